@@ -0,0 +1,455 @@
+#!/usr/bin/env python
+"""
+Standard performance benchmarks for ddSim, mdSim and mcSim.
+
+Usage:
+
+   bench.py [options]
+
+Options:
+
+   -b dir        directory containing ddSim, mdSim and mcSim (default bin/)
+   -o file       JSON output file (default bench.json)
+   -w list       comma separated workloads (default: all)
+   -n list       comma separated numbers of processors for ddSim (default 1)
+   -r list       comma separated replication factors (default 1)
+   -m mode       scaling mode: strong (default) or weak
+   -s nStep      number of timed steps for ddSim workloads (default 1000)
+   -l launcher   MPI launcher prefix (default "mpirun -np")
+   -d dir        scratch directory for runs (default bench/run)
+
+In strong scaling mode, every replication factor r is run with every
+processor count, with r*r*r copies of the base configuration. In weak
+scaling mode, the system run on n processors is obtained by replicating
+the base configuration n/n0 times, where n0 is the first processor
+count, so the number of atoms per processor is constant.
+
+Each ddSim run writes a per-phase timing file with the command
+OUTPUT_PERFORMANCE. Results of all runs are written to one JSON file,
+with atom-steps per second, simulated time (in model time units) per
+day, and per-phase times per step, for comparison across commits.
+"""
+
+import os
+import sys
+import json
+import math
+import time
+import random
+import shutil
+import getopt
+import subprocess
+
+# Numbers of atoms per group, by section name of a DdMd config file.
+GROUP_SIZES = {'BONDS': 2, 'ANGLES': 3, 'DIHEDRALS': 4}
+
+# Workloads: program, template or example directory, and base config.
+WORKLOADS = {
+   'lj':          {'program': 'ddSim', 'dt': 0.005, 'pairsPerAtom': 80,
+                   'range': 2.8, 'config': None},
+   'melt':        {'program': 'ddSim', 'dt': 0.005, 'pairsPerAtom': 12,
+                   'range': 1.6,
+                   'config': 'examples/homopolymer/N32/dd/in/config'},
+   'diblock':     {'program': 'ddSim', 'dt': 0.005, 'pairsPerAtom': 12,
+                   'range': 1.6,
+                   'config': 'examples/diblock/N32/dd/in/config'},
+   'homopolymer_mc':   {'program': 'mcSim', 'param': 'param',
+                   'example': 'examples/homopolymer/N32/mc'},
+   'polyelectrolyte':  {'program': 'mdSim', 'param': 'param.nvt',
+                   'example': 'examples/polyelectrolyte/N8/md'},
+}
+
+ORDER = ['lj', 'melt', 'diblock', 'homopolymer_mc', 'polyelectrolyte']
+
+
+class Config:
+   """
+   A DdMd configuration file (DdMdConfigIo format, no atom context).
+   """
+
+   def __init__(self):
+      self.lengths = [0.0, 0.0, 0.0]
+      self.atoms = []
+      self.groups = {}
+
+   def read(self, filename):
+      file = open(filename, 'r')
+      tokens = file.read().split()
+      file.close()
+      i = 0
+      while i < len(tokens):
+         label = tokens[i]
+         i += 1
+         if label == 'BOUNDARY':
+            style = tokens[i]
+            if style == 'cubic':
+               self.lengths = [float(tokens[i+1])]*3
+               i += 2
+            elif style == 'tetragonal':
+               a = float(tokens[i+1])
+               self.lengths = [a, a, float(tokens[i+2])]
+               i += 3
+            elif style == 'orthorhombic':
+               self.lengths = [float(x) for x in tokens[i+1:i+4]]
+               i += 4
+            else:
+               raise Exception('Unsupported boundary ' + style)
+         elif label == 'ATOMS':
+            n = int(tokens[i+1])
+            i += 2
+            for k in range(n):
+               t = tokens[i:i+8]
+               self.atoms.append([int(t[0]), int(t[1])]
+                                 + [float(x) for x in t[2:8]])
+               i += 8
+         elif label in GROUP_SIZES:
+            size = GROUP_SIZES[label]
+            n = int(tokens[i+1])
+            i += 2
+            groups = []
+            for k in range(n):
+               groups.append([int(x) for x in tokens[i:i+2+size]])
+               i += 2 + size
+            self.groups[label] = groups
+         else:
+            raise Exception('Unknown config section ' + label)
+
+   def lattice(self, n, density, temperature, seed=8082457):
+      """
+      Create a simple cubic lattice of n*n*n atoms of type 0.
+      """
+      a = math.pow(1.0/density, 1.0/3.0)
+      self.lengths = [n*a]*3
+      rng = random.Random(seed)
+      sigma = math.sqrt(temperature)
+      self.atoms = []
+      for i in range(n):
+         for j in range(n):
+            for k in range(n):
+               v = [rng.gauss(0.0, sigma) for x in range(3)]
+               self.atoms.append([len(self.atoms), 0,
+                                  (i + 0.5)*a, (j + 0.5)*a, (k + 0.5)*a]
+                                 + v)
+      for d in range(3):
+         mean = sum([atom[5+d] for atom in self.atoms])/len(self.atoms)
+         for atom in self.atoms:
+            atom[5+d] -= mean
+      self.groups = {}
+
+   def replicate(self, factors):
+      """
+      Return a new Config with factors[d] copies along each axis d.
+      """
+      other = Config()
+      other.lengths = [self.lengths[d]*factors[d] for d in range(3)]
+      nAtom = len(self.atoms)
+      copy = 0
+      for i in range(factors[0]):
+         for j in range(factors[1]):
+            for k in range(factors[2]):
+               shift = [i*self.lengths[0], j*self.lengths[1],
+                        k*self.lengths[2]]
+               for atom in self.atoms:
+                  other.atoms.append([atom[0] + copy*nAtom, atom[1]]
+                                     + [atom[2+d] + shift[d]
+                                        for d in range(3)]
+                                     + atom[5:8])
+               for label in self.groups:
+                  groups = other.groups.setdefault(label, [])
+                  nGroup = len(self.groups[label])
+                  for group in self.groups[label]:
+                     groups.append([group[0] + copy*nGroup, group[1]]
+                                   + [id + copy*nAtom for id in group[2:]])
+               copy += 1
+      return other
+
+   def write(self, filename):
+      file = open(filename, 'w')
+      file.write('BOUNDARY\n\n')
+      file.write('orthorhombic  %.17e  %.17e  %.17e\n\n'
+                 % tuple(self.lengths))
+      file.write('ATOMS\nnAtom  %d\n' % len(self.atoms))
+      for atom in self.atoms:
+         file.write('%10d %4d' % (atom[0], atom[1]))
+         file.write(' %24.16e %24.16e %24.16e' % tuple(atom[2:5]))
+         file.write(' %24.16e %24.16e %24.16e\n' % tuple(atom[5:8]))
+      for label in ['BONDS', 'ANGLES', 'DIHEDRALS']:
+         if label in self.groups:
+            groups = self.groups[label]
+            name = 'n' + label[0] + label[1:-1].lower()
+            file.write('\n%s\n%s  %d\n' % (label, name, len(groups)))
+            for group in groups:
+               file.write(' '.join(['%10d' % x for x in group]) + '\n')
+      file.close()
+
+   def nGroup(self, label):
+      return len(self.groups.get(label, []))
+
+
+def factor3(n):
+   """
+   Return all ordered triples of positive integers with product n.
+   """
+   triples = []
+   for i in range(1, n + 1):
+      if n % i == 0:
+         for j in range(1, n//i + 1):
+            if (n//i) % j == 0:
+               triples.append([i, j, n//(i*j)])
+   return triples
+
+
+def chooseGrid(nProc, lengths, minWidth):
+   """
+   Choose processor grid dimensions giving the most cubic domains.
+   """
+   best = None
+   bestRatio = 0.0
+   for grid in factor3(nProc):
+      widths = [lengths[d]/grid[d] for d in [0, 1, 2]]
+      if min(widths) < minWidth:
+         continue
+      ratio = max(widths)/min(widths)
+      if best is None or ratio < bestRatio:
+         best = grid
+         bestRatio = ratio
+   if best is None:
+      raise Exception('No processor grid with domains wider than cutoff')
+   return best
+
+
+def replicationFactors(k):
+   """
+   Return the most cubic triple of factors with product k.
+   """
+   best = None
+   for triple in factor3(k):
+      if best is None or max(triple) - min(triple) < max(best) - min(best):
+         best = triple
+   return best
+
+
+def readPerformance(filename):
+   """
+   Read a file written by the ddSim OUTPUT_PERFORMANCE command.
+   """
+   phases = {}
+   counts = {}
+   file = open(filename, 'r')
+   for line in file.readlines():
+      fields = line.strip().split(',')
+      if len(fields) == 5 and fields[0] != 'phase':
+         phases[fields[0]] = {'avg': float(fields[1]),
+                              'min': float(fields[2]),
+                              'max': float(fields[3]),
+                              'imbalance': float(fields[4])}
+      elif len(fields) == 2:
+         counts[fields[0]] = int(fields[1])
+   file.close()
+   return phases, counts
+
+
+def runDdSim(root, options, name, workload, nProc, factors):
+   """
+   Run one ddSim benchmark, and return a result dictionary.
+   """
+   base = Config()
+   if workload['config']:
+      base.read(os.path.join(root, workload['config']))
+   else:
+      base.lattice(16, 0.8442, 1.0)
+   config = base.replicate(factors)
+   nAtom = len(config.atoms)
+   nBond = config.nGroup('BONDS')
+   lengths = config.lengths
+   grid = chooseGrid(nProc, lengths, workload['range'])
+
+   dir = os.path.join(options['scratch'], '%s_%dx%dx%d_np%d'
+                      % ((name,) + tuple(factors) + (nProc,)))
+   if os.path.exists(dir):
+      shutil.rmtree(dir)
+   os.makedirs(os.path.join(dir, 'in'))
+   os.makedirs(os.path.join(dir, 'out'))
+   config.write(os.path.join(dir, 'in', 'config'))
+
+   # Write parameter file from template
+   nLocal = nAtom//nProc + 1
+   values = {'GRID': '%d  %d  %d' % tuple(grid),
+             'ATOM_CAPACITY': 2*nLocal + 1000,
+             'GHOST_CAPACITY': 2*nLocal + 1000,
+             'TOTAL_ATOM_CAPACITY': nAtom + 1000,
+             'BOND_CAPACITY': 2*(nBond//nProc) + 1000,
+             'TOTAL_BOND_CAPACITY': nBond + 1000,
+             'BUFFER_ATOM_CAPACITY': nLocal//2 + 1000,
+             'BUFFER_GHOST_CAPACITY': nLocal + 1000,
+             'PAIR_CAPACITY': 2*workload['pairsPerAtom']*nLocal + 1000,
+             'MAX_BOUNDARY': '%.2f  %.2f  %.2f'
+                             % tuple([1.05*L for L in lengths]),
+             'DT': workload['dt']}
+   file = open(os.path.join(root, 'bench', name, 'param'), 'r')
+   text = file.read()
+   file.close()
+   for key in values:
+      text = text.replace('@' + key + '@', str(values[key]))
+   file = open(os.path.join(dir, 'param'), 'w')
+   file.write(text)
+   file.close()
+
+   # Write command file: warm up, then time nStep steps
+   file = open(os.path.join(dir, 'commands'), 'w')
+   file.write('READ_CONFIG        config\n')
+   file.write('THERMALIZE         1.0\n')
+   file.write('SIMULATE           %d\n' % options['nWarm'])
+   file.write('CLEAR_INTEGRATOR\n')
+   file.write('SIMULATE           %d\n' % options['nStep'])
+   file.write('OUTPUT_PERFORMANCE performance\n')
+   file.write('FINISH\n')
+   file.close()
+
+   program = os.path.join(options['bin'], workload['program'])
+   command = options['launcher'].split() + [str(nProc), program,
+             '-e', '-p', 'param', '-c', 'commands']
+   log = open(os.path.join(dir, 'log'), 'w')
+   start = time.time()
+   status = subprocess.call(command, cwd=dir, stdout=log,
+                            stderr=subprocess.STDOUT)
+   wall = time.time() - start
+   log.close()
+
+   result = {'workload': name, 'program': workload['program'],
+             'nProc': nProc, 'grid': grid, 'replicate': factors,
+             'nAtom': nAtom, 'nStep': options['nStep'],
+             'wallTime': wall, 'status': status}
+   perfFile = os.path.join(dir, 'out', 'performance')
+   if status == 0 and os.path.exists(perfFile):
+      phases, counts = readPerformance(perfFile)
+      stepTime = phases['total']['avg']
+      result['timePerStep'] = stepTime
+      result['atomStepsPerSecond'] = nAtom/stepTime
+      result['timeUnitsPerDay'] = workload['dt']*86400.0/stepTime
+      result['phases'] = phases
+      result['communication'] = counts
+   return result
+
+
+def runMcMd(root, options, name, workload):
+   """
+   Run one mcSim or mdSim benchmark, timed by wall clock.
+   """
+   dir = os.path.join(options['scratch'], name)
+   if os.path.exists(dir):
+      shutil.rmtree(dir)
+   shutil.copytree(os.path.join(root, workload['example']), dir)
+   if not os.path.exists(os.path.join(dir, 'out')):
+      os.makedirs(os.path.join(dir, 'out'))
+
+   # Read number of steps and strip output from example commands
+   nStep = 0
+   lines = []
+   file = open(os.path.join(dir, 'commands'), 'r')
+   for line in file.readlines():
+      fields = line.split()
+      if fields and fields[0] == 'SIMULATE':
+         nStep = int(fields[1])
+      if fields and fields[0] in ['WRITE_CONFIG', 'WRITE_PARAM']:
+         continue
+      lines.append(line)
+   file.close()
+   file = open(os.path.join(dir, 'commands'), 'w')
+   file.writelines(lines)
+   file.close()
+
+   program = os.path.join(options['bin'], workload['program'])
+   command = [program, '-e', '-p', workload['param'], '-c', 'commands']
+   log = open(os.path.join(dir, 'log'), 'w')
+   start = time.time()
+   status = subprocess.call(command, cwd=dir, stdout=log,
+                            stderr=subprocess.STDOUT)
+   wall = time.time() - start
+   log.close()
+
+   result = {'workload': name, 'program': workload['program'],
+             'nProc': 1, 'nStep': nStep, 'wallTime': wall,
+             'status': status}
+   if status == 0 and nStep > 0:
+      result['timePerStep'] = wall/nStep
+      result['stepsPerSecond'] = nStep/wall
+   return result
+
+
+def gitRevision(root):
+   try:
+      pipe = subprocess.Popen(['git', 'rev-parse', 'HEAD'], cwd=root,
+                              stdout=subprocess.PIPE)
+      return pipe.communicate()[0].decode().strip()
+   except OSError:
+      return ''
+
+
+def main(argv):
+   root = os.path.dirname(os.path.dirname(os.path.dirname(
+                          os.path.abspath(__file__))))
+   options = {'bin': os.path.join(root, 'bin'), 'output': 'bench.json',
+              'nProcs': [1], 'factors': [1], 'mode': 'strong',
+              'nStep': 1000, 'nWarm': 100, 'launcher': 'mpirun -np',
+              'scratch': os.path.join(root, 'bench', 'run')}
+   names = ORDER
+   opts, args = getopt.getopt(argv, 'b:o:w:n:r:m:s:l:d:')
+   for opt, value in opts:
+      if opt == '-b':
+         options['bin'] = os.path.abspath(value)
+      elif opt == '-o':
+         options['output'] = value
+      elif opt == '-w':
+         names = value.split(',')
+      elif opt == '-n':
+         options['nProcs'] = [int(x) for x in value.split(',')]
+      elif opt == '-r':
+         options['factors'] = [int(x) for x in value.split(',')]
+      elif opt == '-m':
+         options['mode'] = value
+      elif opt == '-s':
+         options['nStep'] = int(value)
+      elif opt == '-l':
+         options['launcher'] = value
+      elif opt == '-d':
+         options['scratch'] = os.path.abspath(value)
+   if options['mode'] not in ['strong', 'weak']:
+      raise Exception('Mode must be strong or weak')
+
+   results = []
+   for name in names:
+      workload = WORKLOADS[name]
+      if workload['program'] != 'ddSim':
+         results.append(runMcMd(root, options, name, workload))
+         continue
+      nProc0 = options['nProcs'][0]
+      for r in options['factors']:
+         for nProc in options['nProcs']:
+            if options['mode'] == 'strong':
+               factors = [r, r, r]
+            else:
+               if nProc % nProc0 != 0:
+                  raise Exception('Weak scaling requires multiples of '
+                                  + 'the first processor count')
+               k = replicationFactors(nProc//nProc0)
+               factors = [r*x for x in k]
+            result = runDdSim(root, options, name, workload,
+                              nProc, factors)
+            results.append(result)
+            sys.stdout.write('%-16s np=%-4d nAtom=%-9d %s\n'
+                             % (name, nProc, result['nAtom'],
+                                result.get('atomStepsPerSecond',
+                                           'failed')))
+
+   summary = {'revision': gitRevision(root), 'mode': options['mode'],
+              'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+              'results': results}
+   file = open(options['output'], 'w')
+   json.dump(summary, file, indent=2, sort_keys=True)
+   file.write('\n')
+   file.close()
+
+
+if __name__ == '__main__':
+   main(sys.argv[1:])
@@ -27,7 +27,8 @@ namespace DdMd
     : ParamComposite(),
       outputFileName_(),
       simulationPtr_(&simulation),
-      interval_(1)
+      interval_(1),
+      phase_(0)
    {}
 
    /*
@@ -103,6 +104,20 @@ namespace DdMd
    void Analyzer::saveInterval(Serializable::OArchive &ar)
    {  ar << interval_; }
 
+   /*
+   * Set phase offset, with error checking.
+   */
+   void Analyzer::setPhase(long phase)
+   {
+      if (phase < 0 || phase >= interval_) {
+         UTIL_THROW("Phase must be in range 0 <= phase < interval");
+      }
+      if (phase % baseInterval != 0) {
+         UTIL_THROW("Phase is not a multiple of baseInterval");
+      }
+      phase_ = phase;
+   }
+
    /*
    * Read output file name and open output file.
    */
@@ -101,6 +101,32 @@ namespace DdMd
       */
       virtual void sample(long iStep) = 0;
 
+      /**
+      * Local part of sampling, for a concurrent analyzer.
+      *
+      * If isConcurrent() returns true, the AnalyzerManager calls this
+      * function before sample() on each step at which the analyzer is
+      * sampled, concurrently with sampleLocal() of other concurrent
+      * analyzers. It may only read the configuration of local atoms and
+      * ghosts and the boundary, may only modify members of this analyzer,
+      * and may not communicate. Communication (e.g., reduction of local
+      * results) must be done in sample(), which is called for all
+      * analyzers in the same order on all processors. The default
+      * implementation is empty.
+      *
+      * \param iStep current simulation step index.
+      */
+      virtual void sampleLocal(long iStep)
+      {}
+
+      /**
+      * Does this analyzer implement a thread safe sampleLocal()?
+      *
+      * Default implementation returns false.
+      */
+      virtual bool isConcurrent() const
+      {  return false; }
+
       /**
       * Output any results at the end of a simulation.
       *
@@ -109,6 +135,30 @@ namespace DdMd
       virtual void output()
       {}
 
+      /**
+      * Flush any buffered output to file.
+      *
+      * Analyzers that write a line to a file every sample should write
+      * without flushing, and flush in this function, which is called
+      * by the AnalyzerManager once every flushInterval steps. The
+      * default implementation is empty.
+      */
+      virtual void flush()
+      {}
+
+      /**
+      * Reduce locally accumulated statistics onto the master processor.
+      *
+      * Analyzers that accumulate statistics on every processor, without
+      * communication during sampling, should reduce them here. This
+      * function is called on all processors by Simulation::save() before
+      * the master processor saves the analyzer state to a checkpoint, so
+      * that save() only needs data from the master. The default
+      * implementation is empty.
+      */
+      virtual void reduce()
+      {}
+
       /**
       * Load internal state from an archive.
       *
@@ -131,7 +181,22 @@ namespace DdMd
       int interval() const;
 
       /**
-      * Return true iff counter is a multiple of the interval.
+      * Get phase offset, in steps (zero unless staggered).
+      */
+      long phase() const;
+
+      /**
+      * Set the phase offset.
+      *
+      * The phase must be a non-negative multiple of baseInterval that
+      * is less than interval. It is set by the AnalyzerManager.
+      *
+      * \param phase offset of sampled steps, in steps
+      */
+      void setPhase(long phase);
+
+      /**
+      * Return true iff counter - phase is a multiple of the interval.
       *
       * \param counter simulation step counter
       */
@@ -227,6 +292,9 @@ namespace DdMd
       /// Number of simulation steps between subsequent actions.
       long   interval_;
 
+      /// Offset of sampled steps (staggered scheduling).
+      long   phase_;
+
    };
 
    // Inline methods
@@ -238,10 +306,16 @@ namespace DdMd
    {  return interval_; }
 
    /*
-   * Return true iff the counter parameter is a multiple of the interval.
+   * Return phase offset.
+   */
+   inline long Analyzer::phase() const
+   {  return phase_; }
+
+   /*
+   * Return true iff counter - phase is a multiple of the interval.
    */
    inline bool Analyzer::isAtInterval(long counter) const
-   {  return (counter%interval_ == 0); }
+   {  return ((counter - phase_)%interval_ == 0); }
 
    /*
    * Get the outputFileName string.
@@ -7,18 +7,56 @@
 
 #include "AnalyzerManager.h" 
 #include "AnalyzerFactory.h" 
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/misc/Tracer.h>
+#include <simp/threads/ThreadPool.h>
+#include <util/misc/Memory.h>
+#include <util/misc/Log.h>
+
+#include <vector>
 
 namespace DdMd
 {
 
    using namespace Util;
 
+   namespace {
+
+      /*
+      * Task that calls the sampleLocal function of one Analyzer.
+      */
+      class LocalSampleTask : public Simp::TaskGroup::Task
+      {
+      public:
+
+         Analyzer* analyzerPtr;
+         long iStep;
+         bool hasFailed;
+
+         virtual void run()
+         {
+            try {
+               analyzerPtr->sampleLocal(iStep);
+            } catch (...) {
+               hasFailed = true;
+            }
+         }
+
+      };
+
+   }
+
    /*
    * Constructor.
    */
    AnalyzerManager::AnalyzerManager(Simulation& simulation)
    : Manager<Analyzer>(),
-     simulationPtr_(&simulation)
+     simulationPtr_(&simulation),
+     memoryBytes_(0.0),
+     flushInterval_(0),
+     timer_(1),
+     isStaggered_(false),
+     phaseCache_()
    {  setClassName("AnalyzerManager"); }
 
    /*
@@ -35,7 +73,14 @@ namespace DdMd
    void AnalyzerManager::readParameters(std::istream &in)
    {
       read<long>(in,"baseInterval", Analyzer::baseInterval);
+      flushInterval_ = 0;
+      readOptional<long>(in, "flushInterval", flushInterval_);
+      checkFlushInterval();
+      isStaggered_ = false;
+      readOptional<bool>(in, "stagger", isStaggered_);
+      int total = Memory::total();
       Manager<Analyzer>::readParameters(in);
+      memoryBytes_ += Memory::total() - total;
    }
 
    /*
@@ -44,7 +89,14 @@ namespace DdMd
    void AnalyzerManager::loadParameters(Serializable::IArchive &ar)
    {
       loadParameter<long>(ar, "baseInterval", Analyzer::baseInterval);
+      flushInterval_ = 0;
+      loadParameter<long>(ar, "flushInterval", flushInterval_, false);
+      checkFlushInterval();
+      isStaggered_ = false;
+      loadParameter<bool>(ar, "stagger", isStaggered_, false);
+      int total = Memory::total();
       Manager<Analyzer>::loadParameters(ar);
+      memoryBytes_ += Memory::total() - total;
    }
 
    /*
@@ -53,6 +105,8 @@ namespace DdMd
    void AnalyzerManager::save(Serializable::OArchive &ar)
    {
       ar << Analyzer::baseInterval;
+      Parameter::saveOptional(ar, flushInterval_, flushInterval_ > 0);
+      Parameter::saveOptional(ar, isStaggered_, isStaggered_);
       Manager<Analyzer>::save(ar);
    }
   
@@ -61,9 +115,65 @@ namespace DdMd
    */
    void AnalyzerManager::setup() 
    {
+      int total = Memory::total();
       for (int i = 0; i < size(); ++i) {
          (*this)[i].setup();
       }
+      memoryBytes_ += Memory::total() - total;
+      assignPhases();
+      if (timer_.size() != size() + 1) {
+         timer_.allocate(size() + 1);
+      }
+   }
+
+   /*
+   * Assign a phase offset to each analyzer.
+   *
+   * Analyzers i and j, with intervals of m_i and m_j base intervals
+   * and phases p_i and p_j (in base intervals), are sampled on a common
+   * step iff p_i - p_j is a multiple of gcd(m_i, m_j). Phases are chosen
+   * greedily, in the order in which analyzers were read, to minimize
+   * the number of such collisions with analyzers already assigned. Only
+   * the first maxSlot candidate phases are considered.
+   */
+   void AnalyzerManager::assignPhases()
+   {
+      const long maxSlot = 1024;
+      const long base = Analyzer::baseInterval;
+      std::vector<long> periods(size());
+      std::vector<long> slots(size());
+      long a, b, c, m, p, nSlot, nCollide, minCollide;
+      int i, j;
+      for (i = 0; i < size(); ++i) {
+         periods[i] = (*this)[i].interval()/base;
+         slots[i] = 0;
+         if (isStaggered_ && i > 0) {
+            m = periods[i];
+            nSlot = m < maxSlot ? m : maxSlot;
+            minCollide = i + 1;
+            for (p = 0; p < nSlot && minCollide > 0; ++p) {
+               nCollide = 0;
+               for (j = 0; j < i; ++j) {
+                  // Greatest common divisor of periods i and j
+                  a = m;
+                  b = periods[j];
+                  while (b != 0) {
+                     c = a % b;
+                     a = b;
+                     b = c;
+                  }
+                  if ((p - slots[j]) % a == 0) {
+                     ++nCollide;
+                  }
+               }
+               if (nCollide < minCollide) {
+                  minCollide = nCollide;
+                  slots[i] = p;
+               }
+            }
+         }
+         (*this)[i].setPhase(slots[i]*base);
+      }
    }
  
    /*
@@ -74,6 +184,7 @@ namespace DdMd
       for (int i = 0; i < size(); ++i) {
          (*this)[i].clear();
       }
+      timer_.clear();
    }
 
    /*
@@ -83,20 +194,103 @@ namespace DdMd
    {
       if (Analyzer::baseInterval > 0) {
          if (iStep % Analyzer::baseInterval == 0) { 
-            for (int i=0; i < size(); ++i) {
+            int i;
+            // Start each interval of timer_ at the beginning of this step
+            timer_.start();
+            sampleLocal(iStep);
+            timer_.stamp(size());
+            for (i = 0; i < size(); ++i) {
                if ((*this)[i].isAtInterval(iStep)) {
-                  (*this)[i].sample(iStep);
+                  if (Tracer::isActive()) {
+                     double begin = MPI_Wtime();
+                     (*this)[i].sample(iStep);
+                     Tracer::record(Tracer::nameId((*this)[i].className()),
+                                    begin, MPI_Wtime());
+                  } else {
+                     (*this)[i].sample(iStep);
+                  }
+                  timer_.stamp(i);
+               }
+            }
+            if (flushInterval_ == 0 || iStep % flushInterval_ == 0) {
+               for (i = 0; i < size(); ++i) {
+                  (*this)[i].flush();
+                  timer_.stamp(i);
                }
             }
          }
       }
    }
+
+   /*
+   * Call sampleLocal method of scheduled concurrent analyzers.
+   */
+   void AnalyzerManager::sampleLocal(long iStep)
+   {
+      int nConcurrent = 0;
+      int i, j;
+      for (i = 0; i < size(); ++i) {
+         if ((*this)[i].isConcurrent() && (*this)[i].isAtInterval(iStep)) {
+            ++nConcurrent;
+         }
+      }
+      if (nConcurrent == 0) return;
+
+      double begin = 0.0;
+      if (Tracer::isActive()) {
+         begin = MPI_Wtime();
+      }
+      std::vector<LocalSampleTask> tasks(nConcurrent);
+      Simp::TaskGroup group(simulationPtr_->threadPool());
+      j = 0;
+      for (i = 0; i < size(); ++i) {
+         if ((*this)[i].isConcurrent() && (*this)[i].isAtInterval(iStep)) {
+            tasks[j].analyzerPtr = &(*this)[i];
+            tasks[j].iStep = iStep;
+            tasks[j].hasFailed = false;
+            group.add(tasks[j]);
+            ++j;
+         }
+      }
+      group.wait();
+      if (Tracer::isActive()) {
+         Tracer::record(Tracer::nameId("sampleLocal"), begin, MPI_Wtime());
+      }
+      for (j = 0; j < nConcurrent; ++j) {
+         if (tasks[j].hasFailed) {
+            Log::file() << "Analyzer " << tasks[j].analyzerPtr->className()
+                        << std::endl;
+            UTIL_THROW("Exception in Analyzer::sampleLocal");
+         }
+      }
+   }
+
+   /*
+   * Call flush method of each analyzer.
+   */
+   void AnalyzerManager::flush()
+   {
+      for (int i=0; i < size(); ++i) {
+         (*this)[i].flush();
+      }
+   }
  
    /*
-   * Call output method of each analyzer.
+   * Call reduce method of each analyzer.
+   */
+   void AnalyzerManager::reduce()
+   {
+      for (int i=0; i < size(); ++i) {
+         (*this)[i].reduce();
+      }
+   }
+
+   /*
+   * Call flush and output methods of each analyzer.
    */
    void AnalyzerManager::output() 
    {
+      flush();
       for (int i=0; i < size(); ++i) {
          (*this)[i].output();
       }
@@ -109,5 +303,38 @@ namespace DdMd
    {
       return new AnalyzerFactory(*simulationPtr_);
    }
+
+   /*
+   * Check that flushInterval_ is zero or a multiple of baseInterval.
+   */
+   void AnalyzerManager::checkFlushInterval() const
+   {
+      if (flushInterval_ < 0) {
+         UTIL_THROW("Negative flushInterval");
+      }
+      if (flushInterval_ > 0 && Analyzer::baseInterval > 0) {
+         if (flushInterval_ % Analyzer::baseInterval != 0) {
+            UTIL_THROW("flushInterval is not a multiple of baseInterval");
+         }
+      }
+   }
+
+   /*
+   * Interval for flushing output.
+   */
+   long AnalyzerManager::flushInterval() const
+   {  return flushInterval_; }
+
+   /*
+   * Are analyzers staggered?
+   */
+   bool AnalyzerManager::isStaggered() const
+   {  return isStaggered_; }
+
+   /*
+   * Bytes allocated by analyzers.
+   */
+   double AnalyzerManager::memoryBytes() const
+   {  return memoryBytes_; }
  
 }
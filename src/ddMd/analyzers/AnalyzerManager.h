@@ -9,6 +9,8 @@
 */
 
 #include "Analyzer.h"                 // template parameter
+#include <ddMd/analyzers/scattering/PhaseCache.h>  // member
+#include <ddMd/misc/DdTimer.h>        // member
 #include <util/param/Manager.h>         // base class template
 
 namespace DdMd
@@ -62,11 +64,19 @@ namespace DdMd
   
       /**
       * Call setup method of each Analyzer.
+      *
+      * If the optional parameter stagger is true, this also assigns a
+      * phase offset to each analyzer (see Analyzer::setPhase), so that
+      * analyzers with equal or commensurate intervals are sampled on
+      * different steps whenever possible. Otherwise, all phases are zero.
+      * Phases are chosen by a deterministic function of the list of
+      * intervals, and are thus the same on all processors and after a
+      * restart.
       */
       void setup();
  
       /**
-      * Call clear method of each Analyzer.
+      * Call clear method of each Analyzer, and clear timer statistics.
       */
       void clear();
  
@@ -80,16 +90,71 @@ namespace DdMd
       * Analyzer::baseInterval. It call the sample() function
       * of each Analyzer object only when iStep is an integer
       * multiple of the interval variable for that Analyzer.
+      * Buffered output of all analyzers is then flushed if
+      * iStep is a multiple of flushInterval.
+      *
+      * The time spent in sample() and flush() by each analyzer is
+      * accumulated in interval i of timer(), in which i is the index
+      * of the analyzer. Interval size() holds time spent in concurrent
+      * sampleLocal() calls.
+      *
+      * Before these calls, the sampleLocal() functions of all analyzers
+      * that are sampled at this step and for which isConcurrent() is
+      * true are executed concurrently on the ThreadPool of the parent
+      * Simulation. Calls of sample(), and thus any MPI communication by
+      * analyzers, remain in the order in which analyzers were read.
       *
       * \param iStep time step counter
       */
       void sample(long iStep);
  
       /**
-      * Call output method of each analyzer.
+      * Call flush method of each analyzer.
+      */
+      void flush();
+
+      /**
+      * Call reduce method of each analyzer.
+      *
+      * Call on all processors.
+      */
+      void reduce();
+
+      /**
+      * Call flush and then output method of each analyzer.
       */
       void output();
 
+      /**
+      * Interval, in steps, at which buffered output is flushed.
+      *
+      * A value of zero (the default) flushes after every base interval.
+      */
+      long flushInterval() const;
+
+      /**
+      * Are analyzers staggered across steps?
+      */
+      bool isStaggered() const;
+
+      /**
+      * Timer for sampling of individual analyzers.
+      */
+      DdTimer& timer();
+
+      /**
+      * Bytes allocated by analyzers during parameter input and setup.
+      *
+      * Measured as the change in Memory::total() over readParameters()
+      * or loadParameters() and over all calls to setup().
+      */
+      double memoryBytes() const;
+
+      /**
+      * Per-step table of phase factors, shared by scattering analyzers.
+      */
+      PhaseCache& phaseCache();
+
       /**
       * Return pointer to a new default factory.
       */
@@ -99,8 +164,40 @@ namespace DdMd
 
       /// Pointer to parent Simulation.
       Simulation* simulationPtr_;
+
+      /// Bytes allocated by analyzers.
+      double memoryBytes_;
+
+      /// Interval for flushing output (0 = every base interval).
+      long flushInterval_;
+
+      /// Timer with one interval per analyzer, plus one (concurrent).
+      DdTimer timer_;
+
+      /// Assign distinct phase offsets to analyzers?
+      bool isStaggered_;
+
+      /// Shared table of phase factors of local atoms.
+      PhaseCache phaseCache_;
+
+      /// Check that flushInterval_ is a valid multiple of baseInterval.
+      void checkFlushInterval() const;
+
+      /// Call sampleLocal() of concurrent analyzers, on all threads.
+      void sampleLocal(long iStep);
+
+      /// Set phase of each analyzer (staggered or all zero).
+      void assignPhases();
  
    };
 
+   // Inline function
+
+   inline PhaseCache& AnalyzerManager::phaseCache()
+   {  return phaseCache_; }
+
+   inline DdTimer& AnalyzerManager::timer()
+   {  return timer_; }
+
 }
 #endif
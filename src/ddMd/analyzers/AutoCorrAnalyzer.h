@@ -24,6 +24,15 @@ namespace DdMd
    * This template works for Data types float or double, std::complex<real>
    * with float or double real type, Util::Vector and Util::Tensor.
    *
+   * The accumulator is a Util::AutoCorrelation, which uses a hierarchical
+   * (multiple-tau) blocking algorithm: Stage i stores bufferCapacity
+   * block averages of blockFactor^i consecutive samples, for stages
+   * 0 <= i <= maxStageId. Memory and cost per sample therefore grow only
+   * logarithmically with the maximum time delay, which is approximately
+   * bufferCapacity*blockFactor^maxStageId samples. The parameters
+   * maxStageId and blockFactor are optional, with default values 10 and
+   * 2, respectively.
+   *
    * \ingroup DdMd_Analyzer_Base_Module
    */
    template <typename Data, typename Product>
@@ -46,7 +55,10 @@ namespace DdMd
       {} 
    
       /**
-      * Read interval, outputFileName and bufferCapacity from parameter file.
+      * Read parameters from file.
+      *
+      * Reads interval, outputFileName, bufferCapacity and optional
+      * parameters maxStageId and blockFactor.
       *
       * \param in input parameter file
       */
@@ -103,6 +115,15 @@ namespace DdMd
       */
       virtual Data data() = 0;
 
+      /**
+      * Add one Data value to the accumulator, call only on master.
+      *
+      * For use by subclasses that override sample().
+      *
+      * \param value new value
+      */
+      void addSample(const Data& value);
+
    private:
  
       /// Output file stream
@@ -117,6 +138,9 @@ namespace DdMd
       /// Maximum stage index for descendant AutoCorrStage objects
       int  maxStageId_;
 
+      /// Ratio of sampling intervals of consecutive AutoCorrStage objects
+      int  blockFactor_;
+
       /// Has readParam been called?
       long  isInitialized_;
    
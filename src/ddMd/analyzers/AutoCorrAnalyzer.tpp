@@ -28,6 +28,7 @@ namespace DdMd
       accumulatorPtr_(0),
       bufferCapacity_(-1),
       maxStageId_(10),
+      blockFactor_(2),
       isInitialized_(false)
    {  setClassName("AutoCorrAnalyzer"); }
 
@@ -40,9 +41,19 @@ namespace DdMd
       readInterval(in);
       readOutputFileName(in);
       read<int>(in,"bufferCapacity", bufferCapacity_);
+      maxStageId_ = 10;
+      readOptional<int>(in, "maxStageId", maxStageId_);
+      blockFactor_ = 2;
+      readOptional<int>(in, "blockFactor", blockFactor_);
+      if (maxStageId_ < 0) {
+         UTIL_THROW("Negative maxStageId");
+      }
+      if (blockFactor_ < 2) {
+         UTIL_THROW("blockFactor must be at least 2");
+      }
       if (simulation().domain().isMaster()) {
-         accumulatorPtr_ = new AutoCorrelation<Tensor, double>;
-         accumulatorPtr_->setParam(bufferCapacity_, maxStageId_);
+         accumulatorPtr_ = new AutoCorrelation<Data, Product>;
+         accumulatorPtr_->setParam(bufferCapacity_, maxStageId_, blockFactor_);
       }
       isInitialized_ = true;
    }
@@ -57,9 +68,13 @@ namespace DdMd
       loadInterval(ar);
       loadOutputFileName(ar);
       loadParameter(ar, "bufferCapacity", bufferCapacity_);
+      maxStageId_ = 10;
+      loadParameter<int>(ar, "maxStageId", maxStageId_, false);
+      blockFactor_ = 2;
+      loadParameter<int>(ar, "blockFactor", blockFactor_, false);
 
       if (simulation().domain().isMaster()) {
-         accumulatorPtr_ = new AutoCorrelation<Tensor, double>;
+         accumulatorPtr_ = new AutoCorrelation<Data, Product>;
          ar >> *accumulatorPtr_;
       }
 
@@ -75,6 +90,8 @@ namespace DdMd
       saveInterval(ar);
       saveOutputFileName(ar);
       ar & bufferCapacity_;
+      Parameter::saveOptional(ar, maxStageId_, true);
+      Parameter::saveOptional(ar, blockFactor_, true);
       if (simulation().domain().isMaster()) {
          if (!accumulatorPtr_) {
             UTIL_THROW("Null accumulatorPtr_ on master");
@@ -131,6 +148,18 @@ namespace DdMd
       }
    }
 
+   /*
+   * Add one Data value to the accumulator (master only).
+   */
+   template <typename Data, typename Product>
+   void AutoCorrAnalyzer<Data, Product>::addSample(const Data& value)
+   {
+      if (!accumulatorPtr_) {
+         UTIL_THROW("Null accumulatorPtr_ on master");
+      }
+      accumulatorPtr_->sample(value);
+   }
+
    /*
    * Output autocorrelation function to file.
    */
@@ -146,6 +175,8 @@ namespace DdMd
          writeParam(outputFile_);
          outputFile_ << std::endl;
          outputFile_ << "bufferCapacity  " << accumulatorPtr_->bufferCapacity() << std::endl;
+         outputFile_ << "maxStageId      " << maxStageId_ << std::endl;
+         outputFile_ << "blockFactor     " << blockFactor_ << std::endl;
          outputFile_ << "nSample         " << accumulatorPtr_->nSample() << std::endl;
          outputFile_ << std::endl;
          outputFile_ << "Format of *.dat file" << std::endl;
@@ -141,6 +141,16 @@ namespace DdMd
       }
    }
 
+   /*
+   * Flush buffered block averages to the data file.
+   */
+   void AverageAnalyzer::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
    /*
    * Output results to file after simulation is completed.
    */
@@ -90,6 +90,11 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered block averages to the data file.
+      */
+      virtual void flush();
+
       /**
       * Write final results to file after a simulation.
       */
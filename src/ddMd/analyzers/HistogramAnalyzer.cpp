@@ -0,0 +1,212 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "HistogramAnalyzer.h"
+#include <ddMd/simulation/Simulation.h>
+#include <util/format/Dbl.h>
+#include <util/mpi/MpiLoader.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   HistogramAnalyzer::HistogramAnalyzer(Simulation& simulation) 
+    : Analyzer(simulation),
+      outputFile_(),
+      histogram_(),
+      total_(),
+      accumulator_(),
+      min_(0.0),
+      max_(0.0),
+      binWidth_(0.0),
+      nBin_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("HistogramAnalyzer"); }
+
+   /*
+   * Destructor.
+   */
+   HistogramAnalyzer::~HistogramAnalyzer() 
+   {}
+
+   /*
+   * Read interval, outputFileName, min, max and nBin.
+   */
+   void HistogramAnalyzer::readParameters(std::istream& in) 
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<double>(in, "min", min_);
+      read<double>(in, "max", max_);
+      read<int>(in, "nBin", nBin_);
+      allocate();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void HistogramAnalyzer::loadParameters(Serializable::IArchive &ar)
+   {
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<double>(ar, "min", min_);
+      loadParameter<double>(ar, "max", max_);
+      loadParameter<int>(ar, "nBin", nBin_);
+      allocate();
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      // Load accumulator, which exists only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> accumulator_;
+         if (accumulator_.capacity() != nBin_ + 1) {
+            UTIL_THROW("Inconsistent accumulator size");
+         }
+      }
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void HistogramAnalyzer::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << min_;
+      ar << max_;
+      ar << nBin_;
+      ar << nSample_;
+      ar << accumulator_;
+   }
+
+   /*
+   * Allocate histograms (private).
+   */
+   void HistogramAnalyzer::allocate()
+   {
+      if (max_ <= min_) {
+         UTIL_THROW("max <= min");
+      }
+      if (nBin_ <= 0) {
+         UTIL_THROW("nBin <= 0");
+      }
+      binWidth_ = (max_ - min_)/double(nBin_);
+      histogram_.allocate(nBin_ + 1);
+      total_.allocate(nBin_ + 1);
+      if (simulation().domain().isMaster()) {
+         accumulator_.allocate(nBin_ + 1);
+      }
+      clear();
+   }
+
+   /*
+   * Clear all histograms.
+   */
+   void HistogramAnalyzer::clear()
+   {
+      for (int i = 0; i <= nBin_; ++i) {
+         histogram_[i] = 0;
+      }
+      if (simulation().domain().isMaster()) {
+         for (int i = 0; i <= nBin_; ++i) {
+            accumulator_[i] = 0;
+         }
+      }
+      nSample_ = 0;
+   }
+
+   /*
+   * Add local values to histogram, for a concurrent analyzer.
+   */
+   void HistogramAnalyzer::sampleLocal(long iStep)
+   {
+      if (isConcurrent()) {
+         compute();
+      }
+   }
+
+   /*
+   * Add local values to histogram, and count sample.
+   */
+   void HistogramAnalyzer::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+      if (!isConcurrent()) {
+         compute();
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Add local histograms to accumulator on master, and clear them.
+   */
+   void HistogramAnalyzer::reduce()
+   {
+      int i;
+      #ifdef UTIL_MPI
+      simulation().domain().communicator().
+                   Reduce(&histogram_[0], &total_[0], nBin_ + 1,
+                          MPI::LONG, MPI::SUM, 0);
+      #else
+      for (i = 0; i <= nBin_; ++i) {
+         total_[i] = histogram_[i];
+      }
+      #endif
+      if (simulation().domain().isMaster()) {
+         for (i = 0; i <= nBin_; ++i) {
+            accumulator_[i] += total_[i];
+         }
+      }
+      for (i = 0; i <= nBin_; ++i) {
+         histogram_[i] = 0;
+      }
+   }
+
+   /*
+   * Write parameters and normalized distribution.
+   */
+   void HistogramAnalyzer::output()
+   {
+      reduce();
+      if (simulation().domain().isMaster()) {
+
+         // Write parameters to a *.prm file
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"),
+                                                  outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Write probability density, normalized by all values sampled
+         long nValue = 0;
+         int i;
+         for (i = 0; i <= nBin_; ++i) {
+            nValue += accumulator_[i];
+         }
+         double norm = nValue > 0 ? 1.0/(double(nValue)*binWidth_) : 0.0;
+         simulation().fileMaster().openOutputFile(outputFileName(".dat"),
+                                                  outputFile_);
+         for (i = 0; i < nBin_; ++i) {
+            outputFile_ << Dbl(min_ + (double(i) + 0.5)*binWidth_, 18, 8)
+                        << Dbl(double(accumulator_[i])*norm, 18, 8)
+                        << std::endl;
+         }
+         outputFile_.close();
+
+      }
+   }
+
+}
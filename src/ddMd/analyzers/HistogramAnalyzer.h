@@ -0,0 +1,187 @@
+#ifndef DDMD_HISTOGRAM_ANALYZER_H
+#define DDMD_HISTOGRAM_ANALYZER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <util/containers/DArray.h>               // member template
+
+#include <iostream>
+#include <fstream>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Analyze the distribution of a floating point variable.
+   *
+   * This class accumulates a histogram of values of a variable, such as
+   * a bond length, that has one value per bond, angle or molecule. It is
+   * intended for use as a base class for analyzers that histogram such
+   * variables. Subclasses implement compute(), which calls addValue()
+   * for each value that should be counted by this processor. 
+   *
+   * Each processor adds values to its own histogram, and histograms
+   * are reduced onto the master processor only in reduce(), which is 
+   * called by output() and before every checkpoint. Sampling thus 
+   * requires no communication beyond any that is done by compute().
+   * A subclass whose compute() function does not communicate should 
+   * override isConcurrent() to return true, in which case compute() is 
+   * called by sampleLocal() rather than by sample().
+   *
+   * \ingroup DdMd_Analyzer_Base_Module
+   */
+   class HistogramAnalyzer : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation  parent Simulation object.
+      */
+      HistogramAnalyzer(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~HistogramAnalyzer();
+
+      /**
+      * Read interval, outputFileName, min, max and nBin.
+      *
+      * \param in  input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an input archive.
+      *
+      * \param ar  input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an output archive.
+      *
+      * Call only on master, after reduce().
+      *
+      * \param ar  output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear histograms on all processors.
+      */
+      virtual void clear();
+
+      /**
+      * Call compute(), if isConcurrent() is true.
+      *
+      * \param iStep  MD time step index
+      */
+      virtual void sampleLocal(long iStep);
+
+      /**
+      * Call compute(), if isConcurrent() is false, and count the sample.
+      *
+      * \param iStep  MD time step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Add local histograms to the accumulator on master.
+      *
+      * Call on all processors.
+      */
+      virtual void reduce();
+
+      /**
+      * Reduce, and write parameters and distribution to files.
+      *
+      * Call on all processors.
+      */
+      virtual void output();
+
+   protected:
+
+      /**
+      * Add values computed by this processor to the local histogram.
+      *
+      * Call on all processors.
+      */
+      virtual void compute() = 0;
+
+      /**
+      * Add one value to the local histogram.
+      *
+      * \param value  sampled value of the variable
+      */
+      void addValue(double value);
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Local histogram since the last reduce (last element = outside).
+      DArray<long> histogram_;
+
+      /// Local histogram summed over processors.
+      DArray<long> total_;
+
+      /// Accumulated histogram (master only, last element = outside).
+      DArray<long> accumulator_;
+
+      /// Lower bound of histogram range.
+      double min_;
+
+      /// Upper bound of histogram range.
+      double max_;
+
+      /// Width of each bin.
+      double binWidth_;
+
+      /// Number of bins.
+      int nBin_;
+
+      /// Number of samples (configurations) thus far.
+      int nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Allocate histograms.
+      */
+      void allocate();
+
+   };
+
+   // Inline function
+
+   /*
+   * Add one value to the local histogram.
+   */
+   inline void HistogramAnalyzer::addValue(double value)
+   {
+      int bin = int((value - min_)/binWidth_);
+      if (value >= min_ && bin < nBin_) {
+         ++histogram_[bin];
+      } else {
+         ++histogram_[nBin_];
+      }
+   }
+
+}
+#endif
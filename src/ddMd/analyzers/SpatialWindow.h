@@ -0,0 +1,129 @@
+#ifndef DDMD_SPATIAL_WINDOW_H
+#define DDMD_SPATIAL_WINDOW_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/communicate/Domain.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Rectangular region in reduced coordinates, used to restrict analysis.
+   *
+   * A window contains reduced positions s with lower[d] <= s[d] < upper[d]
+   * for all axes d, with 0 <= lower[d] < upper[d] <= 1. A processor whose
+   * domain does not overlap the window can skip its local atoms without
+   * testing them. The default window is the whole box, and is inactive.
+   *
+   * \ingroup DdMd_Analyzer_Module
+   */
+   class SpatialWindow
+   {
+
+   public:
+
+      /**
+      * Constructor (whole box).
+      */
+      SpatialWindow()
+       : lower_(0.0),
+         upper_(1.0),
+         isActive_(false)
+      {}
+
+      /**
+      * Set the bounds of the window, and check validity.
+      *
+      * The window is active unless it is the whole box.
+      *
+      * \param lower lower bounds of reduced coordinates
+      * \param upper upper bounds of reduced coordinates
+      */
+      void set(const Vector& lower, const Vector& upper)
+      {
+         isActive_ = false;
+         for (int d = 0; d < Dimension; ++d) {
+            if (lower[d] < 0.0 || upper[d] > 1.0 || lower[d] >= upper[d]) {
+               UTIL_THROW("Invalid spatial window bounds");
+            }
+            if (lower[d] > 0.0 || upper[d] < 1.0) {
+               isActive_ = true;
+            }
+         }
+         lower_ = lower;
+         upper_ = upper;
+      }
+
+      /**
+      * Is the window smaller than the whole box?
+      */
+      bool isActive() const
+      {  return isActive_; }
+
+      /**
+      * Does the window contain reduced position s?
+      *
+      * \param s reduced position
+      */
+      bool contains(const Vector& s) const
+      {
+         if (!isActive_) return true;
+         for (int d = 0; d < Dimension; ++d) {
+            if (s[d] < lower_[d] || s[d] >= upper_[d]) return false;
+         }
+         return true;
+      }
+
+      /**
+      * Does the window overlap the domain of this processor?
+      *
+      * \param domain processor Domain (generalized coordinate bounds)
+      */
+      bool overlaps(const Domain& domain) const
+      {
+         if (!isActive_) return true;
+         for (int d = 0; d < Dimension; ++d) {
+            if (domain.domainBound(d, 1) < lower_[d]) return false;
+            if (domain.domainBound(d, 0) >= upper_[d]) return false;
+         }
+         return true;
+      }
+
+      /**
+      * Lower bounds of reduced coordinates.
+      */
+      const Vector& lower() const
+      {  return lower_; }
+
+      /**
+      * Upper bounds of reduced coordinates.
+      */
+      const Vector& upper() const
+      {  return upper_; }
+
+   private:
+
+      /// Lower bounds.
+      Vector lower_;
+
+      /// Upper bounds.
+      Vector upper_;
+
+      /// Is this smaller than the whole box?
+      bool isActive_;
+
+   };
+
+}
+#endif
@@ -93,6 +93,11 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered block averages to the data file.
+      */
+      virtual void flush();
+
       /**
       * Write final results to a file.
       */
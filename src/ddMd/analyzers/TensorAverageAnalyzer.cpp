@@ -147,6 +147,16 @@ namespace DdMd
       }
    }
 
+   /*
+   * Flush buffered block averages to the data file.
+   */
+   void TensorAverageAnalyzer::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
    /*
    * Output results to file after simulation is completed.
    */
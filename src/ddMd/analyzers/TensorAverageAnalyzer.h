@@ -94,6 +94,11 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered block averages to the data file.
+      */
+      virtual void flush();
+
       /**
       * Write final average and error analysis to file.
       */
@@ -240,8 +240,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sim = simulation();
-         sim.computeKineticEnergy();
-         sim.computePotentialEnergies();
+         sim.computeThermo(true, false);
          if (sim.domain().isMaster()) {
             //outputFile_ << Int(iStep, 10);
             double kinetic = sim.kineticEnergy();
@@ -0,0 +1,84 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "EpsilonDerivativeAnalyzer.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   EpsilonDerivativeAnalyzer::EpsilonDerivativeAnalyzer(Simulation& simulation) 
+    : AverageAnalyzer(simulation)
+   {  setClassName("EpsilonDerivativeAnalyzer"); }
+
+   /*
+   * Destructor.
+   */
+   EpsilonDerivativeAnalyzer::~EpsilonDerivativeAnalyzer() 
+   {}  
+
+   /*
+   * Read interval and outputFileName. 
+   */
+   void EpsilonDerivativeAnalyzer::readParameters(std::istream& in) 
+   {
+      AverageAnalyzer::readParameters(in);
+      readFArray<int, 2>(in, "typeIdPair", typeIdPair_);
+      simulation().pairPotential().requestEpsilonDerivative(typeIdPair_[0],
+                                                            typeIdPair_[1]);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void EpsilonDerivativeAnalyzer::loadParameters(Serializable::IArchive &ar)
+   {
+      AverageAnalyzer::loadParameters(ar);
+      loadFArray<int, 2>(ar, "typeIdPair", typeIdPair_);
+      simulation().pairPotential().requestEpsilonDerivative(typeIdPair_[0],
+                                                            typeIdPair_[1]);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void EpsilonDerivativeAnalyzer::save(Serializable::OArchive &ar)
+   {
+      AverageAnalyzer::save(ar);
+      ar << typeIdPair_;
+   }
+
+   /*
+   * Compute current value, if not computed with the forces.
+   */
+   void EpsilonDerivativeAnalyzer::compute() 
+   {  
+      PairPotential& potential = simulation().pairPotential();
+      if (!potential.isEpsilonDerivativeSet()) {
+         MPI::Intracomm& communicator = simulation().domain().communicator();
+         potential.computeEpsilonDerivative(communicator);
+      }
+   }
+
+   /*
+   * Return current value (call on master).
+   */
+   double EpsilonDerivativeAnalyzer::value() 
+   {
+      if (!simulation().domain().isMaster()) {
+         UTIL_THROW("Error: Not master processor");
+      }
+      return simulation().pairPotential().epsilonDerivative();
+   }
+
+}
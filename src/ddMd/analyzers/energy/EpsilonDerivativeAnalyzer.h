@@ -0,0 +1,96 @@
+#ifndef DDMD_EPSILON_DERIVATIVE_ANALYZER_H
+#define DDMD_EPSILON_DERIVATIVE_ANALYZER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/AverageAnalyzer.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Derivative of the energy with respect to epsilon of one type pair.
+   *
+   * This analyzer samples dU/d epsilon(i, j), for thermodynamic 
+   * integration over the pair interaction parameter epsilon for atom
+   * types i and j. The derivative is computed within the force loop on
+   * steps at which analyzers sample (see 
+   * PairPotential::requestEpsilonDerivative()), and so costs almost
+   * nothing beyond the force calculation.
+   *
+   * \sa \ref ddMd_analyzer_EpsilonDerivativeAnalyzer_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Energy_Module
+   */
+   class EpsilonDerivativeAnalyzer : public AverageAnalyzer
+   {
+   
+   public:
+   
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object. 
+      */
+      EpsilonDerivativeAnalyzer(Simulation& simulation);
+   
+      /**
+      * Destructor.
+      */
+      virtual ~EpsilonDerivativeAnalyzer(); 
+   
+      /**
+      * Read parameters, and request the derivative.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+   
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+  
+   protected:
+
+      /**
+      * Function to compute value.
+      *
+      * Call on all processors.
+      */
+      virtual void compute();
+
+      /**
+      * Current value, set by compute function.
+      *
+      * Call only on master.
+      */
+      virtual double value();
+
+   private:
+   
+      /** 
+      * Pair of atom type ids.
+      */
+      FArray<int, 2>  typeIdPair_;
+
+   };
+
+}
+#endif 
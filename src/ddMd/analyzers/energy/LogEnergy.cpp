@@ -79,8 +79,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sim = simulation();
-         sim.computeKineticEnergy();
-         sim.computePotentialEnergies();
+         sim.computeThermo(true, false);
          if (sim.domain().isMaster()) {
             double kinetic = sim.kineticEnergy();
             Log::file() << Int(iStep, 10)
@@ -111,10 +110,16 @@ namespace DdMd
             }
             #endif
             Log::file() << Dbl(kinetic + potential, 20)
-                        << std::endl;
+                        << "\n";
          }
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void LogEnergy::flush()
+   {  Log::file().flush(); }
+
 }
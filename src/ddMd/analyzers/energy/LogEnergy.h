@@ -77,6 +77,11 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered output lines to file.
+      */
+      virtual void flush();
+
    private:
  
       /// Number of configurations dumped thus far (first dump is zero).
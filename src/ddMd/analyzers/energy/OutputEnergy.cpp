@@ -105,8 +105,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sim = simulation();
-         sim.computeKineticEnergy();
-         sim.computePotentialEnergies();
+         sim.computeThermo(true, false);
          if (sim.domain().isMaster()) {
             double kinetic   = sim.kineticEnergy();
             outputFile_ << Int(iStep, 10)
@@ -144,10 +143,20 @@ namespace DdMd
             }
             #endif
             outputFile_ << Dbl(kinetic + potential, 20)
-                        << std::endl;
+                        << "\n";
          }
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputEnergy::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
@@ -23,6 +23,7 @@ namespace DdMd
    */
    OutputPairEnergies::OutputPairEnergies(Simulation& simulation) 
     : Analyzer(simulation),
+      pair_(),
       nSample_(0),
       isInitialized_(false)
    {  setClassName("OutputPairEnergies"); }
@@ -81,7 +82,8 @@ namespace DdMd
          Simulation& sys = simulation();
          sys.computePairEnergies();
          if (sys.domain().isMaster()) {
-            DMatrix<double> pair = sys.pairEnergies();
+            sys.pairEnergies(pair_);
+            DMatrix<double>& pair = pair_;
             for (int i = 0; i < simulation().nAtomType(); ++i){
                for (int j = 0; j < simulation().nAtomType(); ++j){
                   pair(i,j) = 0.5*( pair(i,j)+pair(j,i) );
@@ -94,11 +96,21 @@ namespace DdMd
                   outputFile_ << Dbl(pair(i,j), 20);
                }
             }
-            outputFile_  << std::endl;
+            outputFile_  << "\n";
          }
 
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputPairEnergies::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
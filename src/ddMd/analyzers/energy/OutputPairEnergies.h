@@ -75,11 +75,19 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered output lines to file.
+      */
+      virtual void flush();
+
    private:
  
       // Output file stream.
       std::ofstream outputFile_;
 
+      /// Work space for symmetrized pair energies (master only).
+      DMatrix<double> pair_;
+
       /// Number of samples.
       long    nSample_;
 
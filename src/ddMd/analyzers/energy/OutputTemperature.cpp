@@ -6,6 +6,7 @@
 */
 
 #include "OutputTemperature.h"
+#include <ddMd/integrators/Integrator.h>
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 #include <util/mpi/MpiLoader.h>
@@ -104,17 +105,29 @@ namespace DdMd
          Simulation& sys = simulation();
          sys.computeKineticEnergy();
          simulation().atomStorage().computeNAtomTotal(simulation().domain().communicator());
+         int nConstraint = sys.integrator().nConstraintTotal();
 
          if (sys.domain().isMaster()) {
-            double ndof = simulation().atomStorage().nAtomTotal()*3;
+            double ndof = simulation().atomStorage().nAtomTotal()*3
+                        - nConstraint;
             double T_kinetic = sys.kineticEnergy()*2.0/ndof;
             outputFile_ << Int(iStep, 10)
                         << Dbl(T_kinetic, 20)
-                        << std::endl;
+                        << "\n";
          }
 
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputTemperature::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
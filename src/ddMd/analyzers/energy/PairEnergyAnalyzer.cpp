@@ -61,9 +61,7 @@ namespace DdMd
    */
    void PairEnergyAnalyzer::compute() 
    {  
-      //simulation().computePairEnergies(); 
-      MPI::Intracomm& communicator = simulation().domain().communicator();  
-      simulation().pairPotential().computePairEnergies(communicator); 
+      simulation().computePairEnergies();
    }
 
    double PairEnergyAnalyzer::value() 
@@ -73,7 +71,7 @@ namespace DdMd
       }
       int i = typeIdPair_[0];
       int j = typeIdPair_[1];
-      DMatrix<double> pair = simulation().pairPotential().pairEnergies();
+      const DMatrix<double>& pair = simulation().pairPotential().pairEnergies();
       return 0.5*(pair(i,j) + pair(j,i));
    }
 
@@ -27,6 +27,7 @@ namespace DdMd
     : Analyzer(simulation),
       outputFile_(),
       pairs_(),
+      pair_(),
       accumulator_(NULL),
       nSamplePerBlock_(1),
       isInitialized_(false)
@@ -110,7 +111,8 @@ namespace DdMd
       if (isAtInterval(iStep))  {
          simulation().computePairEnergies();
          if (simulation().domain().isMaster()) {
-            DMatrix<double> pair = simulation().pairEnergies();
+            simulation().pairEnergies(pair_);
+            DMatrix<double>& pair = pair_;
             for (int i = 0; i < simulation().nAtomType(); ++i){
                for (int j = 0; j < simulation().nAtomType(); ++j){
                   pair(i,j) = 0.5*( pair(i,j)+pair(j,i) );
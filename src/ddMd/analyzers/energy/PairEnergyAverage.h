@@ -11,6 +11,7 @@
 #include <ddMd/analyzers/Analyzer.h>
 #include <ddMd/simulation/Simulation.h>
 #include <util/accumulators/Average.h>
+#include <util/containers/DMatrix.h>
 
 namespace DdMd
 {
@@ -87,6 +88,9 @@ namespace DdMd
       /// Pairs!
       DArray<int>  pairs_;
 
+      /// Work space for symmetrized pair energies (master only).
+      DMatrix<double>  pair_;
+
       /// Average object - statistical accumulator
       Average  *accumulator_;
 
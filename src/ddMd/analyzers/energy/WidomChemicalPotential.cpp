@@ -0,0 +1,320 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "WidomChemicalPotential.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/neighbor/CellList.h>
+#include <ddMd/neighbor/Cell.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/misc/BoundaryMetric.h>
+#include <util/boundary/Boundary.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Vector.h>
+#include <util/space/IntVector.h>
+#include <util/space/Grid.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   WidomChemicalPotential::WidomChemicalPotential(Simulation& simulation)
+    : Analyzer(simulation),
+      outputFile_(),
+      random_(),
+      localSum_(0.0),
+      localSumSq_(0.0),
+      sum_(0.0),
+      sumSq_(0.0),
+      nValue_(0),
+      nSample_(0),
+      nLocal_(0),
+      typeId_(-1),
+      nTrial_(0),
+      seed_(-1),
+      isInitialized_(false)
+   {  setClassName("WidomChemicalPotential"); }
+
+   /*
+   * Destructor.
+   */
+   WidomChemicalPotential::~WidomChemicalPotential()
+   {}
+
+   /*
+   * Read interval, outputFileName, typeId, nTrial and optional seed.
+   */
+   void WidomChemicalPotential::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "typeId", typeId_);
+      read<int>(in, "nTrial", nTrial_);
+      seed_ = -1;
+      readOptional<int>(in, "seed", seed_);
+      if (typeId_ < 0 || typeId_ >= simulation().nAtomType()) {
+         UTIL_THROW("Invalid typeId");
+      }
+      if (nTrial_ <= 0) {
+         UTIL_THROW("nTrial <= 0");
+      }
+      if (simulation().pairPotential().halfShell()) {
+         UTIL_THROW("Test insertions require ghosts on all sides");
+      }
+      clear();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void WidomChemicalPotential::loadParameters(Serializable::IArchive &ar)
+   {
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<int>(ar, "typeId", typeId_);
+      loadParameter<int>(ar, "nTrial", nTrial_);
+      seed_ = -1;
+      loadParameter<int>(ar, "seed", seed_, false);
+      if (simulation().pairPotential().halfShell()) {
+         UTIL_THROW("Test insertions require ghosts on all sides");
+      }
+      clear();
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      // Load accumulators, which exist only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> nValue_;
+         ar >> sum_;
+         ar >> sumSq_;
+      }
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void WidomChemicalPotential::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << typeId_;
+      ar << nTrial_;
+      Parameter::saveOptional(ar, seed_, seed_ >= 0);
+      ar << nSample_;
+      ar << nValue_;
+      ar << sum_;
+      ar << sumSq_;
+   }
+
+   /*
+   * Choose a seed on the master if none was given, and share it.
+   */
+   void WidomChemicalPotential::setup()
+   {
+      if (seed_ < 0) {
+         if (simulation().domain().isMaster()) {
+            seed_ = int(simulation().random().uniform()*2147483647.0);
+         }
+         #ifdef UTIL_MPI
+         bcast(simulation().domain().communicator(), seed_, 0);
+         #endif
+      }
+      random_.setSeed(seed_, 1);
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void WidomChemicalPotential::clear()
+   {
+      localSum_ = 0.0;
+      localSumSq_ = 0.0;
+      nLocal_ = 0;
+      sum_ = 0.0;
+      sumSq_ = 0.0;
+      nValue_ = 0;
+      nSample_ = 0;
+   }
+
+   /*
+   * Insert nTrial test atoms into the domain of this processor.
+   */
+   void WidomChemicalPotential::sampleLocal(long iStep)
+   {
+      Simulation& sim = simulation();
+      PairPotential& potential = sim.pairPotential();
+      const CellList& cellList = potential.cellList();
+      const Grid& grid = cellList.grid();
+      const Boundary& boundary = sim.boundary();
+      const Domain& domain = sim.domain();
+      const int rank = domain.gridRank();
+      const double beta = 1.0/sim.energyEnsemble().temperature();
+      const double cutoffSq = potential.maxPairCutoff()
+                            * potential.maxPairCutoff();
+
+      // Domain bounds (generalized coordinates), and number of cells
+      // that may contain atoms within the pair list cutoff.
+      Vector lower, width;
+      IntVector nCut;
+      int i;
+      for (i = 0; i < Dimension; ++i) {
+         lower[i] = domain.domainBound(i, 0);
+         width[i] = domain.domainBound(i, 1) - lower[i];
+         nCut[i] = int(ceil(scaledWidth(boundary, potential.cutoff(), i)
+                            /cellList.cellLength(i)));
+      }
+
+      // Loop over test atoms
+      Vector g, r, dr;
+      IntVector p, lo, hi, q;
+      double u[4];
+      double energy, rsq, weight;
+      const Atom* atomPtr;
+      int iTrial, j, ic;
+      weight = 0.0;
+      for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
+         random_.uniform(rank, iStep, iTrial, 0, u);
+         for (i = 0; i < Dimension; ++i) {
+            g[i] = lower[i] + u[i]*width[i];
+         }
+         boundary.transformGenToCart(g, r);
+         ic = cellList.cellIndexFromPosition(g);
+         if (ic < 0) {
+            UTIL_THROW("Test position outside of cell list");
+         }
+         p = grid.position(ic);
+         for (i = 0; i < Dimension; ++i) {
+            lo[i] = p[i] - nCut[i] > 0 ? p[i] - nCut[i] : 0;
+            hi[i] = p[i] + nCut[i] < grid.dimension(i) ?
+                    p[i] + nCut[i] : grid.dimension(i) - 1;
+         }
+
+         // Sum pair energies of local atoms and ghosts in nearby cells,
+         // using current (Cartesian) rather than cell list positions.
+         energy = 0.0;
+         for (q[0] = lo[0]; q[0] <= hi[0]; ++q[0]) {
+            for (q[1] = lo[1]; q[1] <= hi[1]; ++q[1]) {
+               for (q[2] = lo[2]; q[2] <= hi[2]; ++q[2]) {
+                  const Cell& cell = cellList.cell(grid.rank(q));
+                  for (j = 0; j < cell.nAtom(); ++j) {
+                     atomPtr = cell.atomPtr(j)->ptr();
+                     dr.subtract(atomPtr->position(), r);
+                     rsq = dr.square();
+                     if (rsq < cutoffSq) {
+                        energy += potential.pairEnergy(rsq, typeId_,
+                                                       atomPtr->typeId());
+                     }
+                  }
+               }
+            }
+         }
+         weight += exp(-beta*energy);
+      }
+      weight /= double(nTrial_);
+      localSum_ += weight;
+      localSumSq_ += weight*weight;
+      ++nLocal_;
+   }
+
+   /*
+   * Count one sample.
+   */
+   void WidomChemicalPotential::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Add local sums to master accumulators, and clear them.
+   */
+   void WidomChemicalPotential::reduce()
+   {
+      double local[3];
+      double total[3];
+      local[0] = double(nLocal_);
+      local[1] = localSum_;
+      local[2] = localSumSq_;
+      #ifdef UTIL_MPI
+      simulation().domain().communicator().
+                   Reduce(local, total, 3, MPI::DOUBLE, MPI::SUM, 0);
+      #else
+      for (int i = 0; i < 3; ++i) {
+         total[i] = local[i];
+      }
+      #endif
+      if (simulation().domain().isMaster()) {
+         nValue_ += long(total[0] + 0.5);
+         sum_ += total[1];
+         sumSq_ += total[2];
+      }
+      localSum_ = 0.0;
+      localSumSq_ = 0.0;
+      nLocal_ = 0;
+   }
+
+   /*
+   * Write parameters and chemical potential.
+   */
+   void WidomChemicalPotential::output()
+   {
+      reduce();
+      if (simulation().domain().isMaster()) {
+
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"),
+                                                  outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Mean Boltzmann factor, and error estimate that neglects
+         // correlations between samples and between processors.
+         double kT = simulation().energyEnsemble().temperature();
+         double mean = 0.0;
+         double error = 0.0;
+         if (nValue_ > 0) {
+            mean = sum_/double(nValue_);
+            double variance = sumSq_/double(nValue_) - mean*mean;
+            if (variance > 0.0 && nValue_ > 1) {
+               error = sqrt(variance/double(nValue_ - 1));
+            }
+         }
+         simulation().fileMaster().openOutputFile(outputFileName(".ave"),
+                                                  outputFile_);
+         outputFile_ << "nSample          " << Int(nSample_, 12) << std::endl;
+         outputFile_ << "nInsertion       "
+                     << Int(nValue_*long(nTrial_), 12) << std::endl;
+         outputFile_ << "BoltzmannFactor  " << Dbl(mean, 18, 8)
+                     << " +- " << Dbl(error, 10, 3) << std::endl;
+         if (mean > 0.0) {
+            outputFile_ << "ExcessMu         " << Dbl(-kT*log(mean), 18, 8)
+                        << " +- " << Dbl(kT*error/mean, 10, 3) << std::endl;
+         } else {
+            outputFile_ << "ExcessMu         undefined (no accepted insertion)"
+                        << std::endl;
+         }
+         outputFile_.close();
+
+      }
+   }
+
+}
@@ -0,0 +1,175 @@
+#ifndef DDMD_WIDOM_CHEMICAL_POTENTIAL_H
+#define DDMD_WIDOM_CHEMICAL_POTENTIAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <simp/random/CounterRandom.h>            // member
+
+#include <iostream>
+#include <fstream>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Widom test particle insertion estimate of the chemical potential.
+   *
+   * On each sample, every processor inserts nTrial test atoms of type
+   * typeId at random positions within its own domain, and computes the
+   * nonbonded pair energy U of each from the local atoms and ghosts in
+   * nearby cells of the pair potential cell list. The excess chemical
+   * potential is mu_ex = -kT ln < exp(-U/kT) >.
+   *
+   * Test positions are generated by a counter based random number
+   * generator keyed by processor rank, step and trial index, so that
+   * no state is shared with the simulation random number generator and
+   * sampleLocal() may run concurrently with other analyzers. Averages
+   * of the Boltzmann factor are accumulated on each processor, and are
+   * reduced onto the master processor only in reduce(), which is called
+   * by output() and before every checkpoint.
+   *
+   * \sa \ref ddMd_analyzer_WidomChemicalPotential_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Energy_Module
+   */
+   class WidomChemicalPotential : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      WidomChemicalPotential(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~WidomChemicalPotential();
+
+      /**
+      * Read interval, outputFileName, typeId, nTrial and optional seed.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * Call on master after reduce().
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Choose a random number seed, if none was given.
+      *
+      * Call on all processors.
+      */
+      virtual void setup();
+
+      /**
+      * Clear accumulators on all processors.
+      */
+      virtual void clear();
+
+      /**
+      * Insert test atoms in the domain of this processor.
+      *
+      * \param iStep current simulation step index.
+      */
+      virtual void sampleLocal(long iStep);
+
+      /**
+      * Count one sample.
+      *
+      * \param iStep current simulation step index.
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Return true: sampleLocal() does not communicate.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
+      /**
+      * Add local accumulators to those of the master, and clear them.
+      *
+      * Call on all processors.
+      */
+      virtual void reduce();
+
+      /**
+      * Write parameters and chemical potential to file.
+      *
+      * Call on all processors.
+      */
+      virtual void output();
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Stateless random number generator for test positions.
+      Simp::CounterRandom random_;
+
+      /// Local sum of mean Boltzmann factors, one per sample.
+      double localSum_;
+
+      /// Local sum of squares of mean Boltzmann factors.
+      double localSumSq_;
+
+      /// Accumulated sum of mean Boltzmann factors (master only).
+      double sum_;
+
+      /// Accumulated sum of squares of mean Boltzmann factors (master).
+      double sumSq_;
+
+      /// Number of processor samples in sum_ (master only).
+      long nValue_;
+
+      /// Number of samples (configurations) thus far.
+      long nSample_;
+
+      /// Number of local samples since the last reduce.
+      long nLocal_;
+
+      /// Atom type index of test atoms.
+      int typeId_;
+
+      /// Number of test insertions per processor per sample.
+      int nTrial_;
+
+      /// Random number seed (optional parameter, or set in setup()).
+      int seed_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+   };
+
+}
+#endif
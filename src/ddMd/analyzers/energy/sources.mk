@@ -6,6 +6,8 @@ ddMd_analyzers_energy_=\
      ddMd/analyzers/energy/OutputTemperature.cpp\
      ddMd/analyzers/energy/PairEnergyAverage.cpp\
      ddMd/analyzers/energy/PairEnergyAnalyzer.cpp\
+     ddMd/analyzers/energy/EpsilonDerivativeAnalyzer.cpp\
+     ddMd/analyzers/energy/WidomChemicalPotential.cpp\
      ddMd/analyzers/energy/OutputPairEnergies.cpp
 
 ifdef SIMP_EXTERNAL
@@ -0,0 +1,97 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BondAngleHistogram.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AngleStorage.h>
+#include <ddMd/storage/GroupIterator.h>
+#include <util/boundary/Boundary.h>
+#include <util/math/Constants.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   BondAngleHistogram::BondAngleHistogram(Simulation& simulation) 
+    : HistogramAnalyzer(simulation),
+      typeId_(-1)
+   {  setClassName("BondAngleHistogram"); }
+
+   /*
+   * Destructor.
+   */
+   BondAngleHistogram::~BondAngleHistogram() 
+   {}
+
+   /*
+   * Read interval, outputFileName, min, max, nBin and typeId.
+   */
+   void BondAngleHistogram::readParameters(std::istream& in)
+   {
+      HistogramAnalyzer::readParameters(in);
+      typeId_ = -1;
+      readOptional<int>(in, "typeId", typeId_);
+      if (typeId_ >= simulation().nAngleType()) {
+         UTIL_THROW("typeId >= nAngleType");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void BondAngleHistogram::loadParameters(Serializable::IArchive &ar)
+   {
+      HistogramAnalyzer::loadParameters(ar);
+      typeId_ = -1;
+      loadParameter<int>(ar, "typeId", typeId_, false);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void BondAngleHistogram::save(Serializable::OArchive &ar)
+   {
+      HistogramAnalyzer::save(ar);
+      Parameter::saveOptional(ar, typeId_, typeId_ >= 0);
+   }
+
+   /*
+   * Add angles of groups for which atom 0 is local.
+   */
+   void BondAngleHistogram::compute() 
+   {
+      Boundary& boundary = simulation().boundary();
+      const double degrees = 180.0/Constants::Pi;
+      GroupIterator<3> iter;
+      Atom* atom0Ptr;
+      Vector dr1, dr2;
+      double rsq1, rsq2, cosTheta;
+
+      simulation().angleStorage().begin(iter);
+      for ( ; iter.notEnd(); ++iter) {
+         if (typeId_ >= 0 && iter->typeId() != typeId_) continue;
+         atom0Ptr = iter->atomPtr(0);
+         if (atom0Ptr->isGhost()) continue;
+         const Vector& r1 = iter->atomPtr(1)->position();
+         rsq1 = boundary.distanceSq(atom0Ptr->position(), r1, dr1);
+         rsq2 = boundary.distanceSq(iter->atomPtr(2)->position(), r1, dr2);
+         cosTheta = dr1.dot(dr2)/sqrt(rsq1*rsq2);
+         if (cosTheta > 1.0) {
+            cosTheta = 1.0;
+         } else 
+         if (cosTheta < -1.0) {
+            cosTheta = -1.0;
+         }
+         addValue(acos(cosTheta)*degrees);
+      }
+   }
+
+}
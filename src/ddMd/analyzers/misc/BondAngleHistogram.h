@@ -0,0 +1,91 @@
+#ifndef DDMD_BOND_ANGLE_HISTOGRAM_H
+#define DDMD_BOND_ANGLE_HISTOGRAM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/HistogramAnalyzer.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Histogram of bond angles, in degrees.
+   *
+   * The angle of a group of atoms 0-1-2 is the angle between bonds 1-0
+   * and 1-2, which is 180 degrees for a straight group. Each processor
+   * adds the angles of the groups for which it owns atom 0 to its own
+   * histogram, so that every angle is counted once, and histograms are
+   * summed over processors only when results are output or saved to a
+   * checkpoint.
+   *
+   * \sa \ref ddMd_analyzer_BondAngleHistogram_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class BondAngleHistogram : public HistogramAnalyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      BondAngleHistogram(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~BondAngleHistogram();
+
+      /**
+      * Read interval, outputFileName, min, max, nBin and typeId.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Return true: compute() does not communicate.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
+   protected:
+
+      /**
+      * Add angles of groups for which atom 0 is local to the histogram.
+      */
+      virtual void compute();
+
+   private:
+
+      /// Index of type of interest, or -1 for all types.
+      int typeId_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,87 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BondLengthHistogram.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/BondStorage.h>
+#include <ddMd/storage/GroupIterator.h>
+#include <util/boundary/Boundary.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   BondLengthHistogram::BondLengthHistogram(Simulation& simulation) 
+    : HistogramAnalyzer(simulation),
+      typeId_(-1)
+   {  setClassName("BondLengthHistogram"); }
+
+   /*
+   * Destructor.
+   */
+   BondLengthHistogram::~BondLengthHistogram() 
+   {}
+
+   /*
+   * Read interval, outputFileName, min, max, nBin and typeId.
+   */
+   void BondLengthHistogram::readParameters(std::istream& in)
+   {
+      HistogramAnalyzer::readParameters(in);
+      typeId_ = -1;
+      readOptional<int>(in, "typeId", typeId_);
+      if (typeId_ >= simulation().nBondType()) {
+         UTIL_THROW("typeId >= nBondType");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void BondLengthHistogram::loadParameters(Serializable::IArchive &ar)
+   {
+      HistogramAnalyzer::loadParameters(ar);
+      typeId_ = -1;
+      loadParameter<int>(ar, "typeId", typeId_, false);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void BondLengthHistogram::save(Serializable::OArchive &ar)
+   {
+      HistogramAnalyzer::save(ar);
+      Parameter::saveOptional(ar, typeId_, typeId_ >= 0);
+   }
+
+   /*
+   * Add lengths of bonds for which atom 0 is local.
+   */
+   void BondLengthHistogram::compute() 
+   {
+      Boundary& boundary = simulation().boundary();
+      GroupIterator<2> iter;
+      Atom* atom0Ptr;
+      Vector dr;
+      double rsq;
+
+      simulation().bondStorage().begin(iter);
+      for ( ; iter.notEnd(); ++iter) {
+         if (typeId_ >= 0 && iter->typeId() != typeId_) continue;
+         atom0Ptr = iter->atomPtr(0);
+         if (atom0Ptr->isGhost()) continue;
+         rsq = boundary.distanceSq(atom0Ptr->position(), 
+                                   iter->atomPtr(1)->position(), dr);
+         addValue(sqrt(rsq));
+      }
+   }
+
+}
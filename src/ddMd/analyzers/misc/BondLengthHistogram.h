@@ -0,0 +1,89 @@
+#ifndef DDMD_BOND_LENGTH_HISTOGRAM_H
+#define DDMD_BOND_LENGTH_HISTOGRAM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/HistogramAnalyzer.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Histogram of bond lengths.
+   *
+   * Each processor adds the lengths of the bonds for which it owns
+   * atom 0 to its own histogram, so that every bond is counted once,
+   * and histograms are summed over processors only when results are
+   * output or saved to a checkpoint.
+   *
+   * \sa \ref ddMd_analyzer_BondLengthHistogram_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class BondLengthHistogram : public HistogramAnalyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      BondLengthHistogram(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~BondLengthHistogram();
+
+      /**
+      * Read interval, outputFileName, min, max, nBin and typeId.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Return true: compute() does not communicate.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
+   protected:
+
+      /**
+      * Add lengths of bonds for which atom 0 is local to the histogram.
+      */
+      virtual void compute();
+
+   private:
+
+      /// Index of type of interest, or -1 for all types.
+      int typeId_;
+
+   };
+
+}
+#endif
@@ -21,7 +21,12 @@ namespace DdMd
    */
    BondTensorAutoCorr::BondTensorAutoCorr(Simulation& simulation) 
     : AutoCorrAnalyzer<Tensor, double>(simulation),
-      bondTensor_()
+      localValues_(),
+      totalValues_(),
+      volumes_(),
+      reductionInterval_(1),
+      nStored_(0),
+      sampleId_(0)
    {  setClassName("BondTensorAutoCorr"); }
 
    /*
@@ -31,11 +36,93 @@ namespace DdMd
    { }
 
    /*
-   * Compute the bond tensor (Call on all processors).
+   * Read parameters of base class, then reductionInterval.
    */
-   void BondTensorAutoCorr::computeData()
+   void BondTensorAutoCorr::readParameters(std::istream& in)
+   {
+      AutoCorrAnalyzer<Tensor, double>::readParameters(in);
+      reductionInterval_ = 1;
+      readOptional<int>(in, "reductionInterval", reductionInterval_);
+      allocate();
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void BondTensorAutoCorr::loadParameters(Serializable::IArchive &ar)
+   {
+      AutoCorrAnalyzer<Tensor, double>::loadParameters(ar);
+      reductionInterval_ = 1;
+      loadParameter<int>(ar, "reductionInterval", reductionInterval_, false);
+      allocate();
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void BondTensorAutoCorr::save(Serializable::OArchive &ar)
+   {
+      AutoCorrAnalyzer<Tensor, double>::save(ar);
+      Parameter::saveOptional(ar, reductionInterval_, true);
+   }
+
+   /*
+   * Allocate buffers, and discard stored samples (private).
+   */
+   void BondTensorAutoCorr::allocate()
+   {
+      if (reductionInterval_ < 1) {
+         UTIL_THROW("reductionInterval must be at least 1");
+      }
+      localValues_.resize(reductionInterval_*NValue_);
+      totalValues_.resize(reductionInterval_*NValue_);
+      volumes_.resize(reductionInterval_);
+      nStored_ = 0;
+   }
+
+   /*
+   * Clear accumulator and stored samples.
+   */
+   void BondTensorAutoCorr::clear()
+   {
+      AutoCorrAnalyzer<Tensor, double>::clear();
+      nStored_ = 0;
+   }
+
+   /*
+   * Store the local bond tensor, and reduce if the buffer is full.
+   */
+   void BondTensorAutoCorr::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index is not a multiple of interval");
+      }
+      storeLocalTensor();
+      if (nStored_ == reductionInterval_) {
+         processDeferred();
+      }
+   }
+
+   /*
+   * Reduce stored samples before a checkpoint.
+   */
+   void BondTensorAutoCorr::reduce()
+   {  processDeferred(); }
+
+   /*
+   * Reduce stored samples, then output.
+   */
+   void BondTensorAutoCorr::output()
+   {
+      processDeferred();
+      AutoCorrAnalyzer<Tensor, double>::output();
+   }
+
+   /*
+   * Add the local bond tensor to the buffer (no communication).
+   */
+   void BondTensorAutoCorr::storeLocalTensor()
    {
-      MPI::Intracomm& communicator = simulation().domain().communicator();
       BondStorage& storage = simulation().bondStorage();
       Boundary& boundary = simulation().boundary();
 
@@ -47,7 +134,6 @@ namespace DdMd
       Atom* atom1Ptr;
       int isLocal0, isLocal1, i, j;
 
-
       // Iterate over bonds
       localTensor.zero();
       storage.begin(iter);
@@ -79,41 +165,80 @@ namespace DdMd
          }
       }
 
-      // Reduce partial sums from all processors, store on the master.
-      bondTensor_.zero();
-      communicator.Reduce(&localTensor(0,0), &bondTensor_(0,0), 
-                          Dimension*Dimension, MPI::DOUBLE, MPI::SUM, 0);
+      // Pack upper triangle of the symmetric tensor
+      double* ptr = &localValues_[nStored_*NValue_];
+      for (i = 0; i < Dimension; ++i) {
+         for (j = i; j < Dimension; ++j) {
+            *ptr = localTensor(i, j);
+            ++ptr;
+         }
+      }
+      volumes_[nStored_] = boundary.volume();
+      ++nStored_;
+   }
 
-      if (communicator.Get_rank() != 0) {
-         bondTensor_.zero();
+   /*
+   * Reduce stored tensors, and add them to the accumulator in order.
+   */
+   void BondTensorAutoCorr::processDeferred()
+   {
+      int n = nStored_*NValue_;
+      if (n == 0) {
+         return;
+      }
+      #ifdef UTIL_MPI
+      simulation().domain().communicator().Reduce(&localValues_[0],
+                                                  &totalValues_[0], n,
+                                                  MPI::DOUBLE, MPI::SUM, 0);
+      #else
+      for (int i = 0; i < n; ++i) {
+         totalValues_[i] = localValues_[i];
+      }
+      #endif
+      if (simulation().domain().isMaster()) {
+         for (sampleId_ = 0; sampleId_ < nStored_; ++sampleId_) {
+            addSample(data());
+         }
       }
+      nStored_ = 0;
    }
 
    /*
-   * Return the current bond tensor value.
+   * Return traceless scaled bond tensor of current stored sample.
    */
    Tensor BondTensorAutoCorr::data() 
    {  
+      // Unpack symmetric tensor
+      Tensor bondTensor;
+      const double* ptr = &totalValues_[sampleId_*NValue_];
+      int i, j;
+      for (i = 0; i < Dimension; ++i) {
+         for (j = i; j < Dimension; ++j) {
+            bondTensor(i, j) = *ptr;
+            bondTensor(j, i) = *ptr;
+            ++ptr;
+         }
+      }
+
       // Remove trace
       double trace = 0.0;
-      int i, j;
       for (i = 0; i < Dimension; ++i) {
-         trace += bondTensor_(i,i);
+         trace += bondTensor(i,i);
       }
       trace = trace/double(Dimension);
       for (i = 0; i < Dimension; ++i) {
-         bondTensor_(i,i) -= trace;
+         bondTensor(i,i) -= trace;
       }
 
       // Scale traceless symmetric tensor   
-      double factor = 1.0/sqrt(10.0*simulation().boundary().volume());
+      double factor = 1.0/sqrt(10.0*volumes_[sampleId_]);
       for (i = 0; i < Dimension; ++i) {
          for (j = 0; j < Dimension; ++j) {
-            bondTensor_(i,j) *= factor;
+            bondTensor(i,j) *= factor;
          }
       }
 
-      return bondTensor_;
+      return bondTensor;
    }  
 
 }
@@ -11,13 +11,29 @@
 #include <ddMd/analyzers/AutoCorrAnalyzer.h>
 #include <util/space/Tensor.h>
 
+#include <vector>
+
 namespace DdMd
 {
 
    using namespace Util;
 
    /**
-   * Calculate stress autocorrelation function.
+   * Autocorrelation function of the bond orientation tensor.
+   *
+   * The bond orientation tensor is the sum over bonds of u u - I/3, in
+   * which u is a unit vector parallel to the bond. Its autocorrelation
+   * gives the stress relaxation modulus via the stress-optical rule, and
+   * is computed by the multiple-tau accumulator of AutoCorrAnalyzer.
+   *
+   * Each processor computes a local bond tensor on every sample, without
+   * communication, and stores it for reductionInterval samples (an
+   * optional parameter, default 1). The 6 independent elements of the
+   * stored symmetric tensors are then summed onto the master in a single
+   * reduction of a packed buffer, and added to the accumulator in the
+   * order sampled, as for StressAutoCorrelation. Memory use on each
+   * processor is thus bounded by reductionInterval, independent of the
+   * length of the run.
    *
    * \ingroup DdMd_Analyzer_Misc_Module
    */
@@ -38,22 +54,97 @@ namespace DdMd
       */
       virtual ~BondTensorAutoCorr();
 
-      using AutoCorrAnalyzer<Tensor, double>::readParameters;
-      using AutoCorrAnalyzer<Tensor, double>::loadParameters;
-      using AutoCorrAnalyzer<Tensor, double>::save;
-      using AutoCorrAnalyzer<Tensor, double>::clear;
+      /**
+      * Read parameters, including optional reductionInterval.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear accumulator and discard stored samples.
+      */
+      virtual void clear();
+
+      /**
+      * Store local bond tensor, and reduce when reductionInterval are stored.
+      *
+      * \param iStep MD step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Reduce stored samples and add them to the accumulator.
+      *
+      * Called on all processors before a checkpoint is saved.
+      */
+      virtual void reduce();
+
+      /**
+      * Reduce stored samples, and output results.
+      */
+      virtual void output();
+
       using AutoCorrAnalyzer<Tensor, double>::setup;
-      using AutoCorrAnalyzer<Tensor, double>::sample;
-      using AutoCorrAnalyzer<Tensor, double>::output;
 
    protected:
 
-      virtual void computeData();
+      /**
+      * Return traceless scaled bond tensor of the current stored sample.
+      */
       virtual Tensor data();
 
    private:
 
-      Tensor bondTensor_;
+      /// Number of independent elements of a symmetric tensor.
+      static const int NValue_ = Dimension*(Dimension + 1)/2;
+
+      /// Local tensors of samples not yet reduced, NValue_ per sample.
+      std::vector<double> localValues_;
+
+      /// Total tensors on master, in the same format.
+      std::vector<double> totalValues_;
+
+      /// System volume for each stored sample.
+      std::vector<double> volumes_;
+
+      /// Number of samples summed in each reduction.
+      int reductionInterval_;
+
+      /// Number of stored samples.
+      int nStored_;
+
+      /// Index of stored sample returned by data().
+      int sampleId_;
+
+      /**
+      * Allocate buffers for reductionInterval_ samples.
+      */
+      void allocate();
+
+      /**
+      * Add the local bond tensor to the buffer.
+      */
+      void storeLocalTensor();
+
+      /**
+      * Reduce stored samples and add them to the accumulator.
+      */
+      void processDeferred();
 
    };
 
@@ -0,0 +1,184 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BuddyCheckpoint.h"
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/global.h>
+
+#include <sstream>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   BuddyCheckpoint::BuddyCheckpoint(Simulation& simulation)
+    : Analyzer(simulation),
+      configIo_(simulation),
+      boundary_(),
+      localData_(),
+      buddyData_(),
+      recvBuffer_(),
+      checkpointStep_(0),
+      nSample_(0),
+      buddyOffset_(0),
+      hasCheckpoint_(false),
+      hasRequest_(false),
+      isInitialized_(false)
+   {  setClassName("BuddyCheckpoint"); }
+
+   /*
+   * Destructor.
+   */
+   BuddyCheckpoint::~BuddyCheckpoint()
+   {}
+
+   /*
+   * Read interval and buddyOffset.
+   */
+   void BuddyCheckpoint::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      int nProc = simulation().domain().communicator().Get_size();
+      buddyOffset_ = nProc/2;
+      readOptional<int>(in, "buddyOffset", buddyOffset_);
+      if (buddyOffset_ < 0 || buddyOffset_ >= nProc) {
+         UTIL_THROW("buddyOffset must lie in range [0, nProc)");
+      }
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void BuddyCheckpoint::loadParameters(Serializable::IArchive &ar)
+   {
+      loadInterval(ar);
+      int nProc = simulation().domain().communicator().Get_size();
+      buddyOffset_ = nProc/2;
+      loadParameter<int>(ar, "buddyOffset", buddyOffset_, false);
+      if (buddyOffset_ < 0 || buddyOffset_ >= nProc) {
+         UTIL_THROW("buddyOffset must lie in range [0, nProc)");
+      }
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void BuddyCheckpoint::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      Parameter::saveOptional(ar, buddyOffset_, true);
+      ar << nSample_;
+   }
+
+   /*
+   * Clear nSample counter.
+   */
+   void BuddyCheckpoint::clear()
+   {  nSample_ = 0; }
+
+   /*
+   * Save a local checkpoint, and start sending a copy to the buddy.
+   */
+   void BuddyCheckpoint::sample(long iStep)
+   {
+      if (isAtInterval(iStep))  {
+
+         // The send buffer may not be modified until the last send is done
+         completeTransfer();
+
+         std::ostringstream out(std::ios::out | std::ios::binary);
+         configIo_.writeRank(out);
+         localData_ = out.str();
+         boundary_ = simulation().boundary();
+         checkpointStep_ = iStep;
+         hasCheckpoint_ = true;
+         ++nSample_;
+
+         if (buddyOffset_ == 0) {
+            buddyData_ = localData_;
+            return;
+         }
+
+         MPI::Intracomm& communicator = simulation().domain().communicator();
+         int nProc = communicator.Get_size();
+         int rank = communicator.Get_rank();
+         int dest = (rank + buddyOffset_) % nProc;
+         int source = (rank - buddyOffset_ + nProc) % nProc;
+         int sendSize = localData_.size();
+         int recvSize = 0;
+         communicator.Sendrecv(&sendSize, 1, MPI::INT, dest, 0,
+                               &recvSize, 1, MPI::INT, source, 0);
+         recvBuffer_.resize(recvSize);
+         requests_[0] = communicator.Irecv(recvSize ? &recvBuffer_[0] : 0,
+                                           recvSize, MPI::CHAR, source, 1);
+         requests_[1] = communicator.Isend(localData_.data(), sendSize,
+                                           MPI::CHAR, dest, 1);
+         hasRequest_ = true;
+      }
+   }
+
+   /*
+   * Complete any pending transfer.
+   */
+   void BuddyCheckpoint::output()
+   {  completeTransfer(); }
+
+   /*
+   * Restore configuration from the last local checkpoint.
+   */
+   long BuddyCheckpoint::restore()
+   {
+      if (!hasCheckpoint_) {
+         UTIL_THROW("No checkpoint has been saved");
+      }
+      completeTransfer();
+
+      // Remove current configuration, restore boundary.
+      simulation().clearConfig();
+      AtomStorage& storage = simulation().atomStorage();
+      if (storage.isCartesian()) {
+         storage.transformCartToGen(simulation().boundary());
+      }
+      simulation().boundary() = boundary_;
+
+      // Read local atoms and groups, then create ghosts.
+      std::istringstream in(localData_, std::ios::in | std::ios::binary);
+      configIo_.readRank(in, simulation().maskedPairPolicy());
+      simulation().exchanger().initialExchange();
+      return checkpointStep_;
+   }
+
+   /*
+   * Wait for nonblocking send and receive, copy received checkpoint.
+   */
+   void BuddyCheckpoint::completeTransfer()
+   {
+      if (hasRequest_) {
+         MPI::Request::Waitall(2, requests_);
+         if (recvBuffer_.size()) {
+            buddyData_.assign(&recvBuffer_[0], recvBuffer_.size());
+         } else {
+            buddyData_.clear();
+         }
+         hasRequest_ = false;
+      }
+   }
+
+}
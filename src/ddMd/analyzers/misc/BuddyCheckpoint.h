@@ -0,0 +1,193 @@
+#ifndef DDMD_BUDDY_CHECKPOINT_H
+#define DDMD_BUDDY_CHECKPOINT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/configIos/DistributedConfigIo.h>
+#include <util/boundary/Boundary.h>
+
+#include <string>
+#include <vector>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Periodically save an in-memory checkpoint on this and a buddy processor.
+   *
+   * At every interval, each processor serializes its local atoms and
+   * all groups that contain local atoms into a binary buffer in memory,
+   * in the rank file format of DistributedConfigIo. The buffer is kept
+   * as a local checkpoint, and a copy is sent to a buddy processor with
+   * rank (rank + buddyOffset) % nProc, while the checkpoint of processor
+   * (rank - buddyOffset) % nProc is received. Buffer sizes are exchanged
+   * with a blocking call, but data is sent with nonblocking calls that
+   * are only completed at the next checkpoint, or by output(), so the
+   * transfer overlaps with subsequent time steps. The default buddyOffset
+   * is nProc/2, which places buddies far apart in the processor grid and
+   * so usually on different nodes.
+   *
+   * No file is ever written. The restore() function rebuilds the state
+   * of all processors from their local checkpoints, and buddyData()
+   * gives access to the copy held for the buddy, from which a wrapper
+   * that recovers from the loss of a processor (e.g., with ULFM) may
+   * reconstruct the state of a replacement. Recovery requires domain
+   * bounds that are unchanged since the checkpoint was saved.
+   *
+   * \code
+   * BuddyCheckpoint{
+   *    interval           1000
+   *    buddyOffset           4
+   * }
+   * \endcode
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class BuddyCheckpoint : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      BuddyCheckpoint(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~BuddyCheckpoint();
+
+      /**
+      * Read interval and optional buddyOffset.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear nSample counter.
+      */
+      virtual void clear();
+
+      /**
+      * Save a checkpoint and start sending it to the buddy.
+      *
+      * Call on all processors.
+      *
+      * \param iStep MD step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Complete any pending transfer of checkpoints.
+      *
+      * Call on all processors.
+      */
+      virtual void output();
+
+      /**
+      * Restore the configuration saved in the last local checkpoint.
+      *
+      * Call on all processors, between runs.
+      *
+      * \return step index of the checkpoint
+      */
+      long restore();
+
+      /**
+      * Has a checkpoint been saved?
+      */
+      bool hasCheckpoint() const;
+
+      /**
+      * Serialized checkpoint received from the buddy processor.
+      */
+      const std::string& buddyData() const;
+
+   private:
+
+      /// Used to write and read serialized checkpoints.
+      DistributedConfigIo configIo_;
+
+      /// Boundary at last checkpoint.
+      Boundary boundary_;
+
+      /// Serialized local checkpoint (also the send buffer).
+      std::string localData_;
+
+      /// Serialized checkpoint received from the buddy.
+      std::string buddyData_;
+
+      /// Receive buffer for the buddy checkpoint.
+      std::vector<char> recvBuffer_;
+
+      /// Requests for nonblocking send and receive.
+      MPI::Request requests_[2];
+
+      /// Step index of last checkpoint.
+      long checkpointStep_;
+
+      /// Number of checkpoints thus far.
+      long nSample_;
+
+      /// Offset of buddy rank.
+      int buddyOffset_;
+
+      /// Has a checkpoint been saved?
+      bool hasCheckpoint_;
+
+      /// Is a transfer in progress?
+      bool hasRequest_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Complete a pending transfer, and copy buddy checkpoint.
+      */
+      void completeTransfer();
+
+   };
+
+   // Inline methods
+
+   /*
+   * Has a checkpoint been saved?
+   */
+   inline bool BuddyCheckpoint::hasCheckpoint() const
+   {  return hasCheckpoint_; }
+
+   /*
+   * Serialized checkpoint received from the buddy processor.
+   */
+   inline const std::string& BuddyCheckpoint::buddyData() const
+   {  return buddyData_; }
+
+}
+#endif
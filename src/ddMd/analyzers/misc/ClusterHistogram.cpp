@@ -0,0 +1,428 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ClusterHistogram.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/storage/GhostIterator.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/neighbor/CellList.h>
+#include <ddMd/neighbor/Cell.h>
+#include <util/space/Vector.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   ClusterHistogram::ClusterHistogram(Simulation& simulation)
+    : Analyzer(simulation),
+      cutoff_(0.0),
+      atomTypeId_(-1),
+      histMin_(0),
+      histMax_(0),
+      nBin_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("ClusterHistogram"); }
+
+   /*
+   * Destructor.
+   */
+   ClusterHistogram::~ClusterHistogram()
+   {}
+
+   /*
+   * Read parameters from file, and allocate histograms.
+   */
+   void ClusterHistogram::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "atomTypeId", atomTypeId_);
+      if (atomTypeId_ < 0) {
+         UTIL_THROW("Negative atomTypeId");
+      }
+      if (atomTypeId_ >= simulation().nAtomType()) {
+         UTIL_THROW("atomTypeId >= nAtomType");
+      }
+      read<double>(in, "cutoff", cutoff_);
+      if (cutoff_ <= 0.0) {
+         UTIL_THROW("Non-positive cutoff");
+      }
+      read<int>(in, "histMin", histMin_);
+      read<int>(in, "histMax", histMax_);
+      allocate();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void ClusterHistogram::loadParameters(Serializable::IArchive &ar)
+   {
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<int>(ar, "atomTypeId", atomTypeId_);
+      loadParameter<double>(ar, "cutoff", cutoff_);
+      loadParameter<int>(ar, "histMin", histMin_);
+      loadParameter<int>(ar, "histMax", histMax_);
+      allocate();
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      // Load accumulator, which exists only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> accumulator_;
+         if (accumulator_.capacity() != nBin_) {
+            UTIL_THROW("Inconsistent accumulator size");
+         }
+      }
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void ClusterHistogram::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << atomTypeId_;
+      ar << cutoff_;
+      ar << histMin_;
+      ar << histMax_;
+      ar << nSample_;
+      ar << accumulator_;
+   }
+
+   /*
+   * Allocate histograms (private).
+   */
+   void ClusterHistogram::allocate()
+   {
+      if (histMin_ < 1) {
+         UTIL_THROW("histMin < 1");
+      }
+      if (histMax_ < histMin_) {
+         UTIL_THROW("histMax < histMin");
+      }
+      nBin_ = histMax_ - histMin_ + 1;
+      histogram_.allocate(nBin_);
+      total_.allocate(nBin_);
+      if (simulation().domain().isMaster()) {
+         accumulator_.allocate(nBin_);
+         for (int i = 0; i < nBin_; ++i) {
+            accumulator_[i] = 0;
+         }
+      }
+      int nProc = 1;
+      #ifdef UTIL_MPI
+      nProc = simulation().domain().communicator().Get_size();
+      #endif
+      sendCounts_.resize(nProc);
+      recvCounts_.resize(nProc);
+      sendDispls_.resize(nProc);
+      recvDispls_.resize(nProc);
+   }
+
+   /*
+   * Check that pairs within the cutoff are in the cell list.
+   */
+   void ClusterHistogram::setup()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      PairPotential& pair = simulation().pairPotential();
+      if (cutoff_ > pair.cutoff() - pair.skin()) {
+         UTIL_THROW("ClusterHistogram cutoff > maximum pair cutoff");
+      }
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void ClusterHistogram::clear()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nSample_ = 0;
+      if (simulation().domain().isMaster()) {
+         for (int i = 0; i < nBin_; ++i) {
+            accumulator_[i] = 0;
+         }
+      }
+   }
+
+   /*
+   * Identify clusters, and accumulate their sizes on master.
+   */
+   void ClusterHistogram::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+      identifyClusters();
+      countClusters();
+
+      int i;
+      #ifdef UTIL_MPI
+      simulation().domain().communicator().
+                   Reduce(&histogram_[0], &total_[0], nBin_,
+                          MPI::LONG, MPI::SUM, 0);
+      #else
+      for (i = 0; i < nBin_; ++i) {
+         total_[i] = histogram_[i];
+      }
+      #endif
+      if (simulation().domain().isMaster()) {
+         for (i = 0; i < nBin_; ++i) {
+            accumulator_[i] += total_[i];
+         }
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Label every atom by the smallest atom id of its cluster (private).
+   */
+   void ClusterHistogram::identifyClusters()
+   {
+      AtomStorage& storage = simulation().atomStorage();
+      int nLocal = storage.atomCapacity();
+      int nTotal = nLocal + storage.ghostCapacity();
+      if (localLabels_.capacity() != nLocal
+          || parents_.capacity() != nTotal) {
+         if (localLabels_.isAllocated()) {
+            localLabels_.deallocate();
+            ghostLabels_.deallocate();
+            parents_.deallocate();
+            minLabels_.deallocate();
+         }
+         localLabels_.allocate(nLocal);
+         ghostLabels_.allocate(storage.ghostCapacity());
+         parents_.allocate(nTotal);
+         minLabels_.allocate(nTotal);
+      }
+
+      // Make every atom of the selected type a cluster of its own
+      members_.clear();
+      int i, j;
+      AtomIterator atomIter;
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         i = storage.arrayIndex(*atomIter);
+         if (atomIter->typeId() == atomTypeId_) {
+            localLabels_[i] = atomIter->id();
+            parents_[i] = i;
+            members_.push_back(i);
+         } else {
+            localLabels_[i] = -1;
+         }
+      }
+      GhostIterator ghostIter;
+      for (storage.begin(ghostIter); ghostIter.notEnd(); ++ghostIter) {
+         i = storage.arrayIndex(*ghostIter);
+         if (ghostIter->typeId() == atomTypeId_) {
+            ghostLabels_[i] = ghostIter->id();
+            parents_[nLocal + i] = nLocal + i;
+            members_.push_back(nLocal + i);
+         } else {
+            ghostLabels_[i] = -1;
+         }
+      }
+
+      // Join pairs within the cutoff that contain a local atom
+      const CellList& cellList = simulation().pairPotential().cellList();
+      Cell::NeighborArray neighbors;
+      const Cell* cellPtr;
+      Atom* atomPtr0;
+      Atom* atomPtr1;
+      Vector dr;
+      double cutoffSq = cutoff_*cutoff_;
+      int na, nn, root0, root1;
+      cellPtr = cellList.begin();
+      while (cellPtr) {
+         cellPtr->getNeighbors(neighbors);
+         na = cellPtr->nAtom();
+         nn = neighbors.size();
+         for (i = 0; i < na; ++i) {
+            atomPtr0 = neighbors[i]->ptr();
+            if (atomPtr0->typeId() != atomTypeId_) continue;
+            for (j = 0; j < nn; ++j) {
+               atomPtr1 = neighbors[j]->ptr();
+               if (atomPtr1 == atomPtr0) continue;
+               if (atomPtr1->typeId() != atomTypeId_) continue;
+               dr.subtract(atomPtr0->position(), atomPtr1->position());
+               if (dr.square() < cutoffSq) {
+                  root0 = findRoot(storage.arrayIndex(*atomPtr0));
+                  root1 = storage.arrayIndex(*atomPtr1);
+                  if (atomPtr1->isGhost()) {
+                     root1 += nLocal;
+                  }
+                  root1 = findRoot(root1);
+                  if (root0 != root1) {
+                     parents_[root1] = root0;
+                  }
+               }
+            }
+         }
+         cellPtr = cellPtr->nextCellPtr();
+      }
+
+      // Iterate local minimization of labels and ghost communication
+      int nMember = members_.size();
+      int k, nChange, nChangeTotal;
+      do {
+         for (k = 0; k < nMember; ++k) {
+            i = members_[k];
+            minLabels_[i] = label(i);
+         }
+         for (k = 0; k < nMember; ++k) {
+            i = members_[k];
+            j = findRoot(i);
+            if (label(i) < minLabels_[j]) {
+               minLabels_[j] = label(i);
+            }
+         }
+         nChange = 0;
+         for (k = 0; k < nMember; ++k) {
+            i = members_[k];
+            j = minLabels_[findRoot(i)];
+            if (j != label(i)) {
+               label(i) = j;
+               ++nChange;
+            }
+         }
+         nChangeTotal = nChange;
+         #ifdef UTIL_MPI
+         simulation().exchanger().reverseUpdateLabels(localLabels_,
+                                                      ghostLabels_);
+         simulation().exchanger().updateLabels(localLabels_, ghostLabels_);
+         simulation().domain().communicator().
+                      Allreduce(&nChange, &nChangeTotal, 1,
+                                MPI::INT, MPI::SUM);
+         #endif
+      } while (nChangeTotal > 0);
+   }
+
+   /*
+   * Count atoms of each cluster, and histogram sizes (private).
+   */
+   void ClusterHistogram::countClusters()
+   {
+      AtomStorage& storage = simulation().atomStorage();
+      AtomIterator atomIter;
+      std::map<int, int>::iterator iter;
+      int i;
+
+      // Count local atoms of each cluster
+      counts_.clear();
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         i = localLabels_[storage.arrayIndex(*atomIter)];
+         if (i >= 0) {
+            ++counts_[i];
+         }
+      }
+
+      #ifdef UTIL_MPI
+      // Send counts to the processor with rank label % nProc
+      MPI::Intracomm& communicator = simulation().domain().communicator();
+      int nProc = sendCounts_.size();
+      int r;
+      for (r = 0; r < nProc; ++r) {
+         sendCounts_[r] = 0;
+      }
+      for (iter = counts_.begin(); iter != counts_.end(); ++iter) {
+         sendCounts_[iter->first % nProc] += 2;
+      }
+      sendDispls_[0] = 0;
+      for (r = 1; r < nProc; ++r) {
+         sendDispls_[r] = sendDispls_[r-1] + sendCounts_[r-1];
+      }
+      sendBuffer_.resize(sendDispls_[nProc-1] + sendCounts_[nProc-1]);
+      std::vector<int> positions(sendDispls_);
+      for (iter = counts_.begin(); iter != counts_.end(); ++iter) {
+         r = iter->first % nProc;
+         sendBuffer_[positions[r]] = iter->first;
+         sendBuffer_[positions[r] + 1] = iter->second;
+         positions[r] += 2;
+      }
+      communicator.Alltoall(&sendCounts_[0], 1, MPI::INT,
+                            &recvCounts_[0], 1, MPI::INT);
+      recvDispls_[0] = 0;
+      for (r = 1; r < nProc; ++r) {
+         recvDispls_[r] = recvDispls_[r-1] + recvCounts_[r-1];
+      }
+      int nRecv = recvDispls_[nProc-1] + recvCounts_[nProc-1];
+      recvBuffer_.resize(nRecv);
+      int* sendPtr = sendBuffer_.empty() ? 0 : &sendBuffer_[0];
+      int* recvPtr = recvBuffer_.empty() ? 0 : &recvBuffer_[0];
+      communicator.Alltoallv(sendPtr, &sendCounts_[0], &sendDispls_[0],
+                             MPI::INT,
+                             recvPtr, &recvCounts_[0], &recvDispls_[0],
+                             MPI::INT);
+
+      // Add counts received for clusters assigned to this processor
+      counts_.clear();
+      for (i = 0; i < nRecv; i += 2) {
+         counts_[recvBuffer_[i]] += recvBuffer_[i + 1];
+      }
+      #endif
+
+      // Histogram sizes of clusters assigned to this processor
+      for (i = 0; i < nBin_; ++i) {
+         histogram_[i] = 0;
+      }
+      int bin;
+      for (iter = counts_.begin(); iter != counts_.end(); ++iter) {
+         bin = iter->second - histMin_;
+         if (bin >= 0 && bin < nBin_) {
+            ++histogram_[bin];
+         }
+      }
+   }
+
+   /*
+   * Write parameters and accumulated histogram.
+   */
+   void ClusterHistogram::output()
+   {
+      if (simulation().domain().isMaster()) {
+
+         // Write parameters to a *.prm file
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"),
+                                                  outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Write average number of clusters of each size per sample
+         simulation().fileMaster().openOutputFile(outputFileName(".dat"),
+                                                  outputFile_);
+         double norm = nSample_ > 0 ? 1.0/double(nSample_) : 0.0;
+         for (int i = 0; i < nBin_; ++i) {
+            outputFile_ << Int(histMin_ + i, 8)
+                        << Dbl(double(accumulator_[i])*norm, 18, 8)
+                        << std::endl;
+         }
+         outputFile_.close();
+
+      }
+   }
+
+}
@@ -0,0 +1,229 @@
+#ifndef DDMD_CLUSTER_HISTOGRAM_H
+#define DDMD_CLUSTER_HISTOGRAM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/simulation/Simulation.h>
+#include <util/containers/DArray.h>               // member template
+
+#include <util/global.h>
+
+#include <iostream>
+#include <vector>
+#include <map>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Histogram of sizes of clusters of atoms of one type.
+   *
+   * Two atoms of type atomTypeId belong to the same cluster if they are
+   * connected by a chain of such atoms in which each pair of successive
+   * atoms is separated by less than cutoff. Clusters are identified in
+   * parallel, without gathering atoms:
+   *
+   *  - Each processor joins pairs of local and ghost atoms found in
+   *    the cell list of the PairPotential, using a union-find structure.
+   *  - Each atom is labelled by its global id, and each processor
+   *    replaces the labels of all atoms of each local cluster by their
+   *    minimum. Labels of ghosts are then reduced onto their owners by
+   *    Exchanger::reverseUpdateLabels(), and copied back to all ghosts
+   *    by Exchanger::updateLabels(). This is repeated until no label
+   *    changes on any processor, after which every atom is labelled by
+   *    the smallest atom id of its cluster.
+   *  - The number of local atoms of each cluster is sent to a processor
+   *    with rank equal to the label modulo the number of processors,
+   *    which adds the counts and histograms the cluster sizes.
+   *
+   * Communication in each iteration is limited to the ghost shell, and
+   * the number of iterations is of the order of the number of domains
+   * spanned by the largest cluster. Cluster sizes are numbers of atoms;
+   * if every molecule has m atoms of type atomTypeId that always lie in
+   * the same cluster, the aggregation number is the size divided by m.
+   *
+   * \sa \ref ddMd_analyzer_ClusterHistogram_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class ClusterHistogram : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation reference to parent Simulation object
+      */
+      ClusterHistogram(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~ClusterHistogram();
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Check the cutoff against the pair potential.
+      */
+      virtual void setup();
+
+      /**
+      * Clear accumulators.
+      */
+      virtual void clear();
+
+      /**
+      * Identify clusters and add their sizes to the histogram.
+      *
+      * Call on all processors.
+      *
+      * \param iStep MD step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file.
+      */
+      virtual void output();
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Histogram of clusters assigned to this processor.
+      DArray<long> histogram_;
+
+      /// Histogram of the current sample, summed over processors.
+      DArray<long> total_;
+
+      /// Accumulated histogram (master only).
+      DArray<long> accumulator_;
+
+      /// Labels of local atoms, indexed by array index.
+      DArray<int> localLabels_;
+
+      /// Labels of ghost atoms, indexed by array index.
+      DArray<int> ghostLabels_;
+
+      /// Union-find parents of local atoms, then ghosts.
+      DArray<int> parents_;
+
+      /// Minimum label of each local cluster, indexed by root.
+      DArray<int> minLabels_;
+
+      /// Union-find indices of atoms of type atomTypeId.
+      std::vector<int> members_;
+
+      /// Number of local atoms of each cluster, by label.
+      std::map<int, int> counts_;
+
+      /// Send and receive buffers of (label, count) pairs.
+      std::vector<int> sendBuffer_;
+      std::vector<int> recvBuffer_;
+
+      /// Numbers of ints sent to and received from each processor.
+      std::vector<int> sendCounts_;
+      std::vector<int> recvCounts_;
+
+      /// Displacements of send and receive blocks.
+      std::vector<int> sendDispls_;
+      std::vector<int> recvDispls_;
+
+      /// Cutoff distance.
+      double cutoff_;
+
+      /// Type of atoms in clusters.
+      int atomTypeId_;
+
+      /// Minimum cluster size in histogram.
+      int histMin_;
+
+      /// Maximum cluster size in histogram.
+      int histMax_;
+
+      /// Number of bins in histogram.
+      int nBin_;
+
+      /// Number of samples thus far.
+      int nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Allocate histograms.
+      */
+      void allocate();
+
+      /**
+      * Label every atom by the smallest atom id of its cluster.
+      */
+      void identifyClusters();
+
+      /**
+      * Count atoms of each cluster, and histogram cluster sizes.
+      */
+      void countClusters();
+
+      /**
+      * Get the root of the union-find tree of an index.
+      */
+      int findRoot(int i);
+
+      /**
+      * Get the label of an atom from its union-find index.
+      */
+      int& label(int i);
+
+   };
+
+   // Inline private functions
+
+   inline int ClusterHistogram::findRoot(int i)
+   {
+      while (parents_[i] != i) {
+         parents_[i] = parents_[parents_[i]];
+         i = parents_[i];
+      }
+      return i;
+   }
+
+   inline int& ClusterHistogram::label(int i)
+   {
+      int nLocal = localLabels_.capacity();
+      return (i < nLocal) ? localLabels_[i] : ghostLabels_[i - nLocal];
+   }
+
+}
+#endif
@@ -0,0 +1,208 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CompositionProfile.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/misc/ioUtil.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/format/Dbl.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /// Constructor.
+   CompositionProfile::CompositionProfile(Simulation& simulation) 
+    : Analyzer(simulation),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("CompositionProfile"); }
+
+   CompositionProfile::~CompositionProfile() 
+   {}
+
+   /// Read parameters from file, and allocate histograms.
+   void CompositionProfile::readParameters(std::istream& in) 
+   {
+      nAtomType_ = simulation().nAtomType();
+
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nDirection", nDirection_);
+      intVectors_.allocate(nDirection_);
+      readDArray<IntVector>(in, "intVectors", intVectors_, nDirection_);
+      read<int>(in, "nBins", nBins_);
+
+      waveVectors_.allocate(nDirection_);
+      histogram_.allocate(nDirection_, nAtomType_, nBins_);
+      total_.allocate(nDirection_, nAtomType_, nBins_);
+      if (simulation().domain().isMaster()) {
+         accumulator_.allocate(nDirection_, nAtomType_, nBins_);
+      }
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void CompositionProfile::loadParameters(Serializable::IArchive &ar)
+   {
+      nAtomType_ = simulation().nAtomType();
+
+      // Load and broadcast parameter file parameters
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<int>(ar, "nDirection", nDirection_);
+      intVectors_.allocate(nDirection_);
+      loadDArray<IntVector>(ar, "intVectors", intVectors_, nDirection_);
+      loadParameter<int>(ar, "nBins", nBins_);
+
+      // Load and broadcast nSample_
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      // Load accumulator, which exists only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> accumulator_;
+         if (accumulator_.size() != nDirection_*nAtomType_*nBins_) {
+            UTIL_THROW("Inconsistent accumulator size");
+         }
+      }
+
+      // Allocate work space (all processors).
+      waveVectors_.allocate(nDirection_);
+      histogram_.allocate(nDirection_, nAtomType_, nBins_);
+      total_.allocate(nDirection_, nAtomType_, nBins_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void CompositionProfile::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << nDirection_;
+      ar << intVectors_;
+      ar << nBins_;
+      ar << nSample_;
+      ar << accumulator_;
+   }
+  
+   /*
+   * Clear accumulators.
+   */
+   void CompositionProfile::clear() 
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nSample_ = 0;
+      if (simulation().domain().isMaster()) {
+         accumulator_.clear();
+      }
+   }
+
+   /*
+   * Add local atoms to local histograms.
+   */
+   void CompositionProfile::sampleLocal(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+
+      // Calculate directions for the current boundary
+      Boundary& boundary = simulation().boundary();
+      Vector lengths = boundary.lengths();
+      Vector dWave;
+      int i, j;
+      for (i = 0; i < nDirection_; ++i) {
+         waveVectors_[i].zero();
+         for (j = 0; j < Dimension; ++j) {
+            dWave  = boundary.reciprocalBasisVector(j);
+            dWave *= intVectors_[i][j];
+            waveVectors_[i] += dWave;
+         }
+         histogram_.setDirection(i, waveVectors_[i], lengths);
+      }
+
+      // Histogram local atoms
+      histogram_.clear();
+      AtomIterator atomIter;
+      simulation().atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         histogram_.sample(atomIter->position(), atomIter->typeId());
+      }
+   }
+
+   /*
+   * Sum local histograms over processors, and accumulate on master.
+   */
+   void CompositionProfile::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+
+      #ifdef UTIL_MPI
+      // Sum counts from all processors, in one reduction of all elements
+      total_.clear();
+      simulation().domain().communicator().
+                   Reduce(histogram_.data(), total_.data(),
+                          histogram_.size(), MPI::LONG, MPI::SUM, 0);
+      #else
+      total_.clear();
+      total_.add(histogram_);
+      #endif
+
+      if (simulation().domain().isMaster()) {
+         accumulator_.add(total_);
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Write parameters and accumulated histograms.
+   */
+   void CompositionProfile::output()
+   {
+      if (simulation().domain().isMaster()) {
+
+         // Write parameters to a *.prm file
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"), 
+                                                  outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Output histograms to one *.dat file
+         simulation().fileMaster().openOutputFile(outputFileName(".dat"), 
+                                                  outputFile_);
+         int i, j, k;
+         for (i = 0; i < nDirection_; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               outputFile_ << Dbl(waveVectors_[i][j], 5);
+            }
+            outputFile_ << std::endl;
+            for (k = 0; k < nAtomType_; ++k) {
+               accumulator_.output(outputFile_, i, k);
+               outputFile_ << std::endl;
+            }
+         }
+         outputFile_.close();
+      }
+   } 
+
+}
@@ -0,0 +1,150 @@
+#ifndef DDMD_COMPOSITION_PROFILE_H
+#define DDMD_COMPOSITION_PROFILE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/simulation/Simulation.h>
+#include <simp/analysis/ProfileHistogram.h>      // member
+#include <util/containers/DArray.h>               // member template
+#include <util/space/IntVector.h>                 // member
+#include <util/space/Vector.h>                    // member
+
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * CompositionProfile evaluates histograms of atom positions.
+   *
+   * For each of nDirection directions, each defined by a vector of 
+   * integer indices of a reciprocal lattice vector, this analyzer
+   * accumulates a histogram of the reduced coordinates of atoms of
+   * each type along that direction. Each processor histograms its 
+   * local atoms, and the histograms are summed on the master by one
+   * reduction per sample. The local histograms are computed by the
+   * thread safe sampleLocal() function, and so may be computed
+   * concurrently with other concurrent analyzers.
+   *
+   * \sa \ref ddMd_analyzer_CompositionProfile_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class CompositionProfile : public Analyzer
+   {
+
+   public:
+
+      /**	
+      * Constructor.
+      *
+      * \param simulation reference to parent Simulation object
+      */
+      CompositionProfile(Simulation& simulation);
+
+      /**	
+      * Destructor.
+      */
+      ~CompositionProfile();
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+  
+      /** 
+      * Clear accumulators.
+      */
+      virtual void clear();
+   
+      /**
+      * Add local atoms to local histograms.
+      *
+      * \param iStep step counter
+      */
+      virtual void sampleLocal(long iStep);
+
+      /**
+      * Sum local histograms over processors, and accumulate.
+      *
+      * \param iStep step counter
+      */
+      void sample(long iStep);
+
+      /**
+      * Return true: sampleLocal() is thread safe.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
+      /**
+      * Output results to predefined output file.
+      */
+      virtual void output();
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Histograms of local atoms for the current sample.
+      ProfileHistogram histogram_;
+
+      /// Accumulated histograms, summed over processors (master only).
+      ProfileHistogram accumulator_;
+
+      /// Histograms of the current sample, summed over processors.
+      ProfileHistogram total_;
+
+      /// Integer indices of reciprocal vectors that define directions.
+      DArray<IntVector> intVectors_;
+
+      /// Reciprocal vectors for the current boundary.
+      DArray<Vector> waveVectors_;
+
+      /// Number of directions.
+      int nDirection_;
+
+      /// Number of bins per histogram.
+      int nBins_;
+
+      /// Number of atom types, copied from Simulation::nAtomType().
+      int nAtomType_;
+
+      /// Number of samples thus far.
+      int nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+   };
+
+}
+#endif
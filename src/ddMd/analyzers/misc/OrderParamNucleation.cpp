@@ -8,6 +8,8 @@
 #include "OrderParamNucleation.h"
 #include <ddMd/simulation/Simulation.h>
 #include <ddMd/simulation/SimulationAccess.h>
+#include <ddMd/analyzers/AnalyzerManager.h>
+#include <ddMd/analyzers/scattering/PhaseCache.h>
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/AtomIterator.h>
 #include <ddMd/communicate/Exchanger.h>
@@ -17,6 +19,8 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <cstdlib>
+
 namespace DdMd
 {
 
@@ -48,6 +52,11 @@ namespace DdMd
       }
       read<int>(in, "periodicity", periodicity_);
       read<int>(in, "nBin", nBin_);
+      Vector lower(0.0);
+      Vector upper(1.0);
+      readOptional<Vector>(in, "windowLower", lower);
+      readOptional<Vector>(in, "windowUpper", upper);
+      setWindow(lower, upper);
 
       cosFactors_.allocate(nAtomType_, nBin_);
       totalCosFactors_.allocate(nAtomType_, nBin_);
@@ -75,6 +84,11 @@ namespace DdMd
       }
       loadParameter<int>(ar, "periodicity", periodicity_);
       loadParameter<int>(ar, "nBin", nBin_);
+      Vector lower(0.0);
+      Vector upper(1.0);
+      loadParameter<Vector>(ar, "windowLower", lower, false);
+      loadParameter<Vector>(ar, "windowUpper", upper, false);
+      setWindow(lower, upper);
 
       cosFactors_.allocate(nAtomType_, nBin_);
       totalCosFactors_.allocate(nAtomType_, nBin_);
@@ -93,6 +107,22 @@ namespace DdMd
       ar << parallelIndex_;
       ar << periodicity_;
       ar << nBin_;
+      Vector lower = window_.lower();
+      Vector upper = window_.upper();
+      bool isActive = window_.isActive();
+      Parameter::saveOptional(ar, lower, isActive);
+      Parameter::saveOptional(ar, upper, isActive);
+   }
+
+   /*
+   * Set spatial window and required Miller indices (private).
+   */
+   void OrderParamNucleation::setWindow(const Vector& lower,
+                                        const Vector& upper)
+   {
+      window_.set(lower, upper);
+      maxIntVector_ = IntVector(0);
+      maxIntVector_[perpIndex_] = abs(periodicity_);
    }
   
    /*
@@ -122,39 +152,32 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
 
-         Vector blengths;
-         Boundary* boundaryPtr = &simulation().boundary();
-         blengths = boundaryPtr->lengths();
-
-         Vector position;
-         double  slabLength, product, cosFactor;
-         AtomIterator  atomIter;
-         int typeId, bin;
-
-         simulation().atomStorage().begin(atomIter);
-         for ( ; atomIter.notEnd(); ++atomIter) {
-            position = atomIter->position();
-            typeId   = atomIter->typeId();
- 
-            slabLength = blengths[parallelIndex_]/nBin_;
-            bin = position[parallelIndex_]/slabLength;
-
-            product = position[perpIndex_]*2.0*Constants::Pi*periodicity_;
-            product /= blengths[perpIndex_];
-            cosFactor = cos(product)*cos(product);
-            cosFactors_(typeId, bin) += cosFactor;
+         // Add local atoms within the window, using shared phase factors
+         if (window_.overlaps(simulation().domain())) {
+            PhaseCache& cache = simulation().analyzerManager().phaseCache();
+            cache.reserve(maxIntVector_);
+            cache.update(simulation());
+
+            double cosFactor;
+            int a, nAtom, bin;
+            nAtom = cache.nAtom();
+            for (a = 0; a < nAtom; ++a) {
+               const Vector& position = cache.position(a);
+               if (!window_.contains(position)) continue;
+               bin = int(position[parallelIndex_]*nBin_);
+               if (bin < 0) bin = 0;
+               if (bin >= nBin_) bin = nBin_ - 1;
+               cosFactor =
+                  std::real(cache.phase(a, perpIndex_, periodicity_));
+               cosFactors_(cache.typeId(a), bin) += cosFactor*cosFactor;
+            }
          }
 
          #ifdef UTIL_MPI
-         // Loop over wavevectors
-         for (int i = 0; i < nAtomType_; ++i) {
-            for (int j = 0; j < nBin_; ++j) {
-            //Sum values from all processors.
-            simulation().domain().communicator().
-                         Reduce(&cosFactors_(i, j), &totalCosFactors_(i, j),
-                                1, MPI::DOUBLE, MPI::SUM, 0);
-            }
-         }
+         // Sum values from all processors, in one reduction
+         simulation().domain().communicator().
+                      Reduce(&cosFactors_(0, 0), &totalCosFactors_(0, 0),
+                             nAtomType_*nBin_, MPI::DOUBLE, MPI::SUM, 0);
          #else
          for (int i = 0; i < nAtomType_; ++i) {
             for (int j = 0; j < nBin_; ++j) {
@@ -9,8 +9,10 @@
 */
 
 #include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/analyzers/SpatialWindow.h>          // member
 #include <ddMd/simulation/Simulation.h>
 #include <util/containers/DMatrix.h>               // member template
+#include <util/space/IntVector.h>                  // member
 
 #include <util/global.h>
 
@@ -37,6 +39,14 @@ namespace DdMd
    * the atom position in the direction parallel to lamellae
    * (specified by the parameter parallelIndex).
    *
+   * Positions are reduced coordinates, and the cos factor of an atom
+   * is the real part of the phase factor for Miller index periodicity
+   * along perpIndex, taken from the PhaseCache of the AnalyzerManager
+   * so that it is shared with scattering analyzers on the same step.
+   * Optional windowLower and windowUpper parameters restrict the sums
+   * to a rectangular region around the nucleus (see SpatialWindow), and
+   * processors whose domains lie outside that region skip their atoms.
+   *
    * \code
    * OrderParamNucleation{
    *    interval                      1000
@@ -45,6 +55,8 @@ namespace DdMd
    *    parallelIndex                    0
    *    periodicity                      3
    *    nBin                           100
+   *    windowLower          0.4  0.4  0.0
+   *    windowUpper          0.6  0.6  1.0
    * }
    * \endcode
    *
@@ -131,12 +143,26 @@ namespace DdMd
       /// Number of bins to divide the length along parallel direction 
       int nBin_;
 
+      /// Region of reduced coordinates included in the sums.
+      SpatialWindow window_;
+
+      /// Miller indices required from the PhaseCache.
+      IntVector maxIntVector_;
+
       /// Number of samples thus far.
       int  nSample_;
 
       /// Has readParam been called?
       bool isInitialized_;
 
+      /**
+      * Set the spatial window and maxIntVector_.
+      *
+      * \param lower lower bounds of window, in reduced coordinates
+      * \param upper upper bounds of window, in reduced coordinates
+      */
+      void setWindow(const Vector& lower, const Vector& upper);
+
    };
 
 }
@@ -0,0 +1,169 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "RadiusOfGyration.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   RadiusOfGyration::RadiusOfGyration(Simulation& simulation)
+    : AverageAnalyzer(simulation),
+      reducer_(),
+      anchors_(),
+      rgSq_(0.0),
+      speciesId_(-1)
+   {
+      setClassName("RadiusOfGyration");
+      reducer_.associate(simulation.domain(), simulation.atomStorage());
+   }
+
+   /*
+   * Destructor.
+   */
+   RadiusOfGyration::~RadiusOfGyration()
+   {}
+
+   /*
+   * Read interval, outputFileName, nSamplePerBlock and speciesId.
+   */
+   void RadiusOfGyration::readParameters(std::istream& in)
+   {
+      AverageAnalyzer::readParameters(in);
+      read<int>(in, "speciesId", speciesId_);
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void RadiusOfGyration::loadParameters(Serializable::IArchive &ar)
+   {
+      AverageAnalyzer::loadParameters(ar);
+      loadParameter<int>(ar, "speciesId", speciesId_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void RadiusOfGyration::save(Serializable::OArchive &ar)
+   {
+      AverageAnalyzer::save(ar);
+      ar << speciesId_;
+   }
+
+   /*
+   * Count species and molecules, and open output file.
+   */
+   void RadiusOfGyration::setup()
+   {
+      AverageAnalyzer::setup();
+      reducer_.setup();
+      if (speciesId_ >= reducer_.nSpecies()) {
+         UTIL_THROW("speciesId >= number of species");
+      }
+   }
+
+   /*
+   * Compute squared radius of gyration, averaged over molecules.
+   */
+   void RadiusOfGyration::compute()
+   {
+      Boundary& boundary = simulation().boundary();
+      AtomStorage& storage = simulation().atomStorage();
+      AtomIterator atomIter;
+      double* values;
+      int i;
+
+      // Send position of atom 0 of each molecule to all owners of its atoms
+      anchors_.clear();
+      reducer_.begin(Dimension);
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         if (atomIter->context().atomId == 0) {
+            for (i = 0; i < Dimension; ++i) {
+               values[i] = atomIter->position()[i];
+            }
+         }
+      }
+      reducer_.reduce();
+      reducer_.scatter();
+      Vector anchor;
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         for (i = 0; i < Dimension; ++i) {
+            anchor[i] = values[i];
+         }
+         anchors_.push_back(anchor);
+      }
+
+      // Sum displacements from atom 0, and their squares, over molecules
+      reducer_.begin(Dimension + 1);
+      Vector dr;
+      int k = 0;
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         values[Dimension] +=
+            boundary.distanceSq(atomIter->position(), anchors_[k], dr);
+         for (i = 0; i < Dimension; ++i) {
+            values[i] += dr[i];
+         }
+         ++k;
+      }
+      reducer_.reduce();
+
+      // Add squared radii of owned molecules, and sum over processors
+      double nAtom = double(reducer_.nAtom(speciesId_));
+      const double* total;
+      double rgSq, cmSq;
+      double localSum = 0.0;
+      for (k = 0; k < reducer_.nOwned(); ++k) {
+         if (reducer_.speciesId(reducer_.ownedId(k)) != speciesId_) continue;
+         total = reducer_.total(k);
+         cmSq = 0.0;
+         for (i = 0; i < Dimension; ++i) {
+            cmSq += total[i]*total[i];
+         }
+         rgSq = total[Dimension]/nAtom - cmSq/(nAtom*nAtom);
+         localSum += rgSq;
+      }
+      double sum = localSum;
+      #ifdef UTIL_MPI
+      simulation().domain().communicator().
+                   Reduce(&localSum, &sum, 1, MPI::DOUBLE, MPI::SUM, 0);
+      #endif
+      if (simulation().domain().isMaster()) {
+         int nMolecule = reducer_.nMolecule(speciesId_);
+         rgSq_ = nMolecule > 0 ? sum/double(nMolecule) : 0.0;
+      }
+   }
+
+   /*
+   * Return current value (call only on master).
+   */
+   double RadiusOfGyration::value()
+   {
+      if (!simulation().domain().isMaster()) {
+         UTIL_THROW("Error: Not master processor");
+      }
+      return rgSq_;
+   }
+
+}
@@ -0,0 +1,112 @@
+#ifndef DDMD_RADIUS_OF_GYRATION_H
+#define DDMD_RADIUS_OF_GYRATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/AverageAnalyzer.h>
+#include <ddMd/communicate/MoleculeReducer.h>     // member
+#include <util/space/Vector.h>                     // member template param
+
+#include <vector>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Average squared radius of gyration of molecules of one species.
+   *
+   * Sums over the atoms of each molecule are computed in parallel by a
+   * MoleculeReducer, without gathering atoms or molecules, using the
+   * AtomContext of each atom. Positions of atoms are taken relative to
+   * the position of atom 0 of the same molecule, using the minimum image
+   * convention, which requires that every atom of a molecule be less
+   * than half a unit cell length from atom 0.
+   *
+   * \sa \ref ddMd_analyzer_RadiusOfGyration_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class RadiusOfGyration : public AverageAnalyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      RadiusOfGyration(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~RadiusOfGyration();
+
+      /**
+      * Read interval, outputFileName, nSamplePerBlock and speciesId.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Setup before main loop: Count species and molecules.
+      */
+      virtual void setup();
+
+   protected:
+
+      /**
+      * Compute squared radius of gyration, averaged over molecules.
+      *
+      * Call on all processors.
+      */
+      virtual void compute();
+
+      /**
+      * Current value, set by compute function.
+      *
+      * Call only on master.
+      */
+      virtual double value();
+
+   private:
+
+      /// Distributed molecule sums.
+      MoleculeReducer reducer_;
+
+      /// Positions of atom 0 of the molecule of each local atom.
+      std::vector<Vector> anchors_;
+
+      /// Average squared radius of gyration (valid only on master).
+      double rgSq_;
+
+      /// Index of species of interest.
+      int speciesId_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,147 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "RadiusOfGyrationHistogram.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   RadiusOfGyrationHistogram::RadiusOfGyrationHistogram(Simulation& simulation)
+    : HistogramAnalyzer(simulation),
+      reducer_(),
+      anchors_(),
+      speciesId_(-1)
+   {
+      setClassName("RadiusOfGyrationHistogram");
+      reducer_.associate(simulation.domain(), simulation.atomStorage());
+   }
+
+   /*
+   * Destructor.
+   */
+   RadiusOfGyrationHistogram::~RadiusOfGyrationHistogram()
+   {}
+
+   /*
+   * Read interval, outputFileName, min, max, nBin and speciesId.
+   */
+   void RadiusOfGyrationHistogram::readParameters(std::istream& in)
+   {
+      HistogramAnalyzer::readParameters(in);
+      read<int>(in, "speciesId", speciesId_);
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void RadiusOfGyrationHistogram::loadParameters(Serializable::IArchive &ar)
+   {
+      HistogramAnalyzer::loadParameters(ar);
+      loadParameter<int>(ar, "speciesId", speciesId_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void RadiusOfGyrationHistogram::save(Serializable::OArchive &ar)
+   {
+      HistogramAnalyzer::save(ar);
+      ar << speciesId_;
+   }
+
+   /*
+   * Count species and molecules.
+   */
+   void RadiusOfGyrationHistogram::setup()
+   {
+      HistogramAnalyzer::setup();
+      reducer_.setup();
+      if (speciesId_ >= reducer_.nSpecies()) {
+         UTIL_THROW("speciesId >= number of species");
+      }
+   }
+
+   /*
+   * Add radii of gyration of owned molecules to the histogram.
+   */
+   void RadiusOfGyrationHistogram::compute()
+   {
+      Boundary& boundary = simulation().boundary();
+      AtomStorage& storage = simulation().atomStorage();
+      AtomIterator atomIter;
+      double* values;
+      int i;
+
+      // Send position of atom 0 of each molecule to all owners of its atoms
+      anchors_.clear();
+      reducer_.begin(Dimension);
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         if (atomIter->context().atomId == 0) {
+            for (i = 0; i < Dimension; ++i) {
+               values[i] = atomIter->position()[i];
+            }
+         }
+      }
+      reducer_.reduce();
+      reducer_.scatter();
+      Vector anchor;
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         for (i = 0; i < Dimension; ++i) {
+            anchor[i] = values[i];
+         }
+         anchors_.push_back(anchor);
+      }
+
+      // Sum displacements from atom 0, and their squares, over molecules
+      reducer_.begin(Dimension + 1);
+      Vector dr;
+      int k = 0;
+      for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         if (atomIter->context().speciesId != speciesId_) continue;
+         values = reducer_.values(*atomIter);
+         values[Dimension] +=
+            boundary.distanceSq(atomIter->position(), anchors_[k], dr);
+         for (i = 0; i < Dimension; ++i) {
+            values[i] += dr[i];
+         }
+         ++k;
+      }
+      reducer_.reduce();
+
+      // Add radii of owned molecules to the local histogram
+      double nAtom = double(reducer_.nAtom(speciesId_));
+      const double* total;
+      double rgSq, cmSq;
+      for (k = 0; k < reducer_.nOwned(); ++k) {
+         if (reducer_.speciesId(reducer_.ownedId(k)) != speciesId_) continue;
+         total = reducer_.total(k);
+         cmSq = 0.0;
+         for (i = 0; i < Dimension; ++i) {
+            cmSq += total[i]*total[i];
+         }
+         rgSq = total[Dimension]/nAtom - cmSq/(nAtom*nAtom);
+         addValue(rgSq > 0.0 ? sqrt(rgSq) : 0.0);
+      }
+   }
+
+}
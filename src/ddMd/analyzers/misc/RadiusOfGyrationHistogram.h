@@ -0,0 +1,102 @@
+#ifndef DDMD_RADIUS_OF_GYRATION_HISTOGRAM_H
+#define DDMD_RADIUS_OF_GYRATION_HISTOGRAM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/HistogramAnalyzer.h>
+#include <ddMd/communicate/MoleculeReducer.h>     // member
+#include <util/space/Vector.h>                     // member template param
+
+#include <vector>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Histogram of radii of gyration of molecules of one species.
+   *
+   * Sums over the atoms of each molecule are computed by a MoleculeReducer,
+   * exactly as in RadiusOfGyration, which requires the same communication.
+   * The radius of gyration of each molecule is then added to the histogram
+   * of the processor that owns the molecule sums, and histograms are 
+   * summed over processors only when results are output or saved to a 
+   * checkpoint.
+   *
+   * \sa \ref ddMd_analyzer_RadiusOfGyrationHistogram_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Misc_Module
+   */
+   class RadiusOfGyrationHistogram : public HistogramAnalyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      RadiusOfGyrationHistogram(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~RadiusOfGyrationHistogram();
+
+      /**
+      * Read interval, outputFileName, min, max, nBin and speciesId.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Setup before main loop: Count species and molecules.
+      */
+      virtual void setup();
+
+   protected:
+
+      /**
+      * Add radii of gyration of owned molecules to the histogram.
+      *
+      * Call on all processors.
+      */
+      virtual void compute();
+
+   private:
+
+      /// Distributed molecule sums.
+      MoleculeReducer reducer_;
+
+      /// Positions of atom 0 of the molecule of each local atom.
+      std::vector<Vector> anchors_;
+
+      /// Index of species of interest.
+      int speciesId_;
+
+   };
+
+}
+#endif
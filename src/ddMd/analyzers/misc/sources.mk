@@ -1,9 +1,20 @@
 ddMd_analyzers_misc_=\
-     ddMd/analyzers/misc/OrderParamNucleation.cpp
+     ddMd/analyzers/misc/OrderParamNucleation.cpp \
+     ddMd/analyzers/misc/CompositionProfile.cpp \
+     ddMd/analyzers/misc/RadiusOfGyration.cpp \
+     ddMd/analyzers/misc/ClusterHistogram.cpp \
+     ddMd/analyzers/misc/RadiusOfGyrationHistogram.cpp \
+     ddMd/analyzers/misc/BuddyCheckpoint.cpp
 
 ifdef SIMP_BOND
 ddMd_analyzers_misc_+=\
-     ddMd/analyzers/misc/BondTensorAutoCorr.cpp
+     ddMd/analyzers/misc/BondTensorAutoCorr.cpp \
+     ddMd/analyzers/misc/BondLengthHistogram.cpp
+endif
+
+ifdef SIMP_ANGLE
+ddMd_analyzers_misc_+=\
+     ddMd/analyzers/misc/BondAngleHistogram.cpp
 endif
 
 ddMd_analyzers_misc_SRCS=\
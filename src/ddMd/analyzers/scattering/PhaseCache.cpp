@@ -0,0 +1,124 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "PhaseCache.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+#include <util/math/Constants.h>
+#include <util/space/Dimension.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   PhaseCache::PhaseCache()
+    : phases_(),
+      positions_(),
+      typeIds_(),
+      maxIntVector_(0),
+      offsets_(0),
+      stride_(0),
+      nAtom_(0),
+      version_(-1),
+      isCurrent_(false)
+   {}
+
+   /*
+   * Extend range of Miller indices.
+   */
+   void PhaseCache::reserve(const IntVector& maxIntVector)
+   {
+      for (int d = 0; d < Dimension; ++d) {
+         if (maxIntVector[d] < 0) {
+            UTIL_THROW("Negative maximum Miller index");
+         }
+         if (maxIntVector[d] > maxIntVector_[d]) {
+            maxIntVector_[d] = maxIntVector[d];
+            isCurrent_ = false;
+         }
+      }
+   }
+
+   /*
+   * Recompute phase factors of all local atoms, if necessary.
+   */
+   void PhaseCache::update(Simulation& simulation)
+   {
+      AtomStorage& storage = simulation.atomStorage();
+      int nAtom = storage.nAtom();
+      long version = simulation.configVersion();
+      if (isCurrent_ && version == version_ && nAtom == nAtom_) return;
+
+      // Layout of phase factors for one atom
+      int d;
+      stride_ = 0;
+      for (d = 0; d < Dimension; ++d) {
+         offsets_[d] = stride_;
+         stride_ += maxIntVector_[d] + 1;
+      }
+
+      // Allocate or extend arrays
+      if (positions_.isAllocated()) {
+         if (positions_.capacity() < nAtom) {
+            positions_.deallocate();
+            typeIds_.deallocate();
+         }
+      }
+      if (!positions_.isAllocated() && nAtom > 0) {
+         positions_.allocate(nAtom);
+         typeIds_.allocate(nAtom);
+      }
+      if (phases_.isAllocated()) {
+         if (phases_.capacity() < nAtom*stride_) {
+            phases_.deallocate();
+         }
+      }
+      if (!phases_.isAllocated() && nAtom > 0) {
+         phases_.allocate(nAtom*stride_);
+      }
+
+      // Tabulate exp(i n b_d.r) by recurrence, with one sin and cos
+      // evaluation per axis.
+      const Boundary& boundary = simulation.boundary();
+      std::complex<double> base;
+      std::complex<double>* ptr;
+      double product;
+      AtomIterator atomIter;
+      int i, n;
+      i = 0;
+      storage.begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         const Vector& r = atomIter->position();
+         typeIds_[i] = atomIter->typeId();
+         for (d = 0; d < Dimension; ++d) {
+            product = r.dot(boundary.reciprocalBasisVector(d));
+            positions_[i][d] = product/(2.0*Constants::Pi);
+            base = std::complex<double>(cos(product), sin(product));
+            ptr = &phases_[i*stride_ + offsets_[d]];
+            ptr[0] = std::complex<double>(1.0, 0.0);
+            for (n = 1; n <= maxIntVector_[d]; ++n) {
+               ptr[n] = ptr[n-1]*base;
+            }
+         }
+         ++i;
+      }
+      assert(i == nAtom);
+
+      nAtom_ = nAtom;
+      version_ = version;
+      isCurrent_ = true;
+   }
+
+}
@@ -0,0 +1,172 @@
+#ifndef DDMD_PHASE_CACHE_H
+#define DDMD_PHASE_CACHE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>             // member template
+#include <util/space/Vector.h>                  // member template parameter
+#include <util/space/IntVector.h>               // member
+#include <util/global.h>
+
+#include <complex>
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * Per-step table of phase factors of local atoms, shared by analyzers.
+   *
+   * For each local atom i, a PhaseCache stores the type id, the reduced
+   * (generalized) position s, with s[d] = b_d.r/(2 pi) for reciprocal
+   * basis vectors b_d, and the phase factors exp(i n b_d.r) for each
+   * axis d and 0 <= n <= maxIntVector()[d]. The phase factor for any
+   * wavevector k = sum_d n_d b_d with |n_d| <= maxIntVector()[d] is the
+   * product of one factor per axis, as returned by phase(i, k).
+   *
+   * One PhaseCache is owned by the AnalyzerManager. Each analyzer calls
+   * reserve() with the largest Miller indices it needs, and update()
+   * before reading the table. The table is recomputed only if the
+   * configuration version or the number of local atoms has changed, or
+   * if a larger index range was reserved, so the cost of evaluating
+   * phase factors is paid once per step by all analyzers that use it.
+   * Atoms are stored in the order of a local AtomIterator.
+   *
+   * \ingroup DdMd_Analyzer_Scattering_Module
+   */
+   class PhaseCache
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      PhaseCache();
+
+      /**
+      * Extend the range of tabulated Miller indices, if necessary.
+      *
+      * \param maxIntVector maximum absolute Miller index for each axis
+      */
+      void reserve(const IntVector& maxIntVector);
+
+      /**
+      * Recompute the table for local atoms, unless it is current.
+      *
+      * \param simulation parent Simulation
+      */
+      void update(Simulation& simulation);
+
+      /**
+      * Number of local atoms in the table.
+      */
+      int nAtom() const;
+
+      /**
+      * Type id of local atom i.
+      *
+      * \param i index of atom in the table
+      */
+      int typeId(int i) const;
+
+      /**
+      * Reduced position of local atom i.
+      *
+      * \param i index of atom in the table
+      */
+      const Vector& position(int i) const;
+
+      /**
+      * Phase factor exp(i n b_d.r) of atom i, for |n| <= maxIntVector()[d].
+      *
+      * \param i index of atom in the table
+      * \param d axis index
+      * \param n Miller index for axis d
+      */
+      std::complex<double> phase(int i, int d, int n) const;
+
+      /**
+      * Phase factor exp(i k.r) of atom i, for integer wavevector k.
+      *
+      * \param i index of atom in the table
+      * \param k Miller indices of the wavevector
+      */
+      std::complex<double> phase(int i, const IntVector& k) const;
+
+      /**
+      * Maximum absolute Miller index for each axis in the table.
+      */
+      const IntVector& maxIntVector() const;
+
+   private:
+
+      /// Phase factors for n >= 0, stride_ elements per atom.
+      DArray< std::complex<double> >  phases_;
+
+      /// Reduced positions of local atoms.
+      DArray<Vector>  positions_;
+
+      /// Type ids of local atoms.
+      DArray<int>  typeIds_;
+
+      /// Largest reserved Miller index for each axis.
+      IntVector  maxIntVector_;
+
+      /// Offset of the element n = 0 for each axis within an atom block.
+      IntVector  offsets_;
+
+      /// Number of phase factors per atom.
+      int  stride_;
+
+      /// Number of local atoms in the table.
+      int  nAtom_;
+
+      /// Configuration version for which the table was computed.
+      long  version_;
+
+      /// Is the table consistent with maxIntVector_?
+      bool  isCurrent_;
+
+   };
+
+   // Inline functions
+
+   inline int PhaseCache::nAtom() const
+   {  return nAtom_; }
+
+   inline int PhaseCache::typeId(int i) const
+   {  return typeIds_[i]; }
+
+   inline const Vector& PhaseCache::position(int i) const
+   {  return positions_[i]; }
+
+   inline 
+   std::complex<double> PhaseCache::phase(int i, int d, int n) const
+   {
+      assert(n <= maxIntVector_[d] && -n <= maxIntVector_[d]);
+      const std::complex<double>* ptr = &phases_[i*stride_ + offsets_[d]];
+      return (n >= 0) ? ptr[n] : std::conj(ptr[-n]);
+   }
+
+   inline 
+   std::complex<double> PhaseCache::phase(int i, const IntVector& k) const
+   {
+      std::complex<double> value = phase(i, 0, k[0]);
+      value *= phase(i, 1, k[1]);
+      value *= phase(i, 2, k[2]);
+      return value;
+   }
+
+   inline const IntVector& PhaseCache::maxIntVector() const
+   {  return maxIntVector_; }
+
+}
+#endif
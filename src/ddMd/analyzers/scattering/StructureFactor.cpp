@@ -8,11 +8,12 @@
 #include "StructureFactor.h"
 #include <ddMd/simulation/Simulation.h>
 #include <ddMd/simulation/SimulationAccess.h>
+#include <ddMd/analyzers/AnalyzerManager.h>
+#include <ddMd/analyzers/scattering/PhaseCache.h>
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/AtomIterator.h>
 #include <ddMd/communicate/Exchanger.h>
 #include <util/boundary/Boundary.h>
-#include <util/math/Constants.h>
 #include <util/space/Dimension.h>
 #include <util/space/IntVector.h>
 #include <util/misc/ioUtil.h>
@@ -20,6 +21,9 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <cmath>
+#include <cstdlib>
+
 namespace DdMd
 {
 
@@ -157,13 +161,12 @@ namespace DdMd
       }
 
       isFirstStep_ = false;
-      Vector position;
       std::complex<double> expFactor;
-      double  product;
-      AtomIterator  atomIter;
-      int i, j, typeId;
+      int i, j, a, nAtom, typeId;
 
       makeWaveVectors();
+      makePhaseTables();
+      const PhaseCache& cache = simulation().analyzerManager().phaseCache();
 
       // Set all Fourier modes to zero
       for (i = 0; i < nWave_; ++i) {
@@ -172,16 +175,12 @@ namespace DdMd
          }
       }
 
-      simulation().atomStorage().begin(atomIter);
-      for ( ; atomIter.notEnd(); ++atomIter) {
-         position = atomIter->position();
-         typeId   = atomIter->typeId();
- 
-         // Loop over wavevectors
+      // Loop over local atoms, exp(i k.r) = prod_d exp(i n_d b_d.r)
+      nAtom = cache.nAtom();
+      for (a = 0; a < nAtom; ++a) {
+         typeId = cache.typeId(a);
          for (i = 0; i < nWave_; ++i) {
-            
-            product = position.dot(waveVectors_[i]);
-            expFactor = exp( product*Constants::Im );
+            expFactor = cache.phase(a, waveIntVectors_[i]);
             for (j = 0; j < nMode_; ++j) {
                fourierModes_(i, j) += modes_(j, typeId)*expFactor;
             }
@@ -195,15 +194,10 @@ namespace DdMd
       }
  
       #ifdef UTIL_MPI
-      // Loop over wavevectors
-      for (int i = 0; i < nWave_; ++i) {
-         for (int j = 0; j < nMode_; ++j) {
-         //Sum values from all processors.
-         simulation().domain().communicator().
-                      Reduce(&fourierModes_(i, j), &totalFourierModes_(i, j),
-                             1, MPI::DOUBLE_COMPLEX, MPI::SUM, 0);
-         }
-      }
+      // Sum values from all processors, in one reduction of all elements
+      simulation().domain().communicator().
+                   Reduce(&fourierModes_(0, 0), &totalFourierModes_(0, 0),
+                          nWave_*nMode_, MPI::DOUBLE_COMPLEX, MPI::SUM, 0);
       #else
       for (int i = 0; i < nWave_; ++i) {
          for (int j = 0; j < nMode_; ++j) {
@@ -263,6 +257,26 @@ namespace DdMd
       }
    }
 
+   /*
+   * Find maximum Miller indices, and update shared phase factors.
+   */
+   void StructureFactor::makePhaseTables() 
+   {
+      int i, d, k;
+      for (d = 0; d < Dimension; ++d) {
+         maxIntVector_[d] = 0;
+      }
+      for (i = 0; i < nWave_; ++i) {
+         for (d = 0; d < Dimension; ++d) {
+            k = abs(waveIntVectors_[i][d]);
+            if (k > maxIntVector_[d]) maxIntVector_[d] = k;
+         }
+      }
+      PhaseCache& cache = simulation().analyzerManager().phaseCache();
+      cache.reserve(maxIntVector_);
+      cache.update(simulation());
+   }
+
    /*
    * Write data to three output files.
    */
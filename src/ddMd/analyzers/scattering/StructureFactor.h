@@ -12,6 +12,7 @@
 #include <ddMd/simulation/Simulation.h>
 #include <util/containers/DMatrix.h>              // member template
 #include <util/containers/DArray.h>               // member template
+#include <util/space/IntVector.h>                 // member
 
 #include <util/global.h>
 
@@ -174,6 +175,11 @@ namespace DdMd
       */
       DArray<Vector>  waveVectors_;
 
+      /**
+      * Maximum absolute value of each Miller index over all wavevectors.
+      */
+      IntVector  maxIntVector_;
+
       /**
       * Array of mode vectors 
       *
@@ -204,6 +210,14 @@ namespace DdMd
       */
       void makeWaveVectors();
 
+      /**
+      * Set maxIntVector_, and update the shared PhaseCache.
+      *
+      * Phase factors of local atoms are reused if another analyzer
+      * has already computed them for the current configuration.
+      */
+      void makePhaseTables();
+
    };
 
 }
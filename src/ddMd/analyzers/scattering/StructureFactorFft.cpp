@@ -0,0 +1,427 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "StructureFactorFft.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/math/Constants.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/format/Dbl.h>
+
+#include <cmath>
+#include <cstdlib>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   namespace
+   {
+
+      // Maximum allowed order of B-spline assignment function.
+      const int MaxOrder = 8;
+
+   }
+
+   /*
+   * Constructor.
+   */
+   StructureFactorFft::StructureFactorFft(Simulation& simulation)
+    : Analyzer(simulation),
+      qMax_(0.0),
+      dq_(0.0),
+      nBin_(0),
+      order_(4),
+      nMode_(0),
+      nGrid_(0),
+      nSample_(0),
+      nAtomType_(0),
+      hasPlan_(false),
+      isInitialized_(false)
+   {  setClassName("StructureFactorFft"); }
+
+   /*
+   * Destructor.
+   */
+   StructureFactorFft::~StructureFactorFft()
+   {
+      if (hasPlan_) {
+         fftw_destroy_plan(plan_);
+      }
+   }
+
+   /*
+   * Read parameters from file, and allocate memory.
+   */
+   void StructureFactorFft::readParameters(std::istream& in)
+   {
+      nAtomType_ = simulation().nAtomType();
+
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nMode", nMode_);
+      modes_.allocate(nMode_, nAtomType_);
+      readDMatrix<double>(in, "modes", modes_, nMode_, nAtomType_);
+      read<IntVector>(in, "gridDimensions", gridDimensions_);
+      order_ = 4;
+      readOptional<int>(in, "order", order_);
+      read<double>(in, "qMax", qMax_);
+      read<int>(in, "nBin", nBin_);
+
+      allocate();
+      nSample_ = 0;
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void StructureFactorFft::loadParameters(Serializable::IArchive &ar)
+   {
+      nAtomType_ = simulation().nAtomType();
+
+      // Load and broadcast parameter file parameters
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<int>(ar, "nMode", nMode_);
+      modes_.allocate(nMode_, nAtomType_);
+      loadDMatrix<double>(ar, "modes", modes_, nMode_, nAtomType_);
+      loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
+      order_ = 4;
+      loadParameter<int>(ar, "order", order_, false);
+      loadParameter<double>(ar, "qMax", qMax_);
+      loadParameter<int>(ar, "nBin", nBin_);
+
+      allocate();
+
+      // Load and broadcast nSample_
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      // Load accumulators that exist only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> structureFactors_;
+         ar >> binCounts_;
+      }
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void StructureFactorFft::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << nMode_;
+      ar << modes_;
+      ar << gridDimensions_;
+      Parameter::saveOptional(ar, order_, true);
+      ar << qMax_;
+      ar << nBin_;
+      ar << nSample_;
+      ar << structureFactors_;
+      ar << binCounts_;
+   }
+
+   /*
+   * Validate parameters, allocate grids, and create FFT plan.
+   */
+   void StructureFactorFft::allocate()
+   {
+      if (nMode_ <= 0) {
+         UTIL_THROW("nMode must be positive");
+      }
+      if (order_ < 2 || order_ > MaxOrder) {
+         UTIL_THROW("B-spline order must be in range [2, 8]");
+      }
+      if (qMax_ <= 0.0) {
+         UTIL_THROW("qMax must be positive");
+      }
+      if (nBin_ <= 0) {
+         UTIL_THROW("nBin must be positive");
+      }
+      nGrid_ = 1;
+      int d, m, size;
+      for (d = 0; d < Dimension; ++d) {
+         if (gridDimensions_[d] < order_) {
+            UTIL_THROW("Each grid dimension must be at least order");
+         }
+         nGrid_ *= gridDimensions_[d];
+      }
+      dq_ = qMax_/double(nBin_);
+
+      // Tabulate B-spline factors for all Fourier indices along each axis
+      size = 0;
+      for (d = 0; d < Dimension; ++d) {
+         bOrigins_[d] = size;
+         size += gridDimensions_[d];
+      }
+      bFactors_.allocate(size);
+      for (d = 0; d < Dimension; ++d) {
+         for (m = 0; m < gridDimensions_[d]; ++m) {
+            bFactors_[bOrigins_[d] + m] = bFactor(m, gridDimensions_[d]);
+         }
+      }
+
+      localGrid_.allocate(nMode_*nGrid_);
+
+      if (simulation().domain().isMaster()) {
+         structureFactors_.allocate(nMode_, nBin_);
+         binCounts_.allocate(nBin_);
+         #ifdef UTIL_MPI
+         totalGrid_.allocate(nMode_*nGrid_);
+         #endif
+         rhoR_.allocate(gridDimensions_);
+         rhoK_.allocate(gridDimensions_);
+
+         // Planning with FFTW_MEASURE overwrites both arrays
+         fftw_complex* inf;
+         fftw_complex* outf;
+         inf  = reinterpret_cast<fftw_complex*>(rhoR_.data());
+         outf = reinterpret_cast<fftw_complex*>(rhoK_.data());
+         plan_ = fftw_plan_dft_3d(gridDimensions_[0],
+                                  gridDimensions_[1],
+                                  gridDimensions_[2],
+                                  inf, outf,
+                                  FFTW_FORWARD, FFTW_MEASURE);
+         hasPlan_ = true;
+
+         int i, j;
+         for (i = 0; i < nMode_; ++i) {
+            for (j = 0; j < nBin_; ++j) {
+               structureFactors_(i, j) = 0.0;
+            }
+         }
+         for (j = 0; j < nBin_; ++j) {
+            binCounts_[j] = 0;
+         }
+      }
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void StructureFactorFft::clear()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nSample_ = 0;
+      if (simulation().domain().isMaster()) {
+         int i, j;
+         for (i = 0; i < nMode_; ++i) {
+            for (j = 0; j < nBin_; ++j) {
+               structureFactors_(i, j) = 0.0;
+            }
+         }
+         for (j = 0; j < nBin_; ++j) {
+            binCounts_[j] = 0;
+         }
+      }
+   }
+
+   /*
+   * Assign atoms to grid, transform, and increment accumulators.
+   */
+   void StructureFactorFft::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+
+      Boundary& boundary = simulation().boundary();
+      double weights[Dimension][MaxOrder];
+      int knots[Dimension][MaxOrder];
+      Vector gpos;
+      AtomIterator atomIter;
+      double u, wx, wxy, w;
+      int i, j, k, d, n, r, typeId, floorIdx;
+
+      for (r = 0; r < nMode_*nGrid_; ++r) {
+         localGrid_[r] = 0.0;
+      }
+
+      // Assign local atoms to the grid with B-spline weights
+      simulation().atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         typeId = atomIter->typeId();
+         boundary.transformCartToGen(atomIter->position(), gpos);
+         for (d = 0; d < Dimension; ++d) {
+            u = gpos[d] - floor(gpos[d]);
+            u *= double(gridDimensions_[d]);
+            floorIdx = int(floor(u));
+            computeWeights(u - double(floorIdx), weights[d]);
+            for (j = 0; j < order_; ++j) {
+               n = floorIdx - j;
+               while (n < 0) n += gridDimensions_[d];
+               while (n >= gridDimensions_[d]) n -= gridDimensions_[d];
+               knots[d][j] = n;
+            }
+         }
+         for (i = 0; i < order_; ++i) {
+            wx = weights[0][i];
+            for (j = 0; j < order_; ++j) {
+               wxy = wx*weights[1][j];
+               for (k = 0; k < order_; ++k) {
+                  w = wxy*weights[2][k];
+                  r = (knots[0][i]*gridDimensions_[1] + knots[1][j])
+                      *gridDimensions_[2] + knots[2][k];
+                  for (n = 0; n < nMode_; ++n) {
+                     localGrid_[n*nGrid_ + r] += modes_(n, typeId)*w;
+                  }
+               }
+            }
+         }
+      }
+
+      // Sum grids from all processors onto the master
+      const double* gridPtr = 0;
+      #ifdef UTIL_MPI
+      double* totalPtr = 0;
+      if (simulation().domain().isMaster()) {
+         totalPtr = &totalGrid_[0];
+      }
+      simulation().domain().communicator().
+                   Reduce(&localGrid_[0], totalPtr, nMode_*nGrid_,
+                          MPI::DOUBLE, MPI::SUM, 0);
+      gridPtr = totalPtr;
+      #else
+      gridPtr = &localGrid_[0];
+      #endif
+
+      if (simulation().domain().isMaster()) {
+         double volume = boundary.volume();
+         double bx, bxy, value;
+         Vector b0 = boundary.reciprocalBasisVector(0);
+         Vector b1 = boundary.reciprocalBasisVector(1);
+         Vector b2 = boundary.reciprocalBasisVector(2);
+         Vector q0, q1, q;
+         int m0, m1, m2, bin;
+         const int n0 = gridDimensions_[0];
+         const int n1 = gridDimensions_[1];
+         const int n2 = gridDimensions_[2];
+
+         for (n = 0; n < nMode_; ++n) {
+            for (r = 0; r < nGrid_; ++r) {
+               rhoR_[r] = std::complex<double>(gridPtr[n*nGrid_ + r], 0.0);
+            }
+            fftw_execute(plan_);
+
+            // Add deconvolved |rho(k)|^2/V to shells, omitting k = 0
+            // and wavevectors with any Miller index at the Nyquist limit
+            r = 0;
+            for (i = 0; i < n0; ++i) {
+               m0 = (i <= n0/2) ? i : i - n0;
+               q0.multiply(b0, m0);
+               bx = bFactors_[bOrigins_[0] + i];
+               for (j = 0; j < n1; ++j) {
+                  m1 = (j <= n1/2) ? j : j - n1;
+                  q1.multiply(b1, m1);
+                  q1 += q0;
+                  bxy = bx*bFactors_[bOrigins_[1] + j];
+                  for (k = 0; k < n2; ++k, ++r) {
+                     m2 = (k <= n2/2) ? k : k - n2;
+                     if (2*abs(m0) >= n0) continue;
+                     if (2*abs(m1) >= n1) continue;
+                     if (2*abs(m2) >= n2) continue;
+                     if (m0 == 0 && m1 == 0 && m2 == 0) continue;
+                     q.multiply(b2, m2);
+                     q += q1;
+                     bin = int(q.abs()/dq_);
+                     if (bin >= nBin_) continue;
+                     value = std::norm(rhoK_[r])/volume;
+                     value *= bxy*bFactors_[bOrigins_[2] + k];
+                     structureFactors_(n, bin) += value;
+                     if (n == 0) {
+                        ++binCounts_[bin];
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+      ++nSample_;
+   }
+
+   /*
+   * Output averages to file.
+   */
+   void StructureFactorFft::output()
+   {
+      if (simulation().domain().isMaster()) {
+
+         // Write parameters to a *.prm file
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Output shell averages, one line per non-empty shell
+         simulation().fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+         int i, j;
+         for (i = 0; i < nBin_; ++i) {
+            if (binCounts_[i] > 0) {
+               outputFile_ << Dbl((double(i) + 0.5)*dq_, 20, 8);
+               for (j = 0; j < nMode_; ++j) {
+                  outputFile_ << Dbl(structureFactors_(j, i)/double(binCounts_[i]), 20, 8);
+               }
+               outputFile_ << std::endl;
+            }
+         }
+         outputFile_.close();
+      }
+   }
+
+   /*
+   * Compute B-spline weights by the Cox-de Boor recursion.
+   */
+   void StructureFactorFft::computeWeights(double w, double* weights) const
+   {
+      int j, k;
+      double c;
+      weights[0] = 1.0;
+      for (k = 2; k <= order_; ++k) {
+         c = 1.0/double(k - 1);
+         weights[k-1] = c*(1.0 - w)*weights[k-2];
+         for (j = k - 2; j > 0; --j) {
+            weights[j] = c*((w + j)*weights[j] + (k - w - j)*weights[j-1]);
+         }
+         weights[0] = c*w*weights[0];
+      }
+   }
+
+   /*
+   * Squared modulus of the inverse Fourier transform of the B-spline.
+   */
+   double StructureFactorFft::bFactor(int m, int nGrid) const
+   {
+      // For odd order, the denominator vanishes when 2*m = nGrid.
+      if (order_%2 == 1 && 2*m == nGrid) {
+         return 0.0;
+      }
+
+      // Values of B-spline at integers: spline[j] = M_order(j)
+      double spline[MaxOrder];
+      computeWeights(0.0, spline);
+
+      double pi = Constants::Pi;
+      double arg;
+      std::complex<double> denom(0.0, 0.0);
+      for (int k = 0; k <= order_ - 2; ++k) {
+         arg = 2.0*pi*double(m)*double(k)/double(nGrid);
+         denom += spline[k + 1]*std::complex<double>(cos(arg), sin(arg));
+      }
+      return 1.0/std::norm(denom);
+   }
+
+}
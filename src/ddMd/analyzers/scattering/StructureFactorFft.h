@@ -0,0 +1,258 @@
+#ifndef DDMD_STRUCTURE_FACTOR_FFT_H
+#define DDMD_STRUCTURE_FACTOR_FFT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/simulation/Simulation.h>
+#include <util/containers/DMatrix.h>              // member template
+#include <util/containers/DArray.h>               // member template
+#include <util/containers/GridArray.h>            // member template
+#include <util/space/IntVector.h>                 // member
+
+#include <complex>
+#include <fftw3.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * StructureFactorFft evaluates a spherically averaged structure factor.
+   *
+   * This analyzer computes the same quantity as StructureFactorGrid,
+   * \f$ S_{m}(k) = < \rho_m(k) \rho_m(-k) / V > \f$ for modes m defined
+   * by weight factors for atom types, but evaluates all Fourier modes of
+   * a regular grid at once by a fast Fourier transform (FFT), and then
+   * averages over wavevectors in spherical shells of equal width in |k|.
+   * The cost of each sample is thus O(N + K log K) for N atoms on a grid
+   * of K points, rather than O(NK) for a direct sum over atoms.
+   *
+   * Each processor assigns its local atoms to a grid that spans the
+   * entire periodic unit cell, using cardinal B-splines of a chosen
+   * order. Grids are summed onto the master processor, which performs
+   * one FFT per mode. The smoothing introduced by B-spline assignment
+   * is removed by dividing each Fourier amplitude by the Fourier
+   * transform of the assignment function, exactly as in the smooth
+   * particle mesh Ewald method (McMd::MdSpmePotential). Wavevectors
+   * with any component at or above the Nyquist index gridDimensions/2
+   * are discarded, so qMax should be chosen well below the Nyquist
+   * wavenumber along each axis.
+   *
+   * Example: For a system with nAtomType = 2, to calculate the total
+   * density and composition structure factors up to |k| = 10:
+   *
+   * \code
+   * StructureFactorFft{
+   *    interval                     1000
+   *    outputFileName   StructureFactorFft
+   *    nMode                           2
+   *    modes                    1      1
+   *                             1     -1
+   *    gridDimensions    64    64     64
+   *    order                           4
+   *    qMax                         10.0
+   *    nBin                          200
+   * }
+   * \endcode
+   *
+   * At the end of a simulation, averages are output to a file with a
+   * suffix *.dat. Each line contains the value of |k| at the center of
+   * a shell, followed by one structure factor value for each mode.
+   *
+   * This class is only available if the code is compiled with FFTW
+   * (i.e., if SIMP_FFTW is defined).
+   *
+   * \sa \ref ddMd_analyzer_StructureFactorFft_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Scattering_Module
+   */
+   class StructureFactorFft : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation  reference to parent Simulation object
+      */
+      StructureFactorFft(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~StructureFactorFft();
+
+      /**
+      * Read parameters from file.
+      *
+      * Input format:
+      *
+      *   - int               interval        sampling interval
+      *   - string            outputFileName  output file base name
+      *   - int               nMode           number of modes
+      *   - DMatrix<double>   modes           mode vectors
+      *   - IntVector         gridDimensions  number of grid points
+      *   - int               order           B-spline order (optional)
+      *   - double            qMax            maximum wavenumber
+      *   - int               nBin            number of shells in |k|
+      *
+      * \param in  input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar  input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar  output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear accumulators.
+      */
+      virtual void clear();
+
+      /**
+      * Assign atoms to grid, transform, and add to accumulators.
+      *
+      * \param iStep  MD time step counter
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output shell averaged structure factors.
+      */
+      virtual void output();
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /**
+      * Structure factor accumulators (master only).
+      *
+      * First index is mode, second index is shell (bin) index.
+      */
+      DMatrix<double> structureFactors_;
+
+      /**
+      * Number of wavevectors added to each shell (master only).
+      */
+      DArray<long> binCounts_;
+
+      /**
+      * Densities of local atoms on grid, for all modes.
+      *
+      * Element iMode*nGrid + r is the value for mode iMode at grid
+      * point of rank r in a GridArray of dimensions gridDimensions_.
+      */
+      DArray<double> localGrid_;
+
+      /**
+      * Sum of localGrid_ over processors (master only).
+      */
+      DArray<double> totalGrid_;
+
+      /**
+      * Density of one mode on grid, before FFT (master only).
+      */
+      GridArray< std::complex<double> > rhoR_;
+
+      /**
+      * Fourier amplitudes for one mode (master only).
+      */
+      GridArray< std::complex<double> > rhoK_;
+
+      /**
+      * Squared magnitude of inverse B-spline Fourier transform.
+      *
+      * Element bOrigins_[d] + m is the factor for index m along axis d.
+      */
+      DArray<double> bFactors_;
+
+      /**
+      * Array of mode vectors.
+      *
+      * First index is mode, second is atomType.
+      */
+      DMatrix<double>  modes_;
+
+      /// Number of grid points along each axis.
+      IntVector gridDimensions_;
+
+      /// Index of first element of bFactors_ for each axis.
+      IntVector bOrigins_;
+
+      /// FFTW plan for forward transform of rhoR_ to rhoK_.
+      fftw_plan plan_;
+
+      /// Maximum wavenumber.
+      double qMax_;
+
+      /// Width of each shell in |k|.
+      double dq_;
+
+      /// Number of shells in |k|.
+      int  nBin_;
+
+      /// Order of B-spline assignment function.
+      int  order_;
+
+      /// Number of mode vectors
+      int  nMode_;
+
+      /// Number of grid points.
+      int  nGrid_;
+
+      /// Number of samples thus far.
+      int  nSample_;
+
+      /// Number of atom types, copied from Simulation::nAtomType().
+      int  nAtomType_;
+
+      /// Has a plan been created?
+      bool hasPlan_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Allocate grids and create FFT plan, after reading parameters.
+      */
+      void allocate();
+
+      /**
+      * Compute B-spline weights for one coordinate.
+      *
+      * On output, weights[j] = M_order(w + j) for 0 <= j < order, in
+      * which M_order is the cardinal B-spline. This is the weight for
+      * grid point floor(u) - j, for scaled coordinate u with fractional
+      * part w = u - floor(u).
+      */
+      void computeWeights(double w, double* weights) const;
+
+      /**
+      * Compute bFactor for Fourier index m along an axis with nGrid points.
+      */
+      double bFactor(int m, int nGrid) const;
+
+   };
+
+}
+#endif
@@ -8,6 +8,8 @@
 #include "VanHove.h"
 #include <ddMd/simulation/Simulation.h>
 #include <ddMd/simulation/SimulationAccess.h>
+#include <ddMd/analyzers/AnalyzerManager.h>
+#include <ddMd/analyzers/scattering/PhaseCache.h>
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/AtomIterator.h>
 #include <ddMd/communicate/Exchanger.h>
@@ -23,6 +25,8 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <cstdlib>
+
 namespace DdMd
 {
 
@@ -69,6 +73,13 @@ namespace DdMd
       }
 
       readDArray<IntVector>(in, "waveIntVectors", waveIntVectors_, nWave_);
+
+      Vector lower(0.0);
+      Vector upper(1.0);
+      readOptional<Vector>(in, "windowLower", lower);
+      readOptional<Vector>(in, "windowUpper", upper);
+      setWindowAndIndices(lower, upper);
+
       isInitialized_ = true;
    }
 
@@ -86,6 +97,11 @@ namespace DdMd
       loadParameter<int>(ar, "nWave", nWave_);
       waveIntVectors_.allocate(nWave_);
       loadDArray<IntVector>(ar, "waveIntVectors", waveIntVectors_, nWave_);
+      Vector lower(0.0);
+      Vector upper(1.0);
+      loadParameter<Vector>(ar, "windowLower", lower, false);
+      loadParameter<Vector>(ar, "windowUpper", upper, false);
+      setWindowAndIndices(lower, upper);
 
       // Load and broadcast nSample_
       MpiLoader<Serializable::IArchive> loader(*this, ar);
@@ -114,6 +130,11 @@ namespace DdMd
       ar << nBuffer_;
       ar << nWave_;
       ar << waveIntVectors_;
+      Vector lower = window_.lower();
+      Vector upper = window_.upper();
+      bool isActive = window_.isActive();
+      Parameter::saveOptional(ar, lower, isActive);
+      Parameter::saveOptional(ar, upper, isActive);
 
       ar << nSample_;
 
@@ -145,11 +166,8 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
 
-         Vector  position;
-         std::complex<double>  expFactor;
-         double  product, coeff;
-         AtomIterator  atomIter;
-         int  i, typeId;
+         double  coeff;
+         int  i, a, nAtom;
 
          makeWaveVectors();
 
@@ -158,18 +176,18 @@ namespace DdMd
             fourierModes_[i] = std::complex<double>(0.0, 0.0);
          }
  
-         simulation().atomStorage().begin(atomIter);
-         for ( ; atomIter.notEnd(); ++atomIter) {
-            position = atomIter->position();
-            typeId   = atomIter->typeId();
-            coeff    = atomTypeCoeffs_[typeId];
-            
-            // Loop over wavevectors
-            for (i = 0; i < nWave_; ++i) {
-
-               product = position.dot(waveVectors_[i]);
-               expFactor = exp( product*Constants::Im );
-               fourierModes_[i] += coeff*expFactor;
+         // Add local atoms within the window, using shared phase factors
+         if (window_.overlaps(simulation().domain())) {
+            PhaseCache& cache = simulation().analyzerManager().phaseCache();
+            cache.reserve(maxIntVector_);
+            cache.update(simulation());
+            nAtom = cache.nAtom();
+            for (a = 0; a < nAtom; ++a) {
+               if (!window_.contains(cache.position(a))) continue;
+               coeff = atomTypeCoeffs_[cache.typeId(a)];
+               for (i = 0; i < nWave_; ++i) {
+                  fourierModes_[i] += coeff*cache.phase(a, waveIntVectors_[i]);
+               }
             }
          }
   
@@ -178,13 +196,10 @@ namespace DdMd
          }
 
          #ifdef UTIL_MPI
-         // Loop over wavevectors
-         for (int i = 0; i < nWave_; ++i) {
-            //Sum values from all processors.
-            simulation().domain().communicator().
-            Reduce(&fourierModes_[i], &totalFourierModes_[i],
-                    1, MPI::DOUBLE_COMPLEX, MPI::SUM, 0);
-         }
+         // Sum values from all processors, in one reduction
+         simulation().domain().communicator().
+                      Reduce(&fourierModes_[0], &totalFourierModes_[0],
+                             nWave_, MPI::DOUBLE_COMPLEX, MPI::SUM, 0);
          #else
          for (int i = 0; i < nWave_; ++i) {
             totalFourierModes_[i] = fourierModes_[i];
@@ -193,7 +208,11 @@ namespace DdMd
          
          if (simulation().domain().isMaster()) {
             // Add Fourier modes to autocorrelation accumulators
-            double sqrtV = sqrt(simulation().boundary().volume());
+            double volume = simulation().boundary().volume();
+            for (int d = 0; d < Dimension; ++d) {
+               volume *= window_.upper()[d] - window_.lower()[d];
+            }
+            double sqrtV = sqrt(volume);
             for (int i = 0; i < nWave_; ++i) {
                accumulators_[i].sample(totalFourierModes_[i]/sqrtV);
             }
@@ -203,6 +222,25 @@ namespace DdMd
 
    }
 
+   /*
+   * Set spatial window, and find maximum Miller indices (private).
+   */
+   void VanHove::setWindowAndIndices(const Vector& lower,
+                                     const Vector& upper)
+   {
+      window_.set(lower, upper);
+      int i, d, k;
+      for (d = 0; d < Dimension; ++d) {
+         maxIntVector_[d] = 0;
+      }
+      for (i = 0; i < nWave_; ++i) {
+         for (d = 0; d < Dimension; ++d) {
+            k = abs(waveIntVectors_[i][d]);
+            if (k > maxIntVector_[d]) maxIntVector_[d] = k;
+         }
+      }
+   }
+
    /**
    * Calculate floating point wavevectors.
    */
@@ -8,6 +8,7 @@
 * Distributed under the terms of the GNU General Public License.
 */
 #include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/analyzers/SpatialWindow.h>     // member
 #include <ddMd/simulation/Simulation.h>
 #include <util/containers/DArray.h>             // member template
 #include <util/containers/DMatrix.h>            // member template
@@ -36,7 +37,14 @@ namespace DdMd
    *     \psi(k,t) = \sum_{i} c_{a} \exp( i k \cdot r_i )
    * \f]
    * over all atoms in the system, where \f$ c_{a} \f$ is a user-specified 
-   * coefficient for monomers of type a. 
+   * coefficient for monomers of type a. If optional windowLower and
+   * windowUpper parameters are given, the sum is restricted to atoms
+   * within a rectangular window in reduced coordinates (see
+   * SpatialWindow), and V is the volume of the window. Processors whose
+   * domains do not overlap the window skip their atoms.
+   *
+   * Phase factors are taken from the PhaseCache of the AnalyzerManager,
+   * and so are computed only once per step for all scattering analyzers.
    *
    * The Van Hove class can calculate S(k,t) for a list of wavevectors.
    * Each wavevector is specified as an IntVector containing integer 
@@ -101,6 +109,8 @@ namespace DdMd
       *   - int               nBuffer         number of samples in buffer
       *   - int               nWave           number of wavevectors
       *   - DArray<IntVector> waveIntVectors  IntVector wavevectors
+      *   - Vector            windowLower     lower window bounds (optional)
+      *   - Vector            windowUpper     upper window bounds (optional)
       *
       * \param in input parameter stream
       */
@@ -160,6 +170,12 @@ namespace DdMd
       /// Array of coefficients for atom types.
       DArray<double>  atomTypeCoeffs_;
 
+      /// Region of reduced coordinates included in the sums.
+      SpatialWindow  window_;
+
+      /// Maximum absolute value of each Miller index over all wavevectors.
+      IntVector  maxIntVector_;
+
       /// Number of wavevectors.
       int  nWave_;
 
@@ -178,6 +194,9 @@ namespace DdMd
       /// Update wavevectors.
       void makeWaveVectors();
 
+      /// Set spatial window, and set maxIntVector_ from wavevectors.
+      void setWindowAndIndices(const Vector& lower, const Vector& upper);
+
    };
 
 }
@@ -1,8 +1,14 @@
 ddMd_analyzers_scattering_=\
+     ddMd/analyzers/scattering/PhaseCache.cpp\
      ddMd/analyzers/scattering/StructureFactor.cpp\
      ddMd/analyzers/scattering/StructureFactorGrid.cpp\
      ddMd/analyzers/scattering/VanHove.cpp
 
+ifdef SIMP_FFTW
+ddMd_analyzers_scattering_+=\
+     ddMd/analyzers/scattering/StructureFactorFft.cpp
+endif
+
 ddMd_analyzers_scattering_SRCS=\
      $(addprefix $(SRC_DIR)/, $(ddMd_analyzers_scattering_))
 ddMd_analyzers_scattering_OBJS=\
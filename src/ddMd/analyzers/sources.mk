@@ -16,6 +16,7 @@ ddMd_analyzers_+=\
      ddMd/analyzers/AnalyzerManager.cpp\
      ddMd/analyzers/AnalyzerFactory.cpp\
      ddMd/analyzers/AverageAnalyzer.cpp\
+     ddMd/analyzers/HistogramAnalyzer.cpp\
      ddMd/analyzers/TensorAverageAnalyzer.cpp\
      ddMd/analyzers/SymmTensorAverageAnalyzer.cpp
 
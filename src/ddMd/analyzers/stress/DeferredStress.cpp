@@ -0,0 +1,107 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DeferredStress.h"
+#include <ddMd/simulation/Simulation.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   DeferredStress::DeferredStress()
+    : localValues_(),
+      totalValues_(),
+      volumes_(),
+      capacity_(1),
+      size_(0)
+   {  setCapacity(1); }
+
+   /*
+   * Set capacity, and discard stored samples.
+   */
+   void DeferredStress::setCapacity(int capacity)
+   {
+      if (capacity < 1) {
+         UTIL_THROW("DeferredStress capacity must be at least 1");
+      }
+      capacity_ = capacity;
+      localValues_.resize(capacity_*Dimension*Dimension);
+      totalValues_.resize(capacity_*Dimension*Dimension);
+      volumes_.resize(capacity_);
+      size_ = 0;
+   }
+
+   /*
+   * Store local stress and volume for the current step.
+   */
+   void DeferredStress::sample(Simulation& simulation)
+   {
+      if (isFull()) {
+         UTIL_THROW("DeferredStress buffer is full");
+      }
+      Tensor stress;
+      simulation.computeLocalStress(stress);
+      double* ptr = &localValues_[size_*Dimension*Dimension];
+      int i, j;
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            *ptr = stress(i, j);
+            ++ptr;
+         }
+      }
+      volumes_[size_] = simulation.boundary().volume();
+      ++size_;
+   }
+
+   /*
+   * Sum stored stresses onto master, with one reduction.
+   */
+   void DeferredStress::reduce(Simulation& simulation)
+   {
+      int n = size_*Dimension*Dimension;
+      if (n == 0) {
+         return;
+      }
+      #ifdef UTIL_MPI
+      simulation.domain().communicator().Reduce(&localValues_[0],
+                                                &totalValues_[0], n,
+                                                MPI::DOUBLE, MPI::SUM, 0);
+      #else
+      for (int i = 0; i < n; ++i) {
+         totalValues_[i] = localValues_[i];
+      }
+      #endif
+   }
+
+   /*
+   * Discard stored samples.
+   */
+   void DeferredStress::clear()
+   {  size_ = 0; }
+
+   /*
+   * Return total stress for one sample (master only).
+   */
+   Tensor DeferredStress::stress(int i) const
+   {
+      Tensor stress;
+      const double* ptr = &totalValues_[i*Dimension*Dimension];
+      int j, k;
+      for (j = 0; j < Dimension; ++j) {
+         for (k = 0; k < Dimension; ++k) {
+            stress(j, k) = *ptr;
+            ++ptr;
+         }
+      }
+      return stress;
+   }
+
+}
@@ -0,0 +1,147 @@
+#ifndef DDMD_DEFERRED_STRESS_H
+#define DDMD_DEFERRED_STRESS_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/space/Tensor.h>                // inline function
+#include <util/global.h>
+
+#include <vector>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Buffer of local stresses for several steps, summed in one reduction.
+   *
+   * A DeferredStress is used by analyzers that sample the total stress
+   * on many steps, but that do not need the value immediately. Each call
+   * to sample() stores the contribution of this processor to the total
+   * (kinetic + virial) stress, given by Simulation::computeLocalStress(),
+   * and the system volume, without communication. A collective call to
+   * reduce() then sums all stored stresses onto the master processor
+   * with a single reduction of a packed buffer, after which stress(i)
+   * and volume(i) give the total stress and volume for sample i, in the
+   * order sampled, on the master. The analyzer should then process these
+   * values and call clear() before the next call to sample().
+   *
+   * \ingroup DdMd_Analyzer_Stress_Module
+   */
+   class DeferredStress
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      DeferredStress();
+
+      /**
+      * Set the maximum number of samples stored between reductions.
+      *
+      * Discards any stored samples.
+      *
+      * \param capacity number of samples per reduction (at least 1)
+      */
+      void setCapacity(int capacity);
+
+      /**
+      * Store the local stress and volume of the current step.
+      *
+      * Call on all processors. Does not communicate.
+      *
+      * \pre isFull() is false
+      *
+      * \param simulation parent Simulation
+      */
+      void sample(Simulation& simulation);
+
+      /**
+      * Sum stored stresses onto the master processor.
+      *
+      * Call on all processors, with equal values of size(). Does nothing
+      * if no samples are stored.
+      *
+      * \param simulation parent Simulation
+      */
+      void reduce(Simulation& simulation);
+
+      /**
+      * Discard all stored samples.
+      */
+      void clear();
+
+      /**
+      * Total stress for one sample, after reduce (master only).
+      *
+      * \param i sample index, 0 <= i < size()
+      */
+      Tensor stress(int i) const;
+
+      /**
+      * System volume for one sample.
+      *
+      * \param i sample index, 0 <= i < size()
+      */
+      double volume(int i) const;
+
+      /**
+      * Number of stored samples.
+      */
+      int size() const;
+
+      /**
+      * Maximum number of stored samples.
+      */
+      int capacity() const;
+
+      /**
+      * Is the buffer full (size() == capacity())?
+      */
+      bool isFull() const;
+
+   private:
+
+      /// Local stresses, Dimension*Dimension values per sample.
+      std::vector<double> localValues_;
+
+      /// Total stresses on master, in the same format.
+      std::vector<double> totalValues_;
+
+      /// System volume for each sample.
+      std::vector<double> volumes_;
+
+      /// Maximum number of samples.
+      int capacity_;
+
+      /// Number of stored samples.
+      int size_;
+
+   };
+
+   // Inline functions
+
+   inline double DeferredStress::volume(int i) const
+   {  return volumes_[i]; }
+
+   inline int DeferredStress::size() const
+   {  return size_; }
+
+   inline int DeferredStress::capacity() const
+   {  return capacity_; }
+
+   inline bool DeferredStress::isFull() const
+   {  return (size_ == capacity_); }
+
+}
+#endif
@@ -92,8 +92,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sys = simulation();
-         sys.computeVirialStress();
-         sys.computeKineticStress();
+         sys.computeThermo(false, true);
          if (sys.domain().isMaster()) {
             Vector L = sys.boundary().lengths();
             double V = sys.boundary().volume();
@@ -102,11 +101,21 @@ namespace DdMd
                         << Dbl(L[1], 20)
                         << Dbl(L[2], 20)
                         << Dbl(V, 20)
-                        << std::endl;
+                        << "\n";
          }
 
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputBoxdim::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
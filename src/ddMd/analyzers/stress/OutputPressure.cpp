@@ -98,8 +98,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sys = simulation();
-         sys.computeVirialStress();
-         sys.computeKineticStress();
+         sys.computeThermo(false, true);
          if (sys.domain().isMaster()) {
             double virial  = sys.virialPressure();
             double kinetic = sys.kineticPressure();
@@ -107,11 +106,21 @@ namespace DdMd
                         << Dbl(kinetic, 20)
                         << Dbl(virial, 20)
                         << Dbl(kinetic + virial, 20)
-                        << std::endl;
+                        << "\n";
          }
 
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputPressure::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
@@ -80,6 +80,11 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Flush buffered output lines to file.
+      */
+      virtual void flush();
+
    private:
  
       /// Output file stream
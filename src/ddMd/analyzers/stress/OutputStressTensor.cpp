@@ -100,8 +100,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sys = simulation();
-         sys.computeVirialStress();
-         sys.computeKineticStress();
+         sys.computeThermo(false, true);
          if (sys.domain().isMaster()) {
             Tensor virial  = sys.virialStress();
             Tensor kinetic = sys.kineticStress();
@@ -135,11 +134,21 @@ namespace DdMd
                         << Dbl(total(2,0), 20)
                         << Dbl(total(2,1), 20)
                         << Dbl(total(2,2), 20)
-                        << std::endl;
+                        << "\n";
          }
 
          ++nSample_;
       }
    }
 
+   /*
+   * Flush buffered output lines to file.
+   */
+   void OutputStressTensor::flush()
+   {
+      if (outputFile_.is_open()) {
+         outputFile_.flush();
+      }
+   }
+
 }
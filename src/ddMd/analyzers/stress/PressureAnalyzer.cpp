@@ -33,8 +33,7 @@ namespace DdMd
    */
    void PressureAnalyzer::compute() 
    {  
-      simulation().computeVirialStress(); 
-      simulation().computeKineticStress(); 
+      simulation().computeThermo(false, true);
    }
 
    /*
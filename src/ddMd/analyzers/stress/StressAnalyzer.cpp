@@ -32,8 +32,7 @@ namespace DdMd
    */
    void StressAnalyzer::compute() 
    {  
-      simulation().computeVirialStress(); 
-      simulation().computeKineticStress(); 
+      simulation().computeThermo(false, true);
    }
 
    /*
@@ -23,9 +23,12 @@ namespace DdMd
    */
    StressAutoCorr::StressAutoCorr(Simulation& simulation) 
     : Analyzer(simulation),
+      deferred_(),
       accumulatorPtr_(0),
       bufferCapacity_(-1),
       maxStageId_(10),
+      blockFactor_(2),
+      reductionInterval_(1),
       isInitialized_(false)
    {  setClassName("StressAutoCorr"); }
 
@@ -37,9 +40,25 @@ namespace DdMd
       readInterval(in);
       readOutputFileName(in);
       read<int>(in,"bufferCapacity", bufferCapacity_);
+      maxStageId_ = 10;
+      readOptional<int>(in, "maxStageId", maxStageId_);
+      blockFactor_ = 2;
+      readOptional<int>(in, "blockFactor", blockFactor_);
+      reductionInterval_ = 1;
+      readOptional<int>(in, "reductionInterval", reductionInterval_);
+      if (maxStageId_ < 0) {
+         UTIL_THROW("Negative maxStageId");
+      }
+      if (blockFactor_ < 2) {
+         UTIL_THROW("blockFactor must be at least 2");
+      }
+      if (reductionInterval_ < 1) {
+         UTIL_THROW("reductionInterval must be at least 1");
+      }
+      deferred_.setCapacity(reductionInterval_);
       if (simulation().domain().isMaster()) {
          accumulatorPtr_ = new AutoCorrelation<Tensor, double>;
-         accumulatorPtr_->setParam(bufferCapacity_, maxStageId_);
+         accumulatorPtr_->setParam(bufferCapacity_, maxStageId_, blockFactor_);
       }
       isInitialized_ = true;
    }
@@ -53,6 +72,13 @@ namespace DdMd
       loadInterval(ar);
       loadOutputFileName(ar);
       loadParameter(ar, "bufferCapacity", bufferCapacity_);
+      maxStageId_ = 10;
+      loadParameter<int>(ar, "maxStageId", maxStageId_, false);
+      blockFactor_ = 2;
+      loadParameter<int>(ar, "blockFactor", blockFactor_, false);
+      reductionInterval_ = 1;
+      loadParameter<int>(ar, "reductionInterval", reductionInterval_, false);
+      deferred_.setCapacity(reductionInterval_);
 
       if (simulation().domain().isMaster()) {
          accumulatorPtr_ = new AutoCorrelation<Tensor, double>;
@@ -70,6 +96,9 @@ namespace DdMd
       saveInterval(ar);
       saveOutputFileName(ar);
       ar & bufferCapacity_;
+      Parameter::saveOptional(ar, maxStageId_, true);
+      Parameter::saveOptional(ar, blockFactor_, true);
+      Parameter::saveOptional(ar, reductionInterval_, true);
       if (simulation().domain().isMaster()) {
          if (!accumulatorPtr_) {
             UTIL_THROW("Null accumulatorPtr_ on master");
@@ -86,6 +115,7 @@ namespace DdMd
       if (!isInitialized_) {
          UTIL_THROW("Error: Object not initialized");
       }
+      deferred_.clear();
       if (simulation().domain().isMaster()) {
          if (!accumulatorPtr_) {
             UTIL_THROW("Null accumulatorPtr_ on master");
@@ -112,23 +142,31 @@ namespace DdMd
    void StressAutoCorr::sample(long iStep) 
    {  
       if (isAtInterval(iStep))  {
-         Simulation& sim = simulation();
-         sim.computeVirialStress();
-         sim.computeKineticStress();
-
-         if (sim.domain().isMaster()) {
-            if (!accumulatorPtr_) {
-               UTIL_THROW("Null accumulatorPtr_ on master");
-            }
+         deferred_.sample(simulation());
+         if (deferred_.isFull()) {
+            processDeferred();
+         }
+      }
+   }
 
-            Tensor virial  = sim.virialStress();
-            Tensor kinetic = sim.kineticStress();
-            Tensor total;
-            total.add(virial, kinetic);
+   /*
+   * Reduce stored stresses, and add them to the accumulator in order.
+   */
+   void StressAutoCorr::processDeferred()
+   {
+      deferred_.reduce(simulation());
+      if (simulation().domain().isMaster()) {
+         if (!accumulatorPtr_) {
+            UTIL_THROW("Null accumulatorPtr_ on master");
+         }
+         Tensor total;
+         double pressure, factor;
+         int i, j, k;
+         for (k = 0; k < deferred_.size(); ++k) {
+            total = deferred_.stress(k);
 
             // Remove trace
-            double pressure = 0.0;
-            int i, j;
+            pressure = 0.0;
             for (i = 0; i < Dimension; ++i) {
                pressure += total(i,i);
             }
@@ -136,17 +174,18 @@ namespace DdMd
             for (i = 0; i < Dimension; ++i) {
                total(i,i) -= pressure;
             }
-   
-            double factor = sqrt(sim.boundary().volume()/10.0);
+
+            factor = sqrt(deferred_.volume(k)/10.0);
             for (i = 0; i < Dimension; ++i) {
                for (j = 0; j < Dimension; ++j) {
                   total(i,j) *= factor;
                }
             }
-   
+
             accumulatorPtr_->sample(total);
          }
       }
+      deferred_.clear();
    }
 
    /*
@@ -154,6 +193,7 @@ namespace DdMd
    */
    void StressAutoCorr::output() 
    {
+      processDeferred();
       if (simulation().domain().isMaster()) {
          if (!accumulatorPtr_) {
             UTIL_THROW("Null accumulatorPtr_ on master");
@@ -163,6 +203,9 @@ namespace DdMd
          writeParam(outputFile_);
          outputFile_ << std::endl;
          outputFile_ << "bufferCapacity  " << accumulatorPtr_->bufferCapacity() << std::endl;
+         outputFile_ << "maxStageId      " << maxStageId_ << std::endl;
+         outputFile_ << "blockFactor     " << blockFactor_ << std::endl;
+         outputFile_ << "reductionInterval " << reductionInterval_ << std::endl;
          outputFile_ << "nSample         " << accumulatorPtr_->nSample() << std::endl;
          outputFile_ << std::endl;
          outputFile_ << "Format of *.dat file" << std::endl;
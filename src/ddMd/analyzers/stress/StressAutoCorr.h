@@ -9,6 +9,7 @@
 */
 
 #include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/analyzers/stress/DeferredStress.h> // member
 #include <ddMd/simulation/Simulation.h>
 #include <util/mpi/MpiLoader.h>
 #include <util/space/Tensor.h>
@@ -22,6 +23,14 @@ namespace DdMd
    /**
    * Compute stress autocorrelation function for a liquid.
    *
+   * The optional parameter reductionInterval (default 1) is the number
+   * of samples for which local stresses are stored on each processor
+   * before they are all summed onto the master in one reduction, and
+   * added to the accumulator in order. Stored samples are also reduced
+   * by output(). Samples stored when a checkpoint is saved are not
+   * included in the checkpoint, so the checkpoint interval should be a
+   * multiple of interval*reductionInterval.
+   *
    * \ingroup DdMd_Analyzer_Stress_Module
    */
    class StressAutoCorr : public Analyzer
@@ -86,6 +95,9 @@ namespace DdMd
       virtual void output();
 
    private:
+
+      /// Local stresses of samples not yet reduced.
+      DeferredStress deferred_;
  
       /// Output file stream
       std::ofstream  outputFile_;
@@ -99,8 +111,19 @@ namespace DdMd
       /// Maximum stage index for descendant AutoCorrStage objects
       int  maxStageId_;
 
+      /// Ratio of sampling intervals of consecutive AutoCorrStage objects
+      int  blockFactor_;
+
+      /// Number of samples summed in each reduction.
+      int  reductionInterval_;
+
       /// Has readParam been called?
       long  isInitialized_;
+
+      /**
+      * Reduce stored samples and add them to the accumulator.
+      */
+      void processDeferred();
    
    };
 
@@ -19,29 +19,98 @@ namespace DdMd
    * Constructor.
    */
    StressAutoCorrelation::StressAutoCorrelation(Simulation& simulation) 
-    : AutoCorrAnalyzer<Tensor, double>(simulation)
+    : AutoCorrAnalyzer<Tensor, double>(simulation),
+      deferred_(),
+      reductionInterval_(1),
+      sampleId_(0)
    {  setClassName("StressAutoCorrelation"); }
 
+   /*
+   * Read parameters of base class, then reductionInterval.
+   */
+   void StressAutoCorrelation::readParameters(std::istream& in)
+   {
+      AutoCorrAnalyzer<Tensor, double>::readParameters(in);
+      reductionInterval_ = 1;
+      readOptional<int>(in, "reductionInterval", reductionInterval_);
+      if (reductionInterval_ < 1) {
+         UTIL_THROW("reductionInterval must be at least 1");
+      }
+      deferred_.setCapacity(reductionInterval_);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void StressAutoCorrelation::loadParameters(Serializable::IArchive &ar)
+   {
+      AutoCorrAnalyzer<Tensor, double>::loadParameters(ar);
+      reductionInterval_ = 1;
+      loadParameter<int>(ar, "reductionInterval", reductionInterval_, false);
+      deferred_.setCapacity(reductionInterval_);
+   }
 
    /*
-   * Sample the stress tensor.
+   * Save internal state to an archive.
    */
-   void StressAutoCorrelation::computeData() 
+   void StressAutoCorrelation::save(Serializable::OArchive &ar)
+   {
+      AutoCorrAnalyzer<Tensor, double>::save(ar);
+      Parameter::saveOptional(ar, reductionInterval_, true);
+   }
+
+   /*
+   * Clear accumulator and stored samples.
+   */
+   void StressAutoCorrelation::clear()
+   {
+      AutoCorrAnalyzer<Tensor, double>::clear();
+      deferred_.clear();
+   }
+
+   /*
+   * Store the local stress tensor, and reduce if the buffer is full.
+   */
+   void StressAutoCorrelation::sample(long iStep)
    {  
-      Simulation& sim = simulation();
-      sim.computeVirialStress();
-      sim.computeKineticStress();
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index is not a multiple of interval");
+      }
+      deferred_.sample(simulation());
+      if (deferred_.isFull()) {
+         processDeferred();
+      }
+   }
+
+   /*
+   * Reduce stored samples, then output.
+   */
+   void StressAutoCorrelation::output()
+   {
+      processDeferred();
+      AutoCorrAnalyzer<Tensor, double>::output();
    }
 
    /*
-   * Sample the stress tensor.
+   * Reduce stored stresses, and add them to the accumulator in order.
+   */
+   void StressAutoCorrelation::processDeferred()
+   {
+      deferred_.reduce(simulation());
+      if (simulation().domain().isMaster()) {
+         for (sampleId_ = 0; sampleId_ < deferred_.size(); ++sampleId_) {
+            addSample(data());
+         }
+      }
+      deferred_.clear();
+   }
+
+   /*
+   * Return traceless scaled stress of current stored sample.
    */
    Tensor StressAutoCorrelation::data() 
    {  
-      Tensor virial  = simulation().virialStress();
-      Tensor kinetic = simulation().kineticStress();
-      Tensor stress;
-      stress.add(virial, kinetic);
+      Tensor stress = deferred_.stress(sampleId_);
 
       // Remove trace
       double pressure = 0.0;
@@ -53,8 +122,8 @@ namespace DdMd
       for (i = 0; i < Dimension; ++i) {
          stress(i,i) -= pressure;
       }
-   
-      double factor = sqrt(simulation().boundary().volume()/10.0);
+
+      double factor = sqrt(deferred_.volume(sampleId_)/10.0);
       for (i = 0; i < Dimension; ++i) {
          for (j = 0; j < Dimension; ++j) {
             stress(i,j) *= factor;
@@ -9,6 +9,7 @@
 */
 
 #include <ddMd/analyzers/AutoCorrAnalyzer.h>
+#include <ddMd/analyzers/stress/DeferredStress.h>   // member
 #include <util/space/Tensor.h>
 
 namespace DdMd
@@ -30,6 +31,10 @@ namespace DdMd
    * stress, using symmetry relations appropriate for an isotropic
    * fluid.
    *
+   * Local stresses are stored on each processor for reductionInterval
+   * samples (an optional parameter, default 1), and then summed onto the
+   * master in a single reduction, as described for StressAutoCorr.
+   *
    * \ingroup DdMd_Analyzer_Stress_Module
    */
    class StressAutoCorrelation : public AutoCorrAnalyzer<Tensor, double>
@@ -50,19 +55,69 @@ namespace DdMd
       virtual ~StressAutoCorrelation()
       {} 
 
-      using AutoCorrAnalyzer<Tensor, double>::readParameters;
-      using AutoCorrAnalyzer<Tensor, double>::loadParameters;
-      using AutoCorrAnalyzer<Tensor, double>::save;
-      using AutoCorrAnalyzer<Tensor, double>::clear;
+      /**
+      * Read parameters, including optional reductionInterval.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear accumulator and discard stored samples.
+      */
+      virtual void clear();
+
+      /**
+      * Store local stress, and reduce when reductionInterval are stored.
+      *
+      * \param iStep MD step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Reduce stored samples, and output results.
+      */
+      virtual void output();
+
       using AutoCorrAnalyzer<Tensor, double>::setup;
-      using AutoCorrAnalyzer<Tensor, double>::sample;
-      using AutoCorrAnalyzer<Tensor, double>::output;
 
    protected:
 
-      virtual void computeData();
+      /**
+      * Return traceless scaled stress of the current stored sample.
+      */
       virtual Tensor data();
 
+   private:
+
+      /// Local stresses of samples not yet reduced.
+      DeferredStress deferred_;
+
+      /// Number of samples summed in each reduction.
+      int reductionInterval_;
+
+      /// Index of sample in deferred_ returned by data().
+      int sampleId_;
+
+      /**
+      * Reduce stored samples and add them to the accumulator.
+      */
+      void processDeferred();
+
    };
 
 }
@@ -0,0 +1,243 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "StressProfile.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/AtomStress.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/boundary/Boundary.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Dimension.h>
+#include <util/space/Tensor.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /// Constructor.
+   StressProfile::StressProfile(Simulation& simulation)
+    : Analyzer(simulation),
+      direction_(-1),
+      nBins_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("StressProfile"); }
+
+   StressProfile::~StressProfile()
+   {}
+
+   /// Read parameters from file, and allocate arrays.
+   void StressProfile::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "direction", direction_);
+      read<int>(in, "nBins", nBins_);
+      if (direction_ < 0 || direction_ >= Dimension) {
+         UTIL_THROW("Invalid direction index");
+      }
+      if (nBins_ <= 0) {
+         UTIL_THROW("Non-positive nBins");
+      }
+      allocate();
+      if (simulation().domain().isMaster()) {
+         for (int i = 0; i < nBins_*NValue; ++i) {
+            accumulator_[i] = 0.0;
+         }
+      }
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void StressProfile::loadParameters(Serializable::IArchive &ar)
+   {
+      // Load and broadcast parameter file parameters
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      loadParameter<int>(ar, "direction", direction_);
+      loadParameter<int>(ar, "nBins", nBins_);
+
+      // Load and broadcast nSample_
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nSample_);
+
+      allocate();
+
+      // Load accumulator, which exists only on master.
+      if (simulation().domain().isMaster()) {
+         ar >> accumulator_;
+         if (accumulator_.capacity() != nBins_*NValue) {
+            UTIL_THROW("Inconsistent accumulator size");
+         }
+      }
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void StressProfile::save(Serializable::OArchive &ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      ar << direction_;
+      ar << nBins_;
+      ar << nSample_;
+      ar << accumulator_;
+   }
+
+   /*
+   * Allocate work arrays, and request per-atom values (private).
+   */
+   void StressProfile::allocate()
+   {
+      local_.allocate(nBins_*NValue);
+      total_.allocate(nBins_*NValue);
+      if (simulation().domain().isMaster()) {
+         if (!accumulator_.isAllocated()) {
+            accumulator_.allocate(nBins_*NValue);
+         }
+      }
+      simulation().atomStress().request(interval());
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void StressProfile::clear()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nSample_ = 0;
+      if (simulation().domain().isMaster()) {
+         for (int i = 0; i < nBins_*NValue; ++i) {
+            accumulator_[i] = 0.0;
+         }
+      }
+   }
+
+   /*
+   * Add local atoms to profiles, and sum over processors.
+   */
+   void StressProfile::sample(long iStep)
+   {
+      if (!isAtInterval(iStep))  {
+         UTIL_THROW("Time step index not a multiple of interval");
+      }
+
+      // Skip samples for which per-atom values were not computed
+      const AtomStress& atomStress = simulation().atomStress();
+      if (atomStress.step() != iStep) return;
+
+      Boundary& boundary = simulation().boundary();
+      double binVolume = boundary.volume()/double(nBins_);
+      int i;
+      for (i = 0; i < nBins_*NValue; ++i) {
+         local_[i] = 0.0;
+      }
+
+      // Without velocities, use the ideal gas kinetic stress kT*delta(i,j).
+      const bool hasVelocity = Atom::hasVelocity();
+      double kT = 0.0;
+      if (!hasVelocity && simulation().energyEnsemble().isIsothermal()) {
+         kT = simulation().energyEnsemble().temperature();
+      }
+
+      // Add kinetic dyads and per-atom values of local atoms to bins
+      AtomIterator atomIter;
+      Vector rg;
+      Vector v(0.0);
+      double mass;
+      double* values;
+      int bin;
+      simulation().atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         boundary.transformCartToGen(atomIter->position(), rg);
+         bin = int(rg[direction_]*double(nBins_));
+         if (bin < 0) bin = 0;
+         if (bin >= nBins_) bin = nBins_ - 1;
+         values = &local_[bin*NValue];
+
+         if (hasVelocity) {
+            v = atomIter->velocity();
+         }
+         const Tensor& w = atomStress.virial(*atomIter);
+         mass = simulation().atomType(atomIter->typeId()).mass();
+         values[0] += 1.0;
+         values[1] += atomStress.energy(*atomIter);
+         values[2] += mass*v[0]*v[0] + kT + w(0, 0);
+         values[3] += mass*v[1]*v[1] + kT + w(1, 1);
+         values[4] += mass*v[2]*v[2] + kT + w(2, 2);
+         values[5] += mass*v[0]*v[1] + 0.5*(w(0, 1) + w(1, 0));
+         values[6] += mass*v[0]*v[2] + 0.5*(w(0, 2) + w(2, 0));
+         values[7] += mass*v[1]*v[2] + 0.5*(w(1, 2) + w(2, 1));
+      }
+      for (i = 0; i < nBins_*NValue; ++i) {
+         local_[i] /= binVolume;
+      }
+
+      #ifdef UTIL_MPI
+      // Sum densities from all processors, in one reduction
+      simulation().domain().communicator().
+                   Reduce(&local_[0], &total_[0], nBins_*NValue,
+                          MPI::DOUBLE, MPI::SUM, 0);
+      #else
+      for (i = 0; i < nBins_*NValue; ++i) {
+         total_[i] = local_[i];
+      }
+      #endif
+
+      if (simulation().domain().isMaster()) {
+         for (i = 0; i < nBins_*NValue; ++i) {
+            accumulator_[i] += total_[i];
+         }
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Write parameters and average profiles.
+   */
+   void StressProfile::output()
+   {
+      if (simulation().domain().isMaster()) {
+
+         // Write parameters to a *.prm file
+         simulation().fileMaster().openOutputFile(outputFileName(".prm"),
+                                                  outputFile_);
+         writeParam(outputFile_);
+         outputFile_.close();
+
+         // Output average profiles to a *.dat file
+         simulation().fileMaster().openOutputFile(outputFileName(".dat"),
+                                                  outputFile_);
+         if (nSample_ > 0) {
+            int i, j;
+            for (i = 0; i < nBins_; ++i) {
+               outputFile_ << Dbl((double(i) + 0.5)/double(nBins_), 12);
+               for (j = 0; j < NValue; ++j) {
+                  outputFile_
+                    << Dbl(accumulator_[i*NValue + j]/double(nSample_), 16);
+               }
+               outputFile_ << std::endl;
+            }
+         }
+         outputFile_.close();
+      }
+   }
+
+}
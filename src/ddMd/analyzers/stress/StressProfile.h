@@ -0,0 +1,131 @@
+#ifndef DDMD_STRESS_PROFILE_H
+#define DDMD_STRESS_PROFILE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/simulation/Simulation.h>
+#include <util/containers/DArray.h>               // member template
+
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * StressProfile evaluates profiles of local stress along one axis.
+   *
+   * This analyzer divides the unit cell into nBins slabs perpendicular
+   * to one lattice axis, and accumulates the number density, potential
+   * energy density and pressure tensor of each slab. The pressure tensor
+   * of a slab is the sum of the kinetic dyads m v v and per-atom virials
+   * of its atoms, divided by the slab volume, using per-atom virials
+   * obtained from Simulation::atomStress(). These are requested at the
+   * interval of this analyzer, and are then computed within the force
+   * loops of steps after which it samples. Samples for which per-atom
+   * values are not available (e.g., the initial step) are skipped.
+   *
+   * \sa \ref ddMd_analyzer_StressProfile_page "parameter file format"
+   *
+   * \ingroup DdMd_Analyzer_Stress_Module
+   */
+   class StressProfile : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation reference to parent Simulation object
+      */
+      StressProfile(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~StressProfile();
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Clear accumulators.
+      */
+      virtual void clear();
+
+      /**
+      * Add local atoms to profiles, and sum over processors.
+      *
+      * \param iStep step counter
+      */
+      void sample(long iStep);
+
+      /**
+      * Output results to predefined output file.
+      */
+      virtual void output();
+
+   private:
+
+      /// Number of values per bin: number, energy, 6 tensor elements.
+      enum {NValue = 8};
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Densities of local atoms for the current sample.
+      DArray<double> local_;
+
+      /// Densities of the current sample, summed over processors.
+      DArray<double> total_;
+
+      /// Accumulated densities, summed over samples (master only).
+      DArray<double> accumulator_;
+
+      /// Index of lattice axis perpendicular to slabs.
+      int direction_;
+
+      /// Number of bins (slabs).
+      int nBins_;
+
+      /// Number of samples thus far.
+      int nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /// Allocate work arrays, and request per-atom values.
+      void allocate();
+
+   };
+
+}
+#endif
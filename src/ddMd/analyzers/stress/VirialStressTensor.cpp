@@ -93,8 +93,7 @@ namespace DdMd
    void VirialStressTensor::sample(long iStep) 
    {
       if (isAtInterval(iStep))  {
-         simulation().computeVirialStress();
-         simulation().computeKineticStress();
+         simulation().computeThermo(false, true);
          if (simulation().domain().isMaster()) {
             Tensor virial  = simulation().virialStress();
             Tensor kinetic = simulation().kineticStress();
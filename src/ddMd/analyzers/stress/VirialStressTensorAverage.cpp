@@ -142,8 +142,7 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          Simulation& sys = simulation();
-         sys.computeVirialStress();
-         sys.computeKineticStress();
+         sys.computeThermo(false, true);
          if (sys.domain().isMaster()) {
             Tensor virial  = sys.virialStress();
             Tensor kinetic = sys.kineticStress();
@@ -7,8 +7,10 @@ ddMd_analyzers_stress_=\
      ddMd/analyzers/stress/OutputStressTensor.cpp\
      ddMd/analyzers/stress/VirialStressTensorAverage.cpp\
      ddMd/analyzers/stress/VirialStressTensor.cpp\
+     ddMd/analyzers/stress/DeferredStress.cpp\
      ddMd/analyzers/stress/StressAutoCorr.cpp\
-     ddMd/analyzers/stress/StressAutoCorrelation.cpp
+     ddMd/analyzers/stress/StressAutoCorrelation.cpp\
+     ddMd/analyzers/stress/StressProfile.cpp
 
 ddMd_analyzers_stress_SRCS=\
      $(addprefix $(SRC_DIR)/, $(ddMd_analyzers_stress_))
@@ -22,7 +22,8 @@ namespace DdMd
    ConfigWriter::ConfigWriter(Simulation& simulation) 
     : Analyzer(simulation),
       nSample_(0),
-      isInitialized_(false)
+      isInitialized_(false),
+      asyncOutput_(false)
    {  setClassName("ConfigWriter"); }
 
    /*
@@ -32,6 +33,8 @@ namespace DdMd
    {
       readInterval(in);
       readOutputFileName(in);
+      asyncOutput_ = false;
+      readOptional<bool>(in, "asyncOutput", asyncOutput_);
       isInitialized_ = true;
    }
 
@@ -42,6 +45,8 @@ namespace DdMd
    {
       loadInterval(ar);
       loadOutputFileName(ar);
+      asyncOutput_ = false;
+      loadParameter<bool>(ar, "asyncOutput", asyncOutput_, false);
 
       MpiLoader<Serializable::IArchive> loader(*this, ar);
       loader.load(nSample_);
@@ -56,6 +61,7 @@ namespace DdMd
    {
       saveInterval(ar);
       saveOutputFileName(ar);
+      Parameter::saveOptional(ar, asyncOutput_, asyncOutput_);
       ar << nSample_;
    }
 
@@ -77,13 +83,40 @@ namespace DdMd
          filename  = outputFileName();
          filename += toString(nSample_);
 
-         // Open output file, write data, and close file
-         //simulation().fileMaster().openOutputFile(filename, outputFile_);
-         simulation().writeConfig(filename);
-         //outputFile_.close();
+         if (asyncOutput_) {
+            // Open file on master, and write to it in the background.
+            // Closing the previous file waits for its data.
+            if (simulation().domain().isMaster()) {
+               if (outputFile_.is_open()) {
+                  asyncBuf_.detach();
+                  outputFile_.close();
+               }
+               simulation().fileMaster().openOutputFile(filename,
+                                                        outputFile_);
+               asyncBuf_.attach(outputFile_);
+            }
+            simulation().writeConfig(outputFile_);
+            if (simulation().domain().isMaster()) {
+               asyncBuf_.submit();
+            }
+         } else {
+            // Open output file, write data, and close file
+            simulation().writeConfig(filename);
+         }
          ++nSample_;
 
       }
    }
 
+   /*
+   * Wait for any background output, and close file.
+   */
+   void ConfigWriter::output() 
+   {
+      if (outputFile_.is_open()) {
+         asyncBuf_.detach();
+         outputFile_.close();
+      }
+   }
+
 }
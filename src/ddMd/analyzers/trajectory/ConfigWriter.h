@@ -10,6 +10,7 @@
 
 #include <ddMd/analyzers/Analyzer.h>
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/misc/AsyncFileBuf.h>
 
 namespace DdMd
 {
@@ -29,6 +30,12 @@ namespace DdMd
    * "dump/", the configurations will be written to files named
    * "out/dump/config.0", "out/dump/config.1", etc.
    *
+   * If the optional parameter asyncOutput is true, each configuration
+   * is formatted in memory on the master and written to disk in the
+   * background (if compiled with DDMD_ASYNC_IO). The analyzer waits 
+   * for the previous file to be written at the next dump, or when
+   * output() is called.
+   *
    * \sa \ref ddMd_analyzer_ConfigWriter_page "param file format"
    *
    * \ingroup DdMd_Analyzer_Trajectory_Module
@@ -84,16 +91,27 @@ namespace DdMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Wait for background output (if any) and close last file.
+      */
+      virtual void output();
+
    private:
  
       /// Output file stream
       std::ofstream outputFile_;
 
+      /// Background writer used if asyncOutput_ is true.
+      AsyncFileBuf asyncBuf_;
+
       /// Number of configurations dumped thus far (first dump is zero).
       long nSample_;
    
       /// Has readParam been called?
       long isInitialized_;
+
+      /// Write configurations in the background?
+      bool asyncOutput_;
    
    };
 
@@ -0,0 +1,138 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DdMdCompactTrajectoryWriter.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/AtomCollector.h>
+#include <ddMd/chemistry/Atom.h>
+#include <util/space/Vector.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   DdMdCompactTrajectoryWriter::DdMdCompactTrajectoryWriter(Simulation& simulation)
+    : TrajectoryWriter(simulation, true),
+      trajectory_(),
+      positions_(),
+      nAtom_(0),
+      nBit_(0)
+   {  setClassName("DdMdCompactTrajectoryWriter"); }
+
+   /*
+   * Destructor.
+   */
+   DdMdCompactTrajectoryWriter::~DdMdCompactTrajectoryWriter()
+   {}
+
+   /*
+   * Read parameter file block.
+   */
+   void DdMdCompactTrajectoryWriter::readParameters(std::istream& in)
+   {
+      TrajectoryWriter::readParameters(in);
+      if (isStream()) {
+         UTIL_THROW("Compact trajectory format cannot be streamed");
+      }
+      read<int>(in, "nBit", nBit_);
+      if (nBit_ < 8 || nBit_ > 30) {
+         UTIL_THROW("nBit must be in range [8, 30]");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void DdMdCompactTrajectoryWriter::loadParameters(Serializable::IArchive &ar)
+   {
+      TrajectoryWriter::loadParameters(ar);
+      if (isStream()) {
+         UTIL_THROW("Compact trajectory format cannot be streamed");
+      }
+      loadParameter<int>(ar, "nBit", nBit_);
+      if (nBit_ < 8 || nBit_ > 30) {
+         UTIL_THROW("nBit must be in range [8, 30]");
+      }
+   }
+
+   /*
+   * Save internal state to output archive.
+   */
+   void DdMdCompactTrajectoryWriter::save(Serializable::OArchive& ar)
+   {
+      TrajectoryWriter::save(ar);
+      ar << nBit_;
+   }
+
+   /*
+   * Write header, and allocate position array on master.
+   */
+   void DdMdCompactTrajectoryWriter::writeHeader(std::ofstream &file)
+   {
+      atomStorage().computeNAtomTotal(domain().communicator());
+      if (domain().isMaster()) {  
+         nAtom_ = atomStorage().nAtomTotal();
+         if (positions_.isAllocated()) {
+            if (positions_.capacity() != nAtom_) {
+               positions_.deallocate();
+            }
+         }
+         if (!positions_.isAllocated()) {
+            positions_.allocate(nAtom_);
+         }
+         trajectory_.setParameters(nAtom_, nBit_);
+         trajectory_.writeHeader(file);
+      }
+   }
+
+   /*
+   * Gather atoms on master, and write one frame.
+   */
+   void DdMdCompactTrajectoryWriter::writeFrame(std::ofstream &file, long iStep)
+   {
+      if (domain().isMaster()) {  
+
+         bool isCartesian = atomStorage().isCartesian();
+         int id;
+         int n = 0;
+         atomCollector().setup();
+         Atom* atomPtr = atomCollector().nextPtr();
+         while (atomPtr) {
+            id = atomPtr->id();
+            if (id < 0 || id >= nAtom_) {
+               UTIL_THROW("Atom id out of range for compact trajectory");
+            }
+            if (isCartesian) {
+               boundary().transformCartToGen(atomPtr->position(), 
+                                             positions_[id]);
+            } else {
+               positions_[id] = atomPtr->position();
+            }
+            ++n;
+            atomPtr = atomCollector().nextPtr();
+         }
+         if (n != nAtom_) {
+            UTIL_THROW("Number of atoms changed since header was written");
+         }
+         trajectory_.writeFrame(file, iStep, boundary(), positions_);
+
+      } else { 
+         atomCollector().send();
+      }
+   }
+
+   /*
+   * Write frame index before file is closed.
+   */
+   void DdMdCompactTrajectoryWriter::writeFooter(std::ofstream &file)
+   {  trajectory_.writeIndex(file); }
+
+}
@@ -0,0 +1,114 @@
+#ifndef DDMD_DDMD_COMPACT_TRAJECTORY_WRITER_H
+#define DDMD_DDMD_COMPACT_TRAJECTORY_WRITER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/trajectory/TrajectoryWriter.h>   // base class
+#include <simp/trajectory/CompactTrajectory.h>             // member
+#include <util/containers/DArray.h>                        // member
+#include <util/space/Vector.h>                             // member
+
+namespace DdMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * Compact binary trajectory format with a frame index.
+   *
+   * Writes quantized, delta-encoded scaled positions for all atoms,
+   * ordered by atom id, using the format defined by the class
+   * Simp::CompactTrajectory. The number of bits per coordinate is set
+   * by the nBit parameter. An index of frame offsets is written when
+   * the file is closed, to allow random access by readers.
+   *
+   * \sa \ref ddMd_analyzer_DdMdCompactTrajectoryWriter_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Trajectory_Module
+   */
+   class DdMdCompactTrajectoryWriter : public TrajectoryWriter
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object
+      */
+      DdMdCompactTrajectoryWriter(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~DdMdCompactTrajectoryWriter();
+
+      /**
+      * Read interval, outputFileName and nBit.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+   protected:
+
+      /**
+      * Write trajectory file header.
+      *
+      * \param file output file stream
+      */
+      void writeHeader(std::ofstream &file);
+
+      /**
+      * Write a single frame. 
+      *
+      * \param file output file stream
+      * \param iStep MD time step index
+      */
+      void writeFrame(std::ofstream &file, long iStep);
+
+      /**
+      * Write the frame index.
+      *
+      * \param file output file stream
+      */
+      void writeFooter(std::ofstream &file);
+
+   private:
+
+      /// File format encoder, and index of frame offsets.
+      CompactTrajectory trajectory_;
+
+      /// Scaled atomic positions, indexed by atom id (master only).
+      DArray<Vector> positions_;
+
+      /// Number of atoms in the file.
+      int nAtom_;
+
+      /// Number of bits per coordinate.
+      int nBit_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,406 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Hdf5TrajectoryWriter.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/misc/BoundaryMetric.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/global.h>
+
+#include <algorithm>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   Hdf5TrajectoryWriter::Hdf5TrajectoryWriter(Simulation& simulation)
+    : Analyzer(simulation),
+      atoms_(),
+      buffer_(),
+      fileId_(-1),
+      positionsId_(-1),
+      lengthsId_(-1),
+      stepsId_(-1),
+      transferId_(-1),
+      nAtom_(0),
+      nFrame_(0),
+      chunkSize_(65536),
+      compression_(0),
+      isInitialized_(false)
+   {  setClassName("Hdf5TrajectoryWriter"); }
+
+   /*
+   * Destructor.
+   */
+   Hdf5TrajectoryWriter::~Hdf5TrajectoryWriter()
+   {  clear(); }
+
+   /*
+   * Read interval, outputFileName and optional chunkSize, compression.
+   */
+   void Hdf5TrajectoryWriter::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      chunkSize_ = 65536;
+      readOptional<int>(in, "chunkSize", chunkSize_);
+      compression_ = 0;
+      readOptional<int>(in, "compression", compression_);
+      checkParameters();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void Hdf5TrajectoryWriter::loadParameters(Serializable::IArchive &ar)
+   {
+      loadInterval(ar);
+      loadOutputFileName(ar);
+      chunkSize_ = 65536;
+      loadParameter<int>(ar, "chunkSize", chunkSize_, false);
+      compression_ = 0;
+      loadParameter<int>(ar, "compression", compression_, false);
+      checkParameters();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an output archive.
+   */
+   void Hdf5TrajectoryWriter::save(Serializable::OArchive& ar)
+   {
+      saveInterval(ar);
+      saveOutputFileName(ar);
+      Parameter::saveOptional(ar, chunkSize_, true);
+      Parameter::saveOptional(ar, compression_, compression_ > 0);
+   }
+
+   /*
+   * Check values of optional parameters.
+   */
+   void Hdf5TrajectoryWriter::checkParameters() const
+   {
+      if (chunkSize_ <= 0) {
+         UTIL_THROW("chunkSize must be positive");
+      }
+      if (compression_ < 0 || compression_ > 9) {
+         UTIL_THROW("compression must be in range [0, 9]");
+      }
+   }
+
+   /*
+   * Create the file and datasets, on all processors.
+   */
+   void Hdf5TrajectoryWriter::setup()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Object is not initialized");
+      }
+      clear();
+
+      Domain& domain = simulation().domain();
+      MPI::Intracomm& communicator = domain.communicator();
+      AtomStorage& storage = simulation().atomStorage();
+      storage.computeNAtomTotal(communicator);
+      if (domain.isMaster()) {
+         nAtom_ = storage.nAtomTotal();
+      }
+      communicator.Bcast(&nAtom_, 1, MPI::INT, 0);
+      if (nAtom_ <= 0) {
+         UTIL_THROW("No atoms");
+      }
+
+      // Create file collectively through the MPI-IO driver
+      hid_t accessId = H5Pcreate(H5P_FILE_ACCESS);
+      H5Pset_fapl_mpio(accessId, (MPI_Comm) communicator, MPI_INFO_NULL);
+      fileId_ = H5Fcreate(outputFileName().c_str(), H5F_ACC_TRUNC,
+                          H5P_DEFAULT, accessId);
+      H5Pclose(accessId);
+      if (fileId_ < 0) {
+         UTIL_THROW("Error creating HDF5 trajectory file");
+      }
+      transferId_ = H5Pcreate(H5P_DATASET_XFER);
+      H5Pset_dxpl_mpio(transferId_, H5FD_MPIO_COLLECTIVE);
+
+      hsize_t n = (hsize_t) nAtom_;
+      hsize_t chunkAtoms = std::min(n, (hsize_t) chunkSize_);
+      hsize_t dims[3] = {0, n, Dimension};
+      hsize_t chunk[3] = {1, chunkAtoms, Dimension};
+      positionsId_ = createDataset("positions", H5T_NATIVE_DOUBLE, 3,
+                                   dims, chunk, compression_);
+      dims[1] = Dimension;
+      chunk[0] = 64;
+      chunk[1] = Dimension;
+      lengthsId_ = createDataset("lengths", H5T_NATIVE_DOUBLE, 2,
+                                 dims, chunk, 0);
+      stepsId_ = createDataset("steps", H5T_NATIVE_LONG, 1,
+                               dims, chunk, 0);
+      nFrame_ = 0;
+   }
+
+   /*
+   * Write a frame, on all processors.
+   */
+   void Hdf5TrajectoryWriter::sample(long iStep)
+   {
+      if (!isAtInterval(iStep)) return;
+      if (fileId_ < 0) {
+         UTIL_THROW("HDF5 trajectory file is not open");
+      }
+      Boundary& boundary = simulation().boundary();
+      if (!isOrthogonal(boundary)) {
+         UTIL_THROW("HDF5 trajectory requires an orthorhombic boundary");
+      }
+
+      collectAtoms();
+      int n = atoms_.size();
+
+      // Type ids, written once with the first frame
+      if (nFrame_ == 0) {
+         hsize_t dim = (hsize_t) nAtom_;
+         hid_t space = H5Screate_simple(1, &dim, NULL);
+         hid_t typesId = H5Dcreate2(fileId_, "typeIds", H5T_NATIVE_INT,
+                                    space, H5P_DEFAULT, H5P_DEFAULT,
+                                    H5P_DEFAULT);
+         H5Sclose(space);
+         std::vector<int> typeIds(n);
+         for (int i = 0; i < n; ++i) {
+            typeIds[i] = atoms_[i].second->typeId();
+         }
+         writeAtoms(typesId, 1, H5T_NATIVE_INT,
+                    n ? &typeIds[0] : 0, 1);
+         H5Dclose(typesId);
+      }
+
+      // Cartesian positions
+      bool isCartesian = simulation().atomStorage().isCartesian();
+      buffer_.resize(Dimension*n);
+      Vector r;
+      int i, j;
+      for (i = 0; i < n; ++i) {
+         const Vector& position = atoms_[i].second->position();
+         if (isCartesian) {
+            r = position;
+         } else {
+            boundary.transformGenToCart(position, r);
+         }
+         for (j = 0; j < Dimension; ++j) {
+            buffer_[Dimension*i + j] = r[j];
+         }
+      }
+      writeAtoms(positionsId_, 3, H5T_NATIVE_DOUBLE,
+                 n ? &buffer_[0] : 0, Dimension);
+
+      // Box lengths and step index
+      Vector lengths = boundary.lengths();
+      double lengthData[Dimension];
+      for (j = 0; j < Dimension; ++j) {
+         lengthData[j] = lengths[j];
+      }
+      writeMaster(lengthsId_, 2, H5T_NATIVE_DOUBLE, lengthData, Dimension);
+      writeMaster(stepsId_, 1, H5T_NATIVE_LONG, &iStep, 1);
+
+      ++nFrame_;
+   }
+
+   /*
+   * Close the file, on all processors.
+   */
+   void Hdf5TrajectoryWriter::clear()
+   {
+      if (fileId_ >= 0) {
+         H5Dclose(positionsId_);
+         H5Dclose(lengthsId_);
+         H5Dclose(stepsId_);
+         H5Pclose(transferId_);
+         H5Fclose(fileId_);
+         fileId_ = -1;
+         positionsId_ = -1;
+         lengthsId_ = -1;
+         stepsId_ = -1;
+         transferId_ = -1;
+      }
+   }
+
+   /*
+   * Close the file.
+   */
+   void Hdf5TrajectoryWriter::output()
+   {  clear(); }
+
+   /*
+   * Create a chunked dataset with an unlimited first dimension.
+   */
+   hid_t Hdf5TrajectoryWriter::createDataset(const char* name, hid_t type,
+                                             int rank, const hsize_t* dims,
+                                             const hsize_t* chunk,
+                                             int compression)
+   {
+      hsize_t maxDims[3];
+      maxDims[0] = H5S_UNLIMITED;
+      for (int i = 1; i < rank; ++i) {
+         maxDims[i] = dims[i];
+      }
+      hid_t space = H5Screate_simple(rank, dims, maxDims);
+      hid_t createId = H5Pcreate(H5P_DATASET_CREATE);
+      H5Pset_chunk(createId, rank, chunk);
+      if (compression > 0) {
+         H5Pset_deflate(createId, compression);
+      }
+      hid_t dataset = H5Dcreate2(fileId_, name, type, space,
+                                 H5P_DEFAULT, createId, H5P_DEFAULT);
+      H5Pclose(createId);
+      H5Sclose(space);
+      if (dataset < 0) {
+         UTIL_THROW("Error creating HDF5 dataset");
+      }
+      return dataset;
+   }
+
+   /*
+   * Extend a time-dependent dataset by one frame, return its file space.
+   */
+   hid_t Hdf5TrajectoryWriter::extendDataset(hid_t dataset)
+   {
+      hsize_t dims[3];
+      hid_t space = H5Dget_space(dataset);
+      H5Sget_simple_extent_dims(space, dims, NULL);
+      H5Sclose(space);
+      dims[0] = nFrame_ + 1;
+      H5Dset_extent(dataset, dims);
+      return H5Dget_space(dataset);
+   }
+
+   /*
+   * Select the local atoms in a file space, one hyperslab per run of
+   * consecutive ids, so that the selection has the order of atoms_.
+   */
+   void Hdf5TrajectoryWriter::selectAtoms(hid_t space, int rank,
+                                          hsize_t frame)
+   {
+      hsize_t offset[3];
+      hsize_t count[3];
+      H5S_seloper_t op = H5S_SELECT_SET;
+      int n = atoms_.size();
+      int i = 0;
+      int j;
+      if (n == 0) {
+         H5Sselect_none(space);
+      }
+      while (i < n) {
+         j = i + 1;
+         while (j < n && atoms_[j].first == atoms_[j-1].first + 1) {
+            ++j;
+         }
+         if (rank == 1) {
+            offset[0] = atoms_[i].first;
+            count[0] = j - i;
+         } else {
+            offset[0] = frame;
+            offset[1] = atoms_[i].first;
+            offset[2] = 0;
+            count[0] = 1;
+            count[1] = j - i;
+            count[2] = Dimension;
+         }
+         H5Sselect_hyperslab(space, op, offset, NULL, count, NULL);
+         op = H5S_SELECT_OR;
+         i = j;
+      }
+   }
+
+   /*
+   * Fill atoms_ with the local atoms, sorted by global id.
+   */
+   void Hdf5TrajectoryWriter::collectAtoms()
+   {
+      AtomStorage& storage = simulation().atomStorage();
+      atoms_.clear();
+      atoms_.reserve(storage.nAtom());
+      AtomIterator iter;
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         if (iter->id() < 0 || iter->id() >= nAtom_) {
+            UTIL_THROW("Atom id out of range of HDF5 trajectory");
+         }
+         atoms_.push_back(std::make_pair(iter->id(), iter.get()));
+      }
+      std::sort(atoms_.begin(), atoms_.end());
+   }
+
+   /*
+   * Write data for local atoms (width values per atom), to the next
+   * frame of a time-dependent dataset (rank 3) or to a fixed dataset
+   * indexed by atom id (rank 1). Collective.
+   */
+   void Hdf5TrajectoryWriter::writeAtoms(hid_t dataset, int rank,
+                                         hid_t type, const void* data,
+                                         hsize_t width)
+   {
+      hid_t fileSpace;
+      if (rank == 1) {
+         fileSpace = H5Dget_space(dataset);
+      } else {
+         fileSpace = extendDataset(dataset);
+      }
+      selectAtoms(fileSpace, rank, nFrame_);
+      hsize_t size = width*atoms_.size();
+      hsize_t dim = size ? size : 1;
+      hid_t memSpace = H5Screate_simple(1, &dim, NULL);
+      if (size == 0) {
+         H5Sselect_none(memSpace);
+      }
+      herr_t error = H5Dwrite(dataset, type, memSpace, fileSpace,
+                              transferId_, data);
+      H5Sclose(memSpace);
+      H5Sclose(fileSpace);
+      if (error < 0) {
+         UTIL_THROW("Error writing HDF5 trajectory");
+      }
+   }
+
+   /*
+   * Write n values from the master to the next frame of a dataset.
+   * Collective: other processors write an empty selection.
+   */
+   void Hdf5TrajectoryWriter::writeMaster(hid_t dataset, int rank,
+                                          hid_t type, const void* data,
+                                          hsize_t n)
+   {
+      hid_t fileSpace = extendDataset(dataset);
+      hid_t memSpace = H5Screate_simple(1, &n, NULL);
+      if (simulation().domain().isMaster()) {
+         hsize_t offset[2] = {(hsize_t) nFrame_, 0};
+         hsize_t count[2] = {1, n};
+         if (rank == 1) {
+            count[0] = n;
+         }
+         H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL,
+                             count, NULL);
+      } else {
+         H5Sselect_none(fileSpace);
+         H5Sselect_none(memSpace);
+      }
+      herr_t error = H5Dwrite(dataset, type, memSpace, fileSpace,
+                              transferId_, data);
+      H5Sclose(memSpace);
+      H5Sclose(fileSpace);
+      if (error < 0) {
+         UTIL_THROW("Error writing HDF5 trajectory");
+      }
+   }
+
+}
@@ -0,0 +1,197 @@
+#ifndef DDMD_HDF5_TRAJECTORY_WRITER_H
+#define DDMD_HDF5_TRAJECTORY_WRITER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/analyzers/Analyzer.h>         // base class
+#include <hdf5.h>
+
+#include <vector>
+#include <utility>
+
+namespace DdMd
+{
+
+   class Simulation;
+   class Atom;
+
+   using namespace Util;
+
+   /**
+   * Write a trajectory to a parallel HDF5 file.
+   *
+   * All processors open the file collectively through the MPI-IO
+   * driver of a parallel HDF5 library, and each processor writes the
+   * positions of its own local atoms directly into the file, with no
+   * collection of atoms on the master. The file contains extendible
+   * datasets "positions" (nFrame x nAtom x 3, Cartesian, indexed by
+   * global atom id), "lengths" (nFrame x 3 orthorhombic box lengths)
+   * and "steps" (nFrame time step indices), and a dataset "typeIds"
+   * (nAtom) written with the first frame. Each processor selects one
+   * hyperslab per run of consecutive ids of its local atoms, and all
+   * processors then write in a single collective call per dataset.
+   *
+   * The positions dataset is chunked with one chunk of chunkSize atoms
+   * per frame, and may be compressed with the deflate filter, which
+   * requires a parallel HDF5 library of version 1.10.2 or later.
+   *
+   * Unlike files opened by the FileMaster, the file name is used as
+   * given, relative to the working directory, because the file is
+   * opened by the HDF5 library on all processors.
+   *
+   * This class is only available if compiled with SIMP_HDF5 defined.
+   *
+   * \sa \ref ddMd_analyzer_Hdf5TrajectoryWriter_page "param file format"
+   *
+   * \ingroup DdMd_Analyzer_Trajectory_Module
+   */
+   class Hdf5TrajectoryWriter : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object
+      */
+      Hdf5TrajectoryWriter(Simulation& simulation);
+
+      /**
+      * Destructor (closes file, if open).
+      */
+      virtual ~Hdf5TrajectoryWriter();
+
+      /**
+      * Read parameters and initialize.
+      *
+      * \param in input parameter file
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Create the file and its datasets.
+      *
+      * Call on all processors.
+      */
+      virtual void setup();
+
+      /**
+      * Write a frame, if iStep is a multiple of interval.
+      *
+      * Call on all processors.
+      *
+      * \param iStep MD step index
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Close the file, if open.
+      */
+      virtual void clear();
+
+      /**
+      * Close the file, if open.
+      */
+      virtual void output();
+
+   private:
+
+      /// Global ids and pointers of local atoms, sorted by id.
+      std::vector< std::pair<int, Atom*> > atoms_;
+
+      /// Positions of local atoms, in order of atoms_.
+      std::vector<double> buffer_;
+
+      /// Identifier for the open file (negative if none).
+      hid_t fileId_;
+
+      /// Identifier for the positions dataset.
+      hid_t positionsId_;
+
+      /// Identifier for the box lengths dataset.
+      hid_t lengthsId_;
+
+      /// Identifier for the time steps dataset.
+      hid_t stepsId_;
+
+      /// Property list for collective transfers.
+      hid_t transferId_;
+
+      /// Total number of atoms.
+      int nAtom_;
+
+      /// Number of frames written to the open file.
+      int nFrame_;
+
+      /// Number of atoms per chunk of the positions dataset.
+      int chunkSize_;
+
+      /// Deflate compression level (0 for none).
+      int compression_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Validate chunkSize_ and compression_.
+      */
+      void checkParameters() const;
+
+      /**
+      * Create a chunked dataset with an unlimited first (frame) dimension.
+      */
+      hid_t createDataset(const char* name, hid_t type, int rank,
+                          const hsize_t* dims, const hsize_t* chunk,
+                          int compression);
+
+      /**
+      * Extend a dataset to nFrame_ + 1 frames, return its file space.
+      */
+      hid_t extendDataset(hid_t dataset);
+
+      /**
+      * Select one hyperslab per run of consecutive ids in atoms_.
+      */
+      void selectAtoms(hid_t space, int rank, hsize_t frame);
+
+      /**
+      * Fill atoms_ with the sorted local atoms.
+      */
+      void collectAtoms();
+
+      /**
+      * Write a value (length n) on the master for frame nFrame_.
+      */
+      void writeMaster(hid_t dataset, int rank, hid_t type,
+                       const void* data, hsize_t n);
+
+      /**
+      * Write data for local atoms, in order of atoms_.
+      */
+      void writeAtoms(hid_t dataset, int rank, hid_t type,
+                      const void* data, hsize_t width);
+
+   };
+
+}
+#endif
@@ -11,18 +11,29 @@
 #include <ddMd/chemistry/Atom.h>
 #include <util/archives/BinaryFileOArchive.h>
 #include <util/format/Dbl.h>
+#include <simp/trajectory/LammpsDumpFormat.h>
 #include <util/space/Vector.h>
+#include <util/global.h>
+#ifdef DDMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace DdMd
 {
 
    using namespace Util;
+   using namespace Simp;
 
    /*
    * Constructor.
    */
    LammpsDumpWriter::LammpsDumpWriter(Simulation& simulation)
-    : TrajectoryWriter(simulation)
+    : TrajectoryWriter(simulation),
+      ids_(),
+      typeIds_(),
+      positions_(),
+      buffers_(),
+      nAtom_(0)
    {  setClassName("LammpsDumpWriter"); }
 
    /*
@@ -31,6 +42,32 @@ namespace DdMd
    LammpsDumpWriter::~LammpsDumpWriter()
    {}
 
+   /*
+   * Allocate arrays for nAtom_ atoms, and one buffer per thread.
+   */
+   void LammpsDumpWriter::allocate()
+   {
+      if (ids_.isAllocated()) {
+         if (ids_.capacity() < nAtom_) {
+            ids_.deallocate();
+            typeIds_.deallocate();
+            positions_.deallocate();
+         }
+      }
+      if (!ids_.isAllocated()) {
+         ids_.allocate(nAtom_);
+         typeIds_.allocate(nAtom_);
+         positions_.allocate(nAtom_);
+      }
+      if (!buffers_.isAllocated()) {
+         int nThread = 1;
+         #ifdef DDMD_OPENMP
+         nThread = omp_get_max_threads();
+         #endif
+         buffers_.allocate(nThread);
+      }
+   }
+
    /*
    *  Write a configuration snapshot. 
    */
@@ -55,38 +92,59 @@ namespace DdMd
          file << Dbl(0.0) << Dbl(lengths[0]) << "\n";
          file << Dbl(0.0) << Dbl(lengths[1]) << "\n";
          file << Dbl(0.0) << Dbl(lengths[2]) << "\n";
+         file << "ITEM: ATOMS id type mol x y z" << "\n";
 
-         Vector r;
-         int id;
-         int typeId;
-         int shift = 0;
-         int molId = 1;
+         // Collect data for all atoms
+         allocate();
          bool isCartesian = atomStorage().isCartesian();
-
-         file << "ITEM: ATOMS id type mol x y z" << "\n";
+         int n = 0;
          atomCollector().setup();
          Atom* atomPtr = atomCollector().nextPtr();
          while (atomPtr) {
-            id = atomPtr->id();
-            typeId = atomPtr->typeId();
+            if (n >= nAtom_) {
+               UTIL_THROW("Too many atoms received");
+            }
+            ids_[n] = atomPtr->id();
+            typeIds_[n] = atomPtr->typeId();
             if (isCartesian) {
-               r = atomPtr->position();
+               positions_[n] = atomPtr->position();
             } else {
-               boundary().transformGenToCart(atomPtr->position(), r);
-            }
-            file << id + 1<< " ";
-            file << typeId + 1 << " ";
-            file << molId << " ";
-            for (int i=0; i < Util::Dimension; ++i) {
-               file << Dbl(atomPtr->position()[i], 13) << " ";
-            }
-            for (int i=0; i < Util::Dimension; ++i) {
-               file << shift << " ";
+               boundary().transformGenToCart(atomPtr->position(),
+                                             positions_[n]);
             }
-            file << "\n";
+            ++n;
             atomPtr = atomCollector().nextPtr();
          }
 
+         // Format contiguous ranges of atoms in per-thread buffers
+         #ifdef DDMD_OPENMP
+         #pragma omp parallel
+         #endif
+         {
+            int threadId = 0;
+            #ifdef DDMD_OPENMP
+            threadId = omp_get_thread_num();
+            #endif
+            std::string& buffer = buffers_[threadId];
+            char line[LammpsDumpFormat::MaxLineLength];
+            int i, length;
+            buffer.clear();
+            #ifdef DDMD_OPENMP
+            #pragma omp for schedule(static)
+            #endif
+            for (i = 0; i < n; ++i) {
+               length = LammpsDumpFormat::formatAtom(line, ids_[i],
+                                                     typeIds_[i], 1,
+                                                     positions_[i]);
+               buffer.append(line, length);
+            }
+         }
+
+         // Write buffers in thread order (i.e., in atom order)
+         for (int t = 0; t < buffers_.capacity(); ++t) {
+            file.write(buffers_[t].data(), buffers_[t].size());
+         }
+
       } else { 
          atomCollector().send();
       }
@@ -9,6 +9,10 @@
 */
 
 #include <ddMd/analyzers/trajectory/TrajectoryWriter.h>   // base class
+#include <util/containers/DArray.h>                        // member
+#include <util/space/Vector.h>                             // member
+
+#include <string>
 
 namespace DdMd
 {
@@ -18,6 +22,11 @@ namespace DdMd
    /**
    * Write a trajectory in the Lammps dump format.
    *
+   * The master processor first collects ids, types and positions of all
+   * atoms. Lines of the ATOMS block are then formatted by all threads
+   * (if compiled with DDMD_OPENMP), each into a private buffer for a
+   * contiguous range of atoms, and the buffers are written in order.
+   *
    * \ingroup DdMd_Analyzer_Trajectory_Module
    */
    class LammpsDumpWriter : public TrajectoryWriter
@@ -47,9 +56,26 @@ namespace DdMd
 
    private:
 
+      /// Atom ids, in the order received by the master.
+      DArray<int> ids_;
+
+      /// Atom type ids.
+      DArray<int> typeIds_;
+
+      /// Cartesian atom positions.
+      DArray<Vector> positions_;
+
+      /// Formatted text of the ATOMS block, one buffer per thread.
+      DArray<std::string> buffers_;
+
       /// Number of atoms in the file.
       int nAtom_;
 
+      /**
+      * Allocate or reallocate arrays for nAtom_ atoms (master only).
+      */
+      void allocate();
+
    };
 
 }
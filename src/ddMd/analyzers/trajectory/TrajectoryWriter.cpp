@@ -24,6 +24,8 @@ namespace DdMd
     : Analyzer(simulation),
       isInitialized_(false),
       isBinary_(isBinary),
+      asyncOutput_(false),
+      stream_(false),
       domainPtr_(0),
       boundaryPtr_(0),
       atomStoragePtr_(0)
@@ -60,6 +62,10 @@ namespace DdMd
    {
       readInterval(in);
       readOutputFileName(in);
+      asyncOutput_ = false;
+      readOptional<bool>(in, "asyncOutput", asyncOutput_);
+      stream_ = false;
+      readOptional<bool>(in, "stream", stream_);
       isInitialized_ = true;
    }
 
@@ -70,6 +76,10 @@ namespace DdMd
    {
       loadInterval(ar);
       loadOutputFileName(ar);
+      asyncOutput_ = false;
+      loadParameter<bool>(ar, "asyncOutput", asyncOutput_, false);
+      stream_ = false;
+      loadParameter<bool>(ar, "stream", stream_, false);
       isInitialized_ = true;
    }
 
@@ -80,6 +90,8 @@ namespace DdMd
    {
       saveInterval(ar);
       saveOutputFileName(ar);
+      Parameter::saveOptional(ar, asyncOutput_, asyncOutput_);
+      Parameter::saveOptional(ar, stream_, stream_);
    }
 
    /*
@@ -89,14 +101,24 @@ namespace DdMd
    {  
       FileMaster& fileMaster = simulation().fileMaster();
       if (isIoProcessor()) {
+         std::ios::openmode mode = std::ios::out;
          if (isBinary()) {
-            fileMaster.openOutputFile(outputFileName(), outputFile_, 
-                                      std::ios::out | std::ios::binary);
-         } else {
-            fileMaster.openOutputFile(outputFileName(), outputFile_);
+            mode |= std::ios::binary;
+         }
+         fileMaster.openOutputFile(outputFileName(), outputFile_, mode);
+         if (asyncOutput_) {
+            asyncBuf_.attach(outputFile_);
          }
       }
       writeHeader(outputFile_);
+      if (isIoProcessor()) {
+         if (asyncOutput_) {
+            asyncBuf_.submit();
+         } else
+         if (stream_) {
+            outputFile_.flush();
+         }
+      }
    }
 
    /*
@@ -106,6 +128,14 @@ namespace DdMd
    {
       if (isAtInterval(iStep))  {
          writeFrame(outputFile_, iStep);
+         if (isIoProcessor()) {
+            if (asyncOutput_) {
+               asyncBuf_.submit();
+            } else
+            if (stream_) {
+               outputFile_.flush();
+            }
+         }
       }
    }
 
@@ -115,6 +145,10 @@ namespace DdMd
    void TrajectoryWriter::clear()
    {
       if (outputFile_.is_open()) {
+         writeFooter(outputFile_);
+         if (asyncBuf_.isAttached()) {
+            asyncBuf_.detach();
+         }
          outputFile_.close();
       }
    }
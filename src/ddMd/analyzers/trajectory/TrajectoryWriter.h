@@ -19,6 +19,7 @@
 #ifdef SIMP_DIHEDRAL
 #include <ddMd/storage/DihedralStorage.h>               
 #endif
+#include <ddMd/misc/AsyncFileBuf.h>       // member
 #include <util/boundary/Boundary.h>         // typedef
 
 namespace DdMd
@@ -34,6 +35,18 @@ namespace DdMd
    /**
    * Base class to write a trajectory to a single file.
    *
+   * If the optional parameter asyncOutput is true, frames are written 
+   * to an in-memory AsyncFileBuf on the master processor and written
+   * to disk in the background (if compiled with DDMD_ASYNC_IO), so
+   * the MD loop only waits for the collection of atoms on the master.
+   *
+   * If the optional parameter stream is true, the output file is
+   * flushed after every frame. This allows the output file to be a
+   * named pipe (FIFO) that is read concurrently by another program,
+   * such as the mdPp postprocessor, so that frames are analyzed in
+   * situ without being written to disk. Formats that must seek within
+   * the file do not support this mode.
+   *
    * \ingroup DdMd_Analyzer_Trajectory_Module
    */
    class TrajectoryWriter : public Analyzer
@@ -105,6 +118,11 @@ namespace DdMd
       */
       bool isBinary() const;
 
+      /**
+      * Is the output file flushed after every frame, for streaming?
+      */
+      bool isStream() const;
+
       /**
       * Write data that should appear once, at beginning of the file. 
       *
@@ -123,6 +141,17 @@ namespace DdMd
       */
       virtual void writeFrame(std::ofstream& out, long iStep) = 0;
 
+      /**
+      * Write data that should appear once, at the end of the file.
+      *
+      * Called by clear() on the processor that owns the open file, 
+      * just before the file is closed. Default implementation is empty.
+      *
+      * \param out output file stream
+      */
+      virtual void writeFooter(std::ofstream& out)
+      {};
+
       /**
       * Get the Domain by reference.
       */
@@ -184,12 +213,21 @@ namespace DdMd
       // Output file stream
       std::ofstream outputFile_;
 
+      // Background writer used if asyncOutput_ is true.
+      AsyncFileBuf asyncBuf_;
+
       /// Has readParam been called?
       long isInitialized_;
   
       /// Is the trajectory file a binary file? 
       bool isBinary_;
 
+      /// Write frames in the background?
+      bool asyncOutput_;
+
+      /// Flush output after every frame?
+      bool stream_;
+
       // Pointers to associated Domain.
       Domain* domainPtr_;
 
@@ -218,6 +256,12 @@ namespace DdMd
    inline bool TrajectoryWriter::isBinary() const
    {  return isBinary_; }
 
+   /**
+   * Is the output file flushed after every frame?
+   */
+   inline bool TrajectoryWriter::isStream() const
+   {  return stream_; }
+
    inline Domain& TrajectoryWriter::domain()
    {  return *domainPtr_; }
 
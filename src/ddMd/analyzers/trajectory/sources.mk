@@ -3,8 +3,14 @@ ddMd_analyzers_trajectory_=\
      ddMd/analyzers/trajectory/TrajectoryWriter.cpp\
      ddMd/analyzers/trajectory/DdMdTrajectoryWriter.cpp\
      ddMd/analyzers/trajectory/DdMdGroupTrajectoryWriter.cpp\
+     ddMd/analyzers/trajectory/DdMdCompactTrajectoryWriter.cpp\
      ddMd/analyzers/trajectory/LammpsDumpWriter.cpp
 
+ifdef SIMP_HDF5
+ddMd_analyzers_trajectory_+=\
+     ddMd/analyzers/trajectory/Hdf5TrajectoryWriter.cpp
+endif
+
 ddMd_analyzers_trajectory_SRCS=\
      $(addprefix $(SRC_DIR)/, $(ddMd_analyzers_trajectory_))
 ddMd_analyzers_trajectory_OBJS=\
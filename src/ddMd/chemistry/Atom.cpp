@@ -28,9 +28,49 @@ namespace DdMd
    void Atom::setHasAtomContext(bool hasAtomContext)
    {  hasAtomContext_ = hasAtomContext; }
 
+   /*
+   * Ghost masks are not communicated by default.
+   */
+   bool Atom::hasGhostMask_ = false;
+
+   /*
+   * Enable (true) or disable (false) communication of ghost masks.
+   */
+   void Atom::setHasGhostMask(bool hasGhostMask)
+   {  hasGhostMask_ = hasGhostMask; }
+
+   /*
+   * Velocities are stored by default.
+   */
+   bool Atom::hasVelocity_ = true;
+
+   /*
+   * Enable (true) or disable (false) storage of velocities.
+   */
+   void Atom::setHasVelocity(bool hasVelocity)
+   {  hasVelocity_ = hasVelocity; }
+
+   #ifdef DDMD_GROUP_INDEX
+   /*
+   * Atom arrays are unknown until set by AtomStorage.
+   */
+   Atom* Atom::localAtoms_ = 0;
+   Atom* Atom::ghostAtoms_ = 0;
+
+   /*
+   * Set addresses of local and ghost atom arrays.
+   */
+   void Atom::setArrays(Atom* localAtoms, Atom* ghostAtoms)
+   {
+      localAtoms_ = localAtoms;
+      ghostAtoms_ = ghostAtoms;
+   }
+   #endif
+
    /*
    * Constructor (private, used by AtomArray).
    */
+   #ifndef DDMD_ATOM_SOA
    Atom::Atom() :
      position_(0.0),
      typeId_(-1),
@@ -41,17 +81,25 @@ namespace DdMd
      , pad_(0)
      #endif
    {}
+   #else
+   Atom::Atom() :
+     localId_(0),
+     arrayPtr_(0)
+   {}
+   #endif
 
    /*
    * Assignment (public).
    */
    Atom& Atom::operator= (const Atom& other)
    {
-      position_ = other.position_;
-      typeId_ = other.typeId_;
-      force_ = other.force_;
+      position() = other.position();
+      setTypeId(other.typeId());
+      force() = other.force();
       setIsGhost(other.isGhost());
-      velocity() = other.velocity();
+      if (hasVelocity_) {
+         velocity() = other.velocity();
+      }
       setId(other.id());
       plan() = other.plan();
       groups() = other.groups();
@@ -67,7 +115,7 @@ namespace DdMd
    */
    void Atom::clear()
    {
-      typeId_ = -1;
+      setTypeId(-1);
       setIsGhost(false);
       setId(-1);
       plan().clearFlags();
@@ -84,12 +132,16 @@ namespace DdMd
    */
    void Atom::packAtom(Buffer& buffer)
    {
-      buffer.pack<int>(id());
-      buffer.pack<int>(typeId());
-      buffer.pack<Vector>(position());
-      buffer.pack<Vector>(velocity());
-      buffer.pack<unsigned int>(plan().flags());
-      buffer.pack<unsigned int>(groups());
+      AtomRecord record;
+      record.id = id();
+      record.typeId = typeId();
+      record.position = position();
+      record.flags = plan().flags();
+      record.groups = groups();
+      buffer.pack<AtomRecord>(record);
+      if (hasVelocity_) {
+         buffer.pack<Vector>(velocity());
+      }
       if (hasAtomContext_) {
          buffer.pack<AtomContext>(context());
       }
@@ -110,18 +162,16 @@ namespace DdMd
    */
    void Atom::unpackAtom(Buffer& buffer)
    {
-      int i;
-      buffer.unpack<int>(i);
-      setId(i);
-      buffer.unpack<int>(i);
-      setTypeId(i);
-      buffer.unpack<Vector>(position());
-      buffer.unpack<Vector>(velocity());
-      unsigned int ui;
-      buffer.unpack<unsigned int>(ui);
-      plan().setFlags(ui);
-      buffer.unpack<unsigned int>(ui);
-      groups() = ui;
+      AtomRecord record;
+      buffer.unpack<AtomRecord>(record);
+      setId(record.id);
+      setTypeId(record.typeId);
+      position() = record.position;
+      plan().setFlags(record.flags);
+      groups() = record.groups;
+      if (hasVelocity_) {
+         buffer.unpack<Vector>(velocity());
+      }
       if (hasAtomContext_) {
          buffer.unpack<AtomContext>(context());
       }
@@ -129,7 +179,7 @@ namespace DdMd
       // Unpack Mask
       Mask& m = mask();
       m.clear();
-      int size;
+      int size, i;
       buffer.unpack<int>(size);
       for (int j = 0; j < size; ++j) {
          buffer.unpack<int>(i);
@@ -145,10 +195,10 @@ namespace DdMd
    */
    int Atom::packedAtomSize()
    {  
-      int size = 0;
-      size += 2*sizeof(int);               // id + typeId
-      size += 2*sizeof(Vector);            // position + velocity
-      size += 2*sizeof(unsigned int);      // plan + groups
+      int size = sizeof(AtomRecord);       // id, type, position, etc.
+      if (hasVelocity_) {
+         size += sizeof(Vector);           // velocity
+      }
       if (hasAtomContext_) {
          size += sizeof(AtomContext);      // context
       }
@@ -162,11 +212,20 @@ namespace DdMd
    */
    void Atom::packGhost(Buffer& buffer)
    {
-      Vector pos;
-      buffer.pack<int>(id());
-      buffer.pack<int>(typeId());
-      buffer.pack<Vector>(position());
-      buffer.pack<unsigned int>(plan().flags());
+      GhostRecord record;
+      record.id = id();
+      record.typeId = typeId();
+      record.position = position();
+      record.flags = plan().flags();
+      buffer.pack<GhostRecord>(record);
+      if (hasGhostMask_) {
+         Mask& m = mask();
+         int size = m.size();
+         buffer.pack<int>(size);
+         for (int j = 0; j < size; ++j) {
+            buffer.pack<int>(m[j]);
+         }
+      }
       buffer.incrementSendSize();
    }
 
@@ -175,15 +234,22 @@ namespace DdMd
    */
    void Atom::unpackGhost(Buffer& buffer)
    {
-      int i;
-      buffer.unpack<int>(i);
-      setId(i);
-      buffer.unpack<int>(i);
-      setTypeId(i);
-      buffer.unpack<Vector>(position());
-      unsigned int ui;
-      buffer.unpack<unsigned int>(ui);
-      plan().setFlags(ui);
+      GhostRecord record;
+      buffer.unpack<GhostRecord>(record);
+      setId(record.id);
+      setTypeId(record.typeId);
+      position() = record.position;
+      plan().setFlags(record.flags);
+      if (hasGhostMask_) {
+         Mask& m = mask();
+         m.clear();
+         int size, id;
+         buffer.unpack<int>(size);
+         for (int j = 0; j < size; ++j) {
+            buffer.unpack<int>(id);
+            m.append(id);
+         }
+      }
       buffer.decrementRecvSize();
    }
 
@@ -192,10 +258,11 @@ namespace DdMd
    */
    int Atom::packedGhostSize()
    {  
-      int size = 0;
-      size += 2*sizeof(int); 
-      size += sizeof(Vector); 
-      size += sizeof(unsigned int);
+      int size = sizeof(GhostRecord);
+      if (hasGhostMask_) {
+         size += sizeof(int);                 // mask size
+         size += Mask::Capacity*sizeof(int);  // mask ids
+      }
       return size;
    }
 
@@ -59,6 +59,14 @@ namespace DdMd
    * arrays. See documentation of the private member localId_ and other 
    * comments in the Atom.h file for further implementation details.
    *
+   * If the preprocessor macro DDMD_ATOM_SOA is defined, the position,
+   * force and atom type id are instead also stored as pseudo-members,
+   * in contiguous arrays owned by the parent AtomArray. This reduces
+   * an Atom object to a local id and a pointer to the parent array, and
+   * allows loops over positions or forces to stream through unit-stride
+   * memory (see AtomArray::positions() and AtomArray::forces()). The 
+   * public interface is identical in both layouts.
+   *
    * \ingroup DdMd_Chemistry_Module
    */
    class Atom
@@ -79,6 +87,58 @@ namespace DdMd
       * Is AtomContext data enabled?
       */
       static bool hasAtomContext();
+
+      /**
+      * Enable (true) or disable (false) communication of ghost masks.
+      *
+      * \param hasGhostMask new value for hasGhostMask static bool flag.
+      */
+      static void setHasGhostMask(bool hasGhostMask);
+
+      /**
+      * Are Mask objects communicated with ghost atoms?
+      *
+      * This is required by the half-shell communication scheme, in
+      * which pairs of two ghost atoms may be included in a pair list.
+      */
+      static bool hasGhostMask();
+
+      /**
+      * Enable (true) or disable (false) storage of velocities.
+      *
+      * Must be set before any AtomArray is allocated. If disabled,
+      * velocities are neither allocated nor communicated, and
+      * velocity() may not be called.
+      *
+      * \param hasVelocity new value for hasVelocity static bool flag.
+      */
+      static void setHasVelocity(bool hasVelocity);
+
+      /**
+      * Are atomic velocities stored and communicated?
+      */
+      static bool hasVelocity();
+
+      #ifdef DDMD_GROUP_INDEX
+      /**
+      * Set the addresses of the first local and first ghost atoms.
+      *
+      * Called by AtomStorage whenever its local or ghost AtomArray is
+      * allocated, so that fromLocalId() can find any atom from its
+      * localId(). Only one AtomStorage per process may thus be used.
+      *
+      * \param localAtoms address of element 0 of local atom array
+      * \param ghostAtoms address of element 0 of ghost atom array
+      */
+      static void setArrays(Atom* localAtoms, Atom* ghostAtoms);
+
+      /**
+      * Get an atom from the value of localId().
+      *
+      * \param localId array index shifted left by one, plus ghost bit
+      */
+      static Atom* fromLocalId(unsigned int localId);
+      #endif
  
       #ifdef UTIL_MPI
       /**
@@ -142,6 +202,8 @@ namespace DdMd
 
       /**
       * Get velocity Vector by reference.
+      *
+      * \pre hasVelocity() is true.
       */
       Vector& velocity();
 
@@ -210,6 +272,11 @@ namespace DdMd
       */
       bool isGhost() const;
 
+      /**
+      * Get index within parent array, shifted left by one, plus ghost bit.
+      */
+      unsigned int localId() const;
+
       /**
       * Get the position Vector (const reference).
       */
@@ -217,6 +284,8 @@ namespace DdMd
 
       /**
       * Get the velocity Vector (const reference).
+      *
+      * \pre hasVelocity() is true.
       */
       const Vector& velocity() const;
 
@@ -344,6 +413,58 @@ namespace DdMd
       */ 
       static bool hasAtomContext_;
 
+      /**
+      * Static member determines if ghosts carry a Mask.
+      */
+      static bool hasGhostMask_;
+
+      /**
+      * Static member determines if velocities are stored.
+      */
+      static bool hasVelocity_;
+
+      #ifdef DDMD_GROUP_INDEX
+      /**
+      * Address of first local atom (see setArrays()).
+      */
+      static Atom* localAtoms_;
+
+      /**
+      * Address of first ghost atom (see setArrays()).
+      */
+      static Atom* ghostAtoms_;
+      #endif
+
+      #ifdef UTIL_MPI
+      /**
+      * Fixed-size leading record of an atom packed for exchange.
+      *
+      * Copied into a Buffer as one item, followed by the velocity if
+      * hasVelocity() is true, an optional AtomContext and the Mask.
+      */
+      struct AtomRecord {
+         int id;
+         int typeId;
+         Vector position;
+         unsigned int flags;
+         unsigned int groups;
+      };
+
+      /**
+      * Fixed-size leading record of a ghost atom packed for sending.
+      *
+      * Copied into a Buffer as one item, followed by the Mask if
+      * hasGhostMask() is true.
+      */
+      struct GhostRecord {
+         int id;
+         int typeId;
+         Vector position;
+         unsigned int flags;
+      };
+      #endif
+
+      #ifndef DDMD_ATOM_SOA
       /**
       * Position of atom.
       */
@@ -353,6 +474,7 @@ namespace DdMd
       * Integer index of atom type.
       */
       int typeId_;
+      #endif
 
       /**
       * Local id in Atom Array, set by AtomArray.
@@ -367,17 +489,19 @@ namespace DdMd
       */
       unsigned int localId_;
 
+      #ifndef DDMD_ATOM_SOA
       /**
       * Force on atom.
       */
       Vector force_;
+      #endif
 
       /**
       * Pointer to parent AtomArray.
       */
       AtomArray* arrayPtr_;
 
-      #ifdef UTIL_32BIT
+      #if defined(UTIL_32BIT) && !defined(DDMD_ATOM_SOA)
       /**
       * On machines with 4 byte pointer, this pads the size to 64 bytes.
       */
@@ -414,8 +538,13 @@ namespace DdMd
    /*
    * Set type Id for Atom.
    */
+   #ifndef DDMD_ATOM_SOA
    inline void Atom::setTypeId(int typeId)
    {  typeId_ = typeId; }
+   #else
+   inline void Atom::setTypeId(int typeId)
+   {  arrayPtr_->typeIds_[localId_ >> 1] = typeId; }
+   #endif
 
    /*
    * Set isGhost flag.
@@ -434,8 +563,13 @@ namespace DdMd
    /*
    * Get atom type Id.
    */
+   #ifndef DDMD_ATOM_SOA
    inline int Atom::typeId() const
    {  return typeId_; }
+   #else
+   inline int Atom::typeId() const
+   {  return arrayPtr_->typeIds_[localId_ >> 1]; }
+   #endif
 
    /*
    * Is this a ghost atom?
@@ -446,29 +580,69 @@ namespace DdMd
       return bool(localId_ & 1);
    }
 
+   /*
+   * Get shifted array index and ghost bit.
+   */
+   inline unsigned int Atom::localId() const
+   {  return localId_; }
+
+   #ifdef DDMD_GROUP_INDEX
+   /*
+   * Get an atom from its shifted array index and ghost bit.
+   */
+   inline Atom* Atom::fromLocalId(unsigned int localId)
+   {
+      if (localId & 1) {
+         return ghostAtoms_ + (localId >> 1);
+      } else {
+         return localAtoms_ + (localId >> 1);
+      }
+   }
+   #endif
+
    /*
    * Get position by reference.
    */
+   #ifndef DDMD_ATOM_SOA
    inline Vector& Atom::position()
    {  return position_; }
+   #else
+   inline Vector& Atom::position()
+   {  return arrayPtr_->positions_[localId_ >> 1]; }
+   #endif
 
    /*
    * Get position by const reference.
    */
+   #ifndef DDMD_ATOM_SOA
    inline const Vector& Atom::position() const
    {  return position_; }
+   #else
+   inline const Vector& Atom::position() const
+   {  return arrayPtr_->positions_[localId_ >> 1]; }
+   #endif
 
    /*
    * Get force by reference.
    */
+   #ifndef DDMD_ATOM_SOA
    inline Vector& Atom::force()
    {  return force_; }
+   #else
+   inline Vector& Atom::force()
+   {  return arrayPtr_->forces_[localId_ >> 1]; }
+   #endif
 
    /*
    * Get force by const reference.
    */
+   #ifndef DDMD_ATOM_SOA
    inline const Vector& Atom::force() const
    {  return force_; }
+   #else
+   inline const Vector& Atom::force() const
+   {  return arrayPtr_->forces_[localId_ >> 1]; }
+   #endif
 
    /*
    * Accessors for pseudo-members stored in separate arrays.
@@ -574,6 +748,18 @@ namespace DdMd
    */
    inline bool Atom::hasAtomContext()
    {  return hasAtomContext_; }
+
+   /*
+   * Are Mask objects communicated with ghost atoms?
+   */
+   inline bool Atom::hasGhostMask()
+   {  return hasGhostMask_; }
+
+   /*
+   * Are velocities stored and communicated?
+   */
+   inline bool Atom::hasVelocity()
+   {  return hasVelocity_; }
  
 }
 #endif
@@ -7,7 +7,7 @@
 
 #include "AtomArray.h"
 #include "Atom.h"
-#include <util/misc/Memory.h>
+#include <ddMd/misc/PageAllocator.h>
 
 #include <stdlib.h>
 
@@ -23,6 +23,11 @@ namespace DdMd
    */
    AtomArray::AtomArray() 
     : Array<Atom>(),
+      #ifdef DDMD_ATOM_SOA
+      positions_(0),
+      forces_(0),
+      typeIds_(0),
+      #endif
       velocities_(0),
       masks_(0),
       plans_(0),
@@ -35,17 +40,33 @@ namespace DdMd
    * Destructor.
    */
    AtomArray::~AtomArray()
+   {  deallocate(); }
+
+   /*
+   * Free all memory, if allocated.
+   */
+   void AtomArray::deallocate()
    {
       if (data_) {
-         Memory::deallocate<Atom>(data_, capacity_);
-         Memory::deallocate<Vector>(velocities_, capacity_);
-         Memory::deallocate<Mask>(masks_, capacity_);
-         Memory::deallocate<Plan>(plans_, capacity_);
-         Memory::deallocate<int>(ids_, capacity_);
-         Memory::deallocate<unsigned int>(groups_, capacity_);
+         PageAllocator::deallocate<Atom>(data_, capacity_);
+         #ifdef DDMD_ATOM_SOA
+         PageAllocator::deallocate<Vector>(positions_, capacity_);
+         PageAllocator::deallocate<Vector>(forces_, capacity_);
+         PageAllocator::deallocate<int>(typeIds_, capacity_);
+         #endif
+         if (velocities_) {
+            PageAllocator::deallocate<Vector>(velocities_, capacity_);
+         }
+         PageAllocator::deallocate<Mask>(masks_, capacity_);
+         PageAllocator::deallocate<Plan>(plans_, capacity_);
+         PageAllocator::deallocate<int>(ids_, capacity_);
+         PageAllocator::deallocate<unsigned int>(groups_, capacity_);
          if (contexts_) {
-            Memory::deallocate<AtomContext>(contexts_, capacity_);
+            PageAllocator::deallocate<AtomContext>(contexts_, capacity_);
          }
+         data_ = 0;
+         velocities_ = 0;
+         contexts_ = 0;
          capacity_ = 0;
       }
    }
@@ -61,29 +82,47 @@ namespace DdMd
       if (capacity <= 0) {
          UTIL_THROW("Cannot allocate with capacity <= 0");
       }
+      #ifndef DDMD_ATOM_SOA
       if (sizeof(Atom) != 64) {
          Log::file() << "Warning: sizeof(Atom) != 64" << std::endl;
          Log::file() << "Size of Atom  = " << sizeof(Atom)  << std::endl;
          Log::file() << "Size of Atom* = " << sizeof(Atom*) << std::endl;
       }
+      #endif
 
       // Allocate memory
       //posix_memalign((void**) &data_, 64, capacity*sizeof(Atom));
-      Memory::allocate<Atom>(data_, capacity);
-      Memory::allocate<Vector>(velocities_, capacity);
-      Memory::allocate<Mask>(masks_, capacity);
-      Memory::allocate<Plan>(plans_, capacity);
-      Memory::allocate<int>(ids_, capacity);
-      Memory::allocate<unsigned int>(groups_, capacity);
+      PageAllocator::allocate<Atom>(data_, capacity);
+      #ifdef DDMD_ATOM_SOA
+      PageAllocator::allocate<Vector>(positions_, capacity);
+      PageAllocator::allocate<Vector>(forces_, capacity);
+      PageAllocator::allocate<int>(typeIds_, capacity);
+      #endif
+      if (Atom::hasVelocity()) {
+         PageAllocator::allocate<Vector>(velocities_, capacity);
+      }
+      PageAllocator::allocate<Mask>(masks_, capacity);
+      PageAllocator::allocate<Plan>(plans_, capacity);
+      PageAllocator::allocate<int>(ids_, capacity);
+      PageAllocator::allocate<unsigned int>(groups_, capacity);
       if (Atom::hasAtomContext()) {
-         Memory::allocate<AtomContext>(contexts_, capacity);
+         PageAllocator::allocate<AtomContext>(contexts_, capacity);
       }
       capacity_ = capacity;
 
-      // Initialize values.
-      for (int i = 0; i < capacity_; ++i) {
+      // Initialize values, in the same static loop as first touch
+      int i;
+      #ifdef DDMD_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (i = 0; i < capacity_; ++i) {
         data_[i].localId_ = (i << 1);
         data_[i].arrayPtr_ = this;
+        #ifdef DDMD_ATOM_SOA
+        positions_[i].zero();
+        forces_[i].zero();
+        typeIds_[i] = -1;
+        #endif
         masks_[i].clear();
         plans_[i].clearFlags();
         ids_[i] = -1;
@@ -100,11 +139,19 @@ namespace DdMd
    */
    void AtomArray::zeroForces() 
    {
+      #ifndef DDMD_ATOM_SOA
       for (int i = 0; i < capacity_; ++i) {
         data_[i].force_[0] = 0.0;
         data_[i].force_[1] = 0.0;
         data_[i].force_[2] = 0.0;
       }
+      #else
+      double* ptr = &(forces_[0][0]);
+      const int n = 3*capacity_;
+      for (int i = 0; i < n; ++i) {
+        ptr[i] = 0.0;
+      }
+      #endif
    }
 
    /*
@@ -113,4 +160,29 @@ namespace DdMd
    bool AtomArray::isAllocated() const 
    {  return (bool)data_; }
 
+   /*
+   * Return number of bytes allocated per element (sum over all arrays).
+   */
+   int AtomArray::bytesPerAtom()
+   {
+      int bytes = sizeof(Atom) + sizeof(Mask)
+                + sizeof(Plan) + sizeof(int) + sizeof(unsigned int);
+      #ifdef DDMD_ATOM_SOA
+      bytes += 2*sizeof(Vector) + sizeof(int);
+      #endif
+      if (Atom::hasVelocity()) {
+         bytes += sizeof(Vector);
+      }
+      if (Atom::hasAtomContext()) {
+         bytes += sizeof(AtomContext);
+      }
+      return bytes;
+   }
+
+   /*
+   * Return number of bytes allocated by this array.
+   */
+   double AtomArray::memoryBytes() const
+   {  return double(capacity_)*double(bytesPerAtom()); }
+
 }
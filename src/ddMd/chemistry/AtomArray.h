@@ -61,15 +61,58 @@ namespace DdMd
       */
       void allocate(int capacity); 
 
+      /**
+      * Free all memory, after which allocate() may be called again.
+      *
+      * Pointers to elements are invalidated. Does nothing if this
+      * array is not allocated.
+      */
+      void deallocate();
+
       /**
       * Set force vector to zero for all atoms in this array.
       */
       void zeroForces(); 
 
+      #ifdef DDMD_ATOM_SOA
+      /**
+      * Return pointer to contiguous array of positions.
+      *
+      * Element i is the position of the Atom in element i of this array.
+      * Available only in the structure-of-arrays layout (DDMD_ATOM_SOA).
+      */
+      Vector* positions();
+
+      /**
+      * Return pointer to contiguous array of forces.
+      *
+      * Element i is the force on the Atom in element i of this array.
+      * Available only in the structure-of-arrays layout (DDMD_ATOM_SOA).
+      */
+      Vector* forces();
+
+      /**
+      * Return pointer to contiguous array of atom type ids.
+      *
+      * Available only in the structure-of-arrays layout (DDMD_ATOM_SOA).
+      */
+      int* typeIds();
+      #endif
+
       /**
       * Return true if this is already allocated, false otherwise.
       */
       bool isAllocated() const;
+
+      /**
+      * Return number of bytes allocated by this array.
+      */
+      double memoryBytes() const;
+
+      /**
+      * Return number of bytes allocated per element.
+      */
+      static int bytesPerAtom();
   
    private:
  
@@ -82,6 +125,23 @@ namespace DdMd
       * array is stored in element i in each of these arrays.
       */
 
+      #ifdef DDMD_ATOM_SOA
+      /**
+      * C-array of Atom positions.
+      */
+      Vector* positions_;
+
+      /**
+      * C-array of Atom forces.
+      */
+      Vector* forces_;
+
+      /**
+      * C-array of Atom type ids.
+      */
+      int* typeIds_;
+      #endif
+
       /**
       * C-array of Atom velocities.
       */
@@ -128,5 +188,18 @@ namespace DdMd
 
    };
 
+   #ifdef DDMD_ATOM_SOA
+   // Inline member functions
+
+   inline Vector* AtomArray::positions()
+   {  return positions_; }
+
+   inline Vector* AtomArray::forces()
+   {  return forces_; }
+
+   inline int* AtomArray::typeIds()
+   {  return typeIds_; }
+   #endif
+
 }
 #endif
@@ -10,6 +10,10 @@
 
 #include <ddMd/communicate/Plan.h>     // member
 #include <ddMd/communicate/Buffer.h>   // method implementation
+#ifdef DDMD_GROUP_INDEX
+#include <ddMd/chemistry/Atom.h>       // inline methods
+#include <util/containers/DArray.h>    // function argument
+#endif
 
 
 namespace DdMd
@@ -44,6 +48,12 @@ namespace DdMd
    * the group, and (2) an array of pointers to these atoms. Each Group<N> 
    * also has an integer type id and a unique global id for the group.
    *
+   * If DDMD_GROUP_INDEX is defined, the pointers are instead stored as
+   * 32 bit indices of atoms in the local and ghost atom arrays (see
+   * Atom::localId()), which halves their size on 64 bit machines. The
+   * indices remain valid when atom arrays are reallocated, and may be
+   * remapped in bulk after local atoms are reordered (remapAtoms()).
+   *
    * \ingroup DdMd_Chemistry_Module
    */
    template <int N>
@@ -102,6 +112,18 @@ namespace DdMd
       * \param i index of atom within group.
       */
       void clearAtomPtr(int i);
+
+      #ifdef DDMD_GROUP_INDEX
+      /**
+      * Remap indices of local atoms after local atoms are reordered.
+      *
+      * \param newIndices new array index of each local atom, indexed
+      *                   by its array index before reordering
+      *
+      * \pre The group contains no ghost atoms.
+      */
+      void remapAtoms(const DArray<int>& newIndices);
+      #endif
   
       /**
       * Get communication plan by reference.
@@ -166,8 +188,13 @@ namespace DdMd
 
    private:
       
+      #ifndef DDMD_GROUP_INDEX
       /// Array of pointers to Atoms in this group.
       Atom*  atomPtrs_[N];
+      #else
+      /// Atom::localId() + 1 of each atom in this group, or 0 if null.
+      unsigned int  atomIndices_[N];
+      #endif
    
       /// Array of integer ids of atoms in this group.
       int  atomIds_[N];
@@ -184,6 +211,16 @@ namespace DdMd
       // Communication Plan.
       Plan plan_;
 
+      /**
+      * Record of a Group packed in a Buffer, copied as one item.
+      */
+      struct Record {
+         int id;
+         int typeId;
+         int atomIds[N];
+         unsigned int flags;
+      };
+
    //friends:
 
       friend 
@@ -249,7 +286,11 @@ namespace DdMd
    {
       for (int i=0; i < N; ++i) {
          atomIds_[i]  = -1;
+         #ifndef DDMD_GROUP_INDEX
          atomPtrs_[i] = 0;
+         #else
+         atomIndices_[i] = 0;
+         #endif
       }
       plan_.clearFlags();
    }
@@ -265,7 +306,11 @@ namespace DdMd
       nPtr_ = 0;
       for (int i=0; i < N; ++i) {
          atomIds_[i]  = -1;
+         #ifndef DDMD_GROUP_INDEX
          atomPtrs_[i] = 0;
+         #else
+         atomIndices_[i] = 0;
+         #endif
       }
       plan_.clearFlags();
    }
@@ -300,10 +345,17 @@ namespace DdMd
       if (atomPtr == 0) {
          UTIL_THROW("Attempt to set null pointer");
       }  
+      #ifndef DDMD_GROUP_INDEX
       if (atomPtrs_[i] == 0) {
          ++nPtr_;
       }
       atomPtrs_[i] = atomPtr; 
+      #else
+      if (atomIndices_[i] == 0) {
+         ++nPtr_;
+      }
+      atomIndices_[i] = atomPtr->localId() + 1;
+      #endif
    }
  
    /*
@@ -312,11 +364,37 @@ namespace DdMd
    template <int N>
    inline void Group<N>::clearAtomPtr(int i)
    {
+      #ifndef DDMD_GROUP_INDEX
       if (atomPtrs_[i] != 0) {
          --nPtr_;
          atomPtrs_[i] = 0; 
       }
+      #else
+      if (atomIndices_[i] != 0) {
+         --nPtr_;
+         atomIndices_[i] = 0;
+      }
+      #endif
+   }
+
+   #ifdef DDMD_GROUP_INDEX
+   /*
+   * Remap indices of local atoms after reordering.
+   */
+   template <int N>
+   void Group<N>::remapAtoms(const DArray<int>& newIndices)
+   {
+      unsigned int localId;
+      for (int i = 0; i < N; ++i) {
+         if (atomIndices_[i] != 0) {
+            localId = atomIndices_[i] - 1;
+            assert((localId & 1) == 0);
+            localId = ((unsigned int)newIndices[localId >> 1]) << 1;
+            atomIndices_[i] = localId + 1;
+         }
+      }
    }
+   #endif
   
    /*
    * Get communication plan by reference.
@@ -353,7 +431,14 @@ namespace DdMd
    */
    template <int N>
    inline Atom* Group<N>::atomPtr(int i) const
+   #ifndef DDMD_GROUP_INDEX
    {  return atomPtrs_[i]; }
+   #else
+   {
+      if (atomIndices_[i] == 0) return 0;
+      return Atom::fromLocalId(atomIndices_[i] - 1);
+   }
+   #endif
  
    /*
    * Return the number of non-null atom pointers in this group.
@@ -439,7 +524,7 @@ namespace DdMd
    */
    template <int N>
    int Group<N>::packedSize()
-   {  return (2 + N)*sizeof(int) + sizeof(unsigned int); }
+   {  return sizeof(Record); }
 
    /*
    * Pack a Group at end of a send buffer.
@@ -447,12 +532,14 @@ namespace DdMd
    template <int N>
    void Group<N>::pack(Buffer& buffer)
    {
-      buffer.pack<int>(id());
-      buffer.pack<int>(typeId());
+      Record record;
+      record.id = id_;
+      record.typeId = typeId_;
       for (int j = 0; j < N; ++j) {
-         buffer.pack<int>(atomId(j));
+         record.atomIds[j] = atomIds_[j];
       }
-      buffer.pack<unsigned int>(plan().flags());
+      record.flags = plan_.flags();
+      buffer.pack<Record>(record);
       buffer.incrementSendSize();
    }
 
@@ -462,19 +549,15 @@ namespace DdMd
    template <int N>
    void Group<N>::unpack(Buffer& buffer)
    {
-      int i;
-      buffer.unpack<int>(i);
-      setId(i);
-      buffer.unpack<int>(i);
-      setTypeId(i);
+      Record record;
+      buffer.unpack<Record>(record);
+      setId(record.id);
+      setTypeId(record.typeId);
       for (int j = 0; j < N; ++j) {
-         buffer.unpack<int>(i);
-         setAtomId(j, i);
+         setAtomId(j, record.atomIds[j]);
          clearAtomPtr(j);
       }
-      unsigned int ui;
-      buffer.unpack<unsigned int>(ui);
-      plan().setFlags(ui);
+      plan().setFlags(record.flags);
       buffer.decrementRecvSize();
    }
 
@@ -18,7 +18,8 @@ namespace DdMd
    * Constructor.
    */
    Mask::Mask()
-    : size_(0)
+    : bits_(0),
+      size_(0)
    {
       for (int i=0; i < Capacity; ++i) {
          atomIds_[i] = -1;
@@ -33,6 +34,7 @@ namespace DdMd
       for (int i=0; i < Capacity; ++i) {
          atomIds_[i] = -1;
       }
+      bits_ = 0;
       size_ = 0;
    }
 
@@ -48,6 +50,7 @@ namespace DdMd
          UTIL_THROW("Attempt to add an atom to a Mask twice");
       }
       atomIds_[size_] = id;
+      bits_ |= (uint64_t(1) << (id & 63));
       ++size_;
    }
 
@@ -9,6 +9,7 @@
 */
 
 #include <util/global.h>
+#include <stdint.h>
 
 namespace DdMd
 {
@@ -26,6 +27,13 @@ namespace DdMd
    * of a Velet pair list to identify nearby atoms for which pair interactions 
    * are suppressed.
    *
+   * In addition to the list of ids, the Mask keeps a 64 bit filter in 
+   * which bit (id & 63) is set for every masked id. Because isMasked()
+   * is called for every candidate pair during a pair list build, and
+   * almost all candidates are not masked, isMasked() first tests this
+   * filter with one shift and AND, and scans the list only if the bit
+   * for the candidate is set.
+   *
    * \ingroup DdMd_Chemistry_Module
    */
    class Mask 
@@ -80,6 +88,9 @@ namespace DdMd
       /// Integer ids to of masked Atoms.
       int atomIds_[Capacity];      
 
+      /// Filter, with bit (id & 63) set for each masked id.
+      uint64_t bits_;
+
       /// Number of masked Atoms.
       int  size_;
 
@@ -92,6 +103,7 @@ namespace DdMd
    */
    inline bool Mask::isMasked(int id) const
    {
+      if (!((bits_ >> (id & 63)) & 1)) return false;
       for (int i=0; i < size_ ; ++i) {
          if (atomIds_[i] == id) return true;
       }
@@ -10,6 +10,9 @@
 #include "Buffer.h"
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/ConstAtomIterator.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/containers/GArray.h>
+#include <util/space/IntVector.h>
 
 #include <algorithm>
 
@@ -499,6 +502,159 @@ namespace DdMd
    }
    #endif
 
+   /*
+   * Return address for a new atom read on this processor.
+   */
+   Atom* AtomDistributor::newLocalAtomPtr()
+   {
+      if (domainPtr_ == 0) {
+         UTIL_THROW("AtomDistributor is not initialized");
+      }
+      if (newPtr_ != 0) {
+         UTIL_THROW("Unprocessed new atom");
+      }
+      newPtr_ = storagePtr_->newAtomPtr();
+      return newPtr_;
+   }
+
+   /*
+   * Add atom read on this processor to the local AtomStorage.
+   */
+   void AtomDistributor::addLocalAtom()
+   {
+      if (newPtr_ == 0) {
+         UTIL_THROW("No active new atom");
+      }
+      boundaryPtr_->shiftGen(newPtr_->position());
+      if (!domainPtr_->isInDomain(newPtr_->position())) {
+         UTIL_THROW("Atom read on wrong processor");
+      }
+      storagePtr_->addNewAtom();
+      newPtr_ = 0;
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Add atom read on this processor for later redistribution.
+   */
+   void AtomDistributor::addStagedAtom()
+   {
+      if (newPtr_ == 0) {
+         UTIL_THROW("No active new atom");
+      }
+      boundaryPtr_->shiftGen(newPtr_->position());
+      storagePtr_->addNewAtom();
+      newPtr_ = 0;
+   }
+
+   /*
+   * Send all local atoms to their owners, one direction at a time.
+   */
+   void AtomDistributor::redistribute()
+   {
+      // Preconditions
+      if (domainPtr_ == 0) {
+         UTIL_THROW("AtomDistributor is not initialized");
+      }
+      if (!domainPtr_->isInitialized()) {
+         UTIL_THROW("Domain is not initialized");
+      }
+      if (!bufferPtr_->isInitialized()) {
+         UTIL_THROW("Buffer is not initialized");
+      }
+      if (storagePtr_->nGhost() != 0) {
+         UTIL_THROW("AtomStorage has ghosts");
+      }
+      if (newPtr_ != 0) {
+         UTIL_THROW("A newPtr_ is still active");
+      }
+
+      MPI::Intracomm& communicator = domainPtr_->communicator();
+      const int capacity = bufferPtr_->atomCapacity();
+      IntVector position = domainPtr_->position(domainPtr_->gridRank());
+      IntVector partner;
+      GArray<Atom*> sendAtoms;
+      AtomIterator atomIter;
+      Atom* ptr;
+      int gridDimension, coordinate, source, dest;
+      int nPacket, nPacketMax;
+      int i, j, k, begin, end;
+
+      for (i = 0; i < Dimension; ++i) {
+         gridDimension = domainPtr_->gridDimension(i);
+         for (j = 1; j < gridDimension; ++j) {
+
+            // Send to processor j steps ahead along axis i, receive
+            // from processor j steps behind (periodic in grid index).
+            coordinate = (position[i] + j) % gridDimension;
+            partner = position;
+            partner[i] = coordinate;
+            dest = domainPtr_->rank(partner);
+            partner[i] = (position[i] - j + gridDimension) % gridDimension;
+            source = domainPtr_->rank(partner);
+
+            // Find atoms owned by processors with grid coordinate[i] 
+            // equal to that of dest. 
+            sendAtoms.clear();
+            storagePtr_->begin(atomIter);
+            for ( ; atomIter.notEnd(); ++atomIter) {
+               partner = domainPtr_->position(
+                          domainPtr_->ownerRank(atomIter->position()));
+               if (partner[i] == coordinate) {
+                  sendAtoms.append(atomIter.get());
+               }
+            }
+
+            // All processors must exchange the same number of buffers.
+            nPacket = (sendAtoms.size() + capacity - 1)/capacity;
+            communicator.Allreduce(&nPacket, &nPacketMax, 1, 
+                                   MPI::INT, MPI::MAX);
+
+            end = 0;
+            for (k = 0; k < nPacketMax; ++k) {
+
+               // Pack next block of atoms, and remove them from storage.
+               // Atoms are packed before they are removed, so reuse of 
+               // their memory by received atoms is safe.
+               begin = end;
+               end = std::min(begin + capacity, sendAtoms.size());
+               bufferPtr_->clearSendBuffer();
+               bufferPtr_->beginSendBlock(Buffer::ATOM);
+               for (int m = begin; m < end; ++m) {
+                  sendAtoms[m]->packAtom(*bufferPtr_);
+                  storagePtr_->removeAtom(sendAtoms[m]);
+               }
+               bufferPtr_->endSendBlock(k == nPacketMax - 1);
+               bufferPtr_->sendRecv(communicator, source, dest);
+
+               // Unpack received atoms into storage.
+               bufferPtr_->beginRecvBlock();
+               while (bufferPtr_->recvSize() > 0) {
+                  ptr = storagePtr_->newAtomPtr();
+                  ptr->unpackAtom(*bufferPtr_);
+                  storagePtr_->addNewAtom();
+               }
+               bufferPtr_->endRecvBlock();
+
+            }
+            bufferPtr_->clearSendBuffer();
+
+         }
+      }
+
+      // Check that every atom is now in this domain
+      storagePtr_->begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         if (!domainPtr_->isInDomain(atomIter->position())) {
+            UTIL_THROW("Atom on wrong processor after redistribution");
+         }
+      }
+
+      storagePtr_->unsetNAtomTotal();
+      storagePtr_->computeNAtomTotal(communicator);
+   }
+   #endif
+
    /*
    * Validate distribution of atoms, return total number of atoms.
    * Called on all processors. Correct return value only on master.
@@ -200,6 +200,57 @@ namespace DdMd
       void receive();
       #endif
 
+      /**
+      * Return address for a new atom read on this processor.
+      *
+      * This method supports parallel reading, in which each processor 
+      * reads its own atoms and no atoms are sent. It may be called on any
+      * processor, and returns the address of a new Atom in the local
+      * AtomStorage. Every call to newLocalAtomPtr() must be followed by 
+      * a matching call to addLocalAtom().
+      *
+      * \return address for a new Atom.
+      */
+      Atom* newLocalAtomPtr();
+
+      /**
+      * Add the atom returned by newLocalAtomPtr() to local storage.
+      *
+      * The coordinates of the atom must be expressed in scaled [0, 1]
+      * coordinates, and must lie within the domain of this processor. 
+      * Throws an Exception otherwise.
+      */
+      void addLocalAtom();
+
+      #ifdef UTIL_MPI
+      /**
+      * Add the atom returned by newLocalAtomPtr() for later redistribution.
+      *
+      * This is an alternative to addLocalAtom() for parallel reading of
+      * files in which the atoms read by each processor may belong to any
+      * domain. The position is shifted into the primary cell, and the atom
+      * is added to the local AtomStorage, where it remains until a later
+      * call to redistribute() sends it to its owner.
+      */
+      void addStagedAtom();
+
+      /**
+      * Send every local atom to the processor that owns it.
+      *
+      * Call on all processors, after all atoms are added. Atoms are
+      * routed in stages, one Cartesian direction at a time: In stage i,
+      * each processor exchanges atoms with the other processors in the 
+      * same row of the processor grid along axis i, using one pairwise 
+      * exchange for each nonzero shift along that row. Each atom is thus
+      * sent at most once per direction, and the number of exchanges is 
+      * the sum of (gridDimension(i) - 1), rather than the number of 
+      * processors. 
+      *
+      * \pre There are no ghost atoms.
+      */
+      void redistribute();
+      #endif
+
       /**
       * Validate distribution of atoms after completion.
       *
@@ -7,10 +7,12 @@
 
 #include "Buffer.h"
 #include "Domain.h"
-#include <util/misc/Memory.h>
+#include <ddMd/misc/Tracer.h>
+#include <ddMd/misc/PageAllocator.h>
 #include <ddMd/chemistry/Atom.h>
 #include <ddMd/chemistry/Group.h>
 #include <util/format/Int.h>
+#include <util/format/Dbl.h>
 
 namespace DdMd
 {
@@ -26,6 +28,7 @@ namespace DdMd
       recvBufferBegin_(0),
       sendBufferEnd_(0),
       recvBufferEnd_(0),
+      recvEnd_(0),
       sendBlockBegin_(0),
       recvBlockBegin_(0),
       recvBlockEnd_(0),
@@ -40,19 +43,60 @@ namespace DdMd
       atomCapacity_(-1),
       ghostCapacity_(-1),
       maxSendLocal_(0),
+      totalSendLocal_(0.0),
+      nSendLocal_(0),
+      maxSend_(),
+      totalSend_(),
+      maxTotalSend_(),
+      nSend_(),
+      #ifdef UTIL_MPI
+      pendingChannel_(-1),
+      nodeRanks_(),
+      #if MPI_VERSION >= 3
+      sharedBases_(),
+      sharedWin_(MPI_WIN_NULL),
+      nodeComm_(MPI_COMM_NULL),
+      sharedParent_(MPI_COMM_NULL),
+      #endif
+      sharedStep_(0),
+      #endif
+      sharedMemory_(false),
+      pendingSendBytes_(0),
+      isPending_(false),
       isInitialized_(false)
-   {  setClassName("Buffer"); }
+   {  
+      setClassName("Buffer"); 
+      #ifdef UTIL_MPI
+      for (int i = 0; i < MaxChannel; ++i) {
+         channels_[i].source = -1;
+         channels_[i].dest = -1;
+         channels_[i].sourceNode = -1;
+         channels_[i].destNode = -1;
+         channels_[i].sendBytes = -1;
+         channels_[i].isActive = false;
+      }
+      #endif
+   }
 
    /*
    * Destructor.
    */
    Buffer::~Buffer()
    {
+      #if defined(UTIL_MPI) && MPI_VERSION >= 3
+      if (sharedWin_ != MPI_WIN_NULL) {
+         int isFinalized;
+         MPI_Finalized(&isFinalized);
+         if (!isFinalized) {
+            disableSharedMemory();
+         }
+      }
+      #endif
       if (sendBufferBegin_) {
-         Memory::deallocate<char>(sendBufferBegin_, bufferCapacity_);
+         PageAllocator::deallocate<char>(sendBufferBegin_, bufferCapacity_);
       }
       if (recvBufferBegin_) {
-         Memory::deallocate<char>(recvBufferBegin_, bufferCapacity_);
+         PageAllocator::deallocate<char>(recvBufferBegin_, bufferCapacity_);
       }
    }
 
@@ -89,6 +133,8 @@ namespace DdMd
       // Read parameters
       read<int>(in, "atomCapacity",  atomCapacity_);
       read<int>(in, "ghostCapacity", ghostCapacity_);
+      sharedMemory_ = false;
+      readOptional<bool>(in, "sharedMemory", sharedMemory_);
 
       //Preconditions
       if (atomCapacity_ < 0) {
@@ -114,6 +160,8 @@ namespace DdMd
       // Read parameters
       loadParameter<int>(ar, "atomCapacity",  atomCapacity_);
       loadParameter<int>(ar, "ghostCapacity", ghostCapacity_);
+      sharedMemory_ = false;
+      loadParameter<bool>(ar, "sharedMemory", sharedMemory_, false);
 
       // Validate data
       if (atomCapacity_ < 0) {
@@ -138,6 +186,7 @@ namespace DdMd
    {
       ar << atomCapacity_;
       ar << ghostCapacity_;
+      Parameter::saveOptional(ar, sharedMemory_, sharedMemory_);
    }
 
    /*
@@ -196,14 +245,51 @@ namespace DdMd
       bufferCapacity_ += dataCapacity_ + 4 * sizeof(int);
 
       // Allocate memory for the send buffer
-      Memory::allocate<char>(sendBufferBegin_, bufferCapacity_);
+      PageAllocator::allocate<char>(sendBufferBegin_, bufferCapacity_);
       sendBufferEnd_ = sendBufferBegin_ + bufferCapacity_;
 
       // Allocate memory for the receive buffer
-      Memory::allocate<char>(recvBufferBegin_, bufferCapacity_);
+      PageAllocator::allocate<char>(recvBufferBegin_, bufferCapacity_);
       recvBufferEnd_ = recvBufferBegin_ + bufferCapacity_;
 
       recvPtr_ = recvBufferBegin_;
+      recvEnd_ = recvBufferEnd_;
+   }
+
+   /*
+   * Increase capacities and reallocate send and recv buffers.
+   */
+   void Buffer::reallocate(int atomCapacity, int ghostCapacity)
+   {
+      if (isPending_) {
+         UTIL_THROW("A sendRecv is pending");
+      }
+      if (!isAllocated()) {
+         UTIL_THROW("Buffer is not allocated");
+      }
+      clearChannels();
+      #if MPI_VERSION >= 3
+      MPI_Comm sharedParent = sharedParent_;
+      disableSharedMemory();
+      #endif
+      PageAllocator::deallocate<char>(sendBufferBegin_, bufferCapacity_);
+      PageAllocator::deallocate<char>(recvBufferBegin_, bufferCapacity_);
+      sendBufferBegin_ = 0;
+      recvBufferBegin_ = 0;
+      bufferCapacity_ = -1;
+      if (atomCapacity > atomCapacity_) {
+         atomCapacity_ = atomCapacity;
+      }
+      if (ghostCapacity > ghostCapacity_) {
+         ghostCapacity_ = ghostCapacity;
+      }
+      allocate();
+      clearSendBuffer();
+      #if MPI_VERSION >= 3
+      if (sharedParent != MPI_COMM_NULL) {
+         allocateShared(sharedParent);
+      }
+      #endif
    }
 
    /*
@@ -318,13 +404,22 @@ namespace DdMd
    */
    void Buffer::sendRecv(MPI::Intracomm& comm, int source, int dest)
    {
+      beginSendRecv(comm, source, dest);
+      endSendRecv();
+   }
 
-      MPI::Request request[2];
-      int  sendBytes = 0;
+   /*
+   * Begin nonblocking send and receive (returns immediately).
+   */
+   void Buffer::beginSendRecv(MPI::Intracomm& comm, int source, int dest)
+   {
       int  myRank    = comm.Get_rank();
       int  comm_size = comm.Get_size();
 
       // Preconditions
+      if (isPending_) {
+         UTIL_THROW("A previous sendRecv is still pending");
+      }
       if (dest > comm_size - 1 || dest < 0) {
          UTIL_THROW("Destination rank out of bounds");
       }
@@ -339,24 +434,275 @@ namespace DdMd
       }
 
       // Start nonblocking receive.
-      request[0] = comm.Irecv(recvBufferBegin_, bufferCapacity_ ,
-                              MPI::CHAR, source, 5);
+      requests_[0] = comm.Irecv(recvBufferBegin_, bufferCapacity_ ,
+                                MPI::CHAR, source, 5);
 
       // Start nonblocking send.
-      sendBytes = sendPtr_ - sendBufferBegin_;
-      request[1] = comm.Isend(sendBufferBegin_, sendBytes , MPI::CHAR, dest, 5);
+      pendingSendBytes_ = sendPtr_ - sendBufferBegin_;
+      requests_[1] = comm.Isend(sendBufferBegin_, pendingSendBytes_, 
+                                MPI::CHAR, dest, 5);
+      pendingChannel_ = -1;
+      isPending_ = true;
+   }
+
+   /*
+   * Begin nonblocking send and receive on a persistent channel.
+   */
+   void Buffer::beginSendRecv(MPI::Intracomm& comm, int source, int dest,
+                              int channel)
+   {
+      // Preconditions
+      if (isPending_) {
+         UTIL_THROW("A previous sendRecv is still pending");
+      }
+      if (channel < 0 || channel >= MaxChannel) {
+         UTIL_THROW("Channel index out of bounds");
+      }
+
+      Channel& c = channels_[channel];
+      pendingSendBytes_ = sendPtr_ - sendBufferBegin_;
+
+      // Recreate requests if the message has changed
+      if (c.isActive) {
+         if (c.source != source || c.dest != dest 
+             || c.sendBytes != pendingSendBytes_) {
+            if (c.sourceNode < 0) c.recvRequest.Free();
+            if (c.destNode < 0) c.sendRequest.Free();
+            c.isActive = false;
+         }
+      }
+
+      // Create requests only for ranks that are not on this node
+      if (!c.isActive) {
+         if (dest == comm.Get_rank() || source == comm.Get_rank()) {
+            UTIL_THROW("Source or destination is my rank");
+         }
+         c.sourceNode = nodeRank(source);
+         c.destNode = nodeRank(dest);
+         if (c.sourceNode < 0) {
+            c.recvRequest = comm.Recv_init(recvBufferBegin_, bufferCapacity_,
+                                           MPI::CHAR, source, 5);
+         }
+         if (c.destNode < 0) {
+            c.sendRequest = comm.Send_init(sendBufferBegin_, 
+                                           pendingSendBytes_,
+                                           MPI::CHAR, dest, 5);
+         }
+         c.source = source;
+         c.dest = dest;
+         c.sendBytes = pendingSendBytes_;
+         c.isActive = true;
+      }
+
+      if (c.sourceNode < 0) {
+         c.recvRequest.Start();
+      }
+      if (c.destNode < 0) {
+         c.sendRequest.Start();
+      } 
+      #if MPI_VERSION >= 3
+      else {
+         // Copy message into the slot of my window for this transmission
+         char* slot = sharedBases_[nodeRank(comm.Get_rank())] 
+                    + (sharedStep_ % 2)*bufferCapacity_;
+         memcpy(slot, sendBufferBegin_, pendingSendBytes_);
+      }
+      #endif
+      pendingChannel_ = channel;
+      isPending_ = true;
+   }
+
+   /*
+   * Free all persistent requests.
+   */
+   void Buffer::clearChannels()
+   {
+      if (isPending_ && pendingChannel_ >= 0) {
+         UTIL_THROW("A persistent sendRecv is still pending");
+      }
+      for (int i = 0; i < MaxChannel; ++i) {
+         if (channels_[i].isActive) {
+            if (channels_[i].sourceNode < 0) {
+               channels_[i].recvRequest.Free();
+            }
+            if (channels_[i].destNode < 0) {
+               channels_[i].sendRequest.Free();
+            }
+            channels_[i].isActive = false;
+         }
+      }
+   }
+
+   /*
+   * Allocate a node shared memory window, if requested.
+   */
+   void Buffer::enableSharedMemory(MPI::Intracomm& comm)
+   {
+      if (!sharedMemory_) return;
+      #if MPI_VERSION >= 3
+      if (isPending_) {
+         UTIL_THROW("A sendRecv is pending");
+      }
+      if (!isAllocated()) {
+         UTIL_THROW("Buffer is not allocated");
+      }
+      disableSharedMemory();
+      allocateShared((MPI_Comm)comm);
+      #else
+      UTIL_THROW("Buffer sharedMemory requires MPI-3");
+      #endif
+   }
 
-      // Wait for completion of receive.
-      request[0].Wait();
+   #if MPI_VERSION >= 3
+   /*
+   * Create node communicator and shared memory window (private).
+   */
+   void Buffer::allocateShared(MPI_Comm parent)
+   {
+      // Split parent communicator into nodes
+      int rank, size, nodeSize;
+      MPI_Comm_rank(parent, &rank);
+      MPI_Comm_size(parent, &size);
+      MPI_Comm_split_type(parent, MPI_COMM_TYPE_SHARED, rank, 
+                          MPI_INFO_NULL, &nodeComm_);
+      MPI_Comm_size(nodeComm_, &nodeSize);
+
+      // Map ranks in parent to ranks in node (-1 if on another node)
+      MPI_Group parentGroup, nodeGroup;
+      MPI_Comm_group(parent, &parentGroup);
+      MPI_Comm_group(nodeComm_, &nodeGroup);
+      DArray<int> ranks;
+      ranks.allocate(size);
+      if (!nodeRanks_.isAllocated()) {
+         nodeRanks_.allocate(size);
+      }
+      UTIL_CHECK(nodeRanks_.capacity() == size);
+      int i;
+      for (i = 0; i < size; ++i) {
+         ranks[i] = i;
+      }
+      MPI_Group_translate_ranks(parentGroup, size, &ranks[0], 
+                                nodeGroup, &nodeRanks_[0]);
+      for (i = 0; i < size; ++i) {
+         if (nodeRanks_[i] == MPI_UNDEFINED) {
+            nodeRanks_[i] = -1;
+         }
+      }
+      MPI_Group_free(&parentGroup);
+      MPI_Group_free(&nodeGroup);
+
+      // Allocate two message slots per rank, and find all slots on node
+      void* base;
+      MPI_Aint windowBytes = 2*(MPI_Aint)bufferCapacity_;
+      MPI_Win_allocate_shared(windowBytes, 1, MPI_INFO_NULL, nodeComm_,
+                              &base, &sharedWin_);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedWin_);
+      sharedBases_.allocate(nodeSize);
+      MPI_Aint bytes;
+      int dispUnit;
+      for (i = 0; i < nodeSize; ++i) {
+         MPI_Win_shared_query(sharedWin_, i, &bytes, &dispUnit, &base);
+         sharedBases_[i] = (char*) base;
+      }
+
+      sharedParent_ = parent;
+      sharedStep_ = 0;
+      clearChannels();
+   }
+   #endif
+
+   /*
+   * Free the node shared memory window, if any.
+   */
+   void Buffer::disableSharedMemory()
+   {
+      #if MPI_VERSION >= 3
+      if (sharedWin_ == MPI_WIN_NULL) return;
+      if (isPending_) {
+         UTIL_THROW("A sendRecv is pending");
+      }
+      clearChannels();
+      MPI_Win_unlock_all(sharedWin_);
+      MPI_Win_free(&sharedWin_);
+      MPI_Comm_free(&nodeComm_);
+      sharedBases_.deallocate();
+      sharedParent_ = MPI_COMM_NULL;
       recvPtr_ = recvBufferBegin_;
+      recvEnd_ = recvBufferEnd_;
+      #endif
+   }
 
-      // Wait for completion of send.
-      request[1].Wait();
+   /*
+   * Return rank in node of a rank in the channel communicator, or -1.
+   */
+   int Buffer::nodeRank(int rank) const
+   {
+      #if MPI_VERSION >= 3
+      if (sharedWin_ != MPI_WIN_NULL) {
+         return nodeRanks_[rank];
+      }
+      #endif
+      return -1;
+   }
+
+   /*
+   * Complete a nonblocking send and receive.
+   */
+   void Buffer::endSendRecv()
+   {
+      if (!isPending_) {
+         UTIL_THROW("No pending sendRecv");
+      }
+
+      // Wait for completion of receive, then of send.
+      double waitBegin = Tracer::isActive() ? MPI_Wtime() : 0.0;
+      if (pendingChannel_ >= 0) {
+         Channel& c = channels_[pendingChannel_];
+         if (c.sourceNode < 0) {
+            c.recvRequest.Wait();
+            recvPtr_ = recvBufferBegin_;
+            recvEnd_ = recvBufferEnd_;
+         }
+         if (c.destNode < 0) {
+            c.sendRequest.Wait();
+         }
+         #if MPI_VERSION >= 3
+         if (sharedWin_ != MPI_WIN_NULL) {
+
+            // Wait until all ranks of the node have copied messages into
+            // their slots, and have unpacked the previous messages.
+            MPI_Win_sync(sharedWin_);
+            MPI_Barrier(nodeComm_);
+            MPI_Win_sync(sharedWin_);
+
+            // Unpack directly from the slot of the source
+            if (c.sourceNode >= 0) {
+               recvPtr_ = sharedBases_[c.sourceNode]
+                        + (sharedStep_ % 2)*bufferCapacity_;
+               recvEnd_ = recvPtr_ + bufferCapacity_;
+            }
+            ++sharedStep_;
+         }
+         #endif
+      } else {
+         requests_[0].Wait();
+         recvPtr_ = recvBufferBegin_;
+         recvEnd_ = recvBufferEnd_;
+         requests_[1].Wait();
+      }
+      pendingChannel_ = -1;
+      isPending_ = false;
+      if (Tracer::isActive()) {
+         static const int waitId = Tracer::nameId("wait");
+         Tracer::record(waitId, waitBegin, MPI_Wtime());
+      }
 
       // Update statistics.
-      if (sendBytes > maxSendLocal_) {
-         maxSendLocal_ = sendBytes;
+      if (pendingSendBytes_ > maxSendLocal_) {
+         maxSendLocal_ = pendingSendBytes_;
       }
+      totalSendLocal_ += double(pendingSendBytes_);
+      ++nSendLocal_;
    }
 
    /*
@@ -385,6 +731,8 @@ namespace DdMd
       if (sendBytes > maxSendLocal_) {
          maxSendLocal_ = sendBytes;
       }
+      totalSendLocal_ += double(sendBytes);
+      ++nSendLocal_;
    }
 
    /*
@@ -409,6 +757,7 @@ namespace DdMd
       request.Wait();
       recvType_ = NONE;
       recvPtr_ = recvBufferBegin_;
+      recvEnd_ = recvBufferEnd_;
    }
 
    /*
@@ -429,10 +778,13 @@ namespace DdMd
          comm.Bcast(sendBufferBegin_, sendBytes, MPI::CHAR, source);
          sendPtr_ = sendBufferBegin_;
          sendType_ = NONE;
+         totalSendLocal_ += double(sendBytes);
+         ++nSendLocal_;
       } else {
          comm.Bcast(&sendBytes, 1, MPI::INT, source);
          comm.Bcast(recvBufferBegin_, sendBytes, MPI::CHAR, source);
          recvPtr_ = recvBufferBegin_;
+         recvEnd_ = recvBufferEnd_;
          recvType_ = NONE;
       }
       if (sendBytes > maxSendLocal_) {
@@ -455,8 +807,23 @@ namespace DdMd
       int globalSendMax;
       comm.Allreduce(&maxSendLocal_, &globalSendMax, 1, MPI::INT, MPI::MAX);
       maxSend_.set(globalSendMax);
+
+      double globalTotal, globalMaxTotal;
+      comm.Allreduce(&totalSendLocal_, &globalTotal, 1, 
+                     MPI::DOUBLE, MPI::SUM);
+      comm.Allreduce(&totalSendLocal_, &globalMaxTotal, 1, 
+                     MPI::DOUBLE, MPI::MAX);
+      totalSend_.set(globalTotal);
+      maxTotalSend_.set(globalMaxTotal);
+
+      int globalNSend;
+      comm.Allreduce(&nSendLocal_, &globalNSend, 1, MPI::INT, MPI::SUM);
+      nSend_.set(globalNSend);
       #else
       maxSend_.set(maxSendLocal_);
+      totalSend_.set(totalSendLocal_);
+      maxTotalSend_.set(totalSendLocal_);
+      nSend_.set(nSendLocal_);
       #endif
    }
 
@@ -466,7 +833,12 @@ namespace DdMd
    void Buffer::clearStatistics()
    {
       maxSendLocal_ = 0;
+      totalSendLocal_ = 0.0;
+      nSendLocal_ = 0;
       maxSend_.unset();
+      totalSend_.unset();
+      maxTotalSend_.unset();
+      nSend_.unset();
    }
 
    /*
@@ -481,20 +853,74 @@ namespace DdMd
           << Int(maxSend_.value(), 10)
           << Int(bufferCapacity_, 10)
           << std::endl;
+      out << "messages sent (all procs)  " 
+          << Int(nSend_.value(), 10) << std::endl;
+      out << "bytes sent: total, max/proc" 
+          << Dbl(totalSend_.value(), 14, 6)
+          << Dbl(maxTotalSend_.value(), 14, 6)
+          << std::endl;
    }
 
+   /*
+   * Total bytes sent by all processors (call after computeStatistics).
+   */
+   double Buffer::totalSendBytes() const
+   {  return totalSend_.value(); }
+
+   /*
+   * Maximum over processors of bytes sent by one processor.
+   */
+   double Buffer::maxProcSendBytes() const
+   {  return maxTotalSend_.value(); }
+
+   /*
+   * Maximum size of one message on any processor, in bytes.
+   */
+   int Buffer::maxSendBytes() const
+   {  return maxSend_.value(); }
+
+   /*
+   * Bytes allocated for send and receive buffers.
+   */
+   double Buffer::memoryBytes() const
+   {  return isInitialized_ ? 2.0*bufferCapacity_ : 0.0; }
+
+   /*
+   * High-water mark of bytes used in send and receive buffers.
+   */
+   double Buffer::maxMemoryBytes() const
+   {  return 2.0*maxSendLocal_; }
+
+   /*
+   * Total number of messages sent by all processors.
+   */
+   int Buffer::nSend() const
+   {  return nSend_.value(); }
+
    /*
    * Number of items packed thus far in current data send block.
    */
    int Buffer::sendSize() const
    {  return sendSize_; }
 
+   /*
+   * Number of bytes packed into the send buffer since it was cleared.
+   */
+   int Buffer::sendBytes() const
+   {  return (int)(sendPtr_ - sendBufferBegin_); }
+
    /*
    * Number of unread items left in the current receive block.
    */
    int Buffer::recvSize() const
    {  return recvSize_; }
 
+   /*
+   * Type of data in current recv block.
+   */
+   int Buffer::recvType() const
+   {  return recvType_; }
+
    /*
    * Has this buffer been allocated?
    */
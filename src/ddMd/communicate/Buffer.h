@@ -10,8 +10,12 @@
 
 #include <util/param/ParamComposite.h>  // base class
 #include <util/misc/Setable.h>          // member
+#include <util/containers/DArray.h>     // member
+#include <util/space/Dimension.h>       // MaxChannel
 #include <util/global.h>
 
+#include <cstring>
+
 namespace DdMd
 {
 
@@ -56,6 +60,8 @@ namespace DdMd
    *   - GHOST   : a ghost atom (position, id and typeId)
    *   - UPDATE  : an update of a ghost atom position
    *   - FORCE   : a force vector for use in a reverse update
+   *   - UPDATE_DELTA : a single precision offset of a ghost position
+   *   - FORCE_FLOAT  : a single precision force vector
    *   - GROUP2  : a Group<2> (bond)
    *   - GROUP3  : a Group<3> (angle)
    *   - GROUP4  : a Group<4> (dihedral)
@@ -72,6 +78,9 @@ namespace DdMd
    * Buffer::pack<T>() and Buffer::unpack<T>() member function 
    * templates of the Buffer class, which a user to pack and 
    * unpack a single C variable of type T to or from a Buffer.
+   * The fixed-size data of each atom or group is gathered into one
+   * plain old data record, which is copied by a single call, so that
+   * only variable-length data (e.g., a Mask) is packed by value.
    * 
    * The SPECIAL BlockDataType value is a generic label for any
    * specialized, non-standard data type. Code that uses an 
@@ -212,6 +221,23 @@ namespace DdMd
    * of all the DdMd Distributor and Collector classes (AtomDistributor, 
    * AtomCollector, GroupDistributor and GroupCollector).
    *
+   * \section Buffer_shared_sec Node shared memory
+   *
+   * If the optional parameter sharedMemory is true, and the MPI library
+   * supports MPI-3, enableSharedMemory() allocates a window of shared
+   * memory on each node (MPI_Win_allocate_shared). Persistent channels
+   * (beginSendRecv with a channel index) then send a message to a rank
+   * on the same node by copying it into a slot of the shared window of
+   * the sender, and the receiving rank unpacks it directly from that
+   * slot, without a message. Messages to and from ranks on other nodes
+   * are sent as before. Each transmission on a channel is completed by
+   * a barrier among the ranks of a node, so all ranks must start the
+   * same sequence of channel transmissions, as in the ghost updates of
+   * the Exchanger, and each received message must be unpacked before
+   * the next channel transmission is completed. Each rank has two slots,
+   * used by alternate transmissions, so that a rank can copy the next
+   * message into its window while its last message is being read.
+   *
    * \ingroup DdMd_Communicate_Module
    */
    class Buffer: public ParamComposite 
@@ -223,6 +249,7 @@ namespace DdMd
       * Enumeration of types of data to be sent in blocks. 
       */
       enum BlockDataType {NONE, ATOM, GHOST, UPDATE, FORCE, 
+                          UPDATE_DELTA, FORCE_FLOAT,
                           GROUP2, GROUP3, GROUP4, SPECIAL};
 
       /**
@@ -269,6 +296,21 @@ namespace DdMd
       */
       void allocate(int atomCapacity, int ghostCapacity);
 
+      #ifdef UTIL_MPI
+      /**
+      * Increase capacities, and reallocate send and recv buffers.
+      *
+      * Contents of both buffers are discarded, and all persistent
+      * channels are freed. Capacities are never decreased. Must be
+      * called with the same arguments on all processors, when no
+      * sendRecv is pending.
+      *
+      * \param atomCapacity max expected number of local atoms.
+      * \param ghostCapacity max expected number of ghost atoms.
+      */
+      void reallocate(int atomCapacity, int ghostCapacity);
+      #endif
+
       /// \name Send Buffer Management
       ///@{
       
@@ -305,6 +347,20 @@ namespace DdMd
       */
       void incrementSendSize();
 
+      /**
+      * Pack a contiguous array of n items into the send buffer.
+      *
+      * Copies n consecutive elements of type T with a single memcpy,
+      * and increments the sendSize counter by n. Each element counts
+      * as one item, and may be unpacked either by unpackArray() or by
+      * n calls to unpack() and decrementRecvSize().
+      *
+      * \param array pointer to first element
+      * \param n     number of elements
+      */
+      template <typename T>
+      void packArray(const T* array, int n);
+
       /**
       * Finalize a block in the send buffer.
       *
@@ -355,6 +411,18 @@ namespace DdMd
       */
       void decrementRecvSize();
 
+      /**
+      * Unpack n items from the receive buffer into a contiguous array.
+      *
+      * Copies n consecutive elements of type T with a single memcpy,
+      * and decrements the recvSize counter by n.
+      *
+      * \param array pointer to first element (output)
+      * \param n     number of elements
+      */
+      template <typename T>
+      void unpackArray(T* array, int n);
+
       /**
       * Finish processing a block in the recv buffer.
       *
@@ -386,6 +454,97 @@ namespace DdMd
       */
       void sendRecv(MPI::Intracomm& comm, int source, int dest);
 
+      /**
+      * Begin a nonblocking send and receive, and return immediately.
+      *
+      * Posts the same nonblocking receive and send as sendRecv(), but
+      * does not wait for completion. Neither buffer may be accessed, and
+      * no other transmission may be started, until endSendRecv() has
+      * been called. The pair beginSendRecv() and endSendRecv() is thus
+      * equivalent to sendRecv(), but allows computation to overlap the 
+      * communication.
+      *
+      * \param comm   MPI communicator object
+      * \param source MPI rank of processor from which data is sent
+      * \param dest   MPI rank of processor to which data is sent
+      */
+      void beginSendRecv(MPI::Intracomm& comm, int source, int dest);
+
+      /**
+      * Begin a nonblocking send and receive using persistent requests.
+      *
+      * Equivalent to beginSendRecv(comm, source, dest), except that the
+      * MPI requests are persistent requests associated with an integer
+      * channel index. The requests for a channel are created (by 
+      * Send_init and Recv_init) on the first call for that channel after 
+      * clearChannels(), and are then only restarted by subsequent calls 
+      * with the same source, destination and number of bytes sent. If 
+      * any of these differ, the requests for the channel are recreated.
+      * Complete the transmission by calling endSendRecv().
+      *
+      * \param comm    MPI communicator object
+      * \param source  MPI rank of processor from which data is sent
+      * \param dest    MPI rank of processor to which data is sent
+      * \param channel channel index, 0 <= channel < MaxChannel
+      */
+      void beginSendRecv(MPI::Intracomm& comm, int source, int dest, 
+                         int channel);
+
+      /**
+      * Free the persistent requests of all channels.
+      *
+      * Call whenever the messages on the channels change, e.g., after
+      * ghost atoms are exchanged, and before MPI is finalized.
+      */
+      void clearChannels();
+
+      /**
+      * Allocate a node shared memory window for persistent channels.
+      *
+      * Does nothing unless the sharedMemory parameter is true. Otherwise,
+      * splits comm into nodes (MPI_COMM_TYPE_SHARED) and allocates a 
+      * window in which each rank has two slots of the buffer capacity.
+      * Persistent channels must afterwards be used with comm. Throws an
+      * Exception if the MPI library does not support MPI-3. Call on all
+      * processors of comm, when no sendRecv is pending.
+      *
+      * \param comm communicator used for persistent channels
+      */
+      void enableSharedMemory(MPI::Intracomm& comm);
+
+      /**
+      * Free the node shared memory window, if any.
+      *
+      * Call on all processors, before MPI is finalized.
+      */
+      void disableSharedMemory();
+
+      /**
+      * Are on-node channel transmissions done through shared memory?
+      */
+      bool hasSharedMemory() const;
+
+      /**
+      * Maximum number of persistent channels.
+      *
+      * Exchanger uses 2*Dimension channels for each kind of update
+      * (positions, forces, velocities, labels), and 4*Dimension for
+      * the two passes of atom stress updates, up to 16*Dimension.
+      */
+      static const int MaxChannel = 16*Dimension;
+
+      /**
+      * Wait for completion of a transmission begun by beginSendRecv().
+      *
+      * On return, the receive buffer is ready for unpacking.
+      */
+      void endSendRecv();
+
+      /**
+      * Is a send and receive begun by beginSendRecv() still pending?
+      */
+      bool isPending() const;
+
       /**
       * Send a complete buffer.
       *
@@ -444,6 +603,46 @@ namespace DdMd
       * Clear any accumulated usage statistics.
       */
       void clearStatistics();
+
+      /**
+      * Total number of bytes sent by all processors.
+      *
+      * Call after computeStatistics.
+      */
+      double totalSendBytes() const;
+
+      /**
+      * Maximum over processors of the total bytes sent by one processor.
+      *
+      * Call after computeStatistics.
+      */
+      double maxProcSendBytes() const;
+
+      /**
+      * Maximum size of a single message sent by any processor, in bytes.
+      *
+      * Call after computeStatistics.
+      */
+      int maxSendBytes() const;
+
+      /**
+      * Number of bytes allocated for send and receive buffers.
+      */
+      double memoryBytes() const;
+
+      /**
+      * High-water mark of bytes used in send and receive buffers.
+      *
+      * Computed from the largest message sent by this processor.
+      */
+      double maxMemoryBytes() const;
+
+      /**
+      * Total number of messages sent or broadcast by all processors.
+      *
+      * Call after computeStatistics.
+      */
+      int nSend() const;
       
       //@}
       /// \name Accessors
@@ -459,6 +658,16 @@ namespace DdMd
       */
       int recvSize() const;
 
+      /**
+      * BlockDataType of current recv block (NONE between blocks).
+      */
+      int recvType() const;
+
+      /**
+      * Number of bytes packed into the send buffer since it was cleared.
+      */
+      int sendBytes() const;
+
       /**
       * Has memory been allocated for this Buffer?
       */
@@ -501,6 +710,9 @@ namespace DdMd
       /// End of allocated send Buffer (one char past end).
       char* recvBufferEnd_;
 
+      /// End of region from which data is unpacked (recv buffer or slot).
+      char* recvEnd_;
+
       /// Pointer to beginning of current block in send buffer.
       char* sendBlockBegin_;
 
@@ -543,9 +755,78 @@ namespace DdMd
       /// Maximum size used for send buffer on this processor, in bytes.
       int maxSendLocal_;
 
+      /// Total number of bytes sent by this processor.
+      double totalSendLocal_;
+
+      /// Number of messages sent by this processor.
+      int nSendLocal_;
+
       /// Maximum size used for send buffers on any processor, in bytes.
       Setable<int> maxSend_;
 
+      /// Total number of bytes sent by all processors.
+      Setable<double> totalSend_;
+
+      /// Maximum over processors of total bytes sent per processor.
+      Setable<double> maxTotalSend_;
+
+      /// Total number of messages sent by all processors.
+      Setable<int> nSend_;
+
+      #ifdef UTIL_MPI
+      /// Requests for pending receive [0] and send [1].
+      MPI::Request requests_[2];
+
+      /**
+      * Persistent send and receive requests for one channel.
+      */
+      struct Channel {
+         MPI::Prequest recvRequest;
+         MPI::Prequest sendRequest;
+         int source;
+         int dest;
+         int sourceNode;   // rank of source in node, or -1 for a message
+         int destNode;     // rank of dest in node, or -1 for a message
+         int sendBytes;
+         bool isActive;
+      };
+
+      /// Persistent channels.
+      Channel channels_[MaxChannel];
+
+      /// Channel of pending send and receive (-1 if not persistent).
+      int pendingChannel_;
+
+      /// Rank in node of each rank of the channel communicator, or -1.
+      DArray<int> nodeRanks_;
+
+      #if MPI_VERSION >= 3
+      /// Addresses of shared windows of ranks in node.
+      DArray<char*> sharedBases_;
+
+      /// Shared memory window (MPI_WIN_NULL if not enabled).
+      MPI_Win sharedWin_;
+
+      /// Communicator of ranks in node (MPI_COMM_NULL if not enabled).
+      MPI_Comm nodeComm_;
+
+      /// Communicator for which the window was created.
+      MPI_Comm sharedParent_;
+      #endif
+
+      /// Number of completed channel transmissions using shared memory.
+      long sharedStep_;
+      #endif
+
+      /// Use node shared memory for persistent channels? (parameter)
+      bool sharedMemory_;
+
+      /// Number of bytes in pending send.
+      int pendingSendBytes_;
+
+      /// Is a nonblocking send and receive pending?
+      bool isPending_;
+
       /// Has this buffer been initialized ?
       bool isInitialized_;
 
@@ -554,6 +835,20 @@ namespace DdMd
       */
       void allocate();
 
+      #ifdef UTIL_MPI
+      /*
+      * Return rank in node of a rank in the channel communicator, or -1.
+      */
+      int nodeRank(int rank) const;
+
+      #if MPI_VERSION >= 3
+      /*
+      * Create node communicator and shared window for parent.
+      */
+      void allocateShared(MPI_Comm parent);
+      #endif
+      #endif
+
    };
 
    /*
@@ -577,7 +872,7 @@ namespace DdMd
    template <typename T>
    inline void Buffer::unpack(T& data)
    {
-      if (recvPtr_ + sizeof(data) > recvBufferEnd_) {
+      if (recvPtr_ + sizeof(data) > recvEnd_) {
          UTIL_THROW("Attempted read past end of recv buffer");
       }
       T* ptr = (T *)recvPtr_;
@@ -586,6 +881,36 @@ namespace DdMd
       recvPtr_ = (char *)ptr;
    }
 
+   /*
+   * Pack a contiguous array of n objects of type T into sendBuffer.
+   */
+   template <typename T>
+   inline void Buffer::packArray(const T* array, int n)
+   {
+      size_t nByte = n*sizeof(T);
+      if (sendPtr_ + nByte > sendBufferEnd_) {
+         UTIL_THROW("Attempted write past end of send buffer");
+      }
+      memcpy(sendPtr_, array, nByte);
+      sendPtr_ += nByte;
+      sendSize_ += n;
+   }
+
+   /*
+   * Unpack a contiguous array of n objects of type T from recvBuffer.
+   */
+   template <typename T>
+   inline void Buffer::unpackArray(T* array, int n)
+   {
+      size_t nByte = n*sizeof(T);
+      if (recvPtr_ + nByte > recvEnd_) {
+         UTIL_THROW("Attempted read past end of recv buffer");
+      }
+      memcpy(array, recvPtr_, nByte);
+      recvPtr_ += nByte;
+      recvSize_ -= n;
+   }
+
    /*
    * Maximum number of Group<N> objects that can fit buffer.
    */
@@ -610,5 +935,25 @@ namespace DdMd
    inline void Buffer::decrementRecvSize()
    { --recvSize_; }
 
+   /*
+   * Is a nonblocking send and receive pending?
+   */
+   inline bool Buffer::isPending() const
+   {  return isPending_; }
+
+   #ifdef UTIL_MPI
+   /*
+   * Are on-node channel transmissions done through shared memory?
+   */
+   inline bool Buffer::hasSharedMemory() const
+   {
+      #if MPI_VERSION >= 3
+      return (sharedWin_ != MPI_WIN_NULL);
+      #else
+      return false;
+      #endif
+   }
+   #endif
+
 }
 #endif
@@ -8,6 +8,8 @@
 #include "Domain.h"
 #include <util/space/Dimension.h>
 
+#include <cmath>
+
 namespace DdMd
 {
 
@@ -23,8 +25,13 @@ namespace DdMd
       shift_(),
       gridDimensions_(),
       gridCoordinates_(),
+      nodeDimensions_(),
       gridRank_(-1),
+      slabAxis_(-1),
+      slabLower_(0.0),
+      slabUpper_(1.0),
       gridIsPeriodic_(),
+      gridBounds_(),
       #if UTIL_MPI
       intracommPtr_(0),
       #endif
@@ -81,6 +88,18 @@ namespace DdMd
 
       // Read processor grid dimensions and initialize
       read<IntVector>(in, "gridDimensions", gridDimensions_);
+      for (int i = 0; i < Dimension; ++i) {
+         nodeDimensions_[i] = 1;
+      }
+      readOptional<IntVector>(in, "nodeDimensions", nodeDimensions_);
+      slabAxis_ = -1;
+      slabLower_ = 0.0;
+      slabUpper_ = 1.0;
+      readOptional<int>(in, "slabAxis", slabAxis_);
+      if (slabAxis_ >= 0) {
+         read<double>(in, "slabLower", slabLower_);
+         read<double>(in, "slabUpper", slabUpper_);
+      }
       initialize();
    }
    
@@ -106,6 +125,19 @@ namespace DdMd
 
       // Read processor grid dimensions and initialize
       loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
+      for (int i = 0; i < Dimension; ++i) {
+         nodeDimensions_[i] = 1;
+      }
+      loadParameter<IntVector>(ar, "nodeDimensions", nodeDimensions_,
+                               false);
+      slabAxis_ = -1;
+      slabLower_ = 0.0;
+      slabUpper_ = 1.0;
+      loadParameter<int>(ar, "slabAxis", slabAxis_, false);
+      if (slabAxis_ >= 0) {
+         loadParameter<double>(ar, "slabLower", slabLower_);
+         loadParameter<double>(ar, "slabUpper", slabUpper_);
+      }
       initialize();
    }
 
@@ -113,7 +145,16 @@ namespace DdMd
    * Save internal state to an archive.
    */
    void Domain::save(Serializable::OArchive &ar)
-   {  ar << gridDimensions_; }
+   {
+      ar << gridDimensions_;
+      bool isActive = (nodeBlock_.size() > 1);
+      Parameter::saveOptional(ar, nodeDimensions_, isActive);
+      Parameter::saveOptional(ar, slabAxis_, slabAxis_ >= 0);
+      if (slabAxis_ >= 0) {
+         ar << slabLower_;
+         ar << slabUpper_;
+      }
+   }
   
    /*
    * Initialize data - called by readParameters and loadParameters (private).
@@ -136,16 +177,63 @@ namespace DdMd
          UTIL_THROW("Grid dimensions inconsistent with communicator size");
       }
 
+      // Validate slab range, if any
+      if (slabAxis_ >= Dimension) {
+         UTIL_THROW("Invalid slabAxis");
+      }
+      if (slabAxis_ >= 0) {
+         if (slabLower_ < 0.0 || slabUpper_ > 1.0
+             || slabLower_ >= slabUpper_) {
+            UTIL_THROW("Slab bounds must obey 0 <= slabLower < slabUpper <= 1");
+         }
+      }
+
       // Set grid dimensions
       grid_.setDimensions(gridDimensions_);
 
+      // Choose node blocks, if requested by nodeDimensions = 0 0 0
+      bool isAuto = true;
+      for (int i = 0; i < Dimension; i++) {
+         if (nodeDimensions_[i] != 0) {
+            isAuto = false;
+         }
+      }
+      if (isAuto) {
+         for (int i = 0; i < Dimension; i++) {
+            nodeDimensions_[i] = 1;
+         }
+         #ifdef UTIL_MPI
+         chooseNodeBlocks();
+         #endif
+      }
+
+      // Set grids of nodes and of processors within a node
+      IntVector nodeGridDimensions;
+      for (int i = 0; i < Dimension; i++) {
+         if (nodeDimensions_[i] <= 0) {
+            UTIL_THROW("Node block dimensions must be greater than 0");
+         }
+         if (gridDimensions_[i] % nodeDimensions_[i] != 0) {
+            UTIL_THROW("Node block dimensions do not divide grid dimensions");
+         }
+         nodeGridDimensions[i] = gridDimensions_[i]/nodeDimensions_[i];
+      }
+      nodeGrid_.setDimensions(nodeGridDimensions);
+      nodeBlock_.setDimensions(nodeDimensions_);
+
       // Mark all directions as periodic.
       for (int i = 0; i < Dimension; i++) {
          gridIsPeriodic_[i] = true;
       }
 
       // Find grid coordinates for this processor
-      gridCoordinates_ = grid_.position(gridRank_);
+      gridCoordinates_ = position(gridRank_);
+
+      // Allocate and initialize uniform domain boundaries
+      for (int i = 0; i < Dimension; i++) {
+         gridBounds_[i].allocate(gridDimensions_[i] + 1);
+      }
+      resetGridBounds();
 
       IntVector sourceCoordinates;
       int       i, j, k, jp;
@@ -169,7 +257,7 @@ namespace DdMd
             // Check for transfer past boundary
             if (gridIsPeriodic_[i] == true) {
                shift_(i, j) = grid_.shift(sourceCoordinates[i], i);
-               sourceRanks_(i, j) = grid_.rank(sourceCoordinates);
+               sourceRanks_(i, j) = rank(sourceCoordinates);
                destRanks_(i, jp)  = sourceRanks_(i, j);
             } else {
                shift_(i, j)  = 0;
@@ -182,7 +270,318 @@ namespace DdMd
          }
       }
       isInitialized_ = true;
+
+      #ifdef UTIL_MPI
+      if (nodeBlock_.size() > 1) {
+         checkNodeBlocks();
+      }
+      #endif
+   }
+
+   /*
+   * Return processor rank for grid coordinates.
+   */
+   int Domain::rank(const IntVector& p) const
+   {
+      IntVector node;
+      IntVector local;
+      for (int i = 0; i < Dimension; ++i) {
+         node[i] = p[i]/nodeDimensions_[i];
+         local[i] = p[i] - node[i]*nodeDimensions_[i];
+      }
+      return nodeGrid_.rank(node)*nodeBlock_.size() + nodeBlock_.rank(local);
+   }
+
+   /*
+   * Return grid coordinates of the domain of a processor.
+   */
+   IntVector Domain::position(int rank) const
+   {
+      int n = nodeBlock_.size();
+      IntVector node = nodeGrid_.position(rank/n);
+      IntVector local = nodeBlock_.position(rank % n);
+      IntVector p;
+      for (int i = 0; i < Dimension; ++i) {
+         p[i] = node[i]*nodeDimensions_[i] + local[i];
+      }
+      return p;
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Check that the processors of each node block share a node.
+   */
+   void Domain::checkNodeBlocks()
+   {
+      int aligned = 1;
+      #if MPI_VERSION >= 3
+      // Split into blocks, then split each block by shared memory node
+      MPI::Intracomm blockComm;
+      blockComm = intracommPtr_->Split(gridRank_/nodeBlock_.size(),
+                                       gridRank_);
+      MPI_Comm nodeComm;
+      MPI_Comm_split_type((MPI_Comm)blockComm, MPI_COMM_TYPE_SHARED,
+                          gridRank_, MPI_INFO_NULL, &nodeComm);
+      int nodeSize;
+      MPI_Comm_size(nodeComm, &nodeSize);
+      MPI_Comm_free(&nodeComm);
+      blockComm.Free();
+      if (nodeSize != nodeBlock_.size()) {
+         aligned = 0;
+      }
+      #endif
+      int allAligned;
+      intracommPtr_->Allreduce(&aligned, &allAligned, 1, MPI::INT, MPI::MIN);
+      if (!allAligned && gridRank_ == 0) {
+         Log::file() << "Warning: Domain node blocks do not match the "
+                     << "placement of processes on nodes" << std::endl;
+      }
+   }
+   #endif
+
+   #ifdef UTIL_MPI
+   /*
+   * Choose node block dimensions from the shared memory node size.
+   *
+   * Requires that all nodes have the same number of processes, and
+   * that the ranks of each node are consecutive. The block dimensions
+   * are then the factorization of this number that divides the grid
+   * dimensions and minimizes the number of domain faces on the surface
+   * of each block. Otherwise, nodeDimensions_ is left as 1 1 1.
+   */
+   void Domain::chooseNodeBlocks()
+   {
+      #if MPI_VERSION >= 3
+      // Find node size, and check that ranks of each node are consecutive
+      MPI_Comm nodeComm;
+      MPI_Comm_split_type((MPI_Comm)(*intracommPtr_), MPI_COMM_TYPE_SHARED,
+                          gridRank_, MPI_INFO_NULL, &nodeComm);
+      int nodeSize, nodeRank;
+      MPI_Comm_size(nodeComm, &nodeSize);
+      MPI_Comm_rank(nodeComm, &nodeRank);
+      int first = gridRank_ - nodeRank;
+      int minFirst;
+      MPI_Allreduce(&first, &minFirst, 1, MPI_INT, MPI_MIN, nodeComm);
+      MPI_Comm_free(&nodeComm);
+      int local[3], global[3];
+      local[0] = nodeSize;
+      local[1] = -nodeSize;
+      local[2] = (minFirst == first && first % nodeSize == 0) ? 0 : 1;
+      intracommPtr_->Allreduce(local, global, 3, MPI::INT, MPI::MAX);
+      bool isValid = (global[0] == -global[1] && global[2] == 0);
+      if (!isValid || nodeSize == 1) {
+         if (!isValid && gridRank_ == 0) {
+            Log::file() << "Warning: Processes are not placed on nodes in "
+                        << "equal blocks of consecutive ranks; "
+                        << "using nodeDimensions = 1 1 1" << std::endl;
+         }
+         return;
+      }
+
+      // Find factorization with fewest domain faces on block surfaces
+      IntVector best;
+      IntVector trial;
+      int bestFaces = -1;
+      int faces, i, k;
+      for (trial[0] = 1; trial[0] <= nodeSize; ++trial[0]) {
+         if (nodeSize % trial[0] != 0) continue;
+         if (gridDimensions_[0] % trial[0] != 0) continue;
+         for (trial[1] = 1; trial[1] <= nodeSize/trial[0]; ++trial[1]) {
+            if ((nodeSize/trial[0]) % trial[1] != 0) continue;
+            if (gridDimensions_[1] % trial[1] != 0) continue;
+            trial[2] = nodeSize/(trial[0]*trial[1]);
+            if (gridDimensions_[2] % trial[2] != 0) continue;
+            faces = 0;
+            for (i = 0; i < Dimension; ++i) {
+               if (trial[i] == gridDimensions_[i]) continue;
+               k = nodeSize/trial[i];
+               faces += k;
+            }
+            if (bestFaces < 0 || faces < bestFaces) {
+               bestFaces = faces;
+               best = trial;
+            }
+         }
+      }
+      if (bestFaces < 0) {
+         if (gridRank_ == 0) {
+            Log::file() << "Warning: No node block divides the processor "
+                        << "grid; using nodeDimensions = 1 1 1" << std::endl;
+         }
+         return;
+      }
+      nodeDimensions_ = best;
+      if (gridRank_ == 0) {
+         Log::file() << "nodeDimensions = " << best << std::endl;
+      }
+      #endif
+   }
+   #endif
+
+   /*
+   * Reset all domain boundaries to uniform spacing.
+   *
+   * Along slabAxis_, if any, internal boundaries are uniformly spaced
+   * within the occupied slab, and the first and last domains also
+   * contain the empty regions below and above it.
+   */
+   void Domain::resetGridBounds()
+   {
+      double lower, width;
+      int i, k, n;
+      for (i = 0; i < Dimension; ++i) {
+         n = gridDimensions_[i];
+         if (i == slabAxis_) {
+            lower = slabLower_;
+            width = slabUpper_ - slabLower_;
+         } else {
+            lower = 0.0;
+            width = 1.0;
+         }
+         gridBounds_[i][0] = 0.0;
+         for (k = 1; k < n; ++k) {
+            gridBounds_[i][k] = lower + width*double(k)/double(n);
+         }
+         gridBounds_[i][n] = 1.0;
+      }
+   }
+
+   /*
+   * Set all domain boundaries along one axis.
+   */
+   void Domain::setGridBounds(int i, const DArray<double>& bounds)
+   {
+      UTIL_CHECK(isInitialized_);
+      UTIL_CHECK(i >= 0 && i < Dimension);
+      int n = gridDimensions_[i];
+      if (bounds.capacity() != n + 1) {
+         UTIL_THROW("Incorrect number of grid bounds");
+      }
+      if (bounds[0] != 0.0 || bounds[n] != 1.0) {
+         UTIL_THROW("First and last grid bounds must be 0 and 1");
+      }
+      for (int k = 0; k < n; ++k) {
+         if (bounds[k+1] <= bounds[k]) {
+            UTIL_THROW("Grid bounds are not strictly increasing");
+         }
+      }
+      for (int k = 0; k <= n; ++k) {
+         gridBounds_[i][k] = bounds[k];
+      }
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Move domain boundaries to balance load among slabs of processors.
+   */
+   bool Domain::balance(double load, const Vector& minWidths, double damping)
+   {
+      UTIL_CHECK(isInitialized_);
+      UTIL_CHECK(damping > 0.0 && damping <= 1.0);
+      UTIL_CHECK(load >= 0.0);
+
+      DArray<double> localLoads;
+      DArray<double> slabLoads;
+      DArray<double> bounds;
+      double total, target, cumulative, position, maxShift, dx;
+      int i, k, c, n;
+      bool isValid;
+      bool isChanged = false;
+
+      for (i = 0; i < Dimension; ++i) {
+         n = gridDimensions_[i];
+         if (n == 1) continue;
+         if (double(n)*minWidths[i] >= 1.0) {
+            UTIL_THROW("Minimum domain width too large for grid");
+         }
+
+         // Sum loads over slabs with equal grid coordinate i
+         localLoads.allocate(n);
+         slabLoads.allocate(n);
+         for (c = 0; c < n; ++c) {
+            localLoads[c] = 0.0;
+         }
+         localLoads[gridCoordinates_[i]] = load;
+         intracommPtr_->Allreduce(&localLoads[0], &slabLoads[0], n, 
+                                  MPI::DOUBLE, MPI::SUM);
+         total = 0.0;
+         for (c = 0; c < n; ++c) {
+            total += slabLoads[c];
+         }
+
+         if (total > 0.0) {
+
+            // Find bounds that divide cumulative load equally, assuming
+            // uniform load within each slab, and apply damped moves.
+            bounds.allocate(n + 1);
+            bounds[0] = 0.0;
+            bounds[n] = 1.0;
+            c = 0;
+            cumulative = 0.0;
+            for (k = 1; k < n; ++k) {
+               target = total*double(k)/double(n);
+               while (c < n - 1 && cumulative + slabLoads[c] <= target) {
+                  cumulative += slabLoads[c];
+                  ++c;
+               }
+               position = gridBounds_[i][c];
+               if (slabLoads[c] > 0.0) {
+                  position += (target - cumulative)/slabLoads[c]
+                              *(gridBounds_[i][c+1] - gridBounds_[i][c]);
+               }
+               dx = damping*(position - gridBounds_[i][k]);
+
+               // Limit shift to half the width of an adjacent domain
+               maxShift = gridBounds_[i][k] - gridBounds_[i][k-1];
+               if (gridBounds_[i][k+1] - gridBounds_[i][k] < maxShift) {
+                  maxShift = gridBounds_[i][k+1] - gridBounds_[i][k];
+               }
+               maxShift *= 0.5;
+               if (dx > maxShift) dx = maxShift;
+               if (dx < -maxShift) dx = -maxShift;
+               bounds[k] = gridBounds_[i][k] + dx;
+            }
+
+            // Enforce minimum widths, sweeping up and then down
+            for (k = 1; k < n; ++k) {
+               if (bounds[k] < bounds[k-1] + minWidths[i]) {
+                  bounds[k] = bounds[k-1] + minWidths[i];
+               }
+            }
+            for (k = n - 1; k > 0; --k) {
+               if (bounds[k] > bounds[k+1] - minWidths[i]) {
+                  bounds[k] = bounds[k+1] - minWidths[i];
+               }
+            }
+
+            // Accept only if no atom can move further than one domain.
+            isValid = true;
+            for (k = 1; k < n; ++k) {
+               dx = fabs(bounds[k] - gridBounds_[i][k]);
+               if (dx >= gridBounds_[i][k] - gridBounds_[i][k-1] ||
+                   dx >= gridBounds_[i][k+1] - gridBounds_[i][k]) {
+                  isValid = false;
+               }
+               if (bounds[k] < bounds[k-1] + minWidths[i]) {
+                  isValid = false;
+               }
+            }
+            if (isValid) {
+               for (k = 1; k < n; ++k) {
+                  if (bounds[k] != gridBounds_[i][k]) {
+                     gridBounds_[i][k] = bounds[k];
+                     isChanged = true;
+                  }
+               }
+            }
+            bounds.deallocate();
+         }
+         localLoads.deallocate();
+         slabLoads.deallocate();
+      }
+      return isChanged;
    }
+   #endif
 
    /*
    * Return one of the boundaries of the domain owned by this processor.
@@ -197,9 +596,7 @@ namespace DdMd
       assert(j >= 0);
       assert(j < 2);
 
-      double dL;
-      dL = 1.0 / double(gridDimensions_[i]);
-      return (gridCoordinates_[i] + j)*dL;
+      return gridBounds_[i][gridCoordinates_[i] + j];
    }
 
    /*
@@ -213,19 +610,28 @@ namespace DdMd
 
       double dL;
       IntVector r;
+      int n;
       for (int i = 0; i < Dimension; ++i) {
-         dL = 1.0 / double(gridDimensions_[i]);
+         n = gridDimensions_[i];
+         dL = 1.0 / double(n);
          r[i] = int(position[i] / dL);
-         if (r[i] < 0 || r[i] >= gridDimensions_[i]) {
+         if (r[i] < 0 || r[i] >= n) {
             Log::file() << "Cart i   = " << i << std::endl;
             Log::file() << "position = " << position[i] << std::endl;
             Log::file() << "dL       = " << dL << std::endl;
             Log::file() << "r        = " << r[i] << std::endl;
-            Log::file() << "gridDim  = " << gridDimensions_[i] << std::endl;
+            Log::file() << "gridDim  = " << n << std::endl;
             UTIL_THROW("Invalid grid coordinate");
          }
+         // Correct initial guess for non-uniform boundaries
+         while (r[i] > 0 && position[i] < gridBounds_[i][r[i]]) {
+            --r[i];
+         }
+         while (r[i] < n - 1 && position[i] >= gridBounds_[i][r[i] + 1]) {
+            ++r[i];
+         }
       }
-      return grid_.rank(r);
+      return rank(r);
    }
 
    /*
@@ -237,14 +643,12 @@ namespace DdMd
       assert(isInitialized_);
       assert(boundaryPtr_);
 
-      double dL;
       bool isIn = true;
       for (int i = 0; i < Dimension; ++i) {  
-         dL = 1.0 / double(gridDimensions_[i]);
-         if (position[i] <   gridCoordinates_[i]*dL) {
+         if (position[i] <   gridBounds_[i][gridCoordinates_[i]]) {
             isIn = false;
          }
-         if (position[i] >= (gridCoordinates_[i] + 1)*dL) {
+         if (position[i] >= gridBounds_[i][gridCoordinates_[i] + 1]) {
             isIn = false;
          }
       }
@@ -12,6 +12,7 @@
 #include <util/boundary/Boundary.h>     // typedef used in interface
 #include <util/containers/FMatrix.h>    // member template
 #include <util/containers/FArray.h>     // member template
+#include <util/containers/DArray.h>     // member template
 #include <util/space/IntVector.h>        // member
 #include <util/space/Grid.h>             // member
 #include <util/space/Dimension.h>        // constant expression
@@ -24,6 +25,26 @@ namespace DdMd
 
    /**
    * Decomposition of the system into domains associated with processors.
+   *
+   * By default, processor ranks are assigned to grid coordinates in the
+   * lexicographic order of the processor Grid. If the optional parameter
+   * nodeDimensions is given, the grid is instead divided into blocks of
+   * nodeDimensions processors, each of which is assigned a contiguous
+   * range of ranks. When an MPI launcher places consecutive ranks on the
+   * same node, each node then owns a compact block of domains, and most
+   * faces between domains (and most ghost communication) lie within a
+   * node, where messages use shared memory. If nodeDimensions is 0 0 0,
+   * the block dimensions are instead chosen from the number of processes
+   * on each shared memory node (see chooseNodeBlocks()).
+   *
+   * For a system in which all atoms lie within a slab slabLower < x[i] <
+   * slabUpper of scaled coordinates along one axis i = slabAxis, such
+   * as a film with free surfaces or a fluid confined in a slit, the
+   * optional parameters slabAxis, slabLower and slabUpper cause the
+   * default domain boundaries along that axis to be spaced uniformly
+   * within the slab rather than the whole unit cell. The first and last
+   * domains along the slab axis then also contain the empty regions, so
+   * that no processor is assigned only vacuum.
    * 
    * \ingroup DdMd_Communicate_Module
    */
@@ -91,9 +112,33 @@ namespace DdMd
 
       /**
       * Return processor Grid by const reference.
+      *
+      * If nodeDimensions is not (1,1,1), Grid::rank() of this object is
+      * not the processor rank; use rank(), position() or ownerRank().
       */
       const Grid& grid() const;
 
+      /**
+      * Get processor rank associated with grid coordinates.
+      *
+      * \param position grid coordinates, inside the grid
+      */
+      int rank(const IntVector& position) const;
+
+      /**
+      * Get grid coordinates of the domain of a processor.
+      *
+      * \param rank processor rank
+      */
+      IntVector position(int rank) const;
+
+      /**
+      * Get dimension of the block of processors per node.
+      *
+      * \param i index of Cartesian direction 0 <= i < Dimension
+      */
+      int nodeDimension(int i) const;
+
       /**
       * Get coordinate of processor within grid in specified direction.
       *
@@ -174,6 +219,63 @@ namespace DdMd
       */
       double domainBound(int i, int j) const;
 
+      /**
+      * Get a boundary between domains along one axis of the grid.
+      *
+      * Domains with grid coordinate c in direction i span the range
+      * gridBound(i, c) <= x[i] < gridBound(i, c+1), with gridBound(i, 0)
+      * = 0 and gridBound(i, gridDimension(i)) = 1. Bounds are uniformly
+      * spaced unless modified by setGridBounds() or balance().
+      *
+      * \param i index of Cartesian direction 0 <= i < Dimension
+      * \param k boundary index, 0 <= k <= gridDimension(i)
+      */
+      double gridBound(int i, int k) const;
+
+      /**
+      * Set all domain boundaries along one axis of the grid.
+      *
+      * Must be called with identical values on all processors. The 
+      * array must have gridDimension(i) + 1 strictly increasing elements,
+      * with first element 0 and last element 1. Atoms must be exchanged
+      * after any change in boundaries.
+      *
+      * \param i      index of Cartesian direction 0 <= i < Dimension
+      * \param bounds array of boundaries along direction i
+      */
+      void setGridBounds(int i, const DArray<double>& bounds);
+
+      /**
+      * Reset all domain boundaries to uniform spacing.
+      *
+      * If a slab axis was given, boundaries along that axis are instead
+      * spaced uniformly within the occupied slab.
+      */
+      void resetGridBounds();
+
+      #ifdef UTIL_MPI
+      /**
+      * Move domain boundaries to balance a measured load.
+      *
+      * Each processor passes its own load (e.g., time spent in force
+      * computation, or number of atoms). For each direction i with more
+      * than one processor, loads are summed over slabs of processors with
+      * equal grid coordinate i, and internal boundaries are moved toward 
+      * the positions that would equalize slab loads if load were uniform
+      * within each slab. The move is damped by a factor damping, and 
+      * limited so that no boundary moves further than half of the width 
+      * of an adjacent domain, and so that no domain becomes narrower 
+      * than minWidths[i] (in scaled coordinates). Must be called on all 
+      * processors. Atoms must be exchanged if the return value is true.
+      *
+      * \param load      load associated with this processor (>= 0)
+      * \param minWidths minimum domain widths, in scaled coordinates
+      * \param damping   fraction of full move applied, 0 < damping <= 1
+      * \return true if any boundary was changed, false otherwise
+      */
+      bool balance(double load, const Vector& minWidths, double damping);
+      #endif
+
       /**
       * Return rank of the processor whose domain contains a position.
       *
@@ -217,15 +319,36 @@ namespace DdMd
       // Number of processors in each direction.
       IntVector gridDimensions_;
 
+      // Number of processors per node in each direction.
+      IntVector nodeDimensions_;
+
+      // Grid of nodes (dimensions gridDimensions_/nodeDimensions_).
+      Grid nodeGrid_;
+
+      // Grid of processors within one node.
+      Grid nodeBlock_;
+
       // Coordinates of this domain in processor grid.
       IntVector gridCoordinates_;
 
       // Rank of this processor in Cartesian communicator.
       int gridRank_;
 
+      // Axis normal to the occupied slab, or -1 if none.
+      int slabAxis_;
+
+      // Lower bound of occupied slab along slabAxis_ (scaled coords).
+      double slabLower_;
+
+      // Upper bound of occupied slab along slabAxis_ (scaled coords).
+      double slabUpper_;
+
       // Is each direction periodic (1 = true, 0 = false).
       FArray<bool, Dimension> gridIsPeriodic_;
 
+      // Boundaries between domains along each grid axis (scaled coords).
+      FArray< DArray<double>, Dimension> gridBounds_;
+
       #if UTIL_MPI
 
       // Pointer to Intracommunicator.
@@ -246,6 +369,18 @@ namespace DdMd
       */
       void initialize();
 
+      #ifdef UTIL_MPI
+      /*
+      * Check that each shared memory node owns a single block.
+      */
+      void checkNodeBlocks();
+
+      /*
+      * Choose node block dimensions from the shared memory node size.
+      */
+      void chooseNodeBlocks();
+      #endif
+
    };
 
    #if UTIL_MPI
@@ -333,6 +468,15 @@ namespace DdMd
       return destRanks_(i,j); 
    }
 
+   /*
+   * Dimension of the block of processors per node.
+   */
+   inline int Domain::nodeDimension(int i) const
+   {
+      assert(isInitialized_);
+      return nodeDimensions_[i];
+   }
+
    /*
    * Shift applied in direction i for transfer (i, j)
    */
@@ -342,6 +486,15 @@ namespace DdMd
       return shift_(i, j);  
    }
 
+   /*
+   * Boundary k between domains along grid axis i.
+   */
+   inline double Domain::gridBound(int i, int k) const
+   {  
+      assert(isInitialized_);
+      return gridBounds_[i][k];  
+   }
+
    /*
    * Has this Domain been initialized by calling readParam?
    */
@@ -14,11 +14,17 @@
 #include <ddMd/storage/AtomIterator.h>
 #include <ddMd/storage/GhostIterator.h>
 #include <ddMd/storage/GroupExchanger.h>
+#include <ddMd/neighbor/CellList.h>
+#include <ddMd/neighbor/Cell.h>
+#include <ddMd/potentials/AtomStress.h>
+#include <ddMd/misc/BoundaryMetric.h>
 #include <util/format/Dbl.h>
+#include <util/format/Int.h>
 #include <util/global.h>
 
 #include <algorithm>
 #include <string>
+#include <cmath>
 
 #ifdef UTIL_DEBUG
 //#define DDMD_EXCHANGER_DEBUG
@@ -34,9 +40,15 @@ namespace DdMd
    Exchanger::Exchanger()
     : sendArray_(),
       recvArray_(),
+      lastSent_(),
+      #ifdef DDMD_ATOM_SOA
+      recvFirst_(),
+      #endif
       bound_(),
       inner_(),
       outer_(),
+      groupInner_(),
+      groupOuter_(),
       gridFlags_(),
       boundaryPtr_(0),
       domainPtr_(0),
@@ -44,8 +56,27 @@ namespace DdMd
       groupExchangers_(),
       bufferPtr_(0),
       pairCutoff_(-1.0),
+      groupMargin_(-1.0),
+      nExchangeSinceSort_(0),
+      updateStep_(0),
+      initialPass_(0),
+      halfShell_(false),
+      compactUpdate_(false),
+      scanCellListPtr_(0),
+      scanDisp_(-1.0),
+      movers_(),
+      hasShear_(false),
+      shearGradient_(1),
+      shearFlow_(0),
+      shearOffset_(0.0),
+      shearVelocity_(0.0),
+      maxMemoryLocal_(),
+      maxMemory_(),
       timer_(Exchanger::NTime)
-   {  groupExchangers_.reserve(8); }
+   {  
+      groupExchangers_.reserve(8); 
+      clearStatistics();
+   }
 
    /*
    * Destructor.
@@ -99,6 +130,109 @@ namespace DdMd
    void Exchanger::setPairCutoff(double pairCutoff)
    {  pairCutoff_ = pairCutoff; }
 
+   /*
+   * Set margin used to find groups that span boundaries.
+   */
+   void Exchanger::setGroupMargin(double margin)
+   {  groupMargin_ = margin; }
+
+   /*
+   * Enable or disable half-shell ghost communication.
+   */
+   void Exchanger::setHalfShell(bool halfShell)
+   {  halfShell_ = halfShell; }
+
+   /*
+   * Enable or disable compact ghost updates.
+   */
+   void Exchanger::setCompactUpdate(bool compactUpdate)
+   {  compactUpdate_ = compactUpdate; }
+
+   /*
+   * Restrict the plan stage of the next exchangeAtoms() to boundary cells.
+   */
+   void Exchanger::setBoundaryScan(const CellList& cellList, double maxDisp)
+   {
+      if (maxDisp < 0.0) {
+         UTIL_THROW("Negative maximum displacement");
+      }
+      scanCellListPtr_ = &cellList;
+      scanDisp_ = maxDisp;
+   }
+
+   /*
+   * Enable Lees-Edwards boundary conditions.
+   */
+   void Exchanger::setShear(int gradient, int flow)
+   {
+      if (gradient < 0 || flow >= Dimension || gradient >= flow) {
+         UTIL_THROW("Lees-Edwards requires 0 <= gradient < flow < Dimension");
+      }
+      if (!domainPtr_) {
+         UTIL_THROW("Exchanger is not associated with a Domain");
+      }
+      if (domainPtr_->grid().dimension(flow) != 1) {
+         UTIL_THROW("Lees-Edwards requires grid dimension 1 along flow");
+      }
+      if (domainPtr_->grid().dimension(gradient) < 2) {
+         UTIL_THROW("Lees-Edwards requires grid dimension > 1 along gradient");
+      }
+      if (halfShell_) {
+         UTIL_THROW("Lees-Edwards is incompatible with halfShell");
+      }
+      hasShear_ = true;
+      shearGradient_ = gradient;
+      shearFlow_ = flow;
+   }
+
+   /*
+   * Set Lees-Edwards image offset and velocity.
+   */
+   void Exchanger::setShearOffset(double offset, double velocity)
+   {
+      shearOffset_ = offset - floor(offset);
+      shearVelocity_ = velocity;
+   }
+
+   /*
+   * Apply Lees-Edwards flow shift in generalized coordinates (private).
+   */
+   void Exchanger::applyShear(Atom& atom, int shift, bool isLocal)
+   {
+      double& x = atom.position()[shearFlow_];
+      x += double(shift)*shearOffset_;
+      x -= floor(x);
+      if (isLocal && Atom::hasVelocity()) {
+         atom.velocity()[shearFlow_] += double(shift)*shearVelocity_;
+      }
+
+      // Reset flags for flow direction, using the wrapped coordinate.
+      // The wrapped atom lies inside the (single) domain along flow.
+      Plan& plan = atom.plan();
+      plan.clearExchange(shearFlow_, 0);
+      plan.clearExchange(shearFlow_, 1);
+      plan.clearGhost(shearFlow_, 0);
+      plan.clearGhost(shearFlow_, 1);
+      if (x < inner_(shearFlow_, 0)) {
+         plan.setGhost(shearFlow_, 0);
+      }
+      if (x > inner_(shearFlow_, 1)) {
+         plan.setGhost(shearFlow_, 1);
+      }
+   }
+
+   /*
+   * Apply Lees-Edwards flow shift in Cartesian coordinates (private).
+   */
+   void Exchanger::applyShearUpdate(Vector& position, int shift,
+                                    double previous)
+   {
+      double length = boundaryPtr_->length(shearFlow_);
+      double& x = position[shearFlow_];
+      x += double(shift)*shearOffset_*length;
+      x += length*floor((previous - x)/length + 0.5);
+   }
+
    #ifdef UTIL_MPI
    /**
    * Exchange local atoms and ghosts.
@@ -112,6 +246,30 @@ namespace DdMd
       exchangeGhosts();
    }
 
+   /*
+   * Exchange atoms and ghosts in two passes, when no ghosts exist.
+   */
+   void Exchanger::initialExchange()
+   {
+      if (atomStoragePtr_->isCartesian()) {
+         UTIL_THROW("Error: Coordinates are Cartesian on entry to exchange");
+      }
+      if (atomStoragePtr_->nGhost() != 0) {
+         UTIL_THROW("Ghosts exist on entry to initialExchange");
+      }
+
+      // First pass: Exchange atoms, and ghosts identified by position.
+      initialPass_ = 1;
+      exchangeAtoms();
+      exchangeGhosts();
+
+      // Second pass: Normal exchange, with most groups complete.
+      initialPass_ = 2;
+      exchangeAtoms();
+      exchangeGhosts();
+      initialPass_ = 0;
+   }
+
    /*
    * void Exchanger::exchangeAtoms()
    *
@@ -201,20 +359,37 @@ namespace DdMd
    void Exchanger::exchangeAtoms()
    {
       stamp(START);
-      Vector lengths = boundaryPtr_->lengths();
-      double bound, slabWidth;
+      double bound, slabWidth, groupWidth;
       double coordinate, rshift;
       AtomIterator atomIter;
       Atom* atomPtr;
       Plan* planPtr;
-      int i, j, jc, ip, jp, k, source, dest, nSend;
+      int i, j, jc, ip, jp, k, n, source, dest, nSend, nMover;
       int shift;
       bool isHome;
       bool isGhost;
 
+      // Before a boundary scan, clear ghost flags set by the previous
+      // exchange, since atoms of interior cells are not rescanned. All
+      // flagged atoms are in send arrays (see end of this function).
+      if (scanCellListPtr_) {
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < 2; ++j) {
+               nSend = sendArray_(i, j).size();
+               for (k = 0; k < nSend; ++k) {
+                  sendArray_(i, j)[k].plan().clearFlags();
+               }
+            }
+         }
+      }
+
       // Set domain and slab boundaries
       for (i = 0; i < Dimension; ++i) {
-         slabWidth = pairCutoff_/lengths[i];
+         slabWidth = scaledWidth(*boundaryPtr_, pairCutoff_, i);
+         groupWidth = slabWidth;
+         if (groupMargin_ > 0.0 && groupMargin_ < pairCutoff_) {
+            groupWidth = scaledWidth(*boundaryPtr_, groupMargin_, i);
+         }
          for (j = 0; j < 2; ++j) {
             // j = 0 sends to lower coordinate i, bound is minimum
             // j = 1 sends to higher coordinate i, bound is maximum
@@ -223,9 +398,13 @@ namespace DdMd
             if (j == 0) { // Communicate with lower index
                inner_(i,j) = bound + slabWidth;
                outer_(i, j)= bound - slabWidth;
+               groupInner_(i, j) = bound + groupWidth;
+               groupOuter_(i, j) = bound - groupWidth;
             } else { // j == 1, communicate with upper index
                inner_(i, j) = bound - slabWidth;
                outer_(i, j) = bound + slabWidth;
+               groupInner_(i, j) = bound - groupWidth;
+               groupOuter_(i, j) = bound + groupWidth;
             }
             sendArray_(i, j).clear();
          }
@@ -236,80 +415,22 @@ namespace DdMd
          }
       }
 
-      // Compute communication plan for every local atom
-      atomStoragePtr_->begin(atomIter);
-      for ( ; atomIter.notEnd(); ++atomIter) {
-
-         planPtr = &atomIter->plan();
-         planPtr->clearFlags();
-         isHome  = true;
-         isGhost = false;
-
-         // Cartesian directions
+      // Compute communication plans of local atoms: if possible, only
+      // of atoms in boundary cells, and otherwise of every atom.
+      movers_.clear();
+      if (!scanBoundaryCells()) {
          for (i = 0; i < Dimension; ++i) {
-
-            coordinate = atomIter->position()[i];
-
-            // Transmission direction
             for (j = 0; j < 2; ++j) {
-
-               // j = 0 sends to lower coordinate i
-               // j = 1 sends to higher coordinate i
-
-               // Index for conjugate (reverse) direction
-               if (j == 0) jc = 1;
-               if (j == 1) jc = 0;
-
-               if (j == 0) { // Communicate with lower index
-                  if (coordinate < bound_(i, j)) {
-                     planPtr->setExchange(i, j);
-                     if (gridFlags_[i]) {
-                        isHome = false;
-                     }
-                     if (coordinate > outer_(i, j)) {
-                        planPtr->setGhost(i, jc);
-                        isGhost = true;
-                     }
-                  } else {
-                     if (coordinate < inner_(i, j)) {
-                        planPtr->setGhost(i, j);
-                        isGhost = true;
-                     }
-                  }
-               } else { // j == 1, communicate with upper index
-                  if (coordinate > bound_(i, j)) {
-                     planPtr->setExchange(i, j);
-                     if (gridFlags_[i]) {
-                        isHome = false;
-                     }
-                     if (coordinate < outer_(i, j)) {
-                        planPtr->setGhost(i, jc);
-                        isGhost = true;
-                     }
-                  } else {
-                     if (coordinate > inner_(i, j)) {
-                        planPtr->setGhost(i, j);
-                        isGhost = true;
-                     }
-                  }
-               }
-
-            } // end for j
-         } // end for i
-
-         // Add atoms that will be retained by this processor,
-         // but will be communicated as ghosts to sendArray_
-         if (isGhost && isHome) {
-            for (i = 0; i < Dimension; ++i) {
-               for (j = 0; j < 2; ++j) {
-                  if (planPtr->ghost(i, j)) {
-                     sendArray_(i, j).append(*atomIter);
-                  }
-               }
+               sendArray_(i, j).clear();
             }
          }
-
-      } // end atom loop, end compute plan
+         movers_.clear();
+         atomStoragePtr_->begin(atomIter);
+         for ( ; atomIter.notEnd(); ++atomIter) {
+            planAtom(*atomIter);
+         }
+      }
+      scanCellListPtr_ = 0;
       stamp(ATOM_PLAN);
 
       /*
@@ -320,7 +441,8 @@ namespace DdMd
       * 
       * If a group has atoms both "inside" and "outside" boundary (i, j),
       * the group is said to "span" the boundary, and ghost communication 
-      * flag (i, j) is set for the Group. Otherwise, this ghost communication 
+      * flag (i, j) is set for the Group. Ghost members within the group
+      * margin of a boundary count as both inside and outside. Otherwise, this ghost communication
       * flag for the Group cleared. After finishing inspection of a Group, 
       * all pointers to ghost atoms within the Group are cleared.
       *
@@ -330,8 +452,8 @@ namespace DdMd
 
       // Set ghost communication flags for groups (see above)
       for (k = 0; k < groupExchangers_.size(); ++k) {
-         groupExchangers_[k].markSpanningGroups(bound_, inner_, outer_,
-                                                gridFlags_);
+         groupExchangers_[k].markSpanningGroups(bound_, groupInner_,
+                                                groupOuter_, gridFlags_);
       }
       stamp(INIT_GROUP_PLAN);
 
@@ -380,12 +502,14 @@ namespace DdMd
             #endif
 
             // Choose atoms for sending, pack and mark for removal.
+            // Only atoms listed in movers_ can be marked for exchange.
             sentAtoms_.clear();
-            atomStoragePtr_->begin(atomIter);
-            for ( ; atomIter.notEnd(); ++atomIter) {
+            nMover = movers_.size();
+            for (k = 0; k < nMover; ++k) {
+               atomPtr = movers_[k];
 
                #ifdef UTIL_DEBUG
-               coordinate = atomIter->position()[i];
+               coordinate = atomPtr->position()[i];
                #ifdef DDMD_EXCHANGER_DEBUG
                {
                   bool choose;
@@ -394,17 +518,17 @@ namespace DdMd
                   } else {
                      choose = (coordinate > bound);
                   }
-                  assert(choose == atomIter->plan().exchange(i, j));
+                  assert(choose == atomPtr->plan().exchange(i, j));
                }
                #endif
                #endif
 
-               if (atomIter->plan().exchange(i, j)) {
+               if (atomPtr->plan().exchange(i, j)) {
 
                   #ifdef UTIL_MPI
                   if (gridFlags_[i]) {
-                     sentAtoms_.append(*atomIter);
-                     atomIter->packAtom(*bufferPtr_);
+                     sentAtoms_.append(*atomPtr);
+                     atomPtr->packAtom(*bufferPtr_);
                   } else
                   #endif
                   {
@@ -419,26 +543,26 @@ namespace DdMd
 
                      // Shift position if required by periodic b.c.
                      if (shift) {
-                        atomIter->position()[i] += rshift;
+                        atomPtr->position()[i] += rshift;
                      }
 
                      #ifdef UTIL_DEBUG
-                     coordinate = atomIter->position()[i];
+                     coordinate = atomPtr->position()[i];
                      assert(coordinate >= domainPtr_->domainBound(i, 0));
                      assert(coordinate < domainPtr_->domainBound(i, 1));
                      #endif
 
                      // For gridDimension==1, only nonbonded ghosts exist.
                      // The following assertion applies to these.
-                     assert(!atomIter->plan().ghost(i, j));
+                     assert(!atomPtr->plan().ghost(i, j));
 
                      #if UTIL_DEBUG
                      // Check ghost communication plan
-                     if (j == 0 && atomIter->position()[i] > inner_(i, jc)) {
-                        assert(atomIter->plan().ghost(i, 1));
+                     if (j == 0 && atomPtr->position()[i] > inner_(i, jc)) {
+                        assert(atomPtr->plan().ghost(i, 1));
                      } else
-                     if (j == 1 && atomIter->position()[i] < inner_(i, jc)) {
-                        assert(atomIter->plan().ghost(i, 0));
+                     if (j == 1 && atomPtr->position()[i] < inner_(i, jc)) {
+                        assert(atomPtr->plan().ghost(i, 0));
                      }
                      #endif
 
@@ -446,6 +570,20 @@ namespace DdMd
                }
 
             } // end atom loop
+
+            #ifdef UTIL_MPI
+            // Remove atoms that will be sent from movers_
+            if (gridFlags_[i]) {
+               n = 0;
+               for (k = 0; k < nMover; ++k) {
+                  if (!movers_[k]->plan().exchange(i, j)) {
+                     movers_[n] = movers_[k];
+                     ++n;
+                  }
+               }
+               movers_.resize(n);
+            }
+            #endif
             stamp(PACK_ATOMS);
 
             /*
@@ -482,6 +620,7 @@ namespace DdMd
                stamp(REMOVE_ATOMS);
 
                // Send to processor dest and receive from processor source
+               recordMemory(ATOM_BYTES, bufferPtr_->sendBytes());
                bufferPtr_->sendRecv(domainPtr_->communicator(),
                                     source, dest);
                stamp(SEND_RECV_ATOMS);
@@ -497,6 +636,9 @@ namespace DdMd
 
                   if (shift) {
                      atomPtr->position()[i] += rshift;
+                     if (hasShear_ && i == shearGradient_) {
+                        applyShear(*atomPtr, shift, true);
+                     }
                   }
 
                   #ifdef UTIL_DEBUG
@@ -530,11 +672,16 @@ namespace DdMd
                     }
                   }
 
+                  // Record atoms marked for exchange (in any direction)
+                  if (planPtr->hasExchange()) {
+                     movers_.push_back(atomPtr);
+                  }
+
                   // If atom will stay, add to sendArrays for ghosts
                   if (isHome) {
                      for (ip = 0; ip < Dimension; ++ip) {
                         for (jp = 0; jp < 2; ++jp) {
-                           if (planPtr->ghost(ip, jp)) {
+                           if (planPtr->hasGhost(ip, jp)) {
                               sendArray_(ip, jp).append(*atomPtr);
                            }
                         }
@@ -558,6 +705,18 @@ namespace DdMd
          } // end for j (direction 0, 1)
       } // end for i (Cartesian index)
 
+      // Clear exchange flags of all local atoms. Afterwards, the only
+      // local atoms with nonempty plans are those in send arrays.
+      nMover = movers_.size();
+      for (k = 0; k < nMover; ++k) {
+         planPtr = &movers_[k]->plan();
+         for (i = 0; i < Dimension; ++i) {
+            planPtr->clearExchange(i, 0);
+            planPtr->clearExchange(i, 1);
+         }
+      }
+      movers_.clear();
+
       /*
       * At this point:
       *    No ghost atoms exist in AtomStorage.
@@ -582,14 +741,284 @@ namespace DdMd
       #endif // ifdef DDMD_EXCHANGER_DEBUG
       #endif // ifdef UTIL_DEBUG
 
-      // Set ghost communication flags for atoms in incomplete groups
-      for (k = 0; k < groupExchangers_.size(); ++k) {
-         groupExchangers_[k].markGhosts(*atomStoragePtr_, sendArray_,
-                                        gridFlags_);
+      // Increase storage and buffer capacities, if usage is too high
+      if (atomStoragePtr_->growThreshold() > 0.0) {
+         growStorage();
+      }
+
+      // Periodically reorder local atoms to improve memory locality
+      if (atomStoragePtr_->sortInterval() > 0) {
+         ++nExchangeSinceSort_;
+         if (nExchangeSinceSort_ >= atomStoragePtr_->sortInterval()) {
+            sortAtoms();
+            nExchangeSinceSort_ = 0;
+         }
+      }
+      stamp(SORT_ATOMS);
+
+      // Set ghost communication flags for atoms in incomplete groups.
+      // Skipped in the first pass of initialExchange, in which all groups
+      // that span boundaries are incomplete.
+      if (initialPass_ != 1) {
+         for (k = 0; k < groupExchangers_.size(); ++k) {
+            groupExchangers_[k].markGhosts(*atomStoragePtr_, sendArray_,
+                                           gridFlags_);
+         }
       }
       stamp(MARK_GROUP_GHOSTS);
    }
 
+   /*
+   * Compute the communication plan of one local atom (private).
+   */
+   void Exchanger::planAtom(Atom& atom)
+   {
+      double coordinate;
+      Plan* planPtr;
+      int i, j, jc;
+      bool isHome;
+      bool isGhost;
+
+      planPtr = &atom.plan();
+      planPtr->clearFlags();
+      isHome  = true;
+      isGhost = false;
+
+      // Cartesian directions
+      for (i = 0; i < Dimension; ++i) {
+
+         coordinate = atom.position()[i];
+
+         // Transmission direction
+         for (j = 0; j < 2; ++j) {
+
+            // j = 0 sends to lower coordinate i
+            // j = 1 sends to higher coordinate i
+
+            // Index for conjugate (reverse) direction
+            if (j == 0) jc = 1;
+            if (j == 1) jc = 0;
+
+            if (j == 0) { // Communicate with lower index
+               if (coordinate < bound_(i, j)) {
+                  planPtr->setExchange(i, j);
+                  if (gridFlags_[i]) {
+                     isHome = false;
+                  }
+                  if (coordinate > outer_(i, j) && !halfShell_) {
+                     planPtr->setGhost(i, jc);
+                     isGhost = true;
+                  }
+               } else {
+                  if (coordinate < inner_(i, j)) {
+                     planPtr->setGhost(i, j);
+                     isGhost = true;
+                  }
+               }
+            } else { // j == 1, communicate with upper index
+               if (coordinate > bound_(i, j)) {
+                  planPtr->setExchange(i, j);
+                  if (gridFlags_[i]) {
+                     isHome = false;
+                  }
+                  if (coordinate < outer_(i, j)) {
+                     planPtr->setGhost(i, jc);
+                     isGhost = true;
+                  }
+               } else {
+                  if (coordinate > inner_(i, j) && !halfShell_) {
+                     planPtr->setGhost(i, j);
+                     isGhost = true;
+                  }
+               }
+            }
+
+         } // end for j
+      } // end for i
+
+      // Add atoms that will be retained by this processor,
+      // but will be communicated as ghosts to sendArray_
+      if (isGhost && isHome) {
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < 2; ++j) {
+               if (planPtr->ghost(i, j)) {
+                  sendArray_(i, j).append(atom);
+               }
+            }
+         }
+      }
+
+      // Record atoms marked for exchange
+      if (planPtr->hasExchange()) {
+         movers_.push_back(&atom);
+      }
+   }
+
+   /*
+   * Compute plans of local atoms in boundary cells only (private).
+   *
+   * An atom in an interior cell of the cell list was at least the slab
+   * width plus maxDisp from every domain face when the list was built,
+   * and so now has an empty plan. Such atoms are only counted. Returns
+   * false if no cell list was set, or if the number of local atoms in
+   * the cell list is incorrect, in which case plans may be incomplete.
+   */
+   bool Exchanger::scanBoundaryCells()
+   {
+      if (!scanCellListPtr_ || scanDisp_ < 0.0) return false;
+      const CellList& cellList = *scanCellListPtr_;
+      if (!cellList.isBuilt()) return false;
+
+      // Lower and upper bounds of the region of interior cells
+      Vector lower, upper, cellLower, cellUpper;
+      double margin;
+      int i;
+      for (i = 0; i < Dimension; ++i) {
+         margin = scaledWidth(*boundaryPtr_, scanDisp_, i);
+         lower[i] = inner_(i, 0) + margin;
+         upper[i] = inner_(i, 1) - margin;
+      }
+
+      Atom* atomPtr;
+      int nCell = cellList.grid().size();
+      int nLocal = 0;
+      int c, k, n;
+      bool isInterior;
+      for (c = 0; c < nCell; ++c) {
+         const Cell& cell = cellList.cell(c);
+         n = cell.nAtom();
+         if (n == 0) continue;
+         cellList.cellBounds(c, cellLower, cellUpper);
+         isInterior = true;
+         for (i = 0; i < Dimension; ++i) {
+            if (cellLower[i] <= lower[i] || cellUpper[i] >= upper[i]) {
+               isInterior = false;
+            }
+         }
+         if (isInterior) {
+            nLocal += n;
+         } else {
+            for (k = 0; k < n; ++k) {
+               atomPtr = cell.atomPtr(k)->ptr();
+               if (!atomPtr->isGhost()) {
+                  planAtom(*atomPtr);
+                  ++nLocal;
+               }
+            }
+         }
+      }
+      return (nLocal == atomStoragePtr_->nAtom());
+   }
+
+   /*
+   * Reorder local atoms, and reset groups and send arrays (private).
+   *
+   * At this point there are no ghosts, each sendArray_(i, j) contains
+   * exactly the local atoms for which plan().hasGhost(i, j) is set, and
+   * groups contain only pointers to local atoms.
+   */
+   void Exchanger::sortAtoms()
+   {
+      atomStoragePtr_->sortAtoms();
+      resetLocalAtoms();
+   }
+
+   /*
+   * Grow atom storage and buffer capacities if needed (private).
+   *
+   * Local atom capacities may differ among processors, but the Buffer
+   * capacity must be the same on all processors, and is set from the
+   * maximum storage capacities. The Buffer is also grown if the largest
+   * message sent by any processor exceeds the growth threshold.
+   */
+   void Exchanger::growStorage()
+   {
+      if (atomStoragePtr_->grow()) {
+         resetLocalAtoms();
+      }
+
+      double threshold = atomStoragePtr_->growThreshold();
+      double factor = atomStoragePtr_->growFactor();
+      int local[3], global[3];
+      local[0] = atomStoragePtr_->atomCapacity();
+      local[1] = atomStoragePtr_->ghostCapacity();
+      local[2] = 0;
+      if (bufferPtr_->maxMemoryBytes() >
+          threshold*bufferPtr_->memoryBytes()) {
+         local[2] = 1;
+      }
+      domainPtr_->communicator().Allreduce(local, global, 3,
+                                           MPI::INT, MPI::MAX);
+      int atomCapacity = bufferPtr_->atomCapacity();
+      int ghostCapacity = bufferPtr_->ghostCapacity();
+      if (global[2]) {
+         atomCapacity = int(factor*atomCapacity) + 1;
+         ghostCapacity = int(factor*ghostCapacity) + 1;
+      }
+      if (global[0] > atomCapacity) atomCapacity = global[0];
+      if (global[1] > ghostCapacity) ghostCapacity = global[1];
+      if (atomCapacity > bufferPtr_->atomCapacity() ||
+          ghostCapacity > bufferPtr_->ghostCapacity()) {
+         bufferPtr_->reallocate(atomCapacity, ghostCapacity);
+      }
+   }
+
+   /*
+   * Reset groups and send arrays after local atoms move (private).
+   *
+   * At this point there are no ghosts, and each sendArray_(i, j)
+   * contained exactly the local atoms for which plan().hasGhost(i, j) is
+   * set before they were moved.
+   */
+   void Exchanger::resetLocalAtoms()
+   {
+      int i, j, k;
+
+      #ifdef UTIL_DEBUG
+      FMatrix<int, Dimension, 2> sendSizes;
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < 2; ++j) {
+            sendSizes(i, j) = sendArray_(i, j).size();
+         }
+      }
+      #endif
+
+      // Reset pointers to local atoms in all groups
+      for (k = 0; k < groupExchangers_.size(); ++k) {
+         groupExchangers_[k].findLocalAtoms(*atomStoragePtr_);
+      }
+
+      // Rebuild send arrays from ghost communication plans
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < 2; ++j) {
+            sendArray_(i, j).clear();
+         }
+      }
+      AtomIterator atomIter;
+      Plan* planPtr;
+      atomStoragePtr_->begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         planPtr = &atomIter->plan();
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < 2; ++j) {
+               if (planPtr->hasGhost(i, j)) {
+                  sendArray_(i, j).append(*atomIter);
+               }
+            }
+         }
+      }
+
+      #ifdef UTIL_DEBUG
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < 2; ++j) {
+            if (sendSizes(i, j) != sendArray_(i, j).size()) {
+               UTIL_THROW("Inconsistent send array after moving atoms");
+            }
+         }
+      }
+      #endif
+   }
+
    /*
    * Exchange ghost atoms.
    *
@@ -609,6 +1038,16 @@ namespace DdMd
          UTIL_THROW("atomStoragePtr_->nGhost() != 0");
       }
 
+      // Ghost plans change, so free persistent update requests
+      bufferPtr_->clearChannels();
+
+      // Positions last sent by compact updates are no longer valid
+      for (int i = 0; i < Dimension; ++i) {
+         for (int j = 0; j < 2; ++j) {
+            lastSent_(i, j).clear();
+         }
+      }
+
       double  rshift;
       Atom* atomPtr;
       Atom* sendPtr;
@@ -618,6 +1057,9 @@ namespace DdMd
       for (i = 0; i < Dimension; ++i) {
          for (j = 0; j < 2; ++j) {
             recvArray_(i, j).clear();
+            #ifdef DDMD_ATOM_SOA
+            recvFirst_(i, j) = -1;
+            #endif
          }
       }
 
@@ -640,7 +1082,7 @@ namespace DdMd
             planPtr = &localIter->plan();
             for (i = 0; i < Dimension; ++i) {
                for (j = 0; j < 2; ++j) {
-                  if (planPtr->ghost(i, j)) {
+                  if (planPtr->hasGhost(i, j)) {
                       ++sendCounter(i, j);
                   }
                }
@@ -699,6 +1141,10 @@ namespace DdMd
                   atomPtr->setId(sendPtr->id());
                   atomPtr->setTypeId(sendPtr->typeId());
                   atomPtr->plan().setFlags(sendPtr->plan().flags());
+                  atomPtr->plan().setImage(i, j);
+                  if (Atom::hasGhostMask()) {
+                     atomPtr->mask() = sendPtr->mask();
+                  }
                   atomPtr->position() = sendPtr->position();
                   if (shift) {
                      atomPtr->position()[i] += rshift;
@@ -719,7 +1165,7 @@ namespace DdMd
                   if (i < Dimension - 1) {
                      for (ip = i + 1; ip < Dimension; ++ip) {
                         for (jp = 0; jp < 2; ++jp) {
-                           if (atomPtr->plan().ghost(ip, jp)) {
+                           if (atomPtr->plan().hasGhost(ip, jp)) {
                               sendArray_(ip, jp).append(*atomPtr);
                            }
                         }
@@ -739,6 +1185,7 @@ namespace DdMd
 
                source = domainPtr_->sourceRank(i, j);
                dest   = domainPtr_->destRank(i, j);
+               recordMemory(GHOST_BYTES, bufferPtr_->sendBytes());
                bufferPtr_->sendRecv(domainPtr_->communicator(), source, dest);
                stamp(SEND_RECV_GHOSTS);
 
@@ -748,22 +1195,29 @@ namespace DdMd
 
                   atomPtr = atomStoragePtr_->newGhostPtr();
                   atomPtr->unpackGhost(*bufferPtr_);
+                  atomPtr->plan().setImage(i, j);
                   if (shift) {
                      atomPtr->position()[i] += rshift;
+                     if (hasShear_ && i == shearGradient_) {
+                        applyShear(*atomPtr, shift, false);
+                     }
                   }
                   recvArray_(i, j).append(*atomPtr);
                   atomStoragePtr_->addNewGhost();
 
-                  // Prohibit sending back ghost in reverse direction
+                  // Forward only within the class of ghost received,
+                  // and prohibit sending back in reverse direction.
+                  atomPtr->plan().pruneGhosts(i, j);
                   if (j == 0) {
                      atomPtr->plan().clearGhost(i, 1);
+                     atomPtr->plan().clearGroupGhost(i, 1);
                   }
 
                   // Add to send arrays for remaining directions
                   if (i < Dimension - 1) {
                      for (ip = i + 1; ip < Dimension; ++ip) {
                         for (jp = 0; jp < 2; ++jp) {
-                           if (atomPtr->plan().ghost(ip, jp)) {
+                           if (atomPtr->plan().hasGhost(ip, jp)) {
                               sendArray_(ip, jp).append(*atomPtr);
                            }
                         }
@@ -782,6 +1236,9 @@ namespace DdMd
 
                }
                bufferPtr_->endRecvBlock();
+               #ifdef DDMD_ATOM_SOA
+               recvFirst_(i, j) = contiguousGhostIndex(recvArray_(i, j));
+               #endif
                stamp(UNPACK_GHOSTS);
 
             }
@@ -796,6 +1253,7 @@ namespace DdMd
       for (k = 0; k < groupExchangers_.size(); ++k) {
          groupExchangers_[k].findGhosts(*atomStoragePtr_);
       }
+      recordMemory(NGHOST, atomStoragePtr_->nGhost());
 
       #ifdef UTIL_DEBUG
       #ifdef DDMD_EXCHANGER_DEBUG
@@ -816,141 +1274,681 @@ namespace DdMd
    * Call on time steps for which no reneighboring is required.
    */
    void Exchanger::update()
+   {
+      beginUpdate();
+      while (continueUpdate()) {}
+   }
+
+   /*
+   * Begin a pipelined update of ghost positions.
+   */
+   void Exchanger::beginUpdate()
    {
       stamp(START);
       if (!atomStoragePtr_->isCartesian()) {
          UTIL_THROW("Error: Coordinates not Cartesian on entry to update");
       }
+      if (bufferPtr_->isPending()) {
+         UTIL_THROW("Error: Buffer has a pending message");
+      }
+      updateStep_ = 0;
+      advanceUpdate();
+   }
+
+   /*
+   * Complete pending message of a pipelined update, and post the next.
+   */
+   bool Exchanger::continueUpdate()
+   {
+      if (bufferPtr_->isPending()) {
+
+         Atom*  atomPtr;
+         int    i, j, k, size, shift;
+
+         i = updateStep_/2;
+         j = updateStep_%2;
+         shift = domainPtr_->shift(i, j);
+
+         // Complete send and receive
+         bufferPtr_->endSendRecv();
+         stamp(SEND_RECV_UPDATE);
+
+         // Unpack ghost positions
+         bufferPtr_->beginRecvBlock();
+         size = recvArray_(i, j).size();
+         bool isSheared = hasShear_ && shift && i == shearGradient_;
+         if (bufferPtr_->recvType() == Buffer::UPDATE_DELTA) {
+            // Add single precision offsets (independent of shift)
+            float d;
+            int m;
+            for (k = 0; k < size; ++k) {
+               Vector& position = recvArray_(i, j)[k].position();
+               for (m = 0; m < Dimension; ++m) {
+                  bufferPtr_->unpack<float>(d);
+                  position[m] += double(d);
+               }
+               bufferPtr_->decrementRecvSize();
+            }
+         } else
+         #ifdef DDMD_ATOM_SOA
+         if (recvFirst_(i, j) >= 0 && !isSheared) {
+            // Copy block directly into consecutive ghost positions
+            Vector* positions = atomStoragePtr_->ghostAtomArray().positions()
+                              + recvFirst_(i, j);
+            bufferPtr_->unpackArray<Vector>(positions, size);
+            if (shift) {
+               for (k = 0; k < size; ++k) {
+                  boundaryPtr_->applyShift(positions[k], i, shift);
+               }
+            }
+         } else
+         #endif
+         {
+            double previous;
+            for (k = 0; k < size; ++k) {
+               atomPtr = &recvArray_(i, j)[k];
+               previous = atomPtr->position()[shearFlow_];
+               atomPtr->unpackUpdate(*bufferPtr_);
+               if (shift) {
+                  boundaryPtr_->applyShift(atomPtr->position(), i, shift);
+                  if (isSheared) {
+                     applyShearUpdate(atomPtr->position(), shift, previous);
+                  }
+               }
+            }
+         }
+         bufferPtr_->endRecvBlock();
+         stamp(UNPACK_UPDATE);
 
+         ++updateStep_;
+         advanceUpdate();
+      }
+      return bufferPtr_->isPending();
+   }
+
+   /*
+   * Perform local steps, and post the next message of an update (private).
+   */
+   void Exchanger::advanceUpdate()
+   {
       Atom*  atomPtr;
       int    i, j, k, source, dest, size, shift;
 
+      while (updateStep_ < 2*Dimension) {
+         i = updateStep_/2;
+         j = updateStep_%2;
+
+         if (gridFlags_[i]) {
+
+            // Pack ghost positions for sending
+            bufferPtr_->clearSendBuffer();
+            if (compactUpdate_ && !hasShear_) {
+               packCompactUpdate(i, j);
+            } else {
+               bufferPtr_->beginSendBlock(Buffer::UPDATE);
+               size = sendArray_(i, j).size();
+               for (k = 0; k < size; ++k) {
+                  atomPtr = &sendArray_(i, j)[k];
+                  atomPtr->packUpdate(*bufferPtr_);
+               }
+               bufferPtr_->endSendBlock();
+            }
+            stamp(PACK_UPDATE);
+
+            // Post nonblocking send and receive, and return.
+            source = domainPtr_->sourceRank(i, j);
+            dest   = domainPtr_->destRank(i, j);
+            bufferPtr_->beginSendRecv(domainPtr_->communicator(), 
+                                      source, dest, updateStep_);
+            return;
+
+         } else {
+
+            // If grid().dimension(i) == 1, then copy positions of atoms
+            // listed in sendArray to those listed in the recvArray.
+
+            shift = domainPtr_->shift(i, j);
+            size = sendArray_(i, j).size();
+            assert(size == recvArray_(i, j).size());
+            for (k = 0; k < size; ++k) {
+               atomPtr = &recvArray_(i, j)[k];
+               atomPtr->position() = sendArray_(i, j)[k].position();
+               if (shift) {
+                  boundaryPtr_->applyShift(atomPtr->position(), i, shift);
+               }
+            }
+            stamp(LOCAL_UPDATE);
+            ++updateStep_;
+
+         }
+      }
+   }
+
+   /*
+   * Pack ghost positions of one send array for a compact update (private).
+   *
+   * Offsets from the positions last sent are packed as floats if these
+   * positions are known and no offset component exceeds the pair cutoff.
+   * Otherwise, full positions are packed. Last sent positions are then
+   * advanced by the rounded offsets, exactly as the receiver does.
+   */
+   void Exchanger::packCompactUpdate(int i, int j)
+   {
+      GPArray<Atom>& atoms = sendArray_(i, j);
+      std::vector<Vector>& last = lastSent_(i, j);
+      int size = atoms.size();
+      int k, m;
+
+      // Check that offsets are known, and small
+      bool isDelta = (size > 0 && int(last.size()) == size);
+      if (isDelta) {
+         Vector dr;
+         for (k = 0; k < size && isDelta; ++k) {
+            dr.subtract(atoms[k].position(), last[k]);
+            for (m = 0; m < Dimension; ++m) {
+               if (fabs(dr[m]) > pairCutoff_) {
+                  isDelta = false;
+               }
+            }
+         }
+      }
+
+      if (isDelta) {
+         float d;
+         bufferPtr_->beginSendBlock(Buffer::UPDATE_DELTA);
+         for (k = 0; k < size; ++k) {
+            const Vector& position = atoms[k].position();
+            Vector& r = last[k];
+            for (m = 0; m < Dimension; ++m) {
+               d = float(position[m] - r[m]);
+               bufferPtr_->pack<float>(d);
+               r[m] += double(d);
+            }
+            bufferPtr_->incrementSendSize();
+         }
+      } else {
+         last.resize(size);
+         bufferPtr_->beginSendBlock(Buffer::UPDATE);
+         for (k = 0; k < size; ++k) {
+            atoms[k].packUpdate(*bufferPtr_);
+            last[k] = atoms[k].position();
+         }
+      }
+      bufferPtr_->endSendBlock();
+   }
+
+   /*
+   * Update ghost atom forces.
+   *
+   * Call on time steps for which no reneighboring is required,
+   * if reverse communication is enabled.
+   */
+   void Exchanger::reverseUpdate()
+   {
+      stamp(START);
+      Atom*  atomPtr;
+      int    i, j, k, m, source, dest, size;
+
+      for (i = Dimension - 1; i >= 0; --i) {
+         for (j = 1; j >= 0; --j) {
+
+            if (gridFlags_[i]) {
+
+               // Pack ghost forces for sending
+               bufferPtr_->clearSendBuffer();
+               size = recvArray_(i, j).size();
+               if (compactUpdate_) {
+                  bufferPtr_->beginSendBlock(Buffer::FORCE_FLOAT);
+                  for (k = 0; k < size; ++k) {
+                     const Vector& f = recvArray_(i, j)[k].force();
+                     for (m = 0; m < Dimension; ++m) {
+                        bufferPtr_->pack<float>(float(f[m]));
+                     }
+                     bufferPtr_->incrementSendSize();
+                  }
+               } else {
+                  bufferPtr_->beginSendBlock(Buffer::FORCE);
+                  #ifdef DDMD_ATOM_SOA
+                  if (recvFirst_(i, j) >= 0) {
+                     // Copy consecutive ghost forces as one block
+                     bufferPtr_->packArray<Vector>(
+                              atomStoragePtr_->ghostAtomArray().forces()
+                              + recvFirst_(i, j), size);
+                  } else
+                  #endif
+                  {
+                     for (k = 0; k < size; ++k) {
+                        atomPtr = &recvArray_(i, j)[k];
+                        atomPtr->packForce(*bufferPtr_);
+                     }
+                  }
+               }
+               bufferPtr_->endSendBlock();
+               stamp(PACK_FORCE);
+
+               // Send and receive buffers (reverse direction)
+               source  = domainPtr_->destRank(i, j);
+               dest    = domainPtr_->sourceRank(i, j);
+               bufferPtr_->beginSendRecv(domainPtr_->communicator(),
+                                         source, dest,
+                                         2*Dimension + 2*i + j);
+               bufferPtr_->endSendRecv();
+               stamp(SEND_RECV_FORCE);
+
+               // Unpack ghost forces
+               bufferPtr_->beginRecvBlock();
+               size = sendArray_(i, j).size();
+               if (bufferPtr_->recvType() == Buffer::FORCE_FLOAT) {
+                  float f;
+                  for (k = 0; k < size; ++k) {
+                     Vector& force = sendArray_(i, j)[k].force();
+                     for (m = 0; m < Dimension; ++m) {
+                        bufferPtr_->unpack<float>(f);
+                        force[m] += double(f);
+                     }
+                     bufferPtr_->decrementRecvSize();
+                  }
+               } else {
+                  for (k = 0; k < size; ++k) {
+                     atomPtr = &sendArray_(i, j)[k];
+                     atomPtr->unpackForce(*bufferPtr_);
+                  }
+               }
+               bufferPtr_->endRecvBlock();
+               stamp(UNPACK_FORCE);
+
+            } else {
+
+               // If grid().dimension(i) == 1, then copy forces of atoms
+               // listed in sendArray to those listed in the recvArray.
+
+               size = recvArray_(i, j).size();
+               assert(size == sendArray_(i, j).size());
+               for (k = 0; k < size; ++k) {
+                  atomPtr = &sendArray_(i, j)[k];
+                  atomPtr->force() += recvArray_(i, j)[k].force();
+               }
+               stamp(LOCAL_FORCE);
+
+            }
+
+         } // transmit direction j = 1 or 0
+
+      } // Cartesian direction i
+
+   }
+
+   /*
+   * Reverse communicate per-atom energies and virials of ghosts.
+   */
+   void Exchanger::reverseUpdate(AtomStress& atomStress)
+   {
+      Atom*  atomPtr;
+      Vector diag, offDiag;
+      double energy;
+      int    i, j, k, pass, source, dest, size;
+
+      for (i = Dimension - 1; i >= 0; --i) {
+         for (j = 1; j >= 0; --j) {
+
+            if (gridFlags_[i]) {
+
+               source  = domainPtr_->destRank(i, j);
+               dest    = domainPtr_->sourceRank(i, j);
+               for (pass = 0; pass < 2; ++pass) {
+
+                  // Pack values of ghosts for sending
+                  bufferPtr_->clearSendBuffer();
+                  bufferPtr_->beginSendBlock(Buffer::FORCE);
+                  size = recvArray_(i, j).size();
+                  for (k = 0; k < size; ++k) {
+                     atomPtr = &recvArray_(i, j)[k];
+                     const Tensor& w = atomStress.virial(*atomPtr);
+                     if (pass == 0) {
+                        diag[0] = w(0, 0);
+                        diag[1] = w(1, 1);
+                        diag[2] = w(2, 2);
+                        bufferPtr_->pack<double>(atomStress.energy(*atomPtr));
+                        bufferPtr_->pack<Vector>(diag);
+                     } else {
+                        offDiag[0] = 0.5*(w(0, 1) + w(1, 0));
+                        offDiag[1] = 0.5*(w(0, 2) + w(2, 0));
+                        offDiag[2] = 0.5*(w(1, 2) + w(2, 1));
+                        bufferPtr_->pack<Vector>(offDiag);
+                     }
+                     bufferPtr_->incrementSendSize();
+                  }
+                  bufferPtr_->endSendBlock();
+
+                  // Send and receive buffers (reverse direction)
+                  bufferPtr_->beginSendRecv(domainPtr_->communicator(),
+                                            source, dest,
+                                            6*Dimension + 4*i + 2*j + pass);
+                  bufferPtr_->endSendRecv();
+
+                  // Unpack and add to values of sent atoms
+                  bufferPtr_->beginRecvBlock();
+                  size = sendArray_(i, j).size();
+                  for (k = 0; k < size; ++k) {
+                     atomPtr = &sendArray_(i, j)[k];
+                     Tensor& w = atomStress.virial(*atomPtr);
+                     if (pass == 0) {
+                        bufferPtr_->unpack<double>(energy);
+                        bufferPtr_->unpack<Vector>(diag);
+                        atomStress.energy(*atomPtr) += energy;
+                        w(0, 0) += diag[0];
+                        w(1, 1) += diag[1];
+                        w(2, 2) += diag[2];
+                     } else {
+                        bufferPtr_->unpack<Vector>(offDiag);
+                        w(0, 1) += offDiag[0];
+                        w(1, 0) += offDiag[0];
+                        w(0, 2) += offDiag[1];
+                        w(2, 0) += offDiag[1];
+                        w(1, 2) += offDiag[2];
+                        w(2, 1) += offDiag[2];
+                     }
+                     bufferPtr_->decrementRecvSize();
+                  }
+                  bufferPtr_->endRecvBlock();
+
+               } // pass
+
+            } else {
+
+               // If grid().dimension(i) == 1, then add values of atoms
+               // listed in recvArray to those listed in the sendArray.
+
+               size = recvArray_(i, j).size();
+               assert(size == sendArray_(i, j).size());
+               for (k = 0; k < size; ++k) {
+                  atomPtr = &sendArray_(i, j)[k];
+                  atomStress.energy(*atomPtr)
+                               += atomStress.energy(recvArray_(i, j)[k]);
+                  atomStress.virial(*atomPtr)
+                               += atomStress.virial(recvArray_(i, j)[k]);
+               }
+
+            }
+
+         } // transmit direction j = 1 or 0
+
+      } // Cartesian direction i
+
+   }
+
+   /*
+   * Update ghost atom velocities.
+   */
+   void Exchanger::updateVelocities()
+   {
+      // Precondition
+      if (!Atom::hasVelocity()) {
+         UTIL_THROW("Atom velocities are not stored");
+      }
+
+      Atom*  atomPtr;
+      int    i, j, k, source, dest, size, shift;
+      bool   isSheared;
+
       for (i = 0; i < Dimension; ++i) {
          for (j = 0; j < 2; ++j) {
-
-            // Shift on receiving processor for periodic boundary conditions
             shift = domainPtr_->shift(i, j);
+            isSheared = hasShear_ && shift && i == shearGradient_;
 
             if (gridFlags_[i]) {
 
-               // Pack ghost positions for sending
+               // Pack ghost velocities for sending
                bufferPtr_->clearSendBuffer();
                bufferPtr_->beginSendBlock(Buffer::UPDATE);
                size = sendArray_(i, j).size();
                for (k = 0; k < size; ++k) {
                   atomPtr = &sendArray_(i, j)[k];
-                  atomPtr->packUpdate(*bufferPtr_);
+                  bufferPtr_->pack<Vector>(atomPtr->velocity());
+                  bufferPtr_->incrementSendSize();
                }
                bufferPtr_->endSendBlock();
-               stamp(PACK_UPDATE);
 
                // Send and receive buffers
                source = domainPtr_->sourceRank(i, j);
                dest   = domainPtr_->destRank(i, j);
-               bufferPtr_->sendRecv(domainPtr_->communicator(), source, dest);
-               stamp(SEND_RECV_UPDATE);
+               bufferPtr_->beginSendRecv(domainPtr_->communicator(),
+                                         source, dest,
+                                         4*Dimension + 2*i + j);
+               bufferPtr_->endSendRecv();
 
-               // Unpack ghost positions
+               // Unpack ghost velocities
                bufferPtr_->beginRecvBlock();
                size = recvArray_(i, j).size();
                for (k = 0; k < size; ++k) {
                   atomPtr = &recvArray_(i, j)[k];
-                  atomPtr->unpackUpdate(*bufferPtr_);
-                  if (shift) {
-                     boundaryPtr_->applyShift(atomPtr->position(), i, shift);
+                  bufferPtr_->unpack<Vector>(atomPtr->velocity());
+                  bufferPtr_->decrementRecvSize();
+                  if (isSheared) {
+                     atomPtr->velocity()[shearFlow_]
+                                      += double(shift)*shearVelocity_;
                   }
                }
                bufferPtr_->endRecvBlock();
-               stamp(UNPACK_UPDATE);
 
             } else {
 
-               // If grid().dimension(i) == 1, then copy positions of atoms
-               // listed in sendArray to those listed in the recvArray.
-
+               // If grid().dimension(i) == 1, copy velocities locally.
                size = sendArray_(i, j).size();
                assert(size == recvArray_(i, j).size());
                for (k = 0; k < size; ++k) {
                   atomPtr = &recvArray_(i, j)[k];
-                  atomPtr->position() = sendArray_(i, j)[k].position();
-                  if (shift) {
-                     boundaryPtr_->applyShift(atomPtr->position(), i, shift);
+                  atomPtr->velocity() = sendArray_(i, j)[k].velocity();
+                  if (isSheared) {
+                     atomPtr->velocity()[shearFlow_]
+                                      += double(shift)*shearVelocity_;
                   }
                }
-               stamp(LOCAL_UPDATE);
 
             }
 
-         } // transmit direction j = 0, 1
+         }
+      }
+   }
+
+   /*
+   * Copy labels of atoms to their ghosts.
+   */
+   void Exchanger::updateLabels(const DArray<int>& localLabels,
+                                DArray<int>& ghostLabels)
+   {
+      Atom*  atomPtr;
+      int    i, j, k, m, source, dest, size, label;
+
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < 2; ++j) {
 
-      } // Cartesian direction i = 0, ..., Dimension - 1
+            if (gridFlags_[i]) {
+
+               // Pack labels of atoms in the send array
+               bufferPtr_->clearSendBuffer();
+               bufferPtr_->beginSendBlock(Buffer::SPECIAL);
+               size = sendArray_(i, j).size();
+               for (k = 0; k < size; ++k) {
+                  atomPtr = &sendArray_(i, j)[k];
+                  m = atomStoragePtr_->arrayIndex(*atomPtr);
+                  label = atomPtr->isGhost() ? ghostLabels[m]
+                                             : localLabels[m];
+                  bufferPtr_->pack<int>(label);
+                  bufferPtr_->incrementSendSize();
+               }
+               bufferPtr_->endSendBlock();
+
+               // Send and receive buffers
+               source = domainPtr_->sourceRank(i, j);
+               dest   = domainPtr_->destRank(i, j);
+               bufferPtr_->beginSendRecv(domainPtr_->communicator(),
+                                         source, dest,
+                                         12*Dimension + 2*i + j);
+               bufferPtr_->endSendRecv();
 
+               // Unpack labels of ghosts
+               bufferPtr_->beginRecvBlock();
+               size = recvArray_(i, j).size();
+               for (k = 0; k < size; ++k) {
+                  m = atomStoragePtr_->arrayIndex(recvArray_(i, j)[k]);
+                  bufferPtr_->unpack<int>(ghostLabels[m]);
+                  bufferPtr_->decrementRecvSize();
+               }
+               bufferPtr_->endRecvBlock();
+
+            } else {
+
+               // If grid().dimension(i) == 1, copy labels locally.
+               size = sendArray_(i, j).size();
+               assert(size == recvArray_(i, j).size());
+               for (k = 0; k < size; ++k) {
+                  atomPtr = &sendArray_(i, j)[k];
+                  m = atomStoragePtr_->arrayIndex(*atomPtr);
+                  label = atomPtr->isGhost() ? ghostLabels[m]
+                                             : localLabels[m];
+                  m = atomStoragePtr_->arrayIndex(recvArray_(i, j)[k]);
+                  ghostLabels[m] = label;
+               }
+
+            }
+
+         }
+      }
    }
 
    /*
-   * Update ghost atom forces.
-   *
-   * Call on time steps for which no reneighboring is required,
-   * if reverse communication is enabled.
+   * Reduce labels of ghosts onto their atoms, by taking the minimum.
    */
-   void Exchanger::reverseUpdate()
+   void Exchanger::reverseUpdateLabels(DArray<int>& localLabels,
+                                       DArray<int>& ghostLabels)
    {
-      stamp(START);
       Atom*  atomPtr;
-      int    i, j, k, source, dest, size;
+      int    i, j, k, m, source, dest, size, label;
+      int*   labelPtr;
 
       for (i = Dimension - 1; i >= 0; --i) {
          for (j = 1; j >= 0; --j) {
 
             if (gridFlags_[i]) {
 
-               // Pack ghost forces for sending
+               // Pack labels of ghosts in the receive array
                bufferPtr_->clearSendBuffer();
-               bufferPtr_->beginSendBlock(Buffer::FORCE);
+               bufferPtr_->beginSendBlock(Buffer::SPECIAL);
                size = recvArray_(i, j).size();
                for (k = 0; k < size; ++k) {
-                  atomPtr = &recvArray_(i, j)[k];
-                  atomPtr->packForce(*bufferPtr_);
+                  m = atomStoragePtr_->arrayIndex(recvArray_(i, j)[k]);
+                  bufferPtr_->pack<int>(ghostLabels[m]);
+                  bufferPtr_->incrementSendSize();
                }
                bufferPtr_->endSendBlock();
-               stamp(PACK_FORCE);
 
                // Send and receive buffers (reverse direction)
                source  = domainPtr_->destRank(i, j);
                dest    = domainPtr_->sourceRank(i, j);
-               bufferPtr_->sendRecv(domainPtr_->communicator(),
-                                    source, dest);
-               stamp(SEND_RECV_FORCE);
+               bufferPtr_->beginSendRecv(domainPtr_->communicator(),
+                                         source, dest,
+                                         14*Dimension + 2*i + j);
+               bufferPtr_->endSendRecv();
 
-               // Unpack ghost forces
+               // Unpack labels, and keep the minimum
                bufferPtr_->beginRecvBlock();
                size = sendArray_(i, j).size();
                for (k = 0; k < size; ++k) {
                   atomPtr = &sendArray_(i, j)[k];
-                  atomPtr->unpackForce(*bufferPtr_);
+                  m = atomStoragePtr_->arrayIndex(*atomPtr);
+                  labelPtr = atomPtr->isGhost() ? &ghostLabels[m]
+                                                : &localLabels[m];
+                  bufferPtr_->unpack<int>(label);
+                  bufferPtr_->decrementRecvSize();
+                  if (label >= 0 && label < *labelPtr) {
+                     *labelPtr = label;
+                  }
                }
                bufferPtr_->endRecvBlock();
-               stamp(UNPACK_FORCE);
 
             } else {
 
-               // If grid().dimension(i) == 1, then copy forces of atoms
-               // listed in sendArray to those listed in the recvArray.
-
+               // If grid().dimension(i) == 1, reduce labels locally.
                size = recvArray_(i, j).size();
                assert(size == sendArray_(i, j).size());
                for (k = 0; k < size; ++k) {
+                  m = atomStoragePtr_->arrayIndex(recvArray_(i, j)[k]);
+                  label = ghostLabels[m];
                   atomPtr = &sendArray_(i, j)[k];
-                  atomPtr->force() += recvArray_(i, j)[k].force();
+                  m = atomStoragePtr_->arrayIndex(*atomPtr);
+                  labelPtr = atomPtr->isGhost() ? &ghostLabels[m]
+                                                : &localLabels[m];
+                  if (label >= 0 && label < *labelPtr) {
+                     *labelPtr = label;
+                  }
                }
-               stamp(LOCAL_FORCE);
 
             }
 
-         } // transmit direction j = 1 or 0
+         }
+      }
+   }
 
-      } // Cartesian direction i
+   #ifdef DDMD_ATOM_SOA
+   /*
+   * Find ghost array index of a block of consecutive ghosts (private).
+   */
+   int Exchanger::contiguousGhostIndex(const GPArray<Atom>& ghosts) const
+   {
+      int size = ghosts.size();
+      if (size == 0) {
+         return -1;
+      }
+      int first = atomStoragePtr_->arrayIndex(ghosts[0]);
+      for (int k = 1; k < size; ++k) {
+         if (atomStoragePtr_->arrayIndex(ghosts[k]) != first + k) {
+            return -1;
+         }
+      }
+      return first;
+   }
+   #endif
 
+   #ifdef UTIL_MPI
+   /*
+   * Reduce memory usage statistics from all processors.
+   */
+   void Exchanger::computeStatistics(MPI::Intracomm& communicator)
+   {
+      communicator.Allreduce(&maxMemoryLocal_[0], &maxMemory_[0], 
+                             NMemoryStat, MPI::INT, MPI::MAX);
+   }
+   #endif
+
+   /*
+   * Output memory usage statistics.
+   */
+   void Exchanger::outputMemoryStatistics(std::ostream& out)
+   {
+      out << std::endl;
+      out << "Exchanger (max over procs)  " 
+          << "   initial" << "     later" << std::endl;
+      out << "atom exchange bytes/message " 
+          << Int(maxMemory_[INIT_ATOM_BYTES], 10)
+          << Int(maxMemory_[ATOM_BYTES], 10) << std::endl;
+      out << "ghost exchange bytes/message" 
+          << Int(maxMemory_[INIT_GHOST_BYTES], 10)
+          << Int(maxMemory_[GHOST_BYTES], 10) << std::endl;
+      out << "number of ghosts            " 
+          << Int(maxMemory_[INIT_NGHOST], 10)
+          << Int(maxMemory_[NGHOST], 10) << std::endl;
+   }
+
+   /*
+   * Clear memory usage statistics.
+   */
+   void Exchanger::clearStatistics()
+   {
+      for (int i = 0; i < NMemoryStat; ++i) {
+         maxMemoryLocal_[i] = 0;
+         maxMemory_[i] = 0;
+      }
    }
 
    /*
@@ -1047,6 +2045,12 @@ namespace DdMd
           << Dbl(UnpackGroupsT*factor1, 12, 6) << "   " 
           << Dbl(UnpackGroupsT*factor2, 12, 6) << "   " 
           << Dbl(UnpackGroupsT*factor3, 12, 6, true) << std::endl;
+      double SortAtomsT = timer_.time(Exchanger::SORT_ATOMS);
+      atomExchangeT += SortAtomsT;
+      out << "SortAtoms            " 
+          << Dbl(SortAtomsT*factor1, 12, 6) << "   " 
+          << Dbl(SortAtomsT*factor2, 12, 6) << "   " 
+          << Dbl(SortAtomsT*factor3, 12, 6, true) << std::endl;
       double MarkGroupGhostsT = timer_.time(Exchanger::MARK_GROUP_GHOSTS);
       atomExchangeT += MarkGroupGhostsT;
       out << "MarkGroupGhosts      " 
@@ -12,8 +12,12 @@
 #include <util/space/IntVector.h>
 #include <util/boundary/Boundary.h>
 #include <util/containers/FMatrix.h>
+#include <util/containers/FArray.h>
+#include <util/containers/DArray.h>
 #include <util/containers/GPArray.h>
 
+#include <vector>
+
 
 namespace DdMd
 {
@@ -21,7 +25,9 @@ namespace DdMd
    class Domain;
    class Atom;
    class AtomStorage;
+   class AtomStress;
    class Buffer;
+   class CellList;
    class GroupExchanger;
 
    using namespace Util;
@@ -78,6 +84,126 @@ namespace DdMd
       */
       void setPairCutoff(double pairCutoff);
 
+      /**
+      * Set width of the margin used to find groups that span boundaries.
+      *
+      * Ghost members of groups have positions from the last update, so
+      * a ghost within this distance of a domain boundary is counted as
+      * lying on both sides when deciding whether a group spans it (see
+      * GroupExchanger::markSpanningGroups). The margin must exceed the
+      * displacement of any atom since the last ghost update, for which
+      * the pair list skin is a safe choice. A smaller margin marks fewer
+      * groups, and so sends fewer atoms as group ghosts in addition to
+      * the nonbonded ghosts within the pair cutoff. If the margin is not
+      * set, or exceeds the pair cutoff, the pair cutoff is used.
+      *
+      * Atoms in groups divided among processors are sent with group
+      * ghost flags that are distinct from the nonbonded ghost flags
+      * (see Plan::groupGhost), and a ghost is only forwarded to later
+      * directions with flags of the class in which it was received, so
+      * that bonded ghosts are sent only to domains that own other atoms
+      * of their groups, and never fill out a full nonbonded shell.
+      *
+      * \param margin width of margin (distance), or negative to unset
+      */
+      void setGroupMargin(double margin);
+
+      /**
+      * Enable or disable the half-shell ghost communication scheme.
+      *
+      * In the half-shell (or eighth-shell) scheme, atoms are sent as
+      * nonbonded ghosts only in directions j=0, toward lower grid
+      * coordinates, and so each processor receives nonbonded ghosts
+      * only from the domains with higher grid coordinates. This roughly
+      * halves the number of ghosts, and the number of bytes sent by each
+      * update. Ghosts of atoms in groups that span a boundary are still
+      * sent in both directions. Each received ghost records the direction
+      * in which it was received in the image flags of its Plan. Reverse
+      * communication of forces is required.
+      *
+      * \param halfShell true to enable half-shell scheme
+      */
+      void setHalfShell(bool halfShell);
+
+      /**
+      * Enable or disable compact encoding of ghost updates.
+      *
+      * If enabled, update() sends the change in the position of each
+      * ghost since the previous update as three single precision values,
+      * rather than the full position in double precision, and
+      * reverseUpdate() sends forces in single precision. This halves the
+      * number of bytes per ghost. The first update after each exchange
+      * sends full positions. Each processor keeps the last position it
+      * sent for each ghost, advanced by the rounded offsets that the
+      * receiver adds, so rounding errors do not accumulate between
+      * exchanges. As a precision check, full positions are sent for any
+      * message in which an offset component exceeds the pair cutoff.
+      * Positions are always sent in full under Lees-Edwards conditions.
+      *
+      * \param compactUpdate true to enable compact updates
+      */
+      void setCompactUpdate(bool compactUpdate);
+
+      /**
+      * Restrict the atom scan of the next exchange to boundary cells.
+      *
+      * By default, exchangeAtoms() computes the communication plan of
+      * every local atom. After this call, the next exchange instead
+      * computes plans only for atoms in cells of cellList that are not
+      * interior cells, in which an interior cell is one that lies farther
+      * than maxDisp plus the ghost slab width from every domain face, so
+      * that atoms in interior cells can neither migrate nor be ghosts.
+      * If the number of local atoms found in the cell list differs from
+      * the number in AtomStorage, all atoms are scanned. The setting only
+      * applies to one exchange.
+      *
+      * The cell list must have been built, in generalized coordinates,
+      * after the most recent exchange, and maxDisp must be an upper bound
+      * on the (non-affine, Cartesian) displacement of any local atom
+      * since it was built.
+      *
+      * \param cellList cell list of local and ghost atoms
+      * \param maxDisp maximum displacement of local atoms since build
+      */
+      void setBoundaryScan(const CellList& cellList, double maxDisp);
+
+      /**
+      * Enable Lees-Edwards sliding periodic boundary conditions.
+      *
+      * Under Lees-Edwards conditions, the periodic image of the unit cell
+      * with index +1 along the gradient direction is displaced along the
+      * flow direction by the current image offset, and moves relative to
+      * the primary cell with the current image velocity (see setShearOffset).
+      * Atoms that cross a periodic boundary along the gradient direction,
+      * and ghosts that are sent across it, are shifted accordingly along
+      * the flow direction, and wrapped into the primary cell. Migrating
+      * atoms also have their flow velocity shifted.
+      *
+      * The gradient index must be less than the flow index, so that ghosts
+      * shifted along the flow direction are then sent as ghosts along the
+      * flow direction. The processor grid dimension must be 1 along the
+      * flow direction and at least 2 along the gradient direction, and the
+      * half-shell scheme may not be used.
+      *
+      * \param gradient index of gradient direction
+      * \param flow  index of flow direction
+      */
+      void setShear(int gradient, int flow);
+
+      /**
+      * Set the current Lees-Edwards image offset and velocity.
+      *
+      * \param offset  flow displacement of the upper image, as a fraction
+      *                of the cell length along the flow direction
+      * \param velocity  flow velocity of the upper image (Cartesian)
+      */
+      void setShearOffset(double offset, double velocity);
+
+      /**
+      * Are Lees-Edwards boundary conditions enabled?
+      */
+      bool hasShear() const;
+
       /**
       * Exchange local atoms and ghosts.
       * 
@@ -89,6 +215,25 @@ namespace DdMd
       */
       void exchange();
 
+      /**
+      * Exchange local atoms and ghosts when no ghosts exist yet.
+      *
+      * This method should be used instead of exchange() after atoms
+      * and groups are first distributed (e.g., after reading or loading
+      * a configuration), when no ghost atoms exist. A single call to 
+      * exchange() in this state must send every atom of every group that
+      * is incomplete on a processor as a ghost in every direction, which
+      * requires ghost and buffer capacities much larger than needed in
+      * steady state. This method instead uses two passes: The first pass
+      * exchanges atoms and then exchanges only ghosts that are identified
+      * by position, which completes every group whose atoms all lie within
+      * the pair cutoff of the domain. The second pass is a normal call to 
+      * exchange(), in which the ghost plans of complete groups are based 
+      * on positions, so that only groups that remain incomplete are sent
+      * in all directions.
+      */
+      void initialExchange();
+
       /**
       * Update ghost atom coordinates.
       * 
@@ -99,6 +244,32 @@ namespace DdMd
       */
       void update();
 
+      /**
+      * Begin a pipelined update of ghost atom coordinates.
+      *
+      * Performs the same communication as update(), in the same order,
+      * but returns as soon as the first nonblocking message has been 
+      * posted. The caller should then alternate computation that does 
+      * not require ghost positions with calls to continueUpdate(), until
+      * continueUpdate() returns false. The sequence
+      * \code
+      *    exchanger.beginUpdate();
+      *    while (exchanger.continueUpdate()) {}
+      * \endcode
+      * is equivalent to update().
+      */
+      void beginUpdate();
+
+      /**
+      * Complete the pending message of a pipelined update, post the next.
+      *
+      * Waits for the pending message, if any, unpacks it, and advances 
+      * to the next transmission, which is posted before returning.
+      * 
+      * \return true if a message is still pending, false if done.
+      */
+      bool continueUpdate();
+
       /**
       * Update ghost atom forces.
       * 
@@ -111,11 +282,94 @@ namespace DdMd
       */
       void reverseUpdate();
 
+      /**
+      * Add per-atom energies and virials of ghosts to their owners.
+      *
+      * Uses the same communication pattern as reverseUpdate(), in two
+      * passes per transmission to fit the space reserved per ghost in
+      * the buffer: The first sends energies and diagonal virial
+      * elements, the second the symmetrized off-diagonal elements. It
+      * should be called only if reverse force communication is enabled,
+      * after a force calculation in which atomStress was active.
+      *
+      * \param atomStress per-atom energy and virial accumulator
+      */
+      void reverseUpdate(AtomStress& atomStress);
+
+      /**
+      * Update ghost atom velocities.
+      *
+      * Communicates velocities of the same ghosts, with the same
+      * communication pattern, as update() communicates positions.
+      * Ghost velocities are otherwise not maintained, and are needed
+      * only by algorithms such as RATTLE that couple velocities of
+      * atoms in groups that span domain boundaries.
+      */
+      void updateVelocities();
+
+      /**
+      * Copy an integer label of every atom to each of its ghosts.
+      *
+      * Labels are stored in one array for local atoms and one for
+      * ghosts, both indexed by AtomStorage::arrayIndex(). Labels are
+      * sent to the same ghosts, with the same communication pattern, as
+      * positions in update(), so that ghosts of ghosts are also set.
+      * Negative labels are sent like any other value.
+      *
+      * \param localLabels labels of local atoms
+      * \param ghostLabels labels of ghost atoms (output)
+      */
+      void updateLabels(const DArray<int>& localLabels,
+                        DArray<int>& ghostLabels);
+
+      /**
+      * Replace the label of every atom by the minimum over its ghosts.
+      *
+      * Uses the communication pattern of reverseUpdate(), and the array
+      * convention of updateLabels(). Each atom ends with the minimum of
+      * its own label and those of all of its ghosts on all processors.
+      * Ghosts with negative labels are ignored. This does not require
+      * that reverse force communication be enabled.
+      *
+      * \param localLabels labels of local atoms (input and output)
+      * \param ghostLabels labels of ghost atoms (input, and modified)
+      */
+      void reverseUpdateLabels(DArray<int>& localLabels,
+                               DArray<int>& ghostLabels);
+
       /**
       * Output statistics.
       */
       void outputStatistics(std::ostream& out, double time, int nStep);
 
+      #ifdef UTIL_MPI
+      /**
+      * Compute memory usage statistics (reduce from all processors).
+      * 
+      * Call on all processors.
+      *
+      * \param communicator MPI communicator for all processors
+      */
+      void computeStatistics(MPI::Intracomm& communicator);
+      #endif
+
+      /**
+      * Output memory usage statistics for each communication step.
+      *
+      * Reports the maximum number of bytes sent in a single message during
+      * atom exchange and ghost exchange, and the maximum number of ghosts, 
+      * for both initial and subsequent exchanges. Call on master, after 
+      * calling computeStatistics on all processors.
+      *
+      * \param out output stream
+      */
+      void outputMemoryStatistics(std::ostream& out);
+
+      /**
+      * Clear memory usage statistics.
+      */
+      void clearStatistics();
+
       /**
       * Return internal timer by reference
       */
@@ -127,7 +381,7 @@ namespace DdMd
       enum timeId {START, ATOM_PLAN, INIT_GROUP_PLAN, CLEAR_GHOSTS,
                    PACK_ATOMS, PACK_GROUPS, REMOVE_ATOMS, 
                    SEND_RECV_ATOMS, UNPACK_ATOMS, UNPACK_GROUPS, 
-                   MARK_GROUP_GHOSTS, INIT_SEND_ARRAYS, PACK_GHOSTS, 
+                   SORT_ATOMS, MARK_GROUP_GHOSTS, INIT_SEND_ARRAYS, PACK_GHOSTS, 
                    SEND_RECV_GHOSTS, UNPACK_GHOSTS, FIND_GROUP_GHOSTS, 
                    PACK_UPDATE, SEND_RECV_UPDATE, UNPACK_UPDATE, 
                    LOCAL_UPDATE, PACK_FORCE, SEND_RECV_FORCE, 
@@ -159,6 +413,28 @@ namespace DdMd
       */
       FMatrix< GPArray<Atom>, Dimension, 2>  recvArray_;
 
+      /**
+      * Positions last sent in each direction by a compact update.
+      *
+      * Element lastSent_(i, j)[k] is the position of sendArray_(i, j)[k]
+      * as known to the receiving processor, before its periodic shift.
+      * Arrays are emptied by exchangeGhosts().
+      */
+      FMatrix< std::vector<Vector>, Dimension, 2>  lastSent_;
+
+      #ifdef DDMD_ATOM_SOA
+      /**
+      * Ghost array index of the first ghost in each receive array.
+      *
+      * Element recvFirst_(i, j) is the index within the ghost AtomArray
+      * of recvArray_(i, j)[0] if the ghosts in recvArray_(i, j) occupy
+      * consecutive array elements, in order, or -1 otherwise. Positions
+      * and forces of such a block of ghosts are then contiguous, and are
+      * copied to or from a Buffer with a single memcpy during updates.
+      */
+      FMatrix<int, Dimension, 2>  recvFirst_;
+      #endif
+
       #ifdef UTIL_MPI
       /**
       * Array of pointers to atoms that have been packed and sent.
@@ -177,6 +453,12 @@ namespace DdMd
       /// Outer boundaries of nonbonded slabs
       FMatrix< double, Dimension, 2>  outer_;
 
+      /// Inner boundaries of margins for groups that span boundaries
+      FMatrix< double, Dimension, 2>  groupInner_;
+
+      /// Outer boundaries of margins for groups that span boundaries
+      FMatrix< double, Dimension, 2>  groupOuter_;
+
       /// Elements are 1 if grid dimension > 1, 0 otherwise.
       IntVector gridFlags_;
 
@@ -198,6 +480,75 @@ namespace DdMd
       /// Cutoff for pair list (potential cutoff + skin).
       double pairCutoff_;
 
+      /// Margin for ghost members of groups (or negative if unset).
+      double groupMargin_;
+
+      /// Number of calls to exchangeAtoms since the last spatial sort.
+      int nExchangeSinceSort_;
+
+      /// Index 2*i + j of the current step of a pipelined update.
+      int updateStep_;
+
+      /// Pass of initialExchange() in progress (1 or 2), or 0 if none.
+      int initialPass_;
+
+      /// Is the half-shell ghost communication scheme enabled?
+      bool halfShell_;
+
+      /// Are ghost updates sent in compact (single precision) form?
+      bool compactUpdate_;
+
+      /// Cell list for a boundary scan in the next exchange, or null.
+      const CellList* scanCellListPtr_;
+
+      /// Maximum displacement of local atoms since scanCellListPtr_ build.
+      double scanDisp_;
+
+      /**
+      * Local atoms with exchange flags set during exchangeAtoms().
+      *
+      * Every atom that is marked for exchange is listed, so that atoms
+      * that are not are never revisited during an exchange.
+      */
+      std::vector<Atom*> movers_;
+
+      /// Are Lees-Edwards boundary conditions enabled?
+      bool hasShear_;
+
+      /// Index of Lees-Edwards gradient direction.
+      int shearGradient_;
+
+      /// Index of Lees-Edwards flow direction.
+      int shearFlow_;
+
+      /// Flow offset of upper image (generalized coordinates, in [0,1)).
+      double shearOffset_;
+
+      /// Flow velocity of upper image (Cartesian).
+      double shearVelocity_;
+
+      /**
+      * Memory statistic identifiers, for maxima over exchanges.
+      *
+      * ATOM_BYTES and GHOST_BYTES are the largest messages sent during
+      * exchangeAtoms and exchangeGhosts, respectively, and NGHOST is the
+      * largest number of ghosts. The INIT_ variants apply to calls from 
+      * initialExchange().
+      */
+      enum MemoryStatId {ATOM_BYTES, GHOST_BYTES, NGHOST, INIT_ATOM_BYTES,
+                         INIT_GHOST_BYTES, INIT_NGHOST, NMemoryStat};
+
+      /// Maxima of memory statistics on this processor.
+      FArray<int, NMemoryStat> maxMemoryLocal_;
+
+      /// Maxima of memory statistics on any processor.
+      FArray<int, NMemoryStat> maxMemory_;
+
+      /*
+      * Record a memory usage value, if it exceeds the current maximum.
+      */
+      void recordMemory(int statId, int value);
+
       /// Timer
       DdTimer timer_;
 
@@ -220,6 +571,102 @@ namespace DdMd
       */
       void exchangeGhosts();
 
+      /**
+      * Apply Lees-Edwards shift to an atom that crossed a gradient boundary.
+      *
+      * Shifts and wraps the flow coordinate (generalized), and resets the
+      * ghost flags for the flow direction. If isLocal, also shifts the
+      * flow velocity.
+      *
+      * \param atom  atom or ghost, after the periodic shift
+      * \param shift  periodic shift along the gradient direction
+      * \param isLocal  true for a local atom, false for a ghost
+      */
+      void applyShear(Atom& atom, int shift, bool isLocal);
+
+      /**
+      * Apply Lees-Edwards shift to a ghost position during an update.
+      *
+      * Shifts the flow coordinate (Cartesian), and chooses the periodic
+      * image closest to the previous position of the ghost.
+      *
+      * \param position  updated ghost position, after the periodic shift
+      * \param shift  periodic shift along the gradient direction
+      * \param previous  flow coordinate of ghost before update
+      */
+      void applyShearUpdate(Vector& position, int shift, double previous);
+
+      /**
+      * Pack ghost positions of one send array for a compact update.
+      *
+      * \param i Cartesian direction
+      * \param j index of transmit direction (0 or 1)
+      */
+      void packCompactUpdate(int i, int j);
+
+      /**
+      * Compute the communication plan of one local atom.
+      *
+      * Also adds the atom to sendArray_ if it remains on this processor
+      * and is sent as a ghost, and to movers_ if marked for exchange.
+      *
+      * \param atom local atom
+      */
+      void planAtom(Atom& atom);
+
+      /**
+      * Compute plans of local atoms in boundary cells only.
+      *
+      * \return false if a full scan of all local atoms is required
+      */
+      bool scanBoundaryCells();
+
+      /**
+      * Reorder local atoms and reset all pointers to local atoms.
+      *
+      * Calls AtomStorage::sortAtoms(), then resets pointers to local
+      * atoms in all groups and rebuilds the ghost send arrays. Called
+      * within exchangeAtoms() after all atoms have been exchanged and
+      * before groups are inspected to mark ghosts.
+      */
+      void sortAtoms();
+
+      /**
+      * Increase storage and buffer capacities, if usage is too high.
+      *
+      * Calls AtomStorage::grow(), resets pointers to local atoms if the
+      * atoms were moved, and reallocates the Buffer on all processors if
+      * any storage capacity exceeds that of the Buffer, or if the largest
+      * message on any processor exceeds the growth threshold. Called on
+      * all processors within exchangeAtoms(), just before sortAtoms().
+      */
+      void growStorage();
+
+      /**
+      * Reset pointers to local atoms in groups and send arrays.
+      *
+      * Called after local atoms have been moved by sortAtoms() or grow().
+      */
+      void resetLocalAtoms();
+
+      /**
+      * Advance a pipelined update to the next step that requires a message.
+      *
+      * Performs local copies for any steps that require no communication,
+      * then packs and posts the next message, if any remain.
+      */
+      void advanceUpdate();
+
+      #ifdef DDMD_ATOM_SOA
+      /**
+      * Return index of the first of a block of consecutive ghosts.
+      *
+      * \param ghosts array of pointers to ghost atoms
+      * \return ghost array index of ghosts[0], or -1 if not consecutive
+      */
+      int contiguousGhostIndex(const GPArray<Atom>& ghosts) const;
+      #endif
+
       /**
       * Stamp internal timer.
       */
@@ -227,12 +674,25 @@ namespace DdMd
 
    };
 
+   // Record a memory usage statistic (private)
+   inline void Exchanger::recordMemory(int statId, int value) 
+   {
+      if (initialPass_ > 0) statId += INIT_ATOM_BYTES;
+      if (value > maxMemoryLocal_[statId]) {
+         maxMemoryLocal_[statId] = value;
+      }
+   }
+
    // Inline methods.
 
    // Return internal timer by reference (public).
    inline DdTimer& Exchanger::timer()
    {  return timer_; }
 
+   // Are Lees-Edwards boundary conditions enabled? (public).
+   inline bool Exchanger::hasShear() const
+   {  return hasShear_; }
+
    // Stamp internal timer (private)
    inline void Exchanger::stamp(unsigned int timeId) 
    {  timer_.stamp(timeId); }
@@ -12,6 +12,7 @@
 #include <ddMd/chemistry/Group.h>            // member
 #include <ddMd/communicate/Buffer.h>         // member data type
 #include <util/containers/DArray.h>          // member
+#include <util/containers/GArray.h>          // member
 
 namespace DdMd
 {
@@ -180,6 +181,33 @@ namespace DdMd
       */ 
       void receive();
 
+      #ifdef UTIL_MPI
+      /**
+      * Queue a copy of a group read on this processor for another processor.
+      *
+      * This supports parallel reading of files in which the groups read by
+      * each processor may be needed by any processor. It may be called on
+      * any processor, before redistribute(). Call once for each processor
+      * that owns one or more atoms of the group.
+      *
+      * \param group  group read on this processor
+      * \param rank   rank of a processor that needs the group
+      */
+      void addStaged(const Group<N>& group, int rank);
+
+      /**
+      * Send all groups queued by addStaged() to their destinations.
+      *
+      * Call on all processors, after AtomDistributor::redistribute(). 
+      * Groups are routed in stages, one grid direction at a time, in the 
+      * same way as atoms. On arrival, each group is added to the local 
+      * GroupStorage, unless a group with the same id is already present.
+      *
+      * \pre There are no ghost atoms.
+      */
+      void redistribute();
+      #endif
+
    protected:
 
       /**
@@ -226,6 +254,14 @@ namespace DdMd
       /// Current size of cache_ (defined only on master).
       int cacheSize_;
 
+      #ifdef UTIL_MPI
+      /// Groups queued by addStaged(), awaiting redistribute().
+      GArray< Group<N> > stagedGroups_;
+
+      /// Destination rank for each element of stagedGroups_.
+      GArray<int> stagedRanks_;
+      #endif
+
       /**
       * Validate groups after receipt.
       */
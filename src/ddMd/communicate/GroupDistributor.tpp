@@ -12,6 +12,7 @@
 #include "Domain.h"
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/GroupStorage.tpp>
+#include <util/space/IntVector.h>
 
 #include <algorithm>
 
@@ -36,6 +37,10 @@ namespace DdMd
       nSentTotal_(0),
       cacheCapacity_(1024), 
       cacheSize_(0)
+      #ifdef UTIL_MPI
+      , stagedGroups_(),
+      stagedRanks_()
+      #endif
    {  setClassName("GroupDistributor"); }
 
    /*
@@ -326,6 +331,155 @@ namespace DdMd
    }
 
    #ifdef UTIL_MPI
+   /*
+   * Queue a copy of a group for a destination processor.
+   */
+   template <int N>
+   void GroupDistributor<N>::addStaged(const Group<N>& group, int rank)
+   {
+      if (domainPtr_ == 0) {
+         UTIL_THROW("GroupDistributor is not initialized");
+      }
+      if (rank < 0 || rank >= domainPtr_->grid().size()) {
+         UTIL_THROW("Invalid destination rank");
+      }
+      stagedGroups_.append(group);
+      stagedRanks_.append(rank);
+   }
+
+   /*
+   * Route queued groups to destinations, one direction at a time.
+   */
+   template <int N>
+   void GroupDistributor<N>::redistribute()
+   {
+      // Preconditions
+      if (atomStoragePtr_ == 0) {
+         UTIL_THROW("GroupDistributor is not initialized");
+      }
+      if (groupStoragePtr_ == 0) {
+         UTIL_THROW("GroupDistributor is not initialized");
+      }
+      if (domainPtr_ == 0) {
+         UTIL_THROW("GroupDistributor is not initialized");
+      }
+      if (bufferPtr_ == 0) {
+         UTIL_THROW("GroupDistributor is not initialized");
+      }
+      if (atomStoragePtr_->nGhost() != 0) {
+         UTIL_THROW("AtomStorage has ghosts");
+      }
+
+      MPI::Intracomm& communicator = domainPtr_->communicator();
+      const Grid& grid = domainPtr_->grid();
+      const int myRank = domainPtr_->gridRank();
+
+      // Each item is packed as a destination rank and a group
+      const int itemSize = Group<N>::packedSize() + sizeof(int);
+      const int capacity = (bufferPtr_->groupCapacity<N>()
+                            *Group<N>::packedSize())/itemSize;
+      IntVector position = grid.position(myRank);
+      IntVector partner;
+      GArray< Group<N> > sendGroups;
+      GArray<int> sendRanks;
+      Group<N> group;
+      int gridDimension, coordinate, source, dest, rank;
+      int nPacket, nPacketMax, nKeep;
+      int i, j, k, m, begin, end;
+
+      for (i = 0; i < Dimension; ++i) {
+         gridDimension = domainPtr_->gridDimension(i);
+         for (j = 1; j < gridDimension; ++j) {
+
+            // Partners j steps ahead and behind along axis i
+            coordinate = (position[i] + j) % gridDimension;
+            partner = position;
+            partner[i] = coordinate;
+            dest = grid.rank(partner);
+            partner[i] = (position[i] - j + gridDimension) % gridDimension;
+            source = grid.rank(partner);
+
+            // Move groups with destination coordinate[i] equal to that 
+            // of dest into the send list, and compact the staged list.
+            sendGroups.clear();
+            sendRanks.clear();
+            nKeep = 0;
+            for (m = 0; m < stagedGroups_.size(); ++m) {
+               rank = stagedRanks_[m];
+               if (grid.position(rank)[i] == coordinate) {
+                  sendGroups.append(stagedGroups_[m]);
+                  sendRanks.append(rank);
+               } else {
+                  if (nKeep != m) {
+                     stagedGroups_[nKeep] = stagedGroups_[m];
+                     stagedRanks_[nKeep] = rank;
+                  }
+                  ++nKeep;
+               }
+            }
+            stagedGroups_.resize(nKeep);
+            stagedRanks_.resize(nKeep);
+
+            // All processors must exchange the same number of buffers.
+            nPacket = (sendGroups.size() + capacity - 1)/capacity;
+            communicator.Allreduce(&nPacket, &nPacketMax, 1, 
+                                   MPI::INT, MPI::MAX);
+
+            end = 0;
+            for (k = 0; k < nPacketMax; ++k) {
+               begin = end;
+               end = std::min(begin + capacity, sendGroups.size());
+               bufferPtr_->clearSendBuffer();
+               bufferPtr_->beginSendBlock(Buffer::GROUP2 + N - 2);
+               for (m = begin; m < end; ++m) {
+                  bufferPtr_->pack<int>(sendRanks[m]);
+                  sendGroups[m].pack(*bufferPtr_);
+               }
+               bufferPtr_->endSendBlock(k == nPacketMax - 1);
+               bufferPtr_->sendRecv(communicator, source, dest);
+
+               bufferPtr_->beginRecvBlock();
+               while (bufferPtr_->recvSize() > 0) {
+                  bufferPtr_->unpack<int>(rank);
+                  group.unpack(*bufferPtr_);
+                  stagedGroups_.append(group);
+                  stagedRanks_.append(rank);
+               }
+               bufferPtr_->endRecvBlock();
+            }
+            bufferPtr_->clearSendBuffer();
+
+         }
+      }
+
+      // Add groups that arrived here, skipping duplicates
+      Group<N>* ptr;
+      int nAtom;
+      for (m = 0; m < stagedGroups_.size(); ++m) {
+         if (stagedRanks_[m] != myRank) {
+            UTIL_THROW("Group on wrong processor after redistribution");
+         }
+         if (groupStoragePtr_->find(stagedGroups_[m].id())) {
+            continue;
+         }
+         ptr = groupStoragePtr_->newPtr();
+         *ptr = stagedGroups_[m];
+         nAtom = atomStoragePtr_->map().findGroupLocalAtoms(*ptr);
+         if (nAtom > 0) {
+            groupStoragePtr_->add();
+         } else {
+            groupStoragePtr_->returnPtr();
+            UTIL_THROW("Group sent to processor that owns none of its atoms");
+         }
+      }
+      stagedGroups_.clear();
+      stagedRanks_.clear();
+
+      groupStoragePtr_->unsetNTotal();
+      groupStoragePtr_->computeNTotal(communicator);
+      groupStoragePtr_->isValid(*atomStoragePtr_, communicator, false);
+   }
+
    /**
    * Check number of groups sent and received.
    */
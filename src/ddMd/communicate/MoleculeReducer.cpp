@@ -0,0 +1,334 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "MoleculeReducer.h"
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   MoleculeReducer::MoleculeReducer()
+    : nMolecules_(),
+      nAtoms_(),
+      offsets_(),
+      slots_(),
+      slotIds_(),
+      partials_(),
+      totals_(),
+      sendBuffer_(),
+      recvBuffer_(),
+      sendSlots_(),
+      sendCounts_(),
+      recvCounts_(),
+      sendDispls_(),
+      recvDispls_(),
+      domainPtr_(0),
+      storagePtr_(0),
+      nSpecies_(0),
+      nValue_(0),
+      nProc_(1),
+      rank_(0),
+      isReduced_(false)
+   {}
+
+   /*
+   * Destructor.
+   */
+   MoleculeReducer::~MoleculeReducer()
+   {}
+
+   /*
+   * Create associations with Domain and AtomStorage.
+   */
+   void MoleculeReducer::associate(Domain& domain, AtomStorage& storage)
+   {
+      domainPtr_ = &domain;
+      storagePtr_ = &storage;
+   }
+
+   /*
+   * Compute species and molecule counts from atom contexts.
+   */
+   void MoleculeReducer::setup()
+   {
+      if (!domainPtr_ || !storagePtr_) {
+         UTIL_THROW("MoleculeReducer is not associated");
+      }
+      if (!Atom::hasAtomContext()) {
+         UTIL_THROW("Molecule reduction requires AtomContext data");
+      }
+      #ifdef UTIL_MPI
+      MPI::Intracomm& communicator = domainPtr_->communicator();
+      nProc_ = communicator.Get_size();
+      rank_ = communicator.Get_rank();
+      #endif
+
+      // Find number of species, and check contexts of local atoms
+      AtomIterator atomIter;
+      int localMax = -1;
+      int nInvalid = 0;
+      storagePtr_->begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         const AtomContext& context = atomIter->context();
+         if (context.speciesId < 0 || context.moleculeId < 0
+             || context.atomId < 0) {
+            ++nInvalid;
+         }
+         if (context.speciesId > localMax) {
+            localMax = context.speciesId;
+         }
+      }
+      int globalMax = localMax;
+      int nInvalidTotal = nInvalid;
+      #ifdef UTIL_MPI
+      communicator.Allreduce(&localMax, &globalMax, 1, MPI::INT, MPI::MAX);
+      communicator.Allreduce(&nInvalid, &nInvalidTotal, 1, MPI::INT,
+                             MPI::SUM);
+      #endif
+      if (nInvalidTotal > 0) {
+         UTIL_THROW("Atom with unset AtomContext");
+      }
+      nSpecies_ = globalMax + 1;
+
+      // Find largest molecule and atom ids of each species
+      DArray<int> localMaxIds;
+      DArray<int> globalMaxIds;
+      int n = 2*nSpecies_;
+      int i, s;
+      if (n > 0) {
+         localMaxIds.allocate(n);
+         globalMaxIds.allocate(n);
+         for (i = 0; i < n; ++i) {
+            localMaxIds[i] = -1;
+         }
+      }
+      for (storagePtr_->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         const AtomContext& context = atomIter->context();
+         s = context.speciesId;
+         if (context.moleculeId > localMaxIds[2*s]) {
+            localMaxIds[2*s] = context.moleculeId;
+         }
+         if (context.atomId > localMaxIds[2*s + 1]) {
+            localMaxIds[2*s + 1] = context.atomId;
+         }
+      }
+      if (n > 0) {
+         #ifdef UTIL_MPI
+         communicator.Allreduce(&localMaxIds[0], &globalMaxIds[0], n,
+                                MPI::INT, MPI::MAX);
+         #else
+         for (i = 0; i < n; ++i) {
+            globalMaxIds[i] = localMaxIds[i];
+         }
+         #endif
+      }
+
+      // Set counts and molecule index offsets of species
+      if (nMolecules_.isAllocated()) {
+         nMolecules_.deallocate();
+         nAtoms_.deallocate();
+         offsets_.deallocate();
+      }
+      if (nSpecies_ > 0) {
+         nMolecules_.allocate(nSpecies_);
+         nAtoms_.allocate(nSpecies_);
+      }
+      offsets_.allocate(nSpecies_ + 1);
+      long nAtomExpected = 0;
+      offsets_[0] = 0;
+      for (s = 0; s < nSpecies_; ++s) {
+         nMolecules_[s] = globalMaxIds[2*s] + 1;
+         nAtoms_[s] = globalMaxIds[2*s + 1] + 1;
+         offsets_[s+1] = offsets_[s] + nMolecules_[s];
+         nAtomExpected += long(nMolecules_[s])*long(nAtoms_[s]);
+      }
+
+      // Check that all molecules are complete
+      long nAtomLocal = storagePtr_->nAtom();
+      long nAtomTotal = nAtomLocal;
+      #ifdef UTIL_MPI
+      communicator.Allreduce(&nAtomLocal, &nAtomTotal, 1, MPI::LONG,
+                             MPI::SUM);
+      #endif
+      if (nAtomTotal != nAtomExpected) {
+         UTIL_THROW("Number of atoms inconsistent with species counts");
+      }
+
+      sendCounts_.resize(nProc_);
+      recvCounts_.resize(nProc_);
+      sendDispls_.resize(nProc_);
+      recvDispls_.resize(nProc_);
+      begin(0);
+   }
+
+   /*
+   * Get the species of a molecule from its global index.
+   */
+   int MoleculeReducer::speciesId(int index) const
+   {
+      int s = 0;
+      while (s < nSpecies_ - 1 && index >= offsets_[s+1]) {
+         ++s;
+      }
+      return s;
+   }
+
+   /*
+   * Discard partial sums and totals, and set the number of values.
+   */
+   void MoleculeReducer::begin(int nValue)
+   {
+      if (nValue < 0) {
+         UTIL_THROW("Negative nValue");
+      }
+      nValue_ = nValue;
+      slots_.clear();
+      slotIds_.clear();
+      partials_.clear();
+      sendSlots_.clear();
+      isReduced_ = false;
+   }
+
+   /*
+   * Send partial sums to owners of molecules, and add them.
+   */
+   void MoleculeReducer::reduce()
+   {
+      int nOwn = nOwned();
+      totals_.assign(nOwn*nValue_, 0.0);
+      int entrySize = nValue_ + 1;
+      int nSlot = slotIds_.size();
+      int i, j, r, k;
+      const double* ptr;
+
+      #ifdef UTIL_MPI
+      // Count entries for each owner, and compute displacements
+      for (r = 0; r < nProc_; ++r) {
+         sendCounts_[r] = 0;
+      }
+      for (k = 0; k < nSlot; ++k) {
+         sendCounts_[slotIds_[k] % nProc_] += entrySize;
+      }
+      sendDispls_[0] = 0;
+      for (r = 1; r < nProc_; ++r) {
+         sendDispls_[r] = sendDispls_[r-1] + sendCounts_[r-1];
+      }
+
+      // Pack entries of molecule index and partial sums, by owner
+      sendBuffer_.resize(nSlot*entrySize);
+      sendSlots_.resize(nSlot);
+      std::vector<int> positions(sendDispls_);
+      for (k = 0; k < nSlot; ++k) {
+         r = slotIds_[k] % nProc_;
+         i = positions[r];
+         sendSlots_[i/entrySize] = k;
+         sendBuffer_[i] = double(slotIds_[k]);
+         ptr = &partials_[k*nValue_];
+         for (j = 0; j < nValue_; ++j) {
+            sendBuffer_[i + 1 + j] = ptr[j];
+         }
+         positions[r] += entrySize;
+      }
+
+      // Exchange counts, then entries, with all processors
+      MPI::Intracomm& communicator = domainPtr_->communicator();
+      communicator.Alltoall(&sendCounts_[0], 1, MPI::INT,
+                            &recvCounts_[0], 1, MPI::INT);
+      recvDispls_[0] = 0;
+      for (r = 1; r < nProc_; ++r) {
+         recvDispls_[r] = recvDispls_[r-1] + recvCounts_[r-1];
+      }
+      int nRecv = recvDispls_[nProc_-1] + recvCounts_[nProc_-1];
+      recvBuffer_.resize(nRecv);
+      double* sendPtr = sendBuffer_.empty() ? 0 : &sendBuffer_[0];
+      double* recvPtr = recvBuffer_.empty() ? 0 : &recvBuffer_[0];
+      communicator.Alltoallv(sendPtr, &sendCounts_[0], &sendDispls_[0],
+                             MPI::DOUBLE,
+                             recvPtr, &recvCounts_[0], &recvDispls_[0],
+                             MPI::DOUBLE);
+
+      // Add received partial sums to totals of owned molecules
+      double* totalPtr;
+      for (i = 0; i < nRecv; i += entrySize) {
+         k = int(recvBuffer_[i]) / nProc_;
+         assert(int(recvBuffer_[i]) % nProc_ == rank_);
+         totalPtr = &totals_[k*nValue_];
+         for (j = 0; j < nValue_; ++j) {
+            totalPtr[j] += recvBuffer_[i + 1 + j];
+         }
+      }
+      #else
+      double* totalPtr;
+      for (k = 0; k < nSlot; ++k) {
+         ptr = &partials_[k*nValue_];
+         totalPtr = &totals_[slotIds_[k]*nValue_];
+         for (j = 0; j < nValue_; ++j) {
+            totalPtr[j] += ptr[j];
+         }
+      }
+      #endif
+
+      isReduced_ = true;
+   }
+
+   /*
+   * Return totals to all processors that contributed partial sums.
+   */
+   void MoleculeReducer::scatter()
+   {
+      if (!isReduced_) {
+         UTIL_THROW("MoleculeReducer::reduce() has not been called");
+      }
+      int i, j, k;
+      double* ptr;
+
+      #ifdef UTIL_MPI
+      // Replace received partial sums by totals, and send them back
+      int entrySize = nValue_ + 1;
+      int nRecv = recvBuffer_.size();
+      const double* totalPtr;
+      for (i = 0; i < nRecv; i += entrySize) {
+         k = int(recvBuffer_[i]) / nProc_;
+         totalPtr = &totals_[k*nValue_];
+         for (j = 0; j < nValue_; ++j) {
+            recvBuffer_[i + 1 + j] = totalPtr[j];
+         }
+      }
+      double* sendPtr = sendBuffer_.empty() ? 0 : &sendBuffer_[0];
+      double* recvPtr = recvBuffer_.empty() ? 0 : &recvBuffer_[0];
+      domainPtr_->communicator().
+         Alltoallv(recvPtr, &recvCounts_[0], &recvDispls_[0], MPI::DOUBLE,
+                   sendPtr, &sendCounts_[0], &sendDispls_[0], MPI::DOUBLE);
+
+      // Copy totals into the slots from which they were sent
+      int nEntry = sendSlots_.size();
+      for (i = 0; i < nEntry; ++i) {
+         ptr = &partials_[sendSlots_[i]*nValue_];
+         for (j = 0; j < nValue_; ++j) {
+            ptr[j] = sendBuffer_[i*entrySize + 1 + j];
+         }
+      }
+      #else
+      int nSlot = slotIds_.size();
+      for (k = 0; k < nSlot; ++k) {
+         ptr = &partials_[k*nValue_];
+         i = slotIds_[k]*nValue_;
+         for (j = 0; j < nValue_; ++j) {
+            ptr[j] = totals_[i + j];
+         }
+      }
+      #endif
+   }
+
+}
@@ -0,0 +1,296 @@
+#ifndef DDMD_MOLECULE_REDUCER_H
+#define DDMD_MOLECULE_REDUCER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/chemistry/Atom.h>               // inline function
+#include <util/containers/DArray.h>            // member template
+#include <util/global.h>
+
+#include <vector>
+#include <map>
+
+namespace DdMd
+{
+
+   class Domain;
+   class AtomStorage;
+
+   using namespace Util;
+
+   /**
+   * Molecular species bookkeeping and distributed sums over molecules.
+   *
+   * A MoleculeReducer uses the AtomContext of each atom to identify its
+   * molecule, and so requires Atom::hasAtomContext(). The setup()
+   * function computes the number of species, the number of molecules of
+   * each species and the number of atoms per molecule of each species,
+   * from the largest species, molecule and atom ids of all atoms. Each
+   * molecule is then given a global index, in order of species and of
+   * molecule id within a species, and is assigned to an owner processor
+   * with rank equal to this index modulo the number of processors.
+   *
+   * Sums of nValue values over the atoms of each molecule are computed
+   * in three steps: After begin(nValue), each processor adds values for
+   * its local atoms to the array returned by values(atom), which holds
+   * partial sums for the molecule of that atom. A collective call to
+   * reduce() then sends each partial sum to the owner of its molecule,
+   * with a single all-to-all exchange, and adds them to the totals for
+   * owned molecules, which are accessed through nOwned(), ownedId()
+   * and total(). Optionally, a collective call to scatter() then returns
+   * each total to every processor that contributed to it, replacing the
+   * partial sums, so that totals may be used in a second loop over local
+   * atoms (e.g., to subtract the center of mass of each molecule).
+   * Only molecules with local atoms are ever sent, and no molecule or
+   * atom data is gathered on one processor.
+   *
+   * \ingroup DdMd_Communicate_Module
+   */
+   class MoleculeReducer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      MoleculeReducer();
+
+      /**
+      * Destructor.
+      */
+      ~MoleculeReducer();
+
+      /**
+      * Create associations with Domain and AtomStorage.
+      *
+      * \param domain  Domain (processor grid)
+      * \param storage AtomStorage (local atoms)
+      */
+      void associate(Domain& domain, AtomStorage& storage);
+
+      /**
+      * Compute species and molecule counts from atom contexts.
+      *
+      * Call on all processors, whenever the set of molecules may have
+      * changed (e.g., after reading a configuration).
+      */
+      void setup();
+
+      /// \name Species bookkeeping
+      //@{
+
+      /**
+      * Number of species.
+      */
+      int nSpecies() const;
+
+      /**
+      * Number of molecules of one species.
+      *
+      * \param speciesId species index
+      */
+      int nMolecule(int speciesId) const;
+
+      /**
+      * Number of atoms per molecule of one species.
+      *
+      * \param speciesId species index
+      */
+      int nAtom(int speciesId) const;
+
+      /**
+      * Total number of molecules of all species.
+      */
+      int nMoleculeTotal() const;
+
+      /**
+      * Global index of the molecule of an atom.
+      *
+      * \param atom local atom, with AtomContext set
+      */
+      int moleculeIndex(const Atom& atom) const;
+
+      /**
+      * Species of a molecule, from its global index.
+      *
+      * \param index global molecule index
+      */
+      int speciesId(int index) const;
+
+      //@}
+      /// \name Distributed sums over molecules
+      //@{
+
+      /**
+      * Discard partial sums and totals, and set the number of values.
+      *
+      * \param nValue number of values summed for each molecule
+      */
+      void begin(int nValue);
+
+      /**
+      * Get the partial sums for the molecule of a local atom.
+      *
+      * Returns a pointer to nValue values, which are zeroed when each
+      * molecule is first accessed after begin(). After scatter(), the
+      * same array instead holds the totals for the molecule. The pointer
+      * is only valid until the next call of values() for a new molecule.
+      *
+      * \param atom local atom, with AtomContext set
+      */
+      double* values(const Atom& atom);
+
+      /**
+      * Send partial sums to owners, and add them (call on all).
+      */
+      void reduce();
+
+      /**
+      * Return totals to all contributing processors (call on all).
+      *
+      * \pre reduce() has been called since begin().
+      */
+      void scatter();
+
+      /**
+      * Number of molecules owned by this processor.
+      */
+      int nOwned() const;
+
+      /**
+      * Global index of an owned molecule.
+      *
+      * \param i index of owned molecule, 0 <= i < nOwned()
+      */
+      int ownedId(int i) const;
+
+      /**
+      * Totals for an owned molecule, after reduce().
+      *
+      * \param i index of owned molecule, 0 <= i < nOwned()
+      */
+      const double* total(int i) const;
+
+      //@}
+
+   private:
+
+      /// Number of molecules of each species.
+      DArray<int> nMolecules_;
+
+      /// Number of atoms per molecule of each species.
+      DArray<int> nAtoms_;
+
+      /// Global index of first molecule of each species (size nSpecies+1).
+      DArray<int> offsets_;
+
+      /// Slot index of each molecule that has a partial sum.
+      std::map<int, int> slots_;
+
+      /// Global molecule index of each slot.
+      std::vector<int> slotIds_;
+
+      /// Partial sums, nValue_ per slot.
+      std::vector<double> partials_;
+
+      /// Totals for owned molecules, nValue_ per owned molecule.
+      std::vector<double> totals_;
+
+      /// Send buffer, entries of molecule index and nValue_ values.
+      std::vector<double> sendBuffer_;
+
+      /// Receive buffer, in the same format as sendBuffer_.
+      std::vector<double> recvBuffer_;
+
+      /// Slot of each entry of sendBuffer_.
+      std::vector<int> sendSlots_;
+
+      /// Number of doubles sent to each processor.
+      std::vector<int> sendCounts_;
+
+      /// Number of doubles received from each processor.
+      std::vector<int> recvCounts_;
+
+      /// Displacements of send blocks.
+      std::vector<int> sendDispls_;
+
+      /// Displacements of receive blocks.
+      std::vector<int> recvDispls_;
+
+      /// Pointer to associated Domain.
+      Domain* domainPtr_;
+
+      /// Pointer to associated AtomStorage.
+      AtomStorage* storagePtr_;
+
+      /// Number of species.
+      int nSpecies_;
+
+      /// Number of values per molecule.
+      int nValue_;
+
+      /// Number of processors.
+      int nProc_;
+
+      /// Rank of this processor.
+      int rank_;
+
+      /// Has reduce() been called since begin()?
+      bool isReduced_;
+
+   };
+
+   // Inline functions
+
+   inline int MoleculeReducer::nSpecies() const
+   {  return nSpecies_; }
+
+   inline int MoleculeReducer::nMolecule(int speciesId) const
+   {  return nMolecules_[speciesId]; }
+
+   inline int MoleculeReducer::nAtom(int speciesId) const
+   {  return nAtoms_[speciesId]; }
+
+   inline int MoleculeReducer::nMoleculeTotal() const
+   {  return offsets_[nSpecies_]; }
+
+   inline int MoleculeReducer::moleculeIndex(const Atom& atom) const
+   {
+      const AtomContext& context = atom.context();
+      return offsets_[context.speciesId] + context.moleculeId;
+   }
+
+   inline int MoleculeReducer::nOwned() const
+   {  return (nMoleculeTotal() - rank_ + nProc_ - 1)/nProc_; }
+
+   inline int MoleculeReducer::ownedId(int i) const
+   {  return i*nProc_ + rank_; }
+
+   inline const double* MoleculeReducer::total(int i) const
+   {  return &totals_[i*nValue_]; }
+
+   /*
+   * Get partial sums for the molecule of a local atom.
+   */
+   inline double* MoleculeReducer::values(const Atom& atom)
+   {
+      int index = moleculeIndex(atom);
+      std::map<int, int>::iterator iter = slots_.find(index);
+      if (iter != slots_.end()) {
+         return &partials_[iter->second*nValue_];
+      }
+      int slot = slotIds_.size();
+      slots_.insert(std::pair<int, int>(index, slot));
+      slotIds_.push_back(index);
+      partials_.resize((slot + 1)*nValue_, 0.0);
+      return &partials_[slot*nValue_];
+   }
+
+}
+#endif
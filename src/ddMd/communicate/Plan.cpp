@@ -13,6 +13,8 @@ namespace DdMd
 
    unsigned int Plan::GMask[3][2] = { {0x0001, 0x0002}, {0x0004, 0x0008}, {0x0010, 0x0020} };
    unsigned int Plan::EMask[3][2] = { {0x0100, 0x0200}, {0x0400, 0x0800}, {0x1000, 0x2000} };
+   unsigned int Plan::IMask[3][2] = { {0x010000, 0x020000}, {0x040000, 0x080000}, {0x100000, 0x200000} };
+   unsigned int Plan::BMask[3][2] = { {0x01000000, 0x02000000}, {0x04000000, 0x08000000}, {0x10000000, 0x20000000} };
 
    using namespace Util;
 
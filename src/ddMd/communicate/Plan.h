@@ -36,7 +36,22 @@ namespace DdMd
    * must be sent as ghosts when the Group is divided among two
    * or more processors. 
    *
-   * Implementation: These 12 flags are stored in different bits 
+   * A ghost atom also has an image flag for each direction i, j in
+   * which it has been received as a ghost. These flags are set by the
+   * Exchanger and travel with the plan when a ghost is forwarded, so
+   * that they identify the neighboring domain that owns a ghost. They
+   * are used by the half-shell communication scheme to decide which
+   * processor computes each pair interaction (see isHalfShellPair()).
+   *
+   * An atom also has a group ghost flag for each direction, which is
+   * set for atoms that must be sent as ghosts only because they belong
+   * to a group that is divided among processors. Group ghost flags are
+   * kept separate from the (geometric) ghost flags so that a ghost is
+   * forwarded to later directions only within the class of ghost with
+   * which it was received (see pruneGhosts()). An atom is in the send
+   * array for direction i, j iff hasGhost(i, j) is true.
+   *
+   * Implementation: These 24 flags are stored in different bits
    * of a single unsigned int that can also be accessed or set 
    * directly.
    *
@@ -92,6 +107,40 @@ namespace DdMd
       void clearGhost(int i, int j)
       {  flags_ &= (~GMask[i][j]); }
 
+      /**
+      * Set group ghost flag for direction i, j (set true).
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      void setGroupGhost(int i, int j)
+      {  flags_ |= BMask[i][j]; }
+
+      /**
+      * Clear group ghost flag for direction i, j (set false).
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      void clearGroupGhost(int i, int j)
+      {  flags_ &= (~BMask[i][j]); }
+
+      /**
+      * Restrict the flags of a ghost received in direction i, j.
+      *
+      * Clears all ghost flags if ghost(i, j) is false, and all group
+      * ghost flags if groupGhost(i, j) is false, so that the ghost is
+      * forwarded only along paths of a single class.
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      void pruneGhosts(int i, int j)
+      {
+         if (!(flags_ & GMask[i][j])) flags_ &= (~GhostMask);
+         if (!(flags_ & BMask[i][j])) flags_ &= (~GroupGhostMask);
+      }
+
       /**
       * Set all flags (contains all bits).
       */
@@ -112,6 +161,12 @@ namespace DdMd
       */
       bool exchange(int i, int j) const
       {  return bool(flags_ & EMask[i][j]); }
+
+      /**
+      * Is the exchange flag set for any direction?
+      */
+      bool hasExchange() const
+      {  return bool(flags_ & ExchangeMask); }
  
       /**
       * Get ghost flag for direction i, j.
@@ -121,6 +176,24 @@ namespace DdMd
       */
       bool ghost(int i, int j) const
       {  return bool(flags_ & GMask[i][j]); }
+
+      /**
+      * Get group ghost flag for direction i, j.
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      bool groupGhost(int i, int j) const
+      {  return bool(flags_ & BMask[i][j]); }
+
+      /**
+      * Is the ghost or group ghost flag set for direction i, j?
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      bool hasGhost(int i, int j) const
+      {  return bool(flags_ & (GMask[i][j] | BMask[i][j])); }
  
       /**
       * Return raw flags unsigned int.
@@ -128,6 +201,46 @@ namespace DdMd
       unsigned int flags() const
       {  return flags_; }
 
+      /**
+      * Set image flag for direction i, j (ghost was received i, j).
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      void setImage(int i, int j)
+      {  flags_ |= IMask[i][j]; }
+
+      /**
+      * Get image flag for direction i, j.
+      *
+      * \param i Cartesian axis index i=0,1,2=x,y,z
+      * \param j binary direction index j=0 (up) 1 (down)
+      */
+      bool image(int i, int j) const
+      {  return bool(flags_ & IMask[i][j]); }
+
+      /**
+      * Is a pair computed on this processor in the half-shell scheme?
+      *
+      * In the half-shell scheme, nonbonded ghosts are sent only in
+      * directions j=0, and so are received only from domains with higher
+      * grid coordinates. A pair is computed by the processor whose grid
+      * coordinates are the minima of those of the owners of the two
+      * atoms. This is true on this processor iff neither atom has an
+      * image flag with j=1, and the atoms share no image flag with j=0.
+      * Local atoms have no image flags, and so pairs of local atoms and
+      * pairs of a local atom and a ghost received with j=0 are always
+      * computed.
+      *
+      * \param a plan of first atom
+      * \param b plan of second atom
+      */
+      static bool isHalfShellPair(const Plan& a, const Plan& b)
+      {
+         return !(((a.flags_ | b.flags_) & LowerImageMask)
+                  | (a.flags_ & b.flags_ & UpperImageMask));
+      }
+
    private:
 
       unsigned int flags_;
@@ -137,6 +250,27 @@ namespace DdMd
 
       /// Matrix of bit masks for ghost flags.
       static unsigned int GMask[3][2];
+
+      /// Matrix of bit masks for image flags.
+      static unsigned int IMask[3][2];
+
+      /// Matrix of bit masks for group ghost flags.
+      static unsigned int BMask[3][2];
+
+      /// Union of all ghost flags.
+      static const unsigned int GhostMask = 0x3F;
+
+      /// Union of all group ghost flags.
+      static const unsigned int GroupGhostMask = 0x3F000000;
+
+      /// Union of all exchange flags.
+      static const unsigned int ExchangeMask = 0x3F00;
+
+      /// Union of all image flags for directions j=0 (up).
+      static const unsigned int UpperImageMask = 0x150000;
+
+      /// Union of all image flags for directions j=1 (down).
+      static const unsigned int LowerImageMask = 0x2A0000;
   
    //friends:
 
@@ -4,6 +4,7 @@ ddMd_communicate_=\
     ddMd/communicate/AtomDistributor.cpp \
     ddMd/communicate/Exchanger.cpp \
     ddMd/communicate/AtomCollector.cpp \
+    ddMd/communicate/MoleculeReducer.cpp \
     ddMd/communicate/Plan.cpp 
 
 ddMd_communicate_SRCS=\
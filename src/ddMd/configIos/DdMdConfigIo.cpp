@@ -169,7 +169,11 @@ namespace DdMd
             }
             file >> r;
             boundary().transformCartToGen(r, atomPtr->position());
-            file >> atomPtr->velocity();
+            if (Atom::hasVelocity()) {
+               file >> atomPtr->velocity();
+            } else {
+               file >> r;
+            }
 
             // Add atom to list for sending.
             atomDistributor().addAtom();
@@ -296,8 +300,12 @@ namespace DdMd
                     << Int(atomPtr->context().moleculeId, 10)
                     << Int(atomPtr->context().atomId, 6);
             }
-            file << "\n" << r 
-                 << "\n" << atomPtr->velocity() << "\n";
+            file << "\n" << r << "\n";
+            if (Atom::hasVelocity()) {
+               file << atomPtr->velocity() << "\n";
+            } else {
+               file << Vector::Zero << "\n";
+            }
             atomPtr = atomCollector().nextPtr();
          }
 
@@ -11,6 +11,8 @@
 #include <ddMd/communicate/Domain.h>   
 
 #include <ddMd/storage/AtomStorage.h>               
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/storage/GroupIterator.h>
 #ifdef SIMP_BOND
 #include <ddMd/storage/BondStorage.h>               
 #endif
@@ -33,11 +35,28 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <algorithm>
+
 namespace DdMd
 {
 
    using namespace Util;
 
+   namespace
+   {
+
+      /*
+      * Comparison of pointers to atoms or groups by global id.
+      */
+      template <typename T>
+      struct IdLess
+      {
+         bool operator() (const T* a, const T* b) const
+         {  return a->id() < b->id(); }
+      };
+
+   }
+
    /*
    * Constructor.
    */
@@ -172,7 +191,11 @@ namespace DdMd
   
             file >> r;
             boundary().transformCartToGen(r, atomPtr->position());
-            file >> atomPtr->velocity();
+            if (Atom::hasVelocity()) {
+               file >> atomPtr->velocity();
+            } else {
+               file >> r;
+            }
 
             // Add atom to list for sending.
             atomDistributor().addAtom();
@@ -226,6 +249,42 @@ namespace DdMd
 
    }
 
+   /*
+   * Gather packed data for one block of ids on the master.
+   */
+   void DdMdOrderedConfigIo::gatherBlock(std::vector<double>& send,
+                                         std::vector<double>& recv)
+   {
+      #ifdef UTIL_MPI
+      MPI::Intracomm& communicator = domain().communicator();
+      int nProc = communicator.Get_size();
+      bool isMaster = domain().isMaster();
+      std::vector<int> counts;
+      std::vector<int> displs;
+      if (isMaster) {
+         counts.resize(nProc);
+         displs.resize(nProc);
+      }
+      int sendCount = send.size();
+      communicator.Gather(&sendCount, 1, MPI::INT,
+                          isMaster ? &counts[0] : 0, 1, MPI::INT, 0);
+      int total = 0;
+      if (isMaster) {
+         for (int p = 0; p < nProc; ++p) {
+            displs[p] = total;
+            total += counts[p];
+         }
+         recv.resize(total);
+      }
+      communicator.Gatherv(sendCount ? &send[0] : 0, sendCount, MPI::DOUBLE,
+                           (isMaster && total) ? &recv[0] : 0,
+                           isMaster ? &counts[0] : 0,
+                           isMaster ? &displs[0] : 0, MPI::DOUBLE, 0);
+      #else
+      recv = send;
+      #endif
+   }
+
    /*
    * Private method to write Group<N> objects.
    */
@@ -233,47 +292,102 @@ namespace DdMd
    int DdMdOrderedConfigIo::writeGroups(std::ofstream& file, 
                   const char* sectionLabel,
                   const char* nGroupLabel,
-                  GroupStorage<N>& storage,
-                  GroupCollector<N>& collector) 
+                  GroupStorage<N>& storage)
    {
-      Group<N>* groupPtr;
-      int       nGroup;
       storage.computeNTotal(domain().communicator());
-      nGroup = storage.nTotal();
+      int nGroup = 0;
       if (domain().isMaster()) {  
+         nGroup = storage.nTotal();
          file << std::endl;
          file << sectionLabel << std::endl;
          file << nGroupLabel << Int(nGroup, 10) << std::endl;
+      }
+      #ifdef UTIL_MPI
+      domain().communicator().Bcast(&nGroup, 1, MPI::INT, 0);
+      #endif
 
-         IoGroup<N> ioGroup;
-         std::vector<IoGroup <N> > groups;
-         groups.reserve(nGroup);
-         groups.clear();
-         groups.insert(groups.end(), nGroup, ioGroup);
-
-         collector.setup();
-         groupPtr = collector.nextPtr();
-         int id;
-         int n = 0;
-         while (groupPtr) {
-            id = groupPtr->id();
-            groups[id].id = id;
-            groups[id].group = *groupPtr;
-            groupPtr = collector.nextPtr();
-            ++n;
+      // Sort local groups owned by this processor (i.e., with a local
+      // first atom) by group id.
+      std::vector< Group<N>* > localGroups;
+      localGroups.reserve(storage.size());
+      GroupIterator<N> iter;
+      Atom* atomPtr;
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         atomPtr = iter->atomPtr(0);
+         if (atomPtr) {
+            if (!atomPtr->isGhost()) {
+               localGroups.push_back(iter.get());
+            }
          }
-         if (n != nGroup) {
-            UTIL_THROW("Something is rotten in Denmark");
+      }
+      std::sort(localGroups.begin(), localGroups.end(),
+                IdLess< Group<N> >());
+
+      // Gather and write blocks of consecutive group ids
+      const int nField = N + 2;
+      int nLocal = localGroups.size();
+      int blockSize = (nGroup < BlockSize) ? nGroup : BlockSize;
+      std::vector< IoGroup<N> > groups;
+      if (domain().isMaster()) {
+         groups.resize(blockSize);
+      }
+      std::vector<double> send;
+      std::vector<double> recv;
+      Group<N>* groupPtr;
+      const double* data;
+      int cursor = 0;
+      int begin, end, n, i, j, k;
+      for (begin = 0; begin < nGroup; begin += blockSize) {
+         end = begin + blockSize;
+         if (end > nGroup) end = nGroup;
+
+         // Pack local groups with ids in [begin, end)
+         send.clear();
+         while (cursor < nLocal && localGroups[cursor]->id() < end) {
+            groupPtr = localGroups[cursor];
+            send.push_back(double(groupPtr->id()));
+            send.push_back(double(groupPtr->typeId()));
+            for (k = 0; k < N; ++k) {
+               send.push_back(double(groupPtr->atomId(k)));
+            }
+            ++cursor;
          }
-         for (id = 0; id < nGroup; ++id) {
-            if (id != groups[id].id) {
+         gatherBlock(send, recv);
+
+         if (domain().isMaster()) {
+            n = recv.size()/nField;
+            if (n != end - begin) {
                UTIL_THROW("Something is rotten in Denmark");
             }
-            file << groups[id].group << std::endl;
+            for (j = 0; j < n; ++j) {
+               groups[j].id = -1;
+            }
+            for (i = 0; i < n; ++i) {
+               data = &recv[i*nField];
+               j = int(data[0]) - begin;
+               if (j < 0 || j >= n) {
+                  UTIL_THROW("Something is rotten in Denmark");
+               }
+               groups[j].id = int(data[0]);
+               groups[j].group.setId(int(data[0]));
+               groups[j].group.setTypeId(int(data[1]));
+               for (k = 0; k < N; ++k) {
+                  groups[j].group.setAtomId(k, int(data[2 + k]));
+               }
+            }
+            for (j = 0; j < n; ++j) {
+               if (groups[j].id != begin + j) {
+                  UTIL_THROW("Something is rotten in Denmark");
+               }
+               file << groups[j].group << std::endl;
+            }
          }
+      }
+      if (cursor != nLocal) {
+         UTIL_THROW("Group id out of range");
+      }
+      if (domain().isMaster()) {
          file << std::endl;
-      } else { 
-         collector.send();
       }
       return nGroup;
    }
@@ -300,80 +414,141 @@ namespace DdMd
 
       // Atoms
       atomStorage().computeNAtomTotal(domain().communicator());
+      int nAtom = 0;
       if (domain().isMaster()) { 
-         int nAtom = atomStorage().nAtomTotal();
-         atomCollector().setup();
-
+         nAtom = atomStorage().nAtomTotal();
          file << "ATOMS" << std::endl;
          file << "nAtom" << Int(nAtom, 10) << std::endl;
+      }
+      #ifdef UTIL_MPI
+      domain().communicator().Bcast(&nAtom, 1, MPI::INT, 0);
+      #endif
 
-         // Set up array of nAtom default-constructed elements.
-         IoAtom atom;
-         atoms_.reserve(nAtom);
-         atoms_.clear();
-         atoms_.insert(atoms_.end(), nAtom, atom);
+      // Sort local atoms by id
+      std::vector<Atom*> localAtoms;
+      localAtoms.reserve(atomStorage().nAtom());
+      AtomIterator iter;
+      for (atomStorage().begin(iter); iter.notEnd(); ++iter) {
+         localAtoms.push_back(iter.get());
+      }
+      std::sort(localAtoms.begin(), localAtoms.end(), IdLess<Atom>());
 
-         // Collect unordered atoms and store in order in atoms_ .
-         Vector r;
-         int id;
-         int n = 0;
-         bool isCartesian = atomStorage().isCartesian();
-         Atom* atomPtr = atomCollector().nextPtr();
-         while (atomPtr) {
-            id = atomPtr->id();
+      // Gather and write blocks of consecutive atom ids
+      const int nField = hasMolecules_ ? 11 : 8;
+      int nLocal = localAtoms.size();
+      int blockSize = (nAtom < BlockSize) ? nAtom : BlockSize;
+      if (domain().isMaster()) {
+         atoms_.clear();
+         atoms_.resize(blockSize);
+      }
+      bool isCartesian = atomStorage().isCartesian();
+      std::vector<double> send;
+      std::vector<double> recv;
+      Vector r;
+      Atom* atomPtr;
+      const double* data;
+      int cursor = 0;
+      int begin, end, n, i, j, k, id;
+      for (begin = 0; begin < nAtom; begin += blockSize) {
+         end = begin + blockSize;
+         if (end > nAtom) end = nAtom;
+
+         // Pack local atoms with ids in [begin, end)
+         send.clear();
+         while (cursor < nLocal && localAtoms[cursor]->id() < end) {
+            atomPtr = localAtoms[cursor];
             if (isCartesian) {
                r = atomPtr->position();
             } else {
                boundary().transformGenToCart(atomPtr->position(), r);
             }
-            atoms_[id].position = r;
-            atoms_[id].velocity = atomPtr->velocity();
-            atoms_[id].typeId = atomPtr->typeId();
-            atoms_[id].id = id;
+            send.push_back(double(atomPtr->id()));
+            send.push_back(double(atomPtr->typeId()));
+            for (k = 0; k < Dimension; ++k) {
+               send.push_back(r[k]);
+            }
+            for (k = 0; k < Dimension; ++k) {
+               if (Atom::hasVelocity()) {
+                  send.push_back(atomPtr->velocity()[k]);
+               } else {
+                  send.push_back(0.0);
+               }
+            }
             if (hasMolecules_) {
-               atoms_[id].context = atomPtr->context();
+               send.push_back(double(atomPtr->context().speciesId));
+               send.push_back(double(atomPtr->context().moleculeId));
+               send.push_back(double(atomPtr->context().atomId));
             }
-            atomPtr = atomCollector().nextPtr();
-            ++n;
-         } 
-         if (n != nAtom) {
-            UTIL_THROW("Something is rotten in Denmark");
+            ++cursor;
          }
+         gatherBlock(send, recv);
+
+         if (domain().isMaster()) {
 
-         // Iterate through atoms_ array to write atoms data.
-         for (id = 0; id < nAtom; ++id) {
-            if (id != atoms_[id].id) {
+            // Store atoms of block in order
+            n = recv.size()/nField;
+            if (n != end - begin) {
                UTIL_THROW("Something is rotten in Denmark");
             }
-            file << Int(id, 10) << Int(atoms_[id].typeId, 6);
-            if (hasMolecules_) {
-               file << Int(atoms_[id].context.speciesId, 6)
-                    << Int(atoms_[id].context.moleculeId, 6)
-                    << Int(atoms_[id].context.atomId, 6);
+            for (j = 0; j < n; ++j) {
+               atoms_[j].id = -1;
+            }
+            for (i = 0; i < n; ++i) {
+               data = &recv[i*nField];
+               j = int(data[0]) - begin;
+               if (j < 0 || j >= n) {
+                  UTIL_THROW("Something is rotten in Denmark");
+               }
+               IoAtom& atom = atoms_[j];
+               atom.id = int(data[0]);
+               atom.typeId = int(data[1]);
+               for (k = 0; k < Dimension; ++k) {
+                  atom.position[k] = data[2 + k];
+                  atom.velocity[k] = data[5 + k];
+               }
+               if (hasMolecules_) {
+                  atom.context.speciesId = int(data[8]);
+                  atom.context.moleculeId = int(data[9]);
+                  atom.context.atomId = int(data[10]);
+               }
             }
-            file << "\n" << atoms_[id].position 
-                 << "\n" << atoms_[id].velocity 
-                 << "\n";
-         }
 
-      } else { 
-         atomCollector().send();
+            // Write atoms of block
+            for (j = 0; j < n; ++j) {
+               id = begin + j;
+               if (id != atoms_[j].id) {
+                  UTIL_THROW("Something is rotten in Denmark");
+               }
+               file << Int(id, 10) << Int(atoms_[j].typeId, 6);
+               if (hasMolecules_) {
+                  file << Int(atoms_[j].context.speciesId, 6)
+                       << Int(atoms_[j].context.moleculeId, 6)
+                       << Int(atoms_[j].context.atomId, 6);
+               }
+               file << "\n" << atoms_[j].position
+                    << "\n" << atoms_[j].velocity
+                    << "\n";
+            }
+         }
+      }
+      if (cursor != nLocal) {
+         UTIL_THROW("Atom id out of range");
       }
 
       // Write the groups
       #ifdef SIMP_BOND
       if (bondStorage().capacity()) {
-         writeGroups<2>(file, "BONDS", "nBond", bondStorage(), bondCollector());
+         writeGroups<2>(file, "BONDS", "nBond", bondStorage());
       }
       #endif
       #ifdef SIMP_ANGLE
       if (angleStorage().capacity()) {
-         writeGroups<3>(file, "ANGLES", "nAngle", angleStorage(), angleCollector());
+         writeGroups<3>(file, "ANGLES", "nAngle", angleStorage());
       }
       #endif
       #ifdef SIMP_DIHEDRAL
       if (dihedralStorage().capacity()) {
-         writeGroups<4>(file, "DIHEDRALS", "nDihedral", dihedralStorage(), dihedralCollector());
+         writeGroups<4>(file, "DIHEDRALS", "nDihedral", dihedralStorage());
       }
       #endif
 
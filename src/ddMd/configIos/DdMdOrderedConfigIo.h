@@ -27,6 +27,12 @@ namespace DdMd
    * configuration file format for ddSim, like DdMdConfigIo, but 
    * that outputs atoms in sequential order, sorted by atom id.
    *
+   * Output does not require storage of all atoms on the master. Each
+   * processor sorts its own atoms and groups by id, and the ranges of
+   * ids [k*BlockSize, (k+1)*BlockSize) are then gathered to the master
+   * and written one block at a time. The master thus stores at most
+   * BlockSize atoms or groups, at the cost of one gather per block.
+   *
    * \ingroup DdMd_ConfigIo_Module
    */
    class DdMdOrderedConfigIo  : public ConfigIo
@@ -69,9 +75,10 @@ namespace DdMd
       /**
       * Write configuration file.
       *
-      * This routine opens and writes a file on the master, collecting
-      * atom and group data from all processors. Atoms and Groups are
-      * output in order, sorted by global id.
+      * This routine writes a file on the master, gathering atom and
+      * group data from all processors in blocks of consecutive ids.
+      * Atoms and Groups are output in order, sorted by global id. Must
+      * be called on all processors.
       *
       * \param file output file stream
       */
@@ -79,6 +86,11 @@ namespace DdMd
    
    private:
 
+      /**
+      * Maximum number of atoms or groups per gathered block of ids.
+      */
+      enum { BlockSize = 262144 };
+
       /*
       * Struct for atom data required in file format.  
       */
@@ -109,7 +121,7 @@ namespace DdMd
       };
 
       /**
-      * Array of atoms, ordered by global index.
+      * Array of atoms of one block, ordered by global index.
       */
       std::vector<IoAtom> atoms_;
 
@@ -129,14 +141,24 @@ namespace DdMd
                       GroupDistributor<N>& distributor);
 
       /**
-      * Write Group<N> objects to file. 
+      * Write Group<N> objects to file, in blocks of consecutive ids.
       *
       * Call on all processors.
       */
       template <int N>
       int writeGroups(std::ofstream& file, 
                       const char* sectionLabel, const char* nGroupLabel,
-                      GroupStorage<N>& storage, GroupCollector<N>& collector);
+                      GroupStorage<N>& storage);
+
+      /**
+      * Gather data of all processors for one block on the master.
+      *
+      * Call on all processors.
+      *
+      * \param send  packed local data for the block
+      * \param recv  packed data of all processors, in rank order (master)
+      */
+      void gatherBlock(std::vector<double>& send, std::vector<double>& recv);
    
    };
 
@@ -0,0 +1,827 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DistributedConfigIo.h"
+
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/AtomDistributor.h>
+#include <ddMd/communicate/GroupDistributor.tpp>
+
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/storage/GroupStorage.tpp>
+#include <ddMd/storage/GroupIterator.h>
+#ifdef SIMP_BOND
+#include <ddMd/storage/BondStorage.h>
+#endif
+#ifdef SIMP_ANGLE
+#include <ddMd/storage/AngleStorage.h>
+#endif
+#ifdef SIMP_DIHEDRAL
+#include <ddMd/storage/DihedralStorage.h>
+#endif
+
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/chemistry/Group.h>
+#include <ddMd/chemistry/MaskPolicy.h>
+#include <util/space/Vector.h>
+#include <util/containers/DArray.h>
+#include <util/param/Label.h>
+#include <util/mpi/MpiSendRecv.h>
+#include <util/misc/ioUtil.h>
+#include <util/misc/FileMaster.h>
+#include <util/global.h>
+
+#include <fstream>
+#include <cstring>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   namespace {
+
+      // Identifier and version of the binary rank file format.
+      const char RankFileMagic[8] = {'D', 'D', 'M', 'D', 'R', 'A', 'N', 'K'};
+      const int RankFileVersion = 1;
+
+      // Section tags (the tag of a section of Group<N> is 2 + N).
+      const int AtomIntSection = 1;
+      const int AtomRealSection = 2;
+
+      /*
+      * Adler-32 checksum of a block of bytes.
+      */
+      unsigned int checksum(const char* data, long nByte)
+      {
+         const unsigned int mod = 65521;
+         unsigned int a = 1;
+         unsigned int b = 0;
+         long i = 0;
+         long j;
+         while (i < nByte) {
+            // Process blocks short enough that a and b cannot overflow
+            j = i + 5552;
+            if (j > nByte) j = nByte;
+            for ( ; i < j; ++i) {
+               a += (unsigned char) data[i];
+               b += a;
+            }
+            a %= mod;
+            b %= mod;
+         }
+         return (b << 16) | a;
+      }
+
+   }
+
+   /*
+   * Constructor.
+   */
+   DistributedConfigIo::DistributedConfigIo(Simulation& simulation)
+    : ConfigIo(simulation),
+      simulationPtr_(&simulation),
+      ints_(),
+      reals_(),
+      isRestart_(false)
+   {  setClassName("DistributedConfigIo"); }
+
+   /*
+   * Return name of the binary file for a processor rank (private).
+   */
+   std::string DistributedConfigIo::rankFileName(const std::string& filename,
+                                                 int rank)
+   {  return filename + "." + toString(rank); }
+
+   /*
+   * Open a file for reading, as a configuration or restart file.
+   *
+   * Returns false, rather than throwing, if the file cannot be opened.
+   */
+   bool DistributedConfigIo::openInput(const std::string& name,
+                                       std::ifstream& file,
+                                       std::ios_base::openmode mode)
+   {
+      FileMaster& fileMaster = simulationPtr_->fileMaster();
+      try {
+         if (isRestart_) {
+            fileMaster.openRestartIFile(name, file, mode);
+         } else {
+            fileMaster.openInputFile(name, file, mode);
+         }
+      } catch (Exception&) {
+         return false;
+      }
+      return file.is_open() && !file.fail();
+   }
+
+   /*
+   * Open a file for writing, as a configuration or restart file.
+   *
+   * Returns false, rather than throwing, if the file cannot be opened.
+   */
+   bool DistributedConfigIo::openOutput(const std::string& name,
+                                        std::ofstream& file,
+                                        std::ios_base::openmode mode)
+   {
+      FileMaster& fileMaster = simulationPtr_->fileMaster();
+      try {
+         if (isRestart_) {
+            fileMaster.openRestartOFile(name, file, mode);
+         } else {
+            fileMaster.openOutputFile(name, file, mode);
+         }
+      } catch (Exception&) {
+         return false;
+      }
+      return file.is_open() && !file.fail();
+   }
+
+   /*
+   * Throw on all processors if a file failed to open on any of them.
+   */
+   void DistributedConfigIo::checkOpen(bool isOpen, const std::string& name)
+   {
+      int ok = isOpen ? 1 : 0;
+      int allOk;
+      domain().communicator().Allreduce(&ok, &allOk, 1, MPI::INT, MPI::MIN);
+      if (!allOk) {
+         Log::file() << "Distributed configuration: " << name << std::endl;
+         UTIL_THROW("Failed to open a distributed configuration file");
+      }
+   }
+
+   /*
+   * Write header of a rank file.
+   */
+   void DistributedConfigIo::writeHeader(std::ostream& file)
+   {
+      int header[2];
+      header[0] = RankFileVersion;
+      header[1] = Atom::hasAtomContext() ? 1 : 0;
+      file.write(RankFileMagic, sizeof(RankFileMagic));
+      file.write((const char*) header, sizeof(header));
+   }
+
+   /*
+   * Read and validate header of a rank file.
+   */
+   void DistributedConfigIo::readHeader(std::istream& file)
+   {
+      char magic[sizeof(RankFileMagic)];
+      int header[2];
+      file.read(magic, sizeof(magic));
+      file.read((char*) header, sizeof(header));
+      if (file.fail()) {
+         UTIL_THROW("Error reading rank file header");
+      }
+      if (memcmp(magic, RankFileMagic, sizeof(magic)) != 0) {
+         UTIL_THROW("Rank file is not a distributed configuration");
+      }
+      if (header[0] != RankFileVersion) {
+         UTIL_THROW("Unsupported rank file format version");
+      }
+      if (header[1] != (Atom::hasAtomContext() ? 1 : 0)) {
+         UTIL_THROW("Inconsistent hasAtomContext in rank file");
+      }
+   }
+
+   /*
+   * Write an array as a section, with one write for the data.
+   */
+   template <typename T>
+   void DistributedConfigIo::writeSection(std::ostream& file, int tag,
+                                          const std::vector<T>& data)
+   {
+      long nByte = data.size()*sizeof(T);
+      const char* ptr = nByte ? (const char*) &data[0] : 0;
+      unsigned int sum = checksum(ptr, nByte);
+      file.write((const char*) &tag, sizeof(int));
+      file.write((const char*) &nByte, sizeof(long));
+      file.write((const char*) &sum, sizeof(unsigned int));
+      if (nByte) {
+         file.write(ptr, nByte);
+      }
+      if (file.fail()) {
+         UTIL_THROW("Error writing rank file section");
+      }
+   }
+
+   /*
+   * Read and validate a section, with one read for the data.
+   */
+   template <typename T>
+   void DistributedConfigIo::readSection(std::istream& file, int tag,
+                                         std::vector<T>& data)
+   {
+      int fileTag;
+      long nByte;
+      unsigned int sum;
+      file.read((char*) &fileTag, sizeof(int));
+      file.read((char*) &nByte, sizeof(long));
+      file.read((char*) &sum, sizeof(unsigned int));
+      if (file.fail()) {
+         UTIL_THROW("Error reading rank file section header");
+      }
+      if (fileTag != tag) {
+         UTIL_THROW("Unexpected section in rank file");
+      }
+      if (nByte < 0 || nByte % sizeof(T) != 0) {
+         UTIL_THROW("Invalid section size in rank file");
+      }
+      data.resize(nByte/sizeof(T));
+      char* ptr = nByte ? (char*) &data[0] : 0;
+      if (nByte) {
+         file.read(ptr, nByte);
+         if (file.fail()) {
+            UTIL_THROW("Error reading rank file section");
+         }
+      }
+      if (checksum(ptr, nByte) != sum) {
+         UTIL_THROW("Checksum error in rank file section");
+      }
+   }
+
+   /*
+   * Private method to read atoms from a rank file.
+   *
+   * If isStaged, atoms are added for later redistribution, and may
+   * belong to any domain. Otherwise, atoms must lie in this domain.
+   */
+   int DistributedConfigIo::readAtoms(std::istream& file, bool isStaged)
+   {
+      readSection(file, AtomIntSection, ints_);
+      readSection(file, AtomRealSection, reals_);
+
+      const int nInt = Atom::hasAtomContext() ? 6 : 3;
+      int nAtomLocal = ints_.size()/nInt;
+      if ((int)ints_.size() != nAtomLocal*nInt
+          || (int)reals_.size() != 2*Dimension*nAtomLocal) {
+         UTIL_THROW("Inconsistent atom sections in rank file");
+      }
+
+      int totalAtomCapacity = atomStorage().totalAtomCapacity();
+      Vector r;
+      Atom* atomPtr;
+      AtomContext* contextPtr;
+      const int* ip;
+      const double* rp;
+      int i, j, id, typeId;
+      for (i = 0; i < nAtomLocal; ++i) {
+         ip = &ints_[i*nInt];
+         rp = &reals_[i*2*Dimension];
+         atomPtr = atomDistributor().newLocalAtomPtr();
+         id = ip[0];
+         typeId = ip[1];
+         if (id < 0 || id >= totalAtomCapacity) {
+            UTIL_THROW("Invalid atom id");
+         }
+         if (typeId < 0) {
+            UTIL_THROW("Negative atom type id");
+         }
+         atomPtr->setId(id);
+         atomPtr->setTypeId(typeId);
+         atomPtr->groups() = (unsigned int) ip[2];
+         if (Atom::hasAtomContext()) {
+            contextPtr = &atomPtr->context();
+            contextPtr->speciesId = ip[3];
+            contextPtr->moleculeId = ip[4];
+            contextPtr->atomId = ip[5];
+         }
+         for (j = 0; j < Dimension; ++j) {
+            r[j] = rp[j];
+         }
+         if (Atom::hasVelocity()) {
+            for (j = 0; j < Dimension; ++j) {
+               atomPtr->velocity()[j] = rp[Dimension + j];
+            }
+         }
+         boundary().transformCartToGen(r, atomPtr->position());
+         if (isStaged) {
+            atomDistributor().addStagedAtom();
+         } else {
+            atomDistributor().addLocalAtom();
+         }
+      }
+      return nAtomLocal;
+   }
+
+   /*
+   * Private method to read Group<N> objects for later redistribution.
+   *
+   * Must be called after reading the atoms of the same rank file, and
+   * before these atoms are redistributed. Each group is queued for the
+   * future owner of each of its atoms that is present on this processor.
+   * Every owner of an atom of the group thus receives a copy, because
+   * every rank file that contains one of its atoms also contains the group.
+   */
+   template <int N>
+   int DistributedConfigIo::stageGroups(std::istream& file,
+                                        GroupDistributor<N>& distributor)
+   {
+      readSection(file, 2 + N, ints_);
+      int nGroup = ints_.size()/(N + 2);
+      if ((int)ints_.size() != nGroup*(N + 2)) {
+         UTIL_THROW("Inconsistent group section in rank file");
+      }
+
+      Group<N> group;
+      Atom* atomPtr;
+      const int* ip;
+      int ranks[N];
+      int nRank, rank, i, j, k;
+      bool isNew;
+      for (i = 0; i < nGroup; ++i) {
+         ip = &ints_[i*(N + 2)];
+         group.setId(ip[0]);
+         group.setTypeId(ip[1]);
+         for (j = 0; j < N; ++j) {
+            group.setAtomId(j, ip[2 + j]);
+         }
+         nRank = 0;
+         for (j = 0; j < N; ++j) {
+            atomPtr = atomStorage().map().find(group.atomId(j));
+            if (atomPtr) {
+               rank = domain().ownerRank(atomPtr->position());
+               isNew = true;
+               for (k = 0; k < nRank; ++k) {
+                  if (ranks[k] == rank) isNew = false;
+               }
+               if (isNew) {
+                  ranks[nRank] = rank;
+                  ++nRank;
+                  distributor.addStaged(group, rank);
+               }
+            }
+         }
+         if (nRank == 0) {
+            UTIL_THROW("Group in rank file contains no atoms");
+         }
+      }
+      return nGroup;
+   }
+
+   /*
+   * Private method to load Group<N> objects from a rank file.
+   */
+   template <int N>
+   int DistributedConfigIo::loadGroups(std::istream& file,
+                                       GroupStorage<N>& storage)
+   {
+      readSection(file, 2 + N, ints_);
+      int nGroup = ints_.size()/(N + 2);
+      if ((int)ints_.size() != nGroup*(N + 2)) {
+         UTIL_THROW("Inconsistent group section in rank file");
+      }
+
+      Group<N>* groupPtr;
+      const int* ip;
+      int nAtom, i, j;
+      for (i = 0; i < nGroup; ++i) {
+         ip = &ints_[i*(N + 2)];
+         groupPtr = storage.newPtr();
+         groupPtr->setId(ip[0]);
+         groupPtr->setTypeId(ip[1]);
+         for (j = 0; j < N; ++j) {
+            groupPtr->setAtomId(j, ip[2 + j]);
+         }
+         nAtom = atomStorage().map().findGroupLocalAtoms(*groupPtr);
+         if (nAtom > 0) {
+            storage.add();
+         } else {
+            UTIL_THROW("Group in rank file contains no local atoms");
+         }
+      }
+      storage.unsetNTotal();
+      storage.computeNTotal(domain().communicator());
+      storage.isValid(atomStorage(), domain().communicator(), false);
+      return nGroup;
+   }
+
+   /*
+   * Private method to save Group<N> objects to a rank file.
+   *
+   * Every group that contains a local atom is written, so that groups
+   * that span domain boundaries appear in more than one rank file.
+   */
+   template <int N>
+   int DistributedConfigIo::saveGroups(std::ostream& file,
+                                       GroupStorage<N>& storage)
+   {
+      GroupIterator<N> iter;
+      Atom* atomPtr;
+      int nGroup = 0;
+      int k;
+      bool hasLocal;
+
+      ints_.clear();
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         hasLocal = false;
+         for (k = 0; k < N; ++k) {
+            atomPtr = iter->atomPtr(k);
+            if (atomPtr) {
+               if (!atomPtr->isGhost()) hasLocal = true;
+            }
+         }
+         if (hasLocal) {
+            ints_.push_back(iter->id());
+            ints_.push_back(iter->typeId());
+            for (k = 0; k < N; ++k) {
+               ints_.push_back(iter->atomId(k));
+            }
+            ++nGroup;
+         }
+      }
+      writeSection(file, 2 + N, ints_);
+      return nGroup;
+   }
+
+   /*
+   * Read a distributed configuration (call on all processors).
+   */
+   void DistributedConfigIo::readConfig(const std::string& filename,
+                                        MaskPolicy maskPolicy)
+   {
+      // Preconditions
+      if (atomStorage().nAtom()) {
+         UTIL_THROW("Atom storage is not empty (has local atoms)");
+      }
+      if (atomStorage().nGhost()) {
+         UTIL_THROW("Atom storage is not empty (has ghost atoms)");
+      }
+      if (atomStorage().isCartesian()) {
+         UTIL_THROW("Atom storage set for Cartesian coordinates");
+      }
+
+      MPI::Intracomm& communicator = domain().communicator();
+      IntVector gridDimensions;
+      int i, j, nProc, nAtom;
+
+      // Read index file on master, compare processor grids
+      std::ifstream indexFile;
+      int isSameGrid = 1;
+      bool isOpen = true;
+      if (domain().isMaster()) {
+         isOpen = openInput(filename, indexFile, std::ios::in);
+      }
+      checkOpen(isOpen, filename);
+      if (domain().isMaster()) {
+         indexFile >> Label("DISTRIBUTED_CONFIG");
+         indexFile >> Label("nProc") >> nProc;
+         indexFile >> Label("gridDimensions") >> gridDimensions;
+         if (nProc != communicator.Get_size()) {
+            isSameGrid = 0;
+         }
+         for (i = 0; i < Dimension; ++i) {
+            if (gridDimensions[i] != domain().gridDimension(i)) {
+               isSameGrid = 0;
+            }
+         }
+      }
+      communicator.Bcast(&isSameGrid, 1, MPI::INT, 0);
+      communicator.Bcast(&nProc, 1, MPI::INT, 0);
+
+      // Read domain boundaries. Use them only if the grid is the same.
+      DArray<double> bounds;
+      for (i = 0; i < Dimension; ++i) {
+         if (isSameGrid) {
+            bounds.allocate(domain().gridDimension(i) + 1);
+            if (domain().isMaster()) {
+               indexFile >> Label("gridBounds");
+               for (j = 0; j <= domain().gridDimension(i); ++j) {
+                  indexFile >> bounds[j];
+               }
+            }
+            communicator.Bcast(&bounds[0], bounds.capacity(), 
+                               MPI::DOUBLE, 0);
+            domain().setGridBounds(i, bounds);
+         } else if (domain().isMaster()) {
+            bounds.allocate(gridDimensions[i] + 1);
+            indexFile >> Label("gridBounds");
+            for (j = 0; j <= gridDimensions[i]; ++j) {
+               indexFile >> bounds[j];
+            }
+         }
+         if (bounds.isAllocated()) {
+            bounds.deallocate();
+         }
+      }
+      if (!isSameGrid) {
+         domain().resetGridBounds();
+      }
+      if (domain().isMaster()) {
+         indexFile >> Label("BOUNDARY");
+         indexFile >> boundary();
+         indexFile >> Label("nAtom") >> nAtom;
+         indexFile.close();
+      }
+      bcast(communicator, boundary(), 0);
+
+      if (isSameGrid) {
+
+         // Read atoms and groups from the file for this processor
+         std::ifstream file;
+         isOpen = openInput(rankFileName(filename, domain().gridRank()),
+                            file, std::ios::in | std::ios::binary);
+         checkOpen(isOpen, rankFileName(filename, domain().gridRank()));
+         readRank(file, maskPolicy);
+         file.close();
+
+         // Check total number of atoms
+         if (domain().isMaster()) {
+            if (atomStorage().nAtomTotal() != nAtom) {
+               UTIL_THROW("Total number of atoms inconsistent with index file");
+            }
+         }
+
+      } else {
+
+         // Read rank files k = myRank, myRank + size, ... in parallel.
+         // Each processor reads a different number of files, so check
+         // that all of them can be opened before reading any.
+         int size = communicator.Get_size();
+         int k;
+         for (k = domain().gridRank(); k < nProc && isOpen; k += size) {
+            std::ifstream file;
+            isOpen = openInput(rankFileName(filename, k), file,
+                               std::ios::in | std::ios::binary);
+            if (file.is_open()) {
+               file.close();
+            }
+         }
+         checkOpen(isOpen, rankFileName(filename, k));
+         for (k = domain().gridRank(); k < nProc; k += size) {
+            std::ifstream file;
+            openInput(rankFileName(filename, k), file,
+                      std::ios::in | std::ios::binary);
+            readHeader(file);
+            readAtoms(file, true);
+            #ifdef SIMP_BOND
+            if (bondStorage().capacity()) {
+               stageGroups<2>(file, bondDistributor());
+            }
+            #endif
+            #ifdef SIMP_ANGLE
+            if (angleStorage().capacity()) {
+               stageGroups<3>(file, angleDistributor());
+            }
+            #endif
+            #ifdef SIMP_DIHEDRAL
+            if (dihedralStorage().capacity()) {
+               stageGroups<4>(file, dihedralDistributor());
+            }
+            #endif
+            file.close();
+         }
+
+         // Send atoms to owners, check total number of atoms
+         atomDistributor().redistribute();
+         atomStorage().isValid(communicator);
+         if (domain().isMaster()) {
+            if (atomStorage().nAtomTotal() != nAtom) {
+               UTIL_THROW("Total number of atoms inconsistent with index file");
+            }
+         }
+
+         // Send groups to every processor that owns one of their atoms
+         #ifdef SIMP_BOND
+         if (bondStorage().capacity()) {
+            bondDistributor().redistribute();
+            if (maskPolicy == MaskBonded) {
+               setAtomMasks();
+            }
+         }
+         #endif
+         #ifdef SIMP_ANGLE
+         if (angleStorage().capacity()) {
+            angleDistributor().redistribute();
+         }
+         #endif
+         #ifdef SIMP_DIHEDRAL
+         if (dihedralStorage().capacity()) {
+            dihedralDistributor().redistribute();
+         }
+         #endif
+
+      }
+   }
+
+   /*
+   * Write a distributed configuration (call on all processors).
+   */
+   void DistributedConfigIo::writeConfig(const std::string& filename)
+   {
+      MPI::Intracomm& communicator = domain().communicator();
+      int i, j;
+
+      // Compute totals (call on all processors)
+      atomStorage().computeNAtomTotal(communicator);
+      #ifdef SIMP_BOND
+      if (bondStorage().capacity()) {
+         bondStorage().computeNTotal(communicator);
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (angleStorage().capacity()) {
+         angleStorage().computeNTotal(communicator);
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (dihedralStorage().capacity()) {
+         dihedralStorage().computeNTotal(communicator);
+      }
+      #endif
+
+      // Write index file on master
+      std::ofstream indexFile;
+      bool isOpen = true;
+      if (domain().isMaster()) {
+         isOpen = openOutput(filename, indexFile, std::ios::out);
+      }
+      checkOpen(isOpen, filename);
+      if (domain().isMaster()) {
+         indexFile << "DISTRIBUTED_CONFIG" << std::endl;
+         indexFile << "nProc  " << communicator.Get_size() << std::endl;
+         indexFile << "gridDimensions  " << domain().grid().dimensions()
+                   << std::endl;
+         indexFile.setf(std::ios::scientific);
+         indexFile.precision(16);
+         for (i = 0; i < Dimension; ++i) {
+            indexFile << "gridBounds ";
+            for (j = 0; j <= domain().gridDimension(i); ++j) {
+               indexFile << " " << domain().gridBound(i, j);
+            }
+            indexFile << std::endl;
+         }
+         indexFile.unsetf(std::ios::scientific);
+         indexFile << "BOUNDARY" << std::endl;
+         indexFile << boundary() << std::endl;
+         indexFile << "nAtom  " << atomStorage().nAtomTotal() << std::endl;
+         #ifdef SIMP_BOND
+         if (bondStorage().capacity()) {
+            indexFile << "nBond  " << bondStorage().nTotal() << std::endl;
+         }
+         #endif
+         #ifdef SIMP_ANGLE
+         if (angleStorage().capacity()) {
+            indexFile << "nAngle  " << angleStorage().nTotal() << std::endl;
+         }
+         #endif
+         #ifdef SIMP_DIHEDRAL
+         if (dihedralStorage().capacity()) {
+            indexFile << "nDihedral  " << dihedralStorage().nTotal()
+                      << std::endl;
+         }
+         #endif
+         indexFile.close();
+      }
+
+      // Write atoms and groups to the file for this processor
+      std::ofstream file;
+      isOpen = openOutput(rankFileName(filename, domain().gridRank()),
+                          file, std::ios::out | std::ios::binary);
+      checkOpen(isOpen, rankFileName(filename, domain().gridRank()));
+      writeRank(file);
+      file.close();
+   }
+
+   /*
+   * Read atoms and groups of this processor from a rank stream.
+   */
+   void DistributedConfigIo::readRank(std::istream& in, MaskPolicy maskPolicy)
+   {
+      readHeader(in);
+      readAtoms(in, false);
+
+      MPI::Intracomm& communicator = domain().communicator();
+      atomStorage().unsetNAtomTotal();
+      atomStorage().computeNAtomTotal(communicator);
+      atomStorage().isValid(communicator);
+
+      #ifdef SIMP_BOND
+      if (bondStorage().capacity()) {
+         loadGroups<2>(in, bondStorage());
+         if (maskPolicy == MaskBonded) {
+            setAtomMasks();
+         }
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (angleStorage().capacity()) {
+         loadGroups<3>(in, angleStorage());
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (dihedralStorage().capacity()) {
+         loadGroups<4>(in, dihedralStorage());
+      }
+      #endif
+   }
+
+   /*
+   * Write local atoms and groups of this processor to a rank stream.
+   */
+   void DistributedConfigIo::writeRank(std::ostream& out)
+   {
+      writeHeader(out);
+      const int nInt = Atom::hasAtomContext() ? 6 : 3;
+      int nAtomLocal = atomStorage().nAtom();
+      ints_.resize(nInt*nAtomLocal);
+      reals_.resize(2*Dimension*nAtomLocal);
+      bool isCartesian = atomStorage().isCartesian();
+      AtomIterator atomIter;
+      AtomContext* contextPtr;
+      Vector r;
+      int* ip;
+      double* rp;
+      int j;
+      int k = 0;
+      for (atomStorage().begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         ip = &ints_[k*nInt];
+         rp = &reals_[k*2*Dimension];
+         ip[0] = atomIter->id();
+         ip[1] = atomIter->typeId();
+         ip[2] = (int) atomIter->groups();
+         if (Atom::hasAtomContext()) {
+            contextPtr = &atomIter->context();
+            ip[3] = contextPtr->speciesId;
+            ip[4] = contextPtr->moleculeId;
+            ip[5] = contextPtr->atomId;
+         }
+         if (isCartesian) {
+            r = atomIter->position();
+         } else {
+            boundary().transformGenToCart(atomIter->position(), r);
+         }
+         for (j = 0; j < Dimension; ++j) {
+            rp[j] = r[j];
+            if (Atom::hasVelocity()) {
+               rp[Dimension + j] = atomIter->velocity()[j];
+            } else {
+               rp[Dimension + j] = 0.0;
+            }
+         }
+         ++k;
+      }
+      writeSection(out, AtomIntSection, ints_);
+      writeSection(out, AtomRealSection, reals_);
+
+      // Write groups containing local atoms
+      #ifdef SIMP_BOND
+      if (bondStorage().capacity()) {
+         saveGroups<2>(out, bondStorage());
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (angleStorage().capacity()) {
+         saveGroups<3>(out, angleStorage());
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (dihedralStorage().capacity()) {
+         saveGroups<4>(out, dihedralStorage());
+      }
+      #endif
+   }
+
+   /*
+   * Read a distributed configuration saved with a restart file.
+   */
+   void DistributedConfigIo::readRestart(const std::string& filename,
+                                         MaskPolicy maskPolicy)
+   {
+      isRestart_ = true;
+      readConfig(filename + ".config", maskPolicy);
+      isRestart_ = false;
+   }
+
+   /*
+   * Write a distributed configuration to accompany a restart file.
+   */
+   void DistributedConfigIo::writeRestart(const std::string& filename)
+   {
+      isRestart_ = true;
+      writeConfig(filename + ".config");
+      isRestart_ = false;
+   }
+
+   /*
+   * Stream-based read, not implemented.
+   */
+   void DistributedConfigIo::readConfig(std::ifstream& file,
+                                        MaskPolicy maskPolicy)
+   {  UTIL_THROW("DistributedConfigIo requires READ_CONFIG_DISTRIBUTED"); }
+
+   /*
+   * Stream-based write, not implemented.
+   */
+   void DistributedConfigIo::writeConfig(std::ofstream& file)
+   {  UTIL_THROW("DistributedConfigIo requires WRITE_CONFIG_DISTRIBUTED"); }
+
+}
@@ -0,0 +1,288 @@
+#ifndef DDMD_DISTRIBUTED_CONFIG_IO_H
+#define DDMD_DISTRIBUTED_CONFIG_IO_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/configIos/ConfigIo.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+namespace DdMd
+{
+
+   class Simulation;
+   template <int N> class GroupStorage;
+
+   using namespace Util;
+
+   /**
+   * Parallel configuration file reader and writer, with one file per rank.
+   *
+   * A distributed configuration with base name "config" consists of a
+   * text index file named "config", written by the master processor, and
+   * a binary file named "config.r" for each processor of rank r. Each
+   * processor writes and reads only its own file, so no atoms or groups
+   * are sent to or from the master. The index file contains the number
+   * of processors, the processor grid dimensions, the domain boundaries
+   * along each grid axis, the Boundary, and total numbers of atoms and
+   * groups. Each binary file contains the local atoms of one processor,
+   * followed by every group that contains one or more of these atoms.
+   *
+   * Each binary rank file begins with the 8 character magic string
+   * "DDMDRANK", an int format version number and an int flag that is
+   * nonzero iff atoms carry an AtomContext. This header is followed by
+   * a sequence of sections, each of which contains an int section tag,
+   * the number of bytes of data as a long, an unsigned int Adler-32
+   * checksum of the data, and the data itself as one contiguous block,
+   * which is read and written with a single call. Atom data is stored
+   * in an int section (id, typeId, groups, and optionally speciesId,
+   * moleculeId and atomId for each atom) and a real section (Cartesian
+   * position and velocity for each atom). Each group type is stored in
+   * one int section (id, typeId and N atom ids for each group). The
+   * magic string, version, tags and checksums are all checked when a
+   * file is read. Binary files are not portable between platforms with
+   * different byte order or sizes of int, long and double.
+   *
+   * A distributed configuration may be read by a simulation with a
+   * different number of processors or processor grid. In this case, 
+   * rank files are divided among the processors, and each processor 
+   * reads its files in parallel with the others. Atoms and groups are 
+   * then sent to their owners in a staged exchange, one dimension of 
+   * the processor grid at a time (see AtomDistributor::redistribute()
+   * and GroupDistributor::redistribute()), and the domains of the new 
+   * grid are given equal widths. This avoids reading and distributing 
+   * all atoms through the master processor, as for serial formats.
+   *
+   * Because file names are needed on all processors, this class is used
+   * through the readConfig(std::string, MaskPolicy) and
+   * writeConfig(std::string) functions, which implement the commands
+   * READ_CONFIG_DISTRIBUTED and WRITE_CONFIG_DISTRIBUTED. The inherited
+   * stream-based functions throw an Exception. The same format is used
+   * for parallel restart, through readRestart() and writeRestart().
+   * Only the configuration is distributed: the restart parameter
+   * archive is still written and read by the master processor alone.
+   *
+   * A failure to open any file is agreed over the communicator, so
+   * that all processors throw together rather than leaving the others
+   * blocked in a later collective call.
+   *
+   * \ingroup DdMd_ConfigIo_Module
+   */
+   class DistributedConfigIo  : public ConfigIo
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      DistributedConfigIo(Simulation& simulation);
+
+      /**
+      * Read a distributed configuration.
+      *
+      * Call on all processors.
+      *
+      * \pre  There are no atoms, ghosts, or groups.
+      * \pre  AtomStorage is set for scaled / generalized coordinates
+      *
+      * \param filename   base name of configuration (name of index file)
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      void readConfig(const std::string& filename, MaskPolicy maskPolicy);
+
+      /**
+      * Write a distributed configuration.
+      *
+      * Call on all processors. Does not modify atomic positions or the
+      * coordinate system setting of the AtomStorage.
+      *
+      * \param filename base name of configuration (name of index file)
+      */
+      void writeConfig(const std::string& filename);
+
+      /**
+      * Read a distributed configuration that accompanies a restart file.
+      *
+      * Reads a distributed configuration with base name filename.config,
+      * using the restart file prefix of the FileMaster. Call on all
+      * processors.
+      *
+      * \param filename   base name of restart file
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      void readRestart(const std::string& filename, MaskPolicy maskPolicy);
+
+      /**
+      * Write a distributed configuration to accompany a restart file.
+      *
+      * Writes a distributed configuration with base name filename.config,
+      * using the restart file prefix of the FileMaster. Call on all
+      * processors.
+      *
+      * \param filename base name of restart file
+      */
+      void writeRestart(const std::string& filename);
+
+      /**
+      * Read the atoms and groups of this processor from a rank stream.
+      *
+      * Reads data in the format of a binary rank file, which must have
+      * been written by writeRank() on a processor with the same domain.
+      * Call on all processors.
+      *
+      * \pre  There are no atoms, ghosts, or groups.
+      * \pre  AtomStorage is set for scaled / generalized coordinates
+      * \pre  Boundary and domain bounds are those used by writeRank().
+      *
+      * \param in  input stream, opened in binary mode
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      void readRank(std::istream& in, MaskPolicy maskPolicy);
+
+      /**
+      * Write the atoms and groups of this processor to a rank stream.
+      *
+      * Writes local atoms, and all groups that contain local atoms, in
+      * the format of a binary rank file. Does not communicate, and so
+      * may be called on any subset of processors.
+      *
+      * \param out  output stream, opened in binary mode
+      */
+      void writeRank(std::ostream& out);
+
+      /**
+      * Not implemented: Throws an Exception.
+      *
+      * \param file input file stream
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      virtual void readConfig(std::ifstream& file, MaskPolicy maskPolicy);
+
+      /**
+      * Not implemented: Throws an Exception.
+      *
+      * \param file output file stream
+      */
+      virtual void writeConfig(std::ofstream& file);
+
+   private:
+
+      // Pointer to parent Simulation.
+      Simulation* simulationPtr_;
+
+      // Buffer for int sections.
+      std::vector<int> ints_;
+
+      // Buffer for real sections.
+      std::vector<double> reals_;
+
+      // Are files opened with the restart prefix?
+      bool isRestart_;
+
+      /**
+      * Read Group<N> objects containing local atoms from a rank file.
+      */
+      template <int N>
+      int loadGroups(std::istream& file, GroupStorage<N>& storage);
+
+      /**
+      * Write Group<N> objects containing local atoms to a rank file.
+      */
+      template <int N>
+      int saveGroups(std::ostream& file, GroupStorage<N>& storage);
+
+      /**
+      * Read atoms from a rank file.
+      *
+      * \param file  input rank file
+      * \param isStaged  if true, atoms may belong to any domain
+      * \return number of atoms read
+      */
+      int readAtoms(std::istream& file, bool isStaged);
+
+      /**
+      * Read Group<N> objects from a rank file, queue for redistribution.
+      */
+      template <int N>
+      int stageGroups(std::istream& file,
+                      GroupDistributor<N>& distributor);
+
+      /**
+      * Write the magic string, version and flags of a rank file.
+      */
+      void writeHeader(std::ostream& file);
+
+      /**
+      * Read and validate the header of a rank file.
+      */
+      void readHeader(std::istream& file);
+
+      /**
+      * Write an array as one checksummed section.
+      *
+      * \param file  output rank file
+      * \param tag  section tag
+      * \param data  array of data
+      */
+      template <typename T>
+      void writeSection(std::ostream& file, int tag,
+                        const std::vector<T>& data);
+
+      /**
+      * Read and validate one checksummed section.
+      *
+      * \param file  input rank file
+      * \param tag  expected section tag
+      * \param data  array of data (resized on return)
+      */
+      template <typename T>
+      void readSection(std::istream& file, int tag, std::vector<T>& data);
+
+      /**
+      * Open an input file, with the input or restart prefix.
+      *
+      * \return true if the file was opened, false otherwise (no throw)
+      */
+      bool openInput(const std::string& name, std::ifstream& file,
+                     std::ios_base::openmode mode);
+
+      /**
+      * Open an output file, with the output or restart prefix.
+      *
+      * \return true if the file was opened, false otherwise (no throw)
+      */
+      bool openOutput(const std::string& name, std::ofstream& file,
+                      std::ios_base::openmode mode);
+
+      /**
+      * Throw on all processors if isOpen is false on any processor.
+      *
+      * Call on all processors of the domain communicator.
+      *
+      * \param isOpen  was the file opened on this processor?
+      * \param name  file name, for the error message
+      */
+      void checkOpen(bool isOpen, const std::string& name);
+
+      /**
+      * Return name of the binary file for a processor.
+      *
+      * \param filename  base name of configuration
+      * \param rank  processor rank
+      */
+      std::string rankFileName(const std::string& filename, int rank);
+
+   };
+
+}
+#endif
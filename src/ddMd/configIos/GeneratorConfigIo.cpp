@@ -0,0 +1,632 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "GeneratorConfigIo.h"
+
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/AtomDistributor.h>
+#include <ddMd/communicate/GroupDistributor.tpp>
+#include <ddMd/storage/AtomStorage.h>
+#ifdef SIMP_BOND
+#include <ddMd/storage/BondStorage.h>
+#include <ddMd/potentials/bond/BondPotential.h>
+#endif
+#ifdef SIMP_ANGLE
+#include <ddMd/storage/AngleStorage.h>
+#endif
+#ifdef SIMP_DIHEDRAL
+#include <ddMd/storage/DihedralStorage.h>
+#endif
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/chemistry/Group.h>
+#include <ddMd/misc/BoundaryMetric.h>
+
+#include <simp/species/Species.h>
+#include <simp/species/Point.h>
+#ifdef SIMP_BOND
+#include <simp/species/Homopolymer.h>
+#include <simp/species/Diblock.h>
+#include <simp/species/Multiblock.h>
+#endif
+
+#include <util/param/Factory.h>
+#include <util/misc/FileMaster.h>
+#include <util/global.h>
+
+#include <fstream>
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   namespace {
+
+      /*
+      * Factory for the subclasses of Species that can be generated.
+      */
+      class GeneratorSpeciesFactory : public Factory<Species>
+      {
+      public:
+
+         Species* factory(const std::string &className) const
+         {
+            Species* ptr = 0;
+            if (className == "Species") {
+               ptr = new Species();
+            } else
+            if (className == "Point") {
+               ptr = new Point();
+            }
+            #ifdef SIMP_BOND
+            else
+            if (className == "Homopolymer") {
+               ptr = new Homopolymer();
+            } else
+            if (className == "Diblock") {
+               ptr = new Diblock();
+            } else
+            if (className == "Multiblock") {
+               ptr = new Multiblock();
+            }
+            #endif
+            return ptr;
+         }
+
+      };
+
+   }
+
+   /*
+   * Constructor.
+   */
+   GeneratorConfigIo::GeneratorConfigIo(Simulation& simulation)
+    : ConfigIo(simulation),
+      positions_(),
+      types_(),
+      cellIds_(),
+      cells_(),
+      species_(),
+      diameters_(),
+      parents_(),
+      bondTypes_(),
+      molecule_(),
+      counterRandom_(),
+      random_(),
+      simulationPtr_(&simulation),
+      temperature_(1.0),
+      maxDiameter_(0.0),
+      nSpecies_(0),
+      seed_(0),
+      maxAttempt_(100)
+   {  setClassName("GeneratorConfigIo"); }
+
+   /*
+   * Destructor.
+   */
+   GeneratorConfigIo::~GeneratorConfigIo()
+   {
+      if (species_.isAllocated()) {
+         for (int i = 0; i < species_.capacity(); ++i) {
+            if (species_[i]) {
+               delete species_[i];
+            }
+         }
+      }
+   }
+
+   /*
+   * Read parameters (call on all processors).
+   */
+   void GeneratorConfigIo::readParameters(std::istream& in)
+   {
+      if (species_.isAllocated()) {
+         UTIL_THROW("Parameters may only be read once");
+      }
+      read<Boundary>(in, "boundary", boundary());
+      read<int>(in, "seed", seed_);
+      read<int>(in, "nSpecies", nSpecies_);
+      if (nSpecies_ <= 0) {
+         UTIL_THROW("Non-positive nSpecies");
+      }
+      species_.allocate(nSpecies_);
+      int i;
+      for (i = 0; i < nSpecies_; ++i) {
+         species_[i] = 0;
+      }
+      GeneratorSpeciesFactory factory;
+      std::string className;
+      bool isEnd;
+      for (i = 0; i < nSpecies_; ++i) {
+         species_[i] = factory.readObject(in, *this, className, isEnd);
+         if (!species_[i]) {
+            std::string msg("Unknown Species subclass name: ");
+            msg += className;
+            UTIL_THROW(msg.c_str());
+         }
+         species_[i]->setId(i);
+      }
+      int nAtomType = simulationPtr_->nAtomType();
+      diameters_.allocate(nAtomType);
+      readDArray<double>(in, "diameters", diameters_, nAtomType);
+      temperature_ = 1.0;
+      readOptional<double>(in, "temperature", temperature_);
+      maxAttempt_ = 100;
+      readOptional<int>(in, "maxAttempt", maxAttempt_);
+      if (temperature_ <= 0.0) {
+         UTIL_THROW("Non-positive temperature");
+      }
+      if (maxAttempt_ <= 0) {
+         UTIL_THROW("Non-positive maxAttempt");
+      }
+   }
+
+   /*
+   * Read a parameter file and generate a configuration.
+   */
+   void GeneratorConfigIo::readConfig(const std::string& filename,
+                                      MaskPolicy maskPolicy)
+   {
+      // Preconditions
+      if (atomStorage().nAtom()) {
+         UTIL_THROW("Atom storage is not empty (has local atoms)");
+      }
+      if (atomStorage().nGhost()) {
+         UTIL_THROW("Atom storage is not empty (has ghost atoms)");
+      }
+      if (atomStorage().isCartesian()) {
+         UTIL_THROW("Atom storage set for Cartesian coordinates");
+      }
+
+      // Read parameter file, opened only on master
+      MPI::Intracomm& communicator = domain().communicator();
+      setIoCommunicator(communicator);
+      std::ifstream file;
+      if (domain().isMaster()) {
+         simulationPtr_->fileMaster().openInputFile(filename, file);
+      }
+      readParam(file);
+      if (domain().isMaster()) {
+         file.close();
+      }
+
+      // Check total number of atoms
+      int nAtomType = simulationPtr_->nAtomType();
+      int nAtomTotal = 0;
+      int s, i, j;
+      for (s = 0; s < nSpecies_; ++s) {
+         nAtomTotal += species_[s]->capacity()*species_[s]->nAtom();
+         for (i = 0; i < species_[s]->nAtom(); ++i) {
+            j = species_[s]->atomTypeId(i);
+            if (j < 0 || j >= nAtomType) {
+               UTIL_THROW("Invalid atom type id in Species");
+            }
+         }
+      }
+      if (nAtomTotal > atomStorage().totalAtomCapacity()) {
+         UTIL_THROW("Number of atoms exceeds totalAtomCapacity");
+      }
+
+      // Set up grid of cells no narrower than the maximum diameter
+      maxDiameter_ = 0.0;
+      for (i = 0; i < nAtomType; ++i) {
+         if (diameters_[i] > maxDiameter_) {
+            maxDiameter_ = diameters_[i];
+         }
+      }
+      for (i = 0; i < Dimension; ++i) {
+         cellDimensions_[i] = 1;
+         if (maxDiameter_ > 0.0) {
+            j = int(1.0/scaledWidth(boundary(), maxDiameter_, i));
+            if (j > 1) cellDimensions_[i] = j;
+         }
+      }
+
+      // Seed generators: counterRandom_ is the same on all processors
+      counterRandom_.setSeed(seed_);
+      random_.setSeed(seed_ + 1 + domain().gridRank());
+
+      // Generate molecules whose first atom is in this domain
+      int atomOffset = 0;
+      #ifdef SIMP_BOND
+      int bondOffset = 0;
+      #endif
+      #ifdef SIMP_ANGLE
+      int angleOffset = 0;
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      int dihedralOffset = 0;
+      #endif
+      Vector first;
+      double u[4];
+      int nAtom, capacity, m, iAttempt;
+      bool success;
+      for (s = 0; s < nSpecies_; ++s) {
+         const Species& species = *species_[s];
+         nAtom = species.nAtom();
+         capacity = species.capacity();
+         setParents(species);
+         for (m = 0; m < capacity; ++m) {
+            counterRandom_.uniform(s, m, 0, 0, u);
+            for (i = 0; i < Dimension; ++i) {
+               first[i] = u[i];
+            }
+            if (!domain().isInDomain(first)) continue;
+
+            // Grow molecule, moving first atom within domain on failure
+            success = false;
+            iAttempt = 0;
+            while (!success && iAttempt < maxAttempt_) {
+               success = placeMolecule(species, first);
+               ++iAttempt;
+               if (!success) {
+                  for (i = 0; i < Dimension; ++i) {
+                     first[i] = random_.uniform(domain().domainBound(i, 0),
+                                                domain().domainBound(i, 1));
+                  }
+               }
+            }
+            if (!success) {
+               UTIL_THROW("Failed to generate molecule");
+            }
+
+            addMolecule(species, s, m, atomOffset + m*nAtom);
+            #ifdef SIMP_BOND
+            if (bondStorage().capacity()) {
+               addGroups<2>(species, species.nBond(),
+                            &Species::speciesBond, bondDistributor(),
+                            atomOffset + m*nAtom,
+                            bondOffset + m*species.nBond());
+            }
+            #endif
+            #ifdef SIMP_ANGLE
+            if (angleStorage().capacity()) {
+               addGroups<3>(species, species.nAngle(),
+                            &Species::speciesAngle, angleDistributor(),
+                            atomOffset + m*nAtom,
+                            angleOffset + m*species.nAngle());
+            }
+            #endif
+            #ifdef SIMP_DIHEDRAL
+            if (dihedralStorage().capacity()) {
+               addGroups<4>(species, species.nDihedral(),
+                            &Species::speciesDihedral, dihedralDistributor(),
+                            atomOffset + m*nAtom,
+                            dihedralOffset + m*species.nDihedral());
+            }
+            #endif
+         }
+         atomOffset += capacity*nAtom;
+         #ifdef SIMP_BOND
+         bondOffset += capacity*species.nBond();
+         #endif
+         #ifdef SIMP_ANGLE
+         angleOffset += capacity*species.nAngle();
+         #endif
+         #ifdef SIMP_DIHEDRAL
+         dihedralOffset += capacity*species.nDihedral();
+         #endif
+      }
+
+      // Release memory used for overlap tests
+      std::vector<Vector>().swap(positions_);
+      std::vector<int>().swap(types_);
+      std::vector<long>().swap(cellIds_);
+      cells_.clear();
+
+      // Send atoms to owners, check total number of atoms
+      atomDistributor().redistribute();
+      atomStorage().isValid(communicator);
+      if (domain().isMaster()) {
+         if (atomStorage().nAtomTotal() != nAtomTotal) {
+            UTIL_THROW("Total number of atoms inconsistent with species");
+         }
+      }
+
+      // Send groups to every processor that owns one of their atoms
+      #ifdef SIMP_BOND
+      if (bondStorage().capacity()) {
+         bondDistributor().redistribute();
+         if (maskPolicy == MaskBonded) {
+            setAtomMasks();
+         }
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (angleStorage().capacity()) {
+         angleDistributor().redistribute();
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (dihedralStorage().capacity()) {
+         dihedralDistributor().redistribute();
+      }
+      #endif
+   }
+
+   /*
+   * Not implemented: Throws an Exception.
+   */
+   void GeneratorConfigIo::readConfig(std::ifstream& file,
+                                      MaskPolicy maskPolicy)
+   {  UTIL_THROW("Use GeneratorConfigIo::readConfig(std::string&, ...)"); }
+
+   /*
+   * Not implemented: Throws an Exception.
+   */
+   void GeneratorConfigIo::writeConfig(std::ofstream& file)
+   {  UTIL_THROW("GeneratorConfigIo cannot write configurations"); }
+
+   /*
+   * Compute the parent and bond type of each atom of a species (private).
+   */
+   void GeneratorConfigIo::setParents(const Species& species)
+   {
+      int nAtom = species.nAtom();
+      if (parents_.isAllocated()) {
+         parents_.deallocate();
+         bondTypes_.deallocate();
+         molecule_.deallocate();
+      }
+      parents_.allocate(nAtom);
+      bondTypes_.allocate(nAtom);
+      molecule_.allocate(nAtom);
+      int i;
+      for (i = 0; i < nAtom; ++i) {
+         parents_[i] = -1;
+         bondTypes_[i] = -1;
+      }
+
+      #ifdef SIMP_BOND
+      // Each atom i > 0 must have exactly one bond to an atom j < i
+      if (species.nBond() != nAtom - 1) {
+         UTIL_THROW("Generated species must have nAtom - 1 bonds");
+      }
+      int lower, upper;
+      for (i = 0; i < species.nBond(); ++i) {
+         lower = species.speciesBond(i).atomId(0);
+         upper = species.speciesBond(i).atomId(1);
+         if (lower > upper) {
+            upper = lower;
+            lower = species.speciesBond(i).atomId(1);
+         }
+         if (lower == upper || parents_[upper] >= 0) {
+            UTIL_THROW("Generated species must be linear or branched");
+         }
+         parents_[upper] = lower;
+         bondTypes_[upper] = species.speciesBond(i).typeId();
+      }
+      #else
+      if (nAtom != 1) {
+         UTIL_THROW("Generated species must have one atom without bonds");
+      }
+      #endif
+   }
+
+   /*
+   * Attempt to place all atoms of a molecule (private).
+   *
+   * On success, positions of all atoms are in molecule_ and are added
+   * to the cell grid. On failure, the cell grid is left unchanged.
+   */
+   bool GeneratorConfigIo::placeMolecule(const Species& species,
+                                         const Vector& first)
+   {
+      molecule_[0] = first;
+      if (!addPosition(molecule_[0], species.atomTypeId(0))) {
+         return false;
+      }
+
+      #ifdef SIMP_BOND
+      const BondPotential& bondPotential = simulationPtr_->bondPotential();
+      double beta = 1.0/temperature_;
+      Vector r;
+      Vector v;
+      int nAtom = species.nAtom();
+      int i, j, k, iAttempt;
+      bool success;
+      for (i = 1; i < nAtom; ++i) {
+         success = false;
+         iAttempt = 0;
+         while (!success && iAttempt < maxAttempt_) {
+
+            // Displace from parent, which is j positions from the end
+            j = i - parents_[i];
+            r = positions_[positions_.size() - j];
+            random_.unitVector(v);
+            v *= bondPotential.randomBondLength(&random_, beta,
+                                                bondTypes_[i]);
+            r += v;
+
+            // Shift into primary cell, in scaled coordinates
+            boundary().transformCartToGen(r, molecule_[i]);
+            for (k = 0; k < Dimension; ++k) {
+               molecule_[i][k] -= floor(molecule_[i][k]);
+               if (molecule_[i][k] >= 1.0) molecule_[i][k] = 0.0;
+            }
+
+            success = addPosition(molecule_[i], species.atomTypeId(i));
+            ++iAttempt;
+         }
+         if (!success) {
+            removePositions(i);
+            return false;
+         }
+      }
+      #endif
+
+      return true;
+   }
+
+   /*
+   * Get the index of the cell containing a scaled position (private).
+   */
+   long GeneratorConfigIo::cellIndex(const Vector& scaled,
+                                     int (&coords)[Dimension]) const
+   {
+      long index = 0;
+      for (int i = Dimension - 1; i >= 0; --i) {
+         coords[i] = int(scaled[i]*double(cellDimensions_[i]));
+         if (coords[i] < 0) coords[i] = 0;
+         if (coords[i] >= cellDimensions_[i]) {
+            coords[i] = cellDimensions_[i] - 1;
+         }
+         index = index*cellDimensions_[i] + coords[i];
+      }
+      return index;
+   }
+
+   /*
+   * Add an atom position to the cell grid, if it has no overlap (private).
+   */
+   bool GeneratorConfigIo::addPosition(const Vector& scaled, int typeId)
+   {
+      int coords[Dimension];
+      long index = cellIndex(scaled, coords);
+      Vector r;
+      boundary().transformGenToCart(scaled, r);
+      double di = diameters_[typeId];
+
+      // Loop over the block of up to 27 cells around this one
+      int lower[Dimension];
+      int upper[Dimension];
+      int i, n;
+      for (i = 0; i < Dimension; ++i) {
+         n = cellDimensions_[i];
+         if (n < 3) {
+            lower[i] = 0;
+            upper[i] = n - 1;
+         } else {
+            lower[i] = coords[i] - 1;
+            upper[i] = coords[i] + 1;
+         }
+      }
+      std::map<long, std::vector<int> >::const_iterator iter;
+      double rSq, d;
+      long neighborIndex;
+      int c0, c1, c2, k;
+      for (c0 = lower[0]; c0 <= upper[0]; ++c0) {
+         for (c1 = lower[1]; c1 <= upper[1]; ++c1) {
+            for (c2 = lower[2]; c2 <= upper[2]; ++c2) {
+               neighborIndex =
+                  (c0 + cellDimensions_[0]) % cellDimensions_[0] +
+                  long(cellDimensions_[0])*(
+                  (c1 + cellDimensions_[1]) % cellDimensions_[1] +
+                  long(cellDimensions_[1])*(
+                  (c2 + cellDimensions_[2]) % cellDimensions_[2]));
+               iter = cells_.find(neighborIndex);
+               if (iter == cells_.end()) continue;
+               const std::vector<int>& cell = iter->second;
+               for (k = 0; k < (int)cell.size(); ++k) {
+                  d = 0.5*(di + diameters_[types_[cell[k]]]);
+                  rSq = boundary().distanceSq(positions_[cell[k]], r);
+                  if (rSq < d*d) {
+                     return false;
+                  }
+               }
+            }
+         }
+      }
+
+      // No overlap: Add position to its cell
+      cells_[index].push_back(positions_.size());
+      positions_.push_back(r);
+      types_.push_back(typeId);
+      cellIds_.push_back(index);
+      return true;
+   }
+
+   /*
+   * Remove the last n positions added to the cell grid (private).
+   */
+   void GeneratorConfigIo::removePositions(int n)
+   {
+      std::map<long, std::vector<int> >::iterator iter;
+      for (int i = 0; i < n; ++i) {
+         iter = cells_.find(cellIds_.back());
+         assert(iter != cells_.end());
+         iter->second.pop_back();
+         if (iter->second.empty()) {
+            cells_.erase(iter);
+         }
+         positions_.pop_back();
+         types_.pop_back();
+         cellIds_.pop_back();
+      }
+   }
+
+   /*
+   * Add atoms of a generated molecule for later redistribution (private).
+   */
+   void GeneratorConfigIo::addMolecule(const Species& species,
+                                       int speciesId, int moleculeId,
+                                       int atomOffset)
+   {
+      Atom* atomPtr;
+      AtomContext* contextPtr;
+      for (int i = 0; i < species.nAtom(); ++i) {
+         atomPtr = atomDistributor().newLocalAtomPtr();
+         atomPtr->setId(atomOffset + i);
+         atomPtr->setTypeId(species.atomTypeId(i));
+         atomPtr->groups() = 0;
+         if (Atom::hasAtomContext()) {
+            contextPtr = &atomPtr->context();
+            contextPtr->speciesId = speciesId;
+            contextPtr->moleculeId = moleculeId;
+            contextPtr->atomId = i;
+         }
+         atomPtr->position() = molecule_[i];
+         if (Atom::hasVelocity()) {
+            atomPtr->velocity().zero();
+         }
+         atomDistributor().addStagedAtom();
+      }
+   }
+
+   /*
+   * Queue each group of a generated molecule for its owners (private).
+   *
+   * Each group is queued once for the future owner of each of its atoms.
+   */
+   template <int N>
+   void GeneratorConfigIo::addGroups(const Species& species, int nGroup,
+                                     const SpeciesGroup<N>&
+                                        (Species::*speciesGroup)(int) const,
+                                     GroupDistributor<N>& distributor,
+                                     int atomOffset, int groupOffset)
+   {
+      Group<N> group;
+      int ranks[N];
+      int nRank, rank, i, j, k;
+      bool isNew;
+      for (i = 0; i < nGroup; ++i) {
+         const SpeciesGroup<N>& speciesGroupRef = (species.*speciesGroup)(i);
+         group.setId(groupOffset + i);
+         group.setTypeId(speciesGroupRef.typeId());
+         for (j = 0; j < N; ++j) {
+            group.setAtomId(j, atomOffset + speciesGroupRef.atomId(j));
+         }
+         nRank = 0;
+         for (j = 0; j < N; ++j) {
+            rank = domain().ownerRank(molecule_[speciesGroupRef.atomId(j)]);
+            isNew = true;
+            for (k = 0; k < nRank; ++k) {
+               if (ranks[k] == rank) isNew = false;
+            }
+            if (isNew) {
+               ranks[nRank] = rank;
+               ++nRank;
+               distributor.addStaged(group, rank);
+            }
+         }
+      }
+   }
+
+}
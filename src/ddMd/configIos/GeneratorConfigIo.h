@@ -0,0 +1,223 @@
+#ifndef DDMD_GENERATOR_CONFIG_IO_H
+#define DDMD_GENERATOR_CONFIG_IO_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/configIos/ConfigIo.h>             // base class
+#include <simp/species/Species.h>                // member function param
+#include <simp/random/CounterRandom.h>           // member
+#include <util/random/Random.h>                  // member
+#include <util/containers/DArray.h>              // member template
+#include <util/space/Vector.h>                   // member template param
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Parallel generator of initial configurations of molecules.
+   *
+   * A GeneratorConfigIo creates a random configuration of molecules of
+   * one or more species in parallel, instead of reading a configuration
+   * file. The Boundary, the species and the excluded volume diameters
+   * of atom types are read from a parameter file, which is the only
+   * file read. The moleculeCapacity of each Species is the number of
+   * molecules of that species that are generated.
+   *
+   * Each processor generates the molecules whose first atom lies in its
+   * domain. The position of the first atom of each molecule is given by
+   * a counter based random number generator, keyed by the seed and the
+   * species and molecule indices, so that all processors agree on the
+   * owner of every molecule without communicating. Other atoms are then
+   * placed by a random walk, using a random number generator seeded
+   * differently on each processor: Each atom is placed at a distance
+   * given by BondPotential::randomBondLength() from an earlier atom to
+   * which it is bonded, and is rejected if it is closer to any atom
+   * already placed by this processor than the average of the excluded
+   * volume diameters of the two types. Overlap tests use a cell grid
+   * that holds only occupied cells. Overlaps between atoms placed by
+   * different processors are not tested. Atoms of molecules that leave
+   * the domain are then sent to their owners, and each group is sent to
+   * every owner of one of its atoms, as in a staged redistribution by
+   * DistributedConfigIo.
+   *
+   * Atom, bond, angle and dihedral ids are assigned in order of species,
+   * molecule and index within the molecule, and so are independent of
+   * the processor grid. Velocities are set to zero. Each atom with index
+   * i > 0 within a molecule must be bonded to exactly one atom with a
+   * lower index, so that molecules are linear or branched, not rings.
+   *
+   * This class is used through readConfig(std::string, MaskPolicy),
+   * which implements the GENERATE_CONFIG command, in which the name of
+   * the parameter file is given. The inherited stream-based functions
+   * throw an Exception.
+   *
+   * \sa \ref ddMd_configIo_GeneratorConfigIo_page "parameter file format"
+   *
+   * \ingroup DdMd_ConfigIo_Module
+   */
+   class GeneratorConfigIo  : public ConfigIo
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      GeneratorConfigIo(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~GeneratorConfigIo();
+
+      /**
+      * Read parameters (call on all processors).
+      *
+      * \param in input parameter stream (must be open on master)
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Read a parameter file and generate a configuration.
+      *
+      * Call on all processors.
+      *
+      * \pre  There are no atoms, ghosts, or groups.
+      * \pre  AtomStorage is set for scaled / generalized coordinates
+      *
+      * \param filename   name of parameter file, with input prefix
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      void readConfig(const std::string& filename, MaskPolicy maskPolicy);
+
+      /**
+      * Not implemented: Throws an Exception.
+      *
+      * \param file input file stream
+      * \param maskPolicy MaskPolicy to be used in setting atom masks
+      */
+      virtual void readConfig(std::ifstream& file, MaskPolicy maskPolicy);
+
+      /**
+      * Not implemented: Throws an Exception.
+      *
+      * \param file output file stream
+      */
+      virtual void writeConfig(std::ofstream& file);
+
+   private:
+
+      // Cartesian positions of atoms placed by this processor.
+      std::vector<Vector> positions_;
+
+      // Atom types of atoms placed by this processor.
+      std::vector<int> types_;
+
+      // Cell indices of atoms placed by this processor.
+      std::vector<long> cellIds_;
+
+      // Indices in positions_ of atoms in each occupied cell.
+      std::map<long, std::vector<int> > cells_;
+
+      // Pointers to Species objects.
+      DArray<Simp::Species*> species_;
+
+      // Excluded volume diameters of atom types.
+      DArray<double> diameters_;
+
+      // Index of the earlier atom bonded to each atom of a molecule.
+      DArray<int> parents_;
+
+      // Type of the bond to the parent of each atom of a molecule.
+      DArray<int> bondTypes_;
+
+      // Scaled positions of the atoms of a molecule.
+      DArray<Vector> molecule_;
+
+      // Cell grid dimensions.
+      int cellDimensions_[Dimension];
+
+      // Generator for first atoms, shared by all processors.
+      Simp::CounterRandom counterRandom_;
+
+      // Generator for random walks, seeded by processor rank.
+      Random random_;
+
+      // Pointer to parent Simulation.
+      Simulation* simulationPtr_;
+
+      // Temperature used to choose bond lengths.
+      double temperature_;
+
+      // Maximum type diameter.
+      double maxDiameter_;
+
+      // Number of species.
+      int nSpecies_;
+
+      // Seed for both random number generators.
+      int seed_;
+
+      // Maximum number of attempts to place each atom.
+      int maxAttempt_;
+
+      /**
+      * Compute parents and bond types for atoms of a species.
+      */
+      void setParents(const Simp::Species& species);
+
+      /**
+      * Attempt to place all atoms of a molecule.
+      */
+      bool placeMolecule(const Simp::Species& species, const Vector& first);
+
+      /**
+      * Add an atom position to the cell grid, if no overlap.
+      */
+      bool addPosition(const Vector& scaled, int typeId);
+
+      /**
+      * Remove the last n positions added to the cell grid.
+      */
+      void removePositions(int n);
+
+      /**
+      * Get cell index for a scaled position.
+      */
+      long cellIndex(const Vector& scaled, int (&coords)[Dimension]) const;
+
+      /**
+      * Add atoms of a generated molecule for later redistribution.
+      */
+      void addMolecule(const Simp::Species& species, int speciesId,
+                       int moleculeId, int atomOffset);
+
+      /**
+      * Queue groups of a generated molecule for their owners.
+      */
+      template <int N>
+      void addGroups(const Simp::Species& species, int nGroup,
+                     const Simp::SpeciesGroup<N>&
+                        (Simp::Species::*speciesGroup)(int) const,
+                     GroupDistributor<N>& distributor,
+                     int atomOffset, int groupOffset);
+
+   };
+
+}
+#endif
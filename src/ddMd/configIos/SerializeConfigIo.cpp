@@ -144,7 +144,11 @@ namespace DdMd
             }
             ar >> r;
             boundary().transformCartToGen(r, atomPtr->position());
-            ar >> atomPtr->velocity();
+            if (Atom::hasVelocity()) {
+               ar >> atomPtr->velocity();
+            } else {
+               ar >> r;
+            }
 
             // Add atom to list for sending.
             atomDistributor().addAtom();
@@ -263,7 +267,12 @@ namespace DdMd
                boundary().transformGenToCart(atomPtr->position(), r);
                ar << r;
             }
-            ar << atomPtr->velocity();
+            if (Atom::hasVelocity()) {
+               ar << atomPtr->velocity();
+            } else {
+               r.zero();
+               ar << r;
+            }
             atomPtr = atomCollector().nextPtr();
          }
 
@@ -4,6 +4,8 @@ ddMd_configIos_=\
    ddMd/configIos/DdMdOrderedConfigIo.cpp \
    ddMd/configIos/LammpsConfigIo.cpp \
    ddMd/configIos/SerializeConfigIo.cpp \
+   ddMd/configIos/DistributedConfigIo.cpp \
+   ddMd/configIos/GeneratorConfigIo.cpp \
    ddMd/configIos/ConfigIoFactory.cpp 
 
 ddMd_configIos_SRCS=\
@@ -6,6 +6,7 @@
 */
 
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/simulation/EnsembleScheduler.h>
 #include <util/param/ParamComponent.h>
 #include <util/global.h>
 
@@ -20,7 +21,7 @@ using namespace Util;
 *
 * Usage:
 *
-*    mpirun -np P ddSim [-e] [-s nSystem] 
+*    mpirun -np P ddSim [-e] [-s nSystem] [-j nRun]
 *                       [-p paramFile] [-r restartFile] [-c command] 
 *
 *    Here, P is the number of processors and paramFile is a parameter 
@@ -40,6 +41,14 @@ using namespace Util;
 *   to a different physical system to allow nSystem independent simulations. 
 *   The total communicator rank must be a multiple of nSystem.
 *
+*  -j nRun
+*
+*   Ensemble mode: run nRun independent simulations in directories
+*   0/, 1/, ..., on nSystem partitions (1 if -s is absent). Each partition
+*   starts the next unstarted run when it finishes the previous one,
+*   so that many short runs are balanced among the partitions (see
+*   DdMd::EnsembleScheduler). Other options apply to every run.
+*
 *  -p paramFile
 *
 *   Specifies the name of parameter file used for initialization.
@@ -63,6 +72,16 @@ int main(int argc, char **argv)
    #endif
 
    #ifdef UTIL_MPI
+   // Ensemble mode (option -j): run many simulations, then exit.
+   {
+      DdMd::EnsembleScheduler scheduler(MPI::COMM_WORLD);
+      if (scheduler.setOptions(argc, argv)) {
+         scheduler.run();
+         MPI::Finalize();
+         return 0;
+      }
+   }
+
    DdMd::Simulation simulation(MPI::COMM_WORLD);
    #else
    DdMd::Simulation simulation();
@@ -0,0 +1,357 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BondConstraints.h"
+#ifdef SIMP_BOND
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/BondStorage.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/chemistry/Group.h>
+#include <util/boundary/Boundary.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   BondConstraints::BondConstraints(Simulation& simulation)
+    : references_(),
+      multipliers_(),
+      atomConstraints_(),
+      lengths_(),
+      simulationPtr_(&simulation),
+      tolerance_(1.0E-8),
+      relaxation_(1.0),
+      maxIter_(100),
+      nIterPosition_(0),
+      nIterVelocity_(0)
+   {  setClassName("BondConstraints"); }
+
+   /*
+   * Destructor.
+   */
+   BondConstraints::~BondConstraints()
+   {}
+
+   /*
+   * Read lengths, tolerance and maxIter.
+   */
+   void BondConstraints::readParameters(std::istream& in)
+   {
+      int nBondType = simulationPtr_->nBondType();
+      readDArray<double>(in, "lengths", lengths_, nBondType);
+      read<double>(in, "tolerance", tolerance_);
+      read<int>(in, "maxIter", maxIter_);
+      if (tolerance_ <= 0.0) {
+         UTIL_THROW("tolerance must be positive");
+      }
+      if (maxIter_ < 1) {
+         UTIL_THROW("maxIter must be positive");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void BondConstraints::loadParameters(Serializable::IArchive &ar)
+   {
+      int nBondType = simulationPtr_->nBondType();
+      loadDArray<double>(ar, "lengths", lengths_, nBondType);
+      loadParameter<double>(ar, "tolerance", tolerance_);
+      loadParameter<int>(ar, "maxIter", maxIter_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void BondConstraints::save(Serializable::OArchive &ar)
+   {
+      ar << lengths_;
+      ar << tolerance_;
+      ar << maxIter_;
+   }
+
+   /*
+   * Allocate arrays indexed by bond storage index (private).
+   */
+   void BondConstraints::allocate()
+   {
+      if (!references_.isAllocated()) {
+         int capacity = simulationPtr_->bondStorage().capacity();
+         references_.allocate(capacity);
+         multipliers_.allocate(capacity);
+      }
+      if (!atomConstraints_.isAllocated()) {
+         int capacity = simulationPtr_->atomStorage().atomCapacity();
+         atomConstraints_.allocate(capacity);
+      }
+   }
+
+   /*
+   * Compute relaxation factor from maximum constraints per atom (private).
+   */
+   void BondConstraints::computeRelaxation()
+   {
+      BondStorage& storage = simulationPtr_->bondStorage();
+      int nBond = storage.size();
+      Atom* atomPtr;
+      int i, j, k;
+
+      // Zero counts of local atoms in constrained bonds
+      for (i = 0; i < nBond; ++i) {
+         Group<2>& bond = storage.group(i);
+         if (lengths_[bond.typeId()] > 0.0) {
+            for (j = 0; j < 2; ++j) {
+               atomPtr = bond.atomPtr(j);
+               if (!atomPtr->isGhost()) {
+                  atomConstraints_[atomPtr->localId() >> 1] = 0;
+               }
+            }
+         }
+      }
+
+      // Count constraints of local atoms, and find the maximum
+      int nMax = 0;
+      for (i = 0; i < nBond; ++i) {
+         Group<2>& bond = storage.group(i);
+         if (lengths_[bond.typeId()] > 0.0) {
+            for (j = 0; j < 2; ++j) {
+               atomPtr = bond.atomPtr(j);
+               if (!atomPtr->isGhost()) {
+                  k = ++atomConstraints_[atomPtr->localId() >> 1];
+                  if (k > nMax) {
+                     nMax = k;
+                  }
+               }
+            }
+         }
+      }
+      #ifdef UTIL_MPI
+      int nLocal = nMax;
+      simulationPtr_->domain().communicator().Allreduce(&nLocal, &nMax,
+                                                 1, MPI::INT, MPI::MAX);
+      #endif
+      relaxation_ = 2.0/double(1 + nMax);
+   }
+
+   /*
+   * Store bond vectors at beginning of a step.
+   */
+   void BondConstraints::storeReference()
+   {
+      allocate();
+      computeRelaxation();
+      BondStorage& storage = simulationPtr_->bondStorage();
+      const Boundary& boundary = simulationPtr_->boundary();
+      int nBond = storage.size();
+      for (int i = 0; i < nBond; ++i) {
+         Group<2>& bond = storage.group(i);
+         if (lengths_[bond.typeId()] > 0.0) {
+            boundary.distanceSq(bond.atomPtr(0)->position(),
+                                bond.atomPtr(1)->position(),
+                                references_[i]);
+         }
+      }
+   }
+
+   /*
+   * Iteratively correct positions (first stage of RATTLE).
+   */
+   void BondConstraints::constrainPositions(double dt)
+   {
+      Simulation& sim = *simulationPtr_;
+      BondStorage& storage = sim.bondStorage();
+      const Boundary& boundary = sim.boundary();
+      int nBond = storage.size();
+      Vector dr, dv;
+      Atom* atom0Ptr;
+      Atom* atom1Ptr;
+      double length, rsq, im0, im1;
+      bool isConverged;
+      int i, iter;
+
+      sim.exchanger().update();
+      for (iter = 0; iter < maxIter_; ++iter) {
+
+         // Compute multipliers for all bonds, from the same positions
+         isConverged = true;
+         for (i = 0; i < nBond; ++i) {
+            Group<2>& bond = storage.group(i);
+            length = lengths_[bond.typeId()];
+            if (length > 0.0) {
+               atom0Ptr = bond.atomPtr(0);
+               atom1Ptr = bond.atomPtr(1);
+               rsq = boundary.distanceSq(atom0Ptr->position(),
+                                         atom1Ptr->position(), dr);
+               length *= length;
+               if (std::fabs(length - rsq) > 2.0*tolerance_*length) {
+                  isConverged = false;
+               }
+               im0 = 1.0/sim.atomType(atom0Ptr->typeId()).mass();
+               im1 = 1.0/sim.atomType(atom1Ptr->typeId()).mass();
+               multipliers_[i] = relaxation_*(length - rsq)
+                               /(2.0*(im0 + im1)*dr.dot(references_[i]));
+            }
+         }
+         if (isConvergedAll(isConverged)) {
+            break;
+         }
+
+         // Apply corrections to local atoms
+         for (i = 0; i < nBond; ++i) {
+            Group<2>& bond = storage.group(i);
+            if (lengths_[bond.typeId()] > 0.0) {
+               atom0Ptr = bond.atomPtr(0);
+               atom1Ptr = bond.atomPtr(1);
+               if (!atom0Ptr->isGhost()) {
+                  im0 = 1.0/sim.atomType(atom0Ptr->typeId()).mass();
+                  dr.multiply(references_[i], multipliers_[i]*im0);
+                  atom0Ptr->position() += dr;
+                  dv.multiply(dr, 1.0/dt);
+                  atom0Ptr->velocity() += dv;
+               }
+               if (!atom1Ptr->isGhost()) {
+                  im1 = 1.0/sim.atomType(atom1Ptr->typeId()).mass();
+                  dr.multiply(references_[i], multipliers_[i]*im1);
+                  atom1Ptr->position() -= dr;
+                  dv.multiply(dr, 1.0/dt);
+                  atom1Ptr->velocity() -= dv;
+               }
+            }
+         }
+         sim.exchanger().update();
+      }
+      if (iter == maxIter_) {
+         UTIL_THROW("Position constraints did not converge");
+      }
+      nIterPosition_ = iter;
+   }
+
+   /*
+   * Iteratively correct velocities (second stage of RATTLE).
+   */
+   void BondConstraints::constrainVelocities(double dt)
+   {
+      Simulation& sim = *simulationPtr_;
+      BondStorage& storage = sim.bondStorage();
+      const Boundary& boundary = sim.boundary();
+      int nBond = storage.size();
+      Vector dr, dv;
+      Atom* atom0Ptr;
+      Atom* atom1Ptr;
+      double length, rsq, im0, im1;
+      bool isConverged;
+      int i, iter;
+
+      allocate();
+      computeRelaxation();
+      sim.exchanger().updateVelocities();
+      for (iter = 0; iter < maxIter_; ++iter) {
+
+         // Compute multipliers and bond vectors for all bonds
+         isConverged = true;
+         for (i = 0; i < nBond; ++i) {
+            Group<2>& bond = storage.group(i);
+            length = lengths_[bond.typeId()];
+            if (length > 0.0) {
+               atom0Ptr = bond.atomPtr(0);
+               atom1Ptr = bond.atomPtr(1);
+               rsq = boundary.distanceSq(atom0Ptr->position(),
+                                         atom1Ptr->position(),
+                                         references_[i]);
+               dv.subtract(atom0Ptr->velocity(), atom1Ptr->velocity());
+               if (std::fabs(dv.dot(references_[i]))*dt
+                   > tolerance_*rsq) {
+                  isConverged = false;
+               }
+               im0 = 1.0/sim.atomType(atom0Ptr->typeId()).mass();
+               im1 = 1.0/sim.atomType(atom1Ptr->typeId()).mass();
+               multipliers_[i] = -relaxation_*dv.dot(references_[i])
+                                 /((im0 + im1)*rsq);
+            }
+         }
+         if (isConvergedAll(isConverged)) {
+            break;
+         }
+
+         // Apply corrections to local atoms
+         for (i = 0; i < nBond; ++i) {
+            Group<2>& bond = storage.group(i);
+            if (lengths_[bond.typeId()] > 0.0) {
+               atom0Ptr = bond.atomPtr(0);
+               atom1Ptr = bond.atomPtr(1);
+               if (!atom0Ptr->isGhost()) {
+                  im0 = 1.0/sim.atomType(atom0Ptr->typeId()).mass();
+                  dv.multiply(references_[i], multipliers_[i]*im0);
+                  atom0Ptr->velocity() += dv;
+               }
+               if (!atom1Ptr->isGhost()) {
+                  im1 = 1.0/sim.atomType(atom1Ptr->typeId()).mass();
+                  dv.multiply(references_[i], multipliers_[i]*im1);
+                  atom1Ptr->velocity() -= dv;
+               }
+            }
+         }
+         sim.exchanger().updateVelocities();
+      }
+      if (iter == maxIter_) {
+         UTIL_THROW("Velocity constraints did not converge");
+      }
+      nIterVelocity_ = iter;
+   }
+
+   /*
+   * Count constrained bonds on all processors.
+   */
+   int BondConstraints::nConstraintTotal()
+   {
+      BondStorage& storage = simulationPtr_->bondStorage();
+      int nBond = storage.size();
+      int nLocal = 0;
+      for (int i = 0; i < nBond; ++i) {
+         Group<2>& bond = storage.group(i);
+         if (lengths_[bond.typeId()] > 0.0) {
+            if (!bond.atomPtr(0)->isGhost()) {
+               ++nLocal;
+            }
+         }
+      }
+      int nTotal = nLocal;
+      #ifdef UTIL_MPI
+      simulationPtr_->domain().communicator().Allreduce(&nLocal, &nTotal,
+                                                 1, MPI::INT, MPI::SUM);
+      #endif
+      return nTotal;
+   }
+
+   /*
+   * Logical AND of convergence flags of all processors (private).
+   */
+   bool BondConstraints::isConvergedAll(bool flag)
+   {
+      #ifdef UTIL_MPI
+      int local = flag ? 1 : 0;
+      int global = 0;
+      simulationPtr_->domain().communicator().Allreduce(&local, &global,
+                                                 1, MPI::INT, MPI::MIN);
+      return (global == 1);
+      #else
+      return flag;
+      #endif
+   }
+
+}
+#endif
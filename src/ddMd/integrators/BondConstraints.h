@@ -0,0 +1,202 @@
+#ifndef DDMD_BOND_CONSTRAINTS_H
+#define DDMD_BOND_CONSTRAINTS_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>  // base class
+#include <util/containers/DArray.h>     // member
+#include <util/space/Vector.h>          // member template parameter
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * Parallel RATTLE solver for fixed length bond constraints.
+   *
+   * Bonds of each type with a positive constraint length are held at
+   * that length by the RATTLE algorithm. Every processor treats every
+   * bond in its BondStorage, including bonds that span domain
+   * boundaries, and applies corrections only to its local atoms. Each
+   * iteration uses corrections computed for all bonds from the same
+   * configuration (Jacobi iteration), so that all processors that hold
+   * a bond compute the same correction, and is followed by an update of
+   * ghost positions (Exchanger::update) or velocities
+   * (Exchanger::updateVelocities). Iteration stops when the relative
+   * error of every constraint on every processor is below tolerance.
+   *
+   * Each correction would exactly satisfy its own constraint if applied
+   * alone. An atom that is shared by n constraints receives the sum of
+   * n such corrections, which overcorrects, and can make the iteration
+   * oscillate or diverge. All corrections are therefore multiplied by a
+   * relaxation factor 2/(1 + n), where n is the maximum number of
+   * constraints that share any atom, which is 1 for isolated bonds
+   * (no relaxation) and 2/3 for chains. Because this factor is the same
+   * for all bonds, corrections remain equal and opposite, and conserve
+   * momentum.
+   *
+   * Usage within a velocity-Verlet step:
+   * \code
+   *    constraints.storeReference();
+   *    // update velocities and positions of local atoms
+   *    constraints.constrainPositions(dt);
+   *    // exchange or update, compute forces, update velocities
+   *    constraints.constrainVelocities(dt);
+   * \endcode
+   *
+   * \ingroup DdMd_Integrator_Module
+   */
+   class BondConstraints : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation
+      */
+      BondConstraints(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~BondConstraints();
+
+      /**
+      * Read constraint lengths, tolerance and maximum iteration count.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Store bond vectors at the beginning of a step.
+      *
+      * Call before positions are updated, when ghost positions are
+      * consistent with those of the corresponding local atoms.
+      */
+      void storeReference();
+
+      /**
+      * Correct positions and velocities to satisfy length constraints.
+      *
+      * Corrections are along the bond vectors stored by storeReference().
+      * Positions of local atoms must be updated and Cartesian. Ghost
+      * positions are updated on return.
+      *
+      * \param dt time step
+      */
+      void constrainPositions(double dt);
+
+      /**
+      * Remove velocity components that would change constrained lengths.
+      *
+      * Call after the final velocity update of a step, when ghost
+      * positions are current. Ghost velocities are updated on entry.
+      *
+      * \param dt time step
+      */
+      void constrainVelocities(double dt);
+
+      /**
+      * Number of constrained bonds of all types (sum over processors).
+      *
+      * Bonds are counted once, by the processor that owns atom 0. The
+      * number of degrees of freedom is reduced by this number. Call on
+      * all processors.
+      */
+      int nConstraintTotal();
+
+      /**
+      * Number of iterations in last call to constrainPositions().
+      */
+      int nIterPosition() const;
+
+      /**
+      * Number of iterations in last call to constrainVelocities().
+      */
+      int nIterVelocity() const;
+
+   private:
+
+      /// Bond vectors at beginning of step, indexed by storage index.
+      DArray<Vector> references_;
+
+      /// Multipliers, indexed by storage index.
+      DArray<double> multipliers_;
+
+      /// Number of constraints of each local atom, indexed by localId/2.
+      DArray<int> atomConstraints_;
+
+      /// Constraint lengths, indexed by bond type (<= 0 if free).
+      DArray<double> lengths_;
+
+      /// Pointer to parent Simulation.
+      Simulation* simulationPtr_;
+
+      /// Relative tolerance for constraint errors.
+      double tolerance_;
+
+      /// Relaxation factor for all corrections (computed before use).
+      double relaxation_;
+
+      /// Maximum number of iterations per call.
+      int maxIter_;
+
+      /// Number of iterations in last position correction.
+      int nIterPosition_;
+
+      /// Number of iterations in last velocity correction.
+      int nIterVelocity_;
+
+      /**
+      * Return true on all processors iff flag is true on all.
+      */
+      bool isConvergedAll(bool flag);
+
+      /**
+      * Allocate private arrays, if necessary.
+      */
+      void allocate();
+
+      /**
+      * Compute relaxation_ from the number of constraints per atom.
+      *
+      * Call on all processors.
+      */
+      void computeRelaxation();
+
+   };
+
+   // Inline methods
+
+   inline int BondConstraints::nIterPosition() const
+   {  return nIterPosition_; }
+
+   inline int BondConstraints::nIterVelocity() const
+   {  return nIterVelocity_; }
+
+}
+#endif
@@ -13,6 +13,9 @@
 #include <ddMd/communicate/Exchanger.h>
 #include <ddMd/analyzers/AnalyzerManager.h>
 #include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/potentials/AtomStress.h>
+#include <ddMd/misc/BoundaryMetric.h>
+#include <ddMd/misc/Tracer.h>
 #ifdef SIMP_BOND
 #include <ddMd/potentials/bond/BondPotential.h>
 #endif
@@ -25,6 +28,9 @@
 #ifdef SIMP_EXTERNAL
 #include <ddMd/potentials/external/ExternalPotential.h>
 #endif
+#ifdef SIMP_COULOMB
+#include <ddMd/potentials/coulomb/CoulombPotential.h>
+#endif
 
 #include <util/ensembles/BoundaryEnsemble.h>
 #include <util/mpi/MpiLoader.h>
@@ -33,11 +39,24 @@
 #include <util/format/Bool.h>
 #include <util/global.h>
 
+#include <iomanip>
+
 namespace DdMd
 {
 
    class Simulation;
 
+   /*
+   * Phase names, in the order of the TimeId enumeration (file scope).
+   */
+   static const char* timeNames[] =
+        {"analyzer", "integrate1", "check", "allreduce",
+         "transform_f", "exchange", "celllist", "transform_r",
+         "pairlist", "update", "zero_force", "pair_force",
+         "bond_force", "angle_force", "dihedral_force",
+         "external_force", "coulomb_force", "integrate2",
+         "modifier", "debug", "signal", "misc"};
+
    /*
    * Constructor.
    */
@@ -46,8 +65,41 @@ namespace DdMd
        timer_(Integrator::NTime),
        isSetup_(false),
        saveFileName_(),
-       saveInterval_(0)
-   {}
+       saveInterval_(0),
+       overlapUpdate_(false),
+       balanceInterval_(0),
+       balanceByTime_(false),
+       balanceTime_(0.0),
+       skinTuneInterval_(0),
+       minSkin_(0.0),
+       maxSkin_(0.0),
+       tunePairTime_(0.0),
+       tuneBuildTime_(0.0),
+       tuneBuildCounter_(0),
+       tuneStep_(-1),
+       asyncExchangeCheck_(false),
+       #ifdef UTIL_MPI
+       hasExchangeCheck_(false),
+       exchangeCheckSend_(0.0),
+       exchangeCheckRecv_(0.0),
+       #endif
+       snapshotLengths_(),
+       exchangeDisp_(0.0),
+       rebuildDisp_(0.0),
+       localMaxDisp_(-1.0),
+       stepMaxSqDisp_(-1.0)
+   {
+      #ifdef DDMD_PERF_COUNTERS
+      timer_.enableCounters();
+      #endif
+
+      // Register phase names with the Tracer, as consecutive ids.
+      int first = Tracer::nameId(timeNames[0]);
+      for (int i = 1; i < NTime; ++i) {
+         UTIL_CHECK(Tracer::nameId(timeNames[i]) == first + i);
+      }
+      timer_.setTraceId(first);
+   }
 
    /*
    * Destructor.
@@ -71,6 +123,25 @@ namespace DdMd
          }
          read<std::string>(in, "saveFileName", saveFileName_);
       }
+      overlapUpdate_ = false;
+      readOptional<bool>(in, "overlapUpdate", overlapUpdate_);
+      balanceInterval_ = 0;
+      readOptional<int>(in, "balanceInterval", balanceInterval_);
+      if (balanceInterval_ > 0) {
+         balanceByTime_ = false;
+         readOptional<bool>(in, "balanceByTime", balanceByTime_);
+      }
+      skinTuneInterval_ = 0;
+      readOptional<int>(in, "skinTuneInterval", skinTuneInterval_);
+      if (skinTuneInterval_ > 0) {
+         read<double>(in, "minSkin", minSkin_);
+         read<double>(in, "maxSkin", maxSkin_);
+         if (minSkin_ <= 0.0 || maxSkin_ < minSkin_) {
+            UTIL_THROW("Invalid minSkin or maxSkin");
+         }
+      }
+      asyncExchangeCheck_ = false;
+      readOptional<bool>(in, "asyncExchangeCheck", asyncExchangeCheck_);
    }
 
    /*
@@ -89,6 +160,23 @@ namespace DdMd
          }
          loadParameter<std::string>(ar, "saveFileName", saveFileName_);
       }
+      overlapUpdate_ = false;
+      loadParameter<bool>(ar, "overlapUpdate", overlapUpdate_, false);
+      balanceInterval_ = 0;
+      loadParameter<int>(ar, "balanceInterval", balanceInterval_, false);
+      if (balanceInterval_ > 0) {
+         balanceByTime_ = false;
+         loadParameter<bool>(ar, "balanceByTime", balanceByTime_, false);
+      }
+      skinTuneInterval_ = 0;
+      loadParameter<int>(ar, "skinTuneInterval", skinTuneInterval_, false);
+      if (skinTuneInterval_ > 0) {
+         loadParameter<double>(ar, "minSkin", minSkin_);
+         loadParameter<double>(ar, "maxSkin", maxSkin_);
+      }
+      asyncExchangeCheck_ = false;
+      loadParameter<bool>(ar, "asyncExchangeCheck", asyncExchangeCheck_,
+                          false);
 
       MpiLoader<Serializable::IArchive> loader(*this, ar);
       loader.load(iStep_);
@@ -104,6 +192,17 @@ namespace DdMd
       if (saveInterval_ > 0) {
          ar << saveFileName_;
       }
+      Parameter::saveOptional(ar, overlapUpdate_, overlapUpdate_);
+      Parameter::saveOptional(ar, balanceInterval_, (balanceInterval_ > 0));
+      if (balanceInterval_ > 0) {
+         Parameter::saveOptional(ar, balanceByTime_, balanceByTime_);
+      }
+      Parameter::saveOptional(ar, skinTuneInterval_, (skinTuneInterval_ > 0));
+      if (skinTuneInterval_ > 0) {
+         ar << minSkin_;
+         ar << maxSkin_;
+      }
+      Parameter::saveOptional(ar, asyncExchangeCheck_, asyncExchangeCheck_);
       ar << iStep_;
       ar << isSetup_;
    }
@@ -113,16 +212,23 @@ namespace DdMd
    */
    void Integrator::setupAtoms()
    {
-      // Precondition
+      // Preconditions
       if (atomStorage().isCartesian()) {
          UTIL_THROW("Atom coordinates are Cartesian");
       }
+      if (needsVelocity() && !Atom::hasVelocity()) {
+         UTIL_THROW("Integrator requires velocities, but hasVelocity = 0");
+      }
+
+      DdTimer& startupTimer = simulation().startupTimer();
+      startupTimer.start();
 
       atomStorage().clearSnapshot();
       exchanger().exchange();
       pairPotential().buildCellList();
       atomStorage().transformGenToCart(boundary());
       atomStorage().makeSnapshot();
+      resetExchangeCheck();
       pairPotential().buildPairList();
       if (simulation().boundaryEnsemble().isRigid()) {
          simulation().computeForces();
@@ -130,16 +236,25 @@ namespace DdMd
          simulation().computeForcesAndVirial();
       }
 
+      startupTimer.stamp(Simulation::STARTUP_SETUP);
+      startupTimer.stop();
+
       // Postcondition - coordinates are Cartesian
       if (!atomStorage().isCartesian()) {
          UTIL_THROW("Atom coordinates are not Cartesian");
       }
    }
 
+   /*
+   * Default: integrator uses velocities.
+   */
+   bool Integrator::needsVelocity() const
+   {  return true; }
+
    /*
    * Compute forces for all atoms, with timing.
    */
-   void Integrator::computeForces()
+   void Integrator::computeForces(bool needEnergy)
    {
       // Precondition
       if (!atomStorage().isCartesian()) {
@@ -149,85 +264,142 @@ namespace DdMd
       timer_.stamp(MISC);
       simulation().zeroForces();
       timer_.stamp(ZERO_FORCE);
-      pairPotential().computeForces();
-      timer_.stamp(PAIR_FORCE);
-      #ifdef SIMP_BOND
-      if (nBondType()) {
-         bondPotential().computeForces();
-         timer_.stamp(BOND_FORCE);
-      }
-      #endif
-      #ifdef SIMP_ANGLE
-      if (nAngleType()) {
-         anglePotential().computeForces();
-         timer_.stamp(ANGLE_FORCE);
-      }
-      #endif
-      #ifdef SIMP_DIHEDRAL
-      if (nDihedralType()) {
-         dihedralPotential().computeForces();
-         timer_.stamp(DIHEDRAL_FORCE);
-      }
-      #endif
-      #ifdef SIMP_EXTERNAL
-      if (hasExternal()) {
-         externalPotential().computeForces();
-         timer_.stamp(EXTERNAL_FORCE);
+      if (needEnergy) {
+         pairPotential().computeForcesAndEnergy(domain().communicator(), 
+                                                false);
+      } else {
+         pairPotential().computeForces();
       }
-      #endif
+      timer_.stamp(PAIR_FORCE);
+      computeNonPairForces(needEnergy, false);
+   }
 
-      // Reverse communication (if any)
-      if (reverseUpdateFlag()) {
-         exchanger().reverseUpdate();
+   /*
+   * Compute forces for all local atoms and virial, with timing.
+   */
+   void Integrator::computeForcesAndVirial(bool needEnergy)
+   {
+      // Precondition
+      if (!atomStorage().isCartesian()) {
+         UTIL_THROW("Atom coordinates are not Cartesian");
       }
 
-      // Send signal indicating change in atomic forces
-      // simulation().forceSignal().notify();
+      timer_.stamp(MISC);
+      simulation().zeroForces();
+      timer_.stamp(ZERO_FORCE);
+      if (needEnergy) {
+         pairPotential().computeForcesAndEnergy(domain().communicator(), 
+                                                true);
+      } else {
+         pairPotential().computeForcesAndStress(domain().communicator());
+      }
+      timer_.stamp(PAIR_FORCE);
+      computeNonPairForces(needEnergy, true);
    }
 
    /*
-   * Compute forces for all local atoms and virial, with timing.
+   * Update ghost positions and compute forces, with overlap and timing.
    */
-   void Integrator::computeForcesAndVirial()
+   void Integrator::updateAndComputeForces()
    {
-      // Precondition
+      // Preconditions
       if (!atomStorage().isCartesian()) {
          UTIL_THROW("Atom coordinates are not Cartesian");
       }
+      if (pairPotential().methodId() != 0) {
+         UTIL_THROW("Overlapped update requires a pair list");
+      }
 
       timer_.stamp(MISC);
       simulation().zeroForces();
       timer_.stamp(ZERO_FORCE);
-      pairPotential().computeForcesAndStress(domain().communicator());
+
+      // Compute forces between local atoms in chunks, and advance the 
+      // ghost update (wait, unpack, post next message) after each chunk.
+      const int nAtom = pairPotential().pairList().nAtom();
+      const int nChunk = 2*Dimension;
+      int i, begin, end;
+      exchanger().beginUpdate();
+      begin = 0;
+      for (i = 0; i < nChunk; ++i) {
+         end = (nAtom*(i+1))/nChunk;
+         pairPotential().computeInteriorForces(begin, end);
+         begin = end;
+         exchanger().continueUpdate();
+      }
+      while (exchanger().continueUpdate()) {}
+      timer_.stamp(UPDATE);
+
+      // Compute pair forces that require ghost positions
+      pairPotential().computeBoundaryForces();
       timer_.stamp(PAIR_FORCE);
+      computeNonPairForces(false, false);
+   }
+
+   /*
+   * Compute all forces other than pair forces, with timing (private).
+   */
+   void Integrator::computeNonPairForces(bool needEnergy, bool needStress)
+   {
       #ifdef SIMP_BOND
       if (nBondType()) {
-         bondPotential().computeForcesAndStress(domain().communicator());
+         if (needStress) {
+            bondPotential().computeForcesAndStress(domain().communicator());
+         } else {
+            bondPotential().computeForces();
+         }
          timer_.stamp(BOND_FORCE);
       }
       #endif
       #ifdef SIMP_ANGLE
       if (nAngleType()) {
-         anglePotential().computeForcesAndStress(domain().communicator());
+         if (needStress) {
+            anglePotential().computeForcesAndStress(domain().communicator());
+         } else {
+            anglePotential().computeForces();
+         }
          timer_.stamp(ANGLE_FORCE);
       }
       #endif
       #ifdef SIMP_DIHEDRAL
       if (nDihedralType()) {
-         dihedralPotential().computeForcesAndStress(domain().communicator());
+         if (needStress) {
+            dihedralPotential().computeForcesAndStress(domain().communicator());
+         } else {
+            dihedralPotential().computeForces();
+         }
          timer_.stamp(DIHEDRAL_FORCE);
       }
       #endif
       #ifdef SIMP_EXTERNAL
       if (hasExternal()) {
-         externalPotential().computeForces();
+         if (needEnergy) {
+            externalPotential().computeForcesAndEnergy(domain().communicator(),
+                                                       false);
+         } else {
+            externalPotential().computeForces();
+         }
          timer_.stamp(EXTERNAL_FORCE);
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (simulation().hasCoulomb()) {
+         if (needStress) {
+            simulation().coulombPotential()
+                        .computeForcesAndStress(domain().communicator());
+         } else {
+            simulation().coulombPotential().computeForces();
+         }
+         timer_.stamp(COULOMB_FORCE);
+      }
+      #endif
 
       // Reverse communication (if any)
       if (reverseUpdateFlag()) {
          exchanger().reverseUpdate();
+         if (simulation().atomStress().isActive()) {
+            exchanger().reverseUpdate(simulation().atomStress());
+         }
       }
 
       // Send signal indicating change in atomic forces
@@ -244,13 +416,55 @@ namespace DdMd
          UTIL_THROW("Error: Coordinates not Cartesian in isExchangeNeeded");
       } 
 
-      // Calculate maximum square displacment on this node
-      double maxSqDisp = atomStorage().maxSqDisplacement(); 
-      int    needed = 0;
+      // Allot part of the skin to box strain since the snapshot, if any
+      Vector lengths = boundary().lengths();
+      Vector scale;
+      double strain = 0.0;
+      for (int i = 0; i < Dimension; ++i) {
+         scale[i] = lengths[i]/snapshotLengths_[i];
+         if (fabs(scale[i] - 1.0) > strain) {
+            strain = fabs(scale[i] - 1.0);
+         }
+      }
+      skin -= strain*pairPotential().cutoff();
+
+      // Calculate maximum square (non-affine) displacment on this node
+      // Use value measured during integrateStep1(), if valid.
+      double maxSqDisp;
+      bool isStepValue = false;
+      if (strain > 0.0) {
+         maxSqDisp = atomStorage().maxSqDisplacement(scale);
+      } else
+      if (stepMaxSqDisp_ >= 0.0) {
+         maxSqDisp = stepMaxSqDisp_;
+         isStepValue = true;
+      } else {
+         maxSqDisp = atomStorage().maxSqDisplacement();
+      }
+      stepMaxSqDisp_ = -1.0;
+      localMaxDisp_ = sqrt(maxSqDisp);
+      timer_.stamp(CHECK);
+
+      #if defined(UTIL_MPI) && MPI_VERSION >= 3
+      // Complete any reduction posted by setMaxSqDisplacement(). Its
+      // result is the global maximum of the same value, if still valid.
+      if (hasExchangeCheck_) {
+         MPI_Wait(&exchangeCheckRequest_, MPI_STATUS_IGNORE);
+         hasExchangeCheck_ = false;
+         timer_.stamp(ALLREDUCE);
+         if (isStepValue) {
+            return bool(skin <= 0.0 || exchangeCheckRecv_ > 0.5*skin);
+         }
+      }
+      #endif
+      if (skin <= 0.0) {
+         return true;
+      }
+
+      int needed = 0;
       if (sqrt(maxSqDisp) > 0.5*skin) {
          needed = 1; 
       }
-      timer_.stamp(CHECK);
 
       #if UTIL_MPI
       int neededAll;
@@ -263,6 +477,249 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Determine whether a pair list rebuild requires an atom exchange.
+   */
+   bool Integrator::isFullExchangeNeeded()
+   {
+      double slack = pairPotential().exchangeSkin() - pairPotential().skin();
+      slack *= 0.5;
+      if (slack <= 0.0 || pairPotential().halfShell()) {
+         return true;
+      }
+      // Only the pair list handles local atoms outside the domain
+      if (pairPotential().methodId() != 0
+          || pairPotential().reverseUpdateFlag()) {
+         return true;
+      }
+      if (!simulation().boundaryEnsemble().isRigid()) {
+         return true;
+      }
+
+      double localMaxDisp = sqrt(atomStorage().maxSqDisplacement());
+      #ifdef UTIL_MPI
+      domain().communicator().Allreduce(&localMaxDisp, &rebuildDisp_,
+                                        1, MPI::DOUBLE, MPI::MAX);
+      timer_.stamp(ALLREDUCE);
+      #else
+      rebuildDisp_ = localMaxDisp;
+      #endif
+      return bool(exchangeDisp_ + rebuildDisp_ > slack);
+   }
+
+   /*
+   * Rebuild cell and pair lists from existing ghosts, without exchange.
+   */
+   void Integrator::rebuildPairList()
+   {
+      if (!atomStorage().isCartesian()) {
+         UTIL_THROW("Error: Coordinates not Cartesian in rebuildPairList");
+      }
+
+      // Update ghost positions
+      exchanger().update();
+      timer_.stamp(UPDATE);
+
+      // Build cell list in scaled coordinates
+      atomStorage().clearSnapshot();
+      atomStorage().transformCartToGen(boundary());
+      timer_.stamp(TRANSFORM_F);
+      pairPotential().buildCellList();
+      timer_.stamp(CELLLIST);
+      atomStorage().transformGenToCart(boundary());
+      timer_.stamp(TRANSFORM_R);
+
+      // Build pair list, keeping the displacement since the last exchange
+      atomStorage().makeSnapshot();
+      double exchangeDisp = exchangeDisp_ + rebuildDisp_;
+      resetExchangeCheck();
+      exchangeDisp_ = exchangeDisp;
+      pairPotential().buildPairList();
+      timer_.stamp(PAIRLIST);
+   }
+
+   /*
+   * Set max squared displacement measured by integrateStep1().
+   */
+   void Integrator::setMaxSqDisplacement(double maxSqDisp)
+   {
+      stepMaxSqDisp_ = maxSqDisp;
+      #if defined(UTIL_MPI) && MPI_VERSION >= 3
+      // Post the reduction completed by isExchangeNeeded(), if enabled
+      if (hasExchangeCheck_) {
+         MPI_Wait(&exchangeCheckRequest_, MPI_STATUS_IGNORE);
+         hasExchangeCheck_ = false;
+      }
+      if (asyncExchangeCheck_ && maxSqDisp >= 0.0) {
+         exchangeCheckSend_ = sqrt(maxSqDisp);
+         MPI_Iallreduce(&exchangeCheckSend_, &exchangeCheckRecv_, 1,
+                        MPI_DOUBLE, MPI_MAX,
+                        (MPI_Comm)domain().communicator(),
+                        &exchangeCheckRequest_);
+         hasExchangeCheck_ = true;
+      }
+      #endif
+   }
+
+   /*
+   * Enable a boundary cell scan in the next exchange, if possible.
+   */
+   void Integrator::enableBoundaryScan()
+   {
+      if (localMaxDisp_ < 0.0) return;
+      exchanger().setBoundaryScan(pairPotential().cellList(), localMaxDisp_);
+      localMaxDisp_ = -1.0;
+   }
+
+   /*
+   * Discard any exchange check reduction after a new snapshot.
+   */
+   void Integrator::resetExchangeCheck()
+   {
+      #if defined(UTIL_MPI) && MPI_VERSION >= 3
+      if (hasExchangeCheck_) {
+         MPI_Wait(&exchangeCheckRequest_, MPI_STATUS_IGNORE);
+         hasExchangeCheck_ = false;
+      }
+      #endif
+      snapshotLengths_ = boundary().lengths();
+      exchangeDisp_ = 0.0;
+      localMaxDisp_ = -1.0;
+      stepMaxSqDisp_ = -1.0;
+   }
+
+   /*
+   * Total time spent computing forces on this processor.
+   */
+   double Integrator::forceTime()
+   {
+      double time = 0.0;
+      for (int i = PAIR_FORCE; i <= COULOMB_FORCE; ++i) {
+         time += timer_.localTime(i);
+      }
+      return time;
+   }
+
+   /*
+   * Move domain boundaries to balance load, if scheduled.
+   */
+   bool Integrator::balanceDomains()
+   {
+      if (balanceInterval_ <= 0) return false;
+      if (iStep_ % balanceInterval_ != 0) return false;
+
+      // Load on this processor: force time since last call, or # atoms
+      double load;
+      if (balanceByTime_) {
+         double time = forceTime();
+         load = time - balanceTime_;
+         balanceTime_ = time;
+      } else {
+         load = double(atomStorage().nAtom());
+      }
+
+      // Require domains wider than the ghost cutoff, with a margin
+      Vector minWidths;
+      for (int i = 0; i < Dimension; ++i) {
+         minWidths[i] = scaledWidth(boundary(),
+                                    1.05*pairPotential().ghostCutoff(), i);
+      }
+      return domain().balance(load, minWidths, 0.5);
+   }
+
+   /*
+   * Adjust the pair list skin to minimize time per step, if scheduled.
+   */
+   bool Integrator::tuneSkin()
+   {
+      if (skinTuneInterval_ <= 0) return false;
+      if (iStep_ % skinTuneInterval_ != 0) return false;
+
+      // Costs accumulated on this processor since the previous call
+      double pairTime  = timer_.localTime(PAIR_FORCE);
+      double buildTime = timer_.localTime(TRANSFORM_F)
+                       + timer_.localTime(EXCHANGE)
+                       + timer_.localTime(CELLLIST)
+                       + timer_.localTime(TRANSFORM_R)
+                       + timer_.localTime(PAIRLIST);
+      int buildCounter = pairPotential().pairList().buildCounter();
+      double localCosts[2];
+      double costs[2];
+      localCosts[0] = pairTime - tunePairTime_;
+      localCosts[1] = buildTime - tuneBuildTime_;
+      int nStep  = iStep_ - tuneStep_;
+      int nBuild = buildCounter - tuneBuildCounter_;
+      int isValid = 1;
+      if (tuneStep_ < 0 || nStep <= 0 || nBuild < 0) isValid = 0;
+      if (localCosts[0] < 0.0 || localCosts[1] < 0.0) isValid = 0;
+      tunePairTime_ = pairTime;
+      tuneBuildTime_ = buildTime;
+      tuneBuildCounter_ = buildCounter;
+      tuneStep_ = iStep_;
+
+      // Use costs on slowest processor; also find smallest domain width.
+      double localWidth = 1.0/scaledWidth(boundary(), 1.0, 0);
+      for (int i = 0; i < Dimension; ++i) {
+         double width = (domain().domainBound(i, 1) 
+                      - domain().domainBound(i, 0))
+                      /scaledWidth(boundary(), 1.0, i);
+         if (width < localWidth) localWidth = width;
+      }
+      double minWidth;
+      int allValid;
+      #ifdef UTIL_MPI
+      MPI::Intracomm& communicator = domain().communicator();
+      communicator.Allreduce(localCosts, costs, 2, MPI::DOUBLE, MPI::MAX);
+      communicator.Allreduce(&isValid, &allValid, 1, MPI::INT, MPI::MIN);
+      communicator.Allreduce(&localWidth, &minWidth, 1, MPI::DOUBLE, MPI::MIN);
+      #else
+      costs[0] = localCosts[0];
+      costs[1] = localCosts[1];
+      allValid = isValid;
+      minWidth = localWidth;
+      #endif
+      if (!allValid) return false;
+      if (nBuild == 0) nBuild = 1; // Lower bound for rebuild rate
+
+      // Model the time per step as a function of skin s. Pair force and 
+      // rebuild costs scale as (r + s)^3, where r = maxPairCutoff, and the 
+      // number of steps between rebuilds is proportional to s.
+      double skin = pairPotential().skin();
+      double cutoff = pairPotential().cutoff();
+      double range = cutoff - skin;
+      double forceCost = costs[0]/double(nStep);
+      double buildCost = costs[1]/double(nBuild);
+      double stepsPerBuild = double(nStep)/double(nBuild);
+      double maxSkin = maxSkin_;
+      if (minWidth/1.05 - range < maxSkin) {
+         maxSkin = minWidth/1.05 - range;
+      }
+      if (maxSkin < minSkin_) return false;
+
+      const int nScan = 100;
+      double s, ratio, cost;
+      double bestSkin = skin;
+      double bestCost = -1.0;
+      for (int k = 0; k <= nScan; ++k) {
+         s = minSkin_ + (maxSkin - minSkin_)*double(k)/double(nScan);
+         ratio = (range + s)/cutoff;
+         cost = (forceCost + buildCost*skin/(s*stepsPerBuild))
+                *ratio*ratio*ratio;
+         if (bestCost < 0.0 || cost < bestCost) {
+            bestCost = cost;
+            bestSkin = s;
+         }
+      }
+
+      // Apply a damped change, if significant.
+      double newSkin = skin + 0.5*(bestSkin - skin);
+      if (fabs(newSkin - skin) < 0.01*skin) return false;
+      pairPotential().setSkin(newSkin);
+      simulation().exchanger().setPairCutoff(pairPotential().ghostCutoff());
+      simulation().exchanger().setGroupMargin(newSkin);
+      return true;
+   }
+
    #if 0
    /*
    * Determine whether an atom exchange and reneighboring is needed.
@@ -309,6 +766,12 @@ namespace DdMd
    double Integrator::time() const
    {  return timer_.time(); }
 
+   /*
+   * Return number of constraints (none by default).
+   */
+   int Integrator::nConstraintTotal()
+   {  return 0; }
+
    /*
    * Reduce timing statistics data from all processors.
    */
@@ -316,6 +779,7 @@ namespace DdMd
    {  
       #ifdef UTIL_MPI
       timer().reduce(domain().communicator());  
+      simulation().analyzerManager().timer().reduce(domain().communicator());
       #endif
    }
 
@@ -342,6 +806,8 @@ namespace DdMd
       out << "run time             " << time << " sec" << std::endl;
       out << "time / nStep         " << time/double(iStep_) 
           << " sec" << std::endl;
+      out << "max time / avg time  " 
+          << (time > 0.0 ? timer().maxTime()/time : 1.0) << std::endl;
 
 
       double factor1 = 1.0/double(iStep_);
@@ -482,6 +948,17 @@ namespace DdMd
              << "   " << Dbl(100.0*externalForceT/time, 12 , 6, true) << std::endl;
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (simulation().hasCoulomb()) {
+         double coulombForceT = timer().time(COULOMB_FORCE);
+         totalT += coulombForceT;
+         out << "Coulomb Forces       " 
+             << Dbl(coulombForceT*factor1, 12, 6) 
+             << "   "
+             << Dbl(coulombForceT*factor2, 12, 6)
+             << "   " << Dbl(100.0*coulombForceT/time, 12 , 6, true) << std::endl;
+      }
+      #endif
       double integrate2T = timer().time(INTEGRATE2);
       totalT += integrate2T;
       out << "Integrate2           " 
@@ -496,6 +973,30 @@ namespace DdMd
           << "   "
           << Dbl(analyzerT*factor2, 12, 6)
           << "   " << Dbl(100.0*analyzerT/time, 12, 6, true) << std::endl;
+
+      // Output time of each analyzer, and of concurrent local sampling
+      AnalyzerManager& analyzerManager = simulation().analyzerManager();
+      DdTimer& analyzerTimer = analyzerManager.timer();
+      int nAnalyzer = analyzerManager.size();
+      if (nAnalyzer > 0 && analyzerTimer.size() == nAnalyzer + 1) {
+         std::string name;
+         double t;
+         for (int i = 0; i <= nAnalyzer; ++i) {
+            t = analyzerTimer.time(i);
+            if (i < nAnalyzer) {
+               name = "  " + analyzerManager[i].className();
+            } else {
+               if (t <= 0.0) continue;
+               name = "  (concurrent)";
+            }
+            if (name.size() > 20) name.resize(20);
+            out << std::left << std::setw(21) << name << std::right
+                << Dbl(t*factor1, 12, 6)
+                << "   "
+                << Dbl(t*factor2, 12, 6)
+                << "   " << Dbl(100.0*t/time, 12, 6, true) << std::endl;
+         }
+      }
       #ifdef DDMD_MODIFIERS
       double modifierT = timer().time(MODIFIER);
       totalT += modifierT;
@@ -507,6 +1008,37 @@ namespace DdMd
       #endif
       out << std::endl;
 
+      // Output hardware counters per step, if any
+      if (timer().hasCounters()) {
+         double cycles, instructions, references, misses, t;
+         out << "Hardware Counters (per step, average per processor)"
+             << std::endl;
+         out << "                     "
+             << "      cycles  "
+             << "         IPC  "
+             << " LLC miss (%)  "
+             << "  LLC misses  "
+             << "  est. GB/s" << std::endl;
+         for (int i = 0; i < NTime; ++i) {
+            cycles = timer().count(i, PerfCounters::Cycles);
+            if (cycles <= 0.0) continue;
+            instructions = timer().count(i, PerfCounters::Instructions);
+            references = timer().count(i, PerfCounters::CacheReferences);
+            misses = timer().count(i, PerfCounters::CacheMisses);
+            t = timer().time(i);
+            out << std::left << std::setw(21) << timeNames[i]
+                << std::right
+                << Dbl(cycles*factor1, 12, 4) << "  "
+                << Dbl(instructions/cycles, 12, 4) << "  "
+                << Dbl(references > 0.0 ? 100.0*misses/references : 0.0,
+                       12, 4) << "  "
+                << Dbl(misses*factor1, 12, 4) << "  "
+                << Dbl(t > 0.0 ? 64.0*misses/(t*1.0E9) : 0.0, 12, 4)
+                << std::endl;
+         }
+         out << std::endl;
+      }
+
       // Output info about timer resolution
       double tick = MPI::Wtick();
       out << "Timer resolution     " 
@@ -529,12 +1061,50 @@ namespace DdMd
 
    }
 
+   /*
+   * Output per-phase timing and imbalance data in CSV format.
+   */
+   void Integrator::outputPerformance(std::ostream& out)
+   {
+      if (!domain().isMaster()) {
+         UTIL_THROW("May be called only on domain master");
+      }
+      UTIL_CHECK(iStep_ > 0);
+
+      double factor = 1.0/double(iStep_);
+      double avg = timer().time();
+      double max = timer().maxTime();
+      out << "phase,avg,min,max,imbalance" << std::endl;
+      out << "total," << avg*factor << "," << avg*factor << "," 
+          << max*factor << "," << (avg > 0.0 ? max/avg : 1.0) 
+          << std::endl;
+      for (int i = 0; i < NTime; ++i) {
+         if (timer().maxTime(i) > 0.0) {
+            out << timeNames[i] << ","
+                << timer().time(i)*factor << ","
+                << timer().minTime(i)*factor << ","
+                << timer().maxTime(i)*factor << ","
+                << timer().imbalance(i) << std::endl;
+         }
+      }
+      out << std::endl;
+
+      Buffer& buffer = simulation().buffer();
+      out << "nStep," << iStep_ << std::endl;
+      out << "messages," << buffer.nSend() << std::endl;
+      out << "bytes_total," << buffer.totalSendBytes() << std::endl;
+      out << "bytes_max_proc," << buffer.maxProcSendBytes() << std::endl;
+      out << "bytes_max_message," << buffer.maxSendBytes() << std::endl;
+   }
+
    /*
    * Clear timing, dynamical state, statistics, and analyzer accumulators.
    */
    void Integrator::clear()
    { 
       iStep_ = 0;
+      balanceTime_ = 0.0;
+      tuneStep_ = -1;
       initDynamicalState();
       timer().clear(); 
       simulation().exchanger().timer().clear();
@@ -4,6 +4,7 @@
 #include <util/param/ParamComposite.h>          // base class
 #include <ddMd/simulation/SimulationAccess.h>   // base class
 #include <ddMd/misc/DdTimer.h>                  // member
+#include <util/space/Vector.h>                  // member
 
 #include <iostream>
 
@@ -103,11 +104,33 @@ namespace DdMd
       */
       virtual void outputStatistics(std::ostream& out);
 
+      /**
+      * Output machine-readable per-phase timing and load imbalance data.
+      *
+      * Writes one comma-separated line per timed phase, with columns
+      * phase, avg, min, max and imbalance, giving the time per step
+      * averaged over processors, its minimum and maximum over processors,
+      * and the ratio max/avg. A final block gives message traffic from
+      * the Buffer. Call computeStatistics() on all processors and 
+      * Buffer::computeStatistics() before calling this on the master.
+      *
+      * \param out output stream to which to write data.
+      */
+      void outputPerformance(std::ostream& out);
+
       /**
       * Get average time per processor of previous run.
       */
       double time() const;
 
+      /**
+      * Get the number of holonomic constraints (sum over processors).
+      *
+      * The number of degrees of freedom is 3*nAtom minus this number.
+      * Default implementation returns 0. Call on all processors.
+      */
+      virtual int nConstraintTotal();
+
       /**
       * Get current time step index.
       */
@@ -119,7 +142,8 @@ namespace DdMd
       enum TimeId {ANALYZER, INTEGRATE1, CHECK, ALLREDUCE, TRANSFORM_F, 
                    EXCHANGE, CELLLIST, TRANSFORM_R, PAIRLIST, UPDATE, 
                    ZERO_FORCE, PAIR_FORCE, BOND_FORCE, ANGLE_FORCE, 
-                   DIHEDRAL_FORCE, EXTERNAL_FORCE, INTEGRATE2, 
+                   DIHEDRAL_FORCE, EXTERNAL_FORCE, COULOMB_FORCE, 
+                   INTEGRATE2, 
                    MODIFIER, DEBUG, SIGNAL, MISC, NTime};
 
       /**
@@ -156,10 +180,20 @@ namespace DdMd
       * Setup state of atoms just before integration.
       *
       * Exchange atoms, build PairList and compute Forces.
-      * Should be called in all subclass setup methods.
+      * Should be called in all subclass setup methods. Throws an
+      * Exception if needsVelocity() is true but Atom::hasVelocity()
+      * is false.
       */
       void setupAtoms();
 
+      /**
+      * Does this integrator use atomic velocities?
+      *
+      * Default implementation returns true. Integrators of overdamped
+      * dynamics may return false, and then run without velocities.
+      */
+      virtual bool needsVelocity() const;
+
       /**
       * Compute forces for all local atoms, with timing.
       *
@@ -167,8 +201,14 @@ namespace DdMd
       * Upon return, forces are correct for all local atoms. Values
       * of the forces on ghost atoms are undefined. Executes reverse
       * communication if needed, and emits Simulation::forceSignal().
+      *
+      * If needEnergy is true, the pair and external energies are computed
+      * in the same loops as the corresponding forces, by calling 
+      * Potential::computeForcesAndEnergy.
+      *
+      * \param needEnergy  if true, also compute pair and external energies
       */
-      void computeForces();
+      void computeForces(bool needEnergy = false);
 
       /**
       * Compute forces for all local atoms and virial, with timing.
@@ -177,17 +217,149 @@ namespace DdMd
       * Upon return, forces are correct for all local atoms. Values
       * of the forces on ghost atoms are undefined. Executes reverse
       * communication if needed, and emits Simulation::forceSignal().
+      *
+      * \param needEnergy  if true, also compute pair and external energies
       */
-      void computeForcesAndVirial();
+      void computeForcesAndVirial(bool needEnergy = false);
+
+      /**
+      * Update ghost positions and compute forces, overlapping the two.
+      *
+      * Equivalent to exchanger().update() followed by computeForces(),
+      * but computes pair forces between local atoms while nonblocking
+      * ghost position messages are in flight, and computes forces on
+      * pairs that involve ghosts only after the update is complete.
+      * Computes forces only: on steps that need energies or stresses,
+      * call exchanger().update() and the fused computeForces(needEnergy)
+      * or computeForcesAndVirial(needEnergy) instead. Requires a pair
+      * list (PairPotential::methodId() == 0).
+      */
+      void updateAndComputeForces();
+
+      /**
+      * Should ghost updates be overlapped with pair force computation?
+      */
+      bool overlapUpdate() const;
+
+      /**
+      * Move domain boundaries to balance load, if scheduled.
+      *
+      * Does nothing and returns false unless balanceInterval > 0 and the 
+      * current step is a multiple of balanceInterval. The load on each 
+      * processor is the time spent computing forces since the previous
+      * call if balanceByTime is true, or the number of local atoms 
+      * otherwise. Must be called on all processors with Cartesian atomic
+      * coordinates. If the return value is true, an exchange is required.
+      *
+      * \return true if domain boundaries were changed
+      */
+      bool balanceDomains();
+
+      /**
+      * Adjust the pair list skin to minimize time per step, if scheduled.
+      *
+      * Does nothing and returns false unless skinTuneInterval > 0 and 
+      * the current step is a multiple of skinTuneInterval. Otherwise,
+      * uses the measured pair force time per step, the cost per pair list 
+      * rebuild, and the number of steps per rebuild since the previous 
+      * call to model the time per step as a function of skin, and moves
+      * the skin half way toward the minimum of this model within the 
+      * range [minSkin, maxSkin]. Must be called on all processors. If the
+      * return value is true, the skin has changed and an exchange is 
+      * required before the pair list is used.
+      *
+      * \return true if the skin was changed
+      */
+      bool tuneSkin();
 
       /**
       * Determine whether an atom exchange and reneighboring is needed.
       *
+      * By default, the maximum displacement since the last snapshot is
+      * reduced over all processors by a blocking Allreduce every step.
+      * If the asyncExchangeCheck parameter is enabled (requires MPI-3),
+      * the reduction of a displacement measured by integrateStep1() is
+      * instead posted by setMaxSqDisplacement(), and completed here, so
+      * that it overlaps with the work done between the two calls. The
+      * decision is the same in either case.
+      *
+      * If the box lengths L differ from their values L0 at the last
+      * snapshot (e.g., in NPT or NPH runs), displacements are measured
+      * relative to snapshot positions scaled affinely by L/L0, and the
+      * maximum displacement is compared to (skin - e*cutoff)/2, where e
+      * is the maximum of |L/L0 - 1| and cutoff is the pair list cutoff.
+      * A box rescaling thus does not by itself trigger a rebuild.
+      *
       * \param skin Verlet list skin length
       * \return true iff exchange is needed
       */
       bool isExchangeNeeded(double skin);
 
+      /**
+      * Determine whether a pair list rebuild requires an atom exchange.
+      *
+      * Call on all processors, after isExchangeNeeded() returns true.
+      * Returns true unless PairPotential::exchangeSkin() exceeds the
+      * pair list skin, the boundary is rigid, the half-shell scheme and
+      * reverse communication are disabled, and the pair potential uses
+      * the pair list (methodId 0). Otherwise, reduces the
+      * maximum displacement since the last snapshot over processors,
+      * and returns true iff its sum with the displacements of all local
+      * rebuilds since the last exchange exceeds half the difference of
+      * the two skins. If false, rebuildPairList() may be called instead
+      * of an exchange.
+      *
+      * \return true iff an exchange is needed
+      */
+      bool isFullExchangeNeeded();
+
+      /**
+      * Rebuild the cell and pair lists without an atom exchange.
+      *
+      * Updates ghost positions, then rebuilds the cell list and pair list
+      * from the existing local and ghost atoms, and makes a new snapshot.
+      * Call on all processors, with Cartesian coordinates, only after
+      * isFullExchangeNeeded() returns false.
+      */
+      void rebuildPairList();
+
+      /**
+      * Restrict the plan stage of the next exchange to boundary cells.
+      *
+      * Passes the cell list and the local maximum displacement found by
+      * the last isExchangeNeeded() to Exchanger::setBoundaryScan(). Call
+      * just before an exchange, only if atoms have not been moved since
+      * isExchangeNeeded() was called. Does nothing if no displacement
+      * has been computed since the last exchange.
+      */
+      void enableBoundaryScan();
+
+      /**
+      * Set the local max squared displacement since the last snapshot.
+      *
+      * Called by integrateStep1() of integrators that measure the
+      * displacement in the same loop that updates positions. The next
+      * isExchangeNeeded() then uses this value instead of a separate
+      * loop over atoms, unless the box has been deformed. A negative
+      * value discards a value already set (e.g., after a modifier moves
+      * atoms). If asyncExchangeCheck is enabled, a nonnegative value is
+      * also reduced over processors by a nonblocking reduction.
+      *
+      * \param maxSqDisp max squared displacement of local atoms
+      */
+      void setMaxSqDisplacement(double maxSqDisp);
+
+      /**
+      * Reset the exchange check after a new snapshot is made.
+      *
+      * Completes any nonblocking reduction posted by setMaxSqDisplacement()
+      * and discards its result, and records the current box lengths as
+      * the reference for box strain. Must be called on all processors after
+      * each call to AtomStorage::makeSnapshot(), and at the end of a run.
+      * Also clears the displacement accumulated by rebuildPairList().
+      */
+      void resetExchangeCheck();
+
       /**
       * Get restart file base name. 
       */
@@ -220,6 +392,82 @@ namespace DdMd
       /// Interval for writing restart files (no output if 0)
       int saveInterval_;
 
+      /// If true, overlap ghost updates with interior pair forces.
+      bool overlapUpdate_;
+
+      /// Interval for domain load balancing (no balancing if 0).
+      int balanceInterval_;
+
+      /// If true, balance force time. If false, balance atom counts.
+      bool balanceByTime_;
+
+      /// Value of forceTime() at previous balancing step.
+      double balanceTime_;
+
+      /// Interval for skin auto-tuning (no tuning if 0).
+      int skinTuneInterval_;
+
+      /// Minimum skin allowed by auto-tuning.
+      double minSkin_;
+
+      /// Maximum skin allowed by auto-tuning.
+      double maxSkin_;
+
+      /// Accumulated pair force time at previous tuning step.
+      double tunePairTime_;
+
+      /// Accumulated rebuild time at previous tuning step.
+      double tuneBuildTime_;
+
+      /// Pair list build counter at previous tuning step.
+      int tuneBuildCounter_;
+
+      /// Step index of previous tuning step (-1 if none).
+      int tuneStep_;
+
+      /// If true, overlap the exchange check reduction with one step.
+      bool asyncExchangeCheck_;
+
+      #ifdef UTIL_MPI
+      /// Is a nonblocking exchange check reduction in progress?
+      bool hasExchangeCheck_;
+
+      /// Request for the nonblocking exchange check reduction.
+      MPI_Request exchangeCheckRequest_;
+
+      /// Local max displacement sent by the nonblocking reduction.
+      double exchangeCheckSend_;
+
+      /// Global max displacement received from the nonblocking reduction.
+      double exchangeCheckRecv_;
+      #endif
+
+      /// Box lengths at the last snapshot.
+      Vector snapshotLengths_;
+
+      /// Sum of max displacements of local rebuilds since last exchange.
+      double exchangeDisp_;
+
+      /// Max displacement found by the last isFullExchangeNeeded().
+      double rebuildDisp_;
+
+      /// Local max displacement found by isExchangeNeeded() (or < 0).
+      double localMaxDisp_;
+
+      /// Local max squared displacement set by setMaxSqDisplacement().
+      double stepMaxSqDisp_;
+
+      /*
+      * Return total time spent computing forces on this processor.
+      */
+      double forceTime();
+
+      /*
+      * Compute bond, angle, dihedral, external and Coulomb forces, with
+      * stresses and energies if requested, then reverse communication.
+      */
+      void computeNonPairForces(bool needEnergy, bool needStress);
+
    };
 
    /*
@@ -265,5 +513,8 @@ namespace DdMd
    inline int Integrator::saveInterval() const
    { return saveInterval_; }
 
+   inline bool Integrator::overlapUpdate() const
+   { return overlapUpdate_; }
+
 }
 #endif
@@ -105,6 +105,10 @@ namespace DdMd
       Vector dr;
       double prefactor; // = 0.5*dt/mass
       AtomIterator atomIter;
+      const bool hasSnapshot = atomStorage().hasSnapshot();
+      double maxSqDisp = 0.0;
+      double norm;
+      int i = 0;
 
       // 1st half of velocity Verlet.
       atomStorage().begin(atomIter);
@@ -116,6 +120,20 @@ namespace DdMd
 
          dr.multiply(atomIter->velocity(), dt_);
          atomIter->position() += dr;
+
+         // Displacement since snapshot, for isExchangeNeeded()
+         if (hasSnapshot) {
+            dr.subtract(atomIter->position(),
+                        atomStorage().snapshotPosition(i));
+            norm = dr.square();
+            if (norm > maxSqDisp) {
+               maxSqDisp = norm;
+            }
+            ++i;
+         }
+      }
+      if (hasSnapshot) {
+         setMaxSqDisplacement(maxSqDisp);
       }
    }
 
@@ -0,0 +1,167 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NveRattleIntegrator.h"
+#ifdef SIMP_BOND
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/ensembles/BoundaryEnsemble.h>
+#include <util/space/Vector.h>
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NveRattleIntegrator::NveRattleIntegrator(Simulation& simulation)
+    : TwoStepIntegrator(simulation),
+      constraints_(simulation),
+      dt_(0.0),
+      prefactors_()
+   {  setClassName("NveRattleIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NveRattleIntegrator::~NveRattleIntegrator()
+   {}
+
+   /*
+   * Read time step dt and constraints.
+   */
+   void NveRattleIntegrator::readParameters(std::istream& in)
+   {
+      read<double>(in, "dt", dt_);
+      readParamComposite(in, constraints_);
+      Integrator::readParameters(in);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NveRattleIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParamComposite(ar, constraints_);
+      Integrator::loadParameters(ar);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NveRattleIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      constraints_.save(ar);
+      Integrator::save(ar);
+   }
+
+   /*
+   * Return number of constrained bonds on all processors.
+   */
+   int NveRattleIntegrator::nConstraintTotal()
+   {  return constraints_.nConstraintTotal(); }
+
+   /*
+   * Setup at beginning of run, before entering main loop.
+   */
+   void NveRattleIntegrator::setup()
+   {
+      if (!simulation().boundaryEnsemble().isRigid()) {
+         UTIL_THROW("NveRattleIntegrator requires a rigid boundary");
+      }
+
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Set prefactors for acceleration
+      double dtHalf = 0.5*dt_;
+      double mass;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         mass = simulation().atomType(i).mass();
+         prefactors_[i] = dtHalf/mass;
+      }
+
+      // Remove initial velocity components along constrained bonds
+      constraints_.constrainVelocities(dt_);
+   }
+
+   /*
+   * First half of velocity-Verlet update, and position constraints.
+   */
+   void NveRattleIntegrator::integrateStep1()
+   {
+      Vector dv;
+      Vector dr;
+      double prefactor; // = 0.5*dt/mass
+      AtomIterator atomIter;
+
+      constraints_.storeReference();
+
+      // 1st half of velocity Verlet.
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+
+         dr.multiply(atomIter->velocity(), dt_);
+         atomIter->position() += dr;
+      }
+
+      constraints_.constrainPositions(dt_);
+   }
+
+   /*
+   * Second half of velocity-Verlet update, and velocity constraints.
+   */
+   void NveRattleIntegrator::integrateStep2()
+   {
+      Vector dv;
+      double prefactor; // = 0.5*dt/mass
+      AtomIterator atomIter;
+
+      // 2nd half of velocity Verlet
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+      }
+
+      constraints_.constrainVelocities(dt_);
+
+      // Notify observers of change in velocity
+      simulation().velocitySignal().notify();
+   }
+
+}
+#endif
@@ -0,0 +1,117 @@
+#ifndef DDMD_NVE_RATTLE_INTEGRATOR_H
+#define DDMD_NVE_RATTLE_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TwoStepIntegrator.h"      // base class
+#include "BondConstraints.h"        // member
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * A velocity-Verlet constant energy integrator with bond constraints.
+   *
+   * Bonds of selected types are held at fixed lengths by the RATTLE
+   * algorithm, implemented by a BondConstraints member. Constraining
+   * the stiffest bonds allows a larger time step than NveIntegrator.
+   *
+   * Constraint forces are not included in the virial stress, so the
+   * pressure computed by the Simulation omits their contribution. The
+   * boundary ensemble must therefore be rigid.
+   *
+   * \sa \ref ddMd_integrator_NveRattleIntegrator_page "param file format"
+   *
+   * \ingroup DdMd_Integrator_Module
+   */
+   class NveRattleIntegrator : public TwoStepIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      NveRattleIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~NveRattleIntegrator();
+
+      /**
+      * Read required parameters.
+      *
+      * Reads the time step dt and a BondConstraints block.
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Get the number of constrained bonds (sum over processors).
+      *
+      * Call on all processors.
+      */
+      virtual int nConstraintTotal();
+
+   protected:
+
+      /**
+      * Setup state just before main loop.
+      *
+      * Calls Integrator::setupAtoms(), initializes prefactors_ array,
+      * and removes velocity components along constrained bonds. Throws
+      * if the boundary ensemble is not rigid.
+      */
+      void setup();
+
+      /**
+      * Execute first step of two-step integrator.
+      *
+      * Update positions and half-update velocities, with constraints.
+      */
+      virtual void integrateStep1();
+
+      /**
+      * Execute second step of two-step integrator.
+      *
+      * Second half-update of velocities, with constraints.
+      */
+      virtual void integrateStep2();
+
+   private:
+
+      /// Constraint solver.
+      BondConstraints constraints_;
+
+      /// Time step.
+      double  dt_;
+
+      /// Factors of 0.5*dt_/mass, calculated in setup().
+      DArray<double> prefactors_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,162 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NveRespaIntegrator.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/space/Vector.h>
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NveRespaIntegrator::NveRespaIntegrator(Simulation& simulation)
+    : RespaIntegrator(simulation)
+   {  setClassName("NveRespaIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NveRespaIntegrator::~NveRespaIntegrator()
+   {}
+
+   /*
+   * Read inner time step dt and nInner.
+   */
+   void NveRespaIntegrator::readParameters(std::istream& in)
+   {
+      read<double>(in, "dt", dt_);
+      read<int>(in, "nInner", nInner_);
+      if (nInner_ < 1) {
+         UTIL_THROW("nInner < 1");
+      }
+      Integrator::readParameters(in);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NveRespaIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<int>(ar, "nInner", nInner_);
+      Integrator::loadParameters(ar);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NveRespaIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      ar << nInner_;
+      Integrator::save(ar);
+   }
+ 
+   /*
+   * Setup at beginning of run, before entering main loop.
+   */ 
+   void NveRespaIntegrator::setup()
+   {
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Set prefactors for acceleration
+      double dtHalf = 0.5*dt_;
+      double mass;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         mass = simulation().atomType(i).mass();
+         prefactors_[i] = dtHalf/mass;
+      }
+
+      // Compute separate fast and slow forces
+      setupRespa();
+   }
+
+   /*
+   * Slow impulse (if beginning of outer step), then fast half step.
+   */
+   void NveRespaIntegrator::integrateStep1()
+   {
+      Vector dv;
+      Vector dr;
+      double prefactor; // = 0.5*dt/mass
+      double slowFactor = double(nInner_);
+      bool   isBegin = isBlockBegin();
+      AtomIterator atomIter;
+      int i = 0;
+
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+
+         if (isBegin) {
+            dv.multiply(slowForce(i), slowFactor*prefactor);
+            atomIter->velocity() += dv;
+         }
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+
+         dr.multiply(atomIter->velocity(), dt_);
+         atomIter->position() += dr;
+         ++i;
+      }
+   }
+
+   /*
+   * Fast half step, then slow impulse (if end of outer step).
+   */
+   void NveRespaIntegrator::integrateStep2()
+   {
+      Vector dv;
+      double prefactor; // = 0.5*dt/mass
+      double slowFactor = double(nInner_);
+      bool   isEnd = isBlockEnd();
+      AtomIterator atomIter;
+      int i = 0;
+
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+         if (isEnd) {
+            dv.multiply(slowForce(i), slowFactor*prefactor);
+            atomIter->velocity() += dv;
+         }
+         ++i;
+      }
+
+      // Notify observers of change in velocity
+      simulation().velocitySignal().notify();
+   }
+
+}
@@ -0,0 +1,99 @@
+#ifndef DDMD_NVE_RESPA_INTEGRATOR_H
+#define DDMD_NVE_RESPA_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "RespaIntegrator.h"        // base class
+#include <util/containers/DArray.h> // member
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * A multiple time step (RESPA) constant energy integrator.
+   *
+   * \sa \ref ddMd_integrator_NveRespaIntegrator_page "param file format"
+   *
+   * \ingroup DdMd_Integrator_Module
+   */
+   class NveRespaIntegrator : public RespaIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      NveRespaIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~NveRespaIntegrator();
+
+      /**
+      * Read required parameters.
+      *
+      * Reads the inner time step dt and nInner.
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+  
+   protected:
+
+      /**
+      * Setup state just before main loop.
+      *
+      * Calls Integrator::setupAtoms(), initializes prefactors_ array,
+      * and calls RespaIntegrator::setupRespa().
+      */
+      void setup();
+
+      /**
+      * Execute first step of two-step integrator.
+      *
+      * Apply a slow impulse at the beginning of an outer step, then
+      * half-update velocities with fast forces and update positions.
+      */
+      virtual void integrateStep1();
+
+      /**
+      * Execute second step of two-step integrator.
+      *
+      * Half-update velocities with fast forces, then apply a slow 
+      * impulse at the end of an outer step.
+      */
+      virtual void integrateStep2();
+
+   private:
+
+      /// Inner time step.
+      double  dt_;
+  
+      /// Factors of 0.5*dt_/mass, calculated in setup().
+      DArray<double> prefactors_;      
+
+   };
+
+}
+#endif
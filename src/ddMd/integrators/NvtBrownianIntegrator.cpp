@@ -0,0 +1,193 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NvtBrownianIntegrator.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NvtBrownianIntegrator::NvtBrownianIntegrator(Simulation& simulation)
+    : TwoStepIntegrator(simulation),
+     dt_(0.0),
+     gamma_(0.0),
+     prefactors_(),
+     cr_(),
+     random_(),
+     seed_(-1)
+   {  setClassName("NvtBrownianIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NvtBrownianIntegrator::~NvtBrownianIntegrator()
+   {}
+
+   /*
+   * Read time step dt, relaxation rate gamma and optional seed.
+   */
+   void NvtBrownianIntegrator::readParameters(std::istream& in)
+   {
+      read<double>(in, "dt", dt_);
+      read<double>(in, "gamma", gamma_);
+      readOptional<int>(in, "seed", seed_);
+      Integrator::readParameters(in);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+         cr_.allocate(nAtomType);
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NvtBrownianIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<double>(ar, "gamma", gamma_);
+      Integrator::loadParameters(ar);
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(seed_);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+         cr_.allocate(nAtomType);
+      }
+      //  Note: Values of prefactors_ and cr_ calculated in setup()
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NvtBrownianIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      ar << gamma_;
+      Integrator::save(ar);
+      ar << seed_;
+   }
+ 
+   /*
+   * Setup at beginning of run, before entering main loop.
+   */ 
+   void NvtBrownianIntegrator::setup()
+   {
+      // Preconditions
+      const EnergyEnsemble& energyEnsemble = simulation().energyEnsemble();
+      if (!energyEnsemble.isIsothermal()) {
+         UTIL_THROW("Energy ensemble is not isothermal");
+      }
+      if (gamma_ <= 0.0) {
+         UTIL_THROW("Relaxation rate gamma must be positive");
+      }
+
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Choose a seed on the master if none was given, share it.
+      if (seed_ < 0) {
+         if (domain().isMaster()) {
+            seed_ = int(simulation().random().uniform()*2147483647.0);
+         }
+         #ifdef UTIL_MPI
+         bcast(domain().communicator(), seed_, 0);
+         #endif
+      }
+      random_.setSeed(seed_);
+
+      // Loop over atom types
+      double temp = energyEnsemble.temperature();
+      double friction;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         friction = gamma_*simulation().atomType(i).mass();
+         prefactors_[i] = dt_/friction;
+         cr_[i] = sqrt(2.0*temp*dt_/friction);
+      }
+
+   }
+
+   /*
+   * Brownian dynamics does not use velocities.
+   */
+   bool NvtBrownianIntegrator::needsVelocity() const
+   {  return false; }
+
+   /*
+   * Euler-Maruyama update of positions.
+   */
+   void NvtBrownianIntegrator::integrateStep1()
+   {
+      Vector dr;
+      double g[4];
+      double cr;
+      AtomIterator atomIter;
+      const bool hasSnapshot = atomStorage().hasSnapshot();
+      double maxSqDisp = 0.0;
+      double norm;
+      int typeId, i, j;
+
+      i = 0;
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         typeId = atomIter->typeId();
+
+         // Drift and random displacement
+         dr.multiply(atomIter->force(), prefactors_[typeId]);
+         cr = cr_[typeId];
+         random_.gaussian(atomIter->id(), iStep_, 0, 0, g);
+         for (j = 0; j < Dimension; ++j) {
+            dr[j] += cr*g[j];
+         }
+         atomIter->position() += dr;
+
+         // Displacement since snapshot, for isExchangeNeeded()
+         if (hasSnapshot) {
+            dr.subtract(atomIter->position(),
+                        atomStorage().snapshotPosition(i));
+            norm = dr.square();
+            if (norm > maxSqDisp) {
+               maxSqDisp = norm;
+            }
+            ++i;
+         }
+      }
+      if (hasSnapshot) {
+         setMaxSqDisplacement(maxSqDisp);
+      }
+   }
+
+   /*
+   * Second step does nothing: forces are used at the next step.
+   */
+   void NvtBrownianIntegrator::integrateStep2()
+   {}
+
+}
@@ -0,0 +1,136 @@
+#ifndef DDMD_NVT_BROWNIAN_INTEGRATOR_H
+#define DDMD_NVT_BROWNIAN_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TwoStepIntegrator.h"      // base class
+#include <simp/random/CounterRandom.h> // member
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * A Brownian (overdamped Langevin) dynamics integrator.
+   *
+   * This class integrates the overdamped Langevin equation
+   * \f[
+   *    m\gamma \frac{d{\bf r}}{dt}  =  
+   *    -\frac{\partial U}{\partial {\bf r}} + {\bf f}^{\rm (r)} ,
+   * \f]
+   * in which \f$\gamma\f$ is a relaxation rate, so that m gamma is the
+   * friction coefficient, by the Euler-Maruyama scheme
+   * \f[
+   *    \Delta {\bf r} = \frac{\Delta t}{m\gamma}{\bf f} 
+   *   + \sqrt{\frac{2 kT \Delta t}{m\gamma}} \, {\boldsymbol \xi} ,
+   * \f]
+   * where \f${\boldsymbol \xi}\f$ is a vector of Gaussian random numbers
+   * with zero mean and unit variance. Positions are updated in 
+   * integrateStep1(), and integrateStep2() does nothing.
+   *
+   * Velocities are not used. If the Simulation parameter hasVelocity
+   * is 0, velocities are neither stored nor communicated. The time step 
+   * is limited by the force field and the friction, rather than by 
+   * the inertial time scale of a Langevin integrator.
+   *
+   * Random numbers are generated by a counter-based generator keyed by
+   * atom id and step index, so a trajectory with a given seed does not
+   * depend on the domain decomposition or on the order of atoms.
+   * 
+   * \sa \ref ddMd_integrator_NvtBrownianIntegrator_page "parameter file format"
+   * \ingroup DdMd_Integrator_Module
+   */
+   class NvtBrownianIntegrator : public TwoStepIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      NvtBrownianIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~NvtBrownianIntegrator();
+
+      /**
+      * Read required parameters.
+      *
+      * Reads the time step dt, the relaxation rate gamma and, 
+      * optionally, a random number seed.
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+  
+   protected:
+
+      /**
+      * Setup state just before main loop.
+      *
+      * Calls Integrator::setupAtoms(), initializes prefactors_ and cr_.
+      */
+      void setup();
+
+      /**
+      * Does this integrator use atomic velocities? (false).
+      */
+      virtual bool needsVelocity() const;
+
+      /**
+      * Execute first step of two-step integrator.
+      *
+      * Update positions.
+      */
+      virtual void integrateStep1();
+
+      /**
+      * Execute second step of two-step integrator (does nothing).
+      */
+      virtual void integrateStep2();
+
+   private:
+
+      /// Time step (parameter)
+      double  dt_;
+  
+      /// Relaxation rate, friction/mass (parameter)
+      double gamma_;
+
+      /// Mobility factors dt/(m*gamma), calculated in setup().
+      DArray<double> prefactors_;
+
+      /// Standard deviations sqrt(2*kT*dt/(m*gamma)) of random steps.
+      DArray<double> cr_;
+
+      /// Counter-based generator for random displacements.
+      Simp::CounterRandom random_;
+
+      /// Random number seed (optional parameter, or set in setup()).
+      int seed_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,252 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NvtDpdIntegrator.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/neighbor/PairList.h>
+#include <ddMd/neighbor/PairIterator.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/global.h>
+
+#include <cmath>
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NvtDpdIntegrator::NvtDpdIntegrator(Simulation& simulation)
+    : TwoStepIntegrator(simulation),
+     dt_(0.0),
+     cutoff_(0.0),
+     gamma_(0.0),
+     sigma_(0.0),
+     cutoffSq_(0.0),
+     prefactors_(),
+     random_(),
+     seed_(-1),
+     nRandom_(0)
+   {  setClassName("NvtDpdIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NvtDpdIntegrator::~NvtDpdIntegrator()
+   {}
+
+   /*
+   * Read time step dt, cutoff, gamma and (optionally) seed.
+   */
+   void NvtDpdIntegrator::readParameters(std::istream& in)
+   {
+      read<double>(in, "dt", dt_);
+      read<double>(in, "cutoff", cutoff_);
+      read<double>(in, "gamma", gamma_);
+      readOptional<int>(in, "seed", seed_);
+      Integrator::readParameters(in);
+      nRandom_ = 0;
+
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(simulation().nAtomType());
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NvtDpdIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<double>(ar, "cutoff", cutoff_);
+      loadParameter<double>(ar, "gamma", gamma_);
+      Integrator::loadParameters(ar);
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(seed_);
+      loader.load(nRandom_);
+
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(simulation().nAtomType());
+      }
+      //  Note: Values of prefactors_ and sigma_ calculated in setup()
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NvtDpdIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      ar << cutoff_;
+      ar << gamma_;
+      Integrator::save(ar);
+      ar << seed_;
+      ar << nRandom_;
+   }
+ 
+   /*
+   * Setup at beginning of run, before entering main loop.
+   */ 
+   void NvtDpdIntegrator::setup()
+   {
+      // Preconditions
+      const EnergyEnsemble& energyEnsemble = simulation().energyEnsemble();
+      if (!energyEnsemble.isIsothermal()) {
+         UTIL_THROW("Energy ensemble is not isothermal");
+      }
+      if (reverseUpdateFlag()) {
+         UTIL_THROW("NvtDpdIntegrator requires reverseUpdateFlag == false");
+      }
+      if (cutoff_ > pairPotential().maxPairCutoff()) {
+         UTIL_THROW("DPD cutoff > maxPairCutoff of pair potential");
+      }
+
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Choose a seed on the master if none was given, share it.
+      if (seed_ < 0) {
+         if (domain().isMaster()) {
+            seed_ = int(simulation().random().uniform()*2147483647.0);
+         }
+         #ifdef UTIL_MPI
+         bcast(domain().communicator(), seed_, 0);
+         #endif
+      }
+      random_.setSeed(seed_);
+
+      // Set constants
+      double temp = energyEnsemble.temperature();
+      sigma_ = sqrt(2.0*gamma_*temp/dt_);
+      cutoffSq_ = cutoff_*cutoff_;
+      double dtHalf = 0.5*dt_;
+      double mass;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         mass = simulation().atomType(i).mass();
+         prefactors_[i] = dtHalf/mass;
+      }
+
+      // Add DPD forces to initial forces
+      exchanger().updateVelocities();
+      addDpdForces();
+   }
+
+   /*
+   * Add DPD pair forces to forces of local atoms (private).
+   */
+   void NvtDpdIntegrator::addDpdForces()
+   {
+      Vector e;      // unit vector (r0 - r1)/|r0 - r1|
+      Vector dv;     // difference in velocities v0 - v1
+      Vector f;      // force on atom 0
+      double rsq, r, w;
+      double g[4];   // gaussian random numbers
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      PairIterator iter;
+      int    id0, id1;
+      const uint32_t key = uint32_t(nRandom_);
+
+      // Atom 0 of each pair is local. Pairs with a ghost atom 1 are also 
+      // listed by the processor that owns atom 1, with the same random
+      // numbers, so forces are added only to local atoms.
+      PairList& pairList = pairPotential().pairList();
+      for (pairList.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         e.subtract(atom0Ptr->position(), atom1Ptr->position());
+         rsq = e.square();
+         if (rsq < cutoffSq_) {
+            r = sqrt(rsq);
+            e /= r;
+            w = 1.0 - r/cutoff_;
+
+            // Random numbers keyed by the unordered pair of atom ids
+            id0 = atom0Ptr->id();
+            id1 = atom1Ptr->id();
+            if (id0 < id1) {
+               random_.gaussian(id0, id1, key, 0, g);
+            } else {
+               random_.gaussian(id1, id0, key, 0, g);
+            }
+
+            dv.subtract(atom0Ptr->velocity(), atom1Ptr->velocity());
+            f.multiply(e, w*(sigma_*g[0] - gamma_*w*dv.dot(e)));
+            atom0Ptr->force() += f;
+            if (!atom1Ptr->isGhost()) {
+               atom1Ptr->force() -= f;
+            }
+         }
+      }
+
+      // Every processor makes the same number of evaluations
+      ++nRandom_;
+   }
+
+   /*
+   * First half of velocity-Verlet update.
+   */
+   void NvtDpdIntegrator::integrateStep1()
+   {
+      Vector dv;
+      Vector dr;
+      double prefactor; // = 0.5*dt/mass
+      AtomIterator atomIter;
+
+      // 1st half of velocity Verlet, with conservative + DPD forces
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+
+         dr.multiply(atomIter->velocity(), dt_);
+         atomIter->position() += dr;
+      }
+   }
+
+   /*
+   * Second half of velocity-Verlet update.
+   */
+   void NvtDpdIntegrator::integrateStep2()
+   {
+      Vector dv;
+      AtomIterator atomIter;
+
+      // Add DPD forces, using half-step velocities of all atoms
+      exchanger().updateVelocities();
+      addDpdForces();
+
+      // 2nd half of velocity Verlet
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         dv.multiply(atomIter->force(), prefactors_[atomIter->typeId()]);
+         atomIter->velocity() += dv;
+      }
+
+      // Notify observers of change in velocity
+      simulation().velocitySignal().notify();
+   }
+
+}
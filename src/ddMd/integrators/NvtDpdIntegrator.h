@@ -0,0 +1,157 @@
+#ifndef DDMD_NVT_DPD_INTEGRATOR_H
+#define DDMD_NVT_DPD_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TwoStepIntegrator.h"         // base class
+#include <simp/random/CounterRandom.h> // member
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * A NVT dissipative particle dynamics (DPD) integrator.
+   *
+   * This class integrates the DPD equations of motion, in which each
+   * pair of atoms i,j separated by a distance r < rc interacts via a
+   * dissipative force and a random force along the unit vector e 
+   * from j to i, with a total magnitude
+   * \f[
+   *    w(r)[ \sigma \theta_{ij}/\sqrt{\Delta t} 
+   *          - \gamma w(r) {\bf e}\cdot({\bf v}_i - {\bf v}_j) ] ,
+   * \f]
+   * in addition to the conservative forces, for a weight function
+   * w(r) = 1 - r/rc, a gaussian random variable \f$\theta_{ij}\f$ and 
+   * \f$\sigma^{2} = 2\gamma k_{B}T\f$. Time stepping uses a modified 
+   * velocity-Verlet algorithm (Groot and Warren, 1997, with lambda = 1/2),
+   * in which DPD pair forces are evaluated once per step, after the
+   * conservative forces, with the half-step velocities.
+   *
+   * DPD forces are computed in a loop over the pair list of the pair 
+   * potential. Random numbers are generated by a counter-based generator
+   * keyed by the unordered pair of atom ids and a count of DPD force
+   * evaluations, so that both processors that own an atom of a pair 
+   * with a ghost compute the same random force, without communication
+   * of random forces. The evaluation count is saved in checkpoints and
+   * is not reset by setup(), so successive runs use new random numbers.
+   * Ghost velocities are updated once per step, before DPD forces are
+   * computed. Because random forces do not depend on the order of atoms, a 
+   * trajectory with a given seed is also independent of the domain
+   * decomposition, up to round-off.
+   *
+   * This integrator requires that reverse communication of forces is
+   * disabled (reverseUpdateFlag == false), and a DPD cutoff no greater
+   * than the maximum pair cutoff.
+   * 
+   * \sa \ref ddMd_integrator_NvtDpdIntegrator_page "parameter file format"
+   * \ingroup DdMd_Integrator_Module
+   */
+   class NvtDpdIntegrator : public TwoStepIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      NvtDpdIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~NvtDpdIntegrator();
+
+      /**
+      * Read required parameters.
+      *
+      * Reads the time step dt, the DPD cutoff, the pair drag coefficient
+      * gamma and, optionally, a random number seed.
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+  
+   protected:
+
+      /**
+      * Setup state just before main loop.
+      *
+      * Calls Integrator::setupAtoms(), initializes prefactors_ array,
+      * and adds DPD forces to the initial forces.
+      */
+      void setup();
+
+      /**
+      * Execute first step of two-step integrator.
+      *
+      * Update positions and half-update velocities.
+      */
+      virtual void integrateStep1();
+
+      /**
+      * Execute second step of two-step integrator.
+      *
+      * Add DPD pair forces, and complete the velocity update.
+      */
+      virtual void integrateStep2();
+
+   private:
+
+      /// Time step (parameter)
+      double  dt_;
+  
+      /// DPD cutoff distance (parameter)
+      double cutoff_;
+
+      /// DPD pair drag coefficient (parameter)
+      double gamma_;
+
+      /// Prefactor of random pair forces, sqrt(2*gamma*T/dt).
+      double sigma_;
+
+      /// Square of cutoff_.
+      double cutoffSq_;
+
+      /// Factors of 0.5*dt_/mass, calculated in setup().
+      DArray<double> prefactors_;      
+
+      /// Counter-based generator for random pair forces.
+      Simp::CounterRandom random_;
+
+      /// Random number seed (optional parameter, or set in setup()).
+      int seed_;
+
+      /// Number of DPD force evaluations, used as a random number key.
+      int nRandom_;
+
+      /**
+      * Add dissipative and random pair forces to local atom forces.
+      *
+      * Requires current ghost velocities.
+      */
+      void addDpdForces();
+
+   };
+
+}
+#endif
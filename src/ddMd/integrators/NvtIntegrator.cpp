@@ -31,10 +31,12 @@ namespace DdMd
       prefactors_(),
       T_target_(1.0),
       T_kinetic_(1.0),
-      xi_(0.0),
-      xiDot_(0.0),
+      xi_(),
+      xiDot_(),
       tauT_(1.0),
-      nuT_(1.0)
+      nuT_(1.0),
+      nAtom_(0),
+      chainLength_(1)
    {
       setClassName("NvtIntegrator");
 
@@ -60,9 +62,15 @@ namespace DdMd
    {
       read<double>(in, "dt",   dt_);
       read<double>(in, "tauT", tauT_);
+      chainLength_ = 1;
+      readOptional<int>(in, "chainLength", chainLength_);
+      if (chainLength_ < 1) {
+         UTIL_THROW("chainLength < 1");
+      }
       Integrator::readParameters(in);
 
       nuT_ = 1.0/tauT_;
+      allocateChain();
       int nAtomType = simulation().nAtomType();
       if (!prefactors_.isAllocated()) {
          prefactors_.allocate(nAtomType);
@@ -76,11 +84,19 @@ namespace DdMd
    {
       loadParameter<double>(ar, "dt", dt_);
       loadParameter<double>(ar, "tauT", tauT_);
+      chainLength_ = 1;
+      loadParameter<int>(ar, "chainLength", chainLength_, false);
+      if (chainLength_ < 1) {
+         UTIL_THROW("chainLength < 1");
+      }
       Integrator::loadParameters(ar);
 
+      allocateChain();
       MpiLoader<Serializable::IArchive> loader(*this, ar);
       loader.load(nuT_);
-      loader.load(xi_);
+      for (int k = 0; k < chainLength_; ++k) {
+         loader.load(xi_[k]);
+      }
 
       int nAtomType = simulation().nAtomType();
       if (!prefactors_.isAllocated()) {
@@ -95,16 +111,23 @@ namespace DdMd
    {
       ar << dt_;
       ar << tauT_;
+      Parameter::saveOptional(ar, chainLength_, (chainLength_ > 1));
       Integrator::save(ar);
       ar << nuT_;
-      ar << xi_;
+      for (int k = 0; k < chainLength_; ++k) {
+         ar << xi_[k];
+      }
    }
 
    /*
-   * Initialize xi_ and xiDot_ to zero.
+   * Initialize xi_ to zero.
    */
    void NvtIntegrator::initDynamicalState()
-   {  xi_ = 0.0; }
+   {
+      for (int k = 0; k < xi_.capacity(); ++k) {
+         xi_[k] = 0.0;
+      }
+   }
 
 
    /*
@@ -131,20 +154,21 @@ namespace DdMd
          prefactors_[i] = dtHalf/mass;
       }
 
-      // Initialize nAtom_, xiDot_
+      // Initialize nAtom_, T_kinetic_ and xiDot_ on all processors
       simulation().computeKineticEnergy();
       #ifdef UTIL_MPI
       atomStorage().computeNAtomTotal(domain().communicator());
       #endif
       if (domain().isMaster()) {
-         T_target_ = simulation().energyEnsemble().temperature();
          nAtom_  = atomStorage().nAtomTotal();
          T_kinetic_ = simulation().kineticEnergy()*2.0/double(3*nAtom_);
-         xiDot_ = (T_kinetic_/T_target_ -1.0)*nuT_*nuT_;
       }
       #ifdef UTIL_MPI
-      bcast(domain().communicator(), xiDot_, 0);
+      bcast(domain().communicator(), nAtom_, 0);
+      bcast(domain().communicator(), T_kinetic_, 0);
       #endif
+      T_target_ = simulation().energyEnsemble().temperature();
+      computeXiDot();
 
    }
 
@@ -156,10 +180,14 @@ namespace DdMd
       double dtHalf = 0.5*dt_;
       double factor;
       AtomIterator atomIter;
+      const bool hasSnapshot = atomStorage().hasSnapshot();
+      double maxSqDisp = 0.0;
+      double norm;
+      int i = 0;
 
    
       T_target_ = simulation().energyEnsemble().temperature();
-      factor = exp(-dtHalf*(xi_ + xiDot_*dtHalf));
+      factor = exp(-dtHalf*(xi_[0] + xiDot_[0]*dtHalf));
 
       // 1st half of velocity Verlet.
       atomStorage().begin(atomIter);
@@ -170,6 +198,20 @@ namespace DdMd
          atomIter->velocity() += dv;
          dr.multiply(atomIter->velocity(), dt_);
          atomIter->position() += dr;
+
+         // Displacement since snapshot, for isExchangeNeeded()
+         if (hasSnapshot) {
+            dr.subtract(atomIter->position(),
+                        atomStorage().snapshotPosition(i));
+            norm = dr.square();
+            if (norm > maxSqDisp) {
+               maxSqDisp = norm;
+            }
+            ++i;
+         }
+      }
+      if (hasSnapshot) {
+         setMaxSqDisplacement(maxSqDisp);
       }
    }
 
@@ -179,36 +221,88 @@ namespace DdMd
       double prefactor; // = 0.5*dt/mass
       double dtHalf = 0.5*dt_;
       double factor;
+      double localKinetic, kinetic;
       AtomIterator atomIter;
+      int k;
 
       T_target_ = simulation().energyEnsemble().temperature();
-      factor = exp(-dtHalf*(xi_ + xiDot_*dtHalf));
+      factor = exp(-dtHalf*(xi_[0] + xiDot_[0]*dtHalf));
 
-      // 2nd half of velocity Verlet
+      // 2nd half of velocity Verlet, and sum of m*v^2 for local atoms
+      localKinetic = 0.0;
       atomStorage().begin(atomIter);
       for ( ; atomIter.notEnd(); ++atomIter) {
          prefactor = prefactors_[atomIter->typeId()];
          dv.multiply(atomIter->force(), prefactor);
          atomIter->velocity() += dv;
          atomIter->velocity() *=factor;
+         localKinetic += atomIter->velocity().square()*dtHalf/prefactor;
       }
 
-      // Notify observers of change in velocity
+      // Sum over processors, with the result on all processors
+      #ifdef UTIL_MPI
+      domain().communicator().Allreduce(&localKinetic, &kinetic, 1,
+                                        MPI::DOUBLE, MPI::SUM);
+      #else
+      kinetic = localKinetic;
+      #endif
+
+      // Notify observers of change in velocity, store kinetic energy
       simulation().velocitySignal().notify();
+      simulation().setKineticEnergy(0.5*kinetic);
 
-      // Update xiDot_ and xi_
-      simulation().computeKineticEnergy();
-      if (domain().isMaster()) {
-         xi_ += xiDot_*dtHalf;
-         T_kinetic_ = simulation().kineticEnergy()*2.0/double(3*nAtom_);
-         xiDot_ = (T_kinetic_/T_target_  - 1.0)*nuT_*nuT_;
-         xi_ += xiDot_*dtHalf;
+      // Update xiDot_ and xi_ (identically on all processors)
+      for (k = 0; k < chainLength_; ++k) {
+         xi_[k] += xiDot_[k]*dtHalf;
       }
-      #ifdef UTIL_MPI
-      bcast(domain().communicator(), xiDot_, 0);
-      bcast(domain().communicator(), xi_, 0);
-      #endif
+      T_kinetic_ = kinetic/double(3*nAtom_);
+      computeXiDot();
+      for (k = 0; k < chainLength_; ++k) {
+         xi_[k] += xiDot_[k]*dtHalf;
+      }
+   }
 
+   /*
+   * Allocate chain variables, and set them to zero (private).
+   */
+   void NvtIntegrator::allocateChain()
+   {
+      if (xi_.isAllocated()) {
+         if (xi_.capacity() != chainLength_) {
+            xi_.deallocate();
+            xiDot_.deallocate();
+         }
+      }
+      if (!xi_.isAllocated()) {
+         xi_.allocate(chainLength_);
+         xiDot_.allocate(chainLength_);
+      }
+      for (int k = 0; k < chainLength_; ++k) {
+         xi_[k] = 0.0;
+         xiDot_[k] = 0.0;
+      }
+   }
+
+   /*
+   * Compute time derivatives of all chain variables (private).
+   *
+   * Thermostat masses are Q_0 = 3N kT/nu^2 and Q_k = kT/nu^2 for k > 0.
+   * For a chain of length 1, xiDot = (T_kinetic/T_target - 1)*nu^2.
+   */
+   void NvtIntegrator::computeXiDot()
+   {
+      double nuSq = nuT_*nuT_;
+      int k;
+      xiDot_[0] = (T_kinetic_/T_target_ - 1.0)*nuSq;
+      if (chainLength_ > 1) {
+         xiDot_[1] = double(3*nAtom_)*xi_[0]*xi_[0] - nuSq;
+      }
+      for (k = 2; k < chainLength_; ++k) {
+         xiDot_[k] = xi_[k-1]*xi_[k-1] - nuSq;
+      }
+      for (k = 0; k < chainLength_ - 1; ++k) {
+         xiDot_[k] -= xi_[k]*xi_[k+1];
+      }
    }
 
 }
@@ -19,6 +19,12 @@ namespace DdMd
    /**
    * A Nose-Hoover constant temperature, constant volume integrator.
    *
+   * If the optional parameter chainLength is greater than 1, the atoms
+   * are coupled to the first of a Nose-Hoover chain of thermostats.
+   * The kinetic energy used to update the thermostat is summed in the
+   * second velocity update loop, and reduced by one MPI allreduce per
+   * step, after which every processor updates the thermostat variables.
+   *
    * \sa \ref ddMd_integrator_NvtIntegrator_page "param file format"
    *
    * \ingroup DdMd_Integrator_Module
@@ -93,11 +99,11 @@ namespace DdMd
       /// Current temperature from kinetic energy
       double T_kinetic_;
 
-      /// Nose-Hover thermostat scaling variable.
-      double xi_;
+      /// Nose-Hover thermostat scaling variables, one per chain element.
+      DArray<double> xi_;
 
-      /// Time derivative of xi
-      double xiDot_;
+      /// Time derivatives of xi, one per chain element.
+      DArray<double> xiDot_;
 
       /// Relaxation time for energy fluctuations.
       double tauT_;
@@ -108,6 +114,19 @@ namespace DdMd
       /// Total number of atoms in simulation.
       int nAtom_;
 
+      /// Number of thermostats in the Nose-Hoover chain.
+      int chainLength_;
+
+      /**
+      * Allocate xi_ and xiDot_, and set all elements to zero.
+      */
+      void allocateChain();
+
+      /**
+      * Compute xiDot_ from T_kinetic_ and xi_.
+      */
+      void computeXiDot();
+
    };
 
 }
@@ -13,6 +13,8 @@
 #include <ddMd/potentials/pair/PairPotential.h>
 #include <util/ensembles/EnergyEnsemble.h>
 #include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/mpi/MpiLoader.h>
 #include <util/global.h>
 
 #include <iostream>
@@ -30,7 +32,9 @@ namespace DdMd
      gamma_(0.0),
      prefactors_(),
      cv_(),
-     cr_()
+     cr_(),
+     random_(),
+     seed_(-1)
    {  setClassName("NvtLangevinIntegrator"); }
 
    /*
@@ -46,6 +50,7 @@ namespace DdMd
    {
       read<double>(in, "dt", dt_);
       read<double>(in, "gamma", gamma_);
+      readOptional<int>(in, "seed", seed_);
       Integrator::readParameters(in);
 
       int nAtomType = simulation().nAtomType();
@@ -62,8 +67,12 @@ namespace DdMd
    void NvtLangevinIntegrator::loadParameters(Serializable::IArchive &ar)
    {
       loadParameter<double>(ar, "dt", dt_);
+      loadParameter<double>(ar, "gamma", gamma_);
       Integrator::loadParameters(ar);
 
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(seed_);
+
       int nAtomType = simulation().nAtomType();
       if (!prefactors_.isAllocated()) {
          prefactors_.allocate(nAtomType);
@@ -81,6 +90,7 @@ namespace DdMd
       ar << dt_;
       ar << gamma_;
       Integrator::save(ar);
+      ar << seed_;
    }
  
    /*
@@ -103,6 +113,17 @@ namespace DdMd
       // Exchange atoms, build pair list, compute forces.
       setupAtoms();
 
+      // Choose a seed on the master if none was given, share it.
+      if (seed_ < 0) {
+         if (domain().isMaster()) {
+            seed_ = int(simulation().random().uniform()*2147483647.0);
+         }
+         #ifdef UTIL_MPI
+         bcast(domain().communicator(), seed_, 0);
+         #endif
+      }
+      random_.setSeed(seed_);
+
       // Set constants that are independent of atom type
       double cv = (exp(-dt_*gamma_) - 1.0)/dt_;
       double temp = energyEnsemble.temperature();
@@ -131,6 +152,10 @@ namespace DdMd
       Vector dr;
       double prefactor; // = 0.5*dt/mass
       AtomIterator atomIter;
+      const bool hasSnapshot = atomStorage().hasSnapshot();
+      double maxSqDisp = 0.0;
+      double norm;
+      int i = 0;
 
       // 1st half of velocity Verlet.
       atomStorage().begin(atomIter);
@@ -142,6 +167,20 @@ namespace DdMd
 
          dr.multiply(atomIter->velocity(), dt_);
          atomIter->position() += dr;
+
+         // Displacement since snapshot, for isExchangeNeeded()
+         if (hasSnapshot) {
+            dr.subtract(atomIter->position(),
+                        atomStorage().snapshotPosition(i));
+            norm = dr.square();
+            if (norm > maxSqDisp) {
+               maxSqDisp = norm;
+            }
+            ++i;
+         }
+      }
+      if (hasSnapshot) {
+         setMaxSqDisplacement(maxSqDisp);
       }
    }
 
@@ -150,10 +189,10 @@ namespace DdMd
    */
    void NvtLangevinIntegrator::integrateStep2()
    {
-      Util::Random& random = simulation().random();
       Vector dv;
       Vector df;
       double cr;
+      double u[4];
       AtomIterator atomIter;
       int typeId, j;
 
@@ -165,8 +204,9 @@ namespace DdMd
          // Add Langevin drag and random force to atomic force
          df.multiply(atomIter->velocity(), cv_[typeId]);
          cr = cr_[typeId];
+         random_.uniform(atomIter->id(), iStep_, 0, 0, u);
          for (j=0; j < Dimension; ++j) {
-            df[j] += (random.uniform() - 0.5)*cr;
+            df[j] += (u[j] - 0.5)*cr;
          }
          atomIter->force() += df;
 
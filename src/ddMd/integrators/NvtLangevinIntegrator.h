@@ -9,6 +9,7 @@
 */
 
 #include "TwoStepIntegrator.h"      // base class
+#include <simp/random/CounterRandom.h> // member
 
 namespace DdMd
 {
@@ -28,6 +29,10 @@ namespace DdMd
    * in which \f$\gamma\f$ is a velocity relaxation rate (inverse 
    * time) parameter, \f${\bf v}\f$ is a particle velocity, and 
    * \f${\bf f}^{\rm (r)}\f$ is a random force.
+   *
+   * Random forces are generated by a counter-based generator keyed by
+   * atom id and step index, so a trajectory with a given seed does not
+   * depend on the domain decomposition or on the order of atoms.
    * 
    * \sa \ref ddMd_integrator_NvtLangevinIntegrator_page "parameter file format"
    * \sa \ref algorithms_Langevin_page "algorithm"
@@ -51,7 +56,8 @@ namespace DdMd
       /**
       * Read required parameters.
       *
-      * Reads the time step dt.
+      * Reads the time step dt, the relaxation rate gamma and, 
+      * optionally, a random number seed.
       */
       void readParameters(std::istream& in);
 
@@ -109,6 +115,12 @@ namespace DdMd
       /// Constant for random force.
       DArray<double> cr_;
 
+      /// Counter-based generator for random forces.
+      Simp::CounterRandom random_;
+
+      /// Random number seed (optional parameter, or set in setup()).
+      int seed_;
+
    };
 
 }
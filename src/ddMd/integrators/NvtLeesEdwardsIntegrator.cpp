@@ -0,0 +1,249 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NvtLeesEdwardsIntegrator.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/misc/BoundaryMetric.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/global.h>
+
+#include <cmath>
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NvtLeesEdwardsIntegrator::NvtLeesEdwardsIntegrator(Simulation& simulation)
+    : TwoStepIntegrator(simulation),
+     dt_(0.0),
+     gamma_(0.0),
+     shearRate_(0.0),
+     strain_(0.0),
+     prefactors_(),
+     cv_(),
+     cr_(),
+     random_(),
+     gradient_(0),
+     flow_(1),
+     seed_(-1)
+   {  setClassName("NvtLeesEdwardsIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NvtLeesEdwardsIntegrator::~NvtLeesEdwardsIntegrator()
+   {}
+
+   /*
+   * Read parameters.
+   */
+   void NvtLeesEdwardsIntegrator::readParameters(std::istream& in)
+   {
+      read<double>(in, "dt", dt_);
+      read<double>(in, "gamma", gamma_);
+      read<double>(in, "shearRate", shearRate_);
+      read<int>(in, "gradient", gradient_);
+      read<int>(in, "flow", flow_);
+      readOptional<int>(in, "seed", seed_);
+      Integrator::readParameters(in);
+      if (gradient_ < 0 || flow_ <= gradient_ || flow_ >= Dimension) {
+         UTIL_THROW("Require 0 <= gradient < flow < Dimension");
+      }
+      strain_ = 0.0;
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+         cv_.allocate(nAtomType);
+         cr_.allocate(nAtomType);
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NvtLeesEdwardsIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<double>(ar, "gamma", gamma_);
+      loadParameter<double>(ar, "shearRate", shearRate_);
+      loadParameter<int>(ar, "gradient", gradient_);
+      loadParameter<int>(ar, "flow", flow_);
+      Integrator::loadParameters(ar);
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(seed_);
+      loader.load(strain_);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+         cv_.allocate(nAtomType);
+         cr_.allocate(nAtomType);
+      }
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NvtLeesEdwardsIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      ar << gamma_;
+      ar << shearRate_;
+      ar << gradient_;
+      ar << flow_;
+      Integrator::save(ar);
+      ar << seed_;
+      ar << strain_;
+   }
+
+   /*
+   * Setup at beginning of run, before entering main loop.
+   */
+   void NvtLeesEdwardsIntegrator::setup()
+   {
+      // Preconditions
+      const EnergyEnsemble& energyEnsemble = simulation().energyEnsemble();
+      if (!energyEnsemble.isIsothermal()) {
+         UTIL_THROW("Energy ensemble is not isothermal");
+      }
+      if (!isOrthogonal(boundary())) {
+         UTIL_THROW("Lees-Edwards boundaries require an orthogonal boundary");
+      }
+
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Enable sliding images before the initial exchange of atoms.
+      simulation().exchanger().setShear(gradient_, flow_);
+      updateShearOffset();
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Choose a seed on the master if none was given, share it.
+      if (seed_ < 0) {
+         if (domain().isMaster()) {
+            seed_ = int(simulation().random().uniform()*2147483647.0);
+         }
+         #ifdef UTIL_MPI
+         bcast(domain().communicator(), seed_, 0);
+         #endif
+      }
+      random_.setSeed(seed_);
+
+      // Set constants that are independent of atom type
+      double cv = (exp(-dt_*gamma_) - 1.0)/dt_;
+      double temp = energyEnsemble.temperature();
+      double d = 2.0/(1.0 + exp(-dt_*gamma_));
+      double cr = 12.0*temp*d*(1.0 - exp(-2.0*dt_*gamma_))/(dt_*dt_);
+
+      // Loop over atom types
+      double dtHalf = 0.5*dt_;
+      double mass;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         mass = simulation().atomType(i).mass();
+         prefactors_[i] = dtHalf/mass;
+         cv_[i] = mass*cv;
+         cr_[i] = sqrt(mass*cr);
+      }
+
+   }
+
+   /*
+   * First half of velocity-Verlet update.
+   */
+   void NvtLeesEdwardsIntegrator::integrateStep1()
+   {
+      Vector dv;
+      Vector dr;
+      double prefactor; // = 0.5*dt/mass
+      AtomIterator atomIter;
+
+      // 1st half of velocity Verlet.
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+
+         dr.multiply(atomIter->velocity(), dt_);
+         atomIter->position() += dr;
+      }
+
+      // Advance images before the following exchange or update.
+      strain_ += shearRate_*dt_;
+      updateShearOffset();
+   }
+
+   /*
+   * Second half of velocity-Verlet update.
+   */
+   void NvtLeesEdwardsIntegrator::integrateStep2()
+   {
+      Vector dv;
+      Vector df;
+      double cr;
+      double u[4];
+      AtomIterator atomIter;
+      int typeId, j;
+      const double center = 0.5*boundary().lengths()[gradient_];
+
+      // 2nd half of velocity Verlet
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         typeId = atomIter->typeId();
+
+         // Langevin drag on peculiar velocity, and random force
+         df = atomIter->velocity();
+         df[flow_] -= shearRate_*(atomIter->position()[gradient_] - center);
+         df *= cv_[typeId];
+         cr = cr_[typeId];
+         random_.uniform(atomIter->id(), iStep_, 0, 0, u);
+         for (j=0; j < Dimension; ++j) {
+            df[j] += (u[j] - 0.5)*cr;
+         }
+         atomIter->force() += df;
+
+         // Update velocity (half step)
+         dv.multiply(atomIter->force(), prefactors_[typeId]);
+         atomIter->velocity() += dv;
+      }
+
+      // Notify observers of change in velocity
+      simulation().velocitySignal().notify();
+   }
+
+   /*
+   * Offset of images in generalized flow coordinate, and their velocity.
+   */
+   void NvtLeesEdwardsIntegrator::updateShearOffset()
+   {
+      const Vector& lengths = boundary().lengths();
+      double offset = strain_*lengths[gradient_]/lengths[flow_];
+      offset -= floor(offset);
+      simulation().exchanger().setShearOffset(offset,
+                                       shearRate_*lengths[gradient_]);
+   }
+
+}
@@ -0,0 +1,155 @@
+#ifndef DDMD_NVT_LEES_EDWARDS_INTEGRATOR_H
+#define DDMD_NVT_LEES_EDWARDS_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TwoStepIntegrator.h"      // base class
+#include <simp/random/CounterRandom.h> // member
+
+namespace DdMd
+{
+
+   class Simulation;
+   using namespace Util;
+
+   /**
+   * A NVT integrator for planar shear flow with Lees-Edwards boundaries.
+   *
+   * This class imposes a steady shear flow with velocity along Cartesian
+   * axis flow and velocity gradient along axis gradient, with a shear
+   * rate \f$\dot{\gamma}\f$. Periodic images displaced by one box length
+   * along the gradient axis slide relative to the primary cell along
+   * the flow axis with velocity \f$\dot{\gamma} L_{g}\f$ (Lees-Edwards
+   * boundary conditions). Sliding images are implemented by the Exchanger,
+   * which adds the accumulated offset to atoms and ghosts that cross the
+   * boundary along the gradient axis (see Exchanger::setShear).
+   *
+   * Temperature is controlled by a Langevin thermostat that acts on the
+   * peculiar velocity \f${\bf v} - {\bf u}({\bf r})\f$, relative to the
+   * linear streaming profile \f$u_{f} = \dot{\gamma}(r_{g} - L_{g}/2)\f$.
+   * Random forces are generated as in NvtLangevinIntegrator.
+   *
+   * \sa \ref ddMd_integrator_NvtLeesEdwardsIntegrator_page "parameter file format"
+   * \ingroup DdMd_Integrator_Module
+   */
+   class NvtLeesEdwardsIntegrator : public TwoStepIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      NvtLeesEdwardsIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~NvtLeesEdwardsIntegrator();
+
+      /**
+      * Read required parameters.
+      *
+      * Reads the time step dt, the relaxation rate gamma, the shear rate,
+      * the gradient and flow axes and, optionally, a random number seed.
+      */
+      void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Get accumulated shear strain.
+      */
+      double strain() const;
+
+   protected:
+
+      /**
+      * Setup state just before main loop.
+      *
+      * Enables sliding images in the Exchanger, then calls
+      * Integrator::setupAtoms() and initializes prefactors.
+      */
+      void setup();
+
+      /**
+      * Execute first step of two-step integrator.
+      *
+      * Update positions, half-update velocities, and advance the offset
+      * of sliding images.
+      */
+      virtual void integrateStep1();
+
+      /**
+      * Execute second step of two-step integrator.
+      *
+      * Second half-update of velocities, with thermostat forces.
+      */
+      virtual void integrateStep2();
+
+   private:
+
+      /// Time step (parameter)
+      double  dt_;
+
+      /// Velocity autocorrelation decay rate (parameter)
+      double gamma_;
+
+      /// Shear rate (parameter)
+      double shearRate_;
+
+      /// Accumulated strain, shearRate*time.
+      double strain_;
+
+      /// Factors of 0.5*dt_/mass, calculated in setup().
+      DArray<double> prefactors_;
+
+      /// Constant for friction force.
+      DArray<double> cv_;
+
+      /// Constant for random force.
+      DArray<double> cr_;
+
+      /// Counter-based generator for random forces.
+      Simp::CounterRandom random_;
+
+      /// Index of velocity gradient axis (parameter)
+      int gradient_;
+
+      /// Index of flow axis (parameter)
+      int flow_;
+
+      /// Random number seed (optional parameter, or set in setup()).
+      int seed_;
+
+      /**
+      * Pass current offset and relative velocity of images to Exchanger.
+      */
+      void updateShearOffset();
+
+   };
+
+   // Inline method
+
+   inline double NvtLeesEdwardsIntegrator::strain() const
+   {  return strain_; }
+
+}
+#endif
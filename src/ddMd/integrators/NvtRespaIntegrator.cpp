@@ -0,0 +1,247 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NvtRespaIntegrator.h"
+#include <util/ensembles/EnergyEnsemble.h>
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/space/Vector.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/misc/Timer.h>
+#include <util/global.h>
+
+#include <iostream>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /* 
+   * Constructor.
+   */
+   NvtRespaIntegrator::NvtRespaIntegrator(Simulation& simulation)
+    : RespaIntegrator(simulation),
+      prefactors_(),
+      T_target_(1.0),
+      T_kinetic_(1.0),
+      xi_(0.0),
+      xiDot_(0.0),
+      tauT_(1.0),
+      nuT_(1.0)
+   {
+      setClassName("NvtRespaIntegrator");
+
+      // Note: Within this constructor, the method parameter "simulation" 
+      // hides the simulation() method name.
+
+      // Precondition
+      if (!simulation.energyEnsemble().isIsothermal() ) {
+         UTIL_THROW("Simulation energy ensemble is not isothermal");
+      }
+   }
+
+   /*
+   * Destructor.
+   */
+   NvtRespaIntegrator::~NvtRespaIntegrator()
+   {}
+
+   /* 
+   * Read parameter and configuration files, initialize simulation.
+   */
+   void NvtRespaIntegrator::readParameters(std::istream &in) 
+   {
+      read<double>(in, "dt",     dt_);
+      read<int>(in,    "nInner", nInner_);
+      if (nInner_ < 1) {
+         UTIL_THROW("nInner < 1");
+      }
+      read<double>(in, "tauT",   tauT_);
+      Integrator::readParameters(in);
+
+      nuT_ = 1.0/tauT_;
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /**
+   * Load internal state from an archive.
+   */
+   void NvtRespaIntegrator::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<int>(ar, "nInner", nInner_);
+      loadParameter<double>(ar, "tauT", tauT_);
+      Integrator::loadParameters(ar);
+
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nuT_);
+      loader.load(xi_);
+
+      int nAtomType = simulation().nAtomType();
+      if (!prefactors_.isAllocated()) {
+         prefactors_.allocate(nAtomType);
+      }
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void NvtRespaIntegrator::save(Serializable::OArchive &ar)
+   {
+      ar << dt_;
+      ar << nInner_;
+      ar << tauT_;
+      Integrator::save(ar);
+      ar << nuT_;
+      ar << xi_;
+   }
+
+   /*
+   * Initialize xi_ and xiDot_ to zero.
+   */
+   void NvtRespaIntegrator::initDynamicalState()
+   {  xi_ = 0.0; }
+
+
+   /*
+   * Setup parameters before beginning of run. 
+   */
+   void NvtRespaIntegrator::setup()
+   {
+
+      // Initialize state and clear statistics on first usage.
+      if (!isSetup()) {
+         clear();
+         setIsSetup();
+      }
+
+      // Exchange atoms, build pair list, compute forces.
+      setupAtoms();
+
+      // Calculate prefactors for acceleration
+      double dtHalf = 0.5*dt_;
+      double mass;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         mass = simulation().atomType(i).mass();
+         prefactors_[i] = dtHalf/mass;
+      }
+
+      // Initialize nAtom_, xiDot_
+      simulation().computeKineticEnergy();
+      #ifdef UTIL_MPI
+      atomStorage().computeNAtomTotal(domain().communicator());
+      #endif
+      if (domain().isMaster()) {
+         T_target_ = simulation().energyEnsemble().temperature();
+         nAtom_  = atomStorage().nAtomTotal();
+         T_kinetic_ = simulation().kineticEnergy()*2.0/double(3*nAtom_);
+         xiDot_ = (T_kinetic_/T_target_ -1.0)*nuT_*nuT_;
+      }
+      #ifdef UTIL_MPI
+      bcast(domain().communicator(), xiDot_, 0);
+      #endif
+
+      // Compute separate fast and slow forces
+      setupRespa();
+   }
+
+   /*
+   * Slow impulse and thermostat (if beginning of outer step), then
+   * fast half step.
+   */
+   void NvtRespaIntegrator::integrateStep1()
+   {
+      Vector dv;
+      Vector dr;
+      double prefactor; // = 0.5*dt/mass
+      double slowFactor = double(nInner_);
+      double dtHalf = 0.5*dt_*slowFactor; // half outer step
+      double factor = 1.0;
+      bool   isBegin = isBlockBegin();
+      AtomIterator atomIter;
+      int i = 0;
+
+      if (isBegin) {
+         T_target_ = simulation().energyEnsemble().temperature();
+         factor = exp(-dtHalf*(xi_ + xiDot_*dtHalf));
+      }
+
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+         if (isBegin) {
+            atomIter->velocity() *= factor;
+            dv.multiply(slowForce(i), slowFactor*prefactor);
+            atomIter->velocity() += dv;
+         }
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+         dr.multiply(atomIter->velocity(), dt_);
+         atomIter->position() += dr;
+         ++i;
+      }
+   }
+
+   /*
+   * Fast half step, then slow impulse and thermostat (if end of outer
+   * step).
+   */
+   void NvtRespaIntegrator::integrateStep2()
+   {
+      Vector dv;
+      double prefactor; // = 0.5*dt/mass
+      double slowFactor = double(nInner_);
+      double dtHalf = 0.5*dt_*slowFactor; // half outer step
+      double factor = 1.0;
+      bool   isEnd = isBlockEnd();
+      AtomIterator atomIter;
+      int i = 0;
+
+      if (isEnd) {
+         T_target_ = simulation().energyEnsemble().temperature();
+         factor = exp(-dtHalf*(xi_ + xiDot_*dtHalf));
+      }
+
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         prefactor = prefactors_[atomIter->typeId()];
+         dv.multiply(atomIter->force(), prefactor);
+         atomIter->velocity() += dv;
+         if (isEnd) {
+            dv.multiply(slowForce(i), slowFactor*prefactor);
+            atomIter->velocity() += dv;
+            atomIter->velocity() *= factor;
+         }
+         ++i;
+      }
+
+      // Notify observers of change in velocity
+      simulation().velocitySignal().notify();
+
+      // Update xiDot_ and xi_ at the end of an outer step
+      if (isEnd) {
+         simulation().computeKineticEnergy();
+         if (domain().isMaster()) {
+            xi_ += xiDot_*dtHalf;
+            T_kinetic_ = simulation().kineticEnergy()*2.0/double(3*nAtom_);
+            xiDot_ = (T_kinetic_/T_target_  - 1.0)*nuT_*nuT_;
+            xi_ += xiDot_*dtHalf;
+         }
+         #ifdef UTIL_MPI
+         bcast(domain().communicator(), xiDot_, 0);
+         bcast(domain().communicator(), xi_, 0);
+         #endif
+      }
+
+   }
+
+}
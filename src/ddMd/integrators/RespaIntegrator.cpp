@@ -0,0 +1,194 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "RespaIntegrator.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#ifdef SIMP_BOND
+#include <ddMd/potentials/bond/BondPotential.h>
+#endif
+#ifdef SIMP_ANGLE
+#include <ddMd/potentials/angle/AnglePotential.h>
+#endif
+#ifdef SIMP_DIHEDRAL
+#include <ddMd/potentials/dihedral/DihedralPotential.h>
+#endif
+#ifdef SIMP_EXTERNAL
+#include <ddMd/potentials/external/ExternalPotential.h>
+#endif
+#ifdef SIMP_COULOMB
+#include <ddMd/potentials/coulomb/CoulombPotential.h>
+#endif
+#include <util/ensembles/BoundaryEnsemble.h>
+#include <util/misc/Timer.h>
+#include <util/global.h>
+
+namespace DdMd
+{
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   RespaIntegrator::RespaIntegrator(Simulation& simulation)
+    : TwoStepIntegrator(simulation),
+      nInner_(1),
+      slowForces_()
+   {}
+
+   /*
+   * Destructor.
+   */
+   RespaIntegrator::~RespaIntegrator()
+   {}
+
+   /*
+   * Check preconditions, then run integrator for nStep inner steps.
+   */
+   void RespaIntegrator::run(int nStep)
+   {
+      if (nStep % nInner_ != 0) {
+         UTIL_THROW("Number of steps is not a multiple of nInner");
+      }
+      if (iStep_ % nInner_ != 0) {
+         UTIL_THROW("Initial step index is not a multiple of nInner");
+      }
+      TwoStepIntegrator::run(nStep);
+   }
+
+   /*
+   * Validate parameters, allocate slowForces_, compute split forces.
+   */
+   void RespaIntegrator::setupRespa()
+   {
+      if (nInner_ < 1) {
+         UTIL_THROW("nInner < 1");
+      }
+      if (!simulation().boundaryEnsemble().isRigid()) {
+         UTIL_THROW("RESPA integrator requires a rigid boundary");
+      }
+      if (overlapUpdate()) {
+         UTIL_THROW("RESPA integrator does not support overlapUpdate");
+      }
+      if (Analyzer::baseInterval % nInner_ != 0) {
+         UTIL_THROW("Analyzer baseInterval is not a multiple of nInner");
+      }
+      if (saveInterval() % nInner_ != 0) {
+         UTIL_THROW("saveInterval is not a multiple of nInner");
+      }
+      if (!slowForces_.isAllocated()) {
+         slowForces_.allocate(atomStorage().atomCapacity());
+      }
+
+      // Replace total forces computed by setupAtoms() by split forces.
+      computeSlowForces(false);
+      computeFastForces();
+   }
+
+   /*
+   * Compute fast forces, and slow forces at the end of an outer step.
+   */
+   void RespaIntegrator::computeStepForces(bool needEnergy)
+   {
+      if (isBlockEnd()) {
+         computeSlowForces(needEnergy);
+      }
+      computeFastForces();
+   }
+
+   /*
+   * Compute pair, external and coulomb forces, copy to slowForces_.
+   */
+   void RespaIntegrator::computeSlowForces(bool needEnergy)
+   {
+      // Precondition
+      if (!atomStorage().isCartesian()) {
+         UTIL_THROW("Atom coordinates are not Cartesian");
+      }
+
+      timer().stamp(MISC);
+      simulation().zeroForces();
+      timer().stamp(ZERO_FORCE);
+      if (needEnergy) {
+         pairPotential().computeForcesAndEnergy(domain().communicator(),
+                                                false);
+      } else {
+         pairPotential().computeForces();
+      }
+      timer().stamp(PAIR_FORCE);
+      #ifdef SIMP_EXTERNAL
+      if (hasExternal()) {
+         if (needEnergy) {
+            externalPotential().computeForcesAndEnergy(domain().communicator(),
+                                                       false);
+         } else {
+            externalPotential().computeForces();
+         }
+         timer().stamp(EXTERNAL_FORCE);
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (simulation().hasCoulomb()) {
+         simulation().coulombPotential().computeForces();
+         timer().stamp(COULOMB_FORCE);
+      }
+      #endif
+      if (reverseUpdateFlag()) {
+         exchanger().reverseUpdate();
+      }
+
+      // Store forces on local atoms (atomCapacity may have grown)
+      if (slowForces_.capacity() < atomStorage().atomCapacity()) {
+         slowForces_.deallocate();
+         slowForces_.allocate(atomStorage().atomCapacity());
+      }
+      AtomIterator atomIter;
+      int i = 0;
+      atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         slowForces_[i] = atomIter->force();
+         ++i;
+      }
+      timer().stamp(MISC);
+   }
+
+   /*
+   * Compute bond, angle and dihedral forces, store in atom forces.
+   */
+   void RespaIntegrator::computeFastForces()
+   {
+      timer().stamp(MISC);
+      simulation().zeroForces();
+      timer().stamp(ZERO_FORCE);
+      #ifdef SIMP_BOND
+      if (nBondType()) {
+         bondPotential().computeForces();
+         timer().stamp(BOND_FORCE);
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (nAngleType()) {
+         anglePotential().computeForces();
+         timer().stamp(ANGLE_FORCE);
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (nDihedralType()) {
+         dihedralPotential().computeForces();
+         timer().stamp(DIHEDRAL_FORCE);
+      }
+      #endif
+      if (reverseUpdateFlag()) {
+         exchanger().reverseUpdate();
+      }
+   }
+
+}
@@ -0,0 +1,127 @@
+#ifndef DDMD_RESPA_INTEGRATOR_H
+#define DDMD_RESPA_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TwoStepIntegrator.h"      // base class
+#include <util/containers/DArray.h> // member
+#include <util/space/Vector.h>      // member template argument
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Base class for multiple time step (RESPA) integrators.
+   *
+   * A RespaIntegrator splits the force on each atom into a fast
+   * component, from bond, angle and dihedral potentials, and a slow
+   * component, from pair, external and coulomb potentials. Each
+   * step of the TwoStepIntegrator main loop is one inner step with
+   * time step dt, in which only the fast forces are recomputed. Slow
+   * forces are recomputed once per outer step of nInner inner steps,
+   * and are applied as impulses of duration nInner*dt/2 at the
+   * beginning and end of each outer step (the reversible impulse
+   * RESPA scheme of Tuckerman, Berne and Martyna).
+   *
+   * During a run, Atom::force() holds only the fast force, while the
+   * slow force on each local atom is stored by this class. Analyzer
+   * sampling intervals, the restart save interval and the number of
+   * steps in each run must all be multiples of nInner, so that every
+   * outer step is completed between samples. The boundary must be
+   * rigid, and the overlapUpdate option is not supported.
+   *
+   * Subclasses must read nInner, call setupRespa() at the end of
+   * setup(), and apply the fast and slow forces in integrateStep1()
+   * and integrateStep2().
+   *
+   * \ingroup DdMd_Integrator_Module
+   */
+   class RespaIntegrator : public TwoStepIntegrator
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      RespaIntegrator(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      ~RespaIntegrator();
+
+      /**
+      * Run a simulation.
+      *
+      * \param nStep number of inner steps (a multiple of nInner)
+      */
+      void run(int nStep);
+
+   protected:
+
+      /// Number of inner steps per outer step.
+      int nInner_;
+
+      /**
+      * Validate parameters, allocate memory and compute split forces.
+      *
+      * Call at the end of setup(), after setupAtoms().
+      */
+      void setupRespa();
+
+      /**
+      * Compute fast forces, and also slow forces at the end of a block.
+      *
+      * \param needEnergy if true, also compute energies for sampling
+      */
+      virtual void computeStepForces(bool needEnergy);
+
+      /**
+      * Is the current step the first inner step of an outer step?
+      */
+      bool isBlockBegin() const
+      {  return (iStep_ % nInner_ == 0); }
+
+      /**
+      * Is the current step the last inner step of an outer step?
+      */
+      bool isBlockEnd() const
+      {  return ((iStep_ + 1) % nInner_ == 0); }
+
+      /**
+      * Get the slow force on a local atom.
+      *
+      * \param i index of atom, in order of local atom iteration
+      */
+      const Vector& slowForce(int i) const
+      {  return slowForces_[i]; }
+
+   private:
+
+      /// Slow forces on local atoms, in order of local atom iteration.
+      DArray<Vector> slowForces_;
+
+      /**
+      * Compute slow forces and store them in slowForces_.
+      *
+      * \param needEnergy if true, also compute pair and external energy
+      */
+      void computeSlowForces(bool needEnergy);
+
+      /**
+      * Compute fast forces and store them in atom forces.
+      */
+      void computeFastForces();
+
+   };
+
+}
+#endif
@@ -13,7 +13,10 @@
 #include <ddMd/modifiers/ModifierManager.h>
 #endif
 #include <ddMd/analyzers/AnalyzerManager.h>
+#include <ddMd/analyzers/Analyzer.h>
+#include <ddMd/misc/Tracer.h>
 #include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/potentials/AtomStress.h>
 #include <util/ensembles/BoundaryEnsemble.h>
 #include <util/misc/Log.h>
 #include <util/global.h>
@@ -38,6 +41,34 @@ namespace DdMd
    TwoStepIntegrator::~TwoStepIntegrator()
    {}
 
+   /*
+   * Compute forces (and virial, if not rigid) for one step.
+   */
+   void TwoStepIntegrator::computeStepForces(bool needEnergy)
+   {
+      if (needAtomStress()) {
+         AtomStress& atomStress = simulation().atomStress();
+         atomStress.begin(iStep_ + 1);
+         computeForcesAndVirial(needEnergy);
+         atomStress.end();
+      } else
+      if (simulation().boundaryEnsemble().isRigid()) {
+         computeForces(needEnergy);
+      } else {
+         computeForcesAndVirial(needEnergy);
+      }
+   }
+
+   /*
+   * Are per-atom energies and virials needed after this step?
+   */
+   bool TwoStepIntegrator::needAtomStress()
+   {
+      AtomStress& atomStress = simulation().atomStress();
+      if (!atomStress.isRequested()) return false;
+      return ((iStep_ + 1) % atomStress.interval() == 0);
+   }
+
    /*
    * Run integrator for nStep steps.
    */
@@ -76,7 +107,10 @@ namespace DdMd
       int  beginStep = iStep_;
       int  endStep = iStep_ + nStep;
       bool needExchange;
+      bool needRebuild;
+      bool needForces;
       for ( ; iStep_ < endStep; ++iStep_) {
+         Tracer::setStep(iStep_);
 
          // Atomic coordinates must be Cartesian on entry to loop body.
          if (!atomStorage().isCartesian()) {
@@ -97,8 +131,10 @@ namespace DdMd
          timer().stamp(ANALYZER);
  
          #ifdef DDMD_MODIFIERS 
-         modifierManager.preIntegrate1(iStep_);
-         timer().stamp(MODIFIER);
+         if (modifierManager.hasAction(Modifier::Flags::PreIntegrate1)) {
+            modifierManager.preIntegrate1(iStep_);
+            timer().stamp(MODIFIER);
+         }
          #endif
    
          // First step of integration: Update positions, half velocity 
@@ -115,13 +151,33 @@ namespace DdMd
          #endif
 
          #ifdef DDMD_MODIFIERS 
-         modifierManager.postIntegrate1(iStep_);
-         timer().stamp(MODIFIER);
+         if (modifierManager.hasAction(Modifier::Flags::PostIntegrate1)) {
+            modifierManager.postIntegrate1(iStep_);
+            setMaxSqDisplacement(-1.0);
+            timer().stamp(MODIFIER);
+         }
          #endif
    
-         // Check if exchange and reneighboring is necessary
+         needForces = true;
+
+         // Check if reneighboring is necessary, and if so whether it
+         // requires an exchange, or may use the existing ghosts.
          // Note: Integrate::isExchangeNeeded uses timer.
-         needExchange = isExchangeNeeded(pairPotential().skin());
+         needRebuild = isExchangeNeeded(pairPotential().skin());
+         needExchange = false;
+         if (needRebuild) {
+            needExchange = isFullExchangeNeeded();
+         }
+
+         // Rebalance domain boundaries, if scheduled. Forces exchange.
+         if (balanceDomains()) {
+            needExchange = true;
+         }
+
+         // Adjust pair list skin, if scheduled. Forces exchange.
+         if (tuneSkin()) {
+            needExchange = true;
+         }
 
          if (!atomStorage().isCartesian()) {
             UTIL_THROW("Error: atomic coordinates are not Cartesian");
@@ -131,8 +187,10 @@ namespace DdMd
          if (needExchange) {
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.preTransform(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PreTransform)) {
+               modifierManager.preTransform(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
       
             // Transform to scaled [0,1] coordinates
@@ -141,17 +199,31 @@ namespace DdMd
             timer().stamp(Integrator::TRANSFORM_F);
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.preExchange(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PreExchange)) {
+               modifierManager.preExchange(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
       
+            // Plan only atoms of boundary cells, unless moved by modifiers
+            #ifdef DDMD_MODIFIERS
+            if (!modifierManager.hasAction(Modifier::Flags::PreTransform) &&
+                !modifierManager.hasAction(Modifier::Flags::PreExchange)) {
+               enableBoundaryScan();
+            }
+            #else
+            enableBoundaryScan();
+            #endif
+
             // Exchange atom ownership, reidentify ghosts
             exchanger().exchange();
             timer().stamp(Integrator::EXCHANGE);
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.postExchange(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PostExchange)) {
+               modifierManager.postExchange(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
    
             // Build cell list 
@@ -164,28 +236,71 @@ namespace DdMd
 
             // Build pair list
             atomStorage().makeSnapshot();
+            resetExchangeCheck();
             pairPotential().buildPairList();
             timer().stamp(Integrator::PAIRLIST);
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.postNeighbor(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PostNeighbor)) {
+               modifierManager.postNeighbor(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
    
+         } else
+         if (needRebuild) { // Rebuild pair list from existing ghosts
+
+            #ifdef DDMD_MODIFIERS
+            if (modifierManager.hasAction(Modifier::Flags::PreUpdate)) {
+               modifierManager.preUpdate(iStep_);
+               timer().stamp(MODIFIER);
+            }
+            #endif
+
+            rebuildPairList();
+
+            #ifdef DDMD_MODIFIERS
+            if (modifierManager.hasAction(Modifier::Flags::PostUpdate)) {
+               modifierManager.postUpdate(iStep_);
+               timer().stamp(MODIFIER);
+            }
+            if (modifierManager.hasAction(Modifier::Flags::PostNeighbor)) {
+               modifierManager.postNeighbor(iStep_);
+               timer().stamp(MODIFIER);
+            }
+            #endif
+
          } else { // Update step (no exchange)
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.preUpdate(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PreUpdate)) {
+               modifierManager.preUpdate(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
      
-            // Update all ghost atom positions 
-            exchanger().update();
-            timer().stamp(UPDATE);
+            // Update all ghost atom positions. If overlapUpdate is enabled,
+            // also compute forces, overlapping communication of ghost 
+            // positions with computation of forces between local atoms.
+            // Steps that need energies or stresses instead use the fused
+            // force, energy and virial loop of computeStepForces().
+            bool needEnergy = (Analyzer::baseInterval > 0)
+                        && ((iStep_ + 1) % Analyzer::baseInterval == 0);
+            bool needStress = !simulation().boundaryEnsemble().isRigid();
+            if (overlapUpdate() && pairPotential().methodId() == 0 
+                && !needEnergy && !needStress && !needAtomStress()) {
+               updateAndComputeForces();
+               needForces = false;
+            } else {
+               exchanger().update();
+               timer().stamp(UPDATE);
+            }
 
             #ifdef DDMD_MODIFIERS 
-            modifierManager.postUpdate(iStep_);
-            timer().stamp(MODIFIER);
+            if (modifierManager.hasAction(Modifier::Flags::PostUpdate)) {
+               modifierManager.postUpdate(iStep_);
+               timer().stamp(MODIFIER);
+            }
             #endif
    
          }
@@ -202,24 +317,29 @@ namespace DdMd
          }
 
          #ifdef DDMD_MODIFIERS 
-         modifierManager.preForce(iStep_);
-         timer().stamp(MODIFIER);
+         if (modifierManager.hasAction(Modifier::Flags::PreForce)) {
+            modifierManager.preForce(iStep_);
+            timer().stamp(MODIFIER);
+         }
          #endif
   
          // Calculate forces: 
          // Calculate new forces for all local atoms. If constant pressure
          // ensemble (not rigid), also calculate the virial stress. Both 
          // methods use the timer() internall, and both send the modifyForce 
-         // signal. 
-         if (simulation().boundaryEnsemble().isRigid()) {
-            computeForces();
-         } else {
-            computeForcesAndVirial();
+         // signal. If analyzers will sample the next step, also compute
+         // the pair energy within the pair force loop.
+         if (needForces) {
+            bool needEnergy = (Analyzer::baseInterval > 0) 
+                        && ((iStep_ + 1) % Analyzer::baseInterval == 0);
+            computeStepForces(needEnergy);
          }
 
          #ifdef DDMD_MODIFIERS 
-         modifierManager.postForce(iStep_);
-         timer().stamp(MODIFIER);
+         if (modifierManager.hasAction(Modifier::Flags::PostForce)) {
+            modifierManager.postForce(iStep_);
+            timer().stamp(MODIFIER);
+         }
          #endif
    
          // 2nd step of velocity-Verlet integration. This finishes the velocity 
@@ -234,11 +354,15 @@ namespace DdMd
          #endif
 
          #ifdef DDMD_MODIFIERS 
-         modifierManager.endOfStep(iStep_);
-         timer().stamp(MODIFIER);
+         if (modifierManager.hasAction(Modifier::Flags::EndOfStep)) {
+            modifierManager.endOfStep(iStep_);
+            timer().stamp(MODIFIER);
+         }
          #endif
 
       }
+      Tracer::stop();
+      resetExchangeCheck();
       exchanger().timer().stop();
       timer().stop();
 
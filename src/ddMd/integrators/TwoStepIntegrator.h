@@ -62,6 +62,28 @@ namespace DdMd
       */
       virtual void integrateStep2() = 0;
 
+      /**
+      * Compute forces after the atom exchange or update of each step.
+      *
+      * The default implementation calls computeForces(needEnergy) if the
+      * boundary is rigid, and computeForcesAndVirial(needEnergy) if not.
+      * If needAtomStress() is true, it instead activates the AtomStress
+      * and calls computeForcesAndVirial(needEnergy) for any boundary.
+      * Subclasses may override this to split forces into components
+      * that are evaluated with different frequencies.
+      *
+      * \param needEnergy if true, also compute energies for sampling
+      */
+      virtual void computeStepForces(bool needEnergy);
+
+      /**
+      * Are per-atom energies and virials needed after this step?
+      *
+      * Returns true if Simulation::atomStress() has been requested at
+      * an interval that divides iStep_ + 1.
+      */
+      bool needAtomStress();
+
    };
 
 }
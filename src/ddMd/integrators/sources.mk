@@ -2,10 +2,18 @@ ddMd_integrators_=\
    ddMd/integrators/Integrator.cpp \
    ddMd/integrators/TwoStepIntegrator.cpp \
    ddMd/integrators/NveIntegrator.cpp \
+   ddMd/integrators/BondConstraints.cpp \
+   ddMd/integrators/NveRattleIntegrator.cpp \
    ddMd/integrators/NvtIntegrator.cpp \
    ddMd/integrators/NvtLangevinIntegrator.cpp \
+   ddMd/integrators/NvtBrownianIntegrator.cpp \
+   ddMd/integrators/NvtDpdIntegrator.cpp \
+   ddMd/integrators/NvtLeesEdwardsIntegrator.cpp \
    ddMd/integrators/NptIntegrator.cpp \
    ddMd/integrators/NphIntegrator.cpp \
+   ddMd/integrators/RespaIntegrator.cpp \
+   ddMd/integrators/NveRespaIntegrator.cpp \
+   ddMd/integrators/NvtRespaIntegrator.cpp \
    ddMd/integrators/IntegratorFactory.cpp
 
 ddMd_integrators_SRCS=\
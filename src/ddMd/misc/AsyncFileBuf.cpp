@@ -0,0 +1,256 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AsyncFileBuf.h"
+
+#include <ostream>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   AsyncFileBuf::AsyncFileBuf()
+    : std::streambuf(),
+      streamPtr_(0),
+      fileBufPtr_(0),
+      active_(),
+      pending_(),
+      position_(0),
+      hasPending_(false),
+      hasError_(false)
+      #ifdef DDMD_ASYNC_IO
+      , isRunning_(false)
+      , isDone_(false)
+      #endif
+   {
+      #ifdef DDMD_ASYNC_IO
+      pthread_mutex_init(&mutex_, 0);
+      pthread_cond_init(&cond_, 0);
+      #endif
+   }
+
+   /*
+   * Destructor.
+   */
+   AsyncFileBuf::~AsyncFileBuf()
+   {
+      // Do not throw from a destructor
+      try {
+         detach();
+      } catch (...) {}
+
+      #ifdef DDMD_ASYNC_IO
+      if (isRunning_) {
+         pthread_mutex_lock(&mutex_);
+         isDone_ = true;
+         pthread_cond_broadcast(&cond_);
+         pthread_mutex_unlock(&mutex_);
+         pthread_join(thread_, 0);
+         isRunning_ = false;
+      }
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
+      #endif
+   }
+
+   /*
+   * Attach to an open stream, and start writer thread if necessary.
+   */
+   void AsyncFileBuf::attach(std::ofstream& stream)
+   {
+      detach();
+      if (!stream.is_open()) {
+         UTIL_THROW("Stream is not open");
+      }
+      fileBufPtr_ = stream.rdbuf();
+      position_ = long(fileBufPtr_->pubseekoff(0, std::ios::cur,
+                                               std::ios::out));
+      if (position_ < 0) position_ = 0;
+      hasError_ = false;
+
+      #ifdef DDMD_ASYNC_IO
+      if (!isRunning_) {
+         isDone_ = false;
+         if (pthread_create(&thread_, 0, &AsyncFileBuf::runThread, this)) {
+            UTIL_THROW("Failed to create writer thread");
+         }
+         isRunning_ = true;
+      }
+      #endif
+
+      // Replace the buffer of the stream (std::ios), not of the file
+      stream.std::ios::rdbuf(this);
+      stream.clear();
+      streamPtr_ = &stream;
+   }
+
+   /*
+   * Submit accumulated data for writing.
+   */
+   void AsyncFileBuf::submit()
+   {
+      if (!streamPtr_) {
+         UTIL_THROW("No attached stream");
+      }
+      wait();
+      if (active_.empty()) return;
+
+      #ifdef DDMD_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      pending_.swap(active_);
+      hasPending_ = true;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #else
+      pending_.swap(active_);
+      hasPending_ = true;
+      writePending();
+      #endif
+      active_.clear();
+   }
+
+   /*
+   * Block until submitted data has been written.
+   */
+   void AsyncFileBuf::wait()
+   {
+      bool hasError;
+      #ifdef DDMD_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      while (hasPending_) {
+         pthread_cond_wait(&cond_, &mutex_);
+      }
+      hasError = hasError_;
+      pthread_mutex_unlock(&mutex_);
+      #else
+      hasError = hasError_;
+      #endif
+      if (hasError) {
+         UTIL_THROW("Error writing output file in background");
+      }
+   }
+
+   /*
+   * Write remaining data and restore the buffer of the stream.
+   */
+   void AsyncFileBuf::detach()
+   {
+      if (streamPtr_) {
+         std::ofstream& stream = *streamPtr_;
+         try {
+            submit();
+            wait();
+         } catch (...) {
+            stream.std::ios::rdbuf(fileBufPtr_);
+            streamPtr_ = 0;
+            fileBufPtr_ = 0;
+            active_.clear();
+            throw;
+         }
+         stream.std::ios::rdbuf(fileBufPtr_);
+         streamPtr_ = 0;
+         fileBufPtr_ = 0;
+      }
+      active_.clear();
+   }
+
+   /*
+   * Write pending data to file.
+   */
+   void AsyncFileBuf::writePending()
+   {
+      std::streamsize n = std::streamsize(pending_.size());
+      bool hasError = (fileBufPtr_->sputn(pending_.data(), n) != n);
+      if (fileBufPtr_->pubsync() == -1) {
+         hasError = true;
+      }
+      pending_.clear();
+
+      #ifdef DDMD_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      #endif
+      if (hasError) hasError_ = true;
+      hasPending_ = false;
+      #ifdef DDMD_ASYNC_IO
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #endif
+   }
+
+   #ifdef DDMD_ASYNC_IO
+   /*
+   * Writer thread main loop.
+   */
+   void AsyncFileBuf::run()
+   {
+      pthread_mutex_lock(&mutex_);
+      while (true) {
+         while (!hasPending_ && !isDone_) {
+            pthread_cond_wait(&cond_, &mutex_);
+         }
+         if (!hasPending_) break;
+
+         // The main thread does not touch pending_ or the file while
+         // hasPending_ is true, so the write is done without the lock.
+         pthread_mutex_unlock(&mutex_);
+         writePending();
+         pthread_mutex_lock(&mutex_);
+      }
+      pthread_mutex_unlock(&mutex_);
+   }
+
+   /*
+   * Static entry point for the writer thread.
+   */
+   void* AsyncFileBuf::runThread(void* ptr)
+   {
+      static_cast<AsyncFileBuf*>(ptr)->run();
+      return 0;
+   }
+   #endif
+
+   /*
+   * Append one character.
+   */
+   AsyncFileBuf::int_type AsyncFileBuf::overflow(int_type c)
+   {
+      if (traits_type::eq_int_type(c, traits_type::eof())) {
+         return traits_type::not_eof(c);
+      }
+      active_ += traits_type::to_char_type(c);
+      ++position_;
+      return c;
+   }
+
+   /*
+   * Append a block of characters.
+   */
+   std::streamsize AsyncFileBuf::xsputn(const char* s, std::streamsize n)
+   {
+      active_.append(s, n);
+      position_ += n;
+      return n;
+   }
+
+   /*
+   * Report the current output position.
+   */
+   AsyncFileBuf::pos_type 
+   AsyncFileBuf::seekoff(off_type off, std::ios::seekdir dir,
+                         std::ios::openmode which)
+   {
+      if (off == 0 && dir == std::ios::cur && (which & std::ios::out)) {
+         return pos_type(position_);
+      }
+      return pos_type(off_type(-1));
+   }
+
+}
@@ -0,0 +1,175 @@
+#ifndef DDMD_ASYNC_FILE_BUF_H
+#define DDMD_ASYNC_FILE_BUF_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+
+#ifdef DDMD_ASYNC_IO
+#include <pthread.h>
+#endif
+
+namespace DdMd 
+{
+
+   using namespace Util;
+
+   /**
+   * Double-buffered stream buffer that writes a file in the background.
+   *
+   * An AsyncFileBuf is attached to an open std::ofstream, so that
+   * everything written to the stream is stored in memory. Each call to
+   * submit()
+   * hands the accumulated data (e.g., one trajectory frame) to a writer
+   * thread, and returns immediately, so that the caller can continue
+   * while the data is written to disk. Data is written in the order it
+   * was submitted. Function submit() only blocks if the data from the
+   * previous call has not yet been fully written. The functions attach(),
+   * detach() and wait() also wait for all submitted data to be written.
+   * The data is written through the file buffer of the stream itself.
+   *
+   * The writer thread is only used if the program is compiled with the
+   * DDMD_ASYNC_IO preprocessor macro defined, which requires pthreads.
+   * Otherwise, submit() writes data synchronously. The writer thread 
+   * never calls MPI functions.
+   *
+   * Because the file is opened by the std::ofstream in the usual way,
+   * is_open() is valid while the AsyncFileBuf is attached, so that the
+   * stream can be passed to any function that checks it. The stream
+   * must not be closed until detach() has been called. While attached,
+   * tellp() returns the file position including unwritten data.
+   */
+   class AsyncFileBuf : public std::streambuf
+   {
+   
+   public:
+   
+      /**
+      * Constructor.
+      */
+      AsyncFileBuf();
+
+      /**
+      * Destructor. 
+      *
+      * Writes any remaining data, closes file and stops the writer thread.
+      */
+      virtual ~AsyncFileBuf();
+
+      /**
+      * Redirect all output to an open file stream to this buffer.
+      *
+      * Detaches from any previously attached stream.
+      *
+      * \param stream open output file stream
+      */
+      void attach(std::ofstream& stream);
+
+      /**
+      * Submit all data written since the last submit for writing.
+      */
+      void submit();
+
+      /**
+      * Block until all submitted data has been written.
+      */
+      void wait();
+
+      /**
+      * Submit remaining data, wait until it is written, and restore the
+      * original buffer of the stream, which may then be closed.
+      */
+      void detach();
+
+      /**
+      * Is a stream attached?
+      */
+      bool isAttached() const;
+
+   protected:
+
+      /**
+      * Append one character to the active buffer.
+      */
+      virtual int_type overflow(int_type c);
+
+      /**
+      * Append a block of characters to the active buffer.
+      */
+      virtual std::streamsize xsputn(const char* s, std::streamsize n);
+
+      /**
+      * Return current position (only supports queries, for tellp).
+      */
+      virtual pos_type seekoff(off_type off, std::ios::seekdir dir,
+                               std::ios::openmode which = std::ios::out);
+
+   private:
+
+      /// Attached stream, or null.
+      std::ofstream* streamPtr_;
+
+      /// File buffer of the attached stream, to which data is written.
+      std::filebuf* fileBufPtr_;
+
+      /// Buffer being filled by the main thread.
+      std::string active_;
+
+      /// Buffer being written by the writer thread.
+      std::string pending_;
+
+      /// File position, including data not yet written.
+      long position_;
+
+      /// Is the pending buffer waiting to be written?
+      bool hasPending_;
+
+      /// Did a write fail?
+      bool hasError_;
+
+      #ifdef DDMD_ASYNC_IO
+      /// Writer thread.
+      pthread_t thread_;
+
+      /// Mutex protecting pending_, hasPending_, hasError_ and isDone_.
+      pthread_mutex_t mutex_;
+
+      /// Condition variable signalled when hasPending_ changes.
+      pthread_cond_t cond_;
+
+      /// Has the writer thread been started?
+      bool isRunning_;
+
+      /// Should the writer thread exit?
+      bool isDone_;
+
+      /// Writer thread main loop.
+      void run();
+
+      /// Entry point for pthread_create.
+      static void* runThread(void* ptr);
+      #endif
+
+      /// Write pending_ buffer to file (called by writer thread, if any).
+      void writePending();
+
+      // Copy constructor and assignment (not implemented).
+      AsyncFileBuf(const AsyncFileBuf& other);
+      AsyncFileBuf& operator = (const AsyncFileBuf& other);
+
+   };
+
+   inline bool AsyncFileBuf::isAttached() const
+   {  return (streamPtr_ != 0); }
+
+}
+#endif
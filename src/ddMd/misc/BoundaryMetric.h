@@ -0,0 +1,75 @@
+#ifndef DDMD_BOUNDARY_METRIC_H
+#define DDMD_BOUNDARY_METRIC_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/math/Constants.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Width in generalized coordinate i of a slab of Cartesian thickness.
+   *
+   * Returns width*|b_i|/(2 pi), where b_i is reciprocal basis vector i.
+   * This is the change in generalized coordinate i over a Cartesian
+   * distance width along the normal to surfaces of constant coordinate
+   * i, and reduces to width/L_i for an orthorhombic boundary. Slabs
+   * of ghosts, domain widths and cell sizes defined in generalized
+   * coordinates with this function thus remain valid for triclinic
+   * boundaries.
+   *
+   * \param boundary  periodic boundary
+   * \param width  Cartesian thickness
+   * \param i  index of generalized coordinate
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   inline
+   double scaledWidth(const Boundary& boundary, double width, int i)
+   {
+      return width*boundary.reciprocalBasisVector(i).abs()
+             /(2.0*Constants::Pi);
+   }
+
+   /**
+   * Are all Bravais basis vectors of a boundary mutually orthogonal?
+   *
+   * \param boundary  periodic boundary
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   inline
+   bool isOrthogonal(const Boundary& boundary)
+   {
+      const double tolerance = 1.0E-10;
+      double dot, norm;
+      int i, j;
+      for (i = 0; i < Dimension; ++i) {
+         const Vector& a = boundary.bravaisBasisVector(i);
+         for (j = i + 1; j < Dimension; ++j) {
+            const Vector& b = boundary.bravaisBasisVector(j);
+            dot = a.dot(b);
+            norm = a.abs()*b.abs();
+            if (std::fabs(dot) > tolerance*norm) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+}
+#endif
@@ -6,6 +6,7 @@
 */
 
 #include "DdTimer.h"
+#include "Tracer.h"
 
 namespace DdMd
 {
@@ -13,34 +14,84 @@ namespace DdMd
    DdTimer::DdTimer(int size)
    {
       times_.allocate(size);
+      localTimes_.allocate(size);
+      minTimes_.allocate(size);
+      maxTimes_.allocate(size);
+      counts_.allocate(size*PerfCounters::NCounter);
       size_ = size;
+      traceId_ = -1;
       clear();
    }
 
    DdTimer::~DdTimer()
    {}
 
+   void DdTimer::allocate(int size)
+   {
+      if (times_.isAllocated()) {
+         times_.deallocate();
+         localTimes_.deallocate();
+         minTimes_.deallocate();
+         maxTimes_.deallocate();
+         counts_.deallocate();
+      }
+      times_.allocate(size);
+      localTimes_.allocate(size);
+      minTimes_.allocate(size);
+      maxTimes_.allocate(size);
+      counts_.allocate(size*PerfCounters::NCounter);
+      size_ = size;
+      clear();
+   }
+
    void DdTimer::clear()
    {
       for (int i = 0; i < size_; i++) {
          times_[i] = 0.0;
+         localTimes_[i] = 0.0;
+         minTimes_[i] = 0.0;
+         maxTimes_[i] = 0.0;
+      }
+      for (int i = 0; i < size_*PerfCounters::NCounter; i++) {
+         counts_[i] = 0.0;
       }
       time_ = 0.0;
+      maxTime_ = 0.0;
+      isReduced_ = false;
    }
 
    void DdTimer::start()
    {
       begin_ = MPI_Wtime(); 
       previous_ = begin_;
+      if (counters_.isActive()) {
+         counters_.read(previousCounts_);
+      }
    }
 
    void DdTimer::stamp(int id)
    {
       double current = MPI_Wtime();
       times_[id] += current - previous_;
+      localTimes_[id] += current - previous_;
+      if (traceId_ >= 0) {
+         Tracer::record(traceId_ + id, previous_, current);
+      }
       previous_ = current;
+      if (counters_.isActive()) {
+         double current[PerfCounters::NCounter];
+         counters_.read(current);
+         double* counts = &counts_[id*PerfCounters::NCounter];
+         for (int k = 0; k < PerfCounters::NCounter; ++k) {
+            counts[k] += current[k] - previousCounts_[k];
+            previousCounts_[k] = current[k];
+         }
+      }
    }
 
+   void DdTimer::setTraceId(int first)
+   {  traceId_ = first; }
+
    void DdTimer::stop()
    {  time_ += MPI_Wtime() - begin_; }
 
@@ -49,12 +100,30 @@ namespace DdMd
    {
       int procs = communicator.Get_size();
       double sum;
+      if (size_ > 0) {
+         communicator.Allreduce(&times_[0], &minTimes_[0], size_, 
+                                MPI::DOUBLE, MPI::MIN);
+         communicator.Allreduce(&times_[0], &maxTimes_[0], size_, 
+                                MPI::DOUBLE, MPI::MAX);
+      }
       for (int i = 0; i < size_; i++) {
          communicator.Allreduce(&times_[i], &sum, 1, MPI::DOUBLE, MPI::SUM);
          times_[i] = sum/double(procs);
       }
+      if (size_ > 0) {
+         int n = size_*PerfCounters::NCounter;
+         DArray<double> sums;
+         sums.allocate(n);
+         communicator.Allreduce(&counts_[0], &sums[0], n,
+                                MPI::DOUBLE, MPI::SUM);
+         for (int i = 0; i < n; i++) {
+            counts_[i] = sums[i]/double(procs);
+         }
+      }
+      communicator.Allreduce(&time_, &maxTime_, 1, MPI::DOUBLE, MPI::MAX);
       communicator.Allreduce(&time_, &sum, 1, MPI::DOUBLE, MPI::SUM);
       time_ = sum/double(procs);
+      isReduced_ = true;
    }
    #endif
 
@@ -64,4 +133,37 @@ namespace DdMd
    double DdTimer::time() const
    {  return time_; }
 
+   double DdTimer::localTime(int id) const
+   {  return localTimes_[id]; }
+
+   double DdTimer::minTime(int id) const
+   {  return isReduced_ ? minTimes_[id] : times_[id]; }
+
+   double DdTimer::maxTime(int id) const
+   {  return isReduced_ ? maxTimes_[id] : times_[id]; }
+
+   double DdTimer::maxTime() const
+   {  return isReduced_ ? maxTime_ : time_; }
+
+   double DdTimer::imbalance(int id) const
+   {
+      if (times_[id] > 0.0) {
+         return maxTime(id)/times_[id];
+      } else {
+         return 1.0;
+      }
+   }
+
+   int DdTimer::size() const
+   {  return size_; }
+
+   bool DdTimer::enableCounters()
+   {  return counters_.open(); }
+
+   bool DdTimer::hasCounters() const
+   {  return counters_.isActive(); }
+
+   double DdTimer::count(int id, int k) const
+   {  return counts_[id*PerfCounters::NCounter + k]; }
+
 }
@@ -8,6 +8,7 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
+#include "PerfCounters.h"
 #include <util/containers/DArray.h>
 #include <util/global.h>
 
@@ -20,6 +21,13 @@ namespace DdMd
    * Class for measuring time intervals.
    *
    * Design adapted from the timer class in Lammps.
+   *
+   * If enableCounters() succeeds, hardware performance counters (see
+   * PerfCounters) are also read at every stamp, and the change in each
+   * counter is accumulated for each interval, like the time.
+   *
+   * If setTraceId() has been called, every interval is also passed to
+   * Tracer::record(), for export of a timeline of phases.
    */
    class DdTimer 
    {
@@ -29,6 +37,13 @@ namespace DdMd
       DdTimer(int size = 0);
       ~DdTimer();
 
+      /**
+      * Set the number of time intervals, and clear statistics.
+      *
+      * \param size number of time intervals
+      */
+      void allocate(int size);
+
       /**
       *  Clear all time statistics.
       */ 
@@ -59,9 +74,80 @@ namespace DdMd
       */ 
       double time() const;
 
+      /**
+      * Get accumulated time for interval id on this processor.
+      *
+      * Unlike time(id), this is never changed by reduce().
+      */
+      double localTime(int id) const;
+
+      /**
+      * Get minimum over processors of time for interval id.
+      *
+      * Value is set by reduce(), and equals time(id) before reduction.
+      */ 
+      double minTime(int id) const;
+
+      /**
+      * Get maximum over processors of time for interval id.
+      *
+      * Value is set by reduce(), and equals time(id) before reduction.
+      */ 
+      double maxTime(int id) const;
+
+      /**
+      * Get maximum over processors of total time.
+      */ 
+      double maxTime() const;
+
+      /**
+      * Get load imbalance factor for interval id.
+      *
+      * The imbalance factor is the ratio maxTime(id)/time(id) of the
+      * maximum to the average time. It is 1.0 for perfect balance, or 
+      * if the average time is zero.
+      */ 
+      double imbalance(int id) const;
+
+      /**
+      * Get number of time intervals.
+      */
+      int size() const;
+
+      /**
+      * Open hardware performance counters, if possible.
+      *
+      * \return true if counters are active, false otherwise
+      */
+      bool enableCounters();
+
+      /**
+      * Are hardware performance counters active?
+      */
+      bool hasCounters() const;
+
+      /**
+      * Get accumulated count k for interval id, average per processor.
+      *
+      * \param id interval index
+      * \param k counter index (a value of PerfCounters::CounterId)
+      */
+      double count(int id, int k) const;
+
+      /**
+      * Record intervals with the Tracer, with name ids first + id.
+      *
+      * \param first Tracer name id of interval 0
+      */
+      void setTraceId(int first);
+
       #ifdef UTIL_MPI
       /**
       * Upon return, times on every processor replaced by average over procs.
+      *
+      * Minimum and maximum values over processors are also computed, and
+      * may be retrieved by minTime(id), maxTime(id) and imbalance(id).
+      * Hardware counts, if any, are also replaced by averages.
       */
       void reduce(MPI::Intracomm& communicator);
       #endif
@@ -69,10 +155,19 @@ namespace DdMd
    private:
    
       DArray<double> times_;
+      DArray<double> localTimes_;
+      DArray<double> minTimes_;
+      DArray<double> maxTimes_;
+      DArray<double> counts_;
+      PerfCounters counters_;
+      double previousCounts_[PerfCounters::NCounter];
+      double maxTime_;
       double previous_;
       double begin_;
       double time_;
       int    size_;
+      int    traceId_;
+      bool   isReduced_;
 
    };
 
@@ -0,0 +1,101 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "MemoryReport.h"
+
+#include <iomanip>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   MemoryReport::MemoryReport()
+   {}
+
+   /*
+   * Add an entry for this processor.
+   */
+   void MemoryReport::add(const std::string& name, double allocated, 
+                          double highWater)
+   {
+      names_.push_back(name);
+      local_.push_back(allocated);
+      local_.push_back(highWater);
+      min_.push_back(allocated);
+      min_.push_back(highWater);
+      max_.push_back(allocated);
+      max_.push_back(highWater);
+      average_.push_back(allocated);
+      average_.push_back(highWater);
+   }
+
+   /*
+   * Sum of allocated bytes on this processor.
+   */
+   double MemoryReport::totalAllocated() const
+   {
+      double total = 0.0;
+      for (int i = 0; i < size(); ++i) {
+         total += local_[2*i];
+      }
+      return total;
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Compute statistics over processors.
+   */
+   void MemoryReport::reduce(MPI::Intracomm& communicator)
+   {
+      int n = local_.size();
+      if (n == 0) return;
+      communicator.Allreduce(&local_[0], &min_[0], n, 
+                             MPI::DOUBLE, MPI::MIN);
+      communicator.Allreduce(&local_[0], &max_[0], n, 
+                             MPI::DOUBLE, MPI::MAX);
+      communicator.Allreduce(&local_[0], &average_[0], n, 
+                             MPI::DOUBLE, MPI::SUM);
+      double nProc = communicator.Get_size();
+      for (int i = 0; i < n; ++i) {
+         average_[i] /= nProc;
+      }
+   }
+   #endif
+
+   /*
+   * Write table of statistics, in bytes per processor.
+   */
+   void MemoryReport::output(std::ostream& out) const
+   {
+      out << std::endl;
+      out << "Memory usage per processor (bytes)" << std::endl;
+      out << std::left << std::setw(20) << "subsystem" << std::right
+          << std::setw(13) << "alloc avg"
+          << std::setw(13) << "alloc min"
+          << std::setw(13) << "alloc max"
+          << std::setw(13) << "high avg"
+          << std::setw(13) << "high min"
+          << std::setw(13) << "high max" << std::endl;
+      out << std::fixed << std::setprecision(0);
+      for (int i = 0; i < size(); ++i) {
+         out << std::left << std::setw(20) << names_[i] << std::right;
+         for (int j = 0; j < 2; ++j) {
+            out << std::setw(13) << average_[2*i + j]
+                << std::setw(13) << min_[2*i + j]
+                << std::setw(13) << max_[2*i + j];
+         }
+         out << std::endl;
+      }
+      out.unsetf(std::ios::floatfield);
+      out << std::setprecision(6);
+   }
+
+}
@@ -0,0 +1,106 @@
+#ifndef DDMD_MEMORY_REPORT_H
+#define DDMD_MEMORY_REPORT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace DdMd 
+{
+
+   using namespace Util;
+
+   /**
+   * Table of memory usage by subsystem, with statistics over processors.
+   *
+   * Each subsystem adds one or more named entries, each giving the
+   * number of bytes allocated on this processor and a high-water mark, 
+   * which is the number of bytes required by the largest number of 
+   * elements (atoms, groups, pairs or message bytes) stored on this 
+   * processor since statistics were last cleared. After reduce(), 
+   * output() writes the average, minimum and maximum of both values 
+   * over processors. All processors must add the same entries in the 
+   * same order.
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   class MemoryReport 
+   {
+   
+   public:
+
+      /**
+      * Constructor.
+      */
+      MemoryReport();
+
+      /**
+      * Add an entry.
+      *
+      * \param name  name of subsystem
+      * \param allocated  number of bytes allocated on this processor
+      * \param highWater  high-water mark of bytes used on this processor
+      */
+      void add(const std::string& name, double allocated, double highWater);
+
+      #ifdef UTIL_MPI
+      /**
+      * Compute average, minimum and maximum values over processors.
+      *
+      * \param communicator  communicator for all processors
+      */
+      void reduce(MPI::Intracomm& communicator);
+      #endif
+
+      /**
+      * Write table of statistics (call on master after reduce).
+      *
+      * \param out  output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Sum of allocated bytes of all entries on this processor.
+      */
+      double totalAllocated() const;
+
+      /**
+      * Number of entries.
+      */
+      int size() const;
+
+   private:
+
+      /// Names of entries.
+      std::vector<std::string> names_;
+
+      /// Values for this processor (allocated, highWater for each entry).
+      std::vector<double> local_;
+
+      /// Minimum values over processors.
+      std::vector<double> min_;
+
+      /// Maximum values over processors.
+      std::vector<double> max_;
+
+      /// Average values over processors.
+      std::vector<double> average_;
+
+   };
+
+   // Inline function
+
+   inline int MemoryReport::size() const
+   {  return names_.size(); }
+
+}
+#endif
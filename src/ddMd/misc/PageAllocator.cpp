@@ -0,0 +1,94 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "PageAllocator.h"
+
+#ifdef DDMD_HUGE_PAGES
+#include <sys/mman.h>
+#include <stdint.h>
+#endif
+
+namespace DdMd
+{
+
+   const size_t PageAllocator::HugePageSize;
+
+   #ifdef DDMD_HUGE_PAGES
+   double PageAllocator::total_ = 0.0;
+   double PageAllocator::max_ = 0.0;
+
+   /*
+   * Allocate aligned memory, advise, and zero in a static loop.
+   */
+   void* PageAllocator::allocateBlock(size_t size, int capacity)
+   {
+      if (capacity <= 0) {
+         UTIL_THROW("Capacity must be positive");
+      }
+      size_t bytes = size*size_t(capacity);
+      size_t alignment = (bytes >= HugePageSize) ? HugePageSize : 64;
+      void* block = 0;
+      if (posix_memalign(&block, alignment, bytes) != 0) {
+         UTIL_THROW("Failed to allocate aligned memory");
+      }
+      advise(block, bytes);
+
+      // First touch: Zero each element on the thread of a static loop
+      char* bytePtr = static_cast<char*>(block);
+      int i;
+      #ifdef DDMD_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (i = 0; i < capacity; ++i) {
+         std::memset(bytePtr + size*size_t(i), 0, size);
+      }
+      return block;
+   }
+   #endif
+
+   /*
+   * Request huge page backing of the huge page aligned part of a block.
+   */
+   void PageAllocator::advise(void* ptr, size_t bytes)
+   {
+      #if defined(DDMD_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+      uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+      uintptr_t end = begin + bytes;
+      begin = (begin + HugePageSize - 1) & ~uintptr_t(HugePageSize - 1);
+      end = end & ~uintptr_t(HugePageSize - 1);
+      if (end > begin) {
+         // Failure only means that huge pages are not available
+         madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+      }
+      #endif
+   }
+
+   /*
+   * Bytes currently allocated by allocate().
+   */
+   double PageAllocator::total()
+   {
+      #ifdef DDMD_HUGE_PAGES
+      return total_;
+      #else
+      return 0.0;
+      #endif
+   }
+
+   /*
+   * Maximum bytes allocated by allocate().
+   */
+   double PageAllocator::max()
+   {
+      #ifdef DDMD_HUGE_PAGES
+      return max_;
+      #else
+      return 0.0;
+      #endif
+   }
+
+}
@@ -0,0 +1,159 @@
+#ifndef DDMD_PAGE_ALLOCATOR_H
+#define DDMD_PAGE_ALLOCATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/misc/Memory.h>
+#include <util/global.h>
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#ifdef DDMD_HUGE_PAGES
+#include <stdlib.h>
+#endif
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Allocator for large per-processor arrays.
+   *
+   * If compiled with DDMD_HUGE_PAGES defined, allocate() aligns arrays
+   * of at least one huge page (2 MB) to a huge page boundary, asks the
+   * kernel to back them with transparent huge pages (madvise with
+   * MADV_HUGEPAGE, on Linux), and then zeroes and constructs elements
+   * in a static OpenMP loop (if compiled with DDMD_OPENMP), so that each
+   * page is first touched, and thus placed on the NUMA node, of the
+   * thread that owns the corresponding block of a static loop over the
+   * array. Such arrays are not counted by Util::Memory, but by total().
+   *
+   * Otherwise, allocate() and deallocate() simply call the functions of
+   * Util::Memory, advise() does nothing, and total() is zero.
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   class PageAllocator
+   {
+
+   public:
+
+      /**
+      * Allocate and construct a C array.
+      *
+      * \param ptr      pointer to array (set on output)
+      * \param capacity number of elements
+      */
+      template <typename T>
+      static void allocate(T*& ptr, int capacity);
+
+      /**
+      * Destroy and free a C array allocated by allocate().
+      *
+      * \param ptr      pointer to array (set to null on output)
+      * \param capacity number of elements
+      */
+      template <typename T>
+      static void deallocate(T*& ptr, int capacity);
+
+      /**
+      * Request huge page backing of an existing block of memory.
+      *
+      * Applies to the largest huge page aligned part of the block, if
+      * any. Pages that were already touched may later be merged by the
+      * kernel. Does nothing unless compiled with DDMD_HUGE_PAGES.
+      *
+      * \param ptr   address of first byte of block
+      * \param bytes number of bytes
+      */
+      static void advise(void* ptr, size_t bytes);
+
+      /**
+      * Bytes currently allocated by allocate(), not counted by Memory.
+      */
+      static double total();
+
+      /**
+      * Maximum of total() since the beginning of the program.
+      */
+      static double max();
+
+      /**
+      * Size of a huge page, in bytes.
+      */
+      static const size_t HugePageSize = 2097152;
+
+   private:
+
+      #ifdef DDMD_HUGE_PAGES
+      /// Bytes allocated by allocate().
+      static double total_;
+
+      /// Maximum value of total_.
+      static double max_;
+
+      /// Allocate aligned memory, advise, and zero in a static loop.
+      static void* allocateBlock(size_t size, int capacity);
+      #endif
+
+   };
+
+   // Template function definitions
+
+   /*
+   * Allocate and construct a C array.
+   */
+   template <typename T>
+   void PageAllocator::allocate(T*& ptr, int capacity)
+   {
+      #ifdef DDMD_HUGE_PAGES
+      if (ptr) {
+         UTIL_THROW("Attempt to allocate to non-null pointer");
+      }
+      void* block = allocateBlock(sizeof(T), capacity);
+      ptr = static_cast<T*>(block);
+      int i;
+      #ifdef DDMD_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (i = 0; i < capacity; ++i) {
+         new (ptr + i) T;
+      }
+      total_ += double(capacity)*double(sizeof(T));
+      if (total_ > max_) max_ = total_;
+      #else
+      Memory::allocate<T>(ptr, capacity);
+      #endif
+   }
+
+   /*
+   * Destroy and free a C array.
+   */
+   template <typename T>
+   void PageAllocator::deallocate(T*& ptr, int capacity)
+   {
+      #ifdef DDMD_HUGE_PAGES
+      if (!ptr) {
+         UTIL_THROW("Attempt to deallocate a null pointer");
+      }
+      for (int i = 0; i < capacity; ++i) {
+         ptr[i].~T();
+      }
+      free(ptr);
+      ptr = 0;
+      total_ -= double(capacity)*double(sizeof(T));
+      #else
+      Memory::deallocate<T>(ptr, capacity);
+      #endif
+   }
+
+}
+#endif
@@ -0,0 +1,122 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "PerfCounters.h"
+
+#ifdef DDMD_PERF_COUNTERS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace DdMd
+{
+
+   #ifdef DDMD_PERF_COUNTERS
+   /*
+   * Open one counter for this process, on any cpu (file scope).
+   */
+   static int openCounter(unsigned long long config, int groupFd)
+   {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.disabled = (groupFd == -1) ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+   }
+   #endif
+
+   /*
+   * Constructor.
+   */
+   PerfCounters::PerfCounters()
+    : isActive_(false)
+   {
+      for (int i = 0; i < NCounter; ++i) {
+         fd_[i] = -1;
+      }
+   }
+
+   /*
+   * Destructor.
+   */
+   PerfCounters::~PerfCounters()
+   {  close(); }
+
+   /*
+   * Open and enable a group of counters.
+   */
+   bool PerfCounters::open()
+   {
+      #ifdef DDMD_PERF_COUNTERS
+      if (isActive_) {
+         return true;
+      }
+      const unsigned long long configs[NCounter] = 
+            {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+             PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+      for (int i = 0; i < NCounter; ++i) {
+         fd_[i] = openCounter(configs[i], i == 0 ? -1 : fd_[0]);
+         if (fd_[i] < 0) {
+            close();
+            return false;
+         }
+      }
+      ioctl(fd_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fd_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      isActive_ = true;
+      #endif
+      return isActive_;
+   }
+
+   /*
+   * Read all counters of the group.
+   */
+   void PerfCounters::read(double* values)
+   {
+      int i;
+      #ifdef DDMD_PERF_COUNTERS
+      if (isActive_) {
+         // Group read format: number of counters, then values
+         unsigned long long buffer[NCounter + 1];
+         if (::read(fd_[0], buffer, sizeof(buffer)) == sizeof(buffer)) {
+            for (i = 0; i < NCounter; ++i) {
+               values[i] = double(buffer[i+1]);
+            }
+            return;
+         }
+      }
+      #endif
+      for (i = 0; i < NCounter; ++i) {
+         values[i] = 0.0;
+      }
+   }
+
+   /*
+   * Close all open counters (private).
+   */
+   void PerfCounters::close()
+   {
+      #ifdef DDMD_PERF_COUNTERS
+      for (int i = NCounter - 1; i >= 0; --i) {
+         if (fd_[i] >= 0) {
+            ::close(fd_[i]);
+            fd_[i] = -1;
+         }
+      }
+      #endif
+      isActive_ = false;
+   }
+
+}
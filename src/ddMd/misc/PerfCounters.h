@@ -0,0 +1,85 @@
+#ifndef DDMD_PERF_COUNTERS_H
+#define DDMD_PERF_COUNTERS_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+namespace DdMd 
+{
+
+   /**
+   * A group of hardware performance counters for this process.
+   *
+   * If compiled with DDMD_PERF_COUNTERS defined, open() creates a group
+   * of Linux perf_event counters for CPU cycles, retired instructions,
+   * last level cache references and last level cache misses, which are
+   * then read together by read(). Otherwise, or if the kernel does not
+   * allow the counters to be opened, isActive() is false and read()
+   * returns zero counts.
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   class PerfCounters 
+   {
+   
+   public:
+
+      /// Indices of counters.
+      enum CounterId {Cycles, Instructions, CacheReferences, CacheMisses, 
+                      NCounter};
+   
+      /**
+      * Constructor.
+      */
+      PerfCounters();
+
+      /**
+      * Destructor, closes counters.
+      */
+      ~PerfCounters();
+
+      /**
+      * Open and start the counters.
+      *
+      * \return true if all counters were opened, false otherwise
+      */
+      bool open();
+
+      /**
+      * Read current values of all counters.
+      *
+      * \param values array of NCounter values (output)
+      */
+      void read(double* values);
+
+      /**
+      * Are counters open?
+      */
+      bool isActive() const;
+
+   private:
+
+      /// File descriptors of counters (group leader first).
+      int fd_[NCounter];
+
+      /// Are counters open?
+      bool isActive_;
+
+      /// Close any open counters.
+      void close();
+
+      // Copying is not allowed.
+      PerfCounters(const PerfCounters& other);
+      PerfCounters& operator = (const PerfCounters& other);
+
+   };
+
+   inline bool PerfCounters::isActive() const
+   {  return isActive_; }
+
+}
+#endif
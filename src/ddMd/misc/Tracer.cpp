@@ -0,0 +1,158 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Tracer.h"
+
+#include <sstream>
+#include <iomanip>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   // Static member variables.
+   std::vector<Tracer::Event> Tracer::events_;
+   std::vector<std::string> Tracer::names_;
+   std::map<std::string, int> Tracer::ids_;
+   double Tracer::origin_ = 0.0;
+   long Tracer::beginStep_ = 0;
+   long Tracer::endStep_ = 0;
+   long Tracer::step_ = 0;
+   int Tracer::capacity_ = 0;
+   int Tracer::next_ = 0;
+   bool Tracer::isFull_ = false;
+   bool Tracer::isActive_ = false;
+
+   /*
+   * Get id for a name, adding the name if necessary.
+   */
+   int Tracer::nameId(const std::string& name)
+   {
+      std::map<std::string, int>::iterator iter = ids_.find(name);
+      if (iter != ids_.end()) {
+         return iter->second;
+      }
+      int id = names_.size();
+      names_.push_back(name);
+      ids_[name] = id;
+      return id;
+   }
+
+   /*
+   * Set window of traced steps, allocate buffer and set time origin.
+   */
+   void Tracer::setWindow(long iBegin, long iEnd, int capacity,
+                          MPI::Intracomm& communicator)
+   {
+      if (iEnd < iBegin) {
+         UTIL_THROW("Trace window end precedes beginning");
+      }
+      if (capacity <= 0) {
+         UTIL_THROW("Trace capacity must be positive");
+      }
+      events_.resize(capacity);
+      capacity_ = capacity;
+      next_ = 0;
+      isFull_ = false;
+      isActive_ = false;
+      beginStep_ = iBegin;
+      endStep_ = iEnd;
+      communicator.Barrier();
+      origin_ = MPI_Wtime();
+   }
+
+   /*
+   * Set current step, enable recording within the window.
+   */
+   void Tracer::setStep(long iStep)
+   {
+      step_ = iStep;
+      isActive_ = (capacity_ > 0 && iStep >= beginStep_ && iStep < endStep_);
+   }
+
+   /*
+   * Disable recording.
+   */
+   void Tracer::stop()
+   {  isActive_ = false; }
+
+   /*
+   * Number of stored events.
+   */
+   int Tracer::nEvent()
+   {  return isFull_ ? capacity_ : next_; }
+
+   /*
+   * Discard events, disable tracing.
+   */
+   void Tracer::clear()
+   {
+      events_.clear();
+      capacity_ = 0;
+      next_ = 0;
+      isFull_ = false;
+      isActive_ = false;
+   }
+
+   /*
+   * Gather events to master and write them in trace event JSON format.
+   */
+   void Tracer::write(std::ostream& out, MPI::Intracomm& communicator)
+   {
+      isActive_ = false;
+      int rank = communicator.Get_rank();
+      int nProc = communicator.Get_size();
+
+      // Format local events, oldest first. Names are written on each
+      // processor, since ids of names added lazily may differ.
+      std::ostringstream local;
+      local << std::fixed << std::setprecision(3);
+      int n = nEvent();
+      int first = isFull_ ? next_ : 0;
+      for (int i = 0; i < n; ++i) {
+         const Event& event = events_[(first + i) % capacity_];
+         local << ",\n{\"name\":\"" << names_[event.id] << "\""
+               << ",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":0"
+               << ",\"ts\":" << 1.0E6*(event.begin - origin_)
+               << ",\"dur\":" << 1.0E6*(event.end - event.begin)
+               << ",\"args\":{\"step\":" << event.step << "}}";
+      }
+      std::string text = local.str();
+      int size = text.size();
+
+      // Gather to master.
+      std::vector<int> sizes(nProc, 0);
+      communicator.Gather(&size, 1, MPI::INT, &sizes[0], 1, MPI::INT, 0);
+      std::vector<int> offsets(nProc, 0);
+      int total = 0;
+      if (rank == 0) {
+         for (int i = 0; i < nProc; ++i) {
+            offsets[i] = total;
+            total += sizes[i];
+         }
+      }
+      std::vector<char> all(total + 1);
+      communicator.Gatherv(text.data(), size, MPI::CHAR, &all[0], 
+                           &sizes[0], &offsets[0], MPI::CHAR, 0);
+
+      if (rank == 0) {
+         out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+         for (int i = 0; i < nProc; ++i) {
+            if (i > 0) out << ",\n";
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << i 
+                << ",\"args\":{\"name\":\"rank " << i << "\"}}";
+         }
+         out.write(&all[0], total);
+         out << "\n]}" << std::endl;
+      }
+
+      next_ = 0;
+      isFull_ = false;
+   }
+
+}
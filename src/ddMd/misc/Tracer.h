@@ -0,0 +1,180 @@
+#ifndef DDMD_TRACER_H
+#define DDMD_TRACER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+namespace DdMd 
+{
+
+   using namespace Util;
+
+   /**
+   * Recorder of a timeline of named intervals on each processor.
+   *
+   * Tracer is a static class that records the begin and end times of 
+   * named intervals (integrator phases, communication, analyzers) in a
+   * fixed capacity ring buffer on each processor, for steps within a 
+   * window set by setWindow(). Nothing is recorded outside the window, 
+   * so record() costs a single test of a flag when tracing is off. 
+   *
+   * The write() function gathers the events of all processors to the 
+   * master and writes them in the JSON trace event format used by the 
+   * Chrome browser trace viewer and by Perfetto, with one "process" per 
+   * MPI rank, so that phases of different ranks in the same step may be 
+   * compared directly. Times are relative to a common origin set after 
+   * a barrier in setWindow().
+   *
+   * \ingroup DdMd_Misc_Module
+   */
+   class Tracer 
+   {
+   
+   public:
+
+      /**
+      * Get integer id for an interval name, adding it if necessary.
+      *
+      * \param name name of a kind of interval
+      */
+      static int nameId(const std::string& name);
+
+      /**
+      * Enable recording of steps iBegin <= iStep < iEnd.
+      *
+      * Clears any existing events and sets the time origin. Call on all
+      * processors of the communicator.
+      *
+      * \param iBegin first traced step
+      * \param iEnd   end of traced steps (one past the last)
+      * \param capacity maximum number of events kept on each processor
+      * \param communicator  communicator for all processors
+      */ 
+      static void setWindow(long iBegin, long iEnd, int capacity,
+                            MPI::Intracomm& communicator);
+
+      /**
+      * Set the current step, and enable recording if within the window.
+      *
+      * \param iStep current step index
+      */
+      static void setStep(long iStep);
+
+      /**
+      * Disable recording until the next call to setStep().
+      */
+      static void stop();
+
+      /**
+      * Record an interval, if recording is enabled.
+      *
+      * \param id  name id returned by nameId()
+      * \param begin  MPI_Wtime() at beginning of interval
+      * \param end  MPI_Wtime() at end of interval
+      */
+      static void record(int id, double begin, double end);
+
+      /**
+      * Is recording enabled now?
+      */
+      static bool isActive();
+
+      /**
+      * Gather events to the master and write them as a JSON trace.
+      *
+      * Call on all processors. The stream is used only on the master 
+      * (rank 0). Events are cleared after writing.
+      *
+      * \param out  output stream (used only on master)
+      * \param communicator  communicator for all processors
+      */
+      static void write(std::ostream& out, MPI::Intracomm& communicator);
+
+      /**
+      * Discard all events and disable tracing.
+      */
+      static void clear();
+
+      /**
+      * Number of events stored on this processor.
+      */
+      static int nEvent();
+
+   private:
+
+      /// A timed interval.
+      struct Event {
+         double begin;
+         double end;
+         long   step;
+         int    id; 
+      };
+
+      /// Ring buffer of events.
+      static std::vector<Event> events_;
+
+      /// Names of intervals, indexed by id.
+      static std::vector<std::string> names_;
+
+      /// Map from name to id.
+      static std::map<std::string, int> ids_;
+
+      /// Time origin (MPI_Wtime() after barrier in setWindow).
+      static double origin_;
+
+      /// First traced step.
+      static long beginStep_;
+
+      /// End of traced steps (one past last).
+      static long endStep_;
+
+      /// Current step.
+      static long step_;
+
+      /// Maximum number of stored events.
+      static int capacity_;
+
+      /// Index of slot for next event in events_.
+      static int next_;
+
+      /// Has the ring buffer overflowed?
+      static bool isFull_;
+
+      /// Is recording enabled now?
+      static bool isActive_;
+
+   };
+
+   // Inline functions
+
+   inline bool Tracer::isActive()
+   {  return isActive_; }
+
+   inline void Tracer::record(int id, double begin, double end)
+   {
+      if (!isActive_) return;
+      Event& event = events_[next_];
+      event.begin = begin;
+      event.end = end;
+      event.step = step_;
+      event.id = id;
+      ++next_;
+      if (next_ == capacity_) {
+         next_ = 0;
+         isFull_ = true;
+      }
+   }
+
+}
+#endif
@@ -1,5 +1,10 @@
 ddMd_misc_=\
+   ddMd/misc/AsyncFileBuf.cpp \
    ddMd/misc/DdTimer.cpp \
+   ddMd/misc/MemoryReport.cpp \
+   ddMd/misc/PageAllocator.cpp \
+   ddMd/misc/PerfCounters.cpp \
+   ddMd/misc/Tracer.cpp \
    ddMd/misc/initStatic.cpp
 
 ddMd_misc_SRCS=\
@@ -33,7 +33,8 @@ namespace DdMd
       endOfStepModifiers_(),
       exchangeModifiers_(),
       updateModifiers_(),
-      reverseUpdateModifiers_()
+      reverseUpdateModifiers_(),
+      flags_(0)
    { setClassName("ModifierManager"); }
 
    /*
@@ -56,7 +57,8 @@ namespace DdMd
       endOfStepModifiers_(),
       exchangeModifiers_(),
       updateModifiers_(),
-      reverseUpdateModifiers_()
+      reverseUpdateModifiers_(),
+      flags_(0)
    {  setClassName("ModifierManager"); }
 
    /*
@@ -73,10 +75,44 @@ namespace DdMd
    void ModifierManager::readParameters(std::istream &in)
    {
       Manager<Modifier>::readParameters(in);
+      makeActionLists();
+   }
+
+   /*
+   * Load parameters from an archive.
+   */
+   void ModifierManager::loadParameters(Serializable::IArchive &ar)
+   {
+      Manager<Modifier>::loadParameters(ar);
+      makeActionLists();
+   }
+
+   /*
+   * Build arrays of modifiers for specific actions (private).
+   */
+   void ModifierManager::makeActionLists()
+   {
+      setupModifiers_.clear();
+      preIntegrate1Modifiers_.clear();
+      postIntegrate1Modifiers_.clear();
+      preTransformModifiers_.clear();
+      preExchangeModifiers_.clear();
+      postExchangeModifiers_.clear();
+      postNeighborModifiers_.clear();
+      preUpdateModifiers_.clear();
+      postUpdateModifiers_.clear();
+      preForceModifiers_.clear();
+      postForceModifiers_.clear();
+      endOfStepModifiers_.clear();
+      exchangeModifiers_.clear();
+      updateModifiers_.clear();
+      reverseUpdateModifiers_.clear();
+      flags_ = 0;
 
       Modifier* ptr;
       for  (int i = 0; i < size(); ++i) {
          ptr = &(*this)[i];
+         flags_ |= ptr->flags();
          if (ptr->isSet(Modifier::Flags::Setup)) { 
             setupModifiers_.append(*ptr); 
          }
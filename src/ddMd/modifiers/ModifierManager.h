@@ -26,6 +26,12 @@ namespace DdMd
    * provides methods to execute specified actions at various 
    * points before and during the main integration loop. 
    *
+   * After reading or loading parameters, the manager builds a separate
+   * list of modifiers for each action, and records the union of the
+   * flags of all modifiers. An integrator may call hasAction() to skip
+   * an action (and the associated timer stamp) for which no modifier
+   * is registered.
+   *
    * \ingroup DdMd_Manager_Module
    * \ingroup DdMd_Modifier_Module
    */
@@ -56,6 +62,13 @@ namespace DdMd
       */
       void readParameters(std::istream &in);
 
+      /**
+      * Load parameters from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
       /**
       * Return pointer to a new default factory.
       *
@@ -63,6 +76,14 @@ namespace DdMd
       */
       Factory<Modifier>* newDefaultFactory() const;
 
+      /**
+      * Is any modifier registered for a specified action?
+      *
+      * \param flag Bit flag for the action, e.g., Modifier::Flags::PostForce
+      */
+      bool hasAction(Bit flag) const
+      {  return flag.isSet(flags_); }
+
       /// \name Integrator actions 
       //@{ 
    
@@ -188,6 +209,14 @@ namespace DdMd
       GPArray<Modifier> updateModifiers_;
       GPArray<Modifier> reverseUpdateModifiers_;
 
+      /// Union of the flags of all modifiers.
+      unsigned int flags_;
+
+      /**
+      * Build the arrays of modifiers for specific actions, and flags_.
+      */
+      void makeActionLists();
+
    };
 
 }
@@ -0,0 +1,130 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "PairPerturbation.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <util/ensembles/EnergyEnsemble.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   PairPerturbation::PairPerturbation(Simulation& simulation)
+    : Perturbation(simulation, 1),
+      parameterName_(),
+      typeId1_(-1),
+      typeId2_(-1)
+   {  setClassName("PairPerturbation"); }
+
+   /*
+   * Destructor.
+   */
+   PairPerturbation::~PairPerturbation()
+   {}
+
+   /*
+   * Read pair parameter name and type ids, then parameters of states.
+   */
+   void PairPerturbation::readParameters(std::istream& in)
+   {
+      read<std::string>(in, "parameterName", parameterName_);
+      read<int>(in, "typeId1", typeId1_);
+      read<int>(in, "typeId2", typeId2_);
+      int nAtomType = simulation().nAtomType();
+      if (typeId1_ < 0 || typeId1_ >= nAtomType) {
+         UTIL_THROW("Invalid typeId1");
+      }
+      if (typeId2_ < 0 || typeId2_ >= nAtomType) {
+         UTIL_THROW("Invalid typeId2");
+      }
+      Perturbation::readParameters(in);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void PairPerturbation::loadParameters(Serializable::IArchive& ar)
+   {
+      loadParameter<std::string>(ar, "parameterName", parameterName_);
+      loadParameter<int>(ar, "typeId1", typeId1_);
+      loadParameter<int>(ar, "typeId2", typeId2_);
+      Perturbation::loadParameters(ar);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void PairPerturbation::save(Serializable::OArchive& ar)
+   {
+      ar << parameterName_;
+      ar << typeId1_;
+      ar << typeId2_;
+      Perturbation::save(ar);
+   }
+
+   /*
+   * Set the pair parameter of the current state.
+   */
+   void PairPerturbation::setParameters()
+   {
+      simulation().pairPotential().set(parameterName_, typeId1_, typeId2_,
+                                       parameter(0, stateId()));
+      simulation().modifySignal().notify();
+   }
+
+   /*
+   * Change the pair parameter, and recompute forces on local atoms.
+   */
+   void PairPerturbation::adoptState(int stateId)
+   {
+      setState(stateId);
+      simulation().computeForces();
+   }
+
+   /*
+   * Return (U' - U)/T (valid on master).
+   *
+   * The pair energy is computed with both parameter values, and the
+   * value of the current state is then restored.
+   */
+   double PairPerturbation::difference(int stateId)
+   {
+      double energy = pairEnergy();
+      simulation().pairPotential().set(parameterName_, typeId1_, typeId2_,
+                                       parameter(0, stateId));
+      double partnerEnergy = pairEnergy();
+      setParameters();
+      double temperature = simulation().energyEnsemble().temperature();
+      return (partnerEnergy - energy)/temperature;
+   }
+
+   /*
+   * Compute total pair energy (valid on master).
+   */
+   double PairPerturbation::pairEnergy()
+   {
+      PairPotential& pairPotential = simulation().pairPotential();
+      pairPotential.unsetEnergy();
+      #ifdef UTIL_MPI
+      pairPotential.computeEnergy(simulation().domain().communicator());
+      #else
+      pairPotential.computeEnergy();
+      #endif
+      double energy = 0.0;
+      if (simulation().domain().isMaster()) {
+         energy = pairPotential.energy();
+      }
+      pairPotential.unsetEnergy();
+      return energy;
+   }
+
+}
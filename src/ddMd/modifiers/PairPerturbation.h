@@ -0,0 +1,113 @@
+#ifndef DDMD_PAIR_PERTURBATION_H
+#define DDMD_PAIR_PERTURBATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Perturbation.h"  // base class
+
+#include <string>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Perturbation of one pair interaction parameter.
+   *
+   * Each state has one parameter, which is the value of the pair
+   * potential parameter named parameterName (e.g., "epsilon") for the
+   * interaction between atoms of types typeId1 and typeId2. This is set
+   * with PairPotential::set(name, typeId1, typeId2, value), and is
+   * used for Hamiltonian replica exchange at a common temperature T.
+   * The difference W(X,p') - W(X,p) is (U' - U)/T, where U and U' are
+   * the pair energies computed with the current and new values. The
+   * parameter may not change the pair potential cutoff. Forces are
+   * recomputed after an exchange.
+   *
+   * \ingroup DdMd_Modifier_Module
+   */
+   class PairPerturbation : public Perturbation
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation
+      */
+      PairPerturbation(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~PairPerturbation();
+
+      /**
+      * Read parameterName, typeId1, typeId2 and parameters of states.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /**
+      * Change the pair parameter, and recompute forces.
+      *
+      * \param stateId index of new state
+      */
+      virtual void adoptState(int stateId);
+
+      /**
+      * Compute (U' - U)/T for the current configuration.
+      *
+      * \param stateId index of state with parameter value p'
+      */
+      virtual double difference(int stateId);
+
+   protected:
+
+      /**
+      * Set the pair parameter of the current state.
+      */
+      virtual void setParameters();
+
+   private:
+
+      /// Name of the pair potential parameter.
+      std::string parameterName_;
+
+      /// Type of first atom in pair.
+      int typeId1_;
+
+      /// Type of second atom in pair.
+      int typeId2_;
+
+      /**
+      * Compute the total pair energy (valid on master).
+      */
+      double pairEnergy();
+
+   };
+
+}
+#endif
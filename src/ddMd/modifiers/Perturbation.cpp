@@ -0,0 +1,89 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Perturbation.h"
+#include <ddMd/simulation/Simulation.h>
+#include <util/mpi/MpiLoader.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   Perturbation::Perturbation(Simulation& simulation, int nParameter)
+    : ParamComposite(),
+      parameters_(),
+      simulationPtr_(&simulation),
+      nState_(simulation.nSystem()),
+      nParameter_(nParameter),
+      stateId_(simulation.systemId())
+   {  setClassName("Perturbation"); }
+
+   /*
+   * Destructor.
+   */
+   Perturbation::~Perturbation()
+   {}
+
+   /*
+   * Read parameters of all states, and set the initial state.
+   */
+   void Perturbation::readParameters(std::istream& in)
+   {
+      parameters_.allocate(nState_, nParameter_);
+      readDMatrix<double>(in, "parameters", parameters_, nState_, 
+                          nParameter_);
+      setState(stateId_);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void Perturbation::loadParameters(Serializable::IArchive& ar)
+   {
+      parameters_.allocate(nState_, nParameter_);
+      loadDMatrix<double>(ar, "parameters", parameters_, nState_, 
+                          nParameter_);
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(stateId_);
+      if (stateId_ < 0 || stateId_ >= nState_) {
+         UTIL_THROW("Invalid stateId");
+      }
+      setState(stateId_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void Perturbation::save(Serializable::OArchive& ar)
+   {
+      ar << parameters_;
+      ar << stateId_;
+   }
+
+   /*
+   * Set current state, and modify the system.
+   */
+   void Perturbation::setState(int stateId)
+   {
+      if (stateId < 0 || stateId >= nState_) {
+         UTIL_THROW("Invalid stateId");
+      }
+      stateId_ = stateId;
+      setParameters();
+   }
+
+   /*
+   * Change state in a replica exchange (default implementation).
+   */
+   void Perturbation::adoptState(int stateId)
+   {  setState(stateId); }
+
+}
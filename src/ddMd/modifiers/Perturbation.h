@@ -0,0 +1,186 @@
+#ifndef DDMD_PERTURBATION_H
+#define DDMD_PERTURBATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>  // base class
+#include <util/containers/DMatrix.h>    // member
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Parameter dependence of the statistical weight, for replica exchange.
+   *
+   * A Perturbation defines a set of nState() thermodynamic states of a
+   * system, each given by a set of nParameter() parameter values, in
+   * which the probability of a microstate X is proportional to
+   * exp(-W(X,p)), where W(X,p) = H/kT may depend on the parameters
+   * p through either the temperature or the Hamiltonian H. This is the
+   * DdMd analog of McMd::Perturbation. The number of states is equal to
+   * the number of systems (see Simulation::nSystem()), and each system
+   * is initially in the state with index equal to its systemId.
+   *
+   * Subclasses must implement setParameters(), which modifies the parent
+   * Simulation to correspond to the parameters of the current state, and
+   * difference(), which computes the change in W(X,p) produced by a
+   * change of state for the current configuration. Subclasses may also
+   * re-implement adoptState(), which is used to change state during a
+   * replica exchange, if other variables must be adjusted.
+   *
+   * \ingroup DdMd_Modifier_Module
+   */
+   class Perturbation : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation
+      * \param nParameter number of parameters per state
+      */
+      Perturbation(Simulation& simulation, int nParameter);
+
+      /**
+      * Destructor.
+      */
+      virtual ~Perturbation();
+
+      /**
+      * Read parameters of all states, and set initial state.
+      *
+      * Reads a matrix "parameters" with nState() rows and nParameter()
+      * columns, in which row i contains the parameters of state i.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive, and set current state.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /**
+      * Set the current state, and modify the system parameters.
+      *
+      * Call on all processors of this system.
+      *
+      * \param stateId index of new state
+      */
+      void setState(int stateId);
+
+      /**
+      * Change state as a result of a replica exchange.
+      *
+      * Call on all processors of this system. The default implementation
+      * calls setState(stateId).
+      *
+      * \param stateId index of new state
+      */
+      virtual void adoptState(int stateId);
+
+      /**
+      * Compute W(X, p') - W(X, p) for the current configuration X.
+      *
+      * Here, p are the parameters of the current state and p' those of
+      * state stateId. Call on all processors of this system. The return
+      * value is only correct on the master processor.
+      *
+      * \param stateId index of the other state
+      */
+      virtual double difference(int stateId) = 0;
+
+      /**
+      * Get the number of states.
+      */
+      int nState() const;
+
+      /**
+      * Get the number of parameters per state.
+      */
+      int nParameter() const;
+
+      /**
+      * Get the index of the current state.
+      */
+      int stateId() const;
+
+      /**
+      * Get a parameter of a state.
+      *
+      * \param i   parameter index, 0 <= i < nParameter()
+      * \param stateId  state index, 0 <= stateId < nState()
+      */
+      double parameter(int i, int stateId) const;
+
+   protected:
+
+      /**
+      * Modify the system to correspond to the current state.
+      */
+      virtual void setParameters() = 0;
+
+      /**
+      * Get the parent Simulation by reference.
+      */
+      Simulation& simulation();
+
+   private:
+
+      /// Parameters of all states (nState x nParameter).
+      DMatrix<double> parameters_;
+
+      /// Pointer to parent Simulation.
+      Simulation* simulationPtr_;
+
+      /// Number of states.
+      int nState_;
+
+      /// Number of parameters per state.
+      int nParameter_;
+
+      /// Index of current state.
+      int stateId_;
+
+   };
+
+   // Inline member functions
+
+   inline int Perturbation::nState() const
+   {  return nState_; }
+
+   inline int Perturbation::nParameter() const
+   {  return nParameter_; }
+
+   inline int Perturbation::stateId() const
+   {  return stateId_; }
+
+   inline double Perturbation::parameter(int i, int stateId) const
+   {  return parameters_(stateId, i); }
+
+   inline Simulation& Perturbation::simulation()
+   {  return *simulationPtr_; }
+
+}
+#endif
@@ -0,0 +1,229 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ReplicaExchange.h"
+#include "Perturbation.h"
+#include "TemperaturePerturbation.h"
+#include "PairPerturbation.h"
+#include <ddMd/simulation/Simulation.h>
+#include <util/param/Factory.h>
+#include <util/mpi/MpiLoader.h>
+#include <util/containers/DArray.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   namespace {
+
+      /*
+      * Factory for subclasses of Perturbation.
+      */
+      class PerturbationFactory : public Factory<Perturbation>
+      {
+      public:
+
+         PerturbationFactory(Simulation& simulation)
+          : simulationPtr_(&simulation)
+         {}
+
+         Perturbation* factory(const std::string &className) const
+         {
+            Perturbation* ptr = 0;
+            if (className == "TemperaturePerturbation") {
+               ptr = new TemperaturePerturbation(*simulationPtr_);
+            } else
+            if (className == "PairPerturbation") {
+               ptr = new PairPerturbation(*simulationPtr_);
+            }
+            return ptr;
+         }
+
+      private:
+
+         Simulation* simulationPtr_;
+
+      };
+
+   }
+
+   /*
+   * Constructor.
+   */
+   ReplicaExchange::ReplicaExchange(Simulation& simulation)
+    : Modifier(simulation),
+      outputFile_(),
+      perturbationPtr_(0),
+      nAttempt_(0)
+   {
+      setClassName("ReplicaExchange");
+      set(Flags::Setup);
+      set(Flags::EndOfStep);
+   }
+
+   /*
+   * Destructor.
+   */
+   ReplicaExchange::~ReplicaExchange()
+   {
+      if (perturbationPtr_) {
+         delete perturbationPtr_;
+      }
+      if (outputFile_.is_open()) {
+         outputFile_.close();
+      }
+   }
+
+   /*
+   * Read interval and Perturbation.
+   */
+   void ReplicaExchange::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      PerturbationFactory factory(simulation());
+      std::string className;
+      bool isEnd;
+      perturbationPtr_ = factory.readObject(in, *this, className, isEnd);
+      checkPerturbation(className);
+      nAttempt_ = 0;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void ReplicaExchange::loadParameters(Serializable::IArchive& ar)
+   {
+      loadInterval(ar);
+      PerturbationFactory factory(simulation());
+      std::string className;
+      perturbationPtr_ = factory.loadObject(ar, *this, className);
+      checkPerturbation(className);
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      loader.load(nAttempt_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void ReplicaExchange::save(Serializable::OArchive& ar)
+   {
+      saveInterval(ar);
+      std::string name = perturbationPtr_->className();
+      ar << name;
+      perturbationPtr_->save(ar);
+      ar << nAttempt_;
+   }
+
+   /*
+   * Check that the Perturbation was created, and that there are systems.
+   */
+   void ReplicaExchange::checkPerturbation(const std::string& className)
+   {
+      if (!perturbationPtr_) {
+         std::string msg("Unknown Perturbation subclass name: ");
+         msg += className;
+         UTIL_THROW(msg.c_str());
+      }
+      if (simulation().nSystem() < 2) {
+         UTIL_THROW("ReplicaExchange requires more than one system");
+      }
+   }
+
+   /*
+   * Open output file on master of each system.
+   */
+   void ReplicaExchange::setup()
+   {
+      if (simulation().domain().isMaster() && !outputFile_.is_open()) {
+         simulation().fileMaster().openOutputFile("repx", outputFile_);
+      }
+   }
+
+   /*
+   * Attempt exchanges between replicas with adjacent states.
+   */
+   void ReplicaExchange::endOfStep(long iStep)
+   {
+      Simulation& sim = simulation();
+      int nState = perturbationPtr_->nState();
+      int stateId = perturbationPtr_->stateId();
+      int parity = nAttempt_ % 2;
+
+      // Find partner state, and compute change of weight on all processors
+      int partnerId;
+      if ((stateId - parity) % 2 == 0) {
+         partnerId = stateId + 1;
+      } else {
+         partnerId = stateId - 1;
+      }
+      double difference = 0.0;
+      if (partnerId >= 0 && partnerId < nState) {
+         difference = perturbationPtr_->difference(partnerId);
+      }
+
+      // On masters of all systems, choose new states
+      int newStateId = stateId;
+      if (sim.domain().isMaster()) {
+         #ifdef UTIL_MPI
+         MPI::Intracomm& communicator = sim.replicaCommunicator();
+         bool isRoot = (communicator.Get_rank() == 0);
+         double values[2];
+         values[0] = double(stateId);
+         values[1] = difference;
+         DArray<double> allValues;
+         DArray<int> newStateIds;
+         newStateIds.allocate(nState);
+         if (isRoot) {
+            allValues.allocate(2*nState);
+         }
+         communicator.Gather(values, 2, MPI::DOUBLE,
+                             isRoot ? &allValues[0] : 0, 2, MPI::DOUBLE, 0);
+
+         // On master of system 0, apply Metropolis criterion to each pair
+         if (isRoot) {
+            DArray<int> systemIds;
+            systemIds.allocate(nState);
+            int i, s, a, b;
+            for (i = 0; i < nState; ++i) {
+               s = int(allValues[2*i] + 0.5);
+               systemIds[s] = i;
+               newStateIds[i] = s;
+            }
+            double delta;
+            for (s = parity; s + 1 < nState; s += 2) {
+               a = systemIds[s];
+               b = systemIds[s+1];
+               delta = allValues[2*a + 1] + allValues[2*b + 1];
+               if (delta <= 0.0 || sim.random().metropolis(exp(-delta))) {
+                  newStateIds[a] = s + 1;
+                  newStateIds[b] = s;
+               }
+            }
+         }
+         communicator.Bcast(&newStateIds[0], nState, MPI::INT, 0);
+         newStateId = newStateIds[sim.systemId()];
+         #endif
+      }
+
+      // Adopt new state on all processors of this system
+      #ifdef UTIL_MPI
+      sim.domain().communicator().Bcast(&newStateId, 1, MPI::INT, 0);
+      #endif
+      if (newStateId != stateId) {
+         perturbationPtr_->adoptState(newStateId);
+      }
+      ++nAttempt_;
+
+      if (sim.domain().isMaster()) {
+         outputFile_ << iStep << "  " << newStateId << std::endl;
+      }
+   }
+
+}
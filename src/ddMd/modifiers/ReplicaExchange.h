@@ -0,0 +1,130 @@
+#ifndef DDMD_REPLICA_EXCHANGE_H
+#define DDMD_REPLICA_EXCHANGE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Modifier.h"                  // base class
+
+#include <fstream>
+
+namespace DdMd
+{
+
+   class Simulation;
+   class Perturbation;
+
+   using namespace Util;
+
+   /**
+   * Replica exchange among systems on partitions of the communicator.
+   *
+   * A ReplicaExchange is used in a multi-system simulation, in which the
+   * -s nSystem command line option assigns each of nSystem replicas of
+   * a system to a different group of processors, so that each replica
+   * is a domain-decomposed simulation on its own sub-communicator. The
+   * replicas differ only in the state defined by a Perturbation (e.g.,
+   * a temperature, or a parameter of the Hamiltonian), which has one
+   * state per replica.
+   *
+   * At the end of every interval steps, exchanges are attempted between
+   * the replicas that hold states s and s+1, for all even s in even
+   * numbered attempts and all odd s in odd attempts. Each replica first
+   * computes the change in its statistical weight that would result
+   * from adopting its partner state, using reduced energies, and the
+   * master processor of system 0 then accepts or rejects each exchange
+   * with the Metropolis criterion. Exchanges swap the perturbation
+   * parameters, and do not move configurations between processors.
+   * Only the master processors of all systems communicate, through
+   * Simulation::replicaCommunicator().
+   *
+   * At each attempt, the master processor of each system writes the
+   * step index and its new state index to the file "repx" in its own
+   * output directory.
+   *
+   * \ingroup DdMd_Modifier_Module
+   */
+   class ReplicaExchange : public Modifier
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation
+      */
+      ReplicaExchange(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~ReplicaExchange();
+
+      /**
+      * Read interval and Perturbation block.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /**
+      * Open output file, if necessary.
+      */
+      virtual void setup();
+
+      /**
+      * Attempt replica exchanges.
+      *
+      * \param iStep MD step index
+      */
+      virtual void endOfStep(long iStep);
+
+      /**
+      * Get the Perturbation by reference.
+      */
+      Perturbation& perturbation();
+
+   private:
+
+      /// Output file stream for state indices.
+      std::ofstream outputFile_;
+
+      /// Pointer to Perturbation.
+      Perturbation* perturbationPtr_;
+
+      /// Number of exchange attempts.
+      long nAttempt_;
+
+      /**
+      * Check that the Perturbation exists, and that there are systems.
+      */
+      void checkPerturbation(const std::string& className);
+
+   };
+
+   // Inline member function
+
+   inline Perturbation& ReplicaExchange::perturbation()
+   {  return *perturbationPtr_; }
+
+}
+#endif
@@ -0,0 +1,79 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TemperaturePerturbation.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <util/ensembles/EnergyEnsemble.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   TemperaturePerturbation::TemperaturePerturbation(Simulation& simulation)
+    : Perturbation(simulation, 1)
+   {  setClassName("TemperaturePerturbation"); }
+
+   /*
+   * Destructor.
+   */
+   TemperaturePerturbation::~TemperaturePerturbation()
+   {}
+
+   /*
+   * Set temperature of the EnergyEnsemble.
+   */
+   void TemperaturePerturbation::setParameters()
+   {
+      EnergyEnsemble& ensemble = simulation().energyEnsemble();
+      if (!ensemble.isIsothermal()) {
+         UTIL_THROW("EnergyEnsemble is not isothermal");
+      }
+      ensemble.setTemperature(parameter(0, stateId()));
+   }
+
+   /*
+   * Set new temperature, and rescale velocities of local atoms.
+   */
+   void TemperaturePerturbation::adoptState(int stateId)
+   {
+      double oldTemperature = parameter(0, Perturbation::stateId());
+      setState(stateId);
+      double factor = sqrt(parameter(0, stateId)/oldTemperature);
+      if (!Atom::hasVelocity()) return;
+
+      AtomIterator atomIter;
+      simulation().atomStorage().begin(atomIter);
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         atomIter->velocity() *= factor;
+      }
+      simulation().velocitySignal().notify();
+   }
+
+   /*
+   * Return (1/T' - 1/T)*U (valid on master).
+   */
+   double TemperaturePerturbation::difference(int stateId)
+   {
+      simulation().computePotentialEnergies();
+      double dBeta = 1.0/parameter(0, stateId) 
+                   - 1.0/parameter(0, Perturbation::stateId());
+      double result = 0.0;
+      if (simulation().domain().isMaster()) {
+         result = dBeta*simulation().potentialEnergy();
+      }
+      return result;
+   }
+
+}
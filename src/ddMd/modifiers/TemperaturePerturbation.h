@@ -0,0 +1,72 @@
+#ifndef DDMD_TEMPERATURE_PERTURBATION_H
+#define DDMD_TEMPERATURE_PERTURBATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Perturbation.h"  // base class
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Perturbation of the temperature, for temperature replica exchange.
+   *
+   * Each state has one parameter, which is the temperature kT, in energy
+   * units, of the EnergyEnsemble (which must be isothermal). When a
+   * system adopts a new state in a replica exchange, all velocities are
+   * rescaled by sqrt(T'/T), where T and T' are the old and new
+   * temperatures, so that the kinetic energy does not enter the
+   * acceptance criterion. The difference W(X,p') - W(X,p) is thus
+   * (1/T' - 1/T)*U, where U is the total potential energy.
+   *
+   * \ingroup DdMd_Modifier_Module
+   */
+   class TemperaturePerturbation : public Perturbation
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation
+      */
+      TemperaturePerturbation(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~TemperaturePerturbation();
+
+      /**
+      * Set new temperature, and rescale velocities.
+      *
+      * \param stateId index of new state
+      */
+      virtual void adoptState(int stateId);
+
+      /**
+      * Compute (1/T' - 1/T)*U for the current configuration.
+      *
+      * \param stateId index of state with temperature T'
+      */
+      virtual double difference(int stateId);
+
+   protected:
+
+      /**
+      * Set the temperature of the EnergyEnsemble.
+      */
+      virtual void setParameters();
+
+   };
+
+}
+#endif
@@ -1,7 +1,11 @@
 ddMd_modifiers_=\
      ddMd/modifiers/Modifier.cpp \
      ddMd/modifiers/ModifierManager.cpp \
-     ddMd/modifiers/ModifierFactory.cpp
+     ddMd/modifiers/ModifierFactory.cpp \
+     ddMd/modifiers/Perturbation.cpp \
+     ddMd/modifiers/TemperaturePerturbation.cpp \
+     ddMd/modifiers/PairPerturbation.cpp \
+     ddMd/modifiers/ReplicaExchange.cpp
 
 ddMd_modifiers_SRCS=\
      $(addprefix $(SRC_DIR)/, $(ddMd_modifiers_))
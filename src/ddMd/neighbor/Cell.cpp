@@ -48,40 +48,73 @@ namespace DdMd
    {
       // Preconditions
       assert(offsetsPtr_);
-      assert(!isGhostCell_);
+      assert(!isGhostCell_ || reverseUpdateFlag);
 
-      const Cell* cellBegin;
-      const Cell* cellEnd;
+      StripArray strips;
       CellAtom* atomBegin;
       CellAtom* atomEnd;
       int  is, ns;
-      bool bg, eg;
 
       neighbors.clear();
+
+      // Atoms in this cell
+      atomBegin = begin_;
+      atomEnd = begin_ + nAtom_;
+      for ( ; atomBegin < atomEnd; ++atomBegin) {
+         neighbors.append(atomBegin);
+      }
+
+      // Atoms in neighboring cells
+      getNeighborStrips(strips, reverseUpdateFlag);
+      ns = strips.size();
+      for (is = 0; is < ns; ++is) {
+         atomBegin = strips[is].first;
+         atomEnd = strips[is].second;
+         for ( ; atomBegin < atomEnd; ++atomBegin) {
+            neighbors.append(atomBegin);
+         }
+      }
+   }
+
+   /*
+   * Fill an array with atom ranges for strips of neighboring cells.
+   *
+   * Element 0 of the offset array is the cell itself, and is skipped.
+   */
+   void Cell::getNeighborStrips(StripArray &strips, 
+                                bool reverseUpdateFlag) const
+   {
+      // Preconditions
+      assert(offsetsPtr_);
+      assert(!isGhostCell_ || reverseUpdateFlag);
+
+      const Cell* cellBegin;
+      const Cell* cellEnd;
+      std::pair<CellAtom*, CellAtom*> strip;
+      int  is, ns;
+      bool bg, eg;
+
+      strips.clear();
       ns = offsetsPtr_->size();
 
       if (reverseUpdateFlag) {
-         for (is = 0; is < ns; ++is) {
+         for (is = 1; is < ns; ++is) {
             cellBegin = this + (*offsetsPtr_)[is].first;
             cellEnd   = this + (*offsetsPtr_)[is].second;
             if (cellBegin->id() >= id_) {
-               atomBegin = cellBegin->begin_;
-               atomEnd = cellEnd->begin_ + cellEnd->nAtom_;
-               for ( ; atomBegin < atomEnd; ++atomBegin) {
-                  neighbors.append(atomBegin);
-               }
+               strip.first = cellBegin->begin_;
+               strip.second = cellEnd->begin_ + cellEnd->nAtom_;
+               strips.append(strip);
             }
          }
       } else {
-         for (is = 0; is < ns; ++is) {
+         for (is = 1; is < ns; ++is) {
             cellBegin = this + (*offsetsPtr_)[is].first;
             cellEnd = this + (*offsetsPtr_)[is].second;
             if (cellBegin->id() >= id_) {
-               atomBegin = cellBegin->begin_;
-               atomEnd = cellEnd->begin_ + cellEnd->nAtom_;
-               for ( ; atomBegin < atomEnd; ++atomBegin) {
-                  neighbors.append(atomBegin);
-               }
+               strip.first = cellBegin->begin_;
+               strip.second = cellEnd->begin_ + cellEnd->nAtom_;
+               strips.append(strip);
             } else {
                bg = cellBegin->isGhostCell();
                eg = cellEnd->isGhostCell();
@@ -95,11 +128,9 @@ namespace DdMd
                      eg = cellEnd->isGhostCell();
                   }
                   assert(cellEnd >= cellBegin);
-                  atomBegin = cellBegin->begin_;
-                  atomEnd = cellEnd->begin_ + cellEnd->nAtom_;
-                  for ( ; atomBegin < atomEnd; ++atomBegin) {
-                     neighbors.append(atomBegin);
-                  }
+                  strip.first = cellBegin->begin_;
+                  strip.second = cellEnd->begin_ + cellEnd->nAtom_;
+                  strips.append(strip);
                }
             }
          }
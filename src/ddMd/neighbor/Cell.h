@@ -34,7 +34,10 @@ namespace DdMd
    *
    * The method Cell::getNeighbors() returns an array containing pointers
    * to atoms in this cell and all neighboring cells, with the atoms in
-   * in this cell listed first.
+   * in this cell listed first. The method Cell::getNeighborStrips()
+   * instead returns the same neighbors, excluding this cell, as a short
+   * list of contiguous ranges of CellAtom objects, one per strip of 
+   * adjacent neighbor cells, without copying a pointer for every atom.
    *
    * Here is an example of code to iterate over all local cells in a
    * CellList, and over all pairs of neighboring atoms:
@@ -109,6 +112,12 @@ namespace DdMd
       */
       typedef FSArray<CellAtom*, MaxNeighborAtom> NeighborArray;
 
+      /**
+      * Static array of [begin, end) ranges of CellAtoms in neighbor cells.
+      */
+      typedef FSArray< std::pair<CellAtom*, CellAtom*>, OffSetArrayCapacity> 
+              StripArray;
+
       /**
       * Constructor.
       */
@@ -224,12 +233,34 @@ namespace DdMd
       * neighboring local cells with a cell id greater than this->id(), and 
       * from neighboring ghost cells.
       *
+      * If reverseUpdateFlag is true, this may also be called for a
+      * ghost cell in the linked list returned by CellList::ghostBegin().
+      *
       * \param neighbors          Array of pointers to neighbor Atoms
       * \param reverseUpdateFlag  Is reverse communication enabled?
       */
       void getNeighbors(NeighborArray& neighbors, 
                         bool reverseUpdateFlag = false) const;
 
+      /**
+      * Fill an array with ranges of atoms in neighboring cells.
+      *
+      * Upon return, each element of strips is a pair of pointers to the
+      * first CellAtom and one past the last CellAtom of a contiguous 
+      * strip of neighboring cells. Atoms in this cell are not included.
+      * The atoms in all strips are the atoms returned by getNeighbors()
+      * after the first nAtom(), i.e., the half-shell of neighboring 
+      * local cells with greater cell id, and neighboring ghost cells.
+      *
+      * If reverseUpdateFlag is true, this may also be called for a
+      * ghost cell in the linked list returned by CellList::ghostBegin().
+      *
+      * \param strips             Array of [begin, end) atom ranges
+      * \param reverseUpdateFlag  Is reverse communication enabled?
+      */
+      void getNeighborStrips(StripArray& strips, 
+                             bool reverseUpdateFlag = false) const;
+
    private:
 
       /// Pointer to first Atom* pointer for this cell.
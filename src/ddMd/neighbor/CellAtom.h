@@ -37,6 +37,7 @@ namespace DdMd
       {
          position_ = ptr_->position();
          id_ = ptr_->id();
+         typeId_ = ptr_->typeId();
       }
 
       Atom* ptr() const
@@ -48,6 +49,9 @@ namespace DdMd
          return id_;
       }
 
+      int typeId() const
+      {  return typeId_; }
+
       const Vector& position() const
       {  
          //return ptr_->position(); 
@@ -64,6 +68,7 @@ namespace DdMd
       Vector position_;
       Atom* ptr_;
       int id_;
+      int typeId_;
 
    };
 
@@ -6,10 +6,13 @@
 */
 
 #include "CellList.h"
+#include <ddMd/misc/PageAllocator.h>
 #include <util/space/Vector.h>
 #include <util/space/IntVector.h>
 #include <util/containers/FArray.h>
 
+#include <algorithm>
+
 namespace DdMd
 {
 
@@ -20,15 +23,21 @@ namespace DdMd
    */
    CellList::CellList()
     : begin_(0),
+      ghostBegin_(0),
       nAtom_(0),
       nReject_(0),
+      nOccupiedLocal_(0),
+      nCellCut_(1),
       #ifdef UTIL_DEBUG
       maxNAtomCell_(0),
       #endif
-      isBuilt_(false)
+      isBuilt_(false),
+      halfShell_(false),
+      isOrthogonal_(true)
    {
       for (int i = 0; i < Dimension; ++i) {
          cellLengths_[i] = 0.0;
+         invCellLengths_[i] = 0.0;
       }
    }
 
@@ -48,11 +57,40 @@ namespace DdMd
       // Allocate arrays of tag and handle objects
       tags_.allocate(atomCapacity);
       atoms_.allocate(atomCapacity);
+      PageAllocator::advise(&tags_[0], atomCapacity*sizeof(Tag));
+      PageAllocator::advise(&atoms_[0], atomCapacity*sizeof(CellAtom));
 
       // Set grid dimensions and allocate an array of Cell objects
       setGridDimensions(lower, upper, cutoffs, nCellCut);
    }
 
+   /*
+   * Increase capacity for atoms, discarding contents.
+   */
+   void CellList::reserveAtoms(int atomCapacity)
+   {
+      if (atomCapacity > tags_.capacity()) {
+         tags_.deallocate();
+         tags_.allocate(atomCapacity);
+         atoms_.deallocate();
+         atoms_.allocate(atomCapacity);
+         PageAllocator::advise(&tags_[0], atomCapacity*sizeof(Tag));
+         PageAllocator::advise(&atoms_[0], atomCapacity*sizeof(CellAtom));
+         isBuilt_ = false;
+      }
+   }
+
+   /*
+   * Enable linked list of upper ghost cells (half-shell scheme).
+   */
+   void CellList::setHalfShell(bool halfShell)
+   {
+      if (isAllocated()) {
+         UTIL_THROW("CellList::setHalfShell called after allocate");
+      }
+      halfShell_ = halfShell;
+   }
+
    /*
    * Calculate number of cells in each direction of grid, resize cells_ array if needed.
    */
@@ -67,6 +105,7 @@ namespace DdMd
       }
       upper_ = upper;
       lower_ = lower;
+      nCellCut_ = nCellCut;
 
       bool isNewGrid;
       if (grid_.size() < 27) {
@@ -77,6 +116,7 @@ namespace DdMd
 
       Vector lengths;
       IntVector gridDimensions;
+      IntVector localDimensions;
       for (int i = 0; i < Dimension; ++i) {
  
          lengths[i] = upper_[i] - lower_[i];
@@ -88,11 +128,19 @@ namespace DdMd
          }
          gridDimensions[i] = int(lengths[i]*nCellCut/cutoffs[i]);
          cellLengths_[i] = lengths[i]/double(gridDimensions[i]);
+         invCellLengths_[i] = 1.0/cellLengths_[i];
          lowerOuter_[i] = lower_[i] - nCellCut*cellLengths_[i];
          upperOuter_[i] = upper_[i] + nCellCut*cellLengths_[i];
 
-         // Add two extra layers of cells for ghosts.
-         gridDimensions[i] += 2*nCellCut;
+         // Add two extra layers of cells for ghosts. For the half-shell
+         // scheme, add a third empty layer above the upper ghost layer.
+         localDimensions[i] = gridDimensions[i];
+         maxCell_[i] = gridDimensions[i] + 2*nCellCut - 1;
+         if (halfShell_) {
+            gridDimensions[i] += 3*nCellCut;
+         } else {
+            gridDimensions[i] += 2*nCellCut;
+         }
 
          if (gridDimensions[i] != grid_.dimension(i)) {
             isNewGrid = true;   
@@ -130,11 +178,15 @@ namespace DdMd
          }
          // Loop over local cells, linking and marking each as a local cell.
          IntVector p;
+         IntVector q;
          Cell* prevPtr = 0;
          Cell* cellPtr = 0;
-         for (p[0] = nCellCut; p[0] < grid_.dimension(0) - nCellCut; ++p[0]) {
-            for (p[1] = nCellCut; p[1] < grid_.dimension(1) - nCellCut; ++p[1]) {
-               for (p[2] = nCellCut; p[2] < grid_.dimension(2) - nCellCut; ++p[2]) {
+         for (int i = 0; i < Dimension; ++i) {
+            q[i] = nCellCut + localDimensions[i];
+         }
+         for (p[0] = nCellCut; p[0] < q[0]; ++p[0]) {
+            for (p[1] = nCellCut; p[1] < q[1]; ++p[1]) {
+               for (p[2] = nCellCut; p[2] < q[2]; ++p[2]) {
                   ic = grid_.rank(p);
                   cellPtr = &cells_[ic];
                   cellPtr->setIsGhostCell(false);
@@ -148,10 +200,39 @@ namespace DdMd
             }
          }
          cellPtr->setLastCell();
+
+         // Link ghost cells above the lower domain bound in all directions
+         ghostBegin_ = 0;
+         if (halfShell_) {
+            prevPtr = 0;
+            for (p[0] = nCellCut; p[0] <= maxCell_[0]; ++p[0]) {
+               for (p[1] = nCellCut; p[1] <= maxCell_[1]; ++p[1]) {
+                  for (p[2] = nCellCut; p[2] <= maxCell_[2]; ++p[2]) {
+                     if (p[0] < q[0] && p[1] < q[1] && p[2] < q[2]) {
+                        continue;
+                     }
+                     cellPtr = &cells_[grid_.rank(p)];
+                     if (prevPtr) {
+                        prevPtr->setNextCell(*cellPtr);
+                     } else {
+                        ghostBegin_ = cellPtr;
+                     }
+                     prevPtr = cellPtr;
+                  }
+               }
+            }
+            cellPtr->setLastCell();
+         }
       } 
       
    }
 
+   /*
+   * Choose criterion for neighbor cells (orthogonal or triclinic axes).
+   */
+   void CellList::setOrthogonal(bool isOrthogonal)
+   {  isOrthogonal_ = isOrthogonal; }
+
    /*
    * Construct grid of cells, build linked list and identify neighbors.
    */
@@ -198,6 +279,9 @@ namespace DdMd
       offsets_.append(strip); 
 
       // Loop over all cells within box -nCellCut <= i, j, k <= nCellCut
+      // For orthogonal axes, accept a cell if the sum of e over all
+      // directions is <= 1. For triclinic axes, widths along different
+      // axes are not orthogonal, so accept a cell if each e is <= 1.
       double e0, e1, e2;              // Partial sums of distance^2/cutoff^2
       int offset0, offset1, offset;   // Partial sums for cell id offset
       int i, j, k;                    // relative cell coordinates
@@ -208,11 +292,19 @@ namespace DdMd
          e0 = e[i+nCellCut][0];
          offset0 = i*span0;
          for (j = -nCellCut; j <= nCellCut; ++j) {
-            e1 = e0 + e[j + nCellCut][1];
+            if (isOrthogonal_) {
+               e1 = e0 + e[j + nCellCut][1];
+            } else {
+               e1 = std::max(e0, e[j + nCellCut][1]);
+            }
             offset1 = offset0 + j*span1;
             for (k = -nCellCut; k <= nCellCut; ++k) {
                offset = offset1 + k;
-               e2 = e1 + e[k + nCellCut][2];
+               if (isOrthogonal_) {
+                  e2 = e1 + e[k + nCellCut][2];
+               } else {
+                  e2 = std::max(e1, e[k + nCellCut][2]);
+               }
                if (e2 <= 1.0) {
                   if (offset != 0) { // Exclude offset = 0 (already added)
                      if (isActive) {
@@ -264,6 +356,9 @@ namespace DdMd
 
       nAtom_ = 0;
       nReject_ = 0;
+      occupied_.clear();
+      driftCells_.clear();
+      nOccupiedLocal_ = 0;
       #ifdef UTIL_DEBUG
       maxNAtomCell_ = 0;
       #endif
@@ -276,17 +371,57 @@ namespace DdMd
    */
    void CellList::build()
    {
-      // Initialize all cells, by associating each with a
-      // block of the atoms_ array.
-
+      // This is a counting sort: placeAtom() counted atoms per cell.
+      // Initialize all cells, by associating each with a block of the 
+      // atoms_ array (an exclusive prefix sum of the cell counts).
+      const int nCell = grid_.size();
+      Cell* cells = &cells_[0];
       CellAtom* cellAtomPtr = &atoms_[0];
-      for (int i = 0; i < grid_.size(); ++i) {
-         cellAtomPtr = cells_[i].initialize(cellAtomPtr);
+      for (int i = 0; i < nCell; ++i) {
+         cellAtomPtr = cells[i].initialize(cellAtomPtr);
       }
 
-      // Add all atoms to cells.
-      for (int i = 0; i < nAtom_; ++i) {
-         cells_[tags_[i].cellRank].append(tags_[i].ptr);
+      // Scatter all atoms to cells, in one pass over the tags, and
+      // record each ghost cell that receives a local atom.
+      const Tag* tagPtr = &tags_[0];
+      const Tag* tagEnd = tagPtr + nAtom_;
+      Cell* targetPtr;
+      int k;
+      bool isNew;
+      driftCells_.clear();
+      for ( ; tagPtr < tagEnd; ++tagPtr) {
+         targetPtr = &cells[tagPtr->cellRank];
+         if (targetPtr->isGhostCell() && !tagPtr->ptr->isGhost()) {
+            isNew = true;
+            for (k = 0; k < targetPtr->nAtom(); ++k) {
+               if (!targetPtr->atomPtr(k)->ptr()->isGhost()) {
+                  isNew = false;
+                  break;
+               }
+            }
+            if (isNew) {
+               driftCells_.append(targetPtr);
+            }
+         }
+         targetPtr->append(tagPtr->ptr);
+      }
+
+      // List non-empty local cells, then non-empty upper ghost cells.
+      occupied_.clear();
+      const Cell* cellPtr = begin_;
+      while (cellPtr) {
+         if (cellPtr->nAtom()) {
+            occupied_.append(cellPtr);
+         }
+         cellPtr = cellPtr->nextCellPtr();
+      }
+      nOccupiedLocal_ = occupied_.size();
+      cellPtr = ghostBegin_;
+      while (cellPtr) {
+         if (cellPtr->nAtom()) {
+            occupied_.append(cellPtr);
+         }
+         cellPtr = cellPtr->nextCellPtr();
       }
 
       #ifdef UTIL_DEBUG
@@ -314,6 +449,18 @@ namespace DdMd
       }
    }
 
+   /*
+   * Get the coordinate bounds of one cell.
+   */
+   void CellList::cellBounds(int i, Vector& lower, Vector& upper) const
+   {
+      IntVector r = grid_.position(i);
+      for (int k = 0; k < Dimension; ++k) {
+         lower[k] = lowerOuter_[k] + r[k]*cellLengths_[k];
+         upper[k] = lower[k] + cellLengths_[k];
+      }
+   }
+
    /*
    * Get total number of atoms in this CellList.
    */
@@ -346,6 +493,18 @@ namespace DdMd
    int CellList::cellCapacity() const
    {  return cells_.capacity(); }
 
+   /*
+   * Get the number of bytes allocated.
+   */
+   double CellList::memoryBytes() const
+   {
+      return tags_.capacity()*sizeof(Tag)
+           + atoms_.capacity()*sizeof(CellAtom)
+           + cells_.capacity()*sizeof(Cell)
+           + occupied_.capacity()*sizeof(const Cell*)
+           + driftCells_.capacity()*sizeof(const Cell*);
+   }
+
    /*
    * Is this CellList built (i.e., full of atoms)?
    */
@@ -12,6 +12,7 @@
 #include <ddMd/chemistry/Atom.h>
 #include <util/boundary/Boundary.h>
 #include <util/space/Grid.h>
+#include <util/space/IntVector.h>
 #include <util/containers/DArray.h>
 #include <util/containers/GArray.h>
 #include <util/global.h>
@@ -75,15 +76,31 @@ namespace DdMd
    * and the ghostCapacity of the associated atomStorage, which is the maximum 
    * total number of atoms that can exist on this processor.
    *
+   * For use with the half-shell ghost communication scheme, in which ghosts
+   * lie only above the upper bounds of the domain, call setHalfShell()
+   * before allocate(). The grid then has an extra layer of empty cells
+   * above the upper ghost layer in each direction, and ghostBegin() returns
+   * a second linked list of the ghost cells that lie above the domain,
+   * every one of which has a complete set of neighboring cells.
+   *
    * If the upper and lower bounds and atom coordinates are all expressed in
    * generalized coordinates, which span 0.0 - 1.0 over the primitive periodic
    * cell in each direction, each element of the cutoffs vector is given by a
    * ratio cutoffs[i] = cutoff/length[i], where length[i] is the Cartesian
    * distance across the unit cell along a direciton parallel to reciprocal 
-   * basis vector i. 
+   * basis vector i. These ratios are returned by DdMd::scaledWidth().
+   * For a boundary with non-orthogonal basis vectors, also call
+   * setOrthogonal(false) before makeGrid().
    *
    * See Cell documentation for an example of how to iterate over local cells 
    * and neighboring atom pairs. 
+   *
+   * The build() method also makes a compact list of the primary cells that
+   * contain at least one atom: the non-empty local cells, followed by the
+   * non-empty upper ghost cells if setHalfShell(true) was called. Loops over
+   * primary cells may use nOccupiedCell() and occupiedCell() to skip empty
+   * cells, which is worthwhile in systems with large empty regions, such as
+   * slits or films with free surfaces.
    * 
    * \ingroup DdMd_Neighbor_Module
    */
@@ -134,6 +151,17 @@ namespace DdMd
       void allocate(int atomCapacity, const Vector& lower, const Vector& upper, 
                     const Vector& cutoffs, int nCellCut = 1);
 
+      /**
+      * Increase the capacity for atoms, if necessary.
+      *
+      * Reallocates the arrays of Tag and CellAtom objects if atomCapacity
+      * exceeds the current capacity. Call only before clear() and a
+      * rebuild, since the cell list is emptied.
+      *
+      * \param atomCapacity new minimum capacity for atoms
+      */
+      void reserveAtoms(int atomCapacity);
+
       /**
       * Allocate memory for this CellList (Cartesian coordinates).
       *
@@ -151,6 +179,28 @@ namespace DdMd
       void allocate(int atomCapacity, const Vector& lower, const Vector& upper, 
                     double cutoff, int nCellCut = 1);
 
+      /**
+      * Enable a linked list of upper ghost cells, for the half-shell scheme.
+      *
+      * Must be called before allocate().
+      *
+      * \param halfShell true to enable upper ghost cell list
+      */
+      void setHalfShell(bool halfShell);
+
+      /**
+      * Set whether the axes of generalized coordinates are orthogonal.
+      *
+      * If false (for a triclinic boundary), makeGrid() includes every
+      * cell whose separation from the primary cell along each axis,
+      * measured normal to the cell faces, is less than the cutoff. This
+      * is valid for any boundary if cutoffs are computed by scaledWidth().
+      * The default is true, for orthorhombic boundaries.
+      *
+      * \param isOrthogonal true if basis vectors are orthogonal
+      */
+      void setOrthogonal(bool isOrthogonal);
+
       /**
       * Make the cell grid (using generalized coordinates).
       *
@@ -237,11 +287,29 @@ namespace DdMd
       */
       int cellIndexFromPosition(const Vector& position) const;
 
+      /**
+      * Get the lower and upper coordinate bounds of one cell.
+      *
+      * \param i  cell index
+      * \param lower  lower bound of cell coordinates (output)
+      * \param upper  upper bound of cell coordinates (output)
+      */
+      void cellBounds(int i, Vector& lower, Vector& upper) const;
+
       /**
       * Return pointer to first local cell in linked list.
       */
       const Cell* begin() const;
 
+      /**
+      * Return pointer to first upper ghost cell in a second linked list.
+      *
+      * This list contains every ghost cell that lies above the lower
+      * bounds of the domain in every direction, and is defined only if
+      * setHalfShell(true) was called. Returns null otherwise.
+      */
+      const Cell* ghostBegin() const;
+
       /**
       * Return a specified cell by const reference.
       * 
@@ -249,6 +317,53 @@ namespace DdMd
       */
       const Cell& cell(int i) const;
 
+      /**
+      * Get the number of non-empty primary cells.
+      *
+      * This is the number of non-empty local cells, plus the number of
+      * non-empty upper ghost cells in the half-shell scheme. Set by build().
+      */
+      int nOccupiedCell() const;
+
+      /**
+      * Get the number of non-empty local cells.
+      *
+      * Local cells are listed first, so occupiedCell(i) is a local cell
+      * for 0 <= i < nOccupiedLocalCell(). Set by build().
+      */
+      int nOccupiedLocalCell() const;
+
+      /**
+      * Return one non-empty primary cell by const reference.
+      *
+      * Cells are listed in the order of the linked lists of local and
+      * upper ghost cells.
+      *
+      * \param i index in list of non-empty cells, 0 <= i < nOccupiedCell()
+      */
+      const Cell& occupiedCell(int i) const;
+
+      /**
+      * Get the number of ghost cells that contain local atoms.
+      *
+      * Local atoms lie in ghost cells only if they have moved outside
+      * the domain since the last exchange, e.g., if the cell list is
+      * rebuilt without an exchange. Set by build().
+      */
+      int nDriftCell() const;
+
+      /**
+      * Return one ghost cell that contains local atoms.
+      *
+      * \param i index in list, 0 <= i < nDriftCell()
+      */
+      const Cell& driftCell(int i) const;
+
+      /**
+      * Get the number of cells per cutoff length (set by makeGrid).
+      */
+      int nCellCut() const;
+
       /**
       * Get total number of atoms (local and ghost) in this CellList.
       */
@@ -276,6 +391,11 @@ namespace DdMd
       */
       int cellCapacity() const;
 
+      /**
+      * Number of bytes allocated for tags, cell atoms and cells.
+      */
+      double memoryBytes() const;
+
       /**
       * Has memory been allocated for this CellList?
       */
@@ -320,6 +440,12 @@ namespace DdMd
       /// Array of Cell objects.
       GArray<Cell> cells_;
 
+      /// Pointers to non-empty primary cells (local cells first).
+      GArray<const Cell*> occupied_;
+
+      /// Pointers to ghost cells that contain local atoms.
+      GArray<const Cell*> driftCells_;
+
       /// Lower coordinate bounds (local atoms).
       Vector lower_; 
 
@@ -329,6 +455,9 @@ namespace DdMd
       /// Length of each cell in grid
       Vector cellLengths_; 
 
+      /// Inverse of length of each cell in grid
+      Vector invCellLengths_; 
+
       /// Lower bound for nonbonded ghosts.
       Vector lowerOuter_; 
 
@@ -338,12 +467,24 @@ namespace DdMd
       /// Pointer to first local cell (to initialize iterator).
       Cell* begin_;
 
+      /// Pointer to first upper ghost cell (half-shell only), or null.
+      Cell* ghostBegin_;
+
+      /// Maximum grid coordinate of a cell that may contain atoms.
+      IntVector maxCell_;
+
       /// Total number of atoms in cell list.
       int nAtom_;
 
       /// Number of atoms that were not placed in cells.
       int nReject_;
 
+      /// Number of non-empty local cells (first elements of occupied_).
+      int nOccupiedLocal_;
+
+      /// Number of cells per cutoff length.
+      int nCellCut_;
+
       #ifdef UTIL_DEBUG
       /// Maximum number of atoms in one cell. 
       int maxNAtomCell_;
@@ -352,6 +493,12 @@ namespace DdMd
       /// Has this CellList been built?
       bool isBuilt_;
 
+      /// Is the upper ghost cell list (half-shell scheme) enabled?
+      bool halfShell_;
+
+      /// Are the axes of generalized coordinates orthogonal?
+      bool isOrthogonal_;
+
       /**
       * Calculate required dimensions for cell grid and resize cells_ array.
       *
@@ -381,16 +528,24 @@ namespace DdMd
    */
    inline int CellList::cellIndexFromPosition(const Vector& position) const
    {
+      // Bounds check for all components, combined in one branch
+      bool inside = true;
+      int i;
+      for (i = 0; i < Dimension; ++i) {
+         inside &= (position[i] > lowerOuter_[i]);
+         inside &= (position[i] < upperOuter_[i]);
+      }
+      if (!inside) {
+         return -1;
+      }
+
+      // Multiply by precomputed inverse lengths (no division)
       IntVector r;
-      for (int i = 0; i < Dimension; ++i) {
-         if (position[i] <= lowerOuter_[i]) {
-            return -1;
-         }
-         if (position[i] >= upperOuter_[i]) {
-            return -1;
-         }
-         r[i] = int( (position[i] - lowerOuter_[i])/ cellLengths_[i] );
-         assert(r[i] < grid_.dimension(i));
+      int d;
+      for (i = 0; i < Dimension; ++i) {
+         r[i] = int((position[i] - lowerOuter_[i])*invCellLengths_[i]);
+         d = maxCell_[i];
+         r[i] = (r[i] > d) ? d : r[i];
       }
       return grid_.rank(r);
    }
@@ -441,12 +596,60 @@ namespace DdMd
       return cells_[i]; 
    }
 
+   /*
+   * Return number of non-empty primary cells.
+   */
+   inline int CellList::nOccupiedCell() const
+   {  return occupied_.size(); }
+
+   /*
+   * Return number of non-empty local cells.
+   */
+   inline int CellList::nOccupiedLocalCell() const
+   {  return nOccupiedLocal_; }
+
+   /*
+   * Return reference to non-empty primary cell number i.
+   */
+   inline const Cell& CellList::occupiedCell(int i) const
+   {
+      assert(i < occupied_.size());
+      return *occupied_[i];
+   }
+
+   /*
+   * Return number of ghost cells that contain local atoms.
+   */
+   inline int CellList::nDriftCell() const
+   {  return driftCells_.size(); }
+
+   /*
+   * Return reference to ghost cell number i that contains local atoms.
+   */
+   inline const Cell& CellList::driftCell(int i) const
+   {
+      assert(i < driftCells_.size());
+      return *driftCells_[i];
+   }
+
+   /*
+   * Return number of cells per cutoff length.
+   */
+   inline int CellList::nCellCut() const
+   {  return nCellCut_; }
+
    /*
    * Return pointer to first Cell.
    */
    inline const Cell* CellList::begin() const
    {  return begin_; }
 
+   /*
+   * Return pointer to first upper ghost Cell (half-shell only).
+   */
+   inline const Cell* CellList::ghostBegin() const
+   {  return ghostBegin_; }
+
    /*
    * Is this CellList allocated?
    */
@@ -98,6 +98,18 @@ namespace DdMd
       */
       void getPair(Atom* &atom1Ptr, Atom* &atom2Ptr) const;
 
+      /**
+      * Prefetch the secondary atom of a later pair into cache.
+      *
+      * Issues a prefetch of the secondary Atom of the pair that is ahead
+      * pairs after the current pair, if that pair exists. This does not
+      * dereference any atom. Does nothing unless compiled with a GNU
+      * compatible compiler.
+      *
+      * \param ahead number of pairs ahead of the current pair
+      */
+      void prefetch(int ahead) const;
+
    private:
  
       /// Array of const pointers to primary atom in each pair.
@@ -106,6 +118,12 @@ namespace DdMd
       /// Array of const pointers to secondary atom in each pair.
       Atom* const* atom2Ptrs_;  
 
+      /// Array of encoded secondary atom indices (compact list only).
+      const int*   atom2Ids_;  
+
+      /// Addresses of first local and ghost atoms (compact list only).
+      Atom* const* atomBases_;  
+
       /// Pointer to const index in atom2Ptrs_ of first neighbor of an Atom.
       const int*   first_; 
 
@@ -133,6 +151,8 @@ namespace DdMd
    inline PairIterator::PairIterator()
     : atom1Ptrs_(0),
       atom2Ptrs_(0),
+      atom2Ids_(0),
+      atomBases_(0),
       first_(0),
       nAtom1_(0),
       nAtom2_(0),
@@ -146,6 +166,8 @@ namespace DdMd
    inline PairIterator::PairIterator(const PairList &pairList)
     : atom1Ptrs_(0),
       atom2Ptrs_(0),
+      atom2Ids_(0),
+      atomBases_(0),
       first_(0),
       nAtom1_(0),
       nAtom2_(0),
@@ -163,7 +185,12 @@ namespace DdMd
       assert(atom2Id_ >=0);
       assert(atom2Id_ < nAtom2_);
       atom1Ptr = atom1Ptrs_[atom1Id_];
-      atom2Ptr = atom2Ptrs_[atom2Id_];
+      if (atom2Ptrs_) {
+         atom2Ptr = atom2Ptrs_[atom2Id_];
+      } else {
+         int id = atom2Ids_[atom2Id_];
+         atom2Ptr = atomBases_[(unsigned int)id >> 31] + (id & 0x7FFFFFFF);
+      }
    }
  
    /*
@@ -182,6 +209,25 @@ namespace DdMd
       return *this;
    }
 
+   /*
+   * Prefetch the secondary atom of a later pair.
+   */
+   inline void PairIterator::prefetch(int ahead) const
+   {
+      #ifdef __GNUC__
+      int k = atom2Id_ + ahead;
+      if (k < nAtom2_) {
+         if (atom2Ptrs_) {
+            __builtin_prefetch(atom2Ptrs_[k]);
+         } else {
+            int id = atom2Ids_[k];
+            __builtin_prefetch(atomBases_[(unsigned int)id >> 31]
+                               + (id & 0x7FFFFFFF));
+         }
+      }
+      #endif
+   }
+
    /*
    * Return true if past last pair in list.
    */
@@ -8,7 +8,11 @@
 #include "PairList.h"
 #include "PairIterator.h"
 #include <ddMd/chemistry/Atom.h>
+#include <ddMd/misc/MemoryReport.h>
+#include <ddMd/misc/PageAllocator.h>
 #include <util/space/Vector.h>
+#include <util/space/IntVector.h>
+#include <util/space/Grid.h>
 #include <util/format/Int.h>
 #include <util/global.h>
 
@@ -23,8 +27,12 @@ namespace DdMd
    PairList::PairList()
     : atom1Ptrs_(),
       atom2Ptrs_(),
+      atom2Ids_(),
       first_(),
       cutoff_(0.0),
+      typeCutoffs_(),
+      typeCutoffSq_(),
+      maxTypeCutoff_(0.0),
       atomCapacity_(0),
       pairCapacity_(0),
       maxNAtomLocal_(0),
@@ -32,8 +40,13 @@ namespace DdMd
       buildCounter_(0),
       maxNAtom_(0),
       maxNPair_(0),
-      isAllocated_(false)
-   {}
+      isAllocated_(false),
+      isCompact_(false),
+      hasTypeCutoffs_(false)
+   {
+      atomBases_[0] = 0;
+      atomBases_[1] = 0;
+   }
    
    /*
    * Destructor.
@@ -51,12 +64,101 @@ namespace DdMd
       cutoff_       = cutoff;
 
       atom1Ptrs_.reserve(atomCapacity_);
-      atom2Ptrs_.reserve(pairCapacity_);
+      if (isCompact_) {
+         atom2Ids_.reserve(pairCapacity_);
+      } else {
+         atom2Ptrs_.reserve(pairCapacity_);
+      }
       first_.reserve(atomCapacity_ + 1);
   
       isAllocated_ = true;
    }
 
+   /*
+   * Choose compact storage of secondary atoms, by array index.
+   */
+   void PairList::setCompact(Atom* localBegin, Atom* ghostBegin) 
+   {
+      if (isAllocated_) {
+         UTIL_THROW("PairList::setCompact called after allocate");
+      }
+      if (localBegin == 0 || ghostBegin == 0) {
+         UTIL_THROW("Null atom array address");
+      }
+      atomBases_[0] = localBegin;
+      atomBases_[1] = ghostBegin;
+      isCompact_ = true;
+   }
+
+   /*
+   * Append a secondary atom (private).
+   */
+   inline void PairList::appendAtom2(Atom* atomPtr)
+   {
+      if (isCompact_) {
+         if (atomPtr->isGhost()) {
+            atom2Ids_.append(int(atomPtr - atomBases_[1]) | (~0x7FFFFFFF));
+         } else {
+            atom2Ids_.append(int(atomPtr - atomBases_[0]));
+         }
+      } else {
+         atom2Ptrs_.append(atomPtr);
+      }
+   }
+
+   /*
+   * Reset the pair list cutoff.
+   */
+   void PairList::setCutoff(double cutoff) 
+   {  cutoff_ = cutoff; }
+
+   /*
+   * Set force cutoffs for pairs of atom types.
+   */
+   void PairList::setTypeCutoffs(const DMatrix<double>& cutoffs)
+   {
+      int nAtomType = cutoffs.capacity1();
+      if (nAtomType <= 0 || cutoffs.capacity2() != nAtomType) {
+         UTIL_THROW("Type cutoff matrix must be square");
+      }
+      if (typeCutoffs_.isAllocated()) {
+         if (typeCutoffs_.capacity1() != nAtomType) {
+            UTIL_THROW("Inconsistent number of atom types");
+         }
+      } else {
+         typeCutoffs_.allocate(nAtomType, nAtomType);
+         typeCutoffSq_.allocate(nAtomType*nAtomType);
+      }
+      maxTypeCutoff_ = 0.0;
+      for (int i = 0; i < nAtomType; ++i) {
+         for (int j = 0; j < nAtomType; ++j) {
+            typeCutoffs_(i, j) = cutoffs(i, j);
+            if (cutoffs(i, j) > maxTypeCutoff_) {
+               maxTypeCutoff_ = cutoffs(i, j);
+            }
+         }
+      }
+      hasTypeCutoffs_ = true;
+   }
+
+   /*
+   * Update after reallocation of atom arrays.
+   */
+   void PairList::resetAtoms(int atomCapacity, Atom* localBegin,
+                             Atom* ghostBegin)
+   {
+      if (atomCapacity > atomCapacity_) {
+         atomCapacity_ = atomCapacity;
+         atom1Ptrs_.reserve(atomCapacity_);
+         first_.reserve(atomCapacity_ + 1);
+      }
+      if (isCompact_) {
+         atomBases_[0] = localBegin;
+         atomBases_[1] = ghostBegin;
+      }
+      clear();
+   }
+
    /*
    * Clear the PairList.
    */
@@ -64,13 +166,15 @@ namespace DdMd
    { 
       atom1Ptrs_.clear();
       atom2Ptrs_.clear();
+      atom2Ids_.clear();
       first_.clear();
    }
  
    /*
    * Build the PairList, i.e., populate it with atom pairs.
    */
-   void PairList::build(CellList& cellList, bool reverseUpdateFlag)
+   void PairList::build(CellList& cellList, bool reverseUpdateFlag,
+                        bool halfShell)
    {
       // Precondition
       assert(isAllocated());
@@ -84,57 +188,146 @@ namespace DdMd
       Vector dr;
       int na;                 // number of atoms in this cell
       int nn;                 // number of neighbors for a cell
-      int i, j;
+      const double* rowCutoffSq = 0;
+      int nAtomType = 0;
+      int i, j, k, nCell;
       bool hasNeighbor;
   
       // Set maximum squared-separation for pairs in Pairlist
       cutoffSq = cutoff_*cutoff_;
+
+      // Set squared list cutoffs for pairs of types, if any
+      if (hasTypeCutoffs_) {
+         nAtomType = typeCutoffs_.capacity1();
+         double skin = cutoff_ - maxTypeCutoff_;
+         double c;
+         for (i = 0; i < nAtomType; ++i) {
+            for (j = 0; j < nAtomType; ++j) {
+               c = typeCutoffs_(i, j) + skin;
+               typeCutoffSq_[i*nAtomType + j] = c*c;
+            }
+         }
+      }
    
       // Initialize counters for primary atoms and neighbors
       atom1Ptrs_.clear();
       atom2Ptrs_.clear();
+      atom2Ids_.clear();
       first_.clear();
       first_.append(0);
 
       // Copy positions and ids into cell list
       cellList.update();
    
-      // Find all neighbors (cell list)
-      cellPtr = cellList.begin();
-      while (cellPtr) {
+      // Find all neighbors, looping over non-empty primary cells. In the
+      // half-shell scheme, the upper ghost cells are also primary cells
+      // (ghost-ghost pairs), and are listed after the local cells.
+      nCell = halfShell ? cellList.nOccupiedCell()
+                        : cellList.nOccupiedLocalCell();
+      for (k = 0; k < nCell; ++k) {
+         cellPtr = &cellList.occupiedCell(k);
          na = cellPtr->nAtom(); // # of atoms in cell
+         cellPtr->getNeighbors(neighbors, reverseUpdateFlag);
+         nn = neighbors.size();
 
-         if (na) {
-            cellPtr->getNeighbors(neighbors, reverseUpdateFlag);
-            nn = neighbors.size();
+         // Loop over primary atoms (atom1) in primary cell
+         for (i = 0; i < na; ++i) {
+            atom1Ptr = neighbors[i];
+            maskPtr  = atom1Ptr->maskPtr();
+            if (hasTypeCutoffs_) {
+               rowCutoffSq =
+                     &typeCutoffSq_[atom1Ptr->typeId()*nAtomType];
+            }
+
+            // Loop over secondary atoms
+            hasNeighbor = false;
+            for (j = i + 1; j < nn; ++j) {
+               atom2Ptr = neighbors[j];
+               if (hasTypeCutoffs_) {
+                  cutoffSq = rowCutoffSq[atom2Ptr->typeId()];
+               }
+               dr.subtract(atom2Ptr->position(), atom1Ptr->position());
+               if (dr.square() < cutoffSq
+                   && !maskPtr->isMasked(atom2Ptr->id())
+                   && (!halfShell || Plan::isHalfShellPair(
+                            atom1Ptr->ptr()->plan(),
+                            atom2Ptr->ptr()->plan()))) {
+                  appendAtom2(atom2Ptr->ptr());
+                  hasNeighbor = true;
+               }
+            }
    
-            // Loop over primary atoms (atom1) in primary cell
+            // Complete processing of atom1.
+            if (hasNeighbor) {
+               atom1Ptrs_.append(atom1Ptr->ptr());
+               first_.append(nPair());
+            }
+
+         } // for ia
+      }
+
+      // Add pairs of local atoms in ghost cells with atoms in other ghost
+      // cells. Pairs with atoms in local cells were found above.
+      if (!reverseUpdateFlag && !halfShell && cellList.nDriftCell()) {
+         const Grid& grid = cellList.grid();
+         const Cell* otherPtr;
+         IntVector p, q, qMin, qMax;
+         int nCellCut = cellList.nCellCut();
+         int l, m, d;
+         for (k = 0; k < cellList.nDriftCell(); ++k) {
+            cellPtr = &cellList.driftCell(k);
+            p = grid.position(cellPtr->id());
+            for (d = 0; d < Dimension; ++d) {
+               qMin[d] = p[d] - nCellCut;
+               if (qMin[d] < 0) qMin[d] = 0;
+               qMax[d] = p[d] + nCellCut;
+               if (qMax[d] >= grid.dimension(d)) {
+                  qMax[d] = grid.dimension(d) - 1;
+               }
+            }
+            na = cellPtr->nAtom();
             for (i = 0; i < na; ++i) {
-               atom1Ptr = neighbors[i];
-               maskPtr  = atom1Ptr->maskPtr();
-   
-               // Loop over secondary atoms
+               atom1Ptr = cellPtr->atomPtr(i);
+               if (atom1Ptr->ptr()->isGhost()) continue;
+               maskPtr = atom1Ptr->maskPtr();
+               if (hasTypeCutoffs_) {
+                  rowCutoffSq =
+                        &typeCutoffSq_[atom1Ptr->typeId()*nAtomType];
+               }
                hasNeighbor = false;
-               for (j = i + 1; j < nn; ++j) {
-                  atom2Ptr = neighbors[j];
-                  dr.subtract(atom2Ptr->position(), atom1Ptr->position()); 
-                  if (dr.square() < cutoffSq && !maskPtr->isMasked(atom2Ptr->id())) {
-                     atom2Ptrs_.append(atom2Ptr->ptr());
-                     hasNeighbor = true;
+               for (q[0] = qMin[0]; q[0] <= qMax[0]; ++q[0]) {
+                  for (q[1] = qMin[1]; q[1] <= qMax[1]; ++q[1]) {
+                     for (q[2] = qMin[2]; q[2] <= qMax[2]; ++q[2]) {
+                        otherPtr = &cellList.cell(grid.rank(q));
+                        if (!otherPtr->isGhostCell()) continue;
+                        m = otherPtr->nAtom();
+                        for (l = 0; l < m; ++l) {
+                           atom2Ptr = otherPtr->atomPtr(l);
+                           // Count each pair of local atoms once
+                           if (!atom2Ptr->ptr()->isGhost()) {
+                              if (otherPtr->id() < cellPtr->id()) continue;
+                              if (otherPtr == cellPtr && l <= i) continue;
+                           }
+                           if (hasTypeCutoffs_) {
+                              cutoffSq = rowCutoffSq[atom2Ptr->typeId()];
+                           }
+                           dr.subtract(atom2Ptr->position(),
+                                       atom1Ptr->position());
+                           if (dr.square() < cutoffSq
+                               && !maskPtr->isMasked(atom2Ptr->id())) {
+                              appendAtom2(atom2Ptr->ptr());
+                              hasNeighbor = true;
+                           }
+                        }
+                     }
                   }
                }
-
-               // Complete processing of atom1.
                if (hasNeighbor) {
                   atom1Ptrs_.append(atom1Ptr->ptr());
-                  first_.append(atom2Ptrs_.size());
+                  first_.append(nPair());
                }
-
-            } // for ia 
-         } // if (na)
-
-         // Advance to next cell in a linked list
-         cellPtr = cellPtr->nextCellPtr();
+            }
+         }
       }
 
       // Postconditions
@@ -145,11 +338,26 @@ namespace DdMd
          if (first_[0] != 0) {
             UTIL_THROW("Incorrect first element of first_");
          }
-         if (first_[atom1Ptrs_.size()] != atom2Ptrs_.size()) {
+         if (first_[atom1Ptrs_.size()] != nPair()) {
             UTIL_THROW("Incorrect last element of first_");
          }
       }
 
+      #ifdef DDMD_HUGE_PAGES
+      // Request huge pages for the arrays traversed by force loops
+      if (nPair() > 0) {
+         PageAllocator::advise(&atom1Ptrs_[0],
+                               atom1Ptrs_.capacity()*sizeof(Atom*));
+         if (isCompact_) {
+            PageAllocator::advise(&atom2Ids_[0],
+                                  atom2Ids_.capacity()*sizeof(int));
+         } else {
+            PageAllocator::advise(&atom2Ptrs_[0],
+                                  atom2Ptrs_.capacity()*sizeof(Atom*));
+         }
+      }
+      #endif
+
       // Increment buildCounter_= number of times the list has been built.
       ++buildCounter_;
  
@@ -157,8 +365,8 @@ namespace DdMd
       if (atom1Ptrs_.size() > maxNAtomLocal_) {
          maxNAtomLocal_ = atom1Ptrs_.size();
       }
-      if (atom2Ptrs_.size() > maxNPairLocal_) {
-         maxNPairLocal_ = atom2Ptrs_.size();
+      if (nPair() > maxNPairLocal_) {
+         maxNPairLocal_ = nPair();
       }
    }
 
@@ -169,10 +377,18 @@ namespace DdMd
    {
       if (atom1Ptrs_.size()) {
          iterator.atom1Ptrs_ = &atom1Ptrs_[0];
-         iterator.atom2Ptrs_ = &atom2Ptrs_[0];
+         if (isCompact_) {
+            iterator.atom2Ptrs_ = 0;
+            iterator.atom2Ids_  = &atom2Ids_[0];
+            iterator.atomBases_ = atomBases_;
+         } else {
+            iterator.atom2Ptrs_ = &atom2Ptrs_[0];
+            iterator.atom2Ids_  = 0;
+            iterator.atomBases_ = 0;
+         }
          iterator.first_     = &first_[0];
          iterator.nAtom1_    = atom1Ptrs_.size();
-         iterator.nAtom2_    = atom2Ptrs_.size();
+         iterator.nAtom2_    = nPair();
          iterator.atom1Id_   = 0;
          iterator.atom2Id_   = 0;
       }
@@ -234,4 +450,23 @@ namespace DdMd
                   << std::endl;
    }
 
+   /*
+   * Add memory usage to a report.
+   */
+   void PairList::reportMemory(MemoryReport& report) const
+   {
+      int pairBytes = isCompact_ ? sizeof(int) : sizeof(Atom*);
+      int atomBytes = sizeof(Atom*) + sizeof(int);
+      double allocated = double(atom1Ptrs_.capacity())*sizeof(Atom*)
+                       + double(first_.capacity())*sizeof(int);
+      if (isCompact_) {
+         allocated += double(atom2Ids_.capacity())*sizeof(int);
+      } else {
+         allocated += double(atom2Ptrs_.capacity())*sizeof(Atom*);
+      }
+      double highWater = double(maxNAtomLocal_)*atomBytes
+                       + double(maxNPairLocal_)*pairBytes;
+      report.add("PairList", allocated, highWater);
+   }
+
 } 
@@ -10,6 +10,8 @@
 
 #include "CellList.h"
 #include <util/containers/GArray.h>
+#include <util/containers/DArray.h>
+#include <util/containers/DMatrix.h>
 #include <util/misc/Setable.h>
 #include <util/global.h>
 
@@ -20,6 +22,7 @@ namespace DdMd
 
    class Atom;
    class PairIterator;
+   class MemoryReport;
    
    /**
    * A Verlet nonbonded pair list.
@@ -36,6 +39,19 @@ namespace DdMd
    * A PairIterator object must be used to iterate over all of the pairs in
    * in completed PairList (see documentation of PairIterator for usage).
    *
+   * By default, the secondary atom of each pair is stored as an Atom* 
+   * pointer. If setCompact() is called before allocate(), it is instead
+   * stored as a 32 bit index into the local or ghost AtomArray, which 
+   * halves the memory and bandwidth required for the list of pairs.
+   *
+   * By default, all pairs closer than the pair list cutoff are listed.
+   * If setTypeCutoffs() is called, a pair of atoms of types i and j is
+   * instead listed only if closer than cutoffs(i, j) + skin, in which
+   * skin is the pair list cutoff minus the maximum of cutoffs(i, j).
+   * This avoids listing pairs of types with short cutoffs, e.g., of WCA
+   * interactions in a mixture with longer-range LJ interactions, which
+   * would otherwise fail the force cutoff test in every force loop.
+   *
    * \ingroup DdMd_Neighbor_Module
    */
    class PairList 
@@ -68,6 +84,51 @@ namespace DdMd
       */
       void allocate(int atomCapacity, int pairCapacity, double cutoff);
 
+      /**
+      * Store secondary atoms as 32 bit array indices.
+      *
+      * Must be called before allocate(). All atoms in the list must be 
+      * elements of one of two arrays that begin at localBegin (local
+      * atoms) and ghostBegin (ghost atoms), respectively.
+      *
+      * \param localBegin  address of first element of local atom array
+      * \param ghostBegin  address of first element of ghost atom array
+      */
+      void setCompact(Atom* localBegin, Atom* ghostBegin);
+
+      /**
+      * Update after reallocation of the local and ghost atom arrays.
+      *
+      * Resets the atom capacity used to reserve memory and, if compact,
+      * the addresses from which indices of secondary atoms are computed.
+      * The pair list must be rebuilt before it is used again.
+      *
+      * \param atomCapacity  new capacity for local atoms
+      * \param localBegin  address of first element of local atom array
+      * \param ghostBegin  address of first element of ghost atom array
+      */
+      void resetAtoms(int atomCapacity, Atom* localBegin, Atom* ghostBegin);
+
+      /**
+      * Reset the pair list cutoff.
+      *
+      * The new value takes effect at the next call to build().
+      *
+      * \param cutoff  pair list cutoff = potential cutoff  + skin
+      */
+      void setCutoff(double cutoff);
+
+      /**
+      * Set force cutoffs for pairs of atom types.
+      *
+      * The list cutoff of a pair of types i, j becomes cutoffs(i, j)
+      * plus the skin, i.e., the pair list cutoff minus the maximum
+      * element of cutoffs. Takes effect at the next call to build().
+      *
+      * \param cutoffs  square matrix of force cutoffs, nAtomType x nAtomType
+      */
+      void setTypeCutoffs(const DMatrix<double>& cutoffs);
+
       /**
       * Reset this to empty state.
       */  
@@ -76,10 +137,24 @@ namespace DdMd
       /**
       * Use a CellList to build a new PairList.
       *
+      * If halfShell is true, the CellList must have been allocated after
+      * a call to CellList::setHalfShell(true), and ghosts must carry image
+      * flags and masks. Upper ghost cells are then also used as primary
+      * cells, and only pairs that satisfy Plan::isHalfShellPair() are
+      * added, so that a primary atom may be a ghost.
+      *
+      * If reverseUpdateFlag and halfShell are both false, local atoms that
+      * lie in ghost cells (see CellList::driftCell()) are also treated as
+      * primary atoms, and are paired with the ghost cell atoms within the
+      * cutoff. Pairs are thus complete after a cell list rebuild in which
+      * local atoms have drifted out of the domain without an exchange.
+      *
       * \param cellList      a CellList object that was just built.
       * \param reverseUpdateFlag is reverse communication enabled?
+      * \param halfShell     is the half-shell ghost scheme enabled?
       */
-      void build(CellList& cellList, bool reverseUpdateFlag = false);
+      void build(CellList& cellList, bool reverseUpdateFlag = false,
+                 bool halfShell = false);
 
       //@}
       /// \name Accessors (miscellaneous)
@@ -102,6 +177,39 @@ namespace DdMd
       */
       int nPair() const;
 
+      /**
+      * Get a pointer to primary atom i, for 0 <= i < nAtom().
+      *
+      * \param i index of primary atom
+      */
+      Atom* atom1Ptr(int i) const;
+
+      /**
+      * Get a pointer to secondary atom j, for 0 <= j < nPair().
+      *
+      * \param j index of pair
+      */
+      Atom* atom2Ptr(int j) const;
+
+      /**
+      * Prefetch secondary atom j into cache, if j < nPair().
+      *
+      * Does nothing unless compiled with a GNU compatible compiler.
+      *
+      * \param j index of pair
+      */
+      void prefetchAtom2(int j) const;
+
+      /**
+      * Get index of first pair of primary atom i, for 0 <= i <= nAtom().
+      *
+      * Pairs of primary atom i have indices first(i) <= j < first(i+1).
+      * This provides random access to the list, e.g., for threading.
+      *
+      * \param i index of primary atom
+      */
+      int first(int i) const;
+
       /**
       * Get the maximum number of pairs. 
       */
@@ -116,6 +224,11 @@ namespace DdMd
       * Has memory been allocated for this PairList?
       */
       bool isAllocated() const;
+
+      /**
+      * Are secondary atoms stored as array indices (see setCompact)?
+      */
+      bool isCompact() const;
  
       //@}
       /// \name Statistics
@@ -165,6 +278,16 @@ namespace DdMd
       */
       int buildCounter() const;
 
+      /**
+      * Add memory usage to a report, as entry "PairList".
+      *
+      * The high-water mark is computed from the maximum numbers of
+      * primary atoms and pairs on this processor.
+      *
+      * \param report report to which an entry is added
+      */
+      void reportMemory(MemoryReport& report) const;
+
       //@}
 
    private:
@@ -175,11 +298,26 @@ namespace DdMd
       /// Array of pointers to neighbor (or secondary) atom in each pair.
       GArray<Atom*>  atom2Ptrs_;  
 
+      /// Encoded array indices of secondary atoms (compact lists only).
+      GArray<int>  atom2Ids_;  
+
+      /// Addresses of first local [0] and first ghost [1] atoms.
+      Atom*  atomBases_[2];
+
       /// Array of indices in atom2Ptrs_ of first neighbor of an Atom.
       GArray<int>  first_; 
 
       /// Pair list cutoff radius (pair potential cutoff + skin_).
       double cutoff_;
+
+      /// Force cutoffs for pairs of types (if hasTypeCutoffs_).
+      DMatrix<double> typeCutoffs_;
+
+      /// Squared list cutoffs, element i*nAtomType + j (set in build).
+      DArray<double> typeCutoffSq_;
+
+      /// Maximum element of typeCutoffs_.
+      double maxTypeCutoff_;
    
       /// Maximum number of atoms (dimension of atom1Ptrs_).
       int  atomCapacity_;     
@@ -204,6 +342,25 @@ namespace DdMd
    
       /// Has memory been allocated?
       bool  isAllocated_;
+
+      /// Are secondary atoms stored in atom2Ids_ rather than atom2Ptrs_?
+      bool  isCompact_;
+
+      /// Do list cutoffs depend on atom types?
+      bool  hasTypeCutoffs_;
+
+      /**
+      * Append a secondary atom to atom2Ptrs_ or atom2Ids_.
+      */
+      void appendAtom2(Atom* atomPtr);
+
+      /**
+      * Decode an element of atom2Ids_.
+      *
+      * The high bit of an encoded index is set for ghost atoms, and the
+      * remaining bits are the index within the local or ghost array.
+      */
+      Atom* decodeAtom2(int id) const;
   
       /* 
       * Implementation Notes:
@@ -245,6 +402,9 @@ namespace DdMd
       * Note that GArray<int> first_ contains one more elements than 
       * atom1Ptrs_. The element first_[0] is equal to 0, and the last 
       * element is always equal to the total number of pairs.
+      * In a compact list, atom2Ptrs_ is empty, and the secondary atoms
+      * are instead stored as encoded indices in atom2Ids_, with the same
+      * layout. Atom2 pointers are then obtained with decodeAtom2().
       */
 
    }; 
@@ -259,7 +419,43 @@ namespace DdMd
    * Get the current number of pairs.
    */ 
    inline int PairList::nPair() const
-   {  return atom2Ptrs_.size(); }
+   {  return isCompact_ ? atom2Ids_.size() : atom2Ptrs_.size(); }
+
+   /*
+   * Decode a compact secondary atom index (private).
+   */ 
+   inline Atom* PairList::decodeAtom2(int id) const
+   {  return atomBases_[(unsigned int)id >> 31] + (id & 0x7FFFFFFF); }
+
+   /*
+   * Get a pointer to primary atom i.
+   */ 
+   inline Atom* PairList::atom1Ptr(int i) const
+   {  return atom1Ptrs_[i]; }
+
+   /*
+   * Get a pointer to secondary atom j.
+   */ 
+   inline Atom* PairList::atom2Ptr(int j) const
+   {  return isCompact_ ? decodeAtom2(atom2Ids_[j]) : atom2Ptrs_[j]; }
+
+   /*
+   * Prefetch secondary atom j, if it exists.
+   */
+   inline void PairList::prefetchAtom2(int j) const
+   {
+      #ifdef __GNUC__
+      if (j < nPair()) {
+         __builtin_prefetch(atom2Ptr(j));
+      }
+      #endif
+   }
+
+   /*
+   * Get index of first pair of primary atom i.
+   */ 
+   inline int PairList::first(int i) const
+   {  return first_[i]; }
 
    /**
    * Get the maximum number of pairs. 
@@ -297,5 +493,11 @@ namespace DdMd
    inline bool PairList::isAllocated() const
    { return isAllocated_; }
 
+   /*
+   * Are secondary atoms stored as array indices?
+   */ 
+   inline bool PairList::isCompact() const
+   { return isCompact_; }
+
 } 
 #endif
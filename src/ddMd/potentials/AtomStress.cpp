@@ -0,0 +1,114 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AtomStress.h"
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   AtomStress::AtomStress()
+    : localEnergies_(),
+      ghostEnergies_(),
+      localVirials_(),
+      ghostVirials_(),
+      storagePtr_(0),
+      step_(-1),
+      interval_(0),
+      isActive_(false)
+   {}
+
+   /*
+   * Destructor.
+   */
+   AtomStress::~AtomStress()
+   {}
+
+   /*
+   * Create association with AtomStorage.
+   */
+   void AtomStress::associate(AtomStorage& storage)
+   {  storagePtr_ = &storage; }
+
+   /*
+   * Request per-atom values at an interval.
+   */
+   void AtomStress::request(int interval)
+   {
+      if (interval <= 0) {
+         UTIL_THROW("Non-positive interval");
+      }
+      if (interval_ == 0) {
+         interval_ = interval;
+      } else {
+         // Greatest common divisor of old and new intervals
+         int a = interval_;
+         int b = interval;
+         int r;
+         while (b != 0) {
+            r = a % b;
+            a = b;
+            b = r;
+         }
+         interval_ = a;
+      }
+   }
+
+   /*
+   * Zero all values and activate accumulation.
+   */
+   void AtomStress::begin(long iStep)
+   {
+      if (!storagePtr_) {
+         UTIL_THROW("AtomStress is not associated with an AtomStorage");
+      }
+      int atomCapacity = storagePtr_->atomCapacity();
+      int ghostCapacity = storagePtr_->ghostCapacity();
+      allocateArray(localEnergies_, atomCapacity);
+      allocateArray(ghostEnergies_, ghostCapacity);
+      allocateArray(localVirials_, atomCapacity);
+      allocateArray(ghostVirials_, ghostCapacity);
+      int i;
+      for (i = 0; i < atomCapacity; ++i) {
+         localEnergies_[i] = 0.0;
+         localVirials_[i].zero();
+      }
+      for (i = 0; i < ghostCapacity; ++i) {
+         ghostEnergies_[i] = 0.0;
+         ghostVirials_[i].zero();
+      }
+      step_ = iStep;
+      isActive_ = true;
+   }
+
+   /*
+   * Deactivate accumulation.
+   */
+   void AtomStress::end()
+   {  isActive_ = false; }
+
+   /*
+   * Allocate or reallocate array to a capacity, if needed (private).
+   */
+   template <typename T>
+   void AtomStress::allocateArray(DArray<T>& array, int capacity)
+   {
+      if (array.isAllocated()) {
+         if (array.capacity() != capacity) {
+            array.deallocate();
+         }
+      }
+      if (!array.isAllocated()) {
+         array.allocate(capacity);
+      }
+   }
+
+}
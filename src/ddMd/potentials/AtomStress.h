@@ -0,0 +1,301 @@
+#ifndef DDMD_ATOM_STRESS_H
+#define DDMD_ATOM_STRESS_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/chemistry/Atom.h>                // inline functions
+#include <ddMd/storage/AtomStorage.h>           // inline functions
+#include <util/containers/DArray.h>             // member template
+#include <util/space/Vector.h>                  // argument
+#include <util/space/Tensor.h>                  // member template param
+#include <util/global.h>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Per-atom potential energies and virials, for local stress analysis.
+   *
+   * An AtomStress holds one energy and one virial tensor for each local
+   * and ghost atom slot of an AtomStorage, indexed by the index given by
+   * AtomStorage::arrayIndex(). The virial of an atom is its share of the
+   * sums of dyads f dr used by Potential::incrementPairStress(), which
+   * are not divided by volume: Each pair contributes half of its energy
+   * and virial to each member, and each covalent group of n atoms an
+   * equal fraction 1/n of its energy and virial to each member.
+   *
+   * Accumulation is done within the force and stress loops of the
+   * potential classes, only while the object is active, i.e., between
+   * calls to begin() and end(). An integrator activates it for force
+   * calculations after which an analyzer will sample, at an interval
+   * set by request(). After a force calculation with reverse
+   * communication, Exchanger::reverseUpdate(AtomStress&) adds values
+   * accumulated for ghosts to those of their owners. Values are only
+   * meaningful for local atoms, and remain valid until atoms are
+   * exchanged or reordered.
+   *
+   * \ingroup DdMd_Potential_Module
+   */
+   class AtomStress
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      AtomStress();
+
+      /**
+      * Destructor.
+      */
+      ~AtomStress();
+
+      /**
+      * Create an association with the AtomStorage.
+      *
+      * \param storage AtomStorage that owns the atoms
+      */
+      void associate(AtomStorage& storage);
+
+      /**
+      * Request per-atom values on steps that are multiples of interval.
+      *
+      * If several requests are made, values are computed at the
+      * greatest common divisor of the requested intervals.
+      *
+      * \param interval number of steps between computations (> 0)
+      */
+      void request(int interval);
+
+      /**
+      * Have per-atom values been requested?
+      */
+      bool isRequested() const;
+
+      /**
+      * Interval requested for per-atom values (0 if not requested).
+      */
+      int interval() const;
+
+      /**
+      * Zero all values and activate accumulation.
+      *
+      * Allocates or reallocates arrays if needed, to the current
+      * capacities of the AtomStorage.
+      *
+      * \param iStep step at which the values will be sampled
+      */
+      void begin(long iStep);
+
+      /**
+      * Deactivate accumulation.
+      */
+      void end();
+
+      /**
+      * Is accumulation active?
+      */
+      bool isActive() const;
+
+      /**
+      * Step index given to the last call of begin() (-1 if none).
+      */
+      long step() const;
+
+      /// \name Accumulation (only while active)
+      //@{
+
+      /**
+      * Add contributions of one pair to both atoms.
+      *
+      * Adds half of the energy and of the dyad f dr to each atom. If
+      * addGhosts is false, contributions to ghosts are discarded.
+      *
+      * \param atom0     first atom
+      * \param atom1     second atom
+      * \param energy    pair energy
+      * \param f         force on atom0
+      * \param dr        separation r0 - r1
+      * \param addGhosts if true, also add to ghost atoms
+      */
+      void addPair(const Atom& atom0, const Atom& atom1, double energy,
+                   const Vector& f, const Vector& dr, bool addGhosts);
+
+      /**
+      * Add equal fractions of a group energy and virial to local members.
+      *
+      * Each of the N atoms gets energy/N and virial/N. Ghosts are
+      * skipped, because every processor that owns a member of a
+      * covalent group computes its interactions.
+      *
+      * \param atomPtrs pointers to the N atoms of the group
+      * \param energy   energy of the group
+      * \param virial   virial of the group
+      */
+      template <int N>
+      void addGroup(Atom* const (&atomPtrs)[N], double energy,
+                    const Tensor& virial);
+
+      //@}
+      /// \name Accessors
+      //@{
+
+      /**
+      * Get the energy of a local or ghost atom.
+      */
+      double& energy(const Atom& atom);
+
+      /**
+      * Get the virial of a local or ghost atom.
+      */
+      Tensor& virial(const Atom& atom);
+
+      /**
+      * Get the energy of a local or ghost atom by const reference.
+      */
+      const double& energy(const Atom& atom) const;
+
+      /**
+      * Get the virial of a local or ghost atom by const reference.
+      */
+      const Tensor& virial(const Atom& atom) const;
+
+      //@}
+
+   private:
+
+      /// Energies of local atoms.
+      DArray<double> localEnergies_;
+
+      /// Energies of ghost atoms.
+      DArray<double> ghostEnergies_;
+
+      /// Virials of local atoms.
+      DArray<Tensor> localVirials_;
+
+      /// Virials of ghost atoms.
+      DArray<Tensor> ghostVirials_;
+
+      /// Pointer to associated AtomStorage.
+      AtomStorage* storagePtr_;
+
+      /// Step index of the last call to begin().
+      long step_;
+
+      /// Requested interval (0 if none).
+      int interval_;
+
+      /// Is accumulation active?
+      bool isActive_;
+
+      /// Allocate or reallocate array to a capacity, if needed.
+      template <typename T>
+      static void allocateArray(DArray<T>& array, int capacity);
+
+   };
+
+   // Inline functions
+
+   inline bool AtomStress::isRequested() const
+   {  return (interval_ > 0); }
+
+   inline int AtomStress::interval() const
+   {  return interval_; }
+
+   inline bool AtomStress::isActive() const
+   {  return isActive_; }
+
+   inline long AtomStress::step() const
+   {  return step_; }
+
+   inline double& AtomStress::energy(const Atom& atom)
+   {
+      if (atom.isGhost()) {
+         return ghostEnergies_[storagePtr_->arrayIndex(atom)];
+      } else {
+         return localEnergies_[storagePtr_->arrayIndex(atom)];
+      }
+   }
+
+   inline const double& AtomStress::energy(const Atom& atom) const
+   {
+      if (atom.isGhost()) {
+         return ghostEnergies_[storagePtr_->arrayIndex(atom)];
+      } else {
+         return localEnergies_[storagePtr_->arrayIndex(atom)];
+      }
+   }
+
+   inline Tensor& AtomStress::virial(const Atom& atom)
+   {
+      if (atom.isGhost()) {
+         return ghostVirials_[storagePtr_->arrayIndex(atom)];
+      } else {
+         return localVirials_[storagePtr_->arrayIndex(atom)];
+      }
+   }
+
+   inline const Tensor& AtomStress::virial(const Atom& atom) const
+   {
+      if (atom.isGhost()) {
+         return ghostVirials_[storagePtr_->arrayIndex(atom)];
+      } else {
+         return localVirials_[storagePtr_->arrayIndex(atom)];
+      }
+   }
+
+   /*
+   * Add half of pair energy and virial to each atom.
+   */
+   inline
+   void AtomStress::addPair(const Atom& atom0, const Atom& atom1,
+                            double energy, const Vector& f,
+                            const Vector& dr, bool addGhosts)
+   {
+      double halfEnergy = 0.5*energy;
+      Tensor w;
+      int i, j;
+      for (i = 0; i < Dimension; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            w(i, j) = 0.5*f[i]*dr[j];
+         }
+      }
+      if (addGhosts || !atom0.isGhost()) {
+         AtomStress::energy(atom0) += halfEnergy;
+         virial(atom0) += w;
+      }
+      if (addGhosts || !atom1.isGhost()) {
+         AtomStress::energy(atom1) += halfEnergy;
+         virial(atom1) += w;
+      }
+   }
+
+   /*
+   * Add equal fractions of group energy and virial to local atoms.
+   */
+   template <int N>
+   inline
+   void AtomStress::addGroup(Atom* const (&atomPtrs)[N], double energy,
+                             const Tensor& virial)
+   {
+      double fraction = 1.0/double(N);
+      Tensor w(virial);
+      w *= fraction;
+      for (int k = 0; k < N; ++k) {
+         if (!atomPtrs[k]->isGhost()) {
+            AtomStress::energy(*atomPtrs[k]) += fraction*energy;
+            AtomStress::virial(*atomPtrs[k]) += w;
+         }
+      }
+   }
+
+}
+#endif
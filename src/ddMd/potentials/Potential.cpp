@@ -1,4 +1,6 @@
 #include "Potential.h"
+#include "AtomStress.h"
+#include <util/global.h>
 
 /*
 * Simpatico - Simulation Package for Polymeric and Molecular Liquids
@@ -18,7 +20,15 @@ namespace DdMd
    Potential::Potential()
     : stress_(),
       energy_(),
-      reverseUpdateFlag_(false)
+      #ifdef UTIL_MPI
+      localEnergy_(0.0),
+      localStress_(),
+      isDeferred_(false),
+      hasLocalEnergy_(false),
+      hasLocalStress_(false),
+      #endif
+      reverseUpdateFlag_(false),
+      atomStressPtr_(0)
    { setClassName("Potential"); }
 
    /*
@@ -33,6 +43,23 @@ namespace DdMd
    void Potential::setReverseUpdateFlag(bool reverseUpdateFlag)
    { reverseUpdateFlag_ = reverseUpdateFlag; }
 
+   /*
+   * Set the associated per-atom energy and virial accumulator.
+   */
+   void Potential::setAtomStress(AtomStress& atomStress)
+   {  atomStressPtr_ = &atomStress; }
+
+   /*
+   * Return pointer to AtomStress if active, or null (protected).
+   */
+   AtomStress* Potential::activeAtomStress() const
+   {
+      if (atomStressPtr_ && atomStressPtr_->isActive()) {
+         return atomStressPtr_;
+      }
+      return 0;
+   }
+
    /*
    * Get the value of the total energy.
    */
@@ -113,6 +140,34 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Compute atomic forces, energy and (optionally) stress.
+   * 
+   * Default implementation calls separate force and energy methods.
+   */
+   #ifdef UTIL_MPI
+   void Potential::computeForcesAndEnergy(MPI::Intracomm& communicator,
+                                          bool needStress)
+   {
+      if (needStress) {
+         computeForcesAndStress(communicator);
+      } else {
+         computeForces();
+      }
+      computeEnergy(communicator);
+   }
+   #else
+   void Potential::computeForcesAndEnergy(bool needStress)
+   {
+      if (needStress) {
+         computeForcesAndStress();
+      } else {
+         computeForces();
+      }
+      computeEnergy();
+   }
+   #endif
+
    /*
    * Reduce energy from all processors.
    */
@@ -123,6 +178,11 @@ namespace DdMd
    #endif
    {
       #ifdef UTIL_MPI
+      if (isDeferred_) {
+         localEnergy_ = localEnergy;
+         hasLocalEnergy_ = true;
+         return;
+      }
       double totalEnergy = 0.0; 
       communicator.Reduce(&localEnergy, &totalEnergy, 1, 
                           MPI::DOUBLE, MPI::SUM, 0);
@@ -145,6 +205,11 @@ namespace DdMd
    #endif
    {
       #ifdef UTIL_MPI
+      if (isDeferred_) {
+         localStress_ = localStress;
+         hasLocalStress_ = true;
+         return;
+      }
       Tensor totalStress;
       communicator.Reduce(&localStress(0,0), &totalStress(0,0), 
                           Dimension*Dimension, MPI::DOUBLE, MPI::SUM, 0);
@@ -158,6 +223,67 @@ namespace DdMd
    }
 
    #ifdef UTIL_MPI
+   /*
+   * Defer reduction of energy and stress.
+   */
+   void Potential::deferReduction()
+   {
+      isDeferred_ = true;
+      hasLocalEnergy_ = false;
+      hasLocalStress_ = false;
+   }
+
+   /*
+   * Copy deferred local energy and stress into a buffer.
+   */
+   int Potential::packDeferred(double* buffer) const
+   {
+      UTIL_CHECK(isDeferred_);
+      int n = 0;
+      if (hasLocalEnergy_) {
+         buffer[n] = localEnergy_;
+         ++n;
+      }
+      if (hasLocalStress_) {
+         int i, j;
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               buffer[n] = localStress_(i, j);
+               ++n;
+            }
+         }
+      }
+      return n;
+   }
+
+   /*
+   * Set total energy and stress from reduced values, end deferral.
+   */
+   int Potential::unpackDeferred(const double* buffer)
+   {
+      UTIL_CHECK(isDeferred_);
+      int n = 0;
+      if (hasLocalEnergy_) {
+         setEnergy(buffer[n]);
+         ++n;
+      }
+      if (hasLocalStress_) {
+         Tensor stress;
+         int i, j;
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               stress(i, j) = buffer[n];
+               ++n;
+            }
+         }
+         setStress(stress);
+      }
+      isDeferred_ = false;
+      hasLocalEnergy_ = false;
+      hasLocalStress_ = false;
+      return n;
+   }
+
    /*
    * Is the potential in a valid internal state?
    */
@@ -15,6 +15,8 @@
 namespace DdMd
 {
 
+   class AtomStress;
+
    using namespace Util;
 
    /**
@@ -52,6 +54,16 @@ namespace DdMd
       */
       bool reverseUpdateFlag() const;
 
+      /**
+      * Set the AtomStress used to accumulate per-atom energy and virial.
+      *
+      * Per-atom contributions are accumulated by force and stress
+      * calculations only while this object is active.
+      *
+      * \param atomStress per-atom energy and virial accumulator
+      */
+      void setAtomStress(AtomStress& atomStress);
+
       /// \name Total Energy, Force and Stress 
       //@{
 
@@ -120,6 +132,24 @@ namespace DdMd
       virtual void computeForcesAndStress();
       #endif
 
+      /**
+      * Compute forces and energy, and optionally stress, for all processors.
+      * 
+      * Call on all processors. This is used on steps after which the
+      * energy will be sampled. The default implementation calls
+      * computeForces() or computeForcesAndStress(), followed by 
+      * computeEnergy(). Subclasses may combine these into a single loop.
+      *
+      * \param communicator domain communicator
+      * \param needStress   if true, also compute the stress
+      */
+      #ifdef UTIL_MPI
+      virtual void computeForcesAndEnergy(MPI::Intracomm& communicator,
+                                          bool needStress);
+      #else
+      virtual void computeForcesAndEnergy(bool needStress);
+      #endif
+
       /**
       * Return the stress tensor.
       *
@@ -161,6 +191,50 @@ namespace DdMd
       #endif
 
       //@}
+      #ifdef UTIL_MPI
+      /// \name Deferred Reduction
+      //@{
+
+      /**
+      * Defer reduction of energy and stress values.
+      *
+      * After this is called, the next calls to computeEnergy() and
+      * computeStress() compute and store contributions from this 
+      * processor, but do not communicate. The local values may then 
+      * be packed into a buffer, summed over processors along with 
+      * other quantities in a single reduction, and unpacked. This is 
+      * used by Simulation::computeThermo() to reduce latency.
+      *
+      * Call on all processors.
+      */
+      void deferReduction();
+
+      /**
+      * Copy deferred local values into a buffer.
+      *
+      * Writes the local energy, if computed since deferReduction() was
+      * called, followed by the Dimension*Dimension elements of the local 
+      * stress, if computed.
+      *
+      * \param buffer  location of first element to write (output)
+      * \return number of elements written
+      */
+      int packDeferred(double* buffer) const;
+
+      /**
+      * Set totals from a buffer of reduced values, end deferral.
+      *
+      * Elements must be in the order written by packDeferred(). Values
+      * are only meaningful on the master processor, but this must be 
+      * called on all processors.
+      *
+      * \param buffer  location of first element to read
+      * \return number of elements read
+      */
+      int unpackDeferred(const double* buffer);
+
+      //@}
+      #endif
 
    protected:
 
@@ -212,6 +286,11 @@ namespace DdMd
       void reduceStress();
       #endif
 
+      /**
+      * Return a pointer to the AtomStress if it is active, or null.
+      */
+      AtomStress* activeAtomStress() const;
+
    private:
 
       /// Total stress.
@@ -220,9 +299,29 @@ namespace DdMd
       /// Total energy.
       Setable<double> energy_;
 
+      #ifdef UTIL_MPI
+      /// Energy contribution of this processor, if deferred.
+      double localEnergy_;
+
+      /// Stress contribution of this processor, if deferred.
+      Tensor localStress_;
+
+      /// Has reduction been deferred by deferReduction()?
+      bool isDeferred_;
+
+      /// Has a local energy been stored since deferReduction()?
+      bool hasLocalEnergy_;
+
+      /// Has a local stress been stored since deferReduction()?
+      bool hasLocalStress_;
+      #endif
+
       /// Is reverse update communication enabled?
       bool reverseUpdateFlag_;
 
+      /// Pointer to associated per-atom accumulator, if any.
+      AtomStress* atomStressPtr_;
+
    };
 
    inline bool Potential::reverseUpdateFlag() const
@@ -18,6 +18,9 @@ namespace DdMd
    AnglePotential::AnglePotential(Simulation& simulation)
     : boundaryPtr_(&simulation.boundary()),
       storagePtr_(&simulation.angleStorage())
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(&simulation.atomStorage())
+      #endif
    { setClassName("AnglePotential"); }
 
    /*
@@ -26,6 +29,9 @@ namespace DdMd
    AnglePotential::AnglePotential()
     : boundaryPtr_(0),
       storagePtr_(0)
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(0)
+      #endif
    { setClassName("AnglePotential"); }
 
    /*
@@ -19,6 +19,7 @@ namespace DdMd
    using namespace Util;
 
    class Simulation;
+   class AtomStorage;
    template <int N> class GroupStorage;
 
    /**
@@ -125,6 +126,15 @@ namespace DdMd
       */
       GroupStorage<3>& storage() const;
 
+      #ifdef DDMD_OPENMP
+      /**
+      *  Return pointer to the atom storage (null if not associated).
+      *
+      *  Used to access per-thread force accumulators.
+      */
+      AtomStorage* atomStoragePtr() const;
+      #endif
+
    private:
 
       // Pointer to associated Boundary object.
@@ -133,6 +143,11 @@ namespace DdMd
       // Pointer to associated GroupStorage<3> object.
       GroupStorage<3>* storagePtr_;
 
+      #ifdef DDMD_OPENMP
+      // Pointer to associated AtomStorage object (null in unit tests).
+      AtomStorage* atomStoragePtr_;
+      #endif
+
    };
 
    // Get boundary by reference.
@@ -143,5 +158,10 @@ namespace DdMd
    inline GroupStorage<3>& AnglePotential::storage() const
    { return *storagePtr_; }
 
+   #ifdef DDMD_OPENMP
+   inline AtomStorage* AnglePotential::atomStoragePtr() const
+   { return atomStoragePtr_; }
+   #endif
+
 }
 #endif
@@ -163,7 +163,9 @@ namespace DdMd
       /**
       * Compute the covalent bond stress.
       * 
-      * Call on all processors.
+      * If an associated AtomStress is active, this also adds per-atom
+      * angle energies and virials to it, and recomputes the stress even
+      * if it is already set. Call on all processors.
       */
       #ifdef UTIL_MPI
       virtual void computeStress(MPI::Intracomm& communicator);
@@ -185,12 +187,20 @@ namespace DdMd
       */
       bool isInitialized_;
 
+      #ifdef DDMD_OPENMP
+      /**
+      * Compute forces using OpenMP threads and per-thread accumulators.
+      */
+      void computeForcesThreaded();
+      #endif
+
    };
 
 }
 
 #include "AnglePotential.h"
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/AtomStress.h>
 #include <ddMd/storage/GroupStorage.h>
 #include <ddMd/storage/GroupIterator.h>
 
@@ -202,6 +212,11 @@ namespace DdMd
 
 #include <fstream>
 
+#ifdef DDMD_OPENMP
+#include <ddMd/storage/AtomStorage.h>
+#include <omp.h>
+#endif
+
 namespace DdMd
 {
 
@@ -338,6 +353,13 @@ namespace DdMd
       Atom* atom2Ptr;
       int   type;
 
+      #ifdef DDMD_OPENMP
+      if (atomStoragePtr()) {
+         computeForcesThreaded();
+         return;
+      }
+      #endif
+
       storage().begin(iter);
       for ( ; iter.notEnd(); ++iter) {
          type = iter->typeId();
@@ -363,6 +385,56 @@ namespace DdMd
       }
    }
 
+   #ifdef DDMD_OPENMP
+   /*
+   * Add angle forces to atomic forces, using threads (private).
+   */
+   template <class Interaction>
+   void AnglePotentialImpl<Interaction>::computeForcesThreaded()
+   {  
+      AtomStorage& atomStorage = *atomStoragePtr();
+      GroupStorage<3>& angleStorage = storage();
+      const int nAngle = angleStorage.size();
+      atomStorage.beginThreadForces();
+
+      #pragma omp parallel
+      {
+         Vector dr1, dr2, f1, f2, df;
+         Atom* atom0Ptr;
+         Atom* atom1Ptr;
+         Atom* atom2Ptr;
+         int   i, type;
+         const int t = omp_get_thread_num();
+
+         #pragma omp for schedule(static)
+         for (i = 0; i < nAngle; ++i) {
+            Group<3>& angle = angleStorage.group(i);
+            type = angle.typeId();
+            atom0Ptr = angle.atomPtr(0);
+            atom1Ptr = angle.atomPtr(1);
+            atom2Ptr = angle.atomPtr(2);
+            boundary().distanceSq(atom1Ptr->position(),
+                                  atom0Ptr->position(), dr1);
+            boundary().distanceSq(atom2Ptr->position(),
+                                  atom1Ptr->position(), dr2);
+            interaction().force(dr1, dr2, f1, f2, type);
+            if (!atom0Ptr->isGhost()) {
+               atomStorage.addThreadForce(t, *atom0Ptr, f1);
+            }
+            if (!atom1Ptr->isGhost()) {
+               df.subtract(f2, f1);
+               atomStorage.addThreadForce(t, *atom1Ptr, df);
+            }
+            if (!atom2Ptr->isGhost()) {
+               atomStorage.subtractThreadForce(t, *atom2Ptr, f2);
+            }
+         }
+      } // omp parallel
+
+      atomStorage.endThreadForces(false);
+   }
+   #endif
+
    /*
    * Compute total angle energy on all processors.
    */
@@ -425,13 +497,16 @@ namespace DdMd
    void AnglePotentialImpl<Interaction>::computeStress()
    #endif
    {
-      // Do nothing and return if stress is already set.
-      if (isStressSet()) return;
+      // Do nothing and return if stress is already set, unless
+      // per-atom contributions are needed
+      AtomStress* atomStressPtr = activeAtomStress();
+      if (isStressSet() && !atomStressPtr) return;
  
       Tensor localStress;
+      Tensor virial;
       Vector dr1, dr2;
       Vector f1, f2;
-      double factor;
+      double factor, cosTheta;
       double prefactor = -1.0/3.0;
       GroupIterator<3> iter;
       Atom*  atom0Ptr;
@@ -456,6 +531,19 @@ namespace DdMd
          // Calculate derivatives f1, f2 of energy with respect to dr1, dr2
          interaction().force(dr1, dr2, f1, f2, type);
 
+         // Add shares of group energy and virial to local atoms
+         if (atomStressPtr) {
+            Atom* atomPtrs[3] = {atom0Ptr, atom1Ptr, atom2Ptr};
+            cosTheta = dr1.dot(dr2) / sqrt(dr1.square()*dr2.square());
+            virial.zero();
+            incrementPairStress(f1, dr1, virial);
+            incrementPairStress(f2, dr2, virial);
+            virial *= -1.0;
+            atomStressPtr->addGroup(atomPtrs,
+                                    interaction().energy(cosTheta, type),
+                                    virial);
+         }
+
          isLocal0 = !(atom0Ptr->isGhost());
          isLocal1 = !(atom1Ptr->isGhost());
          isLocal2 = !(atom2Ptr->isGhost());
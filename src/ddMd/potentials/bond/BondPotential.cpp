@@ -18,6 +18,9 @@ namespace DdMd
    BondPotential::BondPotential(Simulation& simulation)
     : boundaryPtr_(&simulation.boundary()),
       storagePtr_(&simulation.bondStorage())
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(&simulation.atomStorage())
+      #endif
    {  setClassName("BondPotential"); }
 
    /*
@@ -26,6 +29,9 @@ namespace DdMd
    BondPotential::BondPotential()
     : boundaryPtr_(0),
       storagePtr_(0)
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(0)
+      #endif
    {  setClassName("BondPotential"); }
 
    /*
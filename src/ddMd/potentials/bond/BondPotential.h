@@ -19,6 +19,7 @@ namespace DdMd
    using namespace Util;
 
    class Simulation;
+   class AtomStorage;
    template <int N> class GroupStorage;
 
    /**
@@ -146,6 +147,15 @@ namespace DdMd
       */
       GroupStorage<2>& storage() const;
 
+      #ifdef DDMD_OPENMP
+      /**
+      *  Return pointer to the atom storage (null if not associated).
+      *
+      *  Used to access per-thread force accumulators.
+      */
+      AtomStorage* atomStoragePtr() const;
+      #endif
+
    private:
 
       // Pointer to associated Boundary object.
@@ -154,6 +164,11 @@ namespace DdMd
       // Pointer to associated GroupStorage<2> object.
       GroupStorage<2>* storagePtr_;
 
+      #ifdef DDMD_OPENMP
+      // Pointer to associated AtomStorage object (null in unit tests).
+      AtomStorage* atomStoragePtr_;
+      #endif
+
    };
 
    inline Boundary& BondPotential::boundary() const
@@ -162,5 +177,10 @@ namespace DdMd
    inline GroupStorage<2>& BondPotential::storage() const
    { return *storagePtr_; }
 
+   #ifdef DDMD_OPENMP
+   inline AtomStorage* BondPotential::atomStoragePtr() const
+   { return atomStoragePtr_; }
+   #endif
+
 }
 #endif
@@ -11,6 +11,9 @@
 #include <util/global.h>
 #include "BondPotential.h" // base class
 
+// Block size used in blocked bond force calculation
+#define BOND_BLOCK_SIZE 32
+
 namespace DdMd
 {
 
@@ -179,7 +182,8 @@ namespace DdMd
       /**
       * Compute bond forces and stress.
       * 
-      * Call on all processors.
+      * If an associated AtomStress is active, this also adds per-atom
+      * bond energies and virials to it. Call on all processors.
       */
       #ifdef UTIL_MPI
       virtual void computeForcesAndStress(MPI::Intracomm& communicator);
@@ -206,12 +210,30 @@ namespace DdMd
       */
       bool isInitialized_;
 
+      #ifdef BOND_BLOCK_SIZE
+      // Structure-of-arrays work space for blocked force calculation.
+      Vector blockDr_[BOND_BLOCK_SIZE];     ///< Separation vectors.
+      double blockRsq_[BOND_BLOCK_SIZE];    ///< Squared separations.
+      double blockForce_[BOND_BLOCK_SIZE];  ///< Values of forceOverR.
+      Atom*  blockPtr0_[BOND_BLOCK_SIZE];   ///< Pointers to atom 0.
+      Atom*  blockPtr1_[BOND_BLOCK_SIZE];   ///< Pointers to atom 1.
+      int    blockType_[BOND_BLOCK_SIZE];   ///< Bond type ids.
+      #endif
+
+      #ifdef DDMD_OPENMP
+      /**
+      * Compute forces using OpenMP threads and per-thread accumulators.
+      */
+      void computeForcesThreaded();
+      #endif
+
    };
 
 }
 
 #include "BondPotential.h"
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/AtomStress.h>
 #include <ddMd/storage/GroupStorage.h>
 #include <ddMd/storage/GroupIterator.h>
 #include <util/boundary/Boundary.h>
@@ -224,6 +246,12 @@ namespace DdMd
 //#include <util/accumulators/setToZero.h>
 
 #include <fstream>
+#include <algorithm>
+
+#ifdef DDMD_OPENMP
+#include <ddMd/storage/AtomStorage.h>
+#include <omp.h>
+#endif
 
 namespace DdMd
 {
@@ -374,6 +402,51 @@ namespace DdMd
    template <class Interaction>
    void BondPotentialImpl<Interaction>::computeForces()
    {  
+      #ifdef DDMD_OPENMP
+      if (atomStoragePtr()) {
+         computeForcesThreaded();
+         return;
+      }
+      #endif
+
+      #ifdef BOND_BLOCK_SIZE
+      GroupStorage<2>& bondStorage = storage();
+      const int nBond = bondStorage.size();
+      int i, j, n;
+
+      // Process bonds in blocks, in the order of the storage index
+      for (j = 0; j < nBond; j += n) {
+         n = std::min(BOND_BLOCK_SIZE, nBond - j);
+
+         // Gather pointers, types and separations for bonds in block
+         for (i = 0; i < n; ++i) {
+            Group<2>& bond = bondStorage.group(j + i);
+            blockType_[i] = bond.typeId();
+            blockPtr0_[i] = bond.atomPtr(0);
+            blockPtr1_[i] = bond.atomPtr(1);
+            blockRsq_[i] = boundary().distanceSq(blockPtr0_[i]->position(), 
+                                                 blockPtr1_[i]->position(),
+                                                 blockDr_[i]);
+         }
+
+         // Evaluate forceOverR for all bonds in block, in one loop
+         for (i = 0; i < n; ++i) {
+            blockForce_[i] = interactionPtr_->forceOverR(blockRsq_[i], 
+                                                         blockType_[i]);
+         }
+
+         // Scatter forces to local atoms
+         for (i = 0; i < n; ++i) {
+            blockDr_[i] *= blockForce_[i];
+            if (!blockPtr0_[i]->isGhost()) {
+               blockPtr0_[i]->force() += blockDr_[i];
+            }
+            if (!blockPtr1_[i]->isGhost()) {
+               blockPtr1_[i]->force() -= blockDr_[i];
+            }
+         }
+      }
+      #else // ifndef BOND_BLOCK_SIZE
       Vector f;
       double rsq;
       GroupIterator<2> iter;
@@ -400,8 +473,52 @@ namespace DdMd
             atom1Ptr->force() -= f;
          }
       }
+      #endif // ifdef BOND_BLOCK_SIZE
    }
 
+   #ifdef DDMD_OPENMP
+   /*
+   * Add bond forces to atomic forces, using threads (private).
+   */
+   template <class Interaction>
+   void BondPotentialImpl<Interaction>::computeForcesThreaded()
+   {  
+      AtomStorage& atomStorage = *atomStoragePtr();
+      GroupStorage<2>& bondStorage = storage();
+      const int nBond = bondStorage.size();
+      atomStorage.beginThreadForces();
+
+      #pragma omp parallel
+      {
+         Vector f;
+         double rsq;
+         Atom* atom0Ptr;
+         Atom* atom1Ptr;
+         int i, type;
+         const int t = omp_get_thread_num();
+
+         #pragma omp for schedule(static)
+         for (i = 0; i < nBond; ++i) {
+            Group<2>& bond = bondStorage.group(i);
+            type = bond.typeId();
+            atom0Ptr = bond.atomPtr(0);
+            atom1Ptr = bond.atomPtr(1);
+            rsq = boundary().distanceSq(atom0Ptr->position(), 
+                                        atom1Ptr->position(), f);
+            f *= interactionPtr_->forceOverR(rsq, type);
+            if (!atom0Ptr->isGhost()) {
+               atomStorage.addThreadForce(t, *atom0Ptr, f);
+            }
+            if (!atom1Ptr->isGhost()) {
+               atomStorage.subtractThreadForce(t, *atom1Ptr, f);
+            }
+         }
+      } // omp parallel
+
+      atomStorage.endThreadForces(false);
+   }
+   #endif
+
    /*
    * Compute total bond energy on all processors, store result on master.
    */
@@ -517,8 +634,10 @@ namespace DdMd
    void BondPotentialImpl<Interaction>::computeForcesAndStress()
    #endif
    {
-      // Do nothing and return if stress is already set.
-      if (isStressSet()) {
+      // If stress is already set, just calculate forces, unless
+      // per-atom contributions are needed
+      AtomStress* atomStressPtr = activeAtomStress();
+      if (isStressSet() && !atomStressPtr) {
          computeForces();
          return;
       }
@@ -554,6 +673,11 @@ namespace DdMd
          if (isLocal1) {
             atom1Ptr->force() -= f;
          }
+         if (atomStressPtr) {
+            atomStressPtr->addPair(*atom0Ptr, *atom1Ptr,
+                                   interactionPtr_->energy(rsq, type),
+                                   f, dr, false);
+         }
          if (!(isLocal0 && isLocal1)) {
             f *= 0.5;
          }
@@ -0,0 +1,259 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CoulombPotential.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/neighbor/PairList.h>
+#include <ddMd/neighbor/PairIterator.h>
+#include <util/space/Tensor.h>
+#include <util/math/Constants.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   CoulombPotential::CoulombPotential(Simulation& simulation)
+    : ewaldInteraction_(),
+      charges_(),
+      nAtomType_(simulation.nAtomType()),
+      simulationPtr_(&simulation),
+      boundaryPtr_(&simulation.boundary()),
+      domainPtr_(&simulation.domain()),
+      storagePtr_(&simulation.atomStorage())
+   {  setClassName("CoulombPotential"); }
+
+   /*
+   * Destructor.
+   */
+   CoulombPotential::~CoulombPotential()
+   {}
+
+   /*
+   * Read EwaldInteraction parameters without indent or brackets.
+   */
+   void CoulombPotential::readEwaldInteraction(std::istream& in)
+   {
+      UTIL_CHECK(nAtomType_ > 0);
+      bool nextIndent = false;
+      addParamComposite(ewaldInteraction_, nextIndent);
+      ewaldInteraction_.readParameters(in);
+   }
+
+   /*
+   * Load EwaldInteraction parameters from an archive.
+   */
+   void CoulombPotential::loadEwaldInteraction(Serializable::IArchive &ar)
+   {
+      UTIL_CHECK(nAtomType_ > 0);
+      bool nextIndent = false;
+      addParamComposite(ewaldInteraction_, nextIndent);
+      ewaldInteraction_.loadParameters(ar);
+   }
+
+   /*
+   * Save EwaldInteraction parameters to an archive.
+   */
+   void CoulombPotential::saveEwaldInteraction(Serializable::OArchive &ar)
+   {  ewaldInteraction_.save(ar); }
+
+   /*
+   * Read charges.
+   */
+   void CoulombPotential::readCharges(std::istream& in)
+   {
+      charges_.allocate(nAtomType_);
+      readDArray<double>(in, "charges", charges_, nAtomType_);
+      checkCutoff();
+   }
+
+   /*
+   * Load charges from an archive.
+   */
+   void CoulombPotential::loadCharges(Serializable::IArchive &ar)
+   {
+      charges_.allocate(nAtomType_);
+      loadDArray<double>(ar, "charges", charges_, nAtomType_);
+      checkCutoff();
+   }
+
+   /*
+   * Save charges to an archive.
+   */
+   void CoulombPotential::saveCharges(Serializable::OArchive &ar)
+   {  ar << charges_; }
+
+   /*
+   * Check that real space cutoff is within pair list range, and keep
+   * all pairs within this cutoff in a type-dependent list (private).
+   */
+   void CoulombPotential::checkCutoff()
+   {
+      PairPotential& pairPotential = simulationPtr_->pairPotential();
+      double rSpaceCutoff = ewaldInteraction_.rSpaceCutoff();
+      if (rSpaceCutoff > pairPotential.maxPairCutoff()) {
+         UTIL_THROW("Ewald rSpaceCutoff exceeds maximum pair cutoff");
+      }
+      pairPotential.setMinTypeCutoff(rSpaceCutoff);
+   }
+
+   /*
+   * Add real-space and k-space Coulomb forces.
+   */
+   void CoulombPotential::computeForces()
+   {
+      // Real space part, using the pair list of the PairPotential
+      PairList& pairList = simulationPtr_->pairPotential().pairList();
+      PairIterator iter;
+      Vector f;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      double rsq, qProduct;
+      double cutoffSq = ewaldInteraction_.rSpaceCutoffSq();
+      bool   reverse = reverseUpdateFlag();
+      for (pairList.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         qProduct = charges_[atom0Ptr->typeId()]*charges_[atom1Ptr->typeId()];
+         if (qProduct != 0.0) {
+            f.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = f.square();
+            if (rsq < cutoffSq) {
+               f *= ewaldInteraction_.rSpaceForceOverR(rsq, qProduct);
+               atom0Ptr->force() += f;
+               if (reverse || !atom1Ptr->isGhost()) {
+                  atom1Ptr->force() -= f;
+               }
+            }
+         }
+      }
+
+      // K-space part, for local atoms
+      addKSpaceForces();
+   }
+
+   /*
+   * Compute total Coulomb energy.
+   */
+   #ifdef UTIL_MPI
+   void CoulombPotential::computeEnergy(MPI::Intracomm& communicator)
+   #else
+   void CoulombPotential::computeEnergy()
+   #endif
+   {
+      if (isEnergySet()) return;
+
+      // Real space part
+      PairList& pairList = simulationPtr_->pairPotential().pairList();
+      PairIterator iter;
+      Vector dr;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      double rsq, qProduct, e;
+      double cutoffSq = ewaldInteraction_.rSpaceCutoffSq();
+      double energy = 0.0;
+      bool   reverse = reverseUpdateFlag();
+      for (pairList.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         qProduct = charges_[atom0Ptr->typeId()]*charges_[atom1Ptr->typeId()];
+         if (qProduct != 0.0) {
+            dr.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = dr.square();
+            if (rsq < cutoffSq) {
+               e = ewaldInteraction_.rSpaceEnergy(rsq, qProduct);
+               if (reverse || !atom1Ptr->isGhost()) {
+                  energy += e;
+               } else {
+                  energy += 0.5*e;
+               }
+            }
+         }
+      }
+
+      // Self energy correction, for local atoms
+      AtomIterator atomIter;
+      double charge;
+      double selfEnergy = 0.0;
+      for (storagePtr_->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         charge = charges_[atomIter->typeId()];
+         selfEnergy += charge*charge;
+      }
+      double pi = Constants::Pi;
+      selfEnergy *= ewaldInteraction_.alpha()
+                    /(4.0*sqrt(pi)*pi*ewaldInteraction_.epsilon());
+      energy -= selfEnergy;
+
+      // K-space part
+      energy += kSpaceEnergy();
+
+      #ifdef UTIL_MPI
+      reduceEnergy(energy, communicator);
+      #else
+      setEnergy(energy);
+      #endif
+   }
+
+   /*
+   * Compute total Coulomb virial stress.
+   */
+   #ifdef UTIL_MPI
+   void CoulombPotential::computeStress(MPI::Intracomm& communicator)
+   #else
+   void CoulombPotential::computeStress()
+   #endif
+   {
+      if (isStressSet()) return;
+
+      // Real space part, using the pair list of the PairPotential
+      PairList& pairList = simulationPtr_->pairPotential().pairList();
+      PairIterator iter;
+      Tensor localStress;
+      Vector dr, f;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      double rsq, qProduct, forceOverR;
+      double cutoffSq = ewaldInteraction_.rSpaceCutoffSq();
+      bool   reverse = reverseUpdateFlag();
+      localStress.zero();
+      for (pairList.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         qProduct = charges_[atom0Ptr->typeId()]*charges_[atom1Ptr->typeId()];
+         if (qProduct != 0.0) {
+            dr.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = dr.square();
+            if (rsq < cutoffSq) {
+               forceOverR = ewaldInteraction_.rSpaceForceOverR(rsq, qProduct);
+               if (!reverse && atom1Ptr->isGhost()) {
+                  forceOverR *= 0.5;
+               }
+               f.multiply(dr, forceOverR);
+               incrementPairStress(f, dr, localStress);
+            }
+         }
+      }
+      localStress /= boundaryPtr_->volume();
+
+      // K-space part
+      addKSpaceStress(localStress);
+
+      #ifdef UTIL_MPI
+      reduceStress(localStress, communicator);
+      #else
+      setStress(localStress);
+      #endif
+   }
+
+}
@@ -0,0 +1,250 @@
+#ifndef DDMD_COULOMB_POTENTIAL_H
+#define DDMD_COULOMB_POTENTIAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <ddMd/potentials/Potential.h>                 // base class
+#include <simp/interaction/coulomb/EwaldInteraction.h> // member
+#include <util/boundary/Boundary.h>                    // typedef
+#include <util/containers/DArray.h>                    // member
+#include <util/global.h>
+
+namespace DdMd
+{
+
+   class Simulation;
+   class AtomStorage;
+   class Domain;
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * Base class for Ewald-type Coulomb potentials.
+   *
+   * A CoulombPotential splits the Coulomb energy into a short-range
+   * real-space part, a long-range k-space part and a self-energy
+   * correction. This base class evaluates the real-space part, by a
+   * loop over the Verlet pair list of the PairPotential, and the self
+   * energy. Subclasses implement the k-space part. Charges are
+   * associated with atom types.
+   *
+   * \ingroup DdMd_Coulomb_Module
+   */
+   class CoulombPotential : public Potential
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      CoulombPotential(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~CoulombPotential();
+
+      /// \name Total Energy and Forces
+      //@{
+
+      /**
+      * Add real-space and k-space Coulomb forces to atomic forces.
+      *
+      * Call on all processors (requires collective communication).
+      */
+      virtual void computeForces();
+
+      /**
+      * Compute total Coulomb energy on all processors.
+      *
+      * Call on all processors. The total, including the k-space part and
+      * self-energy correction, is stored on the master processor.
+      */
+      #ifdef UTIL_MPI
+      virtual void computeEnergy(MPI::Intracomm& communicator);
+      #else
+      virtual void computeEnergy();
+      #endif
+
+      /**
+      * Compute total Coulomb virial stress on all processors.
+      *
+      * Call on all processors. The sum of real-space pair and k-space
+      * contributions is stored on the master processor.
+      */
+      #ifdef UTIL_MPI
+      virtual void computeStress(MPI::Intracomm& communicator);
+      #else
+      virtual void computeStress();
+      #endif
+
+      //@}
+      /// \name Accessors
+      //@{
+
+      /**
+      * Get the charge associated with an atom type.
+      *
+      * \param typeId atom type index
+      */
+      double charge(int typeId) const;
+
+      /**
+      * Get the Ewald interaction (alpha, epsilon, rSpaceCutoff).
+      */
+      const EwaldInteraction& ewaldInteraction() const;
+
+      //@}
+
+   protected:
+
+      /**
+      * Read Ewald parameters, without indentation or brackets.
+      *
+      * \param in input parameter stream
+      */
+      void readEwaldInteraction(std::istream& in);
+
+      /**
+      * Load Ewald parameters from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      void loadEwaldInteraction(Serializable::IArchive &ar);
+
+      /**
+      * Save Ewald parameters to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      void saveEwaldInteraction(Serializable::OArchive &ar);
+
+      /**
+      * Read the "charges" array, and check the real space cutoff.
+      *
+      * \param in input parameter stream
+      */
+      void readCharges(std::istream& in);
+
+      /**
+      * Load the charges array, and check the real space cutoff.
+      *
+      * \param ar input/loading archive
+      */
+      void loadCharges(Serializable::IArchive &ar);
+
+      /**
+      * Save the charges array to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      void saveCharges(Serializable::OArchive &ar);
+
+      /**
+      * Add k-space forces to the forces on local atoms.
+      *
+      * Called on all processors by computeForces().
+      */
+      virtual void addKSpaceForces() = 0;
+
+      /**
+      * Return the contribution of this processor to the k-space energy.
+      *
+      * Called on all processors by computeEnergy(). The values returned
+      * on all processors are summed to obtain the total.
+      */
+      virtual double kSpaceEnergy() = 0;
+
+      /**
+      * Add the contribution of this processor to the k-space stress.
+      *
+      * Called on all processors by computeStress(). The contributions
+      * of all processors are summed to obtain the total.
+      *
+      * \param stress local stress accumulator (incremented)
+      */
+      virtual void addKSpaceStress(Tensor& stress) = 0;
+
+      /**
+      * Get the parent Simulation.
+      */
+      Simulation& simulation();
+
+      /**
+      * Get the Boundary.
+      */
+      Boundary& boundary();
+
+      /**
+      * Get the Domain.
+      */
+      Domain& domain();
+
+      /**
+      * Get the AtomStorage.
+      */
+      AtomStorage& storage();
+
+   private:
+
+      /// Evaluates real space pair interactions and k-space kernel.
+      EwaldInteraction ewaldInteraction_;
+
+      /// Charges, indexed by atom type id.
+      DArray<double> charges_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Pointer to parent Simulation.
+      Simulation* simulationPtr_;
+
+      /// Pointer to associated Boundary.
+      Boundary* boundaryPtr_;
+
+      /// Pointer to associated Domain.
+      Domain* domainPtr_;
+
+      /// Pointer to associated AtomStorage.
+      AtomStorage* storagePtr_;
+
+      /**
+      * Check that real space cutoff is within pair list range.
+      *
+      * Also sets the minimum type cutoff of the PairPotential to the
+      * real space cutoff, so that no Coulomb pair is omitted from a
+      * type-dependent pair list.
+      */
+      void checkCutoff();
+
+   };
+
+   inline double CoulombPotential::charge(int typeId) const
+   {  return charges_[typeId]; }
+
+   inline const EwaldInteraction& CoulombPotential::ewaldInteraction() const
+   {  return ewaldInteraction_; }
+
+   inline Simulation& CoulombPotential::simulation()
+   {  return *simulationPtr_; }
+
+   inline Boundary& CoulombPotential::boundary()
+   {  return *boundaryPtr_; }
+
+   inline Domain& CoulombPotential::domain()
+   {  return *domainPtr_; }
+
+   inline AtomStorage& CoulombPotential::storage()
+   {  return *storagePtr_; }
+
+}
+#endif
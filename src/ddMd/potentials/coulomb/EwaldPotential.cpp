@@ -0,0 +1,267 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "EwaldPotential.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Domain.h>
+#include <util/space/IntVector.h>
+#include <util/space/Tensor.h>
+#include <util/math/Constants.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   EwaldPotential::EwaldPotential(Simulation& simulation)
+    : CoulombPotential(simulation),
+      waves_(),
+      g_(),
+      rhoLocal_(),
+      rho_(),
+      waveLengths_(),
+      kSpaceCutoff_(0.0)
+   {  setClassName("EwaldPotential"); }
+
+   /*
+   * Destructor.
+   */
+   EwaldPotential::~EwaldPotential()
+   {}
+
+   /*
+   * Read parameters and charges.
+   */
+   void EwaldPotential::readParameters(std::istream& in)
+   {
+      readEwaldInteraction(in);
+      read<double>(in, "kSpaceCutoff", kSpaceCutoff_);
+      if (kSpaceCutoff_ <= 0.0) {
+         UTIL_THROW("kSpaceCutoff must be positive");
+      }
+      readCharges(in);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void EwaldPotential::loadParameters(Serializable::IArchive &ar)
+   {
+      loadEwaldInteraction(ar);
+      loadParameter<double>(ar, "kSpaceCutoff", kSpaceCutoff_);
+      if (kSpaceCutoff_ <= 0.0) {
+         UTIL_THROW("kSpaceCutoff must be positive");
+      }
+      loadCharges(ar);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void EwaldPotential::save(Serializable::OArchive &ar)
+   {
+      saveEwaldInteraction(ar);
+      ar << kSpaceCutoff_;
+      saveCharges(ar);
+   }
+
+   /*
+   * Construct wavevectors within kSpaceCutoff, for half of k-space.
+   */
+   void EwaldPotential::makeWaves()
+   {
+      // Reuse existing waves if the boundary is unchanged
+      if (waves_.size() > 0 && boundary().lengths() == waveLengths_) {
+         return;
+      }
+
+      Vector    b[Dimension];  // Reciprocal basis vectors (include 2 pi)
+      Vector    q, dq;         // Wavevector, and increment
+      IntVector maxK, k;
+      double    ksq, a;
+      double    kSpaceCutoffSq = kSpaceCutoff_*kSpaceCutoff_;
+      double    twoPi = 2.0*Constants::Pi;
+      int       mink1, mink2, j;
+
+      for (j = 0; j < Dimension; ++j) {
+         b[j] = boundary().reciprocalBasisVector(j);
+         a = boundary().bravaisBasisVector(j).abs();
+         maxK[j] = int(ceil(kSpaceCutoff_*a/twoPi));
+         UTIL_CHECK(maxK[j] > 0);
+      }
+
+      waves_.clear();
+      g_.clear();
+
+      // Include only one of each pair of waves k and -k, and omit k = 0.
+      for (k[0] = 0; k[0] <= maxK[0]; ++k[0]) {
+         mink1 = (k[0] == 0 ? 0 : -maxK[1]);
+         for (k[1] = mink1; k[1] <= maxK[1]; ++k[1]) {
+            mink2 = (k[0] == 0 && k[1] == 0 ? 1 : -maxK[2]);
+            for (k[2] = mink2; k[2] <= maxK[2]; ++k[2]) {
+               q.zero();
+               for (j = 0; j < Dimension; ++j) {
+                  dq.multiply(b[j], double(k[j]));
+                  q += dq;
+               }
+               ksq = q.square();
+               if (ksq <= kSpaceCutoffSq) {
+                  waves_.append(q);
+                  g_.append(ewaldInteraction().kSpacePotential(ksq));
+               }
+            }
+         }
+      }
+      UTIL_CHECK(waves_.size() > 0);
+      waveLengths_ = boundary().lengths();
+
+      int n = 2*waves_.size();
+      if (rho_.capacity() < n) {
+         if (rho_.isAllocated()) {
+            rho_.deallocate();
+            rhoLocal_.deallocate();
+         }
+         rho_.allocate(n);
+         rhoLocal_.allocate(n);
+      }
+   }
+
+   /*
+   * Compute Fourier components of the total charge density (private).
+   */
+   void EwaldPotential::computeKSpaceCharge()
+   {
+      makeWaves();
+
+      AtomIterator atomIter;
+      double q, dot;
+      int i;
+      const int nWave = waves_.size();
+      for (i = 0; i < 2*nWave; ++i) {
+         rhoLocal_[i] = 0.0;
+      }
+
+      // Add contributions of local atoms on this processor
+      for (storage().begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         q = charge(atomIter->typeId());
+         if (q != 0.0) {
+            const Vector& r = atomIter->position();
+            for (i = 0; i < nWave; ++i) {
+               dot = waves_[i].dot(r);
+               rhoLocal_[2*i] += q*cos(dot);
+               rhoLocal_[2*i+1] += q*sin(dot);
+            }
+         }
+      }
+
+      // Sum over all processors
+      #ifdef UTIL_MPI
+      domain().communicator().Allreduce(&rhoLocal_[0], &rho_[0], 2*nWave,
+                                        MPI::DOUBLE, MPI::SUM);
+      #else
+      for (i = 0; i < 2*nWave; ++i) {
+         rho_[i] = rhoLocal_[i];
+      }
+      #endif
+   }
+
+   /*
+   * Add k-space Coulomb forces to local atoms.
+   */
+   void EwaldPotential::addKSpaceForces()
+   {
+      computeKSpaceCharge();
+      AtomIterator atomIter;
+      Vector f;
+      double q, dot, c, s, prefactor;
+      double volume = boundary().volume();
+      const int nWave = waves_.size();
+      int i;
+      for (storage().begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         q = charge(atomIter->typeId());
+         if (q != 0.0) {
+            const Vector& r = atomIter->position();
+            f.zero();
+            for (i = 0; i < nWave; ++i) {
+               dot = waves_[i].dot(r);
+               c = cos(dot);
+               s = sin(dot);
+               prefactor = g_[i]*(s*rho_[2*i] - c*rho_[2*i+1]);
+               f[0] += prefactor*waves_[i][0];
+               f[1] += prefactor*waves_[i][1];
+               f[2] += prefactor*waves_[i][2];
+            }
+            f *= 2.0*q/volume;
+            atomIter->force() += f;
+         }
+      }
+   }
+
+   /*
+   * Return k-space energy (identical on all processors, added on master).
+   *
+   * A factor 0.5 is cancelled by the use of half of the wavevectors.
+   */
+   double EwaldPotential::kSpaceEnergy()
+   {
+      computeKSpaceCharge();
+      double energy = 0.0;
+      #ifdef UTIL_MPI
+      if (domain().isMaster()) {
+      #endif
+         for (int i = 0; i < waves_.size(); ++i) {
+            energy += g_[i]*(rho_[2*i]*rho_[2*i] + rho_[2*i+1]*rho_[2*i+1]);
+         }
+         energy /= boundary().volume();
+      #ifdef UTIL_MPI
+      }
+      #endif
+      return energy;
+   }
+
+   /*
+   * Add k-space stress (identical on all processors, added on master).
+   *
+   * A factor 0.5 is cancelled by the use of half of the wavevectors.
+   */
+   void EwaldPotential::addKSpaceStress(Tensor& stress)
+   {
+      computeKSpaceCharge();
+      #ifdef UTIL_MPI
+      if (domain().isMaster()) {
+      #endif
+         Tensor kStress, K;
+         double alpha = ewaldInteraction().alpha();
+         double ca = 0.25/(alpha*alpha);
+         double volume = boundary().volume();
+         double ksq, rhoSq;
+         kStress.zero();
+         for (int i = 0; i < waves_.size(); ++i) {
+            ksq = waves_[i].square();
+            rhoSq = rho_[2*i]*rho_[2*i] + rho_[2*i+1]*rho_[2*i+1];
+            K.dyad(waves_[i], waves_[i]);
+            K *= -2.0*(ca + 1.0/ksq);
+            K.add(Tensor::Identity, K);
+            K *= g_[i]*rhoSq;
+            kStress += K;
+         }
+         kStress /= volume*volume;
+         stress += kStress;
+      #ifdef UTIL_MPI
+      }
+      #endif
+   }
+
+}
@@ -0,0 +1,166 @@
+#ifndef DDMD_EWALD_POTENTIAL_H
+#define DDMD_EWALD_POTENTIAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CoulombPotential.h"                // base class
+#include <util/containers/DArray.h>         // member
+#include <util/containers/GArray.h>         // member
+#include <util/space/Vector.h>              // member template arg
+#include <util/global.h>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Ewald Coulomb potential for a domain-decomposed simulation.
+   *
+   * The real-space part is evaluated by the CoulombPotential base
+   * class, using the Verlet pair list of the PairPotential. The k-space
+   * part is evaluated by an explicit sum over wavevectors: each
+   * processor computes the contribution of its local atoms to the
+   * Fourier components of the charge density, which are then summed
+   * over all processors by a single MPI_Allreduce, after which each
+   * processor computes k-space forces on its own local atoms. The
+   * wavevectors are reconstructed only when the boundary lengths
+   * change. Charges are associated with atom types, and are given by
+   * the "charges" array parameter.
+   *
+   * The cost of the k-space sum grows as the product of the number of
+   * atoms and wavevectors, and the Allreduce communicates every Fourier
+   * component. SpmePotential is preferable for large systems.
+   *
+   * Parameter file format (within the Simulation block):
+   * \code
+   *   EwaldPotential{
+   *     epsilon       1.0
+   *     alpha         1.0
+   *     rSpaceCutoff  3.0
+   *     kSpaceCutoff  4.0
+   *     charges       1.0   -1.0
+   *   }
+   * \endcode
+   *
+   * \ingroup DdMd_Coulomb_Module
+   */
+   class EwaldPotential : public CoulombPotential
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      EwaldPotential(Simulation& simulation);
+
+      /**
+      * Destructor.
+      */
+      virtual ~EwaldPotential();
+
+      /**
+      * Read parameters and charges.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /// \name Accessors
+      //@{
+
+      /**
+      * Get the k-space cutoff (maximum wavenumber).
+      */
+      double kSpaceCutoff() const;
+
+      /**
+      * Get the number of wavevectors in the last k-space sum.
+      */
+      int nWave() const;
+
+      //@}
+
+   protected:
+
+      /**
+      * Add k-space forces to the forces on local atoms.
+      */
+      virtual void addKSpaceForces();
+
+      /**
+      * Return k-space energy on the master processor, 0 on others.
+      */
+      virtual double kSpaceEnergy();
+
+      /**
+      * Add k-space stress on the master processor.
+      *
+      * \param stress local stress accumulator (incremented)
+      */
+      virtual void addKSpaceStress(Tensor& stress);
+
+   private:
+
+      /// Cartesian wavevectors (half of k-space, excluding k=0).
+      GArray<Vector> waves_;
+
+      /// Regularized k-space potential for each wavevector.
+      GArray<double> g_;
+
+      /// Local contributions to Fourier charge density (re, im pairs).
+      DArray<double> rhoLocal_;
+
+      /// Total Fourier charge density (re, im pairs).
+      DArray<double> rho_;
+
+      /// Boundary lengths for which waves_ and g_ were constructed.
+      Vector waveLengths_;
+
+      /// Maximum wavenumber in k-space sum.
+      double kSpaceCutoff_;
+
+      /**
+      * Construct list of wavevectors, if the boundary has changed.
+      */
+      void makeWaves();
+
+      /**
+      * Compute Fourier components of the charge density (all procs).
+      */
+      void computeKSpaceCharge();
+
+   };
+
+   inline double EwaldPotential::kSpaceCutoff() const
+   {  return kSpaceCutoff_; }
+
+   inline int EwaldPotential::nWave() const
+   {  return waves_.size(); }
+
+}
+#endif
@@ -0,0 +1,932 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "SpmePotential.h"
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <util/space/Tensor.h>
+#include <util/math/Constants.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   namespace {
+
+      // Maximum supported B-spline order
+      const int MaxOrder = 8;
+
+      /*
+      * Return index of first mesh point at or above a domain bound.
+      */
+      inline int meshBound(double bound, int nGrid)
+      {  return int(ceil(bound*double(nGrid))); }
+
+   }
+
+   /*
+   * Number of points in a box.
+   */
+   int SpmePotential::Box::size() const
+   {
+      int n = 1;
+      for (int i = 0; i < Dimension; ++i) {
+         if (upper[i] <= lower[i]) return 0;
+         n *= upper[i] - lower[i];
+      }
+      return n;
+   }
+
+   /*
+   * Storage position of a point (axis fast varies most rapidly).
+   */
+   inline int SpmePotential::Box::offset(const IntVector& index) const
+   {
+      int slow = (fast + 1) % Dimension;
+      int mid  = (fast + 2) % Dimension;
+      return ((index[slow] - lower[slow])*(upper[mid] - lower[mid])
+              + index[mid] - lower[mid])*(upper[fast] - lower[fast])
+              + index[fast] - lower[fast];
+   }
+
+   /*
+   * Constructor.
+   */
+   SpmePotential::SpmePotential(Simulation& simulation)
+    : CoulombPotential(simulation),
+      gridDimensions_(),
+      brickBoxes_(),
+      pencilBoxes_(),
+      ghostBox_(),
+      lowerGhosts_(),
+      upperGhosts_(),
+      brick_(),
+      pencils_(),
+      g_(),
+      bSq_(),
+      remaps_(),
+      sendBuffer_(),
+      recvBuffer_(),
+      gridBounds_(),
+      waveLengths_(0.0),
+      order_(5),
+      nProc_(1),
+      rank_(0),
+      hasPencils_(false)
+   {
+      setClassName("SpmePotential");
+      for (int i = 0; i < Dimension; ++i) {
+         gridDimensions_[i] = 0;
+         lowerGhosts_[i] = 0;
+         upperGhosts_[i] = 0;
+      }
+   }
+
+   /*
+   * Destructor.
+   */
+   SpmePotential::~SpmePotential()
+   {
+      if (hasPencils_) {
+         for (int i = 0; i < Dimension; ++i) {
+            if (pencilBoxes_[i][rank_].size() > 0) {
+               fftw_destroy_plan(forwardPlans_[i]);
+               fftw_destroy_plan(backwardPlans_[i]);
+            }
+         }
+      }
+   }
+
+   /*
+   * Read parameters and charges.
+   */
+   void SpmePotential::readParameters(std::istream& in)
+   {
+      readEwaldInteraction(in);
+      read<IntVector>(in, "gridDimensions", gridDimensions_);
+      for (int i = 0; i < Dimension; ++i) {
+         if (gridDimensions_[i] < order_) {
+            UTIL_THROW("SPME gridDimensions less than spline order");
+         }
+      }
+      readCharges(in);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void SpmePotential::loadParameters(Serializable::IArchive &ar)
+   {
+      loadEwaldInteraction(ar);
+      loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
+      for (int i = 0; i < Dimension; ++i) {
+         if (gridDimensions_[i] < order_) {
+            UTIL_THROW("SPME gridDimensions less than spline order");
+         }
+      }
+      loadCharges(ar);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void SpmePotential::save(Serializable::OArchive &ar)
+   {
+      saveEwaldInteraction(ar);
+      ar << gridDimensions_;
+      saveCharges(ar);
+   }
+
+   /*
+   * Compute intersection of boxes a and b (static).
+   */
+   bool SpmePotential::intersect(const Box& a, const Box& b, Box& c)
+   {
+      bool isEmpty = false;
+      for (int i = 0; i < Dimension; ++i) {
+         c.lower[i] = a.lower[i] > b.lower[i] ? a.lower[i] : b.lower[i];
+         c.upper[i] = a.upper[i] < b.upper[i] ? a.upper[i] : b.upper[i];
+         if (c.upper[i] <= c.lower[i]) {
+            c.upper[i] = c.lower[i];
+            isEmpty = true;
+         }
+      }
+      c.fast = Dimension - 1;
+      return !isEmpty;
+   }
+
+   /*
+   * Compute B-spline weights and derivatives by recursion on order.
+   */
+   void
+   SpmePotential::splineWeights(double w, double* theta, double* dTheta)
+   const
+   {
+      double div;
+      int j, k;
+
+      // Order 2
+      theta[order_ - 1] = 0.0;
+      theta[1] = w;
+      theta[0] = 1.0 - w;
+
+      // Raise to order - 1
+      for (k = 3; k < order_; ++k) {
+         div = 1.0/double(k - 1);
+         theta[k - 1] = div*w*theta[k - 2];
+         for (j = 1; j < k - 1; ++j) {
+            theta[k - j - 1] = div*((w + j)*theta[k - j - 2]
+                                    + (k - j - w)*theta[k - j - 1]);
+         }
+         theta[0] = div*(1.0 - w)*theta[0];
+      }
+
+      // Derivatives from weights of order - 1
+      dTheta[0] = -theta[0];
+      for (j = 1; j < order_; ++j) {
+         dTheta[j] = theta[j - 1] - theta[j];
+      }
+
+      // Raise to order
+      k = order_;
+      div = 1.0/double(k - 1);
+      theta[k - 1] = div*w*theta[k - 2];
+      for (j = 1; j < k - 1; ++j) {
+         theta[k - j - 1] = div*((w + j)*theta[k - j - 2]
+                                 + (k - j - w)*theta[k - j - 1]);
+      }
+      theta[0] = div*(1.0 - w)*theta[0];
+   }
+
+   /*
+   * Allocate pencils, create remaps between them, and fft plans (once).
+   */
+   void SpmePotential::makePencils()
+   {
+      if (hasPencils_) return;
+      UTIL_CHECK(order_ <= MaxOrder);
+
+      #ifdef UTIL_MPI
+      nProc_ = domain().communicator().Get_size();
+      rank_  = domain().communicator().Get_rank();
+      #else
+      nProc_ = 1;
+      rank_  = 0;
+      #endif
+
+      // Factor processors into a q1 x q2 grid for pencils, with q1 <= q2
+      int q1 = 1;
+      for (int q = 1; q*q <= nProc_; ++q) {
+         if (nProc_ % q == 0) q1 = q;
+      }
+      int q2 = nProc_/q1;
+
+      // Pencils along axis i divide the other two axes over the grid
+      int i, r, b, c, c1, c2;
+      for (i = 0; i < Dimension; ++i) {
+         b = (i + 1) % Dimension;
+         c = (i + 2) % Dimension;
+         pencilBoxes_[i].allocate(nProc_);
+         for (r = 0; r < nProc_; ++r) {
+            Box& box = pencilBoxes_[i][r];
+            c1 = r / q2;
+            c2 = r % q2;
+            box.lower[i] = 0;
+            box.upper[i] = gridDimensions_[i];
+            box.lower[b] = (c1*gridDimensions_[b])/q1;
+            box.upper[b] = ((c1 + 1)*gridDimensions_[b])/q1;
+            box.lower[c] = (c2*gridDimensions_[c])/q2;
+            box.upper[c] = ((c2 + 1)*gridDimensions_[c])/q2;
+            box.fast = i;
+         }
+      }
+      makeRemap(pencilBoxes_[0], pencilBoxes_[1], 2, remaps_[1]);
+      makeRemap(pencilBoxes_[1], pencilBoxes_[2], 2, remaps_[2]);
+
+      // Allocate pencils and create plans for 1D transforms along axis
+      fftw_complex* data;
+      int n, size;
+      for (i = 0; i < Dimension; ++i) {
+         size = pencilBoxes_[i][rank_].size();
+         pencils_[i].allocate(size > 0 ? size : 1);
+         if (size > 0) {
+            n = gridDimensions_[i];
+            data = reinterpret_cast<fftw_complex*>(&pencils_[i][0]);
+            forwardPlans_[i] =
+                   fftw_plan_many_dft(1, &n, size/n, data, 0, 1, n,
+                                      data, 0, 1, n,
+                                      FFTW_FORWARD, FFTW_MEASURE);
+            backwardPlans_[i] =
+                   fftw_plan_many_dft(1, &n, size/n, data, 0, 1, n,
+                                      data, 0, 1, n,
+                                      FFTW_BACKWARD, FFTW_MEASURE);
+         }
+      }
+      size = pencilBoxes_[2][rank_].size();
+      g_.allocate(size > 0 ? size : 1);
+
+      // Squared moduli of B-spline structure factors along each axis.
+      // For odd order, the factor vanishes at the Nyquist wavenumber.
+      double theta[MaxOrder];
+      double dTheta[MaxOrder];
+      splineWeights(0.0, theta, dTheta);
+      double twoPi = 2.0*Constants::Pi;
+      double arg;
+      std::complex<double> denom;
+      int m, k;
+      for (i = 0; i < Dimension; ++i) {
+         n = gridDimensions_[i];
+         bSq_[i].allocate(n);
+         for (m = 0; m < n; ++m) {
+            if (order_ % 2 == 1 && 2*m == n) {
+               bSq_[i][m] = 0.0;
+            } else {
+               denom = 0.0;
+               for (k = 0; k <= order_ - 2; ++k) {
+                  arg = twoPi*double(m*k)/double(n);
+                  denom += theta[order_ - 2 - k]
+                           *std::complex<double>(cos(arg), sin(arg));
+               }
+               bSq_[i][m] = 1.0/std::norm(denom);
+            }
+         }
+      }
+
+      hasPencils_ = true;
+   }
+
+   /*
+   * Construct bricks, ghost layers and the brick remap, if needed.
+   */
+   void SpmePotential::makeBricks()
+   {
+      makePencils();
+
+      // Ghost layers hold the stencil of any atom that has moved by up
+      // to exchangeSkin/2 outside the domain since the last exchange.
+      double drift = 0.5*simulation().pairPotential().exchangeSkin();
+      double twoPi = 2.0*Constants::Pi;
+      IntVector lowerGhosts, upperGhosts;
+      double b;
+      int i, k, d;
+      bool isNew = !brick_.isAllocated();
+      for (i = 0; i < Dimension; ++i) {
+         b = boundary().reciprocalBasisVector(i).abs();
+         d = int(ceil(drift*b*gridDimensions_[i]/twoPi)) + 1;
+         lowerGhosts[i] = order_ - 1 + d;
+         upperGhosts[i] = d;
+         if (lowerGhosts[i] != lowerGhosts_[i]) isNew = true;
+         if (upperGhosts[i] != upperGhosts_[i]) isNew = true;
+         if (!isNew) {
+            for (k = 0; k <= domain().gridDimension(i); ++k) {
+               if (domain().gridBound(i, k) != gridBounds_[i][k]) {
+                  isNew = true;
+               }
+            }
+         }
+      }
+      if (!isNew) return;
+
+      // Record grid bounds and ghost widths
+      for (i = 0; i < Dimension; ++i) {
+         if (!domain().gridIsPeriodic(i)) {
+            UTIL_THROW("SpmePotential requires a periodic processor grid");
+         }
+         if (!gridBounds_[i].isAllocated()) {
+            gridBounds_[i].allocate(domain().gridDimension(i) + 1);
+         }
+         for (k = 0; k <= domain().gridDimension(i); ++k) {
+            gridBounds_[i][k] = domain().gridBound(i, k);
+         }
+      }
+      lowerGhosts_ = lowerGhosts;
+      upperGhosts_ = upperGhosts;
+
+      // Bricks of mesh points owned by all processors
+      if (!brickBoxes_.isAllocated()) {
+         brickBoxes_.allocate(nProc_);
+      }
+      IntVector position;
+      int r, width;
+      for (r = 0; r < nProc_; ++r) {
+         Box& box = brickBoxes_[r];
+         position = domain().position(r);
+         for (i = 0; i < Dimension; ++i) {
+            box.lower[i] = meshBound(gridBounds_[i][position[i]],
+                                     gridDimensions_[i]);
+            box.upper[i] = meshBound(gridBounds_[i][position[i] + 1],
+                                     gridDimensions_[i]);
+            width = box.upper[i] - box.lower[i];
+            if (width < lowerGhosts_[i] || width < upperGhosts_[i]) {
+               UTIL_THROW("SPME mesh too coarse for domain decomposition");
+            }
+         }
+         box.fast = Dimension - 1;
+      }
+
+      // Local brick storage, including ghost layers
+      const Box& owned = brickBoxes_[rank_];
+      for (i = 0; i < Dimension; ++i) {
+         ghostBox_.lower[i] = owned.lower[i] - lowerGhosts_[i];
+         ghostBox_.upper[i] = owned.upper[i] + upperGhosts_[i];
+      }
+      ghostBox_.fast = Dimension - 1;
+      int size = ghostBox_.size();
+      if (brick_.isAllocated() && brick_.capacity() < size) {
+         brick_.deallocate();
+      }
+      if (!brick_.isAllocated()) {
+         brick_.allocate(size);
+      }
+
+      makeRemap(brickBoxes_, pencilBoxes_[0], 1, remaps_[0]);
+
+      // Buffers must hold any ghost slab, and all data sent in a remap
+      int sendSize = size;
+      int recvSize = size;
+      int sum;
+      for (k = 0; k < Dimension; ++k) {
+         sum = 0;
+         for (r = 0; r < nProc_; ++r) {
+            sum += remaps_[k].sendCounts[r];
+         }
+         if (sum > sendSize) sendSize = sum;
+         if (sum > recvSize) recvSize = sum;
+         sum = 0;
+         for (r = 0; r < nProc_; ++r) {
+            sum += remaps_[k].recvCounts[r];
+         }
+         if (sum > sendSize) sendSize = sum;
+         if (sum > recvSize) recvSize = sum;
+      }
+      if (sendBuffer_.isAllocated() && sendBuffer_.capacity() < sendSize) {
+         sendBuffer_.deallocate();
+      }
+      if (!sendBuffer_.isAllocated()) {
+         sendBuffer_.allocate(sendSize);
+      }
+      if (recvBuffer_.isAllocated() && recvBuffer_.capacity() < recvSize) {
+         recvBuffer_.deallocate();
+      }
+      if (!recvBuffer_.isAllocated()) {
+         recvBuffer_.allocate(recvSize);
+      }
+   }
+
+   /*
+   * Compute the influence function on local z pencils, if needed.
+   */
+   void SpmePotential::makeInfluence()
+   {
+      if (waveLengths_ == boundary().lengths()) return;
+
+      Vector b[Dimension];
+      Vector q, dq;
+      IntVector index, m;
+      double qSq;
+      int i;
+      for (i = 0; i < Dimension; ++i) {
+         b[i] = boundary().reciprocalBasisVector(i);
+      }
+      const Box& box = pencilBoxes_[2][rank_];
+      if (box.size() > 0) {
+         for (index[0] = box.lower[0]; index[0] < box.upper[0]; ++index[0]) {
+          for (index[1] = box.lower[1]; index[1] < box.upper[1]; ++index[1]) {
+           for (index[2] = box.lower[2]; index[2] < box.upper[2]; ++index[2]) {
+               q.zero();
+               for (i = 0; i < Dimension; ++i) {
+                  m[i] = index[i];
+                  if (2*m[i] > gridDimensions_[i]) {
+                     m[i] -= gridDimensions_[i];
+                  }
+                  dq.multiply(b[i], double(m[i]));
+                  q += dq;
+               }
+               qSq = q.square();
+               if (qSq > 1.0E-10) {
+                  g_[box.offset(index)] = bSq_[0][index[0]]
+                                         *bSq_[1][index[1]]
+                                         *bSq_[2][index[2]]
+                                    *ewaldInteraction().kSpacePotential(qSq);
+               } else {
+                  g_[box.offset(index)] = 0.0;
+               }
+           }
+          }
+         }
+      }
+      waveLengths_ = boundary().lengths();
+   }
+
+   /*
+   * Construct a plan for redistribution from source to dest boxes.
+   */
+   void SpmePotential::makeRemap(const DArray<Box>& source,
+                                 const DArray<Box>& dest,
+                                 int nComponent, Remap& remap)
+   {
+      if (!remap.sendBoxes.isAllocated()) {
+         remap.sendBoxes.allocate(nProc_);
+         remap.recvBoxes.allocate(nProc_);
+         remap.sendCounts.allocate(nProc_);
+         remap.sendDispls.allocate(nProc_);
+         remap.recvCounts.allocate(nProc_);
+         remap.recvDispls.allocate(nProc_);
+      }
+      remap.nComponent = nComponent;
+      int sendDispl = 0;
+      int recvDispl = 0;
+      for (int r = 0; r < nProc_; ++r) {
+         intersect(source[rank_], dest[r], remap.sendBoxes[r]);
+         remap.sendCounts[r] = nComponent*remap.sendBoxes[r].size();
+         remap.sendDispls[r] = sendDispl;
+         sendDispl += remap.sendCounts[r];
+         intersect(source[r], dest[rank_], remap.recvBoxes[r]);
+         remap.recvCounts[r] = nComponent*remap.recvBoxes[r].size();
+         remap.recvDispls[r] = recvDispl;
+         recvDispl += remap.recvCounts[r];
+      }
+   }
+
+   /*
+   * Redistribute mesh data, forward or backward through a remap plan.
+   */
+   void SpmePotential::remap(Remap& plan, bool forward,
+                             const double* source, const Box& sourceBox,
+                             int sourceStride,
+                             double* dest, const Box& destBox,
+                             int destStride)
+   {
+      DArray<Box>& sendBoxes  = forward ? plan.sendBoxes  : plan.recvBoxes;
+      DArray<int>& sendCounts = forward ? plan.sendCounts : plan.recvCounts;
+      DArray<int>& sendDispls = forward ? plan.sendDispls : plan.recvDispls;
+      DArray<Box>& recvBoxes  = forward ? plan.recvBoxes  : plan.sendBoxes;
+      DArray<int>& recvCounts = forward ? plan.recvCounts : plan.sendCounts;
+      DArray<int>& recvDispls = forward ? plan.recvDispls : plan.sendDispls;
+      const int nComponent = plan.nComponent;
+      IntVector index;
+      double* ptr;
+      int r, j, k;
+
+      // Pack
+      for (r = 0; r < nProc_; ++r) {
+         if (sendCounts[r] == 0) continue;
+         const Box& box = sendBoxes[r];
+         ptr = &sendBuffer_[sendDispls[r]];
+         for (index[0] = box.lower[0]; index[0] < box.upper[0]; ++index[0]) {
+          for (index[1] = box.lower[1]; index[1] < box.upper[1]; ++index[1]) {
+           for (index[2] = box.lower[2]; index[2] < box.upper[2]; ++index[2]) {
+               k = sourceStride*sourceBox.offset(index);
+               for (j = 0; j < nComponent; ++j) {
+                  *ptr++ = source[k + j];
+               }
+           }
+          }
+         }
+      }
+
+      // Exchange
+      #ifdef UTIL_MPI
+      domain().communicator().Alltoallv(&sendBuffer_[0], &sendCounts[0],
+                                        &sendDispls[0], MPI::DOUBLE,
+                                        &recvBuffer_[0], &recvCounts[0],
+                                        &recvDispls[0], MPI::DOUBLE);
+      #else
+      for (k = 0; k < sendCounts[0]; ++k) {
+         recvBuffer_[k] = sendBuffer_[k];
+      }
+      #endif
+
+      // Unpack, setting any components that were not sent to zero
+      for (r = 0; r < nProc_; ++r) {
+         if (recvCounts[r] == 0) continue;
+         const Box& box = recvBoxes[r];
+         ptr = &recvBuffer_[recvDispls[r]];
+         for (index[0] = box.lower[0]; index[0] < box.upper[0]; ++index[0]) {
+          for (index[1] = box.lower[1]; index[1] < box.upper[1]; ++index[1]) {
+           for (index[2] = box.lower[2]; index[2] < box.upper[2]; ++index[2]) {
+               k = destStride*destBox.offset(index);
+               for (j = 0; j < nComponent; ++j) {
+                  dest[k + j] = *ptr++;
+               }
+               for ( ; j < destStride; ++j) {
+                  dest[k + j] = 0.0;
+               }
+           }
+          }
+         }
+      }
+   }
+
+   /*
+   * Send a slab of the local brick to a neighbor, and receive another.
+   */
+   void SpmePotential::exchangeSlab(const Box& sendRegion,
+                                    const Box& recvRegion,
+                                    int axis, int direction, bool add)
+   {
+      IntVector index;
+      int n = 0;
+      for (index[0] = sendRegion.lower[0]; index[0] < sendRegion.upper[0];
+           ++index[0]) {
+         for (index[1] = sendRegion.lower[1];
+              index[1] < sendRegion.upper[1]; ++index[1]) {
+            for (index[2] = sendRegion.lower[2];
+                 index[2] < sendRegion.upper[2]; ++index[2]) {
+               sendBuffer_[n] = brick_[ghostBox_.offset(index)];
+               ++n;
+            }
+         }
+      }
+      UTIL_CHECK(n == recvRegion.size());
+
+      #ifdef UTIL_MPI
+      IntVector position;
+      int i;
+      for (i = 0; i < Dimension; ++i) {
+         position[i] = domain().gridCoordinate(i);
+      }
+      int nGrid = domain().gridDimension(axis);
+      int c = position[axis];
+      position[axis] = (c + direction + nGrid) % nGrid;
+      int dest = domain().rank(position);
+      position[axis] = (c - direction + nGrid) % nGrid;
+      int source = domain().rank(position);
+      domain().communicator().Sendrecv(&sendBuffer_[0], n, MPI::DOUBLE,
+                                       dest, 0,
+                                       &recvBuffer_[0], n, MPI::DOUBLE,
+                                       source, 0);
+      #else
+      for (int k = 0; k < n; ++k) {
+         recvBuffer_[k] = sendBuffer_[k];
+      }
+      #endif
+
+      n = 0;
+      for (index[0] = recvRegion.lower[0]; index[0] < recvRegion.upper[0];
+           ++index[0]) {
+         for (index[1] = recvRegion.lower[1];
+              index[1] < recvRegion.upper[1]; ++index[1]) {
+            for (index[2] = recvRegion.lower[2];
+                 index[2] < recvRegion.upper[2]; ++index[2]) {
+               if (add) {
+                  brick_[ghostBox_.offset(index)] += recvBuffer_[n];
+               } else {
+                  brick_[ghostBox_.offset(index)] = recvBuffer_[n];
+               }
+               ++n;
+            }
+         }
+      }
+   }
+
+   /*
+   * Spread charges of local atoms, then add ghost charge to owners.
+   */
+   void SpmePotential::spreadCharges()
+   {
+      int size = ghostBox_.size();
+      int i, j, k;
+      for (k = 0; k < size; ++k) {
+         brick_[k] = 0.0;
+      }
+
+      AtomIterator atomIter;
+      double theta[Dimension][MaxOrder];
+      double dTheta[MaxOrder];
+      IntVector first, index;
+      Vector s;
+      double q, u, w0, w1;
+      int floorU;
+      for (storage().begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         q = charge(atomIter->typeId());
+         if (q == 0.0) continue;
+         boundary().transformCartToGen(atomIter->position(), s);
+         for (i = 0; i < Dimension; ++i) {
+            u = s[i]*gridDimensions_[i];
+            floorU = int(floor(u));
+            splineWeights(u - floorU, theta[i], dTheta);
+            first[i] = floorU - order_ + 1;
+            if (first[i] < ghostBox_.lower[i]
+                || first[i] + order_ > ghostBox_.upper[i]) {
+               UTIL_THROW("Atom stencil outside SPME ghost layer");
+            }
+         }
+         for (i = 0; i < order_; ++i) {
+            index[0] = first[0] + i;
+            w0 = q*theta[0][i];
+            for (j = 0; j < order_; ++j) {
+               index[1] = first[1] + j;
+               w1 = w0*theta[1][j];
+               index[2] = first[2];
+               double* ptr = &brick_[ghostBox_.offset(index)];
+               for (k = 0; k < order_; ++k) {
+                  ptr[k] += w1*theta[2][k];
+               }
+            }
+         }
+      }
+
+      // Send ghost charge to owners, one axis at a time. Along axis j,
+      // slabs span owned points along axes < j, and all points along
+      // axes > j, to forward charge destined for diagonal neighbors.
+      const Box& owned = brickBoxes_[rank_];
+      Box sendRegion, recvRegion;
+      for (j = 0; j < Dimension; ++j) {
+         for (i = 0; i < Dimension; ++i) {
+            if (i < j) {
+               sendRegion.lower[i] = owned.lower[i];
+               sendRegion.upper[i] = owned.upper[i];
+            } else {
+               sendRegion.lower[i] = ghostBox_.lower[i];
+               sendRegion.upper[i] = ghostBox_.upper[i];
+            }
+         }
+         recvRegion = sendRegion;
+
+         // Lower ghosts to lower neighbor, add to upper owned points
+         sendRegion.upper[j] = owned.lower[j];
+         recvRegion.lower[j] = owned.upper[j] - lowerGhosts_[j];
+         recvRegion.upper[j] = owned.upper[j];
+         exchangeSlab(sendRegion, recvRegion, j, -1, true);
+
+         // Upper ghosts to upper neighbor, add to lower owned points
+         sendRegion.lower[j] = owned.upper[j];
+         sendRegion.upper[j] = ghostBox_.upper[j];
+         recvRegion.lower[j] = owned.lower[j];
+         recvRegion.upper[j] = owned.lower[j] + upperGhosts_[j];
+         exchangeSlab(sendRegion, recvRegion, j, 1, true);
+      }
+   }
+
+   /*
+   * Copy owned values into ghost layers of neighbors (reverse order).
+   */
+   void SpmePotential::fillGhosts()
+   {
+      const Box& owned = brickBoxes_[rank_];
+      Box sendRegion, recvRegion;
+      int i, j;
+      for (j = Dimension - 1; j >= 0; --j) {
+         for (i = 0; i < Dimension; ++i) {
+            if (i < j) {
+               sendRegion.lower[i] = owned.lower[i];
+               sendRegion.upper[i] = owned.upper[i];
+            } else {
+               sendRegion.lower[i] = ghostBox_.lower[i];
+               sendRegion.upper[i] = ghostBox_.upper[i];
+            }
+         }
+         recvRegion = sendRegion;
+
+         // Upper owned points to lower ghosts of upper neighbor
+         sendRegion.lower[j] = owned.upper[j] - lowerGhosts_[j];
+         sendRegion.upper[j] = owned.upper[j];
+         recvRegion.lower[j] = ghostBox_.lower[j];
+         recvRegion.upper[j] = owned.lower[j];
+         exchangeSlab(sendRegion, recvRegion, j, 1, false);
+
+         // Lower owned points to upper ghosts of lower neighbor
+         sendRegion.lower[j] = owned.lower[j];
+         sendRegion.upper[j] = owned.lower[j] + upperGhosts_[j];
+         recvRegion.lower[j] = owned.upper[j];
+         recvRegion.upper[j] = ghostBox_.upper[j];
+         exchangeSlab(sendRegion, recvRegion, j, -1, false);
+      }
+   }
+
+   /*
+   * Spread charges and transform from bricks to z pencils.
+   */
+   void SpmePotential::forwardTransform()
+   {
+      makeBricks();
+      makeInfluence();
+      spreadCharges();
+
+      double* x = reinterpret_cast<double*>(&pencils_[0][0]);
+      double* y = reinterpret_cast<double*>(&pencils_[1][0]);
+      double* z = reinterpret_cast<double*>(&pencils_[2][0]);
+      const Box& xBox = pencilBoxes_[0][rank_];
+      const Box& yBox = pencilBoxes_[1][rank_];
+      const Box& zBox = pencilBoxes_[2][rank_];
+
+      remap(remaps_[0], true, &brick_[0], ghostBox_, 1, x, xBox, 2);
+      if (xBox.size() > 0) fftw_execute(forwardPlans_[0]);
+      remap(remaps_[1], true, x, xBox, 2, y, yBox, 2);
+      if (yBox.size() > 0) fftw_execute(forwardPlans_[1]);
+      remap(remaps_[2], true, y, yBox, 2, z, zBox, 2);
+      if (zBox.size() > 0) fftw_execute(forwardPlans_[2]);
+   }
+
+   /*
+   * Transform from z pencils to bricks, and fill ghost layers.
+   */
+   void SpmePotential::backwardTransform()
+   {
+      double* x = reinterpret_cast<double*>(&pencils_[0][0]);
+      double* y = reinterpret_cast<double*>(&pencils_[1][0]);
+      double* z = reinterpret_cast<double*>(&pencils_[2][0]);
+      const Box& xBox = pencilBoxes_[0][rank_];
+      const Box& yBox = pencilBoxes_[1][rank_];
+      const Box& zBox = pencilBoxes_[2][rank_];
+
+      if (zBox.size() > 0) fftw_execute(backwardPlans_[2]);
+      remap(remaps_[2], false, z, zBox, 2, y, yBox, 2);
+      if (yBox.size() > 0) fftw_execute(backwardPlans_[1]);
+      remap(remaps_[1], false, y, yBox, 2, x, xBox, 2);
+      if (xBox.size() > 0) fftw_execute(backwardPlans_[0]);
+      remap(remaps_[0], false, x, xBox, 2, &brick_[0], ghostBox_, 1);
+
+      fillGhosts();
+   }
+
+   /*
+   * Add k-space Coulomb forces to local atoms.
+   */
+   void SpmePotential::addKSpaceForces()
+   {
+      forwardTransform();
+
+      // Electrostatic potential on mesh (no 1/M normalization needed)
+      double volume = boundary().volume();
+      int size = pencilBoxes_[2][rank_].size();
+      int i, j, k;
+      for (i = 0; i < size; ++i) {
+         pencils_[2][i] *= g_[i]/volume;
+      }
+      backwardTransform();
+
+      // Interpolate forces on local atoms
+      AtomIterator atomIter;
+      double theta[Dimension][MaxOrder];
+      double dTheta[Dimension][MaxOrder];
+      Vector b[Dimension];
+      IntVector first, index;
+      Vector s, f, df;
+      double q, u, phi, t0, d0, t1, d1;
+      double sum0, sum1, sum2;
+      double twoPi = 2.0*Constants::Pi;
+      int floorU;
+      for (i = 0; i < Dimension; ++i) {
+         b[i] = boundary().reciprocalBasisVector(i);
+         b[i] *= double(gridDimensions_[i])/twoPi;
+      }
+      for (storage().begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         q = charge(atomIter->typeId());
+         if (q == 0.0) continue;
+         boundary().transformCartToGen(atomIter->position(), s);
+         for (i = 0; i < Dimension; ++i) {
+            u = s[i]*gridDimensions_[i];
+            floorU = int(floor(u));
+            splineWeights(u - floorU, theta[i], dTheta[i]);
+            first[i] = floorU - order_ + 1;
+         }
+
+         // Derivatives of energy with respect to scaled coordinates
+         sum0 = sum1 = sum2 = 0.0;
+         for (i = 0; i < order_; ++i) {
+            index[0] = first[0] + i;
+            t0 = theta[0][i];
+            d0 = dTheta[0][i];
+            for (j = 0; j < order_; ++j) {
+               index[1] = first[1] + j;
+               t1 = theta[1][j];
+               d1 = dTheta[1][j];
+               index[2] = first[2];
+               const double* ptr = &brick_[ghostBox_.offset(index)];
+               for (k = 0; k < order_; ++k) {
+                  phi = ptr[k];
+                  sum0 += d0*t1*theta[2][k]*phi;
+                  sum1 += t0*d1*theta[2][k]*phi;
+                  sum2 += t0*t1*dTheta[2][k]*phi;
+               }
+            }
+         }
+         f.multiply(b[0], sum0);
+         df.multiply(b[1], sum1);
+         f += df;
+         df.multiply(b[2], sum2);
+         f += df;
+         f *= -q;
+         atomIter->force() += f;
+      }
+   }
+
+   /*
+   * Return k-space energy of the z pencils on this processor.
+   */
+   double SpmePotential::kSpaceEnergy()
+   {
+      forwardTransform();
+      double energy = 0.0;
+      int size = pencilBoxes_[2][rank_].size();
+      for (int i = 0; i < size; ++i) {
+         energy += g_[i]*std::norm(pencils_[2][i]);
+      }
+      return energy/(2.0*boundary().volume());
+   }
+
+   /*
+   * Add k-space stress of the z pencils on this processor.
+   */
+   void SpmePotential::addKSpaceStress(Tensor& stress)
+   {
+      forwardTransform();
+
+      Vector b[Dimension];
+      Vector q, dq;
+      Tensor kStress, K;
+      IntVector index, m;
+      double alpha = ewaldInteraction().alpha();
+      double ca = 0.25/(alpha*alpha);
+      double qSq, rhoSq;
+      int i, k;
+      for (i = 0; i < Dimension; ++i) {
+         b[i] = boundary().reciprocalBasisVector(i);
+      }
+      kStress.zero();
+      const Box& box = pencilBoxes_[2][rank_];
+      if (box.size() > 0) {
+         for (index[0] = box.lower[0]; index[0] < box.upper[0]; ++index[0]) {
+          for (index[1] = box.lower[1]; index[1] < box.upper[1]; ++index[1]) {
+           for (index[2] = box.lower[2]; index[2] < box.upper[2]; ++index[2]) {
+               k = box.offset(index);
+               if (g_[k] == 0.0) continue;
+               q.zero();
+               for (i = 0; i < Dimension; ++i) {
+                  m[i] = index[i];
+                  if (2*m[i] > gridDimensions_[i]) {
+                     m[i] -= gridDimensions_[i];
+                  }
+                  dq.multiply(b[i], double(m[i]));
+                  q += dq;
+               }
+               qSq = q.square();
+               rhoSq = std::norm(pencils_[2][k]);
+               K.dyad(q, q);
+               K *= -2.0*(ca + 1.0/qSq);
+               K.add(Tensor::Identity, K);
+               K *= g_[k]*rhoSq;
+               kStress += K;
+           }
+          }
+         }
+      }
+      double volume = boundary().volume();
+      kStress /= 2.0*volume*volume;
+      stress += kStress;
+   }
+
+}
@@ -0,0 +1,347 @@
+#ifndef DDMD_SPME_POTENTIAL_H
+#define DDMD_SPME_POTENTIAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CoulombPotential.h"                // base class
+#include <util/containers/DArray.h>         // member
+#include <util/containers/FArray.h>         // member
+#include <util/space/IntVector.h>           // member
+#include <util/space/Vector.h>              // member
+#include <util/global.h>
+
+#include <complex>
+#include <fftw3.h>
+
+namespace DdMd
+{
+
+   class Simulation;
+
+   using namespace Util;
+
+   /**
+   * Smooth particle-mesh Ewald Coulomb potential, with a distributed mesh.
+   *
+   * The real-space part is evaluated by the CoulombPotential base class,
+   * using the Verlet pair list of the PairPotential. The k-space part is
+   * computed on a mesh of gridDimensions points that is distributed over
+   * all processors, in three stages:
+   *
+   *  - Charge spreading: Each processor owns a brick of mesh points that
+   *    lie within its domain, and spreads the charges of its local atoms
+   *    onto this brick and a surrounding layer of ghost mesh points, with
+   *    cardinal B-spline weights of order 5. Ghost layers are wide enough
+   *    to hold the spline stencil of any atom that has drifted outside
+   *    the domain by up to exchangeSkin/2. Charge assigned to ghost mesh
+   *    points is sent to and added into the owning neighbor bricks, one
+   *    direction at a time.
+   *
+   *  - Distributed FFT: The 3D transform is performed as a sequence of
+   *    1D transforms along x, y and z, using a pencil decomposition in
+   *    which each processor holds complete lines of mesh points along
+   *    one axis. The mesh is redistributed from bricks to x pencils, and
+   *    between pencil orientations, by MPI Alltoallv exchanges in which
+   *    each processor communicates only its own part of the mesh. The
+   *    influence function is applied to the z pencils, and the inverse
+   *    transform follows the same sequence in reverse.
+   *
+   *  - Force interpolation: The electrostatic potential is returned to
+   *    the bricks, ghost layers are filled from neighbors, and forces on
+   *    local atoms are interpolated using analytic derivatives of the
+   *    B-spline weights.
+   *
+   * The k-space energy and stress are sums over the z pencils owned by
+   * each processor, and are combined in a single reduction. The cost of
+   * each evaluation is thus proportional to N/P + M log(M)/P for N atoms,
+   * M mesh points and P processors, and each processor sends and receives
+   * of order M/P values in each redistribution.
+   *
+   * Parameter file format (within the Simulation block):
+   * \code
+   *   SpmePotential{
+   *     epsilon         1.0
+   *     alpha           1.0
+   *     rSpaceCutoff    3.0
+   *     gridDimensions  32  32  32
+   *     charges         1.0   -1.0
+   *   }
+   * \endcode
+   *
+   * \ingroup DdMd_Coulomb_Module
+   */
+   class SpmePotential : public CoulombPotential
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param simulation parent Simulation object.
+      */
+      SpmePotential(Simulation& simulation);
+
+      /**
+      * Destructor (destroy fftw plans).
+      */
+      virtual ~SpmePotential();
+
+      /**
+      * Read parameters and charges.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /// \name Accessors
+      //@{
+
+      /**
+      * Get the number of mesh points along each axis.
+      */
+      const IntVector& gridDimensions() const;
+
+      /**
+      * Get the order of the B-spline charge assignment.
+      */
+      int order() const;
+
+      //@}
+
+   protected:
+
+      /**
+      * Add k-space forces to the forces on local atoms.
+      */
+      virtual void addKSpaceForces();
+
+      /**
+      * Return the k-space energy of the z pencils on this processor.
+      */
+      virtual double kSpaceEnergy();
+
+      /**
+      * Add the k-space stress of the z pencils on this processor.
+      *
+      * \param stress local stress accumulator (incremented)
+      */
+      virtual void addKSpaceStress(Tensor& stress);
+
+   private:
+
+      typedef std::complex<double> Complex;
+
+      /**
+      * A rectangular block of mesh points, and its storage order.
+      *
+      * A box contains points with lower[i] <= index[i] < upper[i] for
+      * each axis i, and is stored with axis fast varying most rapidly.
+      * Indices of ghost mesh points may lie outside [0, gridDimension).
+      */
+      struct Box
+      {
+         IntVector lower;
+         IntVector upper;
+         int fast;
+
+         /// Number of points in box (0 if empty).
+         int size() const;
+
+         /// Storage position of a point, in units of points.
+         int offset(const IntVector& index) const;
+      };
+
+      /**
+      * Plan for redistribution of the mesh between two decompositions.
+      *
+      * Counts and displacements are in units of doubles, for use with
+      * Alltoallv. Boxes are intersections of the boxes owned by this
+      * processor and by each other processor.
+      */
+      struct Remap
+      {
+         DArray<Box> sendBoxes;
+         DArray<Box> recvBoxes;
+         DArray<int> sendCounts;
+         DArray<int> sendDispls;
+         DArray<int> recvCounts;
+         DArray<int> recvDispls;
+         int nComponent;
+      };
+
+      /// Number of mesh points along each axis.
+      IntVector gridDimensions_;
+
+      /// Mesh bricks owned by each processor, indexed by rank.
+      DArray<Box> brickBoxes_;
+
+      /// Pencil boxes for each axis, indexed by rank.
+      FArray< DArray<Box>, Dimension> pencilBoxes_;
+
+      /// Storage box of local brick, including ghost layers.
+      Box ghostBox_;
+
+      /// Width of lower ghost layers along each axis.
+      IntVector lowerGhosts_;
+
+      /// Width of upper ghost layers along each axis.
+      IntVector upperGhosts_;
+
+      /// Charge and potential on local brick, with ghost layers.
+      DArray<double> brick_;
+
+      /// Mesh data in pencils along each axis.
+      FArray< DArray<Complex>, Dimension> pencils_;
+
+      /// Influence function on local z pencils.
+      DArray<double> g_;
+
+      /// Squared modulus of B-spline structure factor, for each axis.
+      FArray< DArray<double>, Dimension> bSq_;
+
+      /// Remap plans: brick to x, x to y, and y to z pencils.
+      FArray<Remap, Dimension> remaps_;
+
+      /// Send buffer for remaps and ghost exchange.
+      DArray<double> sendBuffer_;
+
+      /// Receive buffer for remaps and ghost exchange.
+      DArray<double> recvBuffer_;
+
+      /// Domain grid bounds for which brick boxes were constructed.
+      FArray< DArray<double>, Dimension> gridBounds_;
+
+      /// Boundary lengths for which g_ was computed.
+      Vector waveLengths_;
+
+      /// Forward fft plans for pencils along each axis.
+      FArray<fftw_plan, Dimension> forwardPlans_;
+
+      /// Backward fft plans for pencils along each axis.
+      FArray<fftw_plan, Dimension> backwardPlans_;
+
+      /// Order of B-spline charge assignment.
+      int order_;
+
+      /// Number of processors.
+      int nProc_;
+
+      /// Rank of this processor in domain communicator.
+      int rank_;
+
+      /// Have pencil layouts and fft plans been created?
+      bool hasPencils_;
+
+      /**
+      * Allocate pencils and create fft plans (once).
+      */
+      void makePencils();
+
+      /**
+      * Construct bricks, ghost layers and brick remap, if needed.
+      */
+      void makeBricks();
+
+      /**
+      * Compute B-spline factors and influence function, if needed.
+      */
+      void makeInfluence();
+
+      /**
+      * Construct a remap plan between two decompositions.
+      */
+      void makeRemap(const DArray<Box>& source, const DArray<Box>& dest,
+                     int nComponent, Remap& remap);
+
+      /**
+      * Redistribute mesh data using a remap plan.
+      *
+      * If forward, send data from the source to the dest decomposition
+      * of the plan, otherwise from dest to source. Arrays source and
+      * dest store sourceStride and destStride doubles per point (1 for
+      * real, 2 for complex), of which nComponent are sent.
+      */
+      void remap(Remap& plan, bool forward,
+                 const double* source, const Box& sourceBox, int sourceStride,
+                 double* dest, const Box& destBox, int destStride);
+
+      /**
+      * Compute intersection of two boxes (returns false if empty).
+      */
+      static bool intersect(const Box& a, const Box& b, Box& c);
+
+      /**
+      * Compute B-spline weights and derivatives for one coordinate.
+      *
+      * On return, theta[j] is the weight of mesh point floor(u) - order
+      * + 1 + j for a charge at scaled coordinate u = floor(u) + w, and
+      * dTheta[j] is the derivative of this weight with respect to u.
+      *
+      * \param w      fractional part of scaled coordinate, in [0,1)
+      * \param theta  array of order weights (output)
+      * \param dTheta array of order derivatives (output)
+      */
+      void splineWeights(double w, double* theta, double* dTheta) const;
+
+      /**
+      * Spread local charges onto brick and send ghost charge to owners.
+      */
+      void spreadCharges();
+
+      /**
+      * Copy owned potential values into ghost layers of neighbors.
+      */
+      void fillGhosts();
+
+      /**
+      * Forward transform charges from bricks to z pencils.
+      */
+      void forwardTransform();
+
+      /**
+      * Backward transform from z pencils to bricks, and fill ghosts.
+      */
+      void backwardTransform();
+
+      /**
+      * Send one slab of the brick to a neighbor and receive another.
+      *
+      * \param sendRegion region of ghostBox_ to send
+      * \param recvRegion region of ghostBox_ to receive into
+      * \param axis       axis along which neighbors are displaced
+      * \param direction  +1 to send to upper neighbor, -1 for lower
+      * \param add        if true, add received values, else copy
+      */
+      void exchangeSlab(const Box& sendRegion, const Box& recvRegion,
+                        int axis, int direction, bool add);
+
+   };
+
+   inline const IntVector& SpmePotential::gridDimensions() const
+   {  return gridDimensions_; }
+
+   inline int SpmePotential::order() const
+   {  return order_; }
+
+}
+#endif
@@ -18,6 +18,9 @@ namespace DdMd
    DihedralPotential::DihedralPotential(Simulation& simulation)
     : boundaryPtr_(&simulation.boundary()),
       storagePtr_(&simulation.dihedralStorage())
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(&simulation.atomStorage())
+      #endif
    {  setClassName("DihedralPotential");  }
 
    /*
@@ -26,6 +29,9 @@ namespace DdMd
    DihedralPotential::DihedralPotential()
     : boundaryPtr_(0),
       storagePtr_(0)
+      #ifdef DDMD_OPENMP
+      , atomStoragePtr_(0)
+      #endif
    {  setClassName("DihedralPotential");  }
 
    /*
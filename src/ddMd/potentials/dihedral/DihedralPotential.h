@@ -19,6 +19,7 @@ namespace DdMd
    using namespace Util;
 
    class Simulation;
+   class AtomStorage;
    template <int N> class GroupStorage;
 
    /**
@@ -139,6 +140,15 @@ namespace DdMd
       */
       GroupStorage<4>& storage() const;
 
+      #ifdef DDMD_OPENMP
+      /**
+      *  Return pointer to the atom storage (null if not associated).
+      *
+      *  Used to access per-thread force accumulators.
+      */
+      AtomStorage* atomStoragePtr() const;
+      #endif
+
    private:
 
       // Pointer to associated Boundary object.
@@ -147,6 +157,11 @@ namespace DdMd
       // Pointer to associated GroupStorage<4> object.
       GroupStorage<4>* storagePtr_;
 
+      #ifdef DDMD_OPENMP
+      // Pointer to associated AtomStorage object (null in unit tests).
+      AtomStorage* atomStoragePtr_;
+      #endif
+
    };
 
    // Get boundary by reference.
@@ -157,5 +172,10 @@ namespace DdMd
    inline GroupStorage<4>& DihedralPotential::storage() const
    { return *storagePtr_; }
 
+   #ifdef DDMD_OPENMP
+   inline AtomStorage* DihedralPotential::atomStoragePtr() const
+   { return atomStoragePtr_; }
+   #endif
+
 }
 #endif
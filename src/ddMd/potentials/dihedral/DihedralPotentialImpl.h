@@ -190,7 +190,9 @@ namespace DdMd
       /**
       * Compute the covalent dihedral stress.
       *
-      * Call on all processors.
+      * If an associated AtomStress is active, this also adds per-atom
+      * dihedral energies and virials to it, and recomputes the stress
+      * even if it is already set. Call on all processors.
       */
       #ifdef UTIL_MPI
       virtual void computeStress(MPI::Intracomm& communicator);
@@ -212,12 +214,20 @@ namespace DdMd
       */
       bool isInitialized_;
 
+      #ifdef DDMD_OPENMP
+      /**
+      * Compute forces using OpenMP threads and per-thread accumulators.
+      */
+      void computeForcesThreaded();
+      #endif
+
    };
 
 }
 
 #include "DihedralPotential.h"
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/AtomStress.h>
 #include <ddMd/storage/GroupStorage.h>
 #include <ddMd/storage/GroupIterator.h>
 #include <util/boundary/Boundary.h>
@@ -231,6 +241,11 @@ namespace DdMd
 
 #include <fstream>
 
+#ifdef DDMD_OPENMP
+#include <ddMd/storage/AtomStorage.h>
+#include <omp.h>
+#endif
+
 namespace DdMd
 {
 
@@ -385,6 +400,13 @@ namespace DdMd
       Atom* atom3Ptr;
       int   type;
 
+      #ifdef DDMD_OPENMP
+      if (atomStoragePtr()) {
+         computeForcesThreaded();
+         return;
+      }
+      #endif
+
       // Loop over dihedral groups
       for (storage().begin(iter); iter.notEnd(); ++iter) {
          type = iter->typeId();
@@ -420,6 +442,64 @@ namespace DdMd
       }
    }
 
+   #ifdef DDMD_OPENMP
+   /*
+   * Add dihedral forces to atomic forces, using threads (private).
+   */
+   template <class Interaction>
+   void DihedralPotentialImpl<Interaction>::computeForcesThreaded()
+   {
+      AtomStorage& atomStorage = *atomStoragePtr();
+      GroupStorage<4>& dihedralStorage = storage();
+      const int nDihedral = dihedralStorage.size();
+      atomStorage.beginThreadForces();
+
+      #pragma omp parallel
+      {
+         Vector dr1, dr2, dr3, f1, f2, f3, df;
+         Atom* atom0Ptr;
+         Atom* atom1Ptr;
+         Atom* atom2Ptr;
+         Atom* atom3Ptr;
+         int   i, type;
+         const int t = omp_get_thread_num();
+
+         #pragma omp for schedule(static)
+         for (i = 0; i < nDihedral; ++i) {
+            Group<4>& dihedral = dihedralStorage.group(i);
+            type = dihedral.typeId();
+            atom0Ptr = dihedral.atomPtr(0);
+            atom1Ptr = dihedral.atomPtr(1);
+            atom2Ptr = dihedral.atomPtr(2);
+            atom3Ptr = dihedral.atomPtr(3);
+            boundary().distanceSq(atom1Ptr->position(),
+                                  atom0Ptr->position(), dr1);
+            boundary().distanceSq(atom2Ptr->position(),
+                                  atom1Ptr->position(), dr2);
+            boundary().distanceSq(atom3Ptr->position(),
+                                  atom2Ptr->position(), dr3);
+            interaction().force(dr1, dr2, dr3, f1, f2, f3, type);
+            if (!atom0Ptr->isGhost()) {
+               atomStorage.addThreadForce(t, *atom0Ptr, f1);
+            }
+            if (!atom1Ptr->isGhost()) {
+               df.subtract(f2, f1);
+               atomStorage.addThreadForce(t, *atom1Ptr, df);
+            }
+            if (!atom2Ptr->isGhost()) {
+               df.subtract(f3, f2);
+               atomStorage.addThreadForce(t, *atom2Ptr, df);
+            }
+            if (!atom3Ptr->isGhost()) {
+               atomStorage.subtractThreadForce(t, *atom3Ptr, f3);
+            }
+         }
+      } // omp parallel
+
+      atomStorage.endThreadForces(false);
+   }
+   #endif
+
    /*
    * Compute total dihedral energy on all processors.
    */
@@ -492,10 +572,13 @@ namespace DdMd
    void DihedralPotentialImpl<Interaction>::computeStress()
    #endif
    {
-      // If stress is already set, do nothing and return.
-      if (isStressSet()) return;
+      // If stress is already set, do nothing and return, unless
+      // per-atom contributions are needed
+      AtomStress* atomStressPtr = activeAtomStress();
+      if (isStressSet() && !atomStressPtr) return;
 
       Tensor localStress;
+      Tensor virial;
       Vector dr1, dr2, dr3;
       Vector f1,  f2, f3;
       double factor;
@@ -526,7 +609,20 @@ namespace DdMd
                                atom2Ptr->position(), dr3);
 
          // Calculate derivatives of energy with respect to dr1, dr2, dr3
-         interaction().force(dr1, dr2, dr2, f1, f2, f3, type);
+         interaction().force(dr1, dr2, dr3, f1, f2, f3, type);
+
+         // Add shares of group energy and virial to local atoms
+         if (atomStressPtr) {
+            Atom* atomPtrs[4] = {atom0Ptr, atom1Ptr, atom2Ptr, atom3Ptr};
+            virial.zero();
+            incrementPairStress(f1, dr1, virial);
+            incrementPairStress(f2, dr2, virial);
+            incrementPairStress(f3, dr3, virial);
+            virial *= -1.0;
+            atomStressPtr->addGroup(atomPtrs,
+                                    interaction().energy(dr1, dr2, dr3, type),
+                                    virial);
+         }
 
          isLocal0 = !(atom0Ptr->isGhost());
          isLocal1 = !(atom1Ptr->isGhost());
@@ -166,6 +166,22 @@ namespace DdMd
       virtual void computeEnergy();
       #endif
 
+      /**
+      * Compute external forces and energy in one pass over atoms.
+      *
+      * Uses Interaction::evaluate() to obtain the energy and force on
+      * each atom together. Call on all processors.
+      *
+      * \param communicator domain communicator
+      * \param needStress   ignored (external forces add no stress)
+      */
+      #ifdef UTIL_MPI
+      virtual void computeForcesAndEnergy(MPI::Intracomm& communicator,
+                                          bool needStress);
+      #else
+      virtual void computeForcesAndEnergy(bool needStress);
+      #endif
+
       //@}
 
    private:
@@ -364,6 +380,29 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Compute forces and total external energy in one pass.
+   */
+   template <class Interaction>
+   #ifdef UTIL_MPI
+   void 
+   ExternalPotentialImpl<Interaction>::computeForcesAndEnergy(MPI::Intracomm& communicator, bool needStress)
+   #else
+   void ExternalPotentialImpl<Interaction>::computeForcesAndEnergy(bool needStress)
+   #endif
+   {
+      if (isEnergySet()) {
+         computeForces(true, false);
+         return;
+      }
+      double localEnergy = computeForces(true, true); 
+      #ifdef UTIL_MPI
+      reduceEnergy(localEnergy, communicator);
+      #else
+      setEnergy(localEnergy);
+      #endif
+   }
+
    /*
    * Increment atomic forces and/or external energy (private).
    */
@@ -377,6 +416,15 @@ namespace DdMd
       int type;
 
       storage().begin(iter);
+      if (needForce && needEnergy) {
+         double e;
+         for ( ; iter.notEnd(); ++iter) {
+            interactionPtr_->evaluate(iter->position(), iter->typeId(), e, f);
+            iter->force() += f;
+            energy += e;
+         }
+         return energy;
+      }
       for ( ; iter.notEnd(); ++iter) {
          type = iter->typeId();
          if (needEnergy) {
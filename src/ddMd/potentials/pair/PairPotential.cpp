@@ -14,6 +14,7 @@
 #include <ddMd/neighbor/PairList.h>
 #include <ddMd/neighbor/CellList.h>
 #include <ddMd/communicate/Domain.h>
+#include <ddMd/misc/BoundaryMetric.h>
 #include <util/mpi/MpiLoader.h>
 #include <util/space/Vector.h>
 #include <util/global.h>
@@ -28,13 +29,23 @@ namespace DdMd
    PairPotential::PairPotential()
     : skin_(0.0),
       cutoff_(0.0),
+      exchangeSkin_(0.0),
       pairCapacity_(0),
+      compactPairList_(false),
+      typePairList_(false),
+      minTypeCutoff_(0.0),
       domainPtr_(0),
       boundaryPtr_(0),
       storagePtr_(0),
       methodId_(0),
+      blockSize_(16),
+      halfShell_(false),
       nPair_(0),
-      pairEnergies_()
+      pairEnergies_(),
+      epsilonDerivative_(0.0),
+      derivativeTypeId1_(-1),
+      derivativeTypeId2_(-1),
+      isEpsilonDerivativeSet_(false)
    {  setClassName("PairPotential"); } 
 
    /*
@@ -43,13 +54,23 @@ namespace DdMd
    PairPotential::PairPotential(Simulation& simulation)
     : skin_(0.0),
       cutoff_(0.0),
+      exchangeSkin_(0.0),
       pairCapacity_(0),
+      compactPairList_(false),
+      typePairList_(false),
+      minTypeCutoff_(0.0),
       domainPtr_(&simulation.domain()),
       boundaryPtr_(&simulation.boundary()),
       storagePtr_(&simulation.atomStorage()),
       methodId_(0),
+      blockSize_(16),
+      halfShell_(false),
       nPair_(0),
-      pairEnergies_()
+      pairEnergies_(),
+      epsilonDerivative_(0.0),
+      derivativeTypeId1_(-1),
+      derivativeTypeId2_(-1),
+      isEpsilonDerivativeSet_(false)
    {  setClassName("PairPotential"); } 
 
    /*
@@ -83,15 +104,44 @@ namespace DdMd
       allocate();
    }
 
+   /*
+   * Change the pair list skin.
+   */
+   void PairPotential::setSkin(double skin)
+   {
+      UTIL_CHECK(skin > 0.0);
+      skin_ = skin;
+      cutoff_ = maxPairCutoff() + skin;
+      pairList_.setCutoff(cutoff_);
+   }
+
+   /*
+   * Set a lower bound on pair list cutoffs for pairs of types.
+   */
+   void PairPotential::setMinTypeCutoff(double cutoff)
+   {
+      UTIL_CHECK(cutoff >= 0.0);
+      minTypeCutoff_ = cutoff;
+   }
+
    /*
    * Read parameters for PairList and allocate memory.  
    */
    void PairPotential::readParameters(std::istream& in)
    {
       read<double>(in, "skin", skin_);
+      exchangeSkin_ = 0.0; // Default value for optional parameter
+      readOptional<double>(in, "exchangeSkin", exchangeSkin_);
+      if (exchangeSkin_ > 0.0 && exchangeSkin_ < skin_) {
+         UTIL_THROW("exchangeSkin < skin");
+      }
       nCellCut_ = 1; // Default value for optional parameter
       readOptional<int>(in, "nCellCut", nCellCut_); 
       read<int>(in, "pairCapacity", pairCapacity_);
+      compactPairList_ = false;
+      readOptional<bool>(in, "compactPairList", compactPairList_);
+      typePairList_ = false;
+      readOptional<bool>(in, "typePairList", typePairList_);
       read<Boundary>(in, "maxBoundary", maxBoundary_);
       cutoff_ = maxPairCutoff() + skin_;
       allocate();
@@ -104,8 +154,14 @@ namespace DdMd
    {
   
       loadParameter<double>(ar, "skin", skin_);
+      exchangeSkin_ = 0.0;
+      loadParameter<double>(ar, "exchangeSkin", exchangeSkin_, false);
       loadParameter<int>(ar, "nCellCut", nCellCut_, false);
       loadParameter<int>(ar, "pairCapacity", pairCapacity_);
+      compactPairList_ = false;
+      loadParameter<bool>(ar, "compactPairList", compactPairList_, false);
+      typePairList_ = false;
+      loadParameter<bool>(ar, "typePairList", typePairList_, false);
       loadParameter<Boundary>(ar, "maxBoundary", maxBoundary_);
 
       MpiLoader<Serializable::IArchive> loader(*this, ar);
@@ -120,13 +176,27 @@ namespace DdMd
    void PairPotential::save(Serializable::OArchive& ar)
    {
       ar << skin_;
+      Parameter::saveOptional(ar, exchangeSkin_, (exchangeSkin_ > 0.0));
       Parameter::saveOptional(ar, nCellCut_, true);
       ar << pairCapacity_;
+      Parameter::saveOptional(ar, compactPairList_, compactPairList_);
+      Parameter::saveOptional(ar, typePairList_, typePairList_);
       ar << maxBoundary_;
       ar << cutoff_;
       ar << methodId_;
    }
 
+   /*
+   * Enable or disable half-shell ghost communication.
+   */
+   void PairPotential::setHalfShell(bool halfShell)
+   {
+      if (halfShell && methodId_ != 0) {
+         UTIL_THROW("Half-shell scheme requires pair list (methodId 0)");
+      }
+      halfShell_ = halfShell;
+   }
+
    /*
    * Allocate memory for the cell list and pair list.
    *
@@ -136,6 +206,10 @@ namespace DdMd
    {
       // Allocate PairList
       int localCapacity = storage().atomCapacity();
+      if (compactPairList_) {
+         pairList_.setCompact(&storage().localAtomArray()[0], 
+                              &storage().ghostAtomArray()[0]);
+      }
       pairList_.allocate(localCapacity, pairCapacity_, cutoff_);
 
       // Calculate cell list cutoff lengths for all directions
@@ -145,11 +219,12 @@ namespace DdMd
       for (int i = 0; i < Dimension; ++i) {
          lower[i] = domain().domainBound(i, 0);
          upper[i] = domain().domainBound(i, 1);
-         cutoffs[i] = cutoff_/maxBoundary_.length(i);
+         cutoffs[i] = scaledWidth(maxBoundary_, ghostCutoff(), i);
       }
 
       // Allocate CellList
       int totalCapacity = localCapacity + storage().ghostCapacity();
+      cellList_.setHalfShell(halfShell_);
       cellList_.allocate(totalCapacity, lower, upper, cutoffs, nCellCut_);
    }
 
@@ -162,15 +237,25 @@ namespace DdMd
          UTIL_THROW("Coordinates are Cartesian entering buildCellList");
       }
 
+      // Follow any growth of atom storage (see AtomStorage::grow)
+      int totalCapacity = storage().atomCapacity() + storage().ghostCapacity();
+      if (totalCapacity > cellList_.atomCapacity()) {
+         cellList_.reserveAtoms(totalCapacity);
+         pairList_.resetAtoms(storage().atomCapacity(),
+                              &storage().localAtomArray()[0],
+                              &storage().ghostAtomArray()[0]);
+      }
+
       // Set cutoff and domain bounds.
       Vector cutoffs;
       Vector lower;
       Vector upper;
       for (int i = 0; i < Dimension; ++i) {
-         cutoffs[i] = cutoff_/boundaryPtr_->length(i);
+         cutoffs[i] = scaledWidth(*boundaryPtr_, ghostCutoff(), i);
          lower[i] = domain().domainBound(i, 0);
          upper[i] = domain().domainBound(i, 1);
       }
+      cellList_.setOrthogonal(isOrthogonal(*boundaryPtr_));
       cellList_.makeGrid(lower, upper, cutoffs, nCellCut_);
       cellList_.clear();
 
@@ -208,19 +293,19 @@ namespace DdMd
       if (!storage().isCartesian()) {
          UTIL_THROW("Coordinates not Cartesian entering buildPairList");
       }
-      pairList_.build(cellList_, reverseUpdateFlag());
+      pairList_.build(cellList_, reverseUpdateFlag(), halfShell_);
    }
 
    /*
    * Return value of pair energies.
    */
-   DMatrix<double> PairPotential::pairEnergies() const
+   const DMatrix<double>& PairPotential::pairEnergies() const
    {  return pairEnergies_.value(); }
 
    /*
    * Set a value for pair energies.
    */
-   void PairPotential::setPairEnergies(DMatrix<double> pairEnergies)
+   void PairPotential::setPairEnergies(const DMatrix<double>& pairEnergies)
    {  pairEnergies_.set(pairEnergies); }
 
    /*
@@ -229,6 +314,100 @@ namespace DdMd
    void PairPotential::unsetPairEnergies()
    {  pairEnergies_.unset(); }
 
+   /*
+   * Request derivative of energy with respect to epsilon(i, j).
+   */
+   void PairPotential::requestEpsilonDerivative(int typeId1, int typeId2)
+   {
+      if (typeId1 < 0 || typeId2 < 0) {
+         UTIL_THROW("Negative atom type index");
+      }
+      if (hasEpsilonDerivative() && !isDerivativePair(typeId1, typeId2)) {
+         UTIL_THROW("Epsilon derivative requested for two type pairs");
+      }
+      // Throws if the interaction has no parameter epsilon
+      get("epsilon", typeId1, typeId2);
+      derivativeTypeId1_ = typeId1;
+      derivativeTypeId2_ = typeId2;
+      isEpsilonDerivativeSet_ = false;
+   }
+
+   /*
+   * Return epsilon derivative (call on master).
+   */
+   double PairPotential::epsilonDerivative() const
+   {
+      if (!isEpsilonDerivativeSet_) {
+         UTIL_THROW("Epsilon derivative is not set");
+      }
+      return epsilonDerivative_;
+   }
+
+   /*
+   * Reduce energy and epsilon derivative sums in one reduction.
+   */
+   #ifdef UTIL_MPI
+   void PairPotential::reduceEnergyAndDerivative(double localEnergy,
+                                                 double localDerivative,
+                                                 MPI::Intracomm& communicator)
+   {
+      if (!hasEpsilonDerivative()) {
+         reduceEnergy(localEnergy, communicator);
+         return;
+      }
+      double local[2];
+      double total[2];
+      local[0] = localEnergy;
+      local[1] = localDerivative;
+      total[0] = 0.0;
+      total[1] = 0.0;
+      communicator.Reduce(local, total, 2, MPI::DOUBLE, MPI::SUM, 0);
+      if (communicator.Get_rank() != 0) {
+         total[0] = 0.0;
+         total[1] = 0.0;
+      }
+      setEnergy(total[0]);
+      epsilonDerivative_ =
+          total[1]/get("epsilon", derivativeTypeId1_, derivativeTypeId2_);
+      isEpsilonDerivativeSet_ = true;
+   }
+   #else
+   void PairPotential::reduceEnergyAndDerivative(double localEnergy,
+                                                 double localDerivative)
+   {
+      reduceEnergy(localEnergy);
+      if (hasEpsilonDerivative()) {
+         reduceDerivative(localDerivative);
+      }
+   }
+   #endif
+
+   /*
+   * Reduce epsilon derivative sum from all processors.
+   */
+   #ifdef UTIL_MPI
+   void PairPotential::reduceDerivative(double localDerivative,
+                                        MPI::Intracomm& communicator)
+   {
+      double total = 0.0;
+      communicator.Reduce(&localDerivative, &total, 1,
+                          MPI::DOUBLE, MPI::SUM, 0);
+      if (communicator.Get_rank() != 0) {
+         total = 0.0;
+      }
+      epsilonDerivative_ =
+          total/get("epsilon", derivativeTypeId1_, derivativeTypeId2_);
+      isEpsilonDerivativeSet_ = true;
+   }
+   #else
+   void PairPotential::reduceDerivative(double localDerivative)
+   {
+      epsilonDerivative_ = localDerivative
+          /get("epsilon", derivativeTypeId1_, derivativeTypeId2_);
+      isEpsilonDerivativeSet_ = true;
+   }
+   #endif
+
    /*
    * Compute total pair nPair on all processors.
    */
@@ -280,7 +459,7 @@ namespace DdMd
       if (reverseUpdateFlag()) {
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
             iter.getPair(atom0Ptr, atom1Ptr);
-            assert(!atom0Ptr->isGhost());
+            assert(halfShell_ || !atom0Ptr->isGhost());
             f.subtract(atom0Ptr->position(), atom1Ptr->position());
             rsq = f.square();
             if (rsq < cutoffSq) {
@@ -317,12 +496,12 @@ namespace DdMd
       Atom*  atomPtr0;
       Atom*  atomPtr1;
       const Cell*  cellPtr;
-      int na, nn, i, j;
+      int na, nn, i, j, k;
       int count = 0;
 
-      // Iterate over linked list of local cells.
-      cellPtr = cellList_.begin();
-      while (cellPtr) {
+      // Iterate over non-empty local cells.
+      for (k = 0; k < cellList_.nOccupiedLocalCell(); ++k) {
+         cellPtr = &cellList_.occupiedCell(k);
          cellPtr->getNeighbors(neighbors, reverseUpdateFlag());
          na = cellPtr->nAtom();
          nn = neighbors.size();
@@ -367,8 +546,7 @@ namespace DdMd
             }
 
          }
-         cellPtr = cellPtr->nextCellPtr();
-      } // while (cellPtr) 
+      } // for k
       return count;
    }
 
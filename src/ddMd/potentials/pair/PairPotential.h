@@ -107,6 +107,31 @@ namespace DdMd
       void 
       initialize(const Boundary& maxBoundary, double skin, int pairCapacity);
 
+      /**
+      * Change the pair list skin, and thus the pair list cutoff.
+      *
+      * The new cutoff is used by the next cell list and pair list build.
+      * Ghost atoms must be re-identified with the new cutoff, by calling
+      * Exchanger::setPairCutoff(ghostCutoff()) and exchanging atoms,
+      * before the next pair list build.
+      *
+      * \param skin  new pair list skin length (> 0)
+      */
+      void setSkin(double skin);
+
+      /**
+      * Set a lower bound on the pair list cutoff of every pair of types.
+      *
+      * A CoulombPotential evaluates its real-space part with the pair
+      * list of this PairPotential, and calls this function with its
+      * real-space cutoff, so that pairs beyond the pair interaction
+      * cutoff but within the Coulomb cutoff are retained when the
+      * typePairList option is enabled.
+      *
+      * \param cutoff  minimum pair list force cutoff for any type pair
+      */
+      virtual void setMinTypeCutoff(double cutoff);
+
       /**
       * Initialize, by reading parameters and allocating memory for PairList.
       *
@@ -140,6 +165,31 @@ namespace DdMd
       */
       void setMethodId(int methodId);
 
+      /**
+      * Set number of pairs per block in the blocked pair list loop.
+      *
+      * The blocked loop is used by the serial pair list force loop when
+      * reverse communication is disabled. Allowed values are 8, 16, 32
+      * and 64, each of which is a separate template instantiation of
+      * that loop. The default is 16.
+      *
+      * \param blockSize number of pairs per block
+      */
+      void setBlockSize(int blockSize);
+
+      /**
+      * Enable or disable the half-shell ghost communication scheme.
+      *
+      * In this scheme, ghosts are received only from domains with higher
+      * grid coordinates, and the pair list also contains pairs of two
+      * ghost atoms (see Exchanger::setHalfShell() and Plan). This requires
+      * reverse communication and methodId = 0. Must be called before
+      * memory is allocated by readParameters() or loadParameters().
+      *
+      * \param halfShell true to enable half-shell scheme
+      */
+      void setHalfShell(bool halfShell);
+
       //@}
       /// \name Interaction interface
       //@{
@@ -219,6 +269,30 @@ namespace DdMd
       */
       void buildPairList();
 
+      /**
+      * Add forces for pairs of local atoms, for a range of primary atoms.
+      *
+      * Adds forces for all pairs in the pair list in which both atoms
+      * are local, for primary atom indices begin <= i < end within the
+      * PairList. This requires no ghost positions, and so may be called
+      * while ghost positions are being updated. Use only for methodId 0
+      * (pair list). Calling this for all ranges that together cover
+      * [0, pairList().nAtom()), plus computeBoundaryForces(), is 
+      * equivalent to computeForces().
+      *
+      * \param begin  index of first primary atom
+      * \param end    index one past last primary atom
+      */
+      virtual void computeInteriorForces(int begin, int end) = 0;
+
+      /**
+      * Add forces for pairs with a ghost atom, using the pair list.
+      *
+      * Complement of computeInteriorForces(). Call only after ghost 
+      * positions have been updated.
+      */
+      virtual void computeBoundaryForces() = 0;
+
       /**
       * Compute pair energies on all processors.
       *
@@ -237,14 +311,71 @@ namespace DdMd
       *
       * This method should only be called on the master (rank 0) 
       * processor, after a previous call to computePairEnergies.
+      * The returned reference is valid until the next call to
+      * computePairEnergies or unsetPairEnergies.
       */
-      DMatrix<double> pairEnergies() const;
+      const DMatrix<double>& pairEnergies() const;
 
       /**
       * Mark pair energy as unknown (nullify).
       */
       void unsetPairEnergies();
 
+      //@}
+      /// \name Free energy derivative
+      //@{
+
+      /**
+      * Request the derivative of the energy with respect to epsilon(i, j).
+      *
+      * After this is called, computeForcesAndEnergy() also sums the
+      * energy of pairs of atoms of types i and j, in the same loop, and
+      * divides the total by epsilon(i, j) to obtain the derivative. This
+      * is exact for interactions whose energy is proportional to epsilon,
+      * such as LJPair. Only one type pair may be requested. Call on all
+      * processors.
+      *
+      * \param typeId1 type of atom 1
+      * \param typeId2 type of atom 2
+      */
+      void requestEpsilonDerivative(int typeId1, int typeId2);
+
+      /**
+      * Compute the requested epsilon derivative in a separate loop.
+      *
+      * Used if the derivative was not computed with the forces. Call on
+      * all processors.
+      */
+      #ifdef UTIL_MPI
+      virtual void computeEpsilonDerivative(MPI::Intracomm& communicator) = 0;
+      #else
+      virtual void computeEpsilonDerivative() = 0;
+      #endif
+
+      /**
+      * Has an epsilon derivative been requested?
+      */
+      bool hasEpsilonDerivative() const;
+
+      /**
+      * Has the epsilon derivative been computed for this configuration?
+      *
+      * Returns the same value on all processors.
+      */
+      bool isEpsilonDerivativeSet() const;
+
+      /**
+      * Return derivative of total energy with respect to epsilon.
+      *
+      * Call only on the master processor, if isEpsilonDerivativeSet().
+      */
+      double epsilonDerivative() const;
+
+      /**
+      * Mark epsilon derivative as unknown.
+      */
+      void unsetEpsilonDerivative();
+
       /**
       * Compute twice the number of pairs within the force cutoff.
       *  
@@ -290,11 +421,41 @@ namespace DdMd
       */
       double cutoff() const;
 
+      /**
+      * Get value of the ghost communication skin.
+      *
+      * This is the optional exchangeSkin parameter, or skin() if it is
+      * absent or smaller than skin(). If exchangeSkin() > skin(), ghosts
+      * are identified within a wider shell, and the pair list may be
+      * rebuilt from existing ghosts without an atom exchange as long as
+      * no atom has moved farther than (exchangeSkin() - skin())/2 since
+      * the last exchange.
+      */
+      double exchangeSkin() const;
+
+      /**
+      * Get value of the ghost cutoff (maxPairCutoff + exchangeSkin).
+      *
+      * This is the width of the ghost shell, and the minimum cell size
+      * of the cell list.
+      */
+      double ghostCutoff() const;
+
       /**
       * Return integer id for algorithm (0=PAIR, 1=CELL, 2=NSQ)
       */
       int methodId() const;
 
+      /**
+      * Return number of pairs per block in the blocked pair list loop.
+      */
+      int blockSize() const;
+
+      /**
+      * Is the half-shell ghost communication scheme enabled?
+      */
+      bool halfShell() const;
+
    protected:
 
       /// CellList to construct PairList or calculate nonbonded pair forces.
@@ -309,15 +470,27 @@ namespace DdMd
       /// Difference between pairlist cutoff and pair potential cutoff. 
       double skin_;
 
-      /// Minimum cell size = pair potential cutoff + skin.
+      /// Pair list cutoff = pair potential cutoff + skin.
       double cutoff_;
 
+      /// Ghost communication skin (0 if equal to skin_).
+      double exchangeSkin_;
+
       /// Approximate number of cells per cutoff distance in each direction.
       int nCellCut_;
 
       /// Maximum number of nonbonded pairs in pair list. 
       int pairCapacity_;
 
+      /// Store secondary atoms in pair list as 32 bit array indices?
+      bool compactPairList_;
+
+      /// Use a separate pair list cutoff for each pair of atom types?
+      bool typePairList_;
+
+      /// Lower bound on pair list cutoffs for pairs of types (0 if unset).
+      double minTypeCutoff_;
+
       /**
       * Get the PairList by const reference.
       */
@@ -336,7 +509,47 @@ namespace DdMd
       /**
       * Set values for pair energies.
       */
-      void setPairEnergies(DMatrix<double> pairEnergies);
+      void setPairEnergies(const DMatrix<double>& pairEnergies);
+
+      /**
+      * Is a pair of atom types the type pair of the epsilon derivative?
+      *
+      * \param type0 type of atom 0
+      * \param type1 type of atom 1
+      */
+      bool isDerivativePair(int type0, int type1) const;
+
+      /**
+      * Reduce energy and sum for the epsilon derivative, and set both.
+      *
+      * The two local sums are combined in a single reduction. If no
+      * derivative was requested, this is equivalent to reduceEnergy().
+      *
+      * \param localEnergy     pair energy on this processor
+      * \param localDerivative energy of derivative pairs on this processor
+      * \param communicator    domain communicator
+      */
+      #ifdef UTIL_MPI
+      void reduceEnergyAndDerivative(double localEnergy,
+                                     double localDerivative,
+                                     MPI::Intracomm& communicator);
+      #else
+      void reduceEnergyAndDerivative(double localEnergy,
+                                     double localDerivative);
+      #endif
+
+      /**
+      * Reduce sum for the epsilon derivative, and set the derivative.
+      *
+      * \param localDerivative energy of derivative pairs on this processor
+      * \param communicator    domain communicator
+      */
+      #ifdef UTIL_MPI
+      void reduceDerivative(double localDerivative,
+                            MPI::Intracomm& communicator);
+      #else
+      void reduceDerivative(double localDerivative);
+      #endif
 
    private:
 
@@ -352,12 +565,30 @@ namespace DdMd
       /// Index for method used to calculate forces / energies.
       int methodId_;
 
+      /// Number of pairs per block in the blocked pair list loop.
+      int blockSize_;
+
+      /// Is the half-shell ghost communication scheme enabled?
+      bool halfShell_;
+
       /// Number of pairs within specified cutoff.
       int nPair_;
 
       /// Pair energies.
       Setable< DMatrix<double> > pairEnergies_;
 
+      /// Derivative of total energy with respect to epsilon.
+      double epsilonDerivative_;
+
+      /// Atom types of the epsilon derivative (-1 if none requested).
+      int derivativeTypeId1_;
+
+      /// Atom types of the epsilon derivative (-1 if none requested).
+      int derivativeTypeId2_;
+
+      /// Is epsilonDerivative_ current (on all processors)?
+      bool isEpsilonDerivativeSet_;
+
       /// Private methods used to compute number of pairs
       int nPairList(double cutoffSq);
       int nPairCell(double cutoffSq);
@@ -382,6 +613,12 @@ namespace DdMd
    inline double PairPotential::cutoff() const
    {  return cutoff_; }
 
+   inline double PairPotential::exchangeSkin() const
+   {  return (exchangeSkin_ > skin_) ? exchangeSkin_ : skin_; }
+
+   inline double PairPotential::ghostCutoff() const
+   {  return cutoff_ + exchangeSkin() - skin_; }
+
    inline Boundary& PairPotential::boundary() 
    {  return *boundaryPtr_; }
 
@@ -392,10 +629,46 @@ namespace DdMd
    {  return *storagePtr_; }
 
    inline void PairPotential::setMethodId(int methodId)
-   {  methodId_ = methodId; }
+   {
+      if (halfShell_ && methodId != 0) {
+         UTIL_THROW("Half-shell scheme requires pair list (methodId 0)");
+      }
+      methodId_ = methodId;
+   }
 
    inline int PairPotential::methodId() const
    {  return methodId_; }
 
+   inline void PairPotential::setBlockSize(int blockSize)
+   {
+      if (blockSize != 8 && blockSize != 16 && blockSize != 32
+          && blockSize != 64) {
+         UTIL_THROW("Block size must be 8, 16, 32 or 64");
+      }
+      blockSize_ = blockSize;
+   }
+
+   inline int PairPotential::blockSize() const
+   {  return blockSize_; }
+
+   inline bool PairPotential::halfShell() const
+   {  return halfShell_; }
+
+   inline bool PairPotential::hasEpsilonDerivative() const
+   {  return (derivativeTypeId1_ >= 0); }
+
+   inline bool PairPotential::isEpsilonDerivativeSet() const
+   {  return isEpsilonDerivativeSet_; }
+
+   inline void PairPotential::unsetEpsilonDerivative()
+   {  isEpsilonDerivativeSet_ = false; }
+
+   inline
+   bool PairPotential::isDerivativePair(int type0, int type1) const
+   {
+      return (type0 == derivativeTypeId1_ && type1 == derivativeTypeId2_)
+          || (type0 == derivativeTypeId2_ && type1 == derivativeTypeId1_);
+   }
+
 }
 #endif
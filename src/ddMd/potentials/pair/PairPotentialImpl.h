@@ -14,8 +14,35 @@
 
 #include <algorithm>
 
-// Block size used in cache-optimized algorithm
-#define PAIR_BLOCK_SIZE 16
+#ifdef DDMD_OPENMP
+#include <util/containers/GArray.h>
+#include <omp.h>
+#endif
+
+#ifdef DDMD_OFFLOAD
+#ifndef DDMD_ATOM_SOA
+#error "DDMD_OFFLOAD requires DDMD_ATOM_SOA"
+#endif
+#include <util/containers/DArray.h>
+// Interaction objects, which hold parameters in heap-allocated arrays,
+// are read on the device through host pointers. This requires unified
+// shared memory (OpenMP 5.0), which must precede any target construct.
+#if !defined(_OPENMP) || _OPENMP < 201811
+#error "DDMD_OFFLOAD requires OpenMP 5.0 (unified_shared_memory)"
+#endif
+#pragma omp requires unified_shared_memory
+#endif
+
+// Maximum block size used in cache-optimized algorithm (the block size
+// used at run time is set by PairPotential::setBlockSize()).
+#define PAIR_BLOCK_SIZE 64
+
+// Distance, in pairs, of software prefetches in pair list force loops
+#ifdef DDMD_PREFETCH
+#ifndef PAIR_PREFETCH_DISTANCE
+#define PAIR_PREFETCH_DISTANCE 8
+#endif
+#endif
 
 namespace DdMd
 {
@@ -145,7 +172,21 @@ namespace DdMd
       * \param value  new value of parameter
       */
       void set(std::string name, int i, int j, double value)
-      {  interactionPtr_->set(name, i, j, value); }
+      {
+         interactionPtr_->set(name, i, j, value);
+         if (typePairList_) setPairListTypeCutoffs();
+      }
+
+      /**
+      * Set a lower bound on the pair list cutoff of every pair of types.
+      *
+      * \param cutoff  minimum pair list force cutoff for any type pair
+      */
+      virtual void setMinTypeCutoff(double cutoff)
+      {
+         PairPotential::setMinTypeCutoff(cutoff);
+         if (typePairList_) setPairListTypeCutoffs();
+      }
 
       /**
       * Get a parameter value, identified by a string.
@@ -193,6 +234,19 @@ namespace DdMd
       */
       virtual void computeForces();
 
+      /**
+      * Add pair forces for pairs of local atoms, using PairList.
+      *
+      * \param begin  index of first primary atom
+      * \param end    index one past last primary atom
+      */
+      virtual void computeInteriorForces(int begin, int end);
+
+      /**
+      * Add pair forces for pairs with a ghost atom, using PairList.
+      */
+      virtual void computeBoundaryForces();
+
       /**
       * Compute the total nonBonded pair energy for all processors
       * 
@@ -217,7 +271,6 @@ namespace DdMd
 
       /**
       * Compute total pair energies for all processors
-      * Compute nonbonded forces and sress for all processors
       * 
       * Call on all processors.
       */
@@ -230,7 +283,9 @@ namespace DdMd
       /**
       * Compute nonbonded forces and sress for all processors
       * 
-      * Call on all processors.
+      * If an associated AtomStress is active, this also adds per-atom
+      * pair energies and virials to it, and recomputes the stress even
+      * if it is already set. Call on all processors.
       */
       #ifdef UTIL_MPI
       virtual void computeForcesAndStress(MPI::Intracomm& communicator);
@@ -238,22 +293,45 @@ namespace DdMd
       virtual void computeForcesAndStress();
       #endif
 
-      //@}
-
-   private:
+      /**
+      * Compute forces, energy and optionally stress in one pass.
+      *
+      * Uses Interaction::evaluate() to obtain the energy and force of
+      * each pair in a single loop over the pair list. If an epsilon
+      * derivative was requested, the energy of pairs of the requested
+      * types is summed in the same loop, and reduced together with the
+      * energy. Falls back to
+      * separate loops if the energy is already set, if methodId()
+      * != 0, or if an associated AtomStress is active. Call on all
+      * processors.
+      *
+      * \param communicator domain communicator
+      * \param needStress   if true, also compute the stress
+      */
+      #ifdef UTIL_MPI
+      virtual void computeForcesAndEnergy(MPI::Intracomm& communicator,
+                                          bool needStress);
+      #else
+      virtual void computeForcesAndEnergy(bool needStress);
+      #endif
 
-      #ifdef PAIR_BLOCK_SIZE
-      /*
-      * Struct used in inner-loop of cache-optimized algorithm.
+      /**
+      * Compute the requested epsilon derivative in a separate loop.
+      *
+      * Call on all processors.
+      *
+      * \param communicator domain communicator
       */
-      struct PairForce {
-         Vector f;
-         double rsq;
-         Atom*  ptr0;
-         Atom*  ptr1;
-      };
+      #ifdef UTIL_MPI
+      virtual void computeEpsilonDerivative(MPI::Intracomm& communicator);
+      #else
+      virtual void computeEpsilonDerivative();
       #endif
 
+      //@}
+
+   private:
+
       /**
       * Pointer to pair interaction object.
       */ 
@@ -267,8 +345,44 @@ namespace DdMd
       int nAtomType_;
 
       #ifdef PAIR_BLOCK_SIZE
-      PairForce pairs_[PAIR_BLOCK_SIZE];
-      PairForce* inPairs_[PAIR_BLOCK_SIZE];
+      // Structure-of-arrays work space for blocked force calculation.
+      Vector blockDr_[PAIR_BLOCK_SIZE];     ///< Separation vectors.
+      double blockRsq_[PAIR_BLOCK_SIZE];    ///< Squared separations.
+      double blockForce_[PAIR_BLOCK_SIZE];  ///< Values of forceOverR.
+      Atom*  blockPtr0_[PAIR_BLOCK_SIZE];   ///< Pointers to atom 0.
+      Atom*  blockPtr1_[PAIR_BLOCK_SIZE];   ///< Pointers to atom 1.
+      int    blockType0_[PAIR_BLOCK_SIZE];  ///< Types of atom 0.
+      int    blockType1_[PAIR_BLOCK_SIZE];  ///< Types of atom 1.
+      #endif
+
+      #ifdef DDMD_OPENMP
+      /// Pointers to local cells, for threaded cell list loop.
+      GArray<const Cell*> threadCells_;
+      #endif
+
+      #ifdef DDMD_OFFLOAD
+      /// Atom array indices of pairs, 2 per pair (~index for ghosts).
+      DArray<int> offloadPairs_;
+
+      /// Number of pairs in offloadPairs_.
+      int nOffloadPair_;
+
+      /// Number of local atom array elements used by offloadPairs_.
+      int nOffloadLocal_;
+
+      /// Number of ghost atom array elements used by offloadPairs_.
+      int nOffloadGhost_;
+
+      /// Value of pairList_.buildCounter() when offloadPairs_ was built.
+      int offloadBuildCounter_;
+      #endif
+
+      /// Work space for local pair energies (allocated on first use).
+      DMatrix<double> localPairEnergies_;
+
+      #ifdef UTIL_MPI
+      /// Work space for reduced pair energies (allocated on first use).
+      DMatrix<double> totalPairEnergies_;
       #endif
 
       /**
@@ -276,6 +390,11 @@ namespace DdMd
       */ 
       bool isInitialized_;
 
+      /**
+      * Pass the cutoff of each pair of atom types to the PairList.
+      */
+      void setPairListTypeCutoffs();
+
       /**
       * Compute atomic pair energy, using PairList.
       */
@@ -286,6 +405,16 @@ namespace DdMd
       */
       void computeForcesList();
 
+      #ifdef PAIR_BLOCK_SIZE
+      /**
+      * Compute pair forces using PairList, in blocks of BlockSize pairs.
+      *
+      * Requires reverse communication to be disabled.
+      */
+      template <int BlockSize>
+      void computeForcesBlocked();
+      #endif
+
       /**
       * Compute atomic pair forces and/or pair potential energy.
       */
@@ -296,6 +425,36 @@ namespace DdMd
       */
       void computeForcesCell();
 
+      #ifdef DDMD_OPENMP
+      /**
+      * Compute atomic pair forces using PairList, with OpenMP threads.
+      *
+      * Primary atoms are divided among threads. Each thread accumulates
+      * forces in its own per-thread buffer in AtomStorage.
+      */
+      void computeForcesListThreaded();
+
+      /**
+      * Compute atomic pair forces using CellList, with OpenMP threads.
+      *
+      * Local cells are divided among threads. Each thread accumulates
+      * forces in its own per-thread buffer in AtomStorage.
+      */
+      void computeForcesCellThreaded();
+      #endif
+
+      #ifdef DDMD_OFFLOAD
+      /**
+      * Compute atomic pair forces using PairList, on an offload device.
+      *
+      * The pair list is copied to the device as pairs of atom array 
+      * indices after each rebuild. Positions and type ids are copied to
+      * the device, and forces are copied back, at each call. Forces are
+      * accumulated on the device with atomic updates.
+      */
+      void computeForcesOffload();
+      #endif
+
       /**
       * Compute atomic pair energy, using N^2 loop.
       * 
@@ -313,6 +472,7 @@ namespace DdMd
 }
 
 #include <ddMd/simulation/Simulation.h>
+#include <ddMd/potentials/AtomStress.h>
 #include <ddMd/storage/AtomStorage.h>
 #include <ddMd/storage/AtomIterator.h>
 #include <ddMd/storage/GhostIterator.h>
@@ -325,6 +485,7 @@ namespace DdMd
 #include <util/global.h>
 
 #include <fstream>
+#include <cmath>
 
 namespace DdMd
 {
@@ -338,6 +499,12 @@ namespace DdMd
    PairPotentialImpl<Interaction>::PairPotentialImpl(Simulation& simulation)
     : PairPotential(simulation),
       interactionPtr_(0),
+      #ifdef DDMD_OFFLOAD
+      nOffloadPair_(0),
+      nOffloadLocal_(0),
+      nOffloadGhost_(0),
+      offloadBuildCounter_(-1),
+      #endif
       isInitialized_(false)
    {  
       interactionPtr_ = new Interaction;
@@ -351,6 +518,12 @@ namespace DdMd
    PairPotentialImpl<Interaction>::PairPotentialImpl()
     : PairPotential(),
       interactionPtr_(0),
+      #ifdef DDMD_OFFLOAD
+      nOffloadPair_(0),
+      nOffloadLocal_(0),
+      nOffloadGhost_(0),
+      offloadBuildCounter_(-1),
+      #endif
       isInitialized_(false)
    {  interactionPtr_ = new Interaction; }
  
@@ -392,6 +565,7 @@ namespace DdMd
       interaction().readParameters(in);
 
       PairPotential::readParameters(in);
+      if (typePairList_) setPairListTypeCutoffs();
       isInitialized_ = true;
    }
 
@@ -409,6 +583,7 @@ namespace DdMd
       addParamComposite(interaction(), nextIndent);
       interaction().loadParameters(ar);
       PairPotential::loadParameters(ar);
+      if (typePairList_) setPairListTypeCutoffs();
       isInitialized_ = true;
    }
 
@@ -451,6 +626,27 @@ namespace DdMd
    double PairPotentialImpl<Interaction>::maxPairCutoff() const
    {  return interaction().maxPairCutoff(); }
 
+   /*
+   * Pass the cutoff of each pair of atom types to the PairList, but no
+   * less than minTypeCutoff_ (private).
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::setPairListTypeCutoffs()
+   {
+      DMatrix<double> cutoffs;
+      cutoffs.allocate(nAtomType_, nAtomType_);
+      int i, j;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            cutoffs(i, j) = sqrt(interaction().cutoffSq(i, j));
+            if (cutoffs(i, j) < minTypeCutoff_) {
+               cutoffs(i, j) = minTypeCutoff_;
+            }
+         }
+      }
+      pairList_.setTypeCutoffs(cutoffs);
+   }
+
    /*
    * Return pair interaction class name.
    */
@@ -464,6 +660,22 @@ namespace DdMd
    template <class Interaction>
    void PairPotentialImpl<Interaction>::computeForces()
    {  
+       #ifdef DDMD_OFFLOAD
+       if (methodId() == 0) {
+          computeForcesOffload();
+          return;
+       }
+       #endif
+       #ifdef DDMD_OPENMP
+       if (methodId() == 0) {
+          computeForcesListThreaded(); 
+       } else
+       if (methodId() == 1) {
+          computeForcesCellThreaded(); 
+       } else {
+          computeForcesNSq(); 
+       }
+       #else
        if (methodId() == 0) {
           computeForcesList(); 
        } else
@@ -472,6 +684,78 @@ namespace DdMd
        } else {
           computeForcesNSq(); 
        }
+       #endif
+   }
+
+   /*
+   * Add forces for pairs of local atoms, for a range of primary atoms.
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::computeInteriorForces(int begin, 
+                                                              int end)
+   {  
+      Vector f, f0;
+      double rsq;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      int    type0, type1, i, j, jEnd;
+
+      for (i = begin; i < end; ++i) {
+         atom0Ptr = pairList_.atom1Ptr(i);
+         if (atom0Ptr->isGhost()) {
+            // Ghost primary atom (half-shell only): all pairs are boundary
+            continue;
+         }
+         type0 = atom0Ptr->typeId();
+         f0.zero();
+         jEnd = pairList_.first(i+1);
+         for (j = pairList_.first(i); j < jEnd; ++j) {
+            atom1Ptr = pairList_.atom2Ptr(j);
+            if (!atom1Ptr->isGhost()) {
+               type1 = atom1Ptr->typeId();
+               f.subtract(atom0Ptr->position(), atom1Ptr->position());
+               rsq = f.square();
+               if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+                  f *= interactionPtr_->forceOverR(rsq, type0, type1);
+                  f0 += f;
+                  atom1Ptr->force() -= f;
+               }
+            }
+         }
+         atom0Ptr->force() += f0;
+      }
+   }
+
+   /*
+   * Add forces for pairs that contain a ghost atom.
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::computeBoundaryForces()
+   {  
+      Vector f;
+      double rsq;
+      PairIterator iter;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      int    type0, type1;
+      bool   reverse = reverseUpdateFlag();
+
+      for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         if (atom0Ptr->isGhost() || atom1Ptr->isGhost()) {
+            f.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = f.square();
+            type0 = atom0Ptr->typeId();
+            type1 = atom1Ptr->typeId();
+            if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+               f *= interactionPtr_->forceOverR(rsq, type0, type1);
+               atom0Ptr->force() += f;
+               if (reverse) {
+                  atom1Ptr->force() -= f;
+               }
+            }
+         }
+      }
    }
 
    /*
@@ -518,7 +802,7 @@ namespace DdMd
       if (reverseUpdateFlag()) {
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
             iter.getPair(atom0Ptr, atom1Ptr);
-            assert(!atom0Ptr->isGhost());
+            assert(halfShell() || !atom0Ptr->isGhost());
             type0 = atom0Ptr->typeId();
             type1 = atom1Ptr->typeId();
             f.subtract(atom0Ptr->position(), atom1Ptr->position());
@@ -559,6 +843,9 @@ namespace DdMd
 
          Vector f;
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            #ifdef PAIR_PREFETCH_DISTANCE
+            iter.prefetch(PAIR_PREFETCH_DISTANCE);
+            #endif
             iter.getPair(atom0Ptr, atom1Ptr);
             f.subtract(atom0Ptr->position(), atom1Ptr->position());
             rsq = f.square();
@@ -574,77 +861,20 @@ namespace DdMd
       } else {
 
          #ifdef PAIR_BLOCK_SIZE
-         PairForce* pairPtr;
-         Vector*    forcePtr;
-         int i, j, m, n;
-
-         pairList_.begin(iter);
-         j = pairList_.nPair();  // j = # of remaining unprocessed pairs
-         while (j) {
-
-            // Determine n = number of pairs in this block
-            n = std::min(PAIR_BLOCK_SIZE, j);
-
-            // Compute separation for each pair in block
-            for (i = 0; i < n; ++i) {
-               pairPtr = &pairs_[i];
-               iter.getPair(atom0Ptr, atom1Ptr);
-               forcePtr = &(pairPtr->f);
-               forcePtr->subtract(atom0Ptr->position(), atom1Ptr->position());
-               pairPtr->ptr0 = atom0Ptr;
-               pairPtr->ptr1 = atom1Ptr;
-               pairPtr->rsq  = forcePtr->square();
-               ++iter;
-            }
-
-            // Identify pairs in this block with rsq < cutoff
-            // Determine m = number of pairs with rsq < cutoff
-            m = 0; 
-            for (i = 0; i < n; ++i) {
-               pairPtr = &pairs_[i];
-               atom0Ptr = pairPtr->ptr0;
-               atom1Ptr = pairPtr->ptr1; 
-               type0 = atom0Ptr->typeId();
-               type1 = atom1Ptr->typeId();
-               inPairs_[m] = pairPtr;
-               if (pairPtr->rsq < interactionPtr_->cutoffSq(type0, type1)) {
-                  ++m;
-               }
-            }
-              
-            // Compute and increment forces for pairs with rsq < cutoff 
-            for (i = 0; i < m; ++i) {
-               pairPtr =  inPairs_[i];
-               atom0Ptr = pairPtr->ptr0;
-               atom1Ptr = pairPtr->ptr1; 
-               forcePtr = &(pairPtr->f);
-               type0 = atom0Ptr->typeId();
-               type1 = atom1Ptr->typeId();
-               rsq   = pairPtr->rsq;
-               *forcePtr *= interactionPtr_->forceOverR(rsq, type0, type1);
-               atom0Ptr->force() += *forcePtr;
-               if (!atom1Ptr->isGhost()) {
-                  atom1Ptr->force() -= *forcePtr;
-               }
-            }
-
-            // Decrement number of remaining unprocess pairs
-            j = j - n; 
-         }
-
-         #ifdef UTIL_DEBUG
-         if (j != 0) {
-            UTIL_THROW("Error in counting");
-         }
-         if (iter.notEnd()) {
-            UTIL_THROW("Error in iterator");
+         switch (blockSize()) {
+            case 8:  computeForcesBlocked<8>();  break;
+            case 16: computeForcesBlocked<16>(); break;
+            case 32: computeForcesBlocked<32>(); break;
+            default: computeForcesBlocked<64>(); break;
          }
-         #endif // ifdef UTIL_DEBUG
 
          #else  // ifndef PAIR_BLOCK_SIZE
 
          Vector f;
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            #ifdef PAIR_PREFETCH_DISTANCE
+            iter.prefetch(PAIR_PREFETCH_DISTANCE);
+            #endif
             iter.getPair(atom0Ptr, atom1Ptr);
             f.subtract(atom0Ptr->position(), atom1Ptr->position());
             rsq = f.square();
@@ -663,6 +893,90 @@ namespace DdMd
       }
    }
 
+   #ifdef PAIR_BLOCK_SIZE
+   /*
+   * Add forces of pairs in the pair list, in blocks of BlockSize pairs.
+   */
+   template <class Interaction>
+   template <int BlockSize>
+   void PairPotentialImpl<Interaction>::computeForcesBlocked()
+   {
+      double rsq;
+      PairIterator iter;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      int    type0, type1;
+      int i, j, m, n;
+
+      pairList_.begin(iter);
+      j = pairList_.nPair();  // j = # of remaining unprocessed pairs
+      while (j) {
+
+         // Determine n = number of pairs in this block
+         n = std::min(BlockSize, j);
+
+         // Gather pointers, types and separations for pairs in block
+         for (i = 0; i < n; ++i) {
+            #ifdef PAIR_PREFETCH_DISTANCE
+            iter.prefetch(PAIR_PREFETCH_DISTANCE);
+            #endif
+            iter.getPair(atom0Ptr, atom1Ptr);
+            blockPtr0_[i] = atom0Ptr;
+            blockPtr1_[i] = atom1Ptr;
+            blockType0_[i] = atom0Ptr->typeId();
+            blockType1_[i] = atom1Ptr->typeId();
+            blockDr_[i].subtract(atom0Ptr->position(),
+                                 atom1Ptr->position());
+            ++iter;
+         }
+
+         // Compact pairs with rsq < cutoff to the front of each array.
+         // Determine m = number of pairs with rsq < cutoff. Because
+         // m <= i, element i is always read before it is overwritten.
+         m = 0;
+         for (i = 0; i < n; ++i) {
+            type0 = blockType0_[i];
+            type1 = blockType1_[i];
+            rsq = blockDr_[i].square();
+            blockRsq_[m] = rsq;
+            blockType0_[m] = type0;
+            blockType1_[m] = type1;
+            blockPtr0_[m] = blockPtr0_[i];
+            blockPtr1_[m] = blockPtr1_[i];
+            blockDr_[m] = blockDr_[i];
+            if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+               ++m;
+            }
+         }
+
+         // Compute forceOverR for all m pairs in a single batch call
+         interactionPtr_->forceOverR(m, blockRsq_, blockType0_,
+                                     blockType1_, blockForce_);
+
+         // Scatter forces for pairs with rsq < cutoff
+         for (i = 0; i < m; ++i) {
+            blockDr_[i] *= blockForce_[i];
+            blockPtr0_[i]->force() += blockDr_[i];
+            if (!blockPtr1_[i]->isGhost()) {
+               blockPtr1_[i]->force() -= blockDr_[i];
+            }
+         }
+
+         // Decrement number of remaining unprocess pairs
+         j = j - n;
+      }
+
+      #ifdef UTIL_DEBUG
+      if (j != 0) {
+         UTIL_THROW("Error in counting");
+      }
+      if (iter.notEnd()) {
+         UTIL_THROW("Error in iterator");
+      }
+      #endif // ifdef UTIL_DEBUG
+   }
+   #endif // ifdef PAIR_BLOCK_SIZE
+
    /*
    * Increment atomic forces and/or pair energy (private).
    */
@@ -730,76 +1044,329 @@ namespace DdMd
 
    /*
    * Increment atomic forces using Cell List (private).
+   *
+   * Pairs in one cell are visited once, by index. Pairs with atoms in
+   * neighboring cells are visited by iterating directly over ranges of
+   * CellAtoms in the half-shell of strips given by getNeighborStrips().
    */
    template <class Interaction>
    void PairPotentialImpl<Interaction>::computeForcesCell()
    {
-      // Find all neighbors (cell list)
-      Cell::NeighborArray neighbors;
-      Vector f;
+      Cell::StripArray strips;
+      Vector f, f0;
       double rsq;
       Atom*  atomPtr0;
       Atom*  atomPtr1;
+      CellAtom* cellAtoms;
+      CellAtom* neighborPtr;
+      CellAtom* neighborEnd;
       const Cell* cellPtr;
-      int    type0, type1, na, nn, i, j;
+      const bool reverse = reverseUpdateFlag();
+      int    type0, type1, na, ns, i, j, is;
 
       // Iterate over local cells.
       cellPtr = cellList_.begin();
       while (cellPtr) {
-         cellPtr->getNeighbors(neighbors);
          na = cellPtr->nAtom();
-         nn = neighbors.size();
-         for (i = 0; i < na; ++i) {
-            atomPtr0 = neighbors[i]->ptr();
-            type0 = atomPtr0->typeId();
-            // Loop over atoms in this cell
-            for (j = 0; j < na; ++j) {
-               atomPtr1 = neighbors[j]->ptr();
-               type1 = atomPtr1->typeId();
-               if (atomPtr1 > atomPtr0) {
+         if (na > 0) {
+            cellPtr->getNeighborStrips(strips, reverse);
+            ns = strips.size();
+            cellAtoms = cellPtr->atomPtr(0);
+            for (i = 0; i < na; ++i) {
+               atomPtr0 = cellAtoms[i].ptr();
+               type0 = atomPtr0->typeId();
+               f0.zero();
+
+               // Loop over later atoms in this cell
+               for (j = i + 1; j < na; ++j) {
+                  atomPtr1 = cellAtoms[j].ptr();
+                  type1 = atomPtr1->typeId();
                   f.subtract(atomPtr0->position(), atomPtr1->position());
                   rsq = f.square();
                   if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
                      f *= interactionPtr_->forceOverR(rsq, type0, type1);
-                     atomPtr0->force() += f;
+                     f0 += f;
                      atomPtr1->force() -= f;
                   }
                }
+
+               // Loop over atoms in neighboring cells.
+               for (is = 0; is < ns; ++is) {
+                  neighborPtr = strips[is].first;
+                  neighborEnd = strips[is].second;
+                  for ( ; neighborPtr < neighborEnd; ++neighborPtr) {
+                     atomPtr1 = neighborPtr->ptr();
+                     type1 = atomPtr1->typeId();
+                     f.subtract(atomPtr0->position(), atomPtr1->position());
+                     rsq = f.square();
+                     if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+                        f *= interactionPtr_->forceOverR(rsq, type0, type1);
+                        f0 += f;
+                        if (reverse || !atomPtr1->isGhost()) {
+                           atomPtr1->force() -= f;
+                        }
+                     }
+                  }
+               }
+
+               atomPtr0->force() += f0;
             }
+         }
+         cellPtr = cellPtr->nextCellPtr();
+      } // while (cellPtr) 
+   }
 
-            // Loop over atoms in neighboring cells.
-            if (reverseUpdateFlag()) {
-               for (j = na; j < nn; ++j) {
-                  atomPtr1 = neighbors[j]->ptr();
-                  type1 = atomPtr1->typeId();
-                  f.subtract(atomPtr0->position(), atomPtr1->position());
-                  rsq = f.square();
-                  if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
-                     f *= interactionPtr_->forceOverR(rsq, type0, type1);
-                     atomPtr0->force() += f;
-                     atomPtr1->force() -= f;
+   #ifdef DDMD_OPENMP
+   /*
+   * Increment atomic forces using PairList and threads (private).
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::computeForcesListThreaded()
+   {
+      AtomStorage& atomStorage = storage();
+      const bool reverse = reverseUpdateFlag();
+      const int nAtom = pairList_.nAtom();
+      atomStorage.beginThreadForces();
+
+      #pragma omp parallel
+      {
+         Vector f, f0;
+         double rsq;
+         Atom*  atom0Ptr;
+         Atom*  atom1Ptr;
+         int    type0, type1, i, j, jEnd;
+         const int t = omp_get_thread_num();
+
+         #pragma omp for schedule(dynamic, 64)
+         for (i = 0; i < nAtom; ++i) {
+            atom0Ptr = pairList_.atom1Ptr(i);
+            type0 = atom0Ptr->typeId();
+            f0.zero();
+            jEnd = pairList_.first(i+1);
+            for (j = pairList_.first(i); j < jEnd; ++j) {
+               #ifdef PAIR_PREFETCH_DISTANCE
+               pairList_.prefetchAtom2(j + PAIR_PREFETCH_DISTANCE);
+               #endif
+               atom1Ptr = pairList_.atom2Ptr(j);
+               type1 = atom1Ptr->typeId();
+               f.subtract(atom0Ptr->position(), atom1Ptr->position());
+               rsq = f.square();
+               if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+                  f *= interactionPtr_->forceOverR(rsq, type0, type1);
+                  f0 += f;
+                  if (reverse || !atom1Ptr->isGhost()) {
+                     atomStorage.subtractThreadForce(t, *atom1Ptr, f);
                   }
                }
-            } else {
-               for (j = na; j < nn; ++j) {
-                  atomPtr1 = neighbors[j]->ptr();
+            }
+            atomStorage.addThreadForce(t, *atom0Ptr, f0);
+         }
+      } // omp parallel
+
+      atomStorage.endThreadForces(reverse);
+   }
+
+   /*
+   * Increment atomic forces using CellList and threads (private).
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::computeForcesCellThreaded()
+   {
+      AtomStorage& atomStorage = storage();
+      const bool reverse = reverseUpdateFlag();
+
+      // Collect pointers to local cells, for random access.
+      if (threadCells_.capacity() == 0) {
+         threadCells_.reserve(64);
+      }
+      threadCells_.clear();
+      const Cell* cellPtr = cellList_.begin();
+      while (cellPtr) {
+         threadCells_.append(cellPtr);
+         cellPtr = cellPtr->nextCellPtr();
+      }
+      const int nCell = threadCells_.size();
+      atomStorage.beginThreadForces();
+
+      #pragma omp parallel
+      {
+         Cell::StripArray strips;
+         Vector f, f0;
+         double rsq;
+         Atom*  atomPtr0;
+         Atom*  atomPtr1;
+         CellAtom* cellAtoms;
+         CellAtom* neighborPtr;
+         CellAtom* neighborEnd;
+         int    type0, type1, na, ns, i, j, k, is;
+         const int t = omp_get_thread_num();
+
+         #pragma omp for schedule(dynamic, 4)
+         for (k = 0; k < nCell; ++k) {
+            na = threadCells_[k]->nAtom();
+            if (na == 0) continue;
+            threadCells_[k]->getNeighborStrips(strips, reverse);
+            ns = strips.size();
+            cellAtoms = threadCells_[k]->atomPtr(0);
+            for (i = 0; i < na; ++i) {
+               atomPtr0 = cellAtoms[i].ptr();
+               type0 = atomPtr0->typeId();
+               f0.zero();
+
+               // Loop over later atoms in this cell
+               for (j = i + 1; j < na; ++j) {
+                  atomPtr1 = cellAtoms[j].ptr();
                   type1 = atomPtr1->typeId();
                   f.subtract(atomPtr0->position(), atomPtr1->position());
                   rsq = f.square();
                   if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
                      f *= interactionPtr_->forceOverR(rsq, type0, type1);
-                     atomPtr0->force() += f;
-                     if (!atomPtr1->isGhost()) {
-                        atomPtr1->force() -= f;
+                     f0 += f;
+                     atomStorage.subtractThreadForce(t, *atomPtr1, f);
+                  }
+               }
+
+               // Loop over atoms in neighboring cells.
+               for (is = 0; is < ns; ++is) {
+                  neighborPtr = strips[is].first;
+                  neighborEnd = strips[is].second;
+                  for ( ; neighborPtr < neighborEnd; ++neighborPtr) {
+                     atomPtr1 = neighborPtr->ptr();
+                     type1 = atomPtr1->typeId();
+                     f.subtract(atomPtr0->position(), atomPtr1->position());
+                     rsq = f.square();
+                     if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+                        f *= interactionPtr_->forceOverR(rsq, type0, type1);
+                        f0 += f;
+                        if (reverse || !atomPtr1->isGhost()) {
+                           atomStorage.subtractThreadForce(t, *atomPtr1, f);
+                        }
                      }
                   }
                }
+               atomStorage.addThreadForce(t, *atomPtr0, f0);
             }
+         }
+      } // omp parallel
+
+      atomStorage.endThreadForces(reverse);
+   }
+   #endif // ifdef DDMD_OPENMP
 
+   #ifdef DDMD_OFFLOAD
+   /*
+   * Compute pair forces using PairList, on an offload device (private).
+   */
+   template <class Interaction>
+   void PairPotentialImpl<Interaction>::computeForcesOffload()
+   {
+      AtomStorage& atoms = storage();
+
+      // Rebuild array of pair indices after each pair list rebuild.
+      if (offloadBuildCounter_ != pairList_.buildCounter()) {
+         // The pair list may grow past pairCapacity(), so size the
+         // buffer from nPair(), with headroom to limit reallocation.
+         int nPair = pairList_.nPair();
+         if (offloadPairs_.isAllocated()) {
+            if (offloadPairs_.capacity() < 2*nPair) {
+               offloadPairs_.deallocate();
+            }
          }
-         cellPtr = cellPtr->nextCellPtr();
-      } // while (cellPtr) 
+         if (!offloadPairs_.isAllocated()) {
+            int capacity = pairList_.pairCapacity();
+            if (capacity < nPair) {
+               capacity = nPair + nPair/4;
+            }
+            offloadPairs_.allocate(2*capacity);
+         }
+         PairIterator iter;
+         Atom* atom0Ptr;
+         Atom* atom1Ptr;
+         int i, k;
+         nOffloadLocal_ = 0;
+         nOffloadGhost_ = 0;
+         k = 0;
+         for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            iter.getPair(atom0Ptr, atom1Ptr);
+            i = atoms.arrayIndex(*atom0Ptr);
+            if (atom0Ptr->isGhost()) {
+               // Ghost primary atom (half-shell scheme only)
+               if (i >= nOffloadGhost_) nOffloadGhost_ = i + 1;
+               offloadPairs_[k] = ~i;
+            } else {
+               if (i >= nOffloadLocal_) nOffloadLocal_ = i + 1;
+               offloadPairs_[k] = i;
+            }
+            i = atoms.arrayIndex(*atom1Ptr);
+            if (atom1Ptr->isGhost()) {
+               if (i >= nOffloadGhost_) nOffloadGhost_ = i + 1;
+               offloadPairs_[k+1] = ~i;
+            } else {
+               if (i >= nOffloadLocal_) nOffloadLocal_ = i + 1;
+               offloadPairs_[k+1] = i;
+            }
+            k += 2;
+         }
+         nOffloadPair_ = k/2;
+         offloadBuildCounter_ = pairList_.buildCounter();
+      }
+      if (nOffloadPair_ == 0) return;
+
+      // Contiguous host arrays (Vector elements are 3 contiguous doubles)
+      int nL = nOffloadLocal_;
+      int nG = nOffloadGhost_;
+      int nP = nOffloadPair_;
+      const int* pairs = &offloadPairs_[0];
+      const double* rL = (const double*)atoms.localAtomArray().positions();
+      const int*    tL = atoms.localAtomArray().typeIds();
+      double*       fL = (double*)atoms.localAtomArray().forces();
+      const double* rG = (const double*)atoms.ghostAtomArray().positions();
+      const int*    tG = atoms.ghostAtomArray().typeIds();
+      double*       fG = (double*)atoms.ghostAtomArray().forces();
+      const Interaction* interaction = interactionPtr_;
+      const bool reverse = reverseUpdateFlag();
+
+      #pragma omp target teams distribute parallel for \
+              map(to: pairs[0:2*nP], rL[0:3*nL], tL[0:nL], \
+                      rG[0:3*nG], tG[0:nG]) \
+              map(tofrom: fL[0:3*nL], fG[0:3*nG])
+      for (int k = 0; k < nP; ++k) {
+         const int i = pairs[2*k];
+         const int j = pairs[2*k+1];
+         const bool isGhost0 = (i < 0);
+         const int n = isGhost0 ? ~i : i;
+         const double* r0 = isGhost0 ? rG + 3*n : rL + 3*n;
+         const bool isGhost = (j < 0);
+         const int m = isGhost ? ~j : j;
+         const double* r1 = isGhost ? rG + 3*m : rL + 3*m;
+         const int type0 = isGhost0 ? tG[n] : tL[n];
+         const int type1 = isGhost ? tG[m] : tL[m];
+         const double dx = r0[0] - r1[0];
+         const double dy = r0[1] - r1[1];
+         const double dz = r0[2] - r1[2];
+         const double rsq = dx*dx + dy*dy + dz*dz;
+         if (rsq < interaction->cutoffSq(type0, type1)) {
+            const double f = interaction->forceOverR(rsq, type0, type1);
+            double* f0 = isGhost0 ? fG + 3*n : fL + 3*n;
+            #pragma omp atomic update
+            f0[0] += f*dx;
+            #pragma omp atomic update
+            f0[1] += f*dy;
+            #pragma omp atomic update
+            f0[2] += f*dz;
+            if (!isGhost || reverse) {
+               double* f1 = isGhost ? fG + 3*m : fL + 3*m;
+               #pragma omp atomic update
+               f1[0] -= f*dx;
+               #pragma omp atomic update
+               f1[1] -= f*dy;
+               #pragma omp atomic update
+               f1[2] -= f*dz;
+            }
+         }
+      }
    }
+   #endif // ifdef DDMD_OFFLOAD
 
    /*
    * Increment atomic forces and/or pair energy (private).
@@ -1025,8 +1592,10 @@ namespace DdMd
    void PairPotentialImpl<Interaction>::computeForcesAndStress()
    #endif
    {
-      // If stress is already set, just calculate forces
-      if (isStressSet()) {
+      // If stress is already set, just calculate forces, unless
+      // per-atom contributions are needed
+      AtomStress* atomStressPtr = activeAtomStress();
+      if (isStressSet() && !atomStressPtr) {
          computeForces();
          return;
       }
@@ -1041,6 +1610,36 @@ namespace DdMd
       int    type0, type1;
 
       localStress.zero();
+      if (atomStressPtr) {
+
+         // Separate loop with per-atom accumulation. Ghost contributions
+         // are kept only if reverse communication will collect them.
+         bool addGhosts = reverseUpdateFlag();
+         double energy;
+         for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            iter.getPair(atom0Ptr, atom1Ptr);
+            dr.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = dr.square();
+            type0 = atom0Ptr->typeId();
+            type1 = atom1Ptr->typeId();
+            if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+               f = dr;
+               f *= interactionPtr_->forceOverR(rsq, type0, type1);
+               energy = interactionPtr_->energy(rsq, type0, type1);
+               atomStressPtr->addPair(*atom0Ptr, *atom1Ptr, energy,
+                                      f, dr, addGhosts);
+               assert(addGhosts || !atom0Ptr->isGhost());
+               atom0Ptr->force() += f;
+               if (addGhosts || !atom1Ptr->isGhost()) {
+                  atom1Ptr->force() -= f;
+               } else { // if atom 1 is a ghost
+                  f *= 0.5;
+               }
+               incrementPairStress(f, dr, localStress);
+            }
+         }
+
+      } else
       if (reverseUpdateFlag()) {
 
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
@@ -1052,7 +1651,7 @@ namespace DdMd
             if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
                f = dr;
                f *= interactionPtr_->forceOverR(rsq, type0, type1);
-               assert(!atom0Ptr->isGhost());
+               assert(halfShell() || !atom0Ptr->isGhost());
                atom0Ptr->force() += f;
                atom1Ptr->force() -= f;
                incrementPairStress(f, dr, localStress);
@@ -1090,6 +1689,141 @@ namespace DdMd
       reduceStress(localStress, communicator);
    }
 
+   /*
+   * Compute forces, energy and (optionally) stress in one pass.
+   */
+   template <class Interaction>
+   #ifdef UTIL_MPI
+   void 
+   PairPotentialImpl<Interaction>::computeForcesAndEnergy(MPI::Intracomm& communicator, bool needStress)
+   #else
+   void PairPotentialImpl<Interaction>::computeForcesAndEnergy(bool needStress)
+   #endif
+   {
+      // Use separate loops if energy is known, if no pair list is used,
+      // or if per-atom contributions are needed
+      if (isEnergySet() || methodId() != 0 || activeAtomStress()) {
+         Potential::computeForcesAndEnergy(communicator, needStress);
+         return;
+      }
+      if (isStressSet()) {
+         needStress = false;
+      }
+ 
+      Tensor localStress;
+      Vector dr;
+      Vector f;
+      double rsq, energy, forceOverR;
+      double localEnergy = 0.0;
+      double localDerivative = 0.0;
+      PairIterator iter;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      int    type0, type1;
+
+      localStress.zero();
+      if (reverseUpdateFlag()) {
+
+         for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            iter.getPair(atom0Ptr, atom1Ptr);
+            dr.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = dr.square();
+            type0 = atom0Ptr->typeId();
+            type1 = atom1Ptr->typeId();
+            if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+               interactionPtr_->evaluate(rsq, type0, type1, 
+                                         energy, forceOverR);
+               f.multiply(dr, forceOverR);
+               assert(halfShell() || !atom0Ptr->isGhost());
+               atom0Ptr->force() += f;
+               atom1Ptr->force() -= f;
+               localEnergy += energy;
+               if (isDerivativePair(type0, type1)) {
+                  localDerivative += energy;
+               }
+               if (needStress) {
+                  incrementPairStress(f, dr, localStress);
+               }
+            }
+         }
+
+      } else {
+
+         for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+            iter.getPair(atom0Ptr, atom1Ptr);
+            dr.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = dr.square();
+            type0 = atom0Ptr->typeId();
+            type1 = atom1Ptr->typeId();
+            if (rsq < interactionPtr_->cutoffSq(type0, type1)) {
+               interactionPtr_->evaluate(rsq, type0, type1, 
+                                         energy, forceOverR);
+               f.multiply(dr, forceOverR);
+               assert(!atom0Ptr->isGhost());
+               atom0Ptr->force() += f;
+               if (!atom1Ptr->isGhost()) {
+                  atom1Ptr->force() -= f;
+               } else { // if atom 1 is a ghost
+                  f *= 0.5;
+                  energy *= 0.5;
+               }
+               localEnergy += energy;
+               if (isDerivativePair(type0, type1)) {
+                  localDerivative += energy;
+               }
+               if (needStress) {
+                  incrementPairStress(f, dr, localStress);
+               }
+            }
+         }
+
+      }
+
+      // Add local values from all nodes, set totals on master.
+      reduceEnergyAndDerivative(localEnergy, localDerivative, communicator);
+      if (needStress) {
+         localStress /= boundary().volume();
+         reduceStress(localStress, communicator);
+      }
+   }
+
+   /*
+   * Compute epsilon derivative using the pair list (call on all processors).
+   */
+   template <class Interaction>
+   #ifdef UTIL_MPI
+   void PairPotentialImpl<Interaction>::computeEpsilonDerivative(MPI::Intracomm& communicator)
+   #else
+   void PairPotentialImpl<Interaction>::computeEpsilonDerivative()
+   #endif
+   {
+      if (!hasEpsilonDerivative()) {
+         UTIL_THROW("No epsilon derivative was requested");
+      }
+      Vector f;
+      double rsq;
+      double localDerivative = 0.0;
+      PairIterator iter;
+      Atom*  atom0Ptr;
+      Atom*  atom1Ptr;
+      int    type0, type1;
+      for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         type0 = atom0Ptr->typeId();
+         type1 = atom1Ptr->typeId();
+         if (isDerivativePair(type0, type1)) {
+            f.subtract(atom0Ptr->position(), atom1Ptr->position());
+            rsq = f.square();
+            if (reverseUpdateFlag() || !atom1Ptr->isGhost()) {
+               localDerivative += interactionPtr_->energy(rsq, type0, type1);
+            } else {
+               localDerivative += 0.5*interactionPtr_->energy(rsq, type0, type1);
+            }
+         }
+      }
+      reduceDerivative(localDerivative, communicator);
+   }
+
    /*
    * Compute total pair energies (Call on all processors).
    */
@@ -1107,8 +1841,10 @@ namespace DdMd
       Atom*  atom1Ptr;
       int    type0, type1;
 
-      DMatrix<double> localPairEnergies;
-      localPairEnergies.allocate(nAtomType_, nAtomType_);
+      if (!localPairEnergies_.isAllocated()) {
+         localPairEnergies_.allocate(nAtomType_, nAtomType_);
+      }
+      DMatrix<double>& localPairEnergies = localPairEnergies_;
       for (int i = 0; i < nAtomType_; ++i) {
          for (int j = 0; j < nAtomType_; ++j) {
             localPairEnergies(i,j) = 0.0;
@@ -1119,7 +1855,7 @@ namespace DdMd
       if (reverseUpdateFlag()) {
          for (pairList_.begin(iter); iter.notEnd(); ++iter) {
             iter.getPair(atom0Ptr, atom1Ptr);
-            assert(!atom0Ptr->isGhost());
+            assert(halfShell() || !atom0Ptr->isGhost());
             type0 = atom0Ptr->typeId();
             type1 = atom1Ptr->typeId();
             f.subtract(atom0Ptr->position(), atom1Ptr->position());
@@ -1142,15 +1878,16 @@ namespace DdMd
          }
       }
 
-      DMatrix<double> totalPairEnergies;
-      totalPairEnergies.allocate(nAtomType_, nAtomType_);
+      #ifdef UTIL_MPI
+      if (!totalPairEnergies_.isAllocated()) {
+         totalPairEnergies_.allocate(nAtomType_, nAtomType_);
+      }
+      DMatrix<double>& totalPairEnergies = totalPairEnergies_;
       for (int i = 0; i < nAtomType_; ++i) {
          for (int j = 0; j < nAtomType_; ++j) {
             totalPairEnergies(i,j) = 0.0;
          }
       }
-
-      #ifdef UTIL_MPI
       communicator.Reduce(&localPairEnergies(0,0), &totalPairEnergies(0,0), nAtomType_*nAtomType_,
                            MPI::DOUBLE, MPI::SUM, 0);
       if (communicator.Get_rank() == 0) {
@@ -0,0 +1,148 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "EnsembleScheduler.h"
+#include "Simulation.h"
+#include <util/misc/FileMaster.h>
+#include <util/misc/Log.h>
+
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   EnsembleScheduler::EnsembleScheduler(MPI::Intracomm& communicator)
+    : args_(),
+      worldPtr_(&communicator),
+      partition_(),
+      nPartition_(1),
+      nRun_(0),
+      partitionId_(0),
+      nRunLocal_(0)
+   {}
+
+   /*
+   * Destructor.
+   */
+   EnsembleScheduler::~EnsembleScheduler()
+   {}
+
+   /*
+   * Extract options -s and -j, keep all others for each Simulation.
+   */
+   bool EnsembleScheduler::setOptions(int argc, char** argv)
+   {
+      bool jFlag = false;
+      args_.clear();
+      args_.push_back(argv[0]);
+      int i = 1;
+      while (i < argc) {
+         if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            nRun_ = atoi(argv[i+1]);
+            jFlag = true;
+            i += 2;
+         } else
+         if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            nPartition_ = atoi(argv[i+1]);
+            i += 2;
+         } else {
+            args_.push_back(argv[i]);
+            ++i;
+         }
+      }
+      args_.push_back(0);
+      if (!jFlag) {
+         return false;
+      }
+
+      if (nRun_ < 1) {
+         UTIL_THROW("nRun must be positive");
+      }
+      if (nPartition_ < 1) {
+         UTIL_THROW("nPartition must be positive");
+      }
+      int worldRank = worldPtr_->Get_rank();
+      int worldSize = worldPtr_->Get_size();
+      if (worldSize % nPartition_ != 0) {
+         UTIL_THROW("World communicator size not a multiple of nPartition");
+      }
+      int partitionSize = worldSize/nPartition_;
+      partitionId_ = worldRank/partitionSize;
+      partition_ = worldPtr_->Split(partitionId_, worldRank);
+      return true;
+   }
+
+   /*
+   * Run all simulations, taking the next run as each one finishes.
+   */
+   void EnsembleScheduler::run()
+   {
+      #if MPI_VERSION >= 3
+      counter_ = 0;
+      int size = (worldPtr_->Get_rank() == 0) ? sizeof(int) : 0;
+      MPI_Win_create(&counter_, size, sizeof(int), MPI_INFO_NULL,
+                     (MPI_Comm) *worldPtr_, &window_);
+      #endif
+
+      nRunLocal_ = 0;
+      int runId = nextRun();
+      while (runId >= 0) {
+         {
+            Simulation simulation(partition_);
+            simulation.fileMaster().setDirectoryId(runId);
+
+            // Open log file "runId/log" (output prefix is still empty).
+            std::ofstream logFile;
+            simulation.fileMaster().openOutputFile("log", logFile);
+            Log::setFile(logFile);
+
+            simulation.setOptions(args_.size() - 1, &args_[0]);
+            simulation.readParam();
+            simulation.readCommands();
+
+            Log::close();
+         }
+         ++nRunLocal_;
+         runId = nextRun();
+      }
+
+      #if MPI_VERSION >= 3
+      MPI_Win_free(&window_);
+      #endif
+   }
+
+   /*
+   * Get index of next run on the partition master, and broadcast it.
+   */
+   int EnsembleScheduler::nextRun()
+   {
+      int runId;
+      if (partition_.Get_rank() == 0) {
+         #if MPI_VERSION >= 3
+         int one = 1;
+         MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, window_);
+         MPI_Fetch_and_op(&one, &runId, MPI_INT, 0, 0, MPI_SUM, window_);
+         MPI_Win_unlock(0, window_);
+         #else
+         runId = partitionId_ + nRunLocal_*nPartition_;
+         #endif
+         if (runId >= nRun_) {
+            runId = -1;
+         }
+      }
+      partition_.Bcast(&runId, 1, MPI::INT, 0);
+      return runId;
+   }
+
+}
@@ -0,0 +1,135 @@
+#ifndef DDMD_ENSEMBLE_SCHEDULER_H
+#define DDMD_ENSEMBLE_SCHEDULER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <vector>
+
+namespace DdMd
+{
+
+   using namespace Util;
+
+   /**
+   * Scheduler for an ensemble of independent DdMd simulations in one job.
+   *
+   * An EnsembleScheduler splits a world communicator into nPartition
+   * partitions of equal size, and runs nRun independent simulations,
+   * each of which is run by a new DdMd::Simulation on one partition.
+   * Run i reads and writes all files in directory "i/", exactly as
+   * system i of a ddSim invocation with option -s, and writes its log
+   * to file "i/log". When nRun exceeds nPartition, runs are assigned
+   * dynamically: each partition takes the next unstarted run whenever
+   * it finishes the previous one, so partitions that finish short runs
+   * early take more runs. The next run index is obtained by an atomic
+   * fetch-and-add on a counter on world rank 0 (MPI_Fetch_and_op), if
+   * MPI-3 is available, or else runs are assigned round-robin.
+   *
+   * Usage in a main program:
+   * \code
+   * DdMd::EnsembleScheduler scheduler(MPI::COMM_WORLD);
+   * if (scheduler.setOptions(argc, argv)) {
+   *    scheduler.run();
+   * }
+   * \endcode
+   * The options -s nPartition and -j nRun are consumed by setOptions().
+   * All other options are passed to Simulation::setOptions() for each
+   * run, so that all runs use the same parameter and command file names,
+   * relative to the directory of the run.
+   *
+   * \ingroup DdMd_Simulation_Module
+   */
+   class EnsembleScheduler
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param communicator world communicator for all runs
+      */
+      EnsembleScheduler(MPI::Intracomm& communicator);
+
+      /**
+      * Destructor.
+      */
+      ~EnsembleScheduler();
+
+      /**
+      * Read command line options, and return true iff option -j is set.
+      *
+      * \param argc number of arguments
+      * \param argv array of argument strings
+      */
+      bool setOptions(int argc, char** argv);
+
+      /**
+      * Run all simulations of the ensemble.
+      *
+      * Call on all processors. Returns when all runs are complete.
+      */
+      void run();
+
+      /**
+      * Number of runs completed by this partition.
+      */
+      int nRunLocal() const;
+
+   private:
+
+      /// Arguments passed to Simulation::setOptions for each run.
+      std::vector<char*> args_;
+
+      /// World communicator.
+      MPI::Intracomm* worldPtr_;
+
+      /// Communicator for this partition.
+      MPI::Intracomm partition_;
+
+      /// Number of partitions.
+      int nPartition_;
+
+      /// Total number of runs.
+      int nRun_;
+
+      /// Index of partition containing this processor.
+      int partitionId_;
+
+      /// Number of runs completed by this partition.
+      int nRunLocal_;
+
+      #if MPI_VERSION >= 3
+      /// Counter of started runs (used only on world rank 0).
+      int counter_;
+
+      /// RMA window for counter_.
+      MPI_Win window_;
+      #endif
+
+      /**
+      * Get the index of the next run for this partition (-1 if none).
+      *
+      * Call on all processors of the partition.
+      */
+      int nextRun();
+
+   };
+
+   // Inline method
+
+   /*
+   * Number of runs completed by this partition.
+   */
+   inline int EnsembleScheduler::nRunLocal() const
+   {  return nRunLocal_; }
+
+}
+#endif
@@ -15,7 +15,13 @@
 #include <ddMd/configIos/ConfigIoFactory.h>
 #include <ddMd/configIos/DdMdConfigIo.h>
 #include <ddMd/configIos/SerializeConfigIo.h>
+#include <ddMd/configIos/DistributedConfigIo.h>
+#include <ddMd/configIos/GeneratorConfigIo.h>
 #include <ddMd/analyzers/AnalyzerManager.h>
+#include <ddMd/misc/MemoryReport.h>
+#include <ddMd/misc/PageAllocator.h>
+#include <ddMd/misc/Tracer.h>
+#include <simp/commands/CommandLoop.h>
 #ifdef DDMD_MODIFIERS
 #include <ddMd/modifiers/ModifierManager.h>
 #endif
@@ -39,6 +45,12 @@
 #include <ddMd/potentials/external/ExternalPotentialImpl.h>
 #include <ddMd/potentials/external/ExternalFactory.h>
 #endif
+#ifdef SIMP_COULOMB
+#include <ddMd/potentials/coulomb/EwaldPotential.h>
+#ifdef SIMP_FFTW
+#include <ddMd/potentials/coulomb/SpmePotential.h>
+#endif
+#endif
 
 // namespace Util
 #include <util/misc/FileMaster.h>
@@ -61,6 +73,9 @@
 
 // std headers
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <utility>
 #include <unistd.h>
 #include <stdlib.h>
 
@@ -92,7 +107,10 @@ namespace DdMd
       domain_(),
       buffer_(),
       exchanger_(),
+      atomStress_(),
       random_(),
+      threadPool_(),
+      startupTimer_(Simulation::NStartupTime),
       maxBoundary_(),
       kineticEnergy_(0.0),
       pairPotentialPtr_(0),
@@ -108,12 +126,16 @@ namespace DdMd
       #ifdef SIMP_EXTERNAL
       externalPotentialPtr_(0),
       #endif
+      #ifdef SIMP_COULOMB
+      coulombPotentialPtr_(0),
+      #endif
       integratorPtr_(0),
       energyEnsemblePtr_(0),
       boundaryEnsemblePtr_(0),
       fileMasterPtr_(0),
       configIoPtr_(0),
       serializeConfigIoPtr_(0),
+      distributedConfigIoPtr_(0),
       #ifdef DDMD_MODIFIERS
       modifierManagerPtr_(0),
       #endif
@@ -146,6 +168,9 @@ namespace DdMd
       #ifdef SIMP_EXTERNAL
       externalStyle_(),
       #endif
+      #ifdef SIMP_COULOMB
+      coulombStyle_(),
+      #endif
       nAtomType_(0),
       #ifdef SIMP_BOND
       nBondType_(0),
@@ -159,14 +184,27 @@ namespace DdMd
       #ifdef SIMP_EXTERNAL
       hasExternal_(false),
       #endif
+      #ifdef SIMP_COULOMB
+      hasCoulomb_(false),
+      #endif
       hasAtomContext_(false),
       maskedPairPolicy_(MaskBonded),
       reverseUpdateFlag_(false),
+      halfShell_(false),
+      distributedRestart_(false),
+      compactUpdate_(false),
+      hasVelocity_(true),
       #ifdef UTIL_MPI
       communicator_(communicator),
+      replicaCommunicator_(),
       #endif
+      nSystem_(1),
+      systemId_(0),
+      configVersion_(0),
+      pairEnergiesVersion_(-1),
       isInitialized_(false),
-      isRestarting_(false)
+      isRestarting_(false),
+      loopDepth_(0)
    {
       Util::initStatic();
       setClassName("Simulation");
@@ -181,6 +219,7 @@ namespace DdMd
 
       setIoCommunicator(communicator);
       domain_.setGridCommunicator(communicator);
+      replicaCommunicator_ = communicator.Split(communicator.Get_rank(), 0);
       #else
       domain_.setRank(0);
       #endif
@@ -189,6 +228,7 @@ namespace DdMd
       domain_.setBoundary(boundary_);
       exchanger_.associate(domain_, boundary_, atomStorage_, buffer_);
       atomStorage_.associate(domain_, boundary_, buffer_);
+      atomStress_.associate(atomStorage_);
       #ifdef SIMP_BOND
       bondStorage_.associate(domain_, atomStorage_, buffer_);
       #endif
@@ -251,6 +291,11 @@ namespace DdMd
          delete externalPotentialPtr_;
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (coulombPotentialPtr_) {
+         delete coulombPotentialPtr_;
+      }
+      #endif
       if (configIoFactoryPtr_) {
          delete configIoFactoryPtr_;
       }
@@ -260,6 +305,9 @@ namespace DdMd
       if (serializeConfigIoPtr_) {
          delete serializeConfigIoPtr_;
       }
+      if (distributedConfigIoPtr_) {
+         delete distributedConfigIoPtr_;
+      }
       if (integratorFactoryPtr_) {
          delete integratorFactoryPtr_;
       }
@@ -303,18 +351,22 @@ namespace DdMd
       bool cFlag = false; // command file name
       bool iFlag = false; // input prefix
       bool oFlag = false; // output prefix
+      bool tFlag = false; // number of threads
+      bool bFlag = false; // bind threads to cores
       char* sArg = 0;
       char* rArg = 0;
       char* pArg = 0;
       char* cArg = 0;
       char* iArg = 0;
       char* oArg = 0;
+      char* tArg = 0;
       int  nSystem = 1;
 
-      // Read command-line arguments
+      // Read command-line arguments (reset optind for repeated calls)
       int c;
       opterr = 0;
-      while ((c = getopt(argc, argv, "es:p:r:c:i:o:")) != -1) {
+      optind = 1;
+      while ((c = getopt(argc, argv, "es:p:r:c:i:o:t:b")) != -1) {
          switch (c) {
          case 'e': // echo parameters
             eFlag = true;
@@ -344,6 +396,13 @@ namespace DdMd
             oFlag = true;
             oArg  = optarg;
             break;
+         case 't': // number of threads
+            tFlag = true;
+            tArg  = optarg;
+            break;
+         case 'b': // bind threads to cores
+            bFlag = true;
+            break;
          case '?':
             Log::file() << "Unknown option -" << optopt << std::endl;
          }
@@ -363,7 +422,12 @@ namespace DdMd
          // Split the communicator
          int systemSize = worldSize/nSystem;
          int systemId  = worldRank/systemSize;
-         communicator_ = communicator_.Split(systemId, worldRank);
+         MPI::Intracomm world = communicator_;
+         communicator_ = world.Split(systemId, worldRank);
+         replicaCommunicator_.Free();
+         replicaCommunicator_ = world.Split(worldRank % systemSize, systemId);
+         nSystem_ = nSystem;
+         systemId_ = systemId;
 
          // Set param and grid communicators
          setIoCommunicator(communicator_);
@@ -376,6 +440,17 @@ namespace DdMd
          Log::setFile(logFile_);
       }
 
+      // Options -t and -b: Configure the thread pool
+      if (tFlag) {
+         threadPool_.setNThread(atoi(tArg));
+      }
+      threadPool_.setPinned(bFlag);
+      threadPool_.initialize();
+      if (isIoProcessor() && Simp::ThreadPool::isThreaded()) {
+         Log::file() << "Number of threads per processor = "
+                     << threadPool_.nThread() << std::endl;
+      }
+
       // If option -e, enable echoing of parameters as they are read
       if (eFlag) {
          ParamComponent::setEcho(true);
@@ -450,7 +525,18 @@ namespace DdMd
    void Simulation::readParam()
    {
       if (!isRestarting_) {  
-         readParam(fileMaster().paramFile()); 
+         startupTimer_.start();
+
+         // Read the whole file on the io processor with one read, and
+         // parse it from memory, rather than line by line from disk.
+         std::stringstream buffer;
+         if (isIoProcessor()) {
+            buffer << fileMaster().paramFile().rdbuf();
+         }
+         readParam(buffer);
+
+         startupTimer_.stamp(STARTUP_PARAM);
+         startupTimer_.stop();
       }
       /// See comment about restarting in readParam(std::istream&)
    }
@@ -495,11 +581,30 @@ namespace DdMd
       hasExternal_ = false;
       readOptional<bool>(in, "hasExternal", hasExternal_); 
       #endif
+      #ifdef SIMP_COULOMB
+      hasCoulomb_ = false;
+      readOptional<bool>(in, "hasCoulomb", hasCoulomb_); 
+      #endif
 
       hasAtomContext_ = false;
       readOptional<bool>(in, "hasAtomContext", hasAtomContext_); 
       Atom::setHasAtomContext(hasAtomContext_);
 
+      halfShell_ = false;
+      readOptional<bool>(in, "halfShell", halfShell_);
+      Atom::setHasGhostMask(halfShell_);
+
+      distributedRestart_ = false;
+      readOptional<bool>(in, "distributedRestart", distributedRestart_);
+
+      compactUpdate_ = false;
+      readOptional<bool>(in, "compactUpdate", compactUpdate_);
+      exchanger_.setCompactUpdate(compactUpdate_);
+
+      hasVelocity_ = true;
+      readOptional<bool>(in, "hasVelocity", hasVelocity_);
+      Atom::setHasVelocity(hasVelocity_);
+
       // Read array of atom type descriptors
       atomTypes_.allocate(nAtomType_);
       for (int i = 0; i < nAtomType_; ++i) {
@@ -526,7 +631,14 @@ namespace DdMd
       #endif
 
       readParamComposite(in, buffer_);
+      #ifdef UTIL_MPI
+      buffer_.enableSharedMemory(domain_.communicator());
+      #endif
       readPotentialStyles(in);
+      if (halfShell_ && !reverseUpdateFlag_) {
+         UTIL_THROW("Half-shell scheme requires reverseUpdateFlag");
+      }
+      exchanger_.setHalfShell(halfShell_);
 
       // Create and read potential energy classes
 
@@ -537,6 +649,8 @@ namespace DdMd
          UTIL_THROW("Unknown pairStyle");
       }
       pairPotential().setReverseUpdateFlag(reverseUpdateFlag_);
+      pairPotential().setHalfShell(halfShell_);
+      pairPotential().setAtomStress(atomStress_);
       readParamComposite(in, *pairPotentialPtr_);
 
       #ifdef SIMP_BOND
@@ -547,6 +661,7 @@ namespace DdMd
          if (!bondPotentialPtr_) {
             UTIL_THROW("Unknown bondStyle");
          }
+         bondPotentialPtr_->setAtomStress(atomStress_);
          readParamComposite(in, *bondPotentialPtr_);
       }
       #endif
@@ -559,6 +674,7 @@ namespace DdMd
          if (!anglePotentialPtr_) {
             UTIL_THROW("Unknown angleStyle");
          }
+         anglePotentialPtr_->setAtomStress(atomStress_);
          readParamComposite(in, *anglePotentialPtr_);
       }
       #endif
@@ -571,6 +687,7 @@ namespace DdMd
          if (!dihedralPotentialPtr_) {
             UTIL_THROW("Unknown dihedralStyle");
          }
+         dihedralPotentialPtr_->setAtomStress(atomStress_);
          readParamComposite(in, *dihedralPotentialPtr_);
       }
       #endif
@@ -587,6 +704,16 @@ namespace DdMd
       }
       #endif
 
+      #ifdef SIMP_COULOMB
+      // Coulomb potential
+      if (hasCoulomb_) {
+         assert(coulombPotentialPtr_ == 0);
+         coulombPotentialPtr_ = newCoulombPotential(coulombStyle_);
+         coulombPotentialPtr_->setReverseUpdateFlag(reverseUpdateFlag_);
+         readParamComposite(in, *coulombPotentialPtr_);
+      }
+      #endif
+
       readEnsembles(in);
 
       // Integrator
@@ -608,38 +735,12 @@ namespace DdMd
 
       // Finished reading parameter file. Now finish initialization:
 
-      exchanger_.setPairCutoff(pairPotential().cutoff());
+      exchanger_.setPairCutoff(pairPotential().ghostCutoff());
+      exchanger_.setGroupMargin(pairPotential().skin());
       exchanger_.allocate();
 
       // Set signal observers (i.e., call-back functions for Signal::notify)
-      modifySignal().addObserver(*this, &Simulation::unsetKineticEnergy);
-      modifySignal().addObserver(*this, &Simulation::unsetKineticStress);
-      modifySignal().addObserver(*this, &Simulation::unsetPotentialEnergies);
-      modifySignal().addObserver(*this, &Simulation::unsetVirialStress);
-
-      velocitySignal().addObserver(*this, &Simulation::unsetKineticEnergy);
-      velocitySignal().addObserver(*this, &Simulation::unsetKineticStress);
-
-      positionSignal().addObserver(*this, &Simulation::unsetPotentialEnergies);
-      positionSignal().addObserver(*this, &Simulation::unsetVirialStress);
-      #ifdef SIMP_BOND
-      if (nBondType_) {
-         void (BondStorage::*memberPtr)() = &BondStorage::unsetNTotal;
-         exchangeSignal().addObserver(bondStorage_, memberPtr);
-      }
-      #endif
-      #ifdef SIMP_ANGLE
-      if (nAngleType_) {
-         void (AngleStorage::*memberPtr)() = &AngleStorage::unsetNTotal;
-         exchangeSignal().addObserver(angleStorage_, memberPtr);
-      }
-      #endif
-      #ifdef SIMP_DIHEDRAL
-      if (nDihedralType_) {
-         void (DihedralStorage::*memberPtr)() = &DihedralStorage::unsetNTotal;
-         exchangeSignal().addObserver(dihedralStorage_, memberPtr);
-      }
-      #endif
+      addSignalObservers();
 
       isInitialized_ = true;
    }
@@ -687,11 +788,31 @@ namespace DdMd
       hasExternal_ = false;
       loadParameter<bool>(ar, "hasExternal", hasExternal_, false); // opt
       #endif
+      #ifdef SIMP_COULOMB
+      hasCoulomb_ = false;
+      loadParameter<bool>(ar, "hasCoulomb", hasCoulomb_, false); // opt
+      #endif
 
       hasAtomContext_ = false;
       loadParameter<bool>(ar, "hasAtomContext", hasAtomContext_, false); // opt
       Atom::setHasAtomContext(hasAtomContext_);
 
+      halfShell_ = false;
+      loadParameter<bool>(ar, "halfShell", halfShell_, false); // opt
+      Atom::setHasGhostMask(halfShell_);
+
+      distributedRestart_ = false;
+      loadParameter<bool>(ar, "distributedRestart", distributedRestart_,
+                          false); // opt
+
+      compactUpdate_ = false;
+      loadParameter<bool>(ar, "compactUpdate", compactUpdate_, false); // opt
+      exchanger_.setCompactUpdate(compactUpdate_);
+
+      hasVelocity_ = true;
+      loadParameter<bool>(ar, "hasVelocity", hasVelocity_, false); // opt
+      Atom::setHasVelocity(hasVelocity_);
+
       atomTypes_.allocate(nAtomType_);
       for (int i = 0; i < nAtomType_; ++i) {
          atomTypes_[i].setId(i);
@@ -716,9 +837,16 @@ namespace DdMd
       }
       #endif
       loadParamComposite(ar, buffer_);
+      #ifdef UTIL_MPI
+      buffer_.enableSharedMemory(domain_.communicator());
+      #endif
 
       // Load potentials styles and parameters
       loadPotentialStyles(ar);
+      if (halfShell_ && !reverseUpdateFlag_) {
+         UTIL_THROW("Half-shell scheme requires reverseUpdateFlag");
+      }
+      exchanger_.setHalfShell(halfShell_);
 
       // Pair Potential
       assert(pairPotentialPtr_ == 0);
@@ -726,6 +854,8 @@ namespace DdMd
       if (!pairPotentialPtr_) {
          UTIL_THROW("Unknown pairStyle");
       }
+      pairPotential().setHalfShell(halfShell_);
+      pairPotential().setAtomStress(atomStress_);
       loadParamComposite(ar, *pairPotentialPtr_);
       pairPotential().setReverseUpdateFlag(reverseUpdateFlag_);
 
@@ -737,6 +867,7 @@ namespace DdMd
          if (!bondPotentialPtr_) {
             UTIL_THROW("Unknown bondStyle");
          }
+         bondPotentialPtr_->setAtomStress(atomStress_);
          loadParamComposite(ar, *bondPotentialPtr_);
       }
       #endif
@@ -749,6 +880,7 @@ namespace DdMd
          if (!anglePotentialPtr_) {
             UTIL_THROW("Unknown angleStyle");
          }
+         anglePotentialPtr_->setAtomStress(atomStress_);
          loadParamComposite(ar, *anglePotentialPtr_);
       }
       #endif
@@ -761,6 +893,7 @@ namespace DdMd
          if (!dihedralPotentialPtr_) {
             UTIL_THROW("Unknown dihedralStyle");
          }
+         dihedralPotentialPtr_->setAtomStress(atomStress_);
          loadParamComposite(ar, *dihedralPotentialPtr_);
       }
       #endif
@@ -777,6 +910,16 @@ namespace DdMd
       }
       #endif
 
+      #ifdef SIMP_COULOMB
+      // Coulomb potential
+      assert(coulombPotentialPtr_ == 0);
+      if (hasCoulomb_) {
+         coulombPotentialPtr_ = newCoulombPotential(coulombStyle_);
+         coulombPotentialPtr_->setReverseUpdateFlag(reverseUpdateFlag_);
+         loadParamComposite(ar, *coulombPotentialPtr_);
+      }
+      #endif
+
       loadEnsembles(ar);
 
       // Integrator
@@ -797,10 +940,34 @@ namespace DdMd
 
       // Finished loading data from archive. Now finish initialization:
 
-      exchanger_.setPairCutoff(pairPotential().cutoff());
+      exchanger_.setPairCutoff(pairPotential().ghostCutoff());
+      exchanger_.setGroupMargin(pairPotential().skin());
       exchanger_.allocate();
 
       // Set signal observers (i.e., call-back functions for Signal::notify)
+      addSignalObservers();
+
+      isInitialized_ = true;
+
+      // Load the configuration (boundary + positions + groups)
+      // A distributed configuration is instead read by load(filename).
+      if (!distributedRestart_) {
+         serializeConfigIo().loadConfig(ar, maskedPairPolicy_);
+
+         // There are no ghosts yet, so use initial exchange.
+         exchanger_.initialExchange();
+         isValid();
+      }
+   }
+
+   /*
+   * Add observers (call-back functions) to all signals.
+   */
+   void Simulation::addSignalObservers()
+   {
+      modifySignal().addObserver(*this, &Simulation::incrementConfigVersion);
+      positionSignal().addObserver(*this, &Simulation::incrementConfigVersion);
+
       modifySignal().addObserver(*this, &Simulation::unsetKineticEnergy);
       modifySignal().addObserver(*this, &Simulation::unsetKineticStress);
       modifySignal().addObserver(*this, &Simulation::unsetPotentialEnergies);
@@ -829,17 +996,14 @@ namespace DdMd
          exchangeSignal().addObserver(dihedralStorage_, memberPtr);
       }
       #endif
-
-      isInitialized_ = true;
-
-      // Load the configuration (boundary + positions + groups)
-      serializeConfigIo().loadConfig(ar, maskedPairPolicy_);
-
-      // There are no ghosts yet, so exchange.
-      exchanger_.exchange();
-      isValid();
    }
 
+   /*
+   * Increment version number of configuration.
+   */
+   void Simulation::incrementConfigVersion()
+   {  ++configVersion_; }
+
    // ---- Serialization -----------------------------------------------
 
    /*
@@ -865,6 +1029,12 @@ namespace DdMd
          ar.file().close();
       }
 
+      // Read distributed configuration (call on all processors)
+      if (distributedRestart_) {
+         distributedConfigIo().readRestart(filename, maskedPairPolicy_);
+         exchanger_.initialExchange();
+         isValid();
+      }
    }
 
    /*
@@ -891,7 +1061,14 @@ namespace DdMd
       #ifdef SIMP_EXTERNAL
       Parameter::saveOptional(ar, hasExternal_, hasExternal_);
       #endif
+      #ifdef SIMP_COULOMB
+      Parameter::saveOptional(ar, hasCoulomb_, hasCoulomb_);
+      #endif
       Parameter::saveOptional(ar, hasAtomContext_, hasAtomContext_);
+      Parameter::saveOptional(ar, halfShell_, halfShell_);
+      Parameter::saveOptional(ar, distributedRestart_, distributedRestart_);
+      Parameter::saveOptional(ar, compactUpdate_, compactUpdate_);
+      Parameter::saveOptional(ar, hasVelocity_, !hasVelocity_);
       ar << atomTypes_;
 
       // Read storage capacities
@@ -937,6 +1114,11 @@ namespace DdMd
          externalPotential().save(ar);
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().save(ar);
+      }
+      #endif
 
       // Save ensembles, integrator, modifiers, random, analyzers
       saveEnsembles(ar);
@@ -977,6 +1159,9 @@ namespace DdMd
          integrator().computeStatistics();
       }
 
+      // Reduce distributed analyzer statistics (call on all processors).
+      analyzerManager().reduce();
+
       // Save parameters (only on ioProcessor)
       Serializable::OArchive ar;
       if (isIoProcessor()) {
@@ -986,7 +1171,11 @@ namespace DdMd
       }
 
       // Save configuration (call on all processors)
-      serializeConfigIo().saveConfig(ar);
+      if (distributedRestart_) {
+         distributedConfigIo().writeRestart(filename);
+      } else {
+         serializeConfigIo().saveConfig(ar);
+      }
 
       if (isIoProcessor()) {
          ar.file().close();
@@ -1047,6 +1236,11 @@ namespace DdMd
          read<std::string>(in, "externalStyle", externalStyle_);
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         read<std::string>(in, "coulombStyle", coulombStyle_);
+      }
+      #endif
 
       // Read policy regarding whether to excluded pair interactions
       // between covalently bonded pairs.
@@ -1083,6 +1277,11 @@ namespace DdMd
          loadParameter<std::string>(ar, "externalStyle", externalStyle_);
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         loadParameter<std::string>(ar, "coulombStyle", coulombStyle_);
+      }
+      #endif
       loadParameter<MaskPolicy>(ar, "maskedPairPolicy", maskedPairPolicy_);
       loadParameter<bool>(ar, "reverseUpdateFlag", reverseUpdateFlag_);
 
@@ -1115,6 +1314,11 @@ namespace DdMd
          ar << externalStyle_;
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         ar << coulombStyle_;
+      }
+      #endif
       ar << maskedPairPolicy_;
       ar << reverseUpdateFlag_;
    }
@@ -1158,12 +1362,8 @@ namespace DdMd
       std::ifstream  inputFile;
       std::ofstream  outputFile;
 
-      #ifdef UTIL_MPI
       std::stringstream  inBuffer;
       std::string  line;
-      #else
-      std::istream&  inBuffer = in;
-      #endif
 
       bool readNext = true;
       while (readNext) {
@@ -1173,19 +1373,7 @@ namespace DdMd
             UTIL_THROW("Error: Storage set for Cartesian atom coordinates");
          }
 
-         #ifdef UTIL_MPI
-         // Read and broadcast command line
-         if (!hasIoCommunicator() || isIoProcessor()) {
-            getNextLine(in, line);
-            Log::file() << line << std::endl;
-         }
-         if (hasIoCommunicator()) {
-            bcast<std::string>(domain_.communicator(), line, 0);
-         }
-         #else // ifndef UTIL_MPI
-         getNextLine(in, line);
-         Log::file() << line << std::endl;
-         #endif 
+         getCommandLine(in, line);
          inBuffer.clear();
          for (unsigned i=0; i < line.size(); ++i) {
             inBuffer.put(line[i]);
@@ -1217,6 +1405,21 @@ namespace DdMd
                inBuffer >> filename;
                readConfig(filename);
             } else
+            if (command == "READ_CONFIG_DISTRIBUTED") {
+               // Read configuration with one file per processor.
+               inBuffer >> filename;
+               distributedConfigIo().readConfig(filename, maskedPairPolicy_);
+               exchanger_.initialExchange();
+               modifySignal().notify();
+            } else
+            if (command == "GENERATE_CONFIG") {
+               // Generate configuration in parallel, from a parameter file.
+               inBuffer >> filename;
+               GeneratorConfigIo generator(*this);
+               generator.readConfig(filename, maskedPairPolicy_);
+               exchanger_.initialExchange();
+               modifySignal().notify();
+            } else
             if (command == "THERMALIZE") {
                double temperature;
                inBuffer >> temperature;
@@ -1241,6 +1444,39 @@ namespace DdMd
                   integrator().outputStatistics(Log::file());
                }
             } else
+            if (command == "OUTPUT_PERFORMANCE") {
+               // Write per-phase timing and imbalance data to a CSV file.
+               inBuffer >> filename;
+               integrator().computeStatistics();
+               buffer().computeStatistics(domain_.communicator());
+               if (domain_.isMaster()) {
+                  fileMaster().openOutputFile(filename, outputFile);
+                  integrator().outputPerformance(outputFile);
+                  outputFile.close();
+               }
+            } else
+            if (command == "TRACE_STEPS") {
+               // Record a timeline of phases for steps in [iBegin, iEnd).
+               long iBegin, iEnd;
+               int capacity = 100000;
+               inBuffer >> iBegin >> iEnd;
+               if (!(inBuffer >> capacity)) {
+                  capacity = 100000;
+               }
+               Tracer::setWindow(iBegin, iEnd, capacity,
+                                 domain_.communicator());
+            } else
+            if (command == "WRITE_TRACE") {
+               // Gather timelines, write a Chrome trace event JSON file.
+               inBuffer >> filename;
+               if (domain_.isMaster()) {
+                  fileMaster().openOutputFile(filename, outputFile);
+               }
+               Tracer::write(outputFile, domain_.communicator());
+               if (domain_.isMaster()) {
+                  outputFile.close();
+               }
+            } else
             if (command == "OUTPUT_EXCHANGER_STATS") {
                // Output detailed statistics about time usage by Exchanger.
                integrator().computeStatistics();
@@ -1253,6 +1489,15 @@ namespace DdMd
                   exchanger_.outputStatistics(Log::file(), time, iStep);
                }
             } else
+            if (command == "OUTPUT_STARTUP_STATS") {
+               // Output times of startup phases, with load imbalance.
+               #ifdef UTIL_MPI
+               startupTimer_.reduce(domain().communicator());
+               #endif
+               if (domain_.isMaster()) {
+                  outputStartupStatistics(Log::file());
+               }
+            } else
             if (command == "OUTPUT_MEMORY_STATS") {
                // Output statistics about memory usage during simulation.
                // Also clears statistics after printing output
@@ -1275,6 +1520,7 @@ namespace DdMd
                pairPotential().pairList()
                               .computeStatistics(domain_.communicator());
                buffer().computeStatistics(domain_.communicator());
+               exchanger().computeStatistics(domain_.communicator());
                int maxMemory = Memory::max(domain_.communicator());
                if (domain_.isMaster()) {
                   atomStorage().outputStatistics(Log::file());
@@ -1294,6 +1540,7 @@ namespace DdMd
                   }
                   #endif
                   buffer().outputStatistics(Log::file());
+                  exchanger().outputMemoryStatistics(Log::file());
                   pairPotential().pairList().outputStatistics(Log::file());
                   Log::file() << std::endl;
                   Log::file() << "Memory: maximum allocated for arrays = "
@@ -1318,9 +1565,48 @@ namespace DdMd
                }
                #endif
                buffer().clearStatistics();
+               exchanger().clearStatistics();
                pairPotential().pairList().clearStatistics();
 
             } else
+            if (command == "OUTPUT_MEMORY_USAGE") {
+               // Output bytes allocated and high-water marks by subsystem.
+               MemoryReport report;
+               atomStorage().reportMemory(report);
+               #ifdef SIMP_BOND
+               if (nBondType_) {
+                  bondStorage().reportMemory(report, "BondStorage");
+               }
+               #endif
+               #ifdef SIMP_ANGLE
+               if (nAngleType_) {
+                  angleStorage().reportMemory(report, "AngleStorage");
+               }
+               #endif
+               #ifdef SIMP_DIHEDRAL
+               if (nDihedralType_) {
+                  dihedralStorage().reportMemory(report, "DihedralStorage");
+               }
+               #endif
+               double cellBytes = pairPotential().cellList().memoryBytes();
+               report.add("CellList", cellBytes, cellBytes);
+               pairPotential().pairList().reportMemory(report);
+               report.add("Buffer", buffer().memoryBytes(),
+                          buffer().maxMemoryBytes());
+               double analyzerBytes = analyzerManager().memoryBytes();
+               report.add("Analyzers", analyzerBytes, analyzerBytes);
+               double total = Memory::total() + PageAllocator::total();
+               double other = total - report.totalAllocated();
+               if (other < 0.0) other = 0.0;
+               report.add("Other", other, other);
+               report.add("Total", total,
+                          Memory::max() + PageAllocator::max());
+               report.reduce(domain_.communicator());
+               if (domain_.isMaster()) {
+                  report.output(Log::file());
+                  Log::file() << std::endl;
+               }
+            } else
             if (command == "CLEAR_INTEGRATOR") {
                // Clear timing, memory statistics, analyzer accumulators.
                // Also resets integrator iStep() to zero
@@ -1333,6 +1619,11 @@ namespace DdMd
                inBuffer >> filename;
                writeConfig(filename);
             } else
+            if (command == "WRITE_CONFIG_DISTRIBUTED") {
+               // Write configuration with one file per processor.
+               inBuffer >> filename;
+               distributedConfigIo().writeConfig(filename);
+            } else
             if (command == "WRITE_PARAM") {
                // Write params file, using current variable values.
                inBuffer >> filename;
@@ -1363,6 +1654,26 @@ namespace DdMd
                inBuffer >> prefix;
                fileMaster().setOutputPrefix(prefix);
             } else
+            if (command == "LOOP") {
+               // Execute the commands up to END_LOOP for each value.
+               readLoop(in, inBuffer);
+            } else
+            if (command == "END_LOOP") {
+               // Terminate the body of a loop (see readLoop).
+               if (loopDepth_ == 0) {
+                  UTIL_THROW("END_LOOP without matching LOOP");
+               }
+               readNext = false;
+            } else
+            if (command == "SET_TEMPERATURE") {
+               // Change the temperature of an isothermal ensemble.
+               double temperature;
+               inBuffer >> temperature;
+               if (!energyEnsemble().isIsothermal()) {
+                  UTIL_THROW("SET_TEMPERATURE with non-isothermal ensemble");
+               }
+               energyEnsemble().setTemperature(temperature);
+            } else
             if (command == "SET_PAIR") {
                // Modify one parameter of a pair interaction.
                std::string paramName;
@@ -1370,6 +1681,7 @@ namespace DdMd
                double value;
                inBuffer >> paramName >> typeId1 >> typeId2 >> value;
                pairPotential().set(paramName, typeId1, typeId2, value);
+               modifySignal().notify();
             } else
             #ifdef SIMP_BOND
             if (command == "SET_BOND") {
@@ -1382,6 +1694,7 @@ namespace DdMd
                double value;
                inBuffer >> paramName >> typeId >> value;
                bondPotential().set(paramName, typeId, value);
+               modifySignal().notify();
             } else
             #endif
             #ifdef SIMP_ANGLE
@@ -1395,6 +1708,7 @@ namespace DdMd
                double value;
                inBuffer >> paramName >> typeId >> value;
                anglePotential().set(paramName, typeId, value);
+               modifySignal().notify();
             } else
             #endif
             #ifdef SIMP_DIHEDRAL
@@ -1408,13 +1722,29 @@ namespace DdMd
                double value;
                inBuffer >> paramName >> typeId >> value;
                dihedralPotential().set(paramName, typeId, value);
+               modifySignal().notify();
             } else
             #endif
             if (command == "SET_GROUP") {
                setGroup(inBuffer);
             } else
+            if (command == "AUTOTUNE_PAIR") {
+               // Run steps with each pair force method, keep the fastest.
+               int nStep;
+               inBuffer >> nStep;
+               autotunePair(nStep);
+            } else
             if (command == "FINISH") {
                // Terminate loop over commands.
+               if (loopDepth_ > 0) {
+                  UTIL_THROW("FINISH within a LOOP block");
+               }
+               #ifdef UTIL_MPI
+               // Free persistent requests and shared memory before
+               // MPI is finalized.
+               buffer_.clearChannels();
+               buffer_.disableSharedMemory();
+               #endif
                readNext = false;
             } else {
                Log::file() << "Error: Unknown command  " << std::endl;
@@ -1425,6 +1755,52 @@ namespace DdMd
       }
    }
 
+   /*
+   * Read command line on io processor, broadcast to all processors.
+   */
+   void Simulation::getCommandLine(std::istream& in, std::string& line)
+   {
+      #ifdef UTIL_MPI
+      if (!hasIoCommunicator() || isIoProcessor()) {
+         getNextLine(in, line);
+         Log::file() << line << std::endl;
+      }
+      if (hasIoCommunicator()) {
+         bcast<std::string>(domain_.communicator(), line, 0);
+      }
+      #else
+      getNextLine(in, line);
+      Log::file() << line << std::endl;
+      #endif
+   }
+
+   /*
+   * Read body of a LOOP block, and execute it once for each value.
+   */
+   void Simulation::readLoop(std::istream& in, std::istream& header)
+   {
+      Simp::CommandLoop loop;
+      loop.readHeader(header);
+      std::string line;
+      getCommandLine(in, line);
+      while (loop.addLine(line)) {
+         getCommandLine(in, line);
+      }
+
+      // Body is known on all processors, so each can replay it.
+      ++loopDepth_;
+      for (int i = 0; i < loop.nValue(); ++i) {
+         if (domain_.isMaster()) {
+            Log::file() << "LOOP " << loop.name() << " = "
+                        << loop.value(i) << std::endl;
+         }
+         std::stringstream body;
+         loop.writeBody(i, body);
+         readCommands(body);
+      }
+      --loopDepth_;
+   }
+
    /*
    * Read and implement commands from the default command file.
    */
@@ -1441,6 +1817,9 @@ namespace DdMd
    */
    void Simulation::setReverseUpdateFlag(bool reverseUpdateFlag)
    {
+      if (halfShell_ && !reverseUpdateFlag) {
+         UTIL_THROW("Half-shell scheme requires reverseUpdateFlag");
+      }
       reverseUpdateFlag_ = reverseUpdateFlag;
       if (pairPotentialPtr_) {
          pairPotential().setReverseUpdateFlag(reverseUpdateFlag);
@@ -1452,6 +1831,9 @@ namespace DdMd
    */
     void Simulation::setBoltzmannVelocities(double temperature)
    {
+      // Without velocities (hasVelocity = 0), there is nothing to set.
+      if (!hasVelocity_) return;
+
       double mass;
       double scale;
       AtomIterator atomIter;
@@ -1476,6 +1858,8 @@ namespace DdMd
    Vector Simulation::removeDriftVelocity()
    {
       Vector momentum(0.0);      // atom momentum
+      if (!hasVelocity_) return momentum;
+
       Vector momentumLocal(0.0); // sum of momenta on processor
       Vector momentumTotal(0.0); // total momentum of system
       double mass;               // atom mass
@@ -1553,6 +1937,11 @@ namespace DdMd
          externalPotential().computeForces();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeForces();
+      }
+      #endif
 
       // Reverse communication (if any)
       if (reverseUpdateFlag_) {
@@ -1587,6 +1976,11 @@ namespace DdMd
          externalPotential().computeForces();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeForcesAndStress(domain_.communicator());
+      }
+      #endif
 
       // Reverse communication (if any)
       if (reverseUpdateFlag_) {
@@ -1604,19 +1998,7 @@ namespace DdMd
       // Do nothing if kinetic energy is already set.
       if (kineticEnergy_.isSet()) return;
 
-      double localEnergy = 0.0;
-      double mass;
-      int typeId;
-
-      // Add kinetic energies of local atoms on this processor
-      AtomIterator atomIter;
-      atomStorage_.begin(atomIter);
-      for( ; atomIter.notEnd(); ++atomIter){
-         typeId = atomIter->typeId();
-         mass   = atomTypes_[typeId].mass();
-         localEnergy += mass*(atomIter->velocity().square());
-      }
-      localEnergy = 0.5*localEnergy;
+      double localEnergy = localKineticEnergy();
 
       #ifdef UTIL_MPI
       // Sum values from all processors.
@@ -1632,6 +2014,47 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Store total kinetic energy computed elsewhere (call on all processors).
+   */
+   void Simulation::setKineticEnergy(double energy)
+   {
+      #ifdef UTIL_MPI
+      if (domain_.communicator().Get_rank() != 0) {
+         energy = 0.0;
+      }
+      #endif
+      kineticEnergy_.set(energy);
+   }
+
+   /*
+   * Return kinetic energy of local atoms on this processor (private).
+   */
+   double Simulation::localKineticEnergy()
+   {
+      double localEnergy = 0.0;
+      double mass;
+      int typeId;
+
+      // Without velocities, return the equipartition value.
+      if (!hasVelocity_) {
+         if (energyEnsemble().isIsothermal()) {
+            localEnergy = Dimension*energyEnsemble().temperature()
+                        *atomStorage_.nAtom();
+         }
+         return 0.5*localEnergy;
+      }
+
+      AtomIterator atomIter;
+      atomStorage_.begin(atomIter);
+      for( ; atomIter.notEnd(); ++atomIter){
+         typeId = atomIter->typeId();
+         mass   = atomTypes_[typeId].mass();
+         localEnergy += mass*(atomIter->velocity().square());
+      }
+      return 0.5*localEnergy;
+   }
+
    /*
    * Return total kinetic energy (on master processor).
    *
@@ -1660,11 +2083,44 @@ namespace DdMd
       if (kineticStress_.isSet()) return;
 
       Tensor localStress;
+      computeLocalKineticStress(localStress);
+
+      #ifdef UTIL_MPI
+      // Sum values from all processors
+      Tensor totalStress;
+      domain_.communicator().Reduce(&localStress(0, 0), &totalStress(0, 0),
+                                    Dimension*Dimension, MPI::DOUBLE, MPI::SUM, 0);
+      if (domain_.communicator().Get_rank() != 0) {
+         totalStress.zero();
+      }
+      kineticStress_.set(totalStress);
+      #else
+      kineticStress_.set(localStress);
+      #endif
+   }
+
+   /*
+   * Compute kinetic stress of local atoms on this processor (private).
+   */
+   void Simulation::computeLocalKineticStress(Tensor& stress)
+   {
       double  mass;
       Vector  velocity;
       int typeId, i, j;
 
-      localStress.zero();
+      stress.zero();
+
+      // Without velocities, use the ideal gas value nkT*delta(i, j).
+      if (!hasVelocity_) {
+         if (energyEnsemble().isIsothermal()) {
+            double nkT = energyEnsemble().temperature()*atomStorage_.nAtom();
+            for (i = 0; i < Dimension; ++i) {
+               stress(i, i) = nkT;
+            }
+            stress /= boundary().volume();
+         }
+         return;
+      }
 
       // For each local atoms on this processor, stress(i, j) += m*v[i]*v[j]
       AtomIterator atomIter;
@@ -1675,26 +2131,13 @@ namespace DdMd
          mass = atomTypes_[typeId].mass();
          for (i = 0; i < Dimension; ++i) {
             for (j = 0; j < Dimension; ++j) {
-               localStress(i, j) += mass*velocity[i]*velocity[j];
+               stress(i, j) += mass*velocity[i]*velocity[j];
             }
          }
       }
 
       // Divide dyad sum by system volume
-      localStress /= boundary().volume();
-
-      #ifdef UTIL_MPI
-      // Sum values from all processors
-      Tensor totalStress;
-      domain_.communicator().Reduce(&localStress(0, 0), &totalStress(0, 0),
-                                    Dimension*Dimension, MPI::DOUBLE, MPI::SUM, 0);
-      if (domain_.communicator().Get_rank() != 0) {
-         totalStress.zero();
-      }
-      kineticStress_.set(totalStress);
-      #else
-      kineticStress_.set(localStress);
-      #endif
+      stress /= boundary().volume();
    }
 
    /*
@@ -1751,6 +2194,11 @@ namespace DdMd
          externalPotential().computeEnergy(domain_.communicator());
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeEnergy(domain_.communicator());
+      }
+      #endif
    }
 
    #else
@@ -1780,6 +2228,11 @@ namespace DdMd
          externalPotential().computeEnergy();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeEnergy();
+      }
+      #endif
    }
    #endif
 
@@ -1820,6 +2273,11 @@ namespace DdMd
          energy += externalPotential().energy();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         energy += coulombPotential().energy();
+      }
+      #endif
       return energy;
    }
 
@@ -1829,6 +2287,7 @@ namespace DdMd
    void Simulation::unsetPotentialEnergies()
    {
       pairPotential().unsetEnergy();
+      pairPotential().unsetEpsilonDerivative();
       #ifdef SIMP_BOND
       if (nBondType_) {
          bondPotential().unsetEnergy();
@@ -1849,6 +2308,11 @@ namespace DdMd
          externalPotential().unsetEnergy();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().unsetEnergy();
+      }
+      #endif
    }
 
    // --- Virial Stress Methods ----------------------------------------
@@ -1875,6 +2339,11 @@ namespace DdMd
          dihedralPotential().computeStress(domain_.communicator());
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeStress(domain_.communicator());
+      }
+      #endif
    }
    #else
    /*
@@ -1898,6 +2367,11 @@ namespace DdMd
          dihedralPotential().computeStress();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().computeStress();
+      }
+      #endif
    }
    #endif
 
@@ -1924,6 +2398,11 @@ namespace DdMd
          stress += dihedralPotential().stress();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         stress += coulombPotential().stress();
+      }
+      #endif
       return stress;
    }
 
@@ -1950,6 +2429,11 @@ namespace DdMd
          pressure += dihedralPotential().pressure();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         pressure += coulombPotential().pressure();
+      }
+      #endif
       return pressure;
    }
 
@@ -1958,24 +2442,32 @@ namespace DdMd
    * Compute all pair energy contributions.
    */
    void Simulation::computePairEnergies()
-   {  pairPotential().computePairEnergies(domain_.communicator()); }
+   {
+      if (pairEnergiesVersion_ == configVersion_) return;
+      pairPotential().computePairEnergies(domain_.communicator());
+      pairEnergiesVersion_ = configVersion_;
+   }
    #else
    /*
    * Compute all pair energy contributions.
    */
    void Simulation::computePairEnergies()
-   {  pairPotential().computePairEnergies(); }
+   {
+      if (pairEnergiesVersion_ == configVersion_) return;
+      pairPotential().computePairEnergies();
+      pairEnergiesVersion_ = configVersion_;
+   }
    #endif
 
    /*
-   * Return pair energies contributions.
+   * Copy pair energies contributions into a caller-provided matrix.
    */
-   DMatrix<double> Simulation::pairEnergies() const
+   void Simulation::pairEnergies(DMatrix<double>& energies) const
    {
-      DMatrix<double> pairEnergies;
-      pairEnergies.allocate(nAtomType_, nAtomType_);
-      pairEnergies = pairPotential().pairEnergies();
-      return pairEnergies;
+      if (!energies.isAllocated()) {
+         energies.allocate(nAtomType_, nAtomType_);
+      }
+      energies = pairPotential().pairEnergies();
    }
 
    /*
@@ -1999,8 +2491,277 @@ namespace DdMd
          dihedralPotential().unsetStress();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         coulombPotential().unsetStress();
+      }
+      #endif
    }
 
+   // --- Fused Energy and Stress Evaluation ---------------------------
+
+   #ifdef UTIL_MPI
+   /*
+   * Compute energies and/or stresses, with one reduction of each.
+   *
+   * Each potential is told to defer reduction, so that the usual
+   * compute methods store local contributions without communicating.
+   * Local kinetic and potential energies are packed into one buffer,
+   * and local stresses into another. With MPI-3, the energies are 
+   * summed by a non-blocking MPI_Iallreduce that proceeds while the 
+   * stresses are computed, and both reductions are completed together.
+   * Totals are then unpacked in the same order, on the master only.
+   */
+   void Simulation::computeThermo(bool needEnergy, bool needStress)
+   {
+      // Kinetic, pair, bond, angle, dihedral, external and coulomb terms
+      const int capacity = 7*(1 + Dimension*Dimension);
+      double localValues[capacity];
+      double totalValues[capacity];
+      double buffer[1 + Dimension*Dimension];
+      Potential* potentials[6];
+      int energyCounts[6];
+      int stressCounts[6];
+      int nPotential = 0;
+      int nEnergy;
+      int i, j, k, m, n;
+
+      // Collect all potentials that exist in this simulation
+      potentials[nPotential] = &pairPotential();
+      ++nPotential;
+      #ifdef SIMP_BOND
+      if (nBondType_) {
+         potentials[nPotential] = &bondPotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (nAngleType_) {
+         potentials[nPotential] = &anglePotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (nDihedralType_) {
+         potentials[nPotential] = &dihedralPotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_EXTERNAL
+      if (hasExternal_) {
+         potentials[nPotential] = &externalPotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         potentials[nPotential] = &coulombPotential();
+         ++nPotential;
+      }
+      #endif
+      for (k = 0; k < nPotential; ++k) {
+         potentials[k]->deferReduction();
+      }
+
+      // Compute and pack local energies, without communication
+      if (needEnergy) {
+         computePotentialEnergies();
+      }
+      bool hasKineticEnergy = needEnergy && !kineticEnergy_.isSet();
+      n = 0;
+      if (hasKineticEnergy) {
+         localValues[n] = localKineticEnergy();
+         ++n;
+      }
+      for (k = 0; k < nPotential; ++k) {
+         energyCounts[k] = potentials[k]->packDeferred(&localValues[n]);
+         n += energyCounts[k];
+      }
+      nEnergy = n;
+
+      // Start summing energies over all processors
+      MPI_Comm comm = (MPI_Comm) domain_.communicator();
+      #if MPI_VERSION >= 3
+      MPI_Request requests[2];
+      int nRequest = 0;
+      if (nEnergy > 0) {
+         MPI_Iallreduce(localValues, totalValues, nEnergy, MPI_DOUBLE, 
+                        MPI_SUM, comm, &requests[nRequest]);
+         ++nRequest;
+      }
+      #endif
+
+      // Compute and pack local stresses, while energies are reduced
+      if (needStress) {
+         computeVirialStress();
+      }
+      bool hasKineticStress = needStress && !kineticStress_.isSet();
+      if (hasKineticStress) {
+         Tensor stress;
+         computeLocalKineticStress(stress);
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               localValues[n] = stress(i, j);
+               ++n;
+            }
+         }
+      }
+      for (k = 0; k < nPotential; ++k) {
+         // Repacks any deferred energy, which precedes the stress
+         m = potentials[k]->packDeferred(buffer);
+         stressCounts[k] = m - energyCounts[k];
+         for (i = energyCounts[k]; i < m; ++i) {
+            localValues[n] = buffer[i];
+            ++n;
+         }
+      }
+      UTIL_CHECK(n <= capacity);
+
+      // Sum stresses, and complete both reductions
+      #if MPI_VERSION >= 3
+      if (n > nEnergy) {
+         MPI_Iallreduce(&localValues[nEnergy], &totalValues[nEnergy], 
+                        n - nEnergy, MPI_DOUBLE, MPI_SUM, comm, 
+                        &requests[nRequest]);
+         ++nRequest;
+      }
+      MPI_Waitall(nRequest, requests, MPI_STATUSES_IGNORE);
+      #else
+      if (n > 0) {
+         MPI_Allreduce(localValues, totalValues, n, MPI_DOUBLE, 
+                       MPI_SUM, comm);
+      }
+      #endif
+
+      // Totals are defined only on the master
+      if (domain_.communicator().Get_rank() != 0) {
+         for (i = 0; i < n; ++i) {
+            totalValues[i] = 0.0;
+         }
+      }
+
+      // Unpack total energies (from n) and stresses (from m)
+      n = 0;
+      m = nEnergy;
+      if (hasKineticEnergy) {
+         kineticEnergy_.set(totalValues[n]);
+         ++n;
+      }
+      if (hasKineticStress) {
+         Tensor stress;
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               stress(i, j) = totalValues[m];
+               ++m;
+            }
+         }
+         kineticStress_.set(stress);
+      }
+      for (k = 0; k < nPotential; ++k) {
+         for (i = 0; i < energyCounts[k]; ++i) {
+            buffer[i] = totalValues[n];
+            ++n;
+         }
+         for (i = 0; i < stressCounts[k]; ++i) {
+            buffer[energyCounts[k] + i] = totalValues[m];
+            ++m;
+         }
+         potentials[k]->unpackDeferred(buffer);
+      }
+   }
+
+   /*
+   * Compute contribution of this processor to total stress.
+   *
+   * Stresses are recomputed with deferred reduction, so that only local
+   * values are stored, and are then unset, because the values set when
+   * deferral ends are not totals.
+   */
+   void Simulation::computeLocalStress(Tensor& stress)
+   {
+      double buffer[Dimension*Dimension];
+      Potential* potentials[5];
+      int nPotential = 0;
+      int i, j, k, n;
+
+      potentials[nPotential] = &pairPotential();
+      ++nPotential;
+      #ifdef SIMP_BOND
+      if (nBondType_) {
+         potentials[nPotential] = &bondPotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_ANGLE
+      if (nAngleType_) {
+         potentials[nPotential] = &anglePotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      if (nDihedralType_) {
+         potentials[nPotential] = &dihedralPotential();
+         ++nPotential;
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulomb_) {
+         potentials[nPotential] = &coulombPotential();
+         ++nPotential;
+      }
+      #endif
+
+      // Compute local virial stresses, without communication
+      unsetVirialStress();
+      for (k = 0; k < nPotential; ++k) {
+         potentials[k]->deferReduction();
+      }
+      computeVirialStress();
+
+      // Add local kinetic and virial stresses
+      computeLocalKineticStress(stress);
+      for (k = 0; k < nPotential; ++k) {
+         n = potentials[k]->packDeferred(buffer);
+         UTIL_CHECK(n == Dimension*Dimension);
+         n = 0;
+         for (i = 0; i < Dimension; ++i) {
+            for (j = 0; j < Dimension; ++j) {
+               stress(i, j) += buffer[n];
+               ++n;
+            }
+         }
+         potentials[k]->unpackDeferred(buffer);
+         potentials[k]->unsetStress();
+      }
+   }
+
+   #else
+   /*
+   * Compute energies and/or stresses (serial version).
+   */
+   void Simulation::computeThermo(bool needEnergy, bool needStress)
+   {
+      if (needEnergy) {
+         computeKineticEnergy();
+         computePotentialEnergies();
+      }
+      if (needStress) {
+         computeKineticStress();
+         computeVirialStress();
+      }
+   }
+
+   /*
+   * Compute total stress (serial version).
+   */
+   void Simulation::computeLocalStress(Tensor& stress)
+   {
+      computeKineticStress();
+      computeVirialStress();
+      stress.add(kineticStress(), virialStress());
+   }
+   #endif
+
    // --- ConfigIo Accessors -------------------------------------------
 
    /*
@@ -2031,6 +2792,17 @@ namespace DdMd
       return *serializeConfigIoPtr_;
    }
 
+   /*
+   * Return a DistributedConfigIo (create if necessary).
+   */
+   DistributedConfigIo& Simulation::distributedConfigIo()
+   {
+      if (distributedConfigIoPtr_ == 0) {
+         distributedConfigIoPtr_ = new DistributedConfigIo(*this);
+      }
+      return *distributedConfigIoPtr_;
+   }
+
    // --- Config File Read and Write -----------------------------------
 
    /*
@@ -2042,13 +2814,52 @@ namespace DdMd
       if (domain_.isMaster()) {
          fileMaster().openInputFile(filename, inputFile);
       }
-      configIo().readConfig(inputFile, maskedPairPolicy_);
-      exchanger_.exchange();
+      readConfig(inputFile);
       if (domain_.isMaster()) {
          inputFile.close();
       }
    }
 
+   /*
+   * Read configuration from an open stream (stream used only on master).
+   */
+   void Simulation::readConfig(std::ifstream& file)
+   {
+      startupTimer_.start();
+      configIo().readConfig(file, maskedPairPolicy_);
+      startupTimer_.stamp(STARTUP_CONFIG);
+      exchanger_.initialExchange();
+      startupTimer_.stamp(STARTUP_EXCHANGE);
+      startupTimer_.stop();
+      modifySignal().notify();
+   }
+
+   /*
+   * Remove all atoms, ghosts and groups, on all processors.
+   */
+   void Simulation::clearConfig()
+   {
+      atomStorage_.clearSnapshot();
+      atomStorage_.clearGhosts();
+      atomStorage_.clearAtoms();
+      #ifdef UTIL_MPI
+      atomStorage_.unsetNAtomTotal();
+      #endif
+      #ifdef SIMP_BOND
+      bondStorage_.clearGroups();
+      bondStorage_.unsetNTotal();
+      #endif
+      #ifdef SIMP_ANGLE
+      angleStorage_.clearGroups();
+      angleStorage_.unsetNTotal();
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      dihedralStorage_.clearGroups();
+      dihedralStorage_.unsetNTotal();
+      #endif
+      modifySignal().notify();
+   }
+
    /*
    * Write configuration file on master.
    */
@@ -2064,6 +2875,12 @@ namespace DdMd
       }
    }
 
+   /*
+   * Write configuration to an open stream (stream used only on master).
+   */
+   void Simulation::writeConfig(std::ofstream& file)
+   {  configIo().writeConfig(file); }
+
    // --- Potential Factories and Styles -------------------------------
 
    /*
@@ -2164,6 +2981,31 @@ namespace DdMd
    {  return externalStyle_;  }
    #endif
 
+   #ifdef SIMP_COULOMB
+   /*
+   * Get the Coulomb style string.
+   */
+   std::string Simulation::coulombStyle() const
+   {  return coulombStyle_;  }
+
+   /*
+   * Create a new CoulombPotential of the specified style (private).
+   */
+   CoulombPotential* Simulation::newCoulombPotential(const std::string& style)
+   {
+      if (style == "Ewald") {
+         return new EwaldPotential(*this);
+      }
+      #ifdef SIMP_FFTW
+      if (style == "SPME") {
+         return new SpmePotential(*this);
+      }
+      #endif
+      UTIL_THROW("Unknown coulombStyle");
+      return 0;
+   }
+   #endif
+
    // --- Integrator and ConfigIo Management ---------------------------
 
    /*
@@ -2205,6 +3047,126 @@ namespace DdMd
       configIoPtr_ = ptr;
    }
 
+   /*
+   * Time pair force methods and block sizes, and keep the fastest.
+   */
+   void Simulation::autotunePair(int nStep)
+   {
+      if (nStep < 1) {
+         UTIL_THROW("AUTOTUNE_PAIR requires nStep > 0");
+      }
+      PairPotential& pair = pairPotential();
+
+      // Candidate (methodId, blockSize) pairs
+      std::vector< std::pair<int, int> > candidates;
+      int blockSize = pair.blockSize();
+      #if !defined(DDMD_OPENMP) && !defined(DDMD_OFFLOAD)
+      // Block size matters only in the serial blocked pair list loop
+      if (!pair.reverseUpdateFlag()) {
+         candidates.push_back(std::make_pair(0, 8));
+         candidates.push_back(std::make_pair(0, 16));
+         candidates.push_back(std::make_pair(0, 32));
+         candidates.push_back(std::make_pair(0, 64));
+      } else {
+         candidates.push_back(std::make_pair(0, blockSize));
+      }
+      #else
+      candidates.push_back(std::make_pair(0, blockSize));
+      #endif
+      if (!pair.halfShell()) {
+         candidates.push_back(std::make_pair(1, blockSize));
+
+         // The N^2 loop can only be competitive for very small domains
+         int nAtom = atomStorage().nAtom() + atomStorage().nGhost();
+         #ifdef UTIL_MPI
+         int maxNAtom;
+         domain_.communicator().Allreduce(&nAtom, &maxNAtom, 1,
+                                          MPI::INT, MPI::MAX);
+         nAtom = maxNAtom;
+         #endif
+         if (nAtom <= 4096) {
+            candidates.push_back(std::make_pair(2, blockSize));
+         }
+      }
+
+      // Time nStep steps with each candidate
+      int nCandidate = candidates.size();
+      int best = 0;
+      double bestTime = 0.0;
+      double time;
+      Timer timer;
+      if (domain_.isMaster()) {
+         Log::file() << std::endl;
+         Log::file() << "Pair autotune: methodId  blockSize  time [sec]"
+                     << std::endl;
+      }
+      for (int i = 0; i < nCandidate; ++i) {
+         pair.setMethodId(candidates[i].first);
+         pair.setBlockSize(candidates[i].second);
+         #ifdef UTIL_MPI
+         domain_.communicator().Barrier();
+         #endif
+         timer.clear();
+         timer.start();
+         integrator().run(nStep);
+         timer.stop();
+         time = timer.time();
+         #ifdef UTIL_MPI
+         double maxTime;
+         domain_.communicator().Allreduce(&time, &maxTime, 1,
+                                          MPI::DOUBLE, MPI::MAX);
+         time = maxTime;
+         #endif
+         if (i == 0 || time < bestTime) {
+            best = i;
+            bestTime = time;
+         }
+         if (domain_.isMaster()) {
+            Log::file() << "Pair autotune: "
+                        << Int(candidates[i].first, 8)
+                        << Int(candidates[i].second, 11)
+                        << Dbl(time, 13) << std::endl;
+         }
+      }
+
+      pair.setMethodId(candidates[best].first);
+      pair.setBlockSize(candidates[best].second);
+      if (domain_.isMaster()) {
+         Log::file() << "Pair autotune: selected methodId "
+                     << candidates[best].first
+                     << ", blockSize " << candidates[best].second
+                     << std::endl;
+      }
+   }
+
+   /*
+   * Output times of startup phases (call only on master, after reduce).
+   */
+   void Simulation::outputStartupStatistics(std::ostream& out)
+   {
+      if (!domain_.isMaster()) {
+         UTIL_THROW("May be called only on domain master");
+      }
+
+      const char* names[NStartupTime] = {"ReadParam", "ReadConfig",
+                                         "InitialExchange", "SetupAtoms"};
+      out << std::endl;
+      out << "Startup              "
+          << "   Avg [sec]   "
+          << "   Max [sec]   "
+          << " Imbalance" << std::endl;
+      for (int i = 0; i < NStartupTime; ++i) {
+         out << Str(names[i], 21)
+             << Dbl(startupTimer_.time(i), 12, 6) << "   "
+             << Dbl(startupTimer_.maxTime(i), 12, 6) << "   "
+             << Dbl(startupTimer_.imbalance(i), 12, 6) << std::endl;
+      }
+      out << "Total                "
+          << Dbl(startupTimer_.time(), 12, 6) << "   "
+          << Dbl(startupTimer_.maxTime(), 12, 6) << std::endl;
+      out << std::endl;
+   }
+
    // --- Group Management ---------------------------------------------
    
    /*
@@ -13,11 +13,14 @@
 #include <ddMd/communicate/Buffer.h>             // member
 #include <ddMd/communicate/Exchanger.h>          // member
 #include <ddMd/storage/AtomStorage.h>            // member
+#include <ddMd/potentials/AtomStress.h>          // member
 #include <ddMd/storage/BondStorage.h>            // member
 #include <ddMd/storage/AngleStorage.h>           // member
 #include <ddMd/storage/DihedralStorage.h>        // member
 #include <ddMd/chemistry/AtomType.h>             // member (template param)
 #include <ddMd/chemistry/MaskPolicy.h>           // member
+#include <ddMd/misc/DdTimer.h>                    // member
+#include <simp/threads/ThreadPool.h>             // member
 #include <util/random/Random.h>                  // member
 #include <util/boundary/Boundary.h>              // member
 #include <util/space/Tensor.h>                   // member (template param)
@@ -42,6 +45,7 @@ namespace DdMd
    class Integrator;
    class ConfigIo;
    class SerializeConfigIo;
+   class DistributedConfigIo;
    #ifdef DDMD_MODIFIERS
    class ModifierManager;
    #endif
@@ -59,6 +63,9 @@ namespace DdMd
    #ifdef SIMP_EXTERNAL
    class ExternalPotential;
    #endif
+   #ifdef SIMP_COULOMB
+   class CoulombPotential;
+   #endif
 
    using namespace Util;
 
@@ -85,6 +92,18 @@ namespace DdMd
       using ParamComposite::readParam;
       using ParamComposite::load;
 
+      /**
+      * Enumeration of startup phase time stamp identifiers.
+      *
+      * STARTUP_PARAM is the time of readParam(), STARTUP_CONFIG the
+      * time to read and distribute atoms and groups in readConfig(),
+      * STARTUP_EXCHANGE the time of the initial exchange of atoms and
+      * ghosts, and STARTUP_SETUP the accumulated time of calls to
+      * Integrator::setupAtoms().
+      */
+      enum StartupTimeId {STARTUP_PARAM, STARTUP_CONFIG, STARTUP_EXCHANGE,
+                          STARTUP_SETUP, NStartupTime};
+
       // Lifetime
 
       #ifdef UTIL_MPI
@@ -123,6 +142,14 @@ namespace DdMd
       *       is the number of systems. The rank of the communicator passed
       *       to the constructor must be an integer multiple of nSystem.
       *
+      *   -t  nThread [int]
+      *       Sets the number of threads per processor used by threaded
+      *       parts of the code (if compiled with DDMD_OPENMP). By default,
+      *       the OpenMP runtime default is used.
+      *
+      *   -b  Bind (pin) each thread to one core of those allowed to this
+      *       process.
+      *
       *   -p  filename [string]
       *       Specifies the name of a parameter file. If not specified here, 
       *       the parameter file for a single-system simulation may be read
@@ -298,6 +325,26 @@ namespace DdMd
       */
       void readConfig(const std::string& filename);
 
+      /**
+      * Read configuration from an open input stream and distribute atoms.
+      *
+      * Call on all processors. Only the stream on the master is used.
+      * Postconditions are the same as for readConfig(filename).
+      *
+      * \pre AtomStorage and group storage are empty (see clearConfig)
+      *
+      * \param file  input stream, open on the master processor
+      */
+      void readConfig(std::ifstream& file);
+
+      /**
+      * Remove all atoms, ghosts and groups from storage.
+      *
+      * Call on all processors. Upon return, a new configuration may
+      * be read by readConfig.
+      */
+      void clearConfig();
+
       /**
       * Write configuration file.
       *
@@ -307,6 +354,15 @@ namespace DdMd
       */
       void writeConfig(const std::string& filename);
 
+      /**
+      * Write configuration to an open output stream.
+      *
+      * Call on all processors. Only the stream on the master is used.
+      *
+      * \param file  output stream, open on the master processor
+      */
+      void writeConfig(std::ofstream& file);
+
       /**
       * Get the configuration file reader/writer factory by reference.
       */
@@ -374,6 +430,18 @@ namespace DdMd
       */
       void unsetKineticEnergy();
 
+      /**
+      * Store a total kinetic energy computed elsewhere.
+      *
+      * Allows an integrator that sums the kinetic energy during its own
+      * pass over atoms to avoid a second pass and reduction. Call on all
+      * processors with the same total, after the last change of the
+      * velocities (i.e., after notifying velocitySignal()).
+      *
+      * \param energy total kinetic energy of all processors
+      */
+      void setKineticEnergy(double energy);
+
       /**
       * Calculate and store total potential energy on all processors.
       *
@@ -399,18 +467,24 @@ namespace DdMd
       /**
       * Compute pair energies for each pair of atom types.
       *
+      * Does nothing if the pair energies have already been computed
+      * for the current value of configVersion().
+      *
       * Reduce operation: Must be called on all nodes.
       */
       void computePairEnergies();
 
       /**
-      * Return precomputed pair energies.
+      * Copy precomputed pair energies into a caller-provided matrix.
       *
-      * Call only on master processor, after computePairEnergies.
+      * Call only on master processor, after computePairEnergies. The
+      * matrix is allocated with dimensions nAtomType x nAtomType if it
+      * is not already allocated, so that a caller that reuses the same
+      * matrix allocates memory only once.
       *
-      * \return total pair energies (only correct on master node).
+      * \param energies total pair energies (only correct on master node).
       */
-      DMatrix<double> pairEnergies() const;
+      void pairEnergies(DMatrix<double>& energies) const;
 
       #ifdef SIMP_EXTERNAL
       /**
@@ -497,6 +571,44 @@ namespace DdMd
       */
       void unsetVirialStress();
 
+      /**
+      * Calculate and store energies and/or stresses with fused reductions.
+      *
+      * Reduce operation: Must be called on all nodes. If needEnergy is
+      * true, this computes the kinetic and all potential energies, like
+      * computeKineticEnergy() and computePotentialEnergies(). If 
+      * needStress is true, it computes the kinetic and virial stress,
+      * like computeKineticStress() and computeVirialStress(). Values 
+      * that are already set are not recomputed. Contributions of each
+      * processor to all energies, and to all stresses, are each summed
+      * in one reduction of a packed buffer, rather than by one reduction
+      * per quantity, and totals are stored on the master processor. With
+      * MPI-3, the energy reduction is non-blocking (MPI_Iallreduce), and
+      * overlaps computation of the stresses. Analyzers that sample 
+      * energies or stresses should use this when possible, to reduce 
+      * latency on large numbers of processors. 
+      *
+      * \param needEnergy  compute kinetic and potential energies?
+      * \param needStress  compute kinetic and virial stresses?
+      */
+      void computeThermo(bool needEnergy, bool needStress);
+
+      /**
+      * Compute the contribution of this processor to the total stress.
+      *
+      * Call on all nodes. This does not communicate. On return,
+      * stress contains the sum of the kinetic and virial stress of this
+      * processor, so that the sum of stress over all processors is the
+      * total stress, kineticStress() + virialStress(). In a parallel
+      * run, virial stresses of all potentials are recomputed, and are
+      * left unset on return.
+      * Analyzers may accumulate these local values for several steps,
+      * and then sum all of them in a single reduction.
+      *
+      * \param stress  local stress (output)
+      */
+      void computeLocalStress(Tensor& stress);
+
       //@}
       /// \name Potential Energy Classes (Objects, Style Strings and Factories)
       //@{
@@ -609,6 +721,23 @@ namespace DdMd
       Factory<ExternalPotential>& externalFactory();
       #endif
 
+      #ifdef SIMP_COULOMB
+      /**
+      * Get the Coulomb potential by reference.
+      */
+      CoulombPotential& coulombPotential();
+
+      /**
+      * Get the Coulomb potential by const reference.
+      */
+      const CoulombPotential& coulombPotential() const;
+
+      /**
+      * Return Coulomb potential style string ("Ewald" or "SPME").
+      */
+      std::string coulombStyle() const;
+      #endif
+
       //@}
       /// \name Atom and Group Containers
       //@{
@@ -685,16 +814,54 @@ namespace DdMd
       */
       Random& random();
 
+      /**
+      * Get the ThreadPool by reference.
+      */
+      Simp::ThreadPool& threadPool();
+
+      /**
+      * Get the number of systems (set by the -s command line option).
+      */
+      int nSystem() const;
+
+      /**
+      * Get the index of this system, 0 <= systemId() < nSystem().
+      */
+      int systemId() const;
+
+      #ifdef UTIL_MPI
+      /**
+      * Get communicator for corresponding processors of all systems.
+      *
+      * This communicator contains the processors of all systems that
+      * have the same rank as this processor within their own system,
+      * ordered by systemId. It thus links the master processors of all
+      * systems, e.g., for replica exchange. If there is only one system,
+      * it contains only this processor.
+      */
+      MPI::Intracomm& replicaCommunicator();
+      #endif
+
       /**
       * Get the Exchanger by reference.
       */
       Exchanger& exchanger();
 
+      /**
+      * Get the per-atom energy and virial accumulator by reference.
+      */
+      AtomStress& atomStress();
+
       /**
       * Get the Buffer by reference.
       */
       Buffer& buffer();
 
+      /**
+      * Get the timer for startup phases (see StartupTimeId).
+      */
+      DdTimer& startupTimer();
+
       #ifdef DDMD_MODIFIERS
       /**
       * Return the ModifierManager by reference.
@@ -749,6 +916,13 @@ namespace DdMd
       bool hasExternal();
       #endif
 
+      #ifdef SIMP_COULOMB
+      /**
+      * Does this simulation have a Coulomb potential?
+      */
+      bool hasCoulomb() const;
+      #endif
+
       /**
       * Return the value of the mask policy (MaskNone or MaskBonded).
       */
@@ -783,6 +957,17 @@ namespace DdMd
       */
       Signal<>& exchangeSignal();
 
+      /**
+      * Version number of the atomic configuration and potential.
+      *
+      * Incremented by every notification of modifySignal() or
+      * positionSignal(), and thus equal on all processors. A quantity
+      * that is not stored as a Setable value may be cached along
+      * with the version for which it was computed, and is valid as
+      * long as the version is unchanged.
+      */
+      long configVersion() const;
+
       //@}
 
       /**
@@ -820,6 +1005,15 @@ namespace DdMd
       */
       void readPotentialStyles(std::istream& in);
 
+      #ifdef SIMP_COULOMB
+      /**
+      * Create a new CoulombPotential of the specified style.
+      *
+      * \param style coulombStyle string ("Ewald" or "SPME")
+      */
+      CoulombPotential* newCoulombPotential(const std::string& style);
+      #endif
+
       /**
       * Load potential styles.
       *
@@ -890,9 +1084,19 @@ namespace DdMd
       /// Exchanges atoms and ghosts for domain decomposition algorithm.
       Exchanger exchanger_;
 
+      /// Per-atom energies and virials, for local stress analysis.
+      AtomStress atomStress_;
+
       /// Random number generator.
       Random random_;
 
+      /// Thread pool shared by all threaded code.
+      Simp::ThreadPool threadPool_;
+
+      /// Timer for startup phases, indexed by StartupTimeId.
+      DdTimer startupTimer_;
+
+
       /// Maximum boundary (used to allocate memory for the cell list).
       Boundary maxBoundary_;
 
@@ -925,6 +1129,11 @@ namespace DdMd
       ExternalPotential* externalPotentialPtr_;
       #endif
 
+      #ifdef SIMP_COULOMB
+      /// Pointer to Coulomb potential.
+      CoulombPotential* coulombPotentialPtr_;
+      #endif
+
       /// Pointer to MD integrator.
       Integrator* integratorPtr_;
 
@@ -943,6 +1152,9 @@ namespace DdMd
       /// Pointer to a configuration reader/writer for restart.
       SerializeConfigIo* serializeConfigIoPtr_;
 
+      /// Pointer to a distributed (one file per rank) reader/writer.
+      DistributedConfigIo* distributedConfigIoPtr_;
+
       #ifdef DDMD_MODIFIERS
       /// ModifierManager
       ModifierManager* modifierManagerPtr_;
@@ -1003,6 +1215,11 @@ namespace DdMd
       std::string externalStyle_;
       #endif
 
+      #ifdef SIMP_COULOMB
+      /// Name of Coulomb potential style.
+      std::string coulombStyle_;
+      #endif
+
       /// Number of distinct atom types.
       int nAtomType_;
 
@@ -1026,6 +1243,11 @@ namespace DdMd
       bool hasExternal_;
       #endif
 
+      #ifdef SIMP_COULOMB
+      /// Does this simulation have a Coulomb potential?
+      bool hasCoulomb_;
+      #endif
+
       /// Does this simulation keep track of AtomContext info?
       bool hasAtomContext_;
 
@@ -1042,11 +1264,32 @@ namespace DdMd
       /// Is reverse communication enabled?
       bool reverseUpdateFlag_;
 
+      /// Are nonbonded ghosts imported only from upper neighbors?
+      bool halfShell_;
+
+      /// Is the restart configuration written as one file per processor?
+      bool distributedRestart_;
+
+      /// Are ghost updates sent in compact (single precision) form?
+      bool compactUpdate_;
+
+      /// Are atomic velocities stored and communicated?
+      bool hasVelocity_;
+
       #ifdef UTIL_MPI
       /// Communicator for this system.
       MPI::Intracomm communicator_;
+
+      /// Communicator for processors of equal rank in all systems.
+      MPI::Intracomm replicaCommunicator_;
       #endif
 
+      /// Number of systems.
+      int nSystem_;
+
+      /// Index of this system.
+      int systemId_;
+
       /// Signal to force clearing of all computed quantities.
       Signal<>  modifySignal_;
 
@@ -1059,6 +1302,12 @@ namespace DdMd
       /// Signal to indicate exchange of atoms ownership.
       Signal<>  exchangeSignal_;
 
+      /// Version number of configuration, incremented by signals.
+      long configVersion_;
+
+      /// Value of configVersion_ for which pair energies were computed.
+      long pairEnergiesVersion_;
+
       /// Log output file (if not standard out)
       std::ofstream logFile_;
 
@@ -1068,14 +1317,69 @@ namespace DdMd
       /// Is this Simulation in the process of restarting?
       bool isRestarting_;
 
+      /// Depth of LOOP blocks of the command script being executed.
+      int loopDepth_;
+
       /// Return the current ConfigIo (create if necessary)
       ConfigIo& configIo();
 
       /// Return a SerializeConfigIo (create if necessary)
       SerializeConfigIo& serializeConfigIo();
 
+      /// Return a DistributedConfigIo (create if necessary)
+      DistributedConfigIo& distributedConfigIo();
+
       void setGroup(std::stringstream& inBuffer);
 
+      /**
+      * Read the next command line on the io processor, and broadcast it.
+      *
+      * \param in   command file (used only on io processor)
+      * \param line next command line (output, on all processors)
+      */
+      void getCommandLine(std::istream& in, std::string& line);
+
+      /**
+      * Read the body of a LOOP block and execute it for each value.
+      *
+      * \param in     command file (used only on io processor)
+      * \param header rest of the LOOP command line
+      */
+      void readLoop(std::istream& in, std::istream& header);
+
+      /**
+      * Time pair force methods and block sizes, and keep the fastest.
+      *
+      * Runs nStep steps with each candidate algorithm, and sets the
+      * pair potential method and block size with the smallest maximum
+      * wall time over processors. Call on all processors.
+      *
+      * \param nStep number of steps per candidate
+      */
+      void autotunePair(int nStep);
+
+      /**
+      * Output a table of startup phase times.
+      *
+      * Call only on the master, after startupTimer().reduce() has been
+      * called on all processors.
+      *
+      * \param out output stream
+      */
+      void outputStartupStatistics(std::ostream& out);
+
+      /// Return kinetic energy of local atoms on this processor.
+      double localKineticEnergy();
+
+      /// Compute kinetic stress of local atoms on this processor.
+      void computeLocalKineticStress(Tensor& stress);
+
+      /// Increment configVersion_ (observer of modify and position signals).
+      void incrementConfigVersion();
+
+      /// Add observers to all signals (called once after initialization).
+      void addSignalObservers();
+
    // friends:
 
       friend class SimulationAccess;
@@ -1111,9 +1415,15 @@ namespace DdMd
    inline Exchanger& Simulation::exchanger()
    { return exchanger_; }
 
+   inline AtomStress& Simulation::atomStress()
+   { return atomStress_; }
+
    inline Buffer& Simulation::buffer()
    { return buffer_; }
 
+   inline DdTimer& Simulation::startupTimer()
+   { return startupTimer_; }
+
    inline const PairPotential& Simulation::pairPotential() const
    {
       assert(pairPotentialPtr_);
@@ -1182,6 +1492,20 @@ namespace DdMd
    }
    #endif
 
+   #ifdef SIMP_COULOMB
+   inline CoulombPotential& Simulation::coulombPotential()
+   {
+      assert(coulombPotentialPtr_);
+      return *coulombPotentialPtr_;
+   }
+
+   inline const CoulombPotential& Simulation::coulombPotential() const
+   {
+      assert(coulombPotentialPtr_);
+      return *coulombPotentialPtr_;
+   }
+   #endif
+
    /// Get the MD integrator by reference.
    inline Integrator& Simulation::integrator()
    {
@@ -1193,6 +1517,24 @@ namespace DdMd
    inline Random& Simulation::random()
    { return random_; }
 
+   /// Get the ThreadPool by reference.
+   inline Simp::ThreadPool& Simulation::threadPool()
+   { return threadPool_; }
+
+   /// Get the number of systems.
+   inline int Simulation::nSystem() const
+   { return nSystem_; }
+
+   /// Get the index of this system.
+   inline int Simulation::systemId() const
+   { return systemId_; }
+
+   #ifdef UTIL_MPI
+   /// Get the communicator for corresponding processors of all systems.
+   inline MPI::Intracomm& Simulation::replicaCommunicator()
+   { return replicaCommunicator_; }
+   #endif
+
    /// Get the EnergyEnsemble by reference.
    inline EnergyEnsemble& Simulation::energyEnsemble()
    {
@@ -1258,6 +1600,12 @@ namespace DdMd
    {  return hasExternal_; }
    #endif
 
+   #ifdef SIMP_COULOMB
+   /// Does this simulation have a Coulomb potential?
+   inline bool Simulation::hasCoulomb() const
+   {  return hasCoulomb_; }
+   #endif
+
    /// Get an AtomType descriptor for a specific type by reference.
    inline AtomType& Simulation::atomType(int i)
    {  return atomTypes_[i]; }
@@ -1288,5 +1636,9 @@ namespace DdMd
    inline Signal<>& Simulation::exchangeSignal()
    { return exchangeSignal_; }
 
+   /// Version number of configuration.
+   inline long Simulation::configVersion() const
+   { return configVersion_; }
+
 }
 #endif
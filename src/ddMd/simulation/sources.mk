@@ -1,5 +1,6 @@
 ddMd_simulation_= \
      ddMd/simulation/Simulation.cpp \
+     ddMd/simulation/EnsembleScheduler.cpp \
      ddMd/simulation/SimulationAccess.cpp 
 
 ddMd_simulation_SRCS=\
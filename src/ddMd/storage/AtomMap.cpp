@@ -22,9 +22,15 @@ namespace DdMd
    */
    AtomMap::AtomMap()
     : atomPtrs_(),
+      hashIds_(),
+      hashPtrs_(),
       nLocal_(0),
       nGhostDistinct_(0),
       totalAtomCapacity_(0),
+      nHashed_(0),
+      hashMask_(0),
+      hashShift_(0),
+      isHashed_(false),
       isInitialized_(false)
    {}
  
@@ -37,20 +43,133 @@ namespace DdMd
    /*
    * Allocate and initialize all containers (private).
    */
-   void AtomMap::allocate(int totalAtomCapacity)
+   void AtomMap::allocate(int totalAtomCapacity, int hashCapacity)
    {
       // Precondition
       if (isInitialized_) {
          UTIL_THROW("AtomMap can only be initialized once");
       }
-      atomPtrs_.allocate(totalAtomCapacity);
       totalAtomCapacity_ = totalAtomCapacity;
-      for (int i = 0; i < totalAtomCapacity_; ++i) {
-         atomPtrs_[i] = 0;
+      int i;
+      if (hashCapacity > 0) {
+
+         // Number of slots is the smallest power of 2 >= 2*hashCapacity
+         int nBit = 1;
+         while ((1 << nBit) < 2*hashCapacity) {
+            ++nBit;
+            if (nBit > 30) {
+               UTIL_THROW("AtomMap hashCapacity is too large");
+            }
+         }
+         int nSlot = 1 << nBit;
+         hashIds_.allocate(nSlot);
+         hashPtrs_.allocate(nSlot);
+         for (i = 0; i < nSlot; ++i) {
+            hashIds_[i] = -1;
+            hashPtrs_[i] = 0;
+         }
+         hashMask_ = uint32_t(nSlot - 1);
+         hashShift_ = 32 - nBit;
+         nHashed_ = 0;
+         isHashed_ = true;
+
+      } else {
+
+         atomPtrs_.allocate(totalAtomCapacity);
+         for (i = 0; i < totalAtomCapacity_; ++i) {
+            atomPtrs_[i] = 0;
+         }
+         isHashed_ = false;
+
       }
       isInitialized_ = true;
    }
 
+   /*
+   * Return number of bytes allocated (node sizes are estimates).
+   */
+   double AtomMap::memoryBytes() const
+   {
+      double bytes = atomPtrs_.capacity()*sizeof(Atom*)
+                   + hashIds_.capacity()*sizeof(int)
+                   + hashPtrs_.capacity()*sizeof(Atom*);
+      double nodeBytes = sizeof(GhostMap::value_type) + 4*sizeof(void*);
+      bytes += ghostMap_.size()*nodeBytes;
+      return bytes;
+   }
+
+   /*
+   * Free memory of an empty map.
+   */
+   void AtomMap::deallocate()
+   {
+      if (nLocal_ != 0 || ghostMap_.size() != 0 || nGhostDistinct_ != 0) {
+         UTIL_THROW("Cannot deallocate an AtomMap that contains atoms");
+      }
+      if (atomPtrs_.isAllocated()) {
+         atomPtrs_.deallocate();
+      }
+      if (hashIds_.isAllocated()) {
+         hashIds_.deallocate();
+         hashPtrs_.deallocate();
+      }
+      nHashed_ = 0;
+      isHashed_ = false;
+      isInitialized_ = false;
+   }
+
+   /*
+   * Set or remove the primary pointer for an atom id (private).
+   */
+   void AtomMap::setPrimary(int atomId, Atom* ptr)
+   {
+      if (!isHashed_) {
+         atomPtrs_[atomId] = ptr;
+         return;
+      }
+
+      // Find slot with key atomId, or the empty slot ending its probe
+      uint32_t i = hash(atomId);
+      while (hashIds_[i] >= 0 && hashIds_[i] != atomId) {
+         i = (i + 1) & hashMask_;
+      }
+
+      if (ptr) {
+         if (hashIds_[i] < 0) {
+            if (nHashed_ >= int(hashMask_)) {
+               UTIL_THROW("AtomMap hash table is full");
+            }
+            hashIds_[i] = atomId;
+            ++nHashed_;
+         }
+         hashPtrs_[i] = ptr;
+      } else 
+      if (hashIds_[i] == atomId) {
+
+         // Backward shift deletion: Move later entries of the probe
+         // sequence into the hole, so no tombstones are needed.
+         uint32_t j = i;
+         uint32_t k;
+         for (;;) {
+            j = (j + 1) & hashMask_;
+            if (hashIds_[j] < 0) break;
+            k = hash(hashIds_[j]);
+            // Entry j stays if its home slot k lies cyclically in (i, j]
+            if (i <= j) {
+               if (i < k && k <= j) continue;
+            } else {
+               if (i < k || k <= j) continue;
+            }
+            hashIds_[i] = hashIds_[j];
+            hashPtrs_[i] = hashPtrs_[j];
+            i = j;
+         }
+         hashIds_[i] = -1;
+         hashPtrs_[i] = 0;
+         --nHashed_;
+      }
+   }
+
    /*
    * Register new local Atom in internal data structures.
    */ 
@@ -63,17 +182,18 @@ namespace DdMd
          Log::file() << "atomId = " << atomId << std::endl;
          UTIL_THROW("atomId is out of range");
       }
-      if (atomPtrs_[atomId]) {
+      Atom* oldPtr = find(atomId);
+      if (oldPtr) {
          Log::file() << "atomId       = " << atomId << std::endl;
          Log::file() << "New Position = " << ptr->position() 
                    << std::endl;
-         Log::file() << "Old Position = " << atomPtrs_[atomId]->position() 
+         Log::file() << "Old Position = " << oldPtr->position() 
                    << std::endl;
          UTIL_THROW("Local atom with specified id is already present");
       }
 
       // Add 
-      atomPtrs_[atomId] = ptr;
+      setPrimary(atomId, ptr);
       ++nLocal_;
    }
 
@@ -87,24 +207,25 @@ namespace DdMd
          Log::file() << "atomId = " << atomId << std::endl;
          UTIL_THROW("atomId is out of range");
       }
-      if (ptr == atomPtrs_[atomId]) {
+      Atom* oldPtr = find(atomId);
+      if (ptr == oldPtr) {
 
-         // Remove from atomPtrs_
-         atomPtrs_[atomId] = 0;
+         // Remove from primary map
+         setPrimary(atomId, 0);
          --nLocal_;
 
-         // If possible, move an atom from ghostMap to atomPtrs_
+         // If possible, move an atom from ghostMap to primary map
          if (!ghostMap_.empty()) {
             GhostMap::iterator iter = ghostMap_.find(atomId);
             if (iter != ghostMap_.end()) {
-               atomPtrs_[atomId] = iter->second;
+               setPrimary(atomId, iter->second);
                ++nGhostDistinct_;
                ghostMap_.erase(iter);
             }
          }
 
       } else {
-         if (0 == atomPtrs_[atomId]) {
+         if (0 == oldPtr) {
             UTIL_THROW("Error: Attempt to remove absent local atom");
          } else {
             UTIL_THROW("Error: Inconsistent pointer");
@@ -124,8 +245,8 @@ namespace DdMd
          UTIL_THROW("atomId is out of range");
       }
 
-      if (0 == atomPtrs_[atomId]) {
-         atomPtrs_[atomId] = ptr;
+      if (0 == find(atomId)) {
+         setPrimary(atomId, ptr);
          ++nGhostDistinct_;
       } else {
          ghostMap_.insert(std::pair<int, Atom*>(atomId, ptr));
@@ -143,25 +264,26 @@ namespace DdMd
          UTIL_THROW("atomId is out of range");
       }
 
-      if (atomPtrs_[atomId] == ptr) {
+      Atom* oldPtr = find(atomId);
+      if (oldPtr == ptr) {
 
-         // Remove from atomPtrs array
-         atomPtrs_[atomId] = 0;
+         // Remove from primary map
+         setPrimary(atomId, 0);
          --nGhostDistinct_;
 
-         // If possible, move an atom from ghostMap to atomPtrs_
+         // If possible, move an atom from ghostMap to primary map
          if (!ghostMap_.empty()) {
             GhostMap::iterator iter = ghostMap_.find(atomId);
             if (iter != ghostMap_.end()) {
-               atomPtrs_[atomId] = iter->second;
+               setPrimary(atomId, iter->second);
                ++nGhostDistinct_;
                ghostMap_.erase(iter);
             }
          }
 
-      } else { // If ptr is not found in atomPtrs
+      } else { // If ptr is not found in primary map
 
-         if (atomPtrs_[atomId] != 0) { 
+         if (oldPtr != 0) { 
             // Search ghost map
             std::pair<GhostMap::iterator, GhostMap::iterator> ret;
             ret = ghostMap_.equal_range(atomId);
@@ -192,15 +314,15 @@ namespace DdMd
       // Clear extra ghost images from ghostMap_
       ghostMap_.clear();
 
-      // Clear ghosts from atomPtrs_ array
+      // Clear ghosts from primary map
       ConstGhostIterator iter;
       const Atom* ptr;
       int id;
       for (ghostSet.begin(iter); iter.notEnd(); ++iter) {
          id = iter->id();
          ptr = iter.get();
-         if (atomPtrs_[id] == ptr) {
-            atomPtrs_[id] = 0;
+         if (find(id) == ptr) {
+            setPrimary(id, 0);
             --nGhostDistinct_;
          }
       }
@@ -217,23 +339,44 @@ namespace DdMd
       Atom* ptr;
       int i, id, nAtom;
 
-      // Validate atomPtrs_
+      // Validate primary map
       nAtom = 0;
-      for (i = 0; i < totalAtomCapacity_ ; ++i) {
-         ptr = atomPtrs_[i];
-         if (ptr != 0) {
-            id = ptr->id();
-            if (id != i) {
-               Log::file() << std::endl;
-               Log::file() << "Index i in atomPtrs_  " << i << std::endl;
-               Log::file() << "atomPtrs_[i]->id()    " << id << std::endl;
-               UTIL_THROW("ptr->id() != i");
+      if (isHashed_) {
+         for (i = 0; i < hashIds_.capacity(); ++i) {
+            id = hashIds_[i];
+            if (id >= 0) {
+               ptr = hashPtrs_[i];
+               if (ptr == 0 || ptr->id() != id) {
+                  Log::file() << std::endl;
+                  Log::file() << "Hash table key " << id << std::endl;
+                  UTIL_THROW("Inconsistent key in hash table");
+               }
+               if (find(id) != ptr) {
+                  UTIL_THROW("Hash table entry is not found by probing");
+               }
+               ++nAtom;
+            }
+         }
+         if (nAtom != nHashed_) {
+            UTIL_THROW("Inconsistent count of hash table entries");
+         }
+      } else {
+         for (i = 0; i < totalAtomCapacity_ ; ++i) {
+            ptr = atomPtrs_[i];
+            if (ptr != 0) {
+               id = ptr->id();
+               if (id != i) {
+                  Log::file() << std::endl;
+                  Log::file() << "Index i in atomPtrs_  " << i << std::endl;
+                  Log::file() << "atomPtrs_[i]->id()    " << id << std::endl;
+                  UTIL_THROW("ptr->id() != i");
+               }
+               ++nAtom;
             }
-            ++nAtom;
          }
       }
       if (nAtom != nLocal_ + nGhostDistinct_) {
-         UTIL_THROW("Inconsistent count of atoms in atomPtrs");
+         UTIL_THROW("Inconsistent count of atoms in primary map");
       }
 
       // Validate ghostMap_
@@ -247,8 +390,8 @@ namespace DdMd
             Log::file() << "Atom::id()   " << ptr->id() << std::endl;
             UTIL_THROW("Inconsistent key in ghostMap");
          }
-         if (atomPtrs_[id] == 0) {
-            UTIL_THROW("Id in ghostMap_ does not appear in atomPtrs_");
+         if (find(id) == 0) {
+            UTIL_THROW("Id in ghostMap_ does not appear in primary map");
          } 
       }
       return true;
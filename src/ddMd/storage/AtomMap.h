@@ -13,6 +13,8 @@
 #include <ddMd/chemistry/Group.h>    // member function template
 #include <util/global.h>
 
+#include <stdint.h>
+
 #ifdef UTIL_CXX11
 #include <unordered_map>
 #else
@@ -31,6 +33,15 @@ namespace DdMd
    /**
    * Associative container for finding atoms identified by integer id.
    *
+   * One image of each atom id present on this processor is stored in a
+   * primary map, and any extra ghost images of the same id are stored 
+   * in a separate multimap. The primary map is either a direct array
+   * of pointers indexed by atom id, which requires memory proportional
+   * to the total number of atoms in the system on every processor, or
+   * an open-addressing hash table with linear probing, which requires
+   * memory proportional to the number of local and ghost atoms on this
+   * processor. The choice is made by the allocate() function.
+   *
    * \ingroup DdMd_Storage_Atom_Module
    */
    class AtomMap 
@@ -53,9 +64,23 @@ namespace DdMd
       *
       * Call this or (read|load)Parameters to initialize, but not both.
       *
+      * If hashCapacity > 0, the primary map is a hash table with room
+      * for at least 2*hashCapacity atoms, so hashCapacity must be at 
+      * least the maximum number of distinct atom ids on this processor.
+      * If hashCapacity == 0, the primary map is a direct array with 
+      * totalAtomCapacity elements.
+      *
       * \param totalAtomCapacity max number of atoms on all processors.
+      * \param hashCapacity max number of local and ghost atoms, or 0.
       */
-      void allocate(int totalAtomCapacity);
+      void allocate(int totalAtomCapacity, int hashCapacity = 0);
+
+      /**
+      * Free memory of an empty map, after which allocate() may be called.
+      *
+      * \throw Exception if any local or ghost atoms are present.
+      */
+      void deallocate();
 
       /**
       * Add local atom.
@@ -111,6 +136,11 @@ namespace DdMd
       */
       Atom* find(int atomId) const;  
 
+      /**
+      * Is the primary map a hash table (rather than a direct array)?
+      */ 
+      bool isHashed() const;
+
       /**
       * Return the number of local atoms.
       */ 
@@ -126,6 +156,11 @@ namespace DdMd
       */ 
       int nGhost() const;
 
+      /**
+      * Return number of bytes allocated, including ghost image map nodes.
+      */
+      double memoryBytes() const;
+
       /**
       * Set handles to local atoms in a Group<N> object.
       *
@@ -182,10 +217,16 @@ namespace DdMd
       typedef std::multimap<int, Atom*> GhostMap;
       #endif
 
-      // Array of pointers to atoms, indexed by Id.
+      // Array of pointers to atoms, indexed by Id (if not hashed).
       // Elements corresponding to absent atoms hold null pointers.
       DArray<Atom*> atomPtrs_;
 
+      // Atom ids in hash table slots, or -1 for empty slots (if hashed).
+      DArray<int> hashIds_;
+
+      // Atom pointers in hash table slots (if hashed).
+      DArray<Atom*> hashPtrs_;
+
       // Map for extra ghost images
       GhostMap ghostMap_;
 
@@ -198,24 +239,47 @@ namespace DdMd
       // Maximum number of atoms on all processors, maximum id + 1
       int totalAtomCapacity_;
 
+      // Number of occupied hash table slots.
+      int nHashed_;
+
+      // Number of hash table slots minus 1 (number of slots is 2^n).
+      uint32_t hashMask_;
+
+      // Right shift applied to the product in hash(), 32 - n.
+      int hashShift_;
+
+      // Is the primary map a hash table?
+      bool isHashed_;
+
       // Has this map been initialized (i.e., allocated)?
       bool isInitialized_;
 
+      /*
+      * Return the home hash table slot for an atom id.
+      */
+      uint32_t hash(int atomId) const;
+
+      /*
+      * Set the primary pointer for an id, or remove it if ptr == 0.
+      */
+      void setPrimary(int atomId, Atom* ptr);
+
       /*
       *  Design / invariants:
       *
-      *  - If a local atom with id i is present, atomPtrs_[i]
-      *    contains a pointer to that atom.
+      *  - If a local atom with id i is present, the primary map
+      *    (atomPtrs_[i], or the hash slot with key i) contains a 
+      *    pointer to that atom.
       *
       *  - If one or more ghosts with an atom id i are present,
-      *    but there is no local atom with that id, atomPtrs_[i]
+      *    but there is no local atom with that id, the primary map
       *    contains a pointer to one such ghost.
       *
       *  - ghostMap_ contains pointers to all ghosts except those
-      *    in atomPtrs_, stored using atom indices as keys. 
+      *    in the primary map, stored using atom indices as keys. 
       *
       * One image of each physical atom, identified by id, is thus 
-      * stored * in atomPtrs_, while ghostMap_ holds any "extra"
+      * stored in the primary map, while ghostMap_ holds any "extra"
       * ghost images of atoms. If this processor does not contain
       * multiple images of any particle, ghostMap_ will be empty.
       */
@@ -228,7 +292,30 @@ namespace DdMd
    * Return pointer to an Atom with specified id.
    */
    inline Atom* AtomMap::find(int atomId) const
-   {  return atomPtrs_[atomId]; }
+   {
+      if (!isHashed_) {
+         return atomPtrs_[atomId];
+      }
+      uint32_t i = hash(atomId);
+      int id;
+      while ((id = hashIds_[i]) != atomId) {
+         if (id < 0) return 0;
+         i = (i + 1) & hashMask_;
+      }
+      return hashPtrs_[i];
+   }
+
+   /*
+   * Fibonacci hash of an atom id, giving the home slot.
+   */
+   inline uint32_t AtomMap::hash(int atomId) const
+   {  return (uint32_t(atomId)*2654435769u) >> hashShift_; }
+
+   /*
+   * Is the primary map a hash table?
+   */ 
+   inline bool AtomMap::isHashed() const
+   {  return isHashed_; }
 
    /*
    * Return the number of local atoms.
@@ -259,7 +346,7 @@ namespace DdMd
       Atom* ptr;
       int nAtom = 0;
       for (int i = 0; i < N; ++i) {
-         ptr = atomPtrs_[group.atomId(i)];
+         ptr = find(group.atomId(i));
          if (ptr) {
             assert(!ptr->isGhost());
             assert(ptr->id() == group.atomId(i));
@@ -286,7 +373,7 @@ namespace DdMd
             ++nAtom;
          } else {
             int atomId = group.atomId(i);
-            ptr = atomPtrs_[atomId];
+            ptr = find(atomId);
             if (ptr) {
                assert(ptr->isGhost());
                assert(ptr->id() == atomId);
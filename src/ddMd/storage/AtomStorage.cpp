@@ -11,15 +11,41 @@
 #include "GhostIterator.h"
 #include "ConstGhostIterator.h"
 #include <ddMd/chemistry/Group.h>
+#include <ddMd/misc/MemoryReport.h>
 #include <util/format/Int.h>
 #include <util/mpi/MpiLoader.h>
 #include <util/global.h>
 
+#include <algorithm>
+#include <new>
+
+#ifdef DDMD_OPENMP
+#include <omp.h>
+#endif
+
 namespace DdMd
 {
 
    using namespace Util;
 
+   namespace {
+
+      /*
+      * Spread the lowest 10 bits of x so that there are two zero bits 
+      * between each pair of consecutive bits (used for Morton keys).
+      */
+      inline unsigned int spreadBits(unsigned int x)
+      {
+         x &= 0x000003ff;
+         x = (x | (x << 16)) & 0x030000ff;
+         x = (x | (x <<  8)) & 0x0300f00f;
+         x = (x | (x <<  4)) & 0x030c30c3;
+         x = (x | (x <<  2)) & 0x09249249;
+         return x;
+      }
+
+   }
+
    /*
    * Default constructor.
    */
@@ -36,6 +62,11 @@ namespace DdMd
       atomCapacity_(0),
       ghostCapacity_(0),
       totalAtomCapacity_(0),
+      sortInterval_(0),
+      hashMap_(false),
+      growThreshold_(0.0),
+      growFactor_(1.5),
+      fixedPointForces_(false),
       maxNAtomLocal_(0),
       maxNGhostLocal_(0),
       #ifdef UTIL_MPI
@@ -46,6 +77,11 @@ namespace DdMd
       locked_(false),
       isInitialized_(false),
       isCartesian_(false)
+      #ifdef DDMD_OPENMP
+      , threadForces_(),
+      fixedForces_(),
+      nThread_(0)
+      #endif
    {  setClassName("AtomStorage"); }
  
    /*
@@ -68,11 +104,12 @@ namespace DdMd
    * Set parameters and allocate memory.
    */
    void AtomStorage::initialize(int atomCapacity, int ghostCapacity, 
-      int totalAtomCapacity)
+      int totalAtomCapacity, bool hashMap)
    {
       atomCapacity_ = atomCapacity;
       ghostCapacity_ = ghostCapacity;
       totalAtomCapacity_ = totalAtomCapacity;
+      hashMap_ = hashMap;
       allocate();
    }
 
@@ -84,6 +121,22 @@ namespace DdMd
       read<int>(in, "atomCapacity", atomCapacity_);
       read<int>(in, "ghostCapacity", ghostCapacity_);
       read<int>(in, "totalAtomCapacity", totalAtomCapacity_);
+      sortInterval_ = 0;
+      readOptional<int>(in, "sortInterval", sortInterval_);
+      hashMap_ = false;
+      readOptional<bool>(in, "hashMap", hashMap_);
+      growThreshold_ = 0.0;
+      readOptional<double>(in, "growThreshold", growThreshold_);
+      growFactor_ = 1.5;
+      readOptional<double>(in, "growFactor", growFactor_);
+      fixedPointForces_ = false;
+      readOptional<bool>(in, "fixedPointForces", fixedPointForces_);
+      if (growThreshold_ < 0.0 || growThreshold_ > 1.0) {
+         UTIL_THROW("growThreshold must lie in range [0, 1]");
+      }
+      if (growFactor_ <= 1.0) {
+         UTIL_THROW("growFactor must be greater than 1");
+      }
       allocate();
    }
 
@@ -95,6 +148,16 @@ namespace DdMd
       loadParameter<int>(ar, "atomCapacity", atomCapacity_);
       loadParameter<int>(ar, "ghostCapacity", ghostCapacity_);
       loadParameter<int>(ar, "totalAtomCapacity", totalAtomCapacity_);
+      sortInterval_ = 0;
+      loadParameter<int>(ar, "sortInterval", sortInterval_, false);
+      hashMap_ = false;
+      loadParameter<bool>(ar, "hashMap", hashMap_, false);
+      growThreshold_ = 0.0;
+      loadParameter<double>(ar, "growThreshold", growThreshold_, false);
+      growFactor_ = 1.5;
+      loadParameter<double>(ar, "growFactor", growFactor_, false);
+      fixedPointForces_ = false;
+      loadParameter<bool>(ar, "fixedPointForces", fixedPointForces_, false);
       MpiLoader<Serializable::IArchive> loader(*this, ar);
       loader.load(maxNAtomLocal_);
       loader.load(maxNGhostLocal_);
@@ -109,6 +172,11 @@ namespace DdMd
       ar << atomCapacity_;
       ar << ghostCapacity_;
       ar << totalAtomCapacity_;
+      Parameter::saveOptional(ar, sortInterval_, (bool)sortInterval_);
+      Parameter::saveOptional(ar, hashMap_, hashMap_);
+      Parameter::saveOptional(ar, growThreshold_, (growThreshold_ > 0.0));
+      Parameter::saveOptional(ar, growFactor_, (growThreshold_ > 0.0));
+      Parameter::saveOptional(ar, fixedPointForces_, fixedPointForces_);
       ar << maxNAtomLocal_;
       ar << maxNGhostLocal_;
    }
@@ -138,9 +206,22 @@ namespace DdMd
           ghostReservoir_.push(ghosts_[i]);
       }
 
-      map_.allocate(totalAtomCapacity_);
+      if (hashMap_) {
+         map_.allocate(totalAtomCapacity_, atomCapacity_ + ghostCapacity_);
+      } else {
+         map_.allocate(totalAtomCapacity_);
+      }
       snapshot_.allocate(atomCapacity_);
 
+      if (sortInterval_ > 0) {
+         sortAtoms_.allocate(atomCapacity_);
+         sortKeys_.allocate(atomCapacity_);
+      }
+
+      #ifdef DDMD_GROUP_INDEX
+      Atom::setArrays(&atoms_[0], &ghosts_[0]);
+      #endif
+
       isInitialized_ = true;
    }
 
@@ -179,6 +260,96 @@ namespace DdMd
 
    }
 
+   #ifdef DDMD_OPENMP
+   /*
+   * Scale of fixed point forces: resolution 2.3e-10, range 2.1e+9.
+   */
+   const double AtomStorage::FixedPointScale = 4294967296.0;
+
+   /*
+   * Allocate per-thread or fixed point force accumulators, if necessary.
+   */
+   void AtomStorage::beginThreadForces()
+   {
+      if (fixedPointForces_) {
+         if (!fixedForces_.isAllocated()) {
+            int n = Dimension*(atomCapacity_ + ghostCapacity_);
+            fixedForces_.allocate(n);
+            for (int i = 0; i < n; ++i) {
+               fixedForces_[i] = 0;
+            }
+         }
+         return;
+      }
+      if (!threadForces_.isAllocated()) {
+         nThread_ = omp_get_max_threads();
+         int n = nThread_*(atomCapacity_ + ghostCapacity_);
+         threadForces_.allocate(n);
+         for (int i = 0; i < n; ++i) {
+            threadForces_[i].zero();
+         }
+      } else 
+      if (omp_get_max_threads() > nThread_) {
+         UTIL_THROW("Number of threads increased after first threaded loop");
+      }
+   }
+
+   /*
+   * Reduce per-thread forces onto atoms and re-zero accumulators.
+   *
+   * Only the accumulators of atoms in the local and ghost sets can be
+   * nonzero, so the loop runs over nAtom (+ nGhost) atoms rather than
+   * over the full capacity of both arrays.
+   */
+   void AtomStorage::endThreadForces(bool includeGhosts)
+   {
+      const int size = atomCapacity_ + ghostCapacity_;
+      const int nLocal = atomSet_.size();
+      const int n = includeGhosts ? nLocal + ghostSet_.size() : nLocal;
+      Atom* atomPtr;
+      int i, j, t;
+
+      if (fixedPointForces_) {
+         const double scale = 1.0/FixedPointScale;
+         int64_t* g;
+         #pragma omp parallel for private(atomPtr, i, g, t)
+         for (j = 0; j < n; ++j) {
+            if (j < nLocal) {
+               atomPtr = &atomSet_[j];
+               i = int(atomPtr - &atoms_[0]);
+            } else {
+               atomPtr = &ghostSet_[j - nLocal];
+               i = atomCapacity_ + int(atomPtr - &ghosts_[0]);
+            }
+            Vector& f = atomPtr->force();
+            g = &fixedForces_[Dimension*i];
+            for (t = 0; t < Dimension; ++t) {
+               f[t] += scale*double(g[t]);
+               g[t] = 0;
+            }
+         }
+         return;
+      }
+
+      #pragma omp parallel for private(atomPtr, i, t)
+      for (j = 0; j < n; ++j) {
+         if (j < nLocal) {
+            atomPtr = &atomSet_[j];
+            i = int(atomPtr - &atoms_[0]);
+         } else {
+            atomPtr = &ghostSet_[j - nLocal];
+            i = atomCapacity_ + int(atomPtr - &ghosts_[0]);
+         }
+         Vector& f = atomPtr->force();
+         for (t = 0; t < nThread_; ++t) {
+            Vector& g = threadForces_[t*size + i];
+            f += g;
+            g.zero();
+         }
+      }
+   }
+   #endif
+
    // Local atom mutators
 
    /*
@@ -270,6 +441,247 @@ namespace DdMd
       }
    }
 
+   /*
+   * Reorder local atoms along a Morton curve.
+   */
+   void AtomStorage::sortAtoms()
+   {
+      // Preconditions
+      if (locked_) {
+         UTIL_THROW("AtomStorage is locked");
+      }
+      if (newAtomPtr_ != 0) {
+         UTIL_THROW("Unregistered newAtomPtr_ still active");
+      }
+      if (nGhost() != 0) {
+         UTIL_THROW("Cannot sort atoms while ghosts exist");
+      }
+
+      const int n = atomSet_.size();
+      if (n == 0) return;
+
+      // Allocate work space on first use
+      if (!sortAtoms_.isAllocated()) {
+         sortAtoms_.allocate(atomCapacity_);
+         sortKeys_.allocate(atomCapacity_);
+      }
+
+      Atom* atomPtr;
+      int i, j;
+
+      // Find bounding box of local atom positions
+      Vector lower = atomSet_[0].position();
+      Vector upper = lower;
+      for (i = 1; i < n; ++i) {
+         const Vector& r = atomSet_[i].position();
+         for (j = 0; j < Dimension; ++j) {
+            if (r[j] < lower[j]) lower[j] = r[j];
+            if (r[j] > upper[j]) upper[j] = r[j];
+         }
+      }
+      Vector scale;
+      for (j = 0; j < Dimension; ++j) {
+         if (upper[j] > lower[j]) {
+            scale[j] = 1023.99/(upper[j] - lower[j]);
+         } else {
+            scale[j] = 0.0;
+         }
+      }
+
+      // Compute Morton key for each atom (10 bits per coordinate)
+      unsigned int key;
+      for (i = 0; i < n; ++i) {
+         atomPtr = &atomSet_[i];
+         const Vector& r = atomPtr->position();
+         key = 0;
+         for (j = 0; j < Dimension; ++j) {
+            key |= spreadBits((unsigned int)((r[j] - lower[j])*scale[j])) << j;
+         }
+         sortKeys_[i].first = key;
+         sortKeys_[i].second = atomPtr;
+      }
+      std::sort(&sortKeys_[0], &sortKeys_[0] + n);
+
+      // Copy atoms into work space in sorted order
+      for (i = 0; i < n; ++i) {
+         sortAtoms_[i] = *sortKeys_[i].second;
+      }
+
+      #ifdef DDMD_GROUP_INDEX
+      // Record new index of each atom, by old index
+      if (newIndices_.capacity() < atomCapacity_) {
+         if (newIndices_.isAllocated()) newIndices_.deallocate();
+         newIndices_.allocate(atomCapacity_);
+      }
+      for (i = 0; i < n; ++i) {
+         newIndices_[arrayIndex(*sortKeys_[i].second)] = i;
+      }
+      #endif
+
+      // Remove all local atoms and empty the reservoir
+      while (atomSet_.size() > 0) {
+         atomPtr = &atomSet_.pop();
+         map_.removeLocal(atomPtr);
+      }
+      while (atomReservoir_.size() > 0) {
+         atomReservoir_.pop();
+      }
+
+      // Copy sorted atoms back into elements [0, n-1] of atoms_
+      for (i = 0; i < n; ++i) {
+         atomPtr = &atoms_[i];
+         *atomPtr = sortAtoms_[i];
+         atomPtr->setIsGhost(false);
+         map_.addLocal(atomPtr);
+         atomSet_.append(*atomPtr);
+      }
+
+      // Refill reservoir, so that elements with low indices are popped first
+      for (i = atomCapacity_ - 1; i >= n; --i) {
+         atomReservoir_.push(atoms_[i]);
+      }
+   }
+
+   /*
+   * Destroy and default construct a container, so that it can be
+   * allocated again (Util containers can only be allocated once).
+   */
+   template <typename T>
+   static void resetContainer(T& container)
+   {
+      container.~T();
+      new (&container) T();
+   }
+
+   /*
+   * Increase capacities if usage exceeds the threshold.
+   */
+   bool AtomStorage::grow()
+   {
+      // Preconditions
+      if (locked_) {
+         UTIL_THROW("AtomStorage is locked");
+      }
+      if (newAtomPtr_ != 0) {
+         UTIL_THROW("Unregistered newAtomPtr_ still active");
+      }
+      if (nGhost() != 0) {
+         UTIL_THROW("Cannot grow storage while ghosts exist");
+      }
+      if (growThreshold_ <= 0.0) return false;
+
+      // Compute new capacities
+      int atomCapacity = atomCapacity_;
+      while (maxNAtomLocal_ > growThreshold_*atomCapacity) {
+         atomCapacity = int(growFactor_*atomCapacity) + 1;
+      }
+      int ghostCapacity = ghostCapacity_;
+      while (maxNGhostLocal_ > growThreshold_*ghostCapacity) {
+         ghostCapacity = int(growFactor_*ghostCapacity) + 1;
+      }
+      if (atomCapacity == atomCapacity_ && ghostCapacity == ghostCapacity_) {
+         return false;
+      }
+
+      const int n = atomSet_.size();
+      Atom* atomPtr;
+      int i;
+
+      // Copy local atoms into work space, then remove them
+      if (!sortAtoms_.isAllocated()) {
+         sortAtoms_.allocate(atomCapacity_);
+         sortKeys_.allocate(atomCapacity_);
+      }
+      for (i = 0; i < n; ++i) {
+         sortAtoms_[i] = atomSet_[i];
+      }
+      #ifdef DDMD_GROUP_INDEX
+      if (newIndices_.capacity() < atomCapacity_) {
+         if (newIndices_.isAllocated()) newIndices_.deallocate();
+         newIndices_.allocate(atomCapacity_);
+      }
+      for (i = 0; i < n; ++i) {
+         newIndices_[arrayIndex(atomSet_[i])] = i;
+      }
+      #endif
+      while (atomSet_.size() > 0) {
+         atomPtr = &atomSet_.pop();
+         map_.removeLocal(atomPtr);
+      }
+      while (atomReservoir_.size() > 0) {
+         atomReservoir_.pop();
+      }
+
+      // Reallocate local atom containers
+      if (atomCapacity > atomCapacity_) {
+         atoms_.deallocate();
+         atoms_.allocate(atomCapacity);
+         resetContainer(atomSet_);
+         atomSet_.allocate(atoms_);
+         resetContainer(atomReservoir_);
+         atomReservoir_.allocate(atomCapacity);
+         snapshot_.deallocate();
+         snapshot_.allocate(atomCapacity);
+         atomCapacity_ = atomCapacity;
+      }
+
+      // Reallocate ghost containers (all ghosts are in the reservoir)
+      if (ghostCapacity > ghostCapacity_) {
+         ghosts_.deallocate();
+         ghosts_.allocate(ghostCapacity);
+         resetContainer(ghostSet_);
+         ghostSet_.allocate(ghosts_);
+         resetContainer(ghostReservoir_);
+         ghostReservoir_.allocate(ghostCapacity);
+         for (i = ghostCapacity - 1; i >= 0; --i) {
+            ghostReservoir_.push(ghosts_[i]);
+         }
+         ghostCapacity_ = ghostCapacity;
+      }
+
+      // A hash table is sized for atomCapacity_ + ghostCapacity_
+      if (hashMap_) {
+         map_.deallocate();
+         map_.allocate(totalAtomCapacity_, atomCapacity_ + ghostCapacity_);
+      }
+
+      // Copy atoms back into elements [0, n-1] of atoms_
+      for (i = 0; i < n; ++i) {
+         atomPtr = &atoms_[i];
+         *atomPtr = sortAtoms_[i];
+         atomPtr->setIsGhost(false);
+         map_.addLocal(atomPtr);
+         atomSet_.append(*atomPtr);
+      }
+      for (i = atomCapacity_ - 1; i >= n; --i) {
+         atomReservoir_.push(atoms_[i]);
+      }
+
+      #ifdef DDMD_GROUP_INDEX
+      Atom::setArrays(&atoms_[0], &ghosts_[0]);
+      #endif
+
+      // Reallocate work space, or free it if not used for sorting
+      sortAtoms_.deallocate();
+      sortKeys_.deallocate();
+      if (sortInterval_ > 0) {
+         sortAtoms_.allocate(atomCapacity_);
+         sortKeys_.allocate(atomCapacity_);
+      }
+
+      #ifdef DDMD_OPENMP
+      // Per-thread forces are reallocated on next use
+      if (threadForces_.isAllocated()) {
+         threadForces_.deallocate();
+      }
+      if (fixedForces_.isAllocated()) {
+         fixedForces_.deallocate();
+      }
+      #endif
+
+      return true;
+   }
+
    // Ghost atom mutators
 
    /*
@@ -424,6 +836,36 @@ namespace DdMd
       return max;
    }
 
+   /*
+   * Return max. sq. non-affine displacement of local atoms since snapshot.
+   */
+   double AtomStorage::maxSqDisplacement(const Vector& scale)
+   {
+      if (!isCartesian()) {
+         UTIL_THROW("Error: Coordinates not Cartesian in maxSqDisplacement");
+      }
+      if (!locked_) {
+         UTIL_THROW("Error: AtomStorage not locked in maxSqDisplacement");
+      }
+      Vector dr;
+      double norm;
+      double max = 0.0;
+      AtomIterator iter;
+      int i = 0;
+      int j;
+      for (begin(iter); iter.notEnd(); ++iter) {
+         for (j = 0; j < Dimension; ++j) {
+            dr[j] = iter->position()[j] - snapshot_[i][j]*scale[j];
+         }
+         norm = dr.square();
+         if (norm > max) {
+            max = norm;
+         }
+         ++i;
+      }
+      return max;
+   }
+
    // Accessors
 
    /*
@@ -555,6 +997,32 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Add memory usage to a report.
+   */
+   void AtomStorage::reportMemory(MemoryReport& report) const
+   {
+      double arrayBytes = atoms_.memoryBytes() + ghosts_.memoryBytes();
+      double maxArrayBytes = double(maxNAtomLocal_ + maxNGhostLocal_)
+                           * double(AtomArray::bytesPerAtom());
+      report.add("AtomArray", arrayBytes, maxArrayBytes);
+
+      double mapBytes = map_.memoryBytes();
+      report.add("AtomMap", mapBytes, mapBytes);
+
+      // Sets, reservoirs, snapshot and sorting workspace.
+      double bytes = double(atomCapacity_ + ghostCapacity_)
+                   * double(2*sizeof(Atom*) + sizeof(int));
+      bytes += snapshot_.capacity()*sizeof(Vector);
+      bytes += sortAtoms_.memoryBytes();
+      bytes += sortKeys_.capacity()*sizeof(std::pair<unsigned int, Atom*>);
+      #ifdef DDMD_OPENMP
+      bytes += threadForces_.capacity()*sizeof(Vector);
+      bytes += fixedForces_.capacity()*sizeof(int64_t);
+      #endif
+      report.add("AtomStorage", bytes, bytes);
+   }
+
    /*
    * Clear all statistics.
    */
@@ -22,6 +22,10 @@
 #include <util/boundary/Boundary.h>           // typedef
 #include <util/global.h>
 
+#include <utility>
+#include <stdint.h>
+#include <cmath>
+
 class AtomStorageTest;
 
 namespace DdMd
@@ -29,6 +33,7 @@ namespace DdMd
 
    using namespace Util;
 
+   class MemoryReport;
    class AtomIterator;
    class ConstAtomIterator;
    class GhostIterator;
@@ -71,9 +76,10 @@ namespace DdMd
       * \param atomCapacity      max number of atoms owned by processor.
       * \param ghostCapacity     max number of ghosts on this processor.
       * \param totalAtomCapacity max number of atoms on all processors.
+      * \param hashMap           if true, use a hashed AtomMap.
       */
       void initialize(int atomCapacity, int ghostCapacity,
-                      int totalAtomCapacity);
+                      int totalAtomCapacity, bool hashMap = false);
 
       /**
       * Read parameters, allocate memory and initialize.
@@ -84,6 +90,19 @@ namespace DdMd
       *  - atomCapacity      [int]  max number of atoms owned by processor.
       *  - ghostCapacity     [int]  max number of ghosts on this processor.
       *  - totalatomCapacity [int]  max number of atoms on all processors.
+      *  - sortInterval      [int]  optional. number of exchange steps per
+      *                             spatial sort of local atoms (0 = never)
+      *  - hashMap           [bool] optional. if true, the AtomMap uses a
+      *                             hash table with memory proportional to
+      *                             atomCapacity + ghostCapacity, rather than
+      *                             an array of totalAtomCapacity pointers.
+      *  - growThreshold     [double] optional. if positive, grow()
+      *                             increases atomCapacity or ghostCapacity
+      *                             when the maximum number of local atoms
+      *                             or ghosts exceeds this fraction of the
+      *                             capacity (0 = fixed capacities).
+      *  - growFactor        [double] optional. factor by which grow()
+      *                             multiplies a capacity (default 1.5).
       *
       * \param in input parameter stream.
       */
@@ -98,6 +117,94 @@ namespace DdMd
       * \param zeroGhosts if true, zero forces on ghost atoms.
       */
       void zeroForces(bool zeroGhosts);
+
+      #ifdef DDMD_OPENMP
+      /**
+      * Scale factor of fixed point force accumulators (2^32).
+      */
+      static const double FixedPointScale;
+
+      /**
+      * Prepare per-thread force accumulators for a threaded force loop.
+      *
+      * Allocates one zeroed force Vector per thread for every local and
+      * ghost Atom on first use. Call outside of any parallel region, 
+      * before calling threadForce() within one. If fixedPointForces()
+      * is true, instead allocates one shared set of 64 bit integer
+      * accumulators per atom, for use by addThreadForce().
+      */
+      void beginThreadForces();
+
+      /**
+      * Add a force to the accumulator of an atom within one thread.
+      *
+      * If fixedPointForces() is true, the force is rounded to a multiple
+      * of 1/FixedPointScale and added to shared integer accumulators by
+      * atomic operations. Integer addition is associative, so the total
+      * is independent of the number of threads and of the order of the
+      * additions. Otherwise, adds the force to threadForce().
+      *
+      * \param threadId index of the calling thread (omp_get_thread_num())
+      * \param atom     local or ghost Atom in this AtomStorage
+      * \param force    force to add
+      */
+      void addThreadForce(int threadId, const Atom& atom, const Vector& force);
+
+      /**
+      * Subtract a force from the accumulator of an atom within one thread.
+      *
+      * \param threadId index of the calling thread (omp_get_thread_num())
+      * \param atom     local or ghost Atom in this AtomStorage
+      * \param force    force to subtract
+      */
+      void subtractThreadForce(int threadId, const Atom& atom,
+                               const Vector& force);
+
+      /**
+      * Return the force accumulator for an atom within one thread.
+      *
+      * Each OpenMP thread should only access accumulators for its own
+      * threadId, which makes concurrent accumulation free of races.
+      *
+      * \param threadId index of the calling thread (omp_get_thread_num())
+      * \param atom     local or ghost Atom in this AtomStorage
+      *
+      * \pre fixedPointForces() is false
+      */
+      Vector& threadForce(int threadId, const Atom& atom);
+
+      /**
+      * Add per-thread forces to atomic forces, and re-zero accumulators.
+      *
+      * Call outside of any parallel region, after the threaded loop.
+      * If includeGhosts is false, accumulators for ghost atoms must not
+      * have been modified since beginThreadForces().
+      *
+      * \param includeGhosts if true, also reduce forces on ghost atoms.
+      */
+      void endThreadForces(bool includeGhosts);
+      #endif
+
+      /**
+      * Return the AtomArray that contains local atoms.
+      *
+      * For force loops that operate directly on the contiguous arrays
+      * of positions, forces and type ids (e.g., device offload), and 
+      * for compact pair lists that store atoms by array index.
+      */
+      AtomArray& localAtomArray();
+
+      /**
+      * Return the AtomArray that contains ghost atoms.
+      */
+      AtomArray& ghostAtomArray();
+
+      /**
+      * Return the index of an atom within its local or ghost AtomArray.
+      *
+      * \param atom  local or ghost Atom in this AtomStorage
+      */
+      int arrayIndex(const Atom& atom) const;
   
       /// \name Serialization (Checkpoint \& Restart)
       //@{
@@ -200,6 +307,52 @@ namespace DdMd
       */
       void clearAtoms(); 
 
+      /**
+      * Reorder local atoms along a space-filling (Morton) curve.
+      *
+      * Copies all local atoms into the first nAtom() elements of the 
+      * underlying AtomArray, in order of a Morton (Z-order) key computed
+      * from positions relative to the bounding box of the local atoms, 
+      * so that atoms that are close in space are close in memory. The
+      * AtomMap is updated, but any other pointers to local atoms (e.g.,
+      * in Groups or send arrays in the Exchanger) are invalidated and
+      * must be reset by the caller. Intended to be called from within 
+      * Exchanger::exchange(), when no ghosts exist.
+      *
+      * \pre nGhost() == 0 and the storage is not locked.
+      */
+      void sortAtoms(); 
+
+      /**
+      * Increase capacities if usage exceeds the growth threshold.
+      *
+      * If growThreshold() is positive and the maximum number of local
+      * atoms (or ghosts) since statistics were cleared exceeds
+      * growThreshold() times atomCapacity() (or ghostCapacity()), this
+      * function reallocates the atom (or ghost) array with capacity
+      * multiplied by growFactor until usage is below the threshold.
+      * Local atoms are copied into the first nAtom() elements of the
+      * new array, and the AtomMap is rebuilt. As for sortAtoms(), any
+      * other pointers to local atoms are invalidated and must be reset
+      * by the caller. Intended to be called from within
+      * Exchanger::exchange(), when no ghosts exist.
+      *
+      * \pre nGhost() == 0 and the storage is not locked.
+      * \return true if any capacity was increased, false otherwise
+      */
+      bool grow();
+
+      #ifdef DDMD_GROUP_INDEX
+      /**
+      * New array index of each local atom after the last reordering.
+      *
+      * Element i is the index of the local atom that had array index i
+      * before the last call to sortAtoms() or (successful) grow(), for
+      * use by Group<N>::remapAtoms().
+      */
+      const DArray<int>& newIndices() const;
+      #endif
+
       /**
       * Return number of local atoms on this procesor (excluding ghosts)
       */
@@ -347,6 +500,35 @@ namespace DdMd
       */
       double maxSqDisplacement();
 
+      /**
+      * Return max-squared non-affine displacement since the last snapshot.
+      *
+      * Measures displacements relative to snapshot positions multiplied
+      * component-wise by scale, i.e., after an affine rescaling of the box
+      * by factors scale[i] = L[i]/L0[i]. Local operation, as for
+      * maxSqDisplacement().
+      *
+      * \param scale ratios of current to snapshot box lengths
+      */
+      double maxSqDisplacement(const Vector& scale);
+
+      /**
+      * Does a snapshot exist (i.e., is the storage locked)?
+      */
+      bool hasSnapshot() const;
+
+      /**
+      * Get the snapshot position of a local atom.
+      *
+      * Atoms are indexed in the order of iteration over local atoms, as
+      * in maxSqDisplacement(), which allows an integrator to measure
+      * displacements in the same loop that updates positions.
+      *
+      * \param i index of atom in iteration order, 0 <= i < nAtom()
+      * \pre hasSnapshot() is true
+      */
+      const Vector& snapshotPosition(int i) const;
+
       //@}
       /// \name Iteration
       //@{
@@ -465,6 +647,33 @@ namespace DdMd
       */
       bool isInitialized() const;
 
+      /**
+      * Number of exchange steps per spatial sort (0 if sorting is disabled).
+      */
+      int sortInterval() const;
+
+      /**
+      * Does the AtomMap use a hash table (true) or an array (false)?
+      */
+      bool hashMap() const;
+
+      /**
+      * Fraction of capacity above which grow() increases capacity.
+      *
+      * Value is zero if capacities are fixed.
+      */
+      double growThreshold() const;
+
+      /**
+      * Factor by which grow() multiplies a capacity.
+      */
+      double growFactor() const;
+
+      /**
+      * Are threaded forces accumulated in fixed point integers?
+      */
+      bool fixedPointForces() const;
+
       /**
       * Return true if the container is valid, or throw an Exception.
       */
@@ -522,6 +731,17 @@ namespace DdMd
       */
       int maxNGhost() const;
 
+      /**
+      * Add memory usage of atom arrays, map and other storage to a report.
+      *
+      * High-water marks of atom arrays are computed from the maximum
+      * numbers of local and ghost atoms on this processor.
+      *
+      * \param report  report to which entries AtomArray, AtomMap and
+      *                AtomStorage are added
+      */
+      void reportMemory(MemoryReport& report) const;
+
       //@}
 
    private:
@@ -547,6 +767,17 @@ namespace DdMd
       // Map of atomIds to atom pointers.
       AtomMap  map_;
 
+      // Work space for sortAtoms: copies of atoms in sorted order.
+      AtomArray  sortAtoms_;
+
+      // Work space for sortAtoms: (Morton key, atom pointer) pairs.
+      DArray< std::pair<unsigned int, Atom*> >  sortKeys_;
+
+      #ifdef DDMD_GROUP_INDEX
+      // New array index of each local atom, by old index.
+      DArray<int>  newIndices_;
+      #endif
+
       // Array of stored old positions.
       DArray<Vector>  snapshot_;
 
@@ -565,6 +796,21 @@ namespace DdMd
       // Maximum number of atoms on all processors, maximum id + 1
       int  totalAtomCapacity_;
 
+      // Number of exchange steps per spatial sort (0 = never sort).
+      int  sortInterval_;
+
+      // Does map_ use a hash table rather than an array indexed by id?
+      bool hashMap_;
+
+      // Usage fraction above which grow() increases a capacity (0 = never).
+      double growThreshold_;
+
+      // Factor by which grow() multiplies a capacity.
+      double growFactor_;
+
+      // Accumulate threaded forces in fixed point integers?
+      bool fixedPointForces_;
+
       /// Maximum number of atoms on this proc since stats cleared.
       int  maxNAtomLocal_; 
    
@@ -595,6 +841,19 @@ namespace DdMd
       // Are atomic coordinates Cartesian (true) or generalized (false)?
       bool isCartesian_;
 
+      #ifdef DDMD_OPENMP
+      // Per-thread force accumulators, nThread_ blocks of size
+      // atomCapacity_ + ghostCapacity_ (locals first, then ghosts).
+      DArray<Vector>  threadForces_;
+
+      // Fixed point force accumulators, Dimension per local or ghost
+      // atom (locals first, then ghosts), shared by all threads.
+      DArray<int64_t>  fixedForces_;
+
+      // Number of threads for which threadForces_ is allocated.
+      int  nThread_;
+      #endif
+
       /*
       * Allocate and initialize all private containers.
       */
@@ -632,6 +891,96 @@ namespace DdMd
    inline bool AtomStorage::isCartesian() const
    { return isCartesian_; }
 
+   inline int AtomStorage::sortInterval() const
+   { return sortInterval_; }
+
+   inline bool AtomStorage::hashMap() const
+   { return hashMap_; }
+
+   inline double AtomStorage::growThreshold() const
+   { return growThreshold_; }
+
+   inline double AtomStorage::growFactor() const
+   { return growFactor_; }
+
+   inline bool AtomStorage::fixedPointForces() const
+   { return fixedPointForces_; }
+
+   inline bool AtomStorage::hasSnapshot() const
+   { return locked_; }
+
+   inline const Vector& AtomStorage::snapshotPosition(int i) const
+   { return snapshot_[i]; }
+
+   #ifdef DDMD_OPENMP
+   inline Vector& AtomStorage::threadForce(int threadId, const Atom& atom)
+   {
+      int i;
+      if (atom.isGhost()) {
+         i = atomCapacity_ + int(&atom - &ghosts_[0]);
+      } else {
+         i = int(&atom - &atoms_[0]);
+      }
+      return threadForces_[threadId*(atomCapacity_ + ghostCapacity_) + i];
+   }
+
+   inline
+   void AtomStorage::addThreadForce(int threadId, const Atom& atom,
+                                    const Vector& force)
+   {
+      if (fixedPointForces_) {
+         int i;
+         if (atom.isGhost()) {
+            i = atomCapacity_ + int(&atom - &ghosts_[0]);
+         } else {
+            i = int(&atom - &atoms_[0]);
+         }
+         int64_t* g = &fixedForces_[Dimension*i];
+         int64_t df;
+         for (int k = 0; k < Dimension; ++k) {
+            df = (int64_t)floor(force[k]*FixedPointScale + 0.5);
+            #pragma omp atomic
+            g[k] += df;
+         }
+      } else {
+         threadForce(threadId, atom) += force;
+      }
+   }
+
+   inline
+   void AtomStorage::subtractThreadForce(int threadId, const Atom& atom,
+                                         const Vector& force)
+   {
+      if (fixedPointForces_) {
+         Vector f;
+         f.multiply(force, -1.0);
+         addThreadForce(threadId, atom, f);
+      } else {
+         threadForce(threadId, atom) -= force;
+      }
+   }
+   #endif
+
+   inline AtomArray& AtomStorage::localAtomArray()
+   {  return atoms_; }
+
+   #ifdef DDMD_GROUP_INDEX
+   inline const DArray<int>& AtomStorage::newIndices() const
+   {  return newIndices_; }
+   #endif
+
+   inline AtomArray& AtomStorage::ghostAtomArray()
+   {  return ghosts_; }
+
+   inline int AtomStorage::arrayIndex(const Atom& atom) const
+   {
+      if (atom.isGhost()) {
+         return int(&atom - &ghosts_[0]);
+      } else {
+         return int(&atom - &atoms_[0]);
+      }
+   }
+
    inline const AtomMap& AtomStorage::map() const
    { return map_; }
 
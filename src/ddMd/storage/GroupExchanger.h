@@ -49,8 +49,8 @@ namespace DdMd
       * Find and mark groups that span boundaries.
       *
       * \param bound  boundaries of domain for this processor
-      * \param inner  inner slab boundaries (extended domain of neighbors)
-      * \param outer  outer slab boundaries (extended domain of this processor)
+      * \param inner  inner bounds of margin for ghosts near boundaries
+      * \param outer  outer bounds of margin for ghosts near boundaries
       * \param gridFlags  element i is 0 iff gridDimension[i] == 1, 1 otherwise
       */
       virtual
@@ -87,11 +87,12 @@ namespace DdMd
       #endif // ifdef UTIL_MPI
    
       /**
-      * Set ghost communication plans for all atoms in incomplete groups.
+      * Set group ghost flags for all atoms in incomplete groups.
       *
       * Usage: This is called after exchanging all atoms and groups between 
       * processors, but before exchanging ghosts. At this point, atom
-      * ownership is finalized, but there are no ghosts.
+      * ownership is finalized, but there are no ghosts. Atoms are added
+      * to sendArray(i, j) only if not already there as nonbonded ghosts.
       *
       * \param atomStorage AtomStorage object
       * \param sendArray   Matrix of arrays of pointers to ghosts to send
@@ -110,6 +111,16 @@ namespace DdMd
       * \param atomStorage AtomStorage object used to find atom pointers
       */
       virtual void findGhosts(AtomStorage& atomStorage) = 0;
+
+      /**
+      * Reset pointers to all local atoms in every group.
+      *
+      * Usage: This is called after local atoms have been reordered by
+      * AtomStorage::sortAtoms(), when no ghosts exist.
+      *
+      * \param atomStorage AtomStorage object used to find atom pointers
+      */
+      virtual void findLocalAtoms(AtomStorage& atomStorage) = 0;
    
       /**
       * Return true if the container is valid, or throw an Exception.
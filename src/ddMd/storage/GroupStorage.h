@@ -25,11 +25,14 @@
 #include "GroupIterator.h"               // inline functions
 #include "ConstGroupIterator.h"          // inline functions
 
+#include <utility>
+
 namespace DdMd
 {
 
    class Domain;
    class Buffer;
+   class MemoryReport;
    class AtomStorage;
    using namespace Util;
 
@@ -238,6 +241,16 @@ namespace DdMd
       */
       Group<N>* find(int id) const;
 
+      /**
+      * Return local Group<N> by index within the set, for 0 <= i < size().
+      *
+      * Order is arbitrary, and changes when groups are added or removed.
+      * This provides random access to groups, e.g., for threaded loops.
+      *
+      * \param i index of group within set of local groups
+      */
+      Group<N>& group(int i);
+
       //@}
       /// \name Global Group Counting
       //@{
@@ -293,8 +306,8 @@ namespace DdMd
       * Find and mark groups that span boundaries.
       *
       * \param bound  boundaries of domain for this processor
-      * \param inner  inner slab boundaries (extended domain of neighbors)
-      * \param outer  outer slab boundaries (extended domain of this processor)
+      * \param inner  inner bounds of margin for ghosts near boundaries
+      * \param outer  outer bounds of margin for ghosts near boundaries
       * \param gridFlags  element i is 0 iff gridDimension[i] == 1, 1 otherwise
       */
       virtual
@@ -329,11 +342,12 @@ namespace DdMd
       #endif // endif ifdef UTIL_MPI
    
       /**
-      * Set ghost communication flags for all atoms in incomplete groups.
+      * Set group ghost flags for all atoms in incomplete groups.
       *
       * Usage: This is called after exchanging all atoms and groups between 
       * processors, but before exchanging ghosts. At this point, atom
-      * ownership is finalized, but there are no ghosts.
+      * ownership is finalized, but there are no ghosts. Atoms are added
+      * to sendArray(i, j) only if not already there as nonbonded ghosts.
       *
       * \param atomStorage AtomStorage object
       * \param sendArray   Matrix of arrays of pointers to ghosts to send
@@ -353,6 +367,21 @@ namespace DdMd
       */
       virtual
       void findGhosts(AtomStorage& atomStorage);
+
+      /**
+      * Reset pointers to all local atoms in every group.
+      *
+      * Usage: This is called after local atoms have been reordered by
+      * AtomStorage::sortAtoms(), when no ghosts exist. Local groups are
+      * then reordered to follow the new order of their member atoms in 
+      * memory, so that loops over groups access atoms in sorted order.
+      * If DDMD_GROUP_INDEX is defined, atom indices are instead remapped
+      * in bulk from AtomStorage::newIndices().
+      *
+      * \param atomStorage AtomStorage object used to find atom pointers
+      */
+      virtual
+      void findLocalAtoms(AtomStorage& atomStorage);
    
       /**
       * Return true if the container is valid, or throw an Exception.
@@ -412,6 +441,18 @@ namespace DdMd
       */
       int maxNGroup() const;
 
+      /**
+      * Add memory usage to a report.
+      *
+      * The high-water mark is computed from the maximum number of
+      * groups on this processor.
+      *
+      * \param report report to which an entry is added
+      * \param name  name of entry (e.g., "BondStorage")
+      */
+      void reportMemory(MemoryReport& report, const std::string& name)
+      const;
+
       //@}
       /// \name Miscellaneous Accessors
       //@{
@@ -451,6 +492,15 @@ namespace DdMd
       // Array identifying empty groups, marked for later removal 
       GPArray< Group<N> > emptyGroups_;
 
+      // Incomplete groups found by markGhosts, resolved by findGhosts.
+      GPArray< Group<N> > ghostGroups_;
+
+      // Is ghostGroups_ valid (set by markGhosts, unset by findGhosts)?
+      bool hasGhostGroups_;
+
+      // Work space for sortGroups: (first local atom, group) pairs.
+      DArray< std::pair<Atom*, Group<N>*> > sortKeys_;
+
       // Pointer to space for a new local Group
       Group<N>* newPtr_;
 
@@ -477,6 +527,11 @@ namespace DdMd
       * Allocate and initialize all private containers.
       */
       void allocate();
+
+      /*
+      * Reorder local groups by address of their first local atom.
+      */
+      void sortGroups();
     
    };
 
@@ -505,6 +560,13 @@ namespace DdMd
    inline Group<N>* GroupStorage<N>::find(int id) const
    {  return groupPtrs_[id]; }
 
+   /*
+   * Return local group by index within the set.
+   */
+   template <int N>
+   inline Group<N>& GroupStorage<N>::group(int i)
+   {  return groupSet_[i]; }
+
    /*
    * Set iterator to beginning of the set of local groups.
    */
@@ -10,8 +10,10 @@
 
 #include "GroupStorage.h"
 #include "AtomStorage.h"
+#include <ddMd/misc/MemoryReport.h>
 #include <util/format/Int.h>
 #include <util/mpi/MpiLoader.h>  
+#include <algorithm>
 #include <ddMd/communicate/GroupDistributor.tpp>   // member
 #include <ddMd/communicate/GroupCollector.tpp>     // member
 
@@ -30,6 +32,7 @@ namespace DdMd
     : groups_(),
       groupSet_(),
       reservoir_(),
+      hasGhostGroups_(false),
       newPtr_(0),
       capacity_(0),
       totalCapacity_(0),
@@ -115,6 +118,8 @@ namespace DdMd
       reservoir_.allocate(capacity_);
       groupSet_.allocate(groups_);
       groupPtrs_.allocate(totalCapacity_);
+      sortKeys_.allocate(capacity_);
+      ghostGroups_.reserve(capacity_);
 
       // Push all groups onto reservoir stack, in reverse order.
       for (int i = capacity_ - 1; i >=0; --i) {
@@ -237,6 +242,8 @@ namespace DdMd
          groupPtr->setId(-1);
          reservoir_.push(*groupPtr);
       }
+      ghostGroups_.clear();
+      hasGhostGroups_ = false;
 
       if (groupSet_.size() != 0) {
          UTIL_THROW("Nonzero ghostSet size at end of clearGhosts");
@@ -351,6 +358,23 @@ namespace DdMd
       #endif
    }
 
+   /*
+   * Add memory usage to a report.
+   */
+   template <int N>
+   void GroupStorage<N>::reportMemory(MemoryReport& report,
+                                      const std::string& name) const
+   {
+      // Bytes per group in groups_, groupSet_, reservoir_, sortKeys_
+      // and ghost and empty group pointer arrays.
+      double perGroup = sizeof(Group<N>) + 4*sizeof(Group<N>*)
+                      + sizeof(int) + sizeof(std::pair<Atom*, Group<N>*>);
+      double fixed = groupPtrs_.capacity()*sizeof(Group<N>*);
+      double allocated = fixed + capacity_*perGroup;
+      double highWater = fixed + maxNGroupLocal_*perGroup;
+      report.add(name, allocated, highWater);
+   }
+
    /*
    * Clear all statistics.
    */
@@ -488,10 +512,14 @@ namespace DdMd
    * "down" (j=0) and "up" (j=1) in each direction). This requires information
    * about positions of ghost as well as local atoms. For each boundary of 
    * the domain, identify atoms whose positions are "inside" and "outside".
-   * Count ghost atoms very near the boundary as both inside and outside,
-   * for safety. If a group has atoms both inside and outside a domain 
+   * Count ghost atoms very near the boundary (within the slab between
+   * inner and outer, which must only be wide enough to allow for motion
+   * of ghosts since their last update) as both inside and outside, for
+   * safety. If a group has atoms both inside and outside a domain
    * boundary, it is marked for sending in the associated communication 
-   * step. 
+   * step. Complete groups that contain no ghosts and no atoms marked
+   * for exchange cannot span a boundary, and are skipped after a
+   * single pass over their atoms.
    *
    * After calculating a ghost communication plan for each group, clear 
    * the pointers to all ghost atoms in the group. The exchangeAtoms 
@@ -519,6 +547,19 @@ namespace DdMd
 
          if (isComplete) {
 
+            // Skip interior groups: all atoms local, none exchanged.
+            choose = false;
+            for (k = 0; k < N; ++k) {
+               atomPtr = groupIter->atomPtr(k);
+               if (atomPtr->isGhost() || atomPtr->plan().hasExchange()) {
+                  choose = true;
+                  break;
+               }
+            }
+            if (!choose) {
+               continue;
+            }
+
             for (i = 0; i < Dimension; ++i) {
                if (gridFlags[i]) {
                   for (j = 0; j < 2; ++j) {
@@ -719,9 +760,10 @@ namespace DdMd
    * For each group, check if the group is incomplete, implying that one or
    * more atoms in the group are owned by another processor. If the group 
    * is incomplete, loop over 6 transfer directions. For each direction,
-   * if the group is marked for sending in that direction, set the ghost
+   * if the group is marked for sending in that direction, set the group
    * ghost communication flag for transfer in that direction for every 
-   * local atom in the group. Also add each such atom to sendArray(i, j).
+   * local atom in the group. Also add each such atom to sendArray(i, j),
+   * unless it is already there as a nonbonded ghost.
    *
    * Note: If a group is incomplete on this processor, and thus
    * contains atoms owned by other processors, the algorithm assumes
@@ -737,6 +779,7 @@ namespace DdMd
       Atom* atomPtr;
       Plan* planPtr;
       int i, j, k, nAtom;
+      ghostGroups_.clear();
 
       // Loop over groups
       begin(groupIter);
@@ -779,6 +822,7 @@ namespace DdMd
          // If this group is incomplete, set ghost flags for atoms 
          nAtom = groupIter->nPtr();
          if (nAtom < N) {
+            ghostGroups_.append(*groupIter);
             for (i = 0; i < Dimension; ++i) {
                if (gridFlags[i]) {
                   for (j = 0; j < 2; ++j) {
@@ -788,10 +832,10 @@ namespace DdMd
                            if (atomPtr) {
                               assert(!atomPtr->isGhost());
                               planPtr = &atomPtr->plan();
-                              if (!planPtr->ghost(i, j)) { 
-                                 planPtr->setGhost(i, j);
+                              if (!planPtr->hasGhost(i, j)) {
                                  sendArray(i, j).append(*atomPtr);
                               }
+                              planPtr->setGroupGhost(i, j);
                            }
                         }
                      }
@@ -801,17 +845,95 @@ namespace DdMd
          }
 
       }
+      hasGhostGroups_ = true;
+   }
+
+   /*
+   * Reset pointers to local atoms after reordering local atoms.
+   */
+   template <int N>
+   void GroupStorage<N>::findLocalAtoms(AtomStorage& atomStorage)
+   {
+      GroupIterator<N> groupIter;
+      #ifndef DDMD_GROUP_INDEX
+      const AtomMap& atomMap = atomStorage.map();
+      for (begin(groupIter); groupIter.notEnd(); ++groupIter) {
+         atomMap.findGroupLocalAtoms(*groupIter);
+      }
+      #else
+      // Remap atom indices in bulk, without AtomMap lookups
+      const DArray<int>& newIndices = atomStorage.newIndices();
+      for (begin(groupIter); groupIter.notEnd(); ++groupIter) {
+         groupIter->remapAtoms(newIndices);
+      }
+      #endif
+      sortGroups();
+   }
+
+   /*
+   * Reorder local groups to follow the order of local atoms (private).
+   *
+   * Each group is keyed by the lowest address of a local member atom.
+   * Because local atoms are stored in one array, sorting by address 
+   * orders groups consistently with the atom order in memory.
+   */
+   template <int N>
+   void GroupStorage<N>::sortGroups()
+   {
+      const int n = groupSet_.size();
+      if (n == 0) return;
+
+      Group<N>* groupPtr;
+      Atom* keyPtr;
+      Atom* atomPtr;
+      int i, k;
+      for (i = 0; i < n; ++i) {
+         groupPtr = &groupSet_[i];
+         keyPtr = 0;
+         for (k = 0; k < N; ++k) {
+            atomPtr = groupPtr->atomPtr(k);
+            if (atomPtr && (keyPtr == 0 || atomPtr < keyPtr)) {
+               keyPtr = atomPtr;
+            }
+         }
+         sortKeys_[i].first = keyPtr;
+         sortKeys_[i].second = groupPtr;
+      }
+      std::sort(&sortKeys_[0], &sortKeys_[0] + n);
+
+      // Rebuild the set of local groups in sorted order
+      while (groupSet_.size() > 0) {
+         groupSet_.pop();
+      }
+      for (i = 0; i < n; ++i) {
+         groupSet_.append(*sortKeys_[i].second);
+      }
    }
 
    /*
    * Find ghost members of groups after exchanging all ghosts.
+   *
+   * If markGhosts was called since the last call, only the incomplete
+   * groups that it recorded are searched. Otherwise, all groups are.
    */
    template <int N>
    void GroupStorage<N>::findGhosts(AtomStorage& atomStorage)
    {
-      GroupIterator<N> groupIter;
       const AtomMap& atomMap = atomStorage.map();
       int nAtom;
+      if (hasGhostGroups_) {
+         int n = ghostGroups_.size();
+         for (int i = 0; i < n; ++i) {
+            nAtom = atomMap.findGroupGhostAtoms(ghostGroups_[i]);
+            if (nAtom < N) {
+               UTIL_THROW("Incomplete group after search for ghosts");
+            }
+         }
+         hasGhostGroups_ = false;
+         return;
+      }
+
+      GroupIterator<N> groupIter;
       for (begin(groupIter); groupIter.notEnd(); ++groupIter) {
          nAtom = groupIter->nPtr();
          if (nAtom < N) {
@@ -14,6 +14,10 @@
 #include "communicate/CommunicateTestComposite.h"
 #include "neighbor/NeighborTestComposite.h"
 #include "simulation/SimulationTest.h"
+#include "integrators/IntegratorTest.h"
+#ifdef SIMP_COULOMB
+#include "coulomb/CoulombTest.h"
+#endif
 #ifdef DDMD_MODIFIERS
 #include "modifiers/ModifierTestComposite.h"
 #endif
@@ -31,6 +35,10 @@ addChild(new ModifierTestComposite, "modifiers/");
 addChild(new TEST_RUNNER(ConfigIoTest), "configIos/");
 addChild(new CommunicateTestComposite, "communicate/");
 addChild(new TEST_RUNNER(SimulationTest), "simulation/");
+addChild(new TEST_RUNNER(IntegratorTest), "integrators/");
+#ifdef SIMP_COULOMB
+addChild(new TEST_RUNNER(CoulombTest), "coulomb/");
+#endif
 #endif
 TEST_COMPOSITE_END
 
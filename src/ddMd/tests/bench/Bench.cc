@@ -0,0 +1,358 @@
+/*
+* Microbenchmarks for DdMd kernels.
+*
+* Usage:
+*
+*    mpirun -np P Bench [n [density [nRepeat [GHz]]]]
+*
+* Creates a simple cubic lattice of n*n*n Lennard-Jones atoms (default
+* n = 32) at the given number density (default 0.8442), with small
+* random displacements, divided among P processors along the x axis.
+* Each kernel is timed for nRepeat calls (default 20), and the average
+* time per call is reported by the master processor, together with:
+*
+*   - ns (or cycles, if a clock frequency in GHz is given) per atom for
+*     the cell list build,
+*   - ns (or cycles) per pair for the pair list build and force loops,
+*   - bytes per second for Buffer pack/unpack and Exchanger::update.
+*
+* Times are maxima over processors of the time on each processor.
+*/
+
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/communicate/Buffer.h>
+#include <ddMd/communicate/Exchanger.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/GhostIterator.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/potentials/pair/PairPotentialImpl.h>
+#include <simp/interaction/pair/LJPair.h>
+#include <util/boundary/Boundary.h>
+#include <util/random/Random.h>
+#include <util/space/Vector.h>
+#include <util/format/Dbl.h>
+#include <util/format/Int.h>
+#include <util/global.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+
+using namespace Util;
+using namespace Simp;
+using namespace DdMd;
+
+class KernelBench
+{
+
+public:
+
+   KernelBench(MPI::Intracomm& communicator)
+    : communicatorPtr_(&communicator),
+      n_(32),
+      density_(0.8442),
+      nRepeat_(20),
+      frequency_(0.0)
+   {}
+
+   void setOptions(int argc, char** argv)
+   {
+      if (argc > 1) n_ = atoi(argv[1]);
+      if (argc > 2) density_ = atof(argv[2]);
+      if (argc > 3) nRepeat_ = atoi(argv[3]);
+      if (argc > 4) frequency_ = atof(argv[4]);
+   }
+
+   void initialize();
+
+   void run();
+
+private:
+
+   Boundary boundary_;
+   Domain domain_;
+   Buffer buffer_;
+   Exchanger exchanger_;
+   AtomStorage atomStorage_;
+   PairPotentialImpl<LJPair> pairPotential_;
+   MPI::Intracomm* communicatorPtr_;
+   int n_;
+   double density_;
+   int nRepeat_;
+   double frequency_;
+
+   double maxTime(double time);
+
+   void report(const std::string& name, double time, 
+               double count, const std::string& unit);
+
+   void reportBandwidth(const std::string& name, double time, 
+                        double nByte);
+
+   void benchCellList();
+   void benchPairList();
+   void benchForces(int methodId, const std::string& name);
+   void benchPackUnpack();
+   void benchUpdate();
+
+};
+
+/*
+* Create atoms and ghosts, build cell and pair lists.
+*/
+void KernelBench::initialize()
+{
+   int nProc = communicatorPtr_->Get_size();
+   int nAtom = n_*n_*n_;
+   int nLocal = nAtom/nProc + 1;
+   double a = pow(1.0/density_, 1.0/3.0);
+   double length = n_*a;
+   Vector lengths(length, length, length);
+   boundary_.setOrthorhombic(lengths);
+
+   domain_.setBoundary(boundary_);
+   domain_.setGridCommunicator(*communicatorPtr_);
+   atomStorage_.associate(domain_, boundary_, buffer_);
+   exchanger_.associate(domain_, boundary_, atomStorage_, buffer_);
+   pairPotential_.associate(domain_, boundary_, atomStorage_);
+   pairPotential_.setNAtomType(1);
+
+   // Read parameters from strings generated for this system size
+   {
+      std::stringstream in;
+      in << "Domain{ gridDimensions " << nProc << " 1 1 }"
+         << std::endl;
+      in << "Buffer{ atomCapacity " << nLocal 
+         << " ghostCapacity " << nAtom << " }" << std::endl;
+      in << "AtomStorage{ atomCapacity " << 2*nLocal 
+         << " ghostCapacity " << 2*nAtom 
+         << " totalAtomCapacity " << nAtom << " }" << std::endl;
+      in << "PairPotential{ epsilon 1.0 sigma 1.0 cutoff 2.5 skin 0.3 "
+         << " pairCapacity " << 100*nLocal 
+         << " maxBoundary cubic " << 1.1*length << " }" << std::endl;
+      domain_.readParam(in);
+      buffer_.readParam(in);
+      atomStorage_.readParam(in);
+      pairPotential_.readParam(in);
+   }
+   exchanger_.setPairCutoff(pairPotential_.cutoff());
+   exchanger_.allocate();
+
+   // Add lattice sites in this domain, in generalized coordinates
+   Random random;
+   random.setSeed(8682143);
+   Vector position;
+   Atom* ptr;
+   int i, j, k;
+   int id = 0;
+   for (i = 0; i < n_; ++i) {
+      for (j = 0; j < n_; ++j) {
+         for (k = 0; k < n_; ++k) {
+            position[0] = (i + 0.5 + random.uniform(-0.1, 0.1))/n_;
+            position[1] = (j + 0.5 + random.uniform(-0.1, 0.1))/n_;
+            position[2] = (k + 0.5 + random.uniform(-0.1, 0.1))/n_;
+            if (domain_.isInDomain(position)) {
+               ptr = atomStorage_.newAtomPtr();
+               ptr->setId(id);
+               ptr->setTypeId(0);
+               ptr->position() = position;
+               ptr->velocity().zero();
+               ptr->force().zero();
+               atomStorage_.addNewAtom();
+            }
+            ++id;
+         }
+      }
+   }
+
+   // Create ghosts, and build cell and pair lists
+   exchanger_.exchange();
+   pairPotential_.buildCellList();
+   atomStorage_.transformGenToCart(boundary_);
+   atomStorage_.makeSnapshot();
+   pairPotential_.buildPairList();
+}
+
+/*
+* Maximum of a time over all processors.
+*/
+double KernelBench::maxTime(double time)
+{
+   double max = time;
+   communicatorPtr_->Allreduce(&time, &max, 1, MPI::DOUBLE, MPI::MAX);
+   return max;
+}
+
+/*
+* Report time per call and time (or cycles) per item.
+*/
+void KernelBench::report(const std::string& name, double time, 
+                         double count, const std::string& unit)
+{
+   double total = count;
+   communicatorPtr_->Allreduce(&count, &total, 1, MPI::DOUBLE, MPI::MAX);
+   int nProc = communicatorPtr_->Get_size();
+   time = maxTime(time)/double(nRepeat_);
+   if (communicatorPtr_->Get_rank() == 0) {
+      double perItem = 1.0E9*time/total;
+      std::cout << name 
+                << Dbl(1.0E3*time, 14, 6) << " ms  "
+                << Dbl(frequency_ > 0.0 ? perItem*frequency_ : perItem, 12, 4)
+                << (frequency_ > 0.0 ? " cycles/" : " ns/") << unit 
+                << "   (" << Int(nProc) << " procs)" << std::endl;
+   }
+}
+
+/*
+* Report time per call and bytes per second.
+*/
+void KernelBench::reportBandwidth(const std::string& name, double time, 
+                                  double nByte)
+{
+   double total = nByte;
+   communicatorPtr_->Allreduce(&nByte, &total, 1, MPI::DOUBLE, MPI::MAX);
+   time = maxTime(time)/double(nRepeat_);
+   if (communicatorPtr_->Get_rank() == 0) {
+      std::cout << name 
+                << Dbl(1.0E3*time, 14, 6) << " ms  "
+                << Dbl(total/time, 12, 4) << " bytes/s" << std::endl;
+   }
+}
+
+/*
+* Time PairPotential::buildCellList() (CellList::build).
+*/
+void KernelBench::benchCellList()
+{
+   double time = 0.0;
+   double start;
+   atomStorage_.clearSnapshot();
+   for (int i = 0; i < nRepeat_; ++i) {
+      atomStorage_.transformCartToGen(boundary_);
+      start = MPI::Wtime();
+      pairPotential_.buildCellList();
+      time += MPI::Wtime() - start;
+      atomStorage_.transformGenToCart(boundary_);
+   }
+   atomStorage_.makeSnapshot();
+   double count = atomStorage_.nAtom() + atomStorage_.nGhost();
+   report("CellList::build      ", time, count, "atom");
+}
+
+/*
+* Time PairPotential::buildPairList() (PairList::build).
+*/
+void KernelBench::benchPairList()
+{
+   double start = MPI::Wtime();
+   for (int i = 0; i < nRepeat_; ++i) {
+      pairPotential_.buildPairList();
+   }
+   double time = MPI::Wtime() - start;
+   report("PairList::build      ", time, pairPotential_.pairList().nPair(), 
+          "pair");
+}
+
+/*
+* Time a pair force loop (methodId 0 = list, 1 = cell, 2 = N^2).
+*/
+void KernelBench::benchForces(int methodId, const std::string& name)
+{
+   pairPotential_.setMethodId(methodId);
+   double start = MPI::Wtime();
+   for (int i = 0; i < nRepeat_; ++i) {
+      pairPotential_.computeForces();
+   }
+   double time = MPI::Wtime() - start;
+   pairPotential_.setMethodId(0);
+   report(name, time, pairPotential_.pairList().nPair(), "pair");
+}
+
+/*
+* Time packing ghost positions into the Buffer, sending to self, and
+* unpacking them.
+*/
+void KernelBench::benchPackUnpack()
+{
+   GhostIterator iter;
+   int rank = communicatorPtr_->Get_rank();
+   double packTime = 0.0;
+   double unpackTime = 0.0;
+   double start;
+   for (int i = 0; i < nRepeat_; ++i) {
+      start = MPI::Wtime();
+      buffer_.clearSendBuffer();
+      buffer_.beginSendBlock(Buffer::UPDATE);
+      for (atomStorage_.begin(iter); iter.notEnd(); ++iter) {
+         iter->packUpdate(buffer_);
+      }
+      buffer_.endSendBlock();
+      packTime += MPI::Wtime() - start;
+
+      buffer_.beginSendRecv(*communicatorPtr_, rank, rank, 0);
+      buffer_.endSendRecv();
+
+      start = MPI::Wtime();
+      buffer_.beginRecvBlock();
+      for (atomStorage_.begin(iter); iter.notEnd(); ++iter) {
+         iter->unpackUpdate(buffer_);
+      }
+      buffer_.endRecvBlock();
+      unpackTime += MPI::Wtime() - start;
+   }
+   double nByte = double(atomStorage_.nGhost()*sizeof(Vector));
+   reportBandwidth("Buffer pack          ", packTime, nByte);
+   reportBandwidth("Buffer unpack        ", unpackTime, nByte);
+}
+
+/*
+* Time Exchanger::update().
+*/
+void KernelBench::benchUpdate()
+{
+   double start = MPI::Wtime();
+   for (int i = 0; i < nRepeat_; ++i) {
+      exchanger_.update();
+   }
+   double time = MPI::Wtime() - start;
+   double nByte = double(atomStorage_.nGhost()*sizeof(Vector));
+   reportBandwidth("Exchanger::update    ", time, nByte);
+}
+
+/*
+* Run all benchmarks.
+*/
+void KernelBench::run()
+{
+   if (communicatorPtr_->Get_rank() == 0) {
+      std::cout << "nAtom = " << n_*n_*n_ 
+                << ", density = " << density_
+                << ", nRepeat = " << nRepeat_ << std::endl;
+   }
+   benchCellList();
+   benchPairList();
+   benchForces(0, "Forces (pair list)   ");
+   benchForces(1, "Forces (cell list)   ");
+   if (n_*n_*n_ <= 32768) {
+      benchForces(2, "Forces (N^2)         ");
+   }
+   benchPackUnpack();
+   benchUpdate();
+}
+
+int main(int argc, char** argv)
+{
+   MPI::Init();
+   try {
+      KernelBench bench(MPI::COMM_WORLD);
+      bench.setOptions(argc, argv);
+      bench.initialize();
+      bench.run();
+   } catch (Exception& e) {
+      e.write(std::cerr);
+      MPI::COMM_WORLD.Abort(1);
+   }
+   MPI::Finalize();
+}
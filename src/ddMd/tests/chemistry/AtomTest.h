@@ -101,6 +101,7 @@ void AtomTest::testSubscript()
    TEST_ASSERT(a[1].mask().isMasked(37));
    TEST_ASSERT(a[1].mask().size() == 2);
    TEST_ASSERT(!a[1].mask().isMasked(50));
+   TEST_ASSERT(!a[1].mask().isMasked(39 + 64));
    TEST_ASSERT(a[1].plan().flags() == 23);
 
    a[1].setIsGhost(false);
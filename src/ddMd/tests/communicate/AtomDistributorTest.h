@@ -163,10 +163,66 @@ public:
       #endif
 
    }
+
+   #ifdef UTIL_MPI
+   void testRedistribute()
+   {
+      printMethod(TEST_FUNC);
+      std::ifstream atomposfile;
+
+      openFile("in/AtomDistributor.213");
+      domain_.readParam(file());
+      storage_.readParam(file());
+      buffer_.readParam(file());
+      distributor_.readParam(file());
+      closeFile();
+
+      Vector boundarylength(6.0, 3.0, 9.0);
+      boundary_.setOrthorhombic(boundarylength);
+
+      int myRank = domain_.gridRank();
+      int nProc = communicator().Get_size();
+
+      // Every processor reads the file, and keeps every nProc-th atom
+      int atomCount; 
+      int i;
+      Vector r;
+      Atom*  ptr;
+      openInputFile("in/Atompositions", atomposfile);
+      atomposfile >> atomCount;
+      for (i = 0; i < atomCount; ++i) {
+         atomposfile >> r;
+         if (i % nProc == myRank) {
+            ptr = distributor_.newLocalAtomPtr();
+            ptr->setId(i);
+            ptr->setTypeId(0);
+            boundary_.transformCartToGen(r, ptr->position());
+            ptr->velocity() = ptr->position();
+            distributor_.addStagedAtom();
+         }
+      }
+      atomposfile.close();
+
+      distributor_.redistribute();
+
+      AtomIterator iter;
+      storage_.begin(iter);
+      for ( ; iter.notEnd(); ++iter) {
+         TEST_ASSERT(domain_.isInDomain(iter->position()));
+      }
+      if (myRank == 0) {
+         TEST_ASSERT(storage_.nAtomTotal() == atomCount);
+      }
+   }
+   #endif
+
 };
 
 TEST_BEGIN(AtomDistributorTest)
 TEST_ADD(AtomDistributorTest, testDistribute)
+#ifdef UTIL_MPI
+TEST_ADD(AtomDistributorTest, testRedistribute)
+#endif
 TEST_END(AtomDistributorTest)
 
 #endif /* DISTRIBUTOR_TEST_H */
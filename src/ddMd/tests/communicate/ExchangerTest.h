@@ -34,6 +34,8 @@
 #include <test/UnitTestRunner.h>
 #include <test/ParamFileTest.h>
 
+#include <vector>
+
 using namespace Util;
 using namespace DdMd;
 
@@ -71,6 +73,7 @@ public:
    void testExchange();
    void testGhostUpdate();
    void testGhostUpdateCycle();
+   void testCompactUpdate();
    void testExchangeUpdateCycle();
 
 };
@@ -456,6 +459,46 @@ void ExchangerTest::testGhostUpdateCycle()
 
 }
 
+void ExchangerTest::testCompactUpdate()
+{
+   printMethod(TEST_FUNC);
+
+   GhostIterator  ghostIter;
+
+   exchanger.exchange();
+   exchangeNotify();
+   atomStorage.transformGenToCart(boundary);
+   int nGhost = atomStorage.nGhost();
+
+   // Full update, then compact updates after small displacements
+   exchanger.setCompactUpdate(true);
+   double range = 0.01;
+   for (int j=0; j < 4; ++j) {
+      exchanger.update();
+      TEST_ASSERT(nGhost == atomStorage.nGhost());
+      displaceAtoms(range);
+   }
+   exchanger.update();
+
+   // Store ghost positions, then compare to those of a full update
+   std::vector<Vector> positions;
+   atomStorage.begin(ghostIter);
+   for ( ; ghostIter.notEnd(); ++ghostIter) {
+      positions.push_back(ghostIter->position());
+   }
+   exchanger.setCompactUpdate(false);
+   exchanger.update();
+   Vector dr;
+   int i = 0;
+   atomStorage.begin(ghostIter);
+   for ( ; ghostIter.notEnd(); ++ghostIter) {
+      dr.subtract(ghostIter->position(), positions[i]);
+      TEST_ASSERT(dr.square() < 1.0E-16);
+      ++i;
+   }
+   TEST_ASSERT(i == nGhost);
+}
+
 void ExchangerTest::testExchangeUpdateCycle()
 {
    printMethod(TEST_FUNC);
@@ -627,6 +670,7 @@ TEST_ADD(ExchangerTest, testDistribute)
 TEST_ADD(ExchangerTest, testExchange)
 TEST_ADD(ExchangerTest, testGhostUpdate)
 TEST_ADD(ExchangerTest, testGhostUpdateCycle)
+TEST_ADD(ExchangerTest, testCompactUpdate)
 TEST_ADD(ExchangerTest, testExchangeUpdateCycle)
 TEST_END(ExchangerTest)
 
@@ -155,6 +155,85 @@ public:
 
       //std::cout << plan;
    }
+
+   void testGroupGhost()
+   {
+      printMethod(TEST_FUNC);
+
+      Plan plan;
+      plan.clearFlags();
+      plan.setGhost(0, 1);
+      plan.setGhost(1, 0);
+      plan.setGroupGhost(0, 1);
+      plan.setGroupGhost(2, 0);
+      TEST_ASSERT(plan.groupGhost(0, 1));
+      TEST_ASSERT(!plan.groupGhost(1, 0));
+      TEST_ASSERT(plan.groupGhost(2, 0));
+      TEST_ASSERT(!plan.ghost(2, 0));
+      TEST_ASSERT(plan.hasGhost(1, 0));
+      TEST_ASSERT(plan.hasGhost(2, 0));
+      TEST_ASSERT(!plan.hasGhost(2, 1));
+
+      // Received in both classes: all flags kept
+      Plan both = plan;
+      both.pruneGhosts(0, 1);
+      TEST_ASSERT(both.flags() == plan.flags());
+
+      // Received as a nonbonded ghost: group ghost flags cleared
+      Plan pair = plan;
+      pair.pruneGhosts(1, 0);
+      TEST_ASSERT(pair.ghost(1, 0));
+      TEST_ASSERT(pair.ghost(0, 1));
+      TEST_ASSERT(!pair.groupGhost(0, 1));
+      TEST_ASSERT(!pair.hasGhost(2, 0));
+
+      // Received as a group ghost: nonbonded ghost flags cleared
+      Plan group = plan;
+      group.pruneGhosts(2, 0);
+      TEST_ASSERT(!group.ghost(0, 1));
+      TEST_ASSERT(!group.ghost(1, 0));
+      TEST_ASSERT(group.groupGhost(0, 1));
+      TEST_ASSERT(group.groupGhost(2, 0));
+
+      plan.clearGroupGhost(2, 0);
+      TEST_ASSERT(!plan.hasGhost(2, 0));
+      plan.clearFlags();
+      TEST_ASSERT(!plan.groupGhost(0, 1));
+   }
+
+   void testHalfShellPair()
+   {
+      printMethod(TEST_FUNC);
+
+      Plan local;
+      Plan a;
+      Plan b;
+      local.clearFlags();
+      a.clearFlags();
+      b.clearFlags();
+
+      a.setGhost(0, 1);
+      a.setImage(0, 0);
+      TEST_ASSERT(a.image(0, 0));
+      TEST_ASSERT(!a.image(0, 1));
+      TEST_ASSERT(a.ghost(0, 1));
+      TEST_ASSERT(Plan::isHalfShellPair(local, a));
+      TEST_ASSERT(Plan::isHalfShellPair(local, local));
+
+      // Shared upper image: pair is computed by another processor
+      b.setImage(0, 0);
+      TEST_ASSERT(!Plan::isHalfShellPair(a, b));
+
+      // Different upper images: computed here
+      b.clearFlags();
+      b.setImage(1, 0);
+      TEST_ASSERT(Plan::isHalfShellPair(a, b));
+
+      // Any lower image: never computed here
+      b.setImage(2, 1);
+      TEST_ASSERT(!Plan::isHalfShellPair(local, b));
+      TEST_ASSERT(!Plan::isHalfShellPair(a, b));
+   }
 };
 
 TEST_BEGIN(PlanTest)
@@ -162,6 +241,8 @@ TEST_ADD(PlanTest, testGhostPlan)
 TEST_ADD(PlanTest, testExchangePlan)
 TEST_ADD(PlanTest, testClear)
 TEST_ADD(PlanTest, testInserter)
+TEST_ADD(PlanTest, testGroupGhost)
+TEST_ADD(PlanTest, testHalfShellPair)
 TEST_END(PlanTest)
 
 #endif
@@ -13,8 +13,11 @@
 #include <ddMd/storage/BondStorage.h>
 #include <ddMd/storage/AngleStorage.h>
 #include <ddMd/storage/DihedralStorage.h>
+#include <ddMd/misc/AsyncFileBuf.h>
 #include <util/mpi/MpiLogger.h>
 
+#include <sstream>
+
 #ifdef UTIL_MPI
 #ifndef TEST_MPI
 #define TEST_MPI
@@ -189,11 +192,53 @@ public:
 
    }
 
+   void testWriteConfigAsync()
+   {
+      printMethod(TEST_FUNC);
+
+      readParam();
+      std::ifstream file;
+      openInputFile("in/config", file);
+      configIo.readConfig(file, MaskBonded);
+
+      std::ofstream out;
+      openOutputFile("out_sync", out);
+      configIo.writeConfig(out);
+      out.close();
+
+      // Write through a background buffer attached to an open stream
+      AsyncFileBuf asyncBuf;
+      std::ofstream asyncOut;
+      if (domain.isMaster()) {
+         openOutputFile("out_async", asyncOut);
+         asyncBuf.attach(asyncOut);
+         TEST_ASSERT(asyncOut.is_open());
+      }
+      configIo.writeConfig(asyncOut);
+      if (domain.isMaster()) {
+         asyncBuf.submit();
+         asyncBuf.detach();
+         TEST_ASSERT(!asyncBuf.isAttached());
+         asyncOut.close();
+
+         // Compare to the synchronous output
+         std::ifstream in1, in2;
+         openInputFile("out_sync", in1);
+         openInputFile("out_async", in2);
+         std::stringstream s1, s2;
+         s1 << in1.rdbuf();
+         s2 << in2.rdbuf();
+         TEST_ASSERT(s1.str().size() > 0);
+         TEST_ASSERT(s1.str() == s2.str());
+      }
+   }
+
 };
 
 TEST_BEGIN(ConfigIoTest)
 TEST_ADD(ConfigIoTest, testReadConfig)
 TEST_ADD(ConfigIoTest, testReadWriteConfig)
+TEST_ADD(ConfigIoTest, testWriteConfigAsync)
 TEST_END(ConfigIoTest)
 
 #endif /* CONFIG_IO_TEST_H */
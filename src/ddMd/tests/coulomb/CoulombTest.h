@@ -0,0 +1,166 @@
+#ifndef DDMD_COULOMB_TEST_H
+#define DDMD_COULOMB_TEST_H
+
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/potentials/pair/PairPotential.h>
+#include <ddMd/potentials/coulomb/CoulombPotential.h>
+#include <util/boundary/Boundary.h>
+#include <util/math/Constants.h>
+#include <util/format/Dbl.h>
+
+#ifdef UTIL_MPI
+#ifndef TEST_MPI
+#define TEST_MPI
+#endif
+#endif
+
+#include <test/ParamFileTest.h>
+#include <test/UnitTestRunner.h>
+#include <test/CommandLine.h>
+
+#include <cmath>
+
+using namespace Util;
+using namespace DdMd;
+
+class CoulombTest : public ParamFileTest
+{
+private:
+
+   DdMd::Simulation simulation_;
+
+   /*
+   * Read parameter file and NaCl configuration, and compute forces.
+   */
+   void initialize(const char* paramFile);
+
+   /*
+   * Return Coulomb energy on master, 0 on other processors.
+   */
+   double coulombEnergy();
+
+   /*
+   * Return maximum magnitude of force on any atom, on all processors.
+   */
+   double maxForce();
+
+   /*
+   * Check energy and forces of rock salt lattice, within tolerance.
+   */
+   void checkMadelung(double tolerance);
+
+public:
+
+   virtual void setUp()
+   {
+      Label::clear();
+      simulation_.fileMaster().setRootPrefix(filePrefix());
+   }
+
+   virtual void tearDown()
+   {  Label::clear(); }
+
+   void testEwald();
+
+   void testSpme();
+
+};
+
+inline void CoulombTest::initialize(const char* paramFile)
+{
+   CommandLine opts;
+   opts.append("-e");
+   simulation_.setOptions(opts.argc(), opts.argv());
+
+   openFile(paramFile);
+   simulation_.readParam(file());
+   file().close();
+
+   std::string filename("config.nacl");
+   simulation_.readConfig(filename);
+   TEST_ASSERT(simulation_.isValid());
+
+   simulation_.pairPotential().buildCellList();
+   simulation_.atomStorage().transformGenToCart(simulation_.boundary());
+   simulation_.pairPotential().buildPairList();
+   simulation_.computeForces();
+}
+
+inline double CoulombTest::coulombEnergy()
+{
+   simulation_.computePotentialEnergies();
+   double energy = 0.0;
+   if (simulation_.domain().isMaster()) {
+      energy = simulation_.coulombPotential().energy();
+   }
+   return energy;
+}
+
+inline double CoulombTest::maxForce()
+{
+   double force = 0.0;
+   double f;
+   AtomIterator iter;
+   for (simulation_.atomStorage().begin(iter); iter.notEnd(); ++iter) {
+      f = iter->force().abs();
+      if (f > force) {
+         force = f;
+      }
+   }
+
+   double max = force;
+   #ifdef UTIL_MPI
+   simulation_.domain().communicator().Allreduce(&force, &max, 1,
+                                                MPI::DOUBLE, MPI::MAX);
+   #endif
+   return max;
+}
+
+inline void CoulombTest::checkMadelung(double tolerance)
+{
+   // Rock salt lattice of 12^3 unit charges, with nearest neighbor
+   // distance 1, has energy -(N/2) M/(4 pi epsilon) with epsilon = 1
+   const int nAtom = 1728;
+   const double madelung = 1.747564594633;
+   double exact = -0.5*nAtom*madelung/(4.0*Constants::Pi);
+
+   double energy = coulombEnergy();
+   if (simulation_.domain().isMaster()) {
+      if (verbose() > 0) {
+         std::cout << std::endl << Dbl(energy) << Dbl(exact);
+      }
+      TEST_ASSERT(std::fabs(energy/exact - 1.0) < tolerance);
+   }
+
+   // Every ion is a center of inversion symmetry, so net forces vanish
+   double force = maxForce();
+   if (verbose() > 0 && simulation_.domain().isMaster()) {
+      std::cout << std::endl << Dbl(force);
+   }
+   TEST_ASSERT(force < tolerance);
+}
+
+inline void CoulombTest::testEwald()
+{
+   printMethod(TEST_FUNC);
+   initialize("in/Ewald");
+   checkMadelung(1.0E-4);
+}
+
+inline void CoulombTest::testSpme()
+{
+   printMethod(TEST_FUNC);
+   initialize("in/Spme");
+   checkMadelung(1.0E-3);
+}
+
+TEST_BEGIN(CoulombTest)
+TEST_ADD(CoulombTest, testEwald)
+TEST_ADD(CoulombTest, testSpme)
+TEST_END(CoulombTest)
+
+#endif
@@ -0,0 +1,18 @@
+#include "CoulombTest.h"
+
+int main()
+{
+   #ifdef UTIL_MPI 
+   MPI::Init();
+   IntVector::commitMpiType();
+   Vector::commitMpiType();
+   #endif 
+
+   TEST_RUNNER(CoulombTest) runner;
+   runner.run();
+
+   #ifdef UTIL_MPI
+   MPI::Finalize();
+   #endif
+
+} 
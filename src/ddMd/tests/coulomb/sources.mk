@@ -0,0 +1,7 @@
+ddMd_tests_coulomb_=ddMd/tests/coulomb/Test.cc
+
+ddMd_tests_coulomb_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(ddMd_tests_coulomb_))
+ddMd_tests_coulomb_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(ddMd_tests_coulomb_:.cc=.o))
+
@@ -0,0 +1,372 @@
+#ifndef DDMD_INTEGRATOR_TEST_H
+#define DDMD_INTEGRATOR_TEST_H
+
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/storage/AtomStorage.h>
+#include <ddMd/storage/AtomIterator.h>
+#include <ddMd/storage/GhostIterator.h>
+#include <ddMd/storage/BondStorage.h>
+#include <ddMd/communicate/Domain.h>
+#include <ddMd/chemistry/Atom.h>
+#include <ddMd/chemistry/Group.h>
+#include <ddMd/chemistry/AtomType.h>
+#include <ddMd/integrators/Integrator.h>
+#include <ddMd/integrators/NvtLeesEdwardsIntegrator.h>
+#include <util/containers/DArray.h>
+#include <util/boundary/Boundary.h>
+#include <util/format/Dbl.h>
+
+#ifdef UTIL_MPI
+#ifndef TEST_MPI
+#define TEST_MPI
+#endif
+#endif
+
+#include <test/ParamFileTest.h>
+#include <test/UnitTestRunner.h>
+#include <test/CommandLine.h>
+
+#include <cmath>
+
+using namespace Util;
+using namespace DdMd;
+
+class IntegratorTest : public ParamFileTest
+{
+private:
+
+   DdMd::Simulation simulation_;
+
+   /*
+   * Read parameter and configuration files, and set velocities.
+   */
+   void initialize(const char* paramFile, const char* configFile);
+
+   /*
+   * Return total energy on master, 0 on other processors.
+   */
+   double totalEnergy();
+
+   /*
+   * Return maximum relative error of bond lengths on all processors.
+   */
+   double maxBondError(double length);
+
+   /*
+   * Return total momentum of all atoms, on all processors.
+   */
+   Vector totalMomentum();
+
+public:
+
+   virtual void setUp()
+   {
+      Label::clear();
+      simulation_.fileMaster().setRootPrefix(filePrefix());
+   }
+
+   virtual void tearDown()
+   {  Label::clear(); }
+
+   void testRattle();
+
+   void testRespa();
+
+   void testDpd();
+
+   void testLeesEdwards();
+
+};
+
+inline
+void IntegratorTest::initialize(const char* paramFile, const char* configFile)
+{
+   CommandLine opts;
+   opts.append("-e");
+   simulation_.setOptions(opts.argc(), opts.argv());
+
+   openFile(paramFile);
+   simulation_.readParam(file());
+   file().close();
+
+   std::string filename(configFile);
+   simulation_.readConfig(filename);
+
+   double temperature = 1.0;
+   simulation_.setBoltzmannVelocities(temperature);
+   TEST_ASSERT(simulation_.isValid());
+}
+
+inline double IntegratorTest::totalEnergy()
+{
+   simulation_.computeKineticEnergy();
+   simulation_.computePotentialEnergies();
+   double energy = 0.0;
+   if (simulation_.domain().isMaster()) {
+      energy = simulation_.kineticEnergy() + simulation_.potentialEnergy();
+   }
+   return energy;
+}
+
+inline double IntegratorTest::maxBondError(double length)
+{
+   AtomStorage& atomStorage = simulation_.atomStorage();
+   BondStorage& bondStorage = simulation_.bondStorage();
+   const Boundary& boundary = simulation_.boundary();
+   TEST_ASSERT(atomStorage.isCartesian());
+
+   double error = 0.0;
+   double r;
+   int nBond = bondStorage.size();
+   for (int i = 0; i < nBond; ++i) {
+      Group<2>& bond = bondStorage.group(i);
+      r = sqrt(boundary.distanceSq(bond.atomPtr(0)->position(),
+                                   bond.atomPtr(1)->position()));
+      r = std::fabs(r - length)/length;
+      if (r > error) {
+         error = r;
+      }
+   }
+
+   double maxError = error;
+   #ifdef UTIL_MPI
+   simulation_.domain().communicator().Allreduce(&error, &maxError, 1,
+                                                MPI::DOUBLE, MPI::MAX);
+   #endif
+   return maxError;
+}
+
+inline Vector IntegratorTest::totalMomentum()
+{
+   Vector momentum(0.0);
+   Vector p;
+   AtomIterator iter;
+   for (simulation_.atomStorage().begin(iter); iter.notEnd(); ++iter) {
+      p.multiply(iter->velocity(), 
+                 simulation_.atomType(iter->typeId()).mass());
+      momentum += p;
+   }
+
+   Vector total = momentum;
+   #ifdef UTIL_MPI
+   simulation_.domain().communicator().Allreduce(&momentum[0], &total[0], 
+                                  Dimension, MPI::DOUBLE, MPI::SUM);
+   #endif
+   return total;
+}
+
+inline void IntegratorTest::testRattle()
+{
+   printMethod(TEST_FUNC);
+
+   // Chains of 4 atoms, in which interior atoms have two constraints
+   initialize("in/Rattle", "config.chains");
+   Domain& domain = simulation_.domain();
+   int nAtom = 840;
+
+   // Equilibrate briefly, after velocities are constrained in setup
+   simulation_.integrator().run(20);
+   TEST_ASSERT(simulation_.isValid());
+   TEST_ASSERT(maxBondError(1.0) < 1.0E-6);
+   double energy0 = totalEnergy();
+
+   double energy;
+   for (int i = 0; i < 5; ++i) {
+      simulation_.integrator().run(100);
+      TEST_ASSERT(simulation_.isValid());
+      TEST_ASSERT(maxBondError(1.0) < 1.0E-6);
+      energy = totalEnergy();
+      if (domain.isMaster()) {
+         if (verbose() > 0) {
+            std::cout << std::endl << Dbl(energy) << Dbl(energy - energy0);
+         }
+         TEST_ASSERT(std::fabs(energy - energy0) < 1.0E-3*nAtom);
+      }
+   }
+}
+
+inline void IntegratorTest::testRespa()
+{
+   printMethod(TEST_FUNC);
+
+   // Flexible chains, with bond forces in the inner (fast) steps
+   initialize("in/Respa", "config.chains");
+   Domain& domain = simulation_.domain();
+   int nAtom = 840;
+
+   // Run lengths are multiples of nInner = 5
+   simulation_.integrator().run(20);
+   TEST_ASSERT(simulation_.isValid());
+   double energy0 = totalEnergy();
+
+   double energy;
+   for (int i = 0; i < 5; ++i) {
+      simulation_.integrator().run(100);
+      TEST_ASSERT(simulation_.isValid());
+      energy = totalEnergy();
+      if (domain.isMaster()) {
+         if (verbose() > 0) {
+            std::cout << std::endl << Dbl(energy) << Dbl(energy - energy0);
+         }
+         TEST_ASSERT(std::fabs(energy - energy0) < 1.0E-3*nAtom);
+      }
+   }
+}
+
+inline void IntegratorTest::testDpd()
+{
+   printMethod(TEST_FUNC);
+
+   // Flexible chains with DPD pair thermostat at temperature 1.0
+   initialize("in/Dpd", "config.chains");
+   Domain& domain = simulation_.domain();
+   int nAtom = 840;
+
+   // Pair forces conserve momentum, including pairs across domains
+   Vector momentum0 = totalMomentum();
+   simulation_.integrator().run(200);
+   TEST_ASSERT(simulation_.isValid());
+   Vector dp;
+   dp.subtract(totalMomentum(), momentum0);
+   TEST_ASSERT(dp.abs() < 1.0E-8*nAtom);
+
+   // Average kinetic temperature is close to the thermostat temperature
+   double temperature = 0.0;
+   int nSample = 20;
+   for (int i = 0; i < nSample; ++i) {
+      simulation_.integrator().run(50);
+      simulation_.computeKineticEnergy();
+      if (domain.isMaster()) {
+         temperature += 2.0*simulation_.kineticEnergy()/double(3*nAtom);
+      }
+   }
+   TEST_ASSERT(simulation_.isValid());
+   dp.subtract(totalMomentum(), momentum0);
+   TEST_ASSERT(dp.abs() < 1.0E-8*nAtom);
+   if (domain.isMaster()) {
+      temperature /= double(nSample);
+      if (verbose() > 0) {
+         std::cout << std::endl << Dbl(temperature);
+      }
+      TEST_ASSERT(std::fabs(temperature - 1.0) < 0.05);
+   }
+}
+
+inline void IntegratorTest::testLeesEdwards()
+{
+   printMethod(TEST_FUNC);
+
+   // Shear flow along y (flow 1), with gradient along x (gradient 0)
+   initialize("in/LeesEdwards", "config.chains");
+   Domain& domain = simulation_.domain();
+   AtomStorage& atomStorage = simulation_.atomStorage();
+   NvtLeesEdwardsIntegrator* integratorPtr 
+         = dynamic_cast<NvtLeesEdwardsIntegrator*>(&simulation_.integrator());
+   TEST_ASSERT(integratorPtr);
+   const int gradient = 0;
+   const int flow = 1;
+   const double shearRate = 0.2;
+   const int nAtom = 840;
+   int i, j;
+
+   simulation_.integrator().run(1000);
+   TEST_ASSERT(simulation_.isValid());
+   TEST_ASSERT(maxBondError(1.0) < 0.3);
+
+   // Positions of all atoms, indexed by id, on all processors
+   DArray<double> localPositions;
+   DArray<double> positions;
+   localPositions.allocate(Dimension*nAtom);
+   positions.allocate(Dimension*nAtom);
+   for (i = 0; i < Dimension*nAtom; ++i) {
+      localPositions[i] = 0.0;
+      positions[i] = 0.0;
+   }
+   AtomIterator atomIter;
+   for (atomStorage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+      for (j = 0; j < Dimension; ++j) {
+         localPositions[Dimension*atomIter->id() + j] 
+                                               = atomIter->position()[j];
+      }
+   }
+   #ifdef UTIL_MPI
+   domain.communicator().Allreduce(&localPositions[0], &positions[0], 
+                                   Dimension*nAtom, MPI::DOUBLE, MPI::SUM);
+   #else
+   for (i = 0; i < Dimension*nAtom; ++i) {
+      positions[i] = localPositions[i];
+   }
+   #endif
+
+   // Each ghost is an image of its owner, in which an image n along
+   // the gradient axis is also displaced by n*offset along the flow axis
+   const Vector& lengths = simulation_.boundary().lengths();
+   double offset = integratorPtr->strain()*lengths[gradient]/lengths[flow];
+   Vector d;
+   double n;
+   GhostIterator ghostIter;
+   for (atomStorage.begin(ghostIter); ghostIter.notEnd(); ++ghostIter) {
+      i = Dimension*ghostIter->id();
+      for (j = 0; j < Dimension; ++j) {
+         d[j] = (ghostIter->position()[j] - positions[i + j])/lengths[j];
+      }
+      n = floor(d[gradient] + 0.5);
+      d[flow] -= n*offset;
+      for (j = 0; j < Dimension; ++j) {
+         TEST_ASSERT(std::fabs(d[j] - floor(d[j] + 0.5)) < 1.0E-8);
+      }
+   }
+
+   // Velocities follow the streaming profile, and peculiar velocities
+   // have the thermostat temperature. Atoms that crossed a boundary 
+   // along the gradient axis would otherwise have the wrong velocity.
+   const double center = 0.5*lengths[gradient];
+   double localSums[3];
+   double totals[3];
+   double sums[3];
+   double x, mass;
+   Vector v;
+   int nSample = 5;
+   sums[0] = sums[1] = sums[2] = 0.0;
+   for (int k = 0; k < nSample; ++k) {
+      simulation_.integrator().run(100);
+      localSums[0] = localSums[1] = localSums[2] = 0.0;
+      for (atomStorage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+         x = atomIter->position()[gradient] - center;
+         v = atomIter->velocity();
+         mass = simulation_.atomType(atomIter->typeId()).mass();
+         localSums[0] += x*x;
+         localSums[1] += x*v[flow];
+         v[flow] -= shearRate*x;
+         localSums[2] += mass*v.square();
+      }
+      #ifdef UTIL_MPI
+      domain.communicator().Allreduce(localSums, totals, 3, 
+                                      MPI::DOUBLE, MPI::SUM);
+      #else
+      for (j = 0; j < 3; ++j) {
+         totals[j] = localSums[j];
+      }
+      #endif
+      for (j = 0; j < 3; ++j) {
+         sums[j] += totals[j];
+      }
+   }
+   TEST_ASSERT(simulation_.isValid());
+   double slope = sums[1]/sums[0];
+   double temperature = sums[2]/double(Dimension*nAtom*nSample);
+   if (verbose() > 0 && domain.isMaster()) {
+      std::cout << std::endl << Dbl(slope) << Dbl(temperature);
+   }
+   TEST_ASSERT(std::fabs(slope - shearRate) < 0.2*shearRate);
+   TEST_ASSERT(std::fabs(temperature - 1.0) < 0.05);
+}
+
+TEST_BEGIN(IntegratorTest)
+TEST_ADD(IntegratorTest, testRattle)
+TEST_ADD(IntegratorTest, testRespa)
+TEST_ADD(IntegratorTest, testDpd)
+TEST_ADD(IntegratorTest, testLeesEdwards)
+TEST_END(IntegratorTest)
+
+#endif
@@ -0,0 +1,18 @@
+#include "IntegratorTest.h"
+
+int main()
+{
+   #ifdef UTIL_MPI 
+   MPI::Init();
+   IntVector::commitMpiType();
+   Vector::commitMpiType();
+   #endif 
+
+   TEST_RUNNER(IntegratorTest) runner;
+   runner.run();
+
+   #ifdef UTIL_MPI
+   MPI::Finalize();
+   #endif
+
+} 
@@ -58,6 +58,10 @@ public:
       std::cout << std::endl;
       manager.writeParam(std::cout);
 
+      TEST_ASSERT(manager.hasAction(Modifier::Flags::PostIntegrate1));
+      TEST_ASSERT(!manager.hasAction(Modifier::Flags::PreIntegrate1));
+      TEST_ASSERT(!manager.hasAction(Modifier::Flags::PostForce));
+
       long iStep = 10;
       manager.postIntegrate1(iStep);
    }
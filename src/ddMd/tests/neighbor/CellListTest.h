@@ -187,6 +187,9 @@ public:
       cellList.build();
       TEST_ASSERT(cellList.isValid());
       cellList.update();
+      TEST_ASSERT(cellList.nOccupiedCell() == 1);
+      TEST_ASSERT(cellList.nOccupiedLocalCell() == 1);
+      TEST_ASSERT(&cellList.occupiedCell(0) == &cellList.cell(cellId));
 
       int size, capacity;
       for (int i = 0; i < cellList.grid().size(); ++i) {
@@ -251,6 +254,7 @@ public:
       for (i = 0; i < nAtom; ++i){
          TEST_ASSERT(cellList.cell(cellId[i]).nAtom() == nAtom);
       }
+      TEST_ASSERT(cellList.nOccupiedCell() == 1);
 
       try { 
          cellList.isValid(); 
@@ -64,7 +64,11 @@ public:
    void tearDown()
    {}
 
-   void makeConfiguration(int nCutCell = 1)
+   /*
+   * If drift > 0, atoms within drift*cutoffs outside the domain are
+   * local atoms in ghost cells, as after a rebuild without exchange.
+   */
+   void makeConfiguration(int nCutCell = 1, double drift = 0.0)
    {
       for (int i=0; i < Dimension; ++i) {
          lower[i] = lower[i]/lengths[i];
@@ -122,14 +126,15 @@ public:
          ghost = false;
          for (j = 0; j < Dimension; ++j) {
             pos[j] = random.uniform(lowerGhost[j], upperGhost[j]);
-            if (pos[j] < lower[j]) 
+            if (pos[j] < lower[j] - drift*cutoffs[j])
                ghost = true;
-            if (pos[j] > upper[j]) 
+            if (pos[j] > upper[j] + drift*cutoffs[j])
                ghost = true;
             TEST_ASSERT(pos[j] >= lowerGhost[j]);
             TEST_ASSERT(pos[j] <= upperGhost[j]);
          }
          atoms[i].position() = pos;
+         atoms[i].setIsGhost(ghost);
          if (ghost) {
             ++nGhost;
             ghosts.append(atoms[i]);
@@ -138,7 +143,11 @@ public:
             locals.append(atoms[i]);
          }
          ic = cellList.cellIndexFromPosition(pos);
-         TEST_ASSERT(ghost == cellList.cell(ic).isGhostCell());
+         if (ghost) {
+            TEST_ASSERT(cellList.cell(ic).isGhostCell());
+         } else if (drift == 0.0) {
+            TEST_ASSERT(!cellList.cell(ic).isGhostCell());
+         }
          TEST_ASSERT(nGhost == ghosts.size());
          TEST_ASSERT(nLocal == locals.size());
 
@@ -329,6 +338,48 @@ public:
 
    }
 
+   void testCountNeighborsDrift()
+   {
+      printMethod(TEST_FUNC);
+
+      makeConfiguration(1, 0.25);
+      TEST_ASSERT(cellList.nDriftCell() > 0);
+
+      // Count pairs with at least one local atom (N^2 loop)
+      Atom* atom1Ptr;
+      Atom* atom2Ptr;
+      Vector dr;
+      int nq = 0;
+      int i, j;
+      for (i = 0; i < locals.size(); ++i) {
+         atom1Ptr = &locals[i];
+         for (j = i + 1; j < locals.size(); ++j) {
+            atom2Ptr = &locals[j];
+            dr.subtract(atom2Ptr->position(), atom1Ptr->position());
+            if (dr.square() < cutoffSq) {
+               ++nq;
+            }
+         }
+         for (j = 0; j < ghosts.size(); ++j) {
+            atom2Ptr = &ghosts[j];
+            dr.subtract(atom2Ptr->position(), atom1Ptr->position());
+            if (dr.square() < cutoffSq) {
+               ++nq;
+            }
+         }
+      }
+
+      pairList.build(cellList);
+      TEST_ASSERT(nq == pairList.nPair());
+
+      // Check that every listed pair contains a local atom
+      PairIterator iter;
+      for (pairList.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom1Ptr, atom2Ptr);
+         TEST_ASSERT(!atom1Ptr->isGhost() || !atom2Ptr->isGhost());
+      }
+   }
+
    void testPairIterator()
    {
       printMethod(TEST_FUNC);
@@ -363,12 +414,54 @@ public:
 
    }
 
+   void testCompact()
+   {
+      printMethod(TEST_FUNC);
+
+      makeConfiguration();
+      pairList.build(cellList);
+
+      // All atoms (local and ghost) are elements of array atoms
+      PairList compact;
+      compact.setCompact(&atoms[0], &atoms[0]);
+      compact.allocate(nAtom, pairCapacity, cutoff);
+      compact.build(cellList);
+      TEST_ASSERT(compact.isCompact());
+      TEST_ASSERT(!pairList.isCompact());
+      TEST_ASSERT(compact.nAtom() == pairList.nAtom());
+      TEST_ASSERT(compact.nPair() == pairList.nPair());
+
+      // Check that both lists contain the same pairs, in the same order
+      PairIterator iter;
+      PairIterator compactIter;
+      Atom* atom1Ptr;
+      Atom* atom2Ptr;
+      Atom* compact1Ptr;
+      Atom* compact2Ptr;
+      int j = 0;
+      pairList.begin(iter);
+      compact.begin(compactIter);
+      for ( ; iter.notEnd(); ++iter) {
+         TEST_ASSERT(compactIter.notEnd());
+         iter.getPair(atom1Ptr, atom2Ptr);
+         compactIter.getPair(compact1Ptr, compact2Ptr);
+         TEST_ASSERT(compact1Ptr == atom1Ptr);
+         TEST_ASSERT(compact2Ptr == atom2Ptr);
+         TEST_ASSERT(compact.atom2Ptr(j) == atom2Ptr);
+         ++compactIter;
+         ++j;
+      }
+      TEST_ASSERT(compactIter.isEnd());
+   }
+
 };
 
 TEST_BEGIN(PairListTest)
 TEST_ADD(PairListTest, testCountNeighbors)
 TEST_ADD(PairListTest, testCountNeighbors2)
+TEST_ADD(PairListTest, testCountNeighborsDrift)
 TEST_ADD(PairListTest, testPairIterator)
+TEST_ADD(PairListTest, testCompact)
 TEST_END(PairListTest)
 
 #endif
@@ -11,6 +11,7 @@
 #include <simp/interaction/pair/DpdPair.h>
 #include <util/boundary/Boundary.h>
 #include <util/random/Random.h>
+#include <util/containers/DArray.h>
 
 #ifdef UTIL_MPI
 #ifndef TEST_MPI
@@ -259,11 +260,60 @@ public:
 
    }
 
+   /*
+   * Compare pair list forces, which are computed on the offload device
+   * if DDMD_OFFLOAD is defined, to host cell list forces.
+   */
+   void testOffloadForces()
+   {
+      printMethod(TEST_FUNC);
+
+      const int nAtom = 120;
+      double cutoff   = 1.2;
+      Vector lower(0.0);
+      Vector upper(2.0, 3.0, 4.0);
+
+      boundary.setOrthorhombic(upper);
+      randomAtoms(nAtom, lower, upper, cutoff);
+
+      TEST_ASSERT(!storage.isCartesian());
+      pairPotential.buildCellList();
+      storage.transformGenToCart(boundary);
+      pairPotential.buildPairList();
+
+      // Pair list forces (offload device, if enabled)
+      zeroForces();
+      pairPotential.setMethodId(0);
+      pairPotential.computeForces();
+      DArray<Vector> forces;
+      forces.allocate(storage.nAtom());
+      AtomIterator iter;
+      int i = 0;
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         forces[i] = iter->force();
+         ++i;
+      }
+
+      // Cell list forces (host)
+      zeroForces();
+      pairPotential.setMethodId(1);
+      pairPotential.computeForces();
+      Vector df;
+      i = 0;
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         df.subtract(iter->force(), forces[i]);
+         TEST_ASSERT(df.square() < 1.0E-20*(1.0 + forces[i].square()));
+         ++i;
+      }
+      TEST_ASSERT(i == storage.nAtom());
+   }
+
 };
 
 TEST_BEGIN(PairPotentialTest)
 TEST_ADD(PairPotentialTest, testRead1)
 TEST_ADD(PairPotentialTest, testRandom1)
+TEST_ADD(PairPotentialTest, testOffloadForces)
 TEST_END(PairPotentialTest)
 
 #endif 
@@ -60,6 +60,10 @@ public:
 
    void testIntegrate1();
 
+   void testComputeThermo();
+
+   void testConfigVersion();
+
 };
 
 
@@ -347,6 +351,94 @@ inline void SimulationTest::testIntegrate1()
 
 }
 
+inline void SimulationTest::testComputeThermo()
+{
+   printMethod(TEST_FUNC); 
+
+   Domain& domain = simulation_.domain();
+
+   CommandLine opts;
+   opts.append("-e");
+   simulation_.setOptions(opts.argc(), opts.argv());
+
+   openFile("in/param2"); 
+   simulation_.readParam(file()); 
+   std::string filename("config2");
+   simulation_.readConfig(filename);
+   double temperature = 1.0;
+   simulation_.setBoltzmannVelocities(temperature);
+   int myRank = domain.gridRank();
+
+   // Compute values separately, with one reduction per quantity
+   simulation_.computeKineticEnergy();
+   simulation_.computePotentialEnergies();
+   simulation_.computeKineticStress();
+   simulation_.computeVirialStress();
+   double kinetic = 0.0;
+   double potential = 0.0;
+   Tensor kineticStress, virialStress;
+   if (myRank == 0) {
+      kinetic = simulation_.kineticEnergy();
+      potential = simulation_.potentialEnergy();
+      kineticStress = simulation_.kineticStress();
+      virialStress = simulation_.virialStress();
+   }
+
+   // Recompute all values with a single reduction
+   simulation_.unsetKineticEnergy();
+   simulation_.unsetPotentialEnergies();
+   simulation_.unsetKineticStress();
+   simulation_.unsetVirialStress();
+   simulation_.computeThermo(true, true);
+   TEST_ASSERT(simulation_.isValid());
+   if (myRank == 0) {
+      TEST_ASSERT(feq(simulation_.kineticEnergy(), kinetic));
+      TEST_ASSERT(feq(simulation_.potentialEnergy(), potential));
+      for (int i = 0; i < Dimension; ++i) {
+         for (int j = 0; j < Dimension; ++j) {
+            TEST_ASSERT(feq(simulation_.kineticStress()(i, j), 
+                           kineticStress(i, j)));
+            TEST_ASSERT(feq(simulation_.virialStress()(i, j), 
+                           virialStress(i, j)));
+         }
+      }
+   }
+
+   // Calling again with all values set should do nothing
+   simulation_.computeThermo(true, true);
+   TEST_ASSERT(simulation_.isValid());
+}
+
+inline void SimulationTest::testConfigVersion()
+{
+   printMethod(TEST_FUNC);
+
+   CommandLine opts;
+   opts.append("-e");
+   simulation_.setOptions(opts.argc(), opts.argv());
+
+   openFile("in/param2");
+   simulation_.readParam(file());
+   long version = simulation_.configVersion();
+
+   // Reading a configuration invalidates all cached values
+   std::string filename("config2");
+   simulation_.readConfig(filename);
+   TEST_ASSERT(simulation_.configVersion() > version);
+   version = simulation_.configVersion();
+
+   // Velocities do not change the configuration version
+   double temperature = 1.0;
+   simulation_.setBoltzmannVelocities(temperature);
+   TEST_ASSERT(simulation_.configVersion() == version);
+
+   // Position and modify signals do
+   simulation_.positionSignal().notify();
+   TEST_ASSERT(simulation_.configVersion() == version + 1);
+   simulation_.modifySignal().notify();
+   TEST_ASSERT(simulation_.configVersion() == version + 2);
+}
+
 TEST_BEGIN(SimulationTest)
 TEST_ADD(SimulationTest, testReadParam)
 TEST_ADD(SimulationTest, testReadConfig)
@@ -355,6 +447,8 @@ TEST_ADD(SimulationTest, testExchange)
 TEST_ADD(SimulationTest, testUpdate)
 TEST_ADD(SimulationTest, testCalculateForces)
 TEST_ADD(SimulationTest, testIntegrate1)
+TEST_ADD(SimulationTest, testComputeThermo)
+TEST_ADD(SimulationTest, testConfigVersion)
 TEST_END(SimulationTest)
 
 #endif
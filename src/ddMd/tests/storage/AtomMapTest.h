@@ -52,6 +52,7 @@ public:
    void testFindLocal();
    void testFindLocalGhost();
    void testClearGhosts();
+   void testHashed();
 
 };
 
@@ -256,12 +257,80 @@ inline void AtomMapTest::testClearGhosts()
    TEST_ASSERT(map_.isValid());
 }
 
+inline void AtomMapTest::testHashed()
+{
+   printMethod(TEST_FUNC);
+
+   // Small table (8 slots for 20 ids), so that probe sequences collide
+   AtomMap hashMap;
+   hashMap.allocate(20, 4);
+   TEST_ASSERT(hashMap.isHashed());
+   TEST_ASSERT(!map_.isHashed());
+
+   ArraySet<Atom> ghostSet;
+   ghostSet.allocate(array_);
+   array_[7].setId(19);
+   array_[13].setId(19);
+
+   int i, j;
+   for (i = 0; i < 10; i += 2) {
+      hashMap.addLocal(&array_[i]);
+      map_.addLocal(&array_[i]);
+   }
+   hashMap.addGhost(&array_[7]);
+   map_.addGhost(&array_[7]);
+   hashMap.addGhost(&array_[13]);
+   map_.addGhost(&array_[13]);
+   ghostSet.append(array_[7]);
+   ghostSet.append(array_[13]);
+   TEST_ASSERT(hashMap.nLocal() == 5);
+   TEST_ASSERT(hashMap.nGhost() == 2);
+   TEST_ASSERT(hashMap.nGhostDistinct() == 1);
+   TEST_ASSERT(hashMap.isValid());
+   for (j = 0; j < 20; ++j) {
+      TEST_ASSERT(hashMap.find(j) == map_.find(j));
+   }
+
+   // Remove entries from the middle of probe sequences
+   hashMap.removeLocal(&array_[2]);
+   map_.removeLocal(&array_[2]);
+   hashMap.removeLocal(&array_[6]);
+   map_.removeLocal(&array_[6]);
+   hashMap.removeGhost(&array_[7]);
+   ghostSet.remove(array_[7]);
+   map_.removeGhost(&array_[7]);
+   TEST_ASSERT(hashMap.nLocal() == 3);
+   TEST_ASSERT(hashMap.nGhostDistinct() == 1);
+   TEST_ASSERT(hashMap.isValid());
+   for (j = 0; j < 20; ++j) {
+      TEST_ASSERT(hashMap.find(j) == map_.find(j));
+   }
+
+   hashMap.addLocal(&array_[6]);
+   map_.addLocal(&array_[6]);
+   hashMap.addLocal(&array_[10]);
+   map_.addLocal(&array_[10]);
+   TEST_ASSERT(hashMap.isValid());
+   for (j = 0; j < 20; ++j) {
+      TEST_ASSERT(hashMap.find(j) == map_.find(j));
+   }
+
+   hashMap.clearGhosts(ghostSet);
+   map_.clearGhosts(ghostSet);
+   TEST_ASSERT(hashMap.nGhost() == 0);
+   TEST_ASSERT(hashMap.isValid());
+   for (j = 0; j < 20; ++j) {
+      TEST_ASSERT(hashMap.find(j) == map_.find(j));
+   }
+}
+
 TEST_BEGIN(AtomMapTest)
 TEST_ADD(AtomMapTest, testAdd)
 TEST_ADD(AtomMapTest, testAddRemove)
 TEST_ADD(AtomMapTest, testFindLocal)
 TEST_ADD(AtomMapTest, testFindLocalGhost)
 TEST_ADD(AtomMapTest, testClearGhosts)
+TEST_ADD(AtomMapTest, testHashed)
 TEST_END(AtomMapTest)
 
 #endif
@@ -60,6 +60,10 @@ public:
 
    void testTransforms();
 
+   void testSortAtoms();
+
+   void testGrow();
+
 };
 
 inline void AtomStorageTest::testReadParam()
@@ -501,6 +505,90 @@ void AtomStorageTest::testTransforms()
 
 }
 
+void AtomStorageTest::testSortAtoms()
+{
+   printMethod(TEST_FUNC);
+
+   // Add atoms out of spatial order, with x-coordinate = 0.1*id
+   int ids[5] = {53, 35, 18, 44, 17};
+   Atom* ptr;
+   int i;
+   for (i = 0; i < 5; ++i) {
+      ptr = storage_.addAtom(ids[i]);
+      ptr->setTypeId(i % 2);
+      ptr->position() = Vector(0.1*ids[i], 0.5, 0.5);
+      ptr->velocity() = Vector(double(ids[i]), 0.0, 0.0);
+   }
+   storage_.removeAtom(map_.find(35));
+   TEST_ASSERT(storage_.nAtom() == 4);
+   TEST_ASSERT(storage_.isValid());
+
+   storage_.sortAtoms();
+   TEST_ASSERT(storage_.nAtom() == 4);
+   TEST_ASSERT(storage_.isValid());
+
+   // Atoms should now occupy the first elements of atoms_, in order of x
+   int sorted[4] = {17, 18, 44, 53};
+   for (i = 0; i < 4; ++i) {
+      ptr = map_.find(sorted[i]);
+      TEST_ASSERT(ptr == &storage_.atoms_[i]);
+      TEST_ASSERT(ptr->id() == sorted[i]);
+      TEST_ASSERT(!ptr->isGhost());
+      TEST_ASSERT(eq(ptr->position()[0], 0.1*sorted[i]));
+      TEST_ASSERT(eq(ptr->velocity()[0], double(sorted[i])));
+   }
+   TEST_ASSERT(map_.find(35) == 0);
+   TEST_ASSERT(storage_.atomReservoir_.size() == storage_.atomCapacity()-4);
+
+   // Newly added atoms use the first free element
+   ptr = storage_.addAtom(35);
+   TEST_ASSERT(ptr == &storage_.atoms_[4]);
+   TEST_ASSERT(storage_.isValid());
+}
+
+void AtomStorageTest::testGrow()
+{
+   printMethod(TEST_FUNC);
+
+   // Fixed capacities by default
+   TEST_ASSERT(!storage_.grow());
+
+   int ids[7] = {53, 35, 18, 44, 17, 2, 71};
+   Atom* ptr;
+   int i;
+   for (i = 0; i < 7; ++i) {
+      ptr = storage_.addAtom(ids[i]);
+      ptr->position() = Vector(0.1*ids[i], 0.5, 0.5);
+   }
+   storage_.removeAtom(map_.find(35));
+   TEST_ASSERT(storage_.nAtom() == 6);
+
+   // Usage of 7 exceeds half of capacity 10, capacity grows to 16
+   storage_.growThreshold_ = 0.5;
+   TEST_ASSERT(storage_.grow());
+   TEST_ASSERT(storage_.atomCapacity() == 16);
+   TEST_ASSERT(storage_.ghostCapacity() == 10);
+   TEST_ASSERT(storage_.nAtom() == 6);
+   TEST_ASSERT(storage_.isValid());
+   TEST_ASSERT(storage_.atomReservoir_.size() == 10);
+   TEST_ASSERT(map_.find(35) == 0);
+   for (i = 0; i < 7; ++i) {
+      if (ids[i] == 35) continue;
+      ptr = map_.find(ids[i]);
+      TEST_ASSERT(ptr != 0);
+      TEST_ASSERT(ptr->id() == ids[i]);
+      TEST_ASSERT(eq(ptr->position()[0], 0.1*ids[i]));
+      TEST_ASSERT(storage_.arrayIndex(*ptr) < 6);
+   }
+
+   // No further growth is needed
+   TEST_ASSERT(!storage_.grow());
+
+   ptr = storage_.addGhost(35);
+   TEST_ASSERT(map_.find(35) == ptr);
+   TEST_ASSERT(storage_.isValid());
+}
+
 TEST_BEGIN(AtomStorageTest)
 TEST_ADD(AtomStorageTest, testReadParam)
 TEST_ADD(AtomStorageTest, testAddAtoms)
@@ -509,6 +597,8 @@ TEST_ADD(AtomStorageTest, testClear)
 TEST_ADD(AtomStorageTest, testIterators)
 TEST_ADD(AtomStorageTest, testSnapshot)
 TEST_ADD(AtomStorageTest, testTransforms)
+TEST_ADD(AtomStorageTest, testSortAtoms)
+TEST_ADD(AtomStorageTest, testGrow)
 TEST_END(AtomStorageTest)
 
 #endif
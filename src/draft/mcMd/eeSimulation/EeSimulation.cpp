@@ -17,6 +17,7 @@
 #include <mcMd/potentials/pair/McPairPotential.h>
 #endif
 #ifdef MCMD_PERTURB
+#include "ExpandedEnsembleMove.h"
 #ifdef UTIL_MPI
 #include <mcMd/perturb/ReplicaMove.h>
 #endif
@@ -51,7 +52,10 @@ namespace McMd
       system_(),
       mcMoveManagerPtr_(0),
       mcAnalyzerManagerPtr_(0),
+      eeMovePtr_(0),
       paramFilePtr_(0),
+      saveFileName_(),
+      saveInterval_(0),
       isInitialized_(false),
       isRestarting_(false)
    {
@@ -59,6 +63,9 @@ namespace McMd
       system().setId(0);
       system().setSimulation(*this);
       system().setFileMaster(fileMaster());
+      #ifdef MCMD_PERTURB
+      system().setExpectPerturbation();
+      #endif
 
       // Create McMove and Analyzer managers
       mcMoveManagerPtr_ = new McMoveManager(*this);
@@ -77,7 +84,10 @@ namespace McMd
       system_(),
       mcMoveManagerPtr_(0),
       mcAnalyzerManagerPtr_(0),
+      eeMovePtr_(0),
       paramFilePtr_(0),
+      saveFileName_(),
+      saveInterval_(0),
       isInitialized_(false),
       isRestarting_(false)
    {
@@ -85,6 +95,9 @@ namespace McMd
       system().setId(0);
       system().setSimulation(*this);
       system().setFileMaster(fileMaster());
+      #ifdef MCMD_PERTURB
+      system().setExpectPerturbation();
+      #endif
 
       // Create McMove and Analyzer managers
       mcMoveManagerPtr_ = new McMoveManager(*this);
@@ -101,6 +114,11 @@ namespace McMd
    {
       delete mcMoveManagerPtr_;
       delete mcAnalyzerManagerPtr_;
+      #ifdef MCMD_PERTURB
+      if (eeMovePtr_) {
+         delete eeMovePtr_;
+      }
+      #endif
    }
 
    /*
@@ -126,6 +144,26 @@ namespace McMd
       // Read Analyzers
       readParamComposite(in, analyzerManager());
 
+      // Read interval and file name for restart files
+      saveInterval_ = 0;
+      readOptional<int>(in, "saveInterval", saveInterval_);
+      if (saveInterval_ > 0) {
+         read<std::string>(in, "saveFileName", saveFileName_);
+      }
+
+      // Read expanded ensemble move
+      #ifdef MCMD_PERTURB
+      if (!system().hasPerturbation()) {
+         UTIL_THROW("EeSimulation requires a Perturbation");
+      }
+      if (!eeMovePtr_) {
+         eeMovePtr_ = new ExpandedEnsembleMove(system());
+      }
+      readParamComposite(in, *eeMovePtr_);
+      #else
+      UTIL_THROW("EeSimulation requires MCMD_PERTURB");
+      #endif
+
       isValid();
       isInitialized_ = true;
       readEnd(in);
@@ -329,10 +367,22 @@ namespace McMd
             }
          }
 
+         // Write restart file
+         if (saveInterval_ > 0) {
+            if (iStep_ % saveInterval_ == 0 && iStep_ > beginStep) {
+               writeRestart(saveFileName_);
+            }
+         }
+
          // Choose and attempt an McMove
          mcMoveManagerPtr_->chooseMove().move();
 
          #ifdef MCMD_PERTURB
+         // Attempt change of expanded ensemble state
+         if (eeMovePtr_->isAtInterval(iStep_)) {
+            eeMovePtr_->move();
+         }
+
          #ifdef UTIL_MPI
          // Attempt replica move, if any.
          if (system().hasPerturbation()) {
@@ -368,6 +418,11 @@ namespace McMd
       // Output results of move statistics to files
       mcMoveManagerPtr_->output();
 
+      #ifdef MCMD_PERTURB
+      // Output expanded ensemble weights and histogram
+      eeMovePtr_->output();
+      #endif
+
       // Output time for the run
       Log::file() << std::endl;
       Log::file() << "endStep       " << endStep << std::endl;
@@ -404,6 +459,16 @@ namespace McMd
       Log::file() << endl;
 
       #ifdef MCMD_PERTURB
+      // Print expanded ensemble acceptance statistics
+      {
+         long nAttempt = eeMovePtr_->nAttempt();
+         long nAccept  = eeMovePtr_->nAccept();
+         double ratio = nAttempt == 0 ? 0.0 : double(nAccept)/double(nAttempt);
+         Log::file() << "Expanded Ensemble "
+                     << Int(nAttempt) << Int(nAccept) << Dbl(ratio)
+                     << "  lnFactor " << Dbl(eeMovePtr_->lnFactor())
+                     << std::endl;
+      }
       #ifdef UTIL_MPI
       // Print replica-exchange acceptance statistics
       if (system().hasPerturbation()) {
@@ -509,6 +574,9 @@ namespace McMd
       ar & iStep_;
       mcMoveManagerPtr_->save(ar);
       mcAnalyzerManagerPtr_->save(ar);
+      #ifdef MCMD_PERTURB
+      eeMovePtr_->save(ar);
+      #endif
       out.close();
    }
 
@@ -533,6 +601,9 @@ namespace McMd
       ar & iStep_;
       mcMoveManagerPtr_->load(ar);
       mcAnalyzerManagerPtr_->load(ar);
+      #ifdef MCMD_PERTURB
+      eeMovePtr_->load(ar);
+      #endif
       in.close();
 
       fileMaster().openParamIFile(filename, ".cmd", in);
@@ -12,6 +12,8 @@
 #include <mcMd/mcSimulation/McSystem.h>   // class member
 #include <util/global.h>
 
+#include <string>
+
 namespace Util { template <typename T> class Factory; }
 
 namespace McMd
@@ -21,11 +23,25 @@ namespace McMd
 
    class McMove;
    class McMoveManager;
-   class EeAnalyzerManager;
+   class McAnalyzerManager;
+   class ExpandedEnsembleMove;
 
    /**
    * An Extended Ensemble Monte-Carlo simulation of one McSystem.
    *
+   * An EeSimulation is an MC simulation of one McSystem in which the
+   * parameters of the system Perturbation are also sampled, by an
+   * ExpandedEnsembleMove that is attempted every interval steps. The
+   * parameter file is that of an McSimulation, with the block label
+   * EeSimulation, followed by an ExpandedEnsembleMove block. A
+   * Perturbation is always expected in the McSystem block, and so
+   * MCMD_PERTURB must be defined.
+   *
+   * If the optional parameter saveInterval is positive, a restart
+   * file with base name saveFileName is written every saveInterval
+   * steps, which contains the adapted weights of the expanded
+   * ensemble move.
+   *
    * \ingroup McMd_Simulation_Module
    */
    class EeSimulation : public Simulation
@@ -173,6 +189,11 @@ namespace McMd
       */
       McMoveManager& mcMoveManager();
 
+      /**
+      * Get the ExpandedEnsembleMove by reference.
+      */
+      ExpandedEnsembleMove& eeMove();
+
    private:
    
       /// System.
@@ -182,11 +203,20 @@ namespace McMd
       McMoveManager* mcMoveManagerPtr_;
 
       /// Pointer to Manager for analyzers.
-      EeAnalyzerManager* mcAnalyzerManagerPtr_;
+      McAnalyzerManager* mcAnalyzerManagerPtr_;
+
+      /// Pointer to expanded ensemble move.
+      ExpandedEnsembleMove* eeMovePtr_;
 
       /// Pointer to parameter file passed to readParam(istream&)
       std::istream*   paramFilePtr_;
 
+      /// Base name of periodic restart files.
+      std::string saveFileName_;
+
+      /// Interval for writing restart files (no output if 0).
+      int saveInterval_;
+
       /// Has readParam been called?
       bool isInitialized_;
 
@@ -218,5 +248,14 @@ namespace McMd
       return *mcMoveManagerPtr_; 
    }
 
+   /*
+   * Get the ExpandedEnsembleMove (protected).
+   */
+   inline ExpandedEnsembleMove& EeSimulation::eeMove()
+   {
+      assert(eeMovePtr_);
+      return *eeMovePtr_;
+   }
+
 }    
 #endif
@@ -0,0 +1,388 @@
+#ifdef MCMD_PERTURB
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ExpandedEnsembleMove.h"
+
+#include <mcMd/perturb/Perturbation.h>
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/simulation/System.h>
+#include <util/random/Random.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+#include <util/misc/FileMaster.h>
+#include <util/misc/Log.h>
+
+#include <fstream>
+#include <cmath>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   ExpandedEnsembleMove::ExpandedEnsembleMove(System& system)
+    : parameters_(),
+      lnWeights_(),
+      histogram_(),
+      dLnWeights_(),
+      dHistogram_(),
+      sendBuffer_(),
+      recvBuffer_(),
+      partner_(),
+      outputFileName_(),
+      systemPtr_(&system),
+      interval_(-1),
+      checkInterval_(1000),
+      nAttempt_(0),
+      nAccept_(0),
+      lnFactor_(1.0),
+      lnFactorMin_(1.0E-6),
+      flatness_(0.8),
+      nState_(0),
+      nParameter_(0),
+      stateId_(0),
+      isAdaptive_(true),
+      shareWeights_(false)
+      #ifdef UTIL_MPI
+      , hasRequest_(false)
+      #endif
+   {
+      // Precondition
+      if (!system.hasPerturbation()) {
+         UTIL_THROW("Parent System has no Perturbation");
+      }
+      setClassName("ExpandedEnsembleMove");
+      nParameter_ = system.perturbation().getNParameters();
+   }
+
+   /*
+   * Destructor.
+   */
+   ExpandedEnsembleMove::~ExpandedEnsembleMove()
+   {}
+
+   /*
+   * Read parameters, allocate arrays and set initial state.
+   */
+   void ExpandedEnsembleMove::readParameters(std::istream& in)
+   {
+      read<long>(in, "interval", interval_);
+      read<int>(in, "nState", nState_);
+      if (nState_ < 2) {
+         UTIL_THROW("nState < 2");
+      }
+      parameters_.allocate(nState_, nParameter_);
+      readDMatrix<double>(in, "parameters", parameters_, nState_, nParameter_);
+      stateId_ = 0;
+      readOptional<int>(in, "initialState", stateId_);
+      lnFactor_ = 1.0;
+      readOptional<double>(in, "lnFactor", lnFactor_);
+      lnFactorMin_ = 1.0E-6;
+      readOptional<double>(in, "lnFactorMin", lnFactorMin_);
+      flatness_ = 0.8;
+      readOptional<double>(in, "flatness", flatness_);
+      checkInterval_ = 1000;
+      readOptional<long>(in, "checkInterval", checkInterval_);
+      shareWeights_ = false;
+      readOptional<bool>(in, "shareWeights", shareWeights_);
+      read<std::string>(in, "outputFileName", outputFileName_);
+      validate();
+
+      allocate();
+      for (int i = 0; i < nState_; ++i) {
+         lnWeights_[i] = 0.0;
+         histogram_[i] = 0.0;
+      }
+      isAdaptive_ = (lnFactor_ >= lnFactorMin_);
+      setState(stateId_);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void ExpandedEnsembleMove::loadParameters(Serializable::IArchive& ar)
+   {
+      loadParameter<long>(ar, "interval", interval_);
+      loadParameter<int>(ar, "nState", nState_);
+      parameters_.allocate(nState_, nParameter_);
+      loadDMatrix<double>(ar, "parameters", parameters_, nState_, nParameter_);
+      stateId_ = 0;
+      loadParameter<int>(ar, "initialState", stateId_, false);
+      lnFactor_ = 1.0;
+      loadParameter<double>(ar, "lnFactor", lnFactor_, false);
+      lnFactorMin_ = 1.0E-6;
+      loadParameter<double>(ar, "lnFactorMin", lnFactorMin_, false);
+      flatness_ = 0.8;
+      loadParameter<double>(ar, "flatness", flatness_, false);
+      checkInterval_ = 1000;
+      loadParameter<long>(ar, "checkInterval", checkInterval_, false);
+      shareWeights_ = false;
+      loadParameter<bool>(ar, "shareWeights", shareWeights_, false);
+      loadParameter<std::string>(ar, "outputFileName", outputFileName_);
+      validate();
+
+      allocate();
+      ar >> lnWeights_;
+      ar >> histogram_;
+      ar >> isAdaptive_;
+      ar >> nAttempt_;
+      ar >> nAccept_;
+      setState(stateId_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   *
+   * The current state and lnFactor are saved as the values of the
+   * optional initialState and lnFactor parameters.
+   */
+   void ExpandedEnsembleMove::save(Serializable::OArchive& ar)
+   {
+      flush();
+      ar << interval_;
+      ar << nState_;
+      ar << parameters_;
+      Parameter::saveOptional(ar, stateId_, true);
+      Parameter::saveOptional(ar, lnFactor_, true);
+      Parameter::saveOptional(ar, lnFactorMin_, true);
+      Parameter::saveOptional(ar, flatness_, true);
+      Parameter::saveOptional(ar, checkInterval_, true);
+      Parameter::saveOptional(ar, shareWeights_, true);
+      ar << outputFileName_;
+      ar << lnWeights_;
+      ar << histogram_;
+      ar << isAdaptive_;
+      ar << nAttempt_;
+      ar << nAccept_;
+   }
+
+   /*
+   * Validate parameters.
+   */
+   void ExpandedEnsembleMove::validate() const
+   {
+      if (interval_ <= 0) {
+         UTIL_THROW("interval <= 0");
+      }
+      if (nState_ < 2) {
+         UTIL_THROW("nState < 2");
+      }
+      if (stateId_ < 0 || stateId_ >= nState_) {
+         UTIL_THROW("Invalid initialState");
+      }
+      if (lnFactor_ < 0.0 || lnFactorMin_ <= 0.0) {
+         UTIL_THROW("Invalid lnFactor or lnFactorMin");
+      }
+      if (flatness_ <= 0.0 || flatness_ >= 1.0) {
+         UTIL_THROW("flatness must lie in (0, 1)");
+      }
+      if (checkInterval_ <= 0) {
+         UTIL_THROW("checkInterval <= 0");
+      }
+      #ifndef UTIL_MPI
+      if (shareWeights_) {
+         UTIL_THROW("shareWeights requires UTIL_MPI");
+      }
+      #endif
+   }
+
+   /*
+   * Allocate arrays.
+   */
+   void ExpandedEnsembleMove::allocate()
+   {
+      lnWeights_.allocate(nState_);
+      histogram_.allocate(nState_);
+      dLnWeights_.allocate(nState_);
+      dHistogram_.allocate(nState_);
+      sendBuffer_.allocate(2*nState_);
+      recvBuffer_.allocate(2*nState_);
+      partner_.allocate(nParameter_);
+      for (int i = 0; i < nState_; ++i) {
+         dLnWeights_[i] = 0.0;
+         dHistogram_[i] = 0.0;
+      }
+   }
+
+   /*
+   * Set perturbation parameters of the parent System.
+   */
+   void ExpandedEnsembleMove::setState(int id)
+   {
+      for (int i = 0; i < nParameter_; ++i) {
+         partner_[i] = parameters_(id, i);
+      }
+      systemPtr_->perturbation().setParameter(partner_);
+      stateId_ = id;
+   }
+
+   /*
+   * Attempt a change of state to a neighbor.
+   */
+   bool ExpandedEnsembleMove::move()
+   {
+      Random& random = systemPtr_->simulation().random();
+      bool accept = false;
+      ++nAttempt_;
+
+      int j = stateId_ + 2*random.uniformInt(0, 2) - 1;
+      if (j >= 0 && j < nState_) {
+         for (int i = 0; i < nParameter_; ++i) {
+            partner_[i] = parameters_(j, i);
+         }
+         double dW = systemPtr_->perturbation().difference(partner_);
+         double lnRatio = -dW + lnWeights_[stateId_] - lnWeights_[j];
+         accept = random.metropolis(exp(lnRatio));
+         if (accept) {
+            systemPtr_->perturbation().setParameter(partner_);
+            stateId_ = j;
+            ++nAccept_;
+         }
+      }
+
+      // Record visit of the current state
+      if (isAdaptive_) {
+         lnWeights_[stateId_] += lnFactor_;
+      }
+      if (shareWeights_) {
+         if (isAdaptive_) {
+            dLnWeights_[stateId_] += lnFactor_;
+         }
+         dHistogram_[stateId_] += 1.0;
+      } else {
+         histogram_[stateId_] += 1.0;
+      }
+
+      if (nAttempt_ % checkInterval_ == 0) {
+         update();
+      }
+      return accept;
+   }
+
+   /*
+   * Merge increments with other walkers, then check flatness.
+   *
+   * With shareWeights, the reduction posted here is completed by the
+   * next call, so the flatness check uses the histogram merged at the
+   * previous interval, which is identical on all walkers.
+   */
+   void ExpandedEnsembleMove::update()
+   {
+      #ifdef UTIL_MPI
+      if (shareWeights_) {
+         completeMerge();
+         checkFlatness();
+         for (int i = 0; i < nState_; ++i) {
+            sendBuffer_[i] = dLnWeights_[i];
+            sendBuffer_[nState_ + i] = dHistogram_[i];
+            dLnWeights_[i] = 0.0;
+            dHistogram_[i] = 0.0;
+         }
+         MPI::Intracomm& communicator = systemPtr_->simulation().communicator();
+         #if MPI_VERSION >= 3
+         MPI_Iallreduce(&sendBuffer_[0], &recvBuffer_[0], 2*nState_,
+                        MPI_DOUBLE, MPI_SUM, (MPI_Comm)communicator,
+                        &request_);
+         hasRequest_ = true;
+         #else
+         communicator.Allreduce(&sendBuffer_[0], &recvBuffer_[0],
+                                2*nState_, MPI::DOUBLE, MPI::SUM);
+         hasRequest_ = true;
+         completeMerge();
+         #endif
+         return;
+      }
+      #endif
+      checkFlatness();
+   }
+
+   /*
+   * Complete a pending merge, adding increments of other walkers.
+   */
+   void ExpandedEnsembleMove::completeMerge()
+   {
+      #ifdef UTIL_MPI
+      if (hasRequest_) {
+         #if MPI_VERSION >= 3
+         MPI_Wait(&request_, MPI_STATUS_IGNORE);
+         #endif
+         for (int i = 0; i < nState_; ++i) {
+            // Own weight increments were applied when they were made
+            lnWeights_[i] += recvBuffer_[i] - sendBuffer_[i];
+            histogram_[i] += recvBuffer_[nState_ + i];
+         }
+         hasRequest_ = false;
+      }
+      #endif
+   }
+
+   /*
+   * Complete any pending merge (call at end of run).
+   */
+   void ExpandedEnsembleMove::flush()
+   {  completeMerge(); }
+
+   /*
+   * Reduce lnFactor and reset histogram if the histogram is flat.
+   */
+   void ExpandedEnsembleMove::checkFlatness()
+   {
+      if (!isAdaptive_) return;
+
+      double min = histogram_[0];
+      double sum = 0.0;
+      for (int i = 0; i < nState_; ++i) {
+         if (histogram_[i] < min) min = histogram_[i];
+         sum += histogram_[i];
+      }
+      double mean = sum/double(nState_);
+      if (mean > 0.0 && min > flatness_*mean) {
+         lnFactor_ *= 0.5;
+         for (int i = 0; i < nState_; ++i) {
+            histogram_[i] = 0.0;
+         }
+         if (lnFactor_ < lnFactorMin_) {
+            isAdaptive_ = false;
+         }
+         Log::file() << "ExpandedEnsembleMove: lnFactor = "
+                     << Dbl(lnFactor_) << " at attempt "
+                     << Int(nAttempt_) << std::endl;
+      }
+   }
+
+   /*
+   * Output parameters, weights, free energies and histogram of states.
+   */
+   void ExpandedEnsembleMove::output()
+   {
+      flush();
+      std::ofstream file;
+      systemPtr_->fileMaster().openOutputFile(outputFileName_, file);
+      file << "nAttempt  " << nAttempt_ << std::endl;
+      file << "nAccept   " << nAccept_ << std::endl;
+      file << "lnFactor  " << lnFactor_ << std::endl;
+      file << "adaptive  " << isAdaptive_ << std::endl;
+      file << std::endl;
+      int i, j;
+      for (i = 0; i < nState_; ++i) {
+         file << Int(i, 5);
+         for (j = 0; j < nParameter_; ++j) {
+            file << Dbl(parameters_(i, j));
+         }
+         file << Dbl(lnWeights_[i], 20, 10)
+              << Dbl(-(lnWeights_[i] - lnWeights_[0]), 20, 10)
+              << Dbl(histogram_[i]) << std::endl;
+      }
+      file.close();
+   }
+
+}
+#endif // ifdef MCMD_PERTURB
@@ -0,0 +1,306 @@
+#ifdef MCMD_PERTURB
+#ifndef MCMD_EXPANDED_ENSEMBLE_MOVE_H
+#define MCMD_EXPANDED_ENSEMBLE_MOVE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h> // base class
+#include <util/containers/DArray.h>    // member
+#include <util/containers/DMatrix.h>   // member
+#include <util/global.h>
+
+#include <string>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class System;
+
+   /**
+   * Expanded ensemble move with Wang-Landau adaptation of state weights.
+   *
+   * An ExpandedEnsembleMove samples the index of a perturbation state
+   * of a single system, from a list of nState sets of perturbation
+   * parameters. Each attempt proposes a change of state to a randomly
+   * chosen neighbor, i -> i +/- 1, and accepts it with probability
+   * min{1, exp(-dW + lnWeight[i] - lnWeight[j])}, where dW is the change
+   * in the Boltzmann weight W(X,p) computed by the Perturbation of the
+   * parent System for the current configuration X. A single run thus
+   * visits every state along a path of perturbation parameters (e.g.,
+   * a lambda path), and the converged lnWeight[i] gives the free energy
+   * of state i relative to state 0 as -(lnWeight[i] - lnWeight[0]).
+   *
+   * Weights are adapted by the Wang-Landau algorithm: after every
+   * attempt, lnWeight of the current state is incremented by lnFactor,
+   * and the visit histogram is incremented by one. Every checkInterval
+   * attempts, if the smallest histogram entry exceeds flatness times
+   * the mean, lnFactor is halved and the histogram is reset. Adaptation
+   * stops when lnFactor falls below lnFactorMin, after which weights
+   * are fixed and the histogram records the expanded ensemble sampling.
+   *
+   * If the optional parameter shareWeights is true (and UTIL_MPI is
+   * defined), each processor of the simulation communicator is an
+   * independent walker that shares lnWeight and the histogram with all
+   * others. Increments accumulated since the previous merge are summed
+   * over walkers every checkInterval attempts by a nonblocking reduction
+   * (MPI_Iallreduce, if MPI-3 is available) that is completed at the
+   * next merge, so walkers never wait for each other between merges.
+   * The merged histogram is identical on all walkers, so all walkers
+   * reduce lnFactor at the same merge.
+   *
+   * The state, weights, histogram and lnFactor are saved to and loaded
+   * from restart archives, so an adaptive run may be continued.
+   *
+   * \ingroup McMd_Perturb_Module
+   */
+   class ExpandedEnsembleMove : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \pre System must have a Perturbation.
+      *
+      * \param system parent System
+      */
+      ExpandedEnsembleMove(System& system);
+
+      /**
+      * Destructor.
+      */
+      virtual ~ExpandedEnsembleMove();
+
+      /**
+      * Read parameters and set the initial perturbation state.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /**
+      * Attempt a change of state, and update weights if adaptive.
+      *
+      * \return true if the state changed, false otherwise
+      */
+      bool move();
+
+      /**
+      * Complete any pending merge of weights among walkers.
+      *
+      * Call on all walkers at the end of a run, before output.
+      */
+      void flush();
+
+      /**
+      * Output state parameters, weights and histogram to file.
+      */
+      void output();
+
+      /**
+      * Return true iff counter is a multiple of the interval.
+      *
+      * \param counter simulation step counter
+      */
+      bool isAtInterval(long counter) const;
+
+      /**
+      * Index of current perturbation state.
+      */
+      int stateId() const;
+
+      /**
+      * Current Wang-Landau modification factor (ln f).
+      */
+      double lnFactor() const;
+
+      /**
+      * Are weights still being adapted?
+      */
+      bool isAdaptive() const;
+
+      /**
+      * Number of attempted state changes.
+      */
+      long nAttempt() const;
+
+      /**
+      * Number of accepted state changes.
+      */
+      long nAccept() const;
+
+   private:
+
+      /// Perturbation parameters of all states (nState x nParameter).
+      DMatrix<double> parameters_;
+
+      /// Logarithm of weight of each state (Wang-Landau ln g).
+      DArray<double> lnWeights_;
+
+      /// Histogram of visits since last reset (merged over walkers).
+      DArray<double> histogram_;
+
+      /// Local increments of lnWeights_ since last merge.
+      DArray<double> dLnWeights_;
+
+      /// Local increments of histogram_ since last merge.
+      DArray<double> dHistogram_;
+
+      /// Send buffer for merge (weights, then histogram increments).
+      DArray<double> sendBuffer_;
+
+      /// Receive buffer for merge.
+      DArray<double> recvBuffer_;
+
+      /// Parameters of a proposed state.
+      DArray<double> partner_;
+
+      /// Output file name.
+      std::string outputFileName_;
+
+      /// Pointer to parent System.
+      System* systemPtr_;
+
+      /// Number of steps between attempts.
+      long interval_;
+
+      /// Number of attempts between flatness checks and merges.
+      long checkInterval_;
+
+      /// Number of attempted state changes.
+      long nAttempt_;
+
+      /// Number of accepted state changes.
+      long nAccept_;
+
+      /// Wang-Landau modification factor ln f.
+      double lnFactor_;
+
+      /// Adaptation stops when lnFactor_ < lnFactorMin_.
+      double lnFactorMin_;
+
+      /// Minimum ratio of smallest histogram entry to mean.
+      double flatness_;
+
+      /// Number of states.
+      int nState_;
+
+      /// Number of perturbation parameters per state.
+      int nParameter_;
+
+      /// Index of current state.
+      int stateId_;
+
+      /// Are weights still being adapted?
+      bool isAdaptive_;
+
+      /// Share weights among all walkers in the communicator?
+      bool shareWeights_;
+
+      #ifdef UTIL_MPI
+      /// Is a nonblocking merge in progress?
+      bool hasRequest_;
+
+      #if MPI_VERSION >= 3
+      /// Request for nonblocking merge.
+      MPI_Request request_;
+      #endif
+      #endif
+
+      /**
+      * Allocate arrays, after nState_ and nParameter_ are known.
+      */
+      void allocate();
+
+      /**
+      * Set perturbation parameters of the System to those of a state.
+      *
+      * \param id index of state
+      */
+      void setState(int id);
+
+      /**
+      * Merge increments with other walkers, and check flatness.
+      */
+      void update();
+
+      /**
+      * Complete a pending merge and add increments of other walkers.
+      */
+      void completeMerge();
+
+      /**
+      * Halve lnFactor and reset histogram if histogram is flat.
+      */
+      void checkFlatness();
+
+      /**
+      * Validate parameters.
+      */
+      void validate() const;
+
+   };
+
+   // Inline methods
+
+   /*
+   * Return true iff counter is a multiple of the interval.
+   */
+   inline bool ExpandedEnsembleMove::isAtInterval(long counter) const
+   {  return (counter%interval_ == 0); }
+
+   /*
+   * Index of current state.
+   */
+   inline int ExpandedEnsembleMove::stateId() const
+   {  return stateId_; }
+
+   /*
+   * Current Wang-Landau modification factor.
+   */
+   inline double ExpandedEnsembleMove::lnFactor() const
+   {  return lnFactor_; }
+
+   /*
+   * Are weights being adapted?
+   */
+   inline bool ExpandedEnsembleMove::isAdaptive() const
+   {  return isAdaptive_; }
+
+   /*
+   * Number of attempted state changes.
+   */
+   inline long ExpandedEnsembleMove::nAttempt() const
+   {  return nAttempt_; }
+
+   /*
+   * Number of accepted state changes.
+   */
+   inline long ExpandedEnsembleMove::nAccept() const
+   {  return nAccept_; }
+
+}
+#endif
+#endif // ifdef MCMD_PERTURB
@@ -1,6 +1,6 @@
-
 mcMd_eeSimulation_SRCS=\
-     EeSimulation.cpp
+     EeSimulation.cpp \
+     ExpandedEnsembleMove.cpp
 
 #    $(SRC_DIR)/mcMd/eeSimulation/EeSimulation.cpp 
 
@@ -6,9 +6,18 @@
 */
 
 #include <msDd/simulation/Simulation.h>       // class header
-#include <mcMd/mcSimulation/McSimulation.h>                    
-#include <ddMd/system/System.h>       
-//#include <ddMd/communicator/GroupCollector_inc.h>
+#include <mcMd/mcSimulation/McSimulation.h>
+#include <mcMd/mcSimulation/McSystem.h>
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/integrators/Integrator.h>
+#include <ddMd/communicate/Buffer.h>
+#include <util/misc/FileMaster.h>
+#include <util/misc/Log.h>
+#include <util/mpi/MpiSendRecv.h>
+#include <util/misc/ioUtil.h>
+
+#include <fstream>
+#include <sstream>
 
 namespace MsDd
 {
@@ -16,88 +25,200 @@ namespace MsDd
    /*
    * Constructor.
    */
-   Simulation::Simulation(MPI::Intracomm& ddCommunicator)
-    : ddCommunicatorPtr_(&ddCommunicator),
-      mcSimulationPtr_(0),
-      ddSystemPtr_(0),
+   Simulation::Simulation(MPI::Intracomm& communicator)
+    : mcSimulationPtr_(0),
+      ddSimulationPtr_(0),
+      communicatorPtr_(&communicator),
+      transferFileName_(),
+      temperature_(1.0),
+      hasMcStarted_(false),
       isDdMaster_(false)
    {
+      setClassName("MsDdSimulation");
       if (!MPI::Is_initialized()) {
          UTIL_THROW("MPI is not initialized");
       }
-      int myRank = ddCommunicator.Get_rank();
-      if (myRank == 0) {
+      setIoCommunicator(communicator);
+      if (communicator.Get_rank() == 0) {
          isDdMaster_ = true;
          mcSimulationPtr_ = new McMd::McSimulation();
       }
-      ddSystemPtr_ = new DdMd::System(*mcSimulationPtr_, ddCommunicator);
+      ddSimulationPtr_ = new DdMd::Simulation(communicator);
    }
 
+   /*
+   * Destructor.
+   */
    Simulation::~Simulation()
    {
-      int myRank = ddCommunicatorPtr_->Get_rank();
-      if (isDdMaster_) {
-         if (mcSimulationPtr_) {
-            delete mcSimulationPtr_;
-         }
+      if (mcSimulationPtr_) {
+         delete mcSimulationPtr_;
       }
-      if (ddSystemPtr_) {
-         delete ddSystemPtr_;
+      if (ddSimulationPtr_) {
+         delete ddSimulationPtr_;
       }
    }
-   
+
    /*
-   * Initialize parent McMd::McSimulation and DdMd::System
-   *
-   * On master:
-   *    Call McMd::McSimulation::readParam().
-   *    Generate param file for DdMd::System.
-   *    Send signal to read file.
-   *    Call DdMd::System::readParam().
-   * On all processors:
-   *    Receive signal to read file.
-   *    Call DdMd::System::readParam().
+   * Read parameters of both engines (McSimulation only on master).
    */
-   void Simulation::readParam(std::istream& in)
+   void Simulation::readParameters(std::istream& in)
    {
-      Util::ParamComponent::setEcho(true);
-      readBegin(in, "Master");
       if (isDdMaster_) {
          readParamComposite(in, *mcSimulationPtr_);
+         std::string className("DdMdConfigIo");
+         mcSimulationPtr_->system().setConfigIo(className);
       }
-      readParamComposite(in, *ddSystemPtr_);
-      readEnd(in);
+      readParamComposite(in, *ddSimulationPtr_);
+      read<std::string>(in, "transferFileName", transferFileName_);
+      read<double>(in, "temperature", temperature_);
    }
 
    /*
-   * Read and broadcast commands.
-   *
-   * Call only on master processor. Implements main
-   * command loop for master processor.
+   * Read and execute commands from the default command file.
    */
    void Simulation::readCommands()
-   {}
+   {
+      DdMd::Simulation& ddSim = ddSimulation();
+      if (ddSim.fileMaster().commandFileName().empty()) {
+         UTIL_THROW("Empty command file name");
+      }
+      readCommands(ddSim.fileMaster().commandFile());
+   }
+
+   /*
+   * Read and execute commands, broadcasting each line from the master.
+   */
+   void Simulation::readCommands(std::istream& in)
+   {
+      DdMd::Simulation& ddSim = ddSimulation();
+      std::string command;
+      std::string filename;
+      std::string line;
+      std::stringstream inBuffer;
+
+      bool readNext = true;
+      while (readNext) {
+
+         // Read line on master and broadcast to all processors
+         if (isDdMaster_) {
+            getNextLine(in, line);
+            Log::file() << line << std::endl;
+         }
+         bcast<std::string>(*communicatorPtr_, line, 0);
+         inBuffer.clear();
+         inBuffer.str(line);
+
+         inBuffer >> command;
+         if (command == "READ_CONFIG") {
+            // Read into the MD engine, then copy to the McSimulation
+            inBuffer >> filename;
+            ddSim.clearConfig();
+            ddSim.readConfig(filename);
+            mdToMc();
+         } else
+         if (command == "SIMULATE") {
+            int nCycle, nMcStep, nMdStep;
+            inBuffer >> nCycle >> nMcStep >> nMdStep;
+            simulate(nCycle, nMcStep, nMdStep);
+         } else
+         if (command == "WRITE_CONFIG") {
+            inBuffer >> filename;
+            ddSim.writeConfig(filename);
+         } else
+         if (command == "FINISH") {
+            readNext = false;
+            ddSim.buffer().clearChannels();
+         } else {
+            if (isDdMaster_) {
+               Log::file() << "  Error: Unknown command  " << std::endl;
+            }
+            readNext = false;
+         }
+      }
+   }
 
    /*
-   * Receive commands from master processor.
-   *
-   * Call only on slave processor. Allows master to control
-   * action of slaves. Implements main loop for slaves.
+   * Run nCycle cycles of MC steps on master and parallel MD steps.
    */
-   void Simulation::receiveCommands()
-   {}
+   void Simulation::simulate(int nCycle, int nMcStep, int nMdStep)
+   {
+      DdMd::Simulation& ddSim = ddSimulation();
+      for (int iCycle = 0; iCycle < nCycle; ++iCycle) {
+         if (isDdMaster_ && nMcStep > 0) {
+            McMd::McSimulation& mcSim = mcSimulation();
+            if (hasMcStarted_) {
+               mcSim.simulate(mcSim.iStep() + nMcStep, true);
+            } else {
+               mcSim.simulate(nMcStep, false);
+               hasMcStarted_ = true;
+            }
+         }
+         mcToMd();
+         if (nMdStep > 0) {
+            ddSim.integrator().run(nMdStep);
+         }
+         mdToMc();
+      }
+   }
 
    /*
-   * Distribute atoms and groups from master to slaves.
+   * Copy MC configuration to the MD engine, and resample velocities.
    */
-   void Simulation::distribute()
-   {}
+   void Simulation::mcToMd()
+   {
+      DdMd::Simulation& ddSim = ddSimulation();
+      std::ofstream outFile;
+      if (isDdMaster_) {
+         outFile.open(transferFileName_.c_str());
+         if (outFile.fail()) {
+            UTIL_THROW("Error opening configuration transfer file");
+         }
+         mcSimulation().system().writeConfig(outFile);
+         outFile.close();
+      }
+
+      std::ifstream inFile;
+      if (isDdMaster_) {
+         inFile.open(transferFileName_.c_str());
+         if (inFile.fail()) {
+            UTIL_THROW("Error opening configuration transfer file");
+         }
+      }
+      ddSim.clearConfig();
+      ddSim.readConfig(inFile);
+      if (isDdMaster_) {
+         inFile.close();
+      }
+      ddSim.setBoltzmannVelocities(temperature_);
+      ddSim.removeDriftVelocity();
+   }
 
    /*
-   * Collect atoms from master to slaves.
+   * Collect MD configuration and copy it to the McSimulation.
    */
-   void Simulation::collect()
-   {}
+   void Simulation::mdToMc()
+   {
+      std::ofstream outFile;
+      if (isDdMaster_) {
+         outFile.open(transferFileName_.c_str());
+         if (outFile.fail()) {
+            UTIL_THROW("Error opening configuration transfer file");
+         }
+      }
+      ddSimulation().writeConfig(outFile);
+      if (isDdMaster_) {
+         outFile.close();
 
+         McMd::McSystem& system = mcSimulation().system();
+         std::ifstream inFile(transferFileName_.c_str());
+         if (inFile.fail()) {
+            UTIL_THROW("Error opening configuration transfer file");
+         }
+         system.removeAllMolecules();
+         system.readConfig(inFile);
+         inFile.close();
+      }
+   }
 
 }
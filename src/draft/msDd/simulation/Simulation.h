@@ -9,19 +9,16 @@
 */
 
 #include <util/param/ParamComposite.h>           // base class
+#include <util/global.h>
 
-//#include <ddMd/communicate/AtomDistributor.h>    // member
-//#include <ddMd/communicate/GroupDistributor.h>   // member
-//#include <ddMd/communicate/AtomCollector.h>      // member
-//#include <ddMd/communicate/GroupCollector.h>     // member
-
+#include <string>
 
 namespace McMd {
    class McSimulation;
 }
 
 namespace DdMd {
-   class System;
+   class Simulation;
 }
 
 namespace MsDd
@@ -30,22 +27,33 @@ namespace MsDd
    using namespace Util;
 
    /**
-   * Main object in master-slave simulation.
+   * Main object in a hybrid master-slave MC / parallel MD simulation.
    *
-   * A MsDd::Simulation object is the main object in a simulation
-   * in which a McMd::McSimulation MC simulation, which exists 
-   * only on the master node, controls a parallel DdMd::System
-   * molecular dynamics simulation.
+   * A MsDd::Simulation object is the main object in a simulation in
+   * which a McMd::McSimulation Monte Carlo simulation, which exists
+   * only on the master processor, alternates with a parallel
+   * DdMd::Simulation molecular dynamics simulation that runs on all
+   * processors of a communicator.
    *
-   * Usage:
+   * Each cycle of a hybrid simulation consists of an MC phase, in
+   * which MC moves are applied to the full configuration held by the
+   * McSimulation on the master, followed by an MD phase, in which the
+   * configuration is distributed among all processors and integrated
+   * by the DdMd::Simulation. Configurations are transferred between
+   * the two engines through a file in DdMd configuration file format,
+   * which is written and read only by the master. Atom types may be
+   * changed by MC moves (e.g., semigrand identity swaps), but the
+   * number of molecules of each species must equal its capacity in
+   * the McSimulation. Atomic velocities are resampled from a Boltzmann
+   * distribution at the beginning of each MD phase.
    *
-   * Simulation sim(MPI::WORLD_COMM);
-   * sim.readParam(std::cin);
-   * if (sim.isMaster()) {
-   *    sim.readCommands();
-   * } else {
-   *    sim.receiveCommands();
-   * }
+   * Usage:
+   * \code
+   * MsDd::Simulation sim(MPI::COMM_WORLD);
+   * sim.readParam(paramFile);
+   * sim.readCommands();
+   * \endcode
+   * Both functions must be called on all processors.
    */
    class Simulation : public ParamComposite
    {
@@ -54,8 +62,10 @@ namespace MsDd
 
       /**
       * Constructor.
+      *
+      * \param communicator MPI communicator for the DdMd simulation
       */
-      Simulation(MPI::Intracomm& ddCommunicator = MPI::COMM_WORLD);
+      Simulation(MPI::Intracomm& communicator = MPI::COMM_WORLD);
 
       /**
       * Destructor.
@@ -63,54 +73,69 @@ namespace MsDd
       ~Simulation();
 
       /**
-      * Initialize parent McMd::McSimulation and DdMd::System
+      * Read parameters of both engines and of the hybrid cycle.
+      *
+      * Reads a McSimulation block (used only on the master), a DdMd
+      * Simulation block, the name of the configuration transfer file
+      * and the MD temperature. Call on all processors.
       *
-      * On master:
-      *    Call McMd::McSimulation::readParam().
-      *    Generate param file for DdMd::System.
-      *    Send signal to read file.
-      *    Call DdMd::System::readParam().
-      * On all processors:
-      *    Receive signal to read file.
-      *    Call DdMd::System::readParam().
+      * \param in parameter file stream (used only on master)
       */
-      virtual void readParam(std::istream& in);
+      virtual void readParameters(std::istream& in);
 
       /**
-      * Read and broadcast commands.
+      * Read and execute commands from the default command file.
       *
-      * Call only on master processor. Implements main
-      * command loop for master processor.
+      * Call on all processors.
       */
       void readCommands();
 
       /**
-      * Receive commands from master processor.
+      * Read and execute commands from a command file.
+      *
+      * Call on all processors. Each command line is read on the master
+      * and broadcast to all other processors.
       *
-      * Call only on slave processor. Allows master to control
-      * action of slaves. Implements main loop for slaves.
+      * \param in command file stream (used only on master)
       */
-      void receiveCommands();
+      void readCommands(std::istream& in);
 
       /**
-      * Distribute atoms and groups from master to slaves.
+      * Run a hybrid simulation.
+      *
+      * Each of nCycle cycles consists of nMcStep MC steps on the master,
+      * followed by nMdStep parallel MD steps. Upon return, both engines
+      * hold the configuration produced by the final MD phase.
+      *
+      * \param nCycle  number of MC/MD cycles
+      * \param nMcStep number of MC steps per cycle
+      * \param nMdStep number of MD steps per cycle
       */
-      void distribute();
+      void simulate(int nCycle, int nMcStep, int nMdStep);
 
       /**
-      * Collect atoms from master to slaves.
+      * Copy the configuration of the McSimulation to the MD engine.
+      *
+      * Call on all processors.
       */
-      void collect();
+      void mcToMd();
 
       /**
-      * Return McMd::McSimulation (valid only on master)
+      * Copy the configuration of the MD engine to the McSimulation.
+      *
+      * Call on all processors.
+      */
+      void mdToMc();
+
+      /**
+      * Return McMd::McSimulation (valid only on master).
       */
       McMd::McSimulation& mcSimulation();
 
       /**
-      * Return DdMd::System (valid on any processor)
+      * Return DdMd::Simulation (valid on any processor).
       */
-      DdMd::System& ddMdSystem();
+      DdMd::Simulation& ddSimulation();
 
       /**
       * Is this the master node in the intracommunicator?
@@ -122,19 +147,22 @@ namespace MsDd
       /// Parent McSimulation (exists only on master).
       McMd::McSimulation* mcSimulationPtr_;
 
-      /// Slave parallel MD System (exists on all modes).
-      DdMd::System*       ddSystemPtr_;
+      /// Parallel MD simulation (exists on all processors).
+      DdMd::Simulation* ddSimulationPtr_;
 
-      //DdMd::AtomDistributor     atomDistributor_;
-      //DdMd::GroupDistributor<2> bondDistributor_;
+      /// Intracommunicator for DdMd simulation.
+      MPI::Intracomm* communicatorPtr_;
 
-      //DdMd::AtomCollector       atomCollector_;
-      //DdMd::GroupCollector<2>   bondCollector_;
+      /// Name of file used to transfer configurations.
+      std::string transferFileName_;
 
-      /// Intracommunicator for DdMd simulation.
-      MPI::Intracomm* ddCommunicatorPtr_;
+      /// Temperature used to resample velocities before each MD phase.
+      double temperature_;
 
-      /// Is this the master (rank = 0) node of the ddCommunicator?
+      /// Has the McSimulation been run before (continue step counter)?
+      bool hasMcStarted_;
+
+      /// Is this the master (rank = 0) node of the communicator?
       bool isDdMaster_;
 
    };
@@ -144,19 +172,22 @@ namespace MsDd
    */
    inline
    McMd::McSimulation& Simulation::mcSimulation()
-   {   return *mcSimulationPtr_; }
+   {
+      assert(mcSimulationPtr_);
+      return *mcSimulationPtr_;
+   }
 
-   /**
-   * Return DdMd::System (valid on any processor)
+   /*
+   * Return DdMd::Simulation (valid on any processor)
    */
-   inline 
-   DdMd::System& Simulation::ddMdSystem()
-   {  return *ddSystemPtr_; }
+   inline
+   DdMd::Simulation& Simulation::ddSimulation()
+   {  return *ddSimulationPtr_; }
 
-   /**
+   /*
    * Is this the master node in the intracommunicator?
    */
-   inline 
+   inline
    bool Simulation::isDdMaster() const
    {  return isDdMaster_; }
 
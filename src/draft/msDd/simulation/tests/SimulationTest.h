@@ -2,6 +2,8 @@
 #define MSDD_SIMULATION_TEST_H
 
 #include <msDd/simulation/Simulation.h>
+#include <ddMd/simulation/Simulation.h>
+#include <ddMd/communicate/Buffer.h>
 
 #ifdef UTIL_MPI
 #define TEST_MPI
@@ -37,14 +39,13 @@ inline void SimulationTest::testReadParam()
    std::ifstream paramFile;
    if (mpiRank() == 0) {
       openInputFile("in/param", paramFile); 
-      simulation.readParam(paramFile); 
-      //if (verbose() > 0) {
+   }
+   simulation.readParam(paramFile);
+   if (verbose() > 0 && mpiRank() == 0) {
       simulation.writeParam(std::cout);
-      //}
    }
-   // TEST_ASSERT(simulation.buffer().isAllocated())
-   //TEST_ASSERT(simulation.domain().isInitialized());
-   //TEST_ASSERT(simulation.domain().hasBoundary());
+   TEST_ASSERT(simulation.isDdMaster() == (mpiRank() == 0));
+   TEST_ASSERT(simulation.ddSimulation().buffer().isAllocated());
 }
 
 TEST_BEGIN(SimulationTest)
@@ -0,0 +1,60 @@
+#-----------------------------------------------------------------------
+# Python interface to the simpatico mdPp post-processor
+#
+# Arrays returned by the Processor methods positions(), typeIds(), ids()
+# and bonds() refer directly to the memory of the Tools::Configuration,
+# without copying. Positions are updated in place by readFrame(), so an
+# array obtained once shows each new frame. Arrays must not be used after
+# a later readConfig(), which may reallocate the underlying storage.
+#
+# Example:
+#
+#    import mdpp
+#    p = mdpp.Processor('param')
+#    p.setConfigReader('DdMdConfigReader')
+#    p.readConfig('config')
+#    p.setTrajectoryReader('DdMdTrajectoryReader')
+#    for r in mdpp.frames(p, 'traj.trj'):
+#        print(r.mean(axis=0))
+#-----------------------------------------------------------------------
+
+import numpy
+
+import _mdpp
+
+class Processor(_mdpp.Processor):
+
+    def __init__(self, paramFile=None):
+        if paramFile is not None:
+            self.readParam(paramFile)
+
+    def positionArray(self):
+        """Return positions as an (nAtom, 3) numpy array (no copy)."""
+        return numpy.asarray(self.positions())
+
+    def typeIdArray(self):
+        """Return atom type ids as an (nAtom,) numpy array (no copy)."""
+        return numpy.asarray(self.typeIds())
+
+    def idArray(self):
+        """Return atom ids as an (nAtom,) numpy array (no copy)."""
+        return numpy.asarray(self.ids())
+
+    def bondArray(self):
+        """Return bond atom ids as an (nBond, 2) numpy array (no copy)."""
+        return numpy.asarray(self.bonds())
+
+def frames(processor, filename):
+    """
+    Iterate over the frames of a trajectory file.
+
+    Yields the same (nAtom, 3) position array for each frame, after
+    the frame has been read into it.
+    """
+    processor.openTrajectory(filename)
+    try:
+        positions = processor.positionArray()
+        while processor.readFrame():
+            yield positions
+    finally:
+        processor.closeTrajectory()
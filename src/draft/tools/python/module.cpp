@@ -0,0 +1,352 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+/*
+* Python extension module _mdpp, which gives Python code access to a
+* Tools::Processor (the mdPp post-processor) frame by frame.
+*
+* Arrays of the Configuration are exported without copying, through the
+* Python buffer protocol, as strided views of the AtomStorage and 
+* GroupStorage arrays. numpy.asarray(view) thus yields an array that
+* refers directly to simpatico memory. Because trajectory readers update
+* positions in place, such an array remains valid and shows the current
+* frame after each call to readFrame(). Views must not be used after the
+* next readConfig(), which may reallocate storage.
+*/
+
+#include <Python.h>
+
+#include <tools/processor/Processor.h>
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Group.h>
+#include <tools/storage/AtomStorage.h>
+#include <tools/storage/GroupStorage.h>
+#include <util/global.h>
+#include <util/misc/Exception.h>
+
+#include <cstddef>
+#include <exception>
+#include <string>
+
+using namespace Tools;
+
+// ArrayView: a strided view of simpatico memory --------------------------
+
+/*
+* Object that exports a 1D or 2D strided array through the buffer protocol.
+*/
+typedef struct {
+   PyObject_HEAD
+   PyObject* owner;        // Processor object that owns the memory
+   void* buf;              // Address of first element
+   Py_ssize_t shape[2];
+   Py_ssize_t strides[2];
+   Py_ssize_t itemsize;
+   int ndim;
+   int readonly;
+   char format[4];
+} ArrayView;
+
+static void ArrayView_dealloc(ArrayView* self)
+{
+   Py_XDECREF(self->owner);
+   Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int ArrayView_getbuffer(PyObject* obj, Py_buffer* view, int flags)
+{
+   ArrayView* self = (ArrayView*)obj;
+   if ((flags & PyBUF_WRITABLE) && self->readonly) {
+      PyErr_SetString(PyExc_BufferError, "Array is read-only");
+      return -1;
+   }
+   if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+      PyErr_SetString(PyExc_BufferError, "Array is strided");
+      return -1;
+   }
+   view->buf = self->buf;
+   view->obj = obj;
+   Py_INCREF(obj);
+   view->len = self->itemsize;
+   for (int i = 0; i < self->ndim; ++i) {
+      view->len *= self->shape[i];
+   }
+   view->itemsize = self->itemsize;
+   view->readonly = self->readonly;
+   view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+   view->ndim = self->ndim;
+   view->shape = self->shape;
+   view->strides = self->strides;
+   view->suboffsets = NULL;
+   view->internal = NULL;
+   return 0;
+}
+
+static PyBufferProcs ArrayView_as_buffer = {
+   ArrayView_getbuffer,
+   NULL
+};
+
+static PyTypeObject ArrayViewType = {
+   PyVarObject_HEAD_INIT(NULL, 0)
+   "_mdpp.ArrayView",           // tp_name
+   sizeof(ArrayView),           // tp_basicsize
+};
+
+/*
+* Create an ArrayView of elements of size itemsize, with row stride
+* rowStride. If nColumn > 0, the view is 2D with nColumn columns of
+* contiguous elements, otherwise it is 1D.
+*/
+static PyObject* makeView(PyObject* owner, void* buf, 
+                          Py_ssize_t nRow, Py_ssize_t rowStride,
+                          Py_ssize_t nColumn, Py_ssize_t itemsize,
+                          const char* format, int readonly)
+{
+   ArrayView* self = PyObject_New(ArrayView, &ArrayViewType);
+   if (!self) return NULL;
+   Py_INCREF(owner);
+   self->owner = owner;
+   self->buf = buf;
+   self->shape[0] = nRow;
+   self->strides[0] = rowStride;
+   if (nColumn > 0) {
+      self->ndim = 2;
+      self->shape[1] = nColumn;
+      self->strides[1] = itemsize;
+   } else {
+      self->ndim = 1;
+      self->shape[1] = 0;
+      self->strides[1] = 0;
+   }
+   self->itemsize = itemsize;
+   self->readonly = readonly;
+   strncpy(self->format, format, sizeof(self->format) - 1);
+   self->format[sizeof(self->format) - 1] = '\0';
+   return (PyObject*)self;
+}
+
+// PyProcessor: Python wrapper for a Tools::Processor ---------------------
+
+typedef struct {
+   PyObject_HEAD
+   Processor* processor;
+} PyProcessor;
+
+/*
+* Translate C++ exceptions into Python RuntimeError.
+*/
+#define MDPP_TRY try {
+#define MDPP_CATCH \
+   } catch (Util::Exception& e) { \
+      PyErr_SetString(PyExc_RuntimeError, e.message().c_str()); \
+      return NULL; \
+   } catch (std::exception& e) { \
+      PyErr_SetString(PyExc_RuntimeError, e.what()); \
+      return NULL; \
+   } catch (...) { \
+      PyErr_SetString(PyExc_RuntimeError, "Unknown C++ exception"); \
+      return NULL; \
+   }
+
+static PyObject* PyProcessor_new(PyTypeObject* type, PyObject* args, 
+                                 PyObject* kwds)
+{
+   PyProcessor* self = (PyProcessor*)type->tp_alloc(type, 0);
+   if (!self) return NULL;
+   MDPP_TRY
+   self->processor = new Processor();
+   MDPP_CATCH
+   return (PyObject*)self;
+}
+
+static void PyProcessor_dealloc(PyProcessor* self)
+{
+   delete self->processor;
+   Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+/*
+* Call a Processor member function with one string argument.
+*/
+static PyObject* callWithString(PyProcessor* self, PyObject* args,
+                       void (*function)(Processor&, const std::string&))
+{
+   const char* str;
+   if (!PyArg_ParseTuple(args, "s", &str)) return NULL;
+   MDPP_TRY
+   function(*self->processor, std::string(str));
+   MDPP_CATCH
+   Py_RETURN_NONE;
+}
+
+static void doReadParam(Processor& p, const std::string& s)
+{  p.readParam(s.c_str()); }
+
+static void doSetConfigReader(Processor& p, const std::string& s)
+{  p.setConfigReader(s); }
+
+static void doReadConfig(Processor& p, const std::string& s)
+{  p.readConfig(s); }
+
+static void doSetTrajectoryReader(Processor& p, const std::string& s)
+{  p.setTrajectoryReader(s); }
+
+static void doOpenTrajectory(Processor& p, const std::string& s)
+{  p.openTrajectory(s); }
+
+static PyObject* PyProcessor_readParam(PyProcessor* self, PyObject* args)
+{  return callWithString(self, args, doReadParam); }
+
+static PyObject* PyProcessor_setConfigReader(PyProcessor* self, 
+                                             PyObject* args)
+{  return callWithString(self, args, doSetConfigReader); }
+
+static PyObject* PyProcessor_readConfig(PyProcessor* self, PyObject* args)
+{  return callWithString(self, args, doReadConfig); }
+
+static PyObject* PyProcessor_setTrajectoryReader(PyProcessor* self, 
+                                                 PyObject* args)
+{  return callWithString(self, args, doSetTrajectoryReader); }
+
+static PyObject* PyProcessor_openTrajectory(PyProcessor* self, 
+                                            PyObject* args)
+{  return callWithString(self, args, doOpenTrajectory); }
+
+static PyObject* PyProcessor_readFrame(PyProcessor* self, PyObject*)
+{
+   bool notEnd = false;
+   MDPP_TRY
+   notEnd = self->processor->readFrame();
+   MDPP_CATCH
+   return PyBool_FromLong(notEnd);
+}
+
+static PyObject* PyProcessor_closeTrajectory(PyProcessor* self, PyObject*)
+{
+   MDPP_TRY
+   self->processor->closeTrajectory();
+   MDPP_CATCH
+   Py_RETURN_NONE;
+}
+
+/*
+* Return lengths of an orthorhombic boundary, as a tuple (copied).
+*/
+static PyObject* PyProcessor_boxLengths(PyProcessor* self, PyObject*)
+{
+   const Vector& lengths = self->processor->boundary().lengths();
+   return Py_BuildValue("(ddd)", lengths[0], lengths[1], lengths[2]);
+}
+
+/*
+* Views of atom data, in order of addition to AtomStorage.
+*/
+static PyObject* atomView(PyObject* obj, std::size_t offset, int nColumn,
+                          Py_ssize_t itemsize, const char* format)
+{
+   AtomStorage& storage = ((PyProcessor*)obj)->processor->atoms();
+   int n = storage.size();
+   char* buf = n > 0 ? (char*)&storage.atom(0) + offset : NULL;
+   return makeView(obj, buf, n, sizeof(Atom), nColumn, itemsize, 
+                   format, 0);
+}
+
+static PyObject* PyProcessor_positions(PyObject* obj, PyObject*)
+{  
+   return atomView(obj, offsetof(Atom, position), Dimension, 
+                   sizeof(double), "d"); 
+}
+
+static PyObject* PyProcessor_typeIds(PyObject* obj, PyObject*)
+{  return atomView(obj, offsetof(Atom, typeId), 0, sizeof(int), "i"); }
+
+static PyObject* PyProcessor_ids(PyObject* obj, PyObject*)
+{  return atomView(obj, offsetof(Atom, id), 0, sizeof(int), "i"); }
+
+#ifdef SIMP_BOND
+/*
+* View of the atom ids of all bonds, with shape (nBond, 2).
+*/
+static PyObject* PyProcessor_bonds(PyObject* obj, PyObject*)
+{
+   GroupStorage<2>& storage = ((PyProcessor*)obj)->processor->bonds();
+   int n = storage.size();
+   char* buf = n > 0 ? (char*)storage[0].atomIds : NULL;
+   return makeView(obj, buf, n, sizeof(Group<2>), 2, sizeof(int), "i", 0);
+}
+#endif
+
+static PyMethodDef PyProcessor_methods[] = {
+   {"readParam", (PyCFunction)PyProcessor_readParam, METH_VARARGS,
+    "Read a parameter file."},
+   {"setConfigReader", (PyCFunction)PyProcessor_setConfigReader, 
+    METH_VARARGS, "Choose ConfigReader by class name."},
+   {"readConfig", (PyCFunction)PyProcessor_readConfig, METH_VARARGS,
+    "Read a configuration file."},
+   {"setTrajectoryReader", (PyCFunction)PyProcessor_setTrajectoryReader,
+    METH_VARARGS, "Choose TrajectoryReader by class name."},
+   {"openTrajectory", (PyCFunction)PyProcessor_openTrajectory, 
+    METH_VARARGS, "Open a trajectory file and read its header."},
+   {"readFrame", (PyCFunction)PyProcessor_readFrame, METH_NOARGS,
+    "Read next frame; return False at end of file."},
+   {"closeTrajectory", (PyCFunction)PyProcessor_closeTrajectory, 
+    METH_NOARGS, "Close the trajectory file."},
+   {"boxLengths", (PyCFunction)PyProcessor_boxLengths, METH_NOARGS,
+    "Return the box lengths, as a tuple."},
+   {"positions", (PyCFunction)PyProcessor_positions, METH_NOARGS,
+    "Return a writable (nAtom, 3) view of atom positions."},
+   {"typeIds", (PyCFunction)PyProcessor_typeIds, METH_NOARGS,
+    "Return an (nAtom,) view of atom type ids."},
+   {"ids", (PyCFunction)PyProcessor_ids, METH_NOARGS,
+    "Return an (nAtom,) view of atom ids."},
+   #ifdef SIMP_BOND
+   {"bonds", (PyCFunction)PyProcessor_bonds, METH_NOARGS,
+    "Return an (nBond, 2) view of the atom ids of bonds."},
+   #endif
+   {NULL, NULL, 0, NULL}
+};
+
+static PyTypeObject PyProcessorType = {
+   PyVarObject_HEAD_INIT(NULL, 0)
+   "_mdpp.Processor",           // tp_name
+   sizeof(PyProcessor),         // tp_basicsize
+};
+
+// Module definition ------------------------------------------------------
+
+static PyModuleDef mdppModule = {
+   PyModuleDef_HEAD_INIT,
+   "_mdpp",
+   "Zero-copy access to the simpatico mdPp post-processor.",
+   -1,
+   NULL
+};
+
+PyMODINIT_FUNC PyInit__mdpp(void)
+{
+   ArrayViewType.tp_dealloc = (destructor)ArrayView_dealloc;
+   ArrayViewType.tp_as_buffer = &ArrayView_as_buffer;
+   ArrayViewType.tp_flags = Py_TPFLAGS_DEFAULT;
+   ArrayViewType.tp_doc = "Strided view of simpatico memory.";
+   if (PyType_Ready(&ArrayViewType) < 0) return NULL;
+
+   PyProcessorType.tp_new = PyProcessor_new;
+   PyProcessorType.tp_dealloc = (destructor)PyProcessor_dealloc;
+   PyProcessorType.tp_methods = PyProcessor_methods;
+   PyProcessorType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
+   PyProcessorType.tp_doc = "Tools::Processor (mdPp) driven from Python.";
+   if (PyType_Ready(&PyProcessorType) < 0) return NULL;
+
+   PyObject* module = PyModule_Create(&mdppModule);
+   if (!module) return NULL;
+   Py_INCREF(&ArrayViewType);
+   PyModule_AddObject(module, "ArrayView", (PyObject*)&ArrayViewType);
+   Py_INCREF(&PyProcessorType);
+   PyModule_AddObject(module, "Processor", (PyObject*)&PyProcessorType);
+   return module;
+}
@@ -129,6 +129,14 @@ namespace McMd
       ar & outputFileName_;
    }
 
+   #ifdef UTIL_MPI
+   /*
+   * Merge accumulators, default implementation.
+   */
+   void Analyzer::merge(MPI::Intracomm& communicator, int root)
+   {  UTIL_THROW("Analyzer is not mergeable"); }
+   #endif
+
    /*
    * Set the FileMaster.
    */
@@ -137,6 +137,45 @@ namespace McMd
       virtual void output()
       {}
 
+      #ifdef UTIL_MPI
+      /**
+      * Can results of analyzers on different processors be merged?
+      *
+      * An analyzer whose accumulators are sums of contributions of
+      * independent configurations may return true, and must then 
+      * implement merge(). This allows the frames of a trajectory to 
+      * be divided among processors. Default implementation returns 
+      * false.
+      */
+      virtual bool isMergeable() const
+      {  return false; }
+
+      /**
+      * Add accumulators of all processors to those of one processor.
+      *
+      * This must be called on all processors of the communicator. Upon 
+      * return, the analyzer on processor root holds results for all 
+      * configurations sampled by any processor. Default implementation
+      * throws an Exception.
+      *
+      * \param communicator communicator for all processors
+      * \param root         rank of processor that receives the results
+      */
+      virtual void merge(MPI::Intracomm& communicator, int root);
+      #endif
+
+      /**
+      * Can sample() run concurrently with other analyzers?
+      *
+      * An analyzer may return true only if its sample() function reads
+      * but does not modify the System or Simulation, and modifies only
+      * its own members and output files. The AnalyzerManager may then
+      * call sample() for all such analyzers concurrently, on different
+      * threads. Default implementation returns false.
+      */
+      virtual bool isConcurrent() const
+      {  return false; }
+
       /**
       * Get interval value.
       */
@@ -7,18 +7,49 @@
 
 #include "AnalyzerManager.h" 
 #include "Analyzer.h" 
+#include <simp/threads/ThreadPool.h>
+#include <util/misc/Log.h>
 #include <util/archives/Serializable_includes.h>
 
+#include <vector>
+
 namespace McMd
 {
 
    using namespace Util;
 
+   namespace {
+
+      /*
+      * Task that calls the sample function of one Analyzer.
+      */
+      class SampleTask : public Simp::TaskGroup::Task
+      {
+      public:
+
+         Analyzer* analyzerPtr;
+         long iStep;
+         bool hasFailed;
+
+         virtual void run()
+         {
+            try {
+               analyzerPtr->sample(iStep);
+            } catch (...) {
+               hasFailed = true;
+            }
+         }
+
+      };
+
+   }
+
    /*
    * Constructor.
    */
    AnalyzerManager::AnalyzerManager()
-   : Manager<Analyzer>()
+   : Manager<Analyzer>(),
+     threadPoolPtr_(0)
    {  setClassName("AnalyzerManager"); }
 
    /*
@@ -55,10 +86,60 @@ namespace McMd
    {
       UTIL_CHECK(Analyzer::baseInterval > 0);
       UTIL_CHECK(iStep % Analyzer::baseInterval == 0);
-      for (int i = 0; i < size(); ++i) {
-         (*this)[i].sample(iStep);
+      int i;
+
+      // Count concurrent analyzers at this step
+      int nConcurrent = 0;
+      if (threadPoolPtr_ && threadPoolPtr_->nThread() > 1) {
+         for (i = 0; i < size(); ++i) {
+            if ((*this)[i].isConcurrent() && (*this)[i].isAtInterval(iStep)) {
+               ++nConcurrent;
+            }
+         }
+      }
+
+      if (nConcurrent < 2) {
+         for (i = 0; i < size(); ++i) {
+            (*this)[i].sample(iStep);
+         }
+         return;
+      }
+
+      // Sample concurrent analyzers on the thread pool
+      std::vector<SampleTask> tasks(nConcurrent);
+      Simp::TaskGroup group(*threadPoolPtr_);
+      int j = 0;
+      for (i = 0; i < size(); ++i) {
+         if ((*this)[i].isConcurrent() && (*this)[i].isAtInterval(iStep)) {
+            tasks[j].analyzerPtr = &(*this)[i];
+            tasks[j].iStep = iStep;
+            tasks[j].hasFailed = false;
+            group.add(tasks[j]);
+            ++j;
+         }
+      }
+      group.wait();
+      for (j = 0; j < nConcurrent; ++j) {
+         if (tasks[j].hasFailed) {
+            Log::file() << "Analyzer " << tasks[j].analyzerPtr->className()
+                        << std::endl;
+            UTIL_THROW("Exception in concurrent Analyzer::sample");
+         }
+      }
+
+      // Sample other analyzers in order
+      for (i = 0; i < size(); ++i) {
+         if (!(*this)[i].isConcurrent() || !(*this)[i].isAtInterval(iStep)) {
+            (*this)[i].sample(iStep);
+         }
       }
    }
+
+   /*
+   * Set the ThreadPool used to run concurrent analyzers.
+   */
+   void AnalyzerManager::setThreadPool(Simp::ThreadPool& threadPool)
+   {  threadPoolPtr_ = &threadPool; }
  
    /*
    * Call output method of each analyzer.
@@ -70,6 +151,31 @@ namespace McMd
       }
    }
 
+   #ifdef UTIL_MPI
+   /*
+   * Return true iff every analyzer is mergeable.
+   */
+   bool AnalyzerManager::isMergeable() const
+   {
+      for (int i = 0; i < size(); ++i) {
+         if (!(*this)[i].isMergeable()) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /*
+   * Call merge method of each analyzer.
+   */
+   void AnalyzerManager::merge(MPI::Intracomm& communicator, int root)
+   {
+      for (int i = 0; i < size(); ++i) {
+         (*this)[i].merge(communicator, root);
+      }
+   }
+   #endif
+
    /*
    * Read instructions for creating objects from file.
    */
@@ -11,6 +11,8 @@
 #include "Analyzer.h"                  // template parameter
 #include <util/param/Manager.h>          // base class template
 
+namespace Simp { class ThreadPool; }
+
 namespace McMd
 {
 
@@ -70,9 +72,22 @@ namespace McMd
       */
       void setup();
  
+      /**
+      * Set the ThreadPool used to run concurrent analyzers.
+      *
+      * \param threadPool ThreadPool owned by the parent Simulation
+      */
+      void setThreadPool(Simp::ThreadPool& threadPool);
+
       /**
       * Call sample method of each Analyzer.
       *
+      * If a ThreadPool is set and has more than one thread, and two or
+      * more analyzers for which Analyzer::isConcurrent() is true are at
+      * an interval, those analyzers sample first, concurrently, and the
+      * others then sample in the order in which they were read.
+      * Otherwise, all analyzers sample in order.
+      *
       * \pre Analyzer::baseInterval > 0
       * \pre iStep::baseInterval == 0
       * 
@@ -89,6 +104,26 @@ namespace McMd
       */
       void output();
 
+      #ifdef UTIL_MPI
+      /**
+      * Can results of every analyzer be merged across processors?
+      */
+      bool isMergeable() const;
+
+      /**
+      * Call merge method of each analyzer.
+      *
+      * \param communicator communicator for all processors
+      * \param root         rank of processor that receives the results
+      */
+      void merge(MPI::Intracomm& communicator, int root);
+      #endif
+
+   private:
+
+      /// Pointer to ThreadPool (null if not set).
+      Simp::ThreadPool* threadPoolPtr_;
+
    };
 
 }
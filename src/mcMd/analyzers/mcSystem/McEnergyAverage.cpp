@@ -31,7 +31,7 @@ namespace McMd
    void McEnergyAverage::sample(long iStep) 
    {
       if (isAtInterval(iStep))  {
-         accumulator_.sample(system().potentialEnergy(), outputFile_);
+         accumulator_.sample(system().trackedPotentialEnergy(), outputFile_);
       }
    }
    
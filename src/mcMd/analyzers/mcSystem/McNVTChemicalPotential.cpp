@@ -12,6 +12,10 @@
 #include <mcMd/mcSimulation/McSystem.h>
 #include <mcMd/mcMoves/SystemMove.h>
 #include <mcMd/mcSimulation/mc_potentials.h>
+#ifndef SIMP_NOPAIR
+#include <mcMd/neighbor/CellList.h>
+#include <mcMd/neighbor/Cell.h>
+#endif
 
 #include <util/boundary/Boundary.h>
 #include <simp/species/Species.h>
@@ -20,6 +24,7 @@
 #include <mcMd/chemistry/Atom.h>
 #include <util/space/Vector.h>
 #include <util/space/Tensor.h>
+#include <util/space/Dimension.h>
 #include <util/global.h>
 
 #include <math.h>
@@ -42,6 +47,11 @@ namespace McMd
       randomPtr_(&system.simulation().random()),
       outputFile_(),
       accumulator_(),
+      gridFlags_(),
+      voidCells_(),
+      voidFraction_(1.0),
+      cavityRadius_(0.0),
+      energyCap_(0.0),
       nTrial_(-1),
       nMoleculeTrial_(-1),
       nSamplePerBlock_(1),
@@ -83,6 +93,10 @@ namespace McMd
       read<double>(in, "BRnBin", BRnBin_);
       BRaccumulator_.setParam(BRmin_, BRmax_, BRnBin_);
       BRaccumulator_.clear();
+      cavityRadius_ = 0.0;
+      readOptional<double>(in, "cavityRadius", cavityRadius_);
+      energyCap_ = 0.0;
+      readOptional<double>(in, "energyCap", energyCap_);
 
       // If nSamplePerBlock != 0, open an output file for block averages.
       if (accumulator_.nSamplePerBlock()) {
@@ -101,6 +115,15 @@ namespace McMd
          UTIL_THROW("Invalid value input for speciesId");
       }
 
+      if (cavityRadius_ < 0.0) {
+         UTIL_THROW("Negative cavityRadius");
+      }
+      #ifdef SIMP_NOPAIR
+      if (cavityRadius_ > 0.0) {
+         UTIL_THROW("cavityRadius requires a pair potential");
+      }
+      #endif
+
       isInitialized_ = true;
 
    }
@@ -119,233 +142,51 @@ namespace McMd
       if (isAtInterval(iStep))  {
 
          Molecule* molPtr;
-         Atom* endPtr, *pvt1Ptr;
-         Vector trialPos[MaxTrial_], bondVec, pvt1Pos;
-         #ifdef SIMP_ANGLE
-         double angle;
-         Atom* pvt2Ptr;
-         Vector pvt2Pos;
-         #endif
-         double beta, length;
-         // Rosenbluth factor and energy of inserted bonds at each stage.
-         double w = 0, de = 0;
+         // Rosenbluth factor and energy of inserted atom at each stage.
+         double w, de;
          // Total rosenbluth factor and energy of inserted polymer.
-         double rosenbluth = 1, energy = 0;
-         double trialProb[MaxTrial_], trialEnergy[MaxTrial_];
-         int    iTrial;
+         double rosenbluth, energy;
+         int    nAtom, nAdded, atomId;
+         bool   isAlive;
+
+         #ifndef SIMP_NOPAIR
+         if (cavityRadius_ > 0.0) {
+            buildCavityGrid();
+         }
+         #endif
 
-         beta = energyEnsemble().beta();
          molPtr = &(simulation().getMolecule(speciesId_));
          system().addMolecule(*molPtr);
+         nAtom = molPtr->nAtom();
 
          // Main molecule inserting loop:
          for (int i = 0; i < nMoleculeTrial_; i++) {
-
-            // Inserting the first atom.
-            endPtr = &molPtr->atom(0);
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               // trialPos = pvtPos + bondVec
-               boundary().randomPosition(random(), trialPos[iTrial]);
-               boundary().shift(trialPos[iTrial]);
-
-               #ifndef SIMP_NOPAIR
-               trialEnergy[iTrial] = 
-                  system().pairPotential().atomEnergy(*endPtr);
-               #else
-               trialEnergy[iTrial] = 0.0;
-               #endif
-
-               #ifdef SIMP_EXTERNAL
-               trialEnergy[iTrial] += 
-                  system().externalPotential().atomEnergy(*endPtr);
-               #endif
-
-               trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
-               w += trialProb[iTrial];
-            }
-
-            // Normalize trial probabilities
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               trialProb[iTrial] = trialProb[iTrial]/rosenbluth;
-            }
-
-            // Choose trial position
-            iTrial = random().drawFrom(trialProb, nTrial_);
-
-            // Calculate total energy for chosen trial
-            de = trialEnergy[iTrial];
-
-            // Set position of new end atom to chosen trialPos Vector
-            endPtr->position() = trialPos[iTrial];
-
-            #ifndef SIMP_NOPAIR
-            system().pairPotential().addAtom(*endPtr);
-            #endif
-
-            rosenbluth *= w;
-            energy += de;
-
-            // Inserting the second atom.
-            int bondTypeId = molPtr->bond(0).typeId();
-            length = system().bondPotential().randomBondLength(&random(), 
-                                                               beta, 
-                                                               bondTypeId);
-
-            w = 0;
-            de = 0;
-
-            pvt1Ptr = &molPtr->atom(0);
-            endPtr = &molPtr->atom(1);
-
-            pvt1Pos = pvt1Ptr->position();
-
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               // trialPos = pvtPos + bondVec
-               random().unitVector(bondVec);
-               bondVec *= length;
-               // trialPos = pvtPos + bondVec
-               trialPos[iTrial].add(pvt1Pos, bondVec);
-               boundary().shift(trialPos[iTrial]);
-               endPtr->position() = trialPos[iTrial];
-
-               #ifndef SIMP_NOPAIR
-               trialEnergy[iTrial] =
-                  system().pairPotential().atomEnergy(*endPtr);
-               #else
-               trialEnergy[iTrial] = 0.0;
-               #endif
-
-               #ifdef SIMP_EXTERNAL
-               trialEnergy[iTrial] += 
-                  system().externalPotential().atomEnergy(*endPtr);
-               #endif
-
-               trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
-               w += trialProb[iTrial];
-            }
-
-            // Normalize trial probabilities
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               trialProb[iTrial] = trialProb[iTrial]/rosenbluth;
-            }
-
-            // Choose trial position
-            iTrial = random().drawFrom(trialProb, nTrial_);
-
-            // Fetch nonbonded energy for chosen trial
-            de = trialEnergy[iTrial];
-
-            // Add bond energy
-            de += system().bondPotential().energy(length*length, bondTypeId);
-
-            // Set position of new end atom to chosen trialPos Vector
-            endPtr->position() = trialPos[iTrial];
-
-            #ifndef SIMP_NOPAIR
-            system().pairPotential().addAtom(*endPtr);
-            #endif
-
-            rosenbluth *= w;
-            energy += de;
-
-            // Inserting the third atom.
-            bondTypeId = molPtr->bond(1).typeId();
-            length = 
-               system().bondPotential().randomBondLength(&random(), 
-                                                         beta, bondTypeId);
-
-            #ifdef SIMP_ANGLE
-            int angleTypeId = molPtr->angle(0).typeId();
-            angle = 
-               system().anglePotential().randomAngle(&random(), 
-                                                     beta, angleTypeId);
-            pvt2Ptr = &molPtr->atom(0);
-            pvt2Pos = pvt2Ptr->position();
-            Vector n = pvt1Pos;
-            n -= pvt2Pos;
-            #endif
-
-            w = 0;
-            de = 0;
-            pvt1Ptr = &molPtr->atom(1);
-            pvt1Pos = pvt1Ptr->position();
-            endPtr = &molPtr->atom(2);
-
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               // trialPos = pvtPos + bondVec
-               #ifdef SIMP_ANGLE
-               if (system().hasAnglePotential()) {
-                  uniformCone(length, angle, n, bondVec);
-               } else {
-                  random().unitVector(bondVec);
-                  bondVec *= length;
+            rosenbluth = 1.0;
+            energy = 0.0;
+            isAlive = true;
+            nAdded = 0;
+            for (atomId = 0; atomId < nAtom && isAlive; ++atomId) {
+               isAlive = addEndAtom(molPtr, atomId, w, de);
+               if (isAlive) {
+                  rosenbluth *= w;
+                  energy += de;
+                  #ifndef SIMP_NOPAIR
+                  system().pairPotential().addAtom(molPtr->atom(atomId));
+                  #endif
+                  ++nAdded;
                }
-               #else
-               random().unitVector(bondVec);
-               bondVec *= length;
-               #endif
-
-               // trialPos = pvtPos + bondVec
-               trialPos[iTrial].add(pvt1Pos, bondVec);
-               boundary().shift(trialPos[iTrial]);
-               endPtr->position() = trialPos[iTrial];
-
-               #ifndef SIMP_NOPAIR
-               trialEnergy[iTrial] = 
-                  system().pairPotential().atomEnergy(*endPtr);
-               #else
-               trialEnergy[iTrial] = 0.0;
-               #endif
-
-               #ifdef SIMP_EXTERNAL
-               trialEnergy[iTrial] += 
-                  system().externalPotential().atomEnergy(*endPtr);
-               #endif
-
-               trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
-               w += trialProb[iTrial];
             }
-            // Normalize trial probabilities
-            for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-               trialProb[iTrial] = trialProb[iTrial]/rosenbluth;
-            }
-
-            // Choose trial position
-            iTrial = random().drawFrom(trialProb, nTrial_);
-
-            // Get nonbonded energy for chosen trial
-            de = trialEnergy[iTrial];
-
-            // Add bonded energies
-            de += system().bondPotential().energy(length*length, bondTypeId);
-            #ifdef SIMP_ANGLE
-            de += system().anglePotential().energy(cos(angle), angleTypeId);
-            #endif
-
-            // Set position of new end atom to chosen trialPos Vector
-            endPtr->position() = trialPos[iTrial];
 
-            #ifndef SIMP_NOPAIR
-            system().pairPotential().addAtom(*endPtr);
-            #endif
-
-            rosenbluth *= w;
-            energy += de;
-
-            for (int atomId = 3; atomId < molPtr->nAtom(); ++atomId) {
-                addEndAtom(molPtr, atomId, w, de);
-                rosenbluth *= w;
-                energy += de;
-                #ifndef SIMP_NOPAIR
-                system().pairPotential().addAtom(molPtr->atom(atomId));
-                #endif
+            // A molecule abandoned by early rejection has zero weight
+            if (isAlive) {
+               rosenbluth = rosenbluth / pow(double(nTrial_), nAtom);
+            } else {
+               rosenbluth = 0.0;
             }
-
-            rosenbluth = rosenbluth / pow(nTrial_,molPtr->nAtom());
             accumulator_.sample(rosenbluth, outputFile_);
 
             #ifndef SIMP_NOPAIR
-            for (int atomId = 0; atomId < molPtr->nAtom(); ++atomId) {
+            for (atomId = 0; atomId < nAdded; ++atomId) {
                 system().pairPotential().deleteAtom(molPtr->atom(atomId));
             }
             #endif
@@ -354,7 +195,7 @@ namespace McMd
          system().removeMolecule(*molPtr);
          simulation().returnMolecule(*molPtr);
 
-         }
+      }
    }
 
    /*
@@ -405,108 +246,154 @@ namespace McMd
    { ar & *this; }
 
 
-    /*
+   /*
    * Configuration bias algorithm for adding one atom to a chain end.
    */
-   void
+   bool
    McNVTChemicalPotential::addEndAtom(Molecule* molPtr, 
                                       int atomId, double &rosenbluth, 
                                       double &energy)
    {
       Atom* endPtr = &molPtr->atom(atomId);
       Vector trialPos[MaxTrial_];
-      Vector bondVec;
-      Vector pvt1Pos = molPtr->atom(atomId-1).position();
-
-      #ifdef SIMP_ANGLE
-      Vector pvt2Pos = molPtr->atom(atomId-2).position();
-      #endif
-
-      #ifdef SIMP_DIHEDRAL
-      Vector pvt3Pos = molPtr->atom(atomId-3).position();
-      #endif
-
+      Vector bondVec, pvt1Pos;
       double trialProb[MaxTrial_], trialEnergy[MaxTrial_];
       double beta, length;
-      int bondTypeId = molPtr->bond(atomId - 1).typeId();
+      int    iTrial, bondTypeId;
+      double eMin = 0;
 
       #ifdef SIMP_ANGLE
+      Vector n;
       double angle;
-      int angleTypeId = molPtr->angle(atomId - 2).typeId();
+      int angleTypeId;
       #endif
 
-      int    iTrial;
-      double eMin = 0;
-
-      // Generate a random bond-length and bond-angle.
-      beta   = energyEnsemble().beta();
-      length = system().bondPotential().randomBondLength(&random(), beta, 
-                                        molPtr->bond(atomId-1).typeId());
-      #ifdef SIMP_ANGLE
-      Vector n = pvt1Pos;
-      n -= pvt2Pos;
-      angle = system().anglePotential().randomAngle(&random(), beta, 
-                                        molPtr->angle(atomId-2).typeId());
-      #endif
       #ifdef SIMP_DIHEDRAL
-      Vector dR1 = pvt3Pos;
-      Vector dR2 = pvt2Pos;
-      Vector dR3 = pvt1Pos;
-      dR1 -= pvt2Pos;
-      dR2 -= pvt1Pos;
-      dR3 -= endPtr->position();
+      Vector dR1, dR2, dR3;
+      int dihedralTypeId;
       #endif
 
-      // Loop over nTrial trial positions:
-      rosenbluth = 0.0;
-      for (iTrial=0; iTrial < nTrial_; ++iTrial) {
+      // Reject at once if there is no void cell for the first atom
+      if (atomId == 0 && cavityRadius_ > 0.0 && voidCells_.size() == 0) {
+         rosenbluth = 0.0;
+         energy = 0.0;
+         return false;
+      }
 
-         #ifdef SIMP_ANGLE
-         if (system().hasAnglePotential()) {
-            uniformCone(length, angle, n, bondVec);
-         } else {
-            random().unitVector(bondVec);
-            bondVec *= length;
+      // Generate trial positions
+      beta = energyEnsemble().beta();
+      length = 0.0;
+      bondTypeId = -1;
+      if (atomId == 0) {
+         for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
+            if (cavityRadius_ > 0.0) {
+               randomCavityPosition(trialPos[iTrial]);
+            } else {
+               boundary().randomPosition(random(), trialPos[iTrial]);
+            }
+            boundary().shift(trialPos[iTrial]);
+            trialEnergy[iTrial] = 0.0;
          }
-         #else
-         random().unitVector(bondVec);
-         bondVec *= length;
-         #endif
+      } else {
 
-         trialPos[iTrial].add(pvt1Pos, bondVec);
-         boundary().shift(trialPos[iTrial]);
-         endPtr->position() = trialPos[iTrial];
-
-         #ifndef SIMP_NOPAIR
-         trialEnergy[iTrial] = system().pairPotential().atomEnergy(*endPtr);
-         #else
-         trialEnergy[iTrial] = 0.0;
+         // Generate a random bond-length and bond-angle.
+         bondTypeId = molPtr->bond(atomId - 1).typeId();
+         length = system().bondPotential().randomBondLength(&random(), 
+                                                            beta, bondTypeId);
+         pvt1Pos = molPtr->atom(atomId-1).position();
+         #ifdef SIMP_ANGLE
+         if (atomId > 1) {
+            n = pvt1Pos;
+            n -= molPtr->atom(atomId-2).position();
+            angleTypeId = molPtr->angle(atomId - 2).typeId();
+            angle = system().anglePotential().randomAngle(&random(), beta, 
+                                                          angleTypeId);
+         }
          #endif
-
          #ifdef SIMP_DIHEDRAL
-         if (system().hasDihedralPotential()) {
-            trialEnergy[iTrial] += 
-               system().dihedralPotential().energy(dR1, dR2, dR3, 
-                                        molPtr->dihedral(atomId-3).typeId());
+         if (atomId > 2) {
+            dR1 = molPtr->atom(atomId-3).position();
+            dR1 -= molPtr->atom(atomId-2).position();
+            dR2 = molPtr->atom(atomId-2).position();
+            dR2 -= pvt1Pos;
+            dihedralTypeId = molPtr->dihedral(atomId - 3).typeId();
          }
          #endif
 
+         for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
+            #ifdef SIMP_ANGLE
+            if (atomId > 1 && system().hasAnglePotential()) {
+               uniformCone(length, angle, n, bondVec);
+            } else {
+               random().unitVector(bondVec);
+               bondVec *= length;
+            }
+            #else
+            random().unitVector(bondVec);
+            bondVec *= length;
+            #endif
+            trialPos[iTrial].add(pvt1Pos, bondVec);
+            boundary().shift(trialPos[iTrial]);
+            trialEnergy[iTrial] = 0.0;
+
+            #ifdef SIMP_DIHEDRAL
+            if (atomId > 2 && system().hasDihedralPotential()) {
+               dR3.multiply(bondVec, -1.0);
+               trialEnergy[iTrial] = 
+                  system().dihedralPotential().energy(dR1, dR2, dR3, 
+                                                      dihedralTypeId);
+            }
+            #endif
+         }
+      }
+
+      // Nonbonded energies of all trial positions
+      #ifndef SIMP_NOPAIR
+      double pairEnergy[MaxTrial_];
+      system().pairPotential().trialEnergies(*endPtr, trialPos, nTrial_, 
+                                             pairEnergy);
+      #endif
+      for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
+         #ifndef SIMP_NOPAIR
+         trialEnergy[iTrial] += pairEnergy[iTrial];
+         #endif
          #ifdef SIMP_EXTERNAL
+         endPtr->position() = trialPos[iTrial];
          trialEnergy[iTrial] += 
             system().externalPotential().atomEnergy(*endPtr);
          #endif
+      }
+
+      // Loop over nTrial trial positions:
+      rosenbluth = 0.0;
+      for (iTrial=0; iTrial < nTrial_; ++iTrial) {
 
          // Finding the Minimum of the trialEnergy vector
          if (eMin > trialEnergy[iTrial])
             eMin = trialEnergy[iTrial];
-         Eaccumulator_.sample(trialEnergy[iTrial]);
 
-         trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
+         // Energy distributions are sampled beyond the first three atoms
+         if (atomId > 2) {
+            Eaccumulator_.sample(trialEnergy[iTrial]);
+         }
+
+         // Trials above the energy cap are rejected without weight
+         if (energyCap_ > 0.0 && trialEnergy[iTrial] > energyCap_) {
+            trialProb[iTrial] = 0.0;
+         } else {
+            trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
+         }
          rosenbluth += trialProb[iTrial];
       }
 
-      Emaccumulator_.sample(eMin);
-      BRaccumulator_.sample(rosenbluth);
+      if (atomId > 2) {
+         Emaccumulator_.sample(eMin);
+         BRaccumulator_.sample(rosenbluth);
+      }
+      if (rosenbluth <= 0.0) {
+         return false;
+      }
+
       // Normalize trial probabilities
       for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
          trialProb[iTrial] = trialProb[iTrial]/rosenbluth;
@@ -516,18 +403,121 @@ namespace McMd
       iTrial = random().drawFrom(trialProb, nTrial_);
 
       // Calculate total energy for chosen trial.
-      energy = system().bondPotential().energy(length*length, bondTypeId);
+      energy = trialEnergy[iTrial];
+      if (atomId > 0) {
+         energy += system().bondPotential().energy(length*length, bondTypeId);
+      }
       #ifdef SIMP_ANGLE
-      energy += system().anglePotential().energy(cos(angle), angleTypeId);
+      if (atomId > 1 && system().hasAnglePotential()) {
+         energy += system().anglePotential().energy(cos(angle), angleTypeId);
+      }
       #endif
+      if (atomId > 2) {
+         Ecaccumulator_.sample(energy);
+      }
 
-      energy += trialEnergy[iTrial];
-      Ecaccumulator_.sample(energy);
+      // Only void cells were sampled for the first atom
+      if (atomId == 0 && cavityRadius_ > 0.0) {
+         rosenbluth *= voidFraction_;
+      }
 
       // Set position of new end atom to chosen value
       endPtr->position() = trialPos[iTrial];
+      return true;
    }
 
+   #ifndef SIMP_NOPAIR
+   /*
+   * Mark cavity grid cells near atoms of the cell list, list void cells.
+   */
+   void McNVTChemicalPotential::buildCavityGrid()
+   {
+      const Vector& lengths = boundary().lengths();
+      double halfDiagSq = 0.0;
+      int    nCell = 1;
+      int    i;
+      for (i = 0; i < Dimension; ++i) {
+         nGrid_[i] = int(ceil(2.0*lengths[i]/cavityRadius_));
+         gridSpacing_[i] = lengths[i]/double(nGrid_[i]);
+         halfDiagSq += 0.25*gridSpacing_[i]*gridSpacing_[i];
+         nCell *= nGrid_[i];
+      }
+
+      // Every point of a cell whose center lies within cavityRadius - 
+      // (half cell diagonal) of an atom is within cavityRadius of it.
+      double rEx = cavityRadius_ - sqrt(halfDiagSq);
+      double rExSq = rEx*rEx;
+
+      gridFlags_.clear();
+      for (i = 0; i < nCell; ++i) {
+         gridFlags_.append(0);
+      }
+
+      const CellList& cellList = system().pairPotential().cellList();
+      const Atom* atomPtr;
+      IntVector lo, hi;
+      double dx, dy, dz, dxy;
+      int ic, j, k, ix, iy, iz, jx, jy, jz;
+      for (ic = 0; ic < cellList.totCells(); ++ic) {
+         const Cell& cell = cellList.cell(ic);
+         for (j = 0; j < cell.firstClearPos(); ++j) {
+            atomPtr = cell.atomPtr(j);
+            if (!atomPtr) continue;
+            const Vector& r = atomPtr->position();
+            for (k = 0; k < Dimension; ++k) {
+               lo[k] = int(ceil((r[k] - rEx)/gridSpacing_[k] - 0.5));
+               hi[k] = int(floor((r[k] + rEx)/gridSpacing_[k] - 0.5));
+            }
+            for (ix = lo[0]; ix <= hi[0]; ++ix) {
+               dx = (ix + 0.5)*gridSpacing_[0] - r[0];
+               jx = ((ix % nGrid_[0]) + nGrid_[0]) % nGrid_[0];
+               for (iy = lo[1]; iy <= hi[1]; ++iy) {
+                  dy = (iy + 0.5)*gridSpacing_[1] - r[1];
+                  dxy = dx*dx + dy*dy;
+                  if (dxy >= rExSq) continue;
+                  jy = ((iy % nGrid_[1]) + nGrid_[1]) % nGrid_[1];
+                  for (iz = lo[2]; iz <= hi[2]; ++iz) {
+                     dz = (iz + 0.5)*gridSpacing_[2] - r[2];
+                     if (dxy + dz*dz < rExSq) {
+                        jz = ((iz % nGrid_[2]) + nGrid_[2]) % nGrid_[2];
+                        gridFlags_[(jx*nGrid_[1] + jy)*nGrid_[2] + jz] = 1;
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+      voidCells_.clear();
+      for (i = 0; i < nCell; ++i) {
+         if (!gridFlags_[i]) {
+            voidCells_.append(i);
+         }
+      }
+      voidFraction_ = double(voidCells_.size())/double(nCell);
+   }
+
+   /*
+   * Choose a random position within a random void cell.
+   */
+   void McNVTChemicalPotential::randomCavityPosition(Vector& position)
+   {
+      int k = voidCells_[random().uniformInt(0, voidCells_.size())];
+      int iz = k % nGrid_[2];
+      int iy = (k / nGrid_[2]) % nGrid_[1];
+      int ix = k / (nGrid_[1]*nGrid_[2]);
+      position[0] = (ix + random().uniform(0.0, 1.0))*gridSpacing_[0];
+      position[1] = (iy + random().uniform(0.0, 1.0))*gridSpacing_[1];
+      position[2] = (iz + random().uniform(0.0, 1.0))*gridSpacing_[2];
+   }
+   #else
+   void McNVTChemicalPotential::buildCavityGrid()
+   {}
+
+   void McNVTChemicalPotential::randomCavityPosition(Vector& position)
+   {  boundary().randomPosition(random(), position); }
+   #endif
+
    /*
    * Finding a vector which make an angle \theta with vector n and has length b.
    */
@@ -13,6 +13,9 @@
 #include <util/accumulators/Average.h>      // member
 #include <util/accumulators/Distribution.h> // member
 #include <util/random/Random.h>             // member
+#include <util/containers/GArray.h>         // member template
+#include <util/space/Vector.h>              // member
+#include <util/space/IntVector.h>           // member
 #include <util/ensembles/EnergyEnsemble.h>  // inline function
 #include <util/archives/Serializable.h>     // typedef
 
@@ -29,6 +32,19 @@ namespace McMd
    * McNVTChemicalPotential uses configuration bias algorithm
    * to calculate the chemical potential of a linear chain.
    *
+   * Trial energies of each inserted atom are computed in one call to
+   * McPairPotential::trialEnergies(). If the optional cavityRadius
+   * parameter is positive, first atoms are inserted only into a grid
+   * of void cells, which contain no point within cavityRadius of an
+   * existing atom, and the Rosenbluth factor is multiplied by the void
+   * volume fraction. This neglects insertions within cavityRadius of 
+   * an atom, and so requires a cavityRadius at which overlaps have a 
+   * negligible Boltzmann weight. If the optional energyCap parameter
+   * is positive, trial positions with energies above energyCap are
+   * given zero weight, and growth of a molecule is abandoned, with a
+   * Rosenbluth factor of zero, as soon as all trials of one atom are
+   * rejected.
+   *
    * See \ref mcMd_analyzer_McNVTChemicalPotential_page "here" for 
    * the parameter file format and any other user documentation.
    *
@@ -117,26 +133,40 @@ namespace McMd
       *
       * This function generates and computes Rosenbluth factors for nTrial 
       * trial positions, chooses one, updates the atomic position. It does
-      * not add the end atom to the system cell list.
+      * not add the end atom to the system cell list. The first atom is 
+      * inserted at a random position (or random void cell position), and
+      * atom atomId > 0 is bonded to atom atomId - 1.
       *
       * Upon return:
       *  
-      *   - rosenbluth is the nonbonded Rosenblush factor for the added 
+      *   - rosenbluth is the nonbonded Rosenbluth factor for the added 
       *     atom, i.e., the sum of Boltzmann factors from nonbonded 
       *     pair interactions for all nTrial_ trial positions.
       *
-      *+   - energy is the total energy (bonded + nonbonded) of the new 
-      *      end atom in its chosen position.
+      *   - energy is the total energy (bonded + nonbonded) of the new 
+      *     end atom in its chosen position.
       *
-      * \param endPtr     ptr to new end atom, which we attempt to add
-      * \param pvtPtr     end atom of current chain, next to end
-      * \param bondType   type of bond connecting pvt and end atoms
+      * \param molPtr     molecule being inserted
+      * \param atomId     index of new end atom within the molecule
       * \param rosenbluth Rosenbluth factor of added atom (out)
-      * \param energy     potential energy of deleted atom (out)
+      * \param energy     potential energy of added atom (out)
+      * \return false if every trial exceeds the energy cap, true otherwise
       */
-      void addEndAtom(Molecule* molPtr, int atomId, double &rosenbluth,
+      bool addEndAtom(Molecule* molPtr, int atomId, double &rosenbluth,
                       double &energy);
 
+      /**
+      * Mark grid cells near existing atoms, and list void cells.
+      */
+      void buildCavityGrid();
+
+      /**
+      * Choose a random position within a random void cell.
+      *
+      * \param position random position (out)
+      */
+      void randomCavityPosition(Vector& position);
+
       /**
       * Generates vector p of length b and angle theta with vector n.
       * 
@@ -233,6 +263,27 @@ namespace McMd
       /// Number of bins in range
       double BRnBin_;
 
+      /// Flags for cavity grid cells: 1 if near an atom, 0 if void.
+      GArray<int> gridFlags_;
+
+      /// Indices of void grid cells.
+      GArray<int> voidCells_;
+
+      /// Dimensions of cells of the cavity grid.
+      Vector gridSpacing_;
+
+      /// Number of cavity grid cells in each direction.
+      IntVector nGrid_;
+
+      /// Fraction of cavity grid cells that are void.
+      double voidFraction_;
+
+      /// Minimum distance of void cells from atoms (0 if not used).
+      double cavityRadius_;
+
+      /// Maximum trial energy with nonzero weight (0 if not used).
+      double energyCap_;
+
       /// Actual number of trial positions for each regrown atom.
       int  nTrial_; 
 
@@ -0,0 +1,141 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "McStructureFactor.h"
+#include <mcMd/chemistry/Atom.h>
+#include <util/math/Constants.h>
+#include <util/archives/Serializable_includes.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   McStructureFactor::McStructureFactor(McSystem& system) 
+    : StructureFactor(system),
+      mcSystemPtr_(&system),
+      fullUpdateInterval_(100),
+      nSampleSinceUpdate_(0),
+      hasFourierModes_(false),
+      isObserving_(false)
+   {  setClassName("McStructureFactor"); }
+
+   /*
+   * Destructor.
+   */
+   McStructureFactor::~McStructureFactor() 
+   {}
+
+   /*
+   * Read parameters from file, and allocate memory.
+   */
+   void McStructureFactor::readParameters(std::istream& in) 
+   {
+      StructureFactor::readParameters(in);
+      fullUpdateInterval_ = 100;
+      readOptional<int>(in, "fullUpdateInterval", fullUpdateInterval_);
+      if (fullUpdateInterval_ <= 0) {
+         UTIL_THROW("fullUpdateInterval <= 0");
+      }
+      addObservers();
+   }
+
+   /*
+   * Load state from an archive.
+   */
+   void McStructureFactor::loadParameters(Serializable::IArchive& ar)
+   {
+      StructureFactor::loadParameters(ar);
+      fullUpdateInterval_ = 100;
+      loadParameter<int>(ar, "fullUpdateInterval", fullUpdateInterval_, 
+                         false);
+      if (fullUpdateInterval_ <= 0) {
+         UTIL_THROW("fullUpdateInterval <= 0");
+      }
+      hasFourierModes_ = false;
+      addObservers();
+   }
+
+   /*
+   * Save state to archive.
+   */
+   void McStructureFactor::save(Serializable::OArchive& ar)
+   {
+      StructureFactor::save(ar);
+      Parameter::saveOptional(ar, fullUpdateInterval_, true);
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void McStructureFactor::setup() 
+   {
+      StructureFactor::setup();
+      hasFourierModes_ = false;
+   }
+
+   /* 
+   * Increment structure factors, recomputing Fourier modes if needed.
+   */
+   void McStructureFactor::sample(long iStep) 
+   {
+      if (isAtInterval(iStep))  {
+         if (!hasFourierModes_ || nSampleSinceUpdate_ >= fullUpdateInterval_) {
+            computeFourierModes();
+            hasFourierModes_ = true;
+            nSampleSinceUpdate_ = 0;
+         }
+         incrementStructureFactors();
+         ++nSampleSinceUpdate_;
+      }
+   }
+
+   /*
+   * Update Fourier modes for a change in position of one atom.
+   */
+   void McStructureFactor::moveAtom(const Atom& atom, 
+                                    const Vector& oldPosition)
+   {
+      if (!hasFourierModes_) return;
+
+      const Vector& newPosition = atom.position();
+      std::complex<double> dExp;
+      int typeId = atom.typeId();
+      int i, j;
+      for (i = 0; i < nWave_; ++i) {
+         dExp  = exp(newPosition.dot(waveVectors_[i])*Constants::Im);
+         dExp -= exp(oldPosition.dot(waveVectors_[i])*Constants::Im);
+         for (j = 0; j < nMode_; ++j) {
+            fourierModes_(i, j) += modes_(j, typeId)*dExp;
+         }
+      }
+   }
+
+   /*
+   * Mark Fourier modes as unknown.
+   */
+   void McStructureFactor::unsetFourierModes()
+   {  hasFourierModes_ = false; }
+
+   /*
+   * Add call-back functions to McSystem signals (private).
+   */
+   void McStructureFactor::addObservers()
+   {
+      if (!isObserving_) {
+         mcSystemPtr_->atomMoveSignal().
+                       addObserver(*this, &McStructureFactor::moveAtom);
+         mcSystemPtr_->untrackedMoveSignal().
+                       addObserver(*this, &McStructureFactor::unsetFourierModes);
+         isObserving_ = true;
+      }
+   }
+
+}
@@ -0,0 +1,128 @@
+#ifndef MCMD_MC_STRUCTURE_FACTOR_H
+#define MCMD_MC_STRUCTURE_FACTOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/analyzers/system/StructureFactor.h>  // base class
+#include <mcMd/mcSimulation/McSystem.h>             // member
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * StructureFactor with incrementally updated Fourier modes.
+   *
+   * This analyzer computes the same structure factors as StructureFactor,
+   * but updates the Fourier modes after every accepted MC move of an 
+   * McMove that reports its moved atoms (see McMove::reportsAtomMoves()),
+   * by subtracting the phase factor of the old position of each moved 
+   * atom and adding that of its new position. The Fourier modes are
+   * recomputed from all atoms after any move that is not reported, and 
+   * every fullUpdateInterval samples, to bound accumulated round-off
+   * error. Structure factors can thus be sampled at short intervals 
+   * when most accepted moves are reported.
+   *
+   * \sa \ref mcMd_analyzer_McStructureFactor_page "parameter file format"
+   *
+   * \ingroup McMd_Analyzer_Mc_Module
+   */
+   class McStructureFactor : public StructureFactor
+   {
+
+   public:
+
+      /**	
+      * Constructor.
+      *
+      * \param system reference to parent McSystem object
+      */
+      McStructureFactor(McSystem &system);
+
+      /**	
+      * Destructor.
+      */
+      ~McStructureFactor();
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load state from an archive.
+      *
+      * \param ar loading (input) archive.
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save state to archive.
+      *
+      * \param ar saving (output) archive.
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /** 
+      * Clear accumulators, and mark Fourier modes as unknown.
+      */
+      virtual void setup();
+
+      /**
+      * Add current Fourier modes to StructureFactor accumulators.
+      *
+      * \param iStep step counter
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Update Fourier modes for a change in position of one atom.
+      *
+      * Call-back function for McSystem::atomMoveSignal().
+      *
+      * \param atom        moved atom, with new position
+      * \param oldPosition position of the atom before the move
+      */
+      void moveAtom(const Atom& atom, const Vector& oldPosition);
+
+      /**
+      * Mark Fourier modes as unknown.
+      *
+      * Call-back function for McSystem::untrackedMoveSignal().
+      */
+      void unsetFourierModes();
+
+   private:
+
+      /// Pointer to parent McSystem.
+      McSystem* mcSystemPtr_;
+
+      /// Number of samples between full recomputations of Fourier modes.
+      int fullUpdateInterval_;
+
+      /// Number of samples since the last full recomputation.
+      int nSampleSinceUpdate_;
+
+      /// Are the Fourier modes known (i.e., consistent with positions)?
+      bool hasFourierModes_;
+
+      /// Have call-back functions been added to McSystem signals?
+      bool isObserving_;
+
+      /**
+      * Add call-back functions to McSystem signals, if not done already.
+      */
+      void addObservers();
+
+   };
+
+}
+#endif
@@ -5,6 +5,7 @@ mcMd_analyzers_mcSystem_=\
     mcMd/analyzers/mcSystem/McPairEnergyAverage.cpp \
     mcMd/analyzers/mcSystem/McPressureAverage.cpp \
     mcMd/analyzers/mcSystem/McVirialStressTensorAverage.cpp \
+    mcMd/analyzers/mcSystem/McStructureFactor.cpp \
     mcMd/analyzers/mcSystem/McAnalyzerFactory.cpp 
 
 ifndef SIMP_NOPAIR
@@ -46,6 +46,8 @@ namespace McMd
       myParam_(),
       lowerParam_(),
       upperParam_(),
+      partnerParams_(),
+      differences_(),
       nSamplePerBlock_(1),
       myAccumulator_(),
       upperAccumulator_(),
@@ -75,6 +77,8 @@ namespace McMd
       myParam_.allocate(nParameter_);
       lowerParam_.allocate(nParameter_);
       upperParam_.allocate(nParameter_);
+      partnerParams_.allocate(2, nParameter_);
+      differences_.allocate(2);
    }
 
    /*
@@ -199,10 +203,14 @@ namespace McMd
             myParam_[i] = system().perturbation().parameter(i);
             lowerParam_[i] = system().perturbation().parameter(i,lowerId_);
             upperParam_[i] = system().perturbation().parameter(i,upperId_);
+            partnerParams_(0, i) = upperParam_[i];
+            partnerParams_(1, i) = lowerParam_[i];
          }
 
-         myArg_ = system().perturbation().difference(upperParam_);
-         lowerArg_ = system().perturbation().difference(lowerParam_);
+         // Evaluate both differences in a single pass
+         system().perturbation().differences(partnerParams_, differences_);
+         myArg_ = differences_[0];
+         lowerArg_ = differences_[1];
 
          myArg_ -= shift_;
          lowerArg_ += lowerShift_;
@@ -15,6 +15,7 @@
 #include <util/accumulators/Average.h>          // member
 #ifdef UTIL_MPI
 #include <util/containers/DArray.h>
+#include <util/containers/DMatrix.h>
 #include <util/mpi/MpiSendRecv.h>
 #include <util/mpi/MpiLogger.h>
 #endif
@@ -140,6 +141,12 @@ namespace McMd
       /// Tempering variable of upper replica.
       DArray<double> upperParam_;
 
+      /// Tempering variables of upper (row 0) and lower (row 1) replicas.
+      DMatrix<double> partnerParams_;
+
+      /// Differences W(partner) - W(current) for rows of partnerParams_.
+      DArray<double> differences_;
+
       /// Number of samples per block average output.
       int nSamplePerBlock_;
 
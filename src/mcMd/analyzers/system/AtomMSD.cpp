@@ -28,6 +28,7 @@ namespace McMd
     : SystemAnalyzer<System>(system),
       outputFile_(),
       accumulator_(),
+      orderNAccumulator_(),
       truePositions_(),
       oldPositions_(),
       shifts_(),
@@ -35,6 +36,7 @@ namespace McMd
       atomId_(-1),
       nMolecule_(-1),
       capacity_(-1),
+      nLevel_(0),
       isInitialized_(false)
    {  setClassName("AtomMSD"); }
 
@@ -50,6 +52,8 @@ namespace McMd
       read<int>(in, "speciesId", speciesId_);
       read<int>(in, "atomId", atomId_);
       read<int>(in, "capacity", capacity_);
+      nLevel_ = 0;
+      readOptional<int>(in, "nLevel", nLevel_);
 
       // Validate parameters
       if (speciesId_ < 0)
@@ -60,6 +64,8 @@ namespace McMd
          UTIL_THROW("Negative atomId");
       if (capacity_ <= 0)       
          UTIL_THROW("Negative capacity");
+      if (nLevel_ < 0)
+         UTIL_THROW("Negative nLevel");
 
       Species* speciesPtr = &system().simulation().species(speciesId_);
 
@@ -74,8 +80,12 @@ namespace McMd
       oldPositions_.allocate(speciesCapacity);
       shifts_.allocate(speciesCapacity);
 
-      // Allocate memory for the AutoCorrArray accumulator
-      accumulator_.setParam(speciesCapacity, capacity_);
+      // Allocate memory for the accumulator
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setParam(speciesCapacity, capacity_, nLevel_);
+      } else {
+         accumulator_.setParam(speciesCapacity, capacity_);
+      }
 
       isInitialized_ = true;
    }
@@ -90,6 +100,8 @@ namespace McMd
       loadParameter<int>(ar, "speciesId", speciesId_);
       loadParameter<int>(ar, "atomId", atomId_);
       loadParameter<int>(ar, "capacity", capacity_);
+      nLevel_ = 0;
+      loadParameter<int>(ar, "nLevel", nLevel_, false);
 
       // Validate parameters
       if (speciesId_ < 0)
@@ -114,10 +126,14 @@ namespace McMd
       oldPositions_.allocate(speciesCapacity);
       shifts_.allocate(speciesCapacity);
 
-      // Allocate memory for the AutoCorrArray accumulator
-      accumulator_.setParam(speciesCapacity, capacity_);
-
-      ar & accumulator_;
+      // Allocate memory for the accumulator, and load its state
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setParam(speciesCapacity, capacity_, nLevel_);
+         ar & orderNAccumulator_;
+      } else {
+         accumulator_.setParam(speciesCapacity, capacity_);
+         ar & accumulator_;
+      }
       ar & truePositions_;
       ar & oldPositions_;
       ar & shifts_;
@@ -130,7 +146,23 @@ namespace McMd
    * Save state to archive.
    */
    void AtomMSD::save(Serializable::OArchive& ar)
-   { ar & (*this); }
+   {
+      Analyzer::save(ar);
+      ar & speciesId_;
+      ar & atomId_;
+      ar & capacity_;
+      bool isActive = (nLevel_ > 0);
+      Parameter::saveOptional(ar, nLevel_, isActive);
+      if (isActive) {
+         ar & orderNAccumulator_;
+      } else {
+         ar & accumulator_;
+      }
+      ar & truePositions_;
+      ar & oldPositions_;
+      ar & shifts_;
+      ar & nMolecule_;
+   }
 
    /*
    * Initialize at beginning of simulation.
@@ -143,8 +175,13 @@ namespace McMd
 
       // Set number of molecules of this species in the System. 
       nMolecule_ = system().nMolecule(speciesId_);
-      accumulator_.setNEnsemble(nMolecule_);
-      accumulator_.clear();
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setNEnsemble(nMolecule_);
+         orderNAccumulator_.clear();
+      } else {
+         accumulator_.setNEnsemble(nMolecule_);
+         accumulator_.clear();
+      }
 
       // Store initial positions, and set initial shift vectors.
       Vector r;
@@ -196,7 +233,11 @@ namespace McMd
          oldPositions_[i] = r;
   
       }
-      accumulator_.sample(truePositions_);
+      if (nLevel_ > 0) {
+         orderNAccumulator_.sample(truePositions_);
+      } else {
+         accumulator_.sample(truePositions_);
+      }
 
    }
 
@@ -209,12 +250,23 @@ namespace McMd
       writeParam(outputFile_); 
       outputFile_ << std::endl;
       outputFile_ << std::endl;
-      outputFile_ << "nMolecule      " << accumulator_.nEnsemble() 
-                  << std::endl;
-      outputFile_ << "buffercapacity " << accumulator_.bufferCapacity()  
-                  << std::endl;
-      outputFile_ << "nSample        " << accumulator_.nSample() 
-                  << std::endl;
+      if (nLevel_ > 0) {
+         outputFile_ << "nMolecule      " << orderNAccumulator_.nEnsemble() 
+                     << std::endl;
+         outputFile_ << "blockLength    " << orderNAccumulator_.blockLength()
+                     << std::endl;
+         outputFile_ << "nLevel         " << orderNAccumulator_.nLevel()
+                     << std::endl;
+         outputFile_ << "nSample        " << orderNAccumulator_.nSample() 
+                     << std::endl;
+      } else {
+         outputFile_ << "nMolecule      " << accumulator_.nEnsemble() 
+                     << std::endl;
+         outputFile_ << "buffercapacity " << accumulator_.bufferCapacity()  
+                     << std::endl;
+         outputFile_ << "nSample        " << accumulator_.nSample() 
+                     << std::endl;
+      }
       outputFile_ << std::endl;
       //outputFile_ << "Format of *.dat file:" << std::endl;
       //outputFile_ << "[i]  [MSD]" << std::endl;
@@ -222,7 +274,11 @@ namespace McMd
 
       // Output statistical analysis to separate data file
       fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
-      accumulator_.output(outputFile_); 
+      if (nLevel_ > 0) {
+         orderNAccumulator_.output(outputFile_); 
+      } else {
+         accumulator_.output(outputFile_); 
+      }
       outputFile_.close();
 
    }
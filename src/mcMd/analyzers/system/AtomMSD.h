@@ -11,6 +11,7 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>  // base class template
 #include <mcMd/simulation/System.h>             // base class template parameter
 #include <util/accumulators/MeanSqDispArray.h>  // member template 
+#include <mcMd/analyzers/util/OrderNMeanSqDisp.h>  // member
 #include <util/space/Vector.h>                   // member template parameter
 #include <util/containers/DArray.h>             // member template
 
@@ -58,15 +59,6 @@ namespace McMd
       */
       virtual void save(Serializable::OArchive& ar);
 
-      /**
-      * Serialize to/from an archive. 
-      *
-      * \param ar      saving or loading archive
-      * \param version archive version id
-      */
-      template <class Archive>
-      void serialize(Archive& ar, const unsigned int version);
-
       /** 
       * Determine number of molecules and allocate memory.
       */
@@ -93,6 +85,9 @@ namespace McMd
       /// Statistical accumulator
       MeanSqDispArray<Vector> accumulator_;
 
+      /// Order-n statistical accumulator, used if nLevel_ > 0
+      OrderNMeanSqDisp orderNAccumulator_;
+
       /// Array of position vectors, one per molecule of species.
       DArray<Vector>    truePositions_;
    
@@ -113,28 +108,14 @@ namespace McMd
    
       /// Maximum length of each sequence in AutoCorrArray.
       int     capacity_;
+
+      /// Number of levels of order-n accumulator (0 if not used).
+      int     nLevel_;
    
       /// Has readParam been called?
       int     isInitialized_;
    
    };
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void AtomMSD::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & speciesId_;
-      ar & atomId_;
-      ar & capacity_;
-      ar & accumulator_;
-      ar & truePositions_;
-      ar & oldPositions_;
-      ar & shifts_;
-      ar & nMolecule_;
-   }
-
 }
 #endif
@@ -15,6 +15,9 @@
 #include <util/archives/Serializable_includes.h>
 
 #include <util/format/Dbl.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace McMd
 {
@@ -26,11 +29,8 @@ namespace McMd
     : SystemAnalyzer<System>(system),
       outputFile_(),
       accumulators_(),
-      positions_(),
-      rCom_(),
-      iTypeNAtom_(),
-      dRSq_(),
-      dRSqPair_(),
+      threadSums_(),
+      sums_(),
       speciesPtr_(0),
       nAtomType_(-1),
       nAtomTypePairs_(-1),
@@ -77,18 +77,7 @@ namespace McMd
       speciesPtr_ = &system().simulation().species(speciesId_);
       nAtom_ = speciesPtr_->nAtom();
 
-      // Allocate an array of separation Vectors
-      positions_.allocate(nAtom_); 
-      
-      // Allocate an array of center of mass position vectors
-      rCom_.allocate(nAtomType_); 
-      
-      // Allocate an array of number of atoms in blocks of different types
-      iTypeNAtom_.allocate(nAtomType_); 
-
-      dRSq_.allocate(nAtomType_);
-      dRSqPair_.allocate(nAtomTypePairs_);
- 
+      sums_.allocate(nAtomType_, nAtom_);
       isInitialized_ = true;
    }
 
@@ -134,11 +123,7 @@ namespace McMd
       }
 
       // Allocate
-      positions_.allocate(nAtom_); 
-      rCom_.allocate(nAtomType_); 
-      iTypeNAtom_.allocate(nAtomType_); 
-      dRSq_.allocate(nAtomType_);
-      dRSqPair_.allocate(nAtomTypePairs_);
+      sums_.allocate(nAtomType_, nAtom_);
       accumulators_.allocate(nAtomType_ + nAtomTypePairs_);
       for (int i = 0; i < nAtomType_+nAtomTypePairs_; ++i) {
          accumulators_[i].setNSamplePerBlock(nSamplePerBlock_);
@@ -160,100 +145,100 @@ namespace McMd
    { ar & *this; }
 
    /*
-   * Clear accumulators.
+   * Clear accumulators, and allocate per-thread sums.
    */
    void BlockRadiusGyration::setup() 
    {  
       if (!isInitialized_) UTIL_THROW("Object is not initialized");
 
+      int nThread = 1;
+      #ifdef MCMD_OPENMP
+      nThread = omp_get_max_threads();
+      #endif
+      if (threadSums_.isAllocated()) {
+         if (threadSums_.capacity() != nThread) {
+            threadSums_.deallocate();
+         }
+      }
+      if (!threadSums_.isAllocated()) {
+         threadSums_.allocate(nThread);
+      }
+      for (int t = 0; t < nThread; ++t) {
+         threadSums_[t].allocate(nAtomType_, nAtom_);
+      }
+
       for (int i = 0; i < nAtomType_ + nAtomTypePairs_; ++i) {
          accumulators_[i].clear(); 
       }
    }
 
    /* 
-   * Evaluate end-to-end vectors of all chains, add to ensemble.
+   * Evaluate block radii of gyration of all molecules, add to ensemble.
    */
    void BlockRadiusGyration::sample(long iStep) 
    { 
-      if (isAtInterval(iStep))  {
+      if (!isAtInterval(iStep)) return;
 
-         Molecule* moleculePtr;
-         Vector    r1, r2, dR;
-         int       i, j, k, l, m, typeId, nMolecule;
+      int nMolecule = system().nMolecule(speciesId_);
+      int nThread = threadSums_.capacity();
 
-         k = 0;
-         for (i = 0; i < nAtomType_; ++i) {
-            dRSq_[i] = 0.0;
-            iTypeNAtom_[i] = 0;
-            for (j = i+1; j < nAtomType_; ++j) { 
-               ++k;
-               dRSqPair_[k-1] = 0.0;
-            }
-         }
+      // Accumulate sums for a subset of molecules in each thread
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef MCMD_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         BlockGyration& sums = threadSums_[threadId];
+         const Boundary& boundary = system().boundary();
+         const Molecule* moleculePtr;
+         Vector dR;
+         int i, j;
 
-         nMolecule = system().nMolecule(speciesId_);
-         moleculePtr = &system().molecule(speciesId_,0);
-         for (j = 0 ; j < nAtom_; j++) {
-            typeId = moleculePtr->atom(j).typeId(); 
-            iTypeNAtom_[typeId] += 1;
-         }
- 
-         for (i = 0; i < system().nMolecule(speciesId_); i++) {
+         sums.clear();
+         #ifdef MCMD_OPENMP
+         #pragma omp for schedule(static)
+         #endif
+         for (i = 0; i < nMolecule; ++i) {
             moleculePtr = &system().molecule(speciesId_, i);
 
-            // Initializing COM positions for different types to zero
-            for (j = 0; j < nAtomType_; ++j) {
-               rCom_[j].zero();
-            }
-
             // Construct map of molecule with no periodic boundary conditions
-            positions_[0] = moleculePtr->atom(0).position();
-            typeId = moleculePtr->atom(0).typeId();
-            rCom_[typeId] += positions_[0];
-            for (j = 1 ; j < nAtom_; j++) {
-               typeId = moleculePtr->atom(j).typeId(); 
-               r1 = moleculePtr->atom(j-1).position();
-               r2 = moleculePtr->atom(j).position();
-               system().boundary().distanceSq(r1, r2, dR);
-               positions_[j]  = positions_[j-1];
-               positions_[j] += dR;
-               rCom_[typeId] += positions_[j];
-            }
-            for (l = 0; l < nAtomType_; ++l) {
-               rCom_[l] /= double(iTypeNAtom_[l]);
-            }
-            k = 0;
-            for (l = 0; l < nAtomType_; ++l) {
-               for (m = l+1; m < nAtomType_; ++m) {
-                  ++k;
-                  dR.subtract(rCom_[l], rCom_[m]);
-                  dRSqPair_[k-1] += dR.square();
-               }  
-            }
-            for (j = 0 ; j < nAtom_; j++) {
-               typeId = moleculePtr->atom(j).typeId();
-               dR.subtract(positions_[j], rCom_[typeId]);
-               dRSq_[typeId] += dR.square();
-            }
-     
-         }
-         k = 0;
-         for (i = 0; i < nAtomType_; ++i) {
-            dRSq_[i] /= double(nMolecule);
-            dRSq_[i] /= double(iTypeNAtom_[i]);
-            accumulators_[i].sample(dRSq_[i]);
-            outputFile_ << Dbl(dRSq_[i]) << "	";
-            for (j = i+1; j < nAtomType_; ++j) {
-               ++k;
-               dRSqPair_[k-1] /= double(nMolecule);
-               accumulators_[nAtomType_+k-1].sample(dRSqPair_[k-1]);
-               outputFile_ << Dbl(dRSqPair_[k-1]) << "	";
+            sums.position(0) = moleculePtr->atom(0).position();
+            sums.typeId(0) = moleculePtr->atom(0).typeId();
+            for (j = 1 ; j < nAtom_; ++j) {
+               boundary.distanceSq(moleculePtr->atom(j-1).position(),
+                                   moleculePtr->atom(j).position(), dR);
+               sums.position(j) = sums.position(j-1);
+               sums.position(j) += dR;
+               sums.typeId(j) = moleculePtr->atom(j).typeId();
             }
+            sums.addMolecule(nAtom_);
          }
-         outputFile_ << std::endl;
-      } // if isAtInterval
+      }
 
+      // Combine thread sums, in thread order
+      sums_.clear();
+      for (int t = 0; t < nThread; ++t) {
+         sums_.add(threadSums_[t]);
+      }
+
+      double value;
+      int i, j, k;
+      k = 0;
+      for (i = 0; i < nAtomType_; ++i) {
+         value = sums_.radiusSq(i);
+         accumulators_[i].sample(value);
+         outputFile_ << Dbl(value) << "	";
+         for (j = i+1; j < nAtomType_; ++j) {
+            ++k;
+            value = sums_.distanceSq(i, j);
+            accumulators_[nAtomType_+k-1].sample(value);
+            outputFile_ << Dbl(value) << "	";
+         }
+      }
+      outputFile_ << std::endl;
    }
 
    /*
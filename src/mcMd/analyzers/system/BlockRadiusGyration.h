@@ -13,6 +13,7 @@
 #include <util/accumulators/Average.h>     // member
 #include <util/containers/DArray.h>        // member template
 #include <util/space/Vector.h>             // member template parameter
+#include <simp/analysis/BlockGyration.h>   // member
 
 #include <cstdio> 
 #include <cstring> 
@@ -127,20 +128,11 @@ namespace McMd
       /// Array of Average objects - statistical accumulators.
       DArray<Average>  accumulators_;
 
-      /// Array of positions for all atoms in a molecule
-      DArray<Vector> positions_;
-      
-      /// Array of center of mass vectors for blocks of different types
-      DArray<Vector> rCom_;
-      
-      /// Array of number of atoms in blocks of different types
-      DArray<int>  iTypeNAtom_;
-      
-      /// Values of dRSq for atom types i=j (temporary storage)
-      DArray<double> dRSq_; 
+      /// Sums over molecules of one sample, one per thread.
+      DArray<BlockGyration> threadSums_;
 
-      /// Values of dRSq for atom types i !=j (not persistent)
-      DArray<double> dRSqPair_;  
+      /// Sums over all molecules of one sample (sum of threadSums_).
+      BlockGyration sums_;
 
       /// Pointer to relevant Species.
       Species*  speciesPtr_;
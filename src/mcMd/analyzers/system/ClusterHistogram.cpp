@@ -39,6 +39,7 @@ namespace McMd
       speciesId_(),
       atomTypeId_(),
       cutoff_(),
+      skin_(0.0),
       histMin_(),
       histMax_(),
       nSample_(0),
@@ -70,9 +71,14 @@ namespace McMd
       if (cutoff_ < 0) {
          UTIL_THROW("Negative cutoff");
       }
+      skin_ = 0.0;
+      readOptional<double>(in, "skin", skin_);
+      if (skin_ < 0) {
+         UTIL_THROW("Negative skin");
+      }
 
       // Initialize ClusterIdentifier
-      identifier_.initialize(speciesId_, atomTypeId_, cutoff_);
+      identifier_.initialize(speciesId_, atomTypeId_, cutoff_, skin_);
       read<int>(in,"histMin", histMin_);
       read<int>(in,"histMax", histMax_);
       hist_.setParam(histMin_, histMax_);
@@ -106,8 +112,10 @@ namespace McMd
       if (cutoff_ < 0) {
          UTIL_THROW("Negative cutoff");
       }
+      skin_ = 0.0;
+      loadParameter<double>(ar, "skin", skin_, false);
 
-      identifier_.initialize(speciesId_, atomTypeId_, cutoff_);
+      identifier_.initialize(speciesId_, atomTypeId_, cutoff_, skin_);
       loadParameter<int>(ar, "histMin", histMin_);
       loadParameter<int>(ar, "histMax", histMax_);
       ar >> hist_;
@@ -126,6 +134,8 @@ namespace McMd
       ar & speciesId_;
       ar & atomTypeId_;
       ar & cutoff_;
+      bool isActive = (skin_ > 0.0);
+      Parameter::saveOptional(ar, skin_, isActive);
       ar & histMin_;
       ar & histMax_;
       ar & hist_;
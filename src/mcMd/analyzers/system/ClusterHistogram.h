@@ -44,6 +44,7 @@ namespace McMd
       *   - int    speciesId        : integer id for Species of interest
       *   - int    atomTypeId       : integer id for core atom type
       *   - double cutoff           : distance cutoff
+      *   - double skin             : pair list skin (optional)
       *
       * \param in parameter input stream
       */
@@ -106,6 +107,9 @@ namespace McMd
       /// Distance cutoff
       double cutoff_;
 
+      /// Extra distance for reuse of candidate pairs (optional)
+      double skin_;
+
       /// Histogram minimum value
       int  histMin_;
 
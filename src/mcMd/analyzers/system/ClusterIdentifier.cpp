@@ -15,6 +15,9 @@
 #include <mcMd/chemistry/Molecule.h>
 #include <mcMd/chemistry/Atom.h>
 #include <util/boundary/Boundary.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace McMd
 {
@@ -27,12 +30,19 @@ namespace McMd
    ClusterIdentifier::ClusterIdentifier(System& system)
     : links_(),
       clusters_(),
-      workStack_(),
+      parents_(),
+      rootClusters_(),
+      threadPairs_(),
+      oldPositions_(),
+      oldLengths_(),
       cellList_(),
       systemPtr_(&system),
       speciesId_(),
       atomTypeId_(),
-      cutoff_()
+      cutoff_(),
+      skin_(0.0),
+      oldNMolecule_(-1),
+      hasPairs_(false)
    {}
 
    /*
@@ -45,20 +55,33 @@ namespace McMd
    * Initial setup.
    */
    void
-   ClusterIdentifier::initialize(int speciesId, int atomTypeId, double cutoff)
+   ClusterIdentifier::initialize(int speciesId, int atomTypeId, double cutoff,
+                                 double skin)
    {
       // Set member variables
       speciesId_ = speciesId;
       atomTypeId_ = atomTypeId;
       cutoff_ = cutoff;
+      skin_ = skin;
+      hasPairs_ = false;
 
       // Allocate memory
       Species* speciesPtr = &system().simulation().species(speciesId);
       int moleculeCapacity = speciesPtr->capacity();
-      links_.allocate(moleculeCapacity);
-      clusters_.reserve(64);
-      int atomCapacity = system().simulation().atomCapacity();
-      cellList_.setAtomCapacity(atomCapacity);
+      if (!links_.isAllocated()) {
+         links_.allocate(moleculeCapacity);
+         parents_.allocate(moleculeCapacity);
+         rootClusters_.allocate(moleculeCapacity);
+         clusters_.reserve(64);
+         int atomCapacity = system().simulation().atomCapacity();
+         cellList_.setAtomCapacity(atomCapacity);
+         oldPositions_.allocate(atomCapacity);
+         int nThread = 1;
+         #ifdef MCMD_OPENMP
+         nThread = omp_get_max_threads();
+         #endif
+         threadPairs_.allocate(nThread);
+      }
 
       // Note: We must set the cellist atom capacity to the total atom capacity,
       // even though we are only interested in clusters of one species, because 
@@ -66,60 +89,127 @@ namespace McMd
    }
 
    /*
-   * Pop and process the next molecule on the workStack (private).
+   * Check if candidate pairs may be reused (private).
    */
-   void ClusterIdentifier::processNextMolecule(Cluster& cluster)
+   bool ClusterIdentifier::isPairListCurrent()
    {
-      CellList::NeighborArray neighborArray;
+      if (!hasPairs_ || skin_ <= 0.0) return false;
+      if (system().nMolecule(speciesId_) != oldNMolecule_) return false;
+      Boundary& boundary = system().boundary();
+      Vector lengths = boundary.lengths();
+      for (int j = 0; j < Dimension; ++j) {
+         if (lengths[j] != oldLengths_[j]) return false;
+      }
+
+      // Check displacements of core atoms
+      System::MoleculeIterator molIter;
       Molecule::AtomIterator atomIter;
-      ClusterLink* thisLinkPtr;
-      ClusterLink* otherLinkPtr;
-      Atom* otherAtomPtr;
+      double maxSq = 0.25*skin_*skin_;
+      system().begin(speciesId_, molIter);
+      for ( ; molIter.notEnd(); ++molIter) {
+         for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+            if (atomIter->typeId() == atomTypeId_) {
+               if (boundary.distanceSq(atomIter->position(), 
+                       oldPositions_[atomIter->id()]) > maxSq) {
+                  return false;
+               }
+            }
+         }
+      }
+      return true;
+   }
+
+   /*
+   * Build the cell list, and find candidate pairs of core atoms (private).
+   */
+   void ClusterIdentifier::buildPairList()
+   {
       Boundary& boundary = system().boundary();
-      double cutoffSq = cutoff_*cutoff_;
-      double rsq;
-      int thisMolId, otherMolId, otherClusterId;
-
-      // Pop this molecule off the stack
-      thisLinkPtr = &workStack_.pop();
-      thisMolId = thisLinkPtr->molecule().id();
-      if (thisLinkPtr->clusterId() != cluster.id()) {
-         UTIL_THROW("Top ClusterLink not marked with this cluster id");
+      double pairCutoff = cutoff_ + skin_;
+
+      // Setup a grid of empty cells
+      cellList_.setup(boundary, pairCutoff);
+
+      // Add atoms of type = atomTypeId_ to the CellList
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      system().begin(speciesId_, molIter);
+      for ( ; molIter.notEnd(); ++molIter) {
+         for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+            if (atomIter->typeId() == atomTypeId_) {
+               boundary.shift(atomIter->position());
+               cellList_.addAtom(*atomIter);
+               oldPositions_[atomIter->id()] = atomIter->position();
+            }
+         }
       }
 
-      /*
-      * Loop over atoms of this molecule.
-      * For each atom of type atomTypeId_, find neighboring molecules.
-      * Add each new neighbor to the cluster, and to the workStack.
-      */
-      thisLinkPtr->molecule().begin(atomIter); 
-      for ( ; atomIter.notEnd(); ++atomIter) {
-         if (atomIter->typeId() == atomTypeId_) {
-            cellList_.getNeighbors(atomIter->position(), neighborArray);
-            for (int i = 0; i < neighborArray.size(); i++) {
-               otherAtomPtr = neighborArray[i];
-               otherMolId = otherAtomPtr->molecule().id();
-               if (otherMolId != thisMolId) {
-                  rsq = boundary.distanceSq(atomIter->position(),
-                                            otherAtomPtr->position());
-                  if (rsq < cutoffSq) {
-                     otherLinkPtr = &(links_[otherMolId]);
-                     assert(&otherLinkPtr->molecule() ==
-                            &otherAtomPtr->molecule());
-                     otherClusterId = otherLinkPtr->clusterId();
-                     if (otherClusterId == -1) {
-                        cluster.addLink(*otherLinkPtr);
-                        workStack_.push(*otherLinkPtr);
-                     } else
-                     if (otherClusterId != cluster.id()) {
-                        UTIL_THROW("Cluster Clash!");
+      // Sweep over pairs of neighboring cells
+      double pairCutoffSq = pairCutoff*pairCutoff;
+      int nCell = cellList_.totCells();
+      int nNeighborCell = cellList_.nNeighborCell();
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef MCMD_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         GArray< Pair<Atom*> >& pairs = threadPairs_[threadId];
+         Pair<Atom*> pair;
+         const Cell* cellPtr;
+         const Cell* otherCellPtr;
+         Atom* atomPtr;
+         Atom* otherPtr;
+         int ic, jc, ia, ja;
+
+         pairs.clear();
+         #ifdef MCMD_OPENMP
+         #pragma omp for schedule(dynamic, 16)
+         #endif
+         for (ic = 0; ic < nCell; ++ic) {
+            cellPtr = &cellList_.cell(ic);
+            for (ia = 0; ia < cellPtr->firstClearPos(); ++ia) {
+               atomPtr = cellPtr->atomPtr(ia);
+               if (atomPtr == 0) continue;
+               for (jc = 0; jc < nNeighborCell; ++jc) {
+                  otherCellPtr = &cellList_.neighborCell(ic, jc);
+                  for (ja = 0; ja < otherCellPtr->firstClearPos(); ++ja) {
+                     otherPtr = otherCellPtr->atomPtr(ja);
+                     if (otherPtr == 0) continue;
+                     if (otherPtr->id() <= atomPtr->id()) continue;
+                     if (&otherPtr->molecule() == &atomPtr->molecule()) {
+                        continue;
+                     }
+                     if (boundary.distanceSq(atomPtr->position(),
+                             otherPtr->position()) < pairCutoffSq) {
+                        pair[0] = atomPtr;
+                        pair[1] = otherPtr;
+                        pairs.append(pair);
                      }
                   }
                }
-            } // neighbor atoms
+            }
          }
-      } // atoms
+      }
 
+      oldLengths_ = boundary.lengths();
+      oldNMolecule_ = system().nMolecule(speciesId_);
+      hasPairs_ = true;
+   }
+
+   /*
+   * Find root of the set containing a molecule, halving paths (private).
+   */
+   inline int ClusterIdentifier::findRoot(int moleculeId)
+   {
+      int id = moleculeId;
+      while (parents_[id] != id) {
+         parents_[id] = parents_[parents_[id]];
+         id = parents_[id];
+      }
+      return id;
    }
 
    /*
@@ -127,66 +217,68 @@ namespace McMd
    */
    void ClusterIdentifier::identifyClusters()
    {
+      // Find candidate pairs of core atoms, unless they can be reused.
+      if (!isPairListCurrent()) {
+         buildPairList();
+      }
 
-      // Initialize all data structures:
-      // Setup a grid of empty cells
-      cellList_.setup(system().boundary(), cutoff_);
       // Clear clusters array and all links
       clusters_.clear();
       for (int i = 0; i < links_.capacity(); ++i) {
          links_[i].clear();
       }
 
-      // Build the cellList, associate Molecule with ClusterLink.
-      // Iterate over molecules of species speciesId_
+      // Associate each Molecule with a ClusterLink, and a singleton set
       System::MoleculeIterator molIter;
-      Molecule::AtomIterator atomIter;
+      int molId;
       system().begin(speciesId_, molIter);
       for ( ; molIter.notEnd(); ++molIter) {
+         molId = molIter->id();
+         links_[molId].setMolecule(*molIter.get());
+         parents_[molId] = molId;
+         rootClusters_[molId] = -1;
+      }
 
-         // Associate this Molecule with a ClusterLink
-         links_[molIter->id()].setMolecule(*molIter.get());
-
-         // Add atoms of type = atomTypeId_ to the CellList
-         for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
-            if (atomIter->typeId() == atomTypeId_) {
-               system().boundary().shift(atomIter->position());
-               cellList_.addAtom(*atomIter);
+      // Merge sets of molecules with core atoms closer than cutoff
+      Boundary& boundary = system().boundary();
+      double cutoffSq = cutoff_*cutoff_;
+      int root1, root2, i, j;
+      for (i = 0; i < threadPairs_.capacity(); ++i) {
+         const GArray< Pair<Atom*> >& pairs = threadPairs_[i];
+         for (j = 0; j < pairs.size(); ++j) {
+            const Pair<Atom*>& pair = pairs[j];
+            if (boundary.distanceSq(pair[0]->position(), 
+                                    pair[1]->position()) < cutoffSq) {
+               root1 = findRoot(pair[0]->molecule().id());
+               root2 = findRoot(pair[1]->molecule().id());
+               if (root1 != root2) {
+                  if (root1 < root2) {
+                     parents_[root2] = root1;
+                  } else {
+                     parents_[root1] = root2;
+                  }
+               }
             }
-
          }
       }
 
-      // Identify all clusters
+      // Create one cluster per set, in order of first molecule
       Cluster* clusterPtr;
-      ClusterLink* linkPtr;
-      int clusterId = 0;
+      int root, clusterId;
       system().begin(speciesId_, molIter);
       for ( ; molIter.notEnd(); ++molIter) {
-
-         // Find the link with same index as this molecule
-         linkPtr = &(links_[molIter->id()]);
-         assert (&(linkPtr->molecule()) == molIter.get());
-
-         // If this link is not in a cluster, begin a new cluster
-         if (linkPtr->clusterId() == -1) {
-
-            // Add a new empty cluster to clusters_ array
+         molId = molIter->id();
+         root = findRoot(molId);
+         clusterId = rootClusters_[root];
+         if (clusterId == -1) {
+            clusterId = clusters_.size();
             clusters_.resize(clusterId+1);
             clusterPtr = &clusters_[clusterId];
             clusterPtr->clear();
             clusterPtr->setId(clusterId);
-
-            // Identify molecules in this cluster
-            clusterPtr->addLink(*linkPtr);
-            workStack_.push(*linkPtr);
-            while (workStack_.size() > 0) {
-               processNextMolecule(*clusterPtr);
-            }
-
-            clusterId++;
+            rootClusters_[root] = clusterId;
          }
-
+         clusters_[clusterId].addLink(links_[molId]);
       }
 
       // Validity check - throws exception on failure.
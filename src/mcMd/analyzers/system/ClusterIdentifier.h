@@ -14,7 +14,8 @@
 #include <util/boundary/Boundary.h>              // argument (typedef)
 #include <util/containers/DArray.h>              // member template
 #include <util/containers/GArray.h>              // member template
-#include <util/containers/GStack.h>              // member template
+#include <util/containers/Pair.h>                // member template argument
+#include <util/space/Vector.h>                   // member template argument
 
 namespace Simp {
    class Species;
@@ -24,12 +25,28 @@ namespace McMd
 {
 
    class System;
+   class Atom;
 
    using namespace Util;
    using namespace Simp;
 
    /**
    * Identifies clusters of molecules, such as micelles.
+   *
+   * Two molecules are in the same cluster if they are connected by
+   * a path of pairs of core atoms (atoms of type atomTypeId) that
+   * are separated by less than cutoff. Clusters are identified by a
+   * union-find (disjoint set) algorithm over a list of candidate pairs
+   * of core atoms in different molecules. Candidate pairs are found by
+   * a sweep over pairs of neighboring cells of a cell list, which is
+   * threaded over cells when compiled with MCMD_OPENMP.
+   *
+   * If a positive skin is given to initialize(), candidate pairs are
+   * found using an extended cutoff + skin, and the list is reused in
+   * later calls to identifyClusters() until some core atom has moved
+   * more than skin/2 since the list was built, or the boundary or
+   * number of molecules has changed. Only the distances of candidate
+   * pairs must then be recomputed.
    */
    class ClusterIdentifier 
    {
@@ -54,9 +71,11 @@ namespace McMd
       * \param speciesId index of species in clusters
       * \param atomTypeId typeId of atoms in micelle core
       * \param cutoff pair distance cutoff
+      * \param skin extra distance for reuse of candidate pairs
       */
       virtual 
-      void initialize(int speciesId, int atomTypeId, double cutoff);
+      void initialize(int speciesId, int atomTypeId, double cutoff, 
+                      double skin = 0.0);
    
       /**
       * Identify all clusters (main operation).
@@ -102,8 +121,20 @@ namespace McMd
       /// Growable array of clusters.
       GArray<Cluster> clusters_;
 
-      /// Work stack of unprocessed cluster links.
-      GStack<ClusterLink>  workStack_;
+      /// Union-find parent of each molecule, indexed by molecule id.
+      DArray<int> parents_;
+
+      /// Cluster index of each root molecule, indexed by molecule id.
+      DArray<int> rootClusters_;
+
+      /// Candidate pairs of core atoms found by each thread.
+      DArray< GArray< Pair<Atom*> > > threadPairs_;
+
+      /// Positions of core atoms when pairs were found, by atom id.
+      DArray<Vector> oldPositions_;
+
+      /// Boundary lengths when pairs were found.
+      Vector oldLengths_;
 
       /// CellList of atoms of the specified species and atom type.
       CellList cellList_;
@@ -120,6 +151,15 @@ namespace McMd
       /// Cutoff distance for touching cores
       double cutoff_;
 
+      /// Extra pair distance used to allow reuse of candidate pairs
+      double skin_;
+
+      /// Number of molecules when pairs were found
+      int oldNMolecule_;
+
+      /// Are candidate pairs available for reuse?
+      bool hasPairs_;
+
       // Private functions
 
       /**
@@ -129,9 +169,21 @@ namespace McMd
       {  return *systemPtr_; }
 
       /**
-      * Pop and process top ClusterLink in the workStack.
+      * Can the current candidate pairs be reused?
+      */
+      bool isPairListCurrent();
+
+      /**
+      * Build the cell list and find candidate pairs of core atoms.
+      */
+      void buildPairList();
+
+      /**
+      * Return root of the set containing a molecule, compressing paths.
+      *
+      * \param moleculeId id of molecule
       */
-      void processNextMolecule(Cluster& cluster);
+      int findRoot(int moleculeId);
 
    };
 
@@ -28,6 +28,7 @@ namespace McMd
     : SystemAnalyzer<System>(system),
       outputFile_(),
       accumulator_(),
+      orderNAccumulator_(),
       truePositions_(),
       oldPositions_(),
       shifts_(),
@@ -35,6 +36,7 @@ namespace McMd
       nMolecule_(-1),
       nAtom_(-1),
       capacity_(-1),
+      nLevel_(0),
       isInitialized_(false)
    { setClassName("ComMSD"); }
 
@@ -48,12 +50,15 @@ namespace McMd
       readOutputFileName(in);
       read<int>(in, "speciesId", speciesId_);
       read<int>(in, "capacity", capacity_);
+      nLevel_ = 0;
+      readOptional<int>(in, "nLevel", nLevel_);
 
       // Validate parameters
       if (speciesId_ < 0)       UTIL_THROW("Negative speciesId");
       if (speciesId_ >= system().simulation().nSpecies()) 
                                 UTIL_THROW("speciesId > nSpecies");
       if (capacity_ <= 0)       UTIL_THROW("Negative capacity");
+      if (nLevel_ < 0)          UTIL_THROW("Negative nLevel");
 
       // Maximum possible number of molecules of this species
       int speciesCapacity;
@@ -64,8 +69,12 @@ namespace McMd
       oldPositions_.allocate(speciesCapacity);
       shifts_.allocate(speciesCapacity);
 
-      // Allocate memory for the AutoCorrArray accumulator
-      accumulator_.setParam(speciesCapacity, capacity_);
+      // Allocate memory for the accumulator
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setParam(speciesCapacity, capacity_, nLevel_);
+      } else {
+         accumulator_.setParam(speciesCapacity, capacity_);
+      }
 
       // Get number of atoms per molecule.
       nAtom_ = system().simulation().species(speciesId_).nAtom();
@@ -81,6 +90,8 @@ namespace McMd
       Analyzer::loadParameters(ar);
       loadParameter<int>(ar, "speciesId", speciesId_);
       loadParameter<int>(ar, "capacity", capacity_);
+      nLevel_ = 0;
+      loadParameter<int>(ar, "nLevel", nLevel_, false);
       ar & nAtom_;
 
       // Validate parameters
@@ -105,10 +116,15 @@ namespace McMd
       truePositions_.allocate(speciesCapacity);
       oldPositions_.allocate(speciesCapacity);
       shifts_.allocate(speciesCapacity);
-      accumulator_.setParam(speciesCapacity, capacity_);
 
       // Finish reading internal state
-      ar & accumulator_;
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setParam(speciesCapacity, capacity_, nLevel_);
+         ar & orderNAccumulator_;
+      } else {
+         accumulator_.setParam(speciesCapacity, capacity_);
+         ar & accumulator_;
+      }
       ar & truePositions_;
       ar & oldPositions_;
       ar & shifts_;
@@ -119,7 +135,23 @@ namespace McMd
    * Save state to archive.
    */
    void ComMSD::save(Serializable::OArchive& ar)
-   { ar & *this; }
+   {
+      Analyzer::save(ar);
+      ar & speciesId_;
+      ar & capacity_;
+      bool isActive = (nLevel_ > 0);
+      Parameter::saveOptional(ar, nLevel_, isActive);
+      ar & nAtom_;
+      if (isActive) {
+         ar & orderNAccumulator_;
+      } else {
+         ar & accumulator_;
+      }
+      ar & truePositions_;
+      ar & oldPositions_;
+      ar & shifts_;
+      ar & nMolecule_;
+   }
 
    /*
    * Set number of molecules and initialize state.
@@ -134,9 +166,13 @@ namespace McMd
       nMolecule_ = system().nMolecule(speciesId_);
       if (nMolecule_ <= 0)
          UTIL_THROW("nMolecule_ <= 0");
-      accumulator_.setNEnsemble(nMolecule_);
-
-      accumulator_.clear();
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setNEnsemble(nMolecule_);
+         orderNAccumulator_.clear();
+      } else {
+         accumulator_.setNEnsemble(nMolecule_);
+         accumulator_.clear();
+      }
 
       // Store initial positions, and set initial shift vectors.
       Vector r;
@@ -191,7 +227,11 @@ namespace McMd
          }
  
       }
-      accumulator_.sample(truePositions_);
+      if (nLevel_ > 0) {
+         orderNAccumulator_.sample(truePositions_);
+      } else {
+         accumulator_.sample(truePositions_);
+      }
 
    }
 
@@ -206,19 +246,38 @@ namespace McMd
       writeParam(outputFile_); 
       outputFile_ << std::endl;
       outputFile_ << std::endl;
-      outputFile_ << "nMolecule      " << accumulator_.nEnsemble() << std::endl;
-      outputFile_ << "bufferCapacity " << accumulator_.bufferCapacity() 
-                  << std::endl;
-      outputFile_ << "nSample        " << accumulator_.nSample()   << std::endl;
-      outputFile_ << std::endl;
-      outputFile_ << "Format of *.dat file:" << std::endl;
-      outputFile_ << "[i]  [MSD]"
-                  << std::endl;
+      if (nLevel_ > 0) {
+         outputFile_ << "nMolecule      " << orderNAccumulator_.nEnsemble() 
+                     << std::endl;
+         outputFile_ << "blockLength    " << orderNAccumulator_.blockLength()
+                     << std::endl;
+         outputFile_ << "nLevel         " << orderNAccumulator_.nLevel()
+                     << std::endl;
+         outputFile_ << "nSample        " << orderNAccumulator_.nSample()
+                     << std::endl;
+         outputFile_ << std::endl;
+         outputFile_ << "Format of *.dat file:" << std::endl;
+         outputFile_ << "[time lag in samples]  [MSD]"
+                     << std::endl;
+      } else {
+         outputFile_ << "nMolecule      " << accumulator_.nEnsemble() << std::endl;
+         outputFile_ << "bufferCapacity " << accumulator_.bufferCapacity() 
+                     << std::endl;
+         outputFile_ << "nSample        " << accumulator_.nSample()   << std::endl;
+         outputFile_ << std::endl;
+         outputFile_ << "Format of *.dat file:" << std::endl;
+         outputFile_ << "[i]  [MSD]"
+                     << std::endl;
+      }
       outputFile_.close();
 
       // Output statistical analysis to separate data file
       fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
-      accumulator_.output(outputFile_); 
+      if (nLevel_ > 0) {
+         orderNAccumulator_.output(outputFile_); 
+      } else {
+         accumulator_.output(outputFile_); 
+      }
       outputFile_.close();
    }
 
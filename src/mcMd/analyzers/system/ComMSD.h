@@ -11,6 +11,7 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>  // base class template
 #include <mcMd/simulation/System.h>             // base class template parameter
 #include <util/accumulators/MeanSqDispArray.h>  // member template 
+#include <mcMd/analyzers/util/OrderNMeanSqDisp.h>  // member
 #include <util/space/Vector.h>                  // template parameter
 #include <util/space/IntVector.h>               // template parameter
 #include <util/containers/DArray.h>             // member template
@@ -65,15 +66,6 @@ namespace McMd
       */
       virtual void save(Serializable::OArchive& ar);
 
-      /**
-      * Serialize to/from an archive. 
-      *
-      * \param ar      saving or loading archive
-      * \param version archive version id
-      */
-      template <class Archive>
-      void serialize(Archive& ar, const unsigned int version);
-
       /** 
       * Determine number of molecules and allocate memory.
       */
@@ -106,6 +98,9 @@ namespace McMd
       /// Statistical accumulator
       MeanSqDispArray<Vector> accumulator_;
 
+      /// Order-n statistical accumulator, used if nLevel_ > 0
+      OrderNMeanSqDisp orderNAccumulator_;
+
       /// Array of position vectors, one per molecule of species.
       DArray<Vector>    truePositions_;
    
@@ -127,27 +122,13 @@ namespace McMd
       /// Maximum length of each sequence in AutoCorrArray.
       int     capacity_;
 
+      /// Number of levels of order-n accumulator (0 if not used).
+      int     nLevel_;
+
       /// Has readParam been called?
       bool    isInitialized_;
 
    };
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void ComMSD::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & speciesId_;
-      ar & capacity_;
-      ar & nAtom_;
-      ar & accumulator_;
-      ar & truePositions_;
-      ar & oldPositions_;
-      ar & shifts_;
-      ar & nMolecule_;
-   }
-
 }
 #endif
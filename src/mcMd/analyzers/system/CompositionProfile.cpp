@@ -15,6 +15,11 @@
 #include <util/misc/FileMaster.h>
 #include <util/misc/ioUtil.h>
 #include <util/format/Dbl.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
+
+#include <sstream>
 
 namespace McMd
 {
@@ -22,22 +27,22 @@ namespace McMd
    using namespace Util;
 
    /// Constructor.
-   CompositionProfile::CompositionProfile(System& system) 
+   CompositionProfile::CompositionProfile(System& system)
     : SystemAnalyzer<System>(system),
       isFirstStep_(true),
       isInitialized_(false)
    {  setClassName("CompositionProfile"); }
 
-   CompositionProfile::~CompositionProfile() 
+   CompositionProfile::~CompositionProfile()
    {}
 
    /// Read parameters from file, and allocate direction vectors.
-   void CompositionProfile::readParameters(std::istream& in) 
+   void CompositionProfile::readParameters(std::istream& in)
    {
       readInterval(in);
       readOutputFileName(in);
 
-      // Read number of direction vectors and direction vectors 
+      // Read number of direction vectors and direction vectors
       read<int>(in, "nDirection", nDirection_);
       intVectors_.allocate(nDirection_);
       readDArray<IntVector>(in, "intVectors", intVectors_, nDirection_);
@@ -46,8 +51,7 @@ namespace McMd
 
       nAtomType_ = system().simulation().nAtomType();
       waveVectors_.allocate(nDirection_);
-      accumulators_.allocate(nDirection_*nAtomType_);
-      currentAccumulators_.allocate(nDirection_*nAtomType_);
+      accumulator_.allocate(nDirection_, nAtomType_, nBins_);
       logFiles_.allocate(nDirection_*nAtomType_);
 
       isInitialized_ = true;
@@ -60,24 +64,25 @@ namespace McMd
    {
       Analyzer::loadParameters(ar);
       loadParameter<int>(ar, "nDirection", nDirection_);
+      intVectors_.allocate(nDirection_);
       loadDArray<IntVector>(ar, "intVectors", intVectors_, nDirection_);
+      loadParameter<int>(ar, "nBins", nBins_);
       ar & waveVectors_;
-      ar & accumulators_;
+      ar & accumulator_;
       ar & nSample_;
       ar & nAtomType_;
+      ar & isFirstStep_;
 
       if (nAtomType_ != system().simulation().nAtomType()) {
          UTIL_THROW("Inconsistent values for nAtomType_");
       }
-      if (nDirection_ != intVectors_.capacity()) {
-         UTIL_THROW("Inconsistent intVectors capacity");
-      }
       if (nDirection_ != waveVectors_.capacity()) {
          UTIL_THROW("Inconsistent waveVectors capacity");
       }
-      if (nDirection_*nAtomType_ != accumulators_.capacity()) {
-         UTIL_THROW("Inconsistent waveVectors capacity");
+      if (nDirection_*nAtomType_*nBins_ != accumulator_.size()) {
+         UTIL_THROW("Inconsistent accumulator size");
       }
+      logFiles_.allocate(nDirection_*nAtomType_);
 
       isInitialized_ = true;
    }
@@ -86,138 +91,142 @@ namespace McMd
    * Save internal state to an archive.
    */
    void CompositionProfile::save(Serializable::OArchive &ar)
-      {
+   {
       Analyzer::save(ar);
       ar & nDirection_;
       ar & intVectors_;
+      ar & nBins_;
       ar & waveVectors_;
-      ar & accumulators_;
+      ar & accumulator_;
       ar & nSample_;
       ar & nAtomType_;
-      ar & nBins_;
       ar & isFirstStep_;
-      }
+   }
 
    /*
-   * Clear accumulators.
+   * Clear accumulators, and allocate per-thread histograms.
    */
-   void CompositionProfile::setup() 
-   {  
-      double min, max;
-      
-      for (int i=0; i < nDirection_; ++i) {
-         for (int j=0; j < nAtomType_; ++j) {
-
-            min = 0.0;
-            max = 1.0;
-
-            accumulators_[i+j*nDirection_].setParam(min, max, nBins_);
-            currentAccumulators_[i+j*nDirection_].setParam(min, max, nBins_);
-         }
+   void CompositionProfile::setup()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Object is not initialized");
       }
-
       makeWaveVectors();
 
-      // Clear accumulators
-      for (int i = 0; i < nDirection_; ++i) {
-         for (int j = 0; j < nAtomType_; ++j){
-            accumulators_[i+j*nDirection_].clear();
+      int nThread = 1;
+      #ifdef MCMD_OPENMP
+      nThread = omp_get_max_threads();
+      #endif
+      if (threadHistograms_.isAllocated()) {
+         if (threadHistograms_.capacity() != nThread) {
+            threadHistograms_.deallocate();
          }
-      } 
+      }
+      if (!threadHistograms_.isAllocated()) {
+         threadHistograms_.allocate(nThread);
+      }
+      for (int t = 0; t < nThread; ++t) {
+         threadHistograms_[t].allocate(nDirection_, nAtomType_, nBins_);
+      }
+      current_.allocate(nDirection_, nAtomType_, nBins_);
+
+      accumulator_.clear();
       nSample_ = 0;
    }
- 
-   void CompositionProfile::sample(long iStep) 
-   {
-      Vector blengths;
-
-      // Lengths of simulation box
-      blengths = system().boundary().lengths();
-
-      if (isAtInterval(iStep))  {
-         Vector  position;
-         double  product;
-         System::ConstMoleculeIterator  molIter;
-         Molecule::ConstAtomIterator  atomIter;
-         int  nSpecies, iSpecies, typeId;
-
-         // Clear accumulators for the current timestep
-         for (int i = 0; i < nDirection_; ++i) {
-            for (int j = 0; j < nAtomType_; ++j){
-               currentAccumulators_[i+j*nDirection_].clear();
-            }
-         } 
-
-         // Select open mode for output files
-         std::ios_base::openmode mode = std::ios_base::out;
-         if (!isFirstStep_) {
-           mode = std::ios_base::out | std::ios_base::app; 
-         }
 
-         // Open log files
-         for (int i = 0; i < nDirection_; ++i) {
-            for (int j = 0; j < nAtomType_; ++j){
-                std::ostringstream oss;
-                oss << outputFileName();
-                
-                for (int k = 0; k < Dimension; ++k) {
-                    oss << "_" << intVectors_[i][k];
-                }
-                oss << "_type" << j << ".log";
-
-                fileMaster().openOutputFile(oss.str(), 
-                                            logFiles_[i+j*nDirection_], 
-                                            mode);
-            }
+   /*
+   * Add all atoms to histograms, and write histograms of this sample.
+   */
+   void CompositionProfile::sample(long iStep)
+   {
+      if (!isAtInterval(iStep)) return;
+
+      // Coefficients of reduced coordinates, for the current box
+      Vector lengths = system().boundary().lengths();
+      int nThread = threadHistograms_.capacity();
+      int i, j, t;
+      for (t = 0; t < nThread; ++t) {
+         for (i = 0; i < nDirection_; ++i) {
+            threadHistograms_[t].setDirection(i, waveVectors_[i], lengths);
          }
+      }
 
-         // Loop over all atoms
-         nSpecies = system().simulation().nSpecies();
+      // Fill one private histogram per thread
+      int nSpecies = system().simulation().nSpecies();
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef MCMD_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         ProfileHistogram& histogram = threadHistograms_[threadId];
+         const Molecule* molPtr;
+         const Atom* atomPtr;
+         int iSpecies, iMol, nMol, k, nAtom;
+
+         histogram.clear();
          for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
-            system().begin(iSpecies, molIter); 
-          
-            for ( ; molIter.notEnd(); ++molIter) {
-               molIter->begin(atomIter); 
-          
-               for ( ; atomIter.notEnd(); ++atomIter) {
-                  position = atomIter->position();
-                  typeId   = atomIter->typeId();
-                  for (int i = 0; i < Dimension; ++i) {
-                     position[i] /= blengths[i];
-                  }
-	              // Loop over direction vectors
-                  for (int i = 0; i < nDirection_; ++i) {
-                     product = position.dot(waveVectors_[i]);
-                     product /= waveVectors_[i].abs();
-                     accumulators_[i+typeId*nDirection_].sample(product);
-                     currentAccumulators_[i+typeId*nDirection_].sample(product);
-                  }
-		 
+            nMol = system().nMolecule(iSpecies);
+            #ifdef MCMD_OPENMP
+            #pragma omp for schedule(static)
+            #endif
+            for (iMol = 0; iMol < nMol; ++iMol) {
+               molPtr = &system().molecule(iSpecies, iMol);
+               nAtom = molPtr->nAtom();
+               atomPtr = &molPtr->atom(0);
+               for (k = 0; k < nAtom; ++k) {
+                  histogram.sample(atomPtr[k].position(),
+                                   atomPtr[k].typeId());
                }
-  
             }
          }
+      }
 
+      // Sum thread histograms, in thread order
+      current_.clear();
+      for (t = 0; t < nThread; ++t) {
+         current_.add(threadHistograms_[t]);
+      }
+      accumulator_.add(current_);
       ++nSample_;
 
-      // Output to log files
-      for (int i = 0; i < nDirection_; ++i) {
-         for (int j = 0; j < nAtomType_; ++j){
-            currentAccumulators_[i+j*nDirection_].output(logFiles_[i+j*nDirection_]);
-            logFiles_[i+j*nDirection_] << std::endl;
+      // Output histograms of this sample to log files
+      if (!logFiles_[0].is_open()) {
+         openLogFiles();
+      }
+      for (i = 0; i < nDirection_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            current_.output(logFiles_[i+j*nDirection_], i, j);
+            logFiles_[i+j*nDirection_] << "\n";
          }
       }
+      isFirstStep_ = false;
+   }
 
-      // Close log files
+   /*
+   * Open one log file per direction and type (private).
+   */
+   void CompositionProfile::openLogFiles()
+   {
+      std::ios_base::openmode mode = std::ios_base::out;
+      if (!isFirstStep_) {
+         mode = std::ios_base::out | std::ios_base::app;
+      }
       for (int i = 0; i < nDirection_; ++i) {
-         for (int j = 0; j < nAtomType_; ++j){
-            logFiles_[i+j*nDirection_].close();
+         for (int j = 0; j < nAtomType_; ++j) {
+            std::ostringstream oss;
+            oss << outputFileName();
+            for (int k = 0; k < Dimension; ++k) {
+               oss << "_" << intVectors_[i][k];
+            }
+            oss << "_type" << j << ".log";
+            fileMaster().openOutputFile(oss.str(),
+                                        logFiles_[i+j*nDirection_],
+                                        mode);
          }
       }
-
-      isFirstStep_ = false;
-      }
-
    }
 
    /**
@@ -236,16 +245,21 @@ namespace McMd
             dWave  = boundaryPtr->reciprocalBasisVector(j);
             dWave *= intVectors_[i][j];
             waveVectors_[i] += dWave;
-            //std::cout << waveVectors_[i] << std::endl;
          }
       }
    }
 
-   void CompositionProfile::output() 
+   void CompositionProfile::output()
    {
       int i, j, k;
-      std::string suffix;
-      
+
+      // Close log files
+      for (i = 0; i < nDirection_*nAtomType_; ++i) {
+         if (logFiles_[i].is_open()) {
+            logFiles_[i].close();
+         }
+      }
+
       // Echo parameters to a log file
       fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
       writeParam(outputFile_);
@@ -258,15 +272,14 @@ namespace McMd
             outputFile_ << Dbl(waveVectors_[i][j], 5);
          }
          outputFile_ << std::endl;
-      
+
          for (k = 0; k < nAtomType_; ++k) {
-            accumulators_[i+k*nDirection_].output(outputFile_);
+            accumulator_.output(outputFile_, i, k);
             outputFile_ << std::endl;
          }
       }
       outputFile_.close();
 
-
    }
 
 }
@@ -10,7 +10,7 @@
 
 #include <mcMd/analyzers/SystemAnalyzer.h>    // base class template
 #include <mcMd/simulation/System.h>               // base class template parameter
-#include <util/accumulators/Distribution.h>      
+#include <simp/analysis/ProfileHistogram.h>      // member
 #include <util/containers/DArray.h>               // member template
 
 #include <util/global.h>
@@ -21,6 +21,8 @@ namespace McMd
 {
 
    using namespace Util;
+   using namespace Simp;
+
    /**
    * CompositionProfile evaluates the distribution of monomer 
    * positions along several user-specified directions. A direction 
@@ -30,6 +32,11 @@ namespace McMd
    * The dot product of monomer position vector and unit 
    * direction vector is added to distribution function of 
    * particular monomer type and direction vector. 
+   *
+   * All histograms are stored in contiguous ProfileHistogram arrays.
+   * If compiled with MCMD_OPENMP defined, molecules are divided among
+   * threads, each of which fills a private histogram, and these are
+   * summed after the loop.
    */
    class CompositionProfile : public SystemAnalyzer<System>
    {
@@ -74,6 +81,12 @@ namespace McMd
       */
       void sample(long iStep);
 
+      /**
+      * Return true: sample() only reads the configuration.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
       /**
       * Load internal state from an archive.
       *
@@ -108,8 +121,8 @@ namespace McMd
       /// Output file stream.
       std::ofstream outputFile_;
 
-      /// Distribution statistical accumulators.
-      DArray<Distribution> accumulators_;
+      /// Accumulated histograms for all directions and types.
+      ProfileHistogram accumulator_;
       
       /// Array of Miller index vectors for directions.
       DArray<IntVector> intVectors_;
@@ -138,8 +151,16 @@ namespace McMd
       /// Has readParam been called?
       bool isInitialized_;
 
-      /// Distribution statistical accumulators.
-      DArray<Distribution> currentAccumulators_;
+      /// Histograms for the current sample.
+      ProfileHistogram current_;
+
+      /// Private histograms for each thread, for the current sample.
+      DArray<ProfileHistogram> threadHistograms_;
+
+      /**
+      * Open log files, truncating them only if this is the first step.
+      */
+      void openLogFiles();
 
       /**
       * Update wavevectors.
@@ -158,10 +179,12 @@ namespace McMd
       Analyzer::serialize(ar, version);
       ar & nDirection_;
       ar & intVectors_;
+      ar & nBins_;
       ar & waveVectors_;
-      ar & accumulators_;
+      ar & accumulator_;
       ar & nSample_;
       ar & nAtomType_;
+      ar & isFirstStep_;
    }
 
 }
@@ -12,6 +12,7 @@
 #include <mcMd/chemistry/Atom.h>
 #include <util/boundary/Boundary.h>
 #include <util/misc/FileMaster.h>
+#include <util/misc/ioUtil.h>
 
 #include <util/global.h>
 
@@ -26,14 +27,18 @@ namespace McMd
    LinearRouseAutoCorr::LinearRouseAutoCorr(System& system) 
     : SystemAnalyzer<System>(system),
       outputFile_(),
-      accumulator_(),
+      accumulators_(),
+      multipleTauAccumulators_(),
       data_(),
+      positions_(),
       projector_(),
       speciesId_(-1),
       nMolecule_(-1),
       nAtom_(-1),
       p_(-1),
+      nMode_(1),
       capacity_(-1),
+      nLevel_(0),
       isInitialized_(false)
    {  setClassName("LinearRouseAutoCorr"); }
 
@@ -56,6 +61,10 @@ namespace McMd
       read<int>(in, "speciesId", speciesId_);
       read<int>(in, "p", p_);
       read<int>(in, "capacity", capacity_);
+      nMode_ = 1;
+      readOptional<int>(in, "nMode", nMode_);
+      nLevel_ = 0;
+      readOptional<int>(in, "nLevel", nLevel_);
 
       // Validate input
       if (speciesId_ < 0)       
@@ -64,6 +73,10 @@ namespace McMd
          UTIL_THROW("Negative mode index");
       if (capacity_ <= 0)       
          UTIL_THROW("Negative capacity");
+      if (nMode_ <= 0)       
+         UTIL_THROW("Nonpositive nMode");
+      if (nLevel_ < 0)       
+         UTIL_THROW("Negative nLevel");
       if (speciesId_ < 0) 
          UTIL_THROW("speciesId < 0");
       if (speciesId_ >= system().simulation().nSpecies()) 
@@ -71,16 +84,39 @@ namespace McMd
 
       speciesPtr_ = &system().simulation().species(speciesId_);
       nAtom_ = speciesPtr_->nAtom();
+      if (nMode_ > 1 && p_ + nMode_ > nAtom_)
+         UTIL_THROW("p + nMode > nAtom");
 
-      // Allocate arrays
-      int speciesCapacity = speciesPtr_->capacity();
-      accumulator_.setParam(speciesCapacity, capacity_);
-      data_.allocate(speciesCapacity); 
-      projector_.allocate(nAtom_);
-
+      allocate();
       isInitialized_ = true;
    }
 
+   /*
+   * Allocate data and accumulator arrays.
+   */
+   void LinearRouseAutoCorr::allocate() 
+   {
+      int speciesCapacity = speciesPtr_->capacity();
+      int k;
+      if (nLevel_ > 0) {
+         multipleTauAccumulators_.allocate(nMode_);
+         for (k = 0; k < nMode_; ++k) {
+            multipleTauAccumulators_[k].setParam(speciesCapacity, capacity_,
+                                                 2, nLevel_);
+         }
+      } else {
+         accumulators_.allocate(nMode_);
+         for (k = 0; k < nMode_; ++k) {
+            accumulators_[k].setParam(speciesCapacity, capacity_);
+         }
+      }
+      data_.allocate(nMode_); 
+      for (k = 0; k < nMode_; ++k) {
+         data_[k].allocate(speciesCapacity); 
+      }
+      positions_.allocate(nAtom_);
+      projector_.allocate(nMode_, nAtom_);
+   }
 
    /*
    * Load internal state from an archive.
@@ -91,15 +127,13 @@ namespace McMd
       loadParameter<int>(ar, "speciesId", speciesId_);
       loadParameter<int>(ar, "p", p_);
       loadParameter<int>(ar, "capacity", capacity_);
+      nMode_ = 1;
+      loadParameter<int>(ar, "nMode", nMode_, false);
+      nLevel_ = 0;
+      loadParameter<int>(ar, "nLevel", nLevel_, false);
       ar & nAtom_;
       ar & nMolecule_;
-      ar & accumulator_;
-      ar & projector_;
 
-      speciesPtr_ = &system().simulation().species(speciesId_);
-      int speciesCapacity = speciesPtr_->capacity();
-      data_.allocate(speciesCapacity); 
-   
       // Validate input
       if (speciesId_ < 0) {
          UTIL_THROW("Negative speciesId");
@@ -110,20 +144,32 @@ namespace McMd
       if (capacity_ <= 0) {
          UTIL_THROW("Negative capacity");
       }
+      if (nMode_ <= 0) {
+         UTIL_THROW("Nonpositive nMode");
+      }
+      if (nLevel_ < 0) {
+         UTIL_THROW("Negative nLevel");
+      }
       if (speciesId_ < 0) {
          UTIL_THROW("speciesId < 0");
       }
       if (speciesId_ >= system().simulation().nSpecies()) {
          UTIL_THROW("speciesId >= nSpecies");
       }
+      speciesPtr_ = &system().simulation().species(speciesId_);
       if (nAtom_ != speciesPtr_->nAtom()) {
          UTIL_THROW("Inconsistent values of nAtom");
       }
-      if (projector_.capacity() != nAtom_) {
-         UTIL_THROW("Inconsistent projector capacity");
-      }
-      if (accumulator_.bufferCapacity() != capacity_) {
-         UTIL_THROW("Inconsistent accumulator buffer capacity");
+
+      // Allocate, then load accumulator states
+      allocate();
+      if (nLevel_ > 0) {
+         ar & multipleTauAccumulators_;
+      } else {
+         ar & accumulators_;
+         if (accumulators_[0].bufferCapacity() != capacity_) {
+            UTIL_THROW("Inconsistent accumulator buffer capacity");
+         }
       }
 
       isInitialized_ = true;
@@ -133,10 +179,26 @@ namespace McMd
    * Save internal state to an archive.
    */
    void LinearRouseAutoCorr::save(Serializable::OArchive &ar)
-   {  ar << *this; }
+   {
+      Analyzer::save(ar);
+      ar & speciesId_;
+      ar & p_;
+      ar & capacity_;
+      bool isActive = (nMode_ != 1);
+      Parameter::saveOptional(ar, nMode_, isActive);
+      isActive = (nLevel_ > 0);
+      Parameter::saveOptional(ar, nLevel_, isActive);
+      ar & nAtom_;
+      ar & nMolecule_;
+      if (nLevel_ > 0) {
+         ar & multipleTauAccumulators_;
+      } else {
+         ar & accumulators_;
+      }
+   }
 
    /*
-   * Evaluate end-to-end vectors of all chains, add to ensemble.
+   * Set number of molecules, initialize projectors, clear accumulators.
    */
    void LinearRouseAutoCorr::setup() 
    { 
@@ -150,33 +212,44 @@ namespace McMd
       if (nAtom_ <= 1) UTIL_THROW("Number of atoms per molecule < 2.");
 
       // Initialize mode projection coefficients.
-      double qMode = acos(-1.0) * double(p_) / double(nAtom_ - 1);
-      if (p_ == 0) {
-         for (int j = 0; j < nAtom_; ++j)
-            projector_[j] = 1.0 / double(nAtom_);
-      } else {
-         for (int j = 0; j < nAtom_; ++j)
-            projector_[j] = 1.0 / double(nAtom_) * cos(qMode*double(j));
+      double qMode;
+      int j, k, p;
+      for (k = 0; k < nMode_; ++k) {
+         p = p_ + k;
+         qMode = acos(-1.0) * double(p) / double(nAtom_ - 1);
+         if (p == 0) {
+            for (j = 0; j < nAtom_; ++j)
+               projector_(k, j) = 1.0 / double(nAtom_);
+         } else {
+            for (j = 0; j < nAtom_; ++j)
+               projector_(k, j) = 1.0 / double(nAtom_) * cos(qMode*double(j));
+         }
+         projector_(k, 0) -= 0.5/double(nAtom_);
+         projector_(k, nAtom_ - 1) -= 0.5 / double(nAtom_);
       }
-      projector_[0] -= 0.5/double(nAtom_);
-      projector_[nAtom_ - 1] -= 0.5 / double(nAtom_);
-
-      // Initialize the AutoCorrArray object
-      accumulator_.setNEnsemble(nMolecule_);
 
-      accumulator_.clear();
+      // Initialize the accumulators
+      for (k = 0; k < nMode_; ++k) {
+         if (nLevel_ > 0) {
+            multipleTauAccumulators_[k].setNEnsemble(nMolecule_);
+            multipleTauAccumulators_[k].clear();
+         } else {
+            accumulators_[k].setNEnsemble(nMolecule_);
+            accumulators_[k].clear();
+         }
+      }
    }
 
    /*
-   * Evaluate end-to-end vectors of all chains, add to ensemble.
+   * Evaluate Rouse mode coefficients of all chains, add to ensemble.
    */
    void LinearRouseAutoCorr::sample(long iStep) 
    { 
       if (isAtInterval(iStep))  {
 
          Molecule* moleculePtr;
-         Vector    r1, r2, dR, atomPos;
-         int       i, j;
+         Vector    dR, sum;
+         int       i, j, k;
 
          // Confirm that nMolecule has remained constant
          if (nMolecule_ != system().nMolecule(speciesId_)) {
@@ -187,21 +260,33 @@ namespace McMd
          for (i = 0; i < nMolecule_; ++i) {
             moleculePtr = &(system().molecule(speciesId_, i));
 
-            // Retrace non-periodic shape and calculate coefficients
-            atomPos = moleculePtr->atom(0).position();
-            dR.multiply(atomPos, projector_[0]);
-            data_[i] = dR;
+            // Retrace non-periodic shape
+            positions_[0] = moleculePtr->atom(0).position();
             for (j = 1; j < nAtom_; j++) {
-               r1 = moleculePtr->atom(j-1).position();
-               r2 = moleculePtr->atom(j).position();
-               system().boundary().distanceSq(r2, r1, dR);
-               atomPos += dR;
-               dR.multiply(atomPos, projector_[j]);
-               data_[i] += dR;
+               system().boundary().distanceSq(moleculePtr->atom(j).position(),
+                                              moleculePtr->atom(j-1).position(),
+                                              dR);
+               positions_[j].add(positions_[j-1], dR);
+            }
+
+            // Project onto all modes
+            for (k = 0; k < nMode_; ++k) {
+               sum.zero();
+               for (j = 0; j < nAtom_; j++) {
+                  dR.multiply(positions_[j], projector_(k, j));
+                  sum += dR;
+               }
+               data_[k][i] = sum;
             }
          }
       
-         accumulator_.sample(data_);
+         for (k = 0; k < nMode_; ++k) {
+            if (nLevel_ > 0) {
+               multipleTauAccumulators_[k].sample(data_[k]);
+            } else {
+               accumulators_[k].sample(data_[k]);
+            }
+         }
 
       } // if isAtInterval
 
@@ -216,10 +301,22 @@ namespace McMd
       writeParam(outputFile_); 
       outputFile_.close();
 
-      // Output statistical analysis to separate data file
-      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
-      accumulator_.output(outputFile_); 
-      outputFile_.close();
+      // Output statistical analysis to separate data file(s)
+      std::string suffix;
+      for (int k = 0; k < nMode_; ++k) {
+         if (nMode_ == 1) {
+            suffix = std::string(".dat");
+         } else {
+            suffix = std::string(".") + toString(p_ + k) + std::string(".dat");
+         }
+         fileMaster().openOutputFile(outputFileName(suffix), outputFile_);
+         if (nLevel_ > 0) {
+            multipleTauAccumulators_[k].output(outputFile_); 
+         } else {
+            accumulators_[k].output(outputFile_); 
+         }
+         outputFile_.close();
+      }
 
    }
 
@@ -11,11 +11,12 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>   // base class template
 #include <mcMd/simulation/System.h>              // base class template parameter
 #include <util/accumulators/AutoCorrArray.h>     // member template 
+#include <mcMd/analyzers/util/MultipleTauAutoCorr.h> // member template param
 #include <util/space/Vector.h>                   // member template parameter
 #include <util/containers/DArray.h>              // member template
+#include <util/containers/DMatrix.h>             // member template
 
-#include <util/archives/serialize.h>             // used in method template
-#include <util/global.h>                         // used in method template
+#include <util/global.h>
 
 namespace Simp {
    class Species;
@@ -30,6 +31,18 @@ namespace McMd
    /**
    * Autocorrelation for Rouse mode coefficients of a linear molecule.
    *
+   * By default, this analyzer computes the autocorrelation function of 
+   * the single Rouse mode p. If the optional parameter nMode > 1, it 
+   * instead analyzes the nMode modes p, p+1, ..., p + nMode - 1. All
+   * modes of a molecule are then computed from a single traversal of
+   * its non-periodic shape, and each mode is written to a separate file
+   * outputFileName.p.dat, where p is the mode index.
+   *
+   * If the optional parameter nLevel > 0, each autocorrelation function 
+   * is computed with a MultipleTauAutoCorr correlator with nLevel levels
+   * of capacity frames, rather than with an AutoCorrArray. This gives
+   * time lags up to capacity*2^(nLevel-1) samples.
+   *
    * \ingroup McMd_Analyzer_McMd_Module
    */
    class LinearRouseAutoCorr : public SystemAnalyzer<System>
@@ -70,15 +83,6 @@ namespace McMd
       */
       virtual void save(Serializable::OArchive &ar);
 
-      /**
-      * Serialize to/from an archive. 
-      *
-      * \param ar      saving or loading archive
-      * \param version archive version id
-      */
-      template <class Archive>
-      void serialize(Archive& ar, const unsigned int version);
-
       /** 
       * Set number of molecules, initialize eigenvector, and clear accumulator.
       */
@@ -101,14 +105,20 @@ namespace McMd
       /// Output file stream.
       std::ofstream outputFile_;
 
-      /// Statistical accumulator.
-      AutoCorrArray<Vector, double>  accumulator_;
+      /// Statistical accumulators, one per mode (if nLevel_ == 0).
+      DArray< AutoCorrArray<Vector, double> >  accumulators_;
+   
+      /// Multiple-tau accumulators, one per mode (if nLevel_ > 0).
+      DArray<MultipleTauAutoCorr>  multipleTauAccumulators_;
+   
+      /// Rouse mode coefficients, data_[k][i] for mode p+k of molecule i.
+      DArray< DArray<Vector> > data_;
    
-      /// Array of Rouse mode coefficients, one per molecule of species.
-      DArray<Vector> data_;
+      /// Non-periodic positions of atoms of one molecule (workspace).
+      DArray<Vector> positions_;
    
-      /// Array of coefficients for projecting to the Rouse mode.
-      DArray<double> projector_;
+      /// Coefficients for projecting to Rouse modes, element (k, atomId).
+      DMatrix<double> projector_;
    
       /// Pointer to relevant Species.
       Species* speciesPtr_;
@@ -122,33 +132,27 @@ namespace McMd
       /// Number of atoms in the species (must not change).
       int      nAtom_;
  
-      /// Index to Rouse mode.
+      /// Index to (first) Rouse mode.
       int      p_;
 
+      /// Number of Rouse modes.
+      int      nMode_;
+
       /// Maximum length of each sequence in AutoCorrArray.
       int      capacity_;
+
+      /// Number of levels of multiple-tau correlator (0 for AutoCorrArray).
+      int      nLevel_;
    
       /// Has readParam been called?
       bool    isInitialized_;
 
-   };
+      /**
+      * Allocate data and accumulator arrays.
+      */
+      void allocate();
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void LinearRouseAutoCorr::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & speciesId_;
-      ar & p_;
-      ar & capacity_;
-      ar & nAtom_;
-      ar & nMolecule_;
-      ar & accumulator_;
-      ar & projector_;
-
-   }
+   };
 
 }
 #endif
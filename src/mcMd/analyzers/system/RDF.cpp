@@ -35,6 +35,7 @@ namespace McMd
       normSum_(0.0),
       nBin_(1),
       nAtomType_(0),
+      useCellList_(false),
       isInitialized_(false)
    {  setClassName("RDF"); }
 
@@ -47,10 +48,16 @@ namespace McMd
       read<double>(in, "max", max_);
       read<int>(in, "nBin", nBin_);
       read<PairSelector>(in, "selector", selector_);
+      useCellList_ = false;
+      readOptional<bool>(in, "useCellList", useCellList_);
 
       nAtomType_ = system().simulation().nAtomType();
       typeNumbers_.allocate(nAtomType_);
       accumulator_.setParam(max_, nBin_);
+      if (useCellList_) {
+         cellList_.setAtomCapacity(system().simulation().atomCapacity());
+         positions_.allocate(system().simulation().atomCapacity());
+      }
       isInitialized_ = true;
    }
 
@@ -63,6 +70,8 @@ namespace McMd
       loadParameter<double>(ar, "max", max_);
       loadParameter<int>(ar, "nBin", nBin_);
       loadParameter<PairSelector>(ar, "selector", selector_);
+      useCellList_ = false;
+      loadParameter<bool>(ar, "useCellList", useCellList_, false);
 
       ar & accumulator_;
       ar & nAtomType_;
@@ -83,6 +92,11 @@ namespace McMd
          UTIL_THROW("Inconsistent max values");
       }
 
+      if (useCellList_) {
+         cellList_.setAtomCapacity(system().simulation().atomCapacity());
+         positions_.allocate(system().simulation().atomCapacity());
+      }
+
       isInitialized_ = true;
    }
 
@@ -90,7 +104,17 @@ namespace McMd
    * Save state to archive.
    */
    void RDF::save(Serializable::OArchive& ar)
-   { ar & *this; }
+   {
+      Analyzer::save(ar);
+      ar & max_;
+      ar & nBin_;
+      ar & selector_;
+      Parameter::saveOptional(ar, useCellList_, useCellList_);
+      ar & accumulator_;
+      ar & nAtomType_;
+      ar & typeNumbers_;
+      ar & normSum_;
+   }
 
    /*
    * Add particle pairs to RDF histogram.
@@ -124,47 +148,52 @@ namespace McMd
          boundaryPtr = &system().boundary();
          nSpecies    = system().simulation().nSpecies();
 
-         // Loop over atom 1
-         for (iSpecies1 = 0; iSpecies1 < nSpecies; ++iSpecies1) {
-            system().begin(iSpecies1, molIter1); 
-            for ( ; molIter1.notEnd(); ++molIter1) {
-               molIter1->begin(atomIter1); 
-               for ( ; atomIter1.notEnd(); ++atomIter1) {
-                  r1 = atomIter1->position();
+         if (useCellList_) {
+            sampleCellList();
+         } else {
+
+            // Loop over atom 1
+            for (iSpecies1 = 0; iSpecies1 < nSpecies; ++iSpecies1) {
+               system().begin(iSpecies1, molIter1); 
+               for ( ; molIter1.notEnd(); ++molIter1) {
+                  molIter1->begin(atomIter1); 
+                  for ( ; atomIter1.notEnd(); ++atomIter1) {
+                     r1 = atomIter1->position();
  
-                  ++typeNumbers_[atomIter1->typeId()];
+                     ++typeNumbers_[atomIter1->typeId()];
   
-                  // Loop over atom 2 
-                  for (iSpecies2 = 0; iSpecies2 < nSpecies; ++iSpecies2) {
-                     system().begin(iSpecies2, molIter2); 
-                     for ( ; molIter2.notEnd(); ++molIter2) {
+                     // Loop over atom 2 
+                     for (iSpecies2 = 0; iSpecies2 < nSpecies; ++iSpecies2) {
+                        system().begin(iSpecies2, molIter2); 
+                        for ( ; molIter2.notEnd(); ++molIter2) {
 
-                        //Check if molecules are the same  
-                        //if ( &(*molIter2) != &(*molIter1)) {
+                           //Check if molecules are the same  
+                           //if ( &(*molIter2) != &(*molIter1)) {
 
-                           molIter2->begin(atomIter2);
-                           for ( ; atomIter2.notEnd(); ++atomIter2) {
+                              molIter2->begin(atomIter2);
+                              for ( ; atomIter2.notEnd(); ++atomIter2) {
 
-                              if (selector_.match(*atomIter1, *atomIter2)) {
-                                 r2 = atomIter2->position();
+                                 if (selector_.match(*atomIter1, *atomIter2)) {
+                                    r2 = atomIter2->position();
    
-                                 dRsq = boundaryPtr->distanceSq(r1, r2);
-                                 dR   = sqrt(dRsq);
+                                    dRsq = boundaryPtr->distanceSq(r1, r2);
+                                    dR   = sqrt(dRsq);
 
-                                 accumulator_.sample(dR);
+                                    accumulator_.sample(dR);
 
-                              }
+                                 }
                
-                           }
+                              }
 
-                        //}
+                           //}
 
-                     }
-                  } // for iSpecies2
+                        }
+                     } // for iSpecies2
    
+                  }
                }
-            }
-         } // for iSpecies1
+            } // for iSpecies1
+         } // if useCellList_
 
          // Increment normSum_
          double number = 0;
@@ -178,6 +207,58 @@ namespace McMd
    }
 
 
+   /*
+   * Add pairs within max_ to histogram, using a cell list (private).
+   */
+   void RDF::sampleCellList()
+   {
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      CellList::NeighborArray neighbors;
+      Atom* otherPtr;
+      Boundary& boundary = system().boundary();
+      double maxSq = max_*max_;
+      double dRsq;
+      int iSpecies, i, id;
+      int nSpecies = system().simulation().nSpecies();
+
+      // Build cell list, and count atoms of each type
+      cellList_.setup(boundary, max_);
+      for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
+         system().begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               id = atomIter->id();
+               positions_[id] = atomIter->position();
+               boundary.shift(positions_[id]);
+               cellList_.addAtom(*atomIter, positions_[id]);
+               ++typeNumbers_[atomIter->typeId()];
+            }
+         }
+      }
+
+      // Loop over ordered pairs of neighboring atoms
+      for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
+         system().begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               id = atomIter->id();
+               cellList_.getNeighbors(positions_[id], neighbors);
+               for (i = 0; i < neighbors.size(); ++i) {
+                  otherPtr = neighbors[i];
+                  if (selector_.match(*atomIter, *otherPtr)) {
+                     dRsq = boundary.distanceSq(positions_[id],
+                                                positions_[otherPtr->id()]);
+                     if (dRsq < maxSq) {
+                        accumulator_.sample(sqrt(dRsq));
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
    /// Output results to file after simulation is completed.
    void RDF::output() 
    {  
@@ -11,8 +11,10 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>      // base class template
 #include <mcMd/simulation/System.h>                 // base class template parameter
 #include <mcMd/analyzers/util/PairSelector.h>     // member
+#include <mcMd/neighbor/CellList.h>                 // member
 #include <util/accumulators/RadialDistribution.h>   // member
 #include <util/containers/DArray.h>                 // member template
+#include <util/space/Vector.h>                      // member template argument
 
 #include <util/global.h>
 
@@ -25,9 +27,13 @@ namespace McMd
    * RDF evaluates the atomic radial distribution function.
    *
    * This class evaluates a radial distribution function in real space,
-   * by making a histogram of particle pairs. The algorithm is expensive:
-   * It simply executes a double loop over particles, at a cost of order
-   * N^2. 
+   * by making a histogram of particle pairs. By default, the algorithm
+   * simply executes a double loop over particles, at a cost of order
+   * N^2. If the optional parameter useCellList is true, pairs are
+   * instead found by building a CellList with a cutoff equal to the
+   * maximum radius max, at a cost of order N, and only pairs separated
+   * by less than max are added to the histogram. This is much faster
+   * for large systems when max is small compared to the box size.
    * 
    * Different types of RDF may be calculated by setting a PairSelector
    * too specify which types of particles pairs should be accepted: The
@@ -73,15 +79,6 @@ namespace McMd
       */
       virtual void save(Serializable::OArchive& ar);
 
-      /**
-      * Serialize to/from an archive. 
-      *
-      * \param ar      saving or loading archive
-      * \param version archive version id
-      */
-      template <class Archive>
-      void serialize(Archive& ar, const unsigned int version);
-
       /** 
       * Setup before a simulation (clear accumulator).
       */
@@ -94,6 +91,12 @@ namespace McMd
       */
       virtual void sample(long iStep);
 
+      /**
+      * Return true: sample() only reads the configuration.
+      */
+      virtual bool isConcurrent() const
+      {  return true; }
+
       /** 
       * Output results to output file.
       */
@@ -107,6 +110,12 @@ namespace McMd
       // RadialDistribution statistical accumulator
       RadialDistribution  accumulator_;
 
+      /// Cell list used to find pairs, if useCellList_ is true.
+      CellList  cellList_;
+
+      /// Positions shifted into the primary cell, indexed by atom id.
+      DArray<Vector> positions_;
+
       /// Sum of snapshot values of number of atoms for each atom type.
       DArray<double> typeNumbers_;
 
@@ -125,26 +134,21 @@ namespace McMd
       /// Number of atom types, copied from Simulation::nAtomType().
       int nAtomType_;
 
+      /// Use a cell list to find pairs separated by less than max_?
+      bool    useCellList_;
+
       /// Is this initialized (Has readParam or loadParam been called?)
       bool    isInitialized_;
 
-   };
+      /**
+      * Add pairs separated by less than max_, found with cellList_.
+      *
+      * Also increments typeNumbers_. Uses copies of atom positions that
+      * are shifted into the primary cell, and does not modify atoms.
+      */
+      void sampleCellList();
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void RDF::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & max_;
-      ar & nBin_;
-      ar & selector_;
-      ar & accumulator_;
-      ar & nAtomType_;
-      ar & typeNumbers_;
-      ar & normSum_;
-   }
+   };
 
 }
 #endif
@@ -11,8 +11,10 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>   // base class template
 #include <mcMd/simulation/System.h>          // base class template param
 #include <util/accumulators/AutoCorrArray.h> // member template 
+#include <mcMd/analyzers/util/MultipleTauAutoCorr.h> // member template param
 #include <util/space/Vector.h>               // member template parameter
 #include <util/containers/DArray.h>          // member template
+#include <util/containers/DMatrix.h>         // member template
 
 namespace Simp {
    class Species;
@@ -27,6 +29,16 @@ namespace McMd
    /**
    * Autocorrelation for Rouse mode coefficients of a ring molecule.
    *
+   * By default, this analyzer computes the autocorrelation function of 
+   * the single Rouse mode p. If the optional parameter nMode > 1, it 
+   * instead analyzes the nMode modes p, p+1, ..., p + nMode - 1, which
+   * are all computed from a single traversal of each molecule. Each mode
+   * is then written to a separate file outputFileName.p.dat.
+   *
+   * If the optional parameter nLevel > 0, each autocorrelation function 
+   * is computed with a MultipleTauAutoCorr correlator with nLevel levels
+   * of capacity frames, rather than with an AutoCorrArray.
+   *
    * \ingroup McMd_Analyzer_McMd_Module
    */
    class RingRouseAutoCorr : public SystemAnalyzer<System>
@@ -67,15 +79,6 @@ namespace McMd
       */
       virtual void save(Serializable::OArchive &ar);
 
-      /**
-      * Serialize internal state to/from archive.
-      *
-      * \param ar       archive
-      * \param version  id for archive version
-      */
-      template <class Archive>
-      void serialize(Archive &ar, const unsigned int version);
-
       /** 
       * Allocate memory and initialize Rouse mode eigenvector p.
       */
@@ -98,14 +101,20 @@ namespace McMd
       /// Output file stream.
       std::ofstream outputFile_;
 
-      /// Statistical accumulator.
-      AutoCorrArray<Vector, double> accumulator_;
+      /// Statistical accumulators, one per mode (if nLevel_ == 0).
+      DArray< AutoCorrArray<Vector, double> > accumulators_;
 
-      /// Array of Rouse mode coefficients, one per molecule of species.
-      DArray<Vector> data_;
+      /// Multiple-tau accumulators, one per mode (if nLevel_ > 0).
+      DArray<MultipleTauAutoCorr> multipleTauAccumulators_;
+
+      /// Rouse mode coefficients, data_[k][i] for mode p+k of molecule i.
+      DArray< DArray<Vector> > data_;
+   
+      /// Non-periodic positions of atoms of one molecule (workspace).
+      DArray<Vector> positions_;
    
-      /// Array of coefficients for projecting to the Rouse mode (eigenvector).
-      DArray<double> projector_;
+      /// Coefficients for projecting to Rouse modes, element (k, atomId).
+      DMatrix<double> projector_;
    
       /// Pointer to relevant Species.
       Species *speciesPtr_;
@@ -119,32 +128,27 @@ namespace McMd
       /// Number of atoms per molecule (must not change).
       int     nAtom_;
  
-      /// Index of Rouse mode.
+      /// Index of (first) Rouse mode.
       int     p_;
 
+      /// Number of Rouse modes.
+      int     nMode_;
+
       /// Maximum length of each sequence in AutoCorrArray.
       int     capacity_;
+
+      /// Number of levels of multiple-tau correlator (0 for AutoCorrArray).
+      int     nLevel_;
    
       /// Has readParam been called?
       bool    isInitialized_;
 
-   };
+      /**
+      * Allocate data and accumulator arrays.
+      */
+      void allocate();
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void RingRouseAutoCorr::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & speciesId_;
-      ar & p_;
-      ar & capacity_;
-      ar & nAtom_;
-      ar & nMolecule_;
-      ar & accumulator_;
-      ar & projector_;
-   }
+   };
 
 }
 #endif
@@ -162,6 +162,10 @@ namespace McMd
       readOutputFileName(in);
       read(in, "capacity", capacity_);
       readOptional(in, "maxStageId", maxStageId_);
+      readOptional(in, "blockFactor", blockFactor_);
+      if (blockFactor_ < 2) {
+         UTIL_THROW("blockFactor must be at least 2");
+      }
 
       accumulator_.setParam(capacity_, maxStageId_, blockFactor_);
       accumulator_.clear();
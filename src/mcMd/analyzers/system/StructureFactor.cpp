@@ -129,91 +129,123 @@ namespace McMd
    void StructureFactor::sample(long iStep) 
    {
       if (isAtInterval(iStep))  {
+         computeFourierModes();
+         incrementStructureFactors();
+      }
+   }
 
-         std::ios_base::openmode mode = std::ios_base::out;
-         if (!isFirstStep_) {
-           mode = std::ios_base::out | std::ios_base::app; 
-         }
-         fileMaster().openOutputFile(outputFileName("_max.dat"), 
-                                     outputFile_, mode);
-
-         //fileMaster().openOutputFile(outputFileName("_max.dat"), 
-         //                            outputFile_, !isFirstStep_);
-         isFirstStep_ = false;
-
-         Vector position;
-         std::complex<double> expFactor;
-         double product;
-         System::ConstMoleculeIterator molIter;
-         Molecule::ConstAtomIterator atomIter;
-         int nSpecies, iSpecies, typeId, i, j;
+   /*
+   * Compute all Fourier modes from all atomic positions.
+   */
+   void StructureFactor::computeFourierModes()
+   {
+      Vector position;
+      std::complex<double> expFactor;
+      double product;
+      System::ConstMoleculeIterator molIter;
+      Molecule::ConstAtomIterator atomIter;
+      int nSpecies, iSpecies, typeId, i, j;
 
-         makeWaveVectors();
+      makeWaveVectors();
 
-         // Set all Fourier modes to zero
-         for (i = 0; i < nWave_; ++i) {
-            for (j = 0; j < nMode_; ++j) {
-               fourierModes_(i, j) = std::complex<double>(0.0, 0.0);
-            }
+      // Set all Fourier modes to zero
+      for (i = 0; i < nWave_; ++i) {
+         for (j = 0; j < nMode_; ++j) {
+            fourierModes_(i, j) = std::complex<double>(0.0, 0.0);
          }
- 
-         // Loop over all atoms
-         nSpecies = system().simulation().nSpecies();
-         for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
-            system().begin(iSpecies, molIter); 
-            for ( ; molIter.notEnd(); ++molIter) {
-               molIter->begin(atomIter); 
-               for ( ; atomIter.notEnd(); ++atomIter) {
-                  position = atomIter->position();
-                  typeId   = atomIter->typeId();
- 
-		  // Loop over wavevectors
-                  for (i = 0; i < nWave_; ++i) {
-               
-                     product = position.dot(waveVectors_[i]);
-                     expFactor = exp( product*Constants::Im );
-                     for (j = 0; j < nMode_; ++j) {
-                        fourierModes_(i, j) += modes_(j, typeId)*expFactor;
-                     }
-		 
+      }
+
+      // Loop over all atoms
+      nSpecies = system().simulation().nSpecies();
+      for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
+         system().begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            molIter->begin(atomIter);
+            for ( ; atomIter.notEnd(); ++atomIter) {
+               position = atomIter->position();
+               typeId   = atomIter->typeId();
+
+               // Loop over wavevectors
+               for (i = 0; i < nWave_; ++i) {
+                  product = position.dot(waveVectors_[i]);
+                  expFactor = exp( product*Constants::Im );
+                  for (j = 0; j < nMode_; ++j) {
+                     fourierModes_(i, j) += modes_(j, typeId)*expFactor;
                   }
-  
                }
-            }
 
+            }
          }
+      }
+   }
 
-         // Increment structure factors
-         double volume = system().boundary().volume();
-         double norm;
-         for (j = 0; j < nMode_; ++j) {
-            double maxValue = 0.0;
-            double maxQ = 0.0;
-            IntVector maxIntVector;
-            for (i = 0; i < nWave_; ++i) {
-               norm = std::norm(fourierModes_(i, j));
-               if (double(norm/volume) >= maxValue) {
-                  maxValue = double(norm/volume);
-                  maxIntVector = waveIntVectors_[i];
-                  maxQ = waveVectors_[i].abs();
-               }
-               structureFactors_(i, j) += norm/volume;
-            }
+   /*
+   * Add current Fourier modes to accumulators, and output maximum S(q).
+   */
+   void StructureFactor::incrementStructureFactors()
+   {
+      std::ios_base::openmode mode = std::ios_base::out;
+      if (!isFirstStep_) {
+        mode = std::ios_base::out | std::ios_base::app;
+      }
+      fileMaster().openOutputFile(outputFileName("_max.dat"),
+                                  outputFile_, mode);
+      isFirstStep_ = false;
 
-            // Output current maximum S(q)
-            outputFile_ << maxIntVector;
-            outputFile_ << Dbl(maxQ, 20, 8);
-            outputFile_ << Dbl(maxValue, 20, 8);
-            outputFile_ << std::endl;
+      // Increment structure factors
+      double volume = system().boundary().volume();
+      double norm;
+      int i, j;
+      for (j = 0; j < nMode_; ++j) {
+         double maxValue = 0.0;
+         double maxQ = 0.0;
+         IntVector maxIntVector;
+         for (i = 0; i < nWave_; ++i) {
+            norm = std::norm(fourierModes_(i, j));
+            if (double(norm/volume) >= maxValue) {
+               maxValue = double(norm/volume);
+               maxIntVector = waveIntVectors_[i];
+               maxQ = waveVectors_[i].abs();
+            }
+            structureFactors_(i, j) += norm/volume;
          }
 
-         ++nSample_;
-
+         // Output current maximum S(q)
+         outputFile_ << maxIntVector;
+         outputFile_ << Dbl(maxQ, 20, 8);
+         outputFile_ << Dbl(maxValue, 20, 8);
          outputFile_ << std::endl;
-         outputFile_.close();
       }
 
+      ++nSample_;
+
+      outputFile_ << std::endl;
+      outputFile_.close();
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Add structure factor sums and sample counts on processor root.
+   */
+   void StructureFactor::merge(MPI::Intracomm& communicator, int root)
+   {
+      DMatrix<double> totals;
+      totals.allocate(nWave_, nMode_);
+      communicator.Reduce(&structureFactors_(0, 0), &totals(0, 0),
+                          nWave_*nMode_, MPI::DOUBLE, MPI::SUM, root);
+      int nSampleTotal = 0;
+      communicator.Reduce(&nSample_, &nSampleTotal, 1, MPI::INT, 
+                          MPI::SUM, root);
+      if (communicator.Get_rank() == root) {
+         for (int i = 0; i < nWave_; ++i) {
+            for (int j = 0; j < nMode_; ++j) {
+               structureFactors_(i, j) = totals(i, j);
+            }
+         }
+         nSample_ = nSampleTotal;
+      }
    }
+   #endif
 
    /*
    * Calculate floating point wavevectors, using current boundary.
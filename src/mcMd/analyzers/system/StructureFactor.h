@@ -116,6 +116,22 @@ namespace McMd
       */
       virtual void output();
 
+      #ifdef UTIL_MPI
+      /**
+      * Structure factors are sums over configurations, and can be merged.
+      */
+      virtual bool isMergeable() const
+      {  return true; }
+
+      /**
+      * Add structure factor sums of all processors to those of root.
+      *
+      * \param communicator communicator for all processors
+      * \param root         rank of processor that receives the results
+      */
+      virtual void merge(MPI::Intracomm& communicator, int root);
+      #endif
+
    protected:
 
       /**
@@ -171,6 +187,19 @@ namespace McMd
       */
       void makeWaveVectors();
 
+      /**
+      * Update wavevectors, and compute fourierModes_ from all atoms.
+      */
+      void computeFourierModes();
+
+      /**
+      * Add current fourierModes_ to accumulators, and output maximum.
+      *
+      * Increments nSample_, and appends the maximum structure factor of
+      * each mode to the file {outputFileName}_max.dat.
+      */
+      void incrementStructureFactors();
+
       /// Is this the first step?
       bool isFirstStep_;
 
@@ -19,6 +19,8 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <cmath>
+
 namespace McMd
 {
 
@@ -61,6 +63,7 @@ namespace McMd
       }
 
       readDArray<IntVector>(in, "waveIntVectors", waveIntVectors_, nWave_);
+      allocatePhases();
       isInitialized_ = true;
    }
 
@@ -95,10 +98,37 @@ namespace McMd
       // Allocate work arrays.
       waveVectors_.allocate(nWave_);
       fourierModes_.allocate(nWave_);
+      allocatePhases();
 
       isInitialized_ = true;
    }
 
+   /*
+   * Find range of miller indices along each axis, allocate phases_.
+   */
+   void VanHove::allocatePhases()
+   {
+      int i, j, size;
+      for (j = 0; j < Dimension; ++j) {
+         minIntVector_[j] = 0;
+         maxIntVector_[j] = 0;
+         for (i = 0; i < nWave_; ++i) {
+            if (waveIntVectors_[i][j] < minIntVector_[j]) {
+               minIntVector_[j] = waveIntVectors_[i][j];
+            }
+            if (waveIntVectors_[i][j] > maxIntVector_[j]) {
+               maxIntVector_[j] = waveIntVectors_[i][j];
+            }
+         }
+      }
+      size = 0;
+      for (j = 0; j < Dimension; ++j) {
+         phaseOrigins_[j] = size - minIntVector_[j];
+         size += maxIntVector_[j] - minIntVector_[j] + 1;
+      }
+      phases_.allocate(size);
+   }
+
    /*
    * Save state to an archive.
    */
@@ -126,13 +156,18 @@ namespace McMd
       if (isAtInterval(iStep))  {
 
          Vector  position;
-         std::complex<double>  expFactor;
+         Vector  basis[Dimension];
+         std::complex<double>  expFactor, step;
+         std::complex<double>* phases;
          double  product, coeff;
          System::ConstMoleculeIterator  molIter;
          Molecule::ConstAtomIterator  atomIter;
-         int  nSpecies, iSpecies, i;
+         int  nSpecies, iSpecies, i, j, m;
 
          makeWaveVectors();
+         for (j = 0; j < Dimension; ++j) {
+            basis[j] = system().boundary().reciprocalBasisVector(j);
+         }
 
          // Set all Fourier modes to zero
          for (i = 0; i < nWave_; ++i) {
@@ -148,14 +183,28 @@ namespace McMd
                for ( ; atomIter.notEnd(); ++atomIter) {
                   position = atomIter->position();
                   coeff    = atomTypeCoeffs_[atomIter->typeId()];
+
+                  // Tabulate exp(i m b_j.r) along each axis by recurrence
+                  for (j = 0; j < Dimension; ++j) {
+                     product = position.dot(basis[j]);
+                     step = std::complex<double>(cos(product), sin(product));
+                     product *= double(minIntVector_[j]);
+                     phases = &phases_[phaseOrigins_[j] + minIntVector_[j]];
+                     phases[0] = std::complex<double>(cos(product), 
+                                                      sin(product));
+                     for (m = 1; 
+                          m <= maxIntVector_[j] - minIntVector_[j]; ++m) {
+                        phases[m] = phases[m-1]*step;
+                     }
+                  }
  
-		  // Loop over wavevectors
+                  // Loop over wavevectors
                   for (i = 0; i < nWave_; ++i) {
-               
-                     product = position.dot(waveVectors_[i]);
-                     expFactor = exp( product*Constants::Im );
+                     const IntVector& q = waveIntVectors_[i];
+                     expFactor = phases_[phaseOrigins_[0] + q[0]]
+                               * phases_[phaseOrigins_[1] + q[1]]
+                               * phases_[phaseOrigins_[2] + q[2]];
                      fourierModes_[i] += (coeff*expFactor);
-		 
                   }
   
                }
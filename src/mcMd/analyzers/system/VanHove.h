@@ -13,6 +13,7 @@
 #include <util/containers/DArray.h>             // member template
 #include <util/accumulators/AutoCorr.h>         // member template parameter
 #include <util/space/Vector.h>                  // member template parameter
+#include <util/space/IntVector.h>               // member
 
 #include <util/global.h>
 
@@ -165,6 +166,18 @@ namespace McMd
       /// Array of wave vectors.
       DArray<Vector>  waveVectors_;
 
+      /// Phase factors exp(i m b_j.r) of one atom, for all axes j.
+      DArray< std::complex<double> >  phases_;
+
+      /// Index in phases_ of m = 0 for each axis.
+      IntVector  phaseOrigins_;
+
+      /// Minimum miller index along each axis.
+      IntVector  minIntVector_;
+
+      /// Maximum miller index along each axis.
+      IntVector  maxIntVector_;
+
       /// Array of coefficients for atom types.
       DArray<double>  atomTypeCoeffs_;
 
@@ -186,6 +199,9 @@ namespace McMd
       /// Update wavevectors.
       void makeWaveVectors();
 
+      /// Allocate phases_ for range of miller indices.
+      void allocatePhases();
+
    };
 
    /*
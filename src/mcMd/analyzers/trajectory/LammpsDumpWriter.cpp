@@ -6,78 +6,104 @@
 */
 
 #include "LammpsDumpWriter.h"
-#include <util/misc/FileMaster.h>
-#include <util/archives/Serializable_includes.h>
-#include <util/misc/ioUtil.h>
-
-#include <sstream>
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <simp/trajectory/LammpsDumpFormat.h>
+#include <util/boundary/Boundary.h>
+#include <util/format/Dbl.h>
+#include <util/space/Vector.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace McMd
 {
 
    using namespace Util;
+   using namespace Simp;
 
    /*
    * Constructor.
    */
    LammpsDumpWriter::LammpsDumpWriter(System& system) 
-    : SystemAnalyzer<System>(system),
-      nSample_(0),
-      isInitialized_(false)
+    : TrajectoryWriter(system, false),
+      atomPtrs_(),
+      buffers_()
    {  setClassName("LammpsDumpWriter"); }
 
    /*
-   * Read interval and outputFileName. 
+   * Write one frame in Lammps dump format.
    */
-   void LammpsDumpWriter::readParameters(std::istream& in) 
+   void LammpsDumpWriter::writeFrame(std::ofstream& out, long iStep)
    {
-      readInterval(in);
-      readOutputFileName(in);
-      isInitialized_ = true;
-   }
+      if (!atomPtrs_.isAllocated()) {
+         atomPtrs_.allocate(system().simulation().atomCapacity());
+      }
+      if (!buffers_.isAllocated()) {
+         int nThread = 1;
+         #ifdef MCMD_OPENMP
+         nThread = omp_get_max_threads();
+         #endif
+         buffers_.allocate(nThread);
+      }
 
-   /*
-   * Load state from an archive.
-   */
-   void LammpsDumpWriter::loadParameters(Serializable::IArchive& ar)
-   {
-      Analyzer::loadParameters(ar);
-      ar & nSample_;
-      isInitialized_ = true;
-   }
+      // Collect pointers to all atoms, in order
+      int nSpecies = system().simulation().nSpecies();
+      Molecule::ConstAtomIterator atomIter;
+      int iSpecies, iMol, nAtom;
+      nAtom = 0;
+      for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
+         for (iMol = 0; iMol < system().nMolecule(iSpecies); ++iMol) {
+            const Molecule& molecule = system().molecule(iSpecies, iMol);
+            for (molecule.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               atomPtrs_[nAtom] = &(*atomIter);
+               ++nAtom;
+            }
+         }
+      }
 
-   /*
-   * Save state to archive.
-   */
-   void LammpsDumpWriter::save(Serializable::OArchive& ar)
-   { ar & *this; }
+      out << "ITEM: TIMESTEP" << "\n";
+      out << iStep << "\n";
+      out << "ITEM: NUMBER OF ATOMS" << "\n";
+      out << nAtom << "\n";
+      out << "ITEM: BOX BOUNDS pp pp pp" << "\n";
+      Vector lengths = system().boundary().lengths();
+      out << Dbl(0.0) << Dbl(lengths[0]) << "\n";
+      out << Dbl(0.0) << Dbl(lengths[1]) << "\n";
+      out << Dbl(0.0) << Dbl(lengths[2]) << "\n";
+      out << "ITEM: ATOMS id type mol x y z" << "\n";
 
-   /*
-   * Read interval and outputFileName. 
-   */
-   void LammpsDumpWriter::setup() 
-   {  
-      nSample_ = 0; 
-      std::string filename;
-      filename  = outputFileName();
-      fileMaster().openOutputFile(filename, outputFile_);
-   }
+      // Format contiguous ranges of atoms in per-thread buffers
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef MCMD_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         std::string& buffer = buffers_[threadId];
+         char line[LammpsDumpFormat::MaxLineLength];
+         const Atom* atomPtr;
+         int i, length;
+         buffer.clear();
+         #ifdef MCMD_OPENMP
+         #pragma omp for schedule(static)
+         #endif
+         for (i = 0; i < nAtom; ++i) {
+            atomPtr = atomPtrs_[i];
+            length = LammpsDumpFormat::formatAtom(line, atomPtr->id(),
+                                                  atomPtr->typeId(), 1,
+                                                  atomPtr->position());
+            buffer.append(line, length);
+         }
+      }
 
-   /*
-   * Dump configuration to file
-   */
-   void LammpsDumpWriter::sample(long iStep) 
-   {
-      if (isAtInterval(iStep))  {
-         system().writeConfig(outputFile_);
-         ++nSample_;
+      // Write buffers in thread order (i.e., in atom order)
+      for (int t = 0; t < buffers_.capacity(); ++t) {
+         out.write(buffers_[t].data(), buffers_[t].size());
       }
    }
-  
-   /*
-   * Read interval and outputFileName. 
-   */
-   void LammpsDumpWriter::output() 
-   {  outputFile_.close(); }
 
 }
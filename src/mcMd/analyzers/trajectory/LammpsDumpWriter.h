@@ -1,5 +1,5 @@
-#ifndef MCMD_CONFIG_WRITER_H
-#define MCMD_CONFIG_WRITER_H
+#ifndef MCMD_LAMMPS_DUMP_WRITER_H
+#define MCMD_LAMMPS_DUMP_WRITER_H
 
 /*
 * Simpatico - Simulation Package for Polymeric and Molecular Liquids
@@ -8,20 +8,30 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
-#include <mcMd/analyzers/SystemAnalyzer.h>
-#include <mcMd/simulation/System.h>
+#include <mcMd/analyzers/trajectory/TrajectoryWriter.h>  // base class
+#include <util/containers/DArray.h>                      // member
+
+#include <string>
 
 namespace McMd
 {
 
    using namespace Util;
 
+   class Atom;
+
    /**
    * Periodically write snapshots to a lammps dump (i.e., trajectory) file
    *
+   * Atoms are written in order of species, molecule and atom within
+   * the molecule. Lines of the ATOMS block are formatted by all threads
+   * (if compiled with MCMD_OPENMP), each into a private buffer for a
+   * contiguous range of atoms, and the buffers are then written in order.
+   * Files may be read by McMd::LammpsDumpReader and Tools::LammpsDumpReader.
+   *
    * \ingroup McMd_Analyzer_McMd_Module
    */
-   class LammpsDumpWriter : public SystemAnalyzer<System>
+   class LammpsDumpWriter : public TrajectoryWriter
    {
    
    public:
@@ -38,76 +48,26 @@ namespace McMd
       */
       virtual ~LammpsDumpWriter()
       {} 
-   
-      /**
-      * Read interval.
-      *
-      * \param in input parameter file
-      */
-      virtual void readParameters(std::istream& in);
-   
-      /**
-      * Save state to archive.
-      *
-      * \param ar saving (output) archive.
-      */
-      virtual void save(Serializable::OArchive& ar);
-
-      /**
-      * Load state from an archive.
-      *
-      * \param ar loading (input) archive.
-      */
-      virtual void loadParameters(Serializable::IArchive& ar);
 
-      /**
-      * Serialize to/from an archive. 
-      *
-      * \param ar      saving or loading archive
-      * \param version archive version id
-      */
-      template <class Archive>
-      void serialize(Archive& ar, const unsigned int version);
+   protected:
 
       /**
-      * Clear nSample counter.
-      */
-      virtual void setup();
-  
-      /**
-      * Write a frame/snapshot to file
+      * Write one frame.
       *
-      * \param iStep MC step index
+      * \param out output file stream
+      * \param iStep step index
       */
-      virtual void sample(long iStep);
- 
-      /**
-      * Close file.
-      */ 
-      virtual void output(); 
+      virtual void writeFrame(std::ofstream& out, long iStep);
 
    private:
-      
-      // Output file stream
-      std::ofstream outputFile_;
 
-      /// Number of configurations dumped thus far (first dump is zero).
-      long nSample_;
-   
-      /// Has readParam been called?
-      long isInitialized_;
+      /// Pointers to all atoms, in output order.
+      DArray<const Atom*> atomPtrs_;
+
+      /// Formatted text of the ATOMS block, one buffer per thread.
+      DArray<std::string> buffers_;
    
    };
 
-   /*
-   * Serialize to/from an archive. 
-   */
-   template <class Archive>
-   void LammpsDumpWriter::serialize(Archive& ar, const unsigned int version)
-   {
-      Analyzer::serialize(ar, version);
-      ar & nSample_;
-   }
-
 }
 #endif 
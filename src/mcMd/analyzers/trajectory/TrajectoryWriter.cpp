@@ -5,13 +5,11 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
-#include "LammpsDumpWriter.h"
+#include "TrajectoryWriter.h"
 #include <util/misc/FileMaster.h>
 #include <util/archives/Serializable_includes.h>
 #include <util/misc/ioUtil.h>
 
-#include <sstream>
-
 namespace McMd
 {
 
@@ -20,16 +18,17 @@ namespace McMd
    /*
    * Constructor.
    */
-   LammpsDumpWriter::LammpsDumpWriter(System& system) 
+   TrajectoryWriter::TrajectoryWriter(System& system, bool isBinary)
     : SystemAnalyzer<System>(system),
       nSample_(0),
-      isInitialized_(false)
-   {  setClassName("LammpsDumpWriter"); }
+      isInitialized_(false),
+      isBinary_(isBinary)
+   {  setClassName("TrajectoryWriter"); }
 
    /*
    * Read interval and outputFileName. 
    */
-   void LammpsDumpWriter::readParameters(std::istream& in) 
+   void TrajectoryWriter::readParameters(std::istream& in)
    {
       readInterval(in);
       readOutputFileName(in);
@@ -39,7 +38,7 @@ namespace McMd
    /*
    * Load state from an archive.
    */
-   void LammpsDumpWriter::loadParameters(Serializable::IArchive& ar)
+   void TrajectoryWriter::loadParameters(Serializable::IArchive& ar)
    {
       Analyzer::loadParameters(ar);
       ar & nSample_;
@@ -49,35 +48,40 @@ namespace McMd
    /*
    * Save state to archive.
    */
-   void LammpsDumpWriter::save(Serializable::OArchive& ar)
+   void TrajectoryWriter::save(Serializable::OArchive& ar)
    { ar & *this; }
 
    /*
-   * Read interval and outputFileName. 
+   * Clear nSample counter, and open file.
    */
-   void LammpsDumpWriter::setup() 
+   void TrajectoryWriter::setup()
    {  
       nSample_ = 0; 
-      std::string filename;
-      filename  = outputFileName();
-      fileMaster().openOutputFile(filename, outputFile_);
+      std::ios_base::openmode mode = std::ios_base::out;
+      if (isBinary_) {
+         mode |= std::ios_base::binary;
+      }
+      fileMaster().openOutputFile(outputFileName(), outputFile_, mode);
    }
 
    /*
-   * Dump configuration to file
+   * Write a frame, preceded by the header before the first frame.
    */
-   void LammpsDumpWriter::sample(long iStep) 
+   void TrajectoryWriter::sample(long iStep)
    {
       if (isAtInterval(iStep))  {
-         system().writeConfig(outputFile_);
+         if (nSample_ == 0) {
+            writeHeader(outputFile_);
+         }
+         writeFrame(outputFile_, iStep);
          ++nSample_;
       }
    }
   
    /*
-   * Read interval and outputFileName. 
+   * Close trajectory file.
    */
-   void LammpsDumpWriter::output() 
+   void TrajectoryWriter::output()
    {  outputFile_.close(); }
 
 }
@@ -1,5 +1,5 @@
-#ifndef MCMD_CONFIG_WRITER_H
-#define MCMD_CONFIG_WRITER_H
+#ifndef MCMD_TRAJECTORY_WRITER_H
+#define MCMD_TRAJECTORY_WRITER_H
 
 /*
 * Simpatico - Simulation Package for Polymeric and Molecular Liquids
@@ -17,7 +17,10 @@ namespace McMd
    using namespace Util;
 
    /**
-   * Periodically write snapshots to a lammps dump (i.e., trajectory) file
+   * Base class for analyzers that periodically write trajectory frames.
+   *
+   * Subclasses implement writeFrame(), and may implement writeHeader().
+   * The file is opened by setup() and closed by output().
    *
    * \ingroup McMd_Analyzer_McMd_Module
    */
@@ -30,8 +33,9 @@ namespace McMd
       * Constructor.
       *
       * \param system parent System object. 
+      * \param isBinary is the file format binary (true) or text (false)?
       */
-      TrajectoryWriter(System& system);
+      TrajectoryWriter(System& system, bool isBinary = false);
    
       /**
       * Destructor.
@@ -40,7 +44,7 @@ namespace McMd
       {} 
    
       /**
-      * Read interval.
+      * Read interval and outputFileName.
       *
       * \param in input parameter file
       */
@@ -70,7 +74,7 @@ namespace McMd
       void serialize(Archive& ar, const unsigned int version);
 
       /**
-      * Clear nSample counter.
+      * Clear nSample counter, and open the trajectory file.
       */
       virtual void setup();
   
@@ -127,6 +131,14 @@ namespace McMd
 
    };
 
+   // Inline method
+
+   /*
+   * Is the file format binary?
+   */
+   inline bool TrajectoryWriter::isBinary() const
+   {  return isBinary_; }
+
    /*
    * Serialize to/from an archive. 
    */
@@ -0,0 +1,193 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "MultipleTauAutoCorr.h"
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   MultipleTauAutoCorr::MultipleTauAutoCorr()
+    : values_(),
+      blockSums_(),
+      averages_(),
+      sums_(),
+      counts_(),
+      nFrames_(),
+      nBlockSums_(),
+      nSample_(0),
+      ensembleCapacity_(0),
+      nEnsemble_(0),
+      blockLength_(0),
+      blockFactor_(0),
+      nLevel_(0)
+   {}
+
+   /*
+   * Set parameters and allocate memory.
+   */
+   void
+   MultipleTauAutoCorr::setParam(int ensembleCapacity, int blockLength,
+                                 int blockFactor, int nLevel)
+   {
+      if (ensembleCapacity <= 0) {
+         UTIL_THROW("Nonpositive ensembleCapacity");
+      }
+      if (blockFactor < 2) {
+         UTIL_THROW("blockFactor < 2");
+      }
+      if (blockLength < blockFactor) {
+         UTIL_THROW("blockLength < blockFactor");
+      }
+      if (nLevel <= 0) {
+         UTIL_THROW("Nonpositive nLevel");
+      }
+
+      // Check that the longest time lag fits in a long
+      long maxLag = blockLength;
+      for (int i = 1; i < nLevel; ++i) {
+         if (maxLag > 2147483647L/blockFactor) {
+            UTIL_THROW("blockLength*blockFactor^(nLevel-1) is too large");
+         }
+         maxLag *= blockFactor;
+      }
+
+      ensembleCapacity_ = ensembleCapacity;
+      blockLength_ = blockLength;
+      blockFactor_ = blockFactor;
+      nLevel_ = nLevel;
+      values_.allocate(nLevel*blockLength*ensembleCapacity);
+      blockSums_.allocate(nLevel*ensembleCapacity);
+      averages_.allocate(ensembleCapacity);
+      sums_.allocate(nLevel*blockLength);
+      counts_.allocate(nLevel*blockLength);
+      nFrames_.allocate(nLevel);
+      nBlockSums_.allocate(nLevel);
+      nEnsemble_ = 0;
+      clear();
+   }
+
+   /*
+   * Set the number of members of the ensemble.
+   */
+   void MultipleTauAutoCorr::setNEnsemble(int nEnsemble)
+   {
+      if (nEnsemble > ensembleCapacity_) {
+         UTIL_THROW("nEnsemble > ensembleCapacity");
+      }
+      nEnsemble_ = nEnsemble;
+   }
+
+   /*
+   * Reset to empty state.
+   */
+   void MultipleTauAutoCorr::clear()
+   {
+      int i;
+      for (i = 0; i < sums_.capacity(); ++i) {
+         sums_[i] = 0.0;
+         counts_[i] = 0;
+      }
+      for (i = 0; i < blockSums_.capacity(); ++i) {
+         blockSums_[i].zero();
+      }
+      for (i = 0; i < nLevel_; ++i) {
+         nFrames_[i] = 0;
+         nBlockSums_[i] = 0;
+      }
+      nSample_ = 0;
+   }
+
+   /*
+   * Add values at one time to the accumulator.
+   */
+   void MultipleTauAutoCorr::sample(const Array<Vector>& values)
+   {
+      if (nEnsemble_ <= 0) {
+         ++nSample_;
+         return;
+      }
+
+      const Vector* current = &values[0];
+      double sum;
+      double norm = 1.0/double(blockFactor_);
+      long nFrame;
+      int level, k, kMin, nLag, slot, i, begin;
+
+      for (level = 0; level < nLevel_; ++level) {
+
+         // Store current values, overwriting the oldest frame
+         slot = int(nFrames_[level] % blockLength_);
+         begin = (level*blockLength_ + slot)*ensembleCapacity_;
+         for (i = 0; i < nEnsemble_; ++i) {
+            values_[begin + i] = current[i];
+         }
+         ++nFrames_[level];
+
+         // Correlate current values with stored frames of this level.
+         // Lags k < blockLength/blockFactor of higher levels are
+         // already computed more accurately by the level below.
+         nFrame = nFrames_[level];
+         kMin = (level == 0) ? 0 : blockLength_/blockFactor_;
+         nLag = (nFrame < blockLength_) ? int(nFrame) - 1 : blockLength_ - 1;
+         for (k = kMin; k <= nLag; ++k) {
+            slot = int((nFrame - 1 - k) % blockLength_);
+            begin = (level*blockLength_ + slot)*ensembleCapacity_;
+            sum = 0.0;
+            for (i = 0; i < nEnsemble_; ++i) {
+               sum += current[i].dot(values_[begin + i]);
+            }
+            sums_[level*blockLength_ + k] += sum;
+            counts_[level*blockLength_ + k] += nEnsemble_;
+         }
+
+         if (level == nLevel_ - 1) break;
+
+         // Add to block sum, and pass block average to the next level
+         begin = level*ensembleCapacity_;
+         for (i = 0; i < nEnsemble_; ++i) {
+            blockSums_[begin + i] += current[i];
+         }
+         ++nBlockSums_[level];
+         if (nBlockSums_[level] < blockFactor_) break;
+         for (i = 0; i < nEnsemble_; ++i) {
+            averages_[i].multiply(blockSums_[begin + i], norm);
+            blockSums_[begin + i].zero();
+         }
+         nBlockSums_[level] = 0;
+         current = &averages_[0];
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Output time lags and autocorrelation function.
+   */
+   void MultipleTauAutoCorr::output(std::ostream& out) const
+   {
+      long stride = 1;
+      int level, k, kMin, j;
+      for (level = 0; level < nLevel_; ++level) {
+         kMin = (level == 0) ? 0 : blockLength_/blockFactor_;
+         for (k = kMin; k < blockLength_; ++k) {
+            j = level*blockLength_ + k;
+            if (counts_[j] > 0) {
+               out << Int(int(k*stride), 10)
+                   << Dbl(sums_[j]/double(counts_[j]), 20) << std::endl;
+            }
+         }
+         stride *= blockFactor_;
+      }
+   }
+
+}
@@ -0,0 +1,193 @@
+#ifndef MCMD_MULTIPLE_TAU_AUTO_CORR_H
+#define MCMD_MULTIPLE_TAU_AUTO_CORR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>      // member template
+#include <util/containers/Array.h>       // function argument template
+#include <util/space/Vector.h>           // member template argument
+#include <util/global.h>
+
+#include <iostream>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * Multiple-tau autocorrelation accumulator for an ensemble of vectors.
+   *
+   * This class implements the multiple-tau correlator described by
+   * Ramirez et al. (J. Chem. Phys. 133, 154103, 2010), for an ensemble
+   * of Vector quantities. Values are stored in nLevel levels of
+   * blockLength frames. Level 0 stores every sample. Each higher level
+   * stores averages of blockFactor consecutive values of the level
+   * below it. Level l is used to compute correlations for time lags
+   * k*(blockFactor)^l, with k < blockLength at level 0 and with
+   * blockLength/blockFactor <= k < blockLength at higher levels.
+   * The accumulator thus spans time lags of order
+   * blockLength*(blockFactor)^(nLevel-1) samples, while storing
+   * only nLevel*blockLength values for each member of the ensemble.
+   *
+   * The output is the ensemble average of the dot product x(t).x(t+lag).
+   */
+   class MultipleTauAutoCorr
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      MultipleTauAutoCorr();
+
+      /**
+      * Set parameters and allocate memory.
+      *
+      * \param ensembleCapacity maximum number of members of ensemble
+      * \param blockLength      number of frames stored per level
+      * \param blockFactor      number of values averaged between levels
+      * \param nLevel           number of levels
+      */
+      void setParam(int ensembleCapacity, int blockLength,
+                    int blockFactor, int nLevel);
+
+      /**
+      * Set the number of members of the ensemble.
+      *
+      * \param nEnsemble number of members (<= ensembleCapacity)
+      */
+      void setNEnsemble(int nEnsemble);
+
+      /**
+      * Reset to empty state, with no samples.
+      */
+      void clear();
+
+      /**
+      * Add the values of all members of the ensemble at one time.
+      *
+      * \param values array of nEnsemble values
+      */
+      void sample(const Array<Vector>& values);
+
+      /**
+      * Output time lag (in samples) and autocorrelation function.
+      *
+      * Each line contains a time lag and the corresponding ensemble
+      * averaged correlation, in order of increasing time lag.
+      *
+      * \param out output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Serialize to/from an archive.
+      *
+      * \param ar      saving or loading archive
+      * \param version archive version id
+      */
+      template <class Archive>
+      void serialize(Archive& ar, const unsigned int version);
+
+      /**
+      * Get number of members of the ensemble.
+      */
+      int nEnsemble() const
+      {  return nEnsemble_; }
+
+      /**
+      * Get number of frames stored per level.
+      */
+      int blockLength() const
+      {  return blockLength_; }
+
+      /**
+      * Get number of values averaged between levels.
+      */
+      int blockFactor() const
+      {  return blockFactor_; }
+
+      /**
+      * Get number of levels.
+      */
+      int nLevel() const
+      {  return nLevel_; }
+
+      /**
+      * Get number of samples added thus far.
+      */
+      long nSample() const
+      {  return nSample_; }
+
+   private:
+
+      /// Stored values, element [(level*blockLength + slot)*capacity + i].
+      DArray<Vector> values_;
+
+      /// Partial block sums passed up a level, element [level*capacity + i].
+      DArray<Vector> blockSums_;
+
+      /// Block averages passed to the next level (workspace).
+      DArray<Vector> averages_;
+
+      /// Sums of correlations, element [level*blockLength + k].
+      DArray<double> sums_;
+
+      /// Number of terms in each sum, element [level*blockLength + k].
+      DArray<long> counts_;
+
+      /// Number of frames stored in each level.
+      DArray<long> nFrames_;
+
+      /// Number of values in the current block sum of each level.
+      DArray<int> nBlockSums_;
+
+      /// Number of samples added thus far.
+      long nSample_;
+
+      /// Maximum number of members of the ensemble.
+      int ensembleCapacity_;
+
+      /// Number of members of the ensemble.
+      int nEnsemble_;
+
+      /// Number of frames stored per level.
+      int blockLength_;
+
+      /// Number of values averaged between levels.
+      int blockFactor_;
+
+      /// Number of levels.
+      int nLevel_;
+
+   };
+
+   /*
+   * Serialize to/from an archive.
+   */
+   template <class Archive>
+   void MultipleTauAutoCorr::serialize(Archive& ar, const unsigned int version)
+   {
+      ar & ensembleCapacity_;
+      ar & blockLength_;
+      ar & blockFactor_;
+      ar & nLevel_;
+      ar & nEnsemble_;
+      ar & nSample_;
+      ar & values_;
+      ar & blockSums_;
+      ar & sums_;
+      ar & counts_;
+      ar & nFrames_;
+      ar & nBlockSums_;
+   }
+
+}
+#endif
@@ -0,0 +1,159 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "OrderNMeanSqDisp.h"
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   OrderNMeanSqDisp::OrderNMeanSqDisp()
+    : positions_(),
+      sums_(),
+      counts_(),
+      nFrames_(),
+      nSample_(0),
+      ensembleCapacity_(0),
+      nEnsemble_(0),
+      blockLength_(0),
+      nLevel_(0)
+   {}
+
+   /*
+   * Set parameters and allocate memory.
+   */
+   void 
+   OrderNMeanSqDisp::setParam(int ensembleCapacity, int blockLength, 
+                              int nLevel)
+   {
+      if (ensembleCapacity <= 0) {
+         UTIL_THROW("Nonpositive ensembleCapacity");
+      }
+      if (blockLength < 2) {
+         UTIL_THROW("blockLength < 2");
+      }
+      if (nLevel <= 0) {
+         UTIL_THROW("Nonpositive nLevel");
+      }
+
+      // Check that the longest time lag fits in a long
+      long maxLag = 1;
+      for (int i = 0; i < nLevel; ++i) {
+         if (maxLag > 2147483647L/blockLength) {
+            UTIL_THROW("blockLength^nLevel is too large");
+         }
+         maxLag *= blockLength;
+      }
+
+      ensembleCapacity_ = ensembleCapacity;
+      blockLength_ = blockLength;
+      nLevel_ = nLevel;
+      positions_.allocate(nLevel*blockLength*ensembleCapacity);
+      sums_.allocate(nLevel*blockLength);
+      counts_.allocate(nLevel*blockLength);
+      nFrames_.allocate(nLevel);
+      nEnsemble_ = 0;
+      clear();
+   }
+
+   /*
+   * Set the number of members of the ensemble.
+   */
+   void OrderNMeanSqDisp::setNEnsemble(int nEnsemble)
+   {
+      if (nEnsemble > ensembleCapacity_) {
+         UTIL_THROW("nEnsemble > ensembleCapacity");
+      }
+      nEnsemble_ = nEnsemble;
+   }
+
+   /*
+   * Reset to empty state.
+   */
+   void OrderNMeanSqDisp::clear()
+   {
+      int i;
+      for (i = 0; i < sums_.capacity(); ++i) {
+         sums_[i] = 0.0;
+         counts_[i] = 0;
+      }
+      for (i = 0; i < nLevel_; ++i) {
+         nFrames_[i] = 0;
+      }
+      nSample_ = 0;
+   }
+
+   /*
+   * Add positions at one time to the accumulator.
+   */
+   void OrderNMeanSqDisp::sample(const Array<Vector>& positions)
+   {
+      Vector dr;
+      double sum;
+      long stride = 1;
+      long nFrame;
+      int level, k, nLag, slot, i, begin;
+
+      for (level = 0; level < nLevel_; ++level) {
+
+         // Level l stores every (blockLength)^l-th sample
+         if (nSample_ % stride != 0) break;
+
+         // Accumulate displacements from stored frames of this level
+         nFrame = nFrames_[level];
+         nLag = (nFrame < blockLength_) ? int(nFrame) : blockLength_ - 1;
+         for (k = 1; k <= nLag; ++k) {
+            slot = int((nFrame - k) % blockLength_);
+            begin = (level*blockLength_ + slot)*ensembleCapacity_;
+            sum = 0.0;
+            for (i = 0; i < nEnsemble_; ++i) {
+               dr.subtract(positions[i], positions_[begin + i]);
+               sum += dr.square();
+            }
+            sums_[level*blockLength_ + k] += sum;
+            counts_[level*blockLength_ + k] += nEnsemble_;
+         }
+
+         // Store current positions, overwriting the oldest frame
+         slot = int(nFrame % blockLength_);
+         begin = (level*blockLength_ + slot)*ensembleCapacity_;
+         for (i = 0; i < nEnsemble_; ++i) {
+            positions_[begin + i] = positions[i];
+         }
+         ++nFrames_[level];
+
+         stride *= blockLength_;
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Output time lags and mean-squared displacements.
+   */
+   void OrderNMeanSqDisp::output(std::ostream& out) const
+   {
+      long stride = 1;
+      int level, k, j;
+      for (level = 0; level < nLevel_; ++level) {
+         for (k = 1; k < blockLength_; ++k) {
+            j = level*blockLength_ + k;
+            if (counts_[j] > 0) {
+               out << Int(int(k*stride), 10) 
+                   << Dbl(sums_[j]/double(counts_[j]), 20) << std::endl;
+            }
+         }
+         stride *= blockLength_;
+      }
+   }
+
+}
@@ -0,0 +1,169 @@
+#ifndef MCMD_ORDER_N_MEAN_SQ_DISP_H
+#define MCMD_ORDER_N_MEAN_SQ_DISP_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>      // member template
+#include <util/containers/Array.h>       // function argument template
+#include <util/space/Vector.h>           // member template argument
+#include <util/global.h>
+
+#include <iostream>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * Order-n accumulator for the mean-squared displacement of an ensemble.
+   *
+   * This class implements the multiple-window (order-n) algorithm for
+   * mean-squared displacements described by Frenkel and Smit and by
+   * Dubbeldam et al. (Mol. Simul. 35, 1084, 2009). Positions are stored
+   * in nLevel levels of blockLength frames. Level l stores every
+   * (blockLength)^l-th sample, and is used to compute displacements
+   * for time lags k*(blockLength)^l, for 0 < k < blockLength. The 
+   * accumulator thus spans time lags up to (blockLength)^nLevel 
+   * samples, while storing only nLevel*blockLength positions for each
+   * member of the ensemble.
+   *
+   * Positions passed to sample() must be "true" positions, which are
+   * not shifted into the primary cell of a periodic system.
+   */
+   class OrderNMeanSqDisp
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      OrderNMeanSqDisp();
+
+      /**
+      * Set parameters and allocate memory.
+      *
+      * \param ensembleCapacity maximum number of members of ensemble
+      * \param blockLength      number of frames stored per level
+      * \param nLevel           number of levels
+      */
+      void setParam(int ensembleCapacity, int blockLength, int nLevel);
+
+      /**
+      * Set the number of members of the ensemble.
+      *
+      * \param nEnsemble number of members (<= ensembleCapacity)
+      */
+      void setNEnsemble(int nEnsemble);
+
+      /**
+      * Reset to empty state, with no samples.
+      */
+      void clear();
+
+      /**
+      * Add the positions of all members of the ensemble at one time.
+      *
+      * \param positions array of nEnsemble true position vectors
+      */
+      void sample(const Array<Vector>& positions);
+
+      /**
+      * Output time lag (in samples) and mean-squared displacement.
+      *
+      * Each line contains a time lag and the corresponding mean 
+      * squared displacement, in order of increasing time lag.
+      *
+      * \param out output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Serialize to/from an archive.
+      *
+      * \param ar      saving or loading archive
+      * \param version archive version id
+      */
+      template <class Archive>
+      void serialize(Archive& ar, const unsigned int version);
+
+      /**
+      * Get number of members of the ensemble.
+      */
+      int nEnsemble() const
+      {  return nEnsemble_; }
+
+      /**
+      * Get number of frames stored per level.
+      */
+      int blockLength() const
+      {  return blockLength_; }
+
+      /**
+      * Get number of levels.
+      */
+      int nLevel() const
+      {  return nLevel_; }
+
+      /**
+      * Get number of samples added thus far.
+      */
+      long nSample() const
+      {  return nSample_; }
+
+   private:
+
+      /// Stored positions, element [(level*blockLength + slot)*capacity + i].
+      DArray<Vector> positions_;
+
+      /// Sums of squared displacements, element [level*blockLength + k].
+      DArray<double> sums_;
+
+      /// Number of terms in each sum, element [level*blockLength + k].
+      DArray<long> counts_;
+
+      /// Number of frames stored in each level.
+      DArray<long> nFrames_;
+
+      /// Number of samples added thus far.
+      long nSample_;
+
+      /// Maximum number of members of the ensemble.
+      int ensembleCapacity_;
+
+      /// Number of members of the ensemble.
+      int nEnsemble_;
+
+      /// Number of frames stored per level.
+      int blockLength_;
+
+      /// Number of levels.
+      int nLevel_;
+
+   };
+
+   /*
+   * Serialize to/from an archive.
+   */
+   template <class Archive>
+   void OrderNMeanSqDisp::serialize(Archive& ar, const unsigned int version)
+   {
+      ar & ensembleCapacity_;
+      ar & blockLength_;
+      ar & nLevel_;
+      ar & nEnsemble_;
+      ar & nSample_;
+      ar & positions_;
+      ar & sums_;
+      ar & counts_;
+      ar & nFrames_;
+   }
+
+}
+#endif
@@ -1,4 +1,7 @@
-mcMd_analyzers_util_=mcMd/analyzers/util/PairSelector.cpp 
+mcMd_analyzers_util_=\
+    mcMd/analyzers/util/PairSelector.cpp \
+    mcMd/analyzers/util/OrderNMeanSqDisp.cpp \
+    mcMd/analyzers/util/MultipleTauAutoCorr.cpp 
 
 mcMd_analyzers_util_SRCS=\
      $(addprefix $(SRC_DIR)/, $(mcMd_analyzers_util_))
@@ -14,6 +14,18 @@ namespace McMd
    using namespace Util;
 
    // Define and initialize static variables
+   #ifdef MCMD_REPLICAS
+   __thread Atom*      Atom::atoms_ = 0;
+   __thread Mask*      Atom::masks_ = 0;
+   __thread Molecule** Atom::moleculePtrs_ = 0;
+   __thread Vector*    Atom::velocities_ = 0;
+   __thread Vector*    Atom::forces_ = 0;
+   __thread bool*      Atom::isActives_ = 0;
+   #ifdef MCMD_SHIFT
+   __thread IntVector* Atom::shifts_ = 0;
+   #endif
+   __thread int        Atom::capacity_ = 0;
+   #else
    Atom*      Atom::atoms_ = 0;
    Mask*      Atom::masks_ = 0;
    Molecule** Atom::moleculePtrs_ = 0;
@@ -24,6 +36,7 @@ namespace McMd
    IntVector* Atom::shifts_ = 0;
    #endif
    int        Atom::capacity_ = 0;
+   #endif
 
    // Static functions
 
@@ -135,6 +148,58 @@ namespace McMd
       capacity_ = 0;
    }
 
+   #ifdef MCMD_REPLICAS
+   /*
+   * Constructor for an empty Context.
+   */
+   Atom::Context::Context()
+    : atoms(0),
+      masks(0),
+      moleculePtrs(0),
+      forces(0),
+      velocities(0),
+      isActives(0),
+      #ifdef MCMD_SHIFT
+      shifts(0),
+      #endif
+      capacity(0)
+   {}
+
+   /*
+   * Get the addresses of the arrays of the calling thread.
+   */
+   void Atom::getContext(Atom::Context& context)
+   {
+      context.atoms = atoms_;
+      context.masks = masks_;
+      context.moleculePtrs = moleculePtrs_;
+      context.forces = forces_;
+      context.velocities = velocities_;
+      context.isActives = isActives_;
+      #ifdef MCMD_SHIFT
+      context.shifts = shifts_;
+      #endif
+      context.capacity = capacity_;
+   }
+
+   /*
+   * Set the addresses of the arrays of the calling thread.
+   */
+   void Atom::setContext(const Atom::Context& context)
+   {
+      atoms_ = context.atoms;
+      masks_ = context.masks;
+      moleculePtrs_ = context.moleculePtrs;
+      forces_ = context.forces;
+      velocities_ = context.velocities;
+      isActives_ = context.isActives;
+      #ifdef MCMD_SHIFT
+      shifts_ = context.shifts;
+      #endif
+      capacity_ = context.capacity;
+   }
+   #endif
+
    // Nonstatic member functions
 
    /*
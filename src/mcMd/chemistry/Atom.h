@@ -19,6 +19,16 @@ namespace Util {
    template <class Data> class RArray;
 }
 
+/*
+* If MCMD_REPLICAS is defined, the static arrays of Atom data are thread
+* local, so that threads can run different Simulations (see McReplicaSet).
+*/
+#ifdef MCMD_REPLICAS
+#define MCMD_ATOM_STATIC static __thread
+#else
+#define MCMD_ATOM_STATIC static
+#endif
+
 namespace McMd
 {
 
@@ -74,6 +84,16 @@ namespace McMd
    * functions for the associated attributes, as if they were normal 
    * non-static class members. 
    *
+   * \section Replicas Several simulations in one process
+   *
+   * If compiled with MCMD_REPLICAS defined, these static arrays are
+   * thread local, and the addresses of all arrays allocated by one
+   * Simulation may be saved in an Atom::Context by getContext(), and
+   * reinstalled by setContext() on any thread. This allows a process to
+   * run several Simulation objects on different threads, provided that
+   * each thread installs the Context of a Simulation before using it.
+   * Each access to an array is then slightly more expensive.
+   *
    * \ingroup McMd_Chemistry_Module
    */
    class Atom
@@ -193,6 +213,44 @@ namespace McMd
       */
       static int capacity();
 
+      #ifdef MCMD_REPLICAS
+      /**
+      * Addresses of all static arrays allocated by one Simulation.
+      */
+      struct Context
+      {
+         Atom*      atoms;
+         Mask*      masks;
+         Molecule** moleculePtrs;
+         Vector*    forces;
+         Vector*    velocities;
+         bool*      isActives;
+         #ifdef MCMD_SHIFT
+         IntVector* shifts;
+         #endif
+         int        capacity;
+
+         /**
+         * Constructor (creates an empty Context).
+         */
+         Context();
+      };
+
+      /**
+      * Get the arrays used by the calling thread.
+      *
+      * \param context on return, addresses of the current arrays
+      */
+      static void getContext(Context& context);
+
+      /**
+      * Set the arrays used by the calling thread.
+      *
+      * \param context addresses of arrays allocated by a Simulation
+      */
+      static void setContext(const Context& context);
+      #endif
+
       //@}
 
    private:
@@ -203,30 +261,30 @@ namespace McMd
       static const int NullIndex = -1;
 
       /// Array containing all Atom objects in this simulation.
-      static Atom* atoms_;
+      MCMD_ATOM_STATIC Atom* atoms_;
 
       /// Array of Mask objects
-      static Mask* masks_;
+      MCMD_ATOM_STATIC Mask* masks_;
 
       /// Array of pointers to Molecules
-      static Molecule** moleculePtrs_;
+      MCMD_ATOM_STATIC Molecule** moleculePtrs_;
 
       /// Array of atomic force vectors
-      static Vector* forces_;
+      MCMD_ATOM_STATIC Vector* forces_;
 
       /// Array of atomic velocity vectors
-      static Vector* velocities_;
+      MCMD_ATOM_STATIC Vector* velocities_;
 
       /// Array of bool "isActive" flags
-      static bool* isActives_;
+      MCMD_ATOM_STATIC bool* isActives_;
 
       #ifdef MCMD_SHIFT
       /// Array of boundary condition shifts
-      static IntVector* shifts_;
+      MCMD_ATOM_STATIC IntVector* shifts_;
       #endif
 
       /// Total number of atoms allocated
-      static int capacity_;
+      MCMD_ATOM_STATIC int capacity_;
 
       // Non-static member variables
  
@@ -330,5 +388,18 @@ namespace McMd
    inline void Atom::setIsActive(bool isActive)
    {  isActives_[id_] = isActive; }
 
+   // Inline methods of Mask that require Atom::id()
+
+   // Check if an Atom is in the masked set.
+   inline bool Mask::isMasked(const Atom& atom) const
+   {
+      if (!((bits_ >> (atom.id() & 63)) & 1)) return false;
+      const Atom* ptr = &atom;
+      for (int i=0; i < size_ ; ++i) {
+         if (atomPtrs_[i] == ptr) return true;
+      }
+      return false;
+   }
+
 }
 #endif
@@ -6,6 +6,7 @@
 */
 
 #include "Mask.h"
+#include "Atom.h"
 #include <util/global.h>
 
 namespace McMd
@@ -17,7 +18,8 @@ namespace McMd
    * Constructor.
    */
    Mask::Mask()
-    : size_(0)
+    : bits_(0),
+      size_(0)
    {
       for (int i=0; i < Capacity; ++i) {
          atomPtrs_[i] = 0;
@@ -32,6 +34,7 @@ namespace McMd
       for (int i=0; i < Capacity; ++i) {
          atomPtrs_[i] = 0;
       }
+      bits_ = 0;
       size_ = 0;
    }
 
@@ -47,6 +50,7 @@ namespace McMd
          UTIL_THROW("Attempt to add an atom to a Mask twice");
       }
       atomPtrs_[size_] = &atom;
+      bits_ |= (uint64_t(1) << (atom.id() & 63));
       ++size_;
    }
 
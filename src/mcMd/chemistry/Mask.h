@@ -8,6 +8,8 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
+#include <stdint.h>
+
 namespace McMd
 {
 
@@ -23,6 +25,11 @@ namespace McMd
    * A Mask could, for example, contain all atoms that are directly connected 
    * to the target atom by 2-body covalent bonds.
    *
+   * The Mask also keeps a 64 bit filter in which bit (id & 63) is set 
+   * for the Atom::id() of every masked atom. isMasked() tests this 
+   * filter first, and scans the list only if the bit is set, so that
+   * the common case of an unmasked pair is rejected without a loop.
+   *
    * \ingroup McMd_Chemistry_Module
    */
    class Mask 
@@ -50,6 +57,9 @@ namespace McMd
       /**
       * True if the atom is in the masked set for the target Atom.
       *
+      * This function is defined inline in Atom.h, because it requires
+      * Atom::id().
+      *
       * \param  atom Atom object to be tested.
       * \return true if atom is masked, false otherwise.
       */
@@ -68,6 +78,9 @@ namespace McMd
       /// Pointers to of masked Atoms.
       const Atom* atomPtrs_[Capacity];      
 
+      /// Filter, with bit (id & 63) set for each masked Atom.
+      uint64_t bits_;
+
       /// Number of masked Atoms.
       int  size_;                 
 
@@ -78,18 +91,6 @@ namespace McMd
 
    // Inline member functions.
 
-   /*
-   * Check if an Atom is in the masked set.
-   */
-   inline bool Mask::isMasked(const Atom& atom) const
-   {
-      const Atom* ptr = &atom;
-      for (int i=0; i < size_ ; ++i) {
-         if (atomPtrs_[i] == ptr) return true;
-      }
-      return false;
-   }
-
    /*
    * Return the number of masked atoms.
    */
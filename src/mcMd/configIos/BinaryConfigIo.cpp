@@ -0,0 +1,224 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BinaryConfigIo.h"
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/simulation/System.h>
+#include <mcMd/species/SpeciesMutator.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#ifdef SIMP_TETHER
+#include <mcMd/tethers/TetherMaster.h>
+#endif
+#ifdef MCMD_LINK
+#include <mcMd/links/LinkMaster.h>
+#endif
+#include <simp/species/Species.h>
+#include <simp/trajectory/BinaryConfigFormat.h>
+#include <util/space/Dimension.h>
+
+#include <string>
+#include <limits>
+
+namespace McMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /*
+   * Constructor.
+   */
+   BinaryConfigIo::BinaryConfigIo(System& system, bool hasVelocities)
+    : ConfigIo(system),
+      buffer_(),
+      hasVelocities_(hasVelocities)
+   {}
+
+   /*
+   * Destructor.
+   */
+   BinaryConfigIo::~BinaryConfigIo()
+   {}
+
+   /*
+   * Read a binary configuration file.
+   */
+   void BinaryConfigIo::read(std::istream& in)
+   {
+      // Text lines: magic string and version, then Boundary
+      std::string magic;
+      int version;
+      in >> magic >> version;
+      if (!in || magic != BinaryConfig::Magic) {
+         UTIL_THROW("File is not a binary config file");
+      }
+      if (version != BinaryConfig::Version) {
+         UTIL_THROW("Unsupported binary config file version");
+      }
+      in >> boundary();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+      BinaryConfig::FileHeader header;
+      in.read((char*)(&header), sizeof(BinaryConfig::FileHeader));
+      if (!in) {
+         UTIL_THROW("Error reading binary config header");
+      }
+      if (header.nSpecies != simulation().nSpecies()) {
+         UTIL_THROW("Inconsistent number of species");
+      }
+      bool hasVelocities = (header.flags & BinaryConfig::HasVelocities);
+
+      BinaryConfig::SpeciesHeader speciesHeader;
+      Species* speciesPtr;
+      Molecule* molPtr;
+      Molecule::AtomIterator atomIter;
+      const double* positions;
+      const double* velocities;
+      const int32_t* states;
+      size_t nByte;
+      int iSpecies, nMolecule, iMol, n, k, j;
+      for (iSpecies = 0; iSpecies < simulation().nSpecies(); ++iSpecies) {
+         speciesPtr = &simulation().species(iSpecies);
+         in.read((char*)(&speciesHeader),
+                 sizeof(BinaryConfig::SpeciesHeader));
+         if (!in) {
+            UTIL_THROW("Error reading binary config species header");
+         }
+         if (speciesHeader.nAtom != speciesPtr->nAtom()) {
+            UTIL_THROW("Inconsistent number of atoms per molecule");
+         }
+         if (bool(speciesHeader.isMutable) != speciesPtr->isMutable()) {
+            UTIL_THROW("Inconsistent species mutability");
+         }
+
+         // Read all data for this species
+         nByte = BinaryConfig::blockSize(speciesHeader, header.flags);
+         buffer_.resize(nByte);
+         if (nByte > 0) {
+            in.read(&buffer_[0], nByte);
+            if (!in) {
+               UTIL_THROW("Incomplete binary config species block");
+            }
+         }
+         nMolecule = speciesHeader.nMolecule;
+         n = nMolecule*speciesHeader.nAtom;
+         positions = (const double*)(&buffer_[0]);
+         velocities = hasVelocities ? positions + 3*n : 0;
+         states = (const int32_t*)(positions + (hasVelocities ? 6*n : 3*n));
+         states += n;
+
+         // Add molecules, and copy data into atoms
+         k = 0;
+         for (iMol = 0; iMol < nMolecule; ++iMol) {
+            molPtr = &(simulation().getMolecule(iSpecies));
+            system().addMolecule(*molPtr);
+            if (speciesPtr->isMutable()) {
+               speciesPtr->mutator().setMoleculeState(*molPtr, states[iMol]);
+            }
+            for (molPtr->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               for (j = 0; j < Dimension; ++j) {
+                  atomIter->position()[j] = positions[3*k + j];
+               }
+               if (velocities) {
+                  for (j = 0; j < Dimension; ++j) {
+                     atomIter->velocity()[j] = velocities[3*k + j];
+                  }
+               }
+               #ifdef MCMD_SHIFT
+               for (j = 0; j < Dimension; ++j) {
+                  atomIter->shift()[j] = 0;
+               }
+               boundary().shift(atomIter->position(), atomIter->shift());
+               #else
+               boundary().shift(atomIter->position());
+               #endif
+               ++k;
+            }
+         }
+      }
+   }
+
+   /*
+   * Write a binary configuration file.
+   */
+   void BinaryConfigIo::write(std::ostream& out)
+   {
+      #ifdef SIMP_TETHER
+      if (system().tetherMaster().nTether() > 0) {
+         UTIL_THROW("Tethers cannot be written to a binary config file");
+      }
+      #endif
+      #ifdef MCMD_LINK
+      if (system().linkMaster().nLink() > 0) {
+         UTIL_THROW("Links cannot be written to a binary config file");
+      }
+      #endif
+
+      out << BinaryConfig::Magic << "  " << BinaryConfig::Version
+          << std::endl;
+      out << boundary() << std::endl;
+
+      BinaryConfig::FileHeader header;
+      header.nSpecies = simulation().nSpecies();
+      header.flags = hasVelocities_ ? BinaryConfig::HasVelocities : 0;
+      out.write((const char*)(&header), sizeof(BinaryConfig::FileHeader));
+
+      BinaryConfig::SpeciesHeader speciesHeader;
+      System::ConstMoleculeIterator molIter;
+      Molecule::ConstAtomIterator atomIter;
+      Species* speciesPtr;
+      double* positions;
+      double* velocities;
+      int32_t* types;
+      int32_t* states;
+      size_t nByte;
+      int iSpecies, iMol, n, k, j;
+      for (iSpecies = 0; iSpecies < simulation().nSpecies(); ++iSpecies) {
+         speciesPtr = &simulation().species(iSpecies);
+         speciesHeader.nMolecule = system().nMolecule(iSpecies);
+         speciesHeader.nAtom = speciesPtr->nAtom();
+         speciesHeader.isMutable = speciesPtr->isMutable() ? 1 : 0;
+         out.write((const char*)(&speciesHeader),
+                   sizeof(BinaryConfig::SpeciesHeader));
+
+         // Pack all data for this species, then write it
+         nByte = BinaryConfig::blockSize(speciesHeader, header.flags);
+         if (nByte == 0) continue;
+         buffer_.resize(nByte);
+         n = speciesHeader.nMolecule*speciesHeader.nAtom;
+         positions = (double*)(&buffer_[0]);
+         velocities = hasVelocities_ ? positions + 3*n : 0;
+         types = (int32_t*)(positions + (hasVelocities_ ? 6*n : 3*n));
+         states = types + n;
+         k = 0;
+         iMol = 0;
+         system().begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            if (speciesPtr->isMutable()) {
+               states[iMol] = speciesPtr->mutator().moleculeStateId(*molIter);
+            }
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               for (j = 0; j < Dimension; ++j) {
+                  positions[3*k + j] = atomIter->position()[j];
+               }
+               if (velocities) {
+                  for (j = 0; j < Dimension; ++j) {
+                     velocities[3*k + j] = atomIter->velocity()[j];
+                  }
+               }
+               types[k] = atomIter->typeId();
+               ++k;
+            }
+            ++iMol;
+         }
+         out.write(&buffer_[0], nByte);
+      }
+      out.flush();
+   }
+
+}
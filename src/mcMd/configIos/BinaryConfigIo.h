@@ -0,0 +1,84 @@
+#ifndef MCMD_BINARY_CONFIG_IO_H
+#define MCMD_BINARY_CONFIG_IO_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/configIos/ConfigIo.h>
+#include <util/global.h>
+
+#include <iostream>
+#include <vector>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class System;
+
+   /**
+   * ConfigIo for the compact binary configuration file format.
+   *
+   * This format contains the same information as the default McConfigIo
+   * and MdConfigIo text formats, but stores positions, velocities, atom
+   * types and molecule state ids of each species as packed binary arrays,
+   * so that the data for each species is read with a single bulk read
+   * and no parsing. It is intended for large sets of configurations that
+   * are analyzed by the ANALYZE_CONFIGS command, and may also be read by
+   * the mdPp BinaryConfigReader. The layout is described in the
+   * documentation of Simp::BinaryConfig.
+   *
+   * Velocities are always read if present in a file. They are written
+   * only if hasVelocities is true. Tethers, links and atom shifts are
+   * not stored. Atom type ids are stored for use by analysis programs,
+   * but are ignored when reading, since types are set by the species.
+   *
+   * \ingroup McMd_ConfigIo_Module
+   */
+   class BinaryConfigIo : public ConfigIo
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param system parent System
+      * \param hasVelocities write velocities?
+      */
+      BinaryConfigIo(System& system, bool hasVelocities = true);
+
+      /// Destructor.
+      virtual ~BinaryConfigIo();
+
+      /**
+      * Read configuration file.
+      *
+      * \param in input file stream
+      */
+      virtual void read(std::istream& in);
+
+      /**
+      * Write configuration file.
+      *
+      * \param out output file stream
+      */
+      virtual void write(std::ostream& out);
+
+   private:
+
+      /// Buffer for the data block of one species.
+      std::vector<char> buffer_;
+
+      /// Write velocities?
+      bool hasVelocities_;
+
+   };
+
+}
+#endif
@@ -4,7 +4,8 @@ mcMd_configIos_=mcMd/configIos/ConfigIo.cpp \
     mcMd/configIos/McConfigIo.cpp \
     mcMd/configIos/MdConfigIo.cpp \
     mcMd/configIos/DdMdConfigIo.cpp \
-    mcMd/configIos/LammpsConfigIo.cpp 
+    mcMd/configIos/LammpsConfigIo.cpp \
+    mcMd/configIos/BinaryConfigIo.cpp
 
 mcMd_configIos_SRCS=\
      $(addprefix $(SRC_DIR)/, $(mcMd_configIos_))
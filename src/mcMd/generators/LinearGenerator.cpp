@@ -43,6 +43,7 @@ namespace McMd
       while (!success && iAttempt < maxAttempt) {
          boundary().randomPosition(random, atomPtr->position());
          success = attemptPlaceAtom(*atomPtr, diameters, cellList);
+         ++iAttempt;
       }
       if (!success) {
          return false; 
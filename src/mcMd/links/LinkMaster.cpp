@@ -54,14 +54,19 @@ namespace McMd
          UTIL_THROW("Invalid atom1 id");
       }
 
-      // Pop an unused Link off the reservoir
+      // Pop an unused Link off the reservoir, and append its ids
       linkPtr = &reservoir_.pop();
+      int position = linkSet_.size();
       linkSet_.append(*linkPtr);
+      linkIdsPositions_[linkPtr->tag()] = position;
+      linkIds_[position].tag = linkPtr->tag();
+      linkIds_[position].typeId = typeId;
 
       // Initialize the link, and add its address to linkPtrs_[atomId]
       linkPtr->setAtoms(atom0,atom1);
       linkPtr->setTypeId(typeId);
       linkPtr->setIsActive(true);
+      setLinkIds(*linkPtr);
       atomLinkSets_[atom0Id].append(*linkPtr);
       atomLinkSets_[atom1Id].append(*linkPtr);
 
@@ -80,18 +85,21 @@ namespace McMd
       int  atom0Id;
       int  atom1Id;
 
-      if (!link(id).isActive()) {
+      if (!linkPtr->isActive()) {
         UTIL_THROW("Attempt to remove a nonactive link");
       }
       atom0Id = linkPtr->atom0().id();
       atom1Id = linkPtr->atom1().id();
-      // Remove link from atom0 and atom1 link sets
+      // Remove link from atom0 and atom1 link sets. Membership is checked
+      // only in debug builds, since each check is a linear search.
+      #ifdef UTIL_DEBUG
       if (!atomLinkSets_[atom0Id].isElement(*linkPtr)) {
         UTIL_THROW("Link is not in atomLinkSets of atom0");
       }
       if (!atomLinkSets_[atom1Id].isElement(*linkPtr)) {
         UTIL_THROW("Link is not in atomLinkSets of atom1");
       }
+      #endif
       atomLinkSets_[atom0Id].remove(*linkPtr);
       atomLinkSets_[atom1Id].remove(*linkPtr);
 
@@ -100,6 +108,15 @@ namespace McMd
       LinkRemoveEvent event(linkPtr);
       Notifier<LinkRemoveEvent>::notifyObservers(event);
 
+      // Move last element of linkIds_ into the slot of the removed link
+      int position = linkIdsPositions_[linkPtr->tag()];
+      int last = linkSet_.size() - 1;
+      if (position != last) {
+         linkIds_[position] = linkIds_[last];
+         linkIdsPositions_[linkIds_[position].tag] = position;
+      }
+      linkIdsPositions_[linkPtr->tag()] = -1;
+
       // Clear the link: nullify atomPtrs, set typeId = -1, isActive = false
       linkPtr->clear();
 
@@ -135,17 +152,20 @@ namespace McMd
       }
 
       // Remove link from oldAtom0 and oldAtom1 link sets
+      #ifdef UTIL_DEBUG
       if (!atomLinkSets_[oldAtom0Id].isElement(link)) {
         UTIL_THROW("Link is not in atomLinkSets of atom0");
       }
       if (!atomLinkSets_[oldAtom1Id].isElement(link)) {
         UTIL_THROW("Link is not in atomLinkSets of atom1");
       }
+      #endif
       atomLinkSets_[oldAtom0Id].remove(link);
       atomLinkSets_[oldAtom1Id].remove(link);       
 
       // Change the atoms      
       link.setAtoms(atom0,atom1); 
+      setLinkIds(link);
       atomLinkSets_[atom0Id].append(link);
       atomLinkSets_[atom1Id].append(link);
       
@@ -180,9 +200,11 @@ namespace McMd
       }
  
       // Remove link from oldAtom link sets
+      #ifdef UTIL_DEBUG
       if (!atomLinkSets_[oldAtomId].isElement(link)) {
         UTIL_THROW("Link is not in atomLinkSets of atom");
       }     
+      #endif
       atomLinkSets_[oldAtomId].remove(link);       
 
       // Change the atom      
@@ -192,6 +214,7 @@ namespace McMd
       else {
 	link.setAtoms(link.atom0(),atom);
       }
+      setLinkIds(link);
       atomLinkSets_[atomId].append(link);
       
       ReSetAtomEvent event(&link, endId);
@@ -222,10 +245,13 @@ namespace McMd
       links_.allocate(linkCapacity_);
       reservoir_.allocate(linkCapacity_);
       linkSet_.allocate(links_);
+      linkIds_.allocate(linkCapacity_);
+      linkIdsPositions_.allocate(linkCapacity_);
 
       // Set tags for all Links.
       for (int i = 0; i < linkCapacity_; ++i) {
          links_[i].setTag(i);
+         linkIdsPositions_[i] = -1;
       }
 
       // Push all links onto reservoir stack, in reverse order.
@@ -239,6 +265,16 @@ namespace McMd
       atomLinkSets_.allocate(atomCapacity_); 
    }
 
+   /*
+   * Set atom ids of the linkIds_ element of a link.
+   */
+   void LinkMaster::setLinkIds(const Link& link)
+   {
+      LinkIds& ids = linkIds_[linkIdsPositions_[link.tag()]];
+      ids.atom0Id = link.atom0().id();
+      ids.atom1Id = link.atom1().id();
+   }
+
    /*
    * Return true if this LinkMaster is valid, or throw an Exception.
    */
@@ -290,6 +326,23 @@ namespace McMd
                UTIL_THROW("Link is not in atomLinkSets of atom1");
             }
 
+            // that the linkIds_ element of the link agrees with it
+            int position = linkIdsPositions_[linkPtr->tag()];
+            if (position < 0 || position >= linkSet_.size()) {
+               UTIL_THROW("Invalid linkIds position of active link");
+            }
+            const LinkIds& ids = linkIds_[position];
+            if (ids.tag != linkPtr->tag()) {
+               UTIL_THROW("Inconsistent tag in linkIds");
+            }
+            if (ids.atom0Id != atom0Ptr->id() ||
+                ids.atom1Id != atom1Ptr->id()) {
+               UTIL_THROW("Inconsistent atom ids in linkIds");
+            }
+            if (ids.typeId != linkPtr->typeId()) {
+               UTIL_THROW("Inconsistent type id in linkIds");
+            }
+
          }
 
          // Count all active links in links_ array
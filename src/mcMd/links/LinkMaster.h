@@ -56,6 +56,21 @@ namespace McMd
       */
       typedef SSet<Link,400> AtomLinkSet;
 
+      /**
+      * Atom ids and type of an active link, for force and energy loops.
+      */
+      struct LinkIds
+      {
+         /// Id of atom 0.
+         int atom0Id;
+         /// Id of atom 1.
+         int atom1Id;
+         /// Link type index.
+         int typeId;
+         /// Tag of the associated Link.
+         int tag;
+      };
+
       /**
       * Constructor.
       */
@@ -122,6 +137,18 @@ namespace McMd
       * \param id index in the range 0 <= id < nLink.
       */ 
       Link& link(int id) const;
+
+      /**
+      * Return atom ids and type of an active link, by a dense index.
+      *
+      * Elements 0 <= i < nLink() of this dense array describe all active
+      * links, in an order that may differ from that of link(int). When
+      * a link is removed, the last element is moved into its slot. Loops
+      * over this array access atoms by id, without dereferencing Links.
+      *
+      * \param i index in the range 0 <= i < nLink().
+      */
+      const LinkIds& linkIds(int i) const;
           
       /**
       * Modify the atoms attached to a link
@@ -184,6 +211,16 @@ namespace McMd
       */
       ArraySet<Link>   linkSet_;
 
+      /**
+      * Atom ids and types of active links, elements 0,...,nLink()-1.
+      */
+      DArray<LinkIds>  linkIds_;
+
+      /**
+      * Index of each active link in linkIds_, indexed by Link tag.
+      */
+      DArray<int>      linkIdsPositions_;
+
       /**
       * Stack of pointers to inactive Links in the links_ array.
       */
@@ -215,6 +252,11 @@ namespace McMd
       */
       void allocate();
 
+      /**
+      * Set atom ids of the linkIds_ element of a link.
+      */
+      void setLinkIds(const Link& link);
+
    };
 
    // Inline methods
@@ -255,6 +297,12 @@ namespace McMd
    inline Link& LinkMaster::link(int id) const
    {  return linkSet_[id]; }
 
+   /*
+   * Get atom ids and type of an active link, by dense index.
+   */
+   inline const LinkMaster::LinkIds& LinkMaster::linkIds(int i) const
+   {  return linkIds_[i]; }
+
    /*
    * Get number of active Links.
    */ 
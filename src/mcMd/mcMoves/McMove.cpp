@@ -80,6 +80,24 @@ namespace McMd
       return false; 
    }
 
+   /*
+   * Default implementation - energy changes are not reported.
+   */
+   bool McMove::reportsEnergyChange() const
+   {  return false; }
+
+   /*
+   * Default implementation - atom moves are not reported.
+   */
+   bool McMove::reportsAtomMoves() const
+   {  return false; }
+
+   /*
+   * Default implementation - Coulomb energies are not included.
+   */
+   bool McMove::includesCoulomb() const
+   {  return false; }
+
    /*
    * Trivial default implementation - do nothing
    */
@@ -101,6 +101,40 @@ namespace McMd
       */
       virtual bool move();
 
+      /**
+      * Does move() report the energy change of every accepted move?
+      *
+      * A subclass that returns true must call the method
+      * McSystem::incrementTrackedEnergy() with the change in total 
+      * potential energy whenever a move is accepted. The running 
+      * total of the energy is otherwise discarded after each accepted 
+      * move. Default implementation returns false.
+      */
+      virtual bool reportsEnergyChange() const;
+
+      /**
+      * Does move() report every atom moved by an accepted move?
+      *
+      * A subclass that returns true must notify the signal
+      * McSystem::atomMoveSignal() once for each atom whose position
+      * is changed by an accepted move, after the new position is set.
+      * McSimulation otherwise notifies McSystem::untrackedMoveSignal()
+      * after each accepted move. Default implementation returns false.
+      */
+      virtual bool reportsAtomMoves() const;
+
+      /**
+      * Does move() include Coulomb energies in its acceptance criterion?
+      *
+      * A subclass that returns true must include real space and k-space
+      * Coulomb energies, as computed by McSystem::atomPotentialEnergy()
+      * or McCoulombPotential trial moves, and must leave no pending trial
+      * move in the McCoulombPotential. McMoveManager::setup() throws an
+      * Exception if a system with a Coulomb potential has any move for
+      * which this returns false. Default implementation returns false.
+      */
+      virtual bool includesCoulomb() const;
+
       // Accessor Functions
 
       /**
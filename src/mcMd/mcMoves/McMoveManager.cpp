@@ -9,6 +9,7 @@
 #include <mcMd/mcMoves/McMoveManager.h>
 #include <mcMd/mcMoves/McMoveFactory.h>
 #include <mcMd/mcSimulation/McSimulation.h>
+#include <mcMd/mcSimulation/McSystem.h>
 
 #include <util/random/Random.h>
 
@@ -81,6 +82,17 @@ namespace McMd
    */
    void McMoveManager::setup()
    {
+      #ifdef SIMP_COULOMB
+      if (systemPtr_->hasCoulombPotential()) {
+         for (int iMove = 0; iMove < size(); ++iMove) {
+            if (!(*this)[iMove].includesCoulomb()) {
+               Log::file() << "McMove: " << (*this)[iMove].className()
+                           << std::endl;
+               UTIL_THROW("McMove does not include Coulomb energies");
+            }
+         }
+      }
+      #endif
       for (int iMove = 0; iMove < size(); ++iMove) {
          (*this)[iMove].setup();
       }
@@ -8,6 +8,7 @@
 #include "CfbEndBase.h"
 #include <mcMd/mcSimulation/McSystem.h>
 #include <mcMd/mcSimulation/mc_potentials.h>
+#include <mcMd/simulation/Simulation.h>
 
 #include <util/boundary/Boundary.h>
 #include <mcMd/chemistry/getAtomGroups.h>
@@ -76,6 +77,22 @@ namespace McMd
       energy = 0.0;
       #endif
 
+      #ifdef SIMP_COULOMB
+      // Remove the end charge from the trial state, and add its Coulomb
+      // energy with all charges that remain.
+      McCoulombPotential* coulombPtr = 0;
+      double charge = 0.0;
+      if (system().hasCoulombPotential()) {
+         coulombPtr = &system().coulombPotential();
+         charge = simulation().atomType(endPtr->typeId()).charge();
+         coulombPtr->removeTrialCharge(charge, endPtr->position());
+         energy += system().atomRSpaceCoulombEnergy(*endPtr,
+                                                    endPtr->position());
+         energy += coulombPtr->trialInsertionEnergy(charge,
+                                                    endPtr->position());
+      }
+      #endif
+
       #ifdef SIMP_ANGLE
       AtomAngleArray angles;
       const Angle *anglePtr;
@@ -114,7 +131,7 @@ namespace McMd
 
       #ifdef SIMP_EXTERNAL
       if (system().hasExternalPotential()) {
-         energy += system().externalPotential().atomEnergy(*endPtr);
+         energy += system().atomExternalEnergy(*endPtr);
       }
       #endif
 
@@ -139,6 +156,15 @@ namespace McMd
          trialEnergy = 0.0;
          #endif
 
+         #ifdef SIMP_COULOMB
+         if (coulombPtr) {
+            trialEnergy += system().atomRSpaceCoulombEnergy(*endPtr,
+                                                       endPtr->position());
+            trialEnergy += coulombPtr->trialInsertionEnergy(charge,
+                                                       endPtr->position());
+         }
+         #endif
+
          #ifdef SIMP_ANGLE
          if (system().hasAnglePotential()) {
 
@@ -209,20 +235,59 @@ namespace McMd
       length = 
          system().bondPotential().randomBondLength(&random(), beta, bondType);
    
-      // Loop over nTrial trial positions:
-      rosenbluth = 0.0;
+      // Generate nTrial trial positions
       for (iTrial=0; iTrial < nTrial_; ++iTrial) {
          random().unitVector(bondVec);
          bondVec *= length;
          // trialPos = pvtPos + bondVec
          trialPos[iTrial].add(pvtPos, bondVec); 
          boundary().shift(trialPos[iTrial]);
-         endPtr->position() = trialPos[iTrial];
-         #ifndef SIMP_NOPAIR
-         trialEnergy[iTrial] = system().pairPotential().atomEnergy(*endPtr);
-         #else
+      }
+
+      // Compute pair energies of all trials in one call
+      #ifndef SIMP_NOPAIR
+      system().pairPotential().
+               trialEnergies(*endPtr, trialPos, nTrial_, trialEnergy);
+      #else
+      for (iTrial=0; iTrial < nTrial_; ++iTrial) {
          trialEnergy[iTrial] = 0.0;
-         #endif
+      }
+      #endif
+
+      // Add external energies of all trials, computed in one call
+      #ifdef SIMP_EXTERNAL
+      double externalEnergy[MaxTrial_];
+      bool hasExternal = system().hasExternalPotential();
+      if (hasExternal) {
+         system().externalPotential().
+                  trialEnergies(endPtr->typeId(), trialPos, nTrial_,
+                                externalEnergy);
+         for (iTrial=0; iTrial < nTrial_; ++iTrial) {
+            trialEnergy[iTrial] += externalEnergy[iTrial];
+         }
+      }
+      #endif
+
+      // Add Coulomb energies of all trials, relative to the trial state
+      #ifdef SIMP_COULOMB
+      McCoulombPotential* coulombPtr = 0;
+      double charge = 0.0;
+      if (system().hasCoulombPotential()) {
+         coulombPtr = &system().coulombPotential();
+         charge = simulation().atomType(endPtr->typeId()).charge();
+         for (iTrial=0; iTrial < nTrial_; ++iTrial) {
+            trialEnergy[iTrial] +=
+               system().atomRSpaceCoulombEnergy(*endPtr, trialPos[iTrial]);
+            trialEnergy[iTrial] +=
+               coulombPtr->trialInsertionEnergy(charge, trialPos[iTrial]);
+         }
+      }
+      #endif
+
+      // Loop over nTrial trial positions:
+      rosenbluth = 0.0;
+      for (iTrial=0; iTrial < nTrial_; ++iTrial) {
+         endPtr->position() = trialPos[iTrial];
 
          #ifdef SIMP_ANGLE
          if (system().hasAnglePotential()) {
@@ -252,13 +317,6 @@ namespace McMd
          }
          #endif
 
-         #ifdef SIMP_EXTERNAL
-         if (system().hasExternalPotential()) {
-            trialEnergy[iTrial] += 
-                system().externalPotential().atomEnergy(*endPtr);
-         }
-         #endif
-
          trialProb[iTrial] = boltzmann(trialEnergy[iTrial]);
          rosenbluth += trialProb[iTrial];
       }
@@ -277,6 +335,17 @@ namespace McMd
    
       // Set position of new end atom to chosen value
       endPtr->position() = trialPos[iTrial];
+      #ifdef SIMP_EXTERNAL
+      if (hasExternal) {
+         system().storeExternalEnergy(*endPtr, trialPos[iTrial],
+                                      externalEnergy[iTrial]);
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (coulombPtr) {
+         coulombPtr->insertTrialCharge(charge, trialPos[iTrial]);
+      }
+      #endif
 
    }
 
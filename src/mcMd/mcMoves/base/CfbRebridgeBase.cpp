@@ -194,7 +194,7 @@ namespace McMd
 
       #ifdef SIMP_EXTERNAL
       if (system().hasExternalPotential()) {
-         trialEnergy += system().externalPotential().atomEnergy(*partPtr);
+         trialEnergy += system().atomExternalEnergy(*partPtr);
       }
       #endif
 
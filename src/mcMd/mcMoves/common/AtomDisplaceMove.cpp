@@ -66,7 +66,7 @@ namespace McMd
    */
    bool AtomDisplaceMove::move() 
    { 
-      Vector    oldPos;
+      Vector    newPos;
       double    newEnergy, oldEnergy;
       Molecule* molPtr;
       Atom*     atomPtr;
@@ -79,29 +79,50 @@ namespace McMd
       iAtom   = random().uniformInt(0, molPtr->nAtom());
       atomPtr = &molPtr->atom(iAtom);
 
-      // Calculate current pair energy and store old position
-      oldPos    = atomPtr->position();
+      // Calculate current energy, and energy at a trial position
       oldEnergy = system().atomPotentialEnergy(*atomPtr);
-
+      newPos = atomPtr->position();
       for (int j = 0; j < Dimension; ++j) {
-         atomPtr->position()[j] += random().uniform(-delta_, delta_);
+         newPos[j] += random().uniform(-delta_, delta_);
       }
-      boundary().shift(atomPtr->position());
-      newEnergy = system().atomPotentialEnergy(*atomPtr);
+      boundary().shift(newPos);
+      newEnergy = system().atomPotentialEnergy(*atomPtr, newPos);
 
       // Decide whether to accept forward move
       bool accept = random().metropolis(boltzmann(newEnergy - oldEnergy));
 
+      // Commit the trial position only if accepted
       if (accept) {
+         Vector oldPos = atomPtr->position();
          #ifndef SIMP_NOPAIR
-         system().pairPotential().updateAtomCell(*atomPtr);
+         system().pairPotential().moveAtom(*atomPtr, newPos);
+         #else
+         atomPtr->position() = newPos;
          #endif
+         system().atomMoveSignal().notify(*atomPtr, oldPos);
+         system().incrementTrackedEnergy(newEnergy - oldEnergy);
          incrementNAccept();
-      } else {
-         atomPtr->position() = oldPos;
       }
 
       return accept;
    }
 
-}      
+   /*
+   * Accepted energy changes are reported to the McSystem.
+   */
+   bool AtomDisplaceMove::reportsEnergyChange() const
+   {  return true; }
+
+   /*
+   * Moved atoms are reported to observers of McSystem::atomMoveSignal().
+   */
+   bool AtomDisplaceMove::reportsAtomMoves() const
+   {  return true; }
+
+   /*
+   * Coulomb energies are included in the acceptance criterion.
+   */
+   bool AtomDisplaceMove::includesCoulomb() const
+   {  return true; }
+
+}
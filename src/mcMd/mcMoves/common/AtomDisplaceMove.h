@@ -59,6 +59,21 @@ namespace McMd
       */
       virtual bool move();
 
+      /**
+      * Return true: accepted energy changes are reported to McSystem.
+      */
+      virtual bool reportsEnergyChange() const;
+
+      /**
+      * Return true: moved atoms are reported by McSystem::atomMoveSignal().
+      */
+      virtual bool reportsAtomMoves() const;
+
+      /**
+      * Return true: Coulomb energies are included.
+      */
+      virtual bool includesCoulomb() const;
+
    private:
 
       /// Maximum magnitude of displacement.
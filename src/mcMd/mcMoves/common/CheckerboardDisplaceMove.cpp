@@ -0,0 +1,340 @@
+#ifndef SIMP_NOPAIR
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CheckerboardDisplaceMove.h"
+#include <mcMd/mcSimulation/McSystem.h>
+#include <mcMd/potentials/pair/McPairPotential.h>
+#include <mcMd/neighbor/CellList.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <simp/species/Species.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor
+   */
+   CheckerboardDisplaceMove::CheckerboardDisplaceMove(McSystem& system)
+    : SystemMove(system),
+      blockAtoms_(),
+      blockMoves_(),
+      blockCells_(),
+      blockAttempts_(),
+      blockAccepts_(),
+      blockEnergies_(),
+      nBlocks_(0),
+      nCells_(0),
+      offsets_(0),
+      counterRandom_(),
+      delta_(0.0),
+      speciesId_(-1),
+      nBlockAttempt_(0)
+   { setClassName("CheckerboardDisplaceMove"); }
+
+   /*
+   * Read speciesId, delta and nAttempt.
+   */
+   void CheckerboardDisplaceMove::readParameters(std::istream& in)
+   {
+      readProbability(in);
+      read<int>(in, "speciesId", speciesId_);
+      read<double>(in, "delta", delta_);
+      read<int>(in, "nAttempt", nBlockAttempt_);
+      if (nBlockAttempt_ <= 0) {
+         UTIL_THROW("nAttempt must be positive");
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void CheckerboardDisplaceMove::loadParameters(Serializable::IArchive &ar)
+   {
+      McMove::loadParameters(ar);
+      loadParameter<int>(ar, "speciesId", speciesId_);
+      loadParameter<double>(ar, "delta", delta_);
+      loadParameter<int>(ar, "nAttempt", nBlockAttempt_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void CheckerboardDisplaceMove::save(Serializable::OArchive &ar)
+   {
+      McMove::save(ar);
+      ar << speciesId_;
+      ar << delta_;
+      ar << nBlockAttempt_;
+   }
+
+   /*
+   * Compute block grid dimensions, allocate per-block arrays.
+   */
+   void CheckerboardDisplaceMove::setupBlocks()
+   {
+      const CellList& cellList = system().pairPotential().cellList();
+      int nColorBlock = 1;
+      for (int i = 0; i < Dimension; ++i) {
+         nCells_[i] = cellList.gridDimension(i);
+         if (nCells_[i] < 4) {
+            UTIL_THROW("CheckerboardDisplaceMove requires >= 4 cells per axis");
+         }
+         nBlocks_[i] = 2*(nCells_[i]/4);
+         nColorBlock *= nBlocks_[i]/2;
+      }
+
+      if (blockAtoms_.capacity() != nColorBlock) {
+         if (blockAtoms_.isAllocated()) {
+            blockAtoms_.deallocate();
+            blockMoves_.deallocate();
+            blockCells_.deallocate();
+            blockAttempts_.deallocate();
+            blockAccepts_.deallocate();
+            blockEnergies_.deallocate();
+         }
+         blockAtoms_.allocate(nColorBlock);
+         blockMoves_.allocate(nColorBlock);
+         blockCells_.allocate(nColorBlock);
+         blockAttempts_.allocate(nColorBlock);
+         blockAccepts_.allocate(nColorBlock);
+         blockEnergies_.allocate(nColorBlock);
+      }
+   }
+
+   /*
+   * Return block coordinate of a cell coordinate along one axis.
+   */
+   inline int CheckerboardDisplaceMove::blockCoord(int axis, int c) const
+   {
+      int u = c - offsets_[axis];
+      if (u < 0) u += nCells_[axis];
+      return (u*nBlocks_[axis])/nCells_[axis];
+   }
+
+   /*
+   * Attempt nBlockAttempt_ displacements within one block.
+   */
+   void
+   CheckerboardDisplaceMove::sampleBlock(const IntVector& blockCoords, int k,
+                                         int color)
+   {
+      McPairPotential& pairPotential = system().pairPotential();
+      const CellList& cellList = pairPotential.cellList();
+      GArray<Atom*>& atoms = blockAtoms_[k];
+      GArray<Atom*>& moves = blockMoves_[k];
+      GArray<int>& oldCells = blockCells_[k];
+      const Cell* cellPtr;
+      Atom* atomPtr;
+      IntVector begin, end, coords, cellCoords;
+      Vector oldPos, newPos;
+      double u[4];
+      double oldEnergy, newEnergy, p;
+      int i, j, ic, nAtom;
+      bool inBlock;
+
+      // Range of shifted cell coordinates u within this block
+      for (i = 0; i < Dimension; ++i) {
+         begin[i] = (blockCoords[i]*nCells_[i] + nBlocks_[i] - 1)/nBlocks_[i];
+         end[i] = ((blockCoords[i] + 1)*nCells_[i] + nBlocks_[i] - 1)
+                  /nBlocks_[i];
+      }
+
+      // Collect atoms of species speciesId_ in cells of this block
+      atoms.clear();
+      for (coords[0] = begin[0]; coords[0] < end[0]; ++coords[0]) {
+         cellCoords[0] = (coords[0] + offsets_[0]) % nCells_[0];
+         for (coords[1] = begin[1]; coords[1] < end[1]; ++coords[1]) {
+            cellCoords[1] = (coords[1] + offsets_[1]) % nCells_[1];
+            for (coords[2] = begin[2]; coords[2] < end[2]; ++coords[2]) {
+               cellCoords[2] = (coords[2] + offsets_[2]) % nCells_[2];
+               cellPtr = &cellList.cell(cellList.cellIndex(cellCoords));
+               for (j = 0; j < cellPtr->firstClearPos(); ++j) {
+                  atomPtr = cellPtr->atomPtr(j);
+                  if (atomPtr) {
+                     if (atomPtr->molecule().species().id() == speciesId_) {
+                        atoms.append(atomPtr);
+                     }
+                  }
+               }
+            }
+         }
+      }
+
+      moves.clear();
+      oldCells.clear();
+      blockAttempts_[k] = nBlockAttempt_;
+      blockAccepts_[k] = 0;
+      blockEnergies_[k] = 0.0;
+      nAtom = atoms.size();
+      if (nAtom == 0) return;
+
+      // Counter words: block, color, attempt, and draw within attempt
+      const uint32_t c0 = k;
+      const uint32_t c1 = color;
+      for (int iAttempt = 0; iAttempt < nBlockAttempt_; ++iAttempt) {
+         counterRandom_.uniform(c0, c1, iAttempt, 0, u);
+         i = int(u[0]*nAtom);
+         if (i >= nAtom) i = nAtom - 1;
+         atomPtr = atoms[i];
+         newPos = atomPtr->position();
+         for (j = 0; j < Dimension; ++j) {
+            newPos[j] += (2.0*u[j + 1] - 1.0)*delta_;
+         }
+         boundary().shift(newPos);
+
+         // Reject any displacement out of this block
+         ic = cellList.cellIndexFromPosition(newPos);
+         cellList.getCellCoordinates(ic, cellCoords);
+         inBlock = true;
+         for (j = 0; j < Dimension; ++j) {
+            if (blockCoord(j, cellCoords[j]) != blockCoords[j]) {
+               inBlock = false;
+            }
+         }
+         if (!inBlock) continue;
+
+         oldPos = atomPtr->position();
+         oldEnergy = system().atomPotentialEnergy(*atomPtr);
+         atomPtr->position() = newPos;
+         newEnergy = system().atomPotentialEnergy(*atomPtr);
+
+         p = boltzmann(newEnergy - oldEnergy);
+         if (p < 1.0) {
+            counterRandom_.uniform(c0, c1, iAttempt, 1, u);
+         }
+         if (p >= 1.0 || u[0] < p) {
+            ++blockAccepts_[k];
+            blockEnergies_[k] += newEnergy - oldEnergy;
+            moves.append(atomPtr);
+            oldCells.append(cellList.cellIndexFromPosition(oldPos));
+            if (!pairPotential.updateAtomCellLocal(*atomPtr)) {
+               // New cell is full: stop, since atomPtr is in the wrong
+               // cell until move() completes the update.
+               blockAttempts_[k] = iAttempt + 1;
+               return;
+            }
+         } else {
+            atomPtr->position() = oldPos;
+         }
+      }
+   }
+
+   /*
+   * Perform one checkerboard sweep.
+   */
+   bool CheckerboardDisplaceMove::move()
+   {
+      const CellList& cellList = system().pairPotential().cellList();
+      int i, k, color, nColorBlock;
+
+      // Recompute block grid if the cell grid has changed
+      bool isChanged = !blockAtoms_.isAllocated();
+      for (i = 0; i < Dimension; ++i) {
+         if (cellList.gridDimension(i) != nCells_[i]) {
+            isChanged = true;
+         }
+      }
+      if (isChanged) {
+         setupBlocks();
+      }
+      if (system().pairPotential().hasMultiCellList()) {
+         UTIL_THROW("CheckerboardDisplaceMove requires a single cell list");
+      }
+      nColorBlock = blockAtoms_.capacity();
+
+      // Key the counter-based generator for this sweep
+      counterRandom_.setSeed(random().uniformInt(1, 2147483647));
+
+      // Choose a random offset of the block grid
+      for (i = 0; i < Dimension; ++i) {
+         offsets_[i] = random().uniformInt(0, nCells_[i]);
+      }
+
+      // Choose a random order of colors
+      const int nColor = 1 << Dimension;
+      int colors[1 << Dimension];
+      for (color = 0; color < nColor; ++color) {
+         colors[color] = color;
+      }
+      for (color = nColor - 1; color > 0; --color) {
+         k = random().uniformInt(0, color + 1);
+         i = colors[k];
+         colors[k] = colors[color];
+         colors[color] = i;
+      }
+
+      // Verlet lists cannot be updated by several threads, so they are
+      // not used during the sweep, and are rebuilt after it.
+      McPairPotential& pairPotential = system().pairPotential();
+      if (pairPotential.hasVerletList()) {
+         pairPotential.invalidateVerletLists();
+      }
+
+      long nAttempt = 0;
+      long nAccept = 0;
+      double dE = 0.0;
+      for (int iColor = 0; iColor < nColor; ++iColor) {
+         color = colors[iColor];
+
+         #ifdef MCMD_OPENMP
+         #pragma omp parallel for schedule(dynamic)
+         #endif
+         for (k = 0; k < nColorBlock; ++k) {
+            IntVector blockCoords;
+            int j, rest = k;
+            for (j = Dimension - 1; j >= 0; --j) {
+               blockCoords[j] = 2*(rest % (nBlocks_[j]/2)) + ((color >> j) & 1);
+               rest = rest/(nBlocks_[j]/2);
+            }
+            sampleBlock(blockCoords, k, color);
+         }
+
+         // Complete cell list updates of accepted moves, in one thread
+         for (k = 0; k < nColorBlock; ++k) {
+            const GArray<Atom*>& moves = blockMoves_[k];
+            const GArray<int>& oldCells = blockCells_[k];
+            for (i = 0; i < moves.size(); ++i) {
+               pairPotential.completeAtomCell(*moves[i], oldCells[i]);
+            }
+            nAttempt += blockAttempts_[k];
+            nAccept += blockAccepts_[k];
+            dE += blockEnergies_[k];
+         }
+      }
+
+      if (pairPotential.hasVerletList()) {
+         pairPotential.buildCellList();
+      }
+      system().incrementTrackedEnergy(dE);
+
+      // Update move statistics
+      for (long n = 0; n < nAttempt; ++n) {
+         incrementNAttempt();
+      }
+      for (long n = 0; n < nAccept; ++n) {
+         incrementNAccept();
+      }
+
+      return (nAccept > 0);
+   }
+
+   /*
+   * Accepted energy changes are reported to the McSystem.
+   */
+   bool CheckerboardDisplaceMove::reportsEnergyChange() const
+   {  return true; }
+
+}
+#endif
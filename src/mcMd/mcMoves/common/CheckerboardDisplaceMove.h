@@ -0,0 +1,176 @@
+#ifndef SIMP_NOPAIR
+#ifndef MCMD_CHECKERBOARD_DISPLACE_MOVE_H
+#define MCMD_CHECKERBOARD_DISPLACE_MOVE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/mcMoves/SystemMove.h>        // base class
+#include <util/containers/DArray.h>         // member template
+#include <util/containers/GArray.h>         // member template argument
+#include <util/space/IntVector.h>           // member
+#include <simp/random/CounterRandom.h>      // member
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class McSystem;
+   class Atom;
+
+   /**
+   * Sweep of single atom displacements on a checkerboard of blocks.
+   *
+   * Each call to move() performs one sweep, in which many random atomic
+   * displacements are attempted within spatially separated blocks of
+   * cells that can be sampled concurrently. The cells of the pair
+   * potential CellList are grouped along each axis into an even number
+   * of blocks, each at least 2 cells wide, and blocks are assigned one
+   * of 2^Dimension colors by the parities of their block coordinates.
+   * During a sweep, the colors are visited in a random order. For each
+   * color, nAttempt random displacements of atoms of one species are
+   * attempted in every block of that color. A displacement that would
+   * take an atom out of its block is rejected.
+   *
+   * Because blocks of the same color are separated by at least 2 cells,
+   * no atom or cell that is read while sampling one block is modified
+   * while sampling another. While a block is sampled, an accepted atom
+   * is moved only between the cells of that block. Updates of the list
+   * of non-empty cells and of the bridge cell list, which are shared by
+   * all blocks, are buffered per block and applied by one thread after
+   * all blocks of a color are done. If the new cell of an atom is full,
+   * its move is also completed then, and sampling of its block ends for
+   * that color. If the program is compiled with MCMD_OPENMP
+   * defined, the blocks of each color are thus sampled by concurrent
+   * threads. Otherwise, they are sampled in sequence. Random numbers
+   * are drawn from a counter-based generator (Simp::CounterRandom) that
+   * is keyed once per sweep from the main generator, with a counter
+   * given by the color, block index and attempt index. Blocks thus
+   * share no generator state and need no per-block seeding, and results
+   * do not depend on the number of threads. The block grid is displaced
+   * by a random number of cells along each axis at the beginning of each
+   * sweep, so that atoms may cross any cell boundary.
+   *
+   * The pair potential cell list must have at least 4 cells along each
+   * axis, and the range of all bonded interactions must be less than
+   * the width of one cell. Multi-level cell lists are not supported.
+   *
+   * \sa \ref mcMd_mcMove_CheckerboardDisplaceMove_page "parameter file format"
+   *
+   * \ingroup McMd_McMove_Module McMove_Module
+   */
+   class CheckerboardDisplaceMove : public SystemMove
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      CheckerboardDisplaceMove(McSystem& system);
+
+      /**
+      * Read species, maximum displacement and attempts per block.
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Perform one checkerboard sweep of displacement attempts.
+      *
+      * \return true if any attempted displacement was accepted
+      */
+      virtual bool move();
+
+      /**
+      * Return true: accepted energy changes are reported to McSystem.
+      */
+      virtual bool reportsEnergyChange() const;
+
+   private:
+
+      /// Atoms of species speciesId_ in each active block.
+      DArray< GArray<Atom*> > blockAtoms_;
+
+      /// Accepted atoms in each active block, to complete cell updates.
+      DArray< GArray<Atom*> > blockMoves_;
+
+      /// Old cell of each element of blockMoves_.
+      DArray< GArray<int> > blockCells_;
+
+      /// Number of attempted displacements in each active block.
+      DArray<long> blockAttempts_;
+
+      /// Number of accepted displacements in each active block.
+      DArray<long> blockAccepts_;
+
+      /// Sum of energy changes of accepted displacements in each block.
+      DArray<double> blockEnergies_;
+
+      /// Number of blocks along each axis.
+      IntVector nBlocks_;
+
+      /// Number of cells along each axis, when nBlocks_ was computed.
+      IntVector nCells_;
+
+      /// Cell coordinate offset of the block grid in current sweep.
+      IntVector offsets_;
+
+      /// Counter-based generator, keyed once per sweep.
+      Simp::CounterRandom counterRandom_;
+
+      /// Maximum magnitude of displacement.
+      double delta_;
+
+      /// Integer Id of Species.
+      int    speciesId_;
+
+      /// Number of attempted displacements per block per color.
+      int    nBlockAttempt_;
+
+      /**
+      * Compute block grid dimensions, allocate per-block arrays.
+      */
+      void setupBlocks();
+
+      /**
+      * Return block coordinate of a cell coordinate along one axis.
+      *
+      * \param axis  index of axis
+      * \param c     cell coordinate along axis
+      */
+      int blockCoord(int axis, int c) const;
+
+      /**
+      * Attempt nBlockAttempt_ displacements within one block.
+      *
+      * \param blockCoords  block coordinates of the block
+      * \param k            index of block among blocks of one color
+      * \param color        color of the block
+      */
+      void sampleBlock(const IntVector& blockCoords, int k, int color);
+
+   };
+
+}
+#endif
+#endif
@@ -0,0 +1,217 @@
+#ifndef SIMP_NOPAIR
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "EventChainMove.h"
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/mcSimulation/McSystem.h>
+#include <mcMd/potentials/pair/McPairPotential.h>
+#include <mcMd/neighbor/CellList.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <simp/species/Species.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace McMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /*
+   * Constructor
+   */
+   EventChainMove::EventChainMove(McSystem& system)
+    : SystemMove(system),
+      visits_(),
+      chainLength_(0.0),
+      stamp_(0),
+      speciesId_(-1)
+   {  setClassName("EventChainMove"); }
+
+   /*
+   * Read speciesId and chainLength.
+   */
+   void EventChainMove::readParameters(std::istream& in)
+   {
+      readProbability(in);
+      read<int>(in, "speciesId", speciesId_);
+      read<double>(in, "chainLength", chainLength_);
+      if (chainLength_ <= 0.0) {
+         UTIL_THROW("chainLength must be positive");
+      }
+      allocate();
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void EventChainMove::loadParameters(Serializable::IArchive &ar)
+   {
+      McMove::loadParameters(ar);
+      loadParameter<int>(ar, "speciesId", speciesId_);
+      loadParameter<double>(ar, "chainLength", chainLength_);
+      allocate();
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void EventChainMove::save(Serializable::OArchive &ar)
+   {
+      McMove::save(ar);
+      ar << speciesId_;
+      ar << chainLength_;
+   }
+
+   /*
+   * Check that every species is monatomic, allocate visits_.
+   */
+   void EventChainMove::allocate()
+   {
+      for (int i = 0; i < simulation().nSpecies(); ++i) {
+         if (simulation().species(i).nAtom() != 1) {
+            UTIL_THROW("EventChainMove requires molecules of one atom");
+         }
+      }
+      #ifdef SIMP_EXTERNAL
+      if (system().hasExternalPotential()) {
+         UTIL_THROW("EventChainMove does not allow an external potential");
+      }
+      #endif
+      visits_.allocate(simulation().atomCapacity());
+      for (int i = 0; i < visits_.capacity(); ++i) {
+         visits_[i] = 0;
+      }
+      stamp_ = 0;
+   }
+
+   /*
+   * Return displacement of active atom at which a pair event occurs.
+   */
+   double EventChainMove::eventDisplacement(const Atom& active,
+                                            const Atom& other, int axis,
+                                            double maxStep, double dE)
+   {
+      const McPairPotential& pairPotential = system().pairPotential();
+      Vector dr;
+      double rsq, bsq, d, sEnd, rsqEnd, target, lo, hi, mid;
+      int iType, jType;
+
+      // dr = separation of other atom from active atom, d = projection
+      rsq = boundary().distanceSq(other.position(), active.position(), dr);
+      d = dr[axis];
+
+      // Pair energy cannot increase while the atoms separate
+      if (d <= 0.0) return maxStep;
+
+      // Squared separation at closest approach within this step
+      bsq = rsq - d*d;
+      sEnd = (d < maxStep) ? d : maxStep;
+      rsqEnd = bsq + (d - sEnd)*(d - sEnd);
+
+      iType = active.typeId();
+      jType = other.typeId();
+      target = pairPotential.energy(rsq, iType, jType) + dE;
+      if (pairPotential.energy(rsqEnd, iType, jType) < target) {
+         return maxStep;
+      }
+
+      // Bisect for the largest squared separation with energy >= target
+      lo = rsqEnd;
+      hi = rsq;
+      for (int k = 0; k < 60; ++k) {
+         mid = 0.5*(lo + hi);
+         if (pairPotential.energy(mid, iType, jType) >= target) {
+            lo = mid;
+         } else {
+            hi = mid;
+         }
+      }
+      return d - sqrt(lo - bsq);
+   }
+
+   /*
+   * Perform one event chain.
+   */
+   bool EventChainMove::move()
+   {
+      McPairPotential& pairPotential = system().pairPotential();
+      const CellList& cellList = pairPotential.cellList();
+      CellList::NeighborArray neighbors;
+      Vector endPos;
+      Atom*  activePtr;
+      Atom*  nextPtr;
+      Atom*  otherPtr;
+      double remaining, maxStep, step, s, dE;
+      double beta = energyEnsemble().beta();
+      int    axis, i, j, nNeighbor;
+
+      incrementNAttempt();
+
+      // Choose initial atom and axis of displacement
+      activePtr = &(system().randomMolecule(speciesId_).atom(0));
+      axis = random().uniformInt(0, Dimension);
+
+      // Steps no longer than the cutoff need only neighbors of the cells
+      // that contain the beginning and end of the step.
+      maxStep = pairPotential.maxPairCutoff();
+      remaining = chainLength_;
+      while (remaining > 0.0) {
+         step = (remaining < maxStep) ? remaining : maxStep;
+         endPos = activePtr->position();
+         endPos[axis] += step;
+         boundary().shift(endPos);
+
+         ++stamp_;
+         visits_[activePtr->id()] = stamp_;
+         nextPtr = 0;
+         for (i = 0; i < 2; ++i) {
+            if (i == 0) {
+               cellList.getNeighbors(activePtr->position(), neighbors);
+            } else {
+               cellList.getNeighbors(endPos, neighbors);
+            }
+            nNeighbor = neighbors.size();
+            for (j = 0; j < nNeighbor; ++j) {
+               otherPtr = neighbors[j];
+               if (visits_[otherPtr->id()] != stamp_) {
+                  visits_[otherPtr->id()] = stamp_;
+                  dE = -log(1.0 - random().uniform())/beta;
+                  s = eventDisplacement(*activePtr, *otherPtr, axis,
+                                        step, dE);
+                  if (s < step) {
+                     step = s;
+                     nextPtr = otherPtr;
+                  }
+               }
+            }
+         }
+
+         // Displace active atom to the first event, or end of step
+         activePtr->position()[axis] += step;
+         boundary().shift(activePtr->position());
+         pairPotential.updateAtomCell(*activePtr);
+         remaining -= step;
+
+         // Lift: the atom that caused the event becomes active
+         if (nextPtr) {
+            activePtr = nextPtr;
+         }
+      }
+
+      incrementNAccept();
+      return true;
+   }
+
+}
+#endif
@@ -0,0 +1,131 @@
+#ifndef SIMP_NOPAIR
+#ifndef MCMD_EVENT_CHAIN_MOVE_H
+#define MCMD_EVENT_CHAIN_MOVE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/mcMoves/SystemMove.h>        // base class
+#include <util/containers/DArray.h>         // member template
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class McSystem;
+   class Atom;
+
+   /**
+   * Event-chain Monte Carlo move for a liquid of repulsive point particles.
+   *
+   * Each move is a rejection-free chain of displacements along a randomly
+   * chosen Cartesian axis, with a total length chainLength. The chain
+   * begins by displacing a randomly chosen atom of species speciesId.
+   * The active atom moves until a pair "event" occurs, at which point
+   * it stops and the other atom of the pair becomes the active atom,
+   * and continues the move for the remaining length of the chain.
+   *
+   * Events are generated by the factorized Metropolis filter: Each pair
+   * that contains the active atom independently triggers an event when
+   * the increase in its pair energy along the path first exceeds a
+   * threshold -kT ln(u), for a uniform random number u in (0,1]. The
+   * path is divided into steps no longer than the maximum pair cutoff,
+   * and new thresholds are drawn for each step. Because energy thresholds
+   * are only tested as atoms approach, the pair potential must be purely
+   * repulsive, i.e., a non-increasing function of separation, as for the
+   * WCA potential (an LJPair with cutoff 2^{1/6} sigma) or the DPD
+   * potential. The position at which the threshold is reached is found
+   * by bisection using the pair energy function.
+   *
+   * Bonded, external and other potentials are not included in the event
+   * rates. Every species must therefore contain molecules of one atom,
+   * and the system may not have an external potential. The boundary must
+   * be orthorhombic.
+   *
+   * \sa \ref mcMd_mcMove_EventChainMove_page "parameter file format"
+   *
+   * \ingroup McMd_McMove_Module McMove_Module
+   */
+   class EventChainMove : public SystemMove
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      EventChainMove(McSystem& system);
+
+      /**
+      * Read species of initial atom and total chain length.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Perform one event chain.
+      *
+      * \return true (event chain moves are always accepted)
+      */
+      virtual bool move();
+
+   private:
+
+      /// Last value of stamp_ for which each atom was visited, by atom id.
+      DArray<long> visits_;
+
+      /// Total displacement of one event chain.
+      double chainLength_;
+
+      /// Counter used to avoid double counting of neighbors.
+      long stamp_;
+
+      /// Integer Id of Species of initial atom.
+      int speciesId_;
+
+      /**
+      * Check that move is applicable to the system, allocate visits_.
+      */
+      void allocate();
+
+      /**
+      * Return displacement of active atom at which a pair event occurs.
+      *
+      * Returns maxStep if no event occurs before the active atom has
+      * been displaced by maxStep along the axis.
+      *
+      * \param active  active (moving) atom
+      * \param other   other atom of the pair
+      * \param axis    index of axis of displacement
+      * \param maxStep maximum displacement
+      * \param dE      energy threshold
+      */
+      double eventDisplacement(const Atom& active, const Atom& other,
+                               int axis, double maxStep, double dE);
+
+   };
+
+}
+#endif
+#endif
@@ -0,0 +1,177 @@
+#ifndef SIMP_NOPAIR
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "GeometricClusterMove.h"
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/mcSimulation/McSystem.h>
+#include <mcMd/potentials/pair/McPairPotential.h>
+#include <mcMd/neighbor/CellList.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <simp/species/Species.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /*
+   * Constructor
+   */
+   GeometricClusterMove::GeometricClusterMove(McSystem& system)
+    : SystemMove(system),
+      oldPositions_(),
+      visits_(),
+      inCluster_(),
+      cluster_(),
+      stamp_(0),
+      speciesId_(-1)
+   {  setClassName("GeometricClusterMove"); }
+
+   /*
+   * Read speciesId.
+   */
+   void GeometricClusterMove::readParameters(std::istream& in)
+   {
+      readProbability(in);
+      read<int>(in, "speciesId", speciesId_);
+      allocate();
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void GeometricClusterMove::loadParameters(Serializable::IArchive &ar)
+   {
+      McMove::loadParameters(ar);
+      loadParameter<int>(ar, "speciesId", speciesId_);
+      allocate();
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void GeometricClusterMove::save(Serializable::OArchive &ar)
+   {
+      McMove::save(ar);
+      ar << speciesId_;
+   }
+
+   /*
+   * Check that every species is monatomic, allocate arrays.
+   */
+   void GeometricClusterMove::allocate()
+   {
+      for (int i = 0; i < simulation().nSpecies(); ++i) {
+         if (simulation().species(i).nAtom() != 1) {
+            UTIL_THROW("GeometricClusterMove requires molecules of one atom");
+         }
+      }
+      #ifdef SIMP_EXTERNAL
+      if (system().hasExternalPotential()) {
+         UTIL_THROW("GeometricClusterMove does not allow external potential");
+      }
+      #endif
+      int atomCapacity = simulation().atomCapacity();
+      oldPositions_.allocate(atomCapacity);
+      visits_.allocate(atomCapacity);
+      inCluster_.allocate(atomCapacity);
+      for (int i = 0; i < atomCapacity; ++i) {
+         visits_[i] = 0;
+         inCluster_[i] = false;
+      }
+      stamp_ = 0;
+   }
+
+   /*
+   * Add an atom to the cluster, and reflect it through the pivot.
+   */
+   void GeometricClusterMove::addAtom(Atom& atom, const Vector& pivot)
+   {
+      Vector& position = atom.position();
+      int id = atom.id();
+      oldPositions_[id] = position;
+      inCluster_[id] = true;
+      cluster_.append(&atom);
+      for (int j = 0; j < Dimension; ++j) {
+         position[j] = 2.0*pivot[j] - position[j];
+      }
+      boundary().shift(position);
+      system().pairPotential().updateAtomCell(atom);
+   }
+
+   /*
+   * Build and reflect one cluster.
+   */
+   bool GeometricClusterMove::move()
+   {
+      McPairPotential& pairPotential = system().pairPotential();
+      const CellList& cellList = pairPotential.cellList();
+      CellList::NeighborArray neighbors;
+      Vector pivot;
+      Atom*  atomPtr;
+      Atom*  otherPtr;
+      double dE;
+      int    k, i, j, nNeighbor, iType, jType;
+
+      incrementNAttempt();
+
+      // Choose pivot and initial atom
+      boundary().randomPosition(random(), pivot);
+      cluster_.clear();
+      addAtom(system().randomMolecule(speciesId_).atom(0), pivot);
+
+      // Test neighbors of each reflected atom, in order of addition
+      for (k = 0; k < cluster_.size(); ++k) {
+         atomPtr = cluster_[k];
+         const Vector& oldPos = oldPositions_[atomPtr->id()];
+         const Vector& newPos = atomPtr->position();
+         iType = atomPtr->typeId();
+         ++stamp_;
+         for (i = 0; i < 2; ++i) {
+            if (i == 0) {
+               cellList.getNeighbors(oldPos, neighbors);
+            } else {
+               cellList.getNeighbors(newPos, neighbors);
+            }
+            nNeighbor = neighbors.size();
+            for (j = 0; j < nNeighbor; ++j) {
+               otherPtr = neighbors[j];
+               if (inCluster_[otherPtr->id()]) continue;
+               if (visits_[otherPtr->id()] == stamp_) continue;
+               visits_[otherPtr->id()] = stamp_;
+
+               jType = otherPtr->typeId();
+               dE  = pairPotential.energy(boundary().
+                     distanceSq(newPos, otherPtr->position()), iType, jType);
+               dE -= pairPotential.energy(boundary().
+                     distanceSq(oldPos, otherPtr->position()), iType, jType);
+               if (dE > 0.0) {
+                  if (random().uniform() < 1.0 - boltzmann(dE)) {
+                     addAtom(*otherPtr, pivot);
+                  }
+               }
+            }
+         }
+      }
+
+      // Clear cluster membership flags
+      for (k = 0; k < cluster_.size(); ++k) {
+         inCluster_[cluster_[k]->id()] = false;
+      }
+
+      incrementNAccept();
+      return true;
+   }
+
+}
+#endif
@@ -0,0 +1,124 @@
+#ifndef SIMP_NOPAIR
+#ifndef MCMD_GEOMETRIC_CLUSTER_MOVE_H
+#define MCMD_GEOMETRIC_CLUSTER_MOVE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/mcMoves/SystemMove.h>        // base class
+#include <util/containers/DArray.h>         // member template
+#include <util/containers/GArray.h>         // member template
+#include <util/space/Vector.h>              // member template argument
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class McSystem;
+   class Atom;
+
+   /**
+   * Geometric cluster move for a liquid of point particles.
+   *
+   * This move implements the rejection-free geometric cluster algorithm
+   * of Liu and Luijten (Phys. Rev. Lett. 92, 035504, 2004). Each move
+   * chooses a random pivot point and a random initial atom of species
+   * speciesId, and builds a cluster of atoms that are reflected through
+   * the pivot (r -> 2 pivot - r). Whenever an atom i is reflected, each
+   * atom j that is not yet in the cluster, and that interacts with atom
+   * i in either its old or new position, is added to the cluster with
+   * probability max[0, 1 - exp(-(U'_ij - U_ij)/kT)], where U_ij and
+   * U'_ij are the pair energies before and after reflection of atom i.
+   * Atoms added to the cluster are reflected in turn, until no more
+   * atoms are added.
+   *
+   * Only pair interactions are included. Every species must therefore
+   * contain molecules of one atom, and the system may not have an
+   * external potential.
+   *
+   * \sa \ref mcMd_mcMove_GeometricClusterMove_page "parameter file format"
+   *
+   * \ingroup McMd_McMove_Module McMove_Module
+   */
+   class GeometricClusterMove : public SystemMove
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      GeometricClusterMove(McSystem& system);
+
+      /**
+      * Read species of initial atom.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Build and reflect one cluster.
+      *
+      * \return true (cluster moves are always accepted)
+      */
+      virtual bool move();
+
+   private:
+
+      /// Positions of atoms before reflection, indexed by atom id.
+      DArray<Vector> oldPositions_;
+
+      /// Last value of stamp_ for which each atom was visited, by atom id.
+      DArray<long> visits_;
+
+      /// Is each atom in the current cluster? Indexed by atom id.
+      DArray<bool> inCluster_;
+
+      /// Atoms in the current cluster, in the order they were added.
+      GArray<Atom*> cluster_;
+
+      /// Counter used to avoid double counting of neighbors.
+      long stamp_;
+
+      /// Integer Id of Species of initial atom.
+      int speciesId_;
+
+      /**
+      * Check that move is applicable to the system, allocate arrays.
+      */
+      void allocate();
+
+      /**
+      * Add an atom to the cluster and reflect it through the pivot.
+      *
+      * \param atom   atom to add
+      * \param pivot  pivot point
+      */
+      void addAtom(Atom& atom, const Vector& pivot);
+
+   };
+
+}
+#endif
+#endif
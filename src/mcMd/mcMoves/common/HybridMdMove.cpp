@@ -27,11 +27,15 @@ namespace McMd
    HybridMdMove::HybridMdMove(McSystem& system) :
       SystemMove(system),
       mdSystemPtr_(0),
-      nStep_(0)
+      nStep_(0),
+      hasPairList_(false),
+      isAccepted_(false)
    {
       setClassName("HybridMdMove");
       mdSystemPtr_ = new MdSystem(system);
       oldPositions_.allocate(simulation().atomCapacity());
+      system.untrackedMoveSignal().
+             addObserver(*this, &HybridMdMove::unsetPairList);
    }
 
    /*
@@ -87,6 +91,7 @@ namespace McMd
       bool   accept;
 
       incrementNAttempt();
+      isAccepted_ = false;
 
       // Store old atom positions in oldPositions_ array.
       for (iSpec = 0; iSpec < nSpec; ++iSpec) {
@@ -98,9 +103,14 @@ namespace McMd
          }
       }
 
-      // Initialize MdSystem
+      // Initialize MdSystem, reusing the pair list of the previous
+      // attempt if no atom has since moved more than half the skin.
       #ifndef SIMP_NOPAIR
-      mdSystemPtr_->pairPotential().buildPairList();
+      MdPairPotential& mdPairPotential = mdSystemPtr_->pairPotential();
+      if (!hasPairList_ || !mdPairPotential.isPairListCurrent()) {
+         mdPairPotential.buildPairList();
+         hasPairList_ = true;
+      }
       #endif
       mdSystemPtr_->calculateForces();
       mdSystemPtr_->setBoltzmannVelocities(energyEnsemble().temperature());
@@ -132,6 +142,7 @@ namespace McMd
 
          // Increment counter for the number of accepted moves.
          incrementNAccept();
+         isAccepted_ = true;
 
       } else {
 
@@ -152,4 +163,19 @@ namespace McMd
 
    }
 
+   /*
+   * Mark the MD pair list as obsolete, unless this move was accepted.
+   *
+   * McSimulation notifies untrackedMoveSignal() after every accepted
+   * move of this class, which does not invalidate its own pair list.
+   */
+   void HybridMdMove::unsetPairList()
+   {
+      if (isAccepted_) {
+         isAccepted_ = false;
+      } else {
+         hasPairList_ = false;
+      }
+   }
+
 }
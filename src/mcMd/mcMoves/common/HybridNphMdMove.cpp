@@ -32,11 +32,15 @@ namespace McMd
       nStep_(0),
       nphIntegratorPtr_(0),
       barostatMass_(0.0),
-      mode_()
+      mode_(),
+      hasPairList_(false),
+      isAccepted_(false)
    {
       setClassName("HybridNphMdMove");
       mdSystemPtr_ = new MdSystem(system);
       oldPositions_.allocate(simulation().atomCapacity());
+      system.untrackedMoveSignal().
+             addObserver(*this, &HybridNphMdMove::unsetPairList);
    }
 
    /*
@@ -107,6 +111,7 @@ namespace McMd
       }
       // Increment counter for attempted moves
       incrementNAttempt();
+      isAccepted_ = false;
       
       // Store old boundary lengths.
       Vector oldLengths = system().boundary().lengths();
@@ -121,9 +126,14 @@ namespace McMd
          }
       }
 
-      // Initialize MdSystem
+      // Initialize MdSystem, reusing the pair list of the previous
+      // attempt if no atom has since moved more than half the skin.
       #ifndef SIMP_NOPAIR
-      mdSystemPtr_->pairPotential().buildPairList();
+      MdPairPotential& mdPairPotential = mdSystemPtr_->pairPotential();
+      if (!hasPairList_ || !mdPairPotential.isPairListCurrent()) {
+         mdPairPotential.buildPairList();
+         hasPairList_ = true;
+      }
       #endif
       mdSystemPtr_->calculateForces();
       mdSystemPtr_->setBoltzmannVelocities(energyEnsemble().temperature());
@@ -189,6 +199,7 @@ namespace McMd
 
          // Increment counter for the number of accepted moves.
          incrementNAccept();
+         isAccepted_ = true;
 
       } else {
          
@@ -208,8 +219,28 @@ namespace McMd
 
       }
 
+      #ifdef SIMP_EXTERNAL
+      // The boundary may have changed, so cached external energies are stale
+      system().clearExternalEnergyCache();
+      #endif
+
       return accept;
 
    }
 
+   /*
+   * Mark the MD pair list as obsolete, unless this move was accepted.
+   *
+   * McSimulation notifies untrackedMoveSignal() after every accepted
+   * move of this class, which does not invalidate its own pair list.
+   */
+   void HybridNphMdMove::unsetPairList()
+   {
+      if (isAccepted_) {
+         isAccepted_ = false;
+      } else {
+         hasPairList_ = false;
+      }
+   }
+
 }
@@ -73,6 +73,14 @@ namespace McMd
       bool move();
    
    private:
+
+      /**
+      * Mark the MD pair list as obsolete (call-back function).
+      *
+      * Observer of McSystem::untrackedMoveSignal(), which is notified
+      * after accepted moves that do not report moved atoms.
+      */
+      void unsetPairList();
   
       /// MdSystem object used for MD integration
       MdSystem      *mdSystemPtr_;  
@@ -92,6 +100,12 @@ namespace McMd
       /// Integration mode
       LatticeSystem mode_;
 
+      /// Was the MD pair list built for the current set of atoms?
+      bool hasPairList_;
+
+      /// Was the last attempt of this move accepted?
+      bool isAccepted_;
+
    };
 
 }      
@@ -100,12 +100,18 @@ namespace McMd
          #endif
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            oldEnergy += system().externalPotential().atomEnergy(*atomPtr);
+            oldEnergy += system().atomExternalEnergy(*atomPtr);
          }
          #endif
          #ifdef SIMP_TETHER
          oldEnergy += system().atomTetherEnergy(*atomPtr);
          #endif
+         #ifdef SIMP_COULOMB
+         if (system().hasCoulombPotential()) {
+            oldEnergy += system().atomRSpaceCoulombEnergy(*atomPtr,
+                                                   atomPtr->position());
+         }
+         #endif
       }
 
       // Generate trial displacement Vector dr
@@ -113,6 +119,24 @@ namespace McMd
          dr[j] = random().uniform(-delta_, delta_);
       }
 
+      #ifdef SIMP_COULOMB
+      // Change in k-space energy, from atoms at their old positions
+      double kSpaceChange = 0.0;
+      if (system().hasCoulombPotential()) {
+         McCoulombPotential& coulomb = system().coulombPotential();
+         coulomb.clearTrial();
+         for (iAtom = 0; iAtom < nAtom_; ++iAtom) {
+            atomPtr = &molPtr->atom(iAtom);
+            newPos = atomPtr->position();
+            newPos += dr;
+            boundary().shift(newPos);
+            coulomb.addTrialMove(*atomPtr, newPos);
+         }
+         kSpaceChange = coulomb.trialEnergyChange();
+         coulomb.clearTrial();
+      }
+      #endif
+
       // Move every atom by dr and calculate new trial energy.
       newEnergy = 0.0;
       for (iAtom = 0; iAtom < nAtom_; ++iAtom) {
@@ -124,7 +148,7 @@ namespace McMd
          #endif
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            newEnergy += system().externalPotential().atomEnergy(*atomPtr);
+            newEnergy += system().atomExternalEnergy(*atomPtr);
          }
          #endif
          #ifdef SIMP_TETHER
@@ -132,6 +156,19 @@ namespace McMd
          #endif
       }
 
+      #ifdef SIMP_COULOMB
+      // Real space energies, after all atoms are moved, so that pairs
+      // within the molecule are counted at unchanged separations.
+      if (system().hasCoulombPotential()) {
+         for (iAtom = 0; iAtom < nAtom_; ++iAtom) {
+            atomPtr = &molPtr->atom(iAtom);
+            newEnergy += system().atomRSpaceCoulombEnergy(*atomPtr,
+                                                   atomPtr->position());
+         }
+         newEnergy += kSpaceChange;
+      }
+      #endif
+
       // Decide whether to accept the move
       bool accept = random().metropolis(boltzmann(newEnergy - oldEnergy));
 
@@ -143,7 +180,12 @@ namespace McMd
             system().pairPotential().updateAtomCell(molPtr->atom(iAtom));
          }
          #endif
+         for (iAtom = 0; iAtom < nAtom_; ++iAtom) {
+            system().atomMoveSignal().notify(molPtr->atom(iAtom),
+                                             oldPositions_[iAtom]);
+         }
 
+         system().incrementTrackedEnergy(newEnergy - oldEnergy);
          incrementNAccept();
 
       } else {
@@ -157,4 +199,22 @@ namespace McMd
       return accept;
    }
 
-}      
+   /*
+   * Accepted energy changes are reported to the McSystem.
+   */
+   bool RigidDisplaceMove::reportsEnergyChange() const
+   {  return true; }
+
+   /*
+   * Moved atoms are reported to observers of McSystem::atomMoveSignal().
+   */
+   bool RigidDisplaceMove::reportsAtomMoves() const
+   {  return true; }
+
+   /*
+   * Coulomb energies are included in the acceptance criterion.
+   */
+   bool RigidDisplaceMove::includesCoulomb() const
+   {  return true; }
+
+}
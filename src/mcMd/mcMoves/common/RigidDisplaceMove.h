@@ -72,6 +72,21 @@ namespace McMd
       */
       virtual bool move();
 
+      /**
+      * Return true: accepted energy changes are reported to McSystem.
+      */
+      virtual bool reportsEnergyChange() const;
+
+      /**
+      * Return true: moved atoms are reported by McSystem::atomMoveSignal().
+      */
+      virtual bool reportsAtomMoves() const;
+
+      /**
+      * Return true: Coulomb energies are included.
+      */
+      virtual bool includesCoulomb() const;
+
    private:
 
       /// Array of old positions.
@@ -0,0 +1,345 @@
+#ifndef SIMP_NOPAIR
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "VolumeMove.h"
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/mcSimulation/McSystem.h>
+#include <mcMd/potentials/pair/McPairPotential.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <simp/species/Species.h>
+#include <util/boundary/Boundary.h>
+#include <util/ensembles/BoundaryEnsemble.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace McMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /*
+   * Constructor
+   */
+   VolumeMove::VolumeMove(McSystem& system)
+    : SystemMove(system),
+      cellList_(),
+      oldPositions_(),
+      pairRsq_(),
+      pairITypes_(),
+      pairJTypes_(),
+      maxDlnV_(0.0),
+      cacheCutoff_(0.0),
+      nTrial_(1),
+      isPairOnly_(false)
+   {  setClassName("VolumeMove"); }
+
+   /*
+   * Read maxDlnV and nTrial.
+   */
+   void VolumeMove::readParameters(std::istream& in)
+   {
+      readProbability(in);
+      read<double>(in, "maxDlnV", maxDlnV_);
+      if (maxDlnV_ <= 0.0) {
+         UTIL_THROW("maxDlnV must be positive");
+      }
+      nTrial_ = 1;
+      readOptional<int>(in, "nTrial", nTrial_);
+      if (nTrial_ <= 0) {
+         UTIL_THROW("nTrial must be positive");
+      }
+      allocate();
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void VolumeMove::loadParameters(Serializable::IArchive &ar)
+   {
+      McMove::loadParameters(ar);
+      loadParameter<double>(ar, "maxDlnV", maxDlnV_);
+      nTrial_ = 1;
+      loadParameter<int>(ar, "nTrial", nTrial_, false);
+      allocate();
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void VolumeMove::save(Serializable::OArchive &ar)
+   {
+      McMove::save(ar);
+      ar << maxDlnV_;
+      bool isActive = (nTrial_ != 1);
+      Parameter::saveOptional(ar, nTrial_, isActive);
+   }
+
+   /*
+   * Check ensemble, allocate arrays, decide if pair cache is usable.
+   */
+   void VolumeMove::allocate()
+   {
+      if (!system().boundaryEnsemble().isIsobaric()) {
+         UTIL_THROW("VolumeMove requires an isobaric boundary ensemble");
+      }
+      int atomCapacity = simulation().atomCapacity();
+      oldPositions_.allocate(atomCapacity);
+      cellList_.setAtomCapacity(atomCapacity);
+
+      isPairOnly_ = true;
+      for (int i = 0; i < simulation().nSpecies(); ++i) {
+         if (simulation().species(i).nAtom() != 1) {
+            isPairOnly_ = false;
+         }
+      }
+      #ifdef SIMP_EXTERNAL
+      if (system().hasExternalPotential()) {
+         isPairOnly_ = false;
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (system().hasCoulombPotential()) {
+         isPairOnly_ = false;
+      }
+      #endif
+
+      // A compression by a linear factor s >= exp(-maxDlnV/Dimension)
+      // can only bring pairs closer than cacheCutoff_ within the cutoff.
+      cacheCutoff_ = system().pairPotential().maxPairCutoff()
+                   * exp(maxDlnV_/double(Dimension));
+   }
+
+   /*
+   * Cache squared separations of all pairs closer than cacheCutoff_.
+   */
+   bool VolumeMove::buildPairCache()
+   {
+      pairRsq_.clear();
+      pairITypes_.clear();
+      pairJTypes_.clear();
+
+      // Require a unique minimum image for every cached pair
+      const Vector& lengths = boundary().lengths();
+      for (int i = 0; i < Dimension; ++i) {
+         if (2.0*cacheCutoff_ >= lengths[i]) return false;
+      }
+
+      // Fill cell list
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      cellList_.setup(boundary(), cacheCutoff_);
+      for (int iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (system().begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               boundary().shift(atomIter->position());
+               cellList_.addAtom(*atomIter);
+            }
+         }
+      }
+
+      // Cache each pair once, from the cell of its atom of lower id
+      CellList::NeighborArray neighbors;
+      Atom*  iAtomPtr;
+      Atom*  jAtomPtr;
+      double rsq;
+      double cutoffSq = cacheCutoff_*cacheCutoff_;
+      int    ic, nInCell, i, j, nNeighbor;
+      for (ic = 0; ic < cellList_.totCells(); ++ic) {
+         cellList_.getCellNeighbors(ic, neighbors, nInCell);
+         nNeighbor = neighbors.size();
+         for (i = 0; i < nInCell; ++i) {
+            iAtomPtr = neighbors[i];
+            for (j = 0; j < nNeighbor; ++j) {
+               jAtomPtr = neighbors[j];
+               if (jAtomPtr->id() <= iAtomPtr->id()) continue;
+               rsq = boundary().distanceSq(iAtomPtr->position(),
+                                           jAtomPtr->position());
+               if (rsq < cutoffSq) {
+                  pairRsq_.append(rsq);
+                  pairITypes_.append(iAtomPtr->typeId());
+                  pairJTypes_.append(jAtomPtr->typeId());
+               }
+            }
+         }
+      }
+      return true;
+   }
+
+   /*
+   * Return total energy of cached pairs with rsq multiplied by factor.
+   */
+   double VolumeMove::cachedEnergy(double factor) const
+   {
+      const McPairPotential& pairPotential = system().pairPotential();
+      double energy = 0.0;
+      int nPair = pairRsq_.size();
+      for (int k = 0; k < nPair; ++k) {
+         energy += pairPotential.energy(factor*pairRsq_[k],
+                                        pairITypes_[k], pairJTypes_[k]);
+      }
+      return energy;
+   }
+
+   /*
+   * Rescale boundary and atomic positions by factor, rebuild cell list.
+   */
+   void VolumeMove::scaleSystem(double factor)
+   {
+      Vector lengths;
+      lengths.multiply(boundary().lengths(), factor);
+      boundary().setOrthorhombic(lengths);
+      #ifdef SIMP_EXTERNAL
+      system().clearExternalEnergyCache();
+      #endif
+
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      for (int iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (system().begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               atomIter->position() *= factor;
+            }
+         }
+      }
+      system().pairPotential().buildCellList();
+   }
+
+   /*
+   * Attempt one volume change, with full energy recomputation.
+   */
+   bool VolumeMove::fullAttempt(double dlnV)
+   {
+      double pressure = system().boundaryEnsemble().pressure();
+      double oldVolume = boundary().volume();
+      double oldEnergy = system().potentialEnergy();
+      Vector oldLengths = boundary().lengths();
+
+      // Store old atom positions
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      int iSpec;
+      for (iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (system().begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               oldPositions_[atomIter->id()] = atomIter->position();
+            }
+         }
+      }
+
+      scaleSystem(exp(dlnV/double(Dimension)));
+      double newVolume = boundary().volume();
+      double newEnergy = system().potentialEnergy();
+
+      double dH = newEnergy - oldEnergy + pressure*(newVolume - oldVolume);
+      double ratio = boltzmann(dH)*exp(double(system().nAtom() + 1)*dlnV);
+      bool accept = random().metropolis(ratio);
+      if (accept) {
+         system().incrementTrackedEnergy(newEnergy - oldEnergy);
+      } else {
+         boundary().setOrthorhombic(oldLengths);
+         for (iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+            system().begin(iSpec, molIter);
+            for ( ; molIter.notEnd(); ++molIter) {
+               molIter->begin(atomIter);
+               for ( ; atomIter.notEnd(); ++atomIter) {
+                  atomIter->position() = oldPositions_[atomIter->id()];
+               }
+            }
+         }
+         system().pairPotential().buildCellList();
+         #ifdef SIMP_EXTERNAL
+         system().clearExternalEnergyCache();
+         #endif
+      }
+      return accept;
+   }
+
+   /*
+   * Make nTrial volume change attempts.
+   */
+   bool VolumeMove::move()
+   {
+      double pressure = system().boundaryEnsemble().pressure();
+      double nMeasure = double(system().nAtom() + 1);
+      double pairCutoff = system().pairPotential().maxPairCutoff();
+      double dlnV, scale, trialScale, volume, trialVolume;
+      double energy, trialEnergy, dH, ratio;
+      bool   useCache, anyAccept;
+
+      // Linear scale of the current configuration relative to the cache
+      scale = 1.0;
+      energy = 0.0;
+      useCache = isPairOnly_ && buildPairCache();
+      if (useCache) {
+         energy = cachedEnergy(1.0);
+      }
+      anyAccept = false;
+      for (int i = 0; i < nTrial_; ++i) {
+         incrementNAttempt();
+         dlnV = random().uniform(-maxDlnV_, maxDlnV_);
+
+         if (useCache) {
+            trialScale = scale*exp(dlnV/double(Dimension));
+
+            // Pairs beyond cacheCutoff_ may be within range: recache
+            if (trialScale*cacheCutoff_ < pairCutoff) {
+               scaleSystem(scale);
+               scale = 1.0;
+               trialScale = exp(dlnV/double(Dimension));
+               useCache = buildPairCache();
+               if (useCache) {
+                  energy = cachedEnergy(1.0);
+               }
+            }
+         }
+
+         if (useCache) {
+            volume = boundary().volume()*scale*scale*scale;
+            trialVolume = boundary().volume()*trialScale*trialScale*trialScale;
+            trialEnergy = cachedEnergy(trialScale*trialScale);
+            dH = trialEnergy - energy + pressure*(trialVolume - volume);
+            ratio = boltzmann(dH)*exp(nMeasure*dlnV);
+            if (random().metropolis(ratio)) {
+               system().incrementTrackedEnergy(trialEnergy - energy);
+               energy = trialEnergy;
+               scale = trialScale;
+               incrementNAccept();
+               anyAccept = true;
+            }
+         } else {
+            if (scale != 1.0) {
+               scaleSystem(scale);
+               scale = 1.0;
+            }
+            if (fullAttempt(dlnV)) {
+               incrementNAccept();
+               anyAccept = true;
+            }
+         }
+      }
+
+      // Apply the accumulated rescaling of accepted cached attempts
+      if (scale != 1.0) {
+         scaleSystem(scale);
+      }
+      return anyAccept;
+   }
+
+   /*
+   * Accepted energy changes are reported to the McSystem.
+   */
+   bool VolumeMove::reportsEnergyChange() const
+   {  return true; }
+
+}
+#endif
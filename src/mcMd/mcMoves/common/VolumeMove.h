@@ -0,0 +1,164 @@
+#ifndef SIMP_NOPAIR
+#ifndef MCMD_VOLUME_MOVE_H
+#define MCMD_VOLUME_MOVE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/mcMoves/SystemMove.h>        // base class
+#include <mcMd/neighbor/CellList.h>         // member
+#include <util/containers/DArray.h>         // member template
+#include <util/containers/GArray.h>         // member template
+#include <util/space/Vector.h>              // member template argument
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class McSystem;
+
+   /**
+   * Isotropic volume change move for the NPT ensemble.
+   *
+   * Each attempt changes ln(V) by a random amount chosen uniformly in
+   * [-maxDlnV, maxDlnV], and rescales all atomic positions affinely
+   * with the orthorhombic boundary. The move is accepted with
+   * probability min[1, exp(-(dU + P dV)/kT + (N+1) dln(V))], in which
+   * N is the number of atoms and P is the pressure of the isobaric
+   * boundary ensemble. Each call of move() makes nTrial successive
+   * attempts.
+   *
+   * If the total potential energy is a sum of pair interactions (every
+   * species monatomic, and no external or coulomb potential), the move
+   * caches the squared separations and atom types of all pairs that
+   * could be within the pair cutoff after any attempted compression.
+   * Because an affine rescaling by a linear factor s multiplies the
+   * square of every minimum image separation by s*s, the energy of a
+   * trial volume is then evaluated exactly from the cache, without
+   * moving atoms or rebuilding the cell list. Atoms are rescaled and
+   * the cell list is rebuilt only once per call of move(), after an
+   * accepted attempt. Otherwise, or if the boundary is too small for
+   * the extended cutoff of the cache, each attempt rescales all atoms,
+   * rebuilds the cell list and recomputes the total potential energy.
+   *
+   * \sa \ref mcMd_mcMove_VolumeMove_page "parameter file format"
+   *
+   * \ingroup McMd_McMove_Module McMove_Module
+   */
+   class VolumeMove : public SystemMove
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      VolumeMove(McSystem& system);
+
+      /**
+      * Read maxDlnV and (optionally) nTrial.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Make nTrial volume change attempts.
+      *
+      * \return true if any attempt was accepted, false otherwise
+      */
+      virtual bool move();
+
+      /**
+      * Accepted energy changes are reported to the McSystem.
+      */
+      virtual bool reportsEnergyChange() const;
+
+   private:
+
+      /// Cell list used to find pairs within cacheCutoff_.
+      CellList cellList_;
+
+      /// Positions of atoms before a full rescaling, indexed by atom id.
+      DArray<Vector> oldPositions_;
+
+      /// Squared separations of cached pairs.
+      GArray<double> pairRsq_;
+
+      /// Type ids of the first atom of each cached pair.
+      GArray<int> pairITypes_;
+
+      /// Type ids of the second atom of each cached pair.
+      GArray<int> pairJTypes_;
+
+      /// Maximum change in ln(V) in one attempt.
+      double maxDlnV_;
+
+      /// Pair separation below which all pairs are cached.
+      double cacheCutoff_;
+
+      /// Number of attempts per call of move().
+      int nTrial_;
+
+      /// Is the potential energy a sum of pair energies?
+      bool isPairOnly_;
+
+      /**
+      * Check that move is applicable to the system, allocate arrays.
+      */
+      void allocate();
+
+      /**
+      * Cache separations of all pairs within cacheCutoff_.
+      *
+      * \return false if the boundary is too small, true otherwise
+      */
+      bool buildPairCache();
+
+      /**
+      * Return pair energy of cached pairs, with rsq multiplied by factor.
+      *
+      * \param factor square of linear scaling factor
+      */
+      double cachedEnergy(double factor) const;
+
+      /**
+      * Rescale boundary and all atomic positions, rebuild cell list.
+      *
+      * \param factor linear scaling factor
+      */
+      void scaleSystem(double factor);
+
+      /**
+      * Attempt one volume change with a full energy recomputation.
+      *
+      * \param dlnV change in ln(V)
+      * \return true if accepted, false if rejected
+      */
+      bool fullAttempt(double dlnV);
+
+   };
+
+}
+#endif
+#endif
@@ -1,10 +1,14 @@
 mcMd_mcMoves_common_=\
     mcMd/mcMoves/common/AtomDisplaceMove.cpp \
+    mcMd/mcMoves/common/CheckerboardDisplaceMove.cpp \
     mcMd/mcMoves/common/DpdMove.cpp \
+    mcMd/mcMoves/common/EventChainMove.cpp \
+    mcMd/mcMoves/common/GeometricClusterMove.cpp \
     mcMd/mcMoves/common/HybridMdMove.cpp \
     mcMd/mcMoves/common/HybridNphMdMove.cpp \
     mcMd/mcMoves/common/MdMove.cpp \
-    mcMd/mcMoves/common/RigidDisplaceMove.cpp 
+    mcMd/mcMoves/common/RigidDisplaceMove.cpp \
+    mcMd/mcMoves/common/VolumeMove.cpp 
 
 mcMd_mcMoves_common_SRCS=\
      $(addprefix $(SRC_DIR)/, $(mcMd_mcMoves_common_))
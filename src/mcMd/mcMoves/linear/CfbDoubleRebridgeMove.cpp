@@ -60,6 +60,12 @@ namespace McMd
       // Initialize tables for spring constants and normalizations.
       setup();
 
+      #ifndef SIMP_NOPAIR
+      // Index of bridgeable atoms, for the search of candidate pairs
+      system().pairPotential().requestBridgeCellList(speciesId_,
+                                                     bridgeLength_);
+      #endif
+
       // Allocate array to store old positions 
       iOldPos_.allocate(nRegrow_); 
       jOldPos_.allocate(nRegrow_); 
@@ -87,6 +93,12 @@ namespace McMd
       // Initialize tables for spring constants and normalizations.
       setup();
 
+      #ifndef SIMP_NOPAIR
+      // Index of bridgeable atoms, for the search of candidate pairs
+      system().pairPotential().requestBridgeCellList(speciesId_,
+                                                     bridgeLength_);
+      #endif
+
       // Allocate arrays to store old positions 
       iOldPos_.allocate(nRegrow_); 
       jOldPos_.allocate(nRegrow_); 
@@ -311,12 +323,10 @@ namespace McMd
    bool CfbDoubleRebridgeMove::forwardScan(int sign, int &iMol,
                             int &jMol, int &beginId, double &prob)
    {
-      Molecule *iPtr, *jPtr;
-      Vector   iPos1, jPos1, iPos2, jPos2;
+      Molecule *iPtr;
       int      nMol, nAtom, maxPair;
-      int      signRegrow, nPairs, k, choice;
+      int      nPairs, choice;
       int      *molBuf, *atomBuf;
-      double   lengthSq, bridgeLengthSq;  
       bool     found;
 
       // Number of molecules
@@ -339,49 +349,9 @@ namespace McMd
       molBuf  = new int[maxPair];  
       atomBuf = new int[maxPair];  
       
-      // Identify the direction of scaning
-      beginId = (sign == -1) ? (nAtom-1) : 0;
-
-      // Auxiliary variables
-      signRegrow = sign * (nRegrow_ + 1);
-      bridgeLengthSq = bridgeLength_ * bridgeLength_;
-
-      // Nullify counters
-      nPairs = 0; 
-      found  = false;
-
-      // Loop over j molecules to scan possible pairs
-      for (jMol = 0; jMol < nMol; ++jMol) {
-
-         jPtr = &(system().molecule(speciesId_, jMol));
-
-         if (jMol != iMol) {
-
-            for (k = 0; k <  nAtom - 1 - nRegrow_; ++k) {  
-
-               // Check if i1 to j2 bridging is possible
-               iPos1 = iPtr->atom(beginId + k*sign).position();
-               jPos2 = jPtr->atom(beginId + signRegrow + k*sign).position();
-               lengthSq = boundary().distanceSq(iPos1, jPos2);
-
-               if (lengthSq < bridgeLengthSq) {
-                  // Check if j2 to i1 bridging is possible          
-                  jPos1 = jPtr->atom(beginId + k*sign).position();
-                  iPos2 = iPtr->atom(beginId + signRegrow + k*sign).position();
-                  lengthSq = boundary().distanceSq(iPos2, jPos1);
-                  
-                  if (lengthSq < bridgeLengthSq) {
-                     molBuf[nPairs]  = jMol;
-                     atomBuf[nPairs] = beginId + k*sign;
-                     nPairs += 1;
-                  }  
-               }
-
-            } // loop over atom positions
-         } // if jMol != iMol
-      } // loop over j molecules
-      
-      if (nPairs > 0) found = true;
+      // Find all candidate pairs
+      nPairs = findPairs(iPtr, sign, molBuf, atomBuf);
+      found = (nPairs > 0);
       
       if (found) {
          // iMol is not changed after the random selection
@@ -419,87 +389,128 @@ namespace McMd
    {
       Molecule *iPtr, *jPtr;
       Vector   iPos1, jPos1, iPos2, jPos2;
-      int      nMol, nAtom, j;
-      int      signRegrow, nPairs, headId, k;
+      int      signRegrow, nPairs;
       double   lengthSq, bridgeLengthSq;  
-      bool     found;
 
       // Retrieve molecule pointers
       iPtr = &(system().molecule(speciesId_, iMol));
       jPtr = &(system().molecule(speciesId_, jMol));
 
-      // Number of molecules
-      nMol = system().nMolecule(speciesId_);
-
-      // Number of atoms per molecule
-      nAtom = iPtr->nAtom();
-
       // Auxiliary variables
       signRegrow = sign * (nRegrow_ + 1);
       bridgeLengthSq = bridgeLength_ * bridgeLength_;
 
-      // Initialize returning variable
-      found = false;
-
       // Check if i1 to j2 bridging is possible
       iPos1 = iPtr->atom(beginId).position();
       jPos2 = jPtr->atom(beginId + signRegrow).position();
       lengthSq = boundary().distanceSq(iPos1, jPos2);
-
-      if (lengthSq < bridgeLengthSq) {
-         // Check if j2 to i1 bridging is possible          
-         jPos1 = jPtr->atom(beginId).position();
-         iPos2 = iPtr->atom(beginId + signRegrow).position();
-         lengthSq = boundary().distanceSq(iPos2, jPos1);
-                  
-         if (lengthSq < bridgeLengthSq) {
-            found = true;
-         } else {
-            prob = 0.0;
-            return found;
-         }
-      } else {
+      if (lengthSq >= bridgeLengthSq) {
          prob = 0.0;
-         return found;
+         return false;
       }
 
-      // Auxiliary variables
-      headId = (sign == -1) ? (nAtom-1) : 0;
-      iMol = system().moleculeId(*iPtr);
-
-      // Nullify counters
-      nPairs = 0; 
-
-      // Loop over j molecules to scan possible pairs
-      for (j = 0; j < nMol; ++j) {
-
-         jPtr = &(system().molecule(speciesId_, j));
+      // Check if j2 to i1 bridging is possible
+      jPos1 = jPtr->atom(beginId).position();
+      iPos2 = iPtr->atom(beginId + signRegrow).position();
+      lengthSq = boundary().distanceSq(iPos2, jPos1);
+      if (lengthSq >= bridgeLengthSq) {
+         prob = 0.0;
+         return false;
+      }
 
-         if (j != iMol) {
+      // Count all pairs: nPairs is always greater than or equal to 1
+      nPairs = findPairs(iPtr, sign, 0, 0);
+      prob = 1.0 / double(nPairs);
+      return true;
+   }
 
-            for (k = 0; k <  nAtom - 1 - nRegrow_; ++k) {  
+   /*
+   * Find all pairs of rebridging sites of molecule iPtr (private).
+   *
+   * Returns the number of pairs. If molBuf and atomBuf are not null, the
+   * molecule id of molecule j and the index of atom i1 are stored for
+   * each pair. The search loops over candidate atoms i1 of molecule i,
+   * and finds candidate atoms j2 among atoms of the same species within
+   * bridgeLength of i1 in the bridge cell list of the pair potential.
+   */
+   int CfbDoubleRebridgeMove::findPairs(Molecule* iPtr, int sign,
+                                        int* molBuf, int* atomBuf)
+   {
+      Vector   iPos1, iPos2;
+      int      nAtom, headId, signRegrow, nPairs, i1, k;
+      double   bridgeLengthSq;
 
-               // Check if i1 to j2 bridging is possible
-               iPos1 = iPtr->atom(headId + k*sign).position();
-               jPos2 = jPtr->atom(headId + signRegrow + k*sign).position();
-               lengthSq = boundary().distanceSq(iPos1, jPos2);
+      nAtom = iPtr->nAtom();
+      headId = (sign == -1) ? (nAtom-1) : 0;
+      signRegrow = sign * (nRegrow_ + 1);
+      bridgeLengthSq = bridgeLength_ * bridgeLength_;
+      nPairs = 0;
+
+      #ifndef SIMP_NOPAIR
+      const CellList& cellList = system().pairPotential().bridgeCellList();
+      Molecule *jPtr;
+      Atom     *j2Ptr;
+      int      j, nNeighbor;
+
+      for (k = 0; k <  nAtom - 1 - nRegrow_; ++k) {
+         i1 = headId + k*sign;
+         iPos1 = iPtr->atom(i1).position();
+         iPos2 = iPtr->atom(i1 + signRegrow).position();
+
+         // Loop over atoms near i1 with the index of atom j2
+         cellList.getNeighbors(iPos1, neighbors_);
+         nNeighbor = neighbors_.size();
+         for (j = 0; j < nNeighbor; ++j) {
+            j2Ptr = neighbors_[j];
+            if (j2Ptr->indexInMolecule() != i1 + signRegrow) continue;
+            jPtr = &j2Ptr->molecule();
+            if (jPtr == iPtr) continue;
+
+            // Check i1 to j2, then i2 to j1 bridging
+            if (boundary().distanceSq(iPos1, j2Ptr->position())
+                >= bridgeLengthSq) continue;
+            if (boundary().distanceSq(iPos2, jPtr->atom(i1).position())
+                >= bridgeLengthSq) continue;
+
+            if (molBuf) {
+               molBuf[nPairs]  = system().moleculeId(*jPtr);
+               atomBuf[nPairs] = i1;
+            }
+            nPairs += 1;
+         }
+      }
+      #else
+      Molecule *jPtr;
+      Vector   jPos1, jPos2;
+      int      nMol, iMol, jMol;
 
-               if (lengthSq < bridgeLengthSq) {
-                  // Check if j2 to j1 bridging is possible          
-                  jPos1 = jPtr->atom(headId + k*sign).position();
-                  iPos2 = iPtr->atom(headId + signRegrow + k*sign).position();
-                  lengthSq = boundary().distanceSq(iPos2, jPos1);
-                  
-                  if (lengthSq < bridgeLengthSq) nPairs += 1;
-               }
+      nMol = system().nMolecule(speciesId_);
+      iMol = system().moleculeId(*iPtr);
+      for (jMol = 0; jMol < nMol; ++jMol) {
+         if (jMol == iMol) continue;
+         jPtr = &(system().molecule(speciesId_, jMol));
+         for (k = 0; k <  nAtom - 1 - nRegrow_; ++k) {
+            i1 = headId + k*sign;
+            iPos1 = iPtr->atom(i1).position();
+            jPos2 = jPtr->atom(i1 + signRegrow).position();
+            if (boundary().distanceSq(iPos1, jPos2) >= bridgeLengthSq) {
+               continue;
+            }
+            jPos1 = jPtr->atom(i1).position();
+            iPos2 = iPtr->atom(i1 + signRegrow).position();
+            if (boundary().distanceSq(iPos2, jPos1) >= bridgeLengthSq) {
+               continue;
+            }
+            if (molBuf) {
+               molBuf[nPairs]  = jMol;
+               atomBuf[nPairs] = i1;
+            }
+            nPairs += 1;
+         }
+      }
+      #endif
 
-            } // loop over atom positions
-         } // if j != iMol
-      } // loop over j molecules
- 
-      // nPairs is always greater than or equal to 1
-      prob = 1.0 / double(nPairs);
-      return found;
+      return nPairs;
    }
    
 }
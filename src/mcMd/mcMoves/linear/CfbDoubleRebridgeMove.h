@@ -9,6 +9,7 @@
 */
 
 #include <mcMd/mcMoves/base/CfbRebridgeBase.h> // base class
+#include <mcMd/neighbor/CellList.h>             // member
 #include <util/containers/DArray.h>            // member template
 #include <util/space/Vector.h>                 // member template parameter
 
@@ -26,6 +27,11 @@ namespace McMd
    /**
    * configuration bias trimer double rebridge moves, to reconnect two chains.
    *
+   * Candidate pairs of rebridging sites are found with the bridge cell
+   * list of the pair potential (see McPairPotential::requestBridgeCellList),
+   * which contains only atoms of the chosen species, so that the cost of
+   * a search is independent of the number of molecules.
+   *
    * \ingroup McMd_McMove_Module
    */
    class CfbDoubleRebridgeMove : public CfbRebridgeBase
@@ -81,6 +87,12 @@ namespace McMd
 
    private:
 
+      /// Array to hold neighbors returned by the bridge cell list.
+      CellList::NeighborArray neighbors_;
+
+      /// Find all rebridging pairs of molecule iPtr, return number.
+      int findPairs(Molecule* iPtr, int sign, int* molBuf, int* atomBuf);
+
       /// Scan potential bridging sites for old->new move
       bool forwardScan(int sign, int &iMol, int &jMol,
               int &beginId, double &prob);
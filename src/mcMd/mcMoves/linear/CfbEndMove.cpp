@@ -14,6 +14,9 @@
 #ifndef SIMP_NOPAIR
 #include <mcMd/potentials/pair/McPairPotential.h>
 #endif
+#ifdef SIMP_COULOMB
+#include <mcMd/potentials/coulomb/McCoulombPotential.h>
+#endif
 #include <simp/species/Linear.h>
 #include <util/boundary/Boundary.h>
 #include <util/global.h>
@@ -134,6 +137,13 @@ namespace McMd
          oldPos_[i] = endPtr->position();
          endPtr += sign;
       }
+
+      #ifdef SIMP_COULOMB
+      // Charges are removed and inserted as trial moves
+      if (system().hasCoulombPotential()) {
+         system().coulombPotential().clearTrial();
+      }
+      #endif
    
       // Delete monomers, starting from chain end
       rosen_r  = 1.0;
@@ -185,7 +195,13 @@ namespace McMd
          // Increment counter for accepted moves of this class.
          incrementNAccept();
 
-         // If the move is accepted, keep current positions.
+         // If the move is accepted, keep current positions, and
+         // report the moved atoms (this also clears any Coulomb trial).
+         endPtr = &(molPtr->atom(beginId));
+         for (i = 0; i < nRegrow_; ++i) {
+            system().atomMoveSignal().notify(*endPtr, oldPos_[i]);
+            endPtr += sign;
+         }
 
       } else {
 
@@ -199,10 +215,29 @@ namespace McMd
             #endif
             endPtr += sign;
          }
+
+         #ifdef SIMP_COULOMB
+         if (system().hasCoulombPotential()) {
+            system().coulombPotential().clearTrial();
+         }
+         #endif
    
       }
 
       return accept;
    
    }
+
+   /*
+   * Regrown atoms are reported to observers of McSystem::atomMoveSignal().
+   */
+   bool CfbEndMove::reportsAtomMoves() const
+   {  return true; }
+
+   /*
+   * Coulomb energies are included in the Rosenbluth factors.
+   */
+   bool CfbEndMove::includesCoulomb() const
+   {  return true; }
+
 }
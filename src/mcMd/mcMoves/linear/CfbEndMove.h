@@ -62,6 +62,16 @@ namespace McMd
       * Generate and accept or reject configuration bias move
       */
       virtual bool move();
+
+      /**
+      * Return true: regrown atoms are reported by McSystem::atomMoveSignal().
+      */
+      virtual bool reportsAtomMoves() const;
+
+      /**
+      * Return true: Coulomb energies are included.
+      */
+      virtual bool includesCoulomb() const;
    
    protected:
    
@@ -184,7 +184,7 @@ namespace McMd
       if (hasExternal_) {
          externalPotentialPtr = &system().externalPotential();
          assert(externalPotentialPtr);
-         energy += externalPotentialPtr->atomEnergy(atom0);
+         energy += system().atomExternalEnergy(atom0);
       }
       #endif
 
@@ -195,40 +195,56 @@ namespace McMd
       // Add bond energy to total energy in current position
       energy += bondEnergy;
 
-      // Loop over nTrial - 1 additional trial positions:
-      double trialEnergy;
-      for (int iTrial = 0; iTrial < nTrial_ - 1; ++iTrial) {
-
-         // Generate trial position
+      // Generate nTrial - 1 additional trial positions
+      Vector trialPos[MaxTrial_];
+      double trialEnergy[MaxTrial_];
+      #ifdef SIMP_ANGLE
+      double trialCosTheta[MaxTrial_];
+      #endif
+      int iTrial;
+      int nExtra = nTrial_ - 1;
+      for (iTrial = 0; iTrial < nExtra; ++iTrial) {
          random().unitVector(u1);
          v1 = u1;
          v1 *= r1;
-         pos0.subtract(pos1, v1);
-         boundary().shift(pos0);
-
-         // Compute trial energy (excluding bond energy)
-         #ifndef SIMP_NOPAIR
-         trialEnergy = system().pairPotential().atomEnergy(atom0);
-         #else
-         trialEnergy = 0.0;
+         trialPos[iTrial].subtract(pos1, v1);
+         boundary().shift(trialPos[iTrial]);
+         #ifdef SIMP_ANGLE
+         if (hasAngle) {
+            trialCosTheta[iTrial] = u1.dot(u2);
+         }
          #endif
+      }
+
+      // Compute pair energies of all trials in one call
+      #ifndef SIMP_NOPAIR
+      pairPotential.trialEnergies(atom0, trialPos, nExtra, trialEnergy);
+      #else
+      for (iTrial = 0; iTrial < nExtra; ++iTrial) {
+         trialEnergy[iTrial] = 0.0;
+      }
+      #endif
+
+      // Add remaining trial energies (excluding bond energy)
+      for (iTrial = 0; iTrial < nExtra; ++iTrial) {
+         pos0 = trialPos[iTrial];
          #ifdef SIMP_ANGLE
          if (hasAngles_) {
             if (hasAngle) {
                assert(anglePotentialPtr);
-               double cosTheta = u1.dot(u2);
-               trialEnergy += anglePotentialPtr->energy(cosTheta, angleTypeId);
+               trialEnergy[iTrial] += 
+                  anglePotentialPtr->energy(trialCosTheta[iTrial], angleTypeId);
             }
          }
          #endif
          #ifdef SIMP_EXTERNAL
          if (hasExternal_) {
             assert(externalPotentialPtr);
-            trialEnergy += externalPotentialPtr->atomEnergy(atom0);
+            trialEnergy[iTrial] += externalPotentialPtr->atomEnergy(atom0);
          }
          #endif
 
-         rosenbluth += boltzmann(trialEnergy);
+         rosenbluth += boltzmann(trialEnergy[iTrial]);
       }
 
    }
@@ -297,42 +313,62 @@ namespace McMd
       }
       #endif
 
-      // Loop over nTrial trial positions:
+      // Generate nTrial trial positions
       Vector v1, u1;
       Vector trialPos[MaxTrial_];
       double trialProb[MaxTrial_], trialEnergy[MaxTrial_];
-      rosenbluth = 0.0;
+      #ifdef SIMP_ANGLE
+      double trialCosTheta[MaxTrial_];
+      #endif
       for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
-
-         // Generate trial bond vector v1 and position pos0
          random().unitVector(u1);
          v1 = u1;
          v1 *= r1;
          trialPos[iTrial].subtract(pos1, v1);
          boundary().shift(trialPos[iTrial]);
-         pos0 = trialPos[iTrial];
+         #ifdef SIMP_ANGLE
+         if (hasAngle) {
+            trialCosTheta[iTrial] = u1.dot(u2);
+         }
+         #endif
+      }
 
-         // Compute trial energy (excluding bond energy)
-         #ifndef SIMP_NOPAIR
-         trialEnergy[iTrial] = pairPotential.atomEnergy(atom0);
-         #else
+      // Compute pair energies of all trials in one call
+      #ifndef SIMP_NOPAIR
+      pairPotential.trialEnergies(atom0, trialPos, nTrial_, trialEnergy);
+      #else
+      for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
          trialEnergy[iTrial] = 0.0;
-         #endif
+      }
+      #endif
+
+      // Compute external energies of all trials in one call
+      #ifdef SIMP_EXTERNAL
+      double externalEnergy[MaxTrial_];
+      if (hasExternal_) {
+         assert(externalPotentialPtr);
+         externalPotentialPtr->trialEnergies(atom0.typeId(), trialPos,
+                                             nTrial_, externalEnergy);
+      }
+      #endif
+
+      // Add remaining trial energies, compute Rosenbluth factor
+      rosenbluth = 0.0;
+      for (iTrial = 0; iTrial < nTrial_; ++iTrial) {
+         pos0 = trialPos[iTrial];
          #ifdef SIMP_ANGLE
          if (hasAngles_) {
             if (hasAngle) {
                assert(anglePotentialPtr);
-               double cosTheta = u1.dot(u2);
                trialEnergy[iTrial] += 
-                  anglePotentialPtr->energy(cosTheta, angleTypeId);
+                  anglePotentialPtr->energy(trialCosTheta[iTrial], angleTypeId);
             }
          }
          #endif
          #ifdef SIMP_EXTERNAL
          if (hasExternal_) {
             assert(externalPotentialPtr);
-            trialEnergy[iTrial] +=
-                        externalPotentialPtr->atomEnergy(atom0);
+            trialEnergy[iTrial] += externalEnergy[iTrial];
          }
          #endif
 
@@ -355,6 +391,11 @@ namespace McMd
 
       // Set position to chosen value
       pos0 = trialPos[iTrial];
+      #ifdef SIMP_EXTERNAL
+      if (hasExternal_) {
+         system().storeExternalEnergy(atom0, pos0, externalEnergy[iTrial]);
+      }
+      #endif
    }
 
 }
@@ -321,7 +321,7 @@ namespace McMd
          #endif
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            oldEnergy += system().externalPotential().atomEnergy(*hAtomPtr);
+            oldEnergy += system().atomExternalEnergy(*hAtomPtr);
          }
          #endif
 
@@ -333,7 +333,7 @@ namespace McMd
          #endif
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            newEnergy += system().externalPotential().atomEnergy(*hAtomPtr);
+            newEnergy += system().atomExternalEnergy(*hAtomPtr);
          }
          #endif
 
@@ -349,7 +349,7 @@ namespace McMd
 
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            oldEnergy += system().externalPotential().atomEnergy(*hAtomPtr);
+            oldEnergy += system().atomExternalEnergy(*hAtomPtr);
          }
          #endif
 
@@ -360,7 +360,7 @@ namespace McMd
 
          #ifdef SIMP_EXTERNAL
          if (system().hasExternalPotential()) {
-            newEnergy += system().externalPotential().atomEnergy(*hAtomPtr);
+            newEnergy += system().atomExternalEnergy(*hAtomPtr);
          }
          #endif
 
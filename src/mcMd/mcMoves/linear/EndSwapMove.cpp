@@ -143,7 +143,7 @@ namespace McMd
       if (system().hasExternalPotential()) {
          for (i = 0; i < nAtom; ++i) {
             atomPtr = &molPtr->atom(i);
-            oldEnergy += system().externalPotential().atomEnergy(*atomPtr);
+            oldEnergy += system().atomExternalEnergy(*atomPtr);
          }
       }
       #endif
@@ -164,7 +164,7 @@ namespace McMd
          for (i = 0; i < nAtom; ++i) {
             molPtr->atom(i).setTypeId(atomTypeIds_[nAtom - 1 - i]);   
             atomPtr = &molPtr->atom(i);
-            newEnergy += system().externalPotential().atomEnergy(*atomPtr);
+            newEnergy += system().atomExternalEnergy(*atomPtr);
          }
       }
       #endif
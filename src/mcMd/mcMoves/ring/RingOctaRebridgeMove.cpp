@@ -50,6 +50,12 @@ namespace McMd
       if (!ringPtr) {
          UTIL_THROW("Not a Ring species");
       }
+
+      #ifndef SIMP_NOPAIR
+      // Index of ring atoms: Atom n lies within 2*upperBridge of atom m
+      system().pairPotential().requestBridgeCellList(speciesId_,
+                                                     2.0*upperBridge_);
+      #endif
    }
 
    /*
@@ -68,6 +74,12 @@ namespace McMd
       if (!ringPtr) {
          UTIL_THROW("Species is not a Ring species");
       }
+
+      #ifndef SIMP_NOPAIR
+      // Index of ring atoms: Atom n lies within 2*upperBridge of atom m
+      system().pairPotential().requestBridgeCellList(speciesId_,
+                                                     2.0*upperBridge_);
+      #endif
    }
 
    /*
@@ -215,9 +227,10 @@ namespace McMd
          return found;
       }
 
-      // Get the neighbor list.
+      // Get atoms of the ring species near atom m.
       #ifndef SIMP_NOPAIR
-      system().pairPotential().cellList().getNeighbors(mPos, neighbors_);
+      system().pairPotential().bridgeCellList().getNeighbors(mPos,
+                                                             neighbors_);
       nNeighbor = neighbors_.size();
       idList = new int[nNeighbor];
       molIdList = new int[nNeighbor];
@@ -243,9 +256,6 @@ namespace McMd
             if (dmn <= 2 && dnm <= 2) validIndex = false;
          }
 
-         if (pn->molecule().species().id() != speciesId_)
-            validIndex = false;
-
          if (validIndex) {
 
             molPtr2 = &(system().molecule(speciesId_, molId2));
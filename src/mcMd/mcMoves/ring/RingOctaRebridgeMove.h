@@ -25,7 +25,9 @@ namespace McMd
    * The exchange of positions of two closely approaching atoms is attempted.
    * Each atom is bonded to two other atoms. The move requires that the 6 atoms
    * form an octahedron in which the edge lengths satisfying certain distance
-   * criterions, before the exchange is attempted.
+   * criterions, before the exchange is attempted. Partners are found in
+   * the bridge cell list of the pair potential, which contains only atoms
+   * of the ring species, in cells of width at least 2*upperBridge.
    *
    * \ingroup McMd_McMove_Module
    */
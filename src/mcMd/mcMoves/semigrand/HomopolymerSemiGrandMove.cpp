@@ -76,42 +76,30 @@ namespace McMd
       incrementNAttempt();
       Molecule& molecule = system().randomMolecule(speciesId_);
 
-      #ifndef SIMP_NOPAIR
-      // Calculate pair energy for the chosen molecule
-      double oldEnergy = system().pairPotential().moleculeEnergy(molecule);
-      #endif
-
-      // Toggle state of the molecule
+      // Choose the other state of the molecule
       int oldStateId = speciesPtr_->mutator().moleculeStateId(molecule);
       int newStateId = (oldStateId == 0) ? 1 : 0;
-      speciesPtr_->mutator().setMoleculeState(molecule, newStateId);
-
-      #ifdef SIMP_NOPAIR 
 
+      #ifdef SIMP_NOPAIR
       bool   accept = true;
-
       #else // ifndef SIMP_NOPAIR
 
-      // Recalculate pair energy for the molecule
-      double newEnergy = system().pairPotential().moleculeEnergy(molecule);
+      // Compute change in pair energy, without changing atom types
+      int newTypeId = speciesPtr_->stateTypeId(newStateId);
+      double dEnergy = system().pairPotential().
+                       moleculeTypeChangeEnergy(molecule, newTypeId);
 
       // Decide whether to accept or reject
       double oldWeight = speciesPtr_->mutator().stateWeight(oldStateId);
       double newWeight = speciesPtr_->mutator().stateWeight(newStateId);
-      double ratio  = boltzmann(newEnergy - oldEnergy)*newWeight/oldWeight;
+      double ratio  = boltzmann(dEnergy)*newWeight/oldWeight;
       bool   accept = random().metropolis(ratio);
-   
       #endif
 
+      // Change state of the molecule only if accepted
       if (accept) {
-
+         speciesPtr_->mutator().setMoleculeState(molecule, newStateId);
          incrementNAccept();
-
-      } else {
-
-         // Revert chosen molecule to original state
-         speciesPtr_->mutator().setMoleculeState(molecule, oldStateId);
-
       }
 
       return accept;
@@ -18,14 +18,14 @@ namespace McMd
    McAnalyzerManager::McAnalyzerManager(McSimulation& simulation)
     : simulationPtr_(&simulation),
       systemPtr_(&simulation.system())
-   {}
+   {  setThreadPool(simulation.threadPool()); }
 
    // Constructor.
    McAnalyzerManager::McAnalyzerManager(McSimulation& simulation, 
 		                            McSystem &system)
     : simulationPtr_(&simulation),
       systemPtr_(&system)
-   {}
+   {  setThreadPool(simulation.threadPool()); }
 
    /// Return pointer to a new AnalyzerFactory.
    Factory<Analyzer>* McAnalyzerManager::newDefaultFactory() const
@@ -0,0 +1,431 @@
+#ifdef MCMD_REPLICAS
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "McReplicaSet.h"
+#include "McSimulation.h"
+#include "McSystem.h"
+#include <mcMd/perturb/Perturbation.h>
+#include <mcMd/perturb/ReplicaMove.h>
+#ifndef SIMP_NOPAIR
+#include <mcMd/potentials/pair/McPairPotential.h>
+#endif
+
+#include <util/containers/DArray.h>
+#include <util/misc/FileMaster.h>
+#include <util/misc/Log.h>
+#include <util/misc/Timer.h>
+#include <util/misc/ioUtil.h>
+
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   McReplicaSet::McReplicaSet(MPI::Intracomm& communicator)
+    : args_(),
+      replicas_(),
+      contexts_(),
+      logFiles_(),
+      runners_(),
+      values_(),
+      stateIds_(),
+      communicatorPtr_(&communicator),
+      nLocal_(0),
+      nReplica_(0),
+      firstId_(0),
+      nParameter_(0)
+   {}
+
+   /*
+   * Destructor.
+   */
+   McReplicaSet::~McReplicaSet()
+   {
+      // Each Simulation deallocates the Atom arrays of the calling thread
+      for (int i = 0; i < (int)replicas_.size(); ++i) {
+         Atom::setContext(contexts_[i]);
+         delete replicas_[i];
+      }
+      if (logFiles_.size() > 0) {
+         Log::close();
+      }
+      for (int i = 0; i < (int)logFiles_.size(); ++i) {
+         delete logFiles_[i];
+      }
+   }
+
+   /*
+   * Extract option -m, drop -f, keep all others for each replica.
+   */
+   bool McReplicaSet::setOptions(int argc, char** argv)
+   {
+      bool mFlag = false;
+      bool pFlag = false;
+      args_.clear();
+      args_.push_back(argv[0]);
+      int i = 1;
+      while (i < argc) {
+         if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            nLocal_ = atoi(argv[i+1]);
+            mFlag = true;
+            i += 2;
+         } else
+         if (strcmp(argv[i], "-f") == 0) {
+            ++i;
+         } else {
+            if (strcmp(argv[i], "-r") == 0) {
+               UTIL_THROW("Option -r is not supported with -m");
+            }
+            if (strcmp(argv[i], "-p") == 0) {
+               pFlag = true;
+            }
+            args_.push_back(argv[i]);
+            ++i;
+         }
+      }
+      args_.push_back(0);
+      if (!mFlag) {
+         return false;
+      }
+      if (nLocal_ < 1) {
+         UTIL_THROW("Number of replicas per process must be positive");
+      }
+      if (!pFlag) {
+         // Every replica reads the parameter file, so it may not be std::cin
+         UTIL_THROW("Option -m requires option -p");
+      }
+      nReplica_ = nLocal_*communicatorPtr_->Get_size();
+      firstId_ = nLocal_*communicatorPtr_->Get_rank();
+      return true;
+   }
+
+   /*
+   * Create and initialize all replicas of this process.
+   *
+   * Replicas are created and read serially by the main thread. The Atom
+   * arrays of each are saved after readParam(), which allocates them.
+   */
+   void McReplicaSet::readParam()
+   {
+      if (nLocal_ < 1) {
+         UTIL_THROW("setOptions() must be called first");
+      }
+      replicas_.resize(nLocal_, 0);
+      contexts_.resize(nLocal_);
+      logFiles_.resize(nLocal_, 0);
+
+      McSimulation* simulationPtr;
+      int i, id;
+      for (i = 0; i < nLocal_; ++i) {
+         id = firstId_ + i;
+         Atom::setContext(Atom::Context());
+         simulationPtr = new McSimulation();
+         replicas_[i] = simulationPtr;
+         simulationPtr->setReplica(id, nReplica_);
+         simulationPtr->fileMaster().setDirectoryId(id);
+         simulationPtr->fileMaster().setCommonControl();
+
+         // Open log file "id/log" (output prefix is still empty).
+         logFiles_[i] = new std::ofstream;
+         simulationPtr->fileMaster().openOutputFile("log", *logFiles_[i]);
+         Log::setFile(*logFiles_[i]);
+
+         simulationPtr->system().setExpectPerturbation();
+         simulationPtr->setOptions(args_.size() - 1, &args_[0]);
+         simulationPtr->readParam();
+         Atom::getContext(contexts_[i]);
+
+         McSystem& system = simulationPtr->system();
+         if (!system.hasPerturbation()) {
+            UTIL_THROW("Parameter file has no Perturbation");
+         }
+         if (system.hasReplicaMove()) {
+            if (!system.replicaMove().swapParameters()) {
+               UTIL_THROW("McReplicaSet requires swapParameters = 1");
+            }
+         }
+      }
+
+      nParameter_ = replicas_[0]->system().perturbation().getNParameters();
+      values_.resize(2*nParameter_*nLocal_);
+      stateIds_.resize(nLocal_);
+      runners_.resize(nLocal_);
+      for (i = 0; i < nLocal_; ++i) {
+         runners_[i].simulationPtr = replicas_[i];
+         runners_[i].contextPtr = &contexts_[i];
+      }
+   }
+
+   /*
+   * Read and execute commands from the default command file.
+   */
+   void McReplicaSet::readCommands()
+   {
+      FileMaster& fileMaster = replicas_[0]->fileMaster();
+      if (fileMaster.commandFileName().empty()) {
+         UTIL_THROW("Empty command file name");
+      }
+      readCommands(fileMaster.commandFile());
+   }
+
+   /*
+   * Read commands, and execute each one for every replica.
+   */
+   void McReplicaSet::readCommands(std::istream& in)
+   {
+      std::string line;
+      std::string command;
+      std::string arguments;
+      int i;
+      bool readNext = true;
+      while (readNext) {
+         if (!getNextLine(in, line)) {
+            UTIL_THROW("Missing FINISH command");
+         }
+         std::stringstream inBuffer(line);
+         inBuffer >> command;
+         arguments.clear();
+         std::getline(inBuffer, arguments);
+
+         if (command == "FINISH") {
+            for (i = 0; i < nLocal_; ++i) {
+               activate(i);
+               Log::file() << command << std::endl;
+            }
+            readNext = false;
+         } else
+         if (command == "SIMULATE" || command == "CONTINUE") {
+            bool isContinuation = (command == "CONTINUE");
+            if (isContinuation && replicas_[0]->iStep() == 0) {
+               UTIL_THROW("Attempt to continue when iStep == 0");
+            }
+            int endStep;
+            std::stringstream argBuffer(arguments);
+            argBuffer >> endStep;
+            for (i = 0; i < nLocal_; ++i) {
+               activate(i);
+               Log::file() << command << "  " << endStep << std::endl;
+            }
+            simulate(endStep, isContinuation);
+         } else {
+            for (i = 0; i < nLocal_; ++i) {
+               activate(i);
+               Log::file() << command;
+               std::stringstream argBuffer(arguments);
+               if (!replicas_[i]->readCommand(command, argBuffer)) {
+                  Log::file() << "Error: Unknown command  " << std::endl;
+                  UTIL_THROW("Unknown command");
+               }
+            }
+         }
+      }
+   }
+
+   /*
+   * Advance all replicas in segments that end at replica exchanges.
+   */
+   void McReplicaSet::simulate(int endStep, bool isContinuation)
+   {
+      int i;
+      for (i = 0; i < nLocal_; ++i) {
+         activate(i);
+         replicas_[i]->beginRun(isContinuation);
+      }
+      int beginStep = replicas_[0]->iStep();
+
+      // An exchange follows each step with index a multiple of interval
+      long interval = 0;
+      McSystem& system = replicas_[0]->system();
+      if (system.hasReplicaMove()) {
+         interval = system.replicaMove().interval();
+      }
+
+      Simp::TaskGroup group(replicas_[0]->threadPool());
+      Timer timer;
+      timer.start();
+      int iStep = beginStep;
+      int nextStep;
+      long exchangeStep;
+      bool isExchange;
+      while (iStep < endStep) {
+         nextStep = endStep;
+         isExchange = false;
+         if (interval > 0) {
+            exchangeStep = ((iStep + interval - 1)/interval)*interval;
+            if (exchangeStep < endStep) {
+               nextStep = exchangeStep + 1;
+               isExchange = true;
+            }
+         }
+         activate(0);
+         for (i = 0; i < nLocal_; ++i) {
+            runners_[i].endStep = nextStep;
+            runners_[i].valuesPtr =
+                  isExchange ? &values_[2*nParameter_*i] : 0;
+            group.add(runners_[i]);
+         }
+         group.wait();
+         iStep = nextStep;
+         if (isExchange) {
+            exchange();
+         }
+      }
+      timer.stop();
+      double time = timer.time();
+
+      int nStep = endStep - beginStep;
+      for (i = 0; i < nLocal_; ++i) {
+         activate(i);
+         replicas_[i]->endRun();
+         Log::file() << std::endl;
+         Log::file() << "endStep       " << endStep << std::endl;
+         Log::file() << "nStep         " << nStep << std::endl;
+         Log::file() << "run time      " << time
+                     << " sec (" << nLocal_ << " replicas)" << std::endl;
+         Log::file() << std::endl;
+      }
+      if (interval > 0 && communicatorPtr_->Get_rank() == 0) {
+         activate(0);
+         ReplicaMove& move = replicas_[0]->system().replicaMove();
+         long nAttempt = move.nAttempt();
+         long nAccept = move.nAccept();
+         double ratio = nAttempt == 0 ? 0.0 : double(nAccept)/double(nAttempt);
+         Log::file() << "Replica Exchange " << nAttempt << "  "
+                     << nAccept << "  " << ratio << std::endl;
+      }
+   }
+
+   /*
+   * Sample a permutation of states on process 0, and adopt new states.
+   */
+   void McReplicaSet::exchange()
+   {
+      int rank = communicatorPtr_->Get_rank();
+      int nValue = 2*nParameter_;
+      int i, j, k, id;
+
+      // Gather derivatives and parameters of all replicas to process 0
+      std::vector<double> allValues;
+      if (rank == 0) {
+         allValues.resize(nReplica_*nValue);
+      }
+      communicatorPtr_->Gather(&values_[0], nLocal_*nValue, MPI::DOUBLE,
+                               rank == 0 ? &allValues[0] : 0,
+                               nLocal_*nValue, MPI::DOUBLE, 0);
+
+      // Every replica needs the state indices of all replicas
+      for (i = 0; i < nLocal_; ++i) {
+         stateIds_[i] = replicas_[i]->system().replicaMove().stateId();
+      }
+      std::vector<int> allStateIds(nReplica_);
+      communicatorPtr_->Allgather(&stateIds_[0], nLocal_, MPI::INT,
+                                  &allStateIds[0], nLocal_, MPI::INT);
+
+      // On process 0, sample a permutation. Element 2*j of partners is
+      // the replica whose state replica j adopts, and element 2*j + 1 is
+      // the replica that adopts the old state of replica j.
+      std::vector<int> partners;
+      if (rank == 0) {
+         DArray< DArray<double> > allDerivatives;
+         DArray< DArray<double> > allParameters;
+         allDerivatives.allocate(nReplica_);
+         allParameters.allocate(nReplica_);
+         for (j = 0; j < nReplica_; ++j) {
+            allDerivatives[j].allocate(nParameter_);
+            allParameters[j].allocate(nParameter_);
+            for (k = 0; k < nParameter_; ++k) {
+               allDerivatives[j][k] = allValues[j*nValue + k];
+               allParameters[j][k]  = allValues[j*nValue + nParameter_ + k];
+            }
+         }
+         DArray<int> permutation;
+         permutation.allocate(nReplica_);
+         activate(0);
+         replicas_[0]->system().replicaMove()
+                     .samplePermutation(allDerivatives, allParameters,
+                                        permutation);
+         partners.resize(2*nReplica_);
+         for (j = 0; j < nReplica_; ++j) {
+            partners[2*j] = permutation[j];
+            partners[2*permutation[j] + 1] = j;
+         }
+      }
+      std::vector<int> myPartners(2*nLocal_);
+      communicatorPtr_->Scatter(rank == 0 ? &partners[0] : 0,
+                                2*nLocal_, MPI::INT,
+                                &myPartners[0], 2*nLocal_, MPI::INT, 0);
+
+      // Adopt new states
+      sendRecvPair pair;
+      for (i = 0; i < nLocal_; ++i) {
+         id = firstId_ + i;
+         activate(i);
+         McSystem& system = replicas_[i]->system();
+         ReplicaMove& move = system.replicaMove();
+         if (myPartners[2*i] == id) {
+            move.recordState();
+         } else {
+            pair[0] = myPartners[2*i + 1];
+            pair[1] = myPartners[2*i];
+            move.adoptState(allStateIds[myPartners[2*i]], pair);
+            #ifndef SIMP_NOPAIR
+            system.pairPotential().buildCellList();
+            #endif
+            system.unsetTrackedEnergy();
+            system.untrackedMoveSignal().notify();
+         }
+      }
+   }
+
+   /*
+   * Install the Atom arrays and log file of replica i.
+   */
+   void McReplicaSet::activate(int i)
+   {
+      Atom::setContext(contexts_[i]);
+      Log::setFile(*logFiles_[i]);
+   }
+
+   // Runner
+
+   McReplicaSet::Runner::Runner()
+    : simulationPtr(0),
+      contextPtr(0),
+      valuesPtr(0),
+      endStep(0)
+   {}
+
+   /*
+   * Advance one replica, and record values needed for an exchange.
+   */
+   void McReplicaSet::Runner::run()
+   {
+      Atom::setContext(*contextPtr);
+      simulationPtr->advance(endStep);
+      if (valuesPtr) {
+         McSystem& system = simulationPtr->system();
+         system.positionSignal().notify();
+         Perturbation& perturbation = system.perturbation();
+         int n = perturbation.getNParameters();
+         for (int k = 0; k < n; ++k) {
+            valuesPtr[k] = perturbation.derivative(k);
+            valuesPtr[n + k] = perturbation.parameter(k);
+         }
+      }
+   }
+
+}
+#endif
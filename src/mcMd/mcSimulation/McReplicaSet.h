@@ -0,0 +1,235 @@
+#ifdef MCMD_REPLICAS
+#ifndef MCMD_MC_REPLICA_SET_H
+#define MCMD_MC_REPLICA_SET_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/chemistry/Atom.h>           // member (Atom::Context)
+#include <simp/threads/ThreadPool.h>       // TaskGroup::Task base class
+#include <util/global.h>
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   class McSimulation;
+
+   /**
+   * A set of McSimulation replicas of a perturbation run by one process.
+   *
+   * An McReplicaSet runs nLocal replicas of a replicated (perturbation
+   * mode) mcSim simulation within each MPI process, rather than one
+   * replica per process, and advances them concurrently on the threads
+   * of the ThreadPool. With P processes, there are nReplica = nLocal*P
+   * replicas in all, and replica n = rank*nLocal + i is the i-th replica
+   * of process rank. Replica n is assigned the n-th set of parameters of
+   * the Perturbation, and reads and writes all files in directory "n/",
+   * exactly as processor n of an mcSim run with option -f. The parameter
+   * and command files are read by every replica from the working
+   * directory.
+   *
+   * Each replica is a complete McSimulation. The static arrays of Atom
+   * data are thread local (see Atom::Context), and each thread installs
+   * the arrays of a replica before advancing it. Replicas share only the
+   * code, the OpenMP runtime and the log stream. Threaded kernels that
+   * are called within a replica run serially on the thread of that
+   * replica.
+   *
+   * If the parameter file has a ReplicaMove, with swapParameters = 1,
+   * all replicas are advanced to the end of each step at which a replica
+   * exchange is due, and a permutation of states is then sampled by the
+   * Gibbs sampler of ReplicaMove on replica 0 of process 0. Derivatives
+   * and parameters are gathered to process 0 with one MPI_Gather, and
+   * partners scattered with one MPI_Scatter, so MPI is used only across
+   * processes. Every replica then adopts the parameters of its new
+   * state. Exchange of configurations (swapParameters = 0) is not
+   * supported.
+   *
+   * Usage in a main program:
+   * \code
+   * McMd::McReplicaSet replicas(MPI::COMM_WORLD);
+   * if (replicas.setOptions(argc, argv)) {
+   *    replicas.readParam();
+   *    replicas.readCommands();
+   * }
+   * \endcode
+   * The option -m nLocal is consumed by setOptions(), which implies -f,
+   * and requires a parameter file name set by option -p, since every
+   * replica reads the parameter file. All other options except -r are
+   * passed to McSimulation::setOptions()
+   * for each replica. The command file is executed by every replica,
+   * except that SIMULATE and CONTINUE commands advance all replicas
+   * together, as described above.
+   *
+   * \ingroup McMd_Simulation_Module
+   */
+   class McReplicaSet
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param communicator communicator for all processes
+      */
+      McReplicaSet(MPI::Intracomm& communicator);
+
+      /**
+      * Destructor.
+      */
+      ~McReplicaSet();
+
+      /**
+      * Read command line options, and return true iff option -m is set.
+      *
+      * \param argc number of arguments
+      * \param argv array of argument strings
+      */
+      bool setOptions(int argc, char** argv);
+
+      /**
+      * Create all replicas of this process, and read the parameter file.
+      */
+      void readParam();
+
+      /**
+      * Read and execute commands from the default command file.
+      */
+      void readCommands();
+
+      /**
+      * Read and execute commands from a command file.
+      *
+      * \param in command file input stream
+      */
+      void readCommands(std::istream& in);
+
+      /**
+      * Advance all replicas, with replica exchange, until endStep.
+      *
+      * Call on all processes.
+      *
+      * \param endStep        final value of step counter of all replicas
+      * \param isContinuation Is this a continuation of a previous run?
+      */
+      void simulate(int endStep, bool isContinuation = false);
+
+      /**
+      * Number of replicas in this process.
+      */
+      int nLocal() const;
+
+      /**
+      * Total number of replicas in all processes.
+      */
+      int nReplica() const;
+
+      /**
+      * Get a replica of this process.
+      *
+      * \param i local index of replica, 0 <= i < nLocal()
+      */
+      McSimulation& replica(int i);
+
+   private:
+
+      /**
+      * Task that advances one replica to the end of a segment.
+      */
+      class Runner : public Simp::TaskGroup::Task
+      {
+      public:
+
+         /// Constructor.
+         Runner();
+
+         /// Install the Atom arrays of the replica, and advance it.
+         virtual void run();
+
+         /// Replica to advance.
+         McSimulation* simulationPtr;
+
+         /// Atom arrays of the replica.
+         const Atom::Context* contextPtr;
+
+         /// Location for derivatives and parameters (null if unused).
+         double* valuesPtr;
+
+         /// Final value of the step counter.
+         int endStep;
+
+      };
+
+      /// Arguments passed to McSimulation::setOptions for each replica.
+      std::vector<char*> args_;
+
+      /// Replicas of this process.
+      std::vector<McSimulation*> replicas_;
+
+      /// Atom arrays of each replica.
+      std::vector<Atom::Context> contexts_;
+
+      /// Log file of each replica.
+      std::vector<std::ofstream*> logFiles_;
+
+      /// Task for each replica.
+      std::vector<Runner> runners_;
+
+      /// Derivatives, then parameters, of each replica.
+      std::vector<double> values_;
+
+      /// Index of the state held by each replica.
+      std::vector<int> stateIds_;
+
+      /// Communicator for all processes.
+      MPI::Intracomm* communicatorPtr_;
+
+      /// Number of replicas in this process.
+      int nLocal_;
+
+      /// Total number of replicas.
+      int nReplica_;
+
+      /// Index of first replica of this process.
+      int firstId_;
+
+      /// Number of perturbation parameters.
+      int nParameter_;
+
+      /**
+      * Install the Atom arrays and log file of replica i.
+      */
+      void activate(int i);
+
+      /**
+      * Sample a permutation of states, and adopt new states.
+      */
+      void exchange();
+
+   };
+
+   // Inline functions
+
+   inline int McReplicaSet::nLocal() const
+   {  return nLocal_; }
+
+   inline int McReplicaSet::nReplica() const
+   {  return nReplica_; }
+
+   inline McSimulation& McReplicaSet::replica(int i)
+   {  return *replicas_[i]; }
+
+}
+#endif
+#endif
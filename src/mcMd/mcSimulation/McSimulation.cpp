@@ -35,8 +35,10 @@
 #endif
 
 #include <simp/species/Species.h>
+#include <simp/commands/CommandLoop.h>
 
 #include <util/param/Factory.h>
+#include <util/ensembles/EnergyEnsemble.h>
 #include <util/archives/Serializable_includes.h>
 #include <util/format/Dbl.h>
 #include <util/format/Int.h>
@@ -50,6 +52,7 @@
 #include <sstream>
 #include <string>
 #include <unistd.h>
+#include <stdlib.h>
 
 namespace McMd
 {
@@ -69,8 +72,10 @@ namespace McMd
       paramFilePtr_(0),
       saveFileName_(),
       saveInterval_(0),
+      energyCheckInterval_(0),
       isInitialized_(false),
-      isRestarting_(false)
+      isRestarting_(false),
+      loopDepth_(0)
    {
       setClassName("McSimulation"); 
 
@@ -99,8 +104,10 @@ namespace McMd
       paramFilePtr_(0),
       saveFileName_(),
       saveInterval_(0),
+      energyCheckInterval_(0),
       isInitialized_(false),
-      isRestarting_(false)
+      isRestarting_(false),
+      loopDepth_(0)
    {
       setClassName("McSimulation"); 
 
@@ -137,6 +144,8 @@ namespace McMd
       bool cFlag = false;  // command file 
       bool iFlag = false;  // input prefix
       bool oFlag = false;  // output prefix
+      bool tFlag = false;  // number of threads
+      bool bFlag = false;  // bind threads to cores
       #ifdef MCMD_PERTURB
       bool  fflag = false;  // free energy perturbation
       #endif
@@ -145,11 +154,13 @@ namespace McMd
       char* cArg = 0;
       char* iArg = 0;
       char* oArg = 0;
+      char* tArg = 0;
    
-      // Read program arguments
+      // Read program arguments (reset optind for repeated calls)
       int c;
       opterr = 0;
-      while ((c = getopt(argc, argv, "er:p:c:i:o:f")) != -1) {
+      optind = 1;
+      while ((c = getopt(argc, argv, "er:p:c:i:o:ft:b")) != -1) {
          switch (c) {
          case 'e':
             eflag = true;
@@ -174,6 +185,13 @@ namespace McMd
             oFlag = true;
             oArg  = optarg;
             break;
+         case 't': // number of threads
+            tFlag = true;
+            tArg  = optarg;
+            break;
+         case 'b': // bind threads to cores
+            bFlag = true;
+            break;
          #ifdef MCMD_PERTURB
          case 'f':
            fflag = true;
@@ -185,6 +203,13 @@ namespace McMd
          }
       }
    
+      // Options -t and -b: Configure the thread pool
+      if (tFlag) {
+         threadPool().setNThread(atoi(tArg));
+      }
+      threadPool().setPinned(bFlag);
+      threadPool().initialize();
+
       // Set flag to echo parameters as they are read.
       if (eflag) {
          Util::ParamComponent::setEcho(true);
@@ -278,6 +303,13 @@ namespace McMd
          read<std::string>(in, "saveFileName", saveFileName_);
       }
 
+      // Interval for recomputing running total energy (optionally)
+      energyCheckInterval_ = 0; // default value
+      readOptional<int>(in, "energyCheckInterval", energyCheckInterval_);
+      if (energyCheckInterval_ < 0) {
+         UTIL_THROW("Negative energyCheckInterval");
+      }
+
       isValid();
       isInitialized_ = true;
    }
@@ -325,6 +357,9 @@ namespace McMd
       if (saveInterval_ > 0) {
          loadParameter<std::string>(ar, "saveFileName", saveFileName_);
       }
+      energyCheckInterval_ = 0;
+      loadParameter<int>(ar, "energyCheckInterval", energyCheckInterval_,
+                         false);
 
       system().loadConfig(ar);
       ar >> iStep_;
@@ -345,6 +380,8 @@ namespace McMd
       if (saveInterval_ > 0) {
          ar << saveFileName_;
       }
+      bool isActive = (energyCheckInterval_ > 0);
+      Parameter::saveOptional(ar, energyCheckInterval_, isActive);
 
       system().saveConfig(ar);
       ar << iStep_;
@@ -444,6 +481,17 @@ namespace McMd
                            << endStep << std::endl;
                simulate(endStep, isRestarting_);
                isRestarting_ = false;
+            } else
+            if (command == "ANALYZE_TRAJECTORY") {
+               std::string classname;
+               int min, max;
+               inBuffer >> min >> max >> classname >> filename;
+               Log::file() << "  " << iStep_ << " to " << max
+                           << " " << Str(classname,15)
+                           << " " << Str(filename, 15)
+                           << std::endl;
+               analyzeTrajectory(min, max, classname, filename);
+               isRestarting_ = false;
             } else {
                UTIL_THROW("Missing RESTART command");
             }
@@ -452,6 +500,19 @@ namespace McMd
 
             if (command == "FINISH") {
                Log::file() << std::endl;
+               if (loopDepth_ > 0) {
+                  UTIL_THROW("FINISH within a LOOP block");
+               }
+               readNext = false;
+            } else
+            if (command == "LOOP") {
+               readLoop(in, inBuffer);
+            } else
+            if (command == "END_LOOP") {
+               Log::file() << std::endl;
+               if (loopDepth_ == 0) {
+                  UTIL_THROW("END_LOOP without matching LOOP");
+               }
                readNext = false;
             } else {
                bool success;
@@ -467,6 +528,41 @@ namespace McMd
    }
 
 
+   /*
+   * Read body of a LOOP block, and execute it once for each value.
+   */
+   void McSimulation::readLoop(std::istream& in, std::istream& header)
+   {
+      Simp::CommandLoop loop;
+      loop.readHeader(header);
+      Log::file() << "  " << loop.name() << std::endl;
+      std::string line;
+      bool readNext = true;
+      while (readNext) {
+         #ifdef UTIL_MPI
+         if (!hasIoCommunicator() || isIoProcessor()) {
+            getNextLine(in, line);
+         }
+         if (hasIoCommunicator()) {
+            bcast<std::string>(communicator(), line, 0);
+         }
+         #else
+         getNextLine(in, line);
+         #endif
+         readNext = loop.addLine(line);
+      }
+
+      ++loopDepth_;
+      for (int i = 0; i < loop.nValue(); ++i) {
+         Log::file() << "LOOP  " << loop.name() << " = "
+                     << loop.value(i) << std::endl;
+         std::stringstream body;
+         loop.writeBody(i, body);
+         readCommands(body);
+      }
+      --loopDepth_;
+   }
+
    bool McSimulation::readCommand(std::string const & command, 
                                   std::istream& in)
    {
@@ -522,6 +618,25 @@ namespace McMd
                      << std::endl;
          analyzeTrajectory(min, max, classname, filename);
       } else 
+      #ifdef UTIL_MPI
+      if (command == "SPLIT_ANALYZE_CONFIGS") {
+         int min, max;
+         in >> min >> max >> filename;
+         Log::file() << "  " <<  min << "  " <<  max
+                     << "  " <<  filename << std::endl;
+         analyzeConfigs(min, max, filename, true);
+      } else
+      if (command == "SPLIT_ANALYZE_TRAJECTORY") {
+         std::string classname;
+         std::string filename;
+         int min, max;
+         in >> min >> max >> classname >> filename;
+         Log::file() << " " << Str(classname,15) 
+                     << " " << Str(filename, 15)
+                     << std::endl;
+         analyzeTrajectory(min, max, classname, filename, true);
+      } else 
+      #endif
       if (command == "WRITE_CONFIG") {
          in >> filename;
          Log::file() << Str(filename, 15) << std::endl;
@@ -592,6 +707,9 @@ namespace McMd
          in >> system().boundary();
          Log::file() << "  " << system().boundary();
          Log::file() << std::endl;
+         #ifdef SIMP_EXTERNAL
+         system().clearExternalEnergyCache();
+         #endif
 
          for (int iSpec=0; iSpec < nSpecies(); ++iSpec) {
             system().begin(iSpec, molIter);
@@ -619,6 +737,15 @@ namespace McMd
          #endif
 
       } else
+      if (command == "SET_TEMPERATURE") {
+         double temperature;
+         in >> temperature;
+         Log::file() << "  " << temperature << std::endl;
+         if (!system().energyEnsemble().isIsothermal()) {
+            UTIL_THROW("SET_TEMPERATURE with non-isothermal ensemble");
+         }
+         system().energyEnsemble().setTemperature(temperature);
+      } else
       #ifndef UTIL_MPI
       #ifndef SIMP_NOPAIR
       if (command == "SET_PAIR") {
@@ -700,41 +827,18 @@ namespace McMd
       if (isContinuation) {
          Log::file() << "Restarting from iStep = " 
                      << iStep_ << std::endl;
-      } else {
-         iStep_ = 0;
-         analyzerManager().setup();
-         mcMoveManagerPtr_->setup();
       }
+      beginRun(isContinuation);
       int beginStep = iStep_;
       int nStep = endStep - beginStep;
       Log::file() << std::endl;
-      system().positionSignal().notify();
 
       // Main Monte Carlo loop
       Timer timer;
       timer.start();
       for ( ; iStep_ < endStep; ++iStep_) {
 
-         // Call analyzers 
-         if (Analyzer::baseInterval != 0) {
-            if (iStep_ % Analyzer::baseInterval == 0) {
-               if (analyzerManager().size() > 0) {
-                  system().positionSignal().notify();
-                  analyzerManager().sample(iStep_);
-                  system().positionSignal().notify();
-               }
-            }
-         }
-
-         // Save restart file
-         if (saveInterval_ != 0) {
-            if (iStep_ % saveInterval_ == 0) {
-               save(saveFileName_);
-            }
-         }
-
-         // Choose and attempt an McMove
-         mcMoveManagerPtr_->chooseMove().move();
+         runStep();
 
          #ifdef UTIL_MPI
          #ifdef MCMD_PERTURB
@@ -744,11 +848,13 @@ namespace McMd
                if (system().replicaMove().isAtInterval(iStep_)) {
                   system().positionSignal().notify();
                   bool success = system().replicaMove().move();
-                  #ifndef SIMP_NOPAIR
                   if (success) {
+                     #ifndef SIMP_NOPAIR
                      system().pairPotential().buildCellList();
+                     #endif
+                     system().unsetTrackedEnergy();
+                     system().untrackedMoveSignal().notify();
                   }
-                  #endif
                }
             }
          }
@@ -759,32 +865,8 @@ namespace McMd
       timer.stop();
       double time = timer.time();
 
-      // Final analyzers 
       assert(iStep_ == endStep);
-      if (Analyzer::baseInterval > 0) {
-         if (iStep_ % Analyzer::baseInterval == 0) {
-            if (analyzerManager().size() != 0) {
-               system().positionSignal().notify();
-               analyzerManager().sample(iStep_);
-               system().positionSignal().notify();
-            }
-         }
-      }
-
-      // Final save to archive
-      if (saveInterval_ != 0) {
-         if (iStep_ % saveInterval_ == 0) {
-            save(saveFileName_);
-         }
-      }
-
-      // Output results of all analyzers to output files
-      if (Analyzer::baseInterval > 0) {
-         analyzerManager().output();
-      }
-
-      // Output results of move statistics to files
-      mcMoveManagerPtr_->output();
+      endRun();
 
       // Output time for the run
       Log::file() << std::endl;
@@ -843,11 +925,113 @@ namespace McMd
 
    }
 
+   /*
+   * Initialize the step counter, analyzers and moves for a run.
+   */
+   void McSimulation::beginRun(bool isContinuation)
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("McSimulation not initialized");
+      }
+      if (!isContinuation) {
+         iStep_ = 0;
+         analyzerManager().setup();
+         mcMoveManagerPtr_->setup();
+      }
+      system().positionSignal().notify();
+      system().unsetTrackedEnergy();
+   }
+
+   /*
+   * Execute MC steps until iStep_ == endStep.
+   */
+   void McSimulation::advance(int endStep)
+   {
+      for ( ; iStep_ < endStep; ++iStep_) {
+         runStep();
+      }
+   }
+
+   /*
+   * Execute one step of the main loop: analyzers, restart, one move.
+   */
+   void McSimulation::runStep()
+   {
+      // Call analyzers
+      if (Analyzer::baseInterval != 0) {
+         if (iStep_ % Analyzer::baseInterval == 0) {
+            if (analyzerManager().size() > 0) {
+               system().positionSignal().notify();
+               analyzerManager().sample(iStep_);
+               system().positionSignal().notify();
+            }
+         }
+      }
+
+      // Save restart file
+      if (saveInterval_ != 0) {
+         if (iStep_ % saveInterval_ == 0) {
+            save(saveFileName_);
+         }
+      }
+
+      // Choose and attempt an McMove
+      McMove& mcMove = mcMoveManagerPtr_->chooseMove();
+      if (mcMove.move()) {
+         if (energyCheckInterval_ == 0 || !mcMove.reportsEnergyChange()) {
+            system().unsetTrackedEnergy();
+         }
+         if (!mcMove.reportsAtomMoves()) {
+            system().untrackedMoveSignal().notify();
+         }
+      }
+
+      // Periodically discard running total energy, to prevent drift
+      if (energyCheckInterval_ > 0) {
+         if ((iStep_ + 1) % energyCheckInterval_ == 0) {
+            system().unsetTrackedEnergy();
+         }
+      }
+   }
+
+   /*
+   * Final sample, restart file and output files at the end of a run.
+   */
+   void McSimulation::endRun()
+   {
+      // Final analyzers
+      if (Analyzer::baseInterval > 0) {
+         if (iStep_ % Analyzer::baseInterval == 0) {
+            if (analyzerManager().size() != 0) {
+               system().positionSignal().notify();
+               analyzerManager().sample(iStep_);
+               system().positionSignal().notify();
+            }
+         }
+      }
+
+      // Final save to archive
+      if (saveInterval_ != 0) {
+         if (iStep_ % saveInterval_ == 0) {
+            save(saveFileName_);
+         }
+      }
+
+      // Output results of all analyzers to output files
+      if (Analyzer::baseInterval > 0) {
+         analyzerManager().output();
+      }
+
+      // Output results of move statistics to files
+      mcMoveManagerPtr_->output();
+   }
+
    /*
    * Read and analyze a sequence of configuration files.
    */
    void 
-   McSimulation::analyzeConfigs(int min, int max, std::string basename)
+   McSimulation::analyzeConfigs(int min, int max, std::string basename,
+                                bool splitFrames)
    {
       // Preconditions
       UTIL_CHECK(min > 0);
@@ -861,12 +1045,26 @@ namespace McMd
       std::stringstream indexString;
       std::ifstream     configFile;
       int               nConfig;
-      nConfig = max - min + 1;
+      int               begin = min;
+      int               end = max;
+
+      // Range of configurations analyzed by this processor
+      #ifdef UTIL_MPI
+      if (splitFrames) {
+         splitRange(min, max, begin, end);
+      }
+      #else
+      UTIL_CHECK(!splitFrames);
+      #endif
+      nConfig = end - begin + 1;
 
       // Main loop
       Log::file() << "begin main loop" << std::endl;
       timer.start();
-      for (iStep_ = min; iStep_ <= max; ++iStep_) {
+      if (begin > end) {
+         analyzerManager().setup();
+      }
+      for (iStep_ = begin; iStep_ <= end; ++iStep_) {
 
          indexString << iStep_;
          filename = basename;
@@ -884,12 +1082,14 @@ namespace McMd
          system().pairPotential().buildCellList();
          #endif
 
+         system().untrackedMoveSignal().notify();
+
          #ifdef UTIL_DEBUG
          isValid();
          #endif
 
          // Initialize analyzers (taking in molecular information).
-         if (iStep_ == min) analyzerManager().setup();
+         if (iStep_ == begin) analyzerManager().setup();
 
          // Sample property values
          analyzerManager().sample(iStep_);
@@ -902,7 +1102,7 @@ namespace McMd
       Log::file() << "end main loop" << std::endl;
 
       // Output results of all analyzers to output files
-      analyzerManager().output();
+      outputAnalyzers(splitFrames);
 
       // Output time
       Log::file() << std::endl;
@@ -921,7 +1121,8 @@ namespace McMd
    */
    void McSimulation::analyzeTrajectory(int min, int max, 
                                         std::string classname, 
-                                        std::string filename)
+                                        std::string filename,
+                                        bool splitFrames)
    {
       // Preconditions
       if (min < 0) UTIL_THROW("min < 0");
@@ -941,36 +1142,87 @@ namespace McMd
       Log::file() << "Reading " << filename << std::endl;
       trajectoryReaderPtr->open(filename);
 
+      // Range of frames analyzed by this processor
+      int begin = min;
+      int end = max;
+
+      // A restarted analysis resumes at the frame recorded by save()
+      bool isContinuation = isRestarting_;
+      if (isContinuation) {
+         UTIL_CHECK(!splitFrames);
+         if (iStep_ < min || iStep_ > max + 1) {
+            UTIL_THROW("Restart frame is outside the range min to max");
+         }
+         begin = iStep_;
+      }
+      #ifdef UTIL_MPI
+      if (splitFrames) {
+         int nFrame = trajectoryReaderPtr->nFrame();
+         if (nFrame > 0 && nFrame - 1 < max) {
+            splitRange(min, nFrame - 1, begin, end);
+         } else {
+            splitRange(min, max, begin, end);
+         }
+         if (begin > end) {
+            analyzerManager().setup();
+         }
+      }
+      #else
+      UTIL_CHECK(!splitFrames);
+      #endif
+
       // Main loop over trajectory frames
       Timer timer;
       Log::file() << "Begin main loop" << std::endl;
       bool hasFrame = true;
       timer.start();
-      for (iStep_ = 0; iStep_ <= max && hasFrame; ++iStep_) {
+
+      // Skip directly to frame begin, if the format has a frame index
+      iStep_ = 0;
+      if (begin > 0 && trajectoryReaderPtr->nFrame() > begin) {
+         trajectoryReaderPtr->seekFrame(begin);
+         iStep_ = begin;
+      }
+      for ( ; iStep_ <= end && hasFrame; ++iStep_) {
          hasFrame = trajectoryReaderPtr->readFrame();
          if (hasFrame) {
             #ifndef SIMP_NOPAIR
             // Build the system PairList
             system().pairPotential().buildCellList();
             #endif
+            #ifdef SIMP_EXTERNAL
+            system().clearExternalEnergyCache();
+            #endif
+            system().unsetTrackedEnergy();
+            system().untrackedMoveSignal().notify();
             #ifdef UTIL_DEBUG
             isValid();
             #endif
             // Initialize analyzers (taking in molecular information).
-            if (iStep_ == min) analyzerManager().setup();
-            // Sample property values only for iStep >= min
-            if (iStep_ >= min) analyzerManager().sample(iStep_);
+            if (iStep_ == begin && !isContinuation) {
+               analyzerManager().setup();
+            }
+            // Sample property values only for iStep >= begin
+            if (iStep_ >= begin) analyzerManager().sample(iStep_);
+            // Checkpoint, recording the index of the next frame
+            if (saveInterval_ > 0 && !splitFrames) {
+               if ((iStep_ + 1) % saveInterval_ == 0 && iStep_ < end) {
+                  ++iStep_;
+                  save(saveFileName_);
+                  --iStep_;
+               }
+            }
          }
       }
       timer.stop();
       Log::file() << "end main loop" << std::endl;
-      int nFrames = iStep_ - min;
+      int nFrames = (iStep_ > begin) ? iStep_ - begin : 0;
 
       trajectoryReaderPtr->close();
       delete trajectoryReaderPtr;
 
       // Output results of all analyzers to output files
-      analyzerManager().output();
+      outputAnalyzers(splitFrames);
 
       // Output time 
       Log::file() << std::endl;
@@ -982,6 +1234,40 @@ namespace McMd
       Log::file() << std::endl;
    }
 
+   #ifdef UTIL_MPI
+   /*
+   * Divide frames min <= i <= max into contiguous blocks, one per processor.
+   */
+   void McSimulation::splitRange(int min, int max, int& begin, int& end)
+   {
+      if (!analyzerManager().isMergeable()) {
+         UTIL_THROW("Frames can only be split among mergeable analyzers");
+      }
+      int nProc = communicator().Get_size();
+      int rank = communicator().Get_rank();
+      int n = max - min + 1;
+      if (n < 0) n = 0;
+      begin = min + (rank*n)/nProc;
+      end = min + ((rank + 1)*n)/nProc - 1;
+   }
+   #endif
+
+   /*
+   * Output analyzer results, after merging them if frames were split.
+   */
+   void McSimulation::outputAnalyzers(bool splitFrames)
+   {
+      #ifdef UTIL_MPI
+      if (splitFrames) {
+         analyzerManager().merge(communicator(), 0);
+         if (communicator().Get_rank() != 0) {
+            return;
+         }
+      }
+      #endif
+      analyzerManager().output();
+   }
+
    /*
    * Get the McMove factory.
    */
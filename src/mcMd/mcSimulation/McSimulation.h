@@ -66,6 +66,11 @@ namespace McMd
       *
       *   -r filename. Restart a simulation.
       *
+      *   -t nThread. Set the number of threads (if compiled with
+      *       MCMD_OPENMP). By default, the OpenMP default is used.
+      *
+      *   -b  Bind (pin) each thread to one core.
+      *
       * When restarting a simulation, the required parameter "filename"
       * is the base name for the 3 required input files: filename.prm, 
       * filename.rst, and filename.cmd.
@@ -191,6 +196,35 @@ namespace McMd
       */
       void simulate(int endStep, bool isContinuation = false);
 
+      /**
+      * Prepare for a run that is executed in segments by advance().
+      *
+      * If isContinuation is false, sets iStep_ to zero and calls the
+      * setup functions of analyzers and moves, as done by simulate().
+      * Writes nothing to the log file.
+      *
+      * \param isContinuation Is this a continuation of a previous run?
+      */
+      void beginRun(bool isContinuation);
+
+      /**
+      * Execute steps of a run begun by beginRun(), until iStep == endStep.
+      *
+      * Each step is identical to a step of simulate(), except that no
+      * replica exchange move is attempted (see McReplicaSet).
+      *
+      * \param endStep value of step counter at which to stop
+      */
+      void advance(int endStep);
+
+      /**
+      * Finish a run begun by beginRun().
+      *
+      * Samples analyzers and writes a restart file if iStep is at the
+      * corresponding interval, and writes analyzer and move outputs.
+      */
+      void endRun();
+
       /**
       * Read and analyze a sequence of configuration files.
       *
@@ -212,22 +246,42 @@ namespace McMd
       * processor are in this directory, but no inputPrefix is added after
       * the string "m/".
       *
+      * If splitFrames is true (parallel mode only), the range min <= n <= max
+      * is instead divided into contiguous blocks, one per processor, the 
+      * accumulators of all processors are merged by Analyzer::merge(), and
+      * results are output only by processor 0. This requires that every
+      * Analyzer be mergeable, and that every processor read the same files.
+      *
       * \param min  integer suffix of first configuration file name
       * \param max  integer suffix of last configuration file name
       * \param basename  root name for dump files (without integer suffix)
+      * \param splitFrames  divide configurations among processors?
       */  
-      void analyzeConfigs(int min, int max, std::string basename);
+      void analyzeConfigs(int min, int max, std::string basename,
+                          bool splitFrames = false);
 
       /**
       * Read and analyze a trajectory file.
       * 
+      * If splitFrames is true (parallel mode only), frames are divided 
+      * among processors as described for analyzeConfigs(). Each processor
+      * seeks directly to its first frame if the format has a frame index.
+      *
+      * If saveInterval > 0 and frames are not split, a restart file that
+      * records the index of the next frame is written after each frame
+      * i for which i + 1 is a multiple of saveInterval. In a simulation
+      * restarted from such a file, this function resumes the analysis
+      * at that frame, with the restored state of all analyzers.
+      *
       * \param min  start at this frame number
       * \param max  end at this frame number
       * \param classname  name of the TrajectoryReader class to use
       * \param filename  name of the trajectory file
+      * \param splitFrames  divide frames among processors?
       */
       void analyzeTrajectory(int min, int max, 
-                             std::string classname, std::string filename);
+                             std::string classname, std::string filename,
+                             bool splitFrames = false);
 
       //@}
       /// \name Miscellaneous
@@ -282,12 +336,59 @@ namespace McMd
       /// Interval for writing restart files (no output if 0)
       int saveInterval_;
 
+      /**
+      * Interval for recomputing the running total of the energy.
+      *
+      * If positive, McSystem::trackedPotentialEnergy() is updated by
+      * moves that report energy changes, and is recomputed from 
+      * scratch every energyCheckInterval_ steps. If zero (default), 
+      * the running total is discarded after every accepted move.
+      */
+      int energyCheckInterval_;
+
       /// Has readParam been called?
       bool isInitialized_;
 
       /// Is this McSimulation in the process of restarting?
       bool isRestarting_;
 
+      /// Depth of LOOP blocks of the command script being executed.
+      int loopDepth_;
+
+      /**
+      * Read the body of a LOOP block and execute it for each value.
+      *
+      * \param in     command file
+      * \param header rest of the LOOP command line
+      */
+      void readLoop(std::istream& in, std::istream& header);
+
+      /**
+      * Execute one step of the main loop, without replica exchange.
+      */
+      void runStep();
+
+      #ifdef UTIL_MPI
+      /**
+      * Get the block of frames min <= i <= max for this processor.
+      *
+      * Throws an Exception if any analyzer is not mergeable.
+      *
+      * \param min   first frame of the full range
+      * \param max   last frame of the full range
+      * \param begin first frame for this processor (out)
+      * \param end   last frame for this processor (out)
+      */
+      void splitRange(int min, int max, int& begin, int& end);
+      #endif
+
+      /**
+      * Output results of all analyzers, merging them if frames were split.
+      *
+      * \param splitFrames were frames divided among processors?
+      */
+      void outputAnalyzers(bool splitFrames);
+
    }; 
 
    // Inline Methods
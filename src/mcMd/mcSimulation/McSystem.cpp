@@ -26,6 +26,11 @@
 #ifdef SIMP_DIHEDRAL
 #include <mcMd/potentials/dihedral/DihedralPotential.h>
 #endif
+#ifdef SIMP_COULOMB
+#include <mcMd/potentials/coulomb/McCoulombPotential.h>
+#include <mcMd/potentials/coulomb/CoulombFactory.h>
+#include <mcMd/chemistry/AtomType.h>
+#endif
 #ifdef MCMD_LINK
 #include <mcMd/links/LinkMaster.h>
 #endif
@@ -79,11 +84,15 @@ namespace McMd
       #ifdef SIMP_DIHEDRAL
       , dihedralPotentialPtr_(0)
       #endif
+      #ifdef SIMP_COULOMB
+      , coulombPotentialPtr_(0)
+      #endif
       #ifdef MCMD_LINK
       , linkPotentialPtr_(0)
       #endif
       #ifdef SIMP_EXTERNAL
       , externalPotentialPtr_(0)
+      , externalEnergyCache_()
       #endif
       #ifdef SIMP_TETHER
       , tetherPotentialPtr_(0)
@@ -114,6 +123,9 @@ namespace McMd
       #ifdef SIMP_DIHEDRAL
       if (dihedralPotentialPtr_) delete dihedralPotentialPtr_;
       #endif
+      #ifdef SIMP_COULOMB
+      if (coulombPotentialPtr_) delete coulombPotentialPtr_;
+      #endif
       #ifdef MCMD_LINK
       if (linkPotentialPtr_) delete linkPotentialPtr_;
       #endif
@@ -137,6 +149,14 @@ namespace McMd
       readFileMaster(in);
       readPotentialStyles(in);
 
+      #ifdef SIMP_COULOMB
+      assert(coulombPotentialPtr_ == 0);
+      if (simulation().hasCoulomb()) {
+         createCoulombPotential();
+         readParamComposite(in, *coulombPotentialPtr_);
+      }
+      #endif
+
       #ifndef SIMP_NOPAIR
       assert(pairPotentialPtr_ == 0);
       pairPotentialPtr_ = pairFactory().mcFactory(pairStyle(), *this);
@@ -146,6 +166,12 @@ namespace McMd
       readParamComposite(in, *pairPotentialPtr_);
       #endif
 
+      #ifdef SIMP_COULOMB
+      if (coulombPotentialPtr_) {
+         checkCoulombCutoff();
+      }
+      #endif
+
       #ifdef SIMP_BOND
       assert(bondPotentialPtr_ == 0);
       if (simulation().nBondType() > 0) {
@@ -200,6 +226,7 @@ namespace McMd
             UTIL_THROW("Failed attempt to create ExternalPotential");
          }
          readParamComposite(in, *externalPotentialPtr_);
+         externalEnergyCache_.allocate(Atom::capacity());
       }
       #endif
 
@@ -234,6 +261,14 @@ namespace McMd
       loadFileMaster(ar);
       loadPotentialStyles(ar);
 
+      #ifdef SIMP_COULOMB
+      assert(coulombPotentialPtr_ == 0);
+      if (simulation().hasCoulomb()) {
+         createCoulombPotential();
+         loadParamComposite(ar, *coulombPotentialPtr_);
+      }
+      #endif
+
       #ifndef SIMP_NOPAIR
       pairPotentialPtr_ = pairFactory().mcFactory(pairStyle(), *this);
       if (pairPotentialPtr_ == 0) {
@@ -242,6 +277,12 @@ namespace McMd
       loadParamComposite(ar, *pairPotentialPtr_);
       #endif
 
+      #ifdef SIMP_COULOMB
+      if (coulombPotentialPtr_) {
+         checkCoulombCutoff();
+      }
+      #endif
+
       #ifdef SIMP_BOND
       assert(bondPotentialPtr_ == 0);
       if (simulation().nBondType() > 0) {
@@ -296,6 +337,7 @@ namespace McMd
             UTIL_THROW("Failed attempt to create ExternalPotential");
          }
          loadParamComposite(ar, *externalPotentialPtr_);
+         externalEnergyCache_.allocate(Atom::capacity());
       }
       #endif
 
@@ -328,6 +370,11 @@ namespace McMd
    {
       saveFileMaster(ar);
       savePotentialStyles(ar);
+      #ifdef SIMP_COULOMB
+      if (simulation().hasCoulomb()) {
+         coulombPotential().save(ar);
+      }
+      #endif
       #ifndef SIMP_NOPAIR 
       pairPotential().save(ar); 
       #endif
@@ -390,6 +437,15 @@ namespace McMd
       #ifndef SIMP_NOPAIR
       pairPotential().buildCellList();
       #endif
+      #ifdef SIMP_EXTERNAL
+      clearExternalEnergyCache();
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+         coulombPotential().unsetWaves();
+      }
+      #endif
+      unsetTrackedEnergy();
    }
 
    /* 
@@ -401,6 +457,15 @@ namespace McMd
       #ifndef SIMP_NOPAIR
       pairPotential().buildCellList();
       #endif
+      #ifdef SIMP_EXTERNAL
+      clearExternalEnergyCache();
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+         coulombPotential().unsetWaves();
+      }
+      #endif
+      unsetTrackedEnergy();
    }
 
    /*
@@ -438,6 +503,9 @@ namespace McMd
       #ifndef SIMP_NOPAIR
       pairPotential().buildCellList();
       #endif
+      #ifdef SIMP_EXTERNAL
+      clearExternalEnergyCache();
+      #endif
 
       #ifdef UTIL_DEBUG
       isValid();
@@ -456,6 +524,65 @@ namespace McMd
       #ifndef SIMP_NOPAIR
       energy += pairPotential().atomEnergy(atom);
       #endif
+      #ifdef SIMP_EXTERNAL
+      if (hasExternalPotential()) {
+         energy += atomExternalEnergy(atom);
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+         energy += atomRSpaceCoulombEnergy(atom, atom.position());
+         energy += coulombPotential().kspaceAtomEnergy(atom);
+      }
+      #endif
+      energy += atomBondedEnergy(atom);
+      return energy;
+   }
+
+   /*
+   * Return total potential energy for one Atom at a trial position.
+   */
+   double
+   McSystem::atomPotentialEnergy(Atom &atom, const Vector& position) const
+   {
+      double energy = 0.0;
+      #ifndef SIMP_NOPAIR
+      energy += pairPotential().trialEnergy(atom, position);
+      #endif
+      #ifdef SIMP_EXTERNAL
+      if (hasExternalPotential()) {
+         energy += atomExternalEnergy(atom, position);
+      }
+      #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+         // K-space energy at position = energy at atom.position()
+         // plus the change produced by moving the atom to position.
+         McCoulombPotential& coulomb = coulombPotential();
+         energy += atomRSpaceCoulombEnergy(atom, position);
+         energy += coulomb.kspaceAtomEnergy(atom);
+         coulomb.clearTrial();
+         coulomb.addTrialMove(atom, position);
+         energy += coulomb.trialEnergyChange();
+         coulomb.clearTrial();
+      }
+      #endif
+
+      // Bonded energies are evaluated with the atom temporarily moved
+      Vector oldPosition = atom.position();
+      atom.position() = position;
+      energy += atomBondedEnergy(atom);
+      atom.position() = oldPosition;
+
+      return energy;
+   }
+
+   /*
+   * Return energies of one Atom that depend on positions of partners.
+   */
+   double McSystem::atomBondedEnergy(const Atom &atom) const
+   {
+      double energy = 0.0;
       #ifdef SIMP_BOND
       if (hasBondPotential()) {
          energy += bondPotential().atomEnergy(atom);
@@ -476,11 +603,6 @@ namespace McMd
          energy += linkPotential().atomEnergy(atom);
       }
       #endif
-      #ifdef SIMP_EXTERNAL
-      if (hasExternalPotential()) {
-         energy += externalPotential().atomEnergy(atom);
-      }
-      #endif
       #ifdef SIMP_TETHER
       if (tetherPotentialPtr_) {
          if (tetherMaster().isTethered(atom)) {
@@ -530,9 +652,42 @@ namespace McMd
          energy += tetherPotential().energy();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+         energy += rSpaceCoulombEnergy();
+         energy += coulombPotential().kSpaceEnergy();
+      }
+      #endif
       return energy;
    }
 
+   /*
+   * Return running total of potential energy, compute if necessary.
+   */
+   double McSystem::trackedPotentialEnergy()
+   {
+      if (!trackedEnergy_.isSet()) {
+         trackedEnergy_.set(potentialEnergy());
+      }
+      return trackedEnergy_.value();
+   }
+
+   /*
+   * Add an energy change to the running total, if known.
+   */
+   void McSystem::incrementTrackedEnergy(double dE)
+   {
+      if (trackedEnergy_.isSet()) {
+         trackedEnergy_.set(trackedEnergy_.value() + dE);
+      }
+   }
+
+   /*
+   * Mark running total of potential energy as unknown.
+   */
+   void McSystem::unsetTrackedEnergy()
+   {  trackedEnergy_.unset(); }
+
    /*
    * Unset all precomputed potential energy components.
    */
@@ -556,8 +711,127 @@ namespace McMd
           dihedralPotential().unsetEnergy();
       }
       #endif
+      #ifdef SIMP_COULOMB
+      if (hasCoulombPotential()) {
+          coulombPotential().unsetEnergy();
+      }
+      #endif
+   }
+
+   #ifdef SIMP_COULOMB
+   // -------------------------------------------------------------
+   // Coulomb potential
+
+   /*
+   * Create the McCoulombPotential, and add observers (private).
+   */
+   void McSystem::createCoulombPotential()
+   {
+      MdCoulombPotential* ptr = coulombFactory().factory(coulombStyle());
+      if (ptr == 0) {
+         UTIL_THROW("Failed attempt to create CoulombPotential");
+      }
+      coulombPotentialPtr_ = dynamic_cast<McCoulombPotential*>(ptr);
+      if (coulombPotentialPtr_ == 0) {
+         delete ptr;
+         UTIL_THROW("coulombStyle does not support MC moves");
+      }
+      atomMoveSignal().addObserver(*this, &McSystem::moveCoulombCharge);
+      untrackedMoveSignal().addObserver(*this, &McSystem::unsetCoulombWaves);
+   }
+
+   /*
+   * Check that the real space cutoff is within the pair cutoff (private).
+   *
+   * Real space Coulomb energies are evaluated with the pair cell list.
+   */
+   void McSystem::checkCoulombCutoff() const
+   {
+      #ifndef SIMP_NOPAIR
+      double rSpaceCutoff = coulombPotential().ewaldInteraction().rSpaceCutoff();
+      if (rSpaceCutoff > pairPotential().maxPairCutoff()) {
+         UTIL_THROW("Ewald rSpaceCutoff exceeds maximum pair cutoff");
+      }
+      #else
+      UTIL_THROW("MC Coulomb potential requires a pair potential");
+      #endif
+   }
+
+   /*
+   * Return real space Coulomb energy of one Atom at a position.
+   */
+   double McSystem::atomRSpaceCoulombEnergy(const Atom& atom,
+                                            const Vector& position) const
+   {
+      double charge = simulation().atomType(atom.typeId()).charge();
+      if (charge == 0.0) return 0.0;
+
+      EwaldInteraction& ewald = coulombPotential().ewaldInteraction();
+      const CellList& cellList = pairPotential().cellList();
+      const Cell* cellPtr;
+      const Atom* jAtomPtr;
+      double energy = 0.0;
+      double cutoffSq = ewald.rSpaceCutoffSq();
+      double rsq, qProduct;
+      int jc, jp;
+      int id = atom.id();
+      int ic = cellList.cellIndexFromPosition(position);
+      int nNeighborCell = cellList.nNeighborCell();
+      for (jc = 0; jc < nNeighborCell; ++jc) {
+         cellPtr = &cellList.neighborCell(ic, jc);
+         for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+            jAtomPtr = cellPtr->atomPtr(jp);
+            if (jAtomPtr == 0) continue;
+            if (jAtomPtr->id() == id) continue;
+            rsq = boundary().distanceSq(position, jAtomPtr->position());
+            if (rsq < cutoffSq) {
+               if (!atom.mask().isMasked(*jAtomPtr)) {
+                  qProduct = charge
+                           *simulation().atomType(jAtomPtr->typeId()).charge();
+                  if (qProduct != 0.0) {
+                     energy += ewald.rSpaceEnergy(rsq, qProduct);
+                  }
+               }
+            }
+         }
+      }
+      return energy;
    }
 
+   /*
+   * Return total real space Coulomb energy (private).
+   */
+   double McSystem::rSpaceCoulombEnergy() const
+   {
+      System::ConstMoleculeIterator molIter;
+      Molecule::ConstAtomIterator atomIter;
+      double energy = 0.0;
+      for (int iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               energy += atomRSpaceCoulombEnergy(*atomIter,
+                                                 atomIter->position());
+            }
+         }
+      }
+      // Each pair is counted twice
+      return 0.5*energy;
+   }
+
+   /*
+   * Update Coulomb Fourier modes for a reported atom move (private).
+   */
+   void McSystem::moveCoulombCharge(const Atom& atom,
+                                    const Vector& oldPosition)
+   {  coulombPotential().moveCharge(atom, oldPosition); }
+
+   /*
+   * Discard Coulomb waves and modes after an untracked move (private).
+   */
+   void McSystem::unsetCoulombWaves()
+   {  coulombPotential().unsetWaves(); }
+   #endif
+
    // -------------------------------------------------------------
    // Pressure/Stress Evaluators (including all components)
 
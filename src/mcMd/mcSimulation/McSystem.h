@@ -11,6 +11,10 @@
 #include <mcMd/simulation/System.h>     // base class
 #include <mcMd/neighbor/CellList.h>     // member
 #include <util/signal/Signal.h>         // members
+#include <util/misc/Setable.h>          // member
+#ifdef SIMP_EXTERNAL
+#include <mcMd/potentials/external/ExternalEnergyCache.h>  // member
+#endif
 #include <util/global.h>
 
 namespace McMd
@@ -32,7 +36,7 @@ namespace McMd
    class DihedralPotential;
    #endif
    #ifdef SIMP_COULOMB
-   class CoulombPotential;
+   class McCoulombPotential;
    #endif
    #ifdef SIMP_EXTERNAL
    class ExternalPotential;
@@ -141,11 +145,52 @@ namespace McMd
       */
       double atomPotentialEnergy(const Atom& atom) const;
 
+      /**
+      * Calculate the total potential energy for one Atom at a trial position.
+      *
+      * Returns the value atomPotentialEnergy(atom) would return if the atom
+      * were at the specified position. The pair and external energies are
+      * evaluated at position without modifying the atom or the cell list.
+      * Bond, angle, dihedral, link and tether energies are evaluated with
+      * atom.position() temporarily set to position, and the original
+      * position is restored before returning. The cell list thus only
+      * needs to be updated if the move is accepted.
+      *
+      * \param  atom     Atom object of interest
+      * \param  position trial position, in the primary cell
+      * \return potential energy of atom at position
+      */
+      double atomPotentialEnergy(Atom& atom, const Vector& position) const;
+
       /**
       * Return total potential energy of this System.
       */
       double potentialEnergy() const;
 
+      /**
+      * Return running total of the potential energy of this System.
+      *
+      * If the running total is unknown (unset), this function calls
+      * potentialEnergy() and stores the result before returning it.
+      * The stored value is then updated by incrementTrackedEnergy()
+      * until it is cleared by unsetTrackedEnergy().
+      */
+      double trackedPotentialEnergy();
+
+      /**
+      * Add the change in energy of an accepted move to the running total.
+      *
+      * Does nothing if the running total is unknown.
+      *
+      * \param dE change in total potential energy
+      */
+      void incrementTrackedEnergy(double dE);
+
+      /**
+      * Mark the running total of the potential energy as unknown.
+      */
+      void unsetTrackedEnergy();
+
       /**
       * Compute total virial stress (excludes kinetic contribution).
       *
@@ -241,9 +286,24 @@ namespace McMd
       bool hasCoulombPotential() const;
 
       /**
-      * Return CoulombPotential by reference.
+      * Return McCoulombPotential by reference.
       */
-      CoulombPotential& coulombPotential() const;
+      McCoulombPotential& coulombPotential() const;
+
+      /**
+      * Return the real space Coulomb energy of an Atom at a position.
+      *
+      * Sums the Ewald real space interactions of a charge of the type
+      * of atom, at the specified position, with all other unmasked atoms
+      * in the cell list. The atom itself is excluded. As for the trial
+      * pair energy, neither the atom nor the cell list is modified.
+      *
+      * \param  atom     Atom object of interest
+      * \param  position position at which to evaluate the energy
+      * \return real space Coulomb energy
+      */
+      double atomRSpaceCoulombEnergy(const Atom& atom,
+                                     const Vector& position) const;
       #endif
 
       #ifdef MCMD_LINK
@@ -268,6 +328,49 @@ namespace McMd
       * Return ExternalPotential by reference.
       */
       ExternalPotential& externalPotential() const;
+
+      /**
+      * Return the external energy of an Atom, using a per-atom cache.
+      *
+      * Equivalent to externalPotential().atomEnergy(atom), but returns
+      * a cached value if the energy was computed or stored for the same
+      * position and type (see ExternalEnergyCache).
+      *
+      * \param atom Atom object of interest
+      */
+      double atomExternalEnergy(const Atom& atom) const;
+
+      /**
+      * Return the cached external energy of an Atom at a trial position.
+      *
+      * \param atom     Atom object of interest
+      * \param position trial position
+      */
+      double atomExternalEnergy(const Atom& atom, const Vector& position)
+      const;
+
+      /**
+      * Store a known external energy of an Atom at a position.
+      *
+      * For use by moves that compute energies of many trial positions
+      * with ExternalPotential::trialEnergies(), for the chosen position.
+      *
+      * \param atom     Atom object of interest
+      * \param position position of atom
+      * \param energy   external energy at position
+      */
+      void storeExternalEnergy(const Atom& atom, const Vector& position,
+                               double energy) const;
+
+      /**
+      * Discard all cached external energies.
+      *
+      * Call whenever parameters of the external potential or the
+      * boundary change. Called by readConfig(), loadConfig() and
+      * generateMolecules(), and by McSimulation for DEFORM_CELL and
+      * trajectory frames.
+      */
+      void clearExternalEnergyCache();
       #endif
 
       #ifdef SIMP_TETHER
@@ -286,6 +389,26 @@ namespace McMd
       */
       Signal<>& positionSignal();
 
+      /**
+      * Signal to report an accepted change in the position of one atom.
+      *
+      * The arguments are the atom, which holds its new position, and
+      * its old position. This is notified for every atom moved by an
+      * accepted move of an McMove for which McMove::reportsAtomMoves()
+      * returns true.
+      */
+      Signal<Atom, Vector>& atomMoveSignal();
+
+      /**
+      * Signal to indicate changes in positions not reported individually.
+      *
+      * This is notified after each accepted move of an McMove that does
+      * not report atom moves, and after each configuration is read for
+      * analysis. Observers of atomMoveSignal() must then discard any
+      * incrementally updated quantities.
+      */
+      Signal<>& untrackedMoveSignal();
+
       /**
       * Return true if McSystem is valid, or throw Exception.
       */
@@ -335,8 +458,8 @@ namespace McMd
       #endif
 
       #ifdef SIMP_COULOMB
-      /// Pointer to a CoulombPotential. 
-      CoulombPotential* coulombPotentialPtr_;
+      /// Pointer to a McCoulombPotential.
+      McCoulombPotential* coulombPotentialPtr_;
       #endif
 
       #ifdef MCMD_LINK
@@ -347,6 +470,9 @@ namespace McMd
       #ifdef SIMP_EXTERNAL
       /// Pointer to an ExternalPotential.
       ExternalPotential* externalPotentialPtr_;
+
+      /// Cache of external energies of atoms.
+      mutable ExternalEnergyCache externalEnergyCache_;
       #endif
 
       #ifdef SIMP_TETHER
@@ -354,9 +480,56 @@ namespace McMd
       TetherPotential* tetherPotentialPtr_;
       #endif
 
+      /// Running total of potential energy, see trackedPotentialEnergy().
+      Setable<double> trackedEnergy_;
+
       /// Signal to indicate change in atomic positions.
       Signal<>  positionSignal_;
 
+      /// Signal to report a move of one atom, see atomMoveSignal().
+      Signal<Atom, Vector>  atomMoveSignal_;
+
+      /// Signal to indicate unreported moves, see untrackedMoveSignal().
+      Signal<>  untrackedMoveSignal_;
+
+      /**
+      * Calculate bond, angle, dihedral, link and tether energies of an Atom.
+      *
+      * \param  atom Atom object of interest
+      * \return sum of energies that depend on positions of partner atoms
+      */
+      double atomBondedEnergy(const Atom& atom) const;
+
+      #ifdef SIMP_COULOMB
+      /**
+      * Create the McCoulombPotential, and observe atom move signals.
+      */
+      void createCoulombPotential();
+
+      /**
+      * Check that the real space cutoff is within the pair cutoff.
+      */
+      void checkCoulombCutoff() const;
+
+      /**
+      * Return the total real space Coulomb energy.
+      */
+      double rSpaceCoulombEnergy() const;
+
+      /**
+      * Update Coulomb Fourier modes for a reported atom move.
+      *
+      * \param atom        Atom that was moved (at its new position)
+      * \param oldPosition position before the move
+      */
+      void moveCoulombCharge(const Atom& atom, const Vector& oldPosition);
+
+      /**
+      * Discard Coulomb waves and Fourier modes after untracked moves.
+      */
+      void unsetCoulombWaves();
+      #endif
+
       /*
       * Implementations of the explicit specializations of the public
       * stress calculators computeStress(T& ) etc. for T = double,
@@ -451,7 +624,7 @@ namespace McMd
    /*
    * Return Coulomb potential by reference.
    */
-   inline CoulombPotential& McSystem::coulombPotential() const
+   inline McCoulombPotential& McSystem::coulombPotential() const
    {  
       assert(coulombPotentialPtr_);  
       return *coulombPotentialPtr_; 
@@ -473,6 +646,38 @@ namespace McMd
       assert(externalPotentialPtr_);  
       return *externalPotentialPtr_; 
    }
+
+   /*
+   * Return cached external energy of an atom.
+   */
+   inline double McSystem::atomExternalEnergy(const Atom& atom) const
+   {
+      return externalEnergyCache_.energy(externalPotential(), atom,
+                                         atom.position());
+   }
+
+   /*
+   * Return cached external energy of an atom at a trial position.
+   */
+   inline
+   double McSystem::atomExternalEnergy(const Atom& atom,
+                                       const Vector& position) const
+   {  return externalEnergyCache_.energy(externalPotential(), atom, position); }
+
+   /*
+   * Store external energy of an atom at a position.
+   */
+   inline
+   void McSystem::storeExternalEnergy(const Atom& atom,
+                                      const Vector& position,
+                                      double energy) const
+   {  externalEnergyCache_.store(atom, position, energy); }
+
+   /*
+   * Discard all cached external energies.
+   */
+   inline void McSystem::clearExternalEnergyCache()
+   {  externalEnergyCache_.clear(); }
    #endif
 
    #ifdef MCMD_LINK
@@ -517,5 +722,17 @@ namespace McMd
    inline Signal<>& McSystem::positionSignal()
    { return positionSignal_; }
 
+   /*
+   * Signal to report a move of one atom.
+   */
+   inline Signal<Atom, Vector>& McSystem::atomMoveSignal()
+   { return atomMoveSignal_; }
+
+   /*
+   * Signal to indicate moves that are not reported by atomMoveSignal.
+   */
+   inline Signal<>& McSystem::untrackedMoveSignal()
+   { return untrackedMoveSignal_; }
+
 }
 #endif
@@ -1,6 +1,7 @@
 
 mcMd_mcSimulation_=\
     mcMd/mcSimulation/McAnalyzerManager.cpp \
+    mcMd/mcSimulation/McReplicaSet.cpp \
     mcMd/mcSimulation/McSimulation.cpp \
     mcMd/mcSimulation/McSystem.cpp \
     mcMd/mcSimulation/McSystemInterface.cpp 
@@ -122,6 +122,23 @@ namespace McMd
             }
          }
       }
+      #elif defined(MCMD_OPENMP)
+      int   iMol, nMol;
+      for (iSpecies=0; iSpecies < nSpecies; ++iSpecies) {
+         nMol = system().nMolecule(iSpecies);
+         #pragma omp parallel for schedule(static) private(dv, dr, prefactor)
+         for (iMol = 0; iMol < nMol; ++iMol) {
+            Molecule& molecule = system().molecule(iSpecies, iMol);
+            for (int ia = 0; ia < molecule.nAtom(); ++ia) {
+               Atom* atomPtr = &molecule.atom(ia);
+               prefactor = prefactors_[atomPtr->typeId()];
+               dv.multiply(atomPtr->force(), prefactor);
+               atomPtr->velocity() += dv;
+               dr.multiply(atomPtr->velocity(), dt_);
+               atomPtr->position() += dr;
+            }
+         }
+      }
       #else 
       Atom* atomPtr;
       int   ia;
@@ -165,6 +182,20 @@ namespace McMd
             }
          }
       }
+      #elif defined(MCMD_OPENMP)
+      for (iSpecies=0; iSpecies < nSpecies; ++iSpecies) {
+         nMol = system().nMolecule(iSpecies);
+         #pragma omp parallel for schedule(static) private(dv, prefactor)
+         for (iMol = 0; iMol < nMol; ++iMol) {
+            Molecule& molecule = system().molecule(iSpecies, iMol);
+            for (int ia = 0; ia < molecule.nAtom(); ++ia) {
+               Atom* atomPtr = &molecule.atom(ia);
+               prefactor = prefactors_[atomPtr->typeId()];
+               dv.multiply(atomPtr->force(), prefactor);
+               atomPtr->velocity() += dv;
+            }
+         }
+      }
       #else
       for (iSpecies=0; iSpecies < nSpecies; ++iSpecies) {
          system().begin(iSpecies, molIter); 
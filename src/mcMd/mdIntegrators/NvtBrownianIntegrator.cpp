@@ -0,0 +1,168 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "NvtBrownianIntegrator.h"
+#include <mcMd/mdSimulation/MdSystem.h>
+#include <mcMd/simulation/Simulation.h>
+#include <mcMd/potentials/pair/MdPairPotential.h>
+#include <util/ensembles/EnergyEnsemble.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/archives/Serializable_includes.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   NvtBrownianIntegrator::NvtBrownianIntegrator(MdSystem& system)
+   : MdIntegrator(system),
+     prefactors_(),
+     cr_(),
+     random_(),
+     gamma_(0.0),
+     seed_(-1),
+     nStep_(0)
+   {  setClassName("NvtBrownianIntegrator"); }
+
+   /*
+   * Destructor.
+   */
+   NvtBrownianIntegrator::~NvtBrownianIntegrator()
+   {}
+
+   /*
+   * Read parameters, allocate arrays.
+   */
+   void NvtBrownianIntegrator::readParameters(std::istream &in)
+   {
+      read<double>(in, "dt", dt_);
+      read<double>(in, "gamma", gamma_);
+      readOptional<int>(in, "seed", seed_);
+      if (seed_ < 0) {
+         seed_ = int(simulation().random().uniform()*2147483647.0);
+      }
+      random_.setSeed(seed_);
+      nStep_ = 0;
+
+      int nAtomType = simulation().nAtomType();
+      prefactors_.allocate(nAtomType);
+      cr_.allocate(nAtomType);
+   }
+
+   /*
+   * Load the internal state to an archive.
+   */
+   void NvtBrownianIntegrator::loadParameters(Serializable::IArchive& ar)
+   {
+      loadParameter<double>(ar, "dt", dt_);
+      loadParameter<double>(ar, "gamma", gamma_);
+      ar & seed_;
+      ar & nStep_;
+      random_.setSeed(seed_);
+
+      int nAtomType = simulation().nAtomType();
+      prefactors_.allocate(nAtomType);
+      cr_.allocate(nAtomType);
+   }
+
+   /*
+   * Save the internal state to an archive.
+   */
+   void NvtBrownianIntegrator::save(Serializable::OArchive& ar)
+   {
+      ar & dt_;
+      ar & gamma_;
+      ar & seed_;
+      ar & nStep_;
+   }
+
+   /*
+   * Initialize constants.
+   */
+   void NvtBrownianIntegrator::setup()
+   {
+      const EnergyEnsemble& energyEnsemble = system().energyEnsemble();
+      if (!energyEnsemble.isIsothermal()) {
+         UTIL_THROW("Energy ensemble is not isothermal");
+      }
+      if (gamma_ <= 0.0) {
+         UTIL_THROW("Relaxation rate gamma must be positive");
+      }
+      double temp = energyEnsemble.temperature();
+
+      // Loop over atom types
+      double friction;
+      int nAtomType = prefactors_.capacity();
+      for (int i = 0; i < nAtomType; ++i) {
+         friction = gamma_*simulation().atomType(i).mass();
+         prefactors_[i] = dt_/friction;
+         cr_[i] = sqrt(2.0*temp*dt_/friction);
+      }
+      system().positionSignal().notify();
+
+   }
+
+   /*
+   * Brownian dynamics step
+   *
+   * This method implements the Euler-Maruyama algorithm:
+   *
+   *        x(n+1) = x(n) + f(n)*dt/(m*gamma) + sqrt(2*kT*dt/(m*gamma))*xi
+   *
+   *        calculate force f(n+1)
+   *
+   * where x is position, f is force and xi is a Gaussian random vector.
+   */
+   void NvtBrownianIntegrator::step()
+   {
+      Vector dr;
+      double g[4];
+      double cr;
+      System::MoleculeIterator molIter;
+      Atom* atomPtr;
+      int iSpecies, nSpecies, typeId, ia, j;
+
+      nSpecies = simulation().nSpecies();
+      for (iSpecies=0; iSpecies < nSpecies; ++iSpecies) {
+         system().begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            for (ia=0; ia < molIter->nAtom(); ++ia) {
+               atomPtr = &molIter->atom(ia);
+               typeId = atomPtr->typeId();
+
+               // Drift and random displacement
+               dr.multiply(atomPtr->force(), prefactors_[typeId]);
+               cr = cr_[typeId];
+               random_.gaussian(atomPtr->id(), nStep_, 0, 0, g);
+               for (j = 0; j < Dimension; ++j) {
+                  dr[j] += cr*g[j];
+               }
+               atomPtr->position() += dr;
+            }
+         }
+      }
+      ++nStep_;
+      system().positionSignal().notify();
+
+      #ifndef SIMP_NOPAIR
+      if (!system().pairPotential().isPairListCurrent()) {
+         system().pairPotential().buildPairList();
+      }
+      #endif
+
+      // Calculate forces for the next step
+      system().calculateForces();
+
+   }
+
+}
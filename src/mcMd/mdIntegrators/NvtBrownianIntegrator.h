@@ -0,0 +1,114 @@
+#ifndef MCMD_NVT_BROWNIAN_INTEGRATOR_H
+#define MCMD_NVT_BROWNIAN_INTEGRATOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/mdIntegrators/MdIntegrator.h>
+#include <util/containers/DArray.h>
+#include <simp/random/CounterRandom.h>
+
+#include <iostream>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * A Brownian (overdamped Langevin) dynamics integrator.
+   *
+   * This class integrates the overdamped Langevin equation
+   * \f[
+   *    m\gamma\frac{d{\bf r}}{dt}  
+   *    = -\frac{\partial U}{\partial {\bf r}} + {\bf f}^{\rm (r)} ,
+   * \f]
+   * in which \f$\gamma\f$ is a relaxation rate, so that m gamma is the
+   * friction coefficient, by an Euler-Maruyama scheme. Each step moves
+   * each atom by dt*f/(m gamma), plus a Gaussian random displacement
+   * with variance 2 kT dt/(m gamma) along each axis. Velocities are 
+   * neither used nor changed.
+   *
+   * Random displacements are generated by a counter-based generator 
+   * keyed by the seed, the atom id and a step counter.
+   *
+   * \sa \ref mcMd_integrator_NvtBrownianIntegrator_page "parameter file format"
+   *
+   * \ingroup McMd_MdIntegrator_Module
+   */
+   class NvtBrownianIntegrator : public MdIntegrator
+   {
+   
+   public:
+
+      /**
+      * Constructor. 
+      *
+      * \param system parent MdSystem
+      */
+      NvtBrownianIntegrator(MdSystem& system);
+
+      /**
+      * Destructor.   
+      */
+      virtual ~NvtBrownianIntegrator();
+
+      /**
+      * Read dt, gamma and, optionally, a random number seed.
+      *
+      * \param in input file stream.
+      */
+      virtual void readParameters(std::istream &in);
+
+      /**
+      * Load the internal state to an archive.
+      *
+      * \param ar archive object.
+      */
+      virtual void loadParameters(Serializable::IArchive& ar);
+
+      /**
+      * Save the internal state to an archive.
+      *
+      * \param ar archive object.
+      */
+      virtual void save(Serializable::OArchive& ar);
+
+      /**
+      * Setup private variables before main loop.
+      */
+      virtual void setup();
+
+      /**
+      * Take a complete Brownian dynamics step.
+      */
+      virtual void step();
+
+   private:
+
+      /// Mobility factors dt/(m*gamma) for different atom types.
+      DArray<double> prefactors_;
+
+      /// Standard deviations sqrt(2*kT*dt/(m*gamma)) of random steps.
+      DArray<double> cr_;
+
+      /// Counter-based generator for random displacements.
+      Simp::CounterRandom random_;
+
+      /// Relaxation rate, friction/mass.
+      double gamma_;
+
+      /// Random number seed (optional parameter, or chosen at random).
+      int seed_;
+
+      /// Number of steps taken, used as a counter of random_.
+      int nStep_;
+
+   };
+
+} 
+#endif
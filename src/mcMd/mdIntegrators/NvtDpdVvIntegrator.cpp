@@ -17,6 +17,9 @@
 #include <mcMd/chemistry/Atom.h>
 #include <util/archives/Serializable_includes.h>
 #include <util/space/Vector.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 #define MCMD_DPD_TYPE 0
 
@@ -41,9 +44,16 @@ namespace McMd
      #endif
      boundaryPtr_(&system.boundary()),
      randomPtr_(&system.simulation().random()),
+     random_(),
      energyEnsemblePtr_(&system.energyEnsemble()),
      atomCapacity_(system.simulation().atomCapacity()),
+     seed_(-1),
+     nRandom_(0),
      isInitialized_(false)
+     #ifdef MCMD_OPENMP
+     , threadForces_(),
+     nThread_(0)
+     #endif
    {
       // Note: Within the constructor, the method parameter "system" 
       // hides the MdIntegrator::system() method name.
@@ -81,6 +91,12 @@ namespace McMd
       }
       #endif
       read<double>(in, "gamma", gamma_);
+      readOptional<int>(in, "seed", seed_);
+      if (seed_ < 0) {
+         seed_ = int(randomPtr_->uniform()*2147483647.0);
+      }
+      random_.setSeed(seed_);
+      nRandom_ = 0;
 
       // Allocate arrays for internal use
       dissipativeForces_.allocate(atomCapacity_);
@@ -115,6 +131,9 @@ namespace McMd
       ar & dtMinvFactors_;
       ar & dissipativeForces_;
       ar & randomForces_;
+      ar & seed_;
+      ar & nRandom_;
+      random_.setSeed(seed_);
 
       isInitialized_ = true;
    }
@@ -134,6 +153,8 @@ namespace McMd
       ar & dtMinvFactors_;
       ar & dissipativeForces_;
       ar & randomForces_;
+      ar & seed_;
+      ar & nRandom_;
    }
 
    /* 
@@ -166,6 +187,55 @@ namespace McMd
       computeDpdForces(true);
    }
 
+   /*
+   * Compute dissipative and (optionally) random forces of one pair.
+   */
+   inline
+   bool NvtDpdVvIntegrator::pairForces(const Atom& atom0, const Atom& atom1,
+                                       bool computeRandom,
+                                       Vector& fd, Vector& fr) const
+   {
+      Vector e;    // unit vector (r0 - r1)/|r0 - r1|;
+      Vector dv;   // difference in velocities v0 - v1;
+      double rsq;  // square of distance between atoms.
+      double r;    // distance between atoms.
+      double wr;   // weighting function for random forces.
+      double g[4]; // gaussian random numbers
+      int id0, id1;
+
+      rsq = boundaryPtr_->distanceSq(atom0.position(), atom1.position(), e);
+      if (rsq >= cutoffSq_) return false;
+      r = sqrt(rsq);
+      e /= r;
+
+      #if MCMD_DPD_TYPE == 0
+      wr  = 1.0;
+      #endif
+      #if MCMD_DPD_TYPE == 1
+      wr  = 1.0 - (r/cutoff_);
+      #endif
+      #if MCMD_DPD_TYPE == 2
+      wr  = 1.0 - rsq/cutoffSq_;
+      #endif
+
+      // Random force, keyed by the unordered pair of atom ids.
+      if (computeRandom) {
+         id0 = atom0.id();
+         id1 = atom1.id();
+         if (id0 < id1) {
+            random_.gaussian(id0, id1, nRandom_, 0, g);
+         } else {
+            random_.gaussian(id1, id0, nRandom_, 0, g);
+         }
+         fr.multiply(e, sigma_*wr*g[0]);
+      }
+
+      // Dissipative force
+      dv.subtract(atom0.velocity(), atom1.velocity());
+      fd.multiply(e, -gamma_*wr*wr*dv.dot(e));
+      return true;
+   }
+
    /*
    * Compute new dissipative and (optionally) random forces.
    *
@@ -175,18 +245,71 @@ namespace McMd
    */
    void NvtDpdVvIntegrator::computeDpdForces(bool computeRandom)
    {
-      Vector e;   // unit vector (r0 - r1)/|r0 - r1|;
-      Vector f;   // force vector 
-      Vector dv;  // difference in velocities v0 - v1;
-      double rsq; // square of distance between atoms.
-      double r;   // distance between atoms.
-      double fr;  // magnitude of random pair force.
-      double fd;  // magnitude of dissipative pair force.
-      double wr;  // weighting function for random forces.
+      #ifdef MCMD_OPENMP
+      if (!threadForces_.isAllocated()) {
+         nThread_ = omp_get_max_threads();
+         threadForces_.allocate(2*nThread_*atomCapacity_);
+      } else
+      if (omp_get_max_threads() > nThread_) {
+         UTIL_THROW("Number of threads increased after first DPD step");
+      }
+
+      // Divide primary atoms among threads, with per-thread forces
+      const int nAtom1 = pairListPtr_->nAtom1();
+      #pragma omp parallel
+      {
+         Vector fd, fr;
+         Atom*  atom0Ptr;
+         Atom*  atom1Ptr;
+         int    i, j, t, begin, end, id0, id1;
+         int    nThread = omp_get_num_threads();
+         Vector* forces = &threadForces_[2*omp_get_thread_num()*atomCapacity_];
+
+         for (i = 0; i < 2*atomCapacity_; ++i) {
+            forces[i].zero();
+         }
+
+         #pragma omp for schedule(dynamic, 64)
+         for (i = 0; i < nAtom1; ++i) {
+            pairListPtr_->getPrimary(i, atom0Ptr, begin, end);
+            id0 = atom0Ptr->id();
+            for (j = begin; j < end; ++j) {
+               atom1Ptr = pairListPtr_->neighborPtr(j);
+               if (pairForces(*atom0Ptr, *atom1Ptr, computeRandom, fd, fr)) {
+                  id1 = atom1Ptr->id();
+                  forces[2*id0] += fd;
+                  forces[2*id1] -= fd;
+                  if (computeRandom) {
+                     forces[2*id0 + 1] += fr;
+                     forces[2*id1 + 1] -= fr;
+                  }
+               }
+            }
+         }
+
+         // Sum thread forces, in thread order (implicit barrier above)
+         #pragma omp for schedule(static)
+         for (i = 0; i < atomCapacity_; ++i) {
+            dissipativeForces_[i].zero();
+            if (computeRandom) {
+               randomForces_[i].zero();
+            }
+            for (t = 0; t < nThread; ++t) {
+               const Vector* g = &threadForces_[2*(t*atomCapacity_ + i)];
+               dissipativeForces_[i] += g[0];
+               if (computeRandom) {
+                  randomForces_[i] += g[1];
+               }
+            }
+         }
+      }
+      #else
+      Vector fd;  // dissipative force on atom 0
+      Vector fr;  // random force on atom 0
       Atom* atom0Ptr;
       Atom* atom1Ptr;
       PairIterator iter;
-      int i;
+      int i, id0, id1;
 
       // Set all dissipative forces to zero.
       for (i=0; i < atomCapacity_; ++i) {
@@ -201,39 +324,21 @@ namespace McMd
       // Iterator over atom pairs
       for (pairListPtr_->begin(iter); iter.notEnd(); ++iter) {
          iter.getPair(atom0Ptr, atom1Ptr);
-         rsq = boundaryPtr_->distanceSq(atom0Ptr->position(), 
-                                        atom1Ptr->position(), e);
-         if (rsq < cutoffSq_) {
-            r = sqrt(rsq);
-            e /= r;
-
-            #if MCMD_DPD_TYPE == 0
-            wr  = 1.0;
-            #endif
-            #if MCMD_DPD_TYPE == 1
-            wr  = 1.0 - (r/cutoff_);
-            #endif
-            #if MCMD_DPD_TYPE == 2
-            wr  = 1.0 - rsq/cutoffSq_;
-            #endif
-           
-            // Add random forces to atomic vectors.
+         if (pairForces(*atom0Ptr, *atom1Ptr, computeRandom, fd, fr)) {
+            id0 = atom0Ptr->id();
+            id1 = atom1Ptr->id();
+            dissipativeForces_[id0] += fd;
+            dissipativeForces_[id1] -= fd;
             if (computeRandom) {
-               fr  = sigma_*wr*randomPtr_->gaussian();
-               f.multiply(e, fr);
-               randomForces_[atom0Ptr->id()] += f;
-               randomForces_[atom1Ptr->id()] -= f;
+               randomForces_[id0] += fr;
+               randomForces_[id1] -= fr;
             }
-
-            // Add dissipative forces to array
-            dv.subtract(atom0Ptr->velocity(), atom1Ptr->velocity());
-            fd = -gamma_*wr*wr*dv.dot(e);
-            f.multiply(e, fd);
-            dissipativeForces_[atom0Ptr->id()] += f;
-            dissipativeForces_[atom1Ptr->id()] -= f;
-
          }
+      }
+      #endif
 
+      if (computeRandom) {
+         ++nRandom_;
       }
       system().positionSignal().notify();
       system().velocitySignal().notify();
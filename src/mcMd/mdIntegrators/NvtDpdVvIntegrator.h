@@ -11,6 +11,7 @@
 #include <mcMd/mdIntegrators/MdIntegrator.h>
 #include <util/containers/DArray.h>
 #include <util/space/Vector.h>
+#include <simp/random/CounterRandom.h>
 
 #include <iostream>
 
@@ -25,6 +26,7 @@ namespace McMd
 
    using namespace Util;
 
+   class Atom;
    class PairList;
 
    /**
@@ -33,6 +35,13 @@ namespace McMd
    * This class implements a simple velocity-Verlet (VV) algorithm for
    * the dissipitative particle dynamics (DPD) equations of motion.
    *
+   * Random pair forces are generated by a counter-based generator keyed
+   * by the ids of both atoms and a count of random force evaluations,
+   * so that they do not depend on the order of the pair list. If the
+   * program is compiled with MCMD_OPENMP defined, the primary atoms of
+   * the pair list are divided among threads, which accumulate forces in
+   * private arrays that are then summed in thread order.
+   *
    * \ingroup McMd_MdIntegrator_Module
    */
    class NvtDpdVvIntegrator : public MdIntegrator
@@ -117,18 +126,50 @@ namespace McMd
       /// Pointer to boundary object.
       const Boundary* boundaryPtr_;
 
-      /// Pointer to random object.
+      /// Pointer to random object, used to choose a default seed.
       Random* randomPtr_;
 
+      /// Counter-based generator for random pair forces.
+      Simp::CounterRandom random_;
+
       /// Pointer to random object.
       const EnergyEnsemble* energyEnsemblePtr_;
 
       /// Atom capacity of parent simulation.
       int atomCapacity_;
 
+      /// Random number seed (optional parameter).
+      int seed_;
+
+      /// Number of evaluations of random forces (counter for random_).
+      int nRandom_;
+
       /// Has this object been initialized?
       bool isInitialized_;
 
+      #ifdef MCMD_OPENMP
+      /// Per-thread dissipative and random forces, element 2*(t*cap + id) + k.
+      DArray<Vector> threadForces_;
+
+      /// Number of threads for which threadForces_ is allocated.
+      int nThread_;
+      #endif
+
+      /*
+      * Compute dissipative and (optionally) random forces of one pair.
+      *
+      * Returns true if the pair is within the DPD cutoff, and false
+      * otherwise, in which case fd and fr are not set.
+      *
+      * \param atom0         first atom
+      * \param atom1         second atom
+      * \param computeRandom If true, compute random force fr
+      * \param fd            dissipative force on atom0 (output)
+      * \param fr            random force on atom0 (output)
+      */
+      bool pairForces(const Atom& atom0, const Atom& atom1,
+                      bool computeRandom, Vector& fd, Vector& fr) const;
+
       /*
       * Calculate random and dissipative DPD forces.
       *
@@ -28,10 +28,11 @@ namespace McMd
     : MdIntegrator(system),
       T_target_(1.0),
       T_kinetic_(1.0),
-      xi_(0.0),
-      xiDot_(0.0),
+      xi_(),
+      xiDot_(),
       tauT_(1.0),
       nuT_(1.0),
+      chainLength_(1),
       energyEnsemblePtr_(0)
    {
       // Note: Within the constructor, the method parameter "system" hides 
@@ -62,11 +63,15 @@ namespace McMd
    {
       read<double>(in, "dt",   dt_);
       read<double>(in, "tauT", tauT_);
+      chainLength_ = 1;
+      readOptional<int>(in, "chainLength", chainLength_);
+      if (chainLength_ < 1) {
+         UTIL_THROW("chainLength < 1");
+      }
       nuT_ = 1.0/tauT_;
       T_target_  = energyEnsemblePtr_->temperature();
       T_kinetic_ = T_target_;
-      xiDot_ = 0.0;
-      xi_    = 0.0;
+      allocateChain();
 
       int nAtomType = simulation().nAtomType();
       if (!prefactors_.isAllocated()) {
@@ -82,6 +87,12 @@ namespace McMd
    {  
       loadParameter<double>(ar, "dt",   dt_);
       loadParameter<double>(ar, "tauT", tauT_);
+      chainLength_ = 1;
+      loadParameter<int>(ar, "chainLength", chainLength_, false);
+      if (chainLength_ < 1) {
+         UTIL_THROW("chainLength < 1");
+      }
+      allocateChain();
       ar & nuT_;
       ar & T_target_;
       ar & T_kinetic_;
@@ -97,6 +108,7 @@ namespace McMd
    {
       ar & dt_;
       ar & tauT_;
+      Parameter::saveOptional(ar, chainLength_, (chainLength_ > 1));
       ar & nuT_;
       ar & T_target_;
       ar & T_kinetic_;
@@ -113,8 +125,10 @@ namespace McMd
 
       T_kinetic_ = system().kineticEnergy()*2.0/double(3*nAtom);
       T_target_ = energyEnsemblePtr_->temperature();
-      xiDot_ = (T_kinetic_/T_target_ -1.0)*nuT_*nuT_;
-      xi_ = 0.0;
+      for (int k = 0; k < chainLength_; ++k) {
+         xi_[k] = 0.0;
+      }
+      computeXiDot(nAtom);
 
       dtHalf = 0.5*dt_;
       for (int i = 0; i < nAtomType; ++i) {
@@ -141,14 +155,15 @@ namespace McMd
       double  prefactor;
       double  factor;
       Molecule::AtomIterator atomIter;
-      int  iSpecies, nSpecies;
+      double  kinetic;
+      int  iSpecies, nSpecies, typeId, k;
       int  nAtom;
 
       T_target_ = energyEnsemblePtr_->temperature();
       nSpecies  = simulation().nSpecies();
       nAtom     = system().nAtom();
 
-      factor = exp(-dtHalf*(xi_ + xiDot_*dtHalf));
+      factor = exp(-dtHalf*(xi_[0] + xiDot_[0]*dtHalf));
 
       // 1st half velocity Verlet, loop over atoms 
       for (iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
@@ -177,7 +192,9 @@ namespace McMd
       system().velocitySignal().notify();
 
       // First half of update of xi_
-      xi_ += xiDot_*dtHalf;
+      for (k = 0; k < chainLength_; ++k) {
+         xi_[k] += xiDot_[k]*dtHalf;
+      }
 
       #ifndef SIMP_NOPAIR
       // Rebuild the pair list if necessary
@@ -188,25 +205,74 @@ namespace McMd
 
       system().calculateForces();
 
-      // 2nd half velocity Verlet, loop over atoms
+      // 2nd half velocity Verlet, loop over atoms, sum m*v^2
+      kinetic = 0.0;
       for (iSpecies=0; iSpecies < nSpecies; ++iSpecies) {
          system().begin(iSpecies, molIter); 
          for ( ; molIter.notEnd(); ++molIter) {
             for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
-               prefactor = prefactors_[atomIter->typeId()];
+               typeId = atomIter->typeId();
+               prefactor = prefactors_[typeId];
                dv.multiply(atomIter->force(), prefactor);
                atomIter->velocity() += dv;
                atomIter->velocity() *=factor;
+               kinetic += atomIter->velocity().square()*dtHalf/prefactor;
             }
          }
       }
       system().velocitySignal().notify();
 
       // Update xiDot and complete update of xi_
-      T_kinetic_ = system().kineticEnergy()*2.0/double(3*nAtom);
-      xiDot_ = (T_kinetic_/T_target_ -1.0)*nuT_*nuT_;
-      xi_ += xiDot_*dtHalf;
+      T_kinetic_ = kinetic/double(3*nAtom);
+      computeXiDot(nAtom);
+      for (k = 0; k < chainLength_; ++k) {
+         xi_[k] += xiDot_[k]*dtHalf;
+      }
 
    }
 
+   /*
+   * Allocate chain variables, and set them to zero (private).
+   */
+   void NvtNhIntegrator::allocateChain()
+   {
+      if (xi_.isAllocated()) {
+         if (xi_.capacity() != chainLength_) {
+            xi_.deallocate();
+            xiDot_.deallocate();
+         }
+      }
+      if (!xi_.isAllocated()) {
+         xi_.allocate(chainLength_);
+         xiDot_.allocate(chainLength_);
+      }
+      for (int k = 0; k < chainLength_; ++k) {
+         xi_[k] = 0.0;
+         xiDot_[k] = 0.0;
+      }
+   }
+
+   /*
+   * Compute time derivatives of all chain variables (private).
+   *
+   * With thermostat masses Q_0 = 3N kT/nu^2 and Q_k = kT/nu^2 for k > 0,
+   * the Nose-Hoover chain equations reduce to those below. For a chain
+   * of length 1, xiDot = (T_kinetic/T_target - 1)*nu^2.
+   */
+   void NvtNhIntegrator::computeXiDot(int nAtom)
+   {
+      double nuSq = nuT_*nuT_;
+      int k;
+      xiDot_[0] = (T_kinetic_/T_target_ - 1.0)*nuSq;
+      if (chainLength_ > 1) {
+         xiDot_[1] = double(3*nAtom)*xi_[0]*xi_[0] - nuSq;
+      }
+      for (k = 2; k < chainLength_; ++k) {
+         xiDot_[k] = xi_[k-1]*xi_[k-1] - nuSq;
+      }
+      for (k = 0; k < chainLength_ - 1; ++k) {
+         xiDot_[k] -= xi_[k]*xi_[k+1];
+      }
+   }
+
 }
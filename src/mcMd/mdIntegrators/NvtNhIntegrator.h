@@ -32,6 +32,12 @@ namespace McMd
    * D. Frenkel and B. Smit, "Understanding Molecular Simulation,"  
    * Academic Press, 1996. Chapter 6 (Eqs. 6.1.24 - 6.1.27).
    *
+   * If the optional parameter chainLength M is greater than 1, the
+   * atoms are coupled to the first of a Nose-Hoover chain of M
+   * thermostats (Martyna, Klein and Tuckerman, J. Chem. Phys. 97,
+   * 2635 (1992)). The kinetic energy used to update the thermostat
+   * is accumulated in the second velocity update loop of each step.
+   *
    * \ingroup McMd_MdIntegrator_Module
    */
    class NvtNhIntegrator : public MdIntegrator
@@ -96,11 +102,11 @@ namespace McMd
       /// Current temperature from kinetic energy
       double T_kinetic_;
 
-      /// Nose-Hover thermostat scaling variable.
-      double xi_;
+      /// Nose-Hover thermostat scaling variables, one per chain element.
+      DArray<double> xi_;
 
-      /// Time derivative of xi
-      double xiDot_;
+      /// Time derivatives of xi, one per chain element.
+      DArray<double> xiDot_;
 
       /// Relaxation time for energy fluctuations.
       double tauT_;
@@ -108,9 +114,24 @@ namespace McMd
       /// Relaxation rate for energy fluctuations.
       double nuT_;
 
+      /// Number of thermostats in the Nose-Hoover chain.
+      int chainLength_;
+
       /// Pointer to EnergyEnsemble object.
       EnergyEnsemble* energyEnsemblePtr_;
 
+      /**
+      * Allocate xi_ and xiDot_, and set all elements to zero.
+      */
+      void allocateChain();
+
+      /**
+      * Compute xiDot_ from T_kinetic_ and xi_.
+      *
+      * \param nAtom total number of atoms
+      */
+      void computeXiDot(int nAtom);
+
    }; 
 
 } 
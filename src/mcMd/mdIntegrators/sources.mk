@@ -3,6 +3,7 @@ mcMd_mdIntegrators_=\
     mcMd/mdIntegrators/MdIntegratorFactory.cpp \
     mcMd/mdIntegrators/NveVvIntegrator.cpp \
     mcMd/mdIntegrators/NvtLangevinIntegrator.cpp \
+    mcMd/mdIntegrators/NvtBrownianIntegrator.cpp \
     mcMd/mdIntegrators/NvtDpdVvIntegrator.cpp \
     mcMd/mdIntegrators/NvtNhIntegrator.cpp \
     mcMd/mdIntegrators/NphIntegrator.cpp
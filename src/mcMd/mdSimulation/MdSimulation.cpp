@@ -23,6 +23,8 @@
 #include <mcMd/potentials/dihedral/DihedralPotential.h>
 #endif
 #include <simp/species/Species.h>
+#include <simp/commands/CommandLoop.h>
+#include <util/ensembles/EnergyEnsemble.h>
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 #include <util/format/Str.h>
@@ -34,6 +36,7 @@
 #include <sstream>
 #include <iostream>
 #include <unistd.h>
+#include <stdlib.h>
 
 namespace McMd
 {
@@ -52,7 +55,8 @@ namespace McMd
       saveFileName_(),
       saveInterval_(0),
       isInitialized_(false),
-      isRestarting_(false)
+      isRestarting_(false),
+      loopDepth_(0)
    {
       setClassName("MdSimulation"); 
       system_.setId(0);
@@ -74,7 +78,8 @@ namespace McMd
       saveFileName_(),
       saveInterval_(0),
       isInitialized_(false),
-      isRestarting_(false)
+      isRestarting_(false),
+      loopDepth_(0)
    {
       setClassName("MdSimulation"); 
       system_.setId(0);
@@ -108,6 +113,8 @@ namespace McMd
       bool  cFlag = false;  // command file 
       bool  iFlag = false;  // input prefix
       bool  oFlag = false;  // output prefix
+      bool  tFlag = false;  // number of threads
+      bool  bFlag = false;  // bind threads to cores
       #ifdef MCMD_PERTURB
       bool  fflag = false;  // free energy perturbation
       #endif
@@ -116,11 +123,12 @@ namespace McMd
       char* cArg = 0;
       char* iArg = 0;
       char* oArg = 0;
+      char* tArg = 0;
    
       // Read program arguments
       int c;
       opterr = 0;
-      while ((c = getopt(argc, argv, "er:p:c:i:o:f")) != -1) {
+      while ((c = getopt(argc, argv, "er:p:c:i:o:ft:b")) != -1) {
          switch (c) {
          case 'e':
            eflag = true;
@@ -145,6 +153,13 @@ namespace McMd
            oFlag = true;
            oArg  = optarg;
            break;
+         case 't': // number of threads
+           tFlag = true;
+           tArg  = optarg;
+           break;
+         case 'b': // bind threads to cores
+           bFlag = true;
+           break;
          #ifdef MCMD_PERTURB
          case 'f':
            fflag = true;
@@ -156,6 +171,13 @@ namespace McMd
          }
       }
    
+      // Options -t and -b: Configure the thread pool
+      if (tFlag) {
+         threadPool().setNThread(atoi(tArg));
+      }
+      threadPool().setPinned(bFlag);
+      threadPool().initialize();
+
       // Set flag to echo parameters as they are read.
       if (eflag) {
          Util::ParamComponent::setEcho(true);
@@ -356,6 +378,19 @@ namespace McMd
 
             if (command == "FINISH") {
                Log::file() << std::endl;
+               if (loopDepth_ > 0) {
+                  UTIL_THROW("FINISH within a LOOP block");
+               }
+               readNext = false;
+            } else
+            if (command == "LOOP") {
+               readLoop(in, inBuffer);
+            } else
+            if (command == "END_LOOP") {
+               Log::file() << std::endl;
+               if (loopDepth_ == 0) {
+                  UTIL_THROW("END_LOOP without matching LOOP");
+               }
                readNext = false;
             } else {
                bool success;
@@ -381,6 +416,41 @@ namespace McMd
       readCommands(fileMaster().commandFile()); 
    }
 
+   /*
+   * Read body of a LOOP block, and execute it once for each value.
+   */
+   void MdSimulation::readLoop(std::istream& in, std::istream& header)
+   {
+      Simp::CommandLoop loop;
+      loop.readHeader(header);
+      Log::file() << "  " << loop.name() << std::endl;
+      std::string line;
+      bool readNext = true;
+      while (readNext) {
+         #ifdef UTIL_MPI
+         if (!hasIoCommunicator() || isIoProcessor()) {
+            getNextLine(in, line);
+         }
+         if (hasIoCommunicator()) {
+            bcast<std::string>(communicator(), line, 0);
+         }
+         #else
+         getNextLine(in, line);
+         #endif
+         readNext = loop.addLine(line);
+      }
+
+      ++loopDepth_;
+      for (int i = 0; i < loop.nValue(); ++i) {
+         Log::file() << "LOOP  " << loop.name() << " = "
+                     << loop.value(i) << std::endl;
+         std::stringstream body;
+         loop.writeBody(i, body);
+         readCommands(body);
+      }
+      --loopDepth_;
+   }
+
    bool MdSimulation::readCommand(std::string const & command, 
                                   std::istream& in)
    {
@@ -484,6 +554,15 @@ namespace McMd
 
          system().generateMolecules(capacities, diameters);
       } else
+      if (command == "SET_TEMPERATURE") {
+         double temperature;
+         in >> temperature;
+         Log::file() << "  " << temperature << std::endl;
+         if (!system().energyEnsemble().isIsothermal()) {
+            UTIL_THROW("SET_TEMPERATURE with non-isothermal ensemble");
+         }
+         system().energyEnsemble().setTemperature(temperature);
+      } else
       #ifndef UTIL_MPI
       #ifndef SIMP_NOPAIR
       if (command == "SET_PAIR") {
@@ -589,9 +668,15 @@ namespace McMd
             }
          }
 
-         // Take one MD step with the MdIntegrator
+         // Take one MD step with the MdIntegrator. If analyzers will
+         // sample the next step, compute pair energy with the forces.
+         if (Analyzer::baseInterval > 0) {
+            system().setNeedPairEnergy(
+                     (iStep_ + 1) % Analyzer::baseInterval == 0);
+         }
          system_.mdIntegrator().step();
       }
+      system().setNeedPairEnergy(false);
       timer.stop();
       double time  = timer.time();
       double rstep = double(nStep);
@@ -626,6 +711,9 @@ namespace McMd
       Log::file() << "time / (nStep*nAtom) " 
                   <<  time / (rstep*double(system().nAtom())) 
                   << " sec" << std::endl;
+      Log::file() << "sim. time / day      " 
+                  << 86400.0*rstep*system().mdIntegrator().dt() / time
+                  << std::endl;
       Log::file() << std::endl;
       Log::file() << std::endl;
 
@@ -752,7 +840,14 @@ namespace McMd
       Log::file() << "Begin main loop" << std::endl;
       bool hasFrame = true;
       timer.start();
-      for (iStep_ = 0; iStep_ <= max && hasFrame; ++iStep_) {
+
+      // Skip directly to frame min, if the format has a frame index
+      iStep_ = 0;
+      if (min > 0 && trajectoryReaderPtr->nFrame() > min) {
+         trajectoryReaderPtr->seekFrame(min);
+         iStep_ = min;
+      }
+      for ( ; iStep_ <= max && hasFrame; ++iStep_) {
          hasFrame = trajectoryReaderPtr->readFrame();
          if (hasFrame) {
             #ifndef SIMP_NOPAIR
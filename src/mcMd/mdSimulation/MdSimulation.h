@@ -61,6 +61,11 @@ namespace McMd
       *
       *   -r filename. Restart a simulation.
       *
+      *   -t nThread. Set the number of threads (if compiled with
+      *       MCMD_OPENMP). By default, the OpenMP default is used.
+      *
+      *   -b  Bind (pin) each thread to one core.
+      *
       * When restarting a simulation, the required parameter "filename"
       * is the base name for the 3 required input files: filename.prm, 
       * filename.rst, and filename.cmd.
@@ -258,6 +263,17 @@ namespace McMd
       /// Is this MdSimulation in the process of restarting?
       bool isRestarting_;
 
+      /// Depth of LOOP blocks of the command script being executed.
+      int loopDepth_;
+
+      /**
+      * Read the body of a LOOP block and execute it for each value.
+      *
+      * \param in     command file
+      * \param header rest of the LOOP command line
+      */
+      void readLoop(std::istream& in, std::istream& header);
+
    };
 
    // Inline method definitions
@@ -93,7 +93,8 @@ namespace McMd
       #endif
       mdIntegratorPtr_(0),
       mdIntegratorFactoryPtr_(0),
-      createdMdIntegratorFactory_(false)
+      createdMdIntegratorFactory_(false),
+      needPairEnergy_(false)
    {  
       setClassName("MdSystem"); 
 
@@ -133,7 +134,8 @@ namespace McMd
       #endif
       mdIntegratorPtr_(0),
       mdIntegratorFactoryPtr_(0),
-      createdMdIntegratorFactory_(false)
+      createdMdIntegratorFactory_(false),
+      needPairEnergy_(false)
    {
       setClassName("MdSystem");
 
@@ -163,13 +165,11 @@ namespace McMd
       }
       #endif
       #ifdef SIMP_COULOMB
-      #if 0
       assert(coulombPotentialPtr_ == 0);
       if (system.hasCoulombPotential()) {
          coulombPotentialPtr_ = &system.coulombPotential();
       }
       #endif
-      #endif
       #ifdef SIMP_EXTERNAL
       if (system.hasExternalPotential()) {
          externalPotentialPtr_ = &system.externalPotential();
@@ -797,13 +797,23 @@ namespace McMd
       #ifndef SIMP_NOPAIR
       // This method builds pair list if needed, and shifts atoms if
       // it builds the pair list.
-      pairPotential().addForces();
+      if (needPairEnergy_) {
+         pairPotential().addForcesAndEnergy();
+      } else {
+         pairPotential().addForces();
+      }
       #endif
       #ifdef SIMP_BOND
       if (hasBondPotential()) {
          bondPotential().addForces();
       }
       #endif
+      #ifdef MCMD_LINK
+      // Links are evaluated like bonds, immediately after them
+      if (hasLinkPotential()) {
+         linkPotential().addForces();
+      }
+      #endif
       #ifdef SIMP_ANGLE
       if (hasAnglePotential()) {
          anglePotential().addForces();
@@ -824,11 +834,6 @@ namespace McMd
          externalPotential().addForces();
       }
       #endif
-      #ifdef MCMD_LINK
-      if (hasLinkPotential()) {
-         linkPotential().addForces();
-      }
-      #endif
       #ifdef SIMP_TETHER
       if (tetherPotentialPtr_) {
          tetherPotential().addForces();
@@ -836,6 +841,12 @@ namespace McMd
       #endif
    }
 
+   /*
+   * Set whether calculateForces() also computes the pair energy.
+   */
+   void MdSystem::setNeedPairEnergy(bool needPairEnergy)
+   {  needPairEnergy_ = needPairEnergy; }
+
    /*
    * Calculate and return total potential energy.
    */
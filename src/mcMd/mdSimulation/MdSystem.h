@@ -167,9 +167,23 @@ namespace McMd
       * list if necessary before calculating pair forces. On exit,
       * all atomic forces are updated to values corresponding to
       * current positions.
+      *
+      * If setNeedPairEnergy(true) was called, the pair energy is also
+      * computed within the pair force loop.
       */
       void calculateForces();
 
+      /**
+      * Set whether calculateForces() should also compute pair energy.
+      *
+      * MdSimulation::simulate() sets this true before each step after
+      * which analyzers will sample, so that the pair energy is obtained
+      * without a separate pass over the pair list.
+      *
+      * \param needPairEnergy if true, compute pair energy with forces
+      */
+      void setNeedPairEnergy(bool needPairEnergy);
+
       /**
       * Compute and return total kinetic energy.
       */
@@ -459,6 +473,9 @@ namespace McMd
       /// Did this class create the MdIntegratorFactory?
       bool createdMdIntegratorFactory_;
 
+      /// Should calculateForces() also compute the pair energy?
+      bool needPairEnergy_;
+
       /*
       * Implementations of the explicit specializations of the public
       * stress calculators computeVirialStress(T& ) etc. for T = double,
@@ -28,6 +28,7 @@ namespace McMd
       SystemAnalyzer<System>(system),
       outputFile_(),
       accumulator_(),
+      orderNAccumulator_(),
       truePositions_(),
       oldPositions_(),
       shifts_(),
@@ -35,6 +36,7 @@ namespace McMd
       speciesId_(-1),
       nMolecule_(-1),
       capacity_(-1),
+      nLevel_(0),
       nAtom_(0)
    {  setClassName("G1MSD"); }
 
@@ -49,12 +51,15 @@ namespace McMd
       readOutputFileName(in);
       read<int>(in, "speciesId", speciesId_);
       read<int>(in, "capacity", capacity_);
+      nLevel_ = 0;
+      readOptional<int>(in, "nLevel", nLevel_);
 
       // Validate parameters
       if (speciesId_ < 0)       UTIL_THROW("Negative speciesId");
       if (speciesId_ >= system().simulation().nSpecies()) 
                                 UTIL_THROW("speciesId > nSpecies");
       if (capacity_ <= 0)       UTIL_THROW("Negative capacity");
+      if (nLevel_ < 0)          UTIL_THROW("Negative nLevel");
 
       speciesPtr_ = &system().simulation().species(speciesId_);
       nAtom_ = speciesPtr_->nAtom();
@@ -76,8 +81,13 @@ namespace McMd
       oldPositions_.allocate(nratoms); 
       shifts_.allocate(nratoms); 
 
-      // Initialize the AutoCorrArray object
-      accumulator_.setParam(nratoms, capacity_);
+      // Initialize the accumulator
+      if (nLevel_ > 0) {
+         orderNAccumulator_.setParam(nratoms, capacity_, nLevel_);
+         orderNAccumulator_.setNEnsemble(nratoms);
+      } else {
+         accumulator_.setParam(nratoms, capacity_);
+      }
 
       // Store initial positions, and set initial shift vectors.
       Vector     r;
@@ -141,7 +151,11 @@ namespace McMd
 	    iatom++;
 	 }
       }
-      accumulator_.sample(truePositions_);
+      if (nLevel_ > 0) {
+         orderNAccumulator_.sample(truePositions_);
+      } else {
+         accumulator_.sample(truePositions_);
+      }
 
    }
 
@@ -153,9 +167,16 @@ namespace McMd
       fileMaster().openOutputFile(outputFileName(), outputFile_);
       writeParam(outputFile_); 
       outputFile_ << std::endl;
-      outputFile_ << "nrAtoms  " << accumulator_.nEnsemble() << std::endl;
-      outputFile_ << "buffercapacity " << accumulator_.bufferCapacity()  << std::endl;
-      outputFile_ << "nSample    " << accumulator_.nSample()   << std::endl;
+      if (nLevel_ > 0) {
+         outputFile_ << "nrAtoms  " << orderNAccumulator_.nEnsemble() << std::endl;
+         outputFile_ << "blockLength " << orderNAccumulator_.blockLength() << std::endl;
+         outputFile_ << "nLevel     " << orderNAccumulator_.nLevel() << std::endl;
+         outputFile_ << "nSample    " << orderNAccumulator_.nSample() << std::endl;
+      } else {
+         outputFile_ << "nrAtoms  " << accumulator_.nEnsemble() << std::endl;
+         outputFile_ << "buffercapacity " << accumulator_.bufferCapacity()  << std::endl;
+         outputFile_ << "nSample    " << accumulator_.nSample()   << std::endl;
+      }
       outputFile_ << std::endl;
       outputFile_ << "Format of *.dat file:" << std::endl;
       outputFile_ << "[time in samples]  [Mean Sq Displacement]"
@@ -164,7 +185,11 @@ namespace McMd
 
       // Output statistical analysis to separate data file
       fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
-      accumulator_.output(outputFile_); 
+      if (nLevel_ > 0) {
+         orderNAccumulator_.output(outputFile_); 
+      } else {
+         accumulator_.output(outputFile_); 
+      }
       outputFile_.close();
 
    }
@@ -11,6 +11,7 @@
 #include <mcMd/analyzers/SystemAnalyzer.h>  // base class template
 #include <mcMd/simulation/System.h>             // base class template parameter
 #include <util/accumulators/MeanSqDispArray.h>  // member template 
+#include <mcMd/analyzers/util/OrderNMeanSqDisp.h>  // member
 #include <util/space/Vector.h>                   // template parameter
 #include <util/containers/DArray.h>             // member template
 
@@ -72,6 +73,9 @@ namespace McMd
       /// Statistical accumulator
       MeanSqDispArray<Vector> accumulator_;
 
+      /// Order-n statistical accumulator, used if nLevel_ > 0
+      OrderNMeanSqDisp orderNAccumulator_;
+
       /// Array of position vectors, one per molecule of species.
       DArray<Vector>    truePositions_;
    
@@ -92,6 +96,9 @@ namespace McMd
    
       /// Maximum length of each sequence in AutoCorrArray.
       int     capacity_;
+
+      /// Number of levels of order-n accumulator (0 if not used).
+      int     nLevel_;
       
       /// Number of atoms per molecule of this species.
       int     nAtom_;     
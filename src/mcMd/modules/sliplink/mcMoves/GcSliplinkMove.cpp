@@ -62,12 +62,10 @@ namespace McMd
       System::MoleculeIterator molIter;
       double    rsq, oldEnergy, newEnergy;
       double    rnd, norm, energy, sum, pci, pdi, ratio;
-      double    cdf[CellList::MaxNeighbor];
       Molecule *mol0Ptr, *mol1Ptr;
       Link     *linkPtr;
       Atom     *atom0Ptr, *atom1Ptr;
       int       i, j, iAtom0, iAtom1, linkId, nLink, nNeighbor, n0, endId;
-      int       idneighbors[CellList::MaxNeighbor];
       bool      allowed;
 
       
@@ -204,6 +202,8 @@ namespace McMd
                         system().pairPotential().cellList()
                                 .getNeighbors(atom0Ptr->position(), neighbors_);
                         nNeighbor = neighbors_.size();
+                        cdf_.resize(nNeighbor);
+                        idNeighbors_.resize(nNeighbor);
       
                         // Loop over neighboring atoms
                         n0 = 0;
@@ -226,8 +226,8 @@ namespace McMd
                                     energy = system().linkPotential()
                                                      .energy(rsq, linkPtr->typeId());
                                     sum = sum + boltzmann(energy);
-                                    cdf[n0] = sum;
-                                    idneighbors[n0] = j;
+                                    cdf_[n0] = sum;
+                                    idNeighbors_[n0] = j;
                                     n0++;
                                  }
 
@@ -237,7 +237,7 @@ namespace McMd
       
                         // Accept or reject destruction
                         pci = 2.0 * system().nMolecule(speciesId_)
-                                 * boltzmann(-mu_) * cdf[n0-1] / fCreate_;
+                                 * boltzmann(-mu_) * cdf_[n0-1] / fCreate_;
                         pdi = 4.0 * nLink / fNotCreate_;
                         ratio = pdi / pci;
                         if (random().metropolis(ratio)) {
@@ -272,6 +272,8 @@ namespace McMd
             system().pairPotential().cellList()
                     .getNeighbors(atom0Ptr->position(), neighbors_);
             nNeighbor = neighbors_.size();
+            cdf_.resize(nNeighbor);
+            idNeighbors_.resize(nNeighbor);
    
             // Loop over neighboring atoms
             n0 = 0;
@@ -293,8 +295,8 @@ namespace McMd
                      if (rsq <= cutoffSq_) {
                         energy = system().linkPotential().energy(rsq, 0);
                         sum = sum + boltzmann(energy);
-                        cdf[n0] = sum;
-                        idneighbors[n0] = j;
+                        cdf_[n0] = sum;
+                        idNeighbors_[n0] = j;
                         n0++;
                      }
 
@@ -305,18 +307,18 @@ namespace McMd
             // If at least 1 candidate has been found.
             if (n0 > 0) {
    
-               // Choose a partner with probability cdf[j]/cdf[n0-1]
+               // Choose a partner with probability cdf_[j]/cdf_[n0-1]
                j = 0;
                rnd = random().uniform(0.0, 1.0);
-               norm = 1.0/cdf[n0-1];
-               while (rnd > cdf[j]*norm ){
+               norm = 1.0/cdf_[n0-1];
+               while (rnd > cdf_[j]*norm ){
                   j = j + 1;
                }
-               atom1Ptr = neighbors_[idneighbors[j]];
+               atom1Ptr = neighbors_[idNeighbors_[j]];
    
                // Accept or reject creation
                pci = 2.0 * system().nMolecule(speciesId_)
-                        * boltzmann(-mu_) * cdf[n0-1] / fCreate_;
+                        * boltzmann(-mu_) * cdf_[n0-1] / fCreate_;
                pdi = 4.0 * (nLink + 1.0) / fNotCreate_;
                ratio = pci / pdi;
                if (random().metropolis(ratio)) {
@@ -13,6 +13,8 @@
 #include <mcMd/neighbor/CellList.h>
 #include <util/global.h>
 
+#include <vector>
+
 namespace McMd
 {
     
@@ -41,6 +43,12 @@ namespace McMd
 
       /// Array to hold neighbors returned by a CellList.
       mutable CellList::NeighborArray neighbors_;
+
+      /// Cumulative distribution of Boltzmann weights of candidate partners.
+      std::vector<double> cdf_;
+
+      /// Indices in neighbors_ of candidate partners, in order of cdf_.
+      std::vector<int> idNeighbors_;
       
       double cutoff_;
 
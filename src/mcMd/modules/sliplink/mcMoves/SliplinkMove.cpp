@@ -55,9 +55,7 @@ namespace McMd
       double                   rsq, oldEnergy, newEnergy;
       double                   dRSq, mindRSq=cutoff_*cutoff_, rnd, norm;
       Link*                    linkPtr;
-      static const int         maxNeighbor = CellList::MaxNeighbor;
-      double                   cdf[maxNeighbor], energy, sum;
-      int                      idneighbors[maxNeighbor];
+      double                   energy, sum;
 
 
       // Go through all links.
@@ -152,6 +150,8 @@ namespace McMd
                   // Get array of neighbors
                   system().pairPotential().cellList().getNeighbors(atom0Ptr->position(), neighbors_);
                   nNeighbor = neighbors_.size();
+                  cdf_.resize(nNeighbor);
+                  idNeighbors_.resize(nNeighbor);
 
                   iMolecule0 = system().moleculeId(*mol0Ptr);
                   id0 = atom0Ptr->id();
@@ -161,8 +161,6 @@ namespace McMd
                   // Loop over neighboring atoms
                   for (j = 0; j < nNeighbor; ++j) {
                      atom1Ptr = neighbors_[j];
-                     mol1Ptr = &atom1Ptr->molecule();
-                     iMolecule1 = system().moleculeId(*mol1Ptr);
                      id1 = atom1Ptr->id();
 
                      // Check if atoms are the same
@@ -177,8 +175,8 @@ namespace McMd
                            if (dRSq <= mindRSq) {
                               energy = system().linkPotential().energy(dRSq, 0);
                               sum = sum + boltzmann(energy);
-                              cdf[n0] = sum;
-                              idneighbors[n0] = j;
+                              cdf_[n0] = sum;
+                              idNeighbors_[n0] = j;
                               n0++;
                            }
                         }
@@ -187,14 +185,14 @@ namespace McMd
 
                   // If at least 1 candidate has been found.
                   if (n0 > 0) {
-                     // Choose a partner with probability cdf[j]/cdf[n0-1]
+                     // Choose a partner with probability cdf_[j]/cdf_[n0-1]
                      j = 0;
                      rnd = random().uniform(0.0, 1.0);
-                     norm = 1.0/cdf[n0-1];
-                     while (rnd > cdf[j]*norm ){
+                     norm = 1.0/cdf_[n0-1];
+                     while (rnd > cdf_[j]*norm ){
                        j = j + 1;
                      }
-                     atom1Ptr = neighbors_[idneighbors[j]];
+                     atom1Ptr = neighbors_[idNeighbors_[j]];
                      // renew the slip-link with the selected partner.
                      system().linkMaster().addLink(*atom0Ptr, *atom1Ptr, 0);
                      system().linkMaster().removeLink(idLink);
@@ -55,9 +55,7 @@ namespace McMd
      int                      i, ntrials, j, nNeighbor, idLink, iAtom, id1, id0;
      int                      iAtom0, iAtom1, iMolecule0, iMolecule1, n0;
      Link*                    linkPtr;
-     static const int         maxNeighbor = CellList::MaxNeighbor;
-     double                   cdf[maxNeighbor], energy, sum;
-     int                      idneighbors[maxNeighbor];
+     double                   energy, sum;
 
      
      ntrials = 2 * system().simulation().atomCapacity();
@@ -77,14 +75,14 @@ namespace McMd
 	  // Get array of neighbors
 	  system().cellList().getNeighbors(atomPtr->position(), neighbors_);
 	  nNeighbor = neighbors_.size();
+	  cdf_.resize(nNeighbor);
+	  idNeighbors_.resize(nNeighbor);
 	    
 	  n0 = 0;
 	  sum = 0;
 	  // Loop over neighboring atoms
 	  for (j = 0; j < nNeighbor; ++j) {
 	    atom1Ptr = neighbors_[j];
-	    mol1Ptr = &atom1Ptr->molecule();
-	    iMolecule1 = system().moleculeId(*mol1Ptr);	
 	    id1 = atom1Ptr->id();
 	    
             // Check if atoms are the same
@@ -97,8 +95,8 @@ namespace McMd
 		  energy = system().linkPotential().energy(dRSq, 0);
 		  //energy = 0.5*dRSq;
 		  sum = sum + boltzmann(energy);
-		  cdf[n0] = sum;
-		  idneighbors[n0] = j;
+		  cdf_[n0] = sum;
+		  idNeighbors_[n0] = j;
 		  n0++;
 		}    
 	      }
@@ -107,18 +105,18 @@ namespace McMd
 	    
 	  // If at least 1 candidate has been found.  
 	  if (n0 > 0) {
-	    // Choose a partner with probability cdf[j]/cdf[n0-1]
+	    // Choose a partner with probability cdf_[j]/cdf_[n0-1]
 	    j = 0;
 	    rnd = random().uniform(0.0, 1.0);
-	    norm = 1.0/cdf[n0-1];
-	    while (rnd > cdf[j]*norm ){
+	    norm = 1.0/cdf_[n0-1];
+	    while (rnd > cdf_[j]*norm ){
 	      j = j + 1;
 	    }     
-	    atom1Ptr = neighbors_[idneighbors[j]];	  	  
+	    atom1Ptr = neighbors_[idNeighbors_[j]];
 	    // Create a slip-link between the selected atoms with probability = prob
 	    prob = 2.0 * (system().linkMaster().nLink() + 1.0);
-	    prob = system().simulation().atomCapacity() * boltzmann(-mu_) * cdf[n0-1]/ prob ;
-	    //prob = 2.0 * system().nMolecule(speciesId_) * boltzmann(-mu_) * cdf[n0-1]/ prob ;	      
+	    prob = system().simulation().atomCapacity() * boltzmann(-mu_) * cdf_[n0-1]/ prob ;
+	    //prob = 2.0 * system().nMolecule(speciesId_) * boltzmann(-mu_) * cdf_[n0-1]/ prob ;
 	    if (system().simulation().random().uniform(0.0, 1.0) < prob) {        
 	      system().linkMaster().addLink(*atomPtr, *atom1Ptr, 0); 
 	      incrementNAccept();	    
@@ -148,14 +146,14 @@ namespace McMd
 	      // Get array of neighbors
 	      system().cellList().getNeighbors(atom0Ptr->position(), neighbors_);
 	      nNeighbor = neighbors_.size();
+	      cdf_.resize(nNeighbor);
+	      idNeighbors_.resize(nNeighbor);
 	      id0 = atom0Ptr->id();
 	      n0 = 0;
 	      sum = 0;
 	      // Loop over neighboring atoms
 	      for (j = 0; j < nNeighbor; ++j) {
 		atom1Ptr = neighbors_[j];
-		mol1Ptr = &atom1Ptr->molecule();
-		iMolecule1 = system().moleculeId(*mol1Ptr);
 	        id1 = atom1Ptr->id();
 	    
                 // Check if atoms are the same
@@ -168,16 +166,16 @@ namespace McMd
 		      energy = system().linkPotential().energy(dRSq, 0);
 		      //energy = 0.5*dRSq;
 		      sum = sum + boltzmann(energy);
-		      cdf[n0] = sum;
-		      idneighbors[n0] = j;
+		      cdf_[n0] = sum;
+		      idNeighbors_[n0] = j;
 		      n0++;
 		    }    
 		  }
 	        }
 	      }    
 	      // Destroy the slip-link between the selected atoms with probability = prob	  
-	      //prob = 2.0 * system().nMolecule(speciesId_) * boltzmann(-mu_) * cdf[n0-1];	
-	      prob = system().simulation().atomCapacity() * boltzmann(-mu_) * cdf[n0-1];	    
+	      //prob = 2.0 * system().nMolecule(speciesId_) * boltzmann(-mu_) * cdf_[n0-1];
+	      prob = system().simulation().atomCapacity() * boltzmann(-mu_) * cdf_[n0-1];
 	      prob = 2.0 * system().linkMaster().nLink() / prob; 	            
 	      if (system().simulation().random().uniform(0.0, 1.0) < prob) {        
 		system().linkMaster().removeLink(idLink); 
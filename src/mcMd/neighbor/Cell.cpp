@@ -17,7 +17,19 @@ namespace McMd
    * Default constructor, creates an empty Cell.
    */
    Cell::Cell() 
-   {  clear();}
+    : atoms_(0),
+      capacity_(0)
+   {  clear(); }
+
+   /*
+   * Assign a block of memory and reset to empty state.
+   */
+   void Cell::setStorage(Atom** atoms, int capacity)
+   {
+      atoms_ = atoms;
+      capacity_ = capacity;
+      clear();
+   }
    
    /* 
    * Reset Cell to empty state.
@@ -27,7 +39,7 @@ namespace McMd
       nAtomCell_     = 0;
       firstEmptyPos_ = 0;
       firstClearPos_ = 0;
-      for (int j = 0; j < MaxAtomCell; ++j) {
+      for (int j = 0; j < capacity_; ++j) {
          atoms_[j] = 0;
       }
    }
@@ -41,7 +53,7 @@ namespace McMd
    {
       int jp, atomId, nAtomCellTest;
       nAtomCellTest=0;
-      for (jp=0; jp < Cell::MaxAtomCell; ++jp) {
+      for (jp=0; jp < capacity_; ++jp) {
          if (atoms_[jp] != 0) {
             atomId = atoms_[jp]->id();
             ++nAtomCellTest;
@@ -29,11 +29,11 @@ namespace McMd
    * a small region within a System. A CellList contains a private array of
    * Cell objects.  A Cell should be accessed only by its parent CellList. 
    *
-   * The maximum allowed number of atoms in a cell is given by a static 
-   * constant MaxAtomCell. Attempting to add more than MaxAtomCell atoms 
-   * will cause an Exception to be thrown by Cell::addAtom(), thus ending
-   * the simulation. If this happens, the only solution is to recompile 
-   * with a larger value of MaxAtomCell.
+   * The pointers are stored in a contiguous block of a larger array that
+   * is owned by the parent CellList, which is assigned by setStorage().
+   * The number of elements in this block is given by capacity(). The
+   * parent CellList must check isFull() before calling addAtom(), and
+   * reassign larger blocks to all of its cells when a cell is full.
    *
    * \ingroup McMd_Neighbor_Module
    */
@@ -42,13 +42,6 @@ namespace McMd
      
    public:
 
-      /// Maximum number of atoms per cell.
-      #ifdef SIMP_COULOMB
-      static const int MaxAtomCell = 253; 
-      #else
-      static const int MaxAtomCell = 61; 
-      #endif
-   
       /// A null (uninitialized) index value.
       static const int NullIndex   = -1; 
    
@@ -57,6 +50,14 @@ namespace McMd
       */
       Cell();
    
+      /**
+      * Assign a block of memory for pointers, and reset to empty state.
+      *
+      * \param atoms     pointer to first element of the block
+      * \param capacity  number of elements in the block
+      */
+      void setStorage(Atom** atoms, int capacity);
+
       /**
       * Reset Cell to empty state.
       */
@@ -73,6 +74,7 @@ namespace McMd
       * Add one atom to a Cell.
       *
       * On return: cellTag.cellPos is set, and cellTag.cellId = cellId.
+      * Throws an Exception if the cell is full.
       *
       * \param cellTag    CellTag objects associated with added atom
       * \param atom       atom to be added
@@ -85,6 +87,12 @@ namespace McMd
 
       /// Get index of first clear element of atoms_ 
       int firstClearPos() const; 
+
+      /// Get number of elements in the block of memory for this cell.
+      int capacity() const;
+
+      /// Is every element of the block of memory occupied?
+      bool isFull() const;
         
       /** 
       * Get a pointer to Atom (may be null). 
@@ -114,7 +122,8 @@ namespace McMd
       /*
       * Implementation notes:
       *
-      * Pointers to atoms in a cell are stored in the atoms_[] array member.
+      * Pointers to atoms in a cell are stored in the atoms_[] array, which
+      * is a block of capacity_ elements in an array owned by the CellList.
       * "Empty" elements of atoms_[] must contain a null (i.e., 0) pointer.
       *
       * The total number of atoms in the cell in is nAtomCell_. The array 
@@ -129,8 +138,11 @@ namespace McMd
       * checked in the isValid() method. 
       */
    
-      /// C array containing pointers to atoms in this Cell.
-      Atom* atoms_[MaxAtomCell]; ///< stores pointers to the atoms in cell
+      /// Pointer to first element of block of pointers to atoms.
+      Atom** atoms_;
+
+      /// Number of elements in the block atoms_.
+      int   capacity_;
    
       /// Number of atoms currently in this Cell.
       int   nAtomCell_;   
@@ -189,7 +201,7 @@ namespace McMd
    {
    
       // If cell is already full, throw Exception
-      if (firstEmptyPos_ == MaxAtomCell) {
+      if (firstEmptyPos_ == capacity_) {
          UTIL_THROW("Too many atoms in one cell");
       }
        
@@ -202,7 +214,7 @@ namespace McMd
       cellTag.cellPos = firstEmptyPos_;
    
       // Reset firstEmptyPos_ and firstClearPos_
-      if (firstEmptyPos_ < MaxAtomCell - 1) {
+      if (firstEmptyPos_ < capacity_ - 1) {
    
          if (firstEmptyPos_ == firstClearPos_) {
    
@@ -212,7 +224,7 @@ namespace McMd
          } else {
    
             // Find the next empty element, for which atoms_[i] is null
-            for (int i = firstEmptyPos_ + 1; i < MaxAtomCell; ++i) {
+            for (int i = firstEmptyPos_ + 1; i < capacity_; ++i) {
                if (atoms_[i] == 0) {
                   firstEmptyPos_ = i;
                   break;
@@ -223,11 +235,11 @@ namespace McMd
    
       } else { 
    
-         // If firstEmptyPos_ was MaxAtomCell - 1, no empty slots remain.
-         // Set firstEmptyPos_ = MaxAtomCell to indicate this condition.
-         // Attempting to add one more atom will trigger an Exception.
-         firstEmptyPos_ = MaxAtomCell;  // Note: Invalid array index
-         firstClearPos_ = MaxAtomCell;  // Note: Invalid array index
+         // If firstEmptyPos_ was capacity_ - 1, no empty slots remain.
+         // Set firstEmptyPos_ = capacity_ to indicate this condition.
+         // The parent CellList must then reassign storage (isFull()).
+         firstEmptyPos_ = capacity_;  // Note: Invalid array index
+         firstClearPos_ = capacity_;  // Note: Invalid array index
    
       }
    }
@@ -238,6 +250,12 @@ namespace McMd
    inline int Cell::firstClearPos() const
    { return firstClearPos_; }
 
+   inline int Cell::capacity() const
+   { return capacity_; }
+
+   inline bool Cell::isFull() const
+   { return (firstEmptyPos_ == capacity_); }
+
    inline Atom* Cell::atomPtr(int index) const
    { return atoms_[index]; }
          
@@ -29,6 +29,8 @@ namespace McMd
       }
       YZCells_ = 0;
       totCells_ = 0;
+      nNeighborCell_ = 0;
+      nOccupied_ = 0;
       atomCapacity_ = 0;
    }
 
@@ -43,13 +45,13 @@ namespace McMd
    */
    void CellList::clear()
    {
-      // Clear all Cell objects
+      // Clear all Cell objects in the current grid
       int i;
-      if (cells_.capacity() > 0) {
-         for (i=0; i < cells_.capacity(); ++i) {
-            cells_[i].clear();
-         }
+      for (i=0; i < totCells_; ++i) {
+         cells_[i].clear();
+         occupiedPos_[i] = -1;
       }
+      nOccupied_ = 0;
 
       // Clear all CellTag objects
       if (cellTags_.capacity() > 0) {
@@ -98,13 +100,16 @@ namespace McMd
       }
       atomCapacity_ = atomCapacity;
 
-      // If necessary, allocate/reallocate cellTags_ array.
+      // If necessary, allocate/reallocate cellTags_ and work_ arrays.
       if (cellTags_.capacity() == 0) {
          cellTags_.allocate(atomCapacity_);
+         work_.allocate(atomCapacity_);
       } else 
       if (atomCapacity_ > cellTags_.capacity()) {
          cellTags_.deallocate();
          cellTags_.allocate(atomCapacity_);
+         work_.deallocate();
+         work_.allocate(atomCapacity_);
       }
    }
 
@@ -116,6 +121,9 @@ namespace McMd
       if (cutoff <= 0) {
          UTIL_THROW("cutoff must be > 0");
       }
+      if (atomCapacity_ <= 0) {
+         UTIL_THROW("atomCapacity must be set before setup");
+      }
 
       lengths_ = boundary.lengths();
       setCellsAxis(0, cutoff);
@@ -130,16 +138,143 @@ namespace McMd
       // If necessary, allocate or reallocate cells_ array
       if (cells_.capacity() == 0) {
          cells_.allocate(totCells_);
+         occupied_.allocate(totCells_);
+         occupiedPos_.allocate(totCells_);
       } else
       if (totCells_ > cells_.capacity()) {
          cells_.deallocate();
          cells_.allocate(totCells_);
+         occupied_.deallocate();
+         occupied_.allocate(totCells_);
+         occupiedPos_.deallocate();
+         occupiedPos_.allocate(totCells_);
       }
+      initializeStorage();
       clear();
+      makeNeighborCells();
 
       boundaryPtr_ = &boundary;
    }
 
+   /*
+   * Fill table of neighbor cell indices.
+   */
+   void CellList::makeNeighborCells()
+   {
+      int ic, icx, icy, icz;
+      int jc, jcx, jcy, jcz;
+      int dcx, dcy, dcz, k;
+
+      nNeighborCell_ = 1;
+      for (k = 0; k < Dimension; ++k) {
+         nNeighborCell_ *= maxDel_[k] - minDel_[k] + 1;
+      }
+      assert(nNeighborCell_ <= MaxNeighborCell);
+
+      // If necessary, allocate or reallocate neighborCells_ array
+      int size = totCells_*nNeighborCell_;
+      if (neighborCells_.capacity() == 0) {
+         neighborCells_.allocate(size);
+      } else
+      if (size > neighborCells_.capacity()) {
+         neighborCells_.deallocate();
+         neighborCells_.allocate(size);
+      }
+
+      for (ic = 0; ic < totCells_; ++ic) {
+         cellCoordFromIndex(ic, icx, icy, icz);
+
+         // By convention, cell ic is listed first
+         k = ic*nNeighborCell_;
+         neighborCells_[k] = ic;
+         ++k;
+
+         for (dcx = minDel_[0]; dcx <= maxDel_[0]; ++dcx) {
+            jcx = shiftCellCoordAxis(0, icx + dcx);
+            for (dcy = minDel_[1]; dcy <= maxDel_[1]; ++dcy) {
+               jcy = shiftCellCoordAxis(1, icy + dcy);
+               for (dcz = minDel_[2]; dcz <= maxDel_[2]; ++dcz) {
+                  jcz = shiftCellCoordAxis(2, icz + dcz);
+                  jc = cellIndexFromCoord(jcx, jcy, jcz);
+                  if (jc != ic) {
+                     neighborCells_[k] = jc;
+                     ++k;
+                  }
+               }
+            }
+         }
+         assert(k == (ic + 1)*nNeighborCell_);
+      }
+   }
+
+   /*
+   * Assign equal blocks of storage to all cells, sized for uniform density.
+   */
+   void CellList::initializeStorage()
+   {
+      int capacity = atomCapacity_/totCells_ + 1 + Slack;
+      int size = capacity*totCells_;
+      if (storage_.capacity() < size) {
+         if (storage_.isAllocated()) {
+            storage_.deallocate();
+         }
+         storage_.allocate(size);
+      }
+      for (int ic = 0; ic < totCells_; ++ic) {
+         cells_[ic].setStorage(&storage_[ic*capacity], capacity);
+      }
+   }
+
+   /*
+   * Regroup all atoms by cell into new blocks, giving cell ic extra room.
+   */
+   void CellList::resizeStorage(int ic)
+   {
+      const Cell* cellPtr;
+      Atom* atomPtr;
+      int jc, jp, n, capacity;
+
+      // Copy atom pointers to work_, grouped by cell, and add block sizes
+      int nAtom = 0;
+      int size = 0;
+      for (jc = 0; jc < totCells_; ++jc) {
+         cellPtr = &cells_[jc];
+         for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+            atomPtr = cellPtr->atomPtr(jp);
+            if (atomPtr) {
+               work_[nAtom] = atomPtr;
+               ++nAtom;
+            }
+         }
+         n = cellPtr->nAtomCell();
+         size += (jc == ic) ? 2*n + Slack : n + Slack;
+      }
+
+      // Reallocate storage_ if necessary (contents are now in work_)
+      if (storage_.capacity() < size) {
+         storage_.deallocate();
+         storage_.allocate(size);
+      }
+
+      // Assign new blocks, in order of cell index
+      int offset = 0;
+      for (jc = 0; jc < totCells_; ++jc) {
+         n = cells_[jc].nAtomCell();
+         capacity = (jc == ic) ? 2*n + Slack : n + Slack;
+         cells_[jc].setStorage(&storage_[offset], capacity);
+         offset += capacity;
+      }
+
+      // Add atoms back to their cells, which also resets all CellTags
+      int atomId;
+      for (int i = 0; i < nAtom; ++i) {
+         atomPtr = work_[i];
+         atomId = atomPtr->id();
+         jc = cellTags_[atomId].cellId;
+         cells_[jc].addAtom(cellTags_[atomId], *atomPtr, jc);
+      }
+   }
+
    /*
    * Fill an array with Ids of atoms in cell ic and all neighboring cells.
    */
@@ -149,15 +284,9 @@ namespace McMd
    {
       const Cell *cellPtr;
       Atom *atomPtr;
-      int   icx, icy, icz;
-      int   jc, jcx, jcy, jcz;
-      int   dcx, dcy, dcz, jp;
+      const int* cellIds = &neighborCells_[ic*nNeighborCell_];
+      int   jc, jp;
 
-      // Determine cell coordinates icx, icy, icz
-      cellCoordFromIndex(ic, icx, icy, icz);
-
-      // Zero total number of neighbor atoms and number in cell
-      //nNeighbor = 0;
       nInCell   = 0;
       neighbors.clear();
 
@@ -173,40 +302,15 @@ namespace McMd
       }
 
       // Loop over neighboring cells (excluding cell ic)
-
-      // Loop in x direction
-      for (dcx = minDel_[0]; dcx <= maxDel_[0]; ++dcx) {
-         jcx = shiftCellCoordAxis(0, icx + dcx);
-
-         // Loop in y direction
-         for (dcy = minDel_[1]; dcy <= maxDel_[1]; ++dcy) {
-            jcy = shiftCellCoordAxis(1, icy + dcy);
-
-            // Loop in z direction
-            for (dcz = minDel_[2]; dcz <= maxDel_[2]; ++dcz) {
-               jcz = shiftCellCoordAxis(2, icz + dcz);
-
-               // Get cell index jc and Cell pointer cellPtr
-               jc = cellIndexFromCoord(jcx, jcy, jcz);
-
-               if (jc != ic) {
-
-                  // Loop over atoms in neighboring cell jc
-                  cellPtr = &cells_[jc];
-                  for (jp=0; jp < cellPtr->firstClearPos(); ++jp) {
-                     atomPtr  = cellPtr->atomPtr(jp);
-                     if (atomPtr != 0) {
-                        neighbors.append(atomPtr);
-                     }
-                  }
-
-               } // end if (jc != ic)
-
-            } // end for dcz
-
-         } // end for dcy
-
-      } // end for dcx
+      for (jc = 1; jc < nNeighborCell_; ++jc) {
+         cellPtr = &cells_[cellIds[jc]];
+         for (jp=0; jp < cellPtr->firstClearPos(); ++jp) {
+            atomPtr  = cellPtr->atomPtr(jp);
+            if (atomPtr != 0) {
+               neighbors.append(atomPtr);
+            }
+         }
+      }
 
    } 
 
@@ -251,6 +355,29 @@ namespace McMd
          }
       }
 
+      // Check consistency of list of non-empty cells
+      int nOccupied = 0;
+      int pos;
+      for (int icell = 0; icell < totCells_; ++icell) {
+         pos = occupiedPos_[icell];
+         if (cells_[icell].nAtomCell() > 0) {
+            ++nOccupied;
+            if (pos < 0 || pos >= nOccupied_) {
+               UTIL_THROW("Non-empty cell missing from occupied list");
+            }
+            if (occupied_[pos] != icell) {
+               UTIL_THROW("Inconsistent occupied list position");
+            }
+         } else {
+            if (pos != -1) {
+               UTIL_THROW("Empty cell in occupied list");
+            }
+         }
+      }
+      if (nOccupied != nOccupied_) {
+         UTIL_THROW("Number of non-empty cells != nOccupiedCell");
+      }
+
       return true;
    }
 
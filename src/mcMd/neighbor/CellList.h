@@ -14,7 +14,7 @@
 #include <util/boundary/Boundary.h>
 #include <util/space/IntVector.h>
 #include <util/containers/DArray.h>
-#include <util/containers/FSArray.h>
+#include <util/containers/GArray.h>
 #include <util/global.h>
 
 #include <sstream>
@@ -41,11 +41,22 @@ namespace McMd
    * object. Each cell contains an small array of pointers to all
    * all atoms in the associated volume. This implementation is
    * designed to allow fast addition and removal of individual 
-   * atoms. This implementation also wastes some memory, compared
-   * to a linked list implementation, because the dimension
-   * Cell::MaxAtomCell of the array of pointers in each Cell must
-   * be large enough to accomodate the maximum number of atoms 
-   * that will ever be encountered in an individual cell.
+   * atoms. The arrays for all cells are contiguous blocks of a
+   * single array owned by the CellList, listed in order of cell
+   * index. Each block has a few empty slots (at least Slack when
+   * assigned), so that an atom can usually be added to a cell in
+   * constant time. When an atom is added to a full cell, all atoms
+   * are regrouped by cell into new blocks sized from the current
+   * cell occupancies, giving the full cell extra room. There is
+   * thus no fixed maximum number of atoms per cell.
+   *
+   * The CellList also maintains a compact list of the indices of all
+   * non-empty cells, which is updated in constant time whenever a cell
+   * gains its first atom or loses its last. Loops that compute energies
+   * or stresses cell by cell may iterate over this list, by calling
+   * nOccupiedCell() and occupiedCell(), rather than over all totCells()
+   * cells. This avoids sweeping empty cells in systems that contain large
+   * empty regions, such as slits or free-standing films.
    *
    * CellList is a non-polymorphic class, with no virtual functions, 
    * and a non-virtual destructor. Do not derive subclasses from it.
@@ -60,19 +71,21 @@ namespace McMd
       // Static members
 
       /**
-      * Maximum possible number of neighboring atoms.
+      * Growable array for holding neighbors in a cell list.
       *
-      * Use as dimension of the array neighbor passed to getNeighbors() and
-      * getCellNeighbors().
+      * \ingroup McMd_Neighbor_Module
       */
-      static const int MaxNeighbor = 27*Cell::MaxAtomCell;
+      typedef GArray<Atom*> NeighborArray;
 
       /**
-      * Static array for holding neighbors in a cell list.
-      *
-      * \ingroup McMd_Neighbor_Module
+      * Minimum number of empty slots per cell when storage is assigned.
       */
-      typedef FSArray<Atom*, MaxNeighbor> NeighborArray;
+      static const int Slack = 4;
+
+      /**
+      * Maximum possible number of cells in the neighborhood of a cell.
+      */
+      static const int MaxNeighborCell = 27;
 
       // Public member functions
 
@@ -92,7 +105,8 @@ namespace McMd
       * Set atom capacity.
       *
       * This function sets the atom capacity (the maximum number of atoms), and
-      * allocates an array of atomCapacity CellTag objects.
+      * allocates an array of atomCapacity CellTag objects and a work array
+      * of atomCapacity pointers.  It must be called before setup().
       *
       * \param atomCapacity dimension of global array of atoms
       */
@@ -117,7 +131,9 @@ namespace McMd
       * nonbonded interactions.
       *
       * After calculating the grid dimensions, this this function may allocate
-      * or resizes the array of cells if necessary, and then calls clear().
+      * or resizes the array of cells if necessary, assigns each cell a block
+      * of storage sized for a uniform density of atomCapacity() atoms, and
+      * then calls clear().
       * It also retains a pointer to the Boundary, which is used to determine
       * the correct cell by the cellIndexFromPosition() function.
       *
@@ -129,8 +145,8 @@ namespace McMd
       /**
       * Sets all Cell objects to empty state (no Atoms).
       *
-      * This function does not change the cell grid dimensions, and does not
-      * allocate or reallocate any memory.
+      * This function does not change the cell grid dimensions or the blocks
+      * of storage assigned to cells, and does not allocate any memory.
       */
       void clear();
 
@@ -149,6 +165,18 @@ namespace McMd
       */
       void addAtom(Atom &atom);
 
+      /**
+      * Add an Atom to the cell that contains a specified position.
+      *
+      * Use this to add an atom at a shifted copy of its position, without
+      * modifying the Atom. Later calls to updateAtomCell() and deleteAtom()
+      * for this atom are then not meaningful.
+      *
+      * \param atom  Atom object to be added.
+      * \param pos   position used to choose the cell
+      */
+      void addAtom(Atom &atom, const Vector &pos);
+
       /**
       * Delete a Atom object from its cell.
       *
@@ -173,6 +201,31 @@ namespace McMd
       */
       void updateAtomCell(Atom &atom, const Vector &pos);
 
+      /**
+      * Move an Atom to the cell of a new position, if that cell has room.
+      *
+      * Unlike updateAtomCell(), this modifies only the old and new cells
+      * and the CellTag of the atom. It never reallocates storage and does
+      * not update the list of non-empty cells, and so may be called
+      * concurrently for atoms in disjoint sets of cells. Afterwards, call
+      * markCell() for the old and new cells from a single thread.
+      *
+      * \param atom Atom object to be moved
+      * \param pos  new Atom position
+      * \return false (and do nothing) if the new cell is full, else true
+      */
+      bool updateAtomCellLocal(Atom &atom, const Vector &pos);
+
+      /**
+      * Add cell ic to, or remove it from, the list of non-empty cells.
+      *
+      * Makes membership of cell ic in the list match its contents. Call
+      * after updateAtomCellLocal() for each cell it may have changed.
+      *
+      * \param ic  index of cell
+      */
+      void markCell(int ic);
+
       /**
       * Fill a NeighborArray with pointers to atoms near a specified position.
       *
@@ -207,6 +260,54 @@ namespace McMd
       void 
       getCellNeighbors(int ic, NeighborArray &neighbors, int &nInCell) const;
 
+      /**
+      * Get the number of distinct cells in the neighborhood of each cell.
+      *
+      * This is 27 if there are at least 3 cells in each direction, but
+      * is smaller for grids with only 1 or 2 cells along some axis. The 
+      * cell itself is included in this count.
+      */
+      int nNeighborCell() const;
+
+      /**
+      * Get one cell in the neighborhood of cell ic.
+      *
+      * Neighbor cells are stored in a table that is computed in setup(),
+      * so this function does no periodic index arithmetic. Neighbor j=0
+      * is always cell ic itself. Cells j = 1, ..., nNeighborCell() - 1 
+      * are listed in the same order as the atoms returned by 
+      * getCellNeighbors(). This allows callers that must visit every 
+      * neighbor of one position, such as McPairPotential::atomEnergy(), 
+      * to loop directly over the Cell objects rather than first copying
+      * atom pointers into a NeighborArray.
+      *
+      * \param ic  index of central cell
+      * \param j   index of neighbor cell, 0 <= j < nNeighborCell()
+      */
+      const Cell& neighborCell(int ic, int j) const;
+
+      /**
+      * Get a Cell by const reference.
+      *
+      * \param ic  cell index, 0 <= ic < totCells()
+      */
+      const Cell& cell(int ic) const;
+
+      /**
+      * Get the index of the cell with specified integer coordinates.
+      *
+      * \param coords  cell coordinates, 0 <= coords[i] < gridDimension(i)
+      */
+      int cellIndex(const IntVector& coords) const;
+
+      /**
+      * Get the integer coordinates of the cell with index ic.
+      *
+      * \param ic      cell index, 0 <= ic < totCells()
+      * \param coords  cell coordinates (output)
+      */
+      void getCellCoordinates(int ic, IntVector& coords) const;
+
       /**
       * Number of cells along axis i.
       *
@@ -219,6 +320,23 @@ namespace McMd
       */
       int totCells() const;
 
+      /**
+      * Get the number of cells that contain at least one atom.
+      */
+      int nOccupiedCell() const;
+
+      /**
+      * Get the index of one non-empty cell.
+      *
+      * The order of cells in the list of non-empty cells depends on the
+      * history of additions and deletions, and is not sorted.
+      *
+      * \param i  index in list of non-empty cells, 0 <= i < nOccupiedCell()
+      *
+eturn cell index, 0 <= ic < totCells()
+      */
+      int occupiedCell(int i) const;
+
       /**
       * Get total number of atoms in this CellList.
       */
@@ -245,9 +363,29 @@ namespace McMd
       /// Array of Cell objects
       DArray<Cell>    cells_;
 
+      /// Storage for pointers to atoms in all cells, ordered by cell.
+      DArray<Atom*>   storage_;
+
+      /// Work array used to regroup atoms by cell in resizeStorage().
+      DArray<Atom*>   work_;
+
       /// Array of CellTag objects for quick retrieval
       DArray<CellTag> cellTags_;
 
+      /// Indices of non-empty cells (first nOccupied_ elements).
+      DArray<int> occupied_;
+
+      /// Position of each cell in occupied_, or -1 if the cell is empty.
+      DArray<int> occupiedPos_;
+
+      /**
+      * Table of indices of neighboring cells.
+      *
+      * Element ic*nNeighborCell_ + j is the index of neighbor j of cell
+      * ic, in which j = 0 is cell ic itself.
+      */
+      DArray<int> neighborCells_;
+
       /**
       * Lengths of Boundary in each direction.
       *
@@ -288,6 +426,12 @@ namespace McMd
       /// Total number of cells in grid.
       int  totCells_;        
 
+      /// Number of distinct cells in the neighborhood of each cell.
+      int  nNeighborCell_;        
+
+      /// Number of non-empty cells.
+      int  nOccupied_;
+
       /// Maximum atom id + 1.
       int  atomCapacity_;        
 
@@ -306,6 +450,42 @@ namespace McMd
       */
       void setCellsAxis(int axis, double cutoff);
 
+      /**
+      * Compute nNeighborCell_ and (re)allocate and fill neighborCells_.
+      */
+      void makeNeighborCells();
+
+      /**
+      * Assign equal blocks of storage to all cells, and empty them.
+      */
+      void initializeStorage();
+
+      /**
+      * Regroup atoms into new blocks sized from current occupancies.
+      *
+      * Each cell is given a block with at least Slack empty slots, and
+      * cell ic (which is full) is given at least twice its occupancy.
+      * Atoms keep their order within each cell, so the effect is that
+      * of a counting sort by cell index of all atoms in the list.
+      *
+      * \param ic  index of a full cell to which an atom will be added
+      */
+      void resizeStorage(int ic);
+
+      /**
+      * Add cell ic to the list of non-empty cells, if it has one atom.
+      *
+      * Call after adding an atom to cell ic.
+      */
+      void markOccupied(int ic);
+
+      /**
+      * Remove cell ic from the list of non-empty cells, if it is empty.
+      *
+      * Call after deleting an atom from cell ic.
+      */
+      void markEmpty(int ic);
+
       /**
       * Return shifted integer cell coordinate x for axis i.
       *
@@ -354,6 +534,52 @@ namespace McMd
    inline int CellList::totCells() const
    { return totCells_; }
 
+   /*
+   * Get number of non-empty cells.
+   */
+   inline int CellList::nOccupiedCell() const
+   { return nOccupied_; }
+
+   /*
+   * Get index of non-empty cell number i.
+   */
+   inline int CellList::occupiedCell(int i) const
+   {
+      assert(i >= 0 && i < nOccupied_);
+      return occupied_[i];
+   }
+
+   /*
+   * Append cell ic to the list of non-empty cells, if it has one atom.
+   */
+   inline void CellList::markOccupied(int ic)
+   {
+      if (cells_[ic].nAtomCell() == 1) {
+         assert(occupiedPos_[ic] < 0);
+         occupiedPos_[ic] = nOccupied_;
+         occupied_[nOccupied_] = ic;
+         ++nOccupied_;
+      }
+   }
+
+   /*
+   * Remove cell ic from the list of non-empty cells, if it is empty.
+   *
+   * The last element of the list is moved into the vacated position.
+   */
+   inline void CellList::markEmpty(int ic)
+   {
+      if (cells_[ic].nAtomCell() == 0) {
+         int pos = occupiedPos_[ic];
+         assert(pos >= 0);
+         --nOccupied_;
+         int jc = occupied_[nOccupied_];
+         occupied_[pos] = jc;
+         occupiedPos_[jc] = pos;
+         occupiedPos_[ic] = -1;
+      }
+   }
+
    /*
    *  Return index of the cell that contains the position array pos = {x, y, z}.
    */
@@ -387,7 +613,9 @@ namespace McMd
       int atomId   = atom.id();
       assert(isValidAtomId(atomId));
       CellTag& cellTag = cellTags_[atomId];
-      cells_[cellTag.cellId].deleteAtom(cellTag);
+      int cellId = cellTag.cellId;
+      cells_[cellId].deleteAtom(cellTag);
+      markEmpty(cellId);
    }
 
    /*
@@ -399,7 +627,26 @@ namespace McMd
       int    cellId   = cellIndexFromPosition(position);
       int    atomId   = atom.id();
       assert(isValidAtomId(atomId));
+      if (cells_[cellId].isFull()) {
+         resizeStorage(cellId);
+      }
+      cells_[cellId].addAtom(cellTags_[atomId], atom, cellId);
+      markOccupied(cellId);
+   }
+
+   /*
+   * Add a Atom to the cell that contains position pos.
+   */
+   inline void CellList::addAtom(Atom &atom, const Vector &pos)
+   {
+      int    cellId   = cellIndexFromPosition(pos);
+      int    atomId   = atom.id();
+      assert(isValidAtomId(atomId));
+      if (cells_[cellId].isFull()) {
+         resizeStorage(cellId);
+      }
       cells_[cellId].addAtom(cellTags_[atomId], atom, cellId);
+      markOccupied(cellId);
    }
 
    /*
@@ -414,7 +661,48 @@ namespace McMd
       int      newCell = cellIndexFromPosition(pos);
       if (oldCell != newCell) {
          cells_[oldCell].deleteAtom(cellTag);
+         markEmpty(oldCell);
+         if (cells_[newCell].isFull()) {
+            resizeStorage(newCell);
+         }
          cells_[newCell].addAtom(cellTag, atom, newCell);
+         markOccupied(newCell);
+      }
+   }
+
+   /*
+   * Move atom to the cell of a new position, without shared updates.
+   */
+   inline bool CellList::updateAtomCellLocal(Atom &atom, const Vector &pos)
+   {
+      int atomId = atom.id();
+      assert(isValidAtomId(atomId));
+      CellTag& cellTag = cellTags_[atomId];
+      int      oldCell = cellTag.cellId;
+      int      newCell = cellIndexFromPosition(pos);
+      if (oldCell != newCell) {
+         if (cells_[newCell].isFull()) {
+            return false;
+         }
+         cells_[oldCell].deleteAtom(cellTag);
+         cells_[newCell].addAtom(cellTag, atom, newCell);
+      }
+      return true;
+   }
+
+   /*
+   * Match membership of cell ic in the list of non-empty cells to its contents.
+   */
+   inline void CellList::markCell(int ic)
+   {
+      if (cells_[ic].nAtomCell() > 0) {
+         if (occupiedPos_[ic] < 0) {
+            occupiedPos_[ic] = nOccupied_;
+            occupied_[nOccupied_] = ic;
+            ++nOccupied_;
+         }
+      } else if (occupiedPos_[ic] >= 0) {
+         markEmpty(ic);
       }
    }
 
@@ -465,6 +753,22 @@ namespace McMd
    inline int CellList::gridDimension(int i) const
    {  return numCells_[i]; }
 
+   inline const Cell& CellList::cell(int ic) const
+   {  return cells_[ic]; }
+
+   inline int CellList::cellIndex(const IntVector& coords) const
+   {  return cellIndexFromCoord(coords[0], coords[1], coords[2]); }
+
+   inline 
+   void CellList::getCellCoordinates(int ic, IntVector& coords) const
+   {  cellCoordFromIndex(ic, coords[0], coords[1], coords[2]); }
+
+   inline int CellList::nNeighborCell() const
+   {  return nNeighborCell_; }
+
+   inline const Cell& CellList::neighborCell(int ic, int j) const
+   {  return cells_[neighborCells_[ic*nNeighborCell_ + j]]; }
+
    /*
    * Serialize to/from an Archive.
    */
@@ -483,7 +787,12 @@ namespace McMd
       ar & atomCapacity_;
       if (ar.is_loading()) {
          cells_.allocate(totCells_);
+         occupied_.allocate(totCells_);
+         occupiedPos_.allocate(totCells_);
          cellTags_.allocate(atomCapacity_);
+         work_.allocate(atomCapacity_);
+         initializeStorage();
+         makeNeighborCells();
       }
       clear();
    }
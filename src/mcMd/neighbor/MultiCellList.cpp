@@ -0,0 +1,210 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "MultiCellList.h"
+
+#include <cmath>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   MultiCellList::MultiCellList()
+    : cellLists_(),
+      typeLevels_(),
+      levelCutoffs_(),
+      searchWidths_(),
+      nLevel_(0),
+      nAtomType_(0)
+   {}
+
+   /*
+   * Destructor.
+   */
+   MultiCellList::~MultiCellList()
+   {}
+
+   /*
+   * Assign atom types to levels, and compute level cutoffs.
+   */
+   void MultiCellList::setLevels(const DMatrix<double>& cutoffs, double ratio)
+   {
+      int nAtomType = cutoffs.capacity1();
+      if (nAtomType <= 0 || cutoffs.capacity2() != nAtomType) {
+         UTIL_THROW("Cutoff matrix must be square");
+      }
+      if (ratio <= 1.0) {
+         UTIL_THROW("Level ratio must be > 1");
+      }
+      int i, j, a, b;
+
+      // On first call, assign types to levels in order of self cutoff
+      if (nLevel_ == 0) {
+         nAtomType_ = nAtomType;
+         typeLevels_.allocate(nAtomType_);
+         DArray<int> order;
+         order.allocate(nAtomType_);
+         for (i = 0; i < nAtomType_; ++i) {
+            order[i] = i;
+         }
+         for (i = 1; i < nAtomType_; ++i) {
+            j = i;
+            while (j > 0 && cutoffs(order[j], order[j]) 
+                            < cutoffs(order[j-1], order[j-1])) {
+               a = order[j];
+               order[j] = order[j-1];
+               order[j-1] = a;
+               --j;
+            }
+         }
+         double start = cutoffs(order[0], order[0]);
+         double c;
+         a = 0;
+         for (i = 0; i < nAtomType_; ++i) {
+            c = cutoffs(order[i], order[i]);
+            if (c > ratio*start) {
+               ++a;
+               start = c;
+            }
+            typeLevels_[order[i]] = a;
+         }
+         nLevel_ = a + 1;
+         cellLists_.allocate(nLevel_);
+         levelCutoffs_.allocate(nLevel_, nLevel_);
+         searchWidths_.allocate(nLevel_*nLevel_);
+      } else 
+      if (nAtomType != nAtomType_) {
+         UTIL_THROW("Inconsistent number of atom types");
+      }
+
+      // Maximum cutoff between types of each pair of levels
+      for (a = 0; a < nLevel_; ++a) {
+         for (b = 0; b < nLevel_; ++b) {
+            levelCutoffs_(a, b) = 0.0;
+         }
+      }
+      for (i = 0; i < nAtomType_; ++i) {
+         a = typeLevels_[i];
+         for (j = 0; j < nAtomType_; ++j) {
+            b = typeLevels_[j];
+            if (cutoffs(i, j) > levelCutoffs_(a, b)) {
+               levelCutoffs_(a, b) = cutoffs(i, j);
+               levelCutoffs_(b, a) = cutoffs(i, j);
+            }
+         }
+      }
+   }
+
+   /*
+   * Set the maximum atom id + 1 for all levels.
+   */
+   void MultiCellList::setAtomCapacity(int atomCapacity)
+   {
+      if (nLevel_ == 0) {
+         UTIL_THROW("Levels must be set before atomCapacity");
+      }
+      for (int a = 0; a < nLevel_; ++a) {
+         cellLists_[a].setAtomCapacity(atomCapacity);
+      }
+   }
+
+   /*
+   * Set up empty grids of cells for all levels.
+   */
+   void MultiCellList::setup(const Boundary& boundary)
+   {
+      if (nLevel_ == 0) {
+         UTIL_THROW("Levels must be set before setup");
+      }
+      const Vector& lengths = boundary.lengths();
+      double cutoff;
+      int a, b, k;
+
+      // Cells of each level are wider than the cutoff within the level
+      for (b = 0; b < nLevel_; ++b) {
+         cutoff = levelCutoffs_(b, b);
+         if (cutoff <= 0.0) {
+            for (a = 0; a < nLevel_; ++a) {
+               if (levelCutoffs_(a, b) > cutoff) {
+                  cutoff = levelCutoffs_(a, b);
+               }
+            }
+         }
+         if (cutoff <= 0.0) {
+            UTIL_THROW("Level with no positive cutoff");
+         }
+         cellLists_[b].setup(boundary, cutoff);
+      }
+
+      // Half widths of search blocks, in cells of the searched level
+      for (a = 0; a < nLevel_; ++a) {
+         for (b = 0; b < nLevel_; ++b) {
+            IntVector& widths = searchWidths_[a*nLevel_ + b];
+            for (k = 0; k < Dimension; ++k) {
+               widths[k] = int(ceil(levelCutoffs_(a, b)
+                           *cellLists_[b].gridDimension(k)/lengths[k]));
+            }
+         }
+      }
+   }
+
+   /*
+   * Remove all atoms from all levels.
+   */
+   void MultiCellList::clear()
+   {
+      for (int a = 0; a < nLevel_; ++a) {
+         cellLists_[a].clear();
+      }
+   }
+
+   /*
+   * Fill an array with pointers to atoms near a position.
+   */
+   void MultiCellList::getNeighbors(const Vector& pos, int typeId,
+                                    NeighborArray& neighbors) const
+   {
+      const Cell* cellPtr;
+      Atom* atomPtr;
+      IntVector lower, upper, c;
+      int b, jp;
+
+      neighbors.clear();
+      for (b = 0; b < nLevel_; ++b) {
+         getSearchRange(pos, typeId, b, lower, upper);
+         for (c[0] = lower[0]; c[0] <= upper[0]; ++c[0]) {
+            for (c[1] = lower[1]; c[1] <= upper[1]; ++c[1]) {
+               for (c[2] = lower[2]; c[2] <= upper[2]; ++c[2]) {
+                  cellPtr = &cell(b, c);
+                  for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+                     atomPtr = cellPtr->atomPtr(jp);
+                     if (atomPtr != 0) {
+                        neighbors.append(atomPtr);
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /*
+   * Return true if valid, or throw Exception.
+   */
+   bool MultiCellList::isValid() const
+   {
+      for (int a = 0; a < nLevel_; ++a) {
+         cellLists_[a].isValid();
+      }
+      return true;
+   }
+
+}
@@ -0,0 +1,325 @@
+#ifndef MCMD_MULTI_CELL_LIST_H
+#define MCMD_MULTI_CELL_LIST_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CellList.h"
+#include <mcMd/chemistry/Atom.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/IntVector.h>
+#include <util/space/Dimension.h>
+#include <util/containers/DArray.h>
+#include <util/containers/DMatrix.h>
+#include <util/global.h>
+
+class MultiCellListTest;
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * A hierarchical cell list, with one grid of cells per size class.
+   *
+   * A MultiCellList divides atom types into levels (size classes), and
+   * keeps the atoms of each level in a separate CellList with cells no
+   * smaller than the largest cutoff between two types of that level.
+   * In a mixture of small and large particles (e.g., polymers and
+   * colloids), this keeps small particles in small cells, even though
+   * large particles require a long cutoff.
+   *
+   * Neighbors of an atom of level a in the grid of level b are found
+   * in a block of cells around its position, extending far enough in
+   * each direction to cover the maximum cutoff between types of levels
+   * a and b. This is the usual 27 cell stencil when the cells of level
+   * b are wider than this cutoff, and a larger block otherwise. The
+   * range of this block is returned by getSearchRange(), and cells are
+   * accessed by periodically shifted coordinates through cell(). These
+   * functions do not modify the list, and so may be used by several
+   * threads at once. The getNeighbors() function instead fills an array
+   * with pointers to the atoms of all levels within this range.
+   *
+   * Levels are assigned by setLevels(), from a matrix of cutoffs for
+   * pairs of types: Types are sorted by their self cutoffs, and a new
+   * level is started whenever a self cutoff exceeds the smallest self
+   * cutoff of the current level by more than a specified ratio.
+   *
+   * \ingroup McMd_Neighbor_Module
+   */
+   class MultiCellList
+   {
+
+   public:
+
+      /**
+      * Array for pointers to neighboring atoms.
+      */
+      typedef CellList::NeighborArray NeighborArray;
+
+      /**
+      * Constructor.
+      */
+      MultiCellList();
+
+      /**
+      * Destructor.
+      */
+      ~MultiCellList();
+
+      /**
+      * Set the maximum atom id + 1, for all levels.
+      *
+      * Must be called after setLevels() and before setup().
+      *
+      * \param atomCapacity maximum atom id + 1
+      */
+      void setAtomCapacity(int atomCapacity);
+
+      /**
+      * Assign atom types to levels, and compute level cutoffs.
+      *
+      * The number of levels is set on the first call, and may not be
+      * changed by later calls, which may only update level cutoffs.
+      *
+      * \param cutoffs cutoffs for all pairs of atom types
+      * \param ratio   maximum ratio of self cutoffs within a level (> 1)
+      */
+      void setLevels(const DMatrix<double>& cutoffs, double ratio);
+
+      /**
+      * Set up empty grids of cells for the current boundary.
+      *
+      * \param boundary periodic boundary
+      */
+      void setup(const Boundary& boundary);
+
+      /**
+      * Remove all atoms from all cells.
+      */
+      void clear();
+
+      /**
+      * Add an atom to the grid of its level.
+      *
+      * \param atom atom to be added
+      */
+      void addAtom(Atom& atom);
+
+      /**
+      * Remove an atom from the grid of its level.
+      *
+      * \param atom atom to be removed
+      */
+      void deleteAtom(Atom& atom);
+
+      /**
+      * Update the cell of an atom after a change in its position.
+      *
+      * \param atom atom that has moved
+      * \param pos  new position of atom
+      */
+      void updateAtomCell(Atom& atom, const Vector& pos);
+
+      /**
+      * Get range of cells of one level to search for neighbors.
+      *
+      * On return, all atoms of level level that are within the level
+      * cutoff of position pos for an atom of type typeId are in cells
+      * with coordinates lower[k] <= c[k] <= upper[k]. Coordinates out
+      * of the range of the grid are shifted periodically by cell(), and
+      * no cell appears twice within the range.
+      *
+      * \param pos    position (inside the primary cell)
+      * \param typeId type of the atom at position pos
+      * \param level  level of the grid to be searched
+      * \param lower  lower bounds of cell coordinates (output)
+      * \param upper  upper bounds of cell coordinates (output)
+      */
+      void getSearchRange(const Vector& pos, int typeId, int level,
+                          IntVector& lower, IntVector& upper) const;
+
+      /**
+      * Get a cell of one level by periodically shifted coordinates.
+      *
+      * \param level  level index
+      * \param coords cell coordinates, may lie outside the grid
+      */
+      const Cell& cell(int level, const IntVector& coords) const;
+
+      /**
+      * Fill an array with pointers to possible neighbors of a position.
+      *
+      * On return, neighbors contains all atoms of all levels in the cells
+      * given by getSearchRange() for an atom of type typeId at pos.
+      *
+      * \param pos       position (inside the primary cell)
+      * \param typeId    type of the atom at position pos
+      * \param neighbors array of pointers to atoms (output)
+      */
+      void getNeighbors(const Vector& pos, int typeId,
+                        NeighborArray& neighbors) const;
+
+      /**
+      * Get the number of levels (0 before setLevels()).
+      */
+      int nLevel() const;
+
+      /**
+      * Get the level of an atom type.
+      *
+      * \param typeId atom type index
+      */
+      int level(int typeId) const;
+
+      /**
+      * Get the maximum cutoff between types of two levels.
+      *
+      * \param a first level index
+      * \param b second level index
+      */
+      double levelCutoff(int a, int b) const;
+
+      /**
+      * Get the cell list of one level by const reference.
+      *
+      * \param level level index
+      */
+      const CellList& cellList(int level) const;
+
+      /**
+      * Return true if valid, or throw Exception.
+      */
+      bool isValid() const;
+
+   private:
+
+      /// Cell lists, one per level.
+      DArray<CellList> cellLists_;
+
+      /// Level of each atom type.
+      DArray<int> typeLevels_;
+
+      /// Maximum cutoff between types of each pair of levels.
+      DMatrix<double> levelCutoffs_;
+
+      /// Half widths of search blocks, element a*nLevel + b.
+      DArray<IntVector> searchWidths_;
+
+      /// Number of levels.
+      int nLevel_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Shift coordinate x to the range 0 <= x < n.
+      static int shift(int x, int n);
+
+   //friends:
+
+      friend class ::MultiCellListTest;
+
+   };
+
+   // Inline functions
+
+   /*
+   * Get number of levels.
+   */
+   inline int MultiCellList::nLevel() const
+   {  return nLevel_; }
+
+   /*
+   * Get level of an atom type.
+   */
+   inline int MultiCellList::level(int typeId) const
+   {  return typeLevels_[typeId]; }
+
+   /*
+   * Get maximum cutoff between types of levels a and b.
+   */
+   inline double MultiCellList::levelCutoff(int a, int b) const
+   {  return levelCutoffs_(a, b); }
+
+   /*
+   * Get the cell list of one level.
+   */
+   inline const CellList& MultiCellList::cellList(int level) const
+   {  return cellLists_[level]; }
+
+   /*
+   * Add an atom to the grid of its level.
+   */
+   inline void MultiCellList::addAtom(Atom& atom)
+   {  cellLists_[typeLevels_[atom.typeId()]].addAtom(atom); }
+
+   /*
+   * Remove an atom from the grid of its level.
+   */
+   inline void MultiCellList::deleteAtom(Atom& atom)
+   {  cellLists_[typeLevels_[atom.typeId()]].deleteAtom(atom); }
+
+   /*
+   * Update the cell of an atom.
+   */
+   inline void MultiCellList::updateAtomCell(Atom& atom, const Vector& pos)
+   {  cellLists_[typeLevels_[atom.typeId()]].updateAtomCell(atom, pos); }
+
+   /*
+   * Shift coordinate x to the range 0 <= x < n.
+   */
+   inline int MultiCellList::shift(int x, int n)
+   {
+      if (x < 0) {
+         x += n*(1 + (-x)/n);
+      }
+      return x % n;
+   }
+
+   /*
+   * Get a cell of one level by periodically shifted coordinates.
+   */
+   inline
+   const Cell& MultiCellList::cell(int level, const IntVector& coords) const
+   {
+      const CellList& list = cellLists_[level];
+      IntVector c;
+      for (int k = 0; k < Dimension; ++k) {
+         c[k] = shift(coords[k], list.gridDimension(k));
+      }
+      return list.cell(list.cellIndex(c));
+   }
+
+   /*
+   * Get range of cells of one level to search for neighbors.
+   */
+   inline
+   void MultiCellList::getSearchRange(const Vector& pos, int typeId,
+                                      int level, IntVector& lower,
+                                      IntVector& upper) const
+   {
+      const CellList& list = cellLists_[level];
+      const IntVector& widths
+                    = searchWidths_[typeLevels_[typeId]*nLevel_ + level];
+      IntVector c;
+      list.getCellCoordinates(list.cellIndexFromPosition(pos), c);
+      int n;
+      for (int k = 0; k < Dimension; ++k) {
+         n = list.gridDimension(k);
+         if (2*widths[k] + 1 >= n) {
+            lower[k] = 0;
+            upper[k] = n - 1;
+         } else {
+            lower[k] = c[k] - widths[k];
+            upper[k] = c[k] + widths[k];
+         }
+      }
+   }
+
+}
+#endif
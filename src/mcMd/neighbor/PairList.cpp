@@ -9,8 +9,11 @@
 #include "PairIterator.h"
 #include <mcMd/chemistry/Atom.h>
 #include <util/space/Vector.h>
+#include <util/space/Dimension.h>
 #include <util/global.h>
 
+#include <math.h>
+
 namespace McMd
 {
 
@@ -25,8 +28,11 @@ namespace McMd
       atom2Ptrs_(),
       first_(),
       oldPositions_(),
+      oldLengths_(),
       skin_(-1.0),
       cutoff_(-1.0),
+      typeCutoffSq_(),
+      nAtomType_(0),
       atomCapacity_(0),
       pairCapacity_(0),
       nAtom1_(0),
@@ -36,7 +42,8 @@ namespace McMd
       maxNAtom_(0),
       maxNAtom2_(0),
       buildCounter_(0),
-      isInitialized_(false)
+      isInitialized_(false),
+      typePairList_(false)
    {  setClassName("PairList"); }
    
    /*
@@ -53,6 +60,8 @@ namespace McMd
       read<int>(in, "atomCapacity", atomCapacity_);
       read<int>(in, "pairCapacity", pairCapacity_);
       read<double>(in, "skin", skin_);
+      typePairList_ = false;
+      readOptional<bool>(in, "typePairList", typePairList_);
    }
 
    /*
@@ -63,6 +72,8 @@ namespace McMd
       loadParameter<int>(ar, "atomCapacity", atomCapacity_);
       loadParameter<int>(ar, "pairCapacity", pairCapacity_);
       loadParameter<double>(ar, "skin", skin_);
+      typePairList_ = false;
+      loadParameter<bool>(ar, "typePairList", typePairList_, false);
       ar >> cutoff_;
       ar >> cellList_;
 
@@ -78,6 +89,7 @@ namespace McMd
       ar << atomCapacity_;
       ar << pairCapacity_;
       ar << skin_;
+      Parameter::saveOptional(ar, typePairList_, typePairList_);
       ar << cutoff_;
       ar << cellList_;
    }
@@ -101,6 +113,35 @@ namespace McMd
       allocate();
    }
 
+   /*
+   * Set potential cutoffs for all pairs of atom types.
+   */
+   void PairList::setTypeCutoffs(const DMatrix<double>& cutoffs)
+   {
+      int nAtomType = cutoffs.capacity1();
+      if (nAtomType <= 0 || cutoffs.capacity2() != nAtomType) {
+         UTIL_THROW("Type cutoff matrix must be square");
+      }
+      if (typeCutoffSq_.isAllocated()) {
+         if (nAtomType_ != nAtomType) {
+            UTIL_THROW("Inconsistent number of atom types");
+         }
+      } else {
+         typeCutoffSq_.allocate(nAtomType*nAtomType);
+         nAtomType_ = nAtomType;
+      }
+      double c;
+      for (int i = 0; i < nAtomType; ++i) {
+         for (int j = 0; j < nAtomType; ++j) {
+            c = cutoffs(i, j) + skin_;
+            if (c > cutoff_ + 1.0E-10) {
+               UTIL_THROW("Type pair cutoff exceeds PairList cutoff");
+            }
+            typeCutoffSq_[i*nAtomType + j] = c*c;
+         }
+      }
+   }
+
    /*
    * Allocate CellList and PairList arrays, initialize to empty state.
    */
@@ -147,6 +188,7 @@ namespace McMd
    void PairList::setup(const Boundary& boundary)
    {
       cellList_.setup(boundary, cutoff_); 
+      oldLengths_ = boundary.lengths();
       nAtom1_ = 0;
       nAtom2_ = 0; 
       nAtom_ = 0;
@@ -176,15 +218,18 @@ namespace McMd
       Vector  iPos, jPos;
       Atom   *iAtomPtr, *jAtomPtr;
       double  dRSq, cutoffSq;
+      const double* rowCutoffSq = 0;
       int     nCellNeighbor, nCellAtom, totCells;
       int     ic, ip, iAtomId, jp, jAtomId;
       bool    foundNeighbor;
+      bool    useTypes = (typePairList_ && nAtomType_ > 0);
   
       // Precondition
       assert(isInitialized());
  
       // Set maximum squared-separation for pairs in Pairlist
       cutoffSq = cutoff_*cutoff_;
+      oldLengths_ = boundary.lengths();
    
       // Initialize counters for primary atoms and neighbors
       nAtom1_ = 0; // Number of primary atoms with neighbors
@@ -208,6 +253,9 @@ namespace McMd
             iAtomPtr = cellNeighbor[ip]; 
             iPos = iAtomPtr->position();
             iAtomId = iAtomPtr->id();
+            if (useTypes) {
+               rowCutoffSq = &typeCutoffSq_[iAtomPtr->typeId()*nAtomType_];
+            }
             ++nAtom_;
             if (nAtom_ > atomCapacity_) {
                UTIL_THROW("Overflow: nAtom_ > atomCapacity_ in PairList");
@@ -230,6 +278,9 @@ namespace McMd
    
                      // Calculate distance between atoms i and j
                      dRSq = boundary.distanceSq(iPos, jPos);
+                     if (useTypes) {
+                        cutoffSq = rowCutoffSq[jAtomPtr->typeId()];
+                     }
    
                      if (dRSq < cutoffSq) {
       
@@ -318,6 +369,20 @@ namespace McMd
   
       // If the list has never been built, it is not current. 
       if (buildCounter_ == 0) return false;
+
+      // Affine scaling factors and maximum strain since the last build
+      Vector lengths = boundary.lengths();
+      Vector scale;
+      double strain = 0.0;
+      for (int i = 0; i < Dimension; ++i) {
+         scale[i] = lengths[i]/oldLengths_[i];
+         if (fabs(scale[i] - 1.0) > strain) {
+            strain = fabs(scale[i] - 1.0);
+         }
+      }
+      if (strain > 0.0) {
+         return isCurrent(boundary, scale, strain);
+      }
    
       dRSqMax = 0.25*skin_*skin_;
 
@@ -342,6 +407,40 @@ namespace McMd
       return true;
    }
 
+   /*
+   * Displacement test relative to affinely scaled old positions (private).
+   */
+   bool PairList::isCurrent(const Boundary& boundary, const Vector& scale,
+                            double strain) const
+   {
+      double dRMax = 0.5*(skin_ - strain*cutoff_);
+      if (dRMax <= 0.0) return false;
+      double dRSqMax = dRMax*dRMax;
+      Vector oldPos;
+      double dRSq;
+      int    ip, i;
+
+      for (ip = 0; ip < nAtom1_; ++ip) {
+         for (i = 0; i < Dimension; ++i) {
+            oldPos[i] = oldPositions_[ip][i]*scale[i];
+         }
+         dRSq = boundary.distanceSq(atom1Ptrs_[ip]->position(), oldPos);
+         if (dRSq > dRSqMax) {
+            return false;
+         }
+      }
+      for (ip = atomCapacity_ - 1; ip > tList1_; --ip) {
+         for (i = 0; i < Dimension; ++i) {
+            oldPos[i] = oldPositions_[ip][i]*scale[i];
+         }
+         dRSq = boundary.distanceSq(atom1Ptrs_[ip]->position(), oldPos);
+         if (dRSq > dRSqMax) {
+            return false;
+         }
+      }
+      return true;
+   }
+
    /*
    * Clear all statistics.
    */
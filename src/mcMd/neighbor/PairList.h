@@ -12,6 +12,7 @@
 #include <util/boundary/Boundary.h>
 #include <util/param/ParamComposite.h>
 #include <util/containers/DArray.h>
+#include <util/containers/DMatrix.h>
 #include <util/space/Vector.h>
 
 class PairListTest;
@@ -53,6 +54,20 @@ namespace McMd
    * positions that were stored when the PairList was last built. In an MD
    * simulation, isCurrent() should be called after every time step, and 
    * the PairList should be rebuilt if its return value is false.
+   *
+   * If the box lengths have changed since the PairList was built, as in
+   * a constant pressure simulation, the stored positions are first scaled
+   * affinely to the current box, and part of the skin is allotted to the
+   * strain of the box (see isCurrent()), so that a box rescaling does not
+   * by itself require a rebuild.
+   *
+   * If the optional parameter typePairList is true, and setTypeCutoffs()
+   * has been called, each pair is instead retained only if it is within
+   * the potential cutoff for its pair of atom types plus the skin, so
+   * that pairs of types with a short cutoff (e.g., WCA pairs in a system
+   * that also contains longer range LJ pairs) are not listed beyond the
+   * range at which they could come within their own cutoff before the
+   * next rebuild.
    * 
    *
    * \ingroup McMd_Neighbor_Module 
@@ -114,6 +129,18 @@ namespace McMd
       * \param potentialCutoff  range of pair potential, without skin
       */
       void initialize(int atomIdEnd, double potentialCutoff);
+
+      /**
+      * Set potential cutoffs for all pairs of atom types.
+      *
+      * Used by build() only if typePairList() is true. Element (i, j)
+      * is the cutoff for atoms of types i and j, which must not exceed
+      * the potentialCutoff passed to initialize(). May be called again
+      * after the cutoffs are modified, to take effect at the next build.
+      *
+      * \param cutoffs square matrix of type pair cutoffs
+      */
+      void setTypeCutoffs(const DMatrix<double>& cutoffs);
   
       /**
       * Setup an empty grid of cells for the internal cell list.
@@ -156,6 +183,36 @@ namespace McMd
       * \param iterator a PairList, initialized on output
       */
       void begin(PairIterator &iterator) const;
+
+      /**
+      * Get the number of primary atoms, i.e., atoms with neighbors.
+      *
+      * Primary atoms are indexed by 0 <= i < nAtom1(). This and the
+      * getPrimary() and neighborPtr() functions allow the pairs of
+      * different primary atoms to be divided among threads. Otherwise,
+      * a PairIterator should be used to loop over pairs.
+      */
+      int nAtom1() const;
+
+      /**
+      * Get a primary atom and the range of indices of its neighbors.
+      *
+      * On return, neighborPtr(j) for begin <= j < end are the secondary
+      * atoms of all pairs that contain primary atom *atomPtr.
+      *
+      * \param i       index of primary atom, 0 <= i < nAtom1()
+      * \param atomPtr pointer to primary atom (output)
+      * \param begin   index of first neighbor (output)
+      * \param end     one more than index of last neighbor (output)
+      */
+      void getPrimary(int i, Atom*& atomPtr, int& begin, int& end) const;
+
+      /**
+      * Get a secondary atom by its index in the list of neighbors.
+      *
+      * \param j  index of neighbor, 0 <= j < nPair()
+      */
+      Atom* neighborPtr(int j) const;
  
       //@}
       /// \name Accessors (miscellaneous)
@@ -175,6 +232,11 @@ namespace McMd
       * Has the initialize function been called?
       */
       bool isInitialized() const;
+
+      /**
+      * Are pairs selected with a separate cutoff for each type pair?
+      */
+      bool typePairList() const;
    
       /**
       * Returns true if PairList is current, false otherwise.
@@ -186,6 +248,14 @@ namespace McMd
       * nonbonded potential (i.e., the maxCutoff member of a PairPotential 
       * object).
       *
+      * If the box lengths L have changed from values L0 at the time of
+      * the last build, displacements are instead measured relative to the
+      * stored positions scaled by L/L0, and the threshold is reduced to
+      * (skin - e*cutoff)/2, where e is the maximum of |L/L0 - 1| over all
+      * directions and cutoff is the pair list cutoff. This guarantees that
+      * no pair that was farther apart than cutoff is now within the
+      * potential cutoff.
+      *
       * \param  boundary  Boundary object containing simulation cell dimensions
       * \return true if the Pairlist is valid, false if it is outdated
       */
@@ -193,6 +263,14 @@ namespace McMd
 
       /// Return true if valid, or throw Exception.
       bool isValid() const;
+
+      /**
+      * Get the internal CellList by const reference.
+      *
+      * The CellList reflects atomic positions at the most recent call 
+      * of addAtom(), which are not updated as atoms move.
+      */
+      const CellList& cellList() const;
   
       //@}
       /// \name Statistics
@@ -237,11 +315,20 @@ namespace McMd
       /// Array of old atom positions.
       DArray<Vector>  oldPositions_;
 
+      /// Box lengths when the PairList was last built.
+      Vector oldLengths_;
+
       /// Extra distance to add to pair potential cutoff.
       double  skin_;
    
       /// Pair list cutoff radius (pair potential cutoff + skin_).
       double cutoff_;
+
+      /// Squared list cutoffs for type pairs, element i*nAtomType + j.
+      DArray<double> typeCutoffSq_;
+
+      /// Number of atom types in typeCutoffSq_ (0 if not set).
+      int nAtomType_;
    
       /// Maximum number of atoms (dimension of atom1Ptrs_).
       int  atomCapacity_;     
@@ -273,12 +360,25 @@ namespace McMd
 
       /// Has the initialize function been called?
       bool isInitialized_;
+
+      /// Use a separate list cutoff for each pair of atom types?
+      bool typePairList_;
   
       /**
       * Allocate memory for PairList.
       */
       void allocate();
 
+      /**
+      * Test displacements relative to affinely scaled old positions.
+      *
+      * \param boundary current Boundary
+      * \param scale  ratios L/L0 of current to old box lengths
+      * \param strain maximum of |L/L0 - 1| over directions
+      */
+      bool isCurrent(const Boundary& boundary, const Vector& scale,
+                     double strain) const;
+
       /* 
       * Implementation Notes:
       *
@@ -354,6 +454,12 @@ namespace McMd
    inline void PairList::addAtom(Atom &atom)
    {  cellList_.addAtom(atom); }
 
+   /*
+   * Get the internal CellList.
+   */
+   inline const CellList& PairList::cellList() const
+   {  return cellList_; }
+
    /*
    * Get the current number of atoms in the pairlist.
    */ 
@@ -366,6 +472,34 @@ namespace McMd
    inline int PairList::nPair() const
    {  return nAtom2_; }
 
+   /*
+   * Return number of primary atoms.
+   */
+   inline int PairList::nAtom1() const
+   {  return nAtom1_; }
+
+   /*
+   * Get a primary atom and the range of its neighbors.
+   */
+   inline 
+   void PairList::getPrimary(int i, Atom*& atomPtr, int& begin, int& end) 
+   const
+   {
+      assert(i >= 0 && i < nAtom1_);
+      atomPtr = atom1Ptrs_[i];
+      begin = first_[i];
+      end = first_[i+1];
+   }
+
+   /*
+   * Return pointer to a secondary atom.
+   */
+   inline Atom* PairList::neighborPtr(int j) const
+   {
+      assert(j >= 0 && j < nAtom2_);
+      return atom2Ptrs_[j];
+   }
+
    /*
    * Get the maximum value of aAtom() since instantiation.
    */ 
@@ -390,5 +524,11 @@ namespace McMd
    inline bool PairList::isInitialized() const
    {  return isInitialized_; }
 
+   /*
+   * Are pairs selected with a separate cutoff for each type pair?
+   */
+   inline bool PairList::typePairList() const
+   {  return typePairList_; }
+
 } 
 #endif
@@ -1,6 +1,7 @@
 
 mcMd_neighbor_=mcMd/neighbor/Cell.cpp \
     mcMd/neighbor/CellList.cpp \
+    mcMd/neighbor/MultiCellList.cpp \
     mcMd/neighbor/PairList.cpp 
 
 mcMd_neighbor_SRCS=\
@@ -59,6 +59,19 @@ namespace McMd
       */
       virtual double difference(DArray<double> iPartnerParameter) const;
 
+      /**
+      * Compute differences W(partner m) - W(current) for several partners.
+      *
+      * Each derivative dW/dp[i] is evaluated only once, and all
+      * differences are computed as linear combinations of these.
+      *
+      * \param partnerParameters matrix of partner parameters (nSet x nParameter)
+      * \param differences       array of differences (nSet elements, output)
+      */
+      virtual void 
+      differences(const DMatrix<double>& partnerParameters, 
+                  DArray<double>& differences) const;
+
       /**
       * Get the associated System by reference.
       */
@@ -101,6 +114,37 @@ namespace McMd
       return difference;
    }
 
+   /*
+   * Compute differences for several partners from one set of derivatives.
+   */
+   template <class SystemType>
+   void LinearPerturbation<SystemType>
+        ::differences(const DMatrix<double>& partnerParameters,
+                      DArray<double>& differences) const
+   {  
+      int nParameters = getNParameters();
+      int nSet = partnerParameters.capacity1();
+      if (differences.capacity() < nSet) {
+         UTIL_THROW("Array of differences is too small");
+      }
+      DArray<double> derivatives;
+      DArray<double> parameters;
+      derivatives.allocate(nParameters);
+      parameters.allocate(nParameters);
+      int i, m;
+      for (i = 0; i < nParameters; ++i) {
+         derivatives[i] = derivative(i);
+         parameters[i] = parameter(i);
+      }
+      for (m = 0; m < nSet; ++m) {
+         differences[m] = 0.0;
+         for (i = 0; i < nParameters; ++i) {
+            differences[m] += (partnerParameters(m, i) - parameters[i])
+                              * derivatives[i];
+         }
+      }
+   }
+
    /*
    * Return associated System by reference.
    */
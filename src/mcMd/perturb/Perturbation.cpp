@@ -114,6 +114,26 @@ namespace McMd
       setParameter();           // Modify associated System.
    }
 
+   /*
+   * Compute differences W(X, p'_m) - W(X, p) for several partners.
+   */
+   void Perturbation::differences(const DMatrix<double>& partnerParameters,
+                                  DArray<double>& differences) const
+   {
+      int nSet = partnerParameters.capacity1();
+      if (differences.capacity() < nSet) {
+         UTIL_THROW("Array of differences is too small");
+      }
+      DArray<double> partner;
+      partner.allocate(nParameters_);
+      for (int m = 0; m < nSet; ++m) {
+         for (int i = 0; i < nParameters_; ++i) {
+            partner[i] = partnerParameters(m, i);
+         }
+         differences[m] = difference(partner);
+      }
+   }
+
    /*
    * Get parameter i of system id.
    */
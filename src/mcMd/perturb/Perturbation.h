@@ -141,6 +141,22 @@ namespace McMd
       */
       virtual double difference(DArray<double> iPartnerParameter) const = 0;
 
+      /**
+      * Compute differences W(X, p'_m) - W(X, p) for several partners.
+      *
+      * Row m of partnerParameters contains the perturbation parameters
+      * p'_m of partner parameter set m. On return, differences[m] is set
+      * to W(X, p'_m) - W(X, p) for the current microstate. The default
+      * implementation calls difference() once for each row. Subclasses
+      * may override this to evaluate all differences in one pass.
+      *
+      * \param partnerParameters matrix of partner parameters (nSet x nParameter)
+      * \param differences       array of differences (nSet elements, output)
+      */
+      virtual void 
+      differences(const DMatrix<double>& partnerParameters, 
+                  DArray<double>& differences) const;
+
       //@}
 
    protected:
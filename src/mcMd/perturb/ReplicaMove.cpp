@@ -43,6 +43,8 @@ namespace McMd
       nParameters_(0),
       interval_(-1),
       nSampling_(-1),
+      stateId_(-1),
+      swapParameters_(false),
       ptPositionPtr_(0),
       myPositionPtr_(0),
       swapAttempt_(0),
@@ -54,9 +56,12 @@ namespace McMd
       }
 
       setClassName("ReplicaMove");
-      communicatorPtr_ = &(system.simulation().communicator());
-      myId_   = communicatorPtr_->Get_rank();
-      nProcs_ = communicatorPtr_->Get_size();
+      if (system.simulation().hasCommunicator()) {
+         communicatorPtr_ = &(system.simulation().communicator());
+      }
+      myId_   = system.simulation().replicaId();
+      nProcs_ = system.simulation().nReplica();
+      stateId_ = myId_;
 
       // Generate output file name and open the file.
       //std::stringstream sMyId;
@@ -97,6 +102,8 @@ namespace McMd
       if (nSampling_ <= 0) {
          UTIL_THROW("Invalid value input for nSampling_");
       }
+      swapParameters_ = false;
+      readOptional<bool>(in, "swapParameters", swapParameters_);
 
       // Allocate memory
       int nAtom = system().simulation().atomCapacity();
@@ -112,6 +119,11 @@ namespace McMd
       // Load parameters
       loadParameter<long>(ar, "interval", interval_);
       loadParameter<int>(ar, "nSampling", nSampling_);
+      swapParameters_ = false;
+      loadParameter<bool>(ar, "swapParameters", swapParameters_, false);
+      if (swapParameters_) {
+         ar & stateId_;
+      }
       ar & swapAttempt_;
       ar & swapAccept_;
 
@@ -136,6 +148,10 @@ namespace McMd
    {
       ar & interval_;
       ar & nSampling_;
+      Parameter::saveOptional(ar, swapParameters_, swapParameters_);
+      if (swapParameters_) {
+         ar & stateId_;
+      }
       ar & swapAttempt_;
       ar & swapAccept_;
 
@@ -144,11 +160,57 @@ namespace McMd
       myPositionPtr_ = new Vector[nAtom];
    }
    
+   /*
+   * Sample a permutation of states by a Gibbs sampler (master only).
+   */
+   void 
+   ReplicaMove::samplePermutation(const DArray< DArray<double> >& allDerivatives,
+                                  const DArray< DArray<double> >& allParameters,
+                                  DArray<int>& permutation)
+   {
+      // start with identity permutation
+      for (int i = 0; i < nProcs_; i++)
+         permutation[i] = i;
+
+      for (int n =0; n < nSampling_; n++) {
+         swapAttempt_++;
+         // choose a pair i,j, i!= j at random
+         int i = system().simulation().random().uniformInt(0,nProcs_);
+         int j = system().simulation().random().uniformInt(0,nProcs_-1);
+         if (i<=j) j++;
+
+         // apply acceptance criterium
+         double weight = 0;
+         for (int k = 0; k < nParameters_; k++) {
+            double deltaDerivative = allDerivatives[i][k] - allDerivatives[j][k];
+            // the permutations operate on the states (the perturbation parameters)
+            weight += (allParameters[permutation[j]][k] - allParameters[permutation[i]][k])*deltaDerivative;
+          }
+         double exponential = exp(-weight);
+         int accept = system().simulation().random(). metropolis(exponential) ? 1 : 0;
+
+         if (accept) {
+            swapAccept_++;
+            // swap states of pair i,j
+            int tmp = permutation[i];
+            permutation[i] = permutation[j];
+            permutation[j] = tmp;
+            }
+      }
+   }
+
    /*
    * Perform replica exchange move.
    */
    bool ReplicaMove::move()
    {
+      if (!communicatorPtr_) {
+         UTIL_THROW("ReplicaMove::move() requires a communicator");
+      }
+      if (swapParameters_) {
+         return exchangeStates();
+      }
+
       MPI::Request request[4];
       MPI::Status  status;
       System::MoleculeIterator molIter;
@@ -206,36 +268,7 @@ namespace McMd
 
          // Now we have the complete matrix U_ij = u_i(x_j), permutate nsampling steps according
          // to acceptance criterium
-  
-         // start with identity permutation
-         for (int i = 0; i < nProcs_; i++)
-            permutation[i] = i;
-
-         for (int n =0; n < nSampling_; n++) {
-            swapAttempt_++;
-            // choose a pair i,j, i!= j at random
-            int i = system().simulation().random().uniformInt(0,nProcs_);
-            int j = system().simulation().random().uniformInt(0,nProcs_-1);
-            if (i<=j) j++;
-
-            // apply acceptance criterium
-            double weight = 0;
-            for (int k = 0; k < nParameters_; k++) {
-               double deltaDerivative = allDerivatives[i][k] - allDerivatives[j][k];
-               // the permutations operate on the states (the perturbation parameters)
-               weight += (allParameters[permutation[j]][k] - allParameters[permutation[i]][k])*deltaDerivative;
-             }
-            double exponential = exp(-weight);
-            int accept = system().simulation().random(). metropolis(exponential) ? 1 : 0;
-   
-            if (accept) {
-               swapAccept_++;
-               // swap states of pair i,j
-               int tmp = permutation[i];
-               permutation[i] = permutation[j];
-               permutation[j] = tmp;
-               }
-         }
+         samplePermutation(allDerivatives, allParameters, permutation);
     
          // send exchange partner information to all other processors
          for (int i = 0; i < nProcs_; i++) {
@@ -332,6 +365,105 @@ namespace McMd
 
    }
 
+
+   /*
+   * Perform replica exchange by permuting perturbation parameters.
+   */
+   bool ReplicaMove::exchangeStates()
+   {
+      int nValue = 2*nParameters_;
+      int i, k;
+
+      // Gather derivatives and parameters of all replicas on master
+      DArray<double> myValues;
+      myValues.allocate(nValue);
+      for (k = 0; k < nParameters_; ++k) {
+         myValues[k] = system().perturbation().derivative(k);
+         myValues[nParameters_ + k] = system().perturbation().parameter(k);
+      }
+      DArray<double> allValues;
+      if (myId_ == 0) {
+         allValues.allocate(nProcs_*nValue);
+      }
+      communicatorPtr_->Gather(&myValues[0], nValue, MPI::DOUBLE,
+                               myId_ == 0 ? &allValues[0] : 0, nValue,
+                               MPI::DOUBLE, 0);
+
+      // Every replica needs the state indices of all replicas
+      DArray<int> allStateIds;
+      allStateIds.allocate(nProcs_);
+      communicatorPtr_->Allgather(&stateId_, 1, MPI::INT, 
+                                  &allStateIds[0], 1, MPI::INT);
+
+      // On master, sample permutation. Element 2*i of partners is the 
+      // rank whose state replica i adopts, and element 2*i + 1 is the 
+      // rank that adopts the old state of replica i.
+      DArray<int> partners;
+      if (myId_ == 0) {
+         DArray< DArray<double> > allDerivatives;
+         DArray< DArray<double> > allParameters;
+         allDerivatives.allocate(nProcs_);
+         allParameters.allocate(nProcs_);
+         for (i = 0; i < nProcs_; ++i) {
+            allDerivatives[i].allocate(nParameters_);
+            allParameters[i].allocate(nParameters_);
+            for (k = 0; k < nParameters_; ++k) {
+               allDerivatives[i][k] = allValues[i*nValue + k];
+               allParameters[i][k]  = allValues[i*nValue + nParameters_ + k];
+            }
+         }
+         DArray<int> permutation;
+         permutation.allocate(nProcs_);
+         samplePermutation(allDerivatives, allParameters, permutation);
+
+         partners.allocate(2*nProcs_);
+         for (i = 0; i < nProcs_; ++i) {
+            partners[2*i] = permutation[i];
+            partners[2*permutation[i] + 1] = i;
+         }
+      }
+      int myPartners[2];
+      communicatorPtr_->Scatter(myId_ == 0 ? &partners[0] : 0, 2, MPI::INT,
+                                myPartners, 2, MPI::INT, 0);
+
+      if (myPartners[0] == myId_) {
+         // no exchange necessary
+         recordState();
+         return false;
+      }
+
+      sendRecvPair pair;
+      pair[0] = myPartners[1];
+      pair[1] = myPartners[0];
+      adoptState(allStateIds[myPartners[0]], pair);
+      return true;
+   }
+
+   /*
+   * Adopt the parameters of another state.
+   */
+   void ReplicaMove::adoptState(int stateId, sendRecvPair partners)
+   {
+      stateId_ = stateId;
+      DArray<double> parameters;
+      parameters.allocate(nParameters_);
+      for (int k = 0; k < nParameters_; ++k) {
+         parameters[k] = system().perturbation().parameter(k, stateId_);
+      }
+      system().perturbation().setParameter(parameters);
+
+      // Notify component observers.
+      Notifier<sendRecvPair>::notifyObservers(partners);
+
+      recordState();
+   }
+
+   /*
+   * Log index of current state to file.
+   */
+   void ReplicaMove::recordState()
+   {  outputFile_ << stateId_ << std::endl; }
+
 }
 #endif // ifdef UTIL_MPI
 #endif // ifdef MCMD_PERTURB
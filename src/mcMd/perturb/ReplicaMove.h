@@ -58,6 +58,16 @@ namespace McMd
    *
    * The technique is described in detail in
    * John D. Chodera and Michael R. Shirts, J. Chem. Phys. 135, 194110 (2011)
+   *
+   * If the optional parameter \b swapParameters is true, the sampled 
+   * permutation is applied to the perturbation parameters rather than to
+   * the configurations: every replica keeps its own atomic positions and
+   * boundary, and adopts the parameters of another state. Each exchange 
+   * then requires only one gather of 2*nParameters doubles and one scatter
+   * of two integers per replica, rather than point-to-point transfer of
+   * all atomic positions. The index of the state held by each replica is
+   * written to the repx file after each attempt, and is needed to map
+   * output files of different replicas onto states. 
    * 
    * \ingroup McMd_Perturb_Module
    */
@@ -88,6 +98,10 @@ namespace McMd
       * Empirically, \b nSampling should be on the order of P^3 .. P^5,
       * where P is the number of processors.
       *
+      * The optional boolean parameter \b swapParameters (default false)
+      * selects exchange of perturbation parameters rather than of
+      * configurations.
+      *
       * \param in input stream from which to read parameters.
       */
       virtual void readParameters(std::istream& in);
@@ -126,6 +140,13 @@ namespace McMd
       /**
       * Notify observers of a successful replica exchange
       *
+      * When configurations are exchanged, partners[0] is the rank to 
+      * which the configuration of this replica was sent and partners[1]
+      * is the rank from which the new configuration was received. When
+      * parameters are exchanged, partners[0] is the rank that adopted 
+      * the old state of this replica and partners[1] is the rank whose
+      * old state this replica adopted.
+      *
       * \param partners a pair of indices of partner replicas. Needs to be known
       *  for communication.
       */
@@ -141,6 +162,57 @@ namespace McMd
       */
       long nAccept(); 
 
+      /**
+      * Index of the perturbation state currently held by this replica.
+      *
+      * This equals the rank of this processor unless swapParameters
+      * is enabled.
+      */
+      int stateId() const;
+
+      /**
+      * Number of steps of the Gibbs sampler per exchange attempt.
+      */
+      int nSampling() const;
+
+      /**
+      * Are perturbation parameters exchanged, rather than configurations?
+      */
+      bool swapParameters() const;
+
+      /**
+      * Sample a permutation of states by a Gibbs sampler.
+      *
+      * Element i of the permutation is the index of the replica whose
+      * state is adopted by replica i. Called by the master processor
+      * (or the master replica), which counts attempts and acceptances.
+      *
+      * \param allDerivatives  derivatives of weight for all replicas
+      * \param allParameters   perturbation parameters of all replicas
+      * \param permutation     new state of each replica (output)
+      */
+      void samplePermutation(const DArray< DArray<double> >& allDerivatives,
+                             const DArray< DArray<double> >& allParameters,
+                             DArray<int>& permutation);
+
+      /**
+      * Adopt the perturbation parameters of another state.
+      *
+      * Sets the parameters of state stateId, notifies observers with the
+      * partners defined as for swapParameters mode, and writes the new
+      * state index to the repx file.
+      *
+      * \param stateId   index of the new state
+      * \param partners  replica that adopts the old state of this one,
+      *                  and replica whose old state this one adopts
+      */
+      void adoptState(int stateId, sendRecvPair partners);
+
+      /**
+      * Write the index of the current state to the repx file.
+      */
+      void recordState();
+
    protected:
 
       /**
@@ -156,10 +228,10 @@ namespace McMd
       /// Get the communicator in the simulation.
       MPI::Intracomm* communicatorPtr_;
 
-      /// Current processor's rank.
+      /// Index of this replica (processor rank, unless set otherwise).
       int   myId_;
 
-      /// Number of processors.
+      /// Number of replicas (processors, unless set otherwise).
       int   nProcs_;
 
       /// Output file stream storing the acceptance statistics.
@@ -174,6 +246,12 @@ namespace McMd
       /// Number of state swaps before exchanging
       int nSampling_;
 
+      /// Index of perturbation state of this replica.
+      int stateId_;
+
+      /// If true, exchange perturbation parameters, not configurations.
+      bool swapParameters_;
+
       /// Pointer to allocated buffer to store atom positions.
       Vector   *ptPositionPtr_;
 
@@ -186,6 +264,11 @@ namespace McMd
       /// Count of accepted swaps
       long  swapAccept_;
 
+      /**
+      * Perform a replica exchange move by exchanging parameters.
+      */
+      bool exchangeStates();
+
    };
    // Inline methods
 
@@ -213,6 +296,24 @@ namespace McMd
    inline long ReplicaMove::nAccept()
    {  return swapAccept_; }
 
+   /*
+   * Index of current perturbation state.
+   */
+   inline int ReplicaMove::stateId() const
+   {  return stateId_; }
+
+   /*
+   * Number of Gibbs sampler steps per attempt.
+   */
+   inline int ReplicaMove::nSampling() const
+   {  return nSampling_; }
+
+   /*
+   * Are parameters exchanged rather than configurations?
+   */
+   inline bool ReplicaMove::swapParameters() const
+   {  return swapParameters_; }
+
    /*
    * Return reference to parent System.
    */
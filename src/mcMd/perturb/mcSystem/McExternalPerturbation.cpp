@@ -70,6 +70,7 @@ namespace McMd
    void McExternalPerturbation<Interaction>::setParameter()
    {  
      interaction().setExternalParameter(parameter_[0]);
+     system().clearExternalEnergyCache();
    }
 
    /* 
@@ -148,6 +148,7 @@ namespace McMd
    void McExternalPerturbation<Interaction>::setParameter()
    {
       interaction().setExternalParameter(parameter_[0]);
+      system().clearExternalEnergyCache();
    }
 
    /* 
@@ -187,6 +187,7 @@ namespace McMd
    { 
       pairInteraction().setEpsilon(0, 1, parameter_[0]);
       externalInteraction().setExternalParameter(parameter_[1]);
+      system().clearExternalEnergyCache();
    }
 
    /* 
@@ -394,16 +394,21 @@ namespace McMd
    template <class Interaction>
    void AnglePotentialImpl<Interaction>::addForces() 
    {
-      Vector dr1, dr2, force1, force2;
-      System::MoleculeIterator molIter;
-      Molecule::AngleIterator angleIter;
-      Atom *atom0Ptr, *atom1Ptr, *atom2Ptr;
-      int iSpec;
+      int iSpec, iMol, nMol;
 
+      // Molecules contain different atoms, and may be divided among threads
       for (iSpec=0; iSpec < simulation().nSpecies(); ++iSpec) {
          if (simulation().species(iSpec).nAngle() > 0) {
-            for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
-               for (molIter->begin(angleIter); angleIter.notEnd(); ++angleIter){
+            nMol = nMolecule(iSpec);
+            #ifdef MCMD_OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for (iMol = 0; iMol < nMol; ++iMol) {
+               Molecule& molecule = system().molecule(iSpec, iMol);
+               Molecule::AngleIterator angleIter;
+               Vector dr1, dr2, force1, force2;
+               Atom *atom0Ptr, *atom1Ptr, *atom2Ptr;
+               for (molecule.begin(angleIter); angleIter.notEnd(); ++angleIter){
                   atom0Ptr = &(angleIter->atom(0));
                   atom1Ptr = &(angleIter->atom(1));
                   atom2Ptr = &(angleIter->atom(2));
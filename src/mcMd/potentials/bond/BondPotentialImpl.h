@@ -11,6 +11,8 @@
 #include <util/global.h>
 #include <mcMd/potentials/bond/BondPotential.h>
 #include <mcMd/simulation/SystemInterface.h>
+#include <simp/interaction/bond/BondLengthTable.h>  // member template parameter
+#include <util/containers/DArray.h>                 // member template
 
 namespace Util
 {
@@ -22,12 +24,19 @@ namespace McMd
 {
 
    using namespace Util;
+   using namespace Simp;
 
    class System;
 
    /**
    * Implementation template for a BondPotential.
    *
+   * Random bond lengths are drawn by inversion of a BondLengthTable
+   * for each bond type, which is built from the energy function of the
+   * Interaction when first needed, and rebuilt when beta or a parameter
+   * changes. This makes each draw cost one random number and a binary
+   * search, and works for any Interaction.
+   *
    * \ingroup McMd_Bond_Module
    */
    template <class Interaction>
@@ -88,7 +97,11 @@ namespace McMd
       virtual double forceOverR(double rsq, int bondTypeId) const;
 
       /**
-      * Return force / separation for a single pair.
+      * Return a bond length chosen from the Boltzmann distribution.
+      *
+      * \param random     random number generator
+      * \param beta       inverse temperature
+      * \param bondTypeId bond type index
       */
       virtual 
       double randomBondLength(Random* random, double beta, int bondTypeId) 
@@ -102,7 +115,12 @@ namespace McMd
       * \param value  new value of parameter
       */
       void set(std::string name, int type, double value)
-      {   interactionPtr_->set(name, type, value); }
+      {
+         interactionPtr_->set(name, type, value);
+         if (tables_.isAllocated()) {
+            tables_[type].clear();
+         }
+      }
 
       /**
       * Get a parameter value, identified by a string.
@@ -161,6 +179,9 @@ namespace McMd
   
       Interaction* interactionPtr_;
 
+      /// Inverse cumulative bond length tables, indexed by bond type.
+      mutable DArray<BondLengthTable> tables_;
+
       bool isCopy_;
 
       /**
@@ -199,6 +220,7 @@ namespace McMd
     : BondPotential(),
       SystemInterface(system),
       interactionPtr_(0),
+      tables_(),
       isCopy_(false)
    { interactionPtr_ = new Interaction(); }
  
@@ -211,6 +233,7 @@ namespace McMd
     : BondPotential(),
       SystemInterface(other.system()),
       interactionPtr_(&other.interaction()),
+      tables_(),
       isCopy_(true)
    {}
  
@@ -286,12 +309,21 @@ namespace McMd
    { return interaction().forceOverR(rsq, iBondType); }
 
    /*
-   * Return force / separation for a single bonded pair.
+   * Return a random bond length, from a table built when needed.
    */
    template <class Interaction> double 
    BondPotentialImpl<Interaction>::
       randomBondLength(Random* random, double beta, int bondTypeId) const
-   { return interaction().randomBondLength(random, beta, bondTypeId); }
+   {
+      if (!tables_.isAllocated()) {
+         tables_.allocate(simulation().nBondType());
+      }
+      BondLengthTable& table = tables_[bondTypeId];
+      if (!table.isBuilt() || table.beta() != beta) {
+         table.build(interaction(), bondTypeId, beta);
+      }
+      return table.draw(*random);
+   }
 
    /*
    * Return bond energy for one Atom. 
@@ -352,18 +384,23 @@ namespace McMd
    template <class Interaction>
    void BondPotentialImpl<Interaction>::addForces() 
    {
-      Vector force;
-      double rsq;
-      System::MoleculeIterator molIter;
-      Molecule::BondIterator bondIter;
-      Atom *atom0Ptr, *atom1Ptr;
-      int iSpec;
+      int iSpec, iMol, nMol;
 
-      // Loop over all bonds in system
+      // Loop over all bonds in system. Bonds of different molecules 
+      // contain different atoms, so molecules may be divided among threads.
       for (iSpec=0; iSpec < simulation().nSpecies(); ++iSpec) {
          if (simulation().species(iSpec).nBond() > 0) {
-            for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
-               for (molIter->begin(bondIter); bondIter.notEnd(); ++bondIter) {
+            nMol = nMolecule(iSpec);
+            #ifdef MCMD_OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for (iMol = 0; iMol < nMol; ++iMol) {
+               Molecule& molecule = system().molecule(iSpec, iMol);
+               Molecule::BondIterator bondIter;
+               Vector force;
+               double rsq;
+               Atom *atom0Ptr, *atom1Ptr;
+               for (molecule.begin(bondIter); bondIter.notEnd(); ++bondIter) {
                   atom0Ptr = &(bondIter->atom(0));
                   atom1Ptr = &(bondIter->atom(1));
                   rsq = boundary().distanceSq(atom0Ptr->position(), 
@@ -8,7 +8,9 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
-#include "CoulombPotential.h"
+#include <mcMd/potentials/coulomb/MdCoulombPotential.h>   // base class
+#include <simp/interaction/coulomb/EwaldInteraction.h>    // return value
+#include <util/space/Vector.h>                            // argument
 
 namespace McMd
 {
@@ -16,36 +18,142 @@ namespace McMd
    class Atom;
 
    using namespace Util;
+   using namespace Simp;
 
    /**
-   * Long-range part of Coulomb potential for MC.
+   * Long-range part of Coulomb potential with incremental updates for MC.
+   *
+   * This interface adds to MdCoulombPotential a set of functions that
+   * compute changes in the k-space energy produced by a trial move of
+   * one or more charges, at a cost proportional to the number of
+   * wavevectors per charge, rather than recomputing all Fourier modes
+   * of the charge density. A trial move is described by a sequence of
+   * calls to addTrialMove(), insertTrialCharge() and removeTrialCharge()
+   * after clearTrial(), which accumulate changes in the Fourier modes.
+   * The trial energy change is returned by trialEnergyChange(), and the
+   * stored Fourier modes are updated by acceptTrial() if the move is
+   * accepted. A rejected move needs only clearTrial() before the next.
+   *
+   * For configurational-bias regrowth, trialInsertionEnergy() returns
+   * the energy of one more charge added to the current trial state,
+   * without changing that state, so that several candidate positions
+   * can be compared before one is added with insertTrialCharge().
+   *
+   * The stored Fourier modes are recomputed from all atoms when first
+   * needed, and after any call of unsetEnergy() or unsetWaves(). Any
+   * change in atomic positions that is not committed by acceptTrial()
+   * or moveCharge() must therefore be followed by a call of unsetEnergy().
+   * McSystem calls moveCharge() for each atom reported by its
+   * atomMoveSignal(), and unsetWaves() after untracked moves.
    *
    * \ingroup McMd_Coulomb_Module
    */
-   class McCoulombPotential : public CoulombPotential
+   class McCoulombPotential : public MdCoulombPotential
    {
 
    public:
 
       /**
-      * Constructor .
+      * Constructor.
       */
-      McCoulombPotential(System& system);
+      McCoulombPotential()
+       : MdCoulombPotential()
+      {}
 
       /**
       * Destructor (does nothing)
       */
-      virtual ~McCoulombPotential();
+      virtual ~McCoulombPotential()
+      {}
+
+      /**
+      * Discard all changes of the current trial move.
+      */
+      virtual void clearTrial() = 0;
+
+      /**
+      * Add the displacement of one atom to the trial move.
+      *
+      * \param atom        Atom to be moved (at its old position)
+      * \param newPosition new position of the atom
+      */
+      virtual void addTrialMove(const Atom& atom,
+                                const Vector& newPosition) = 0;
 
       /**
-      * Calculate the covalent bond energy for one Atom.
+      * Add insertion of a new charge to the trial move.
+      *
+      * \param charge   charge of inserted particle
+      * \param position position of inserted particle
+      */
+      virtual void insertTrialCharge(double charge,
+                                     const Vector& position) = 0;
+
+      /**
+      * Add removal of an existing charge to the trial move.
+      *
+      * \param charge   charge of removed particle
+      * \param position position of removed particle
+      */
+      virtual void removeTrialCharge(double charge,
+                                     const Vector& position) = 0;
+
+      /**
+      * Energy of one more charge added to the current trial state.
+      *
+      * Does not modify the trial state.
+      *
+      * \param charge   charge of candidate particle
+      * \param position candidate position
+      * \return change in k-space energy, including self-energy
+      */
+      virtual double trialInsertionEnergy(double charge,
+                                          const Vector& position) = 0;
+
+      /**
+      * Change in k-space energy produced by the current trial move.
+      */
+      virtual double trialEnergyChange() = 0;
+
+      /**
+      * Commit the current trial move to the stored Fourier modes.
+      *
+      * Also updates the k-space energy, if it is set, and clears the
+      * trial state. This should be called after the atomic positions
+      * of an accepted move are updated.
+      */
+      virtual void acceptTrial() = 0;
+
+      /**
+      * Calculate the k-space energy of one Atom.
+      *
+      * Returns the decrease in k-space energy produced by removal
+      * of the atom, which is the interaction of its charge with all
+      * other charges and periodic images. Clears any trial move.
       *
       * \param  atom Atom object of interest
-      * \return bond potential energy of atom
+      * \return k-space energy of atom
+      */
+      virtual double kspaceAtomEnergy(const Atom& atom) = 0;
+
+      /**
+      * Update stored Fourier modes after an accepted move of one atom.
+      *
+      * The atom must hold its new position. Clears any trial move. Does
+      * nothing if the Fourier modes are not stored, since they are then
+      * recomputed from current positions when next needed.
+      *
+      * \param atom        Atom that was moved (at its new position)
+      * \param oldPosition position of the atom before the move
+      */
+      virtual void moveCharge(const Atom& atom, const Vector& oldPosition) = 0;
+
+      /**
+      * Get the Ewald interaction (alpha, epsilon and real space cutoff).
       */
-      virtual double kspaceAtomEnergy(const Atom& atom) const = 0;
+      virtual EwaldInteraction& ewaldInteraction() = 0;
 
    };
 
-} 
+}
 #endif
@@ -20,22 +20,55 @@
 #include <cmath>
 #include <util/containers/Array.h>
 #include <mcMd/chemistry/AtomType.h>
+#include <mcMd/chemistry/Atom.h>
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace McMd
 {
 
    using namespace Util;
 
+   namespace {
+
+      /*
+      * Tabulate cos(2 pi m x) and sin(2 pi m x) for m = base, ...,
+      * base + n - 1 by recurrence, storing m - base at c[(m-base)*stride].
+      */
+      inline void tabulatePhases(double x, int base, int n, int stride,
+                                 double* c, double* s)
+      {
+         double arg = 2.0*Constants::Pi*x;
+         double dc = cos(arg);
+         double ds = sin(arg);
+         double cm = cos(arg*double(base));
+         double sm = sin(arg*double(base));
+         double t;
+         for (int m = 0; m < n; ++m) {
+            c[m*stride] = cm;
+            s[m*stride] = sm;
+            t  = cm*dc - sm*ds;
+            sm = sm*dc + cm*ds;
+            cm = t;
+         }
+      }
+
+   }
+
    /*
    * Constructor.
    */
    MdEwaldPotential::MdEwaldPotential(System& system)
-    : MdCoulombPotential(),
+    : McCoulombPotential(),
       ewaldInteraction_(),
       simulationPtr_(&system.simulation()),
       systemPtr_(&system),
       boundaryPtr_(&system.boundary()),
-      atomTypesPtr_(&system.simulation().atomTypes())
+      atomTypesPtr_(&system.simulation().atomTypes()),
+      trialSelfEnergy_(0.0),
+      hasRho_(false),
+      hasTrial_(false)
    {
       // Note: Don't setClassName - using "CoulombPotential" base class name
    }
@@ -151,17 +184,11 @@ namespace McMd
          ksq_.reserve(capacity);
          g_.reserve(capacity);
          rho_.reserve(capacity);
-         fexp0_.reserve(maxK[0] + 1);
-         fexp1_.reserve(2*maxK[1] + 1);
-         fexp2_.reserve(2*maxK[2] + 1);
       } else {
          intWaves_.clear();
          ksq_.clear();
          g_.clear();
          rho_.clear();
-         fexp0_.clear();
-         fexp1_.clear();
-         fexp2_.clear();
       }
 
       // Accumulate waves, and wave-related properties.
@@ -218,67 +245,122 @@ namespace McMd
       UTIL_CHECK(upper1_ - base1_ + 1 > 0);
       UTIL_CHECK(upper2_ - base2_ + 1 > 0);
       rho_.resize(intWaves_.size());
-      fexp0_.resize(upper0_ - base0_ + 1);
-      fexp1_.resize(upper1_ - base1_ + 1);
-      fexp2_.resize(upper2_ - base2_ + 1);
+      hasRho_ = false;
 
       // Mark waves as updated
       hasWaves_ = true;
    }
 
    /*
-   * Calculate fourier modes of charge density.
+   * Gather charged atoms and tabulate phase factors along each axis.
    */
-   void MdEwaldPotential::computeKSpaceCharge()
+   void MdEwaldPotential::computePhases()
    {
-      // Compute waves if necessary
-      if (!hasWaves()) {
-         makeWaves();
-      }
-
       System::MoleculeIterator molIter;
       Molecule::AtomIterator atomIter;
-      Vector  rg;     // scaled atom position vector
-      IntVector q;    // wave indices
-      Vector  qv;     // wave vector
-      double  dotqr;  // dot product between q and r
-      double  x, y;   // real and imaginary parts of phasor
-      double  charge; // atom charge
-      double  TwoPi;  // 2.0*pi
-      int  i, j;      // array index
-
-      TwoPi = 2.0*Constants::Pi;
-
-      // Clear rho for all waves
-      for (i = 0; i < rho_.size(); ++i) {
-         rho_[i] = DCMPLX(0.0, 0.0);
-      }
-
-      // Loop over species, molecules atoms
+      double charge;
+      double EPS(1.0E-10);  // Tiny number to check if is charge
       int  nSpecies = simulationPtr_->nSpecies();
+
+      // Gather charged atoms and their charges
+      chargedAtoms_.clear();
+      charges_.clear();
       for (int iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
          systemPtr_->begin(iSpecies, molIter); 
          for ( ; molIter.notEnd(); ++molIter) {
             for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
-               boundaryPtr_->transformCartToGen(atomIter->position(), rg);
                charge = (*atomTypesPtr_)[atomIter->typeId()].charge();
-
-               // Loop over waves
-               for (i = 0; i < intWaves_.size(); ++i) {
-                  q = intWaves_[i];
-                  for (j = 0; j < Dimension; ++j) {
-                     qv[j] = double(q[j]);
-                  }
-                  dotqr = rg.dot(qv)*TwoPi;
-                  x = charge*cos(dotqr);
-                  y = charge*sin(dotqr);
-                  rho_[i] += DCMPLX(x, y);
+               if (fabs(charge) > EPS) {
+                  chargedAtoms_.append(&(*atomIter));
+                  charges_.append(charge);
                }
+            }
+         }
+      }
+      int nCharged = chargedAtoms_.size();
+      if (nCharged == 0) return;
+
+      // Resize tables, with elements [(m - base)*nCharged + i]
+      int b0 = int(base0_);
+      int b1 = int(base1_);
+      int b2 = int(base2_);
+      int n0 = int(upper0_) - b0 + 1;
+      int n1 = int(upper1_) - b1 + 1;
+      int n2 = int(upper2_) - b2 + 1;
+      cos0_.resize(n0*nCharged);
+      sin0_.resize(n0*nCharged);
+      cos1_.resize(n1*nCharged);
+      sin1_.resize(n1*nCharged);
+      cos2_.resize(n2*nCharged);
+      sin2_.resize(n2*nCharged);
+
+      // Tabulate phase factors for each atom
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (int i = 0; i < nCharged; ++i) {
+         Vector rg;
+         boundaryPtr_->transformCartToGen(chargedAtoms_[i]->position(), rg);
+         tabulatePhases(rg[0], b0, n0, nCharged, &cos0_[i], &sin0_[i]);
+         tabulatePhases(rg[1], b1, n1, nCharged, &cos1_[i], &sin1_[i]);
+         tabulatePhases(rg[2], b2, n2, nCharged, &cos2_[i], &sin2_[i]);
+      }
+   }
 
-            } // For atoms.
-         } // For molecules.
-      } // For species.
+   /*
+   * Calculate fourier modes of charge density.
+   */
+   void MdEwaldPotential::computeKSpaceCharge()
+   {
+      // Compute waves if necessary
+      if (!hasWaves()) {
+         makeWaves();
+      }
 
+      // Clear rho for all waves
+      int nWave = intWaves_.size();
+      for (int k = 0; k < nWave; ++k) {
+         rho_[k] = DCMPLX(0.0, 0.0);
+      }
+      hasRho_ = true;
+
+      computePhases();
+      int nCharged = chargedAtoms_.size();
+      if (nCharged == 0) return;
+
+      const double* charges = &charges_[0];
+      int b0 = int(base0_);
+      int b1 = int(base1_);
+      int b2 = int(base2_);
+
+      // Loop over waves
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (int k = 0; k < nWave; ++k) {
+         const IntVector& q = intWaves_[k];
+         const double* c0 = &cos0_[(q[0] - b0)*nCharged];
+         const double* s0 = &sin0_[(q[0] - b0)*nCharged];
+         const double* c1 = &cos1_[(q[1] - b1)*nCharged];
+         const double* s1 = &sin1_[(q[1] - b1)*nCharged];
+         const double* c2 = &cos2_[(q[2] - b2)*nCharged];
+         const double* s2 = &sin2_[(q[2] - b2)*nCharged];
+         double x = 0.0;
+         double y = 0.0;
+         double c01, s01;
+
+         // Loop over charged atoms
+         #ifdef MCMD_OPENMP
+         #pragma omp simd reduction(+:x,y) private(c01, s01)
+         #endif
+         for (int i = 0; i < nCharged; ++i) {
+            c01 = c0[i]*c1[i] - s0[i]*s1[i];
+            s01 = s0[i]*c1[i] + c0[i]*s1[i];
+            x += charges[i]*(c01*c2[i] - s01*s2[i]);
+            y += charges[i]*(s01*c2[i] + c01*s2[i]);
+         }
+         rho_[k] = DCMPLX(x, y);
+      }
    }
 
    /*
@@ -286,89 +368,91 @@ namespace McMd
    */
    void MdEwaldPotential::addForces()
    {
-      System::MoleculeIterator molIter, imolIter, jmolIter;
-      Molecule::AtomIterator atomIter, iatomIter, jatomIter;
-      Vector  b[Dimension];   // array of reciprocal basis vectors
-      Vector  rg;             // scaled atom position vector
-      Vector  fg;             // generalized force on atom
-      Vector  df;             // force contribution
-      IntVector q;            // wave index
-      double  charge;         // atom charge
-      double  x, y;           // Real and imaginary parts of phasor
- 
-      DCMPLX TwoPiIm;       // 2.0*pi*I
-      DCMPLX de, expfactor;
-      double EPS(1.0E-10);  // Tiny number to check if is charge
-      double volume = boundaryPtr_->volume();
-      double TwoPi = 2.0*Constants::Pi;
-      TwoPiIm = TwoPi * Constants::Im;
-      int  nSpecies = simulationPtr_->nSpecies();
-      int  type;
-      int  i, j;
-
       // Compute Fourier components of charge density.
       computeKSpaceCharge();
-    
-      // Store reciprocal lattice vectors 
-      for (j = 0; j < Dimension; ++j) {
+
+      int nCharged = chargedAtoms_.size();
+      if (nCharged == 0) return;
+      int nWave = intWaves_.size();
+      fg0_.resize(nCharged);
+      fg1_.resize(nCharged);
+      fg2_.resize(nCharged);
+
+      Vector  b[Dimension];   // array of reciprocal basis vectors
+      for (int j = 0; j < Dimension; ++j) {
          b[j] = boundaryPtr_->reciprocalBasisVector(j);
       }
+      double prefactor = -2.0/boundaryPtr_->volume();
+      int b0 = int(base0_);
+      int b1 = int(base1_);
+      int b2 = int(base2_);
+
+      // Each thread accumulates forces on a contiguous block of atoms
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int begin = 0;
+         int end = nCharged;
+         #ifdef MCMD_OPENMP
+         int nThread = omp_get_num_threads();
+         int threadId = omp_get_thread_num();
+         begin = (threadId*nCharged)/nThread;
+         end = ((threadId + 1)*nCharged)/nThread;
+         #endif
+         double* f0 = &fg0_[0];
+         double* f1 = &fg1_[0];
+         double* f2 = &fg2_[0];
+         Vector  fg;             // generalized force on atom
+         Vector  df;             // force contribution
+         double  c01, s01, x, y, f, gr, gi, q0, q1, q2;
+         int i, j, k;
+
+         for (i = begin; i < end; ++i) {
+            f0[i] = 0.0;
+            f1[i] = 0.0;
+            f2[i] = 0.0;
+         }
 
-      // Loop over species, molecules atoms
-      for (int iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
-         systemPtr_->begin(iSpecies, molIter); 
-         for ( ; molIter.notEnd(); ++molIter) {
-            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
-               type = atomIter->typeId();
-               charge = (*atomTypesPtr_)[type].charge();
-
-               if (fabs(charge) > EPS) {
-                  boundaryPtr_->transformCartToGen(atomIter->position(), rg);
-
-                  // Tabulate the exponential factors.
-                  fexp0_[0] = exp(TwoPiIm * rg[0] * double(base0_));
-                  de = exp(TwoPiIm * rg[0]);
-                  for (i = 1; i < fexp0_.size(); ++i) {
-                     fexp0_[i] = fexp0_[i-1] * de;
-                  }
-
-                  fexp1_[0] = exp(TwoPiIm * rg[1] * double(base1_));
-                  de = exp(TwoPiIm * rg[1]);
-                  for (i = 1; i < fexp1_.size(); ++i) {
-                     fexp1_[i] = fexp1_[i-1] * de;
-                  }
-
-                  fexp2_[0] = exp(TwoPiIm * rg[2] * double(base2_));
-                  de = exp(TwoPiIm * rg[2]);
-                  for (i = 1; i < fexp2_.size(); ++i) {
-                     fexp2_[i] = fexp2_[i-1] * de;
-                  }
-
-                  // Accumulating forces.
-                  fg.zero();
-                  for (i = 0; i < intWaves_.size(); ++i) {
-                     q = intWaves_[i];
-                     for (j = 0; j < Dimension; ++j) {
-                        df[j] = double(q[j]);
-                     }
-                     expfactor = fexp0_[q[0]-base0_] * fexp1_[q[1]-base1_] * fexp2_[q[2]-base2_];
-                     x = expfactor.real();
-                     y = expfactor.imag();
-                     df *= g_[i]*( x*rho_[i].imag() - y*rho_[i].real() );
-                     fg += df;
-                  }
-                  fg *= -2.0*charge/volume;
- 
-                  // Transform to Cartesian coordinates
-                  for (j = 0; j < Dimension; ++j) {
-                     df.multiply(b[j], fg[j]);
-                     atomIter->force() += df;
-                  }
-               }
+         // Loop over waves, accumulating generalized forces
+         for (k = 0; k < nWave; ++k) {
+            const IntVector& q = intWaves_[k];
+            const double* c0 = &cos0_[(q[0] - b0)*nCharged];
+            const double* s0 = &sin0_[(q[0] - b0)*nCharged];
+            const double* c1 = &cos1_[(q[1] - b1)*nCharged];
+            const double* s1 = &sin1_[(q[1] - b1)*nCharged];
+            const double* c2 = &cos2_[(q[2] - b2)*nCharged];
+            const double* s2 = &sin2_[(q[2] - b2)*nCharged];
+            gr = g_[k]*rho_[k].real();
+            gi = g_[k]*rho_[k].imag();
+            q0 = double(q[0]);
+            q1 = double(q[1]);
+            q2 = double(q[2]);
+            for (i = begin; i < end; ++i) {
+               c01 = c0[i]*c1[i] - s0[i]*s1[i];
+               s01 = s0[i]*c1[i] + c0[i]*s1[i];
+               x = c01*c2[i] - s01*s2[i];
+               y = s01*c2[i] + c01*s2[i];
+               f = x*gi - y*gr;
+               f0[i] += q0*f;
+               f1[i] += q1*f;
+               f2[i] += q2*f;
+            }
+         }
 
-            } // for atoms
-         } // for molecules
-      } // for species
+         // Transform to Cartesian coordinates
+         for (i = begin; i < end; ++i) {
+            Vector& force = chargedAtoms_[i]->force();
+            fg[0] = f0[i];
+            fg[1] = f1[i];
+            fg[2] = f2[i];
+            fg *= prefactor*charges_[i];
+            for (j = 0; j < Dimension; ++j) {
+               df.multiply(b[j], fg[j]);
+               force += df;
+            }
+         }
+      }
    }
 
    /*
@@ -411,10 +495,7 @@ namespace McMd
             }
          }
       }
-      double pi = Constants::Pi;
-      double alpha = ewaldInteraction_.alpha();
-      double epsilon = ewaldInteraction_.epsilon();
-      selfEnergy *= alpha/(4.0*sqrt(pi)*pi*epsilon);
+      selfEnergy *= selfEnergyCoeff();
 
       // Correct for conjugate wave contribution in k-part.
       kSpaceEnergy_.set(energy - selfEnergy);
@@ -467,5 +548,242 @@ namespace McMd
       kSpaceStress_.set(stressTensor);
    }
 
+   /*
+   * Unset k-space energy and stored charge density.
+   */
+   void MdEwaldPotential::unsetEnergy()
+   {
+      MdCoulombPotential::unsetEnergy();
+      hasRho_ = false;
+   }
+
+   /*
+   * Coefficient of the Ewald self-energy.
+   */
+   double MdEwaldPotential::selfEnergyCoeff() const
+   {
+      double pi = Constants::Pi;
+      double alpha = ewaldInteraction_.alpha();
+      double epsilon = ewaldInteraction_.epsilon();
+      return alpha/(4.0*sqrt(pi)*pi*epsilon);
+   }
+
+   /*
+   * Compute charge density if necessary, and allocate trial arrays.
+   */
+   void MdEwaldPotential::prepareTrial()
+   {
+      bool isReset = false;
+      if (!hasWaves() || !hasRho_) {
+         computeKSpaceCharge();
+         isReset = true;
+      }
+      int nWave = intWaves_.size();
+      if (drho_.size() != nWave) {
+         drho_.resize(nWave);
+         isReset = true;
+      }
+      int n = int(upper0_ - base0_ + upper1_ - base1_ + upper2_ - base2_) + 3;
+      if (trialCos_.size() != n) {
+         trialCos_.resize(n);
+         trialSin_.resize(n);
+      }
+
+      // Changes relative to an older charge density are discarded
+      if (isReset) {
+         hasTrial_ = true;
+         clearTrial();
+      }
+   }
+
+   /*
+   * Tabulate phase factors along each axis for one position.
+   */
+   void MdEwaldPotential::tabulateTrialPhases(const Vector& position)
+   {
+      Vector rg;
+      boundaryPtr_->transformCartToGen(position, rg);
+      int n0 = int(upper0_ - base0_) + 1;
+      int n1 = int(upper1_ - base1_) + 1;
+      int n2 = int(upper2_ - base2_) + 1;
+      tabulatePhases(rg[0], int(base0_), n0, 1,
+                     &trialCos_[0], &trialSin_[0]);
+      tabulatePhases(rg[1], int(base1_), n1, 1,
+                     &trialCos_[n0], &trialSin_[n0]);
+      tabulatePhases(rg[2], int(base2_), n2, 1,
+                     &trialCos_[n0 + n1], &trialSin_[n0 + n1]);
+   }
+
+   /*
+   * Phase factor for wave q, from the tabulated trial position.
+   */
+   inline DCMPLX MdEwaldPotential::trialPhase(const IntVector& q) const
+   {
+      int i0 = q[0] - int(base0_);
+      int i1 = q[1] - int(base1_) + int(upper0_ - base0_) + 1;
+      int i2 = q[2] - int(base2_) + int(upper0_ - base0_)
+             + int(upper1_ - base1_) + 2;
+      DCMPLX phase(trialCos_[i0], trialSin_[i0]);
+      phase *= DCMPLX(trialCos_[i1], trialSin_[i1]);
+      phase *= DCMPLX(trialCos_[i2], trialSin_[i2]);
+      return phase;
+   }
+
+   /*
+   * Add Fourier modes of one point charge to drho_.
+   */
+   void MdEwaldPotential::addTrialCharge(double charge,
+                                         const Vector& position)
+   {
+      tabulateTrialPhases(position);
+      int nWave = intWaves_.size();
+      for (int k = 0; k < nWave; ++k) {
+         drho_[k] += charge*trialPhase(intWaves_[k]);
+      }
+      hasTrial_ = true;
+   }
+
+   /*
+   * Clear trial move.
+   */
+   void MdEwaldPotential::clearTrial()
+   {
+      if (hasTrial_) {
+         int nWave = drho_.size();
+         for (int k = 0; k < nWave; ++k) {
+            drho_[k] = DCMPLX(0.0, 0.0);
+         }
+      }
+      trialSelfEnergy_ = 0.0;
+      hasTrial_ = false;
+   }
+
+   /*
+   * Add displacement of an atom to the trial move.
+   */
+   void MdEwaldPotential::addTrialMove(const Atom& atom,
+                                       const Vector& newPosition)
+   {
+      double charge = (*atomTypesPtr_)[atom.typeId()].charge();
+      if (charge == 0.0) return;
+      prepareTrial();
+      addTrialCharge(-charge, atom.position());
+      addTrialCharge(charge, newPosition);
+   }
+
+   /*
+   * Add insertion of a charge to the trial move.
+   */
+   void MdEwaldPotential::insertTrialCharge(double charge,
+                                            const Vector& position)
+   {
+      if (charge == 0.0) return;
+      prepareTrial();
+      addTrialCharge(charge, position);
+      trialSelfEnergy_ -= charge*charge*selfEnergyCoeff();
+   }
+
+   /*
+   * Add removal of a charge to the trial move.
+   */
+   void MdEwaldPotential::removeTrialCharge(double charge,
+                                            const Vector& position)
+   {
+      if (charge == 0.0) return;
+      prepareTrial();
+      addTrialCharge(-charge, position);
+      trialSelfEnergy_ += charge*charge*selfEnergyCoeff();
+   }
+
+   /*
+   * Energy of one more charge, without changing the trial state.
+   *
+   * Uses |a + b|^2 - |a|^2 = 2 Re(a conj(b)) + |b|^2.
+   */
+   double MdEwaldPotential::trialInsertionEnergy(double charge,
+                                                 const Vector& position)
+   {
+      if (charge == 0.0) return 0.0;
+      prepareTrial();
+      tabulateTrialPhases(position);
+      DCMPLX a, b;
+      double energy = 0.0;
+      int nWave = intWaves_.size();
+      for (int k = 0; k < nWave; ++k) {
+         a = rho_[k] + drho_[k];
+         b = charge*trialPhase(intWaves_[k]);
+         energy += g_[k]*(2.0*(a*std::conj(b)).real() + std::norm(b));
+      }
+      energy /= boundaryPtr_->volume();
+      return energy - charge*charge*selfEnergyCoeff();
+   }
+
+   /*
+   * Change in k-space energy for the current trial move.
+   */
+   double MdEwaldPotential::trialEnergyChange()
+   {
+      if (!hasTrial_) return trialSelfEnergy_;
+      double energy = 0.0;
+      int nWave = drho_.size();
+      for (int k = 0; k < nWave; ++k) {
+         energy += g_[k]*(2.0*(rho_[k]*std::conj(drho_[k])).real()
+                          + std::norm(drho_[k]));
+      }
+      energy /= boundaryPtr_->volume();
+      return energy + trialSelfEnergy_;
+   }
+
+   /*
+   * Commit the trial move to rho_ and to the k-space energy.
+   */
+   void MdEwaldPotential::acceptTrial()
+   {
+      if (!hasTrial_ && trialSelfEnergy_ == 0.0) return;
+      double dE = trialEnergyChange();
+      if (hasTrial_) {
+         int nWave = drho_.size();
+         for (int k = 0; k < nWave; ++k) {
+            rho_[k] += drho_[k];
+         }
+      }
+      if (kSpaceEnergy_.isSet()) {
+         kSpaceEnergy_.set(kSpaceEnergy_.value() + dE);
+      }
+      unsetStress();
+      clearTrial();
+   }
+
+   /*
+   * Energy of one atom, from the energy change on removal.
+   */
+   double MdEwaldPotential::kspaceAtomEnergy(const Atom& atom)
+   {
+      double charge = (*atomTypesPtr_)[atom.typeId()].charge();
+      if (charge == 0.0) return 0.0;
+      prepareTrial();
+      clearTrial();
+      removeTrialCharge(charge, atom.position());
+      double energy = -trialEnergyChange();
+      clearTrial();
+      return energy;
+   }
+
+   /*
+   * Commit an accepted move of one atom to the stored Fourier modes.
+   */
+   void MdEwaldPotential::moveCharge(const Atom& atom,
+                                     const Vector& oldPosition)
+   {
+      if (!hasWaves() || !hasRho_) return;
+      double charge = (*atomTypesPtr_)[atom.typeId()].charge();
+      if (charge == 0.0) return;
+      prepareTrial();
+      clearTrial();
+      addTrialCharge(-charge, oldPosition);
+      addTrialCharge(charge, atom.position());
+      acceptTrial();
+   }
+
 } 
 #endif
@@ -8,7 +8,7 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
-#include <mcMd/potentials/coulomb/MdCoulombPotential.h>       // base class
+#include <mcMd/potentials/coulomb/McCoulombPotential.h>       // base class
 #include <mcMd/potentials/coulomb/EwaldRSpaceAccumulator.h>   // member
 #include <simp/interaction/coulomb/EwaldInteraction.h>        // member
 
@@ -29,6 +29,7 @@ namespace McMd
 
    class Simulation;
    class System;
+   class Atom;
 
    typedef std::complex<double> DCMPLX;
 
@@ -41,9 +42,23 @@ namespace McMd
    * This class implements the k-space sums in the Ewald
    * method for computing the Coulomb energy and forces.
    *
+   * Phase factors exp(i k.r) are constructed from per-axis tables
+   * of exp(2 pi i m s_j), where s_j is a generalized coordinate,
+   * that are computed by recurrence once per evaluation. The tables
+   * are stored with the atom index varying fastest, so that sums
+   * over atoms for each wavevector run over contiguous arrays.
+   * When compiled with MCMD_OPENMP, the charge density is threaded
+   * over wavevectors and forces are threaded over blocks of atoms.
+   *
+   * The incremental McCoulombPotential interface for MC is implemented
+   * by storing the Fourier modes rho(k) of the charge density, and a
+   * separate array of changes for the current trial move. Each moved,
+   * inserted or removed charge costs one evaluation of the per-axis
+   * phase tables for its position and one pass over the wavevectors.
+   *
    * \ingroup McMd_Coulomb_Module
    */
-   class MdEwaldPotential : public MdCoulombPotential
+   class MdEwaldPotential : public McCoulombPotential
    {
 
    public:
@@ -132,6 +147,78 @@ namespace McMd
       */
       virtual void computeStress();
 
+      /**
+      * Unset k-space energy and stored Fourier modes of the charge.
+      */
+      virtual void unsetEnergy();
+
+      //@}
+      /// \name Incremental k-space energy for MC moves
+      //@{
+
+      /**
+      * Discard all changes of the current trial move.
+      */
+      virtual void clearTrial();
+
+      /**
+      * Add the displacement of one atom to the trial move.
+      *
+      * \param atom        Atom to be moved (at its old position)
+      * \param newPosition new position of the atom
+      */
+      virtual void addTrialMove(const Atom& atom, const Vector& newPosition);
+
+      /**
+      * Add insertion of a new charge to the trial move.
+      *
+      * \param charge   charge of inserted particle
+      * \param position position of inserted particle
+      */
+      virtual void insertTrialCharge(double charge, const Vector& position);
+
+      /**
+      * Add removal of an existing charge to the trial move.
+      *
+      * \param charge   charge of removed particle
+      * \param position position of removed particle
+      */
+      virtual void removeTrialCharge(double charge, const Vector& position);
+
+      /**
+      * Energy of one more charge added to the current trial state.
+      *
+      * \param charge   charge of candidate particle
+      * \param position candidate position
+      */
+      virtual double trialInsertionEnergy(double charge,
+                                          const Vector& position);
+
+      /**
+      * Change in k-space energy produced by the current trial move.
+      */
+      virtual double trialEnergyChange();
+
+      /**
+      * Commit the current trial move to the stored Fourier modes.
+      */
+      virtual void acceptTrial();
+
+      /**
+      * Calculate the k-space energy of one Atom.
+      *
+      * \param atom Atom object of interest
+      */
+      virtual double kspaceAtomEnergy(const Atom& atom);
+
+      /**
+      * Update stored Fourier modes after an accepted move of one atom.
+      *
+      * \param atom        Atom that was moved (at its new position)
+      * \param oldPosition position of the atom before the move
+      */
+      virtual void moveCharge(const Atom& atom, const Vector& oldPosition);
+
       //@}
       /// \name Miscellaneous Accessors
       //@{
@@ -139,7 +226,7 @@ namespace McMd
       EwaldRSpaceAccumulator& rSpaceAccumulator()
       {  return rSpaceAccumulator_; }
 
-      EwaldInteraction& ewaldInteraction()
+      virtual EwaldInteraction& ewaldInteraction()
       { return ewaldInteraction_; }
 
       //@}
@@ -161,12 +248,27 @@ namespace McMd
       // Pointer to array of atom types
       const Array<AtomType>* atomTypesPtr_;
 
-      /// Exponential factor accessors.
+      /// Minimum and maximum wave indices along each axis.
       double  base0_, base1_, base2_;
       double  upper0_, upper1_, upper2_;
-      GArray<DCMPLX> fexp0_;
-      GArray<DCMPLX> fexp1_;
-      GArray<DCMPLX> fexp2_;
+
+      /// Pointers to charged atoms, in the order used in phase tables.
+      GArray<Atom*> chargedAtoms_;
+
+      /// Charges of charged atoms.
+      GArray<double> charges_;
+
+      /// Real and imaginary parts of exp(2 pi i m x) for axis 0.
+      GArray<double> cos0_, sin0_;
+
+      /// Real and imaginary parts of exp(2 pi i m y) for axis 1.
+      GArray<double> cos1_, sin1_;
+
+      /// Real and imaginary parts of exp(2 pi i m z) for axis 2.
+      GArray<double> cos2_, sin2_;
+
+      /// Components of generalized k-space forces on charged atoms.
+      GArray<double> fg0_, fg1_, fg2_;
 
       /// Wave vector indices.
       GArray<IntVector> intWaves_;
@@ -183,14 +285,62 @@ namespace McMd
       /// Fourier modes of charge density.
       GArray<DCMPLX> rho_;
 
+      /// Changes in Fourier modes for the current trial move.
+      GArray<DCMPLX> drho_;
+
+      /// Per-axis cos(2 pi m s_j) for one trial position, axes in order.
+      GArray<double> trialCos_;
+
+      /// Per-axis sin(2 pi m s_j) for one trial position, axes in order.
+      GArray<double> trialSin_;
+
+      /// Change in self-energy for the current trial move.
+      double trialSelfEnergy_;
+
+      /// Does rho_ hold the Fourier modes of the current configuration?
+      bool hasRho_;
+
+      /// Does the current trial move change any charge?
+      bool hasTrial_;
+
       /// cutoff distance in k space
       double kSpaceCutoff_;
 
+      /*
+      * Gather charged atoms and tabulate per-axis phase factors.
+      */
+      void computePhases();
+
       /*
       * Calculate Fourier coefficients of charge density.
       */
       void computeKSpaceCharge();
 
+      /*
+      * Compute rho_ if necessary, and allocate trial arrays.
+      */
+      void prepareTrial();
+
+      /*
+      * Tabulate per-axis phase factors for one position.
+      */
+      void tabulateTrialPhases(const Vector& position);
+
+      /*
+      * Phase factor exp(i q.r) from the last tabulated trial position.
+      */
+      DCMPLX trialPhase(const IntVector& q) const;
+
+      /*
+      * Add charge*exp(i k.r) to drho_ for all waves.
+      */
+      void addTrialCharge(double charge, const Vector& position);
+
+      /*
+      * Coefficient c of the self-energy, -c*q*q per charge q.
+      */
+      double selfEnergyCoeff() const;
+
    };
 
 }
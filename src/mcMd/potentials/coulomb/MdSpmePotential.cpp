@@ -15,6 +15,7 @@
 #include <util/math/Constants.h>
 #include <util/boundary/Boundary.h>
 #include <util/containers/Array.h>
+#include <util/misc/Log.h>
 
 #include <stdlib.h>
 #include <cmath>
@@ -24,6 +25,51 @@ namespace McMd
 
    using namespace Util;
 
+   namespace {
+
+      /*
+      * Return smallest integer >= n with no prime factors other than 2, 3, 5.
+      */
+      int fftFriendlySize(int n)
+      {
+         int m;
+         for ( ; ; ++n) {
+            m = n;
+            while (m % 2 == 0) m /= 2;
+            while (m % 3 == 0) m /= 3;
+            while (m % 5 == 0) m /= 5;
+            if (m == 1) return n;
+         }
+      }
+
+      /*
+      * Estimated rms k-space force error for 5th order spline assignment.
+      *
+      * \param h       grid spacing
+      * \param length  box length along axis
+      * \param alpha   Ewald smearing parameter
+      * \param q2      sum of squared charges, times 1/(4 pi epsilon)
+      * \param nAtom   number of atoms
+      */
+      double kSpaceForceError(double h, double length, double alpha,
+                              double q2, int nAtom)
+      {
+         // Coefficients of Deserno and Holm for order 5
+         static const double a[5] = {1.0/23232.0, 7601.0/13628160.0,
+                                     143.0/69120.0, 517231.0/106536960.0,
+                                     106640677.0/11737571328.0};
+         double ha = h*alpha;
+         double sum = 0.0;
+         for (int m = 0; m < 5; ++m) {
+            sum += a[m]*pow(ha, 2.0*m);
+         }
+         return q2*pow(ha, 5.0)
+                *sqrt(alpha*length*sqrt(2.0*Constants::Pi)*sum/double(nAtom))
+                /(length*length);
+      }
+
+   }
+
    /*
    * Constructor.
    */
@@ -43,7 +89,10 @@ namespace McMd
       xfield_(),
       yfield_(),
       zfield_(),
-      order_(5)
+      rmsForceError_(0.0),
+      wisdomFile_(),
+      order_(5),
+      hasPlans_(false)
    {
       // Note: Don't setClassName - using "CoulombPotential" base class name
    }
@@ -53,10 +102,12 @@ namespace McMd
    */
    MdSpmePotential::~MdSpmePotential()
    {
-      fftw_destroy_plan(forward_plan);
-      fftw_destroy_plan(xfield_backward_plan);
-      fftw_destroy_plan(yfield_backward_plan);
-      fftw_destroy_plan(zfield_backward_plan);
+      if (hasPlans_) {
+         fftw_destroy_plan(forward_plan);
+         fftw_destroy_plan(xfield_backward_plan);
+         fftw_destroy_plan(yfield_backward_plan);
+         fftw_destroy_plan(zfield_backward_plan);
+      }
    }
 
    /*
@@ -68,8 +119,22 @@ namespace McMd
       bool nextIndent = false;
       addParamComposite(ewaldInteraction_, nextIndent);
       ewaldInteraction_.readParameters(in);
-      read<IntVector>(in, "gridDimensions", gridDimensions_);
-      setGridDimensions();
+
+      rmsForceError_ = 0.0;
+      readOptional<double>(in, "rmsForceError", rmsForceError_);
+      if (rmsForceError_ < 0.0) {
+         UTIL_THROW("Negative rmsForceError");
+      }
+      if (rmsForceError_ == 0.0) {
+         read<IntVector>(in, "gridDimensions", gridDimensions_);
+      }
+      wisdomFile_ = "";
+      readOptional<std::string>(in, "wisdomFile", wisdomFile_);
+
+      // If rmsForceError is set, grid is chosen when waves are made
+      if (rmsForceError_ == 0.0) {
+         setGridDimensions();
+      }
    }
 
    /*
@@ -80,8 +145,16 @@ namespace McMd
       bool nextIndent = false;
       addParamComposite(ewaldInteraction_, nextIndent);
       ewaldInteraction_.loadParameters(ar);
-      loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
-      setGridDimensions();
+      rmsForceError_ = 0.0;
+      loadParameter<double>(ar, "rmsForceError", rmsForceError_, false);
+      if (rmsForceError_ == 0.0) {
+         loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
+      }
+      wisdomFile_ = "";
+      loadParameter<std::string>(ar, "wisdomFile", wisdomFile_, false);
+      if (rmsForceError_ == 0.0) {
+         setGridDimensions();
+      }
    }
 
    /*
@@ -90,7 +163,13 @@ namespace McMd
    void MdSpmePotential::save(Serializable::OArchive &ar)
    {
       ewaldInteraction_.save(ar);
-      ar << gridDimensions_;
+      bool isActive = (rmsForceError_ > 0.0);
+      Parameter::saveOptional(ar, rmsForceError_, isActive);
+      if (!isActive) {
+         ar << gridDimensions_;
+      }
+      isActive = !wisdomFile_.empty();
+      Parameter::saveOptional(ar, wisdomFile_, isActive);
    }
 
    /*
@@ -126,6 +205,9 @@ namespace McMd
    { 
       // Allocate memory if not done previously
       if (g_.size() == 0) {
+         if (rmsForceError_ > 0.0) {
+            selectParameters();
+         }
          setGridDimensions();
       }
 
@@ -136,6 +218,65 @@ namespace McMd
       hasWaves_ = true;
    }
 
+   /*
+   * Choose alpha and grid dimensions for a target rms force error.
+   */
+   void MdSpmePotential::selectParameters()
+   {
+      // Count atoms and compute sum of squared charges
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      double charge;
+      double q2 = 0.0;
+      int nAtom = 0;
+      int nSpecies = simulationPtr_->nSpecies();
+      for (int iSpecies = 0; iSpecies < nSpecies; ++iSpecies) {
+         systemPtr_->begin(iSpecies, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               charge = (*atomTypesPtr_)[atomIter->typeId()].charge();
+               q2 += charge*charge;
+               ++nAtom;
+            }
+         }
+      }
+      if (q2 <= 0.0) {
+         UTIL_THROW("No charged atoms: cannot choose SPME parameters");
+      }
+      q2 /= 4.0*Constants::Pi*ewaldInteraction_.epsilon();
+
+      // Choose alpha so that the real-space error equals rmsForceError_
+      double volume = boundaryPtr_->volume();
+      double rCutoff = ewaldInteraction_.rSpaceCutoff();
+      double alpha = rmsForceError_*sqrt(nAtom*rCutoff*volume)/(2.0*q2);
+      if (alpha >= 1.0) {
+         alpha = (1.35 - 0.15*log(rmsForceError_))/rCutoff;
+      } else {
+         alpha = sqrt(-log(alpha))/rCutoff;
+      }
+      ewaldInteraction_.set("alpha", alpha);
+
+      // Choose smallest FFT-friendly grid with acceptable k-space error
+      double length;
+      int n;
+      for (int j = 0; j < Dimension; ++j) {
+         length = boundaryPtr_->bravaisBasisVector(j).abs();
+         n = fftFriendlySize(order_);
+         while (kSpaceForceError(length/double(n), length, alpha, q2, nAtom)
+                > rmsForceError_) {
+            n = fftFriendlySize(n + 1);
+            if (n > 4096) {
+               UTIL_THROW("SPME grid for rmsForceError exceeds 4096");
+            }
+         }
+         gridDimensions_[j] = n;
+      }
+
+      Log::file() << "SPME alpha          = " << alpha << std::endl;
+      Log::file() << "SPME gridDimensions = " << gridDimensions_ 
+                  << std::endl;
+   }
+
    void MdSpmePotential::setGridDimensions()
    {
       // Allocate memory 
@@ -148,6 +289,11 @@ namespace McMd
       yfield_.allocate(gridDimensions_);
       zfield_.allocate(gridDimensions_);
 
+      // Import saved wisdom, if any, to make FFTW_MEASURE planning fast
+      if (!wisdomFile_.empty()) {
+         fftw_import_wisdom_from_filename(wisdomFile_.c_str());
+      }
+
       // Initialize fft plan for charge grid
       fftw_complex* inf;
       fftw_complex* outf;
@@ -187,7 +333,15 @@ namespace McMd
                                 gridDimensions_[1],
                                 gridDimensions_[2],
                                 inzf, outzf,FFTW_BACKWARD, FFTW_MEASURE);
+      hasPlans_ = true;
 
+      // Save accumulated wisdom for later runs
+      if (!wisdomFile_.empty()) {
+         if (!fftw_export_wisdom_to_filename(wisdomFile_.c_str())) {
+            Log::file() << "Warning: Unable to write FFTW wisdom to "
+                        << wisdomFile_ << std::endl;
+         }
+      }
    }
 
    /*
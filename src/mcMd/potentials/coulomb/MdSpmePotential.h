@@ -24,6 +24,7 @@
 #include <util/boundary/Boundary.h>      // typedef
 
 #include <complex>
+#include <string>
 #include <fftw3.h>
 
 namespace McMd
@@ -43,6 +44,21 @@ namespace McMd
    * This class implements the smooth particle mesh ewald k-space
    * computations for the Coulomb energy and forces.
    *
+   * If the optional parameter rmsForceError is present, the grid
+   * dimensions are not read from file. Instead, when waves are first
+   * constructed, the Ewald parameter alpha is chosen so that the
+   * estimated real-space rms force error for the given rSpaceCutoff
+   * equals rmsForceError, and the grid dimension along each axis is
+   * chosen as the smallest FFT-friendly size (with prime factors 2, 3
+   * and 5) for which the estimated k-space rms force error is less
+   * than rmsForceError. Error estimates are those of Kolafa and Perram
+   * (real space) and of Deserno and Holm (k-space).
+   *
+   * If the optional parameter wisdomFile is present, FFTW wisdom is
+   * imported from this file before fft plans are created, and exported
+   * to it afterwards, so that FFTW_MEASURE planning is only expensive
+   * in the first run on a given machine and grid.
+   *
    * \ingroup McMd_Coulomb_Module
    */
    class MdSpmePotential : public MdCoulombPotential
@@ -188,6 +204,12 @@ namespace McMd
       /// Force grid z component 
       GridArray<DCMPLX> zfield_;
 
+      /// Target rms force error for parameter selection (0 if inactive).
+      double rmsForceError_;
+
+      /// Name of file for FFTW wisdom (empty if inactive).
+      std::string wisdomFile_;
+
       /// order of basis spline
       int order_;
       
@@ -197,6 +219,9 @@ namespace McMd
       /// FFT plan for electric field
       fftw_plan xfield_backward_plan, yfield_backward_plan, zfield_backward_plan;
 
+      /// Have fft plans been created?
+      bool hasPlans_;
+
       /**
       * Set all elements of grid to 0.
       */
@@ -208,6 +233,11 @@ namespace McMd
       */
       void setGridDimensions();
 
+      /**
+      * Choose alpha and grid dimensions to satisfy rmsForceError_.
+      */
+      void selectParameters();
+
       /**
       * Compute waves and influence function.
       */
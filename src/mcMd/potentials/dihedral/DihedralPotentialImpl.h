@@ -372,16 +372,21 @@ namespace McMd
    template <class Interaction>
    void DihedralPotentialImpl<Interaction>::addForces() 
    {
-      Vector dr1, dr2, dr3, force1, force2, force3;
-      Atom *atom0Ptr, *atom1Ptr, *atom2Ptr, *atom3Ptr;
-      int iSpec;
+      int iSpec, iMol, nMol;
 
-      System::MoleculeIterator molIter;
-      Molecule::DihedralIterator dihedralIter;
+      // Molecules contain different atoms, and may be divided among threads
       for (iSpec=0; iSpec < simulation().nSpecies(); ++iSpec) {
          if (simulation().species(iSpec).nDihedral() > 0) {
-            for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
-               molIter->begin(dihedralIter); 
+            nMol = nMolecule(iSpec);
+            #ifdef MCMD_OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for (iMol = 0; iMol < nMol; ++iMol) {
+               Molecule& molecule = system().molecule(iSpec, iMol);
+               Molecule::DihedralIterator dihedralIter;
+               Vector dr1, dr2, dr3, force1, force2, force3;
+               Atom *atom0Ptr, *atom1Ptr, *atom2Ptr, *atom3Ptr;
+               molecule.begin(dihedralIter); 
                for ( ; dihedralIter.notEnd(); ++dihedralIter) {
 
                   atom0Ptr = &(dihedralIter->atom(0));
@@ -0,0 +1,189 @@
+#ifndef MCMD_EXTERNAL_ENERGY_CACHE_H
+#define MCMD_EXTERNAL_ENERGY_CACHE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/potentials/external/ExternalPotential.h>
+#include <mcMd/chemistry/Atom.h>
+#include <util/containers/DArray.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/global.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /**
+   * Cache of the external energies of atoms, indexed by atom id.
+   *
+   * For a static external field, the external energy of an atom depends
+   * only on its position and type. Each atom has two cache slots, each
+   * holding a position, type id and energy. A call to energy() returns
+   * a cached energy if the position and type id of either slot equal
+   * those given, exactly, and otherwise evaluates the ExternalPotential
+   * and replaces the least recently used slot. In an MC move, the energy
+   * at the old position is then found in the cache, the energy at the
+   * trial position is stored in the other slot, and the slot that holds
+   * the final position after acceptance or rejection is used by the next
+   * move, so every accepted or rejected single atom move evaluates the
+   * field only once. Configuration bias moves that evaluate many trial
+   * positions in one call to ExternalPotential::trialEnergies() should
+   * call store() for the chosen position.
+   *
+   * Entries are matched by value, so changes of position or type made
+   * anywhere else simply cause a cache miss. Changes to the field itself
+   * (parameters or boundary) require a call to clear(), which takes
+   * constant time.
+   *
+   * \ingroup McMd_External_Module
+   */
+   class ExternalEnergyCache
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      ExternalEnergyCache()
+       : entries_(),
+         stamp_(1)
+      {}
+
+      /**
+      * Allocate one entry per atom.
+      *
+      * \param capacity total number of atoms (Atom::capacity())
+      */
+      void allocate(int capacity)
+      {
+         entries_.allocate(capacity);
+         for (int i = 0; i < capacity; ++i) {
+            entries_[i].stamp[0] = 0;
+            entries_[i].stamp[1] = 0;
+            entries_[i].last = 0;
+         }
+         stamp_ = 1;
+      }
+
+      /**
+      * Invalidate all entries.
+      */
+      void clear()
+      {
+         ++stamp_;
+         if (stamp_ == 0) {
+            allocate(entries_.capacity());
+         }
+      }
+
+      /**
+      * Return the external energy of an atom at a specified position.
+      *
+      * \param potential external potential
+      * \param atom      atom (provides id and type id)
+      * \param position  position of atom
+      * \return external energy
+      */
+      double energy(const ExternalPotential& potential, const Atom& atom,
+                    const Vector& position)
+      {
+         Entry& entry = entries_[atom.id()];
+         int typeId = atom.typeId();
+         int k = entry.last;
+         if (matches(entry, k, typeId, position)) {
+            return entry.energy[k];
+         }
+         k = 1 - k;
+         if (!matches(entry, k, typeId, position)) {
+            set(entry, k, typeId, position,
+                potential.energy(position, typeId));
+         }
+         entry.last = k;
+         return entry.energy[k];
+      }
+
+      /**
+      * Store a known energy of an atom at a specified position.
+      *
+      * Replaces the least recently used slot, unless a slot already
+      * matches the position and type id.
+      *
+      * \param atom      atom (provides id and type id)
+      * \param position  position of atom
+      * \param energy    external energy at position
+      */
+      void store(const Atom& atom, const Vector& position, double energy)
+      {
+         Entry& entry = entries_[atom.id()];
+         int typeId = atom.typeId();
+         int k = entry.last;
+         if (!matches(entry, k, typeId, position)) {
+            k = 1 - k;
+            set(entry, k, typeId, position, energy);
+         }
+         entry.last = k;
+      }
+
+      /**
+      * Has memory been allocated?
+      */
+      bool isAllocated() const
+      {  return entries_.isAllocated(); }
+
+   private:
+
+      /**
+      * Two cached energies of one atom.
+      */
+      struct Entry
+      {
+         Vector position[2];
+         double energy[2];
+         unsigned int stamp[2];
+         int typeId[2];
+         int last;
+      };
+
+      /// Entries, indexed by atom id.
+      DArray<Entry> entries_;
+
+      /// Current stamp value, incremented by clear().
+      unsigned int stamp_;
+
+      /// Does slot k of entry hold a valid value for typeId and position?
+      bool matches(const Entry& entry, int k, int typeId,
+                   const Vector& position) const
+      {
+         if (entry.stamp[k] != stamp_ || entry.typeId[k] != typeId) {
+            return false;
+         }
+         for (int i = 0; i < Dimension; ++i) {
+            if (entry.position[k][i] != position[i]) {
+               return false;
+            }
+         }
+         return true;
+      }
+
+      /// Set slot k of entry.
+      void set(Entry& entry, int k, int typeId, const Vector& position,
+               double energy)
+      {
+         entry.position[k] = position;
+         entry.energy[k] = energy;
+         entry.stamp[k] = stamp_;
+         entry.typeId[k] = typeId;
+      }
+
+   };
+
+}
+#endif
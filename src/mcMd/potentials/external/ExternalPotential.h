@@ -69,6 +69,21 @@ namespace McMd
       */
       virtual void getForce(const Vector& position, int type, Vector& force) const = 0;
 
+      /**
+      * Compute external energies of one atom type at several positions.
+      *
+      * Equivalent to energies[k] = energy(positions[k], typeId) for all
+      * 0 <= k < n, but with one virtual function call, for use with the
+      * trial positions of configuration bias moves.
+      *
+      * \param typeId    atom type id
+      * \param positions array of n positions
+      * \param n         number of positions
+      * \param energies  array of n external energies (output)
+      */
+      virtual void trialEnergies(int typeId, const Vector* positions, int n,
+                                 double* energies) const = 0;
+
       //@}
 
       /**
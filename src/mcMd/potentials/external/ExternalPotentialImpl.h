@@ -97,6 +97,17 @@ namespace McMd
       */
       virtual void getForce(const Vector& position, int typeId, Vector& force) const;
 
+      /**
+      * Compute external energies of one atom type at several positions.
+      *
+      * \param typeId    atom type id
+      * \param positions array of n positions
+      * \param n         number of positions
+      * \param energies  array of n external energies (output)
+      */
+      virtual void trialEnergies(int typeId, const Vector* positions, int n,
+                                 double* energies) const;
+
       /**
       * Return external interaction class name (e.g., "LamellarOrderingExternal").
       */
@@ -219,6 +230,7 @@ namespace McMd
       ar >> isCopy_;
       if (!isCopy_) {
          interaction().setNAtomType(simulation().nAtomType());
+         interaction().setBoundary(system().boundary());
          bool nextIndent = false;
          addParamComposite(interaction(), nextIndent);
          interaction().loadParameters(ar);
@@ -254,6 +266,22 @@ namespace McMd
                                                int typeId, Vector& force) const
    { interaction().getForce(position, typeId, force); }
 
+   /*
+   * Compute external energies of one atom type at several positions.
+   */
+   template <class Interaction>
+   void
+   ExternalPotentialImpl<Interaction>::trialEnergies(int typeId,
+                                                     const Vector* positions,
+                                                     int n, double* energies)
+      const
+   {
+      const Interaction& interaction = *interactionPtr_;
+      for (int k = 0; k < n; ++k) {
+         energies[k] = interaction.energy(positions[k], typeId);
+      }
+   }
+
    /* 
    * Return total external potential energy.
    */
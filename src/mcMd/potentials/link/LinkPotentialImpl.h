@@ -295,18 +295,19 @@ namespace McMd
    {
       Vector  force;
       double  rsq;
-      Link*   linkPtr;
       Atom*   atom0Ptr;
       Atom*   atom1Ptr;
       int     iLink, nLink;
+
+      // Loop over the dense array of link atom ids
       nLink = linkMasterPtr_->nLink();
       for (iLink = 0; iLink < nLink; ++iLink) {
-         linkPtr  = &linkMasterPtr_->link(iLink);
-         atom0Ptr = &(linkPtr->atom0());
-         atom1Ptr = &(linkPtr->atom1());
+         const LinkMaster::LinkIds& ids = linkMasterPtr_->linkIds(iLink);
+         atom0Ptr = &simulation().atom(ids.atom0Id);
+         atom1Ptr = &simulation().atom(ids.atom1Id);
          rsq = boundary().
                distanceSq(atom0Ptr->position(), atom1Ptr->position(), force);
-         force *= interaction().forceOverR(rsq, linkPtr->typeId());
+         force *= interaction().forceOverR(rsq, ids.typeId);
          atom0Ptr->force() += force;
          atom1Ptr->force() -= force;
       }
@@ -320,14 +321,13 @@ namespace McMd
    {
       double rsq;
       double energy = 0.0;
-      Link* linkPtr;
       int iLink, nLink;
       nLink = linkMasterPtr_->nLink();
       for (iLink = 0; iLink < nLink; ++iLink) {
-         linkPtr = &(linkMasterPtr_->link(iLink));
-         rsq = boundary().distanceSq(linkPtr->atom0().position(), 
-                                     linkPtr->atom1().position());
-         energy += interaction().energy(rsq, linkPtr->typeId());
+         const LinkMaster::LinkIds& ids = linkMasterPtr_->linkIds(iLink);
+         rsq = boundary().distanceSq(simulation().atom(ids.atom0Id).position(),
+                                     simulation().atom(ids.atom1Id).position());
+         energy += interaction().energy(rsq, ids.typeId);
       }
       energy_.set(energy);
    }
@@ -11,6 +11,7 @@
 #include <util/boundary/Boundary.h> 
 #include <mcMd/chemistry/Atom.h> 
 #include <mcMd/chemistry/Molecule.h> 
+#include <simp/species/Species.h>
 
 #include <util/global.h> 
 
@@ -26,7 +27,15 @@ namespace McMd
    */
    McPairPotential::McPairPotential(System& system)
     : ParamComposite(),
-      SystemInterface(system)
+      SystemInterface(system),
+      multiCellRatio_(0.0),
+      hasMultiCellList_(false),
+      verletSkin_(0.0),
+      hasVerletList_(false),
+      bridgeCutoff_(0.0),
+      bridgeSpeciesId_(-1),
+      nVerletRebuild_(0),
+      isVerletListValid_(false)
    {  setClassName("McPairPotential"); }
  
    /* 
@@ -40,8 +49,17 @@ namespace McMd
    */ 
    void McPairPotential::buildCellList() 
    {
-      // Set up a grid of empty cells.
-      cellList_.setup(boundary(), maxPairCutoff());
+      // Set up a grid of empty cells. With Verlet lists, cells must hold
+      // every atom within cutoff + skin of a reference position of an
+      // atom that has moved by less than skin/2.
+      double cutoff = maxPairCutoff();
+      if (hasVerletList_) {
+         cutoff += 1.5*verletSkin_;
+      }
+      cellList_.setup(boundary(), cutoff);
+      if (hasMultiCellList_) {
+         multiCellList_.setup(boundary());
+      }
 
       // Add all atoms to cellList_ 
       System::MoleculeIterator molIter;
@@ -51,10 +69,231 @@ namespace McMd
             for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
                boundary().shift(atomIter->position());
                cellList_.addAtom(*atomIter);
+               if (hasMultiCellList_) {
+                  multiCellList_.addAtom(*atomIter);
+               }
+            }
+         }
+      }
+
+      // Rebuild the bridge cell list, if any
+      if (bridgeSpeciesId_ >= 0) {
+         bridgeCellList_.setup(boundary(), bridgeCutoff_);
+         begin(bridgeSpeciesId_, molIter);
+         for ( ; molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               bridgeCellList_.addAtom(*atomIter);
+            }
+         }
+      }
+
+      // Rebuild all Verlet lists, if any
+      if (hasVerletList_) {
+         buildVerletLists();
+      }
+
+   }
+
+   /*
+   * Allocate Verlet lists, if verletSkin_ > 0.
+   */
+   void McPairPotential::allocateVerletLists()
+   {
+      if (verletSkin_ < 0.0) {
+         UTIL_THROW("verletSkin must be >= 0");
+      }
+      hasVerletList_ = (verletSkin_ > 0.0);
+      if (!hasVerletList_) return;
+      if (hasMultiCellList_) {
+         UTIL_THROW("Verlet lists and multiCellList are incompatible");
+      }
+      int capacity = simulation().atomCapacity();
+      if (!verletLists_.isAllocated()) {
+         verletLists_.allocate(capacity);
+         verletPositions_.allocate(capacity);
+         isVerletAtom_.allocate(capacity);
+      }
+      for (int i = 0; i < capacity; ++i) {
+         isVerletAtom_[i] = false;
+      }
+      isVerletListValid_ = false;
+   }
+
+   /*
+   * Build Verlet lists of all atoms (private).
+   */
+   void McPairPotential::buildVerletLists()
+   {
+      int capacity = verletLists_.capacity();
+      int i;
+      for (i = 0; i < capacity; ++i) {
+         verletLists_[i].clear();
+         isVerletAtom_[i] = false;
+      }
+
+      // Set reference positions of all atoms in this System
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      int iSpec, id;
+      for (iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               id = atomIter->id();
+               verletPositions_[id] = atomIter->position();
+               isVerletAtom_[id] = true;
+            }
+         }
+      }
+
+      // Add each pair once, to the lists of both atoms
+      Atom* jAtomPtr;
+      double listCutoff = maxPairCutoff() + verletSkin_;
+      double listCutoffSq = listCutoff*listCutoff;
+      int j, jId, nNeighbor;
+      for (iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         for (begin(iSpec, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               id = atomIter->id();
+               cellList_.getNeighbors(verletPositions_[id], neighbors_);
+               nNeighbor = neighbors_.size();
+               for (j = 0; j < nNeighbor; ++j) {
+                  jAtomPtr = neighbors_[j];
+                  jId = jAtomPtr->id();
+                  if (jId <= id) continue;
+                  if (boundary().distanceSq(verletPositions_[id],
+                                            verletPositions_[jId])
+                      < listCutoffSq) {
+                     verletLists_[id].append(jAtomPtr);
+                     verletLists_[jId].append(&(*atomIter));
+                  }
+               }
+            }
+         }
+      }
+      nVerletRebuild_ = 0;
+      isVerletListValid_ = true;
+   }
+
+   /*
+   * Add an atom to the Verlet lists, at its current position (private).
+   */
+   void McPairPotential::addVerletAtom(Atom& atom)
+   {
+      int id = atom.id();
+      if (isVerletAtom_[id]) {
+         deleteVerletAtom(atom);
+      }
+      verletPositions_[id] = atom.position();
+      isVerletAtom_[id] = true;
+
+      double listCutoff = maxPairCutoff() + verletSkin_;
+      double listCutoffSq = listCutoff*listCutoff;
+      Atom* jAtomPtr;
+      int j, jId, nNeighbor;
+      cellList_.getNeighbors(atom.position(), neighbors_);
+      nNeighbor = neighbors_.size();
+      for (j = 0; j < nNeighbor; ++j) {
+         jAtomPtr = neighbors_[j];
+         jId = jAtomPtr->id();
+         if (jId == id || !isVerletAtom_[jId]) continue;
+         if (boundary().distanceSq(verletPositions_[id],
+                                   verletPositions_[jId]) < listCutoffSq) {
+            verletLists_[id].append(jAtomPtr);
+            verletLists_[jId].append(&atom);
+         }
+      }
+   }
+
+   /*
+   * Remove an atom from the Verlet lists of itself and its neighbors.
+   */
+   void McPairPotential::deleteVerletAtom(Atom& atom)
+   {
+      int id = atom.id();
+      if (!isVerletAtom_[id]) return;
+      GArray<Atom*>& list = verletLists_[id];
+      int i, k, n;
+      for (i = 0; i < list.size(); ++i) {
+         GArray<Atom*>& other = verletLists_[list[i]->id()];
+         n = other.size();
+         for (k = 0; k < n; ++k) {
+            if (other[k] == &atom) {
+               other[k] = other[n-1];
+               other.resize(n-1);
+               break;
             }
          }
       }
+      list.clear();
+      isVerletAtom_[id] = false;
+   }
+
+   /*
+   * Rebuild Verlet list of an atom if it moved more than verletSkin/2.
+   */
+   void McPairPotential::updateVerletAtom(Atom& atom)
+   {
+      int id = atom.id();
+      if (!isVerletAtom_[id]) return;
+      double halfSkin = 0.5*verletSkin_;
+      if (boundary().distanceSq(atom.position(), verletPositions_[id])
+          >= halfSkin*halfSkin) {
+         addVerletAtom(atom);
+         ++nVerletRebuild_;
+      }
+   }
+
+   /*
+   * Request a cell list of atoms of one species.
+   */
+   void McPairPotential::requestBridgeCellList(int speciesId, double cutoff)
+   {
+      if (speciesId < 0 || speciesId >= simulation().nSpecies()) {
+         UTIL_THROW("Invalid bridge speciesId");
+      }
+      if (cutoff <= 0.0) {
+         UTIL_THROW("Bridge cutoff must be > 0");
+      }
+      if (bridgeSpeciesId_ >= 0 && bridgeSpeciesId_ != speciesId) {
+         UTIL_THROW("Bridge cell list already requested for another species");
+      }
+      if (bridgeSpeciesId_ < 0) {
+         bridgeCellList_.setAtomCapacity(simulation().atomCapacity());
+      }
+      bridgeSpeciesId_ = speciesId;
+      if (cutoff > bridgeCutoff_) {
+         bridgeCutoff_ = cutoff;
+      }
+   }
+
+   /*
+   * Add atom to bridge cell list, if of the bridge species (private).
+   */
+   void McPairPotential::addBridgeAtom(Atom& atom)
+   {
+      if (atom.molecule().species().id() == bridgeSpeciesId_) {
+         bridgeCellList_.addAtom(atom);
+      }
+   }
+
+   /*
+   * Delete atom from bridge cell list, if of the bridge species (private).
+   */
+   void McPairPotential::deleteBridgeAtom(Atom& atom)
+   {
+      if (atom.molecule().species().id() == bridgeSpeciesId_) {
+         bridgeCellList_.deleteAtom(atom);
+      }
+   }
 
+   /*
+   * Update cell of atom in bridge cell list, if of bridge species (private).
+   */
+   void McPairPotential::updateBridgeAtom(Atom& atom)
+   {
+      if (atom.molecule().species().id() == bridgeSpeciesId_) {
+         bridgeCellList_.updateAtomCell(atom, atom.position());
+      }
    }
 
 }
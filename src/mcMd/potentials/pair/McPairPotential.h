@@ -12,6 +12,9 @@
 #include <mcMd/simulation/SystemInterface.h>       // base class
 #include <mcMd/potentials/pair/PairPotential.h>    // base class
 #include <mcMd/neighbor/CellList.h>                // member
+#include <mcMd/neighbor/MultiCellList.h>           // member
+#include <util/containers/DArray.h>                // member (template)
+#include <util/containers/GArray.h>                // member (template)
 
 #include <util/global.h>
 
@@ -54,6 +57,43 @@ namespace McMd
       */
       virtual double atomEnergy(const Atom& atom) const = 0;
 
+      /**
+      * Calculate the nonbonded pair energy of one Atom at a trial position.
+      *
+      * Returns the value that atomEnergy(atom) would return if the atom
+      * were at the specified position, with all other atoms fixed.
+      * Neither the Atom nor the CellList is modified, so a move that is
+      * rejected after this call needs no cell list update. The atom may
+      * be listed in any cell of the CellList, but position must lie in
+      * the primary cell, as after Boundary::shift().
+      *
+      * \param  atom     Atom object of interest
+      * \param  position trial position of atom
+      * \return nonbonded pair potential energy of atom at position
+      */
+      virtual
+      double trialEnergy(const Atom& atom, const Vector& position) const = 0;
+
+      /**
+      * Calculate the nonbonded pair energy of one Atom at trial positions.
+      *
+      * Upon return, energies[i] is the value that atomEnergy(atom) would
+      * return if the atom were at positions[i], for 0 <= i < nTrial. The
+      * actual position of the atom is neither used nor modified. This is
+      * intended for configuration bias moves, which evaluate many trial
+      * positions of one atom with all other atoms fixed. If the program
+      * is compiled with MCMD_OPENMP defined, trials are divided among 
+      * threads. 
+      *
+      * \param atom      Atom object of interest
+      * \param positions array of nTrial trial positions
+      * \param nTrial    number of trial positions
+      * \param energies  array of nTrial energies (output)
+      */
+      virtual 
+      void trialEnergies(const Atom& atom, const Vector* positions, 
+                         int nTrial, double* energies) const = 0;
+
       /**
       * Calculate the nonbonded pair energy for an entire Molecule.
       *
@@ -68,6 +108,24 @@ namespace McMd
       */
       virtual double moleculeEnergy(const Molecule& molecule) const = 0;
 
+      /**
+      * Change in moleculeEnergy if all atoms of a Molecule change type.
+      *
+      * Returns the value that moleculeEnergy(molecule) would have after
+      * setting the type of every atom in the molecule to typeId, minus
+      * its current value, without modifying the molecule. Both energies
+      * are evaluated in a single pass over neighbors, in which partners
+      * within the molecule are also given the new type. This is used by
+      * semigrand moves that change the identity of a homopolymer.
+      *
+      * \param  molecule Molecule object of interest
+      * \param  typeId   new atom type for all atoms of the molecule
+      * \return change in nonbonded pair energy of molecule
+      */
+      virtual double
+      moleculeTypeChangeEnergy(const Molecule& molecule, int typeId) const
+      = 0;
+
       //@}
       /// \name Cell List Management
       //@{
@@ -78,7 +136,9 @@ namespace McMd
       * Calls CellList::clear() to clear the CellList,
       * then adds every Atom in this System. Each Atom
       * position is shifted into the primary box by
-      * Boundary::shift() before being added.
+      * Boundary::shift() before being added. Also rebuilds the
+      * multi-level cell list, the bridge cell list and the Verlet
+      * lists, if any.
       */
       void buildCellList();
 
@@ -118,12 +178,129 @@ namespace McMd
       */
       void moveAtom(Atom& atom, const Vector &position);
 
+      /**
+      * Move an Atom to its new cell in the main CellList, if it has room.
+      *
+      * Calls CellList::updateAtomCellLocal() for the main cell list, and
+      * so may be called concurrently for atoms in disjoint sets of cells.
+      * Each call must be followed by a call to completeAtomCell() from a
+      * single thread. Use only without a multi-level cell list and while
+      * Verlet lists are invalid.
+      *
+      * \param atom Atom object whose position has been modified.
+      * \return false (and do nothing) if the new cell is full, else true
+      */
+      bool updateAtomCellLocal(Atom& atom);
+
+      /**
+      * Complete the cell list updates after updateAtomCellLocal().
+      *
+      * Moves the atom to the cell of its position if it is not already
+      * there, updates the list of non-empty cells for the old and new
+      * cells, and updates the bridge cell list.
+      *
+      * \param atom    Atom object whose position has been modified.
+      * \param oldCell index of the main cell list cell of the old position
+      */
+      void completeAtomCell(Atom& atom, int oldCell);
+
       /** 
       * Get the cellList by const reference.
       */
       const CellList& cellList() const;
 
       //@}
+      /// \name Bridge Cell List
+      //@{
+
+      /**
+      * Request a secondary cell list of the atoms of one species.
+      *
+      * The bridge cell list contains only the atoms of one species, in
+      * cells of width at least cutoff. It is built by buildCellList()
+      * and updated by addAtom(), deleteAtom(), updateAtomCell() and
+      * moveAtom(), along with the main CellList, so that rebridging
+      * moves can search for partners among atoms of the right species
+      * within a bridge length, independent of the pair cutoff. Several
+      * moves may request the same species, and the largest requested
+      * cutoff is used. Call before the first buildCellList().
+      *
+      * \param speciesId index of species of bridgeable atoms
+      * \param cutoff    minimum cell width (e.g., max bridge length)
+      */
+      void requestBridgeCellList(int speciesId, double cutoff);
+
+      /**
+      * Does this potential maintain a bridge cell list?
+      */
+      bool hasBridgeCellList() const;
+
+      /**
+      * Get the bridge cell list by const reference.
+      */
+      const CellList& bridgeCellList() const;
+
+      //@}
+      /// \name Multi-Level Cell List
+      //@{
+
+      /**
+      * Does this potential use a multi-level cell list?
+      *
+      * True if the optional parameter multiCellRatio is positive and
+      * divides the atom types into two or more levels, in which case
+      * atomEnergy(), trialEnergy() and trialEnergies() search for
+      * neighbors in multiCellList(), rather than in cellList().
+      */
+      bool hasMultiCellList() const;
+
+      /**
+      * Get the multi-level cell list by const reference.
+      */
+      const MultiCellList& multiCellList() const;
+
+      //@}
+      /// \name Verlet Lists
+      //@{
+
+      /**
+      * Does this potential use Verlet lists for atom energies?
+      *
+      * True if the optional parameter verletSkin is positive. Each atom
+      * then has a list of all atoms within maxPairCutoff() + verletSkin
+      * of its position when the list was built (its reference position),
+      * and atomEnergy() and trialEnergy() loop over this list, rather
+      * than over 27 cells, whenever the evaluation position is within
+      * verletSkin/2 of the reference position. Whenever moveAtom() or
+      * updateAtomCell() moves an atom by more than verletSkin/2 from its
+      * reference position, the list of that atom alone is rebuilt, and
+      * its entries in the lists of its old and new neighbors are updated.
+      * Every other atom thus remains within verletSkin/2 of its reference
+      * position, so that the lists contain all pairs within the cutoff.
+      */
+      bool hasVerletList() const;
+
+      /**
+      * Get the Verlet skin (0 if Verlet lists are not used).
+      */
+      double verletSkin() const;
+
+      /**
+      * Get number of single atom Verlet list rebuilds since buildCellList().
+      */
+      long nVerletRebuild() const;
+
+      /**
+      * Mark all Verlet lists invalid, until the next buildCellList().
+      *
+      * Until then, energies are computed from the cell list, and moved
+      * atoms are not checked against their reference positions. Call
+      * when the pair cutoff may have changed, or before moving atoms
+      * in parallel threads.
+      */
+      void invalidateVerletLists();
+
+      //@}
 
    protected:
 
@@ -133,32 +310,204 @@ namespace McMd
       /// Cell list for atom positions.
       CellList cellList_;
 
+      /// Cell lists for atom positions, one per size class of types.
+      MultiCellList multiCellList_;
+
+      /// Maximum ratio of self cutoffs of types of one level (0 if none).
+      double multiCellRatio_;
+
+      /// Is multiCellList_ maintained and used for atom energies?
+      bool hasMultiCellList_;
+
+      /// Verlet list skin (0 if Verlet lists are not used).
+      double verletSkin_;
+
+      /// Are Verlet lists maintained and used for atom energies?
+      bool hasVerletList_;
+
+      /**
+      * Allocate Verlet lists, if verletSkin_ > 0. Call in readParameters.
+      */
+      void allocateVerletLists();
+
+      /**
+      * Can the Verlet list of an atom be used at a position?
+      *
+      * Returns true if Verlet lists are valid, the atom has a list, and
+      * position is within verletSkin/2 of the reference position.
+      *
+      * \param atom     Atom object of interest
+      * \param position position at which energy is evaluated
+      */
+      bool isVerletValid(const Atom& atom, const Vector& position) const;
+
+      /**
+      * Get the Verlet list of an atom.
+      *
+      * \param atom Atom object of interest
+      */
+      const GArray<Atom*>& verletList(const Atom& atom) const;
+
+   private:
+
+      /// Cell list for atoms of species bridgeSpeciesId_.
+      CellList bridgeCellList_;
+
+      /// Minimum cell width of bridgeCellList_.
+      double bridgeCutoff_;
+
+      /// Species of atoms in bridgeCellList_ (-1 if none).
+      int bridgeSpeciesId_;
+
+      /// Add atom to bridgeCellList_, if of species bridgeSpeciesId_.
+      void addBridgeAtom(Atom& atom);
+
+      /// Delete atom from bridgeCellList_, if of species bridgeSpeciesId_.
+      void deleteBridgeAtom(Atom& atom);
+
+      /// Update cell of atom in bridgeCellList_, if of bridge species.
+      void updateBridgeAtom(Atom& atom);
+
+      /// Verlet list of each atom, indexed by atom id.
+      DArray< GArray<Atom*> > verletLists_;
+
+      /// Reference position of each atom, indexed by atom id.
+      DArray<Vector> verletPositions_;
+
+      /// Does each atom have a Verlet list? Indexed by atom id.
+      DArray<bool> isVerletAtom_;
+
+      /// Number of single atom rebuilds since the last buildVerletLists().
+      long nVerletRebuild_;
+
+      /// Are all Verlet lists valid?
+      bool isVerletListValid_;
+
+      /// Build Verlet lists of all atoms, after cellList_ is built.
+      void buildVerletLists();
+
+      /// Add an atom to the Verlet lists, at its current position.
+      void addVerletAtom(Atom& atom);
+
+      /// Remove an atom from the Verlet lists.
+      void deleteVerletAtom(Atom& atom);
+
+      /// Rebuild list of an atom if it moved more than verletSkin/2.
+      void updateVerletAtom(Atom& atom);
+
    };
 
    // Inline functions
   
    // Add an atom to CellList.
    inline void McPairPotential::addAtom(Atom &atom)
-   {  cellList_.addAtom(atom); }
+   {
+      cellList_.addAtom(atom);
+      if (hasMultiCellList_) multiCellList_.addAtom(atom);
+      if (bridgeSpeciesId_ >= 0) addBridgeAtom(atom);
+      if (isVerletListValid_) addVerletAtom(atom);
+   }
 
    // Delete an atom from the CellList.
    inline void McPairPotential::deleteAtom(Atom &atom)
-   {  cellList_.deleteAtom(atom); }
+   {
+      cellList_.deleteAtom(atom);
+      if (hasMultiCellList_) multiCellList_.deleteAtom(atom);
+      if (bridgeSpeciesId_ >= 0) deleteBridgeAtom(atom);
+      if (isVerletListValid_) deleteVerletAtom(atom);
+   }
 
    // Update the cell list to reflect a new Atom position.
    inline void McPairPotential::updateAtomCell(Atom &atom)
-   {  cellList_.updateAtomCell(atom, atom.position()); }
+   {
+      cellList_.updateAtomCell(atom, atom.position());
+      if (hasMultiCellList_) {
+         multiCellList_.updateAtomCell(atom, atom.position());
+      }
+      if (bridgeSpeciesId_ >= 0) updateBridgeAtom(atom);
+      if (isVerletListValid_) updateVerletAtom(atom);
+   }
 
    // Move atom to a new position.
    inline void McPairPotential::moveAtom(Atom &atom, const Vector &position)
    {
       atom.position() = position;
       cellList_.updateAtomCell(atom, position);
+      if (hasMultiCellList_) multiCellList_.updateAtomCell(atom, position);
+      if (bridgeSpeciesId_ >= 0) updateBridgeAtom(atom);
+      if (isVerletListValid_) updateVerletAtom(atom);
+   }
+
+   // Move an atom to its new cell, without shared cell list updates.
+   inline bool McPairPotential::updateAtomCellLocal(Atom &atom)
+   {
+      assert(!hasMultiCellList_);
+      assert(!isVerletListValid_);
+      return cellList_.updateAtomCellLocal(atom, atom.position());
+   }
+
+   // Complete the cell list updates for an atom after a local update.
+   inline void McPairPotential::completeAtomCell(Atom &atom, int oldCell)
+   {
+      cellList_.updateAtomCell(atom, atom.position());
+      cellList_.markCell(oldCell);
+      cellList_.markCell(cellList_.cellIndexFromPosition(atom.position()));
+      if (bridgeSpeciesId_ >= 0) updateBridgeAtom(atom);
    }
 
    // Get the cellList by const reference.
    inline const CellList& McPairPotential::cellList() const
    { return cellList_; }
 
+   // Does this potential maintain a bridge cell list?
+   inline bool McPairPotential::hasBridgeCellList() const
+   { return (bridgeSpeciesId_ >= 0); }
+
+   // Get the bridge cell list by const reference.
+   inline const CellList& McPairPotential::bridgeCellList() const
+   { return bridgeCellList_; }
+
+   // Does this potential use a multi-level cell list?
+   inline bool McPairPotential::hasMultiCellList() const
+   { return hasMultiCellList_; }
+
+   // Get the multi-level cell list by const reference.
+   inline const MultiCellList& McPairPotential::multiCellList() const
+   { return multiCellList_; }
+
+   // Does this potential use Verlet lists?
+   inline bool McPairPotential::hasVerletList() const
+   { return hasVerletList_; }
+
+   // Get the Verlet skin.
+   inline double McPairPotential::verletSkin() const
+   { return verletSkin_; }
+
+   // Get number of single atom Verlet list rebuilds.
+   inline long McPairPotential::nVerletRebuild() const
+   { return nVerletRebuild_; }
+
+   // Can the Verlet list of an atom be used at a position?
+   inline bool
+   McPairPotential::isVerletValid(const Atom& atom, const Vector& position)
+   const
+   {
+      if (!isVerletListValid_) return false;
+      int id = atom.id();
+      if (!isVerletAtom_[id]) return false;
+      double halfSkin = 0.5*verletSkin_;
+      return (boundary().distanceSq(position, verletPositions_[id])
+              < halfSkin*halfSkin);
+   }
+
+   // Get the Verlet list of an atom.
+   inline const GArray<Atom*>& McPairPotential::verletList(const Atom& atom)
+   const
+   { return verletLists_[atom.id()]; }
+
+   // Mark all Verlet lists invalid.
+   inline void McPairPotential::invalidateVerletLists()
+   { isVerletListValid_ = false; }
+
 } 
 #endif
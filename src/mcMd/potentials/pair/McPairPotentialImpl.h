@@ -97,7 +97,11 @@ namespace McMd
       * \param value  parameter value
       */
       void set(std::string name, int i, int j, double value)
-      {  interaction_.set(name, i, j, value); }
+      {
+         interaction_.set(name, i, j, value);
+         if (hasMultiCellList_) setMultiCellLevels();
+         if (hasVerletList_) invalidateVerletLists();
+      }
 
       /**
       * Get a parameter value, identified by a string.
@@ -136,6 +140,26 @@ namespace McMd
       */
       double atomEnergy(const Atom& atom) const;
 
+      /**
+      * Calculate the nonbonded pair energy of one Atom at a trial position.
+      *
+      * \param  atom     Atom object of interest
+      * \param  position trial position of atom
+      * \return nonbonded pair potential energy of atom at position
+      */
+      double trialEnergy(const Atom& atom, const Vector& position) const;
+
+      /**
+      * Calculate the nonbonded pair energy of one Atom at trial positions.
+      *
+      * \param atom      Atom object of interest
+      * \param positions array of nTrial trial positions
+      * \param nTrial    number of trial positions
+      * \param energies  array of nTrial energies (output)
+      */
+      void trialEnergies(const Atom& atom, const Vector* positions, 
+                         int nTrial, double* energies) const;
+
       /**
       * Calculate the nonbonded pair energy for an entire Molecule.
       *
@@ -144,6 +168,16 @@ namespace McMd
       */
       double moleculeEnergy(const Molecule& molecule) const;
 
+      /**
+      * Change in pair energy of a Molecule if all atoms change type.
+      *
+      * \param  molecule Molecule object of interest
+      * \param  typeId   new atom type for all atoms of the molecule
+      * \return change in nonbonded pair energy of molecule
+      */
+      double
+      moleculeTypeChangeEnergy(const Molecule& molecule, int typeId) const;
+
       /**
       * Compute and store nonbonded pair energy of this System.
       *
@@ -161,6 +195,36 @@ namespace McMd
       //@}
 
    private:
+
+      /**
+      * Calculate the nonbonded pair energy of an Atom at a given position.
+      *
+      * \param atom      Atom object of interest
+      * \param position  position at which energy is evaluated
+      */
+      double positionEnergy(const Atom& atom, const Vector& position) const;
+
+      /**
+      * Calculate the energy of an Atom at a position, by MultiCellList.
+      *
+      * \param atom      Atom object of interest
+      * \param position  position at which energy is evaluated
+      */
+      double multiLevelEnergy(const Atom& atom, const Vector& position)
+      const;
+
+      /**
+      * Calculate the energy of an Atom at a position, by its Verlet list.
+      *
+      * \param atom      Atom object of interest
+      * \param position  position at which energy is evaluated
+      */
+      double verletEnergy(const Atom& atom, const Vector& position) const;
+
+      /**
+      * Set levels of multiCellList_ from the pair cutoffs.
+      */
+      void setMultiCellLevels();
  
       /**
       * Pair interaction object (e.g., Interaction == LJPair)
@@ -178,6 +242,26 @@ namespace McMd
       template <typename T>
       void computeStressImpl(T& stress);
 
+      /**
+      * Return energy of all pairs assigned to cell ic.
+      *
+      * A pair of atoms in the same cell is assigned to that cell. A pair
+      * of atoms in different cells is assigned to the cell with the lower
+      * address, so that each pair is visited once (half-shell stencil).
+      *
+      * \param ic  cell index
+      */
+      double cellEnergy(int ic) const;
+
+      /**
+      * Add stress of all pairs assigned to cell ic (see cellEnergy).
+      *
+      * \param ic      cell index
+      * \param stress  stress accumulator (incremented)
+      */
+      template <typename T>
+      void incrementCellStress(int ic, T& stress) const;
+
    };
 
 }
@@ -191,9 +275,11 @@ namespace McMd
 #include <util/space/Dimension.h>
 #include <util/space/Vector.h>
 #include <util/space/Tensor.h>
+#include <util/containers/DArray.h>
 #include <util/accumulators/setToZero.h>
 
 #include <fstream>
+#include <cmath>
 
 namespace McMd
 {
@@ -227,9 +313,17 @@ namespace McMd
       bool nextIndent = false;
       addParamComposite(interaction(), nextIndent);
       interaction().readParameters(in);
+      multiCellRatio_ = 0.0;
+      readOptional<double>(in, "multiCellRatio", multiCellRatio_);
+      verletSkin_ = 0.0;
+      readOptional<double>(in, "verletSkin", verletSkin_);
 
       // Set atom capacity and allocate memory in the CellList.
       cellList_.setAtomCapacity(simulation().atomCapacity());
+      if (multiCellRatio_ > 0.0) {
+         setMultiCellLevels();
+      }
+      allocateVerletLists();
    }
 
    /*
@@ -245,9 +339,17 @@ namespace McMd
       bool nextIndent = false;
       addParamComposite(interaction(), nextIndent);
       interaction().loadParameters(ar);
+      multiCellRatio_ = 0.0;
+      loadParameter<double>(ar, "multiCellRatio", multiCellRatio_, false);
+      verletSkin_ = 0.0;
+      loadParameter<double>(ar, "verletSkin", verletSkin_, false);
 
       // Allocate memory for the CellList.
       cellList_.setAtomCapacity(simulation().atomCapacity());
+      if (multiCellRatio_ > 0.0) {
+         setMultiCellLevels();
+      }
+      allocateVerletLists();
    }
 
    /*
@@ -257,6 +359,8 @@ namespace McMd
    void McPairPotentialImpl<Interaction>::save(Serializable::OArchive &ar)
    {
       interaction().save(ar);
+      Parameter::saveOptional(ar, multiCellRatio_, (multiCellRatio_ > 0.0));
+      Parameter::saveOptional(ar, verletSkin_, (verletSkin_ > 0.0));
    }
 
    /*
@@ -291,42 +395,212 @@ namespace McMd
    {  return interaction().maxPairCutoff(); }
 
    /* 
-   * Return nonbonded pair energy for one Atom.
+   * Return nonbonded pair energy of one Atom at a specified position.
+   *
+   * Loops directly over the atoms of the neighboring Cell objects, using
+   * the stencil of neighbor cells stored by the CellList, and evaluates
+   * the separation before the more expensive identity and mask checks.
    */
    template <class Interaction>
-   double McPairPotentialImpl<Interaction>::atomEnergy(const Atom &atom) const
+   double 
+   McPairPotentialImpl<Interaction>::positionEnergy(const Atom &atom, 
+                                                    const Vector& position) 
+   const
    {
-      Atom   *jAtomPtr;
-      double  energy;
-      double  rsq;
-      int     j, jId, nNeighbor;
-      int     id = atom.id();
-
-      // Get array of neighbors
-      cellList_.getNeighbors(atom.position(), neighbors_);
-      nNeighbor = neighbors_.size();
+      if (hasMultiCellList_) {
+         return multiLevelEnergy(atom, position);
+      }
+      if (hasVerletList_) {
+         if (isVerletValid(atom, position)) {
+            return verletEnergy(atom, position);
+         }
+      }
 
-      // Loop over neighboring atoms
+      const Cell* cellPtr;
+      const Atom* jAtomPtr;
+      double energy;
+      double rsq;
+      double cutoffSq = interaction().maxPairCutoff();
+      int    jc, jp, nNeighborCell;
+      int    id = atom.id();
+      int    typeId = atom.typeId();
+      int    ic = cellList_.cellIndexFromPosition(position);
+      cutoffSq *= cutoffSq;
+
+      // Loop over neighboring cells, starting with cell ic
       energy = 0.0;
-      for (j = 0; j < nNeighbor; ++j) {
-         jAtomPtr = neighbors_[j];
-         jId      = jAtomPtr->id();
+      nNeighborCell = cellList_.nNeighborCell();
+      for (jc = 0; jc < nNeighborCell; ++jc) {
+         cellPtr = &cellList_.neighborCell(ic, jc);
+
+         // Loop over atoms in cell
+         for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+            jAtomPtr = cellPtr->atomPtr(jp);
+            if (jAtomPtr == 0) continue;
+
+            rsq = boundary().distanceSq(position, jAtomPtr->position());
+            if (rsq < cutoffSq) {
+
+               // Exclude the atom itself and masked (e.g., bonded) atoms
+               if (jAtomPtr->id() != id) {
+                  if (!atom.mask().isMasked(*jAtomPtr)) {
+                     energy += interaction().
+                               energy(rsq, typeId, jAtomPtr->typeId());
+                  }
+               }
 
-         // Check if atoms are the same
-         if (jId != id) {
+            }
+         }
+      } 
+      return energy;
+   }
 
-            // Check if atoms are bonded
+   /*
+   * Return nonbonded pair energy of one Atom at a specified position.
+   *
+   * Searches the grid of each level of the MultiCellList over the block
+   * of cells given by MultiCellList::getSearchRange().
+   */
+   template <class Interaction>
+   double
+   McPairPotentialImpl<Interaction>::multiLevelEnergy(const Atom &atom,
+                                                      const Vector& position)
+   const
+   {
+      const Cell* cellPtr;
+      const Atom* jAtomPtr;
+      IntVector lower, upper, c;
+      double energy = 0.0;
+      double rsq, cutoffSq;
+      int    jp, level;
+      int    nLevel = multiCellList_.nLevel();
+      int    id = atom.id();
+      int    typeId = atom.typeId();
+      int    iLevel = multiCellList_.level(typeId);
+
+      for (level = 0; level < nLevel; ++level) {
+         cutoffSq = multiCellList_.levelCutoff(iLevel, level);
+         cutoffSq *= cutoffSq;
+         multiCellList_.getSearchRange(position, typeId, level,
+                                       lower, upper);
+         for (c[0] = lower[0]; c[0] <= upper[0]; ++c[0]) {
+            for (c[1] = lower[1]; c[1] <= upper[1]; ++c[1]) {
+               for (c[2] = lower[2]; c[2] <= upper[2]; ++c[2]) {
+                  cellPtr = &multiCellList_.cell(level, c);
+                  for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+                     jAtomPtr = cellPtr->atomPtr(jp);
+                     if (jAtomPtr == 0) continue;
+                     rsq = boundary().distanceSq(position,
+                                                 jAtomPtr->position());
+                     if (rsq < cutoffSq && jAtomPtr->id() != id) {
+                        if (!atom.mask().isMasked(*jAtomPtr)) {
+                           energy += interaction().
+                                     energy(rsq, typeId, jAtomPtr->typeId());
+                        }
+                     }
+                  }
+               }
+            }
+         }
+      }
+      return energy;
+   }
+
+   /*
+   * Return nonbonded pair energy of one Atom at a specified position.
+   *
+   * Loops over the Verlet list of the atom, which contains every atom
+   * within the cutoff of any position within verletSkin/2 of the
+   * reference position of the list.
+   */
+   template <class Interaction>
+   double
+   McPairPotentialImpl<Interaction>::verletEnergy(const Atom &atom,
+                                                  const Vector& position)
+   const
+   {
+      const GArray<Atom*>& list = verletList(atom);
+      const Atom* jAtomPtr;
+      double energy = 0.0;
+      double rsq;
+      double cutoffSq = interaction().maxPairCutoff();
+      int    typeId = atom.typeId();
+      int    j, n;
+      cutoffSq *= cutoffSq;
+
+      n = list.size();
+      for (j = 0; j < n; ++j) {
+         jAtomPtr = list[j];
+         rsq = boundary().distanceSq(position, jAtomPtr->position());
+         if (rsq < cutoffSq) {
             if (!atom.mask().isMasked(*jAtomPtr)) {
-               rsq = boundary().
-                     distanceSq(atom.position(), jAtomPtr->position());
-               energy += interaction().
-                         energy(rsq, atom.typeId(), jAtomPtr->typeId());
+               energy += interaction().energy(rsq, typeId, jAtomPtr->typeId());
             }
          }
-      } 
+      }
       return energy;
    }
 
+   /*
+   * Set levels of the MultiCellList from the pair cutoffs (private).
+   */
+   template <class Interaction>
+   void McPairPotentialImpl<Interaction>::setMultiCellLevels()
+   {
+      int nAtomType = simulation().nAtomType();
+      DMatrix<double> cutoffs;
+      cutoffs.allocate(nAtomType, nAtomType);
+      int i, j;
+      for (i = 0; i < nAtomType; ++i) {
+         for (j = 0; j < nAtomType; ++j) {
+            cutoffs(i, j) = sqrt(interaction().cutoffSq(i, j));
+         }
+      }
+      bool isFirst = (multiCellList_.nLevel() == 0);
+      multiCellList_.setLevels(cutoffs, multiCellRatio_);
+      if (isFirst) {
+         multiCellList_.setAtomCapacity(simulation().atomCapacity());
+      }
+      hasMultiCellList_ = (multiCellList_.nLevel() > 1);
+   }
+
+   /* 
+   * Return nonbonded pair energy for one Atom.
+   */
+   template <class Interaction>
+   double McPairPotentialImpl<Interaction>::atomEnergy(const Atom &atom) const
+   {  return positionEnergy(atom, atom.position()); }
+
+   /*
+   * Return nonbonded pair energy for one Atom at a trial position.
+   */
+   template <class Interaction>
+   double
+   McPairPotentialImpl<Interaction>::trialEnergy(const Atom& atom,
+                                                 const Vector& position) const
+   {  return positionEnergy(atom, position); }
+
+   /* 
+   * Return nonbonded pair energies for one Atom at trial positions.
+   */
+   template <class Interaction>
+   void 
+   McPairPotentialImpl<Interaction>::trialEnergies(const Atom& atom, 
+                                                   const Vector* positions,
+                                                   int nTrial, 
+                                                   double* energies) const
+   {
+      int iTrial;
+
+      // Threads are only used when there is enough work to pay for them.
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(static) if (nTrial > 15)
+      #endif
+      for (iTrial = 0; iTrial < nTrial; ++iTrial) {
+         energies[iTrial] = positionEnergy(atom, positions[iTrial]);
+      }
+   }
+
    /* 
    * Return nonbonded pair potential energy for one Molecule.
    */
@@ -374,113 +648,225 @@ namespace McMd
    }
 
    /*
-   * Compute and store total nonbonded pair potential energy for System.
+   * Return change in pair energy of a Molecule if all atoms change type.
+   *
+   * Each pair is found once, and contributes the difference between its
+   * energies with new and old types, so that the molecule is not modified
+   * and no second pass over neighbors is needed.
    */
    template <class Interaction>
-   void McPairPotentialImpl<Interaction>::computeEnergy()
+   double
+   McPairPotentialImpl<Interaction>::moleculeTypeChangeEnergy(
+                                     const Molecule &molecule,
+                                     int typeId) const
    {
-      Atom  *iAtomPtr, *jAtomPtr;
-      double energy;
+      const Atom* iAtomPtr;
+      const Atom* jAtomPtr;
+      double  difference;
       double  rsq;
-      int    nNeighbor, nInCell;
-      int    i, j, iId, jId, ic;
+      int     i, iId, iType, j, jId, jType, nNeighbor;
 
-      // Loop over cells
-      energy = 0.0;
-      for (ic=0; ic < cellList_.totCells(); ++ic) {
+      difference = 0.0;
+      for (i = 0; i < molecule.nAtom(); ++i) {
+         iAtomPtr = &molecule.atom(i);
+         iId      = iAtomPtr->id();
+         iType    = iAtomPtr->typeId();
 
          // Get array of neighbors
-         cellList_.getCellNeighbors(ic, neighbors_, nInCell);
+         cellList_.getNeighbors(iAtomPtr->position(), neighbors_);
          nNeighbor = neighbors_.size();
-  
-         // Loop over primary atoms in this cell
-         for (i = 0; i < nInCell; ++i) {
-            iAtomPtr = neighbors_[i];
-            iId      = iAtomPtr->id();
-          
-            // Loop over secondary atoms in this and neighboring cells
-            for (j = 0; j < nNeighbor; ++j) {
-               jAtomPtr = neighbors_[j];
-               jId      = jAtomPtr->id();
-     
-               // Count each pair only once 
-               if (jId > iId) {
-
-                  // Exclude masked pairs
-                  if (!iAtomPtr->mask().isMasked(*jAtomPtr)) {
 
-                     rsq = boundary().distanceSq(iAtomPtr->position(), 
-                                                 jAtomPtr->position());
-                     energy += interaction().energy(rsq, iAtomPtr->typeId(), 
-                                                  jAtomPtr->typeId());
-                  }
+         // Loop over neighboring atoms
+         for (j = 0; j < nNeighbor; ++j) {
+            jAtomPtr = neighbors_[j];
+            jId      = jAtomPtr->id();
+            if (jId == iId) continue;
+            if (iAtomPtr->mask().isMasked(*jAtomPtr)) continue;
+            if (&iAtomPtr->molecule() != &jAtomPtr->molecule()) {
+               jType = jAtomPtr->typeId();
+               rsq = boundary().distanceSq(iAtomPtr->position(),
+                                           jAtomPtr->position());
+               difference += interaction().energy(rsq, typeId, jType)
+                           - interaction().energy(rsq, iType, jType);
+            } else
+            if (iId < jId) {
+               jType = jAtomPtr->typeId();
+               rsq = boundary().distanceSq(iAtomPtr->position(),
+                                           jAtomPtr->position());
+               difference += interaction().energy(rsq, typeId, typeId)
+                           - interaction().energy(rsq, iType, jType);
+            }
+         }
+      }
+      return difference;
+   }
 
+   /*
+   * Return energy of all pairs assigned to cell ic (half-shell stencil).
+   */
+   template <class Interaction>
+   double McPairPotentialImpl<Interaction>::cellEnergy(int ic) const
+   {
+      const Cell* cellPtr = &cellList_.cell(ic);
+      const Cell* otherPtr;
+      const Atom* iAtomPtr;
+      const Atom* jAtomPtr;
+      double energy = 0.0;
+      double rsq;
+      int    nNeighborCell = cellList_.nNeighborCell();
+      int    jc, i, j, iId, iType;
+
+      for (jc = 0; jc < nNeighborCell; ++jc) {
+         otherPtr = &cellList_.neighborCell(ic, jc);
+         if (otherPtr < cellPtr) continue;
+
+         // Loop over primary atoms in cell ic
+         for (i = 0; i < cellPtr->firstClearPos(); ++i) {
+            iAtomPtr = cellPtr->atomPtr(i);
+            if (iAtomPtr == 0) continue;
+            iId = iAtomPtr->id();
+            iType = iAtomPtr->typeId();
+
+            // Loop over secondary atoms in neighbor cell
+            for (j = 0; j < otherPtr->firstClearPos(); ++j) {
+               jAtomPtr = otherPtr->atomPtr(j);
+               if (jAtomPtr == 0) continue;
+
+               // Count pairs within one cell only once 
+               if (otherPtr == cellPtr && jAtomPtr->id() <= iId) continue;
+
+               // Exclude masked pairs
+               if (!iAtomPtr->mask().isMasked(*jAtomPtr)) {
+                  rsq = boundary().distanceSq(iAtomPtr->position(), 
+                                              jAtomPtr->position());
+                  energy += interaction().energy(rsq, iType, 
+                                                 jAtomPtr->typeId());
                }
+            }
+         }
+      }
+      return energy;
+   }
 
-            } // secondary atoms
-
-         } // primary atoms
-
-      } // cells
+   /*
+   * Compute and store total nonbonded pair potential energy for System.
+   */
+   template <class Interaction>
+   void McPairPotentialImpl<Interaction>::computeEnergy()
+   {
+      int nCell = cellList_.totCells();
+      int nOccupied = cellList_.nOccupiedCell();
+      int ic, k;
+
+      // Compute energy of each non-empty cell, then sum over all cells in
+      // order of cell index, so that the result does not depend on the
+      // number of threads or on the order of the list of non-empty cells.
+      DArray<double> cellEnergies;
+      cellEnergies.allocate(nCell);
+      for (ic = 0; ic < nCell; ++ic) {
+         cellEnergies[ic] = 0.0;
+      }
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(dynamic, 16) private(ic)
+      #endif
+      for (k = 0; k < nOccupied; ++k) {
+         ic = cellList_.occupiedCell(k);
+         cellEnergies[ic] = cellEnergy(ic);
+      }
+      double energy = 0.0;
+      for (ic = 0; ic < nCell; ++ic) {
+         energy += cellEnergies[ic];
+      }
 
       // Store local variable energy in Setable<double> class member energy_
       energy_.set(energy);
    }
 
    /*
-   * Compute nonbonded pair stress.
+   * Add stress of all pairs assigned to cell ic (half-shell stencil).
    */
    template <class Interaction>
    template <typename T>
-   void McPairPotentialImpl<Interaction>::computeStressImpl(T& stress)
+   void 
+   McPairPotentialImpl<Interaction>::incrementCellStress(int ic, T& stress) 
+   const
    {
+      const Cell* cellPtr = &cellList_.cell(ic);
+      const Cell* otherPtr;
+      const Atom* atom0Ptr;
+      const Atom* atom1Ptr;
       Vector dr;
       Vector force;
       double rsq;
-      const Atom *atom0Ptr, *atom1Ptr;
-      int nNeighbor, nInCell, ia, ja, type0, type1;
+      int    nNeighborCell = cellList_.nNeighborCell();
+      int    jc, ia, ja, type0, type1;
 
-      setToZero(stress);
+      for (jc = 0; jc < nNeighborCell; ++jc) {
+         otherPtr = &cellList_.neighborCell(ic, jc);
+         if (otherPtr < cellPtr) continue;
 
-      // Loop over cells
-      for (int ic=0; ic < cellList_.totCells(); ++ic) {
-
-         // Get array of neighbors
-         cellList_.getCellNeighbors(ic, neighbors_, nInCell);
-         nNeighbor = neighbors_.size();
-  
-         // Loop over primary atoms in this cell.
-         for (ia = 0; ia < nInCell; ++ia) {
-            atom0Ptr = neighbors_[ia];
+         // Loop over primary atoms in cell ic
+         for (ia = 0; ia < cellPtr->firstClearPos(); ++ia) {
+            atom0Ptr = cellPtr->atomPtr(ia);
+            if (atom0Ptr == 0) continue;
             type0 = atom0Ptr->typeId();
-          
-            // Loop over secondary atoms in the neighboring cells.
-            for (ja = 0; ja < nNeighbor; ++ja) {
-               atom1Ptr = neighbors_[ja];
-               type1 = atom1Ptr->typeId();
-     
-               // Count each pair only once.
-               if (atom1Ptr->id() > atom0Ptr->id()) {
-
-                  // Exclude masked pairs.
-                  if (!atom0Ptr->mask().isMasked(*atom1Ptr)) {
-                     rsq = boundary().distanceSq(atom0Ptr->position(),
-                                                 atom1Ptr->position(), dr);
-                     if (rsq < interaction().cutoffSq(type0, type1)) {
-                        force = dr;
-                        force *= interaction().forceOverR(rsq, type0, type1);
-                        incrementPairStress(force, dr, stress);
-                     }
 
-                  }
+            // Loop over secondary atoms in neighbor cell
+            for (ja = 0; ja < otherPtr->firstClearPos(); ++ja) {
+               atom1Ptr = otherPtr->atomPtr(ja);
+               if (atom1Ptr == 0) continue;
 
+               // Count pairs within one cell only once 
+               if (otherPtr == cellPtr && atom1Ptr->id() <= atom0Ptr->id()) {
+                  continue;
                }
 
-            } // secondary atoms
-
-         } // primary atoms
+               // Exclude masked pairs.
+               if (!atom0Ptr->mask().isMasked(*atom1Ptr)) {
+                  type1 = atom1Ptr->typeId();
+                  rsq = boundary().distanceSq(atom0Ptr->position(),
+                                              atom1Ptr->position(), dr);
+                  if (rsq < interaction().cutoffSq(type0, type1)) {
+                     force = dr;
+                     force *= interaction().forceOverR(rsq, type0, type1);
+                     incrementPairStress(force, dr, stress);
+                  }
+               }
+            }
+         }
+      }
+   }
 
-      } // cells
+   /*
+   * Compute nonbonded pair stress.
+   */
+   template <class Interaction>
+   template <typename T>
+   void McPairPotentialImpl<Interaction>::computeStressImpl(T& stress)
+   {
+      int nCell = cellList_.totCells();
+      int nOccupied = cellList_.nOccupiedCell();
+      int ic, k;
+
+      // Compute stress of each non-empty cell, then sum over all cells in
+      // order of cell index, so that the result does not depend on the
+      // number of threads or on the order of the list of non-empty cells.
+      DArray<T> cellStresses;
+      cellStresses.allocate(nCell);
+      for (ic = 0; ic < nCell; ++ic) {
+         setToZero(cellStresses[ic]);
+      }
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(dynamic, 16) private(ic)
+      #endif
+      for (k = 0; k < nOccupied; ++k) {
+         ic = cellList_.occupiedCell(k);
+         incrementCellStress(ic, cellStresses[ic]);
+      }
+      setToZero(stress);
+      for (ic = 0; ic < nCell; ++ic) {
+         stress += cellStresses[ic];
+      }
 
       // Normalize by volume.
       stress /= boundary().volume();
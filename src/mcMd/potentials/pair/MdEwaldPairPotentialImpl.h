@@ -148,6 +148,14 @@ namespace McMd
        // Force evaluation, which adds both types of pair force.
       virtual void addForces();
 
+      /**
+      * Add both types of pair force, and set both pair energies.
+      *
+      * Evaluates forces, the non-Coulomb pair energy and the r-space
+      * Coulomb energy in a single loop over the pair list.
+      */
+      virtual void addForcesAndEnergy();
+
       /**
       * Unset both energy accumulators.
       */
@@ -295,6 +303,9 @@ namespace McMd
  
       // Initialize the PairList 
       pairList_.initialize(simulation().atomCapacity(), cutoff);
+      if (pairList_.typePairList()) {
+         UTIL_THROW("typePairList is not supported with Ewald potentials");
+      }
 
    }
 
@@ -315,6 +326,9 @@ namespace McMd
       UTIL_CHECK(ewaldInteractionPtr_->rSpaceCutoff() >= 
                  pairPtr_->maxPairCutoff())
       loadParamComposite(ar, pairList_);
+      if (pairList_.typePairList()) {
+         UTIL_THROW("typePairList is not supported with Ewald potentials");
+      }
 
    }
 
@@ -414,6 +428,62 @@ namespace McMd
 
    }
 
+   /*
+   * Add nonBonded pair forces, and set both pair energy accumulators.
+   */
+   template <class Interaction>
+   void MdEwaldPairPotentialImpl<Interaction>::addForcesAndEnergy()
+   {
+      UTIL_CHECK(ewaldInteractionPtr_);
+      UTIL_CHECK(rSpaceAccumulatorPtr_);
+
+      // Update PairList if necessary
+      if (!isPairListCurrent()) {
+         buildPairList();
+      }
+
+      PairIterator iter;
+      Vector force;
+      double rsq, qProduct, forceOverR;
+      double pairEnergy, pairForceOverR;
+      double pEnergy = 0.0;
+      double cEnergy = 0.0;
+      double ewaldCutoffSq = ewaldInteractionPtr_->rSpaceCutoffSq();
+      Atom *atom0Ptr;
+      Atom *atom1Ptr;
+      int type0, type1;
+
+      // Loop over nonbonded neighbor pairs
+      for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         rsq = boundary().
+               distanceSq(atom0Ptr->position(), atom1Ptr->position(),
+                          force);
+         if (rsq < ewaldCutoffSq) {
+            type0 = atom0Ptr->typeId();
+            type1 = atom1Ptr->typeId();
+            qProduct = (*atomTypesPtr_)[type0].charge();
+            qProduct *= (*atomTypesPtr_)[type1].charge();
+            ewaldInteractionPtr_->rSpaceEvaluate(rsq, qProduct,
+                                                 pairEnergy, forceOverR);
+            cEnergy += pairEnergy;
+            if (rsq < pairPtr_->cutoffSq(type0, type1)) {
+               pairPtr_->evaluate(rsq, type0, type1,
+                                  pairEnergy, pairForceOverR);
+               forceOverR += pairForceOverR;
+               pEnergy += pairEnergy;
+            }
+            force *= forceOverR;
+            atom0Ptr->force() += force;
+            atom1Ptr->force() -= force;
+         }
+      }
+
+      // Set energy accumulators
+      energy_.set(pEnergy);
+      rSpaceAccumulatorPtr_->rSpaceEnergy_.set(cEnergy);
+   }
+
    /*
    * Unset both energy accumulators.
    */
@@ -537,7 +607,7 @@ namespace McMd
             }
 
             // Short-range Coulomb stress 
-            qProduct  = (*atomTypesPtr_)[type0].charge();
+            qProduct = (*atomTypesPtr_)[type0].charge();
             qProduct *= (*atomTypesPtr_)[type1].charge();
             force = dr;
             forceOverR = ewaldInteractionPtr_->rSpaceForceOverR(rsq, qProduct);
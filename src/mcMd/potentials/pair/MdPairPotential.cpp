@@ -8,12 +8,17 @@
 #include "MdPairPotential.h"
 #include <mcMd/simulation/System.h> 
 #include <mcMd/simulation/Simulation.h> 
+#include <mcMd/chemistry/Molecule.h> 
 #include <util/boundary/Boundary.h> 
 
 #include <util/global.h> 
 
 #include <fstream>
 
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
+
 namespace McMd
 {
 
@@ -24,7 +29,14 @@ namespace McMd
    */
    MdPairPotential::MdPairPotential(System& system)
     : ParamComposite(),
-      SystemInterface(system)
+      SystemInterface(system),
+      useCellList_(false),
+      forceMethod_("pairList")
+      #ifdef MCMD_OPENMP
+      , threadForces_()
+      , nThread_(0)
+      , threadCapacity_(0)
+      #endif
    {  setClassName("MdPairPotential"); }
  
    /* 
@@ -33,14 +45,64 @@ namespace McMd
    MdPairPotential::~MdPairPotential() 
    {}
 
+   /* 
+   * Add pair forces (default does not compute energy).
+   */ 
+   void MdPairPotential::addForcesAndEnergy()
+   {  addForces(); }
+
+   /* 
+   * Read optional choice of force loop.
+   */ 
+   void MdPairPotential::readForceMethod(std::istream& in) 
+   {
+      forceMethod_ = "pairList";
+      readOptional<std::string>(in, "forceMethod", forceMethod_);
+      if (forceMethod_ == "pairList") {
+         useCellList_ = false;
+      } else
+      if (forceMethod_ == "cellList") {
+         useCellList_ = true;
+      } else {
+         UTIL_THROW("Unknown forceMethod: must be pairList or cellList");
+      }
+   }
+
+   /* 
+   * Load optional choice of force loop.
+   */ 
+   void MdPairPotential::loadForceMethod(Serializable::IArchive& ar) 
+   {
+      forceMethod_ = "pairList";
+      loadParameter<std::string>(ar, "forceMethod", forceMethod_, false);
+      useCellList_ = (forceMethod_ == "cellList");
+   }
+
+   /* 
+   * Save optional choice of force loop.
+   */ 
+   void MdPairPotential::saveForceMethod(Serializable::OArchive& ar) 
+   {  Parameter::saveOptional(ar, forceMethod_, useCellList_); }
+
    /* 
    * Build the PairList.
    */ 
    void MdPairPotential::buildPairList() 
+   {
+      buildCellList();
+
+      // Use the completed CellList to build the PairList 
+      pairList_.build(boundary());
+   }
+
+   /* 
+   * Shift atoms and rebuild the CellList.
+   */ 
+   void MdPairPotential::buildCellList() 
    {
       // Precondition
       if (!pairList_.isInitialized()) {
-         UTIL_THROW("PairList not initialized in MdPairPotential::buildPairList");
+         UTIL_THROW("PairList not initialized in MdPairPotential");
       }
 
       // Set up an empty PairList with an empty internal CellList.
@@ -62,10 +124,51 @@ namespace McMd
             }
          }
       }
+   }
 
-      // Use the completed CellList to build the PairList 
-      pairList_.build(boundary());
+   #ifdef MCMD_OPENMP
+   /*
+   * Allocate per-thread force accumulators, if necessary.
+   */
+   void MdPairPotential::beginThreadForces()
+   {
+      if (!threadForces_.isAllocated()) {
+         nThread_ = omp_get_max_threads();
+         threadCapacity_ = simulation().atomCapacity();
+         int n = nThread_*threadCapacity_;
+         threadForces_.allocate(n);
+         for (int i = 0; i < n; ++i) {
+            threadForces_[i].zero();
+         }
+      } else 
+      if (omp_get_max_threads() > nThread_) {
+         UTIL_THROW("Number of threads increased after first threaded loop");
+      }
+   }
+
+   /*
+   * Reduce per-thread forces onto atoms and re-zero accumulators.
+   */
+   void MdPairPotential::endThreadForces()
+   {
+      int iSpec, nMol, iMol, ia, t;
+      for (iSpec = 0; iSpec < simulation().nSpecies(); ++iSpec) {
+         nMol = nMolecule(iSpec);
+         #pragma omp parallel for private(ia, t)
+         for (iMol = 0; iMol < nMol; ++iMol) {
+            Molecule& molecule = system().molecule(iSpec, iMol);
+            for (ia = 0; ia < molecule.nAtom(); ++ia) {
+               Atom& atom = molecule.atom(ia);
+               for (t = 0; t < nThread_; ++t) {
+                  Vector& g = threadForce(t, atom);
+                  atom.force() += g;
+                  g.zero();
+               }
+            }
+         }
+      }
    }
+   #endif
 
    /* 
    * Clear the PairList statistical accumulators
@@ -13,8 +13,15 @@
 #include <mcMd/neighbor/PairList.h>               // member
 
 #include <util/param/ParamComposite.h>            // base class
+#ifdef MCMD_OPENMP
+#include <mcMd/chemistry/Atom.h>                  // inline function
+#include <util/containers/DArray.h>               // member template
+#include <util/space/Vector.h>                    // member template param
+#endif
 #include <util/global.h>
 
+#include <string>
+
 namespace Util
 {
    class Vector;
@@ -59,6 +66,16 @@ namespace McMd
       */
       virtual void addForces() = 0;
 
+      /**
+      * Add pair forces and compute the pair energy.
+      *
+      * Adds pair forces as for addForces(), and may also set the pair 
+      * energy, so that a later call to energy() needs no separate loop.
+      * The default implementation just calls addForces(), leaving the
+      * energy to be computed when it is requested.
+      */
+      virtual void addForcesAndEnergy();
+
       /// \name PairList Management (non-virtual)
       //@{
 
@@ -72,6 +89,15 @@ namespace McMd
       */
       void buildPairList();
 
+      /**
+      * Shift all atoms into the primary cell and rebuild the CellList.
+      *
+      * This method sets up the CellList owned by the PairList and adds
+      * every atom, but does not build the PairList itself. It is used 
+      * by buildPairList() and by cell list force loops.
+      */
+      void buildCellList();
+
       /**
       * Return true if PairList is current, false if obsolete.
       *
@@ -91,6 +117,11 @@ namespace McMd
       */
       const PairList& pairList() const;
 
+      /**
+      * Are forces computed by looping over cells, without a PairList?
+      */
+      bool useCellList() const;
+
       //@}
 
    protected:
@@ -98,6 +129,73 @@ namespace McMd
       /// Verlet neighbor pair list for nonbonded interactions.
       PairList pairList_;
 
+      /**
+      * If true, addForces() rebuilds the CellList at every step and loops
+      * over cells, rather than using the Verlet PairList.
+      */
+      bool useCellList_;
+
+      /**
+      * Read optional forceMethod parameter, and set useCellList_.
+      *
+      * \param in input parameter stream
+      */
+      void readForceMethod(std::istream& in);
+
+      /**
+      * Load optional forceMethod parameter, and set useCellList_.
+      *
+      * \param ar input/loading archive
+      */
+      void loadForceMethod(Serializable::IArchive& ar);
+
+      /**
+      * Save optional forceMethod parameter.
+      *
+      * \param ar output/saving archive
+      */
+      void saveForceMethod(Serializable::OArchive& ar);
+
+      #ifdef MCMD_OPENMP
+      /**
+      * Allocate per-thread force accumulators, if necessary.
+      *
+      * Call outside of a parallel region, before threadForce().
+      */
+      void beginThreadForces();
+
+      /**
+      * Return the force accumulator for an atom in one thread.
+      *
+      * \param threadId  OpenMP thread number
+      * \param atom      Atom of interest
+      */
+      Vector& threadForce(int threadId, const Atom& atom);
+
+      /**
+      * Add per-thread forces to atom forces, and zero accumulators.
+      *
+      * Call outside of a parallel region, after all threads are done.
+      */
+      void endThreadForces();
+      #endif
+
+   private:
+
+      /// Name of force loop method ("pairList" or "cellList").
+      std::string forceMethod_;
+
+      #ifdef MCMD_OPENMP
+      /// Per-thread force accumulators, element t*atomCapacity + atom id.
+      DArray<Vector> threadForces_;
+
+      /// Number of threads for which threadForces_ is allocated.
+      int nThread_;
+
+      /// Number of accumulators per thread (simulation atomCapacity).
+      int threadCapacity_;
+      #endif
+
    };
 
    // Inline functions
@@ -108,5 +206,19 @@ namespace McMd
    inline const PairList& MdPairPotential::pairList() const
    {  return pairList_; }
 
+   /*
+   * Are forces computed by a cell list loop?
+   */
+   inline bool MdPairPotential::useCellList() const
+   {  return useCellList_; }
+
+   #ifdef MCMD_OPENMP
+   /*
+   * Return force accumulator for an atom in one thread.
+   */
+   inline Vector& MdPairPotential::threadForce(int threadId, const Atom& atom)
+   {  return threadForces_[threadId*threadCapacity_ + atom.id()]; }
+   #endif
+
 } 
 #endif
@@ -118,7 +118,10 @@ namespace McMd
       * \param value  new value of parameter
       */
       void set(std::string name, int i, int j, double value)
-      {  interactionPtr_->set(name, i, j, value); }
+      {
+         interactionPtr_->set(name, i, j, value);
+         if (pairList_.typePairList()) setPairListTypeCutoffs();
+      }
 
       /**
       * Get a parameter value, identified by a string.
@@ -145,10 +148,21 @@ namespace McMd
       * Adds non-bonded pair forces to the current values of the
       * forces for all atoms in this system. Before calculating
       * forces, the method checks if the pair list is current,
-      * and rebuilds it if necessary.
+      * and rebuilds it if necessary. If forceMethod is cellList,
+      * the CellList is instead rebuilt and used directly.
       */
       virtual void addForces();
 
+      /**
+      * Add nonbonded pair forces, and compute and store the pair energy.
+      *
+      * Uses Interaction::evaluate() to compute the energy and force of
+      * each pair in a single pass over the pair list. If forces are 
+      * computed using a cell list or OpenMP threads, this just calls
+      * addForces().
+      */
+      virtual void addForcesAndEnergy();
+
       /**
       * Calculate and store pair energy for this System.
       *
@@ -180,6 +194,16 @@ namespace McMd
 
       bool       isCopy_;
 
+      /**
+      * Rebuild the CellList and add forces by a loop over cells.
+      */
+      void addCellListForces();
+
+      /**
+      * Pass the cutoff of each pair of atom types to the PairList.
+      */
+      void setPairListTypeCutoffs();
+
    };
 
 }
@@ -195,6 +219,11 @@ namespace McMd
 #include <util/accumulators/setToZero.h>
 
 #include <fstream>
+#include <cmath>
+
+#ifdef MCMD_OPENMP
+#include <omp.h>
+#endif
 
 namespace McMd
 {
@@ -249,6 +278,9 @@ namespace McMd
       readParamComposite(in, pairList_);
       double cutoff = interaction().maxPairCutoff();
       pairList_.initialize(simulation().atomCapacity(), cutoff);
+      if (pairList_.typePairList()) setPairListTypeCutoffs();
+
+      readForceMethod(in);
    }
 
    /*
@@ -266,6 +298,8 @@ namespace McMd
          interaction().loadParameters(ar);
       }
       loadParamComposite(ar, pairList_);
+      if (pairList_.typePairList()) setPairListTypeCutoffs();
+      loadForceMethod(ar);
    }
 
    /*
@@ -279,6 +313,7 @@ namespace McMd
          interaction().save(ar);
       }
       pairList_.save(ar);
+      saveForceMethod(ar);
    }
 
    /*
@@ -310,6 +345,24 @@ namespace McMd
    double MdPairPotentialImpl<Interaction>::maxPairCutoff() const
    { return interaction().maxPairCutoff(); }
 
+   /*
+   * Pass the cutoff of each pair of atom types to the PairList (private).
+   */
+   template <class Interaction>
+   void MdPairPotentialImpl<Interaction>::setPairListTypeCutoffs()
+   {
+      int nAtomType = simulation().nAtomType();
+      DMatrix<double> cutoffs;
+      cutoffs.allocate(nAtomType, nAtomType);
+      int i, j;
+      for (i = 0; i < nAtomType; ++i) {
+         for (j = 0; j < nAtomType; ++j) {
+            cutoffs(i, j) = sqrt(interaction().cutoffSq(i, j));
+         }
+      }
+      pairList_.setTypeCutoffs(cutoffs);
+   }
+
    /*
    * Return pair interaction class name.
    */
@@ -323,11 +376,50 @@ namespace McMd
    template <class Interaction>
    void MdPairPotentialImpl<Interaction>::addForces()
    {
+      if (useCellList_) {
+         addCellListForces();
+         return;
+      }
+
       // Update PairList if necessary
       if (!isPairListCurrent()) {
          buildPairList();
       }
 
+      #ifdef MCMD_OPENMP
+      // Divide primary atoms among threads, with per-thread forces
+      beginThreadForces();
+      const int nAtom1 = pairList_.nAtom1();
+      #pragma omp parallel
+      {
+         Vector force;
+         double rsq;
+         Atom  *atom0Ptr;
+         Atom  *atom1Ptr;
+         int    i, j, begin, end, type0, type1;
+         int    threadId = omp_get_thread_num();
+
+         #pragma omp for schedule(dynamic, 64)
+         for (i = 0; i < nAtom1; ++i) {
+            pairList_.getPrimary(i, atom0Ptr, begin, end);
+            Vector& force0 = threadForce(threadId, *atom0Ptr);
+            type0 = atom0Ptr->typeId();
+            for (j = begin; j < end; ++j) {
+               atom1Ptr = pairList_.neighborPtr(j);
+               rsq = boundary().
+                     distanceSq(atom0Ptr->position(), atom1Ptr->position(),
+                                force);
+               type1 = atom1Ptr->typeId();
+               if (rsq < interaction().cutoffSq(type0, type1)) {
+                  force *= interaction().forceOverR(rsq, type0, type1);
+                  force0 += force;
+                  threadForce(threadId, *atom1Ptr) -= force;
+               }
+            }
+         }
+      }
+      endThreadForces();
+      #else
       PairIterator iter;
       Vector       force;
       double       rsq;
@@ -349,20 +441,118 @@ namespace McMd
             atom1Ptr->force() -= force;
          }
       }
+      #endif
 
    }
 
    /*
-   * Compute and store all short-range pair energy components.
+   * Add nonBonded pair forces, and compute pair energy in the same loop.
    */
    template <class Interaction>
-   void MdPairPotentialImpl<Interaction>::computeEnergy()
+   void MdPairPotentialImpl<Interaction>::addForcesAndEnergy()
    {
+      #ifdef MCMD_OPENMP
+      addForces();
+      #else
+      if (useCellList_) {
+         addCellListForces();
+         return;
+      }
+
       // Update PairList if necessary
       if (!isPairListCurrent()) {
          buildPairList();
       }
 
+      PairIterator iter;
+      Vector       force;
+      double       rsq, pairEnergy, forceOverR;
+      double       energy = 0.0;
+      Atom        *atom0Ptr;
+      Atom        *atom1Ptr;
+      int          type0, type1;
+
+      // Loop over nonbonded neighbor pairs
+      for (pairList_.begin(iter); iter.notEnd(); ++iter) {
+         iter.getPair(atom0Ptr, atom1Ptr);
+         rsq = boundary().
+               distanceSq(atom0Ptr->position(), atom1Ptr->position(),
+                          force);
+         type0 = atom0Ptr->typeId();
+         type1 = atom1Ptr->typeId();
+         if (rsq < interaction().cutoffSq(type0, type1)) {
+            interaction().evaluate(rsq, type0, type1, 
+                                   pairEnergy, forceOverR);
+            force *= forceOverR;
+            atom0Ptr->force() += force;
+            atom1Ptr->force() -= force;
+            energy += pairEnergy;
+         }
+      }
+
+      // Set value of Setable<double> energy_ 
+      energy_.set(energy);
+      #endif
+   }
+
+   /*
+   * Rebuild the CellList, and add pair forces by looping over cells.
+   */
+   template <class Interaction>
+   void MdPairPotentialImpl<Interaction>::addCellListForces()
+   {
+      buildCellList();
+
+      const CellList& cellList = pairList_.cellList();
+      CellList::NeighborArray neighbors;
+      Vector  force;
+      double  rsq;
+      Atom   *atom0Ptr;
+      Atom   *atom1Ptr;
+      int     nNeighbor, nInCell, ic, ip, jp, id0, type0, type1;
+
+      // Loop over cells, and over atoms in each cell
+      int totCells = cellList.totCells();
+      for (ic = 0; ic < totCells; ++ic) {
+         cellList.getCellNeighbors(ic, neighbors, nInCell);
+         nNeighbor = neighbors.size();
+         for (ip = 0; ip < nInCell; ++ip) {
+            atom0Ptr = neighbors[ip];
+            id0 = atom0Ptr->id();
+            type0 = atom0Ptr->typeId();
+
+            // Loop over atoms in this and neighboring cells
+            for (jp = 0; jp < nNeighbor; ++jp) {
+               atom1Ptr = neighbors[jp];
+               if (atom1Ptr->id() > id0) {
+                  if (!atom0Ptr->mask().isMasked(*atom1Ptr)) {
+                     rsq = boundary().distanceSq(atom0Ptr->position(),
+                                                 atom1Ptr->position(),
+                                                 force);
+                     type1 = atom1Ptr->typeId();
+                     if (rsq < interaction().cutoffSq(type0, type1)) {
+                        force *= interaction().forceOverR(rsq, type0, type1);
+                        atom0Ptr->force() += force;
+                        atom1Ptr->force() -= force;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   /*
+   * Compute and store all short-range pair energy components.
+   */
+   template <class Interaction>
+   void MdPairPotentialImpl<Interaction>::computeEnergy()
+   {
+      // Update PairList if necessary (always, if forces use cells)
+      if (useCellList_ || !isPairListCurrent()) {
+         buildPairList();
+      }
+
       // Loop over pairs
       PairIterator iter;
       Atom *atom0Ptr;
@@ -388,8 +578,8 @@ namespace McMd
    template <typename T>
    void MdPairPotentialImpl<Interaction>::computeStressImpl(T& stress)
    {
-      // Update PairList if necessary
-      if (!isPairListCurrent()) {
+      // Update PairList if necessary (always, if forces use cells)
+      if (useCellList_ || !isPairListCurrent()) {
          buildPairList();
       }
 
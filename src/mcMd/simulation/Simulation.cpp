@@ -72,6 +72,8 @@ namespace McMd
       , hasTether_(-1)
       #endif
       , communicatorPtr_(&communicator)
+      , replicaId_(0)
+      , nReplica_(1)
    {
       setClassName("Simulation");
       Util::initStatic();
@@ -82,6 +84,8 @@ namespace McMd
          UTIL_THROW("MPI not initialized on entry");
       }
       commitMpiTypes();
+      replicaId_ = communicatorPtr_->Get_rank();
+      nReplica_ = communicatorPtr_->Get_size();
 
       // Set directory Id in FileMaster to MPI processor rank.
       fileMaster_.setDirectoryId(communicatorPtr_->Get_rank());
@@ -135,6 +139,8 @@ namespace McMd
       #endif
       #ifdef UTIL_MPI
       , communicatorPtr_(0)
+      , replicaId_(0)
+      , nReplica_(1)
       #endif
    {
       setClassName("Simulation");
@@ -176,6 +182,21 @@ namespace McMd
       ParamComponent::setIoCommunicator(communicator);
    }
 
+   /*
+   * Set the replica index and number of replicas used by a Perturbation.
+   */
+   void Simulation::setReplica(int replicaId, int nReplica)
+   {
+      if (nReplica < 1) {
+         UTIL_THROW("nReplica must be positive");
+      }
+      if (replicaId < 0 || replicaId >= nReplica) {
+         UTIL_THROW("replicaId out of range");
+      }
+      replicaId_ = replicaId;
+      nReplica_ = nReplica;
+   }
+
    /*
    * Set an MPI job to read a single parameter file, from std::cin.
    */
@@ -27,6 +27,7 @@
 #endif
 #include <mcMd/chemistry/AtomType.h>    // member container template parameter
 #include <util/misc/FileMaster.h>       // member
+#include <simp/threads/ThreadPool.h>   // member
 #include <util/random/Random.h>         // member
 #include <util/containers/RArray.h>     // member container for Atoms
 #include <util/containers/DArray.h>     // member containers (Molecules, Bonds, ...)
@@ -202,6 +203,11 @@ namespace McMd
       */
       Random& random();
 
+      /**
+      * Get the ThreadPool by reference.
+      */
+      Simp::ThreadPool& threadPool();
+
       /**
       * Get a specific Species by reference.
       * 
@@ -230,6 +236,35 @@ namespace McMd
       * Get the MPI communicator by reference
       */
       MPI::Intracomm& communicator();
+
+      /**
+      * Was this Simulation constructed with an MPI communicator?
+      */
+      bool hasCommunicator() const;
+
+      /**
+      * Set the index of this replica and the total number of replicas.
+      *
+      * A Perturbation assigns the set of parameters with index
+      * replicaId() to this Simulation, out of nReplica() sets. These
+      * are initialized to the rank and size of the communicator, or to
+      * 0 and 1 if there is none. They are reset by McReplicaSet for
+      * replicas that run within one process.
+      *
+      * \param replicaId index of this replica, 0 <= replicaId < nReplica
+      * \param nReplica  total number of replicas
+      */
+      void setReplica(int replicaId, int nReplica);
+
+      /**
+      * Get the index of this replica.
+      */
+      int replicaId() const;
+
+      /**
+      * Get the total number of replicas.
+      */
+      int nReplica() const;
       #endif
 
       //@}
@@ -280,6 +315,13 @@ namespace McMd
       */
       int atomCapacity() const;
 
+      /**
+      * Get an Atom by its global id.
+      *
+      * \param id atom id, 0 <= id < atomCapacity()
+      */
+      Atom& atom(int id);
+
       /**
       * Get the number of Systems in this Simulation.
       *
@@ -402,6 +444,11 @@ namespace McMd
       */
       Random random_;
 
+      /**
+      * Thread pool shared by all threaded code.
+      */
+      Simp::ThreadPool threadPool_;
+
       /**
       * Object for opening associated input and output files.
       */
@@ -637,6 +684,16 @@ namespace McMd
       * Pointer to the simulation communicator.
       */
       MPI::Intracomm* communicatorPtr_;
+
+      /**
+      * Index of this replica (rank of communicator by default).
+      */
+      int replicaId_;
+
+      /**
+      * Total number of replicas (size of communicator by default).
+      */
+      int nReplica_;
       #endif
  
       //@}
@@ -732,6 +789,9 @@ namespace McMd
    inline int Simulation::atomCapacity() const
    {  return atomCapacity_; }
 
+   inline Atom& Simulation::atom(int id)
+   {  return atoms_[id]; }
+
    #ifdef SIMP_BOND
    inline int Simulation::bondCapacity() const
    {  return bondCapacity_; }
@@ -755,6 +815,9 @@ namespace McMd
    inline Random& Simulation::random()
    {  return random_; }
 
+   inline Simp::ThreadPool& Simulation::threadPool()
+   {  return threadPool_; }
+
    inline const Array<AtomType>& Simulation::atomTypes() const
    {  return atomTypes_; }
 
@@ -767,6 +830,15 @@ namespace McMd
       assert(communicatorPtr_);  
       return *communicatorPtr_; 
    }
+
+   inline bool Simulation::hasCommunicator() const
+   {  return (communicatorPtr_ != 0); }
+
+   inline int Simulation::replicaId() const
+   {  return replicaId_; }
+
+   inline int Simulation::nReplica() const
+   {  return nReplica_; }
    #endif
 
    // Protected inline member functions
@@ -55,6 +55,13 @@ namespace McMd
       */
       virtual void setMoleculeState(Molecule& molecule, int stateId);
 
+      /**
+      * Get the atom type of all atoms in a molecule in a given state.
+      *
+      * \param stateId  state index (0 or 1)
+      */
+      int stateTypeId(int stateId) const;
+
    protected:
 
       /**
@@ -111,5 +118,10 @@ namespace McMd
 
    };
 
+   // Inline member function
+
+   inline int HomopolymerSG::stateTypeId(int stateId) const
+   {  return typeIds_[stateId]; }
+
 }
 #endif
@@ -39,6 +39,7 @@ public:
    void testReadParamBond();
    void testReadConfigBond();
    void testPairEnergy();
+   void testMoleculeTypeChangeEnergy();
    void testBondEnergy();
    void testActivate();
    void testMdSystemCopy();
@@ -150,12 +151,15 @@ void McSimulationTest::testPairEnergy()
    System::MoleculeIterator molIter;
    Molecule::AtomIterator atomIter;
    double total = system_.pairPotential().energy();
-   double de;
+   double de, trial;
    double energy = 0.0;
    for (int is=0; is < simulation_.nSpecies(); ++is) {
       for (system_.begin(is, molIter); molIter.notEnd(); ++molIter) {
          for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
             de = system_.pairPotential().atomEnergy(*atomIter);
+            system_.pairPotential().
+                    trialEnergies(*atomIter, &atomIter->position(), 1, &trial);
+            TEST_ASSERT(eq(de, trial));
             //std::cout.width(5);
             //std::cout << atomIter->id() << "     " << de << std::endl;
             energy += de;
@@ -169,6 +173,38 @@ void McSimulationTest::testPairEnergy()
    TEST_ASSERT(eq(0.5*energy, total));
 }
 
+void McSimulationTest::testMoleculeTypeChangeEnergy()
+{
+   printMethod(TEST_FUNC);
+   std::cout << std::endl;
+
+   readParam("in/McSimulation");
+   readConfig("in/config");
+
+   // Compare to moleculeEnergy before and after changing all atom types
+   System::MoleculeIterator molIter;
+   Molecule::AtomIterator atomIter;
+   McPairPotential& potential = system_.pairPotential();
+   double oldEnergy, newEnergy, difference;
+   int oldTypeId, newTypeId;
+   for (int is=0; is < simulation_.nSpecies(); ++is) {
+      for (system_.begin(is, molIter); molIter.notEnd(); ++molIter) {
+         oldTypeId = molIter->atom(0).typeId();
+         newTypeId = (oldTypeId == 0) ? 1 : 0;
+         oldEnergy = potential.moleculeEnergy(*molIter);
+         difference = potential.moleculeTypeChangeEnergy(*molIter, newTypeId);
+         for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+            atomIter->setTypeId(newTypeId);
+         }
+         newEnergy = potential.moleculeEnergy(*molIter);
+         for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+            atomIter->setTypeId(oldTypeId);
+         }
+         TEST_ASSERT(eq(difference, newEnergy - oldEnergy));
+      }
+   }
+}
+
 void McSimulationTest::testBondEnergy()
 { 
    printMethod(TEST_FUNC);
@@ -399,6 +435,7 @@ TEST_BEGIN(McSimulationTest)
 TEST_ADD(McSimulationTest, testReadParamBond)
 TEST_ADD(McSimulationTest, testReadConfigBond)
 TEST_ADD(McSimulationTest, testPairEnergy)
+TEST_ADD(McSimulationTest, testMoleculeTypeChangeEnergy)
 TEST_ADD(McSimulationTest, testBondEnergy)
 TEST_ADD(McSimulationTest, testActivate)
 TEST_ADD(McSimulationTest, testMdSystemCopy)
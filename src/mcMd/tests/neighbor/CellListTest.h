@@ -320,7 +320,7 @@ public:
          TEST_ASSERT(cellList.cellTags_[k].cellPos == k);
       }
 
-      for (k=N_PART; k < Cell::MaxAtomCell; k++) {
+      for (k=N_PART; k < cellList.cells_[i].capacity(); k++) {
          TEST_ASSERT(cellList.cells_[i].atoms_[k] == 0);
       }
 
@@ -507,6 +507,114 @@ public:
    }
 
 
+   void testCrowdedCell()
+   {
+      const int nAtom = 200;
+      double    cutoff  = 1.2;
+      int       i;
+
+      printMethod(TEST_FUNC);
+
+      // Setup CellList with 6 cells, storage sized for uniform density
+      Vector Lin(2.0, 3.0, 4.0);
+      boundary.setOrthorhombic(Lin);
+      cellList.setAtomCapacity(nAtom);
+      cellList.setup(boundary, cutoff);
+      int capacity = cellList.cells_[0].capacity();
+      TEST_ASSERT(capacity < nAtom);
+
+      RArray<Atom> atoms;
+      Atom::allocate(nAtom, atoms);
+
+      // Add all atoms to one cell, forcing storage to be resized
+      Vector pos(0.5, 0.5, 0.5);
+      int ic = cellList.cellIndexFromPosition(pos);
+      for (i=0; i < nAtom; ++i) {
+         atoms[i].position() = pos;
+         cellList.addAtom(atoms[i]);
+      }
+      TEST_ASSERT(cellList.cells_[ic].nAtomCell() == nAtom);
+      TEST_ASSERT(cellList.cells_[ic].capacity() > capacity);
+      TEST_ASSERT(cellList.isValid(nAtom));
+
+      // Move half of the atoms to another cell
+      Vector newPos(1.5, 2.5, 3.5);
+      int jc = cellList.cellIndexFromPosition(newPos);
+      TEST_ASSERT(jc != ic);
+      for (i=0; i < nAtom; i += 2) {
+         cellList.updateAtomCell(atoms[i], newPos);
+      }
+      TEST_ASSERT(cellList.cells_[ic].nAtomCell() == nAtom/2);
+      TEST_ASSERT(cellList.cells_[jc].nAtomCell() == nAtom/2);
+      TEST_ASSERT(cellList.isValid(nAtom));
+
+      CellList::NeighborArray neighbors;
+      int nInCell;
+      cellList.getCellNeighbors(ic, neighbors, nInCell);
+      TEST_ASSERT(nInCell == nAtom/2);
+      TEST_ASSERT(neighbors.size() == nAtom);
+
+      Atom::deallocate();
+   }
+
+   void testOccupiedCells()
+   {
+      const int nAtom = 4;
+      double    cutoff  = 1.2;
+      int       i;
+
+      printMethod(TEST_FUNC);
+
+      // Setup CellList with 6 cells (a slit with atoms in a few cells)
+      Vector Lin(2.0, 3.0, 4.0);
+      boundary.setOrthorhombic(Lin);
+      cellList.setAtomCapacity(nAtom);
+      cellList.setup(boundary, cutoff);
+      TEST_ASSERT(cellList.nOccupiedCell() == 0);
+
+      RArray<Atom> atoms;
+      Atom::allocate(nAtom, atoms);
+
+      // Put two atoms in each of two cells
+      Vector pos(0.5, 0.5, 0.5);
+      Vector newPos(1.5, 2.5, 3.5);
+      int ic = cellList.cellIndexFromPosition(pos);
+      int jc = cellList.cellIndexFromPosition(newPos);
+      for (i=0; i < nAtom; ++i) {
+         atoms[i].position() = (i < 2) ? pos : newPos;
+         cellList.addAtom(atoms[i]);
+      }
+      TEST_ASSERT(cellList.nOccupiedCell() == 2);
+      TEST_ASSERT(cellList.isValid(nAtom));
+
+      // Empty cell ic, by moving its atoms to cell jc
+      for (i=0; i < 2; ++i) {
+         cellList.updateAtomCell(atoms[i], newPos);
+         atoms[i].position() = newPos;
+      }
+      TEST_ASSERT(cellList.nOccupiedCell() == 1);
+      TEST_ASSERT(cellList.occupiedCell(0) == jc);
+      TEST_ASSERT(cellList.isValid(nAtom));
+
+      // Delete one atom, then all atoms
+      cellList.deleteAtom(atoms[0]);
+      TEST_ASSERT(cellList.nOccupiedCell() == 1);
+      for (i=1; i < nAtom; ++i) {
+         cellList.deleteAtom(atoms[i]);
+      }
+      TEST_ASSERT(cellList.nOccupiedCell() == 0);
+      TEST_ASSERT(cellList.isValid(0));
+
+      // Add one atom back to cell ic
+      atoms[0].position() = pos;
+      cellList.addAtom(atoms[0]);
+      TEST_ASSERT(cellList.nOccupiedCell() == 1);
+      TEST_ASSERT(cellList.occupiedCell(0) == ic);
+      TEST_ASSERT(cellList.isValid(1));
+
+      Atom::deallocate();
+   }
+
    void testGetNeighbors()
    {
       printMethod(TEST_FUNC);
@@ -576,6 +684,58 @@ public:
       Atom::deallocate();
    }
 
+   void testNeighborCells()
+   {
+      printMethod(TEST_FUNC);
+      const int  nAtom = 200;
+      double     cutoff  = 1.2;
+      int        i, ic, jc, jp, k, nInCell;
+
+      // Set up CellList with 3, 2 and 4 cells along x, y and z
+      Vector Lin(4.0, 3.0, 5.0);
+      boundary.setOrthorhombic(Lin);  
+      cellList.setAtomCapacity(nAtom);
+      cellList.setup(boundary, cutoff);
+      TEST_ASSERT(cellList.nNeighborCell() == 3*2*3);
+
+      RArray<Atom>  atoms;
+      Atom::allocate(nAtom, atoms);
+      Vector        pos;
+      Random        random;
+      random.setSeed(1098640);
+      for (i=0; i < nAtom; i++) {
+         boundary.randomPosition(random, pos);
+         atoms[i].setTypeId(1);
+         atoms[i].position() = pos;
+         cellList.addAtom(atoms[i]);
+      }
+
+      // Atoms of neighbor cells must match getCellNeighbors, in order
+      CellList::NeighborArray neighborPtrs;
+      const Cell* cellPtr;
+      for (ic = 0; ic < cellList.totCells(); ++ic) {
+         cellList.getCellNeighbors(ic, neighborPtrs, nInCell);
+         TEST_ASSERT(&cellList.neighborCell(ic, 0) == &cellList.cells_[ic]);
+         k = 0;
+         for (jc = 0; jc < cellList.nNeighborCell(); ++jc) {
+            cellPtr = &cellList.neighborCell(ic, jc);
+            for (jp = 0; jp < cellPtr->firstClearPos(); ++jp) {
+               if (cellPtr->atomPtr(jp)) {
+                  TEST_ASSERT(k < neighborPtrs.size());
+                  TEST_ASSERT(cellPtr->atomPtr(jp) == neighborPtrs[k]);
+                  ++k;
+               }
+            }
+            if (jc == 0) {
+               TEST_ASSERT(k == nInCell);
+            }
+         }
+         TEST_ASSERT(k == neighborPtrs.size());
+      }
+
+      Atom::deallocate();
+   }
+
    void writeCellConfiguration()
    {
       printf("numCells: %i %i %i \n", 
@@ -600,7 +760,10 @@ TEST_ADD(CellListTest, testAddDeleteAtoms)
 TEST_ADD(CellListTest, testAddRandomAtoms)
 TEST_ADD(CellListTest, testBuild)
 TEST_ADD(CellListTest, testUpdateAtomCell)
+TEST_ADD(CellListTest, testCrowdedCell)
+TEST_ADD(CellListTest, testOccupiedCells)
 TEST_ADD(CellListTest, testGetNeighbors)
+TEST_ADD(CellListTest, testNeighborCells)
 TEST_END(CellListTest)
 
 #endif
@@ -19,6 +19,7 @@ private:
    static const int cellId = 37;
 
    Cell            cell;
+   Atom*           storage[nAtom];
    DArray<CellTag> cellTags;
    RArray<Atom>    atoms;
 
@@ -28,6 +29,7 @@ public:
    {
       cellTags.allocate(nAtom);
       Atom::allocate(nAtom, atoms);
+      cell.setStorage(storage, nAtom);
    }
 
    void tearDown()
@@ -48,6 +50,7 @@ public:
       TEST_ASSERT(cell.nAtomCell_ == nAtom);
       TEST_ASSERT(cell.firstEmptyPos_ == nAtom);
       TEST_ASSERT(cell.firstClearPos_ == nAtom);
+      TEST_ASSERT(cell.isFull());
 
       cell.isValid(cellTags, nAtom, cellId);
 
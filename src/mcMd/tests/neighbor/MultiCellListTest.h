@@ -0,0 +1,150 @@
+#ifndef MCMD_MULTI_CELL_LIST_TEST_H
+#define MCMD_MULTI_CELL_LIST_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <mcMd/neighbor/MultiCellList.h>
+#include <util/boundary/Boundary.h>
+#include <mcMd/chemistry/Atom.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/containers/RArray.h>
+#include <util/containers/DMatrix.h>
+
+#include <iostream>
+
+using namespace Util;
+using namespace McMd;
+
+class MultiCellListTest : public UnitTest 
+{
+
+private:
+
+   Boundary boundary;
+   DMatrix<double> cutoffs;
+
+public:
+
+   void setUp()
+   {
+      // Small type 0, large type 1, intermediate cross cutoff
+      if (!cutoffs.isAllocated()) {
+         cutoffs.allocate(2, 2);
+      }
+      cutoffs(0, 0) = 1.0;
+      cutoffs(1, 1) = 4.0;
+      cutoffs(0, 1) = 2.5;
+      cutoffs(1, 0) = 2.5;
+   }
+
+   void tearDown()
+   {}
+
+   void testSetLevels()
+   {
+      printMethod(TEST_FUNC);
+      MultiCellList cellList;
+
+      cellList.setLevels(cutoffs, 2.0);
+      TEST_ASSERT(cellList.nLevel() == 2);
+      TEST_ASSERT(cellList.level(0) == 0);
+      TEST_ASSERT(cellList.level(1) == 1);
+      TEST_ASSERT(eq(cellList.levelCutoff(0, 0), 1.0));
+      TEST_ASSERT(eq(cellList.levelCutoff(0, 1), 2.5));
+      TEST_ASSERT(eq(cellList.levelCutoff(1, 0), 2.5));
+      TEST_ASSERT(eq(cellList.levelCutoff(1, 1), 4.0));
+
+      Vector lengths(10.0, 10.0, 12.0);
+      boundary.setOrthorhombic(lengths);
+      cellList.setAtomCapacity(10);
+      cellList.setup(boundary);
+      TEST_ASSERT(cellList.cellList(0).gridDimension(0) == 10);
+      TEST_ASSERT(cellList.cellList(0).gridDimension(2) == 12);
+      TEST_ASSERT(cellList.cellList(1).gridDimension(0) == 2);
+      TEST_ASSERT(cellList.cellList(1).gridDimension(2) == 3);
+   }
+
+   void testSingleLevel()
+   {
+      printMethod(TEST_FUNC);
+      MultiCellList cellList;
+
+      cellList.setLevels(cutoffs, 5.0);
+      TEST_ASSERT(cellList.nLevel() == 1);
+      TEST_ASSERT(cellList.level(0) == 0);
+      TEST_ASSERT(cellList.level(1) == 0);
+      TEST_ASSERT(eq(cellList.levelCutoff(0, 0), 4.0));
+   }
+
+   void testGetNeighbors()
+   {
+      printMethod(TEST_FUNC);
+      MultiCellList cellList;
+
+      const int nAtom = 400;
+      Vector lengths(10.0, 11.0, 12.0);
+      boundary.setOrthorhombic(lengths);
+      cellList.setLevels(cutoffs, 2.0);
+      cellList.setAtomCapacity(nAtom);
+      cellList.setup(boundary);
+
+      RArray<Atom> atoms;
+      Atom::allocate(nAtom, atoms);
+      Random random;
+      random.setSeed(7430851);
+      Vector pos;
+      int i, j, k, m;
+      for (i = 0; i < nAtom; ++i) {
+         boundary.randomPosition(random, pos);
+         atoms[i].setTypeId(i % 10 == 0 ? 1 : 0);
+         atoms[i].position() = pos;
+         cellList.addAtom(atoms[i]);
+      }
+      try {
+         cellList.isValid();
+      } catch (Exception e) {
+         e.write(std::cout);
+         TEST_ASSERT(0);
+      }
+
+      // Every pair within its level cutoff must be found
+      MultiCellList::NeighborArray neighbors;
+      double cutoff;
+      bool found;
+      for (i = 0; i < nAtom; ++i) {
+         cellList.getNeighbors(atoms[i].position(), atoms[i].typeId(), 
+                               neighbors);
+         for (j = 0; j < nAtom; ++j) {
+            cutoff = cutoffs(atoms[i].typeId(), atoms[j].typeId());
+            if (boundary.distanceSq(atoms[i].position(), 
+                                    atoms[j].position()) < cutoff*cutoff) {
+               found = false;
+               for (k = 0; k < neighbors.size(); ++k) {
+                  if (neighbors[k] == &atoms[j]) found = true;
+               }
+               TEST_ASSERT(found);
+            }
+         }
+
+         // No atom may appear twice
+         for (k = 0; k < neighbors.size(); ++k) {
+            for (m = k + 1; m < neighbors.size(); ++m) {
+               TEST_ASSERT(neighbors[k] != neighbors[m]);
+            }
+         }
+      }
+
+      Atom::deallocate();
+   }
+
+};
+
+TEST_BEGIN(MultiCellListTest)
+TEST_ADD(MultiCellListTest, testSetLevels)
+TEST_ADD(MultiCellListTest, testSingleLevel)
+TEST_ADD(MultiCellListTest, testGetNeighbors)
+TEST_END(MultiCellListTest)
+
+#endif
@@ -1,6 +1,7 @@
 
 #include <mcMd/mdSimulation/MdSimulation.h>
 #include <mcMd/potentials/coulomb/MdCoulombPotential.h>
+#include <mcMd/potentials/coulomb/McCoulombPotential.h>
 #include <mcMd/potentials/pair/MdPairPotential.h>
 #include <simp/species/Species.h>
 #include <util/format/Int.h>
@@ -196,6 +197,81 @@ public:
       coulomb.set("alpha", alpha_);
    }
 
+   /**
+   * Compare incremental k-space energy changes to full recomputation.
+   */
+   void testTrialMoves(int nMove)
+   {
+      McCoulombPotential* mcPtr
+             = dynamic_cast<McCoulombPotential*>(&sim.system().coulombPotential());
+      UTIL_CHECK(mcPtr);
+      McCoulombPotential& coulomb = *mcPtr;
+      MdSystem& system = sim.system();
+      Boundary& boundary = system.boundary();
+
+      coulomb.unsetEnergy();
+      double energy = coulomb.kSpaceEnergy();
+
+      // Displace nMove atoms, one accepted trial move per atom
+      System::MoleculeIterator molIter;
+      Molecule::AtomIterator atomIter;
+      Vector dr, newPosition;
+      double dE, dEMax;
+      int iMove = 0;
+      dEMax = 0.0;
+      for (int iSpecies = 0; iSpecies < sim.nSpecies(); ++iSpecies) {
+         for (system.begin(iSpecies, molIter); molIter.notEnd(); ++molIter) {
+            for (molIter->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               if (iMove >= nMove) break;
+               dr[0] = 0.11*((iMove % 3) - 1);
+               dr[1] = 0.07*((iMove % 5) - 2);
+               dr[2] = 0.13*((iMove % 2) - 0.5);
+               newPosition = atomIter->position();
+               newPosition += dr;
+               boundary.shift(newPosition);
+               coulomb.clearTrial();
+               coulomb.addTrialMove(*atomIter, newPosition);
+               dE = coulomb.trialEnergyChange();
+               atomIter->position() = newPosition;
+               coulomb.acceptTrial();
+               energy += dE;
+               if (fabs(dE) > dEMax) dEMax = fabs(dE);
+               ++iMove;
+            }
+         }
+      }
+
+      // Removal and reinsertion of the same charge costs nothing
+      double reinsertError = 0.0;
+      system.begin(0, molIter);
+      molIter->begin(atomIter);
+      double charge = sim.atomType(atomIter->typeId()).charge();
+      coulomb.clearTrial();
+      coulomb.removeTrialCharge(charge, atomIter->position());
+      double removalEnergy = coulomb.trialEnergyChange();
+      dE = removalEnergy
+         + coulomb.trialInsertionEnergy(charge, atomIter->position());
+      reinsertError = fabs(dE);
+      dE = coulomb.kspaceAtomEnergy(*atomIter) + removalEnergy;
+      double atomEnergyError = fabs(dE);
+
+      double incremental = coulomb.kSpaceEnergy();
+      coulomb.unsetEnergy();
+      double full = coulomb.kSpaceEnergy();
+      std::cout << "Trial moves        " << Int(iMove, 10) << std::endl;
+      std::cout << "Max |dE|           " << Dbl(dEMax, 20) << std::endl;
+      std::cout << "Incremental energy " << Dbl(incremental, 20) << std::endl;
+      std::cout << "Summed energy      " << Dbl(energy, 20) << std::endl;
+      std::cout << "Full energy        " << Dbl(full, 20) << std::endl;
+      std::cout << "Reinsertion error  " << Dbl(reinsertError, 20) << std::endl;
+      std::cout << "Atom energy error  " << Dbl(atomEnergyError, 20) << std::endl;
+      double tolerance = 1.0E-8*(1.0 + fabs(full));
+      UTIL_CHECK(fabs(incremental - full) < tolerance);
+      UTIL_CHECK(fabs(energy - full) < tolerance);
+      UTIL_CHECK(reinsertError < tolerance);
+      UTIL_CHECK(atomEnergyError < tolerance);
+   }
+
    MdSimulation& simulation()
    {  return sim; }
 
@@ -221,5 +297,6 @@ int main(int argc, char* argv[])
    test.readParam("in/param.ewald");
    test.generateConfig();
    test.varyAlpha(1.0, 2.4, 14);
+   test.testTrialMoves(50);
 
 }
@@ -0,0 +1,224 @@
+#ifndef MCMD_EXTERNAL_ENERGY_CACHE_TEST_H
+#define MCMD_EXTERNAL_ENERGY_CACHE_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <mcMd/potentials/external/ExternalEnergyCache.h>
+#include <mcMd/potentials/external/ExternalPotential.h>
+#include <mcMd/chemistry/Atom.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/random/Random.h>
+#include <util/containers/RArray.h>
+
+#include <string>
+
+using namespace Util;
+using namespace McMd;
+
+/*
+* Simple external potential that counts energy evaluations.
+*
+* The energy of an atom of type i at position r is amplitude*(i+1)*r[0].
+*/
+class CountingExternal : public ExternalPotential
+{
+
+public:
+
+   CountingExternal()
+    : amplitude(1.0),
+      nEval(0)
+   {}
+
+   double energy(const Vector& position, int i) const
+   {
+      ++nEval;
+      return amplitude*double(i + 1)*position[0];
+   }
+
+   void getForce(const Vector& position, int type, Vector& force) const
+   {
+      force.zero();
+      force[0] = -amplitude*double(type + 1);
+   }
+
+   void trialEnergies(int typeId, const Vector* positions, int n,
+                      double* energies) const
+   {
+      for (int k = 0; k < n; ++k) {
+         energies[k] = energy(positions[k], typeId);
+      }
+   }
+
+   void addForces()
+   {}
+
+   double energy() const
+   {  return 0.0; }
+
+   double atomEnergy(const Atom& atom) const
+   {  return energy(atom.position(), atom.typeId()); }
+
+   std::string interactionClassName() const
+   {  return "CountingExternal"; }
+
+   double amplitude;
+   mutable int nEval;
+
+};
+
+class ExternalEnergyCacheTest : public UnitTest 
+{
+
+private:
+
+   static const int nAtom = 20;
+
+   ExternalEnergyCache cache;
+   CountingExternal potential;
+   RArray<Atom> atoms;
+
+public:
+
+   void setUp()
+   {
+      Atom::allocate(nAtom, atoms);
+      for (int i = 0; i < nAtom; ++i) {
+         atoms[i].setTypeId(i % 2);
+         atoms[i].position()[0] = 0.1*double(i);
+         atoms[i].position()[1] = 0.0;
+         atoms[i].position()[2] = 0.0;
+      }
+      cache.allocate(nAtom);
+      potential.amplitude = 1.0;
+      potential.nEval = 0;
+   }
+
+   void tearDown()
+   {  Atom::deallocate(); }
+
+   void testHit()
+   {
+      printMethod(TEST_FUNC);
+      Atom& atom = atoms[3];
+
+      double e1 = cache.energy(potential, atom, atom.position());
+      TEST_ASSERT(potential.nEval == 1);
+      double e2 = cache.energy(potential, atom, atom.position());
+      TEST_ASSERT(potential.nEval == 1);
+      TEST_ASSERT(e1 == e2);
+      TEST_ASSERT(e1 == potential.atomEnergy(atom));
+   }
+
+   void testTrialMove()
+   {
+      printMethod(TEST_FUNC);
+      Atom& atom = atoms[4];
+      Vector oldPos = atom.position();
+      Vector newPos = oldPos;
+      newPos[0] += 0.5;
+
+      // Old and trial positions occupy the two slots
+      double eOld = cache.energy(potential, atom, oldPos);
+      double eNew = cache.energy(potential, atom, newPos);
+      TEST_ASSERT(potential.nEval == 2);
+      TEST_ASSERT(eOld == potential.energy(oldPos, atom.typeId()));
+      TEST_ASSERT(eNew == potential.energy(newPos, atom.typeId()));
+      potential.nEval = 0;
+
+      // Either outcome of the move is found without evaluation
+      TEST_ASSERT(cache.energy(potential, atom, oldPos) == eOld);
+      TEST_ASSERT(cache.energy(potential, atom, newPos) == eNew);
+      TEST_ASSERT(potential.nEval == 0);
+
+      // A change of type is a miss
+      atom.setTypeId(1 - atom.typeId());
+      double eType = cache.energy(potential, atom, newPos);
+      TEST_ASSERT(potential.nEval == 1);
+      TEST_ASSERT(eType == potential.energy(newPos, atom.typeId()));
+   }
+
+   void testStore()
+   {
+      printMethod(TEST_FUNC);
+      Atom& atom = atoms[5];
+      Vector pos = atom.position();
+      pos[1] = 0.25;
+
+      double e = potential.energy(pos, atom.typeId());
+      potential.nEval = 0;
+      cache.store(atom, pos, e);
+      TEST_ASSERT(cache.energy(potential, atom, pos) == e);
+      TEST_ASSERT(potential.nEval == 0);
+   }
+
+   void testClear()
+   {
+      printMethod(TEST_FUNC);
+      int i;
+      for (i = 0; i < nAtom; ++i) {
+         cache.energy(potential, atoms[i], atoms[i].position());
+      }
+      TEST_ASSERT(potential.nEval == nAtom);
+
+      // Change the field: entries are stale until cleared
+      potential.amplitude = 2.0;
+      cache.clear();
+      potential.nEval = 0;
+      for (i = 0; i < nAtom; ++i) {
+         double e = cache.energy(potential, atoms[i], atoms[i].position());
+         TEST_ASSERT(e == 2.0*double(atoms[i].typeId() + 1)
+                          *atoms[i].position()[0]);
+      }
+      TEST_ASSERT(potential.nEval == nAtom);
+   }
+
+   void testRandomMoves()
+   {
+      printMethod(TEST_FUNC);
+      Boundary boundary;
+      Vector lengths;
+      lengths[0] = 3.0;
+      lengths[1] = 4.0;
+      lengths[2] = 5.0;
+      boundary.setOrthorhombic(lengths);
+      Random random;
+      random.setSeed(8134127);
+
+      // Propose moves on random atoms; accept half of them
+      Vector trial;
+      double eCache, eDirect;
+      int i, j;
+      for (j = 0; j < 1000; ++j) {
+         i = random.uniformInt(0, nAtom);
+         Atom& atom = atoms[i];
+         eCache = cache.energy(potential, atom, atom.position());
+         eDirect = potential.atomEnergy(atom);
+         TEST_ASSERT(eCache == eDirect);
+         boundary.randomPosition(random, trial);
+         eCache = cache.energy(potential, atom, trial);
+         eDirect = potential.energy(trial, atom.typeId());
+         TEST_ASSERT(eCache == eDirect);
+         if (random.uniform(0.0, 1.0) < 0.5) {
+            atom.position() = trial;
+         }
+         if (j == 500) {
+            potential.amplitude = 0.5;
+            cache.clear();
+         }
+      }
+   }
+
+};
+
+TEST_BEGIN(ExternalEnergyCacheTest)
+TEST_ADD(ExternalEnergyCacheTest, testHit)
+TEST_ADD(ExternalEnergyCacheTest, testTrialMove)
+TEST_ADD(ExternalEnergyCacheTest, testStore)
+TEST_ADD(ExternalEnergyCacheTest, testClear)
+TEST_ADD(ExternalEnergyCacheTest, testRandomMoves)
+TEST_END(ExternalEnergyCacheTest)
+
+#endif
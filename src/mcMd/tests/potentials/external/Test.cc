@@ -0,0 +1,7 @@
+#include "ExternalEnergyCacheTest.h"
+
+int main() 
+{
+   TEST_RUNNER(ExternalEnergyCacheTest) runner;
+   runner.run();
+}
@@ -0,0 +1,8 @@
+
+mcMd_tests_potentials_external_=mcMd/tests/potentials/external/Test.cc
+
+mcMd_tests_potentials_external_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(mcMd_tests_potentials_external_))
+mcMd_tests_potentials_external_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(mcMd_tests_potentials_external_:.cc=.o))
+
@@ -16,6 +16,7 @@
 
 #include <vector>
 #include <sstream>
+#include <cstring>
 
 //! File position of NFILE in DCD header
 #define NFILE_POS 8L
@@ -36,7 +37,8 @@ namespace McMd
    : TrajectoryReader(system),
      nAtoms_(0),
      nFrames_(0),
-     frameId_(0)
+     frameId_(0),
+     frameSize_(0)
    {}
 
    /*
@@ -83,93 +85,77 @@ namespace McMd
 
       file_.seekp(FRAMEDATA_POS);
 
-      xBuffer_.allocate(nAtoms_);
-      yBuffer_.allocate(nAtoms_);
-      zBuffer_.allocate(nAtoms_);
+      // Unit cell record, then x, y and z records, each with markers
+      frameSize_ = 6*sizeof(double) + 2*sizeof(int)
+                 + 3*(nAtoms_*sizeof(float) + 2*sizeof(int));
+      if (!frameBuffer_.isAllocated()) {
+         frameBuffer_.allocate(frameSize_);
+      } else
+      if (frameBuffer_.capacity() != frameSize_) {
+         UTIL_THROW("Inconsistent frame size");
+      }
    }
 
-   bool DCDTrajectoryReader::readFrame()
+   /*
+   * Return pointer to a coordinate block, after checking its markers.
+   */
+   const float* DCDTrajectoryReader::coordinateBlock(int offset) const
    {
-      // Check if the last frame was already read
-      if (frameId_ >= nFrames_) {
-         return false;
-      }
-
-      double lx, ly, lz;
-      double angle0, angle1, angle2;
-
-      Vector lengths;
-
-      // Read frame header
-      int headerSize;
-      headerSize=read_int(file_);
-      if (headerSize != 6*sizeof(double)) {
+      const char* ptr = &frameBuffer_[0] + offset;
+      int blockSize = (int)sizeof(float)*nAtoms_;
+      int begin, end;
+      memcpy(&begin, ptr, sizeof(int));
+      memcpy(&end, ptr + sizeof(int) + blockSize, sizeof(int));
+      if (begin != blockSize || end != blockSize) {
          std::ostringstream oss;
-         oss << "Unknown file format!";
+         oss << "Invalid frame size (got " << begin 
+             << ", expected " << blockSize << ")";
          UTIL_THROW(oss.str().c_str());
       }
+      return (const float*)(ptr + sizeof(int));
+   }
 
-      file_.read((char *)&lx, sizeof(double));
-      file_.read((char *)&angle0, sizeof(double));
-      file_.read((char *)&ly, sizeof(double));
-      file_.read((char *)&angle1, sizeof(double));
-      file_.read((char *)&angle2, sizeof(double));
-      file_.read((char *)&lz, sizeof(double));
-
-      headerSize=read_int(file_);
-      if (headerSize != 6*sizeof(double)) {
-         std::ostringstream oss;
-         oss << "Unkown file format!";
-         UTIL_THROW(oss.str().c_str());
+   bool DCDTrajectoryReader::readFrame()
+   {
+      // Check if the last frame was already read
+      if (frameId_ >= nFrames_) {
+         return false;
       }
 
+      // Read the whole frame with one read
+      file_.read(&frameBuffer_[0], frameSize_);
       if (!file_.good()) {
          std::ostringstream oss;
          oss << "Error reading trajectory file!";
          UTIL_THROW(oss.str().c_str());
       }
 
-      lengths[0]=lx;
-      lengths[1]=ly;
-      lengths[2]=lz;
-      boundary().setOrthorhombic(lengths);
-
-      // Read frame data
-      int blockSize;
-
-      // read coords
-      blockSize = read_int(file_);
-      file_.read((char *) xBuffer_.cArray(), sizeof(float) * nAtoms_);
-      read_int(file_); // blockSize
-
-      if (blockSize != (int)sizeof(float)*nAtoms_) {
-         std::ostringstream oss;
-         oss << "Invalid frame size (got " << blockSize 
-             << ", expected " << nAtoms_ << ")";
-         UTIL_THROW(oss.str().c_str());
-      }
-
-      blockSize = read_int(file_);
-      file_.read((char *) yBuffer_.cArray(), sizeof(float) * nAtoms_);
-      read_int(file_); // blockSize
-
-      if (blockSize != (int)sizeof(float)*nAtoms_) {
+      // Check frame header
+      const char* ptr = &frameBuffer_[0];
+      int headerSize, headerEnd;
+      memcpy(&headerSize, ptr, sizeof(int));
+      memcpy(&headerEnd, ptr + sizeof(int) + 6*sizeof(double), sizeof(int));
+      if (headerSize != (int)(6*sizeof(double)) || headerEnd != headerSize) {
          std::ostringstream oss;
-         oss << "Invalid frame size (got " << blockSize 
-             << ", expected " << nAtoms_ << ")";
+         oss << "Unknown file format!";
          UTIL_THROW(oss.str().c_str());
       }
 
-      blockSize = read_int(file_);
-      file_.read((char *) zBuffer_.cArray(), sizeof(float) * nAtoms_);
-      read_int(file_); // blockSize
+      // Unit cell is stored as (lx, angle0, ly, angle1, angle2, lz)
+      double cell[6];
+      memcpy(cell, ptr + sizeof(int), 6*sizeof(double));
+      Vector lengths;
+      lengths[0] = cell[0];
+      lengths[1] = cell[2];
+      lengths[2] = cell[5];
+      boundary().setOrthorhombic(lengths);
 
-      if (blockSize != (int)sizeof(float)* nAtoms_) {
-         std::ostringstream oss;
-         oss << "Invalid frame size (got " << blockSize 
-             << ", expected " << nAtoms_ << ")";
-         UTIL_THROW(oss.str().c_str());
-      }
+      // Coordinate blocks, accessed in place
+      int offset = 6*sizeof(double) + 2*sizeof(int);
+      int recordSize = nAtoms_*sizeof(float) + 2*sizeof(int);
+      const float* x = coordinateBlock(offset);
+      const float* y = coordinateBlock(offset + recordSize);
+      const float* z = coordinateBlock(offset + 2*recordSize);
 
       // Load positions, assume they are ordered according to species
       int iSpecies,iMol;
@@ -183,9 +169,9 @@ namespace McMd
          for (iMol = 0; iMol < speciesPtr->capacity(); ++iMol) {
             molPtr = &system().molecule(iSpecies, iMol);
             for (molPtr->begin(atomIter); atomIter.notEnd(); ++atomIter) {
-               atomIter->position()[0] = (double) xBuffer_[bufferIdx];
-               atomIter->position()[1] = (double) yBuffer_[bufferIdx];
-               atomIter->position()[2] = (double) zBuffer_[bufferIdx];
+               atomIter->position()[0] = (double) x[bufferIdx];
+               atomIter->position()[1] = (double) y[bufferIdx];
+               atomIter->position()[2] = (double) z[bufferIdx];
 
                // shift into simulation cell
                boundary().shift(atomIter->position());
@@ -202,6 +188,25 @@ namespace McMd
       return true;
    }
 
+   /*
+   * Get number of frames declared in file header.
+   */
+   int DCDTrajectoryReader::nFrame() const
+   {  return nFrames_; }
+
+   /*
+   * Position file at the beginning of frame frameId.
+   */
+   void DCDTrajectoryReader::seekFrame(int frameId)
+   {
+      if (frameId < 0 || frameId >= nFrames_) {
+         UTIL_THROW("Invalid frameId");
+      }
+      file_.clear();
+      file_.seekg(FRAMEDATA_POS + ((long)frameId)*((long)frameSize_));
+      frameId_ = frameId;
+   }
+
    void DCDTrajectoryReader::close()
    { file_.close(); }
 
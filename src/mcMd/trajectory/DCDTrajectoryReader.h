@@ -26,6 +26,10 @@ namespace McMd
    * a species occur in the file consecutively. Currently it has only been 
    * tested with Hoomd generated trajectory files.
    *
+   * Each frame is read into a single buffer by one binary read. The
+   * x, y, and z coordinate blocks are then accessed in place as float 
+   * arrays within that buffer, without further copying.
+   *
    * \ingroup McMd_Trajectory_Module
    */
    class DCDTrajectoryReader : public TrajectoryReader
@@ -57,6 +61,20 @@ namespace McMd
       */
       bool readFrame();
 
+      /**
+      * Get the number of frames declared in the file header.
+      */
+      int nFrame() const;
+
+      /**
+      * Position the file at the beginning of a frame.
+      *
+      * Frames have a fixed size, so any frame can be accessed directly.
+      *
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      void seekFrame(int frameId);
+
       /**
       * Close trajectory file.
       */
@@ -76,14 +94,20 @@ namespace McMd
           /// The current frame index, starting from 0.
           int frameId_;
 
-          /// buffer for reading data (x values).
-          DArray<float> xBuffer_;
+          /// Size of one frame in the file, in bytes.
+          int frameSize_;
 
-          /// buffer for reading data (y values).
-          DArray<float> yBuffer_;
+          /// Buffer holding the data for one frame.
+          DArray<char> frameBuffer_;
 
-          /// buffer for reading data (z values).
-          DArray<float> zBuffer_;
+          /**
+          * Return a pointer to a block of nAtoms_ floats in frameBuffer_.
+          *
+          * Checks the record markers that enclose the block.
+          *
+          * \param offset position of leading record marker in buffer
+          */
+          const float* coordinateBlock(int offset) const;
 
    }; 
 
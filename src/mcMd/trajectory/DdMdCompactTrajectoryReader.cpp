@@ -0,0 +1,118 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DdMdCompactTrajectoryReader.h"
+#include <mcMd/simulation/System.h>
+#include <mcMd/simulation/Simulation.h>
+#include <simp/species/Species.h>
+#include <mcMd/chemistry/Molecule.h>
+#include <mcMd/chemistry/Atom.h>
+#include <util/space/Vector.h>
+
+namespace McMd
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   DdMdCompactTrajectoryReader::DdMdCompactTrajectoryReader(System &system)
+   : TrajectoryReader(system),
+     file_(),
+     trajectory_(),
+     positions_()
+   {}
+
+   /*
+   * Destructor.
+   */
+   DdMdCompactTrajectoryReader::~DdMdCompactTrajectoryReader()
+   {}
+
+   /*
+   * Open trajectory file and setup to read.
+   */
+   void DdMdCompactTrajectoryReader::open(std::string filename)
+   {
+      // Open trajectory file, read header and index
+      simulation().fileMaster().openInputFile(filename, file_,
+                                        std::ios::in | std::ios::binary);
+      trajectory_.readHeader(file_);
+      trajectory_.readIndex(file_);
+
+      // Add all molecules to system and check consistency of nAtom.
+      addMolecules();
+      if (trajectory_.nAtom() != nAtomTotal_) {
+         UTIL_THROW("Inconsistent values: nAtom != nAtomTotal_");
+      }
+     
+      // Allocate private array of atomic positions_
+      if (!positions_.isAllocated()) {
+         positions_.allocate(nAtomTotal_);
+      } else {
+         if (nAtomTotal_ != positions_.capacity()) {
+            UTIL_THROW("Inconsistent values of atom capacity");
+         }
+      }
+   }
+
+   /*
+   * Read frame, return false if end of trajectory.
+   */
+   bool DdMdCompactTrajectoryReader::readFrame()
+   {
+      // Preconditions
+      if (!positions_.isAllocated()) {
+         UTIL_THROW("positions_ array is not allocated");
+      }
+
+      long iStep;
+      if (!trajectory_.readFrame(file_, iStep, boundary(), positions_)) {
+         return false;
+      }
+
+      // Assign atom positions, assuming ordered atom ids 
+      int iSpecies, iMol, id;
+      Species *speciesPtr;
+      Molecule::AtomIterator atomIter;
+      Molecule *molPtr;
+      id = 0;
+      for (iSpecies = 0; iSpecies < simulation().nSpecies(); ++iSpecies) {
+         speciesPtr = &simulation().species(iSpecies);
+         for (iMol = 0; iMol < speciesPtr->capacity(); ++iMol) {
+            molPtr = &system().molecule(iSpecies, iMol);
+            for (molPtr->begin(atomIter); atomIter.notEnd(); ++atomIter) {
+               boundary().transformGenToCart(positions_[id], 
+                                             atomIter->position());
+               id++;
+            }
+         }
+      }
+
+      return true;
+   }
+
+   /*
+   * Get number of frames in the index.
+   */
+   int DdMdCompactTrajectoryReader::nFrame() const
+   {  return trajectory_.nFrame(); }
+
+   /*
+   * Position file at the beginning of a frame.
+   */
+   void DdMdCompactTrajectoryReader::seekFrame(int frameId)
+   {  trajectory_.seekFrame(file_, frameId); }
+
+   /*
+   * Close trajectory file.
+   */
+   void DdMdCompactTrajectoryReader::close()
+   {  file_.close(); }
+
+}
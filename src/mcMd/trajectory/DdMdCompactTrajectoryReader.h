@@ -0,0 +1,95 @@
+#ifndef MCMD_DDMD_COMPACT_TRAJECTORY_READER_H
+#define MCMD_DDMD_COMPACT_TRAJECTORY_READER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <mcMd/trajectory/TrajectoryReader.h> // base class
+#include <simp/trajectory/CompactTrajectory.h> // member
+#include <util/containers/DArray.h>           // member 
+#include <util/space/Vector.h>                // member 
+
+#include <fstream>
+
+namespace McMd
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * TrajectoryReader for a DdMd compact trajectory file.
+   *
+   * Reads the format written by DdMd::DdMdCompactTrajectoryWriter. The
+   * frame index is read (or rebuilt) when the file is opened, after 
+   * which any frame can be accessed directly with seekFrame. Like
+   * DdMdTrajectoryReader, this class assumes that atom tags are ordered 
+   * by molecule and species.
+   *
+   * \ingroup McMd_Trajectory_Module
+   */
+   class DdMdCompactTrajectoryReader : public TrajectoryReader
+   {
+   
+   public:
+
+      /**
+      * Constructor. 
+      */
+      DdMdCompactTrajectoryReader(System& system);
+
+      /** 
+      * Destructor.   
+      */
+      virtual ~DdMdCompactTrajectoryReader();
+ 
+      /**
+      * Open trajectory file, read header and index, and allocate memory.
+      *
+      * \param filename trajectory file name
+      */
+      void open(std::string filename);
+
+      /**
+      * Read the next frame.
+      *
+      * \return true if this frame is available, false if end of file
+      */
+      bool readFrame();
+
+      /**
+      * Get the number of frames in the file.
+      */
+      int nFrame() const;
+
+      /**
+      * Position the file at the beginning of a frame.
+      *
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      void seekFrame(int frameId);
+
+      /**
+      * Close trajectory file.
+      */
+      void close();
+
+   private:
+
+      /// Trajectory file.
+      std::ifstream file_;
+
+      /// File format decoder, and index of frame offsets.
+      CompactTrajectory trajectory_;
+
+      /// Scaled atom positions, indexed by id.
+      DArray< Vector > positions_;
+
+   }; 
+
+} 
+#endif
@@ -11,6 +11,7 @@
 #include <simp/species/Species.h>
 #include <mcMd/chemistry/Molecule.h>
 #include <mcMd/chemistry/Atom.h>
+#include <simp/trajectory/LammpsDumpFormat.h>
 #include <util/space/Vector.h>
 #include <util/space/IntVector.h>
 #include <util/misc/ioUtil.h>
@@ -54,6 +55,28 @@ namespace McMd
             UTIL_THROW("Inconsistent values of atom capacity");
          }
       }
+      if (!lines_.isAllocated()) {
+         lines_.allocate(nAtomTotal_);
+      }
+   }
+
+   /*
+   * Parse one line of the ATOMS block.
+   */
+   bool LammpsDumpReader::parseAtomLine(const std::string& line)
+   {
+      Vector r;
+      int id, typeId, molId;
+      if (!Simp::LammpsDumpFormat::parseAtom(line.c_str(),
+                                             id, typeId, molId, r)) {
+         return false;
+      }
+      if (id < 0 || id >= nAtomTotal_) return false;
+
+      // Position, shifted into the simulation cell. Image flags ignored.
+      boundary().shift(r);
+      positions_[id] = r;
+      return true;
    }
 
    /*
@@ -117,25 +140,26 @@ namespace McMd
       checkString(line, "ATOMS");
       // Ignore the rest of ITEM: ATOMS  line, for now
 
-      // Load positions into positions_ vector, indexed by id.
-      IntVector shift;
-      int id, typeId, molId, i, j;
+      // Read all lines of ATOMS block
+      int i;
       for (i = 0; i < nAtom; ++i) {
-
-         file_ >> id;
-         id = id - 1; // Convert convention, Lammps -> Simpatico
-         file_ >> typeId;
-         file_ >> molId;
- 
-         // Read position
-         for (j = 0; j < Util::Dimension; ++j) {
-            file_ >> positions_[id][j];
+         if (!std::getline(file_, lines_[i])) {
+            UTIL_THROW("EOF reading ITEM: ATOMS");
          }
-         file_ >> shift;
-
-         // shift into simulation cell
-         boundary().shift(positions_[id]);
+      }
 
+      // Parse lines, load positions into positions_, indexed by id.
+      int nError = 0;
+      #ifdef MCMD_OPENMP
+      #pragma omp parallel for schedule(static) reduction(+:nError)
+      #endif
+      for (i = 0; i < nAtom; ++i) {
+         if (!parseAtomLine(lines_[i])) {
+            ++nError;
+         }
+      }
+      if (nError) {
+         UTIL_THROW("Invalid line in ITEM: ATOMS block");
       }
 
       // Assign atom positions, assuming ordered atom ids 
@@ -143,7 +167,7 @@ namespace McMd
       Species *speciesPtr;
       Molecule::AtomIterator atomIter;
       Molecule *molPtr;
-      id = 0;
+      int id = 0;
       for (iSpecies = 0; iSpecies < simulation().nSpecies(); ++iSpecies) {
          speciesPtr = &simulation().species(iSpecies);
          for (iMol = 0; iMol < speciesPtr->capacity(); ++iMol) {
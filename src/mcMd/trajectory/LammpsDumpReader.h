@@ -12,6 +12,8 @@
 #include <util/containers/DArray.h>           // member template
 #include <util/space/Vector.h>                // template argument
 
+#include <string>
+
 namespace McMd
 {
 
@@ -25,6 +27,11 @@ namespace McMd
    * blocks for molecules in the same species. It does not require that 
    * the atoms be ordered consecutively by id within the dump file.
    *
+   * The ATOMS block of each frame is read as nAtom lines, which are
+   * then parsed with strtol and strtod rather than formatted stream
+   * extraction. If compiled with MCMD_OPENMP defined, the lines are 
+   * parsed by several threads.
+   *
    * \ingroup McMd_Trajectory_Module
    */
    class LammpsDumpReader : public TrajectoryReader
@@ -69,6 +76,17 @@ namespace McMd
        /// Atom positions, indexed by id.
        DArray< Vector > positions_;
 
+       /// Lines of the ATOMS block of the current frame.
+       DArray< std::string > lines_;
+
+       /**
+       * Parse one line of the ATOMS block, and store the position.
+       *
+       * \param line  text of line "id type molId x y z ix iy iz"
+       * \return true if line is valid, false otherwise
+       */
+       bool parseAtomLine(const std::string& line);
+
    }; 
 
 } 
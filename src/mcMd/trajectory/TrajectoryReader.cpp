@@ -32,6 +32,12 @@ namespace McMd
    TrajectoryReader::~TrajectoryReader() 
    {}
 
+   /*
+   * Random access (default implementation, not supported).
+   */
+   void TrajectoryReader::seekFrame(int frameId)
+   {  UTIL_THROW("Random access is not supported by this trajectory format"); }
+
    /*
    * Add all molecules and set nAtomTotal_.
    */
@@ -65,6 +65,24 @@ namespace McMd
       */
       virtual bool readFrame() = 0;
 
+      /**
+      * Get the number of frames, if known from a frame index.
+      *
+      * Default implementation returns -1 (unknown).
+      */
+      virtual int nFrame() const
+      {  return -1; }
+
+      /**
+      * Position the file so that the next readFrame() reads frame frameId.
+      *
+      * Only available for formats with a frame index, for which nFrame()
+      * returns a non-negative value. Default implementation throws.
+      *
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      virtual void seekFrame(int frameId);
+
       /**
       * Close the trajectory file.
       */
@@ -0,0 +1,270 @@
+#ifndef SIMP_BLOCK_GYRATION_H
+#define SIMP_BLOCK_GYRATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>
+#include <util/space/Vector.h>
+#include <util/global.h>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Sums for radii of gyration of blocks of atoms of the same type.
+   *
+   * A "block" is the set of all atoms of one type within a molecule.
+   * For each molecule, the caller fills the contiguous arrays position(j)
+   * and typeId(j) for j = 0, ..., nAtom - 1, with positions given as an
+   * unwrapped (continuous) map of the molecule, and then calls
+   * addMolecule(nAtom). This adds the squared distance of each atom from
+   * the center of mass of its block to a sum for its type, and the
+   * squared distance between the centers of mass of each pair of blocks
+   * to a sum for the pair of types. Types that are absent from a molecule
+   * are skipped. Sums of different threads may be combined with add().
+   *
+   * \ingroup Simp_Analysis_Module
+   */
+   class BlockGyration
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      BlockGyration()
+       : positions_(),
+         typeIds_(),
+         rCom_(),
+         nTypeAtom_(),
+         radiusSums_(),
+         atomCounts_(),
+         pairSums_(),
+         pairCounts_(),
+         nAtomType_(0),
+         nMolecule_(0)
+      {}
+
+      /**
+      * Allocate memory, and clear sums.
+      *
+      * \param nAtomType number of atom types
+      * \param nAtom     maximum number of atoms per molecule
+      */
+      void allocate(int nAtomType, int nAtom)
+      {
+         if (nAtomType <= 0 || nAtom <= 0) {
+            UTIL_THROW("Invalid BlockGyration dimensions");
+         }
+         nAtomType_ = nAtomType;
+         positions_.allocate(nAtom);
+         typeIds_.allocate(nAtom);
+         rCom_.allocate(nAtomType);
+         nTypeAtom_.allocate(nAtomType);
+         radiusSums_.allocate(nAtomType);
+         atomCounts_.allocate(nAtomType);
+         pairSums_.allocate(nAtomType*nAtomType);
+         pairCounts_.allocate(nAtomType*nAtomType);
+         clear();
+      }
+
+      /**
+      * Set all sums to zero.
+      */
+      void clear()
+      {
+         int i;
+         for (i = 0; i < nAtomType_; ++i) {
+            radiusSums_[i] = 0.0;
+            atomCounts_[i] = 0;
+         }
+         for (i = 0; i < nAtomType_*nAtomType_; ++i) {
+            pairSums_[i] = 0.0;
+            pairCounts_[i] = 0;
+         }
+         nMolecule_ = 0;
+      }
+
+      /**
+      * Get unwrapped position of atom j of the current molecule.
+      *
+      * \param j atom index within molecule
+      */
+      Vector& position(int j)
+      {  return positions_[j]; }
+
+      /**
+      * Get type id of atom j of the current molecule.
+      *
+      * \param j atom index within molecule
+      */
+      int& typeId(int j)
+      {  return typeIds_[j]; }
+
+      /**
+      * Add contributions of the current molecule to all sums.
+      *
+      * \param nAtom number of atoms in the molecule
+      */
+      void addMolecule(int nAtom)
+      {
+         Vector dR;
+         int j, l, m, t;
+
+         // Compute center of mass of each block
+         for (t = 0; t < nAtomType_; ++t) {
+            rCom_[t].zero();
+            nTypeAtom_[t] = 0;
+         }
+         for (j = 0; j < nAtom; ++j) {
+            t = typeIds_[j];
+            rCom_[t] += positions_[j];
+            ++nTypeAtom_[t];
+         }
+         for (t = 0; t < nAtomType_; ++t) {
+            if (nTypeAtom_[t] > 0) {
+               rCom_[t] /= double(nTypeAtom_[t]);
+               atomCounts_[t] += nTypeAtom_[t];
+            }
+         }
+
+         // Distances between centers of mass of pairs of blocks
+         for (l = 0; l < nAtomType_; ++l) {
+            if (nTypeAtom_[l] == 0) continue;
+            for (m = l + 1; m < nAtomType_; ++m) {
+               if (nTypeAtom_[m] == 0) continue;
+               dR.subtract(rCom_[l], rCom_[m]);
+               pairSums_[l*nAtomType_ + m] += dR.square();
+               ++pairCounts_[l*nAtomType_ + m];
+            }
+         }
+
+         // Distances of atoms from centers of mass of their blocks
+         for (j = 0; j < nAtom; ++j) {
+            t = typeIds_[j];
+            dR.subtract(positions_[j], rCom_[t]);
+            radiusSums_[t] += dR.square();
+         }
+         ++nMolecule_;
+      }
+
+      /**
+      * Add all sums of another object of the same dimensions.
+      *
+      * \param other object to be added to this one
+      */
+      void add(const BlockGyration& other)
+      {
+         if (other.nAtomType_ != nAtomType_) {
+            UTIL_THROW("Inconsistent BlockGyration dimensions");
+         }
+         int i;
+         for (i = 0; i < nAtomType_; ++i) {
+            radiusSums_[i] += other.radiusSums_[i];
+            atomCounts_[i] += other.atomCounts_[i];
+         }
+         for (i = 0; i < nAtomType_*nAtomType_; ++i) {
+            pairSums_[i] += other.pairSums_[i];
+            pairCounts_[i] += other.pairCounts_[i];
+         }
+         nMolecule_ += other.nMolecule_;
+      }
+
+      /**
+      * Mean-squared radius of gyration of blocks of type t.
+      *
+      * Returns zero if no molecule contains atoms of type t.
+      *
+      * \param t atom type index
+      */
+      double radiusSq(int t) const
+      {
+         if (atomCounts_[t] == 0) return 0.0;
+         return radiusSums_[t]/double(atomCounts_[t]);
+      }
+
+      /**
+      * Mean-squared distance between centers of blocks of types l < m.
+      *
+      * Returns zero if no molecule contains both types.
+      *
+      * \param l first atom type index
+      * \param m second atom type index, m > l
+      */
+      double distanceSq(int l, int m) const
+      {
+         int k = l*nAtomType_ + m;
+         if (pairCounts_[k] == 0) return 0.0;
+         return pairSums_[k]/double(pairCounts_[k]);
+      }
+
+      /**
+      * Number of molecules added since the last clear().
+      */
+      int nMolecule() const
+      {  return nMolecule_; }
+
+      /**
+      * Serialize sums to/from an archive.
+      *
+      * Work space for the current molecule is not stored.
+      *
+      * \pre allocate() must have been called.
+      *
+      * \param ar      archive
+      * \param version archive version id
+      */
+      template <class Archive>
+      void serialize(Archive& ar, const unsigned int version)
+      {
+         ar & radiusSums_;
+         ar & atomCounts_;
+         ar & pairSums_;
+         ar & pairCounts_;
+         ar & nMolecule_;
+      }
+
+   private:
+
+      /// Unwrapped positions of atoms in the current molecule.
+      DArray<Vector> positions_;
+
+      /// Type ids of atoms in the current molecule.
+      DArray<int> typeIds_;
+
+      /// Centers of mass of blocks of the current molecule.
+      DArray<Vector> rCom_;
+
+      /// Numbers of atoms of each type in the current molecule.
+      DArray<int> nTypeAtom_;
+
+      /// Sums of squared distances of atoms from block centers, by type.
+      DArray<double> radiusSums_;
+
+      /// Numbers of atoms included in radiusSums_, by type.
+      DArray<long> atomCounts_;
+
+      /// Sums of squared distances between block centers, l*nAtomType + m.
+      DArray<double> pairSums_;
+
+      /// Numbers of molecules included in pairSums_.
+      DArray<long> pairCounts_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Number of molecules added since last clear().
+      int nMolecule_;
+
+   };
+
+}
+#endif
@@ -0,0 +1,254 @@
+#ifndef SIMP_PROFILE_HISTOGRAM_H
+#define SIMP_PROFILE_HISTOGRAM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/format/Dbl.h>
+#include <util/global.h>
+
+#include <iostream>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Histograms of projected atomic positions, for composition profiles.
+   *
+   * A ProfileHistogram holds a histogram of nBin bins over the interval
+   * [0,1) for each pair of a direction and an atom type, all stored in
+   * one contiguous array of counts. A position r is projected onto
+   * direction i by a dot product r.c with a coefficient vector c that
+   * is set by setCoefficients(i, c). The caller chooses each c so that
+   * r.c is a reduced coordinate, e.g., with components c[k] = u[k]/L[k]
+   * for a unit vector u and box lengths L. Values outside the open
+   * interval (0,1) are ignored.
+   *
+   * Histograms of different threads or processors may be summed with
+   * add() or by a reduction of the array data(), and are then written
+   * by output().
+   *
+   * \ingroup Simp_Analysis_Module
+   */
+   class ProfileHistogram
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      ProfileHistogram()
+       : counts_(),
+         coefficients_(),
+         nDirection_(0),
+         nAtomType_(0),
+         nBin_(0)
+      {}
+
+      /**
+      * Allocate memory, and set all counts to zero.
+      *
+      * \param nDirection number of directions
+      * \param nAtomType  number of atom types
+      * \param nBin       number of bins per histogram
+      */
+      void allocate(int nDirection, int nAtomType, int nBin)
+      {
+         if (nDirection <= 0 || nAtomType <= 0 || nBin <= 0) {
+            UTIL_THROW("Invalid ProfileHistogram dimensions");
+         }
+         nDirection_ = nDirection;
+         nAtomType_ = nAtomType;
+         nBin_ = nBin;
+         if (counts_.isAllocated()) {
+            counts_.deallocate();
+            coefficients_.deallocate();
+         }
+         counts_.allocate(nDirection_*nAtomType_*nBin_);
+         coefficients_.allocate(nDirection_);
+         for (int i = 0; i < nDirection_; ++i) {
+            coefficients_[i].zero();
+         }
+         clear();
+      }
+
+      /**
+      * Set the coefficient vector of direction i.
+      *
+      * \param i  direction index
+      * \param c  coefficient vector (projected coordinate is r.c)
+      */
+      void setCoefficients(int i, const Vector& c)
+      {  coefficients_[i] = c; }
+
+      /**
+      * Set coefficients of direction i from a direction vector.
+      *
+      * Sets c[k] = w[k]/(|w| L[k]), so that r.c is the projection
+      * onto the unit vector w/|w| of the reduced position (r[k]/L[k]).
+      *
+      * \param i        direction index
+      * \param w        direction vector (e.g., a reciprocal vector)
+      * \param lengths  box lengths L
+      */
+      void setDirection(int i, const Vector& w, const Vector& lengths)
+      {
+         double norm = w.abs();
+         if (norm <= 0.0) {
+            UTIL_THROW("Zero direction vector");
+         }
+         for (int k = 0; k < Dimension; ++k) {
+            coefficients_[i][k] = w[k]/(norm*lengths[k]);
+         }
+      }
+
+      /**
+      * Set all counts to zero.
+      */
+      void clear()
+      {
+         int size = counts_.capacity();
+         for (int i = 0; i < size; ++i) {
+            counts_[i] = 0;
+         }
+      }
+
+      /**
+      * Add one position of an atom of type typeId to all directions.
+      *
+      * \param r      atomic position
+      * \param typeId atom type index
+      */
+      void sample(const Vector& r, int typeId)
+      {
+         long* counts = &counts_[typeId*nDirection_*nBin_];
+         const Vector* c;
+         double x;
+         int bin;
+         for (int i = 0; i < nDirection_; ++i) {
+            c = &coefficients_[i];
+            x = r[0]*(*c)[0] + r[1]*(*c)[1] + r[2]*(*c)[2];
+            if (x > 0.0 && x < 1.0) {
+               bin = int(x*nBin_);
+               if (bin < nBin_) {
+                  ++counts[i*nBin_ + bin];
+               }
+            }
+         }
+      }
+
+      /**
+      * Add all counts of another histogram of the same dimensions.
+      *
+      * \param other histogram to be added to this one
+      */
+      void add(const ProfileHistogram& other)
+      {
+         int size = counts_.capacity();
+         if (other.counts_.capacity() != size) {
+            UTIL_THROW("Inconsistent ProfileHistogram dimensions");
+         }
+         for (int i = 0; i < size; ++i) {
+            counts_[i] += other.counts_[i];
+         }
+      }
+
+      /**
+      * Get the number of values in one histogram.
+      *
+      * \param i      direction index
+      * \param typeId atom type index
+      */
+      long nSample(int i, int typeId) const
+      {
+         const long* counts = &counts_[(i + typeId*nDirection_)*nBin_];
+         long sum = 0;
+         for (int j = 0; j < nBin_; ++j) {
+            sum += counts[j];
+         }
+         return sum;
+      }
+
+      /**
+      * Write one normalized histogram, one line per bin.
+      *
+      * Each line contains the bin center and the fraction of values in
+      * the bin divided by the bin width.
+      *
+      * \param out    output stream
+      * \param i      direction index
+      * \param typeId atom type index
+      */
+      void output(std::ostream& out, int i, int typeId) const
+      {
+         const long* counts = &counts_[(i + typeId*nDirection_)*nBin_];
+         double width = 1.0/double(nBin_);
+         long n = nSample(i, typeId);
+         double norm = (n > 0) ? 1.0/(double(n)*width) : 0.0;
+         for (int j = 0; j < nBin_; ++j) {
+            out << Dbl((double(j) + 0.5)*width, 18, 8)
+                << Dbl(double(counts[j])*norm, 18, 8) << "\n";
+         }
+      }
+
+      /**
+      * Get a pointer to the array of all counts (e.g., for MPI reduction).
+      */
+      long* data()
+      {  return &counts_[0]; }
+
+      /**
+      * Get total number of counts, nDirection*nAtomType*nBin.
+      */
+      int size() const
+      {  return counts_.capacity(); }
+
+      /**
+      * Serialize to/from an archive (coefficients are not stored).
+      *
+      * \param ar      archive
+      * \param version archive version id
+      */
+      template <class Archive>
+      void serialize(Archive& ar, const unsigned int version)
+      {
+         ar & nDirection_;
+         ar & nAtomType_;
+         ar & nBin_;
+         if (ar.is_loading() && !coefficients_.isAllocated()) {
+            coefficients_.allocate(nDirection_);
+         }
+         ar & counts_;
+      }
+
+   private:
+
+      /// Counts, element (i + typeId*nDirection)*nBin + bin.
+      DArray<long> counts_;
+
+      /// Coefficient vector for each direction.
+      DArray<Vector> coefficients_;
+
+      /// Number of directions.
+      int nDirection_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Number of bins per histogram.
+      int nBin_;
+
+   };
+
+}
+#endif
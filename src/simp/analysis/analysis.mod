@@ -0,0 +1,10 @@
+namespace Simp {
+
+   /**
+   * \defgroup Simp_Analysis_Module Analysis
+   * \ingroup Simp_Module
+   *
+   * Accumulators shared by analyzers of all programs.
+   */
+
+}
@@ -0,0 +1,186 @@
+#ifndef SIMP_COMMAND_LOOP_H
+#define SIMP_COMMAND_LOOP_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * A loop over values of a variable in a command script.
+   *
+   * A command file may contain a block of the form
+   * \code
+   * LOOP             T  1.0  1.2  1.4
+   * SET_TEMPERATURE  $T
+   * SIMULATE         100000
+   * WRITE_CONFIG     config.$T
+   * END_LOOP
+   * \endcode
+   * The commands of the body are executed once for each value, in the
+   * order given, with every occurrence of $T replaced by the value. The
+   * simulation continues from the configuration in memory, so a sweep of
+   * a parameter does not require a restart or any file input. Loops may
+   * be nested, with different variable names.
+   *
+   * Usage, after reading the command name LOOP from a command line:
+   * \code
+   * CommandLoop loop;
+   * loop.readHeader(lineStream);
+   * while (loop.addLine(nextLine)) { ... read nextLine ... }
+   * for (int i = 0; i < loop.nValue(); ++i) {
+   *    std::stringstream body;
+   *    loop.writeBody(i, body);
+   *    // execute commands in body, up to END_LOOP
+   * }
+   * \endcode
+   *
+   * \ingroup Simp_Commands_Module
+   */
+   class CommandLoop
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      CommandLoop()
+       : depth_(0)
+      {}
+
+      /**
+      * Read variable name and values from the rest of a LOOP line.
+      *
+      * \param in input stream, positioned after the command name
+      */
+      void readHeader(std::istream& in)
+      {
+         std::string rest;
+         std::getline(in, rest);
+         std::istringstream header(rest);
+         header >> name_;
+         if (name_.empty()) {
+            UTIL_THROW("Missing variable name in LOOP command");
+         }
+         std::string value;
+         while (header >> value) {
+            values_.push_back(value);
+         }
+         if (values_.empty()) {
+            UTIL_THROW("No values in LOOP command");
+         }
+      }
+
+      /**
+      * Add a line to the body, or return false at the matching END_LOOP.
+      *
+      * \param line next line of the command file
+      * \return false if line is the END_LOOP of this loop, true otherwise
+      */
+      bool addLine(const std::string& line)
+      {
+         std::istringstream lineStream(line);
+         std::string command;
+         lineStream >> command;
+         if (command == "LOOP") {
+            ++depth_;
+         } else
+         if (command == "END_LOOP") {
+            if (depth_ == 0) {
+               return false;
+            }
+            --depth_;
+         }
+         lines_.push_back(line);
+         return true;
+      }
+
+      /**
+      * Write the body for value i, terminated by an END_LOOP line.
+      *
+      * \param i   index of value, 0 <= i < nValue()
+      * \param out output stream
+      */
+      void writeBody(int i, std::ostream& out) const
+      {
+         const std::string key = "$" + name_;
+         const std::string& value = values_[i];
+         std::string line;
+         std::string::size_type pos, end;
+         for (unsigned int k = 0; k < lines_.size(); ++k) {
+            line = lines_[k];
+            pos = line.find(key);
+            while (pos != std::string::npos) {
+               end = pos + key.size();
+               if (end < line.size() && isNameChar(line[end])) {
+                  pos = line.find(key, end);
+               } else {
+                  line.replace(pos, key.size(), value);
+                  pos = line.find(key, pos + value.size());
+               }
+            }
+            out << line << std::endl;
+         }
+         out << "END_LOOP" << std::endl;
+      }
+
+      /**
+      * Get the variable name.
+      */
+      const std::string& name() const
+      {  return name_; }
+
+      /**
+      * Get the number of values, i.e., of iterations.
+      */
+      int nValue() const
+      {  return values_.size(); }
+
+      /**
+      * Get value i, as given in the command file.
+      *
+      * \param i index of value, 0 <= i < nValue()
+      */
+      const std::string& value(int i) const
+      {  return values_[i]; }
+
+   private:
+
+      /// Name of the loop variable.
+      std::string name_;
+
+      /// Values of the loop variable.
+      std::vector<std::string> values_;
+
+      /// Lines of the body, without the final END_LOOP.
+      std::vector<std::string> lines_;
+
+      /// Depth of nested loops within the body.
+      int depth_;
+
+      /// Can c be part of a variable name?
+      static bool isNameChar(char c)
+      {
+         return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+             || (c >= '0' && c <= '9') || c == '_';
+      }
+
+   };
+
+}
+#endif
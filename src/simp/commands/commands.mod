@@ -0,0 +1,10 @@
+namespace Simp {
+
+   /**
+   * \defgroup Simp_Commands_Module Commands
+   * \ingroup Simp_Module
+   *
+   * Utilities for command scripts.
+   */
+
+}
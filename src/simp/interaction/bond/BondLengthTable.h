@@ -0,0 +1,260 @@
+#ifndef SIMP_BOND_LENGTH_TABLE_H
+#define SIMP_BOND_LENGTH_TABLE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>
+#include <util/random/Random.h>
+#include <util/global.h>
+
+#include <cmath>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Inverse cumulative distribution table for Boltzmann bond lengths.
+   *
+   * A BondLengthTable tabulates the cumulative distribution function of
+   * the bond length l, with probability density proportional to l*l*
+   * exp[-beta*phi(l)] for a bond energy phi(l), and draws lengths from
+   * this distribution by inversion of the table, using one uniform
+   * random number and a binary search. The table is built by build(),
+   * which uses only the energy(rSq, type) function of the interaction,
+   * and so works for any bond interaction class, including composite
+   * bonds for which no exact sampling algorithm is available.
+   *
+   * The range of lengths is found automatically: A coarse geometric
+   * scan locates the region of low energy, and a uniform grid over that
+   * region is then refined to the interval in which the density exceeds
+   * exp(-MaxLogRatio) times its maximum. The density is treated as
+   * constant within each of nGrid bins of this interval, so that the
+   * cumulative distribution is piecewise linear. With the default
+   * nGrid, the bin width of a harmonic bond is about 1/100 of the
+   * standard deviation of its length.
+   *
+   * \ingroup Simp_Interaction_Bond_Module
+   */
+   class BondLengthTable
+   {
+
+   public:
+
+      /// Default number of bins.
+      enum {DefaultNGrid = 2048};
+
+      /**
+      * Constructor.
+      */
+      BondLengthTable()
+       : cdf_(),
+         rMin_(0.0),
+         dr_(0.0),
+         beta_(0.0),
+         nGrid_(0)
+      {}
+
+      /**
+      * Build the table for one bond type at inverse temperature beta.
+      *
+      * \param interaction bond interaction, with energy(rSq, type)
+      * \param type        bond type index
+      * \param beta        inverse temperature
+      * \param nGrid       number of bins
+      */
+      template <class Interaction>
+      void build(const Interaction& interaction, int type, double beta,
+                 int nGrid = DefaultNGrid);
+
+      /**
+      * Mark the table as not built (e.g., after a parameter change).
+      */
+      void clear()
+      {  nGrid_ = 0; }
+
+      /**
+      * Return the bond length for cumulative probability u.
+      *
+      * \param u value in the interval [0, 1]
+      */
+      double length(double u) const
+      {
+         assert(nGrid_ > 0);
+         if (u <= 0.0) return rMin_;
+         if (u >= 1.0) return rMin_ + dr_*nGrid_;
+
+         // Find bin i with cdf_[i] <= u < cdf_[i+1]
+         int lo = 0;
+         int hi = nGrid_;
+         int mid;
+         while (hi - lo > 1) {
+            mid = (lo + hi)/2;
+            if (cdf_[mid] <= u) {
+               lo = mid;
+            } else {
+               hi = mid;
+            }
+         }
+         double x = (u - cdf_[lo])/(cdf_[lo+1] - cdf_[lo]);
+         return rMin_ + dr_*(double(lo) + x);
+      }
+
+      /**
+      * Draw a random bond length from the tabulated distribution.
+      *
+      * \param random random number generator
+      */
+      double draw(Random& random) const
+      {  return length(random.uniform(0.0, 1.0)); }
+
+      /**
+      * Inverse temperature for which the table was built.
+      */
+      double beta() const
+      {  return beta_; }
+
+      /**
+      * Has the table been built?
+      */
+      bool isBuilt() const
+      {  return (nGrid_ > 0); }
+
+      /**
+      * Minimum tabulated length.
+      */
+      double rMin() const
+      {  return rMin_; }
+
+      /**
+      * Maximum tabulated length.
+      */
+      double rMax() const
+      {  return rMin_ + dr_*nGrid_; }
+
+   private:
+
+      /// Cumulative distribution at bin boundaries, nGrid + 1 values.
+      DArray<double> cdf_;
+
+      /// Minimum length.
+      double rMin_;
+
+      /// Bin width.
+      double dr_;
+
+      /// Inverse temperature.
+      double beta_;
+
+      /// Number of bins.
+      int nGrid_;
+
+      /// Largest retained ratio of log densities, ln(pMax/p).
+      static double maxLogRatio()
+      {  return 40.0; }
+
+   };
+
+   /*
+   * Build table of cumulative probabilities.
+   */
+   template <class Interaction>
+   void BondLengthTable::build(const Interaction& interaction, int type,
+                               double beta, int nGrid)
+   {
+      if (beta <= 0.0) {
+         UTIL_THROW("Non-positive beta in BondLengthTable");
+      }
+      if (nGrid < 2) {
+         UTIL_THROW("Too few bins in BondLengthTable");
+      }
+
+      // Coarse geometric scan, until beta*phi exceeds its minimum by
+      // more than maxLogRatio() beyond the minimum
+      const double factor = pow(2.0, 0.25);
+      double r = 1.0E-3;
+      double e, eMin;
+      bool hasMin = false;
+      eMin = beta*interaction.energy(r*r, type);
+      for (;;) {
+         r *= factor;
+         if (r > 1.0E+4) {
+            UTIL_THROW("No bound on bond length in BondLengthTable");
+         }
+         e = beta*interaction.energy(r*r, type);
+         if (e < eMin) {
+            eMin = e;
+         } else {
+            hasMin = true;
+         }
+         if (hasMin && e - eMin > maxLogRatio()) break;
+      }
+
+      // Two passes over uniform grids: The first locates the interval
+      // of non-negligible density in [0, r], the second tabulates it
+      if (cdf_.isAllocated()) {
+         if (cdf_.capacity() != nGrid + 1) {
+            cdf_.deallocate();
+         }
+      }
+      if (!cdf_.isAllocated()) {
+         cdf_.allocate(nGrid + 1);
+      }
+      double lo = 0.0;
+      double hi = r;
+      double dr, rb, logMax;
+      int i, iLo, iHi, pass;
+      for (pass = 0; pass < 2; ++pass) {
+         dr = (hi - lo)/double(nGrid);
+
+         // Log densities at bin midpoints, stored in cdf_[i+1]
+         logMax = 0.0;
+         for (i = 0; i < nGrid; ++i) {
+            rb = lo + (double(i) + 0.5)*dr;
+            e = 2.0*log(rb) - beta*interaction.energy(rb*rb, type);
+            cdf_[i+1] = e;
+            if (i == 0 || e > logMax) logMax = e;
+         }
+
+         if (pass == 0) {
+            // Find bins with non-negligible density, plus one bin margin
+            iLo = nGrid - 1;
+            iHi = 0;
+            for (i = 0; i < nGrid; ++i) {
+               if (cdf_[i+1] > logMax - maxLogRatio()) {
+                  if (i < iLo) iLo = i;
+                  if (i > iHi) iHi = i;
+               }
+            }
+            iLo = (iLo > 0) ? iLo - 1 : 0;
+            iHi = (iHi < nGrid - 1) ? iHi + 1 : nGrid - 1;
+            hi = lo + double(iHi + 1)*dr;
+            lo = lo + double(iLo)*dr;
+         } else {
+            // Accumulate normalized cumulative distribution
+            cdf_[0] = 0.0;
+            for (i = 0; i < nGrid; ++i) {
+               cdf_[i+1] = cdf_[i] + exp(cdf_[i+1] - logMax);
+            }
+            double norm = 1.0/cdf_[nGrid];
+            for (i = 1; i < nGrid; ++i) {
+               cdf_[i] *= norm;
+            }
+            cdf_[nGrid] = 1.0;
+         }
+      }
+
+      rMin_ = lo;
+      dr_ = dr;
+      beta_ = beta;
+      nGrid_ = nGrid;
+   }
+
+}
+#endif
@@ -175,7 +175,7 @@ namespace Simp
          x = random->gaussian();
          y = random->gaussian();
          z = random->gaussian();
-         rSq = sqrt(x*x + y*y + z*z)*sigSq;
+         rSq = (x*x + y*y + z*z)*sigSq;
          if (rSq >= r0Sq_[type]) continue;
          eHarm = 0.5*kappa_[type]*rSq;
          eFene = energy(rSq, type);
@@ -27,6 +27,10 @@ namespace Simp
     : epsilon_(0.0),
       alpha_(0.0),
       rSpaceCutoff_(0.0),
+      energyTable_(),
+      forceTable_(),
+      dRInv_(0.0),
+      nTable_(0),
       isInitialized_(false)
    { setClassName("EwaldInteraction");}
    
@@ -41,8 +45,16 @@ namespace Simp
       ce_(other.ce_),
       cf_(other.cf_),
       cg_(other.cg_),
+      energyTable_(),
+      forceTable_(),
+      dRInv_(other.dRInv_),
+      nTable_(other.nTable_),
       isInitialized_(other.isInitialized_)
-   {}
+   {
+      if (isInitialized_) {
+         makeTables();
+      }
+   }
    
    /* 
    * Assignment operator.
@@ -56,18 +68,27 @@ namespace Simp
       ce_ = other.ce_;
       cf_ = other.cf_;
       cg_ = other.cg_;
+      nTable_ = other.nTable_;
       isInitialized_ = other.isInitialized_;
+      if (isInitialized_) {
+         makeTables();
+      }
       return *this;
    }
 
    /* 
-   * Read parameters (epsilon, alpha, rSpaceCutoff) from file.
+   * Read parameters (epsilon, alpha, rSpaceCutoff, [nTable]) from file.
    */
    void EwaldInteraction::readParameters(std::istream &in) 
    {
       read<double>(in, "epsilon",      epsilon_);
       read<double>(in, "alpha",        alpha_);
       read<double>(in, "rSpaceCutoff", rSpaceCutoff_);
+      nTable_ = 0;
+      readOptional<int>(in, "nTable", nTable_);
+      if (nTable_ < 0) {
+         UTIL_THROW("nTable < 0");
+      }
       setDerivedConstants();
       isInitialized_ = true;
    }
@@ -81,6 +102,11 @@ namespace Simp
       loadParameter<double>(ar, "epsilon", epsilon_);
       loadParameter<double>(ar, "alpha", alpha_);
       loadParameter<double>(ar, "rSpaceCutoff", rSpaceCutoff_);
+      nTable_ = 0;
+      loadParameter<int>(ar, "nTable", nTable_, false);
+      if (nTable_ < 0) {
+         UTIL_THROW("nTable < 0");
+      }
       setDerivedConstants();
       isInitialized_ = true;
    }
@@ -93,6 +119,7 @@ namespace Simp
       ar << epsilon_;
       ar << alpha_;
       ar << rSpaceCutoff_;
+      Parameter::saveOptional(ar, nTable_, (nTable_ > 0));
    }
 
    /*
@@ -141,6 +168,63 @@ namespace Simp
       ce_ = 1.0/(4.0*pi*epsilon_); 
       cf_ = 2.0*alpha_/sqrt(pi);
       cg_ = -0.25/(alpha_*alpha_);
+      makeTables();
+   }
+
+   /*
+   * Build cubic Hermite interpolation tables for erfc(alpha r) and for
+   * f(r) = erfc(alpha r) + cf r exp(-alpha^2 r^2), using exact values and
+   * derivatives at the ends of each interval.
+   */
+   void EwaldInteraction::makeTables()
+   {
+      if (nTable_ <= 0) {
+         return;
+      }
+      if (energyTable_.isAllocated()) {
+         if (energyTable_.capacity() != 4*nTable_) {
+            energyTable_.deallocate();
+            forceTable_.deallocate();
+         }
+      }
+      if (!energyTable_.isAllocated()) {
+         energyTable_.allocate(4*nTable_);
+         forceTable_.allocate(4*nTable_);
+      }
+      double dr = rSpaceCutoff_/double(nTable_);
+      dRInv_ = 1.0/dr;
+      double a2 = alpha_*alpha_;
+      double r, x, g, e0, e1, de0, de1, f0, f1, df0, df1;
+      int i;
+
+      // Values and derivatives (times dr) at r = 0
+      e0 = 1.0;
+      de0 = -cf_*dr;
+      f0 = 1.0;
+      df0 = 0.0;
+      for (i = 0; i < nTable_; ++i) {
+         r = dr*double(i + 1);
+         x = alpha_*r;
+         g = exp(-x*x);
+         e1 = erfc(x);
+         de1 = -cf_*g*dr;
+         f1 = e1 + cf_*r*g;
+         df1 = -2.0*a2*cf_*r*r*g*dr;
+
+         energyTable_[4*i] = e0;
+         energyTable_[4*i+1] = de0;
+         energyTable_[4*i+2] = 3.0*(e1 - e0) - 2.0*de0 - de1;
+         energyTable_[4*i+3] = 2.0*(e0 - e1) + de0 + de1;
+         forceTable_[4*i] = f0;
+         forceTable_[4*i+1] = df0;
+         forceTable_[4*i+2] = 3.0*(f1 - f0) - 2.0*df0 - df1;
+         forceTable_[4*i+3] = 2.0*(f0 - f1) + df0 + df1;
+
+         e0 = e1;
+         de0 = de1;
+         f0 = f1;
+         df0 = df1;
+      }
    }
  
 } 
@@ -9,6 +9,7 @@
 */
 
 #include <util/param/ParamComposite.h>
+#include <util/containers/DArray.h>
 #include <util/global.h>
 
 #include <math.h>
@@ -27,6 +28,12 @@ namespace Simp
    * smeared k-space potential for square wavenumber kSq is given by
    * V(k) = exp(-kSq/(4*alpha^2))/(epsilon kSq).
    *
+   * If the optional parameter nTable is positive, the functions
+   * erfc(alpha r) and erfc(alpha r) + 2 alpha r exp(-alpha^2 r^2)/sqrt(pi)
+   * that appear in the r-space energy and force are evaluated by cubic
+   * Hermite interpolation from tables of nTable uniform intervals of r
+   * over [0, rSpaceCutoff], rather than by calls to erfc and exp.
+   *
    * \ingroup Simp_Coulomb_Module
    */
    class EwaldInteraction : public ParamComposite
@@ -62,7 +69,7 @@ namespace Simp
       //@{ 
 
       /**
-      * Read epsilon, alpha, and rCutoff.
+      * Read epsilon, alpha, rSpaceCutoff and optional nTable.
       *
       * \param in  input parameter stream 
       */
@@ -127,6 +134,22 @@ namespace Simp
       * \return force magnitude divided by distance 
       */
       double rSpaceForceOverR(double rSq, double qProduct) const;
+
+      /**
+      * Compute r-space energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = rSpaceEnergy(rSq, qProduct) and
+      * fOverR = rSpaceForceOverR(rSq, qProduct), but shares the square
+      * root and the evaluation of erfc. The precondition of
+      * rSpaceForceOverR applies.
+      *
+      * \param rSq  square of distance between atoms
+      * \param qProduct  product of charges
+      * \param energy  short range pair energy (output)
+      * \param fOverR  force divided by distance (output)
+      */
+      void rSpaceEvaluate(double rSq, double qProduct,
+                          double& energy, double& fOverR) const;
   
       /**
       * Return regularized Fourier-space potential.
@@ -164,6 +187,11 @@ namespace Simp
       */
       double rSpaceCutoffSq() const;
 
+      /**
+      * Get number of intervals in r-space tables (0 if not tabulated).
+      */
+      int nTable() const;
+
       /**
       * Get a parameter value, identified by a string.
       *
@@ -190,6 +218,18 @@ namespace Simp
       double cf_;
       double cg_;
 
+      /// Cubic coefficients of erfc(alpha r), 4 per interval of r.
+      DArray<double> energyTable_;
+
+      /// Cubic coefficients of r^3 force/r divided by ce_, 4 per interval.
+      DArray<double> forceTable_;
+
+      /// Inverse of table interval width in r.
+      double dRInv_;
+
+      /// Number of table intervals (0 if r-space functions are exact).
+      int nTable_;
+
       /**
       * Was this object initialized by calling (read|load)Parameters ?
       */
@@ -198,6 +238,19 @@ namespace Simp
       /// Compute and set values of all derived constants
       void setDerivedConstants();
 
+      /**
+      * Build tables of interpolation coefficients (if nTable_ > 0).
+      */
+      void makeTables();
+
+      /**
+      * Evaluate a tabulated function by cubic interpolation.
+      *
+      * \param table array of coefficients, 4 per interval
+      * \param r  distance, 0 <= r <= rSpaceCutoff
+      */
+      double interpolate(const DArray<double>& table, double r) const;
+
    };
 
    // Inline methods 
@@ -228,6 +281,30 @@ namespace Simp
    double EwaldInteraction::rSpaceCutoffSq() const
    {  return rSpaceCutoffSq_; }
 
+   /*
+   * Return number of table intervals.
+   */
+   inline int EwaldInteraction::nTable() const
+   {  return nTable_; }
+
+   /*
+   * Interpolate a tabulated function of r (private).
+   */
+   inline
+   double
+   EwaldInteraction::interpolate(const DArray<double>& table, double r)
+   const
+   {
+      double x = r*dRInv_;
+      int i = int(x);
+      if (i >= nTable_) {
+         i = nTable_ - 1;
+      }
+      x -= double(i);
+      const double* c = &table[4*i];
+      return c[0] + x*(c[1] + x*(c[2] + x*c[3]));
+   }
+
    /* 
    * Compute and return r-space energy for a pair of charges.
    */
@@ -236,6 +313,9 @@ namespace Simp
    const 
    {
       double r = sqrt(rSq);
+      if (nTable_ > 0) {
+         return ce_*qProduct*interpolate(energyTable_, r)/r;
+      }
       return ce_*qProduct*erfc(alpha_*r)/r;
    }
 
@@ -247,10 +327,34 @@ namespace Simp
    const 
    {
       double r = sqrt(rSq);
+      if (nTable_ > 0) {
+         return ce_*qProduct*interpolate(forceTable_, r)/(r*rSq);
+      }
       double x = alpha_*r;
       return ce_*qProduct*(erfc(x) + cf_*r*exp(-x*x))/(r*rSq); 
    }
 
+   /*
+   * Compute r-space energy and force / distance for a pair of charges.
+   */
+   inline
+   void EwaldInteraction::rSpaceEvaluate(double rSq, double qProduct,
+                                         double& energy, double& fOverR)
+   const
+   {
+      double r = sqrt(rSq);
+      double c = ce_*qProduct/r;
+      if (nTable_ > 0) {
+         energy = c*interpolate(energyTable_, r);
+         fOverR = c*interpolate(forceTable_, r)/rSq;
+      } else {
+         double x = alpha_*r;
+         double e = erfc(x);
+         energy = c*e;
+         fOverR = c*(e + cf_*r*exp(-x*x))/rSq;
+      }
+   }
+
    /* 
    * Calculate k-space potential from squared wavenumber kSq.
    */
@@ -133,6 +133,20 @@ namespace Simp
       * \param force     force on the atom (on output)
       */
       void getForce(const Vector& position, int type, Vector& force) const;
+
+      /**
+      * Compute external energy and force for a single atom.
+      *
+      * Equivalent to calling energy() and getForce(), but evaluates
+      * each transcendental function only once.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param energy    external energy of the atom (on output)
+      * \param force     force on the atom (on output)
+      */
+      void evaluate(const Vector& position, int type, 
+                    double& energy, Vector& force) const;
  
       /**
       * Return name string "GeneralPeriodicExternal".
@@ -252,6 +266,45 @@ namespace Simp
       deriv *= -1.0*f;
       force = deriv;
    }
+
+   /* 
+   * Calculate external energy and force for a single atom.
+   */
+   inline 
+   void GeneralPeriodicExternal::evaluate(const Vector& position, int type, 
+                                          double& energy, Vector& force) const
+   {
+      const Vector cellLengths = boundaryPtr_->lengths();
+      double clipParameter = 1.0/(2.0*M_PI*periodicity_*interfaceWidth_);
+      Vector b;
+      int j;
+      for (j = 0; j < Dimension; ++j) {
+         b[j] = 2.0*M_PI*periodicity_/cellLengths[j];
+      }
+
+      Vector r;
+      Vector q;
+      Vector deriv;
+      deriv.zero();
+      double cosine = 0.0;
+      double arg, prefactor;
+      for (int i = 0; i < nWaveVectors_; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            r[j] = position[j] - shifts_[i*Dimension + j];
+            q[j] = b[j]*waveVectors_[i][j];
+         }
+         arg = q.dot(r) + phases_[i];
+         prefactor = prefactor_[i*nAtomType_ + type];
+         cosine += prefactor*cos(arg);
+         q *= -1.0*prefactor*sin(arg);
+         deriv += q;
+      }
+      cosine *= clipParameter;
+      deriv *= clipParameter;
+      double tanH = tanh(cosine);
+      energy = externalParameter_*tanH;
+      force.multiply(deriv, -1.0*externalParameter_*(1.0 - tanH*tanH));
+   }
  
 }
 #endif
@@ -0,0 +1,533 @@
+#ifndef SIMP_GRID_EXTERNAL_H
+#define SIMP_GRID_EXTERNAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>
+#include <util/boundary/Boundary.h>
+#include <util/containers/DArray.h>
+#include <util/space/Dimension.h>
+#include <util/space/Vector.h>
+#include <util/space/IntVector.h>
+#include <util/global.h>
+
+#include <string>
+#include <cmath>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * External interaction tabulated on a periodic grid.
+   *
+   * This class template wraps any external interaction class, and
+   * replaces its evaluation by trilinear interpolation from a table of
+   * energies and forces of each atom type on a regular grid of points
+   * in scaled (generalized) coordinates, which spans the periodic unit
+   * cell. The underlying interaction must be periodic with the periodic
+   * boundary conditions, as are all external fields used for templating
+   * ordered phases. The table is sampled, using the evaluate() function
+   * of the underlying interaction, the first time it is needed, and is
+   * sampled again whenever the lengths of the Boundary change, or a
+   * parameter is modified by set(). The energy and force of an atom
+   * then cost one grid lookup, independent of the number of terms in
+   * the underlying field.
+   *
+   * Forces are interpolated from tabulated forces, rather than obtained
+   * by differentiating the interpolated energy, and so agree with the
+   * energy only to within the interpolation error. Grid spacings should
+   * thus be small compared to the shortest wavelength of the field.
+   *
+   * Resampling occurs within the first const function call after a
+   * change, and is not thread safe. Energy and force loops of external
+   * potentials are serial.
+   *
+   * In the parameter file, the gridDimensions IntVector is followed by
+   * the parameter block of the underlying interaction, enclosed in
+   * brackets labelled by its class name. Parameter names used in set()
+   * and get() are passed to the underlying interaction.
+   *
+   * \sa \ref simp_interaction_external_GridExternal_page "Parameter file format"
+   *
+   * \ingroup Simp_Interaction_External_Module
+   */
+   template <class Interaction>
+   class GridExternal : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      GridExternal();
+
+      /**
+      * Set nAtomType value.
+      *
+      * \param nAtomType number of atom types.
+      */
+      void setNAtomType(int nAtomType);
+
+      /**
+      * Set pointer to Boundary.
+      *
+      * \param boundary Boundary object
+      */
+      void setBoundary(Boundary &boundary);
+
+      /**
+      * Read gridDimensions and parameters of the underlying interaction.
+      *
+      * \pre nAtomType must have been set, by calling setNAtomType().
+      * \pre Boundary must have been set, by calling setBoundary().
+      *
+      * \param in input stream
+      */
+      void readParameters(std::istream &in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Set a parameter of the underlying interaction, and resample.
+      *
+      * \param name  parameter name
+      * \param value new value of parameter
+      */
+      void set(std::string name, double value);
+
+      /**
+      * Get a parameter value of the underlying interaction.
+      *
+      * \param name  parameter name
+      */
+      double get(std::string name) const;
+
+      /**
+      * Mark the table as invalid, so that it is sampled again.
+      *
+      * Call after modifying the underlying interaction directly.
+      */
+      void invalidate();
+
+      /**
+      * Returns interpolated external energy of a single particle.
+      *
+      * \param position atomic position Vector
+      * \param type     atom type id
+      * \return external potential energy
+      */
+      double energy(const Vector& position, int type) const;
+
+      /**
+      * Returns interpolated external force.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param force     force on the atom (on output)
+      */
+      void getForce(const Vector& position, int type, Vector& force) const;
+
+      /**
+      * Compute interpolated external energy and force for one atom.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param energy    external energy of the atom (on output)
+      * \param force     force on the atom (on output)
+      */
+      void evaluate(const Vector& position, int type,
+                    double& energy, Vector& force) const;
+
+      /**
+      * Get the number of grid points along each axis.
+      */
+      const IntVector& gridDimensions() const;
+
+      /**
+      * Return name string "GridExternal<className>".
+      */
+      std::string className() const;
+
+      /**
+      * Get the underlying interaction by reference.
+      */
+      Interaction& interaction();
+
+      /**
+      * Get the underlying interaction by const reference.
+      */
+      const Interaction& interaction() const;
+
+   private:
+
+      /// Number of values per grid point and type (energy, force).
+      static const int NValue = Dimension + 1;
+
+      /// Underlying interaction.
+      Interaction interaction_;
+
+      /// Energy and force at each grid point, for each atom type.
+      mutable DArray<double> grid_;
+
+      /// Boundary lengths at which grid_ was sampled.
+      mutable Vector lengths_;
+
+      /// Number of grid points along each axis.
+      IntVector gridDimensions_;
+
+      /// Pointer to associated Boundary object.
+      Boundary* boundaryPtr_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Does grid_ hold values for the current parameters?
+      mutable bool isSampled_;
+
+      /**
+      * Check gridDimensions and allocate the table.
+      */
+      void allocate();
+
+      /**
+      * Sample energy and force of the underlying interaction.
+      */
+      void sample() const;
+
+      /**
+      * Interpolate energy and force components, resampling if needed.
+      *
+      * \param position atom position
+      * \param type     atom type id
+      * \param values   energy, then force components (output)
+      */
+      void interpolate(const Vector& position, int type,
+                       double* values) const;
+
+   };
+
+   // Inline methods
+
+   /*
+   * Interpolate energy and force from the grid.
+   */
+   template <class Interaction>
+   inline
+   void GridExternal<Interaction>::interpolate(const Vector& position,
+                                               int type,
+                                               double* values) const
+   {
+      const Vector& lengths = boundaryPtr_->lengths();
+      int d;
+      for (d = 0; d < Dimension; ++d) {
+         if (lengths[d] != lengths_[d]) isSampled_ = false;
+      }
+      if (!isSampled_) {
+         sample();
+      }
+
+      // Lower grid indices and weights along each axis
+      Vector s;
+      boundaryPtr_->transformCartToGen(position, s);
+      int lower[Dimension];
+      int upper[Dimension];
+      double weight[Dimension];
+      double u;
+      int n;
+      for (d = 0; d < Dimension; ++d) {
+         n = gridDimensions_[d];
+         u = (s[d] - floor(s[d]))*n;
+         lower[d] = int(u);
+         if (lower[d] >= n) lower[d] = n - 1;
+         weight[d] = u - lower[d];
+         upper[d] = (lower[d] + 1 == n) ? 0 : lower[d] + 1;
+      }
+
+      // Sum contributions of the 8 corners of the grid cell
+      const int n1 = gridDimensions_[1];
+      const int n2 = gridDimensions_[2];
+      const int begin = type*gridDimensions_[0];
+      const double* p;
+      double w0, w01, w;
+      int i0, i1, i2, a, b, c, k;
+      for (k = 0; k < NValue; ++k) {
+         values[k] = 0.0;
+      }
+      for (a = 0; a < 2; ++a) {
+         i0 = a ? upper[0] : lower[0];
+         w0 = a ? weight[0] : 1.0 - weight[0];
+         for (b = 0; b < 2; ++b) {
+            i1 = b ? upper[1] : lower[1];
+            w01 = w0*(b ? weight[1] : 1.0 - weight[1]);
+            for (c = 0; c < 2; ++c) {
+               i2 = c ? upper[2] : lower[2];
+               w = w01*(c ? weight[2] : 1.0 - weight[2]);
+               p = &grid_[NValue*(((begin + i0)*n1 + i1)*n2 + i2)];
+               for (k = 0; k < NValue; ++k) {
+                  values[k] += w*p[k];
+               }
+            }
+         }
+      }
+   }
+
+   /*
+   * Return interpolated external energy.
+   */
+   template <class Interaction>
+   inline
+   double GridExternal<Interaction>::energy(const Vector& position,
+                                            int type) const
+   {
+      double values[NValue];
+      interpolate(position, type, values);
+      return values[0];
+   }
+
+   /*
+   * Get interpolated external force.
+   */
+   template <class Interaction>
+   inline
+   void GridExternal<Interaction>::getForce(const Vector& position, int type,
+                                            Vector& force) const
+   {
+      double values[NValue];
+      interpolate(position, type, values);
+      for (int d = 0; d < Dimension; ++d) {
+         force[d] = values[d + 1];
+      }
+   }
+
+   /*
+   * Compute interpolated external energy and force.
+   */
+   template <class Interaction>
+   inline
+   void GridExternal<Interaction>::evaluate(const Vector& position, int type,
+                                            double& energy,
+                                            Vector& force) const
+   {
+      double values[NValue];
+      interpolate(position, type, values);
+      energy = values[0];
+      for (int d = 0; d < Dimension; ++d) {
+         force[d] = values[d + 1];
+      }
+   }
+
+   template <class Interaction>
+   inline const IntVector& GridExternal<Interaction>::gridDimensions() const
+   {  return gridDimensions_; }
+
+   template <class Interaction>
+   inline Interaction& GridExternal<Interaction>::interaction()
+   {  return interaction_; }
+
+   template <class Interaction>
+   inline const Interaction& GridExternal<Interaction>::interaction() const
+   {  return interaction_; }
+
+   // Non-inline methods
+
+   /*
+   * Constructor.
+   */
+   template <class Interaction>
+   GridExternal<Interaction>::GridExternal()
+    : interaction_(),
+      grid_(),
+      lengths_(),
+      gridDimensions_(),
+      boundaryPtr_(0),
+      nAtomType_(0),
+      isSampled_(false)
+   {
+      std::string name("GridExternal<");
+      name += interaction_.className();
+      name += ">";
+      setClassName(name.c_str());
+   }
+
+   /*
+   * Set nAtomType of this and the underlying interaction.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::setNAtomType(int nAtomType)
+   {
+      if (nAtomType <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      nAtomType_ = nAtomType;
+      interaction_.setNAtomType(nAtomType);
+   }
+
+   /*
+   * Set pointer to the Boundary of this and the underlying interaction.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::setBoundary(Boundary &boundary)
+   {
+      boundaryPtr_ = &boundary;
+      interaction_.setBoundary(boundary);
+      isSampled_ = false;
+   }
+
+   /*
+   * Check grid dimensions and allocate the table.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::allocate()
+   {
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType must be set before readParam");
+      }
+      int size = NValue*nAtomType_;
+      for (int d = 0; d < Dimension; ++d) {
+         if (gridDimensions_[d] <= 0) {
+            UTIL_THROW("Grid dimensions must be positive");
+         }
+         size *= gridDimensions_[d];
+      }
+      if (grid_.isAllocated()) {
+         grid_.deallocate();
+      }
+      grid_.allocate(size);
+      isSampled_ = false;
+   }
+
+   /*
+   * Read grid dimensions and parameters of the underlying interaction.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::readParameters(std::istream &in)
+   {
+      read<IntVector>(in, "gridDimensions", gridDimensions_);
+      allocate();
+      readParamComposite(in, interaction_);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   template <class Interaction>
+   void
+   GridExternal<Interaction>::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParameter<IntVector>(ar, "gridDimensions", gridDimensions_);
+      allocate();
+      loadParamComposite(ar, interaction_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::save(Serializable::OArchive &ar)
+   {
+      ar << gridDimensions_;
+      interaction_.save(ar);
+   }
+
+   /*
+   * Set a parameter of the underlying interaction.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::set(std::string name, double value)
+   {
+      interaction_.set(name, value);
+      isSampled_ = false;
+   }
+
+   /*
+   * Get a parameter of the underlying interaction.
+   */
+   template <class Interaction>
+   double GridExternal<Interaction>::get(std::string name) const
+   {  return interaction_.get(name); }
+
+   /*
+   * Mark the table as invalid.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::invalidate()
+   {  isSampled_ = false; }
+
+   /*
+   * Sample energy and force of the underlying interaction on the grid.
+   */
+   template <class Interaction>
+   void GridExternal<Interaction>::sample() const
+   {
+      if (!boundaryPtr_) {
+         UTIL_THROW("Boundary must be set before sampling");
+      }
+      if (!grid_.isAllocated()) {
+         UTIL_THROW("Grid is not allocated");
+      }
+      lengths_ = boundaryPtr_->lengths();
+
+      const int n0 = gridDimensions_[0];
+      const int n1 = gridDimensions_[1];
+      const int n2 = gridDimensions_[2];
+      Vector s, r, f;
+      double e;
+      double* p;
+      int t, i, j, k, d;
+      int m = 0;
+      for (t = 0; t < nAtomType_; ++t) {
+         for (i = 0; i < n0; ++i) {
+            s[0] = double(i)/double(n0);
+            for (j = 0; j < n1; ++j) {
+               s[1] = double(j)/double(n1);
+               for (k = 0; k < n2; ++k) {
+                  s[2] = double(k)/double(n2);
+                  boundaryPtr_->transformGenToCart(s, r);
+                  interaction_.evaluate(r, t, e, f);
+                  p = &grid_[m];
+                  p[0] = e;
+                  for (d = 0; d < Dimension; ++d) {
+                     p[d + 1] = f[d];
+                  }
+                  m += NValue;
+               }
+            }
+         }
+      }
+      isSampled_ = true;
+   }
+
+   /*
+   * Return name string "GridExternal<className>".
+   */
+   template <class Interaction>
+   std::string GridExternal<Interaction>::className() const
+   {
+      std::string name("GridExternal<");
+      name += interaction_.className();
+      name += ">";
+      return name;
+   }
+
+}
+#endif
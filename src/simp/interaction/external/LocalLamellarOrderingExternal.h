@@ -144,6 +144,20 @@ namespace Simp
       * \param force     force on the atom (on output)
       */
       void getForce(const Vector& position, int type, Vector& force) const;
+
+      /**
+      * Compute external energy and force for a single atom.
+      *
+      * Equivalent to calling energy() and getForce(), but evaluates
+      * each transcendental function only once.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param energy    external energy of the atom (on output)
+      * \param force     force on the atom (on output)
+      */
+      void evaluate(const Vector& position, int type, 
+                    double& energy, Vector& force) const;
  
       /**
       * Return name string "LocalLamellarOrderingExternal".
@@ -284,6 +298,54 @@ namespace Simp
       }
 
    }
+
+   /* 
+   * Calculate external energy and force for a single atom.
+   */
+   inline 
+   void 
+   LocalLamellarOrderingExternal::evaluate(const Vector& position, int type, 
+                                           double& energy, Vector& force) const
+   {
+      double dPerp, dParallel, perpLength, parallelLength, q, clipParameter;
+      double arg, tanH, sechSq, fLength, factor;
+      double parallelFactor1, parallelFactor2, parallelFactor;
+      double forceParallelSech1, forceParallelSech2;
+      dPerp = position[perpDirection_];
+      dParallel = position[parallelDirection_];
+
+      Vector lengths;
+      lengths = boundaryPtr_->lengths();
+      perpLength = lengths[perpDirection_];
+      parallelLength = lengths[parallelDirection_];
+      fLength = fraction_*parallelLength;
+
+      q = (2.0*M_PI*periodicity_)/perpLength;
+      clipParameter = 1.0/(q*width_*perpLength);
+      arg = q*dPerp;
+      tanH = tanh(clipParameter*cos(arg));
+      sechSq = (1.0 - tanH*tanH);
+      parallelFactor1 = tanh( 2.0*M_PI*((dParallel - (((1.0-fraction_)/2.0)*parallelLength))/fLength) );
+      parallelFactor2 = tanh( 2.0*M_PI*(((((1+fraction_)/2.0)*parallelLength) - dParallel)/fLength) );
+      parallelFactor = 1.0 + (parallelFactor1*parallelFactor2);
+      parallelFactor /= 2.0;
+
+      if (parallelFactor < 0.0) {
+         UTIL_THROW("Negative base factor");
+      }
+
+      factor = prefactor_[type]*externalParameter_;
+      energy = factor*tanH*parallelFactor;
+
+      forceParallelSech1 = (1.0 - (parallelFactor1*parallelFactor1));
+      forceParallelSech1 *= M_PI*parallelFactor2/fLength;
+      forceParallelSech2 = (1.0 - (parallelFactor2*parallelFactor2));
+      forceParallelSech2 *= -1.0*M_PI*parallelFactor1/fLength;
+      force.zero();
+      force[parallelDirection_] = -1.0*factor*tanH;
+      force[parallelDirection_] *= (forceParallelSech1 + forceParallelSech2);
+      force[perpDirection_] = factor*sechSq*clipParameter*sin(arg)*q*parallelFactor;
+   }
  
 }
 #endif
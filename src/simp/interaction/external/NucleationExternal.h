@@ -133,6 +133,20 @@ namespace Simp
       * \param force     force on the atom (on output)
       */
       void getForce(const Vector& position, int type, Vector& force) const;
+
+      /**
+      * Compute external energy and force for a single atom.
+      *
+      * Equivalent to calling energy() and getForce(), but evaluates
+      * each transcendental function only once.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param energy    external energy of the atom (on output)
+      * \param force     force on the atom (on output)
+      */
+      void evaluate(const Vector& position, int type, 
+                    double& energy, Vector& force) const;
  
       /**
       * Return name string "NucleationExternal".
@@ -279,6 +293,57 @@ namespace Simp
                             (tanh(nucleationClip_*(-bias_+cos(2.0*M_PI*position[1]/cellLengths[1]+acos(bias_))))+1)/2;
       force = deriv;
    }
+
+   /* 
+   * Calculate external energy and force for a single atom.
+   */
+   inline 
+   void NucleationExternal::evaluate(const Vector& position, int type, 
+                                     double& energy, Vector& force) const
+   {
+      const Vector cellLengths = boundaryPtr_->lengths();
+      double clipParameter = 1.0/(2.0*M_PI*periodicity_*interfaceWidth_);
+      double phase = acos(bias_);
+      Vector b, g, h;
+      double arg, coshArg;
+      int j;
+
+      // Nucleation envelope factors g and their derivative terms h
+      for (j = 0; j < Dimension; ++j) {
+         b[j] = 2.0*M_PI*periodicity_/cellLengths[j];
+         arg = 2.0*M_PI*position[j]/cellLengths[j] + phase;
+         g[j] = (tanh(nucleationClip_*(-bias_ + cos(arg))) + 1)/2;
+         coshArg = cosh(arg);
+         h[j] = nucleationClip_*(M_PI/cellLengths[j]*sin(arg))
+                /(coshArg*coshArg);
+      }
+      double ne = g[0]*g[1]*g[2];
+
+      Vector r = position;
+      r -= shift_;
+      double cosine = 0.0;
+      Vector deriv;
+      deriv.zero();
+      Vector q;
+      for (int i = 0; i < nWaveVectors_; ++i) {
+         q[0] = b[0]*waveVectors_[i][0];
+         q[1] = b[1]*waveVectors_[i][1];
+         q[2] = b[2]*waveVectors_[i][2];
+         arg = q.dot(r) + phases_[i];
+         cosine += cos(arg);
+         q *= -1.0*sin(arg);
+         deriv += q;
+      }
+      cosine *= clipParameter;
+      deriv *= clipParameter;
+      double tanH = tanh(C_ + cosine);
+      double factor = prefactor_[type]*externalParameter_;
+      energy = factor*tanH*ne;
+      force.multiply(deriv, -1.0*factor*(1.0 - tanH*tanH)*ne);
+      force[0] += h[0]*g[1]*g[2];
+      force[1] += h[1]*g[0]*g[2];
+      force[2] += h[2]*g[0]*g[1];
+   }
  
 }
 #endif
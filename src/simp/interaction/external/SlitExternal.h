@@ -170,6 +170,20 @@ namespace Simp
       * \param force     force on the atom (on output)
       */
       void getForce(const Vector& position, int type, Vector& force) const;
+
+      /**
+      * Compute external energy and force for a single atom.
+      *
+      * Equivalent to calling energy() and getForce(), but may be
+      * used by potentials to obtain both in one pass over atoms.
+      *
+      * \param position  atom position
+      * \param type      atom type id
+      * \param energy    external energy of the atom (on output)
+      * \param force     force on the atom (on output)
+      */
+      void evaluate(const Vector& position, int type, 
+                    double& energy, Vector& force) const;
  
       //@}
 
@@ -270,6 +284,17 @@ namespace Simp
          force = Vector(0.0, 0.0, scalarf);
       }
    }
+
+   /* 
+   * Calculate external energy and force for a single atom.
+   */
+   inline 
+   void SlitExternal::evaluate(const Vector& position, int type, 
+                               double& energy, Vector& force) const
+   {
+      energy = this->energy(position, type);
+      getForce(position, type, force);
+   }
  
 }
 #endif
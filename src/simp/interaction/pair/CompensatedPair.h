@@ -101,6 +101,22 @@ namespace Simp
       * \return  force divided by distance 
       */
       double forceOverR(double rsq, int i, int j) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = energy(rsq, i, j) and fOverR =
+      * forceOverR(rsq, i, j), but evaluates the link Boltzmann factor
+      * only once.
+      *
+      * \param rsq    square of distance between particles
+      * \param i      type of particle 1
+      * \param j      type of particle 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j, 
+                    double& energy, double& fOverR) const;
    
       /**
       * Get cutoff for pair potential, for a particular type pair.
@@ -315,6 +331,27 @@ namespace Simp
         return total;
    }
 
+   /* 
+   * Calculate energy and force/distance for a pair.
+   */
+   template <class BarePair, class LinkPotential>
+   inline void 
+   CompensatedPair<BarePair, LinkPotential>::evaluate(double rsq, int i, int j,
+                                                      double& energy, 
+                                                      double& fOverR) const
+   {
+        energy = 0.0;
+        fOverR = 0.0;
+        if (rsq < pair_.cutoffSq(i, j)) {
+           pair_.evaluate(rsq, i, j, energy, fOverR);
+        }
+        if (rsq < maxLinkLengthSq_) {
+           double boltz = activity_ * exp(-beta_ * link_.energy(rsq, 0));
+           energy += temp_ * boltz;
+           fOverR -= boltz * link_.forceOverR(rsq, 0);
+        }
+   }
+
    /*
    * Get square of maximum pair cutoff distance.
    */
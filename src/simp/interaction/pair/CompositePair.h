@@ -0,0 +1,421 @@
+#ifndef SIMP_COMPOSITE_PAIR_H
+#define SIMP_COMPOSITE_PAIR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>
+#include <util/global.h>
+
+#include <string>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Sum of two pair interactions, evaluated in a single pass.
+   *
+   * This class template creates a pair interaction that is the sum of
+   * a PairA and a PairB pair interaction, each of which must satisfy
+   * the standard pair interaction interface. Because the sum is itself
+   * a pair interaction, a single pair potential (e.g., a PairPotentialImpl
+   * or MdPairPotentialImpl) may evaluate both components in one loop
+   * over a pair list, rather than using two separate potentials. More
+   * than two components may be combined by nesting, e.g., as in
+   * CompositePair<A, CompositePair<B, C> >.
+   *
+   * The cutoff for each type pair is the larger of the two component
+   * cutoffs. Each component contributes to the energy and force only
+   * within its own cutoff.
+   *
+   * In the parameter file, the parameter blocks of the two components
+   * appear in order, each enclosed in brackets labelled by the class
+   * name of the component. Parameter names used in set() and get()
+   * have the form "className.name", e.g., "LJPair.epsilon".
+   *
+   * \sa \ref simp_interaction_pair_CompositePair_page "Parameter file format"
+   * \sa \ref simp_interaction_pair_interface_page
+   *
+   * \ingroup Simp_Interaction_Pair_Module
+   */
+   template <class PairA, class PairB>
+   class CompositePair : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      CompositePair();
+
+      /// \name Mutators
+      //@{
+
+      /**
+      * Set nAtomType value for both components.
+      *
+      * \param nAtomType number of atom types.
+      */
+      void setNAtomType(int nAtomType);
+
+      /**
+      * Read parameter blocks of both components.
+      *
+      * \pre nAtomType must be set, by calling setNAtomType().
+      *
+      * \param in  input stream
+      */
+      void readParameters(std::istream &in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Modify a parameter of one component, identified by a string.
+      *
+      * \param name  "className.name", with className of a component
+      * \param i     atom type index 1
+      * \param j     atom type index 2
+      * \param value new value of parameter
+      */
+      void set(std::string name, int i, int j, double value);
+
+      //@}
+      /// \name Accessors
+      //@{
+
+      /**
+      * Returns interaction energy for a single pair of particles.
+      *
+      * \param rsq square of distance between particles
+      * \param i   type of particle 1
+      * \param j   type of particle 2
+      * \return    pair interaction energy
+      */
+      double energy(double rsq, int i, int j) const;
+
+      /**
+      * Returns ratio of scalar pair interaction force to pair separation.
+      *
+      * Precondition: rsq must be less than cutoffSq(i, j).
+      *
+      * \param rsq square of distance between particles
+      * \param i type of particle 1
+      * \param j type of particle 2
+      * \return  force divided by distance
+      */
+      double forceOverR(double rsq, int i, int j) const;
+
+      /**
+      * Compute force/distance ratios for a block of pairs.
+      *
+      * Equivalent to setting fOverR[k] = forceOverR(rsq[k], i[k], j[k])
+      * for all 0 <= k < n. Every element must satisfy the precondition
+      * rsq[k] < cutoffSq(i[k], j[k]).
+      *
+      * \param n      number of pairs in block
+      * \param rsq    array of squared separations
+      * \param i      array of types of particle 1
+      * \param j      array of types of particle 2
+      * \param fOverR array of force divided by distance (output)
+      */
+      void forceOverR(int n, const double* rsq, const int* i, const int* j,
+                      double* fOverR) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Precondition: rsq must be less than cutoffSq(i, j).
+      *
+      * \param rsq    square of distance between particles
+      * \param i      type of particle 1
+      * \param j      type of particle 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j,
+                    double& energy, double& fOverR) const;
+
+      /**
+      * Get square of cutoff distance for specific type pair.
+      *
+      * \param i   type of particle 1
+      * \param j   type of particle 2
+      * \return    larger of the component values of cutoffSq(i, j)
+      */
+      double cutoffSq(int i, int j) const;
+
+      /**
+      * Get maximum of pair cutoff distance, for all atom type pairs.
+      */
+      double maxPairCutoff() const;
+
+      /**
+      * Get a parameter value of one component, identified by a string.
+      *
+      * \param name   "className.name", with className of a component
+      * \param i      atom type index 1
+      * \param j      atom type index 2
+      */
+      double get(std::string name, int i, int j) const;
+
+      /**
+      * Get the first component.
+      */
+      const PairA& pairA() const
+      {  return pairA_; }
+
+      /**
+      * Get the second component.
+      */
+      const PairB& pairB() const
+      {  return pairB_; }
+
+      //@}
+
+   private:
+
+      /// First pair interaction.
+      PairA pairA_;
+
+      /// Second pair interaction.
+      PairB pairB_;
+
+      /**
+      * Split "className.name" into component index and parameter name.
+      *
+      * \param name   full parameter name
+      * \param param  name of parameter within component (output)
+      * \return 0 for pairA, 1 for pairB
+      */
+      int component(const std::string& name, std::string& param) const;
+
+      /**
+      * Copy constructor (private and not implemented).
+      */
+      CompositePair(const CompositePair<PairA, PairB>& other);
+
+   };
+
+   // Inline methods
+
+   /*
+   * Calculate interaction energy for a pair.
+   */
+   template <class PairA, class PairB>
+   inline double
+   CompositePair<PairA, PairB>::energy(double rsq, int i, int j) const
+   {  return pairA_.energy(rsq, i, j) + pairB_.energy(rsq, i, j); }
+
+   /*
+   * Calculate force/distance for a pair inside the composite cutoff.
+   */
+   template <class PairA, class PairB>
+   inline double
+   CompositePair<PairA, PairB>::forceOverR(double rsq, int i, int j) const
+   {
+      double total = 0.0;
+      if (rsq < pairA_.cutoffSq(i, j)) {
+         total += pairA_.forceOverR(rsq, i, j);
+      }
+      if (rsq < pairB_.cutoffSq(i, j)) {
+         total += pairB_.forceOverR(rsq, i, j);
+      }
+      return total;
+   }
+
+   /*
+   * Calculate force/distance for a block of pairs.
+   */
+   template <class PairA, class PairB>
+   inline void
+   CompositePair<PairA, PairB>::forceOverR(int n, const double* rsq,
+                                           const int* i, const int* j,
+                                           double* fOverR) const
+   {
+      for (int k = 0; k < n; ++k) {
+         fOverR[k] = forceOverR(rsq[k], i[k], j[k]);
+      }
+   }
+
+   /*
+   * Calculate energy and force/distance for a pair.
+   */
+   template <class PairA, class PairB>
+   inline void
+   CompositePair<PairA, PairB>::evaluate(double rsq, int i, int j,
+                                         double& energy,
+                                         double& fOverR) const
+   {
+      double e, f;
+      energy = 0.0;
+      fOverR = 0.0;
+      if (rsq < pairA_.cutoffSq(i, j)) {
+         pairA_.evaluate(rsq, i, j, e, f);
+         energy += e;
+         fOverR += f;
+      }
+      if (rsq < pairB_.cutoffSq(i, j)) {
+         pairB_.evaluate(rsq, i, j, e, f);
+         energy += e;
+         fOverR += f;
+      }
+   }
+
+   /*
+   * Return square of composite cutoff for a type pair.
+   */
+   template <class PairA, class PairB>
+   inline
+   double CompositePair<PairA, PairB>::cutoffSq(int i, int j) const
+   {
+      double a = pairA_.cutoffSq(i, j);
+      double b = pairB_.cutoffSq(i, j);
+      return (a > b) ? a : b;
+   }
+
+   // Non-inline methods
+
+   /*
+   * Constructor.
+   */
+   template <class PairA, class PairB>
+   CompositePair<PairA, PairB>::CompositePair()
+    : pairA_(),
+      pairB_()
+   {
+      std::string name("CompositePair");
+      name += "<";
+      name += pairA_.className();
+      name += ",";
+      name += pairB_.className();
+      name += ">";
+      setClassName(name.c_str());
+   }
+
+   /*
+   * Set nAtomType for both components.
+   */
+   template <class PairA, class PairB>
+   void CompositePair<PairA, PairB>::setNAtomType(int nAtomType)
+   {
+      pairA_.setNAtomType(nAtomType);
+      pairB_.setNAtomType(nAtomType);
+   }
+
+   /*
+   * Read parameters of both components from file.
+   */
+   template <class PairA, class PairB>
+   void CompositePair<PairA, PairB>::readParameters(std::istream &in)
+   {
+      readParamComposite(in, pairA_);
+      readParamComposite(in, pairB_);
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   template <class PairA, class PairB>
+   void
+   CompositePair<PairA, PairB>::loadParameters(Serializable::IArchive &ar)
+   {
+      loadParamComposite(ar, pairA_);
+      loadParamComposite(ar, pairB_);
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   template <class PairA, class PairB>
+   void CompositePair<PairA, PairB>::save(Serializable::OArchive &ar)
+   {
+      pairA_.save(ar);
+      pairB_.save(ar);
+   }
+
+   /*
+   * Get maximum pair cutoff of both components.
+   */
+   template <class PairA, class PairB>
+   double CompositePair<PairA, PairB>::maxPairCutoff() const
+   {
+      double a = pairA_.maxPairCutoff();
+      double b = pairB_.maxPairCutoff();
+      return (a > b) ? a : b;
+   }
+
+   /*
+   * Identify the component and parameter named by "className.name".
+   */
+   template <class PairA, class PairB>
+   int CompositePair<PairA, PairB>::component(const std::string& name,
+                                              std::string& param) const
+   {
+      std::string::size_type pos = name.find('.');
+      if (pos == std::string::npos) {
+         UTIL_THROW("CompositePair parameter name must be className.name");
+      }
+      std::string prefix = name.substr(0, pos);
+      param = name.substr(pos + 1);
+      if (prefix == pairA_.className()) {
+         return 0;
+      } else
+      if (prefix == pairB_.className()) {
+         return 1;
+      } else {
+         UTIL_THROW("Unrecognized component class name");
+      }
+      return 0;
+   }
+
+   /*
+   * Modify a parameter of one component.
+   */
+   template <class PairA, class PairB>
+   void CompositePair<PairA, PairB>
+        ::set(std::string name, int i, int j, double value)
+   {
+      std::string param;
+      if (component(name, param) == 0) {
+         pairA_.set(param, i, j, value);
+      } else {
+         pairB_.set(param, i, j, value);
+      }
+   }
+
+   /*
+   * Get a parameter value of one component.
+   */
+   template <class PairA, class PairB>
+   double CompositePair<PairA, PairB>
+          ::get(std::string name, int i, int j) const
+   {
+      std::string param;
+      if (component(name, param) == 0) {
+         return pairA_.get(param, i, j);
+      } else {
+         return pairB_.get(param, i, j);
+      }
+   }
+
+}
+#endif
@@ -29,20 +29,12 @@ namespace Simp
    * Copy constructor.
    */
    DpdPair::DpdPair(const DpdPair& other)
-    : maxPairCutoff_(other.maxPairCutoff_),
-      nAtomType_(other.nAtomType_),
-      isInitialized_(other.isInitialized_)
-   {
-      int i,j;
-      for (i = 0; i < nAtomType_; ++i) {
-         for (j = 0; j < nAtomType_; ++j) {
-            epsilon_[i][j] = other.epsilon_[i][j];
-            sigma_[i][j]   = other.sigma_[i][j];
-            sigmaSq_[i][j] = other.sigmaSq_[i][j];
-            ce_[i][j]      = other.ce_[i][j];
-            cf_[i][j]      = other.cf_[i][j];
-         } 
-      }
+    : maxPairCutoff_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  
+      setClassName("DpdPair"); 
+      *this = other;
    }
    
    /* 
@@ -50,21 +42,57 @@ namespace Simp
    */
    DpdPair& DpdPair::operator = (const DpdPair& other)
    {
+      if (this == &other) return *this;
+      if (epsilon_.isAllocated() && nAtomType_ != other.nAtomType_) {
+         deallocate();
+      }
       maxPairCutoff_ = other.maxPairCutoff_;
       nAtomType_     = other.nAtomType_;
       isInitialized_ = other.isInitialized_;
-      int i,j;
-      for (i = 0; i < nAtomType_; ++i) {
-         for (j = 0; j < nAtomType_; ++j) {
-            epsilon_[i][j] = other.epsilon_[i][j];
-            sigma_[i][j]   = other.sigma_[i][j];
-            sigmaSq_[i][j] = other.sigmaSq_[i][j];
-            ce_[i][j]      = other.ce_[i][j];
-            cf_[i][j]      = other.cf_[i][j];
-         } 
+      if (other.epsilon_.isAllocated()) {
+         allocate();
+         epsilon_ = other.epsilon_;
+         sigma_   = other.sigma_;
+         coeffs_  = other.coeffs_;
       }
       return *this;
    }
+
+   /*
+   * Allocate parameter matrices and coefficient records.
+   */
+   void DpdPair::allocate()
+   {
+      if (!epsilon_.isAllocated()) {
+         epsilon_.allocate(nAtomType_, nAtomType_);
+         sigma_.allocate(nAtomType_, nAtomType_);
+         coeffs_.allocate(nAtomType_);
+      }
+   }
+
+   /*
+   * Free parameter matrices and coefficient records.
+   */
+   void DpdPair::deallocate()
+   {
+      if (epsilon_.isAllocated()) {
+         epsilon_.deallocate();
+         sigma_.deallocate();
+         coeffs_.deallocate();
+      }
+   }
+
+   /*
+   * Compute packed coefficients for one type pair.
+   */
+   void DpdPair::setCoeff(int i, int j)
+   {
+      Coeff& c = coeffs_(i, j);
+      c.sigma   = sigma_(i, j);
+      c.sigmaSq = c.sigma*c.sigma;
+      c.cf      = epsilon_(i, j)/c.sigmaSq;
+      c.ce      = 0.5*c.cf;
+   }
    
    /* 
    * Read potential parameters from file.
@@ -75,24 +103,21 @@ namespace Simp
       if (nAtomType_ <= 0) {
          UTIL_THROW( "nAtomType must be set before readParam");
       }
+      allocate();
    
       // Read parameters
-      readCArray2D<double> (in, "epsilon", epsilon_[0], 
-                            nAtomType_, nAtomType_, MaxAtomType);
-      readCArray2D<double>(in, "sigma", sigma_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
+      readDMatrix<double>(in, "epsilon", epsilon_, nAtomType_, nAtomType_);
+      readDMatrix<double>(in, "sigma", sigma_, nAtomType_, nAtomType_);
    
-      // Calculate sigmaSq_, ce_, cf_, and maxPairCutoff_
+      // Calculate coefficients and maxPairCutoff_
       int i, j;
       maxPairCutoff_ = 0.0;
       for (i = 0; i < nAtomType_; ++i) {
          for (j = 0; j < nAtomType_; ++j) {
-            sigmaSq_[i][j]  = sigma_[i][j]*sigma_[i][j];
-            if (sigma_[i][j] > maxPairCutoff_) {
-               maxPairCutoff_ = sigma_[i][j];
+            setCoeff(i, j);
+            if (sigma_(i, j) > maxPairCutoff_) {
+               maxPairCutoff_ = sigma_(i, j);
             }
-            cf_[i][j] = epsilon_[i][j]/sigmaSq_[i][j];
-            ce_[i][j] = 0.5*cf_[i][j];
          }
       }
   
@@ -108,25 +133,39 @@ namespace Simp
       if (nAtomType_ <= 0) {
          UTIL_THROW( "nAtomType must be set before loadParameters");
       }
+      allocate();
+      const int n = nAtomType_;
 
       // Read parameters
-      loadCArray2D<double> (ar, "epsilon", epsilon_[0], 
-                            nAtomType_, nAtomType_, MaxAtomType);
-      loadCArray2D<double>(ar, "sigma", sigma_[0], 
-                            nAtomType_, nAtomType_, MaxAtomType);
-      
+      loadCArray2D<double>(ar, "epsilon", &epsilon_(0, 0), n, n, n);
+      loadCArray2D<double>(ar, "sigma", &sigma_(0, 0), n, n, n);
+
+      // Skip derived arrays, which are recomputed by setCoeff()
+      DMatrix<double> derived;
+      derived.allocate(n, n);
       #ifdef UTIL_MPI
       MpiLoader<Serializable::IArchive> loader(*this, ar);
-      loader.load(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      loader.load(cf_[0], nAtomType_, nAtomType_, MaxAtomType);
-      loader.load(ce_[0], nAtomType_, nAtomType_, MaxAtomType);
+      for (int k = 0; k < 3; ++k) {
+         loader.load(&derived(0, 0), n, n, n);
+      }
       loader.load(maxPairCutoff_);
       #else
-      ar.unpack(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.unpack(cf_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.unpack(ce_[0], nAtomType_, nAtomType_, MaxAtomType);
+      for (int k = 0; k < 3; ++k) {
+         ar.unpack(&derived(0, 0), n, n, n);
+      }
       ar >> maxPairCutoff_;
       #endif
+
+      int i, j;
+      maxPairCutoff_ = 0.0;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            setCoeff(i, j);
+            if (sigma_(i, j) > maxPairCutoff_) {
+               maxPairCutoff_ = sigma_(i, j);
+            }
+         }
+      }
       isInitialized_ = true;
    }
 
@@ -135,14 +174,31 @@ namespace Simp
    */
    void DpdPair::save(Serializable::OArchive &ar)
    {
-      ar.pack(epsilon_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(sigma_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(cf_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(ce_[0], nAtomType_, nAtomType_, MaxAtomType);
+      const int n = nAtomType_;
+      ar.pack(&epsilon_(0, 0), n, n, n);
+      ar.pack(&sigma_(0, 0), n, n, n);
+      packCoeff(ar, &Coeff::sigmaSq);
+      packCoeff(ar, &Coeff::cf);
+      packCoeff(ar, &Coeff::ce);
       ar << maxPairCutoff_;
    }
 
+   /*
+   * Pack one member of all coefficient records, as an n x n array.
+   */
+   void DpdPair::packCoeff(Serializable::OArchive &ar, double Coeff::* member)
+   {
+      const int n = nAtomType_;
+      DMatrix<double> values;
+      values.allocate(n, n);
+      for (int i = 0; i < n; ++i) {
+         for (int j = 0; j < n; ++j) {
+            values(i, j) = coeffs_(i, j).*member;
+         }
+      }
+      ar.pack(&values(0, 0), n, n, n);
+   }
+
    /* 
    * Set nAtomType
    */
@@ -151,14 +207,14 @@ namespace Simp
       if (nAtomType <= 0) {
          UTIL_THROW("nAtomType <= 0");
       }
-      if (nAtomType > MaxAtomType) {
-         UTIL_THROW("nAtomType > DpdPair::MaxAtomType");
+      if (epsilon_.isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("nAtomType cannot be changed after allocation");
       }
       nAtomType_ = nAtomType;
    }
     
    /*
-   * Reset epsilon_[i][j] after initialization
+   * Reset epsilon(i, j) after initialization
    */
    void DpdPair::setEpsilon(int i, int j, double epsilon)
    {
@@ -174,19 +230,15 @@ namespace Simp
          UTIL_THROW("Invalid atom type index j");
       }
 
-      epsilon_[i][j] = epsilon;
-      cf_[i][j] = epsilon_[i][j]/sigmaSq_[i][j];
-      ce_[i][j] = 0.5*cf_[i][j];
-
-      if (j != i) {
-         epsilon_[j][i] = epsilon;
-         cf_[j][i] = cf_[i][j];
-         ce_[j][i] = ce_[i][j];
-      }
+      // Set and symmetrize
+      epsilon_(i, j) = epsilon;
+      epsilon_(j, i) = epsilon;
+      setCoeff(i, j);
+      setCoeff(j, i);
    } 
 
    /*
-   * Reset sigma_[i][j] after initialization
+   * Reset sigma(i, j) after initialization
    */
    void DpdPair::setSigma(int i, int j, double sigma)
    {
@@ -202,19 +254,11 @@ namespace Simp
          UTIL_THROW("Invalid atom type index j");
       }
 
-      sigma_[i][j]   = sigma;
-      sigmaSq_[i][j] = sigma*sigma;
-      cf_[i][j]      = epsilon_[i][j]/sigmaSq_[i][j];
-      ce_[i][j]      = 0.5*cf_[i][j];
-
-      // Symmetrize
-      if (j != i) {
-         sigma_[j][i] = sigma;
-         sigmaSq_[j][i] = sigmaSq_[i][j];
-         cf_[j][i] = cf_[i][j];
-         ce_[j][i] = ce_[i][j];
-      }
-
+      // Set and symmetrize
+      sigma_(i, j) = sigma;
+      sigma_(j, i) = sigma;
+      setCoeff(i, j);
+      setCoeff(j, i);
    } 
 
    /* 
@@ -224,7 +268,7 @@ namespace Simp
    { 
       assert(i >= 0 && i < nAtomType_); 
       assert(j >= 0 && j < nAtomType_); 
-      return epsilon_[i][j]; 
+      return epsilon_(i, j); 
    }
 
    /* 
@@ -234,7 +278,7 @@ namespace Simp
    {
       assert(i >= 0 && i < nAtomType_); 
       assert(j >= 0 && j < nAtomType_); 
-      return sigma_[i][j]; 
+      return sigma_(i, j); 
    }
 
    /* 
@@ -249,15 +293,17 @@ namespace Simp
    void DpdPair::set(std::string name, int i, int j, double value)
    {
       if (name == "epsilon") {
-         epsilon_[i][j] = value;
-         epsilon_[j][i] = value;
+         epsilon_(i, j) = value;
+         epsilon_(j, i) = value;
       } else
       if (name == "sigma") {
-         sigma_[i][j] = value;
-         sigma_[j][i] = value;
+         sigma_(i, j) = value;
+         sigma_(j, i) = value;
       } else {
          UTIL_THROW("Unrecognized parameter name");
       }
+      setCoeff(i, j);
+      setCoeff(j, i);
    }
 
    /*
@@ -267,14 +313,14 @@ namespace Simp
    {
       double value = 0.0;
       if (name == "epsilon") {
-         value = epsilon_[i][j];
+         value = epsilon_(i, j);
       } else
       if (name == "sigma") {
-         value = sigma_[i][j];
+         value = sigma_(i, j);
       } else {
          UTIL_THROW("Unrecognized parameter name");
       }
       return value;
    }
 
-} 
+}
@@ -8,7 +8,10 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
+#include <simp/interaction/pair/TypePairArray.h>
+#include <simp/interaction/pair/ForceReal.h>
 #include <util/param/ParamComposite.h>
+#include <util/containers/DMatrix.h>
 #include <util/global.h>
 
 #include <math.h>
@@ -22,6 +25,10 @@ namespace Simp
    * Soft pair potential used in dissipative particle dynamics (DPD) simulations 
    * of Groot, Warren et al. 
    *
+   * The number of atom types is not limited. The coefficients for each
+   * pair of types are packed into one 32 byte Coeff record, aligned so 
+   * that it never straddles two cache lines.
+   *
    * \sa \ref simp_interaction_pair_DpdPair_page "Parameter file format"
    * \sa \ref simp_interaction_pair_interface_page
    * \sa \ref simp_interaction_pair_page
@@ -146,13 +153,47 @@ namespace Simp
       * \return  force divided by distance 
       */
       double forceOverR(double rsq, int i, int j) const;
+  
+      /**
+      * Compute force/distance ratios for a block of pairs.
+      *
+      * Equivalent to setting fOverR[k] = forceOverR(rsq[k], i[k], j[k])
+      * for all 0 <= k < n, but omits the cutoff test in order to allow
+      * the loop to be vectorized. Every element must thus satisfy the
+      * precondition rsq[k] < cutoffSq(i[k], j[k]).
+      *
+      * \param n      number of pairs in block
+      * \param rsq    array of squared separations
+      * \param i      array of types of particle 1
+      * \param j      array of types of particle 2
+      * \param fOverR array of force divided by distance (output)
+      */
+      void forceOverR(int n, const double* rsq, const int* i, const int* j,
+                      double* fOverR) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = energy(rsq, i, j) and fOverR =
+      * forceOverR(rsq, i, j), but shares intermediate results. The
+      * precondition of forceOverR applies: rsq must be less than
+      * cutoffSq(i, j).
+      *
+      * \param rsq    square of distance between particles
+      * \param i      type of particle 1
+      * \param j      type of particle 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j, 
+                    double& energy, double& fOverR) const;
    
       /**
       * Get square of cutoff distance for specific type pair.
       *
       * \param i   type of Atom 1
       * \param j   type of Atom 2
-      * \return    cutoffSq_[i][j]
+      * \return    square of cutoff distance
       */
       double cutoffSq(int i, int j) const;
  
@@ -179,7 +220,7 @@ namespace Simp
       *
       * \param i   type of Atom 1
       * \param j   type of Atom 2
-      * \return    epsilon_[i][j]
+      * \return    epsilon(i, j)
       */
       double epsilon(int i, int j) const;
  
@@ -188,23 +229,31 @@ namespace Simp
       *
       * \param i   atom type index 1
       * \param j   atom type index 2
-      * \return    sigma_[i][j]
+      * \return    sigma(i, j)
       */
       double sigma(int i, int j) const;
  
       //@}
 
    private:
-   
-      /// Maximum allowed value for nAtomType (# of particle types)
-      static const int MaxAtomType = 4;
+
+      /**
+      * Coefficients for one pair of atom types (32 bytes).
+      */
+      struct Coeff
+      {
+         double sigma;     ///< range parameter
+         double sigmaSq;   ///< square of sigma
+         double ce;        ///< energy prefactor
+         double cf;        ///< force prefactor
+      };
    
       // Parameters for different types of particle pairs
-      double epsilon_[MaxAtomType][MaxAtomType];   ///< energy parameter
-      double sigma_[MaxAtomType][MaxAtomType];     ///< range parameter
-      double sigmaSq_[MaxAtomType][MaxAtomType];   ///< square of sigma[][].
-      double ce_[MaxAtomType][MaxAtomType];        ///< energy prefactor
-      double cf_[MaxAtomType][MaxAtomType];        ///< force prefactor
+      DMatrix<double> epsilon_;   ///< energy parameter
+      DMatrix<double> sigma_;     ///< range parameter
+
+      /// Packed coefficients, computed from epsilon and sigma.
+      TypePairArray<Coeff> coeffs_;
  
       /**
       * Maximum pair potential cutoff radius, for all monomer type pairs.
@@ -219,6 +268,35 @@ namespace Simp
       /// Are all parameters and pointers initialized?
       bool  isInitialized_;
 
+      /**
+      * Allocate parameter matrices, if not already allocated.
+      */
+      void allocate();
+
+      /**
+      * Free parameter matrices and coefficient records.
+      */
+      void deallocate();
+
+      /**
+      * Pack one member of all Coeff records to an archive.
+      *
+      * Used by save() to write the derived arrays of the archive format
+      * used before coefficients were packed into Coeff records.
+      *
+      * \param ar  output archive
+      * \param member  pointer to a double member of Coeff
+      */
+      void packCoeff(Serializable::OArchive &ar, double Coeff::* member);
+
+      /**
+      * Compute packed coefficients for one type pair.
+      *
+      * \param i  type of atom 1
+      * \param j  type of atom 2
+      */
+      void setCoeff(int i, int j);
+
    };
   
    // inline methods 
@@ -228,10 +306,11 @@ namespace Simp
    */
    inline double DpdPair::energy(double rsq, int i, int j) const 
    {
+      const Coeff& c = coeffs_(i, j);
       double dr;
-      if (rsq < sigmaSq_[i][j]) {
-         dr = sqrt(rsq) - sigma_[i][j];
-         return ce_[i][j]*dr*dr;
+      if (rsq < c.sigmaSq) {
+         dr = sqrt(rsq) - c.sigma;
+         return c.ce*dr*dr;
       } else {
          return 0.0;
       }
@@ -242,18 +321,58 @@ namespace Simp
    */
    inline double DpdPair::forceOverR(double rsq, int i, int j) const
    {
-      if (rsq < sigmaSq_[i][j]) {
-         return cf_[i][j]*(sigma_[i][j]/sqrt(rsq) - 1.0);
+      const Coeff& c = coeffs_(i, j);
+      if (rsq < c.sigmaSq) {
+         return c.cf*(c.sigma/sqrt(rsq) - 1.0);
       } else {
          return 0.0;
       }
    }
 
    /* 
-   * Calculate force/distance for a pair as function of squared distance.
+   * Calculate force/distance for a block of pairs inside the cutoff.
+   */
+   inline 
+   void DpdPair::forceOverR(int n, const double* rsq, const int* i, 
+                            const int* j, double* fOverR) const
+   {
+      const ForceReal one = 1.0;
+      int k;
+      if (nAtomType_ == 1) {
+         const ForceReal sigma = coeffs_(0, 0).sigma;
+         const ForceReal cf = coeffs_(0, 0).cf;
+         for (k = 0; k < n; ++k) {
+            fOverR[k] = cf*(sigma/sqrt(ForceReal(rsq[k])) - one);
+         }
+      } else {
+         const Coeff* c;
+         for (k = 0; k < n; ++k) {
+            c = &coeffs_(i[k], j[k]);
+            fOverR[k] = ForceReal(c->cf)
+                      *(ForceReal(c->sigma)/sqrt(ForceReal(rsq[k])) - one);
+         }
+      }
+   }
+
+   /* 
+   * Calculate energy and force/distance for a pair inside the cutoff.
+   */
+   inline 
+   void DpdPair::evaluate(double rsq, int i, int j, 
+                          double& energy, double& fOverR) const
+   {
+      const Coeff& c = coeffs_(i, j);
+      double r = sqrt(rsq);
+      double dr = r - c.sigma;
+      energy = c.ce*dr*dr;
+      fOverR = -c.cf*dr/r;
+   }
+
+   /* 
+   * Return square of cutoff distance for a specific type pair.
    */
    inline double DpdPair::cutoffSq(int i, int j) const
-   {  return sigmaSq_[i][j]; }
+   {  return coeffs_(i, j).sigmaSq; }
 
 }
 #endif
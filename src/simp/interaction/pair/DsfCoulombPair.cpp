@@ -0,0 +1,225 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DsfCoulombPair.h"
+#include <util/math/Constants.h>
+
+#include <iostream>
+namespace Simp
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   DsfCoulombPair::DsfCoulombPair()
+    : epsilon_(0.0),
+      alpha_(0.0),
+      cutoff_(0.0),
+      cutoffSq_(0.0),
+      cf_(0.0),
+      shiftEnergy_(0.0),
+      shiftForce_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  setClassName("DsfCoulombPair"); }
+
+   /*
+   * Copy constructor.
+   */
+   DsfCoulombPair::DsfCoulombPair(const DsfCoulombPair& other)
+    : epsilon_(0.0),
+      alpha_(0.0),
+      cutoff_(0.0),
+      cutoffSq_(0.0),
+      cf_(0.0),
+      shiftEnergy_(0.0),
+      shiftForce_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {
+      setClassName("DsfCoulombPair");
+      *this = other;
+   }
+
+   /*
+   * Assignment operator.
+   */
+   DsfCoulombPair& DsfCoulombPair::operator = (const DsfCoulombPair& other)
+   {
+      epsilon_       = other.epsilon_;
+      alpha_         = other.alpha_;
+      cutoff_        = other.cutoff_;
+      cutoffSq_      = other.cutoffSq_;
+      cf_            = other.cf_;
+      shiftEnergy_   = other.shiftEnergy_;
+      shiftForce_    = other.shiftForce_;
+      nAtomType_     = other.nAtomType_;
+      isInitialized_ = other.isInitialized_;
+      if (other.charges_.isAllocated()) {
+         allocate();
+         for (int i = 0; i < nAtomType_; ++i) {
+            charges_[i] = other.charges_[i];
+         }
+         ce_ = other.ce_;
+      }
+      return *this;
+   }
+
+   /*
+   * Allocate charge array and coefficient records.
+   */
+   void DsfCoulombPair::allocate()
+   {
+      if (!charges_.isAllocated()) {
+         charges_.allocate(nAtomType_);
+         ce_.allocate(nAtomType_);
+      }
+   }
+
+   /*
+   * Compute shifts and prefactors for all type pairs.
+   */
+   void DsfCoulombPair::setCoeffs()
+   {
+      if (epsilon_ <= 0.0) {
+         UTIL_THROW("Dielectric permittivity epsilon must be positive");
+      }
+      if (alpha_ < 0.0) {
+         UTIL_THROW("Damping parameter alpha must be non-negative");
+      }
+      if (cutoff_ <= 0.0) {
+         UTIL_THROW("Cutoff must be positive");
+      }
+      cutoffSq_ = cutoff_*cutoff_;
+      cf_ = 2.0*alpha_/sqrt(Constants::Pi);
+      double x = alpha_*cutoff_;
+      shiftEnergy_ = erfc(x)/cutoff_;
+      shiftForce_ = shiftEnergy_/cutoff_ + cf_*exp(-x*x)/cutoff_;
+
+      double prefactor = 1.0/(4.0*Constants::Pi*epsilon_);
+      int i, j;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            ce_(i, j) = prefactor*charges_[i]*charges_[j];
+         }
+      }
+   }
+
+   /*
+   * Read potential parameters from file.
+   */
+   void DsfCoulombPair::readParameters(std::istream &in)
+   {
+      // Preconditions
+      if (nAtomType_ <= 0) {
+         UTIL_THROW( "nAtomType must be set before readParam");
+      }
+      allocate();
+
+      // Read parameters
+      read<double>(in, "epsilon", epsilon_);
+      readDArray<double>(in, "charges", charges_, nAtomType_);
+      read<double>(in, "alpha", alpha_);
+      read<double>(in, "cutoff", cutoff_);
+
+      setCoeffs();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void DsfCoulombPair::loadParameters(Serializable::IArchive &ar)
+   {
+      // Precondition
+      if (nAtomType_ <= 0) {
+         UTIL_THROW( "nAtomType must be set before loadParameters");
+      }
+      allocate();
+
+      // Read parameters
+      loadParameter<double>(ar, "epsilon", epsilon_);
+      loadDArray<double>(ar, "charges", charges_, nAtomType_);
+      loadParameter<double>(ar, "alpha", alpha_);
+      loadParameter<double>(ar, "cutoff", cutoff_);
+      setCoeffs();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void DsfCoulombPair::save(Serializable::OArchive &ar)
+   {
+      ar << epsilon_;
+      ar << charges_;
+      ar << alpha_;
+      ar << cutoff_;
+   }
+
+   /*
+   * Set nAtomType
+   */
+   void DsfCoulombPair::setNAtomType(int nAtomType)
+   {
+      if (nAtomType <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (charges_.isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("nAtomType cannot be changed after allocation");
+      }
+      nAtomType_ = nAtomType;
+   }
+
+   /*
+   * Get maximum of pair cutoff distance, for all atom type pairs.
+   */
+   double DsfCoulombPair::maxPairCutoff() const
+   { return cutoff_; }
+
+   /*
+   * Set a potential energy parameter, identified by a string.
+   */
+   void DsfCoulombPair::set(std::string name, int i, int j, double value)
+   {
+      if (name == "charge") {
+         if (i < 0 || i >= nAtomType_) {
+            UTIL_THROW("Invalid atom type index i");
+         }
+         charges_[i] = value;
+      } else {
+         UTIL_THROW("Unrecognized parameter name");
+      }
+      setCoeffs();
+   }
+
+   /*
+   * Get a parameter value, identified by a string.
+   */
+   double DsfCoulombPair::get(std::string name, int i, int j) const
+   {
+      double value = 0.0;
+      if (name == "epsilon") {
+         value = epsilon_;
+      } else
+      if (name == "charge") {
+         value = charges_[i];
+      } else
+      if (name == "alpha") {
+         value = alpha_;
+      } else
+      if (name == "cutoff") {
+         value = cutoff_;
+      } else {
+         UTIL_THROW("Unrecognized parameter name");
+      }
+      return value;
+   }
+
+}
@@ -0,0 +1,32 @@
+#ifndef SIMP_FORCE_REAL_H
+#define SIMP_FORCE_REAL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+namespace Simp
+{
+
+   /**
+   * Floating point type used within blocked pair force kernels.
+   *
+   * This is float if the preprocessor macro SIMP_FLOAT_FORCE is defined,
+   * and double otherwise. It is used only for intermediate quantities in
+   * the block forceOverR() functions of pair interaction classes, which
+   * read and write arrays of double. Positions, forces, energies, 
+   * stresses and integration always remain in double precision.
+   *
+   * \ingroup Simp_Interaction_Pair_Module
+   */
+   #ifdef SIMP_FLOAT_FORCE
+   typedef float ForceReal;
+   #else
+   typedef double ForceReal;
+   #endif
+
+}
+#endif
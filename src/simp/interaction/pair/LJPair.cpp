@@ -31,22 +31,12 @@ namespace Simp
    * Copy constructor.
    */
    LJPair::LJPair(const LJPair& other)
-    : maxPairCutoff_(other.maxPairCutoff_),
-      nAtomType_(other.nAtomType_),
-      isInitialized_(other.isInitialized_)
-   {
-      int i,j;
-      for (i = 0; i < nAtomType_; ++i) {
-         for (j = 0; j < nAtomType_; ++j) {
-            cutoffSq_[i][j]= other.cutoffSq_[i][j];
-            sigma_[i][j]   = other.sigma_[i][j];
-            eps48_[i][j]   = other.eps48_[i][j];
-            ljShift_[i][j] = other.ljShift_[i][j];
-            epsilon_[i][j] = other.epsilon_[i][j];
-            cutoff_[i][j]  = other.cutoff_[i][j];
-            sigmaSq_[i][j] = other.sigmaSq_[i][j];
-         }
-      }
+    : maxPairCutoff_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  
+      setClassName("LJPair"); 
+      *this = other;
    }
    
    /* 
@@ -54,20 +44,19 @@ namespace Simp
    */
    LJPair& LJPair::operator = (const LJPair& other)
    {
+      if (this == &other) return *this;
+      if (epsilon_.isAllocated() && nAtomType_ != other.nAtomType_) {
+         deallocate();
+      }
       maxPairCutoff_ = other.maxPairCutoff_;
       nAtomType_     = other.nAtomType_;
       isInitialized_ = other.isInitialized_;
-      int i,j;
-      for (i = 0; i < nAtomType_; ++i) {
-         for (j = 0; j < nAtomType_; ++j) {
-            cutoffSq_[i][j]= other.cutoffSq_[i][j];
-            sigmaSq_[i][j] = other.sigmaSq_[i][j];
-            eps48_[i][j]   = other.eps48_[i][j];
-            ljShift_[i][j] = other.ljShift_[i][j];
-            epsilon_[i][j] = other.epsilon_[i][j];
-            sigma_[i][j]   = other.sigma_[i][j];
-            cutoff_[i][j]  = other.cutoff_[i][j];
-         } 
+      if (other.epsilon_.isAllocated()) {
+         allocate();
+         epsilon_ = other.epsilon_;
+         sigma_   = other.sigma_;
+         cutoff_  = other.cutoff_;
+         coeffs_  = other.coeffs_;
       }
       return *this;
    }
@@ -80,14 +69,73 @@ namespace Simp
       if (nAtomType <= 0) {
          UTIL_THROW("nAtomType <= 0");
       }
-      if (nAtomType > MaxAtomType) {
-         UTIL_THROW("nAtomType > LJPair::MaxAtomType");
+      if (epsilon_.isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("nAtomType cannot be changed after allocation");
       }
       nAtomType_ = nAtomType;
    }
 
    /*
-   * Reset epsilon_[i][j] after initialization
+   * Allocate parameter matrices and coefficient records.
+   */
+   void LJPair::allocate()
+   {
+      if (!epsilon_.isAllocated()) {
+         epsilon_.allocate(nAtomType_, nAtomType_);
+         sigma_.allocate(nAtomType_, nAtomType_);
+         cutoff_.allocate(nAtomType_, nAtomType_);
+         coeffs_.allocate(nAtomType_);
+      }
+   }
+
+   /*
+   * Free parameter matrices and coefficient records.
+   */
+   void LJPair::deallocate()
+   {
+      if (epsilon_.isAllocated()) {
+         epsilon_.deallocate();
+         sigma_.deallocate();
+         cutoff_.deallocate();
+         coeffs_.deallocate();
+      }
+   }
+
+   /*
+   * Compute packed coefficients for one type pair.
+   */
+   void LJPair::setCoeff(int i, int j)
+   {
+      Coeff& c = coeffs_(i, j);
+      c.sigmaSq  = sigma_(i, j)*sigma_(i, j);
+      c.cutoffSq = cutoff_(i, j)*cutoff_(i, j);
+      c.minRsq   = 0.6*c.sigmaSq;
+      c.eps4     = 4.0*epsilon_(i, j);
+      c.eps48    = 48.0*epsilon_(i, j);
+      double r6i = c.sigmaSq/c.cutoffSq;
+      r6i = r6i*r6i*r6i;
+      c.ljShift  = -c.eps4*(r6i*r6i - r6i);
+   }
+
+   /*
+   * Compute packed coefficients for all type pairs, and maxPairCutoff_.
+   */
+   void LJPair::setCoeffs()
+   {
+      int i, j;
+      maxPairCutoff_ = 0.0;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            setCoeff(i, j);
+            if (cutoff_(i, j) > maxPairCutoff_ ) {
+               maxPairCutoff_ = cutoff_(i, j);
+            }
+         } 
+      } 
+   }
+    
+   /*
+   * Reset epsilon(i, j) after initialization
    */
    void LJPair::setEpsilon(int i, int j, double epsilon)
    {
@@ -103,24 +151,15 @@ namespace Simp
          UTIL_THROW("Invalid atom type index j");
       }
 
-      epsilon_[i][j] = epsilon;
-      eps48_[i][j]   = 48.0*epsilon;
-
-      // Calculate shift
-      double r6i = sigmaSq_[i][j]/cutoffSq_[i][j];
-      r6i = r6i*r6i*r6i;
-      ljShift_[i][j] = -4.0*epsilon_[i][j]*(r6i*r6i - r6i);
-
-      // Symmetrize
-      if (j != i) {
-         epsilon_[j][i] = epsilon_[i][j];
-         eps48_[j][i]   = eps48_[i][j];
-         ljShift_[j][i] = ljShift_[i][j];
-      }
+      // Set and symmetrize
+      epsilon_(i, j) = epsilon;
+      epsilon_(j, i) = epsilon;
+      setCoeff(i, j);
+      setCoeff(j, i);
    } 
 
    /*
-   * Reset sigma_[i][j] after initialization
+   * Reset sigma(i, j) after initialization
    */
    void LJPair::setSigma(int i, int j, double sigma)
    {
@@ -136,21 +175,11 @@ namespace Simp
          UTIL_THROW("Invalid atom type index j");
       }
 
-      sigma_[i][j]   = sigma;
-      sigmaSq_[i][j] = sigma*sigma;
-
-      // Recalculate shift
-      double r6i = sigmaSq_[i][j]/cutoffSq_[i][j];
-      r6i = r6i*r6i*r6i;
-      ljShift_[i][j] = -4.0*epsilon_[i][j]*(r6i*r6i - r6i);
-
-      // Symmetrize
-      if (j != i) {
-         sigma_[j][i]   = sigma_[i][j];
-         sigmaSq_[j][i] = sigmaSq_[i][j];
-         ljShift_[j][i] = ljShift_[j][i];
-      }
-
+      // Set and symmetrize
+      sigma_(i, j) = sigma;
+      sigma_(j, i) = sigma;
+      setCoeff(i, j);
+      setCoeff(j, i);
    } 
 
    /* 
@@ -161,32 +190,14 @@ namespace Simp
       if (nAtomType_ <= 0) {
          UTIL_THROW( "nAtomType must be set before readParam");
       }
+      allocate();
    
       // Read parameters
-      readCArray2D<double> (in, "epsilon", epsilon_[0], 
-                            nAtomType_, nAtomType_, MaxAtomType);
-      readCArray2D<double>(in, "sigma", sigma_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
-      readCArray2D<double>(in, "cutoff", cutoff_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
+      readDMatrix<double>(in, "epsilon", epsilon_, nAtomType_, nAtomType_);
+      readDMatrix<double>(in, "sigma", sigma_, nAtomType_, nAtomType_);
+      readDMatrix<double>(in, "cutoff", cutoff_, nAtomType_, nAtomType_);
    
-      // Initialize sigmaSq, cutoffSq, and ljShift, and maxPairCutoff_
-      double r6i;
-      int i, j;
-      maxPairCutoff_ = 0.0;
-      for (i = 0; i < nAtomType_; ++i) {
-         for (j = 0; j < nAtomType_; ++j) {
-            eps48_[i][j] = 48.0*epsilon_[i][j];
-            sigmaSq_[i][j] = sigma_[i][j]*sigma_[i][j];
-            cutoffSq_[i][j] = cutoff_[i][j]*cutoff_[i][j];
-            r6i = sigmaSq_[i][j]/cutoffSq_[i][j];
-            r6i = r6i*r6i*r6i;
-            ljShift_[i][j] = -4.0*epsilon_[i][j]*(r6i*r6i - r6i);
-            if (cutoff_[i][j] > maxPairCutoff_ ) {
-               maxPairCutoff_ = cutoff_[i][j];
-            }
-         } 
-      } 
+      setCoeffs();
       isInitialized_ = true;
    }
 
@@ -198,28 +209,30 @@ namespace Simp
       if (nAtomType_ <= 0) {
          UTIL_THROW( "nAtomType must be set before readParam");
       }
+      allocate();
+      const int n = nAtomType_;
 
       // Read parameters
-      loadCArray2D<double>(ar, "epsilon", epsilon_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
-      loadCArray2D<double>(ar, "sigma", sigma_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
-      loadCArray2D<double>(ar, "cutoff", cutoff_[0], 
-                           nAtomType_, nAtomType_, MaxAtomType);
+      loadCArray2D<double>(ar, "epsilon", &epsilon_(0, 0), n, n, n);
+      loadCArray2D<double>(ar, "sigma", &sigma_(0, 0), n, n, n);
+      loadCArray2D<double>(ar, "cutoff", &cutoff_(0, 0), n, n, n);
+
+      // Skip derived arrays, which are recomputed by setCoeffs()
+      DMatrix<double> derived;
+      derived.allocate(n, n);
       #ifdef UTIL_MPI
       MpiLoader<Serializable::IArchive> loader(*this, ar);
-      loader.load(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      loader.load(cutoffSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      loader.load(ljShift_[0], nAtomType_, nAtomType_, MaxAtomType);
-      loader.load(eps48_[0], nAtomType_, nAtomType_, MaxAtomType);
+      for (int k = 0; k < 4; ++k) {
+         loader.load(&derived(0, 0), n, n, n);
+      }
       loader.load(maxPairCutoff_);
       #else
-      ar.unpack(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.unpack(cutoffSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.unpack(ljShift_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.unpack(eps48_[0], nAtomType_, nAtomType_, MaxAtomType);
+      for (int k = 0; k < 4; ++k) {
+         ar.unpack(&derived(0, 0), n, n, n);
+      }
       ar >> maxPairCutoff_;
       #endif
+      setCoeffs();
       isInitialized_ = true;
    }
 
@@ -228,16 +241,33 @@ namespace Simp
    */
    void LJPair::save(Serializable::OArchive &ar)
    {
-      ar.pack(epsilon_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(sigma_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(cutoff_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(sigmaSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(cutoffSq_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(ljShift_[0], nAtomType_, nAtomType_, MaxAtomType);
-      ar.pack(eps48_[0], nAtomType_, nAtomType_, MaxAtomType);
+      const int n = nAtomType_;
+      ar.pack(&epsilon_(0, 0), n, n, n);
+      ar.pack(&sigma_(0, 0), n, n, n);
+      ar.pack(&cutoff_(0, 0), n, n, n);
+      packCoeff(ar, &Coeff::sigmaSq);
+      packCoeff(ar, &Coeff::cutoffSq);
+      packCoeff(ar, &Coeff::ljShift);
+      packCoeff(ar, &Coeff::eps48);
       ar << maxPairCutoff_;
    }
 
+   /*
+   * Pack one member of all coefficient records, as an n x n array.
+   */
+   void LJPair::packCoeff(Serializable::OArchive &ar, double Coeff::* member)
+   {
+      const int n = nAtomType_;
+      DMatrix<double> values;
+      values.allocate(n, n);
+      for (int i = 0; i < n; ++i) {
+         for (int j = 0; j < n; ++j) {
+            values(i, j) = coeffs_(i, j).*member;
+         }
+      }
+      ar.pack(&values(0, 0), n, n, n);
+   }
+
    /* 
    * Get maximum of pair cutoff distance, for all atom type pairs.
    */
@@ -251,7 +281,7 @@ namespace Simp
    { 
       assert(i >= 0 && i < nAtomType_); 
       assert(j >= 0 && j < nAtomType_); 
-      return epsilon_[i][j]; 
+      return epsilon_(i, j); 
    }
 
    /* 
@@ -261,7 +291,7 @@ namespace Simp
    {
       assert(i >= 0 && i < nAtomType_); 
       assert(j >= 0 && j < nAtomType_); 
-      return sigma_[i][j]; 
+      return sigma_(i, j); 
    }
 
    /*
@@ -270,32 +300,19 @@ namespace Simp
    void LJPair::set(std::string name, int i, int j, double value)
    {
       if (name == "epsilon") {
-         epsilon_[i][j] = value;
-         eps48_[i][j] = 48.0*value;
-         if (j != i) {
-            epsilon_[j][i] = value;
-            eps48_[j][i] = eps48_[i][j];
-         }
+         epsilon_(i, j) = value;
+         epsilon_(j, i) = value;
       } else
       if (name == "sigma") {
-         sigma_[i][j] = value;
-         sigmaSq_[i][j] = value*value;
-         if (j != i) {
-            sigma_[j][i] = sigma_[i][j];
-            sigmaSq_[j][i] = sigmaSq_[i][j];
-         }
+         sigma_(i, j) = value;
+         sigma_(j, i) = value;
       } else {
          UTIL_THROW("Unrecognized parameter name");
       }
 
-      // Recalculate shift
-      double r6i = sigmaSq_[i][j]/cutoffSq_[i][j];
-      r6i = r6i*r6i*r6i;
-      ljShift_[i][j] = -4.0*epsilon_[i][j]*(r6i*r6i - r6i);
-      if (j != i) {
-         ljShift_[j][i] = ljShift_[j][i];
-      }
-
+      // Recalculate coefficients, including shift
+      setCoeff(i, j);
+      setCoeff(j, i);
    }
 
    /*
@@ -305,17 +322,17 @@ namespace Simp
    {
       double value = 0.0;
       if (name == "epsilon") {
-         value = epsilon_[i][j];
+         value = epsilon_(i, j);
       } else
       if (name == "sigma") {
-         value = sigma_[i][j];
+         value = sigma_(i, j);
       } else
       if (name == "cutoff") {
-         value = cutoff_[i][j];
+         value = cutoff_(i, j);
       } else {
          UTIL_THROW("Unrecognized parameter name");
       }
       return value;
    }
 
-} 
+}
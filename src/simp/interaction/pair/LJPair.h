@@ -8,7 +8,10 @@
 * Distributed under the terms of the GNU General Public License.
 */
 
+#include <simp/interaction/pair/TypePairArray.h>
+#include <simp/interaction/pair/ForceReal.h>
 #include <util/param/ParamComposite.h>
+#include <util/containers/DMatrix.h>
 #include <util/global.h>
 
 #include <math.h>
@@ -24,6 +27,14 @@ namespace Simp
    * This class defines a Lennard-Jones potential that is cutoff and
    * shifted so that the potential is zero at the cutoff distance.
    *
+   * The number of atom types is not limited. All coefficients needed
+   * to evaluate the interaction of one pair of types are packed into 
+   * one cache-aligned Coeff record, so that each pair evaluation reads
+   * one cache line. For systems with one atom type, the block function
+   * forceOverR(n, ...) hoists these coefficients out of its loop. The
+   * block function uses ForceReal (float if SIMP_FLOAT_FORCE is defined)
+   * for intermediate values.
+   *
    * \sa \ref simp_interaction_pair_LJPair_page "Parameter file format"
    * \sa \ref simp_interaction_pair_interface_page
    * \sa \ref simp_interaction_pair_page
@@ -152,13 +163,47 @@ namespace Simp
       * \return    force divided by distance 
       */
       double forceOverR(double rsq, int i, int j) const;
-  
+
+      /**
+      * Compute force/distance ratios for a block of pairs.
+      *
+      * Equivalent to setting fOverR[k] = forceOverR(rsq[k], i[k], j[k])
+      * for all 0 <= k < n, but written as a single branch-free loop that
+      * the compiler can vectorize. The same precondition applies to each
+      * element: rsq[k] must be less than cutoffSq(i[k], j[k]).
+      *
+      * \param n      number of pairs in block
+      * \param rsq    array of squared separations
+      * \param i      array of types of atom 1
+      * \param j      array of types of atom 2
+      * \param fOverR array of force divided by distance (output)
+      */
+      void forceOverR(int n, const double* rsq, const int* i, const int* j,
+                      double* fOverR) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = energy(rsq, i, j) and fOverR =
+      * forceOverR(rsq, i, j), but shares intermediate results. The
+      * precondition of forceOverR applies: rsq must be less than
+      * cutoffSq(i, j).
+      *
+      * \param rsq    square of distance between atoms
+      * \param i      type of atom 1
+      * \param j      type of atom 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j, 
+                    double& energy, double& fOverR) const;
+
       /**
       * Get square of cutoff distance for specific type pair.
       *
       * \param i   type of atom 1
       * \param j   type of atom 2
-      * \return    cutoffSq_[i][j]
+      * \return    square of cutoff distance
       */
       double cutoffSq(int i, int j) const;
  
@@ -172,7 +217,7 @@ namespace Simp
       *
       * \param i   type of Atom 1
       * \param j   type of Atom 2
-      * \return    epsilon_[i][j]
+      * \return    epsilon(i, j)
       */
       double epsilon(int i, int j) const;
  
@@ -181,7 +226,7 @@ namespace Simp
       *
       * \param i   atom type index 1
       * \param j   atom type index 2
-      * \return    sigma_[i][j]
+      * \return    sigma(i, j)
       */
       double sigma(int i, int j) const;
  
@@ -197,18 +242,28 @@ namespace Simp
       //@}
 
    protected:
-   
-      /// Maximum allowed value for nAtomType (# of atom types)
-      static const int MaxAtomType = 4;
+
+      /**
+      * Coefficients for one pair of atom types (64 bytes).
+      */
+      struct Coeff
+      {
+         double sigmaSq;   ///< square of sigma
+         double cutoffSq;  ///< square of cutoff
+         double minRsq;    ///< rsq below which energy is constant
+         double eps4;      ///< 4*epsilon
+         double eps48;     ///< 48*epsilon
+         double ljShift;   ///< shift in LJ potential
+         double pad[2];    ///< padding to one cache line
+      };
    
       // Lennard-Jones parameters for different types of atom pairs
-      double epsilon_[MaxAtomType][MaxAtomType];  ///< LJ interaction energies.
-      double sigma_[MaxAtomType][MaxAtomType];    ///< LJ range parameters.
-      double sigmaSq_[MaxAtomType][MaxAtomType];  ///< square of sigma[][].
-      double cutoff_[MaxAtomType][MaxAtomType];   ///< LJ cutoff distance.
-      double cutoffSq_[MaxAtomType][MaxAtomType]; ///< square of cutoff[][].
-      double ljShift_[MaxAtomType][MaxAtomType];  ///< shift in LJ potential.
-      double eps48_[MaxAtomType][MaxAtomType];    ///< 48*epsilon
+      DMatrix<double> epsilon_;   ///< LJ interaction energies.
+      DMatrix<double> sigma_;     ///< LJ range parameters.
+      DMatrix<double> cutoff_;    ///< LJ cutoff distance.
+
+      /// Packed coefficients, computed from epsilon, sigma and cutoff.
+      TypePairArray<Coeff> coeffs_;
  
       /**
       * Maximum pair potential cutoff radius, for all monomer type pairs.
@@ -227,6 +282,40 @@ namespace Simp
       */
       bool  isInitialized_;
 
+      /**
+      * Allocate parameter matrices, if not already allocated.
+      */
+      void allocate();
+
+      /**
+      * Free parameter matrices and coefficient records.
+      */
+      void deallocate();
+
+      /**
+      * Pack one member of all Coeff records to an archive.
+      *
+      * Used by save() to write the derived arrays of the archive format
+      * used before coefficients were packed into Coeff records.
+      *
+      * \param ar  output archive
+      * \param member  pointer to a double member of Coeff
+      */
+      void packCoeff(Serializable::OArchive &ar, double Coeff::* member);
+
+      /**
+      * Compute packed coefficients for all type pairs, and maxPairCutoff.
+      */
+      void setCoeffs();
+
+      /**
+      * Compute packed coefficients for one type pair.
+      *
+      * \param i  type of atom 1
+      * \param j  type of atom 2
+      */
+      void setCoeff(int i, int j);
+
    };
   
    // Inline methods 
@@ -236,14 +325,15 @@ namespace Simp
    */
    inline double LJPair::energy(double rsq, int i, int j) const 
    {
+      const Coeff& c = coeffs_(i, j);
       double r6i;
-      if (rsq < cutoffSq_[i][j]) {
-         if (rsq < 0.6*sigmaSq_[i][j]) {
-             rsq = 0.6*sigmaSq_[i][j];
+      if (rsq < c.cutoffSq) {
+         if (rsq < c.minRsq) {
+             rsq = c.minRsq;
          }
-         r6i = sigmaSq_[i][j]/rsq;
+         r6i = c.sigmaSq/rsq;
          r6i = r6i*r6i*r6i;
-         return 4.0*epsilon_[i][j]*(r6i*r6i - r6i) + ljShift_[i][j];
+         return c.eps4*(r6i*r6i - r6i) + c.ljShift;
       } else {
          return 0.0;
       }
@@ -254,18 +344,71 @@ namespace Simp
    */
    inline double LJPair::forceOverR(double rsq, int i, int j) const
    {
+      const Coeff& c = coeffs_(i, j);
       double r2i, r6i;
       r2i = 1.0/rsq;
-      r6i = sigmaSq_[i][j]*r2i;
+      r6i = c.sigmaSq*r2i;
       r6i = r6i*r6i*r6i;
-      return eps48_[i][j]*(r6i - 0.5)*r6i*r2i;
+      return c.eps48*(r6i - 0.5)*r6i*r2i;
+   }
+
+   /* 
+   * Calculate force/distance for a block of pairs.
+   */
+   inline 
+   void LJPair::forceOverR(int n, const double* rsq, const int* i, 
+                           const int* j, double* fOverR) const
+   {
+      const ForceReal one = 1.0;
+      const ForceReal half = 0.5;
+      ForceReal r2i, r6i;
+      int k;
+      if (nAtomType_ == 1) {
+         const ForceReal sigmaSq = coeffs_(0, 0).sigmaSq;
+         const ForceReal eps48 = coeffs_(0, 0).eps48;
+         for (k = 0; k < n; ++k) {
+            r2i = one/ForceReal(rsq[k]);
+            r6i = sigmaSq*r2i;
+            r6i = r6i*r6i*r6i;
+            fOverR[k] = eps48*(r6i - half)*r6i*r2i;
+         }
+      } else {
+         const Coeff* c;
+         for (k = 0; k < n; ++k) {
+            c = &coeffs_(i[k], j[k]);
+            r2i = one/ForceReal(rsq[k]);
+            r6i = ForceReal(c->sigmaSq)*r2i;
+            r6i = r6i*r6i*r6i;
+            fOverR[k] = ForceReal(c->eps48)*(r6i - half)*r6i*r2i;
+         }
+      }
+   }
+
+   /* 
+   * Calculate energy and force/distance for a pair inside the cutoff.
+   */
+   inline 
+   void LJPair::evaluate(double rsq, int i, int j, 
+                         double& energy, double& fOverR) const
+   {
+      const Coeff& c = coeffs_(i, j);
+      double r2i, r6i;
+      r2i = 1.0/rsq;
+      r6i = c.sigmaSq*r2i;
+      r6i = r6i*r6i*r6i;
+      fOverR = c.eps48*(r6i - 0.5)*r6i*r2i;
+      if (rsq < c.minRsq) {
+         r6i = c.sigmaSq/c.minRsq;
+         r6i = r6i*r6i*r6i;
+      }
+      energy = c.eps4*(r6i*r6i - r6i) + c.ljShift;
    }
 
    /* 
    * Return cutoff parameter for a specific atom type pair.
    */
    inline double LJPair::cutoffSq(int i, int j) const
-   {  return cutoffSq_[i][j]; }
+   {  return coeffs_(i, j).cutoffSq; }
 
 }
 #endif
@@ -0,0 +1,220 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ReactionFieldPair.h"
+#include <util/math/Constants.h>
+
+#include <iostream>
+namespace Simp
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   ReactionFieldPair::ReactionFieldPair()
+    : epsilon_(0.0),
+      epsilonRF_(0.0),
+      cutoff_(0.0),
+      cutoffSq_(0.0),
+      kRF_(0.0),
+      cRF_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  setClassName("ReactionFieldPair"); }
+
+   /*
+   * Copy constructor.
+   */
+   ReactionFieldPair::ReactionFieldPair(const ReactionFieldPair& other)
+    : epsilon_(0.0),
+      epsilonRF_(0.0),
+      cutoff_(0.0),
+      cutoffSq_(0.0),
+      kRF_(0.0),
+      cRF_(0.0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {
+      setClassName("ReactionFieldPair");
+      *this = other;
+   }
+
+   /*
+   * Assignment operator.
+   */
+   ReactionFieldPair& ReactionFieldPair::operator = (const ReactionFieldPair& other)
+   {
+      epsilon_       = other.epsilon_;
+      epsilonRF_     = other.epsilonRF_;
+      cutoff_        = other.cutoff_;
+      cutoffSq_      = other.cutoffSq_;
+      kRF_           = other.kRF_;
+      cRF_           = other.cRF_;
+      nAtomType_     = other.nAtomType_;
+      isInitialized_ = other.isInitialized_;
+      if (other.charges_.isAllocated()) {
+         allocate();
+         for (int i = 0; i < nAtomType_; ++i) {
+            charges_[i] = other.charges_[i];
+         }
+         ce_ = other.ce_;
+      }
+      return *this;
+   }
+
+   /*
+   * Allocate charge array and coefficient records.
+   */
+   void ReactionFieldPair::allocate()
+   {
+      if (!charges_.isAllocated()) {
+         charges_.allocate(nAtomType_);
+         ce_.allocate(nAtomType_);
+      }
+   }
+
+   /*
+   * Compute shifts and prefactors for all type pairs.
+   */
+   void ReactionFieldPair::setCoeffs()
+   {
+      if (epsilon_ <= 0.0) {
+         UTIL_THROW("Dielectric permittivity epsilon must be positive");
+      }
+      if (epsilonRF_ <= 0.0) {
+         UTIL_THROW("Reaction field permittivity epsilonRF must be positive");
+      }
+      if (cutoff_ <= 0.0) {
+         UTIL_THROW("Cutoff must be positive");
+      }
+      cutoffSq_ = cutoff_*cutoff_;
+      kRF_ = (epsilonRF_ - 1.0)/((2.0*epsilonRF_ + 1.0)*cutoffSq_*cutoff_);
+      cRF_ = 1.0/cutoff_ + kRF_*cutoffSq_;
+
+      double prefactor = 1.0/(4.0*Constants::Pi*epsilon_);
+      int i, j;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            ce_(i, j) = prefactor*charges_[i]*charges_[j];
+         }
+      }
+   }
+
+   /*
+   * Read potential parameters from file.
+   */
+   void ReactionFieldPair::readParameters(std::istream &in)
+   {
+      // Preconditions
+      if (nAtomType_ <= 0) {
+         UTIL_THROW( "nAtomType must be set before readParam");
+      }
+      allocate();
+
+      // Read parameters
+      read<double>(in, "epsilon", epsilon_);
+      readDArray<double>(in, "charges", charges_, nAtomType_);
+      read<double>(in, "epsilonRF", epsilonRF_);
+      read<double>(in, "cutoff", cutoff_);
+
+      setCoeffs();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void ReactionFieldPair::loadParameters(Serializable::IArchive &ar)
+   {
+      // Precondition
+      if (nAtomType_ <= 0) {
+         UTIL_THROW( "nAtomType must be set before loadParameters");
+      }
+      allocate();
+
+      // Read parameters
+      loadParameter<double>(ar, "epsilon", epsilon_);
+      loadDArray<double>(ar, "charges", charges_, nAtomType_);
+      loadParameter<double>(ar, "epsilonRF", epsilonRF_);
+      loadParameter<double>(ar, "cutoff", cutoff_);
+      setCoeffs();
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void ReactionFieldPair::save(Serializable::OArchive &ar)
+   {
+      ar << epsilon_;
+      ar << charges_;
+      ar << epsilonRF_;
+      ar << cutoff_;
+   }
+
+   /*
+   * Set nAtomType
+   */
+   void ReactionFieldPair::setNAtomType(int nAtomType)
+   {
+      if (nAtomType <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (charges_.isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("nAtomType cannot be changed after allocation");
+      }
+      nAtomType_ = nAtomType;
+   }
+
+   /*
+   * Get maximum of pair cutoff distance, for all atom type pairs.
+   */
+   double ReactionFieldPair::maxPairCutoff() const
+   { return cutoff_; }
+
+   /*
+   * Set a potential energy parameter, identified by a string.
+   */
+   void ReactionFieldPair::set(std::string name, int i, int j, double value)
+   {
+      if (name == "charge") {
+         if (i < 0 || i >= nAtomType_) {
+            UTIL_THROW("Invalid atom type index i");
+         }
+         charges_[i] = value;
+      } else {
+         UTIL_THROW("Unrecognized parameter name");
+      }
+      setCoeffs();
+   }
+
+   /*
+   * Get a parameter value, identified by a string.
+   */
+   double ReactionFieldPair::get(std::string name, int i, int j) const
+   {
+      double value = 0.0;
+      if (name == "epsilon") {
+         value = epsilon_;
+      } else
+      if (name == "charge") {
+         value = charges_[i];
+      } else
+      if (name == "epsilonRF") {
+         value = epsilonRF_;
+      } else
+      if (name == "cutoff") {
+         value = cutoff_;
+      } else {
+         UTIL_THROW("Unrecognized parameter name");
+      }
+      return value;
+   }
+
+}
@@ -0,0 +1,306 @@
+#ifndef SIMP_REACTION_FIELD_PAIR_H
+#define SIMP_REACTION_FIELD_PAIR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <simp/interaction/pair/TypePairArray.h>
+#include <simp/interaction/pair/ForceReal.h>
+#include <util/param/ParamComposite.h>
+#include <util/containers/DArray.h>
+#include <util/global.h>
+
+#include <math.h>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Reaction field Coulomb pair interaction.
+   *
+   * Electrostatic interactions beyond the cutoff are approximated by
+   * those of a dielectric continuum, following Barker and Watts, with
+   * the cutoff sphere of permittivity epsilon and the continuum of
+   * permittivity epsilonRF*epsilon. The pair potential is
+   * q_i q_j (1/r + k r^2 - c)/(4 pi epsilon), in which k is set by
+   * epsilonRF and c is chosen so that the energy vanishes at the cutoff.
+   * It requires no k-space sum, and is evaluated as a short range pair
+   * interaction.
+   *
+   * As in DsfCoulombPair, a charge is assigned to each atom type, and
+   * the product of charges and the prefactor 1/(4 pi epsilon) for each
+   * pair of types is stored in one 8 byte record of a TypePairArray.
+   *
+   * \sa \ref simp_interaction_pair_ReactionFieldPair_page "Parameter file format"
+   * \sa \ref simp_interaction_pair_interface_page
+   * \sa \ref simp_interaction_pair_page
+   *
+   * \ingroup Simp_Interaction_Pair_Module
+   */
+   class ReactionFieldPair : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      ReactionFieldPair();
+
+      /**
+      * Copy constructor.
+      */
+      ReactionFieldPair(const ReactionFieldPair& other);
+
+      /**
+      * Assignment.
+      */
+      ReactionFieldPair& operator = (const ReactionFieldPair& other);
+
+      /// \name Mutators
+      //@{
+
+      /**
+      * Set nAtomType value.
+      *
+      * \param nAtomType number of atom types.
+      */
+      void setNAtomType(int nAtomType);
+
+      /**
+      * Read epsilon, charges, epsilonRF and cutoff.
+      *
+      * \pre nAtomType must be set, by calling setNAtomType().
+      *
+      * \param in  input stream
+      */
+      void readParameters(std::istream &in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Modify a parameter, identified by a string.
+      *
+      * Only the type dependent parameter "charge" may be modified. A
+      * new charge value applies to atom type i, and j is ignored.
+      *
+      * \param name   parameter name
+      * \param i      atom type index 1
+      * \param j      atom type index 2
+      * \param value  new value of parameter
+      */
+      void set(std::string name, int i, int j, double value);
+
+      //@}
+      /// \name Accessors (required)
+      //@{
+
+      /**
+      * Returns interaction energy for a single pair of particles.
+      *
+      * \param rsq square of distance between particles
+      * \param i   type of particle 1
+      * \param j   type of particle 2
+      * \return    pair interaction energy
+      */
+      double energy(double rsq, int i, int j) const;
+
+      /**
+      * Returns ratio of scalar pair interaction force to pair separation.
+      *
+      * Precondition: The square separation rsq must be less than cutoffSq.
+      * If rsq > cutoffSq, the return value is undefined (i.e., wrong).
+      *
+      * \param rsq square of distance between particles
+      * \param i type of particle 1
+      * \param j type of particle 2
+      * \return  force divided by distance
+      */
+      double forceOverR(double rsq, int i, int j) const;
+
+      /**
+      * Compute force/distance ratios for a block of pairs.
+      *
+      * Equivalent to setting fOverR[k] = forceOverR(rsq[k], i[k], j[k])
+      * for all 0 <= k < n. Every element must satisfy the precondition
+      * rsq[k] < cutoffSq(i[k], j[k]).
+      *
+      * \param n      number of pairs in block
+      * \param rsq    array of squared separations
+      * \param i      array of types of particle 1
+      * \param j      array of types of particle 2
+      * \param fOverR array of force divided by distance (output)
+      */
+      void forceOverR(int n, const double* rsq, const int* i, const int* j,
+                      double* fOverR) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = energy(rsq, i, j) and fOverR =
+      * forceOverR(rsq, i, j), but evaluates the square root only once.
+      * Requires rsq < cutoffSq(i, j).
+      *
+      * \param rsq    square of distance between particles
+      * \param i      type of particle 1
+      * \param j      type of particle 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j,
+                    double& energy, double& fOverR) const;
+
+      /**
+      * Get square of cutoff distance for specific type pair.
+      *
+      * \param i   type of Atom 1
+      * \param j   type of Atom 2
+      * \return    square of cutoff distance
+      */
+      double cutoffSq(int i, int j) const;
+
+      /**
+      * Get maximum of pair cutoff distance, for all atom type pairs.
+      */
+      double maxPairCutoff() const;
+
+      /**
+      * Get a parameter value, identified by a string.
+      *
+      * Names "epsilon", "epsilonRF" and "cutoff" return global parameters,
+      * and "charge" returns the charge of type i.
+      *
+      * \param name   parameter name
+      * \param i      atom type index 1
+      * \param j      atom type index 2
+      */
+      double get(std::string name, int i, int j) const;
+
+      //@}
+
+   private:
+
+      /// Charge of each atom type.
+      DArray<double> charges_;
+
+      /// Coulomb prefactor q_i q_j/(4 pi epsilon) for each type pair.
+      TypePairArray<double> ce_;
+
+      /// Dielectric permittivity.
+      double epsilon_;
+
+      /// Ratio of continuum permittivity to epsilon.
+      double epsilonRF_;
+
+      /// Cutoff distance.
+      double cutoff_;
+
+      /// Square of cutoff distance.
+      double cutoffSq_;
+
+      /// Coefficient k = (epsilonRF - 1)/((2 epsilonRF + 1) rc^3).
+      double kRF_;
+
+      /// Energy shift c = 1/rc + k rc^2.
+      double cRF_;
+
+      /// Number of possible atom types.
+      int    nAtomType_;
+
+      /// Are all parameters and pointers initialized?
+      bool  isInitialized_;
+
+      /**
+      * Allocate parameter arrays, if not already allocated.
+      */
+      void allocate();
+
+      /**
+      * Check parameters, and compute shifts and all coefficients.
+      */
+      void setCoeffs();
+
+   };
+
+   // inline methods
+
+   /*
+   * Calculate interaction energy for a pair, as function of squared distance.
+   */
+   inline double ReactionFieldPair::energy(double rsq, int i, int j) const
+   {
+      if (rsq < cutoffSq_) {
+         return ce_(i, j)*(1.0/sqrt(rsq) + kRF_*rsq - cRF_);
+      } else {
+         return 0.0;
+      }
+   }
+
+   /*
+   * Calculate force/distance for a pair as function of squared distance.
+   */
+   inline double ReactionFieldPair::forceOverR(double rsq, int i, int j) const
+   {
+      if (rsq < cutoffSq_) {
+         return ce_(i, j)*(1.0/(rsq*sqrt(rsq)) - 2.0*kRF_);
+      } else {
+         return 0.0;
+      }
+   }
+
+   /*
+   * Calculate force/distance for a block of pairs inside the cutoff.
+   */
+   inline
+   void ReactionFieldPair::forceOverR(int n, const double* rsq, const int* i,
+                                      const int* j, double* fOverR) const
+   {
+      const ForceReal one = 1.0;
+      const ForceReal twoK = 2.0*kRF_;
+      ForceReal s;
+      int k;
+      for (k = 0; k < n; ++k) {
+         s = rsq[k];
+         fOverR[k] = ForceReal(ce_(i[k], j[k]))*(one/(s*sqrt(s)) - twoK);
+      }
+   }
+
+   /*
+   * Calculate energy and force/distance for a pair inside the cutoff.
+   */
+   inline
+   void ReactionFieldPair::evaluate(double rsq, int i, int j,
+                                    double& energy, double& fOverR) const
+   {
+      double ce = ce_(i, j);
+      double rInv = 1.0/sqrt(rsq);
+      energy = ce*(rInv + kRF_*rsq - cRF_);
+      fOverR = ce*(rInv*rInv*rInv - 2.0*kRF_);
+   }
+
+   /*
+   * Return square of cutoff distance for a specific type pair.
+   */
+   inline double ReactionFieldPair::cutoffSq(int i, int j) const
+   {  return cutoffSq_; }
+
+}
+#endif
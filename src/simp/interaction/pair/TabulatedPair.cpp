@@ -0,0 +1,318 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "TabulatedPair.h"
+#include <util/misc/Log.h>
+#ifdef UTIL_MPI
+#include <util/mpi/MpiLoader.h>
+#endif
+
+#include <fstream>
+#include <vector>
+#include <cmath>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   TabulatedPair::TabulatedPair()
+    : energies_(),
+      forces_(),
+      coeffs_(),
+      filename_(),
+      maxPairCutoff_(0.0),
+      nTable_(0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  setClassName("TabulatedPair"); }
+
+   /*
+   * Copy constructor.
+   */
+   TabulatedPair::TabulatedPair(const TabulatedPair& other)
+    : energies_(),
+      forces_(),
+      coeffs_(),
+      filename_(),
+      maxPairCutoff_(0.0),
+      nTable_(0),
+      nAtomType_(0),
+      isInitialized_(false)
+   {  copy(other); }
+
+   /*
+   * Assignment operator.
+   */
+   TabulatedPair& TabulatedPair::operator = (const TabulatedPair& other)
+   {
+      copy(other);
+      return *this;
+   }
+
+   /*
+   * Copy all parameters and tables.
+   */
+   void TabulatedPair::copy(const TabulatedPair& other)
+   {
+      filename_      = other.filename_;
+      maxPairCutoff_ = other.maxPairCutoff_;
+      nTable_        = other.nTable_;
+      nAtomType_     = other.nAtomType_;
+      isInitialized_ = other.isInitialized_;
+      int i;
+      coeffs_ = other.coeffs_;
+      if (other.energies_.isAllocated()) {
+         int n = other.energies_.capacity();
+         if (!energies_.isAllocated()) {
+            energies_.allocate(n);
+            forces_.allocate(n);
+         }
+         UTIL_CHECK(energies_.capacity() == n);
+         for (i = 0; i < n; ++i) {
+            energies_[i] = other.energies_[i];
+            forces_[i] = other.forces_[i];
+         }
+      }
+   }
+
+   /*
+   * Set nAtomType
+   */
+   void TabulatedPair::setNAtomType(int nAtomType)
+   {
+      if (nAtomType <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (coeffs_.isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("nAtomType cannot be changed after allocation");
+      }
+      nAtomType_ = nAtomType;
+   }
+
+   /*
+   * Read parameters and tables.
+   */
+   void TabulatedPair::readParameters(std::istream &in)
+   {
+      // Preconditions
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType must be set before readParam");
+      }
+
+      read<std::string>(in, "filename", filename_);
+      nTable_ = 1000;
+      readOptional<int>(in, "nTable", nTable_);
+      if (nTable_ < 2) {
+         UTIL_THROW("nTable < 2");
+      }
+
+      // Allocate one table of each kind per unordered type pair
+      int nPair = nAtomType_*(nAtomType_ + 1)/2;
+      energies_.allocate(nPair*nTable_);
+      forces_.allocate(nPair*nTable_);
+      coeffs_.allocate(nAtomType_);
+
+      // Read tables for pairs (i, j) with j <= i, in lower diagonal order
+      std::ifstream file;
+      file.open(filename_.c_str());
+      if (!file.is_open()) {
+         Log::file() << "Table file name: " << filename_ << std::endl;
+         UTIL_THROW("Error opening pair table file");
+      }
+      int i, j, ti, tj, p;
+      p = 0;
+      maxPairCutoff_ = 0.0;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j <= i; ++j) {
+            file >> ti >> tj;
+            if (file.fail() || ti != i || tj != j) {
+               UTIL_THROW("Missing or misordered table in pair table file");
+            }
+            coeffs_(i, j).offset = p*nTable_;
+            readTable(file, i, j);
+            coeffs_(j, i) = coeffs_(i, j);
+            if (sqrt(coeffs_(i, j).cutoffSq) > maxPairCutoff_) {
+               maxPairCutoff_ = sqrt(coeffs_(i, j).cutoffSq);
+            }
+            ++p;
+         }
+      }
+      file.close();
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Read one table, and interpolate it onto a uniform grid in rsq.
+   */
+   void TabulatedPair::readTable(std::istream& in, int i, int j)
+   {
+      int nPoint;
+      in >> nPoint;
+      if (in.fail() || nPoint < 2) {
+         UTIL_THROW("Invalid number of points in pair table");
+      }
+      std::vector<double> r(nPoint);
+      std::vector<double> v(nPoint);
+      std::vector<double> f(nPoint);
+      int k;
+      for (k = 0; k < nPoint; ++k) {
+         in >> r[k] >> v[k] >> f[k];
+         if (in.fail()) {
+            UTIL_THROW("Error reading pair table");
+         }
+         if (k == 0 && r[k] <= 0.0) {
+            UTIL_THROW("Nonpositive separation in pair table");
+         }
+         if (k > 0 && r[k] <= r[k-1]) {
+            UTIL_THROW("Separations in pair table are not increasing");
+         }
+      }
+
+      double rsqMin = r[0]*r[0];
+      double cutoffSq = r[nPoint-1]*r[nPoint-1];
+      double dRsq = (cutoffSq - rsqMin)/double(nTable_ - 1);
+      Coeff& c = coeffs_(i, j);
+      c.rsqMin = rsqMin;
+      c.cutoffSq = cutoffSq;
+      c.rsqScale = 1.0/dRsq;
+
+      // Cubic Hermite interpolation in r, with slopes dV/dr = -F
+      double* energies = &energies_[c.offset];
+      double* forces = &forces_[c.offset];
+      double rk, h, t, t2, t3, dVdr;
+      int m = 0;
+      for (k = 0; k < nTable_; ++k) {
+         rk = sqrt(rsqMin + k*dRsq);
+         while (m < nPoint - 2 && rk > r[m+1]) {
+            ++m;
+         }
+         h = r[m+1] - r[m];
+         t = (rk - r[m])/h;
+         if (t > 1.0) t = 1.0;
+         t2 = t*t;
+         t3 = t2*t;
+         energies[k] = (2.0*t3 - 3.0*t2 + 1.0)*v[m]
+                     - (t3 - 2.0*t2 + t)*h*f[m]
+                     + (-2.0*t3 + 3.0*t2)*v[m+1]
+                     - (t3 - t2)*h*f[m+1];
+         dVdr = 6.0*(t2 - t)*(v[m] - v[m+1])/h
+              - (3.0*t2 - 4.0*t + 1.0)*f[m]
+              - (3.0*t2 - 2.0*t)*f[m+1];
+         forces[k] = -dVdr/rk;
+      }
+   }
+
+   /*
+   * Load internal state from an archive.
+   */
+   void TabulatedPair::loadParameters(Serializable::IArchive &ar)
+   {
+      // Precondition
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType must be set before loadParameters");
+      }
+
+      loadParameter<std::string>(ar, "filename", filename_);
+      nTable_ = 1000;
+      loadParameter<int>(ar, "nTable", nTable_, false);
+      int nPair = nAtomType_*(nAtomType_ + 1)/2;
+      if (!energies_.isAllocated()) {
+         energies_.allocate(nPair*nTable_);
+         forces_.allocate(nPair*nTable_);
+      }
+      UTIL_CHECK(energies_.capacity() == nPair*nTable_);
+      coeffs_.allocate(nAtomType_);
+
+      int i, j;
+      #ifdef UTIL_MPI
+      MpiLoader<Serializable::IArchive> loader(*this, ar);
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            Coeff& c = coeffs_(i, j);
+            loader.load(c.cutoffSq);
+            loader.load(c.rsqMin);
+            loader.load(c.rsqScale);
+            loader.load(c.offset);
+         }
+      }
+      loader.load(maxPairCutoff_);
+      loader.load(energies_, nPair*nTable_);
+      loader.load(forces_, nPair*nTable_);
+      #else
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            Coeff& c = coeffs_(i, j);
+            ar >> c.cutoffSq;
+            ar >> c.rsqMin;
+            ar >> c.rsqScale;
+            ar >> c.offset;
+         }
+      }
+      ar >> maxPairCutoff_;
+      ar >> energies_;
+      ar >> forces_;
+      #endif
+      isInitialized_ = true;
+   }
+
+   /*
+   * Save internal state to an archive.
+   */
+   void TabulatedPair::save(Serializable::OArchive &ar)
+   {
+      ar << filename_;
+      Parameter::saveOptional(ar, nTable_, true);
+      int i, j;
+      for (i = 0; i < nAtomType_; ++i) {
+         for (j = 0; j < nAtomType_; ++j) {
+            const Coeff& c = coeffs_(i, j);
+            ar << c.cutoffSq;
+            ar << c.rsqMin;
+            ar << c.rsqScale;
+            ar << c.offset;
+         }
+      }
+      ar << maxPairCutoff_;
+      ar << energies_;
+      ar << forces_;
+   }
+
+   /*
+   * Get maximum of pair cutoff distance, for all atom type pairs.
+   */
+   double TabulatedPair::maxPairCutoff() const
+   {  return maxPairCutoff_; }
+
+   /*
+   * Tabulated potentials have no modifiable parameters.
+   */
+   void TabulatedPair::set(std::string name, int i, int j, double value)
+   {  UTIL_THROW("Unrecognized parameter name"); }
+
+   /*
+   * Get a parameter value, identified by a string.
+   */
+   double TabulatedPair::get(std::string name, int i, int j) const
+   {
+      double value = 0.0;
+      if (name == "cutoff") {
+         value = sqrt(coeffs_(i, j).cutoffSq);
+      } else
+      if (name == "rMin") {
+         value = sqrt(coeffs_(i, j).rsqMin);
+      } else {
+         UTIL_THROW("Unrecognized parameter name");
+      }
+      return value;
+   }
+
+}
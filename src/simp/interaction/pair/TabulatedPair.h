@@ -0,0 +1,339 @@
+#ifndef SIMP_TABULATED_PAIR_H
+#define SIMP_TABULATED_PAIR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/param/ParamComposite.h>
+#include <util/containers/DArray.h>
+#include <simp/interaction/pair/TypePairArray.h>
+#include <util/global.h>
+
+#include <string>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * A pair interaction defined by tables of energy and force values.
+   *
+   * The potential for each pair of atom types is read from a table file
+   * of values of separation r, energy V(r) and force F(r) = -dV/dr, such
+   * as those produced by iterative Boltzmann inversion. The last value
+   * of r in each table is the cutoff for that pair. When parameters are
+   * read, the tabulated data are interpolated with cubic Hermite splines
+   * in r onto a uniform grid of nTable values of r*r. The energy and
+   * force/distance are then evaluated during a simulation by linear
+   * interpolation in r*r, without a square root. Values for separations
+   * less than the first tabulated r are linearly extrapolated.
+   *
+   * All tables are stored in one array, and the index arithmetic used
+   * for a lookup contains no branches, so that the block forceOverR()
+   * function can be vectorized.
+   *
+   * \sa \ref simp_interaction_pair_TabulatedPair_page "Parameter file format"
+   * \sa \ref simp_interaction_pair_interface_page
+   * \sa \ref simp_interaction_pair_page
+   *
+   * \ingroup Simp_Interaction_Pair_Module
+   */
+   class TabulatedPair : public ParamComposite
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      TabulatedPair();
+
+      /**
+      * Copy constructor.
+      */
+      TabulatedPair(const TabulatedPair& other);
+
+      /**
+      * Assignment.
+      */
+      TabulatedPair& operator = (const TabulatedPair& other);
+
+      /// \name Mutators
+      //@{
+
+      /**
+      * Set nAtomType value.
+      *
+      * \param nAtomType number of atom types.
+      */
+      void setNAtomType(int nAtomType);
+
+      /**
+      * Read file name and table size, read and interpolate tables.
+      *
+      * \pre nAtomType must be set, by calling setNAtomType().
+      *
+      * \param in  input stream
+      */
+      void readParameters(std::istream &in);
+
+      /**
+      * Load internal state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadParameters(Serializable::IArchive &ar);
+
+      /**
+      * Save internal state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void save(Serializable::OArchive &ar);
+
+      /**
+      * Modify a parameter, identified by a string.
+      *
+      * No parameters of a tabulated potential may be modified, and so
+      * this function always throws an Exception.
+      *
+      * \param name   parameter name
+      * \param i      atom type index 1
+      * \param j      atom type index 2
+      * \param value  new value of parameter
+      */
+      void set(std::string name, int i, int j, double value);
+
+      //@}
+      /// \name Accessors (required)
+      //@{
+
+      /**
+      * Returns interaction energy for a single pair of particles.
+      *
+      * \param rsq square of distance between particles
+      * \param i   type of particle 1
+      * \param j   type of particle 2
+      * \return    pair interaction energy
+      */
+      double energy(double rsq, int i, int j) const;
+
+      /**
+      * Returns ratio of scalar pair interaction force to pair separation.
+      *
+      * Precondition: The square separation rsq must be less than cutoffSq.
+      *
+      * \param rsq square of distance between particles
+      * \param i type of particle 1
+      * \param j type of particle 2
+      * \return  force divided by distance
+      */
+      double forceOverR(double rsq, int i, int j) const;
+
+      /**
+      * Compute force/distance ratios for a block of pairs.
+      *
+      * Equivalent to setting fOverR[k] = forceOverR(rsq[k], i[k], j[k])
+      * for all 0 <= k < n. Every element must satisfy the precondition
+      * rsq[k] < cutoffSq(i[k], j[k]).
+      *
+      * \param n      number of pairs in block
+      * \param rsq    array of squared separations
+      * \param i      array of types of particle 1
+      * \param j      array of types of particle 2
+      * \param fOverR array of force divided by distance (output)
+      */
+      void forceOverR(int n, const double* rsq, const int* i, const int* j,
+                      double* fOverR) const;
+
+      /**
+      * Compute energy and force/distance for a single pair.
+      *
+      * Equivalent to setting energy = energy(rsq, i, j) and fOverR =
+      * forceOverR(rsq, i, j), but shares intermediate results. The
+      * precondition of forceOverR applies: rsq must be less than
+      * cutoffSq(i, j).
+      *
+      * \param rsq    square of distance between particles
+      * \param i      type of particle 1
+      * \param j      type of particle 2
+      * \param energy pair interaction energy (output)
+      * \param fOverR force divided by distance (output)
+      */
+      void evaluate(double rsq, int i, int j, 
+                    double& energy, double& fOverR) const;
+
+      /**
+      * Get square of cutoff distance for specific type pair.
+      *
+      * \param i   type of Atom 1
+      * \param j   type of Atom 2
+      * \return    square of cutoff distance
+      */
+      double cutoffSq(int i, int j) const;
+
+      /**
+      * Get maximum of pair cutoff distance, for all atom type pairs.
+      */
+      double maxPairCutoff() const;
+
+      /**
+      * Get a parameter value, identified by a string.
+      *
+      * Recognized names are "cutoff" and "rMin", the first tabulated
+      * separation.
+      *
+      * \param name   parameter name
+      * \param i      atom type index 1
+      * \param j      atom type index 2
+      */
+      double get(std::string name, int i, int j) const;
+
+      //@}
+
+   private:
+
+      /// Tabulated energies, for all type pairs.
+      DArray<double> energies_;
+
+      /// Tabulated force/distance ratios, for all type pairs.
+      DArray<double> forces_;
+
+      /**
+      * Grid parameters for one type pair (32 bytes).
+      */
+      struct Coeff {
+         double cutoffSq;  ///< square of cutoff
+         double rsqMin;    ///< first grid rsq
+         double rsqScale;  ///< inverse grid step
+         int    offset;    ///< index of first value
+         int    pad;       ///< unused
+      };
+
+      /// Grid parameters for all type pairs.
+      TypePairArray<Coeff> coeffs_;
+
+      /// Name of file containing tabulated potentials.
+      std::string filename_;
+
+      /// Maximum pair potential cutoff radius, for all type pairs.
+      double maxPairCutoff_;
+
+      /// Number of grid values of rsq per type pair.
+      int nTable_;
+
+      /// Number of possible atom types.
+      int nAtomType_;
+
+      /// Are all parameters and pointers initialized?
+      bool isInitialized_;
+
+      /**
+      * Read one table from file, interpolate onto the rsq grid.
+      *
+      * \param in  table file
+      * \param i   type of particle 1
+      * \param j   type of particle 2
+      */
+      void readTable(std::istream& in, int i, int j);
+
+      /**
+      * Copy all tables and parameters from another object.
+      */
+      void copy(const TabulatedPair& other);
+
+      /**
+      * Interpolate a table linearly in rsq.
+      *
+      * \param table array of tabulated values
+      * \param rsq   square of distance between particles
+      * \param i     type of particle 1
+      * \param j     type of particle 2
+      */
+      double interpolate(const double* table, double rsq, int i, int j)
+      const;
+
+   };
+
+   // inline methods
+
+   /*
+   * Linear interpolation in rsq, with extrapolation below the grid.
+   */
+   inline
+   double TabulatedPair::interpolate(const double* table, double rsq,
+                                     int i, int j) const
+   {
+      const Coeff& c = coeffs_(i, j);
+      double x = (rsq - c.rsqMin)*c.rsqScale;
+      int k = int(x);
+      k = (k < 0) ? 0 : k;
+      k = (k > nTable_ - 2) ? nTable_ - 2 : k;
+      x -= double(k);
+      const double* t = table + c.offset + k;
+      return t[0] + x*(t[1] - t[0]);
+   }
+
+   /*
+   * Calculate interaction energy for a pair, as function of squared distance.
+   */
+   inline double TabulatedPair::energy(double rsq, int i, int j) const
+   {
+      if (rsq < coeffs_(i, j).cutoffSq) {
+         return interpolate(&energies_[0], rsq, i, j);
+      } else {
+         return 0.0;
+      }
+   }
+
+   /*
+   * Calculate force/distance for a pair as function of squared distance.
+   */
+   inline double TabulatedPair::forceOverR(double rsq, int i, int j) const
+   {  return interpolate(&forces_[0], rsq, i, j); }
+
+   /*
+   * Calculate force/distance for a block of pairs inside the cutoff.
+   */
+   inline
+   void TabulatedPair::forceOverR(int n, const double* rsq, const int* i,
+                                  const int* j, double* fOverR) const
+   {
+      const double* table = &forces_[0];
+      for (int k = 0; k < n; ++k) {
+         fOverR[k] = interpolate(table, rsq[k], i[k], j[k]);
+      }
+   }
+
+   /*
+   * Calculate energy and force/distance for a pair inside the cutoff.
+   */
+   inline
+   void TabulatedPair::evaluate(double rsq, int i, int j,
+                                double& energy, double& fOverR) const
+   {
+      const Coeff& c = coeffs_(i, j);
+      double x = (rsq - c.rsqMin)*c.rsqScale;
+      int k = int(x);
+      k = (k < 0) ? 0 : k;
+      k = (k > nTable_ - 2) ? nTable_ - 2 : k;
+      x -= double(k);
+      const double* e = &energies_[c.offset + k];
+      const double* f = &forces_[c.offset + k];
+      energy = e[0] + x*(e[1] - e[0]);
+      fOverR = f[0] + x*(f[1] - f[0]);
+   }
+
+   /*
+   * Return square of cutoff distance for specific type pair.
+   */
+   inline double TabulatedPair::cutoffSq(int i, int j) const
+   {  return coeffs_(i, j).cutoffSq; }
+
+}
+#endif
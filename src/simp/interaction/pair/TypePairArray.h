@@ -0,0 +1,218 @@
+#ifndef SIMP_TYPE_PAIR_ARRAY_H
+#define SIMP_TYPE_PAIR_ARRAY_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>
+#include <util/global.h>
+
+#include <cstring>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Cache-aligned square array of per-type-pair coefficient records.
+   *
+   * A TypePairArray<Data> stores one Data record for each ordered pair
+   * (i, j) of atom types, with 0 <= i, j < nAtomType, in row major order.
+   * The number of atom types is set at run time by allocate(). The first
+   * record is aligned to a 64 byte cache line boundary, so that a record
+   * type Data whose size divides 64 bytes never straddles two cache lines.
+   * Pair interaction classes use this to pack all of the coefficients
+   * needed to evaluate one pair into a single record.
+   *
+   * Data must be a plain struct of numbers, which is copied bytewise.
+   *
+   * \ingroup Simp_Interaction_Pair_Module
+   */
+   template <typename Data>
+   class TypePairArray
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      TypePairArray();
+
+      /**
+      * Copy constructor.
+      *
+      * \param other TypePairArray to be copied
+      */
+      TypePairArray(const TypePairArray<Data>& other);
+
+      /**
+      * Assignment.
+      *
+      * \param other TypePairArray to be assigned
+      */
+      TypePairArray<Data>& operator = (const TypePairArray<Data>& other);
+
+      /**
+      * Allocate memory for nAtomType*nAtomType records.
+      *
+      * Records are zero initialized. If already allocated with the same
+      * number of types, this only zeros the records.
+      *
+      * \param nAtomType number of atom types
+      */
+      void allocate(int nAtomType);
+
+      /**
+      * Free memory, if allocated.
+      */
+      void deallocate();
+
+      /**
+      * Get the record for a pair of types.
+      *
+      * \param i type of atom 1
+      * \param j type of atom 2
+      */
+      Data& operator () (int i, int j);
+
+      /**
+      * Get the record for a pair of types (const).
+      *
+      * \param i type of atom 1
+      * \param j type of atom 2
+      */
+      const Data& operator () (int i, int j) const;
+
+      /**
+      * Get number of atom types.
+      */
+      int nAtomType() const;
+
+      /**
+      * Has memory been allocated?
+      */
+      bool isAllocated() const;
+
+   private:
+
+      /// Cache line size assumed for alignment, in bytes.
+      static const int Alignment = 64;
+
+      /// Raw storage, with room for alignment.
+      DArray<char> buffer_;
+
+      /// Pointer to aligned first record.
+      Data* data_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+   };
+
+   // Inline methods
+
+   template <typename Data>
+   inline Data& TypePairArray<Data>::operator () (int i, int j)
+   {
+      assert(i >= 0 && i < nAtomType_);
+      assert(j >= 0 && j < nAtomType_);
+      return data_[i*nAtomType_ + j];
+   }
+
+   template <typename Data>
+   inline const Data& TypePairArray<Data>::operator () (int i, int j) const
+   {
+      assert(i >= 0 && i < nAtomType_);
+      assert(j >= 0 && j < nAtomType_);
+      return data_[i*nAtomType_ + j];
+   }
+
+   template <typename Data>
+   inline int TypePairArray<Data>::nAtomType() const
+   {  return nAtomType_; }
+
+   template <typename Data>
+   inline bool TypePairArray<Data>::isAllocated() const
+   {  return (data_ != 0); }
+
+   // Non-inline methods
+
+   /*
+   * Constructor.
+   */
+   template <typename Data>
+   TypePairArray<Data>::TypePairArray()
+    : buffer_(),
+      data_(0),
+      nAtomType_(0)
+   {}
+
+   /*
+   * Copy constructor.
+   */
+   template <typename Data>
+   TypePairArray<Data>::TypePairArray(const TypePairArray<Data>& other)
+    : buffer_(),
+      data_(0),
+      nAtomType_(0)
+   {  *this = other; }
+
+   /*
+   * Assignment.
+   */
+   template <typename Data>
+   TypePairArray<Data>&
+   TypePairArray<Data>::operator = (const TypePairArray<Data>& other)
+   {
+      if (this == &other) return *this;
+      if (other.isAllocated()) {
+         allocate(other.nAtomType_);
+         memcpy(data_, other.data_, nAtomType_*nAtomType_*sizeof(Data));
+      }
+      return *this;
+   }
+
+   /*
+   * Allocate and zero records.
+   */
+   template <typename Data>
+   void TypePairArray<Data>::allocate(int nAtomType)
+   {
+      if (nAtomType <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (isAllocated() && nAtomType != nAtomType_) {
+         UTIL_THROW("TypePairArray already allocated with different size");
+      }
+      int size = nAtomType*nAtomType*sizeof(Data);
+      if (!isAllocated()) {
+         buffer_.allocate(size + Alignment);
+         size_t address = (size_t)(&buffer_[0]);
+         size_t shift = (Alignment - address % Alignment) % Alignment;
+         data_ = (Data*)(&buffer_[0] + shift);
+         nAtomType_ = nAtomType;
+      }
+      memset(data_, 0, size);
+   }
+
+   /*
+   * Free memory.
+   */
+   template <typename Data>
+   void TypePairArray<Data>::deallocate()
+   {
+      if (buffer_.isAllocated()) {
+         buffer_.deallocate();
+      }
+      data_ = 0;
+      nAtomType_ = 0;
+   }
+
+}
+#endif
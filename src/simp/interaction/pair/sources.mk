@@ -1,6 +1,9 @@
 simp_interaction_pair_=\
     simp/interaction/pair/DpdPair.cpp \
+    simp/interaction/pair/DsfCoulombPair.cpp \
     simp/interaction/pair/LJPair.cpp \
+    simp/interaction/pair/ReactionFieldPair.cpp \
+    simp/interaction/pair/TabulatedPair.cpp \
     simp/interaction/pair/WcaPair.cpp 
 
 simp_interaction_pair_SRCS=\
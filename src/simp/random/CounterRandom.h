@@ -0,0 +1,197 @@
+#ifndef SIMP_COUNTER_RANDOM_H
+#define SIMP_COUNTER_RANDOM_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <stdint.h>
+#include <cmath>
+
+namespace Simp
+{
+
+   /**
+   * Counter-based (stateless) random number generator.
+   *
+   * CounterRandom implements the Philox4x32-10 generator of Salmon et al.
+   * (Proc. SC11, 2011). Each call maps a 128 bit counter, given as four
+   * 32 bit words, and a 64 bit key, set by the seed and stream index, to
+   * four independent 32 bit random integers. The output depends only on
+   * the counter and key, so a random number may be attached to a label 
+   * such as (atom id, step index) rather than to the order in which it is
+   * drawn. Results are then independent of domain decomposition and of
+   * loop order, and calls from different threads or iterations of a 
+   * vectorized loop share no mutable state.
+   *
+   * The stream index should be used to give different uses of the same
+   * seed (e.g., different thermostats) statistically independent output.
+   *
+   * \ingroup Simp_Random_Module
+   */
+   class CounterRandom
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param seed   random number seed (first key word)
+      * \param stream stream index (second key word)
+      */
+      CounterRandom(uint32_t seed = 0, uint32_t stream = 0)
+      {  setSeed(seed, stream); }
+
+      /**
+      * Set seed and stream index.
+      *
+      * \param seed   random number seed (first key word)
+      * \param stream stream index (second key word)
+      */
+      void setSeed(uint32_t seed, uint32_t stream = 0)
+      {
+         key_[0] = seed;
+         key_[1] = stream;
+      }
+
+      /**
+      * Generate four random 32 bit integers for one counter value.
+      *
+      * \param c0  counter word 0
+      * \param c1  counter word 1
+      * \param c2  counter word 2
+      * \param c3  counter word 3
+      * \param out array of 4 random integers (output)
+      */
+      void generate(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                    uint32_t* out) const;
+
+      /**
+      * Generate four uniform random numbers in the open interval (0,1).
+      *
+      * \param c0  counter word 0
+      * \param c1  counter word 1
+      * \param c2  counter word 2
+      * \param c3  counter word 3
+      * \param out array of 4 random numbers (output)
+      */
+      void uniform(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                   double* out) const;
+
+      /**
+      * Generate four Gaussian random numbers with zero mean, unit variance.
+      *
+      * Uses the Box-Muller transform of two pairs of uniform numbers.
+      *
+      * \param c0  counter word 0
+      * \param c1  counter word 1
+      * \param c2  counter word 2
+      * \param c3  counter word 3
+      * \param out array of 4 random numbers (output)
+      */
+      void gaussian(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                    double* out) const;
+
+      /**
+      * Get seed (first key word).
+      */
+      uint32_t seed() const
+      {  return key_[0]; }
+
+      /**
+      * Get stream index (second key word).
+      */
+      uint32_t stream() const
+      {  return key_[1]; }
+
+      /**
+      * Convert a random 32 bit integer to a double in (0,1).
+      *
+      * \param x random integer
+      */
+      static double toUniform(uint32_t x)
+      {  return (double(x) + 0.5)*2.3283064365386963E-10; }
+
+   private:
+
+      /// Key words: seed and stream index.
+      uint32_t key_[2];
+
+   };
+
+   // Inline methods
+
+   /*
+   * Ten Philox4x32 rounds.
+   */
+   inline
+   void CounterRandom::generate(uint32_t c0, uint32_t c1, 
+                                uint32_t c2, uint32_t c3,
+                                uint32_t* out) const
+   {
+      const uint32_t M0 = 0xD2511F53u;
+      const uint32_t M1 = 0xCD9E8D57u;
+      const uint32_t W0 = 0x9E3779B9u;
+      const uint32_t W1 = 0xBB67AE85u;
+      uint32_t k0 = key_[0];
+      uint32_t k1 = key_[1];
+      uint64_t p0, p1;
+      for (int i = 0; i < 10; ++i) {
+         if (i > 0) {
+            k0 += W0;
+            k1 += W1;
+         }
+         p0 = uint64_t(M0)*c0;
+         p1 = uint64_t(M1)*c2;
+         c0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+         c2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+         c1 = uint32_t(p1);
+         c3 = uint32_t(p0);
+      }
+      out[0] = c0;
+      out[1] = c1;
+      out[2] = c2;
+      out[3] = c3;
+   }
+
+   /*
+   * Four uniform random numbers in (0,1).
+   */
+   inline
+   void CounterRandom::uniform(uint32_t c0, uint32_t c1, 
+                               uint32_t c2, uint32_t c3,
+                               double* out) const
+   {
+      uint32_t r[4];
+      generate(c0, c1, c2, c3, r);
+      for (int i = 0; i < 4; ++i) {
+         out[i] = toUniform(r[i]);
+      }
+   }
+
+   /*
+   * Four Gaussian random numbers, by Box-Muller.
+   */
+   inline
+   void CounterRandom::gaussian(uint32_t c0, uint32_t c1, 
+                                uint32_t c2, uint32_t c3,
+                                double* out) const
+   {
+      const double twoPi = 6.283185307179586;
+      double u[4];
+      double r, theta;
+      uniform(c0, c1, c2, c3, u);
+      for (int i = 0; i < 4; i += 2) {
+         r = sqrt(-2.0*log(u[i]));
+         theta = twoPi*u[i+1];
+         out[i] = r*cos(theta);
+         out[i+1] = r*sin(theta);
+      }
+   }
+
+}
+#endif
@@ -0,0 +1,10 @@
+namespace Simp {
+
+   /**
+   * \defgroup Simp_Random_Module Random
+   * \ingroup Simp_Module
+   *
+   * Counter-based random number generators.
+   */
+
+}
@@ -10,6 +10,9 @@
 
 #include "interaction/InteractionTestComposite.h"
 #include "species/SpeciesTestComposite.h"
+#include "trajectory/CompactTrajectoryTest.h"
+#include "random/CounterRandomTest.h"
+#include "threads/ThreadPoolTest.h"
 #include <test/CompositeTestRunner.h>
 
 using namespace Simp;
@@ -17,6 +20,9 @@ using namespace Simp;
 TEST_COMPOSITE_BEGIN(SimpNsTestComposite)
 addChild(new InteractionTestComposite, "interaction/");
 addChild(new SpeciesTestComposite, "species/");
+addChild(new TEST_RUNNER(CompactTrajectoryTest), "trajectory/");
+addChild(new TEST_RUNNER(CounterRandomTest), "random/");
+addChild(new TEST_RUNNER(ThreadPoolTest), "threads/");
 TEST_COMPOSITE_END
 
 
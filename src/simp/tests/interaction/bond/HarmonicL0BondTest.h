@@ -2,6 +2,7 @@
 #define HARMONIC_L0_BOND_TEST_H
 
 #include <simp/interaction/bond/HarmonicL0Bond.h>
+#include <simp/interaction/bond/BondLengthTable.h>
 #include <simp/tests/interaction/bond/BondTestTemplate.h>
 
 #include <iostream>
@@ -135,6 +136,32 @@ public:
                       clone.forceOverR(0.95, 0) ));
    }
 
+   void testBondLengthTable()
+   {
+      printMethod(TEST_FUNC);
+
+      // Mean-square length <r^2> = 3/(beta*kappa), kappa = 8
+      BondLengthTable table;
+      table.build(interaction_, 0, 1.0);
+      TEST_ASSERT(table.isBuilt());
+      TEST_ASSERT(eq(table.beta(), 1.0));
+      TEST_ASSERT(eq(table.length(0.0), table.rMin()));
+      TEST_ASSERT(eq(table.length(1.0), table.rMax()));
+
+      int n = 100000;
+      double r, sum = 0.0;
+      for (int i = 0; i < n; ++i) {
+         r = table.length((double(i) + 0.5)/double(n));
+         sum += r*r;
+      }
+      sum /= double(n);
+      if (verbose() > 0) {
+         std::cout << std::endl;
+         std::cout << "<r^2> = " << sum << std::endl;
+      }
+      TEST_ASSERT(std::abs(sum - 0.375) < 1.0E-3);
+   }
+
    void testRandomBondLength() 
    {
       int    type, i;
@@ -165,6 +192,7 @@ TEST_ADD(HarmonicL0BondTest, testEnergy)
 TEST_ADD(HarmonicL0BondTest, testForceOverR)
 TEST_ADD(HarmonicL0BondTest, testGetSet)
 TEST_ADD(HarmonicL0BondTest, testSaveLoad)
+TEST_ADD(HarmonicL0BondTest, testBondLengthTable)
 //TEST_ADD(HarmonicL0BondTest, testRandomBondLength)
 TEST_END(HarmonicL0BondTest)
 
@@ -0,0 +1,111 @@
+#ifndef COMPOSITE_PAIR_TEST_H
+#define COMPOSITE_PAIR_TEST_H
+
+#include <simp/interaction/pair/CompositePair.h>
+#include <simp/interaction/pair/LJPair.h>
+#include <simp/interaction/pair/DpdPair.h>
+#include <simp/tests/interaction/pair/PairTestTemplate.h>
+
+#include <iostream>
+#include <fstream>
+
+using namespace Util;
+using namespace Simp;
+
+class CompositePairTest 
+ : public PairTestTemplate< CompositePair<LJPair, DpdPair> >
+{
+
+private:
+
+   typedef CompositePair<LJPair, DpdPair> Composite;
+
+   LJPair  lj_;
+   DpdPair dpd_;
+
+protected:
+
+   using PairTestTemplate<Composite>::setNAtomType;
+   using PairTestTemplate<Composite>::readParamFile;
+
+public:
+
+   void setUp()
+   {
+      eps_ = 1.0E-6;
+      setNAtomType(2);
+      readParamFile("in/CompositePair");
+
+      // Separate components, with the same parameters
+      std::ifstream in;
+      lj_.setNAtomType(2);
+      openInputFile("in/LJPair", in);
+      lj_.readParameters(in);
+      in.close();
+      dpd_.setNAtomType(2);
+      openInputFile("in/DpdPair", in);
+      dpd_.readParameters(in);
+      in.close();
+   }
+
+   void testSetUp() 
+   {
+      printMethod(TEST_FUNC);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         interaction_.writeParam(std::cout);
+      }
+      TEST_ASSERT(interaction_.className() == "CompositePair<LJPair,DpdPair>");
+      TEST_ASSERT(eq(interaction_.maxPairCutoff(), lj_.maxPairCutoff()));
+      TEST_ASSERT(eq(interaction_.cutoffSq(0, 1), lj_.cutoffSq(0, 1)));
+   }
+
+   void testSum() 
+   {
+      printMethod(TEST_FUNC);
+
+      // Both components act for rsq < 1.0, only LJPair for rsq > 1.0
+      const int n = 4;
+      double rsq[n] = {0.81, 0.95, 1.1, 1.2};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double e, f, fb[n], ref;
+      int k;
+
+      for (k = 0; k < n; ++k) {
+         ref = lj_.energy(rsq[k], i[k], j[k]) 
+             + dpd_.energy(rsq[k], i[k], j[k]);
+         TEST_ASSERT(eq(interaction_.energy(rsq[k], i[k], j[k]), ref));
+         ref = lj_.forceOverR(rsq[k], i[k], j[k]) 
+             + dpd_.forceOverR(rsq[k], i[k], j[k]);
+         TEST_ASSERT(eq(interaction_.forceOverR(rsq[k], i[k], j[k]), ref));
+         interaction_.evaluate(rsq[k], i[k], j[k], e, f);
+         TEST_ASSERT(eq(e, interaction_.energy(rsq[k], i[k], j[k])));
+         TEST_ASSERT(eq(f, interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+
+      interaction_.forceOverR(n, rsq, i, j, fb);
+      for (k = 0; k < n; ++k) {
+         TEST_ASSERT(eq(fb[k], interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+   }
+
+   void testGetSet() 
+   {
+      printMethod(TEST_FUNC);
+      TEST_ASSERT(eq(interaction_.get("LJPair.epsilon", 0, 1), 2.0));
+      TEST_ASSERT(eq(interaction_.get("DpdPair.sigma", 1, 1), 1.0));
+      interaction_.set("DpdPair.epsilon", 0, 1, 3.0);
+      TEST_ASSERT(eq(interaction_.get("DpdPair.epsilon", 1, 0), 3.0));
+      TEST_ASSERT(eq(interaction_.get("LJPair.epsilon", 1, 0), 2.0));
+   }
+
+};
+
+TEST_BEGIN(CompositePairTest)
+TEST_ADD(CompositePairTest, testSetUp)
+TEST_ADD(CompositePairTest, testSum)
+TEST_ADD(CompositePairTest, testGetSet)
+TEST_END(CompositePairTest)
+
+#endif
@@ -105,6 +105,46 @@ public:
       //Note: Do not test beyond cutoff: result is undefined.
    }
 
+   void testForceOverRBlock() 
+   {
+      printMethod(TEST_FUNC);
+
+      // All separations are inside the cutoff (block precondition)
+      const int n = 4;
+      double rsq[n] = {0.25, 0.64, 0.81, 0.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double f[n];
+
+      interaction_.forceOverR(n, rsq, i, j, f);
+      for (int k = 0; k < n; ++k) {
+         #ifdef SIMP_FLOAT_FORCE
+         double g = interaction_.forceOverR(rsq[k], i[k], j[k]);
+         TEST_ASSERT(fabs(f[k] - g) < 1.0E-5*(fabs(g) + 1.0));
+         #else
+         TEST_ASSERT(eq(f[k], interaction_.forceOverR(rsq[k], i[k], j[k])));
+         #endif
+      }
+   }
+
+   void testEvaluate() 
+   {
+      printMethod(TEST_FUNC);
+
+      // All separations are inside the cutoff (evaluate precondition)
+      const int n = 4;
+      double rsq[n] = {0.25, 0.64, 0.81, 0.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double e, f;
+
+      for (int k = 0; k < n; ++k) {
+         interaction_.evaluate(rsq[k], i[k], j[k], e, f);
+         TEST_ASSERT(eq(e, interaction_.energy(rsq[k], i[k], j[k])));
+         TEST_ASSERT(eq(f, interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+   }
+
    void testGetSet() {
       printMethod(TEST_FUNC);
 
@@ -234,6 +274,8 @@ TEST_BEGIN(DpdPairTest)
 TEST_ADD(DpdPairTest, testSetUp)
 TEST_ADD(DpdPairTest, testEnergy)
 TEST_ADD(DpdPairTest, testForceOverR)
+TEST_ADD(DpdPairTest, testForceOverRBlock)
+TEST_ADD(DpdPairTest, testEvaluate)
 TEST_ADD(DpdPairTest, testGetSet)
 TEST_ADD(DpdPairTest, testModify)
 TEST_ADD(DpdPairTest, testSaveLoad)
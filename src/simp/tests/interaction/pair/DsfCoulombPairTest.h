@@ -0,0 +1,182 @@
+#ifndef DSF_COULOMB_PAIR_TEST_H
+#define DSF_COULOMB_PAIR_TEST_H
+
+#include <simp/interaction/pair/DsfCoulombPair.h>
+#include <simp/tests/interaction/pair/PairTestTemplate.h>
+
+#include <iostream>
+#include <fstream>
+
+using namespace Util;
+using namespace Simp;
+
+class DsfCoulombPairTest : public PairTestTemplate<DsfCoulombPair>
+{
+
+protected:
+
+   using PairTestTemplate<DsfCoulombPair>::setNAtomType;
+   using PairTestTemplate<DsfCoulombPair>::readParamFile;
+   using PairTestTemplate<DsfCoulombPair>::forceOverR;
+   using PairTestTemplate<DsfCoulombPair>::energy;
+
+public:
+
+   void setUp()
+   {
+      eps_ = 1.0E-6;
+      setNAtomType(2);
+      readParamFile("in/DsfCoulombPair");
+      // setVerbose(1);
+   }
+
+   void testSetUp() 
+   {
+      printMethod(TEST_FUNC);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         interaction_.writeParam(std::cout);
+      }
+   }
+
+   void testEnergy() 
+   {
+      printMethod(TEST_FUNC);
+      double e;
+
+      // Like charges repel, unlike charges attract
+      e = energy(1.0, 0, 0);
+      TEST_ASSERT(e > 0.0);
+      TEST_ASSERT(eq(e, energy(1.0, 1, 1)));
+      TEST_ASSERT(eq(energy(1.0, 0, 1), -e));
+
+      // Energy vanishes continuously at the cutoff
+      e = energy(8.9999, 0, 1);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         std::cout << "energy(8.9999, 0, 1) = " << e << std::endl;
+      }
+      TEST_ASSERT(fabs(e) < 1.0E-8);
+      TEST_ASSERT(eq(energy(9.5, 0, 1), 0.0));
+   }
+
+   void testForceOverR() 
+   {
+      printMethod(TEST_FUNC);
+      double f;
+
+      type1_ = 0;
+      type2_ = 0;
+      rsq_ = 0.25;
+      f = forceOverR();
+      TEST_ASSERT(f > 0.0);
+      TEST_ASSERT(testForce());
+
+      rsq_ = 2.0;
+      TEST_ASSERT(testForce());
+
+      type2_ = 1;
+      rsq_ = 4.0;
+      f = forceOverR();
+      TEST_ASSERT(f < 0.0);
+      TEST_ASSERT(testForce());
+
+      // Force vanishes continuously at the cutoff
+      f = forceOverR(8.9999, 0, 1);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         std::cout << "forceOverR(8.9999, 0, 1) = " << f << std::endl;
+      }
+      TEST_ASSERT(fabs(f) < 1.0E-5);
+   }
+
+   void testForceOverRBlock() 
+   {
+      printMethod(TEST_FUNC);
+
+      // All separations are inside the cutoff (block precondition)
+      const int n = 4;
+      double rsq[n] = {0.25, 1.64, 4.81, 8.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double f[n];
+
+      interaction_.forceOverR(n, rsq, i, j, f);
+      for (int k = 0; k < n; ++k) {
+         #ifdef SIMP_FLOAT_FORCE
+         double g = interaction_.forceOverR(rsq[k], i[k], j[k]);
+         TEST_ASSERT(fabs(f[k] - g) < 1.0E-5*(fabs(g) + 1.0));
+         #else
+         TEST_ASSERT(eq(f[k], interaction_.forceOverR(rsq[k], i[k], j[k])));
+         #endif
+      }
+   }
+
+   void testEvaluate() 
+   {
+      printMethod(TEST_FUNC);
+
+      const int n = 4;
+      double rsq[n] = {0.25, 1.64, 4.81, 8.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double e, f;
+
+      for (int k = 0; k < n; ++k) {
+         interaction_.evaluate(rsq[k], i[k], j[k], e, f);
+         TEST_ASSERT(eq(e, interaction_.energy(rsq[k], i[k], j[k])));
+         TEST_ASSERT(eq(f, interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+   }
+
+   void testModify() {
+      printMethod(TEST_FUNC);
+
+      TEST_ASSERT(eq(interaction_.get("charge", 0, 0), 1.0));
+      TEST_ASSERT(eq(interaction_.get("charge", 1, 1), -1.0));
+      TEST_ASSERT(eq(interaction_.get("alpha", 0, 0), 0.5));
+      TEST_ASSERT(eq(interaction_.get("cutoff", 0, 0), 3.0));
+      TEST_ASSERT(eq(interaction_.maxPairCutoff(), 3.0));
+
+      double e = energy(1.0, 0, 1);
+      interaction_.set("charge", 1, 1, -2.0);
+      TEST_ASSERT(eq(interaction_.get("charge", 1, 1), -2.0));
+      TEST_ASSERT(eq(energy(1.0, 0, 1), 2.0*e));
+      TEST_ASSERT(eq(energy(1.0, 1, 0), 2.0*e));
+      TEST_ASSERT(eq(energy(1.0, 1, 1), -4.0*e));
+   }
+
+   void testSaveLoad() {
+      printMethod(TEST_FUNC);
+
+      Serializable::OArchive oar;
+      openOutputFile("out/serial", oar.file());
+      interaction_.save(oar);
+      oar.file().close();
+
+      Serializable::IArchive iar;
+      openInputFile("out/serial", iar.file());
+
+      DsfCoulombPair clone;
+      clone.setNAtomType(2);
+      clone.loadParameters(iar);
+
+      TEST_ASSERT(eq(interaction_.energy(0.95, 0, 1), clone.energy(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(0.95, 0, 1), clone.forceOverR(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.energy(4.25, 1, 1), clone.energy(4.25, 1, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(4.25, 1, 1), clone.forceOverR(4.25, 1, 1)));
+   }
+
+};
+
+TEST_BEGIN(DsfCoulombPairTest)
+TEST_ADD(DsfCoulombPairTest, testSetUp)
+TEST_ADD(DsfCoulombPairTest, testEnergy)
+TEST_ADD(DsfCoulombPairTest, testForceOverR)
+TEST_ADD(DsfCoulombPairTest, testForceOverRBlock)
+TEST_ADD(DsfCoulombPairTest, testEvaluate)
+TEST_ADD(DsfCoulombPairTest, testModify)
+TEST_ADD(DsfCoulombPairTest, testSaveLoad)
+TEST_END(DsfCoulombPairTest)
+
+#endif
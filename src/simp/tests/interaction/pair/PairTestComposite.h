@@ -5,10 +5,18 @@
 
 #include "LJPairTest.h"
 #include "DpdPairTest.h"
+#include "DsfCoulombPairTest.h"
+#include "ReactionFieldPairTest.h"
+#include "TabulatedPairTest.h"
+#include "CompositePairTest.h"
 
 TEST_COMPOSITE_BEGIN(PairTestComposite)
 TEST_COMPOSITE_ADD_UNIT(LJPairTest);
 TEST_COMPOSITE_ADD_UNIT(DpdPairTest);
+TEST_COMPOSITE_ADD_UNIT(DsfCoulombPairTest);
+TEST_COMPOSITE_ADD_UNIT(ReactionFieldPairTest);
+TEST_COMPOSITE_ADD_UNIT(TabulatedPairTest);
+TEST_COMPOSITE_ADD_UNIT(CompositePairTest);
 TEST_COMPOSITE_END
 
 #endif
@@ -0,0 +1,176 @@
+#ifndef REACTION_FIELD_PAIR_TEST_H
+#define REACTION_FIELD_PAIR_TEST_H
+
+#include <simp/interaction/pair/ReactionFieldPair.h>
+#include <simp/tests/interaction/pair/PairTestTemplate.h>
+
+#include <iostream>
+#include <fstream>
+
+using namespace Util;
+using namespace Simp;
+
+class ReactionFieldPairTest : public PairTestTemplate<ReactionFieldPair>
+{
+
+protected:
+
+   using PairTestTemplate<ReactionFieldPair>::setNAtomType;
+   using PairTestTemplate<ReactionFieldPair>::readParamFile;
+   using PairTestTemplate<ReactionFieldPair>::forceOverR;
+   using PairTestTemplate<ReactionFieldPair>::energy;
+
+public:
+
+   void setUp()
+   {
+      eps_ = 1.0E-6;
+      setNAtomType(2);
+      readParamFile("in/ReactionFieldPair");
+      // setVerbose(1);
+   }
+
+   void testSetUp() 
+   {
+      printMethod(TEST_FUNC);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         interaction_.writeParam(std::cout);
+      }
+   }
+
+   void testEnergy() 
+   {
+      printMethod(TEST_FUNC);
+      double e;
+
+      // Compare to the analytic form, with unit Coulomb prefactor
+      double k = 79.0/(161.0*27.0);
+      double c = 1.0/3.0 + 9.0*k;
+      e = energy(1.0, 0, 0);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         std::cout << "energy(1.0, 0, 0) = " << e << std::endl;
+      }
+      TEST_ASSERT(eq(e, 1.0 + k - c));
+      TEST_ASSERT(eq(energy(1.0, 0, 1), -e));
+      TEST_ASSERT(eq(energy(4.0, 1, 1), 0.5 + 4.0*k - c));
+
+      // Energy vanishes continuously at the cutoff
+      e = energy(8.9999, 0, 1);
+      TEST_ASSERT(fabs(e) < 1.0E-5);
+      TEST_ASSERT(eq(energy(9.5, 0, 1), 0.0));
+   }
+
+   void testForceOverR() 
+   {
+      printMethod(TEST_FUNC);
+      double f;
+
+      type1_ = 0;
+      type2_ = 0;
+      rsq_ = 0.25;
+      f = forceOverR();
+      TEST_ASSERT(f > 0.0);
+      TEST_ASSERT(testForce());
+
+      rsq_ = 2.0;
+      TEST_ASSERT(testForce());
+
+      type2_ = 1;
+      rsq_ = 4.0;
+      f = forceOverR();
+      TEST_ASSERT(f < 0.0);
+      TEST_ASSERT(testForce());
+   }
+
+   void testForceOverRBlock() 
+   {
+      printMethod(TEST_FUNC);
+
+      // All separations are inside the cutoff (block precondition)
+      const int n = 4;
+      double rsq[n] = {0.25, 1.64, 4.81, 8.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double f[n];
+
+      interaction_.forceOverR(n, rsq, i, j, f);
+      for (int k = 0; k < n; ++k) {
+         #ifdef SIMP_FLOAT_FORCE
+         double g = interaction_.forceOverR(rsq[k], i[k], j[k]);
+         TEST_ASSERT(fabs(f[k] - g) < 1.0E-5*(fabs(g) + 1.0));
+         #else
+         TEST_ASSERT(eq(f[k], interaction_.forceOverR(rsq[k], i[k], j[k])));
+         #endif
+      }
+   }
+
+   void testEvaluate() 
+   {
+      printMethod(TEST_FUNC);
+
+      const int n = 4;
+      double rsq[n] = {0.25, 1.64, 4.81, 8.36};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double e, f;
+
+      for (int k = 0; k < n; ++k) {
+         interaction_.evaluate(rsq[k], i[k], j[k], e, f);
+         TEST_ASSERT(eq(e, interaction_.energy(rsq[k], i[k], j[k])));
+         TEST_ASSERT(eq(f, interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+   }
+
+   void testModify() {
+      printMethod(TEST_FUNC);
+
+      TEST_ASSERT(eq(interaction_.get("charge", 0, 0), 1.0));
+      TEST_ASSERT(eq(interaction_.get("charge", 1, 1), -1.0));
+      TEST_ASSERT(eq(interaction_.get("epsilonRF", 0, 0), 80.0));
+      TEST_ASSERT(eq(interaction_.get("cutoff", 0, 0), 3.0));
+      TEST_ASSERT(eq(interaction_.maxPairCutoff(), 3.0));
+
+      double e = energy(1.0, 0, 1);
+      interaction_.set("charge", 1, 1, -2.0);
+      TEST_ASSERT(eq(interaction_.get("charge", 1, 1), -2.0));
+      TEST_ASSERT(eq(energy(1.0, 0, 1), 2.0*e));
+      TEST_ASSERT(eq(energy(1.0, 1, 0), 2.0*e));
+      TEST_ASSERT(eq(energy(1.0, 1, 1), -4.0*e));
+   }
+
+   void testSaveLoad() {
+      printMethod(TEST_FUNC);
+
+      Serializable::OArchive oar;
+      openOutputFile("out/serial", oar.file());
+      interaction_.save(oar);
+      oar.file().close();
+
+      Serializable::IArchive iar;
+      openInputFile("out/serial", iar.file());
+
+      ReactionFieldPair clone;
+      clone.setNAtomType(2);
+      clone.loadParameters(iar);
+
+      TEST_ASSERT(eq(interaction_.energy(0.95, 0, 1), clone.energy(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(0.95, 0, 1), clone.forceOverR(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.energy(4.25, 1, 1), clone.energy(4.25, 1, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(4.25, 1, 1), clone.forceOverR(4.25, 1, 1)));
+   }
+
+};
+
+TEST_BEGIN(ReactionFieldPairTest)
+TEST_ADD(ReactionFieldPairTest, testSetUp)
+TEST_ADD(ReactionFieldPairTest, testEnergy)
+TEST_ADD(ReactionFieldPairTest, testForceOverR)
+TEST_ADD(ReactionFieldPairTest, testForceOverRBlock)
+TEST_ADD(ReactionFieldPairTest, testEvaluate)
+TEST_ADD(ReactionFieldPairTest, testModify)
+TEST_ADD(ReactionFieldPairTest, testSaveLoad)
+TEST_END(ReactionFieldPairTest)
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef TABULATED_PAIR_TEST_H
+#define TABULATED_PAIR_TEST_H
+
+#include <simp/interaction/pair/TabulatedPair.h>
+#include <simp/interaction/pair/DpdPair.h>
+#include <simp/tests/interaction/pair/PairTestTemplate.h>
+
+#include <iostream>
+#include <fstream>
+#include <cmath>
+
+using namespace Util;
+using namespace Simp;
+
+class TabulatedPairTest : public PairTestTemplate<TabulatedPair>
+{
+
+protected:
+
+   using PairTestTemplate<TabulatedPair>::setNAtomType;
+   using PairTestTemplate<TabulatedPair>::readParamFile;
+   using PairTestTemplate<TabulatedPair>::forceOverR;
+   using PairTestTemplate<TabulatedPair>::energy;
+
+   // Analytic potential tabulated in file in/DpdTable
+   DpdPair dpd_;
+
+public:
+
+   void setUp()
+   {
+      eps_ = 1.0E-6;
+      setNAtomType(2);
+      readParamFile("in/TabulatedPair");
+
+      std::ifstream in;
+      openInputFile("in/DpdPair", in);
+      dpd_.setNAtomType(2);
+      dpd_.readParameters(in);
+      in.close();
+      // setVerbose(1);
+   }
+
+   bool near(double a, double b)
+   {  return (std::fabs(a - b) < 1.0E-4); }
+
+   void testSetUp() 
+   {
+      printMethod(TEST_FUNC);
+      if (verbose() > 0) {
+         std::cout << std::endl; 
+         interaction_.writeParam(std::cout);
+      }
+      TEST_ASSERT(eq(interaction_.maxPairCutoff(), 1.0));
+      TEST_ASSERT(eq(interaction_.cutoffSq(0, 1), 1.0));
+      TEST_ASSERT(eq(interaction_.get("rMin", 1, 0), 0.1));
+   }
+
+   void testEnergy() 
+   {
+      printMethod(TEST_FUNC);
+      double rsq[4] = {0.09, 0.36, 0.64, 0.99};
+      int i, j, k;
+      for (i = 0; i < 2; ++i) {
+         for (j = 0; j < 2; ++j) {
+            for (k = 0; k < 4; ++k) {
+               TEST_ASSERT(near(energy(rsq[k], i, j), 
+                                dpd_.energy(rsq[k], i, j)));
+            }
+         }
+      }
+      TEST_ASSERT(eq(energy(1.21, 0, 1), 0.0));
+   }
+
+   void testForceOverR() 
+   {
+      printMethod(TEST_FUNC);
+      double rsq[4] = {0.09, 0.36, 0.64, 0.99};
+      int k;
+      type1_ = 0;
+      type2_ = 1;
+      for (k = 0; k < 4; ++k) {
+         rsq_ = rsq[k];
+         TEST_ASSERT(near(forceOverR(), dpd_.forceOverR(rsq_, 0, 1)));
+      }
+      type1_ = 1;
+      type2_ = 1;
+      for (k = 0; k < 4; ++k) {
+         rsq_ = rsq[k];
+         TEST_ASSERT(near(forceOverR(), dpd_.forceOverR(rsq_, 1, 1)));
+      }
+   }
+
+   void testForceOverRBlock() 
+   {
+      printMethod(TEST_FUNC);
+
+      // All separations are inside the cutoff (block precondition)
+      const int n = 4;
+      double rsq[n] = {0.25, 0.64, 0.81, 0.005};
+      int i[n] = {0, 0, 1, 1};
+      int j[n] = {0, 1, 0, 1};
+      double f[n];
+
+      interaction_.forceOverR(n, rsq, i, j, f);
+      for (int k = 0; k < n; ++k) {
+         TEST_ASSERT(eq(f[k], interaction_.forceOverR(rsq[k], i[k], j[k])));
+      }
+   }
+
+   void testSaveLoad() {
+      printMethod(TEST_FUNC);
+
+      Serializable::OArchive oar;
+      openOutputFile("out/serial", oar.file());
+      interaction_.save(oar);
+      oar.file().close();
+
+      Serializable::IArchive iar;
+      openInputFile("out/serial", iar.file());
+
+      TabulatedPair clone;
+      clone.setNAtomType(2);
+      clone.loadParameters(iar);
+
+      TEST_ASSERT(eq(interaction_.maxPairCutoff(), clone.maxPairCutoff()));
+      TEST_ASSERT(eq(interaction_.energy(0.95, 0, 1), clone.energy(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(0.95, 0, 1), clone.forceOverR(0.95, 0, 1)));
+      TEST_ASSERT(eq(interaction_.energy(0.25, 1, 1), clone.energy(0.25, 1, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(0.25, 1, 1), clone.forceOverR(0.25, 1, 1)));
+
+      TabulatedPair copy(interaction_);
+      TEST_ASSERT(eq(interaction_.energy(0.5, 0, 1), copy.energy(0.5, 0, 1)));
+      TEST_ASSERT(eq(interaction_.forceOverR(0.5, 0, 0), copy.forceOverR(0.5, 0, 0)));
+   }
+
+};
+
+TEST_BEGIN(TabulatedPairTest)
+TEST_ADD(TabulatedPairTest, testSetUp)
+TEST_ADD(TabulatedPairTest, testEnergy)
+TEST_ADD(TabulatedPairTest, testForceOverR)
+TEST_ADD(TabulatedPairTest, testForceOverRBlock)
+TEST_ADD(TabulatedPairTest, testSaveLoad)
+TEST_END(TabulatedPairTest)
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef SIMP_COUNTER_RANDOM_TEST_H
+#define SIMP_COUNTER_RANDOM_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <simp/random/CounterRandom.h>
+
+#include <cmath>
+
+using namespace Util;
+using namespace Simp;
+
+class CounterRandomTest : public UnitTest 
+{
+
+public:
+
+   void setUp() 
+   {}
+
+   void tearDown() 
+   {}
+
+   void testKnownAnswer();
+   void testReproducible();
+   void testMoments();
+
+};
+
+/*
+* Compare to published Philox4x32-10 known answer vectors.
+*/
+void CounterRandomTest::testKnownAnswer()
+{
+   printMethod(TEST_FUNC);
+
+   uint32_t out[4];
+   CounterRandom random(0, 0);
+   random.generate(0, 0, 0, 0, out);
+   TEST_ASSERT(out[0] == 0x6627e8d5u);
+   TEST_ASSERT(out[1] == 0xe169c58du);
+   TEST_ASSERT(out[2] == 0xbc57ac4cu);
+   TEST_ASSERT(out[3] == 0x9b00dbd8u);
+
+   random.setSeed(0xa4093822u, 0x299f31d0u);
+   random.generate(0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u, out);
+   TEST_ASSERT(out[0] == 0xd16cfe09u);
+   TEST_ASSERT(out[1] == 0x94fdccebu);
+   TEST_ASSERT(out[2] == 0x5001e420u);
+   TEST_ASSERT(out[3] == 0x24126ea1u);
+}
+
+/*
+* Output depends only on counter and key, not on call order.
+*/
+void CounterRandomTest::testReproducible()
+{
+   printMethod(TEST_FUNC);
+
+   double a[4], b[4], c[4];
+   CounterRandom random(17, 1);
+   random.uniform(5, 100, 0, 0, a);
+   random.uniform(6, 100, 0, 0, c);
+   random.uniform(5, 100, 0, 0, b);
+   for (int i = 0; i < 4; ++i) {
+      TEST_ASSERT(a[i] == b[i]);
+      TEST_ASSERT(a[i] != c[i]);
+      TEST_ASSERT(a[i] > 0.0 && a[i] < 1.0);
+   }
+   CounterRandom other(17, 2);
+   other.uniform(5, 100, 0, 0, b);
+   TEST_ASSERT(a[0] != b[0]);
+}
+
+/*
+* Check mean and variance of uniform and Gaussian output.
+*/
+void CounterRandomTest::testMoments()
+{
+   printMethod(TEST_FUNC);
+
+   const int n = 100000;
+   double u[4], g[4];
+   double uSum = 0.0, uSqSum = 0.0, gSum = 0.0, gSqSum = 0.0;
+   CounterRandom random(12345, 0);
+   for (int i = 0; i < n; ++i) {
+      random.uniform(i, 0, 0, 0, u);
+      random.gaussian(i, 1, 0, 0, g);
+      for (int j = 0; j < 4; ++j) {
+         uSum += u[j];
+         uSqSum += u[j]*u[j];
+         gSum += g[j];
+         gSqSum += g[j]*g[j];
+      }
+   }
+   double m = 4.0*n;
+   TEST_ASSERT(std::fabs(uSum/m - 0.5) < 0.005);
+   TEST_ASSERT(std::fabs(uSqSum/m - 1.0/3.0) < 0.005);
+   TEST_ASSERT(std::fabs(gSum/m) < 0.01);
+   TEST_ASSERT(std::fabs(gSqSum/m - 1.0) < 0.01);
+}
+
+TEST_BEGIN(CounterRandomTest)
+TEST_ADD(CounterRandomTest, testKnownAnswer)
+TEST_ADD(CounterRandomTest, testReproducible)
+TEST_ADD(CounterRandomTest, testMoments)
+TEST_END(CounterRandomTest)
+
+#endif
@@ -0,0 +1,7 @@
+#include "CounterRandomTest.h"
+
+int main()
+{
+   TEST_RUNNER(CounterRandomTest) test;
+   test.run();
+}
@@ -0,0 +1,7 @@
+simp_tests_random_=simp/tests/random/Test.cc
+
+simp_tests_random_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(simp_tests_random_))
+simp_tests_random_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(simp_tests_random_:.cc=.o))
+
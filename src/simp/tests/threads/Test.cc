@@ -0,0 +1,7 @@
+#include "ThreadPoolTest.h"
+
+int main()
+{
+   TEST_RUNNER(ThreadPoolTest) test;
+   test.run();
+}
@@ -0,0 +1,137 @@
+#ifndef SIMP_THREAD_POOL_TEST_H
+#define SIMP_THREAD_POOL_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <simp/threads/ThreadPool.h>
+
+#include <vector>
+
+using namespace Util;
+using namespace Simp;
+
+class ThreadPoolTest : public UnitTest 
+{
+
+public:
+
+   void setUp() 
+   {}
+
+   void tearDown() 
+   {}
+
+   void testInitialize();
+   void testParallelFor();
+   void testTaskGroup();
+
+};
+
+namespace {
+
+   /*
+   * Loop body that counts visits of each index.
+   */
+   struct CountBody
+   {
+      std::vector<int>* counts;
+
+      void operator () (int begin, int end)
+      {
+         for (int i = begin; i < end; ++i) {
+            ++(*counts)[i];
+         }
+      }
+   };
+
+   /*
+   * Task that records its own index.
+   */
+   class IndexTask : public TaskGroup::Task
+   {
+   public:
+      int id;
+      int result;
+
+      virtual void run()
+      {  result = id; }
+   };
+
+}
+
+void ThreadPoolTest::testInitialize()
+{
+   printMethod(TEST_FUNC);
+
+   ThreadPool pool;
+   TEST_ASSERT(!pool.isInitialized());
+   pool.setNThread(2);
+   pool.initialize();
+   TEST_ASSERT(pool.isInitialized());
+   TEST_ASSERT(pool.nThread() > 0);
+   if (!ThreadPool::isThreaded()) {
+      TEST_ASSERT(pool.nThread() == 1);
+   }
+}
+
+/*
+* Every index is visited exactly once, for any grain size.
+*/
+void ThreadPoolTest::testParallelFor()
+{
+   printMethod(TEST_FUNC);
+
+   ThreadPool pool;
+   pool.initialize();
+   const int n = 1003;
+   std::vector<int> counts(n);
+   CountBody body;
+   body.counts = &counts;
+   int grains[3] = {1, 16, 5000};
+   int i, j;
+   for (j = 0; j < 3; ++j) {
+      for (i = 0; i < n; ++i) {
+         counts[i] = 0;
+      }
+      pool.parallelFor(0, n, body, grains[j]);
+      for (i = 0; i < n; ++i) {
+         TEST_ASSERT(counts[i] == 1);
+      }
+   }
+
+   // Empty range
+   pool.parallelFor(5, 5, body, 4);
+   TEST_ASSERT(counts[5] == 1);
+}
+
+void ThreadPoolTest::testTaskGroup()
+{
+   printMethod(TEST_FUNC);
+
+   ThreadPool pool;
+   pool.initialize();
+   TaskGroup group(pool);
+   const int n = 20;
+   IndexTask tasks[n];
+   int i;
+   for (i = 0; i < n; ++i) {
+      tasks[i].id = i;
+      tasks[i].result = -1;
+      group.add(tasks[i]);
+   }
+   TEST_ASSERT(group.size() == n);
+   group.wait();
+   TEST_ASSERT(group.size() == 0);
+   for (i = 0; i < n; ++i) {
+      TEST_ASSERT(tasks[i].result == i);
+   }
+}
+
+TEST_BEGIN(ThreadPoolTest)
+TEST_ADD(ThreadPoolTest, testInitialize)
+TEST_ADD(ThreadPoolTest, testParallelFor)
+TEST_ADD(ThreadPoolTest, testTaskGroup)
+TEST_END(ThreadPoolTest)
+
+#endif
@@ -0,0 +1,7 @@
+simp_tests_threads_=simp/tests/threads/Test.cc
+
+simp_tests_threads_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(simp_tests_threads_))
+simp_tests_threads_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(simp_tests_threads_:.cc=.o))
+
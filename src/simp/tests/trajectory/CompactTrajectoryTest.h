@@ -0,0 +1,175 @@
+#ifndef SIMP_COMPACT_TRAJECTORY_TEST_H
+#define SIMP_COMPACT_TRAJECTORY_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <simp/trajectory/CompactTrajectory.h>
+#include <util/boundary/Boundary.h>
+#include <util/containers/DArray.h>
+#include <util/containers/GArray.h>
+#include <util/space/Vector.h>
+
+#include <fstream>
+#include <cmath>
+
+using namespace Util;
+using namespace Simp;
+
+class CompactTrajectoryTest : public UnitTest 
+{
+
+private:
+
+   enum { NAtom = 20 };
+   enum { NBit = 16 };
+
+   DArray<Vector> positions_;
+
+public:
+
+   void setUp() 
+   {
+      // Chain-like configuration that crosses the periodic boundary
+      positions_.allocate(NAtom);
+      for (int i = 0; i < NAtom; ++i) {
+         positions_[i][0] = 0.9 + 0.01*i;
+         positions_[i][1] = 0.5 - 0.003*i;
+         positions_[i][2] = 0.25;
+         if (positions_[i][0] >= 1.0) positions_[i][0] -= 1.0;
+      }
+   } 
+
+   void tearDown() 
+   {}
+
+   /*
+   * Is every position within half a quantization bin of the original?
+   */
+   bool isClose(const DArray<Vector>& decoded)
+   {
+      double tolerance = 0.5/double(1 << NBit) + 1.0E-12;
+      for (int i = 0; i < NAtom; ++i) {
+         for (int j = 0; j < Dimension; ++j) {
+            if (std::fabs(decoded[i][j] - positions_[i][j]) > tolerance) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+   void testEncodeDecode();
+   void testWriteRead();
+   void testRebuildIndex();
+
+};
+
+void CompactTrajectoryTest::testEncodeDecode()
+{
+   printMethod(TEST_FUNC);
+
+   CompactTrajectory trajectory;
+   trajectory.setParameters(NAtom, NBit);
+
+   GArray<unsigned char> bytes;
+   trajectory.encode(positions_, bytes);
+
+   // Small differences between neighbors need 1 or 2 bytes/coordinate
+   TEST_ASSERT(bytes.size() <= 2*Dimension*NAtom);
+
+   DArray<Vector> decoded;
+   decoded.allocate(NAtom);
+   trajectory.decode(&bytes[0], bytes.size(), decoded);
+   TEST_ASSERT(isClose(decoded));
+}
+
+void CompactTrajectoryTest::testWriteRead()
+{
+   printMethod(TEST_FUNC);
+
+   Boundary boundary;
+   boundary.setCubic(10.0);
+
+   // Write three frames, with index
+   CompactTrajectory writer;
+   writer.setParameters(NAtom, NBit);
+   std::ofstream out;
+   openOutputFile("binary", out);
+   writer.writeHeader(out);
+   for (int i = 0; i < 3; ++i) {
+      writer.writeFrame(out, 100*i, boundary, positions_);
+   }
+   writer.writeIndex(out);
+   out.close();
+
+   CompactTrajectory reader;
+   std::ifstream in;
+   openInputFile("binary", in);
+   reader.readHeader(in);
+   TEST_ASSERT(reader.nAtom() == NAtom);
+   TEST_ASSERT(reader.nBit() == NBit);
+   TEST_ASSERT(reader.readIndex(in));
+   TEST_ASSERT(reader.nFrame() == 3);
+
+   // Random access to last frame
+   DArray<Vector> decoded;
+   decoded.allocate(NAtom);
+   Boundary boundaryIn;
+   long iStep;
+   reader.seekFrame(in, 2);
+   TEST_ASSERT(reader.readFrame(in, iStep, boundaryIn, decoded));
+   TEST_ASSERT(iStep == 200);
+   TEST_ASSERT(isClose(decoded));
+   TEST_ASSERT(!reader.readFrame(in, iStep, boundaryIn, decoded));
+
+   // Sequential access from first frame
+   reader.seekFrame(in, 0);
+   TEST_ASSERT(reader.readFrame(in, iStep, boundaryIn, decoded));
+   TEST_ASSERT(iStep == 0);
+   TEST_ASSERT(reader.frameId() == 1);
+   in.close();
+}
+
+void CompactTrajectoryTest::testRebuildIndex()
+{
+   printMethod(TEST_FUNC);
+
+   Boundary boundary;
+   boundary.setCubic(10.0);
+
+   // Write two frames, without index
+   CompactTrajectory writer;
+   writer.setParameters(NAtom, NBit);
+   std::ofstream out;
+   openOutputFile("binary", out);
+   writer.writeHeader(out);
+   writer.writeFrame(out, 10, boundary, positions_);
+   writer.writeFrame(out, 20, boundary, positions_);
+   out.close();
+
+   CompactTrajectory reader;
+   std::ifstream in;
+   openInputFile("binary", in);
+   reader.readHeader(in);
+   TEST_ASSERT(!reader.readIndex(in));
+   TEST_ASSERT(reader.nFrame() == 2);
+
+   DArray<Vector> decoded;
+   decoded.allocate(NAtom);
+   Boundary boundaryIn;
+   long iStep;
+   reader.seekFrame(in, 1);
+   TEST_ASSERT(reader.readFrame(in, iStep, boundaryIn, decoded));
+   TEST_ASSERT(iStep == 20);
+   TEST_ASSERT(isClose(decoded));
+   in.close();
+}
+
+TEST_BEGIN(CompactTrajectoryTest)
+TEST_ADD(CompactTrajectoryTest, testEncodeDecode)
+TEST_ADD(CompactTrajectoryTest, testWriteRead)
+TEST_ADD(CompactTrajectoryTest, testRebuildIndex)
+TEST_END(CompactTrajectoryTest)
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SIMP_LAMMPS_DUMP_FORMAT_TEST_H
+#define SIMP_LAMMPS_DUMP_FORMAT_TEST_H
+
+#include <test/UnitTest.h>
+#include <test/UnitTestRunner.h>
+
+#include <simp/trajectory/LammpsDumpFormat.h>
+#include <util/space/Vector.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace Util;
+using namespace Simp;
+
+class LammpsDumpFormatTest : public UnitTest 
+{
+
+public:
+
+   void setUp() 
+   {}
+
+   void tearDown() 
+   {}
+
+   void testFormatParse();
+   void testInvalidLine();
+
+};
+
+void LammpsDumpFormatTest::testFormatParse()
+{
+   printMethod(TEST_FUNC);
+
+   char line[LammpsDumpFormat::MaxLineLength];
+   Vector r;
+   r[0] = 1.25;
+   r[1] = -3.0E-5;
+   r[2] = 12345.678901234;
+   int n = LammpsDumpFormat::formatAtom(line, 41, 2, 7, r);
+   TEST_ASSERT(n == (int) strlen(line));
+   TEST_ASSERT(line[n-1] == '\n');
+   TEST_ASSERT(strncmp(line, "42 3 7 ", 7) == 0);
+
+   Vector s;
+   int id, typeId, molId;
+   TEST_ASSERT(LammpsDumpFormat::parseAtom(line, id, typeId, molId, s));
+   TEST_ASSERT(id == 41);
+   TEST_ASSERT(typeId == 2);
+   TEST_ASSERT(molId == 7);
+   for (int j = 0; j < Dimension; ++j) {
+      TEST_ASSERT(std::fabs(s[j] - r[j]) <= 1.0E-11*std::fabs(r[j]));
+   }
+}
+
+void LammpsDumpFormatTest::testInvalidLine()
+{
+   printMethod(TEST_FUNC);
+
+   Vector r;
+   int id, typeId, molId;
+   TEST_ASSERT(!LammpsDumpFormat::parseAtom("", id, typeId, molId, r));
+   TEST_ASSERT(!LammpsDumpFormat::parseAtom("1 1 1 0.5 0.5", 
+                                            id, typeId, molId, r));
+   TEST_ASSERT(LammpsDumpFormat::parseAtom("1 1 1 0.5 0.5 0.5", 
+                                           id, typeId, molId, r));
+}
+
+TEST_BEGIN(LammpsDumpFormatTest)
+TEST_ADD(LammpsDumpFormatTest, testFormatParse)
+TEST_ADD(LammpsDumpFormatTest, testInvalidLine)
+TEST_END(LammpsDumpFormatTest)
+
+#endif
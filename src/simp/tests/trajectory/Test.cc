@@ -0,0 +1,11 @@
+#include "CompactTrajectoryTest.h"
+#include "LammpsDumpFormatTest.h"
+
+int main()
+{
+   TEST_RUNNER(CompactTrajectoryTest) test1;
+   test1.run();
+
+   TEST_RUNNER(LammpsDumpFormatTest) test2;
+   test2.run();
+}
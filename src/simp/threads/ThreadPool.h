@@ -0,0 +1,385 @@
+#ifndef SIMP_THREAD_POOL_H
+#define SIMP_THREAD_POOL_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+namespace Simp
+{
+
+   /**
+   * Thread pool shared by all threaded parts of a program.
+   *
+   * A ThreadPool is created once by the main object of each program
+   * (DdMd::Simulation, McMd::McSimulation, McMd::MdSimulation and
+   * Tools::Processor), and sets the number of threads and the placement
+   * of threads on cores for the whole process. It does not create its
+   * own threads: It configures the OpenMP runtime, which then provides
+   * one set of persistent worker threads that is shared by the threaded
+   * force kernels, configuration bias trial energies, analyzers and
+   * trajectory code, and by the parallelFor() and TaskGroup primitives.
+   * Sharing one runtime avoids oversubscription of cores by independent
+   * pools, which matters in hybrid MPI + threads runs.
+   *
+   * The number of threads and pinning must be set before initialize(),
+   * which is normally called while processing command-line options.
+   * If pinning is enabled, thread i of each process is bound to the i-th
+   * core (modulo the number of cores) in the affinity mask with which the
+   * process was started, so that cores assigned to an MPI rank by the
+   * launcher are respected. Pinning is only implemented on Linux.
+   *
+   * All functions are inline, and are compiled with the flags of the
+   * including code: Without OpenMP (e.g., if DDMD_OPENMP, MCMD_OPENMP
+   * or TOOLS_OPENMP is not defined), there is one thread and all loops
+   * and tasks are executed serially by the calling thread.
+   *
+   * \ingroup Simp_Threads_Module
+   */
+   class ThreadPool
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      ThreadPool();
+
+      /**
+      * Set the number of threads.
+      *
+      * \param nThread number of threads, or 0 for the runtime default
+      */
+      void setNThread(int nThread);
+
+      /**
+      * Enable or disable pinning of threads to cores.
+      *
+      * \param isPinned true to bind each thread to one core
+      */
+      void setPinned(bool isPinned);
+
+      /**
+      * Apply settings to the runtime, and optionally pin threads.
+      *
+      * Call from the main thread, outside of any parallel region.
+      */
+      void initialize();
+
+      /**
+      * Execute body over all chunks of a range of indices.
+      *
+      * The range [begin, end) is divided into contiguous chunks of at
+      * most grain indices, which are handed out to threads dynamically,
+      * so that threads that finish early take remaining chunks. Body must
+      * provide a thread safe member "void operator () (int begin, int end)"
+      * that processes one chunk. If called from within a parallel region,
+      * the loop is executed serially by the calling thread.
+      *
+      * \param begin first index
+      * \param end   one past the last index
+      * \param body  functor that processes one chunk
+      * \param grain maximum number of indices per chunk
+      */
+      template <class Body>
+      void parallelFor(int begin, int end, Body& body, int grain = 1) const;
+
+      /**
+      * Number of threads used by parallel regions.
+      */
+      int nThread() const;
+
+      /**
+      * Are threads pinned to cores?
+      */
+      bool isPinned() const;
+
+      /**
+      * Has initialize() been called?
+      */
+      bool isInitialized() const;
+
+      /**
+      * Is this code compiled with OpenMP threads?
+      */
+      static bool isThreaded();
+
+   private:
+
+      // Requested number of threads (0 for runtime default).
+      int nThread_;
+
+      // Pin threads to cores?
+      bool isPinned_;
+
+      // Has initialize() been called?
+      bool isInitialized_;
+
+      /**
+      * Bind each thread of a parallel region to one allowed core.
+      */
+      void pin();
+
+   };
+
+   /**
+   * Group of independent tasks executed by a ThreadPool.
+   *
+   * Tasks are added by add(), and are all executed by a call to wait(),
+   * which returns after every task has completed and empties the group.
+   * Tasks are handed out one at a time to idle threads, so tasks of very
+   * different cost are balanced among threads. A TaskGroup holds only
+   * pointers: Each task must remain valid until wait() returns.
+   *
+   * \ingroup Simp_Threads_Module
+   */
+   class TaskGroup
+   {
+
+   public:
+
+      /**
+      * Base class for a task.
+      */
+      class Task
+      {
+      public:
+
+         /**
+         * Destructor.
+         */
+         virtual ~Task() {}
+
+         /**
+         * Execute this task (must be thread safe).
+         */
+         virtual void run() = 0;
+
+      };
+
+      /**
+      * Constructor.
+      *
+      * \param pool ThreadPool that executes the tasks
+      */
+      TaskGroup(const ThreadPool& pool);
+
+      /**
+      * Add a task to the group.
+      *
+      * \param task task to execute in the next call to wait()
+      */
+      void add(Task& task);
+
+      /**
+      * Execute all tasks, and return when all are complete.
+      */
+      void wait();
+
+      /**
+      * Number of tasks waiting to be executed.
+      */
+      int size() const;
+
+   private:
+
+      // Tasks added since the last call to wait().
+      std::vector<Task*> tasks_;
+
+      // Pointer to the ThreadPool.
+      const ThreadPool* poolPtr_;
+
+      /*
+      * Functor that runs tasks with indices in a range.
+      */
+      struct Runner
+      {
+         Task** tasks;
+
+         void operator () (int begin, int end)
+         {
+            for (int i = begin; i < end; ++i) {
+               tasks[i]->run();
+            }
+         }
+      };
+
+   };
+
+   // Inline functions of ThreadPool
+
+   inline ThreadPool::ThreadPool()
+    : nThread_(0),
+      isPinned_(false),
+      isInitialized_(false)
+   {}
+
+   inline void ThreadPool::setNThread(int nThread)
+   {
+      if (nThread < 0) {
+         UTIL_THROW("Negative number of threads");
+      }
+      nThread_ = nThread;
+   }
+
+   inline void ThreadPool::setPinned(bool isPinned)
+   {  isPinned_ = isPinned; }
+
+   /*
+   * Apply settings to the OpenMP runtime.
+   */
+   inline void ThreadPool::initialize()
+   {
+      #ifdef _OPENMP
+      if (omp_in_parallel()) {
+         UTIL_THROW("ThreadPool::initialize() called in a parallel region");
+      }
+      if (nThread_ > 0) {
+         omp_set_num_threads(nThread_);
+      }
+      omp_set_dynamic(0);
+      if (isPinned_) {
+         pin();
+      }
+      #endif
+      isInitialized_ = true;
+   }
+
+   /*
+   * Bind each thread of a parallel region to one of the allowed cores.
+   *
+   * OpenMP runtimes keep their worker threads between parallel regions,
+   * so the binding applies to all later regions with the same number
+   * of threads.
+   */
+   inline void ThreadPool::pin()
+   {
+      #if defined(_OPENMP) && defined(__linux__)
+      cpu_set_t allowed;
+      CPU_ZERO(&allowed);
+      if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+         UTIL_THROW("Failed to get affinity mask of process");
+      }
+      std::vector<int> cores;
+      for (int i = 0; i < CPU_SETSIZE; ++i) {
+         if (CPU_ISSET(i, &allowed)) {
+            cores.push_back(i);
+         }
+      }
+      const int nCore = cores.size();
+      if (nCore == 0) {
+         UTIL_THROW("Empty affinity mask");
+      }
+      int nFail = 0;
+      #pragma omp parallel reduction(+:nFail)
+      {
+         cpu_set_t mask;
+         CPU_ZERO(&mask);
+         CPU_SET(cores[omp_get_thread_num() % nCore], &mask);
+         if (sched_setaffinity(0, sizeof(cpu_set_t), &mask) != 0) {
+            ++nFail;
+         }
+      }
+      if (nFail > 0) {
+         UTIL_THROW("Failed to pin threads to cores");
+      }
+      #endif
+   }
+
+   /*
+   * Execute body over all chunks of a range, with dynamic scheduling.
+   */
+   template <class Body>
+   void ThreadPool::parallelFor(int begin, int end, Body& body, int grain)
+   const
+   {
+      if (end <= begin) return;
+      if (grain < 1) grain = 1;
+      const int nChunk = (end - begin + grain - 1)/grain;
+      int i, first, last;
+      #ifdef _OPENMP
+      if (nChunk > 1 && !omp_in_parallel()) {
+         #pragma omp parallel for schedule(dynamic, 1) private(first, last)
+         for (i = 0; i < nChunk; ++i) {
+            first = begin + i*grain;
+            last = first + grain;
+            if (last > end) last = end;
+            body(first, last);
+         }
+         return;
+      }
+      #endif
+      for (i = 0; i < nChunk; ++i) {
+         first = begin + i*grain;
+         last = first + grain;
+         if (last > end) last = end;
+         body(first, last);
+      }
+   }
+
+   inline int ThreadPool::nThread() const
+   {
+      #ifdef _OPENMP
+      return omp_get_max_threads();
+      #else
+      return 1;
+      #endif
+   }
+
+   inline bool ThreadPool::isPinned() const
+   {  return isPinned_; }
+
+   inline bool ThreadPool::isInitialized() const
+   {  return isInitialized_; }
+
+   inline bool ThreadPool::isThreaded()
+   {
+      #ifdef _OPENMP
+      return true;
+      #else
+      return false;
+      #endif
+   }
+
+   // Inline functions of TaskGroup
+
+   inline TaskGroup::TaskGroup(const ThreadPool& pool)
+    : tasks_(),
+      poolPtr_(&pool)
+   {}
+
+   inline void TaskGroup::add(Task& task)
+   {  tasks_.push_back(&task); }
+
+   /*
+   * Execute all tasks, one per chunk, and empty the group.
+   */
+   inline void TaskGroup::wait()
+   {
+      if (tasks_.empty()) return;
+      Runner runner;
+      runner.tasks = &tasks_[0];
+      poolPtr_->parallelFor(0, tasks_.size(), runner, 1);
+      tasks_.clear();
+   }
+
+   inline int TaskGroup::size() const
+   {  return tasks_.size(); }
+
+}
+#endif
@@ -0,0 +1,10 @@
+namespace Simp {
+
+   /**
+   * \defgroup Simp_Threads_Module Threads
+   * \ingroup Simp_Module
+   *
+   * Shared thread pool, parallel loops and task groups.
+   */
+
+}
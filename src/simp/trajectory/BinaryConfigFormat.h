@@ -0,0 +1,91 @@
+#ifndef SIMP_BINARY_CONFIG_FORMAT_H
+#define SIMP_BINARY_CONFIG_FORMAT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace Simp
+{
+
+   /**
+   * Layout of the compact binary configuration file format.
+   *
+   * This format is written and read by McMd::BinaryConfigIo, and read
+   * by the mdPp Tools::BinaryConfigReader. Molecules appear in order of
+   * species, and of molecule index within each species, as in the
+   * default mcSim and mdSim text format. A file contains:
+   *
+   *  - A text line with the magic string "SIMPBCFG" and the version.
+   *  - A text line with the Boundary, in the text config file format.
+   *  - A FileHeader record (number of species and flags).
+   *  - For each species, a SpeciesHeader record followed by one block
+   *    that holds, in this order, the positions of all atoms (3 doubles
+   *    per atom), their velocities if the HasVelocities flag is set
+   *    (3 doubles per atom), their atom type ids (one int32_t per atom),
+   *    and, if the species is mutable, the state id of each molecule
+   *    (one int32_t per molecule).
+   *
+   * Each species block may thus be read with a single bulk read, of
+   * blockSize() bytes. Placing the doubles first keeps them aligned in
+   * a buffer allocated by operator new. As for other native binary
+   * formats in Simpatico, integers and doubles use the representation
+   * of the writing machine.
+   *
+   * \ingroup Simp_Trajectory_Module
+   */
+   namespace BinaryConfig
+   {
+
+      /// Magic string at the beginning of the first line.
+      const char Magic[] = "SIMPBCFG";
+
+      /// Format version number.
+      const int Version = 1;
+
+      /// Flag bit set if velocities are stored.
+      const uint32_t HasVelocities = 1;
+
+      /**
+      * Record that follows the text lines of a file.
+      */
+      struct FileHeader
+      {
+         int32_t  nSpecies;
+         uint32_t flags;
+      };
+
+      /**
+      * Record at the beginning of the data for each species.
+      */
+      struct SpeciesHeader
+      {
+         int32_t nMolecule;
+         int32_t nAtom;      // atoms per molecule
+         int32_t isMutable;
+      };
+
+      /**
+      * Return number of bytes in the block of data for one species.
+      *
+      * \param header species header
+      * \param flags  flags of the file header
+      */
+      inline size_t blockSize(const SpeciesHeader& header, uint32_t flags)
+      {
+         size_t n = size_t(header.nMolecule)*size_t(header.nAtom);
+         size_t nDouble = (flags & HasVelocities) ? 6*n : 3*n;
+         size_t nInt = header.isMutable ? n + header.nMolecule : n;
+         return nDouble*sizeof(double) + nInt*sizeof(int32_t);
+      }
+
+   }
+
+}
+#endif
@@ -0,0 +1,331 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CompactTrajectory.h"
+#include <util/archives/BinaryFileOArchive.h>
+#include <util/archives/BinaryFileIArchive.h>
+#include <util/global.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   namespace
+   {
+
+      // Magic strings at beginning of file and at end of index.
+      const char HeaderMagic[8] = {'S','I','M','P','C','T','R','J'};
+      const char IndexMagic[8]  = {'C','T','R','J','I','N','D','X'};
+
+      /*
+      * Append unsigned integer as a variable length integer.
+      */
+      inline void appendVarint(unsigned int z, GArray<unsigned char>& bytes)
+      {
+         while (z >= 0x80) {
+            bytes.append((unsigned char)((z & 0x7F) | 0x80));
+            z >>= 7;
+         }
+         bytes.append((unsigned char)z);
+      }
+
+   }
+
+   const int CompactTrajectory::Version = 1;
+
+   /*
+   * Constructor.
+   */
+   CompactTrajectory::CompactTrajectory()
+    : offsets_(),
+      bytes_(),
+      nAtom_(0),
+      nBit_(0),
+      frameId_(0),
+      firstOffset_(0)
+   {}
+
+   /*
+   * Set number of atoms and number of bits per coordinate.
+   */
+   void CompactTrajectory::setParameters(int nAtom, int nBit)
+   {
+      if (nAtom <= 0) {
+         UTIL_THROW("Number of atoms must be positive");
+      }
+      if (nBit < 8 || nBit > 30) {
+         UTIL_THROW("Number of bits per coordinate must be in [8, 30]");
+      }
+      nAtom_ = nAtom;
+      nBit_ = nBit;
+   }
+
+   /*
+   * Write file header.
+   */
+   void CompactTrajectory::writeHeader(std::ofstream& file)
+   {
+      UTIL_CHECK(nAtom_ > 0);
+      file.write(HeaderMagic, 8);
+      BinaryFileOArchive ar(file);
+      int version = Version;
+      ar << version;
+      ar << nAtom_;
+      ar << nBit_;
+      firstOffset_ = (long)file.tellp();
+      offsets_.clear();
+   }
+
+   /*
+   * Write one frame, and record its offset.
+   */
+   void CompactTrajectory::writeFrame(std::ofstream& file, long iStep,
+                                      Boundary& boundary,
+                                      const DArray<Vector>& positions)
+   {
+      offsets_.append((long)file.tellp());
+      encode(positions, bytes_);
+      int nByte = bytes_.size();
+      BinaryFileOArchive ar(file);
+      ar << iStep;
+      ar << boundary;
+      ar << nByte;
+      file.write((const char*)(&bytes_[0]), nByte);
+   }
+
+   /*
+   * Write frame index at end of file.
+   */
+   void CompactTrajectory::writeIndex(std::ofstream& file)
+   {
+      long indexOffset = (long)file.tellp();
+      int nFrame = offsets_.size();
+      BinaryFileOArchive ar(file);
+      ar << nFrame;
+      for (int i = 0; i < nFrame; ++i) {
+         ar << offsets_[i];
+      }
+      ar << indexOffset;
+      file.write(IndexMagic, 8);
+   }
+
+   /*
+   * Read file header.
+   */
+   void CompactTrajectory::readHeader(std::ifstream& file)
+   {
+      char magic[8];
+      file.read(magic, 8);
+      if (!file || std::memcmp(magic, HeaderMagic, 8) != 0) {
+         UTIL_THROW("File is not a compact trajectory file");
+      }
+      BinaryFileIArchive ar(file);
+      int version;
+      ar >> version;
+      if (version != Version) {
+         UTIL_THROW("Unsupported compact trajectory format version");
+      }
+      int nAtom, nBit;
+      ar >> nAtom;
+      ar >> nBit;
+      setParameters(nAtom, nBit);
+      firstOffset_ = (long)file.tellg();
+      offsets_.clear();
+      frameId_ = 0;
+   }
+
+   /*
+   * Read frame index, or rebuild it by scanning the file.
+   */
+   bool CompactTrajectory::readIndex(std::ifstream& file)
+   {
+      BinaryFileIArchive ar(file);
+      offsets_.clear();
+
+      // Look for index at end of file
+      bool hasIndex = false;
+      long tailSize = (long)(sizeof(long) + 8);
+      file.seekg(0, std::ios::end);
+      long fileSize = (long)file.tellg();
+      if (fileSize >= firstOffset_ + tailSize + (long)sizeof(int)) {
+         long indexOffset;
+         char magic[8];
+         file.seekg(fileSize - tailSize);
+         ar >> indexOffset;
+         file.read(magic, 8);
+         if (file && std::memcmp(magic, IndexMagic, 8) == 0) {
+            int nFrame;
+            long offset;
+            file.seekg(indexOffset);
+            ar >> nFrame;
+            for (int i = 0; i < nFrame; ++i) {
+               ar >> offset;
+               offsets_.append(offset);
+            }
+            if (!file) {
+               UTIL_THROW("Error reading compact trajectory index");
+            }
+            hasIndex = true;
+         }
+      }
+
+      // If no index was found, scan frames without decoding positions
+      if (!hasIndex) {
+         file.clear();
+         file.seekg(firstOffset_);
+         Boundary boundary;
+         long iStep, offset;
+         int nByte;
+         while (true) {
+            offset = (long)file.tellg();
+            ar >> iStep;
+            ar >> boundary;
+            ar >> nByte;
+            if (!file) break;
+            file.seekg(nByte, std::ios::cur);
+            if (!file || (long)file.tellg() > fileSize) break;
+            offsets_.append(offset);
+         }
+      }
+
+      file.clear();
+      file.seekg(firstOffset_);
+      frameId_ = 0;
+      return hasIndex;
+   }
+
+   /*
+   * Position file at beginning of a frame.
+   */
+   void CompactTrajectory::seekFrame(std::ifstream& file, int frameId)
+   {
+      if (frameId < 0 || frameId >= offsets_.size()) {
+         UTIL_THROW("Frame index out of range");
+      }
+      file.clear();
+      file.seekg(offsets_[frameId]);
+      frameId_ = frameId;
+   }
+
+   /*
+   * Read next frame.
+   */
+   bool CompactTrajectory::readFrame(std::ifstream& file, long& iStep,
+                                     Boundary& boundary,
+                                     DArray<Vector>& positions)
+   {
+      if (frameId_ >= offsets_.size()) {
+         return false;
+      }
+      BinaryFileIArchive ar(file);
+      int nByte;
+      ar >> iStep;
+      ar >> boundary;
+      ar >> nByte;
+      if (!file || nByte <= 0) {
+         UTIL_THROW("Error reading compact trajectory frame");
+      }
+      bytes_.clear();
+      for (int i = 0; i < nByte; ++i) {
+         bytes_.append(0);
+      }
+      file.read((char*)(&bytes_[0]), nByte);
+      if (!file) {
+         UTIL_THROW("Incomplete compact trajectory frame");
+      }
+      decode(&bytes_[0], nByte, positions);
+      ++frameId_;
+      return true;
+   }
+
+   /*
+   * Encode scaled positions.
+   */
+   void CompactTrajectory::encode(const DArray<Vector>& positions,
+                                  GArray<unsigned char>& bytes) const
+   {
+      UTIL_CHECK(positions.capacity() >= nAtom_);
+      const unsigned int range = 1u << nBit_;
+      const unsigned int mask = range - 1;
+      const unsigned int half = range >> 1;
+      const double scale = double(range);
+      unsigned int previous[Dimension];
+      unsigned int q, d;
+      int s, i, j;
+      double r;
+
+      for (j = 0; j < Dimension; ++j) {
+         previous[j] = 0;
+      }
+      bytes.clear();
+      for (i = 0; i < nAtom_; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            r = positions[i][j];
+            r -= floor(r);
+            q = ((unsigned int)(r*scale)) & mask;
+
+            // Minimum image difference, as a signed integer
+            d = (q - previous[j]) & mask;
+            s = (d >= half) ? int(d) - int(range) : int(d);
+            previous[j] = q;
+
+            // Zig-zag encoding maps small |s| to small unsigned values
+            if (s >= 0) {
+               appendVarint(2u*(unsigned int)s, bytes);
+            } else {
+               appendVarint(2u*(unsigned int)(-s) - 1u, bytes);
+            }
+         }
+      }
+   }
+
+   /*
+   * Decode scaled positions.
+   */
+   void CompactTrajectory::decode(const unsigned char* bytes, int nByte,
+                                  DArray<Vector>& positions) const
+   {
+      UTIL_CHECK(positions.capacity() >= nAtom_);
+      const unsigned int range = 1u << nBit_;
+      const unsigned int mask = range - 1;
+      const double h = 1.0/double(range);
+      unsigned int previous[Dimension];
+      unsigned int z, c;
+      int s, i, j, k, shift;
+
+      for (j = 0; j < Dimension; ++j) {
+         previous[j] = 0;
+      }
+      k = 0;
+      for (i = 0; i < nAtom_; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            z = 0;
+            shift = 0;
+            do {
+               if (k >= nByte || shift > 28) {
+                  UTIL_THROW("Corrupt compact trajectory frame data");
+               }
+               c = bytes[k];
+               ++k;
+               z |= (c & 0x7F) << shift;
+               shift += 7;
+            } while (c & 0x80);
+            s = (z & 1) ? -int((z + 1) >> 1) : int(z >> 1);
+            previous[j] = (previous[j] + (unsigned int)s) & mask;
+            positions[i][j] = (double(previous[j]) + 0.5)*h;
+         }
+      }
+      if (k != nByte) {
+         UTIL_THROW("Inconsistent size of compact trajectory frame");
+      }
+   }
+
+}
@@ -0,0 +1,236 @@
+#ifndef SIMP_COMPACT_TRAJECTORY_H
+#define SIMP_COMPACT_TRAJECTORY_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/boundary/Boundary.h>      // typedef
+#include <util/containers/DArray.h>      // member
+#include <util/containers/GArray.h>      // member
+#include <util/space/Vector.h>           // member template argument
+
+#include <fstream>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Compact binary trajectory format, with a frame index.
+   *
+   * This class implements encoding, decoding and random access for a
+   * versioned binary trajectory format that is written by the ddSim
+   * DdMdCompactTrajectoryWriter analyzer and read by the corresponding
+   * mcMd and tools trajectory readers.
+   *
+   * Atomic positions are stored as scaled (generalized) coordinates,
+   * in the range [0,1), for atoms ordered by atom id, and quantized to
+   * nBit bits per coordinate. The quantized coordinates of each atom
+   * are stored as differences from those of the previous atom, using
+   * the minimum image convention, and written as variable length
+   * integers. Because atoms with consecutive ids are usually close in
+   * space, most differences fit in one or two bytes. The resolution
+   * along each Bravais lattice vector is 1/2^nBit of the box length.
+   *
+   * File layout:
+   *
+   *  - Header: magic string "SIMPCTRJ", version, nAtom, nBit
+   *  - Frames: iStep, Boundary, number of bytes, encoded positions
+   *  - Index: nFrame, byte offset of each frame, index offset, and
+   *    the magic string "CTRJINDX" as the last 8 bytes.
+   *
+   * The index is written when the file is closed. If it is missing
+   * (e.g., if a simulation did not finish), readIndex() rebuilds it by
+   * a scan that skips over frame payloads without decoding them.
+   *
+   * Like other native binary formats in Simpatico, integers and Boundary
+   * data use the native representation of the writing machine.
+   *
+   * \ingroup Simp_Trajectory_Module
+   */
+   class CompactTrajectory
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      CompactTrajectory();
+
+      /**
+      * Set number of atoms and number of bits per coordinate.
+      *
+      * \param nAtom total number of atoms (ids 0, ..., nAtom - 1)
+      * \param nBit  number of bits per coordinate, 8 <= nBit <= 30
+      */
+      void setParameters(int nAtom, int nBit);
+
+      /// \name Writing
+      //@{
+
+      /**
+      * Write file header.
+      *
+      * \pre setParameters() has been called.
+      *
+      * \param file output file, opened in binary mode
+      */
+      void writeHeader(std::ofstream& file);
+
+      /**
+      * Write one frame and record its offset in the index.
+      *
+      * \param file output file
+      * \param iStep time step index
+      * \param boundary periodic boundary
+      * \param positions scaled atomic positions, indexed by atom id
+      */
+      void writeFrame(std::ofstream& file, long iStep, Boundary& boundary,
+                      const DArray<Vector>& positions);
+
+      /**
+      * Write the frame index at the end of the file.
+      *
+      * \param file output file
+      */
+      void writeIndex(std::ofstream& file);
+
+      //@}
+      /// \name Reading
+      //@{
+
+      /**
+      * Read file header, and set nAtom and nBit.
+      *
+      * \param file input file, opened in binary mode
+      */
+      void readHeader(std::ifstream& file);
+
+      /**
+      * Read or rebuild the frame index, and seek to the first frame.
+      *
+      * \pre readHeader() has been called.
+      *
+      * \param file input file
+      * \return true if an index was found, false if it was rebuilt
+      */
+      bool readIndex(std::ifstream& file);
+
+      /**
+      * Position the file at the beginning of a frame.
+      *
+      * \param file input file
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      void seekFrame(std::ifstream& file, int frameId);
+
+      /**
+      * Read the next frame.
+      *
+      * \param file input file
+      * \param iStep time step index (output)
+      * \param boundary periodic boundary (output)
+      * \param positions scaled atomic positions, indexed by id (output)
+      * \return true if a frame was read, false if at end of trajectory
+      */
+      bool readFrame(std::ifstream& file, long& iStep, Boundary& boundary,
+                     DArray<Vector>& positions);
+
+      //@}
+      /// \name Encoding
+      //@{
+
+      /**
+      * Encode scaled positions.
+      *
+      * \param positions scaled positions, indexed by atom id
+      * \param bytes encoded data (output, cleared on entry)
+      */
+      void encode(const DArray<Vector>& positions,
+                  GArray<unsigned char>& bytes) const;
+
+      /**
+      * Decode scaled positions.
+      *
+      * Each position is set to the center of its quantization bin.
+      *
+      * \param bytes pointer to encoded data
+      * \param nByte number of bytes of encoded data
+      * \param positions scaled positions, indexed by atom id (output)
+      */
+      void decode(const unsigned char* bytes, int nByte,
+                  DArray<Vector>& positions) const;
+
+      //@}
+      /// \name Accessors
+      //@{
+
+      /**
+      * Get the number of atoms per frame.
+      */
+      int nAtom() const;
+
+      /**
+      * Get the number of bits per coordinate.
+      */
+      int nBit() const;
+
+      /**
+      * Get the number of frames in the index.
+      */
+      int nFrame() const;
+
+      /**
+      * Get the index of the next frame to be read.
+      */
+      int frameId() const;
+
+      //@}
+
+      /// Format version number.
+      static const int Version;
+
+   private:
+
+      /// Byte offsets of frames from the beginning of the file.
+      GArray<long> offsets_;
+
+      /// Buffer for encoded frame data.
+      GArray<unsigned char> bytes_;
+
+      /// Number of atoms per frame.
+      int nAtom_;
+
+      /// Number of bits per coordinate.
+      int nBit_;
+
+      /// Index of next frame to be read.
+      int frameId_;
+
+      /// Byte offset of first frame (end of header).
+      long firstOffset_;
+
+   };
+
+   // Inline functions
+
+   inline int CompactTrajectory::nAtom() const
+   {  return nAtom_; }
+
+   inline int CompactTrajectory::nBit() const
+   {  return nBit_; }
+
+   inline int CompactTrajectory::nFrame() const
+   {  return offsets_.size(); }
+
+   inline int CompactTrajectory::frameId() const
+   {  return frameId_; }
+
+}
+#endif
@@ -0,0 +1,60 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "LammpsDumpFormat.h"
+#include <util/space/Dimension.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /*
+   * Format one atom line.
+   */
+   int LammpsDumpFormat::formatAtom(char* buffer, int id, int typeId, 
+                                    int molId, const Vector& r)
+   {
+      int n = snprintf(buffer, MaxLineLength, 
+                       "%d %d %d %13.12e %13.12e %13.12e 0 0 0 \n",
+                       id + 1, typeId + 1, molId, r[0], r[1], r[2]);
+      if (n >= MaxLineLength) {
+         n = MaxLineLength - 1;
+      }
+      return n;
+   }
+
+   /*
+   * Parse one atom line.
+   */
+   bool LammpsDumpFormat::parseAtom(const char* line, int& id, int& typeId,
+                                    int& molId, Vector& r)
+   {
+      const char* ptr = line;
+      char* end;
+
+      id = int(strtol(ptr, &end, 10)) - 1;
+      if (end == ptr) return false;
+      ptr = end;
+      typeId = int(strtol(ptr, &end, 10)) - 1;
+      if (end == ptr) return false;
+      ptr = end;
+      molId = int(strtol(ptr, &end, 10));
+      if (end == ptr) return false;
+      ptr = end;
+      for (int j = 0; j < Dimension; ++j) {
+         r[j] = strtod(ptr, &end);
+         if (end == ptr) return false;
+         ptr = end;
+      }
+      return true;
+   }
+
+}
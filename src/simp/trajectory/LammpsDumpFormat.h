@@ -0,0 +1,77 @@
+#ifndef SIMP_LAMMPS_DUMP_FORMAT_H
+#define SIMP_LAMMPS_DUMP_FORMAT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/space/Vector.h>
+
+namespace Simp
+{
+
+   using namespace Util;
+
+   /**
+   * Formatting and parsing of atom lines of a Lammps dump file.
+   *
+   * Each line of the ITEM: ATOMS block written by the Lammps dump 
+   * writers of all programs has the form
+   * \code
+   *    id type mol x y z ix iy iz
+   * \endcode
+   * in which id, type and mol use the Lammps convention of integers 
+   * beginning at 1, and ix, iy and iz are image flags. Positions are
+   * written in %13.12e format, and image flags are written as 0.
+   *
+   * The functions of this class use only their arguments, with no 
+   * locale or stream state, so that lines of disjoint ranges of atoms 
+   * can be formatted or parsed concurrently by different threads. 
+   *
+   * \ingroup Simp_Trajectory_Module
+   */
+   class LammpsDumpFormat
+   {
+
+   public:
+
+      /**
+      * Minimum size of a buffer passed to formatAtom.
+      */
+      enum { MaxLineLength = 160 };
+
+      /**
+      * Format one atom line, including the final newline.
+      *
+      * \param buffer  output character buffer, size >= MaxLineLength
+      * \param id  atom id (Simpatico convention, beginning at 0)
+      * \param typeId  atom type id (beginning at 0)
+      * \param molId  molecule id (Lammps convention, beginning at 1)
+      * \param r  atomic position
+      * \return number of characters written, not including a final null
+      */
+      static 
+      int formatAtom(char* buffer, int id, int typeId, int molId, 
+                     const Vector& r);
+
+      /**
+      * Parse one atom line. Image flags, if any, are ignored.
+      *
+      * \param line  null terminated line of text
+      * \param id  atom id, converted to Simpatico convention (output)
+      * \param typeId  atom type id, converted to Simpatico (output)
+      * \param molId  molecule id, as written (output)
+      * \param r  atomic position (output)
+      * \return true if the line is valid, false otherwise
+      */
+      static 
+      bool parseAtom(const char* line, int& id, int& typeId, int& molId,
+                     Vector& r);
+
+   };
+
+}
+#endif
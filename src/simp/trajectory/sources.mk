@@ -0,0 +1,9 @@
+simp_trajectory_= \
+    simp/trajectory/CompactTrajectory.cpp \
+    simp/trajectory/LammpsDumpFormat.cpp
+
+simp_trajectory_SRCS=\
+     $(addprefix $(SRC_DIR)/, $(simp_trajectory_))
+simp_trajectory_OBJS=\
+     $(addprefix $(BLD_DIR)/, $(simp_trajectory_:.cpp=.o))
+
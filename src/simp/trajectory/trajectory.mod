@@ -0,0 +1,10 @@
+namespace Simp {
+
+   /**
+   * \defgroup Simp_Trajectory_Module Trajectory
+   * \ingroup Simp_Module
+   *
+   * Trajectory file formats shared by simulation and analysis programs.
+   */
+
+}
@@ -8,6 +8,7 @@
 #include "Analyzer.h"
 #include <tools/processor/Processor.h>
 #include <util/misc/FileMaster.h>
+#include <util/archives/Serializable_includes.h>
 #include <util/global.h>
 
 namespace Tools
@@ -88,6 +89,26 @@ namespace Tools
    void Analyzer::readOutputFileName(std::istream &in)
    {  read<std::string>(in, "outputFileName", outputFileName_); }
 
+   /*
+   * Save statistical state (default throws).
+   */
+   void Analyzer::saveState(Serializable::OArchive& ar)
+   {
+      std::string msg = "Analyzer does not support checkpoints: ";
+      msg += className();
+      UTIL_THROW(msg.c_str());
+   }
+
+   /*
+   * Load statistical state (default throws).
+   */
+   void Analyzer::loadState(Serializable::IArchive& ar)
+   {
+      std::string msg = "Analyzer does not support checkpoints: ";
+      msg += className();
+      UTIL_THROW(msg.c_str());
+   }
+
    /*
    * Get the outputFileName string with an added suffix
    */
@@ -114,6 +114,55 @@ namespace Tools
       */
       virtual void output()
       {}
+
+      /**
+      * Save the statistical state of this analyzer to an archive.
+      *
+      * Called after sample() by a trajectory analysis that writes
+      * checkpoint files. Subclasses save accumulators and any other
+      * data needed to continue sampling, but not parameters, which are
+      * read again from the parameter file of a restarted job. The
+      * default implementation throws an Exception.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load the statistical state of this analyzer from an archive.
+      *
+      * Called after setup() when a trajectory analysis is restarted
+      * from a checkpoint file, to restore the state saved by
+      * saveState(). The default implementation throws an Exception.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * May the frames of a trajectory be divided among processors?
+      *
+      * If all analyzers return true, the ANALYZE_TRAJECTORY_FRAMES
+      * command of an MPI mdPp run gives each processor a contiguous block
+      * of the selected frames. Analyzers of time correlations must return
+      * false. The default implementation returns false.
+      */
+      virtual bool isFrameParallel() const
+      {  return false; }
+
+      /**
+      * Combine results of all processors on processor 0.
+      *
+      * Called on all processors after frame-parallel sampling, before
+      * output(), which is then called only on processor 0. The default
+      * implementation is empty.
+      *
+      * \param communicator communicator for all processors
+      */
+      virtual void reduce(MPI::Intracomm& communicator)
+      {}
+      #endif
   
       /**
       * Get interval value.
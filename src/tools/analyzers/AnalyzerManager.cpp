@@ -6,6 +6,9 @@
 */
 
 #include "AnalyzerManager.h" 
+#include <util/archives/Serializable_includes.h>
+
+#include <string>
 
 namespace Tools
 {
@@ -77,4 +80,64 @@ namespace Tools
       }
    }
 
+   /*
+   * Save state of each analyzer, preceded by its class name.
+   */
+   void AnalyzerManager::saveState(Serializable::OArchive& ar)
+   {
+      int n = size();
+      ar << n;
+      std::string name;
+      for (int i=0; i < size(); ++i) {
+         name = (*this)[i].className();
+         ar << name;
+         (*this)[i].saveState(ar);
+      }
+   }
+
+   /*
+   * Load state of each analyzer, checking its class name.
+   */
+   void AnalyzerManager::loadState(Serializable::IArchive& ar)
+   {
+      int n;
+      ar >> n;
+      if (n != size()) {
+         UTIL_THROW("Inconsistent number of analyzers in checkpoint");
+      }
+      std::string name;
+      for (int i=0; i < size(); ++i) {
+         ar >> name;
+         if (name != (*this)[i].className()) {
+            UTIL_THROW("Inconsistent analyzer class in checkpoint");
+         }
+         (*this)[i].loadState(ar);
+      }
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Return true iff every analyzer is frame parallel.
+   */
+   bool AnalyzerManager::isFrameParallel() const
+   {
+      for (int i=0; i < size(); ++i) {
+         if (!(*this)[i].isFrameParallel()) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /*
+   * Call reduce method of each analyzer.
+   */
+   void AnalyzerManager::reduce(MPI::Intracomm& communicator)
+   {
+      for (int i=0; i < size(); ++i) {
+         (*this)[i].reduce(communicator);
+      }
+   }
+   #endif
+
 }
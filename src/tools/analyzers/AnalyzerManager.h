@@ -67,6 +67,37 @@ namespace Tools
       * Call output method of each analyzer.
       */
       void output();
+
+      /**
+      * Save the state of every analyzer to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load the state of every analyzer from an archive.
+      *
+      * Throws an Exception if the number or classes of the analyzers
+      * differ from those that saved the archive.
+      *
+      * \param ar input/loading archive
+      */
+      void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * Return true iff every analyzer is frame parallel.
+      */
+      bool isFrameParallel() const;
+
+      /**
+      * Call reduce method of each analyzer.
+      *
+      * \param communicator communicator for all processors
+      */
+      void reduce(MPI::Intracomm& communicator);
+      #endif
  
    };
 
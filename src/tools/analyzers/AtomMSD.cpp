@@ -182,6 +182,28 @@ namespace Tools
 
    }
 
+   /*
+   * Save statistical state to an archive.
+   */
+   void AtomMSD::saveState(Serializable::OArchive& ar)
+   {
+      ar & accumulator_;
+      ar & oldPositions_;
+      ar & shifts_;
+      ar & nMolecule_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void AtomMSD::loadState(Serializable::IArchive& ar)
+   {
+      ar & accumulator_;
+      ar & oldPositions_;
+      ar & shifts_;
+      ar & nMolecule_;
+   }
+
    /// Output results to file after simulation is completed.
    void AtomMSD::output() 
    {  
@@ -67,6 +67,20 @@ namespace Tools
       */
       virtual void output();
 
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
    private:
  
       /// Output file stream
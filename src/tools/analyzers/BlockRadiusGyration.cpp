@@ -0,0 +1,219 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BlockRadiusGyration.h"
+#include <tools/chemistry/Molecule.h>
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Species.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/format/Dbl.h>
+#include <util/archives/Serializable_includes.h>
+#ifdef TOOLS_OPENMP
+#include <omp.h>
+#endif
+
+#include <util/global.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   BlockRadiusGyration::BlockRadiusGyration(Processor& processor) 
+    : Analyzer(processor),
+      outputFile_(),
+      accumulator_(),
+      current_(),
+      threadSums_(),
+      nAtomType_(-1),
+      speciesId_(-1),
+      nAtom_(-1),
+      isInitialized_(false)
+   {  setClassName("BlockRadiusGyration"); }
+
+   /*
+   * Constructor.
+   */
+   BlockRadiusGyration::BlockRadiusGyration(Configuration& configuration, 
+                                            FileMaster& fileMaster) 
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      accumulator_(),
+      current_(),
+      threadSums_(),
+      nAtomType_(-1),
+      speciesId_(-1),
+      nAtom_(-1),
+      isInitialized_(false)
+   {  setClassName("BlockRadiusGyration"); }
+
+   /*
+   * Read parameters from file, and allocate sums.
+   */
+   void BlockRadiusGyration::readParameters(std::istream& in) 
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nAtomType", nAtomType_);
+      read<int>(in, "speciesId", speciesId_);
+
+      // Validate parameters
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+      if (speciesId_ >= configuration().nSpecies()) {
+         UTIL_THROW("speciesId > nSpecies");
+      }
+      nAtom_ = configuration().species(speciesId_).nAtom();
+
+      accumulator_.allocate(nAtomType_, nAtom_);
+      current_.allocate(nAtomType_, nAtom_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Clear accumulator, allocate per-thread sums, and open file.
+   */
+   void BlockRadiusGyration::setup() 
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      int nThread = 1;
+      #ifdef TOOLS_OPENMP
+      nThread = omp_get_max_threads();
+      #endif
+      if (!threadSums_.isAllocated()) {
+         threadSums_.allocate(nThread);
+         for (int t = 0; t < nThread; ++t) {
+            threadSums_[t].allocate(nAtomType_, nAtom_);
+         }
+      }
+      accumulator_.clear();
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+   }
+
+   /*
+   * Evaluate block radii of gyration of all molecules of the species.
+   */
+   void BlockRadiusGyration::sample(long iStep) 
+   { 
+      if (!isAtInterval(iStep)) return;
+
+      Species& species = configuration().species(speciesId_);
+      Boundary& boundary = configuration().boundary();
+      int nMolecule = species.size();
+      int nThread = threadSums_.capacity();
+
+      // Accumulate sums for a subset of molecules in each thread
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef TOOLS_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         BlockGyration& sums = threadSums_[threadId];
+         Molecule* moleculePtr;
+         Vector dR;
+         int i, j;
+
+         sums.clear();
+         #ifdef TOOLS_OPENMP
+         #pragma omp for schedule(static)
+         #endif
+         for (i = 0; i < nMolecule; ++i) {
+            moleculePtr = &species.molecule(i);
+
+            // Construct map of molecule with no periodic boundary conditions
+            sums.position(0) = moleculePtr->atom(0).position;
+            sums.typeId(0) = moleculePtr->atom(0).typeId;
+            for (j = 1; j < nAtom_; ++j) {
+               boundary.distanceSq(moleculePtr->atom(j).position,
+                                   moleculePtr->atom(j-1).position, dR);
+               sums.position(j) = sums.position(j-1);
+               sums.position(j) += dR;
+               sums.typeId(j) = moleculePtr->atom(j).typeId;
+            }
+            sums.addMolecule(nAtom_);
+         }
+      }
+
+      // Combine thread sums, in thread order
+      current_.clear();
+      for (int t = 0; t < nThread; ++t) {
+         current_.add(threadSums_[t]);
+      }
+      accumulator_.add(current_);
+
+      outputFile_ << iStep;
+      writeValues(current_);
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void BlockRadiusGyration::saveState(Serializable::OArchive& ar)
+   {
+      ar & accumulator_;
+      outputFile_.flush();
+   }
+
+   /*
+   * Load statistical state, and append to the per-frame output file.
+   */
+   void BlockRadiusGyration::loadState(Serializable::IArchive& ar)
+   {
+      ar & accumulator_;
+      outputFile_.close();
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_,
+                                  std::ios::out | std::ios::app);
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void BlockRadiusGyration::output() 
+   {  
+      outputFile_.close();
+
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_); 
+      outputFile_.close();
+
+      // Output averages over all frames
+      fileMaster().openOutputFile(outputFileName(".ave"), outputFile_);
+      writeValues(accumulator_);
+      outputFile_.close();
+   }
+
+   /*
+   * Write values for types i, then for pairs (i, j > i) (private).
+   */
+   void BlockRadiusGyration::writeValues(const BlockGyration& sums)
+   {
+      int i, j;
+      for (i = 0; i < nAtomType_; ++i) {
+         outputFile_ << Dbl(sums.radiusSq(i));
+         for (j = i+1; j < nAtomType_; ++j) {
+            outputFile_ << Dbl(sums.distanceSq(i, j));
+         }
+      }
+      outputFile_ << std::endl;
+   }
+
+}
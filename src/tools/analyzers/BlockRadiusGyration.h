@@ -0,0 +1,134 @@
+#ifndef TOOLS_BLOCK_RADIUS_GYRATION_H
+#define TOOLS_BLOCK_RADIUS_GYRATION_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>           // base class
+#include <simp/analysis/BlockGyration.h>        // member
+#include <util/containers/DArray.h>             // member template
+
+namespace Tools
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * Radii of gyration of blocks of atoms of the same type in a species.
+   *
+   * A block is the set of all atoms of one type within a molecule. For
+   * each frame, this analyzer writes the mean-squared radius of gyration
+   * of each type of block, and the mean-squared distance between the
+   * centers of mass of each pair of types of block, averaged over all
+   * molecules of one species. Averages over all frames are written at
+   * the end. When compiled with TOOLS_OPENMP defined, molecules are 
+   * divided among threads.
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class BlockRadiusGyration : public Analyzer
+   {
+   
+   public:
+  
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      BlockRadiusGyration(Processor &processor);
+  
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      BlockRadiusGyration(Configuration &configuration, 
+                          FileMaster& fileMaster);
+  
+      /** 
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+  
+      /** 
+      * Clear accumulator, allocate per-thread sums, and open file.
+      */
+      virtual void setup();
+   
+      /** 
+      * Evaluate block radii of gyration of all molecules of the species.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * Flushes the per-frame output file.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * Reopens the per-frame output file for appending. Frames written
+      * after the checkpoint by an interrupted job appear twice.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+   private:
+ 
+      /// Output file stream
+      std::ofstream outputFile_;
+
+      /// Sums over all molecules of all frames.
+      BlockGyration accumulator_;
+
+      /// Sums over all molecules of the current frame.
+      BlockGyration current_;
+
+      /// Sums over molecules of the current frame, one per thread.
+      DArray<BlockGyration> threadSums_;
+
+      /// Number of atom types.
+      int nAtomType_;
+   
+      /// Index of relevant Species.
+      int speciesId_;
+   
+      /// Number of atoms per molecule of the species.
+      int nAtom_;
+   
+      /// Has readParam been called?
+      int isInitialized_;
+   
+      /**
+      * Write one value per type and per pair of types to outputFile_.
+      *
+      * \param sums sums to be written
+      */
+      void writeValues(const BlockGyration& sums);
+
+   };
+
+}
+#endif
@@ -0,0 +1,188 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "CompositionProfile.h"
+#include <tools/chemistry/Atom.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/format/Dbl.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <util/global.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   CompositionProfile::CompositionProfile(Processor& processor) 
+    : Analyzer(processor),
+      outputFile_(),
+      accumulator_(),
+      intVectors_(),
+      waveVectors_(),
+      nAtomType_(-1),
+      nDirection_(-1),
+      nBins_(-1),
+      isInitialized_(false)
+   {  setClassName("CompositionProfile"); }
+
+   /*
+   * Constructor.
+   */
+   CompositionProfile::CompositionProfile(Configuration& configuration, 
+                                          FileMaster& fileMaster) 
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      accumulator_(),
+      intVectors_(),
+      waveVectors_(),
+      nAtomType_(-1),
+      nDirection_(-1),
+      nBins_(-1),
+      isInitialized_(false)
+   {  setClassName("CompositionProfile"); }
+
+   /*
+   * Read parameters from file, and allocate histograms.
+   */
+   void CompositionProfile::readParameters(std::istream& in) 
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nAtomType", nAtomType_);
+      read<int>(in, "nDirection", nDirection_);
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      if (nDirection_ <= 0) {
+         UTIL_THROW("nDirection <= 0");
+      }
+      intVectors_.allocate(nDirection_);
+      readDArray<IntVector>(in, "intVectors", intVectors_, nDirection_);
+      read<int>(in, "nBins", nBins_);
+      if (nBins_ <= 0) {
+         UTIL_THROW("nBins <= 0");
+      }
+
+      waveVectors_.allocate(nDirection_);
+      accumulator_.allocate(nDirection_, nAtomType_, nBins_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Clear accumulator.
+   */
+   void CompositionProfile::setup() 
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      accumulator_.clear();
+   }
+
+   /*
+   * Add all atoms of the current frame to histograms.
+   */
+   void CompositionProfile::sample(long iStep) 
+   { 
+      if (!isAtInterval(iStep)) return;
+
+      // Calculate directions for the current boundary
+      Boundary& boundary = configuration().boundary();
+      Vector lengths = boundary.lengths();
+      Vector dWave;
+      int i, j;
+      for (i = 0; i < nDirection_; ++i) {
+         waveVectors_[i].zero();
+         for (j = 0; j < Dimension; ++j) {
+            dWave  = boundary.reciprocalBasisVector(j);
+            dWave *= intVectors_[i][j];
+            waveVectors_[i] += dWave;
+         }
+         accumulator_.setDirection(i, waveVectors_[i], lengths);
+      }
+
+      // Add all atoms, with positions shifted into the primary cell
+      Vector r;
+      AtomStorage::Iterator atomIter;
+      configuration().atoms().begin(atomIter); 
+      for ( ; atomIter.notEnd(); ++atomIter) {
+         if (atomIter->typeId >= nAtomType_) {
+            UTIL_THROW("Atom typeId >= nAtomType");
+         }
+         r = atomIter->position;
+         boundary.shift(r);
+         accumulator_.sample(r, atomIter->typeId);
+      }
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void CompositionProfile::saveState(Serializable::OArchive& ar)
+   {
+      ar & accumulator_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void CompositionProfile::loadState(Serializable::IArchive& ar)
+   {
+      ar & accumulator_;
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void CompositionProfile::output() 
+   {  
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_); 
+      outputFile_.close();
+
+      // Output histograms to separate data file
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+      int i, j, k;
+      for (i = 0; i < nDirection_; ++i) {
+         for (j = 0; j < Dimension; ++j) {
+            outputFile_ << Dbl(waveVectors_[i][j], 5);
+         }
+         outputFile_ << std::endl;
+         for (k = 0; k < nAtomType_; ++k) {
+            accumulator_.output(outputFile_, i, k);
+            outputFile_ << std::endl;
+         }
+      }
+      outputFile_.close();
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Sum histograms of all processors on processor 0.
+   */
+   void CompositionProfile::reduce(MPI::Intracomm& communicator)
+   {
+      int size = accumulator_.size();
+      if (communicator.Get_rank() == 0) {
+         communicator.Reduce(MPI::IN_PLACE, accumulator_.data(), size,
+                             MPI::LONG, MPI::SUM, 0);
+      } else {
+         communicator.Reduce(accumulator_.data(), 0, size,
+                             MPI::LONG, MPI::SUM, 0);
+      }
+   }
+   #endif
+
+}
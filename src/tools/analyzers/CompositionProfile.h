@@ -0,0 +1,135 @@
+#ifndef TOOLS_COMPOSITION_PROFILE_H
+#define TOOLS_COMPOSITION_PROFILE_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>           // base class
+#include <simp/analysis/ProfileHistogram.h>     // member
+#include <util/containers/DArray.h>             // member template
+#include <util/space/IntVector.h>               // member template parameter
+#include <util/space/Vector.h>                  // member template parameter
+
+namespace Tools
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * Histograms of atom positions along reciprocal lattice directions.
+   *
+   * For each of nDirection directions, each defined by integer indices
+   * of a reciprocal lattice vector, this analyzer accumulates a histogram
+   * of the reduced coordinates of atoms of each type along that
+   * direction, over all frames.
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class CompositionProfile : public Analyzer
+   {
+   
+   public:
+  
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      CompositionProfile(Processor &processor);
+  
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      CompositionProfile(Configuration &configuration, FileMaster& fileMaster);
+  
+      /** 
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+  
+      /** 
+      * Clear accumulator.
+      */
+      virtual void setup();
+   
+      /** 
+      * Add all atoms of the current frame to histograms.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * Return true: each frame is analyzed independently.
+      */
+      virtual bool isFrameParallel() const
+      {  return true; }
+
+      /**
+      * Sum histograms of all processors on processor 0.
+      *
+      * \param communicator communicator for all processors
+      */
+      virtual void reduce(MPI::Intracomm& communicator);
+      #endif
+
+   private:
+ 
+      /// Output file stream
+      std::ofstream outputFile_;
+
+      /// Accumulated histograms.
+      ProfileHistogram accumulator_;
+
+      /// Integer indices of reciprocal vectors that define directions.
+      DArray<IntVector> intVectors_;
+
+      /// Reciprocal vectors for the most recent frame.
+      DArray<Vector> waveVectors_;
+
+      /// Number of atom types.
+      int nAtomType_;
+   
+      /// Number of directions.
+      int nDirection_;
+   
+      /// Number of bins per histogram.
+      int nBins_;
+   
+      /// Has readParam been called?
+      int isInitialized_;
+   
+   };
+
+}
+#endif
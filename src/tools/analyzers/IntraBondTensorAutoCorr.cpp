@@ -0,0 +1,210 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "IntraBondTensorAutoCorr.h"
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Group.h>
+#include <tools/chemistry/Species.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Vector.h>
+#include <util/space/Dimension.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <util/global.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   IntraBondTensorAutoCorr::IntraBondTensorAutoCorr(Processor& processor) 
+    : Analyzer(processor),
+      outputFile_(),
+      accumulator_(),
+      data_(),
+      speciesId_(-1),
+      nMolecule_(-1),
+      capacity_(-1),
+      nLevel_(1),
+      blockFactor_(2),
+      isInitialized_(false)
+   {  setClassName("IntraBondTensorAutoCorr"); }
+
+   /*
+   * Constructor.
+   */
+   IntraBondTensorAutoCorr::IntraBondTensorAutoCorr(
+                                           Configuration& configuration, 
+                                           FileMaster& fileMaster) 
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      accumulator_(),
+      data_(),
+      speciesId_(-1),
+      nMolecule_(-1),
+      capacity_(-1),
+      nLevel_(1),
+      blockFactor_(2),
+      isInitialized_(false)
+   {  setClassName("IntraBondTensorAutoCorr"); }
+
+   /*
+   * Read parameters from file, and allocate memory.
+   */
+   void IntraBondTensorAutoCorr::readParameters(std::istream& in) 
+   {
+      #ifndef SIMP_BOND
+      UTIL_THROW("IntraBondTensorAutoCorr requires bonds (SIMP_BOND)");
+      #endif
+
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "speciesId", speciesId_);
+      read<int>(in, "capacity", capacity_);
+      nLevel_ = 1;
+      readOptional<int>(in, "nLevel", nLevel_);
+      blockFactor_ = 2;
+      readOptional<int>(in, "blockFactor", blockFactor_);
+
+      // Validate parameters
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+      if (speciesId_ >= configuration().nSpecies()) {
+         UTIL_THROW("speciesId >= nSpecies");
+      }
+      if (capacity_ <= 0) {
+         UTIL_THROW("Nonpositive capacity");
+      }
+      int speciesCapacity = configuration().species(speciesId_).capacity();
+      if (speciesCapacity <= 0) {
+         UTIL_THROW("Species capacity <= 0");
+      }
+
+      // Allocate memory
+      data_.allocate(speciesCapacity);
+      accumulator_.setParam(speciesCapacity, capacity_, 
+                            blockFactor_, nLevel_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Set number of molecules and clear accumulator.
+   */
+   void IntraBondTensorAutoCorr::setup() 
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nMolecule_ = configuration().species(speciesId_).size();
+      if (nMolecule_ <= 0) {
+         UTIL_THROW("nMolecule <= 0");
+      }
+      accumulator_.setNEnsemble(nMolecule_);
+      accumulator_.clear();
+   }
+
+   /*
+   * Evaluate bond tensors of all molecules, add to ensemble.
+   */
+   void IntraBondTensorAutoCorr::sample(long iStep) 
+   { 
+      if (!isAtInterval(iStep)) return;
+
+      // Confirm that nMolecule is unchanged.
+      if (nMolecule_ != configuration().species(speciesId_).size()) {
+         UTIL_THROW("Number of molecules has changed.");
+      }
+
+      int i, j;
+      for (i = 0; i < nMolecule_; ++i) {
+         data_[i].zero();
+      }
+
+      #ifdef SIMP_BOND
+      Boundary& boundary = configuration().boundary();
+      AtomStorage& atoms = configuration().atoms();
+      Configuration::BondIterator iter;
+      Atom* atom0Ptr;
+      Atom* atom1Ptr;
+      Tensor t;
+      Vector dr, u;
+
+      // Add bond orientation dyads to the tensor of the parent molecule
+      for (configuration().bonds().begin(iter); iter.notEnd(); ++iter) {
+         atom0Ptr = atoms.ptr(iter->atomIds[0]);
+         atom1Ptr = atoms.ptr(iter->atomIds[1]);
+         if (!atom0Ptr || !atom1Ptr) {
+            UTIL_THROW("Bond atom not found");
+         }
+         if (atom0Ptr->speciesId != speciesId_) continue;
+         i = atom0Ptr->moleculeId;
+         if (i < 0 || i >= nMolecule_) {
+            UTIL_THROW("Invalid moleculeId");
+         }
+         boundary.distanceSq(atom0Ptr->position, atom1Ptr->position, dr);
+         u.versor(dr);
+         t.dyad(u, u);
+         data_[i] += t;
+      }
+      #endif
+
+      // Remove traces
+      double trace;
+      for (i = 0; i < nMolecule_; ++i) {
+         trace = data_[i].trace()/double(Dimension);
+         for (j = 0; j < Dimension; ++j) {
+            data_[i](j, j) -= trace;
+         }
+      }
+
+      accumulator_.sample(data_);
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void IntraBondTensorAutoCorr::saveState(Serializable::OArchive& ar)
+   {
+      ar & accumulator_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void IntraBondTensorAutoCorr::loadState(Serializable::IArchive& ar)
+   {
+      ar & accumulator_;
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void IntraBondTensorAutoCorr::output() 
+   {  
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_); 
+      outputFile_ << std::endl;
+      outputFile_ << "nMolecule      " << accumulator_.nEnsemble() 
+                  << std::endl;
+      outputFile_ << "nSample        " << accumulator_.nSample() 
+                  << std::endl;
+      outputFile_.close();
+
+      // Output autocorrelation function to separate data file
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+      accumulator_.output(outputFile_); 
+      outputFile_.close();
+   }
+
+}
@@ -0,0 +1,137 @@
+#ifndef TOOLS_INTRA_BOND_TENSOR_AUTO_CORR_H
+#define TOOLS_INTRA_BOND_TENSOR_AUTO_CORR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>              // base class
+#include <tools/analyzers/MultipleTauAutoCorr.h>   // member template
+#include <util/space/Tensor.h>                     // member template parameter
+#include <util/containers/DArray.h>                // member template
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Autocorrelation of the bond orientation tensor of each molecule.
+   *
+   * The bond orientation tensor for each molecule is defined as a sum
+   * \f[ 
+   *    S_{ij} = \sum_{a}( u_{ai}u_{aj} - \delta_{ij}/3 )
+   * \f]
+   * where \f$u_{ai}\f$ is the ith Cartesian component of a unit vector
+   * parallel to bond number a, and the sum is over all bonds in a 
+   * molecule. This analyzer calculates 
+   * \f[
+   *  C(t) = \sum_{i,j=0}^{2} \langle S_{ij}(t)S_{ij}(0) \rangle
+   * \f]
+   * for molecules of a specified species, using a MultipleTauAutoCorr
+   * accumulator. Bonds are assigned to molecules using the speciesId 
+   * and moleculeId of their first atom, and so the configuration file
+   * format must provide these indices.
+   *
+   * Parameters are the same as for McMd::IntraBondTensorAutoCorr, plus
+   * optional parameters nLevel (default 1, for a single level of 
+   * capacity frames) and blockFactor (default 2) for the multiple-tau
+   * correlator.
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class IntraBondTensorAutoCorr : public Analyzer
+   {
+   
+   public:
+  
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      IntraBondTensorAutoCorr(Processor &processor);
+  
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      IntraBondTensorAutoCorr(Configuration &configuration, 
+                              FileMaster& fileMaster);
+  
+      /** 
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+  
+      /** 
+      * Determine number of molecules and clear accumulator.
+      */
+      virtual void setup();
+   
+      /** 
+      * Evaluate bond tensors of all molecules, add to ensemble.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+   private:
+ 
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Statistical accumulator.
+      MultipleTauAutoCorr<Tensor, double> accumulator_;
+
+      /// Traceless bond tensors, one per molecule of species.
+      DArray<Tensor> data_;
+   
+      /// Index of relevant Species.
+      int speciesId_;
+   
+      /// Number of molecules in the species (must not change).
+      int nMolecule_;
+   
+      /// Number of frames stored per level of the accumulator.
+      int capacity_;
+   
+      /// Number of levels of the accumulator.
+      int nLevel_;
+   
+      /// Number of values averaged between levels.
+      int blockFactor_;
+   
+      /// Has readParam been called?
+      bool isInitialized_;
+   
+   };
+
+}
+#endif
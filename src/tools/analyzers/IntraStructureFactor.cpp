@@ -0,0 +1,419 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "IntraStructureFactor.h"
+#include <tools/analyzers/phaseSums.h>
+#include <tools/chemistry/Molecule.h>
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Species.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <util/global.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   #ifdef TOOLS_OFFLOAD
+   #pragma omp declare target
+   #endif
+   /*
+   * Add intramolecular sums of nMolecule molecules for one wavevector.
+   *
+   * Atoms of molecule m are atoms m*nAtom, ..., (m+1)*nAtom - 1. Array
+   * rho, of 2*(nAtomType + 1) doubles, is used as workspace for the 
+   * amplitudes of each type in one molecule, followed by the amplitude
+   * of all atoms. For each pair j, the sum over molecules of 
+   * Re[ rho_a^* rho_b ] is added to s[j], where a = pairs[2*j] and 
+   * b = pairs[2*j+1] are amplitude indices.
+   */
+   static inline
+   void addIntraSums(const double* x, const double* y, const double* z,
+                     const int* t, int nMolecule, int nAtom, 
+                     const double* q, int nAtomType, 
+                     const int* pairs, int nPair, double* rho, double* s)
+   {
+      const int nAll = 2*nAtomType;
+      int a, b, i, j, m, offset;
+      for (m = 0; m < nMolecule; ++m) {
+         for (i = 0; i < nAll + 2; ++i) {
+            rho[i] = 0.0;
+         }
+         offset = m*nAtom;
+         addPhases(x + offset, y + offset, z + offset, t + offset, 
+                   nAtom, q, rho);
+         for (i = 0; i < nAtomType; ++i) {
+            rho[nAll] += rho[2*i];
+            rho[nAll + 1] += rho[2*i + 1];
+         }
+         for (j = 0; j < nPair; ++j) {
+            a = 2*pairs[2*j];
+            b = 2*pairs[2*j + 1];
+            s[j] += rho[a]*rho[b] + rho[a + 1]*rho[b + 1];
+         }
+      }
+   }
+   #ifdef TOOLS_OFFLOAD
+   #pragma omp end declare target
+   #endif
+
+   /*
+   * Constructor.
+   */
+   IntraStructureFactor::IntraStructureFactor(Processor& processor)
+    : Analyzer(processor),
+      outputFile_(),
+      atomTypeIdPairs_(),
+      pairIndices_(),
+      waveIntVectors_(),
+      waveVectors_(),
+      structureFactors_(),
+      positions_(),
+      typeIds_(),
+      batchWaves_(),
+      volumes_(),
+      nMolecules_(),
+      amplitudes_(),
+      sums_(),
+      nAtomType_(-1),
+      speciesId_(-1),
+      nAtom_(-1),
+      nAtomTypeIdPair_(-1),
+      nWave_(-1),
+      batchSize_(16),
+      nBatch_(0),
+      atomCapacity_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("IntraStructureFactor"); }
+
+   /*
+   * Constructor.
+   */
+   IntraStructureFactor::IntraStructureFactor(Configuration& configuration,
+                                              FileMaster& fileMaster)
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      atomTypeIdPairs_(),
+      pairIndices_(),
+      waveIntVectors_(),
+      waveVectors_(),
+      structureFactors_(),
+      positions_(),
+      typeIds_(),
+      batchWaves_(),
+      volumes_(),
+      nMolecules_(),
+      amplitudes_(),
+      sums_(),
+      nAtomType_(-1),
+      speciesId_(-1),
+      nAtom_(-1),
+      nAtomTypeIdPair_(-1),
+      nWave_(-1),
+      batchSize_(16),
+      nBatch_(0),
+      atomCapacity_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("IntraStructureFactor"); }
+
+   /*
+   * Read parameters from file, and allocate accumulators.
+   */
+   void IntraStructureFactor::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nAtomType", nAtomType_);
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      read<int>(in, "speciesId", speciesId_);
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+      if (speciesId_ >= configuration().nSpecies()) {
+         UTIL_THROW("speciesId > nSpecies");
+      }
+      nAtom_ = configuration().species(speciesId_).nAtom();
+      read<int>(in, "nAtomTypeIdPair", nAtomTypeIdPair_);
+      if (nAtomTypeIdPair_ <= 0) {
+         UTIL_THROW("nAtomTypeIdPair <= 0");
+      }
+      atomTypeIdPairs_.allocate(nAtomTypeIdPair_);
+      readDArray< Pair<int> >(in, "atomTypeIdPairs", atomTypeIdPairs_, 
+                              nAtomTypeIdPair_);
+      read<int>(in, "nWave", nWave_);
+      if (nWave_ <= 0) {
+         UTIL_THROW("nWave <= 0");
+      }
+      waveIntVectors_.allocate(nWave_);
+      readDArray<IntVector>(in, "waveIntVectors", waveIntVectors_, nWave_);
+      batchSize_ = 16;
+      readOptional<int>(in, "batchSize", batchSize_);
+      if (batchSize_ <= 0) {
+         UTIL_THROW("batchSize <= 0");
+      }
+
+      // Amplitude index of each type in pairs (nAtomType_ for all types)
+      int i, j, typeId;
+      pairIndices_.allocate(2*nAtomTypeIdPair_);
+      for (j = 0; j < nAtomTypeIdPair_; ++j) {
+         for (i = 0; i < 2; ++i) {
+            typeId = atomTypeIdPairs_[j][i];
+            if (typeId >= nAtomType_) {
+               UTIL_THROW("Invalid atom type id in atomTypeIdPairs");
+            }
+            pairIndices_[2*j + i] = typeId < 0 ? nAtomType_ : typeId;
+         }
+      }
+
+      waveVectors_.allocate(nWave_);
+      structureFactors_.allocate(nWave_, nAtomTypeIdPair_);
+      batchWaves_.allocate(batchSize_*nWave_);
+      volumes_.allocate(batchSize_);
+      nMolecules_.allocate(batchSize_);
+      amplitudes_.allocate(2*(nAtomType_ + 1)*batchSize_*nWave_);
+      sums_.allocate(nAtomTypeIdPair_*batchSize_*nWave_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void IntraStructureFactor::setup()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      for (int i = 0; i < nWave_; ++i) {
+         waveVectors_[i].zero();
+         for (int j = 0; j < nAtomTypeIdPair_; ++j) {
+            structureFactors_(i, j) = 0.0;
+         }
+      }
+      nBatch_ = 0;
+      nSample_ = 0;
+   }
+
+   /*
+   * Allocate batch arrays for frames of up to atomCapacity atoms.
+   */
+   void IntraStructureFactor::allocateBatch(int atomCapacity)
+   {
+      if (positions_.isAllocated()) {
+         positions_.deallocate();
+         typeIds_.deallocate();
+      }
+      positions_.allocate(batchSize_*Dimension*atomCapacity);
+      typeIds_.allocate(batchSize_*atomCapacity);
+      atomCapacity_ = atomCapacity;
+   }
+
+   /*
+   * Copy the current frame into the batch, and evaluate a full batch.
+   */
+   void IntraStructureFactor::sample(long iStep)
+   {
+      if (!isAtInterval(iStep)) return;
+
+      Species& species = configuration().species(speciesId_);
+      int nMolecule = species.size();
+      int nAtom = nMolecule*nAtom_;
+      if (nAtom > atomCapacity_ || !positions_.isAllocated()) {
+         processBatch();
+         allocateBatch(nAtom > nAtom_ ? nAtom : nAtom_);
+      }
+
+      // Calculate wavevectors for the current boundary
+      Boundary& boundary = configuration().boundary();
+      Vector dWave;
+      int i, j;
+      for (i = 0; i < nWave_; ++i) {
+         waveVectors_[i].zero();
+         for (j = 0; j < Dimension; ++j) {
+            dWave  = boundary.reciprocalBasisVector(j);
+            dWave *= waveIntVectors_[i][j];
+            waveVectors_[i] += dWave;
+         }
+         batchWaves_[nBatch_*nWave_ + i] = waveVectors_[i];
+      }
+      volumes_[nBatch_] = boundary.volume();
+      nMolecules_[nBatch_] = nMolecule;
+
+      // Copy positions into x, y and z columns in molecule order
+      double* x = &positions_[nBatch_*Dimension*atomCapacity_];
+      int* t = &typeIds_[nBatch_*atomCapacity_];
+      const Molecule* moleculePtr;
+      const Atom* atomPtr;
+      int k, m;
+      k = 0;
+      for (m = 0; m < nMolecule; ++m) {
+         moleculePtr = &species.molecule(m);
+         for (i = 0; i < nAtom_; ++i) {
+            atomPtr = &moleculePtr->atom(i);
+            if (atomPtr->typeId < 0 || atomPtr->typeId >= nAtomType_) {
+               UTIL_THROW("Invalid atom typeId");
+            }
+            for (j = 0; j < Dimension; ++j) {
+               x[j*atomCapacity_ + k] = atomPtr->position[j];
+            }
+            t[k] = atomPtr->typeId;
+            ++k;
+         }
+      }
+
+      ++nBatch_;
+      if (nBatch_ == batchSize_) {
+         processBatch();
+      }
+   }
+
+   /*
+   * Evaluate all frames of the current batch, and add to accumulators.
+   */
+   void IntraStructureFactor::processBatch()
+   {
+      if (nBatch_ == 0) return;
+
+      // Sums over molecules, one work item per pair of frame and wave
+      const int nItem = nBatch_*nWave_;
+      const int nw = nWave_;
+      const int na = nAtomType_;
+      const int np = nAtomTypeIdPair_;
+      const int nam = nAtom_;
+      const int cap = atomCapacity_;
+      const double* r = &positions_[0];
+      const int* types = &typeIds_[0];
+      const double* waves = (const double*)&batchWaves_[0];
+      const int* sizes = &nMolecules_[0];
+      const int* pairs = &pairIndices_[0];
+      double* rhos = &amplitudes_[0];
+      double* s = &sums_[0];
+      #ifdef TOOLS_OFFLOAD
+      const int nb = nBatch_;
+      #pragma omp target teams distribute parallel for \
+              map(to: r[0:nb*Dimension*cap], types[0:nb*cap], \
+                      waves[0:Dimension*nItem], sizes[0:nb], \
+                      pairs[0:2*np]) \
+              map(alloc: rhos[0:2*(na+1)*nItem]) \
+              map(from: s[0:np*nItem])
+      #else
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      #endif
+      for (int item = 0; item < nItem; ++item) {
+         const int f = item/nw;
+         const double* x = r + f*Dimension*cap;
+         double* sum = s + np*item;
+         for (int j = 0; j < np; ++j) {
+            sum[j] = 0.0;
+         }
+         addIntraSums(x, x + cap, x + 2*cap, types + f*cap, sizes[f], nam,
+                      waves + Dimension*item, na, pairs, np, 
+                      rhos + 2*(na + 1)*item, sum);
+      }
+
+      // Add sums to accumulators, in order of frames
+      int f, i, j;
+      for (f = 0; f < nBatch_; ++f) {
+         for (i = 0; i < nWave_; ++i) {
+            for (j = 0; j < np; ++j) {
+               structureFactors_(i, j) += s[np*(f*nWave_ + i) + j]
+                                          /volumes_[f];
+            }
+         }
+      }
+      nSample_ += nBatch_;
+      nBatch_ = 0;
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void IntraStructureFactor::saveState(Serializable::OArchive& ar)
+   {
+      processBatch();
+      ar & structureFactors_;
+      ar & nSample_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void IntraStructureFactor::loadState(Serializable::IArchive& ar)
+   {
+      ar & structureFactors_;
+      ar & nSample_;
+      nBatch_ = 0;
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void IntraStructureFactor::output()
+   {
+      processBatch();
+
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_);
+      outputFile_.close();
+
+      // Output structure factors, with |q| for the last frame
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+      double value;
+      int i, j, k;
+      for (i = 0; i < nWave_; ++i) {
+         for (k = 0; k < Dimension; ++k) {
+            outputFile_ << Int(waveIntVectors_[i][k], 5);
+         }
+         outputFile_ << Dbl(waveVectors_[i].abs(), 20, 8);
+         for (j = 0; j < nAtomTypeIdPair_; ++j) {
+            value = 0.0;
+            if (nSample_ > 0) {
+               value = structureFactors_(i, j)/double(nSample_);
+            }
+            outputFile_ << Dbl(value, 18, 8);
+         }
+         outputFile_ << std::endl;
+      }
+      outputFile_.close();
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Sum structure factors and sample counts on processor 0.
+   */
+   void IntraStructureFactor::reduce(MPI::Intracomm& communicator)
+   {
+      processBatch();
+      int size = nWave_*nAtomTypeIdPair_;
+      if (communicator.Get_rank() == 0) {
+         communicator.Reduce(MPI::IN_PLACE, &structureFactors_(0, 0), size,
+                             MPI::DOUBLE, MPI::SUM, 0);
+         communicator.Reduce(MPI::IN_PLACE, &nSample_, 1,
+                             MPI::LONG, MPI::SUM, 0);
+      } else {
+         communicator.Reduce(&structureFactors_(0, 0), 0, size,
+                             MPI::DOUBLE, MPI::SUM, 0);
+         communicator.Reduce(&nSample_, 0, 1,
+                             MPI::LONG, MPI::SUM, 0);
+      }
+   }
+   #endif
+
+}
@@ -0,0 +1,204 @@
+#ifndef TOOLS_INTRA_STRUCTURE_FACTOR_H
+#define TOOLS_INTRA_STRUCTURE_FACTOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>       // base class
+#include <util/containers/DArray.h>         // member template
+#include <util/containers/DMatrix.h>        // member template
+#include <util/containers/Pair.h>           // member template parameter
+#include <util/space/IntVector.h>           // member template parameter
+#include <util/space/Vector.h>              // member template parameter
+
+#include <fstream>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Intramolecular structure factors, computed from batches of frames.
+   *
+   * Computes the same intramolecular structure factors as 
+   * McMd::IntraStructureFactor, i.e., 
+   * S_ab(q) = sum_m Re[ rho_ma(q)^* rho_mb(q) ] / V, in which the sum
+   * is over molecules m of one species, and rho_ma(q) is the sum of
+   * exp(i q.r) over atoms of type a in molecule m, or over all atoms
+   * of molecule m if a < 0, for each pair (a, b) in atomTypeIdPairs.
+   *
+   * Frames are processed in batches, as by Tools::StructureFactor.
+   * sample() only copies the positions and types of atoms of the 
+   * species into columnar arrays, in molecule order, and the sums for
+   * all pairs of frame and wavevector in a batch of batchSize frames 
+   * are then evaluated as independent work items, in parallel if 
+   * compiled with TOOLS_OPENMP, or on an offload device if compiled 
+   * with TOOLS_OFFLOAD. Partial batches are evaluated by saveState(), 
+   * reduce() and output().
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class IntraStructureFactor : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      IntraStructureFactor(Processor &processor);
+
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      IntraStructureFactor(Configuration &configuration, 
+                           FileMaster& fileMaster);
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Clear accumulators.
+      */
+      virtual void setup();
+
+      /**
+      * Add the current frame to the batch, and evaluate a full batch.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * Return true: each frame is analyzed independently.
+      */
+      virtual bool isFrameParallel() const
+      {  return true; }
+
+      /**
+      * Sum structure factors of all processors on processor 0.
+      *
+      * \param communicator communicator for all processors
+      */
+      virtual void reduce(MPI::Intracomm& communicator);
+      #endif
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Pairs of atom type ids (-1 denotes all types).
+      DArray< Pair<int> > atomTypeIdPairs_;
+
+      /// Amplitude indices of pairs (2 per pair, nAtomType for all types).
+      DArray<int> pairIndices_;
+
+      /// Integer indices of wavevectors.
+      DArray<IntVector> waveIntVectors_;
+
+      /// Wavevectors for the most recent frame.
+      DArray<Vector> waveVectors_;
+
+      /// Accumulated structure factors (nWave x nAtomTypeIdPair).
+      DMatrix<double> structureFactors_;
+
+      /// Columnar positions of batch frames (x, y, z blocks per frame).
+      DArray<double> positions_;
+
+      /// Atom type ids of batch frames.
+      DArray<int> typeIds_;
+
+      /// Wavevectors of batch frames (nWave per frame).
+      DArray<Vector> batchWaves_;
+
+      /// Volumes of batch frames.
+      DArray<double> volumes_;
+
+      /// Number of molecules in each batch frame.
+      DArray<int> nMolecules_;
+
+      /// Amplitudes of one molecule, per (frame, wave) work item.
+      DArray<double> amplitudes_;
+
+      /// Sums over molecules per (frame, wave, type pair).
+      DArray<double> sums_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Index of relevant Species.
+      int speciesId_;
+
+      /// Number of atoms per molecule of the species.
+      int nAtom_;
+
+      /// Number of atom type id pairs.
+      int nAtomTypeIdPair_;
+
+      /// Number of wavevectors.
+      int nWave_;
+
+      /// Maximum number of frames per batch.
+      int batchSize_;
+
+      /// Number of frames in the current batch.
+      int nBatch_;
+
+      /// Maximum number of atoms per frame in batch arrays.
+      int atomCapacity_;
+
+      /// Number of frames added to structureFactors_.
+      long nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Allocate batch arrays for frames of up to atomCapacity atoms.
+      */
+      void allocateBatch(int atomCapacity);
+
+      /**
+      * Evaluate all frames of the current batch, and add to accumulators.
+      */
+      void processBatch();
+
+   };
+
+}
+#endif
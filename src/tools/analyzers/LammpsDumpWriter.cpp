@@ -10,20 +10,28 @@
 #include <tools/chemistry/Atom.h>
 #include <tools/chemistry/Group.h>
 
+#include <simp/trajectory/LammpsDumpFormat.h>
+
 #include <util/archives/BinaryFileOArchive.h>
 #include <util/format/Dbl.h>
 #include <util/space/Vector.h>
+#ifdef TOOLS_OPENMP
+#include <omp.h>
+#endif
 
 namespace Tools
 {
 
    using namespace Util;
+   using namespace Simp;
 
    /*
    * Constructor.
    */
    LammpsDumpWriter::LammpsDumpWriter(Processor& processor)
-    : TrajectoryWriter(processor, false)
+    : TrajectoryWriter(processor, false),
+      buffers_(),
+      nAtom_(0)
    {}
 
    /*
@@ -31,7 +39,9 @@ namespace Tools
    */
    LammpsDumpWriter::LammpsDumpWriter(Configuration& configuration,
                                       FileMaster& fileMaster)
-    : TrajectoryWriter(configuration, fileMaster, false)
+    : TrajectoryWriter(configuration, fileMaster, false),
+      buffers_(),
+      nAtom_(0)
    {}
 
    /*
@@ -61,28 +71,46 @@ namespace Tools
       file << Dbl(0.0) << Dbl(lengths[1]) << "\n";
       file << Dbl(0.0) << Dbl(lengths[2]) << "\n";
 
-      Vector r;
-      int id;
-      int typeId;
-      int shift = 0;
-      int molId = 1;
-
       file << "ITEM: ATOMS id type mol x y z" << "\n";
-      AtomStorage::Iterator iter;
-      atoms().begin(iter);
-      for ( ; iter.notEnd(); ++iter) {
-         id = iter->id;
-         typeId = iter->typeId;
-         file << id + 1<< " ";
-         file << typeId + 1 << " ";
-         file << molId << " ";
-         for (int i=0; i < Util::Dimension; ++i) {
-            file << Dbl(iter->position[i], 13) << " ";
-         }
-         for (int i=0; i < Util::Dimension; ++i) {
-            file << shift << " ";
+
+      if (!buffers_.isAllocated()) {
+         int nThread = 1;
+         #ifdef TOOLS_OPENMP
+         nThread = omp_get_max_threads();
+         #endif
+         buffers_.allocate(nThread);
+      }
+
+      // Format contiguous ranges of atoms in per-thread buffers
+      AtomStorage* storagePtr = &atoms();
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel
+      #endif
+      {
+         int threadId = 0;
+         #ifdef TOOLS_OPENMP
+         threadId = omp_get_thread_num();
+         #endif
+         std::string& buffer = buffers_[threadId];
+         char line[LammpsDumpFormat::MaxLineLength];
+         const Atom* atomPtr;
+         int i, length;
+         buffer.clear();
+         #ifdef TOOLS_OPENMP
+         #pragma omp for schedule(static)
+         #endif
+         for (i = 0; i < nAtom_; ++i) {
+            atomPtr = &storagePtr->atom(i);
+            length = LammpsDumpFormat::formatAtom(line, atomPtr->id,
+                                                  atomPtr->typeId, 1,
+                                                  atomPtr->position);
+            buffer.append(line, length);
          }
-         file << "\n";
+      }
+
+      // Write buffers in thread order (i.e., in atom order)
+      for (int t = 0; t < buffers_.capacity(); ++t) {
+         file.write(buffers_[t].data(), buffers_[t].size());
       }
 
    }
@@ -9,9 +9,11 @@
 */
 
 #include <tools/analyzers/TrajectoryWriter.h>   // base class
+#include <util/containers/DArray.h>              // member
 
 #include <iostream>
 #include <fstream>
+#include <string>
 
 namespace Tools
 {
@@ -23,6 +25,10 @@ namespace Tools
    /**
    * Write a trajectory in the Lammps dump format.
    *
+   * Lines of the ATOMS block are formatted by all threads (if compiled
+   * with TOOLS_OPENMP), each into a private buffer for a contiguous range
+   * of atoms, and the buffers are then written in order.
+   *
    * \ingroup Tools_Analyzer_Module
    */
    class LammpsDumpWriter : public TrajectoryWriter
@@ -60,6 +66,9 @@ namespace Tools
 
    private:
 
+      /// Formatted text of the ATOMS block, one buffer per thread.
+      DArray<std::string> buffers_;
+
       /// Number of atoms in the file.
       int nAtom_;
 
@@ -0,0 +1,253 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "LinearRouseAutoCorr.h"
+#include <tools/chemistry/Molecule.h>
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Species.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/misc/ioUtil.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <util/global.h>
+
+#include <cmath>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   LinearRouseAutoCorr::LinearRouseAutoCorr(Processor& processor) 
+    : Analyzer(processor),
+      outputFile_(),
+      accumulators_(),
+      data_(),
+      positions_(),
+      projector_(),
+      speciesId_(-1),
+      nMolecule_(-1),
+      nAtom_(-1),
+      p_(-1),
+      nMode_(1),
+      capacity_(-1),
+      nLevel_(1),
+      blockFactor_(2),
+      isInitialized_(false)
+   {  setClassName("LinearRouseAutoCorr"); }
+
+   /*
+   * Constructor.
+   */
+   LinearRouseAutoCorr::LinearRouseAutoCorr(Configuration& configuration, 
+                                            FileMaster& fileMaster) 
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      accumulators_(),
+      data_(),
+      positions_(),
+      projector_(),
+      speciesId_(-1),
+      nMolecule_(-1),
+      nAtom_(-1),
+      p_(-1),
+      nMode_(1),
+      capacity_(-1),
+      nLevel_(1),
+      blockFactor_(2),
+      isInitialized_(false)
+   {  setClassName("LinearRouseAutoCorr"); }
+
+   /*
+   * Read parameters from file, and allocate memory.
+   */
+   void LinearRouseAutoCorr::readParameters(std::istream& in) 
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "speciesId", speciesId_);
+      read<int>(in, "p", p_);
+      read<int>(in, "capacity", capacity_);
+      nMode_ = 1;
+      readOptional<int>(in, "nMode", nMode_);
+      nLevel_ = 1;
+      readOptional<int>(in, "nLevel", nLevel_);
+      blockFactor_ = 2;
+      readOptional<int>(in, "blockFactor", blockFactor_);
+
+      // Validate parameters
+      if (speciesId_ < 0) {
+         UTIL_THROW("Negative speciesId");
+      }
+      if (speciesId_ >= configuration().nSpecies()) {
+         UTIL_THROW("speciesId >= nSpecies");
+      }
+      if (p_ < 0) {
+         UTIL_THROW("Negative mode index");
+      }
+      if (capacity_ <= 0) {
+         UTIL_THROW("Nonpositive capacity");
+      }
+      if (nMode_ <= 0) {
+         UTIL_THROW("Nonpositive nMode");
+      }
+      Species& species = configuration().species(speciesId_);
+      nAtom_ = species.nAtom();
+      if (nAtom_ <= 1) {
+         UTIL_THROW("Number of atoms per molecule < 2");
+      }
+      if (nMode_ > 1 && p_ + nMode_ > nAtom_) {
+         UTIL_THROW("p + nMode > nAtom");
+      }
+      int speciesCapacity = species.capacity();
+      if (speciesCapacity <= 0) {
+         UTIL_THROW("Species capacity <= 0");
+      }
+
+      // Allocate memory
+      int k;
+      accumulators_.allocate(nMode_);
+      data_.allocate(nMode_); 
+      for (k = 0; k < nMode_; ++k) {
+         accumulators_[k].setParam(speciesCapacity, capacity_,
+                                   blockFactor_, nLevel_);
+         data_[k].allocate(speciesCapacity); 
+      }
+      positions_.allocate(nAtom_);
+      projector_.allocate(nMode_, nAtom_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Set number of molecules, initialize projectors, clear accumulators.
+   */
+   void LinearRouseAutoCorr::setup() 
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      nMolecule_ = configuration().species(speciesId_).size();
+
+      // Initialize mode projection coefficients
+      double qMode;
+      int j, k, p;
+      for (k = 0; k < nMode_; ++k) {
+         p = p_ + k;
+         qMode = acos(-1.0) * double(p) / double(nAtom_ - 1);
+         for (j = 0; j < nAtom_; ++j) {
+            projector_(k, j) = cos(qMode*double(j)) / double(nAtom_);
+         }
+         projector_(k, 0) -= 0.5/double(nAtom_);
+         projector_(k, nAtom_ - 1) -= 0.5*cos(qMode*double(nAtom_ - 1)) 
+                                      / double(nAtom_);
+      }
+
+      // Initialize the accumulators
+      for (k = 0; k < nMode_; ++k) {
+         accumulators_[k].setNEnsemble(nMolecule_);
+         accumulators_[k].clear();
+      }
+   }
+
+   /*
+   * Evaluate Rouse modes of all molecules, add to ensemble.
+   */
+   void LinearRouseAutoCorr::sample(long iStep) 
+   { 
+      if (!isAtInterval(iStep)) return;
+
+      Species& species = configuration().species(speciesId_);
+      Boundary& boundary = configuration().boundary();
+
+      // Confirm that nMolecule is unchanged.
+      if (nMolecule_ != species.size()) {
+         UTIL_THROW("Number of molecules has changed.");
+      }
+
+      Species::Iterator iter;
+      Vector dR, sum;
+      int i, j, k;
+
+      i = 0;
+      for (species.begin(iter); iter.notEnd(); ++iter) {
+
+         // Retrace non-periodic shape
+         positions_[0] = iter->atom(0).position;
+         for (j = 1; j < nAtom_; ++j) {
+            boundary.distanceSq(iter->atom(j).position, 
+                                iter->atom(j-1).position, dR);
+            positions_[j].add(positions_[j-1], dR);
+         }
+
+         // Project onto all modes
+         for (k = 0; k < nMode_; ++k) {
+            sum.zero();
+            for (j = 0; j < nAtom_; ++j) {
+               dR.multiply(positions_[j], projector_(k, j));
+               sum += dR;
+            }
+            data_[k][i] = sum;
+         }
+         ++i;
+      }
+
+      for (k = 0; k < nMode_; ++k) {
+         accumulators_[k].sample(data_[k]);
+      }
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void LinearRouseAutoCorr::saveState(Serializable::OArchive& ar)
+   {
+      for (int k = 0; k < nMode_; ++k) {
+         ar & accumulators_[k];
+      }
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void LinearRouseAutoCorr::loadState(Serializable::IArchive& ar)
+   {
+      for (int k = 0; k < nMode_; ++k) {
+         ar & accumulators_[k];
+      }
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void LinearRouseAutoCorr::output() 
+   {  
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_); 
+      outputFile_.close();
+
+      // Output autocorrelation functions to separate data file(s)
+      std::string suffix;
+      for (int k = 0; k < nMode_; ++k) {
+         if (nMode_ == 1) {
+            suffix = std::string(".dat");
+         } else {
+            suffix = std::string(".") + toString(p_ + k) 
+                   + std::string(".dat");
+         }
+         fileMaster().openOutputFile(outputFileName(suffix), outputFile_);
+         accumulators_[k].output(outputFile_); 
+         outputFile_.close();
+      }
+   }
+
+}
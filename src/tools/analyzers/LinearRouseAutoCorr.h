@@ -0,0 +1,149 @@
+#ifndef TOOLS_LINEAR_ROUSE_AUTO_CORR_H
+#define TOOLS_LINEAR_ROUSE_AUTO_CORR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>              // base class
+#include <tools/analyzers/MultipleTauAutoCorr.h>   // member template
+#include <util/space/Vector.h>                     // member template parameter
+#include <util/containers/DArray.h>                // member template
+#include <util/containers/DMatrix.h>               // member template
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Autocorrelation function of Rouse modes of linear molecules.
+   *
+   * Rouse mode p of a linear molecule of N atoms is defined as
+   * \f[
+   *    {\bf R}_p = \frac{1}{N}\sum_{j=0}^{N-1} {\bf R}_j 
+   *                \cos\left( \frac{\pi p j}{N-1} \right)
+   * \f]
+   * in which the terms for the two end atoms are given weights of 1/2.
+   * Atom positions are unwrapped along each chain using the minimum 
+   * image convention between consecutive atoms.
+   * Autocorrelation functions of modes p, ..., p + nMode - 1 are 
+   * computed with MultipleTauAutoCorr accumulators.
+   *
+   * Parameters are interval, outputFileName, speciesId, p, capacity,
+   * and the optional parameters nMode (default 1), nLevel (default 1)
+   * and blockFactor (default 2). If nMode > 1, the function for mode
+   * p + k is written to outputFileName.(p+k).dat.
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class LinearRouseAutoCorr : public Analyzer
+   {
+   
+   public:
+  
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      LinearRouseAutoCorr(Processor &processor);
+  
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      LinearRouseAutoCorr(Configuration &configuration, 
+                          FileMaster& fileMaster);
+  
+      /** 
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+  
+      /** 
+      * Set number of molecules, compute projectors, clear accumulators.
+      */
+      virtual void setup();
+   
+      /** 
+      * Evaluate Rouse modes of all molecules, add to ensemble.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+   private:
+ 
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Statistical accumulators, one per mode.
+      DArray< MultipleTauAutoCorr<Vector, double> > accumulators_;
+
+      /// Rouse mode coefficients, data_[k][i] for mode p+k of molecule i.
+      DArray< DArray<Vector> > data_;
+
+      /// Unwrapped positions of atoms of one molecule (workspace).
+      DArray<Vector> positions_;
+
+      /// Coefficients for projecting to Rouse modes, element (k, atomId).
+      DMatrix<double> projector_;
+   
+      /// Index of relevant Species.
+      int speciesId_;
+   
+      /// Number of molecules in the species (must not change).
+      int nMolecule_;
+   
+      /// Number of atoms per molecule.
+      int nAtom_;
+   
+      /// Index of (first) Rouse mode.
+      int p_;
+   
+      /// Number of Rouse modes.
+      int nMode_;
+   
+      /// Number of frames stored per level of each accumulator.
+      int capacity_;
+   
+      /// Number of levels of each accumulator.
+      int nLevel_;
+   
+      /// Number of values averaged between levels.
+      int blockFactor_;
+   
+      /// Has readParam been called?
+      bool isInitialized_;
+   
+   };
+
+}
+#endif
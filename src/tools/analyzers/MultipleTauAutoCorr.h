@@ -0,0 +1,406 @@
+#ifndef TOOLS_MULTIPLE_TAU_AUTO_CORR_H
+#define TOOLS_MULTIPLE_TAU_AUTO_CORR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>      // member template
+#include <util/containers/Array.h>       // function argument template
+#include <util/accumulators/setToZero.h> // used in implementation
+#include <util/accumulators/product.h>   // used in implementation
+#include <util/format/Int.h>             // used in implementation
+#include <util/format/write.h>           // used in implementation
+#include <util/global.h>
+
+#include <iostream>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Multiple-tau autocorrelation accumulator for an ensemble of values.
+   *
+   * This class template implements the multiple-tau correlator of
+   * Ramirez et al. (J. Chem. Phys. 133, 154103, 2010) for an ensemble
+   * of values of type Data (e.g., double, Vector or Tensor). Values are
+   * stored in nLevel levels of blockLength frames. Level 0 stores every
+   * sample. Each higher level stores averages of blockFactor consecutive
+   * values of the level below it, and is used to compute correlations
+   * for time lags k*(blockFactor)^level with blockLength/blockFactor
+   * <= k < blockLength. Memory use is thus bounded by nLevel*blockLength
+   * values per member of the ensemble, while the longest time lag is
+   * of order blockLength*(blockFactor)^(nLevel-1) samples. With nLevel
+   * = 1, the output is the exact autocorrelation function for lags
+   * less than blockLength, as for Util::AutoCorrArray.
+   *
+   * The output is the ensemble average of product(x(t), x(t+lag)),
+   * where product() is defined in util/accumulators/product.h.
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   template <typename Data, typename Product>
+   class MultipleTauAutoCorr
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      MultipleTauAutoCorr();
+
+      /**
+      * Set parameters and allocate memory.
+      *
+      * \param ensembleCapacity maximum number of members of ensemble
+      * \param blockLength      number of frames stored per level
+      * \param blockFactor      number of values averaged between levels
+      * \param nLevel           number of levels
+      */
+      void setParam(int ensembleCapacity, int blockLength,
+                    int blockFactor, int nLevel);
+
+      /**
+      * Set the number of members of the ensemble.
+      *
+      * \param nEnsemble number of members (<= ensembleCapacity)
+      */
+      void setNEnsemble(int nEnsemble);
+
+      /**
+      * Reset to empty state, with no samples.
+      */
+      void clear();
+
+      /**
+      * Add the values of all members of the ensemble at one time.
+      *
+      * \param values array of nEnsemble values
+      */
+      void sample(const Array<Data>& values);
+
+      /**
+      * Output time lag (in samples) and autocorrelation function.
+      *
+      * Each line contains a time lag and the corresponding ensemble
+      * averaged correlation, in order of increasing time lag.
+      *
+      * \param out output stream
+      */
+      void output(std::ostream& out) const;
+
+      /**
+      * Serialize to/from an archive.
+      *
+      * \pre setParam() must have been called with the same parameters.
+      *
+      * \param ar      archive
+      * \param version archive version id
+      */
+      template <class Archive>
+      void serialize(Archive& ar, const unsigned int version);
+
+      /**
+      * Get number of members of the ensemble.
+      */
+      int nEnsemble() const
+      {  return nEnsemble_; }
+
+      /**
+      * Get number of frames stored per level.
+      */
+      int blockLength() const
+      {  return blockLength_; }
+
+      /**
+      * Get number of values averaged between levels.
+      */
+      int blockFactor() const
+      {  return blockFactor_; }
+
+      /**
+      * Get number of levels.
+      */
+      int nLevel() const
+      {  return nLevel_; }
+
+      /**
+      * Get number of samples added thus far.
+      */
+      long nSample() const
+      {  return nSample_; }
+
+   private:
+
+      /// Stored values, element [(level*blockLength + slot)*capacity + i].
+      DArray<Data> values_;
+
+      /// Partial block sums passed up a level, element [level*capacity + i].
+      DArray<Data> blockSums_;
+
+      /// Block averages passed to the next level (workspace).
+      DArray<Data> averages_;
+
+      /// Sums of correlations, element [level*blockLength + k].
+      DArray<Product> sums_;
+
+      /// Number of terms in each sum, element [level*blockLength + k].
+      DArray<long> counts_;
+
+      /// Number of frames stored in each level.
+      DArray<long> nFrames_;
+
+      /// Number of values in the current block sum of each level.
+      DArray<int> nBlockSums_;
+
+      /// Number of samples added thus far.
+      long nSample_;
+
+      /// Maximum number of members of the ensemble.
+      int ensembleCapacity_;
+
+      /// Number of members of the ensemble.
+      int nEnsemble_;
+
+      /// Number of frames stored per level.
+      int blockLength_;
+
+      /// Number of values averaged between levels.
+      int blockFactor_;
+
+      /// Number of levels.
+      int nLevel_;
+
+   };
+
+   /*
+   * Constructor.
+   */
+   template <typename Data, typename Product>
+   MultipleTauAutoCorr<Data, Product>::MultipleTauAutoCorr()
+    : values_(),
+      blockSums_(),
+      averages_(),
+      sums_(),
+      counts_(),
+      nFrames_(),
+      nBlockSums_(),
+      nSample_(0),
+      ensembleCapacity_(0),
+      nEnsemble_(0),
+      blockLength_(0),
+      blockFactor_(0),
+      nLevel_(0)
+   {}
+
+   /*
+   * Set parameters and allocate memory.
+   */
+   template <typename Data, typename Product>
+   void
+   MultipleTauAutoCorr<Data, Product>::setParam(int ensembleCapacity,
+                                                int blockLength,
+                                                int blockFactor, int nLevel)
+   {
+      if (ensembleCapacity <= 0) {
+         UTIL_THROW("Nonpositive ensembleCapacity");
+      }
+      if (nLevel <= 0) {
+         UTIL_THROW("Nonpositive nLevel");
+      }
+      if (nLevel > 1) {
+         if (blockFactor < 2) {
+            UTIL_THROW("blockFactor < 2");
+         }
+         if (blockLength < blockFactor) {
+            UTIL_THROW("blockLength < blockFactor");
+         }
+      } else if (blockLength <= 0) {
+         UTIL_THROW("Nonpositive blockLength");
+      }
+
+      // Check that the longest time lag fits in an int
+      long maxLag = blockLength;
+      for (int i = 1; i < nLevel; ++i) {
+         if (maxLag > 2147483647L/blockFactor) {
+            UTIL_THROW("blockLength*blockFactor^(nLevel-1) is too large");
+         }
+         maxLag *= blockFactor;
+      }
+
+      ensembleCapacity_ = ensembleCapacity;
+      blockLength_ = blockLength;
+      blockFactor_ = blockFactor;
+      nLevel_ = nLevel;
+      values_.allocate(nLevel*blockLength*ensembleCapacity);
+      blockSums_.allocate(nLevel*ensembleCapacity);
+      averages_.allocate(ensembleCapacity);
+      sums_.allocate(nLevel*blockLength);
+      counts_.allocate(nLevel*blockLength);
+      nFrames_.allocate(nLevel);
+      nBlockSums_.allocate(nLevel);
+      nEnsemble_ = 0;
+      clear();
+   }
+
+   /*
+   * Set the number of members of the ensemble.
+   */
+   template <typename Data, typename Product>
+   void MultipleTauAutoCorr<Data, Product>::setNEnsemble(int nEnsemble)
+   {
+      if (nEnsemble > ensembleCapacity_) {
+         UTIL_THROW("nEnsemble > ensembleCapacity");
+      }
+      nEnsemble_ = nEnsemble;
+   }
+
+   /*
+   * Reset to empty state.
+   */
+   template <typename Data, typename Product>
+   void MultipleTauAutoCorr<Data, Product>::clear()
+   {
+      int i;
+      for (i = 0; i < sums_.capacity(); ++i) {
+         setToZero(sums_[i]);
+         counts_[i] = 0;
+      }
+      for (i = 0; i < blockSums_.capacity(); ++i) {
+         setToZero(blockSums_[i]);
+      }
+      for (i = 0; i < nLevel_; ++i) {
+         nFrames_[i] = 0;
+         nBlockSums_[i] = 0;
+      }
+      nSample_ = 0;
+   }
+
+   /*
+   * Add values at one time to the accumulator.
+   */
+   template <typename Data, typename Product>
+   void MultipleTauAutoCorr<Data, Product>::sample(const Array<Data>& values)
+   {
+      if (nEnsemble_ <= 0) {
+         ++nSample_;
+         return;
+      }
+
+      const Data* current = &values[0];
+      Product sum;
+      double norm = 1.0/double(blockFactor_);
+      long nFrame;
+      int level, k, kMin, nLag, slot, i, begin;
+
+      for (level = 0; level < nLevel_; ++level) {
+
+         // Store current values, overwriting the oldest frame
+         slot = int(nFrames_[level] % blockLength_);
+         begin = (level*blockLength_ + slot)*ensembleCapacity_;
+         for (i = 0; i < nEnsemble_; ++i) {
+            values_[begin + i] = current[i];
+         }
+         ++nFrames_[level];
+
+         // Correlate current values with stored frames of this level.
+         // Lags k < blockLength/blockFactor of higher levels are
+         // already computed more accurately by the level below.
+         nFrame = nFrames_[level];
+         kMin = (level == 0) ? 0 : blockLength_/blockFactor_;
+         nLag = (nFrame < blockLength_) ? int(nFrame) - 1 : blockLength_ - 1;
+         for (k = kMin; k <= nLag; ++k) {
+            slot = int((nFrame - 1 - k) % blockLength_);
+            begin = (level*blockLength_ + slot)*ensembleCapacity_;
+            setToZero(sum);
+            for (i = 0; i < nEnsemble_; ++i) {
+               sum += product(current[i], values_[begin + i]);
+            }
+            sums_[level*blockLength_ + k] += sum;
+            counts_[level*blockLength_ + k] += nEnsemble_;
+         }
+
+         if (level == nLevel_ - 1) break;
+
+         // Add to block sum, and pass block average to the next level
+         begin = level*ensembleCapacity_;
+         for (i = 0; i < nEnsemble_; ++i) {
+            blockSums_[begin + i] += current[i];
+         }
+         ++nBlockSums_[level];
+         if (nBlockSums_[level] < blockFactor_) break;
+         for (i = 0; i < nEnsemble_; ++i) {
+            averages_[i] = blockSums_[begin + i];
+            averages_[i] *= norm;
+            setToZero(blockSums_[begin + i]);
+         }
+         nBlockSums_[level] = 0;
+         current = &averages_[0];
+      }
+      ++nSample_;
+   }
+
+   /*
+   * Output time lags and autocorrelation function.
+   */
+   template <typename Data, typename Product>
+   void MultipleTauAutoCorr<Data, Product>::output(std::ostream& out) const
+   {
+      Product ave;
+      long stride = 1;
+      int level, k, kMin, j;
+      for (level = 0; level < nLevel_; ++level) {
+         kMin = (level == 0) ? 0 : blockLength_/blockFactor_;
+         for (k = kMin; k < blockLength_; ++k) {
+            j = level*blockLength_ + k;
+            if (counts_[j] > 0) {
+               ave = sums_[j];
+               ave /= double(counts_[j]);
+               out << Int(int(k*stride), 10) << " ";
+               write<Product>(out, ave);
+               out << std::endl;
+            }
+         }
+         stride *= blockFactor_;
+      }
+   }
+
+   /*
+   * Serialize to/from an archive.
+   */
+   template <typename Data, typename Product>
+   template <class Archive>
+   void MultipleTauAutoCorr<Data, Product>::serialize(Archive& ar,
+                                             const unsigned int version)
+   {
+      int ensembleCapacity = ensembleCapacity_;
+      int blockLength = blockLength_;
+      int blockFactor = blockFactor_;
+      int nLevel = nLevel_;
+      ar & ensembleCapacity;
+      ar & blockLength;
+      ar & blockFactor;
+      ar & nLevel;
+      if (ensembleCapacity != ensembleCapacity_
+          || blockLength != blockLength_
+          || blockFactor != blockFactor_ || nLevel != nLevel_) {
+         UTIL_THROW("Inconsistent MultipleTauAutoCorr parameters");
+      }
+      ar & nEnsemble_;
+      ar & values_;
+      ar & blockSums_;
+      ar & sums_;
+      ar & counts_;
+      ar & nFrames_;
+      ar & nBlockSums_;
+      ar & nSample_;
+   }
+
+}
+#endif
@@ -11,6 +11,9 @@
 #include <tools/neighbor/Cell.h>
 #include <tools/chemistry/Atom.h>
 #include <util/space/Vector.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <vector>
 
 namespace Tools
 {
@@ -86,85 +89,95 @@ namespace Tools
       Vector cutoffs(cutoff_, cutoff_, cutoff_); 
 
       cellList_.allocate(atomCapacity_, lower, upper, cutoffs);
-      cellList_.makeGrid(lower, upper, cutoffs);
    }
 
+   /*
+   * Compute total pair energy of the current frame.
+   */
    void PairEnergy::sample(long iStep) 
    {
       if (!isAtInterval(iStep)) return;
 
-      // Clear cell list
-      cellList_.clear();
-
-      // Place all atoms
+      // Fill cell list with periodic images (grid is only remade if 
+      // the boundary changed since the previous frame)
+      Boundary& boundary = configuration().boundary();
+      cellList_.setup(boundary, cutoff_);
       AtomStorage::Iterator atomIter;
       configuration().atoms().begin(atomIter); 
       for ( ; atomIter.notEnd(); ++atomIter) {
-         cellList_.placeAtom(*atomIter);
+         cellList_.placeAtom(*atomIter, boundary);
       }
-
-      // Build/update cell list
       cellList_.build();
-      cellList_.update();
-
       if (!cellList_.isValid()) {
          UTIL_THROW("Cell List Invalid\n");
       }
 
-      // Compute pair energy using loop over cells
-      Vector dr;
+      // Sum over cells, each of which includes pairs in a half shell
       double energy = 0.0;
-      double rsq;
+      int nCell = cellList_.grid().size();
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel for schedule(dynamic) reduction(+:energy)
+      #endif
+      for (int ic = 0; ic < nCell; ++ic) {
+         energy += cellEnergy(cellList_.cell(ic), boundary);
+      }
+
+      timesteps_.append(iStep);
+      energies_.append(energy);
+   }
+
+   /*
+   * Energy of pairs with a primary atom in one cell.
+   */
+   double PairEnergy::cellEnergy(const Cell& cell, 
+                                 const Boundary& boundary) const
+   {
       Cell::NeighborArray neighbors;
-      Boundary& boundary = configuration().boundary();
-      CellAtom* cellAtomPtr1 = 0;
-      CellAtom* cellAtomPtr2 = 0;
-      const Cell* cellPtr = 0;
-      int na = 0; // total number of atoms
-      int nn = 0; // number of neighbors in a cell
-      int np = 0; // Number of pairs within cutoff
-
-      // Loop over cells in CellList
-      cellPtr = cellList_.begin();
-      while (cellPtr) {
-         cellPtr->getNeighbors(neighbors);
-         na = cellPtr->nAtom();
-         nn = neighbors.size();
-         // Loop over primary atoms, from this cell
-         for (int i = 0; i < na; ++i) {
-            cellAtomPtr1 = neighbors[i];
-            // Loop over secondary atoms in this cell
-            for (int j = 0; j < na; ++j) {
-               cellAtomPtr2 = neighbors[j];
-               if (cellAtomPtr2 > cellAtomPtr1) {
-                  rsq = boundary.distanceSq(cellAtomPtr1->ptr()->position, 
-                                            cellAtomPtr2->ptr()->position, dr);
-                  if (rsq <= cutoff_*cutoff_) {
-                     ++np;
-                     energy += interaction_.energy(rsq, 
-                                            cellAtomPtr1->ptr()->typeId,
-                                            cellAtomPtr2->ptr()->typeId);
-                  }
-               }
-            }
-            // Loop over atoms in neighboring cells
-            for (int j = na; j < nn; ++j) {
-               cellAtomPtr2 = neighbors[j];
-               rsq = boundary.distanceSq(cellAtomPtr1->ptr()->position, 
-                                         cellAtomPtr2->ptr()->position, dr);
-               if (rsq <= cutoff_*cutoff_) {
-                  ++np;
-                  energy += interaction_.energy(rsq, 
-                                         cellAtomPtr1->ptr()->typeId, 
-                                         cellAtomPtr2->ptr()->typeId);
-               }
+      cell.getNeighbors(neighbors);
+      int na = cell.nAtom();         // number of atoms in this cell
+      int nn = neighbors.size();     // number of neighbors 
+      double cutoffSq = cutoff_*cutoff_;
+      double energy = 0.0;
+      double rsq;
+      const CellAtom* cellAtomPtr1;
+      const CellAtom* cellAtomPtr2;
+      int i, j;
+
+      // Loop over primary atoms, from this cell
+      for (i = 0; i < na; ++i) {
+         cellAtomPtr1 = neighbors[i];
+
+         // Secondary atoms from this cell (j > i), then from neighbors
+         for (j = i + 1; j < nn; ++j) {
+            cellAtomPtr2 = neighbors[j];
+            rsq = boundary.distanceSq(cellAtomPtr1->position(), 
+                                      cellAtomPtr2->position());
+            if (rsq <= cutoffSq) {
+               energy += interaction_.energy(rsq, 
+                                      cellAtomPtr1->ptr()->typeId,
+                                      cellAtomPtr2->ptr()->typeId);
             }
          }
-         cellPtr = cellPtr->nextCellPtr();
       }
+      return energy;
+   }
 
-      timesteps_.append(iStep);
-      energies_.append(energy);
+   /*
+   * Save statistical state to an archive.
+   */
+   void PairEnergy::saveState(Serializable::OArchive& ar)
+   {
+      ar & timesteps_;
+      ar & energies_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void PairEnergy::loadState(Serializable::IArchive& ar)
+   {
+      ar & timesteps_;
+      ar & energies_;
    }
 
    /*
@@ -190,5 +203,53 @@ namespace Tools
 
    }
 
+   #ifdef UTIL_MPI
+   /*
+   * Gather energies on processor 0, in order of processor rank.
+   */
+   void PairEnergy::reduce(MPI::Intracomm& communicator)
+   {
+      int rank = communicator.Get_rank();
+      int nProc = communicator.Get_size();
+      int n = timesteps_.size();
+      std::vector<int> steps(n + 1);
+      std::vector<double> energies(n + 1);
+      int i;
+      for (i = 0; i < n; ++i) {
+         steps[i] = timesteps_[i];
+         energies[i] = energies_[i];
+      }
+
+      // Frames are assigned to processors in contiguous blocks, so
+      // concatenation in order of rank preserves the order of frames.
+      std::vector<int> counts(nProc);
+      std::vector<int> displs(nProc);
+      communicator.Gather(&n, 1, MPI::INT, &counts[0], 1, MPI::INT, 0);
+      int total = 0;
+      if (rank == 0) {
+         for (i = 0; i < nProc; ++i) {
+            displs[i] = total;
+            total += counts[i];
+         }
+      }
+      std::vector<int> allSteps(total + 1);
+      std::vector<double> allEnergies(total + 1);
+      communicator.Gatherv(&steps[0], n, MPI::INT,
+                           &allSteps[0], &counts[0], &displs[0],
+                           MPI::INT, 0);
+      communicator.Gatherv(&energies[0], n, MPI::DOUBLE,
+                           &allEnergies[0], &counts[0], &displs[0],
+                           MPI::DOUBLE, 0);
+      if (rank == 0) {
+         timesteps_.clear();
+         energies_.clear();
+         for (i = 0; i < total; ++i) {
+            timesteps_.append(allSteps[i]);
+            energies_.append(allEnergies[i]);
+         }
+      }
+   }
+   #endif
+
 }
 
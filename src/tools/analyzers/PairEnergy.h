@@ -11,7 +11,6 @@
 #include <tools/analyzers/Analyzer.h>       // base class 
 #include <tools/neighbor/CellList.h>        // member
 #include <simp/interaction/pair/LJPair.h>   // member
-#include <tools/neighbor/CellList.h>        // member
 #include <util/containers/GArray.h>         // member
 
 namespace Tools
@@ -70,6 +69,35 @@ namespace Tools
       */
       virtual void output();
 
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * Return true: each frame is analyzed independently.
+      */
+      virtual bool isFrameParallel() const
+      {  return true; }
+
+      /**
+      * Gather energies of all frames on processor 0, in frame order.
+      *
+      * \param communicator communicator for all processors
+      */
+      virtual void reduce(MPI::Intracomm& communicator);
+      #endif
+
    private:
 
       /// Pair interaction type (hard-coded for now).
@@ -101,6 +129,14 @@ namespace Tools
       /// Store energies for the runs
       GArray<double> energies_;
 
+      /**
+      * Return energy of all pairs found by getNeighbors() for one cell.
+      *
+      * \param cell  primary cell
+      * \param boundary  periodic boundary
+      */
+      double cellEnergy(const Cell& cell, const Boundary& boundary) const;
+
    };
 
 }
@@ -0,0 +1,362 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "StructureFactor.h"
+#include <tools/analyzers/phaseSums.h>
+#include <tools/chemistry/Atom.h>
+#include <tools/storage/Configuration.h>
+#include <util/boundary/Boundary.h>
+#include <util/space/Dimension.h>
+#include <util/format/Int.h>
+#include <util/format/Dbl.h>
+#include <util/archives/Serializable_includes.h>
+
+#include <util/global.h>
+
+#include <cmath>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   StructureFactor::StructureFactor(Processor& processor)
+    : Analyzer(processor),
+      outputFile_(),
+      modes_(),
+      waveIntVectors_(),
+      waveVectors_(),
+      structureFactors_(),
+      positions_(),
+      typeIds_(),
+      batchWaves_(),
+      volumes_(),
+      nAtoms_(),
+      amplitudes_(),
+      nAtomType_(-1),
+      nMode_(-1),
+      nWave_(-1),
+      batchSize_(16),
+      nBatch_(0),
+      atomCapacity_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("StructureFactor"); }
+
+   /*
+   * Constructor.
+   */
+   StructureFactor::StructureFactor(Configuration& configuration,
+                                    FileMaster& fileMaster)
+    : Analyzer(configuration, fileMaster),
+      outputFile_(),
+      modes_(),
+      waveIntVectors_(),
+      waveVectors_(),
+      structureFactors_(),
+      positions_(),
+      typeIds_(),
+      batchWaves_(),
+      volumes_(),
+      nAtoms_(),
+      amplitudes_(),
+      nAtomType_(-1),
+      nMode_(-1),
+      nWave_(-1),
+      batchSize_(16),
+      nBatch_(0),
+      atomCapacity_(0),
+      nSample_(0),
+      isInitialized_(false)
+   {  setClassName("StructureFactor"); }
+
+   /*
+   * Read parameters from file, and allocate accumulators.
+   */
+   void StructureFactor::readParameters(std::istream& in)
+   {
+      readInterval(in);
+      readOutputFileName(in);
+      read<int>(in, "nAtomType", nAtomType_);
+      if (nAtomType_ <= 0) {
+         UTIL_THROW("nAtomType <= 0");
+      }
+      read<int>(in, "nMode", nMode_);
+      if (nMode_ <= 0) {
+         UTIL_THROW("nMode <= 0");
+      }
+      modes_.allocate(nMode_, nAtomType_);
+      readDMatrix<double>(in, "modes", modes_, nMode_, nAtomType_);
+      read<int>(in, "nWave", nWave_);
+      if (nWave_ <= 0) {
+         UTIL_THROW("nWave <= 0");
+      }
+      waveIntVectors_.allocate(nWave_);
+      readDArray<IntVector>(in, "waveIntVectors", waveIntVectors_, nWave_);
+      batchSize_ = 16;
+      readOptional<int>(in, "batchSize", batchSize_);
+      if (batchSize_ <= 0) {
+         UTIL_THROW("batchSize <= 0");
+      }
+
+      waveVectors_.allocate(nWave_);
+      structureFactors_.allocate(nWave_, nMode_);
+      batchWaves_.allocate(batchSize_*nWave_);
+      volumes_.allocate(batchSize_);
+      nAtoms_.allocate(batchSize_);
+      amplitudes_.allocate(2*batchSize_*nWave_*nAtomType_);
+
+      isInitialized_ = true;
+   }
+
+   /*
+   * Clear accumulators.
+   */
+   void StructureFactor::setup()
+   {
+      if (!isInitialized_) {
+         UTIL_THROW("Error: object is not initialized");
+      }
+      for (int i = 0; i < nWave_; ++i) {
+         waveVectors_[i].zero();
+         for (int j = 0; j < nMode_; ++j) {
+            structureFactors_(i, j) = 0.0;
+         }
+      }
+      nBatch_ = 0;
+      nSample_ = 0;
+   }
+
+   /*
+   * Allocate batch arrays for frames of up to atomCapacity atoms.
+   */
+   void StructureFactor::allocateBatch(int atomCapacity)
+   {
+      if (positions_.isAllocated()) {
+         positions_.deallocate();
+         typeIds_.deallocate();
+      }
+      positions_.allocate(batchSize_*Dimension*atomCapacity);
+      typeIds_.allocate(batchSize_*atomCapacity);
+      atomCapacity_ = atomCapacity;
+   }
+
+   /*
+   * Copy the current frame into the batch, and evaluate a full batch.
+   */
+   void StructureFactor::sample(long iStep)
+   {
+      if (!isAtInterval(iStep)) return;
+
+      AtomStorage& atoms = configuration().atoms();
+      int nAtom = atoms.size();
+      if (nAtom > atomCapacity_) {
+         processBatch();
+         allocateBatch(atoms.capacity() > nAtom ? atoms.capacity() : nAtom);
+      }
+
+      // Calculate wavevectors for the current boundary
+      Boundary& boundary = configuration().boundary();
+      Vector dWave;
+      int i, j;
+      for (i = 0; i < nWave_; ++i) {
+         waveVectors_[i].zero();
+         for (j = 0; j < Dimension; ++j) {
+            dWave  = boundary.reciprocalBasisVector(j);
+            dWave *= waveIntVectors_[i][j];
+            waveVectors_[i] += dWave;
+         }
+         batchWaves_[nBatch_*nWave_ + i] = waveVectors_[i];
+      }
+      volumes_[nBatch_] = boundary.volume();
+      nAtoms_[nBatch_] = nAtom;
+
+      // Copy positions into x, y and z columns, and copy type ids
+      double* x = &positions_[nBatch_*Dimension*atomCapacity_];
+      int* t = &typeIds_[nBatch_*atomCapacity_];
+      const Atom* atomPtr;
+      int k;
+      for (k = 0; k < nAtom; ++k) {
+         atomPtr = &atoms.atom(k);
+         if (atomPtr->typeId < 0 || atomPtr->typeId >= nAtomType_) {
+            UTIL_THROW("Invalid atom typeId");
+         }
+         for (j = 0; j < Dimension; ++j) {
+            x[j*atomCapacity_ + k] = atomPtr->position[j];
+         }
+         t[k] = atomPtr->typeId;
+      }
+
+      ++nBatch_;
+      if (nBatch_ == batchSize_) {
+         processBatch();
+      }
+   }
+
+   /*
+   * Compute amplitudes of all atom types for one frame and wavevector.
+   */
+   void StructureFactor::computeAmplitudes(int frame, int wave)
+   {
+      const double* x = &positions_[frame*Dimension*atomCapacity_];
+      const double* y = x + atomCapacity_;
+      const double* z = y + atomCapacity_;
+      const int* t = &typeIds_[frame*atomCapacity_];
+      const Vector& q = batchWaves_[frame*nWave_ + wave];
+      double* a = &amplitudes_[2*nAtomType_*(frame*nWave_ + wave)];
+      for (int k = 0; k < 2*nAtomType_; ++k) {
+         a[k] = 0.0;
+      }
+      addPhases(x, y, z, t, nAtoms_[frame], &q[0], a);
+   }
+
+   /*
+   * Evaluate all frames of the current batch, and add to accumulators.
+   */
+   void StructureFactor::processBatch()
+   {
+      if (nBatch_ == 0) return;
+
+      // Phase sums, one work item per pair of frame and wavevector
+      const int nItem = nBatch_*nWave_;
+      #ifdef TOOLS_OFFLOAD
+      // Map the batch to the device, and amplitudes back to the host
+      const int nb = nBatch_;
+      const int nw = nWave_;
+      const int na = nAtomType_;
+      const int cap = atomCapacity_;
+      const double* r = &positions_[0];
+      const int* types = &typeIds_[0];
+      const double* waves = (const double*)&batchWaves_[0];
+      const int* sizes = &nAtoms_[0];
+      double* amps = &amplitudes_[0];
+      #pragma omp target teams distribute parallel for \
+              map(to: r[0:nb*Dimension*cap], types[0:nb*cap], \
+                      waves[0:Dimension*nItem], sizes[0:nb]) \
+              map(from: amps[0:2*na*nItem])
+      for (int item = 0; item < nItem; ++item) {
+         const int f = item/nw;
+         const double* x = r + f*Dimension*cap;
+         double* a = amps + 2*na*item;
+         for (int k = 0; k < 2*na; ++k) {
+            a[k] = 0.0;
+         }
+         addPhases(x, x + cap, x + 2*cap, types + f*cap, sizes[f],
+                   waves + Dimension*item, a);
+      }
+      #else
+      int item;
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel for schedule(static)
+      #endif
+      for (item = 0; item < nItem; ++item) {
+         computeAmplitudes(item/nWave_, item%nWave_);
+      }
+      #endif
+
+      // Combine amplitudes of types into modes, in order of frames
+      const double* a;
+      double re, im, w;
+      int f, i, j, k;
+      for (f = 0; f < nBatch_; ++f) {
+         for (i = 0; i < nWave_; ++i) {
+            a = &amplitudes_[2*nAtomType_*(f*nWave_ + i)];
+            for (j = 0; j < nMode_; ++j) {
+               re = 0.0;
+               im = 0.0;
+               for (k = 0; k < nAtomType_; ++k) {
+                  w = modes_(j, k);
+                  re += w*a[2*k];
+                  im += w*a[2*k + 1];
+               }
+               structureFactors_(i, j) += (re*re + im*im)/volumes_[f];
+            }
+         }
+      }
+      nSample_ += nBatch_;
+      nBatch_ = 0;
+   }
+
+   /*
+   * Save statistical state to an archive.
+   */
+   void StructureFactor::saveState(Serializable::OArchive& ar)
+   {
+      processBatch();
+      ar & structureFactors_;
+      ar & nSample_;
+   }
+
+   /*
+   * Load statistical state from an archive.
+   */
+   void StructureFactor::loadState(Serializable::IArchive& ar)
+   {
+      ar & structureFactors_;
+      ar & nSample_;
+      nBatch_ = 0;
+   }
+
+   /*
+   * Output results to file after simulation is completed.
+   */
+   void StructureFactor::output()
+   {
+      processBatch();
+
+      // Output parameters
+      fileMaster().openOutputFile(outputFileName(".prm"), outputFile_);
+      writeParam(outputFile_);
+      outputFile_.close();
+
+      // Output structure factors, with |q| for the last frame
+      fileMaster().openOutputFile(outputFileName(".dat"), outputFile_);
+      double value;
+      int i, j, k;
+      for (i = 0; i < nWave_; ++i) {
+         for (k = 0; k < Dimension; ++k) {
+            outputFile_ << Int(waveIntVectors_[i][k], 5);
+         }
+         outputFile_ << Dbl(waveVectors_[i].abs(), 20, 8);
+         for (j = 0; j < nMode_; ++j) {
+            value = 0.0;
+            if (nSample_ > 0) {
+               value = structureFactors_(i, j)/double(nSample_);
+            }
+            outputFile_ << Dbl(value, 18, 8);
+         }
+         outputFile_ << std::endl;
+      }
+      outputFile_.close();
+   }
+
+   #ifdef UTIL_MPI
+   /*
+   * Sum structure factors and sample counts on processor 0.
+   */
+   void StructureFactor::reduce(MPI::Intracomm& communicator)
+   {
+      processBatch();
+      int size = nWave_*nMode_;
+      if (communicator.Get_rank() == 0) {
+         communicator.Reduce(MPI::IN_PLACE, &structureFactors_(0, 0), size,
+                             MPI::DOUBLE, MPI::SUM, 0);
+         communicator.Reduce(MPI::IN_PLACE, &nSample_, 1,
+                             MPI::LONG, MPI::SUM, 0);
+      } else {
+         communicator.Reduce(&structureFactors_(0, 0), 0, size,
+                             MPI::DOUBLE, MPI::SUM, 0);
+         communicator.Reduce(&nSample_, 0, 1,
+                             MPI::LONG, MPI::SUM, 0);
+      }
+   }
+   #endif
+
+}
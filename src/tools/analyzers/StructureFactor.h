@@ -0,0 +1,199 @@
+#ifndef TOOLS_STRUCTURE_FACTOR_H
+#define TOOLS_STRUCTURE_FACTOR_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/analyzers/Analyzer.h>       // base class
+#include <util/containers/DArray.h>         // member template
+#include <util/containers/DMatrix.h>        // member template
+#include <util/space/IntVector.h>           // member template parameter
+#include <util/space/Vector.h>              // member template parameter
+
+#include <fstream>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Structure factors, computed from batches of frames.
+   *
+   * Computes the same structure factors as McMd::StructureFactor, i.e.,
+   * S_j(q) = |sum_a modes(j, t_a) exp(i q.r_a)|^2 / V for each mode j,
+   * where t_a is the type of atom a, for a list of nWave wavevectors
+   * given by integer indices of reciprocal lattice vectors.
+   *
+   * The phase sums over atoms take almost all of the time. To make them
+   * efficient, sample() only copies the positions and types of atoms of
+   * each frame into columnar (x, y, z) arrays, and the phase sums for all
+   * pairs of frame and wavevector in a batch of batchSize frames are
+   * then evaluated as independent work items, each a single pass over
+   * contiguous arrays, in parallel if compiled with TOOLS_OPENMP. If
+   * compiled with TOOLS_OFFLOAD, the work items of each batch are
+   * instead evaluated on a GPU or other device by OpenMP target offload,
+   * with one transfer of the batch to the device and of the amplitudes
+   * back to the host.
+   * Partial batches are evaluated by saveState(), reduce() and output().
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   class StructureFactor : public Analyzer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param processor reference to parent Processor
+      */
+      StructureFactor(Processor &processor);
+
+      /**
+      * Constructor.
+      *
+      * \param configuration reference to parent Configuration
+      * \param fileMaster reference to associated FileMaster
+      */
+      StructureFactor(Configuration &configuration, FileMaster& fileMaster);
+
+      /**
+      * Read parameters from file.
+      *
+      * \param in input parameter stream
+      */
+      virtual void readParameters(std::istream& in);
+
+      /**
+      * Clear accumulators.
+      */
+      virtual void setup();
+
+      /**
+      * Add the current frame to the batch, and evaluate a full batch.
+      *
+      * \param iStep counter for number of steps
+      */
+      virtual void sample(long iStep);
+
+      /**
+      * Output results to file after simulation is completed.
+      */
+      virtual void output();
+
+      /**
+      * Save statistical state to an archive.
+      *
+      * \param ar output/saving archive
+      */
+      virtual void saveState(Serializable::OArchive& ar);
+
+      /**
+      * Load statistical state from an archive.
+      *
+      * \param ar input/loading archive
+      */
+      virtual void loadState(Serializable::IArchive& ar);
+
+      #ifdef UTIL_MPI
+      /**
+      * Return true: each frame is analyzed independently.
+      */
+      virtual bool isFrameParallel() const
+      {  return true; }
+
+      /**
+      * Sum structure factors of all processors on processor 0.
+      *
+      * \param communicator communicator for all processors
+      */
+      virtual void reduce(MPI::Intracomm& communicator);
+      #endif
+
+   private:
+
+      /// Output file stream.
+      std::ofstream outputFile_;
+
+      /// Weights of each atom type in each mode (nMode x nAtomType).
+      DMatrix<double> modes_;
+
+      /// Integer indices of wavevectors.
+      DArray<IntVector> waveIntVectors_;
+
+      /// Wavevectors for the most recent frame.
+      DArray<Vector> waveVectors_;
+
+      /// Accumulated structure factors (nWave x nMode).
+      DMatrix<double> structureFactors_;
+
+      /// Columnar positions of batch frames (x, y, z blocks per frame).
+      DArray<double> positions_;
+
+      /// Atom type ids of batch frames.
+      DArray<int> typeIds_;
+
+      /// Wavevectors of batch frames (nWave per frame).
+      DArray<Vector> batchWaves_;
+
+      /// Volumes of batch frames.
+      DArray<double> volumes_;
+
+      /// Number of atoms in each batch frame.
+      DArray<int> nAtoms_;
+
+      /// Real and imaginary amplitudes per (frame, wave, atom type).
+      DArray<double> amplitudes_;
+
+      /// Number of atom types.
+      int nAtomType_;
+
+      /// Number of modes.
+      int nMode_;
+
+      /// Number of wavevectors.
+      int nWave_;
+
+      /// Maximum number of frames per batch.
+      int batchSize_;
+
+      /// Number of frames in the current batch.
+      int nBatch_;
+
+      /// Maximum number of atoms per frame in batch arrays.
+      int atomCapacity_;
+
+      /// Number of frames added to structureFactors_.
+      long nSample_;
+
+      /// Has readParam been called?
+      bool isInitialized_;
+
+      /**
+      * Allocate batch arrays for frames of up to atomCapacity atoms.
+      */
+      void allocateBatch(int atomCapacity);
+
+      /**
+      * Compute amplitudes of all types for one frame and wavevector.
+      *
+      * \param frame index of frame in batch
+      * \param wave  index of wavevector
+      */
+      void computeAmplitudes(int frame, int wave);
+
+      /**
+      * Evaluate all frames of the current batch, and add to accumulators.
+      */
+      void processBatch();
+
+   };
+
+}
+#endif
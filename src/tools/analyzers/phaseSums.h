@@ -0,0 +1,54 @@
+#ifndef TOOLS_PHASE_SUMS_H
+#define TOOLS_PHASE_SUMS_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <cmath>
+
+namespace Tools
+{
+
+   #ifdef TOOLS_OFFLOAD
+   #pragma omp declare target
+   #endif
+
+   /**
+   * Add exp(i q.r) of n atoms to the Fourier amplitudes of their types.
+   *
+   * Used by the host and offload device kernels of structure factor
+   * analyzers. Positions are given in columnar x, y and z arrays. The
+   * real and imaginary parts for atom type t are a[2*t] and a[2*t+1].
+   *
+   * \param x  x coordinates of atoms
+   * \param y  y coordinates of atoms
+   * \param z  z coordinates of atoms
+   * \param t  atom type ids
+   * \param n  number of atoms
+   * \param q  wavevector (3 components)
+   * \param a  amplitudes, indexed by type (incremented)
+   *
+   * \ingroup Tools_Analyzer_Module
+   */
+   inline
+   void addPhases(const double* x, const double* y, const double* z,
+                  const int* t, int n, const double* q, double* a)
+   {
+      double phase;
+      for (int k = 0; k < n; ++k) {
+         phase = q[0]*x[k] + q[1]*y[k] + q[2]*z[k];
+         a[2*t[k]] += cos(phase);
+         a[2*t[k] + 1] += sin(phase);
+      }
+   }
+
+   #ifdef TOOLS_OFFLOAD
+   #pragma omp end declare target
+   #endif
+
+}
+#endif
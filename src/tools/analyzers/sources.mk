@@ -4,7 +4,13 @@ tools_analyzers_=\
      tools/analyzers/AtomMSD.cpp \
      tools/analyzers/TrajectoryWriter.cpp \
      tools/analyzers/LammpsDumpWriter.cpp \
-     tools/analyzers/PairEnergy.cpp
+     tools/analyzers/PairEnergy.cpp \
+     tools/analyzers/IntraBondTensorAutoCorr.cpp \
+     tools/analyzers/LinearRouseAutoCorr.cpp \
+     tools/analyzers/CompositionProfile.cpp \
+     tools/analyzers/BlockRadiusGyration.cpp \
+     tools/analyzers/StructureFactor.cpp \
+     tools/analyzers/IntraStructureFactor.cpp
 
 tools_analyzers_SRCS=\
      $(addprefix $(SRC_DIR)/, $(tools_analyzers_))
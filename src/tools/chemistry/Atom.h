@@ -18,6 +18,10 @@ namespace Tools
    /**
    * A point particle in an MD simulation.
    *
+   * Velocities are not stored in the Atom: they are stored in a separate
+   * array that is allocated by the parent AtomStorage only when needed.
+   * Use AtomStorage::velocity(id) to access the velocity of an atom.
+   *
    * \ingroup Tools_Chemistry_Module
    */
    struct Atom
@@ -28,9 +32,6 @@ namespace Tools
       /// Atom position
       Vector position;    
 
-      /// Atom velocity
-      Vector velocity;    
-
       /// Atom type index
       int typeId;         
 
@@ -0,0 +1,141 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "BinaryConfigReader.h"
+
+#include <tools/chemistry/Atom.h>
+#include <tools/storage/Configuration.h>
+#include <simp/trajectory/BinaryConfigFormat.h>
+
+#include <util/space/Vector.h>
+
+#include <string>
+#include <limits>
+
+namespace Tools
+{
+
+   using namespace Util;
+   using namespace Simp;
+
+   /*
+   * Constructor.
+   */
+   BinaryConfigReader::BinaryConfigReader(Configuration& configuration)
+    : ConfigReader(configuration),
+      buffer_()
+   {  setClassName("BinaryConfigReader"); }
+
+   /*
+   * Read a binary configuration file.
+   */
+   void BinaryConfigReader::readConfig(std::ifstream& file)
+   {
+      // Precondition
+      if (!file.is_open()) {
+         UTIL_THROW("Error: File is not open");
+      }
+
+      // Text lines: magic string and version, then Boundary
+      std::string magic;
+      int version;
+      file >> magic >> version;
+      if (!file || magic != BinaryConfig::Magic) {
+         UTIL_THROW("File is not a binary config file");
+      }
+      if (version != BinaryConfig::Version) {
+         UTIL_THROW("Unsupported binary config file version");
+      }
+      Boundary& boundary = configuration().boundary();
+      file >> boundary;
+      file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+      BinaryConfig::FileHeader header;
+      file.read((char*)(&header), sizeof(BinaryConfig::FileHeader));
+      if (!file) {
+         UTIL_THROW("Error reading binary config header");
+      }
+      bool hasVelocities = (header.flags & BinaryConfig::HasVelocities);
+
+      // Atoms are created, unless storage already holds them
+      AtomStorage& storage = configuration().atoms();
+      bool hasAtoms = (storage.size() > 0);
+      if (hasVelocities) {
+         storage.allocateVelocities();
+      }
+
+      BinaryConfig::SpeciesHeader speciesHeader;
+      Atom* atomPtr;
+      const double* positions;
+      const double* velocities;
+      const int32_t* types;
+      size_t nByte;
+      int iSpecies, n, i, j;
+      int id = 0;
+      for (iSpecies = 0; iSpecies < header.nSpecies; ++iSpecies) {
+         file.read((char*)(&speciesHeader),
+                   sizeof(BinaryConfig::SpeciesHeader));
+         if (!file) {
+            UTIL_THROW("Error reading binary config species header");
+         }
+
+         // Read all data for this species
+         nByte = BinaryConfig::blockSize(speciesHeader, header.flags);
+         buffer_.resize(nByte);
+         if (nByte > 0) {
+            file.read(&buffer_[0], nByte);
+            if (!file) {
+               UTIL_THROW("Incomplete binary config species block");
+            }
+         }
+         n = speciesHeader.nMolecule*speciesHeader.nAtom;
+         positions = (const double*)(&buffer_[0]);
+         velocities = hasVelocities ? positions + 3*n : 0;
+         types = (const int32_t*)(positions + (hasVelocities ? 6*n : 3*n));
+
+         for (i = 0; i < n; ++i) {
+            if (hasAtoms) {
+               atomPtr = storage.ptr(id);
+               if (!atomPtr) {
+                  UTIL_THROW("Atom not found");
+               }
+            } else {
+               atomPtr = storage.newPtr();
+               atomPtr->id = id;
+            }
+            atomPtr->typeId = types[i];
+            for (j = 0; j < Dimension; ++j) {
+               atomPtr->position[j] = positions[3*i + j];
+            }
+            boundary.shift(atomPtr->position);
+            if (!hasAtoms) {
+               storage.add();
+            }
+            if (velocities) {
+               Vector& v = storage.velocity(id);
+               for (j = 0; j < Dimension; ++j) {
+                  v[j] = velocities[3*i + j];
+               }
+            }
+            ++id;
+         }
+      }
+      if (hasAtoms && id != storage.size()) {
+         UTIL_THROW("Inconsistent number of atoms");
+      }
+
+      // If species are declared, set atom context info
+      if (configuration().nSpecies() > 0) {
+         bool success;
+         success = setAtomContexts();
+         if (success) {
+            addAtomsToSpecies();
+         }
+      }
+   }
+
+}
@@ -0,0 +1,62 @@
+#ifndef TOOLS_BINARY_CONFIG_READER_H
+#define TOOLS_BINARY_CONFIG_READER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/config/ConfigReader.h>   // base class
+
+#include <iostream>
+#include <vector>
+
+namespace Tools
+{
+
+   class Configuration;
+
+   using namespace Util;
+
+   /**
+   * Reader for the compact binary configuration format of mcSim/mdSim.
+   *
+   * Reads files written by McMd::BinaryConfigIo, in the format described
+   * in the documentation of Simp::BinaryConfig. Atoms are given ids in
+   * order of species, molecule and atom index, and the data for each
+   * species is read with a single bulk read. If species are declared,
+   * atom context data is set and atoms are added to species. The file
+   * contains no bond, angle or dihedral groups.
+   *
+   * \ingroup Tools_ConfigReader_Module
+   */
+   class BinaryConfigReader  : public ConfigReader
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration object.
+      */
+      BinaryConfigReader(Configuration& configuration);
+
+      /**
+      * Read a binary configuration file.
+      *
+      * \param file input file stream
+      */
+      virtual void readConfig(std::ifstream& file);
+
+   private:
+
+      /// Buffer for the data block of one species.
+      std::vector<char> buffer_;
+
+   };
+
+}
+#endif
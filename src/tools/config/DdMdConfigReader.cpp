@@ -17,6 +17,9 @@
 //#include <util/format/Int.h>
 //#include <util/format/Dbl.h>
 
+#include <cctype>
+#include <cstdlib>
+
 namespace Tools
 {
 
@@ -27,9 +30,89 @@ namespace Tools
    */
    DdMdConfigReader::DdMdConfigReader(Configuration& configuration, bool hasMolecules)
     : ConfigReader(configuration),
+      atomText_(),
+      atomOffsets_(),
       hasMolecules_(hasMolecules)
    {  setClassName("DdMdConfigReader"); }
 
+   /*
+   * Read text of the ATOMS block, and record where each atom begins.
+   */
+   void DdMdConfigReader::readAtomText(std::ifstream& file, int nAtom)
+   {
+      const long nToken = hasMolecules_ ? 11 : 8;
+      const long nTokenTotal = nToken*nAtom;
+      long iToken = 0;
+      std::string line;
+      size_t i, size;
+
+      atomText_.clear();
+      atomOffsets_.clear();
+      atomOffsets_.reserve(nAtom);
+      while (iToken < nTokenTotal) {
+         if (!std::getline(file, line)) {
+            UTIL_THROW("EOF reading ATOMS block");
+         }
+         i = atomText_.size();
+         atomText_ += line;
+         atomText_ += '\n';
+         size = atomText_.size();
+
+         // Count whitespace separated tokens in the new line
+         while (i < size) {
+            while (i < size && isspace(atomText_[i])) ++i;
+            if (i == size) break;
+            if (iToken == nTokenTotal) {
+               UTIL_THROW("Unexpected data at end of ATOMS block");
+            }
+            if (iToken % nToken == 0) {
+               atomOffsets_.push_back(i);
+            }
+            ++iToken;
+            while (i < size && !isspace(atomText_[i])) ++i;
+         }
+      }
+   }
+
+   /*
+   * Parse one atom record.
+   */
+   bool DdMdConfigReader::parseAtom(const char* ptr, Atom& atom, 
+                                    Vector& velocity) const
+   {
+      char* end;
+      int j;
+
+      atom.id = strtol(ptr, &end, 10);
+      if (end == ptr) return false;
+      ptr = end;
+      atom.typeId = strtol(ptr, &end, 10);
+      if (end == ptr) return false;
+      ptr = end;
+      if (hasMolecules_) {
+         atom.speciesId = strtol(ptr, &end, 10);
+         if (end == ptr) return false;
+         ptr = end;
+         atom.moleculeId = strtol(ptr, &end, 10);
+         if (end == ptr) return false;
+         ptr = end;
+         atom.atomId = strtol(ptr, &end, 10);
+         if (end == ptr) return false;
+         ptr = end;
+      }
+      for (j = 0; j < Dimension; ++j) {
+         atom.position[j] = strtod(ptr, &end);
+         if (end == ptr) return false;
+         ptr = end;
+      }
+      for (j = 0; j < Dimension; ++j) {
+         velocity[j] = strtod(ptr, &end);
+         if (end == ptr) return false;
+         ptr = end;
+      }
+      return true;
+   }
+
    /*
    * Private method to read Group<N> objects.
    */
@@ -68,16 +151,42 @@ namespace Tools
 
       // Read atoms
       Atom* atomPtr;
-      int atomCapacity = configuration().atoms().capacity(); // Maximum allowed id + 1
+      AtomStorage& storage = configuration().atoms();
+      int atomCapacity = storage.capacity(); // Maximum allowed id + 1
       int nAtom;          
+      int i;
+      storage.allocateVelocities();
       file >> Label("ATOMS");
       file >> Label("nAtom") >> nAtom;
-      for (int i = 0; i < nAtom; ++i) {
+      if (nAtom < 0) {
+         UTIL_THROW("Negative nAtom");
+      }
+
+      // Read text of atom records, and parse records (in parallel)
+      readAtomText(file, nAtom);
+      std::vector<Atom> atoms(nAtom);
+      std::vector<Vector> velocities(nAtom);
+      int nError = 0;
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel for schedule(static) reduction(+:nError)
+      #endif
+      for (i = 0; i < nAtom; ++i) {
+         if (!parseAtom(&atomText_[atomOffsets_[i]], atoms[i], 
+                        velocities[i])) {
+            ++nError;
+         }
+      }
+      if (nError) {
+         UTIL_THROW("Invalid atom record in ATOMS block");
+      }
+
+      // Check and add atoms, in order read from file
+      for (i = 0; i < nAtom; ++i) {
 
          // Get pointer to new atom 
-         atomPtr = configuration().atoms().newPtr();
+         atomPtr = storage.newPtr();
+         *atomPtr = atoms[i];
  
-         file >> atomPtr->id;
          if (atomPtr->id < 0) {
             std::cout << "atom id =" << atomPtr->id << std::endl;
             UTIL_THROW("Negative atom id");
@@ -87,30 +196,26 @@ namespace Tools
             std::cout << "atomCapacity =" << atomCapacity << std::endl;
             UTIL_THROW("Invalid atom id");
          }
-         file >> atomPtr->typeId;
          if (hasMolecules_) {
-            file >> atomPtr->speciesId;
             if (atomPtr->speciesId < 0) {
                std::cout << "species Id  =" << atomPtr->speciesId << std::endl;
                UTIL_THROW("Negative species id");
             }
-            file >> atomPtr->moleculeId; 
             if (atomPtr->moleculeId < 0) {
                std::cout << "molecule Id =" << atomPtr->moleculeId << std::endl;
                UTIL_THROW("Negative molecule id");
             }
-            file >> atomPtr->atomId;
             if (atomPtr->atomId < 0) {
                std::cout << "atom id     =" << atomPtr->atomId << std::endl;
                UTIL_THROW("Negative atom id in molecule");
             }
          }
-         file >> atomPtr->position;
-         file >> atomPtr->velocity;
+         storage.velocity(atomPtr->id) = velocities[i];
 
          // Finalize addition of new atom
-         configuration().atoms().add();
+         storage.add();
       }
+      atomText_.clear();
 
       // Read Covalent Groups
       #ifdef SIMP_BOND
@@ -14,6 +14,9 @@
 
 #include <util/format/Int.h>
 
+#include <string>
+#include <vector>
+
 namespace Tools
 {
 
@@ -24,6 +27,11 @@ namespace Tools
    /**
    * Native / default DdMd format for configuration files.
    *
+   * The ATOMS block is read as text, and then parsed with strtol and
+   * strtod rather than by formatted stream extraction. If TOOLS_OPENMP
+   * is defined, atoms are parsed by several threads. Atom records may
+   * span any number of lines, as for formatted input.
+   *
    * \ingroup Tools_ConfigReader_Module
    */
    class DdMdConfigReader  : public ConfigReader
@@ -53,8 +61,32 @@ namespace Tools
 
    private:
 
+      /// Text of the ATOMS block.
+      std::string atomText_;
+
+      /// Offsets within atomText_ of the first token of each atom.
+      std::vector<size_t> atomOffsets_;
+
       bool hasMolecules_;
 
+      /**
+      * Read text of nAtom atom records, and locate each record.
+      *
+      * \param file  input file, positioned after the nAtom line
+      * \param nAtom number of atoms
+      */
+      void readAtomText(std::ifstream& file, int nAtom);
+
+      /**
+      * Parse one atom record.
+      *
+      * \param ptr      pointer to beginning of record
+      * \param atom     atom (output)
+      * \param velocity atom velocity (output)
+      * \return true if successful, false if record is invalid
+      */
+      bool parseAtom(const char* ptr, Atom& atom, Vector& velocity) const;
+
       template <int N>
       int readGroups(std::ifstream& file, const char* sectionLabel, 
                      const char* nGroupLabel, GroupStorage<N>& groups);
@@ -17,6 +17,9 @@
 #include <util/format/Int.h>
 #include <util/format/Dbl.h>
 
+#include <stdio.h>
+#include <string>
+
 namespace Tools
 {
 
@@ -38,13 +41,13 @@ namespace Tools
                   const char* nGroupLabel, GroupStorage<N>& groups)
    {
       ArrayIterator< Group<N> > iter;
-      int nGroup = configuration().bonds().size();
+      int nGroup = groups.size();
 
       file << std::endl;
       file << sectionLabel << std::endl;
       file << nGroupLabel << Int(nGroup, 10) << std::endl;
       for (groups.begin(iter); iter.notEnd(); ++iter) {
-         file << *iter << std::endl;
+         file << *iter << "\n";
       }
       return nGroup;
    }
@@ -68,21 +71,44 @@ namespace Tools
       file << "ATOMS" << std::endl;
       int nAtom = configuration().atoms().size();
       file << "nAtom" << Int(nAtom, 10) << std::endl;
-      Vector r;
+      Vector v;
+      v.zero();
+      AtomStorage& storage = configuration().atoms();
+      bool hasVelocities = storage.hasVelocities();
+
+      // Atom records are formatted with sprintf into a block of text,
+      // which is written with a single unformatted write per blockSize
+      // atoms.
+      const int blockSize = 4096;
+      std::string block;
+      char record[256];
+      int n, iAtom = 0;
       AtomStorage::Iterator iter;
       configuration().atoms().begin(iter);
       for (; iter.notEnd(); ++iter) {
-         file << Int(iter->id, 10) 
-              << Int(iter->typeId, 6);
-         r = iter->position;
+         if (hasVelocities) {
+            v = storage.velocity(iter->id);
+         }
+         const Vector& r = iter->position;
          if (hasMolecules_) {
-            file << Int(iter->speciesId, 6) 
-                 << Int(iter->moleculeId, 10)
-                 << Int(iter->atomId, 6);
+            n = sprintf(record, "%10d%6d%6d%10d%6d\n", 
+                        iter->id, iter->typeId, iter->speciesId, 
+                        iter->moleculeId, iter->atomId);
+         } else {
+            n = sprintf(record, "%10d%6d\n", iter->id, iter->typeId);
+         }
+         block.append(record, n);
+         n = sprintf(record, 
+                     "%25.17e%25.17e%25.17e\n%25.17e%25.17e%25.17e\n",
+                     r[0], r[1], r[2], v[0], v[1], v[2]);
+         block.append(record, n);
+         ++iAtom;
+         if (iAtom % blockSize == 0) {
+            file.write(block.c_str(), block.size());
+            block.clear();
          }
-         file << "\n" << r 
-              << "\n" << iter->velocity << "\n";
       }
+      file.write(block.c_str(), block.size());
 
       // Write the groups
       #ifdef SIMP_BOND
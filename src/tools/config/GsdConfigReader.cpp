@@ -0,0 +1,439 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "GsdConfigReader.h"
+
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Group.h>
+#include <tools/storage/GroupStorage.h>
+#include <tools/storage/Configuration.h>
+
+#include <util/space/Vector.h>
+#include <util/misc/ioUtil.h>
+
+#include <cstring>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   GsdConfigReader::GsdConfigReader(Configuration& configuration)
+    : ConfigReader(configuration, true),
+      entries_(),
+      names_(),
+      buffer_(),
+      lastFrame_(0),
+      hasTypeMaps_(false)
+   {  setClassName("GsdConfigReader"); }
+
+   /*
+   * Read auxiliary type map file.
+   */
+   void GsdConfigReader::readAuxiliaryFile(std::ifstream& file)
+   {
+      bool notEnd;
+      std::stringstream line;
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "ATOM");
+         checkString(line, "TYPES:");
+         atomTypeMap_.read(file);
+      }
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "BOND");
+         checkString(line, "TYPES:");
+         bondTypeMap_.read(file);
+      }
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "ANGLE");
+         checkString(line, "TYPES:");
+         angleTypeMap_.read(file);
+      }
+
+      hasTypeMaps_ = true;
+   }
+
+   /*
+   * Read the last frame of a GSD file.
+   */
+   void GsdConfigReader::readConfig(std::ifstream& file)
+   {
+      // Preconditions
+      if (!file.is_open()) {
+         UTIL_THROW("Error: File is not open");
+      }
+      if (!hasTypeMaps_) {
+         UTIL_THROW("Error: A type map file must be read before config");
+      }
+
+      readIndex(file);
+      readAtoms(file);
+      #ifdef SIMP_BOND
+      readGroups<2>(file, "bonds", configuration().bonds(), bondTypeMap_);
+      #endif
+      #ifdef SIMP_ANGLE
+      readGroups<3>(file, "angles", configuration().angles(),
+                    angleTypeMap_);
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      readGroups<4>(file, "dihedrals", configuration().dihedrals(),
+                    dihedralTypeMap_);
+      readGroups<4>(file, "impropers", configuration().impropers(),
+                    improperTypeMap_);
+      #endif
+
+      // If species are declared, attempt to set atom context info,
+      // assuming that atom ids are ordered by molecule and species.
+      if (configuration().nSpecies() > 0) {
+         bool success;
+         success = setAtomContexts();
+         if (success) {
+            addAtomsToSpecies();
+         }
+      }
+
+      // Release memory used for the index and chunk data
+      std::vector<Gsd::IndexEntry>().swap(entries_);
+      std::vector<char>().swap(buffer_);
+   }
+
+   /*
+   * Read header, index and name list.
+   */
+   void GsdConfigReader::readIndex(std::ifstream& file)
+   {
+      if (sizeof(Gsd::Header) != 256 || sizeof(Gsd::IndexEntry) != 32) {
+         UTIL_THROW("Unexpected size of GSD header or index entry");
+      }
+
+      // Header
+      Gsd::Header header;
+      file.seekg(0);
+      file.read((char*)&header, sizeof(Gsd::Header));
+      if (file.fail() || header.magic != Gsd::Magic) {
+         UTIL_THROW("Not a GSD file");
+      }
+      unsigned int major = header.gsdVersion >> 16;
+      if (major < 1 || major > 2) {
+         UTIL_THROW("Unsupported GSD file layout version");
+      }
+
+      // Index (entries with zero location are unused)
+      std::vector<Gsd::IndexEntry> index(header.indexAllocatedEntries);
+      entries_.clear();
+      lastFrame_ = 0;
+      if (index.size() > 0) {
+         file.seekg(header.indexLocation);
+         file.read((char*)&index[0], index.size()*sizeof(Gsd::IndexEntry));
+         if (file.fail()) {
+            UTIL_THROW("Error reading GSD index");
+         }
+      }
+      for (size_t i = 0; i < index.size(); ++i) {
+         if (index[i].location != 0) {
+            entries_.push_back(index[i]);
+            if (index[i].frame > lastFrame_) {
+               lastFrame_ = index[i].frame;
+            }
+         }
+      }
+
+      // Name list: fixed length names in version 1, and consecutive
+      // null-terminated names in version 2, ended by an empty name.
+      size_t nByte = header.namelistAllocatedEntries;
+      if (major == 1) {
+         nByte *= Gsd::NameSize;
+      }
+      buffer_.resize(nByte + 1);
+      if (nByte > 0) {
+         file.seekg(header.namelistLocation);
+         file.read(&buffer_[0], nByte);
+         if (file.fail()) {
+            UTIL_THROW("Error reading GSD name list");
+         }
+      }
+      buffer_[nByte] = '\0';
+      names_.clear();
+      std::string name;
+      size_t position = 0;
+      while (position < nByte) {
+         if (major == 1) {
+            name.assign(&buffer_[position], Gsd::NameSize);
+            name = name.substr(0, name.find('\0'));
+            position += Gsd::NameSize;
+         } else {
+            name = &buffer_[position];
+            position += name.size() + 1;
+         }
+         if (name.empty()) break;
+         names_.push_back(name);
+      }
+   }
+
+   /*
+   * Find the entry for a chunk in the last frame, or else in frame 0.
+   */
+   const Gsd::IndexEntry*
+   GsdConfigReader::findChunk(const std::string& name) const
+   {
+      size_t id = 0;
+      while (id < names_.size() && names_[id] != name) {
+         ++id;
+      }
+      if (id == names_.size()) return 0;
+
+      const Gsd::IndexEntry* firstPtr = 0;
+      for (size_t i = 0; i < entries_.size(); ++i) {
+         if (entries_[i].id == id) {
+            if (entries_[i].frame == lastFrame_) {
+               return &entries_[i];
+            }
+            if (entries_[i].frame == 0) {
+               firstPtr = &entries_[i];
+            }
+         }
+      }
+      return firstPtr;
+   }
+
+   /*
+   * Read data of one chunk into buffer_.
+   */
+   void GsdConfigReader::readChunk(std::ifstream& file,
+                                   const Gsd::IndexEntry& entry,
+                                   int type, unsigned int M)
+   {
+      if (entry.type != type || entry.M != M) {
+         Log::file() << "Chunk name = " << names_[entry.id] << std::endl;
+         UTIL_THROW("Unexpected data type or width of GSD chunk");
+      }
+      size_t nByte = entry.N*entry.M*Gsd::typeSize(type);
+      buffer_.resize(nByte);
+      if (nByte > 0) {
+         file.seekg(entry.location);
+         file.read(&buffer_[0], nByte);
+         if (file.fail()) {
+            UTIL_THROW("Error reading GSD chunk");
+         }
+      }
+   }
+
+   /*
+   * Read a count chunk (e.g., particles/N), return 0 if absent.
+   */
+   int GsdConfigReader::readCount(std::ifstream& file,
+                                  const std::string& name)
+   {
+      const Gsd::IndexEntry* entryPtr = findChunk(name);
+      if (!entryPtr) return 0;
+      readChunk(file, *entryPtr, Gsd::UInt32, 1);
+      if (entryPtr->N != 1) {
+         UTIL_THROW("Count chunk of GSD file is not a single value");
+      }
+      uint32_t value;
+      memcpy(&value, &buffer_[0], sizeof(uint32_t));
+      return int(value);
+   }
+
+   /*
+   * Read a list of type names, with default ["A"].
+   */
+   void GsdConfigReader::readTypeNames(std::ifstream& file,
+                                       const std::string& name,
+                                       std::vector<std::string>& names)
+   {
+      names.clear();
+      const Gsd::IndexEntry* entryPtr = findChunk(name);
+      if (!entryPtr) {
+         names.push_back("A");
+         return;
+      }
+      unsigned int M = entryPtr->M;
+      readChunk(file, *entryPtr, Gsd::Int8, M);
+      std::string typeName;
+      for (size_t i = 0; i < entryPtr->N; ++i) {
+         typeName.assign(&buffer_[i*M], M);
+         names.push_back(typeName.substr(0, typeName.find('\0')));
+      }
+   }
+
+   /*
+   * Read box and atom data.
+   */
+   void GsdConfigReader::readAtoms(std::ifstream& file)
+   {
+      // Box (only orthorhombic boxes are supported)
+      Vector lengths(1.0, 1.0, 1.0);
+      const Gsd::IndexEntry* entryPtr = findChunk("configuration/box");
+      if (entryPtr) {
+         readChunk(file, *entryPtr, Gsd::Float, 1);
+         if (entryPtr->N != 6) {
+            UTIL_THROW("configuration/box chunk does not have 6 values");
+         }
+         const float* box = (const float*)(&buffer_[0]);
+         if (box[3] != 0.0 || box[4] != 0.0 || box[5] != 0.0) {
+            UTIL_THROW("Tilted GSD boxes are not supported");
+         }
+         for (int j = 0; j < Dimension; ++j) {
+            lengths[j] = box[j];
+         }
+      }
+      Boundary& boundary = configuration().boundary();
+      boundary.setOrthorhombic(lengths);
+
+      // Create atoms, if storage is empty
+      AtomStorage& storage = configuration().atoms();
+      int nAtom = storage.size();
+      int n = readCount(file, "particles/N");
+      Atom* atomPtr;
+      int i, j;
+      if (nAtom > 0) {
+         if (n != nAtom) {
+            UTIL_THROW("Inconsistent number of atoms");
+         }
+         for (i = 0; i < n; ++i) {
+            if (!storage.ptr(i)) {
+               UTIL_THROW("Atom not found");
+            }
+         }
+      } else {
+         for (i = 0; i < n; ++i) {
+            atomPtr = storage.newPtr();
+            atomPtr->id = i;
+            atomPtr->typeId = 0;
+            atomPtr->position.zero();
+            storage.add();
+         }
+      }
+
+      // Positions
+      entryPtr = findChunk("particles/position");
+      if (entryPtr) {
+         readChunk(file, *entryPtr, Gsd::Float, 3);
+         if (entryPtr->N != (uint64_t)n) {
+            UTIL_THROW("Inconsistent number of positions");
+         }
+         const float* data = (const float*)(&buffer_[0]);
+         for (i = 0; i < n; ++i) {
+            atomPtr = storage.ptr(i);
+            for (j = 0; j < Dimension; ++j) {
+               atomPtr->position[j] = data[3*i + j];
+            }
+            boundary.shift(atomPtr->position);
+         }
+      }
+
+      // Velocities
+      entryPtr = findChunk("particles/velocity");
+      if (entryPtr) {
+         readChunk(file, *entryPtr, Gsd::Float, 3);
+         if (entryPtr->N != (uint64_t)n) {
+            UTIL_THROW("Inconsistent number of velocities");
+         }
+         const float* data = (const float*)(&buffer_[0]);
+         storage.allocateVelocities();
+         for (i = 0; i < n; ++i) {
+            Vector& v = storage.velocity(i);
+            for (j = 0; j < Dimension; ++j) {
+               v[j] = data[3*i + j];
+            }
+         }
+      }
+
+      // Types
+      std::vector<std::string> typeNames;
+      readTypeNames(file, "particles/types", typeNames);
+      std::vector<int> typeIds(typeNames.size());
+      for (size_t k = 0; k < typeNames.size(); ++k) {
+         typeIds[k] = atomTypeMap_.id(typeNames[k]);
+      }
+      const uint32_t* data = 0;
+      entryPtr = findChunk("particles/typeid");
+      if (entryPtr) {
+         readChunk(file, *entryPtr, Gsd::UInt32, 1);
+         if (entryPtr->N != (uint64_t)n) {
+            UTIL_THROW("Inconsistent number of atom type ids");
+         }
+         data = (const uint32_t*)(&buffer_[0]);
+      }
+      uint32_t gsdTypeId;
+      for (i = 0; i < n; ++i) {
+         gsdTypeId = data ? data[i] : 0;
+         if (gsdTypeId >= typeIds.size()) {
+            UTIL_THROW("Invalid atom type id");
+         }
+         storage.ptr(i)->typeId = typeIds[gsdTypeId];
+      }
+   }
+
+   /*
+   * Read chunks for a group type.
+   */
+   template <int N>
+   void GsdConfigReader::readGroups(std::ifstream& file,
+                                    const std::string& prefix,
+                                    GroupStorage<N>& storage,
+                                    const TypeMap& map)
+   {
+      int n = readCount(file, prefix + "/N");
+      if (n == 0) return;
+      if (storage.size() > 0) {
+         UTIL_THROW("Group storage not empty");
+      }
+
+      // Map GSD group type ids onto simpatico type ids
+      std::vector<std::string> typeNames;
+      readTypeNames(file, prefix + "/types", typeNames);
+      std::vector<int> typeIds(n, 0);
+      const Gsd::IndexEntry* entryPtr = findChunk(prefix + "/typeid");
+      if (entryPtr) {
+         readChunk(file, *entryPtr, Gsd::UInt32, 1);
+         if (entryPtr->N != (uint64_t)n) {
+            UTIL_THROW("Inconsistent number of group type ids");
+         }
+         const uint32_t* data = (const uint32_t*)(&buffer_[0]);
+         for (int i = 0; i < n; ++i) {
+            typeIds[i] = data[i];
+         }
+      }
+
+      // Atom ids
+      entryPtr = findChunk(prefix + "/group");
+      if (!entryPtr) {
+         UTIL_THROW("Missing GSD group chunk");
+      }
+      readChunk(file, *entryPtr, Gsd::UInt32, N);
+      if (entryPtr->N != (uint64_t)n) {
+         UTIL_THROW("Inconsistent number of groups");
+      }
+      const uint32_t* data = (const uint32_t*)(&buffer_[0]);
+
+      Group<N>* groupPtr;
+      int i, j;
+      for (i = 0; i < n; ++i) {
+         if (typeIds[i] < 0 || typeIds[i] >= (int)typeNames.size()) {
+            UTIL_THROW("Invalid group type id");
+         }
+         groupPtr = storage.newPtr();
+         groupPtr->id = i;
+         groupPtr->typeId = map.id(typeNames[typeIds[i]]);
+         for (j = 0; j < N; ++j) {
+            groupPtr->atomIds[j] = data[N*i + j];
+         }
+      }
+   }
+
+}
@@ -0,0 +1,164 @@
+#ifndef TOOLS_GSD_CONFIG_READER_H
+#define TOOLS_GSD_CONFIG_READER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/config/ConfigReader.h>   // base class
+#include <tools/config/TypeMap.h>        // member
+#include <tools/config/GsdFormat.h>      // member
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Tools
+{
+
+   class Configuration;
+   template <int N> class GroupStorage;
+
+   using namespace Util;
+
+   /**
+   * Reader for HOOMD-blue GSD binary configuration files.
+   *
+   * Reads the last frame of a GSD file that uses the "hoomd" schema.
+   * Chunks that are absent from the last frame are read from frame 0,
+   * or take the default values of the schema, as for HOOMD. Versions
+   * 1.x and 2.x of the GSD file layout are accepted. Each chunk is read
+   * directly from its file location, so that memory use is dominated
+   * by the chunk being read.
+   *
+   * Like HoomdConfigReader, this reader requires an auxiliary type map
+   * file that maps the type names stored in the GSD file onto the integer
+   * type ids used by simpatico. The required syntax for the READ_CONFIG
+   * command in the mdPp command file is thus
+   * \code
+   *    READ_CONFIG auxiliaryFile configFile
+   * \endcode
+   *
+   * \sa \ref tools_config_HoomdTypeMap_page
+   *
+   * \ingroup Tools_ConfigReader_Module
+   */
+   class GsdConfigReader  : public ConfigReader
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration object.
+      */
+      GsdConfigReader(Configuration& configuration);
+
+      /**
+      * Read the last frame of a GSD file.
+      *
+      * \param file input file stream
+      */
+      virtual void readConfig(std::ifstream& file);
+
+      /**
+      * Read auxiliary file with type map information.
+      *
+      * \param file input file stream
+      */
+      virtual void readAuxiliaryFile(std::ifstream& file);
+
+   private:
+
+      /// Valid index entries of the current file.
+      std::vector<Gsd::IndexEntry> entries_;
+
+      /// Chunk names of the current file, indexed by name id.
+      std::vector<std::string> names_;
+
+      /// Buffer for the data of one chunk.
+      std::vector<char> buffer_;
+
+      TypeMap atomTypeMap_;
+      TypeMap bondTypeMap_;
+      TypeMap angleTypeMap_;
+      TypeMap dihedralTypeMap_;
+      TypeMap improperTypeMap_;
+
+      /// Last frame in the file.
+      uint64_t lastFrame_;
+
+      bool hasTypeMaps_;
+
+      /**
+      * Read header, index and name list.
+      *
+      * \param file input file
+      */
+      void readIndex(std::ifstream& file);
+
+      /**
+      * Find a chunk in the last frame, or in frame 0.
+      *
+      * \param name chunk name
+      * \return pointer to index entry, or null if chunk is absent
+      */
+      const Gsd::IndexEntry* findChunk(const std::string& name) const;
+
+      /**
+      * Read the data of a chunk into buffer_, after checking its type.
+      *
+      * \param file  input file
+      * \param entry index entry for chunk
+      * \param type  expected data type
+      * \param M     expected number of columns
+      */
+      void readChunk(std::ifstream& file, const Gsd::IndexEntry& entry,
+                     int type, unsigned int M);
+
+      /**
+      * Read the number of items of a group of chunks (e.g., bonds/N).
+      *
+      * \param file  input file
+      * \param name  name of the chunk
+      * \return value of chunk, or 0 if absent
+      */
+      int readCount(std::ifstream& file, const std::string& name);
+
+      /**
+      * Read a list of type names (e.g., particles/types).
+      *
+      * \param file  input file
+      * \param name  name of the chunk
+      * \param names type names, indexed by GSD type id (output)
+      */
+      void readTypeNames(std::ifstream& file, const std::string& name,
+                         std::vector<std::string>& names);
+
+      /**
+      * Read box, particle positions, velocities and types.
+      *
+      * \param file input file
+      */
+      void readAtoms(std::ifstream& file);
+
+      /**
+      * Read Group<N> (bond, angle, ...) chunks.
+      *
+      * \param file    input file
+      * \param prefix  chunk prefix, e.g., "bonds"
+      * \param storage group storage
+      * \param map     type map for this group type
+      */
+      template <int N>
+      void readGroups(std::ifstream& file, const std::string& prefix,
+                      GroupStorage<N>& storage, const TypeMap& map);
+
+   };
+
+}
+#endif
@@ -0,0 +1,284 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "GsdConfigWriter.h"
+
+#include <tools/chemistry/Atom.h>
+#include <tools/chemistry/Group.h>
+#include <tools/storage/GroupStorage.h>
+#include <tools/storage/Configuration.h>
+
+#include <util/space/Vector.h>
+#include <util/misc/ioUtil.h>
+
+#include <cstring>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   GsdConfigWriter::GsdConfigWriter(Configuration& configuration)
+    : ConfigWriter(configuration, true),
+      entries_(),
+      names_(),
+      hasTypeMaps_(false)
+   {  setClassName("GsdConfigWriter"); }
+
+   /*
+   * Read auxiliary type map file.
+   */
+   void GsdConfigWriter::readAuxiliaryFile(std::ifstream& file)
+   {
+      bool notEnd;
+      std::stringstream line;
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "ATOM");
+         checkString(line, "TYPES:");
+         atomTypeMap_.read(file);
+      }
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "BOND");
+         checkString(line, "TYPES:");
+         bondTypeMap_.read(file);
+      }
+
+      notEnd = getNextLine(file, line);
+      if (notEnd) {
+         checkString(line, "ANGLE");
+         checkString(line, "TYPES:");
+         angleTypeMap_.read(file);
+      }
+
+      hasTypeMaps_ = true;
+   }
+
+   /*
+   * Write one chunk at the current file position.
+   */
+   void GsdConfigWriter::writeChunk(std::ofstream& file,
+                                    const std::string& name,
+                                    int type, uint64_t N, uint32_t M,
+                                    const void* data)
+   {
+      Gsd::IndexEntry entry;
+      entry.frame = 0;
+      entry.N = N;
+      entry.location = file.tellp();
+      entry.M = M;
+      entry.id = names_.size();
+      entry.type = type;
+      entry.flags = 0;
+      entries_.push_back(entry);
+      names_.push_back(name);
+      file.write((const char*)data, N*M*Gsd::typeSize(type));
+   }
+
+   /*
+   * Write a single unsigned integer.
+   */
+   void GsdConfigWriter::writeCount(std::ofstream& file,
+                                    const std::string& name, int value)
+   {
+      uint32_t data = value;
+      writeChunk(file, name, Gsd::UInt32, 1, 1, &data);
+   }
+
+   /*
+   * Write type names, in order of type id, as rows of characters.
+   */
+   void GsdConfigWriter::writeTypeNames(std::ofstream& file,
+                                        const std::string& name,
+                                        const TypeMap& map)
+   {
+      int nType = map.size();
+      if (nType == 0) return;
+      size_t M = 0;
+      int i;
+      for (i = 0; i < nType; ++i) {
+         if (map.name(i).size() + 1 > M) {
+            M = map.name(i).size() + 1;
+         }
+      }
+      std::vector<char> data(nType*M, '\0');
+      for (i = 0; i < nType; ++i) {
+         memcpy(&data[i*M], map.name(i).c_str(), map.name(i).size());
+      }
+      writeChunk(file, name, Gsd::Int8, nType, M, &data[0]);
+   }
+
+   /*
+   * Private function template for writing groups.
+   */
+   template <int N>
+   void GsdConfigWriter::writeGroups(std::ofstream& file,
+                                     const std::string& prefix,
+                                     const GroupStorage<N>& storage,
+                                     const TypeMap& map)
+   {
+      int nGroup = storage.size();
+      if (nGroup == 0) return;
+
+      std::vector<uint32_t> typeIds(nGroup);
+      std::vector<uint32_t> atomIds(N*nGroup);
+      ConstArrayIterator< Group<N> > iter;
+      int i = 0;
+      int j;
+      for (storage.begin(iter); iter.notEnd(); ++iter) {
+         typeIds[i] = iter->typeId;
+         for (j = 0; j < N; ++j) {
+            atomIds[N*i + j] = iter->atomIds[j];
+         }
+         ++i;
+      }
+
+      writeCount(file, prefix + "/N", nGroup);
+      writeTypeNames(file, prefix + "/types", map);
+      writeChunk(file, prefix + "/typeid", Gsd::UInt32, nGroup, 1,
+                 &typeIds[0]);
+      writeChunk(file, prefix + "/group", Gsd::UInt32, nGroup, N,
+                 &atomIds[0]);
+   }
+
+   /*
+   * Write the configuration file.
+   */
+   void GsdConfigWriter::writeConfig(std::ofstream& file)
+   {
+      // Precondition
+      if (!file.is_open()) {
+         UTIL_THROW("Error: File is not open");
+      }
+      if (!hasTypeMaps_) {
+         UTIL_THROW("Error: Must read type map auxiliary file before config");
+      }
+      if (sizeof(Gsd::Header) != 256 || sizeof(Gsd::IndexEntry) != 32) {
+         UTIL_THROW("Unexpected size of GSD header or index entry");
+      }
+      entries_.clear();
+      names_.clear();
+
+      // Reserve space for the header, which is written last
+      Gsd::Header header;
+      memset(&header, 0, sizeof(Gsd::Header));
+      file.write((const char*)&header, sizeof(Gsd::Header));
+
+      // Step, dimensions and box
+      uint64_t step = 0;
+      writeChunk(file, "configuration/step", Gsd::UInt64, 1, 1, &step);
+      uint8_t dimensions = 3;
+      writeChunk(file, "configuration/dimensions", Gsd::UInt8, 1, 1,
+                 &dimensions);
+      Boundary& boundary = configuration().boundary();
+      Vector lengths = boundary.lengths();
+      float box[6];
+      int i, j;
+      for (j = 0; j < Dimension; ++j) {
+         box[j] = lengths[j];
+         box[j + 3] = 0.0;
+      }
+      writeChunk(file, "configuration/box", Gsd::Float, 6, 1, box);
+
+      // Atoms, in order of atom id
+      AtomStorage& storage = configuration().atoms();
+      int nAtom = storage.size();
+      std::vector<uint32_t> typeIds(nAtom);
+      std::vector<float> positions(3*nAtom);
+      bool hasVelocities = storage.hasVelocities();
+      std::vector<float> velocities(hasVelocities ? 3*nAtom : 0);
+      Atom* atomPtr;
+      Vector r, rg;
+      for (i = 0; i < nAtom; ++i) {
+         atomPtr = storage.ptr(i);
+         if (!atomPtr) {
+            UTIL_THROW("Atom ids are not contiguous");
+         }
+         typeIds[i] = atomPtr->typeId;
+
+         // Shift position into [-L/2, L/2)
+         r = atomPtr->position;
+         boundary.shift(r);
+         boundary.transformCartToGen(r, rg);
+         for (j = 0; j < Dimension; ++j) {
+            if (rg[j] >= 0.5) {
+               rg[j] -= 1.0;
+            }
+         }
+         boundary.transformGenToCart(rg, r);
+         for (j = 0; j < Dimension; ++j) {
+            positions[3*i + j] = r[j];
+         }
+         if (hasVelocities) {
+            for (j = 0; j < Dimension; ++j) {
+               velocities[3*i + j] = storage.velocity(i)[j];
+            }
+         }
+      }
+      writeCount(file, "particles/N", nAtom);
+      writeTypeNames(file, "particles/types", atomTypeMap_);
+      if (nAtom > 0) {
+         writeChunk(file, "particles/typeid", Gsd::UInt32, nAtom, 1,
+                    &typeIds[0]);
+         writeChunk(file, "particles/position", Gsd::Float, nAtom, 3,
+                    &positions[0]);
+         if (hasVelocities) {
+            writeChunk(file, "particles/velocity", Gsd::Float, nAtom, 3,
+                       &velocities[0]);
+         }
+      }
+
+      // Covalent groups, as needed
+      #ifdef SIMP_BOND
+      writeGroups(file, "bonds", configuration().bonds(), bondTypeMap_);
+      #endif
+      #ifdef SIMP_ANGLE
+      writeGroups(file, "angles", configuration().angles(), angleTypeMap_);
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      writeGroups(file, "dihedrals", configuration().dihedrals(),
+                  dihedralTypeMap_);
+      writeGroups(file, "impropers", configuration().impropers(),
+                  improperTypeMap_);
+      #endif
+
+      // Index, in order of name id
+      header.indexLocation = file.tellp();
+      header.indexAllocatedEntries = entries_.size();
+      file.write((const char*)&entries_[0],
+                 entries_.size()*sizeof(Gsd::IndexEntry));
+
+      // Name list, with fixed length names
+      header.namelistLocation = file.tellp();
+      header.namelistAllocatedEntries = names_.size();
+      char name[Gsd::NameSize];
+      for (size_t k = 0; k < names_.size(); ++k) {
+         memset(name, 0, Gsd::NameSize);
+         strncpy(name, names_[k].c_str(), Gsd::NameSize - 1);
+         file.write(name, Gsd::NameSize);
+      }
+
+      // Header
+      header.magic = Gsd::Magic;
+      header.schemaVersion = Gsd::makeVersion(1, 3);
+      header.gsdVersion = Gsd::makeVersion(1, 0);
+      strncpy(header.application, "simpatico mdPp", Gsd::NameSize - 1);
+      strncpy(header.schema, "hoomd", Gsd::NameSize - 1);
+      file.seekp(0);
+      file.write((const char*)&header, sizeof(Gsd::Header));
+      if (file.fail()) {
+         UTIL_THROW("Error writing GSD file");
+      }
+   }
+
+}
@@ -0,0 +1,136 @@
+#ifndef TOOLS_GSD_CONFIG_WRITER_H
+#define TOOLS_GSD_CONFIG_WRITER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/config/ConfigWriter.h>       // base class
+#include <tools/config/TypeMap.h>            // member
+#include <tools/config/GsdFormat.h>          // member
+
+#include <string>
+#include <vector>
+
+namespace Tools
+{
+
+   class Configuration;
+   template <int N> class GroupStorage;
+
+   using namespace Util;
+
+   /**
+   * Writer for HOOMD-blue GSD binary configuration files.
+   *
+   * Writes a GSD file with one frame, using version 1.0 of the GSD file
+   * layout and the "hoomd" schema, which can be read by HOOMD-blue and
+   * by the gsd python package. Positions are shifted into the range
+   * [-L/2, L/2) used by HOOMD. Atom ids must run from 0 to nAtom - 1.
+   * Velocities are written only if the AtomStorage has velocities.
+   *
+   * Like HoomdConfigWriter, this writer requires an auxiliary type map
+   * file that maps simpatico type ids onto the type names written to
+   * the GSD file. The required syntax for the WRITE_CONFIG command in
+   * the mdPp command file is thus
+   * \code
+   *    WRITE_CONFIG auxiliaryFile configFile
+   * \endcode
+   *
+   * \sa \ref tools_config_HoomdTypeMap_page
+   *
+   * \ingroup Tools_ConfigWriter_Module
+   */
+   class GsdConfigWriter  : public ConfigWriter
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration object.
+      */
+      GsdConfigWriter(Configuration& configuration);
+
+      /**
+      * Write a GSD configuration file.
+      *
+      * \param file output file stream
+      */
+      virtual void writeConfig(std::ofstream& file);
+
+      /**
+      * Read auxiliary file with type map information.
+      *
+      * \param file input file stream
+      */
+      virtual void readAuxiliaryFile(std::ifstream& file);
+
+   private:
+
+      /// Index entries of chunks written thus far.
+      std::vector<Gsd::IndexEntry> entries_;
+
+      /// Names of chunks written thus far, indexed by name id.
+      std::vector<std::string> names_;
+
+      TypeMap atomTypeMap_;
+      TypeMap bondTypeMap_;
+      TypeMap angleTypeMap_;
+      TypeMap dihedralTypeMap_;
+      TypeMap improperTypeMap_;
+      bool hasTypeMaps_;
+
+      /**
+      * Write one chunk of data of frame 0, and add it to the index.
+      *
+      * \param file  output file
+      * \param name  chunk name
+      * \param type  GSD data type
+      * \param N     number of rows
+      * \param M     number of columns
+      * \param data  pointer to N*M elements of the given type
+      */
+      void writeChunk(std::ofstream& file, const std::string& name,
+                      int type, uint64_t N, uint32_t M, const void* data);
+
+      /**
+      * Write a count chunk (e.g., particles/N).
+      *
+      * \param file  output file
+      * \param name  chunk name
+      * \param value number of items
+      */
+      void writeCount(std::ofstream& file, const std::string& name,
+                      int value);
+
+      /**
+      * Write a list of type names (e.g., particles/types).
+      *
+      * \param file  output file
+      * \param name  chunk name
+      * \param map   type map, with type ids 0, ..., map.size() - 1
+      */
+      void writeTypeNames(std::ofstream& file, const std::string& name,
+                          const TypeMap& map);
+
+      /**
+      * Write chunks for one type of group (bond, angle, ...).
+      *
+      * \param file    output file
+      * \param prefix  chunk prefix, e.g., "bonds"
+      * \param storage group storage
+      * \param map     type map for this group type
+      */
+      template <int N>
+      void writeGroups(std::ofstream& file, const std::string& prefix,
+                       const GroupStorage<N>& storage, const TypeMap& map);
+
+   };
+
+}
+#endif
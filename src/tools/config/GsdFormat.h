@@ -0,0 +1,98 @@
+#ifndef TOOLS_GSD_FORMAT_H
+#define TOOLS_GSD_FORMAT_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <stdint.h>
+
+namespace Tools
+{
+
+   /**
+   * Binary layout of the HOOMD General Simulation Data (GSD) file format.
+   *
+   * A GSD file begins with a GsdHeader, which gives the file locations
+   * of an index and of a list of chunk names. Each GsdIndexEntry of the
+   * index gives the frame, name id, data type, dimensions N x M and file
+   * location of one chunk of data. All integers are little-endian, as
+   * for the native format of the machines for which HOOMD writes GSD
+   * files. Chunk names and types used for configurations are defined by
+   * the "hoomd" schema (e.g., "particles/position", float, N x 3).
+   *
+   * \ingroup Tools_Config_Module
+   */
+   namespace Gsd
+   {
+
+      /// Magic number at the beginning of every GSD file.
+      const uint64_t Magic = 0x65DF65DF65DF65DFULL;
+
+      /// Length of a name in a version 1 name list, and of header strings.
+      const int NameSize = 64;
+
+      /// Data type codes.
+      enum Type { UInt8 = 1, UInt16, UInt32, UInt64,
+                  Int8, Int16, Int32, Int64, Float, Double };
+
+      /**
+      * Return size in bytes of one element of a GSD data type (0 if unknown).
+      */
+      inline int typeSize(int type)
+      {
+         switch (type) {
+            case UInt8:  case Int8:   return 1;
+            case UInt16: case Int16:  return 2;
+            case UInt32: case Int32:  case Float:  return 4;
+            case UInt64: case Int64:  case Double: return 8;
+            default: return 0;
+         }
+      }
+
+      /**
+      * Return a version number with major and minor parts.
+      */
+      inline uint32_t makeVersion(unsigned int major, unsigned int minor)
+      {  return (major << 16) + minor; }
+
+      /**
+      * GSD file header (256 bytes).
+      */
+      struct Header
+      {
+         uint64_t magic;
+         uint64_t indexLocation;
+         uint64_t indexAllocatedEntries;
+         uint64_t namelistLocation;
+         uint64_t namelistAllocatedEntries;
+         uint32_t schemaVersion;
+         uint32_t gsdVersion;
+         char application[NameSize];
+         char schema[NameSize];
+         char reserved[80];
+      };
+
+      /**
+      * GSD index entry (32 bytes), describing one chunk of data.
+      *
+      * Entries with location == 0 are unused.
+      */
+      struct IndexEntry
+      {
+         uint64_t frame;
+         uint64_t N;
+         int64_t  location;
+         uint32_t M;
+         uint16_t id;
+         uint8_t  type;
+         uint8_t  flags;
+      };
+
+   }
+
+}
+#endif
@@ -351,19 +351,20 @@ namespace Tools
       int n = readNumberAttribute(start, nAtom);
 
       Atom* atomPtr;
+      storage.allocateVelocities();
       if (nAtom > 0) {
          for (int i = 0; i < n; ++i) {
             atomPtr = storage.ptr(i);
             if (!atomPtr) {
                UTIL_THROW("Atom not found");   
             }
-            file >> atomPtr->velocity;
+            file >> storage.velocity(i);
          }
       } else {
          for (int i = 0; i < n; ++i) {
             atomPtr = storage.newPtr();
             atomPtr->id = i;
-            file >> atomPtr->velocity;
+            file >> storage.velocity(i);
             storage.add();
          }
       }
@@ -488,7 +489,7 @@ namespace Tools
             file >> typeName;
             typeId = map.id(typeName);
             groupPtr->typeId = typeId;
-            for (j = 0; j < 2; ++j) {
+            for (j = 0; j < N; ++j) {
                file >> groupPtr->atomIds[j];
             }
          }
@@ -153,7 +153,7 @@ namespace Tools
       file << "<velocity num=\"" << nAtom << "\">\n";
       configuration().atoms().begin(iter);
       for (; iter.notEnd(); ++iter) {
-         file << iter->velocity << "\n";
+         file << configuration().atoms().velocity(iter->id) << "\n";
       }
       file << "</velocity>\n";
       #endif
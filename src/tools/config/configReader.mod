@@ -25,7 +25,8 @@ namespace Tools
 * file, defined relative to the directory from which mdPp
 * is invoked. 
 *
-* Some configuration file readers, such as HoomdConfigReader,
+* Some configuration file readers, such as HoomdConfigReader
+* and GsdConfigReader,
 * may require an additional auxiliary data file. In this 
 * case, they synatx of the READ_CONFIG command is
 * \code
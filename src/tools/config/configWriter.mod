@@ -25,7 +25,8 @@ namespace Tools
 * file, defined relative to the directory from which mdPp
 * is invoked. 
 *
-* Some configuration file writers, such as HoomdConfigWriter,
+* Some configuration file writers, such as HoomdConfigWriter
+* and GsdConfigWriter,
 * may require an additional auxiliary data file. The
 * syntax in this case is
 * is
@@ -3,11 +3,14 @@ tools_config_=\
    tools/config/ConfigReaderFactory.cpp \
    tools/config/DdMdConfigReader.cpp \
    tools/config/HoomdConfigReader.cpp \
+   tools/config/GsdConfigReader.cpp \
+   tools/config/BinaryConfigReader.cpp \
    tools/config/TypeMap.cpp \
    tools/config/ConfigWriter.cpp \
    tools/config/ConfigWriterFactory.cpp \
    tools/config/DdMdConfigWriter.cpp \
    tools/config/HoomdConfigWriter.cpp \
+   tools/config/GsdConfigWriter.cpp \
 
 tools_config_SRCS=\
      $(addprefix $(SRC_DIR)/, $(tools_config_))
@@ -39,6 +39,10 @@ namespace Tools
          std::cout << "Unrecognized style " 
                    << outputStyle_ << std::endl;
       }
+
+      // Lines are ended with "\n" rather than std::endl, so that the
+      // stream is flushed once here rather than once per line.
+      out.flush();
    }
    
    void ChainMaker::writeChainsMcMd(std::ostream& out)
@@ -49,28 +53,28 @@ namespace Tools
       int  bondType = 0;
       int  iMol, iAtom;
    
-      out << "BOUNDARY" << std::endl;
-      out << std::endl;
-      out << boundary_ << std::endl;
-      out << std::endl;
-      out << "MOLECULES" << std::endl;
-      out << std::endl;
-      out << "species    " << 0 << std::endl;
-      out << "nMolecule  " << nMolecule_ << std::endl;
-      out << std::endl;
+      out << "BOUNDARY" << "\n";
+      out << "\n";
+      out << boundary_ << "\n";
+      out << "\n";
+      out << "MOLECULES" << "\n";
+      out << "\n";
+      out << "species    " << 0 << "\n";
+      out << "nMolecule  " << nMolecule_ << "\n";
+      out << "\n";
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
-         out << "molecule   " << iMol << std::endl;
+         out << "molecule   " << iMol << "\n";
          // Choosen first atom at random
          boundary_.randomPosition(random_, r);
-         out << r << std::endl;
+         out << r << "\n";
          for (iAtom = 1; iAtom < nAtomPerMolecule_; ++iAtom) {
             random_.unitVector(v);
             v *= bondPotential_.randomBondLength(&random_, beta, bondType);
             r += v;
             boundary_.shift(r);
-            out << r << std::endl;
+            out << r << "\n";
          }
-         out << std::endl;
+         out << "\n";
       }
    
    }
@@ -85,12 +89,12 @@ namespace Tools
       int bondType = 0;
       int iMol, iAtom, i, j;
    
-      out << "BOUNDARY" << std::endl;
-      out << std::endl;
-      out << boundary_ << std::endl;
-      out << std::endl;
-      out << "ATOMS" << std::endl;
-      out << "nAtom  " << nMolecule_*nAtomPerMolecule_ << std::endl;
+      out << "BOUNDARY" << "\n";
+      out << "\n";
+      out << boundary_ << "\n";
+      out << "\n";
+      out << "ATOMS" << "\n";
+      out << "nAtom  " << nMolecule_*nAtomPerMolecule_ << "\n";
    
       i = 0;
       velocity.zero();
@@ -108,7 +112,7 @@ namespace Tools
             for (j = 0; j < Dimension; ++j) {
                out << Dbl(0.0, 12, 4);
             }
-            out << std::endl;
+            out << "\n";
    
             if (iAtom < nAtomPerMolecule_ - 1) {
                random_.unitVector(v);
@@ -122,15 +126,15 @@ namespace Tools
       }
    
       // Write bonds
-      out << std::endl;
-      out << "BONDS" << std::endl;
-      out << "nBond  " << nMolecule_*(nAtomPerMolecule_ -1 ) << std::endl;
+      out << "\n";
+      out << "BONDS" << "\n";
+      out << "nBond  " << nMolecule_*(nAtomPerMolecule_ -1 ) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 1; ++iAtom) {
             out << Int(j,5) <<  Int(bondType, 5) << "  ";
-            out << Int(i, 10) << Int(i + 1, 10) << std::endl;
+            out << Int(i, 10) << Int(i + 1, 10) << "\n";
             ++i;
             ++j;
          }
@@ -139,16 +143,16 @@ namespace Tools
    
       // Write angles
       int angleType = 0;
-      out << std::endl;
-      out << "ANGLES" << std::endl;
-      out << "nAngle  " << nMolecule_*(nAtomPerMolecule_ -2) << std::endl;
+      out << "\n";
+      out << "ANGLES" << "\n";
+      out << "nAngle  " << nMolecule_*(nAtomPerMolecule_ -2) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 2; ++iAtom) {
             out << Int(j,5) <<  Int(angleType, 5) << "  ";
             out << Int(i, 10) << Int(i + 1, 10) << Int(i + 2, 10)
-                << std::endl;
+                << "\n";
             ++i;
             ++j;
          }
@@ -157,16 +161,16 @@ namespace Tools
    
       // Write dihedrals
       int dihedralType = 0;
-      out << std::endl;
-      out << "DIHEDRALS" << std::endl;
-      out << "nDihedral  " << nMolecule_*(nAtomPerMolecule_ -3) << std::endl;
+      out << "\n";
+      out << "DIHEDRALS" << "\n";
+      out << "nDihedral  " << nMolecule_*(nAtomPerMolecule_ -3) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 3; ++iAtom) {
             out << Int(j,5) <<  Int(dihedralType, 5) << "  ";
             out << Int(i, 10) << Int(i + 1, 10) << Int(i + 2, 10)
-                << Int(i + 3, 10) << std::endl;
+                << Int(i + 3, 10) << "\n";
             ++i;
             ++j;
          }
@@ -186,12 +190,12 @@ namespace Tools
       int bondType = 0;
       int iMol, iAtom, i, j;
    
-      out << "BOUNDARY" << std::endl;
-      out << std::endl;
-      out << boundary_ << std::endl;
-      out << std::endl;
-      out << "ATOMS" << std::endl;
-      out << "nAtom  " << nMolecule_*nAtomPerMolecule_ << std::endl;
+      out << "BOUNDARY" << "\n";
+      out << "\n";
+      out << boundary_ << "\n";
+      out << "\n";
+      out << "ATOMS" << "\n";
+      out << "nAtom  " << nMolecule_*nAtomPerMolecule_ << "\n";
    
       i = 0;
       velocity.zero();
@@ -222,19 +226,19 @@ namespace Tools
    
             ++i;
          }
-         out << std::endl;
+         out << "\n";
       }
    
       // Write bonds
-      out << std::endl;
-      out << "BONDS" << std::endl;
-      out << "nBond  " << nMolecule_*(nAtomPerMolecule_ -1 ) << std::endl;
+      out << "\n";
+      out << "BONDS" << "\n";
+      out << "nBond  " << nMolecule_*(nAtomPerMolecule_ -1 ) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 1; ++iAtom) {
             out << Int(j,5) <<  Int(bondType, 5) << "  ";
-            out << Int(i, 10) << Int(i + 1, 10) << std::endl;
+            out << Int(i, 10) << Int(i + 1, 10) << "\n";
             ++i;
             ++j;
          }
@@ -243,16 +247,16 @@ namespace Tools
    
       // Write angles
       int angleType = 0;
-      out << std::endl;
-      out << "ANGLES" << std::endl;
-      out << "nAngle  " << nMolecule_*(nAtomPerMolecule_ -2) << std::endl;
+      out << "\n";
+      out << "ANGLES" << "\n";
+      out << "nAngle  " << nMolecule_*(nAtomPerMolecule_ -2) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 2; ++iAtom) {
             out << Int(j,5) <<  Int(angleType, 5) << "  ";
             out << Int(i, 10) << Int(i + 1, 10) << Int(i + 2, 10)
-                << std::endl;
+                << "\n";
             ++i;
             ++j;
          }
@@ -261,16 +265,16 @@ namespace Tools
    
       // Write dihedrals
       int dihedralType = 0;
-      out << std::endl;
-      out << "DIHEDRALS" << std::endl;
-      out << "nDihedral  " << nMolecule_*(nAtomPerMolecule_ -3) << std::endl;
+      out << "\n";
+      out << "DIHEDRALS" << "\n";
+      out << "nDihedral  " << nMolecule_*(nAtomPerMolecule_ -3) << "\n";
       i = 0;
       j = 0;
       for (iMol = 0; iMol < nMolecule_; ++iMol) {
          for (iAtom = 0; iAtom < nAtomPerMolecule_ - 3; ++iAtom) {
             out << Int(j,5) <<  Int(dihedralType, 5) << "  ";
             out << Int(i, 10) << Int(i + 1, 10) << Int(i + 2, 10)
-                << Int(i + 3, 10) << std::endl;
+                << Int(i + 3, 10) << "\n";
             ++i;
             ++j;
          }
@@ -283,6 +287,7 @@ namespace Tools
 
 int main() 
 {
+   std::ios::sync_with_stdio(false);
    Tools::ChainMaker obj;
    obj.readParam(std::cin);
    obj.writeChains(std::cout);
@@ -10,7 +10,7 @@
 /**
 * \page mdPp_page mdPp - postprocessing analysis program
 *
-* Single-processor analysis program for postprocessing MD trajectories.
+* Analysis program for postprocessing MD trajectories.
 * 
 * Usage:
 *
@@ -32,13 +32,35 @@
 *
 * If option -p is not set, so that no command file name is given,
 * commands are read from standard input (i.e., from the keyboard).
+*
+* A version mdPp_m compiled with MPI enabled (make tools-mpi) may be
+* run with mpirun, in which case every process reads the parameter
+* and command files, and the ANALYZE_TRAJECTORY and
+* ANALYZE_TRAJECTORY_FRAMES commands give each process a contiguous
+* block of frames. Results are combined on process 0, which writes all
+* output files. This requires that every analyzer support frame-parallel
+* analysis (e.g., PairEnergy and CompositionProfile), and that a command
+* file is given by option -c.
 */
 
 int main(int argc, char** argv)
 {
-   Tools::Processor processor;
-   processor.setOptions(argc, argv);
-   processor.readParam();
-   processor.readCommands();
+   #ifdef UTIL_MPI
+   MPI::Init();
+   #endif
+
+   {
+      Tools::Processor processor;
+      #ifdef UTIL_MPI
+      processor.setCommunicator(MPI::COMM_WORLD);
+      #endif
+      processor.setOptions(argc, argv);
+      processor.readParam();
+      processor.readCommands();
+   }
+
+   #ifdef UTIL_MPI
+   MPI::Finalize();
+   #endif
    return 0;
 }
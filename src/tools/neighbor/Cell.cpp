@@ -21,9 +21,7 @@ namespace Tools
    {}
 
    Cell::~Cell()
-   {
-      delete offsetsPtr_;
-   }
+   {}
 
    void Cell::setOffsetArray(Cell::OffsetArray& offsets)
    {  offsetsPtr_ = &offsets; }
@@ -170,6 +170,14 @@ namespace Tools
       */
       void append(Atom* atomPtr);
 
+      /**
+      * Append an Atom to an initialized cell, with a stored position.
+      *
+      * \param atomPtr  pointer to Atom
+      * \param position position stored in the CellAtom (e.g., an image)
+      */
+      void append(Atom* atomPtr, const Vector& position);
+
       // Accessors
 
       /**
@@ -262,6 +270,15 @@ namespace Tools
       ++nAtom_;
    }
 
+   inline void Cell::append(Atom* atomPtr, const Vector& position)
+   {
+      assert(begin_ != 0);
+      assert(nAtom_ < atomCapacity_);
+      begin_[nAtom_].setPtr(atomPtr);
+      begin_[nAtom_].update(position);
+      ++nAtom_;
+   }
+
    /*
    * Get identifier for this Cell.
    */
@@ -34,6 +34,12 @@ namespace Tools
          id_ = ptr_->id;
       }
 
+      void update(const Vector& position) 
+      {
+         position_ = position;
+         id_ = ptr_->id;
+      }
+
       Atom* ptr() const
       {  return ptr_; }
 
@@ -19,7 +19,8 @@ namespace Tools
    * Constructor.
    */
    CellList::CellList()
-    : begin_(0),
+    : setupCutoff_(0.0),
+      begin_(0),
       nAtom_(0),
       nReject_(0),
       #ifdef UTIL_DEBUG
@@ -29,6 +30,7 @@ namespace Tools
    {
       for (int i = 0; i < Dimension; ++i) {
          cellLengths_[i] = 0.0;
+         setupLengths_[i] = 0.0;
       }
    }
 
@@ -150,21 +152,53 @@ namespace Tools
       setGridDimensions(lower, upper, cutoffs);
 
       // Calculate offsets to move to neighboring cells
+      offsets_.resize(grid_.size());
       for (int cellId = 0; cellId < grid_.size(); cellId++) {
-         Cell::OffsetArray *offsets = new Cell::OffsetArray;
+         Cell::OffsetArray& offsets = offsets_[cellId];
+         offsets.clear();
 
          for (int i = 0; i < Dimension; i++) {
             std::pair<int, int> axisOffset;
             axisOffset.first  = calculateAxisOffset(cellId, i,  1);
             axisOffset.second = calculateAxisOffset(cellId, i, -1);
 
-            offsets->append(axisOffset);
+            offsets.append(axisOffset);
          }
 
-         cells_[cellId].setOffsetArray(*offsets);
+         cells_[cellId].setOffsetArray(offsets);
       }
    }
 
+   /*
+   * Make grid for an orthorhombic boundary if it changed, and clear.
+   */
+   void CellList::setup(const Boundary& boundary, double cutoff)
+   {
+      if (!isAllocated()) {
+         UTIL_THROW("CellList is not allocated");
+      }
+      const Vector& lengths = boundary.lengths();
+      bool isNewGrid = (cutoff != setupCutoff_);
+      for (int i = 0; i < Dimension; ++i) {
+         if (lengths[i] != setupLengths_[i]) {
+            isNewGrid = true;
+         }
+      }
+      if (isNewGrid) {
+         for (int i = 0; i < Dimension; ++i) {
+            if (lengths[i] < 3.0*cutoff) {
+               UTIL_THROW("Boundary length < 3*cutoff");
+            }
+         }
+         Vector lower(0.0, 0.0, 0.0);
+         Vector cutoffs(cutoff, cutoff, cutoff);
+         makeGrid(lower, lengths, cutoffs);
+         setupLengths_ = lengths;
+         setupCutoff_ = cutoff;
+      }
+      clear();
+   }
+
    /*
    * Resets all cells to empty state.
    */
@@ -201,7 +235,7 @@ namespace Tools
 
       // Add all atoms to cells.
       for (int i = 0; i < nAtom_; ++i) {
-         cells_[tags_[i].cellRank].append(tags_[i].ptr);
+         cells_[tags_[i].cellRank].append(tags_[i].ptr, tags_[i].position);
       }
 
       #ifdef UTIL_DEBUG
@@ -76,6 +76,30 @@ namespace Tools
    *
    * See Cell documentation for an example of how to iterate over local cells 
    * and neighboring atom pairs. 
+   *
+   * Reuse for successive frames of a trajectory (Cartesian coordinates):
+   * \code
+   *
+   *    // Once, before the first frame
+   *    cellList.allocate(atomCapacity, lower, upper, cutoff);
+   *
+   *    // For each frame
+   *    cellList.setup(boundary, cutoff);
+   *    for (storage.begin(atomIter); atomIter.notEnd(); ++atomIter) {
+   *       cellList.placeAtom(*atomIter, boundary);
+   *    }
+   *    cellList.build();
+   *
+   * \endcode
+   * The setup() function only remakes the grid if the boundary or cutoff
+   * changed since the previous frame. The boundary version of placeAtom()
+   * places each atom in the cell of its image in the primary unit cell, 
+   * without modifying the atom position, and accepts every atom. The
+   * CellAtom positions stored by build() are these periodic images. 
+   * Iteration over the cells by index, as for (i = 0; i < grid().size(); 
+   * ++i) { cell(i).getNeighbors(neighbors); ... }, visits every pair of
+   * atoms in different cells exactly once, and may thus be divided 
+   * among threads.
    * 
    * \ingroup Tools_Neighbor_Module
    */
@@ -163,6 +187,23 @@ namespace Tools
       void 
       makeGrid(const Vector& lower, const Vector& upper, const Vector& cutoffs);
 
+      /**
+      * Make the grid for an orthorhombic boundary, if needed, and clear.
+      *
+      * Prepares the cell list for placeAtom(Atom&, const Boundary&), with 
+      * Cartesian coordinates spanning 0 to boundary.lengths() in each
+      * direction. The grid and the neighbor offsets are only recomputed
+      * if the boundary lengths or cutoff differ from those of the last
+      * call, so that repeated calls for frames with the same boundary
+      * only clear the cells. Throws an Exception if any direction has
+      * fewer than 3 cells, for which the half-shell pair iteration of
+      * Cell::getNeighbors() would count some pairs twice.
+      *
+      * \param boundary  periodic orthorhombic boundary
+      * \param cutoff    pair cutoff distance
+      */
+      void setup(const Boundary& boundary, double cutoff);
+
       /**
       * Determine the appropriate cell for an Atom, based on its position.
       *
@@ -176,6 +217,18 @@ namespace Tools
       */
       void placeAtom(Atom &atom);
 
+      /**
+      * Determine the cell for the periodic image of an Atom.
+      *
+      * Equivalent to placeAtom(Atom&) for the image of the atom that
+      * lies in the primary unit cell of boundary, for use after setup(). 
+      * The atom position is not modified, and no atom is rejected.
+      *
+      * \param atom  Atom object to be added.
+      * \param boundary  periodic boundary passed to setup()
+      */
+      void placeAtom(Atom &atom, const Boundary& boundary);
+
       /**
       * Build the cell list.
       *
@@ -285,6 +338,7 @@ namespace Tools
       * Temporary storage for atom pointers, before copying to cells. 
       */
       struct Tag {
+         Vector position;
          Atom* ptr;
          int cellRank;
       };
@@ -301,6 +355,9 @@ namespace Tools
       /// Array of Cell objects.
       GArray<Cell> cells_;
 
+      /// Neighbor offsets for each cell (owned, pointed to by cells_).
+      GArray<Cell::OffsetArray> offsets_;
+
       /// Lower coordinate bounds (local atoms).
       Vector lower_;
 
@@ -310,6 +367,12 @@ namespace Tools
       /// Length of each cell in grid
       Vector cellLengths_;
 
+      /// Boundary lengths at last call of setup().
+      Vector setupLengths_;
+
+      /// Cutoff at last call of setup().
+      double setupCutoff_;
+
       /// Pointer to first local cell (to initialize iterator).
       Cell* begin_;
 
@@ -416,6 +479,7 @@ namespace Tools
 
       int rank = cellIndexFromPosition(atom.position);
       if (rank >= 0) {
+         tags_[nAtom_].position = atom.position;
          tags_[nAtom_].cellRank = rank;
          tags_[nAtom_].ptr = &atom;
          cells_[rank].incrementCapacity();
@@ -425,6 +489,31 @@ namespace Tools
       }
    }
 
+   /*
+   * Add the primary cell image of an atom to the appropriate cell.
+   */
+   inline void CellList::placeAtom(Atom &atom, const Boundary& boundary)
+   {
+      // Preconditon
+      assert(nAtom_ < tags_.capacity());
+
+      Vector& r = tags_[nAtom_].position;
+      r = atom.position;
+      boundary.shift(r);
+      IntVector p;
+      for (int i = 0; i < Dimension; ++i) {
+         p[i] = int(r[i]/cellLengths_[i]);
+         if (p[i] >= grid_.dimension(i)) {
+            p[i] = grid_.dimension(i) - 1;
+         }
+      }
+      int rank = grid_.rank(p);
+      tags_[nAtom_].cellRank = rank;
+      tags_[nAtom_].ptr = &atom;
+      cells_[rank].incrementCapacity();
+      ++nAtom_;
+   }
+
    /*
    * Return true iff atomId is valid, i.e., if 0 <= 0 < atomCapacity.
    */
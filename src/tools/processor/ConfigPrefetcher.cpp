@@ -0,0 +1,231 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "ConfigPrefetcher.h"
+
+#include <istream>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   ConfigPrefetcher::ConfigPrefetcher(int nSlot)
+    : slots_(),
+      filenames_(),
+      mode_(std::ios::in),
+      nextId_(0),
+      readId_(0)
+      #ifdef TOOLS_ASYNC_IO
+      , isRunning_(false)
+      , isDone_(false)
+      #endif
+   {
+      if (nSlot <= 0) {
+         UTIL_THROW("Nonpositive nSlot");
+      }
+      slots_.allocate(nSlot);
+      for (int i = 0; i < nSlot; ++i) {
+         slots_[i].state = Empty;
+      }
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_init(&mutex_, 0);
+      pthread_cond_init(&cond_, 0);
+      #endif
+   }
+
+   /*
+   * Destructor.
+   */
+   ConfigPrefetcher::~ConfigPrefetcher()
+   {
+      stop();
+      #ifdef TOOLS_ASYNC_IO
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
+      #endif
+   }
+
+   /*
+   * Start reading a list of files.
+   */
+   void ConfigPrefetcher::start(const std::vector<std::string>& filenames,
+                                std::ios::openmode mode)
+   {
+      stop();
+      filenames_ = filenames;
+      mode_ = mode;
+      nextId_ = 0;
+      readId_ = 0;
+      #ifdef TOOLS_ASYNC_IO
+      isDone_ = false;
+      if (pthread_create(&thread_, 0, &ConfigPrefetcher::runThread, this)) {
+         UTIL_THROW("Failed to create reader thread");
+      }
+      isRunning_ = true;
+      #endif
+   }
+
+   /*
+   * Stop the reader thread and close all files.
+   */
+   void ConfigPrefetcher::stop()
+   {
+      #ifdef TOOLS_ASYNC_IO
+      if (isRunning_) {
+         pthread_mutex_lock(&mutex_);
+         isDone_ = true;
+         pthread_cond_broadcast(&cond_);
+         pthread_mutex_unlock(&mutex_);
+         pthread_join(thread_, 0);
+         isRunning_ = false;
+      }
+      #endif
+      for (int i = 0; i < slots_.capacity(); ++i) {
+         release(slots_[i]);
+      }
+      filenames_.clear();
+      nextId_ = 0;
+      readId_ = 0;
+   }
+
+   /*
+   * Open and read one file into its slot (called by reader thread, if any).
+   */
+   void ConfigPrefetcher::load(int fileId)
+   {
+      Slot& slot = slots_[fileId % slots_.capacity()];
+      State state = Failed;
+      slot.file.open(filenames_[fileId].c_str(), mode_);
+      if (slot.file.is_open()) {
+         std::string contents;
+         slot.file.seekg(0, std::ios::end);
+         std::streamoff size = slot.file.tellg();
+         slot.file.seekg(0, std::ios::beg);
+         if (size > 0) {
+            contents.resize(size);
+            slot.file.read(&contents[0], size);
+         }
+         if (!slot.file.fail()) {
+            slot.buffer.str(contents);
+            state = Ready;
+         }
+      }
+
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      slot.state = state;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #else
+      slot.state = state;
+      #endif
+   }
+
+   /*
+   * Close the file of a slot, and mark it empty.
+   */
+   void ConfigPrefetcher::release(Slot& slot)
+   {
+      std::istream& stream = slot.file;
+      stream.rdbuf(slot.file.rdbuf());
+      if (slot.file.is_open()) {
+         slot.file.close();
+      }
+      slot.file.clear();
+      slot.buffer.str("");
+
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      slot.state = Empty;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #else
+      slot.state = Empty;
+      #endif
+   }
+
+   #ifdef TOOLS_ASYNC_IO
+   /*
+   * Reader thread main loop.
+   */
+   void ConfigPrefetcher::run()
+   {
+      int nFile = filenames_.size();
+      int nSlot = slots_.capacity();
+      pthread_mutex_lock(&mutex_);
+      while (readId_ < nFile) {
+         while (slots_[readId_ % nSlot].state != Empty && !isDone_) {
+            pthread_cond_wait(&cond_, &mutex_);
+         }
+         if (isDone_) break;
+
+         // The main thread does not touch an empty slot, so the file
+         // is read without the lock.
+         int fileId = readId_;
+         pthread_mutex_unlock(&mutex_);
+         load(fileId);
+         pthread_mutex_lock(&mutex_);
+         ++readId_;
+      }
+      pthread_mutex_unlock(&mutex_);
+   }
+
+   /*
+   * Static entry point for the reader thread.
+   */
+   void* ConfigPrefetcher::runThread(void* ptr)
+   {
+      static_cast<ConfigPrefetcher*>(ptr)->run();
+      return 0;
+   }
+   #endif
+
+   /*
+   * Release previous file, and return the next one.
+   */
+   std::ifstream& ConfigPrefetcher::next()
+   {
+      int nSlot = slots_.capacity();
+      if (nextId_ >= (int)filenames_.size()) {
+         UTIL_THROW("No more files");
+      }
+      if (nextId_ > 0) {
+         release(slots_[(nextId_ - 1) % nSlot]);
+      }
+      Slot& slot = slots_[nextId_ % nSlot];
+
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      while (slot.state == Empty) {
+         pthread_cond_wait(&cond_, &mutex_);
+      }
+      State state = slot.state;
+      pthread_mutex_unlock(&mutex_);
+      #else
+      load(nextId_);
+      State state = slot.state;
+      #endif
+
+      if (state == Failed) {
+         std::string msg = "Configuration file is not open. Filename =";
+         msg += filenames_[nextId_];
+         UTIL_THROW(msg.c_str());
+      }
+      ++nextId_;
+
+      // Redirect input from the open file to its contents in memory
+      std::istream& stream = slot.file;
+      stream.rdbuf(&slot.buffer);
+      stream.clear();
+      return slot.file;
+   }
+
+}
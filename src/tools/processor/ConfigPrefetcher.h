@@ -0,0 +1,150 @@
+#ifndef TOOLS_CONFIG_PREFETCHER_H
+#define TOOLS_CONFIG_PREFETCHER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+#include <util/containers/DArray.h>     // member
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef TOOLS_ASYNC_IO
+#include <pthread.h>
+#endif
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Reads a sequence of configuration files ahead in the background.
+   *
+   * A ConfigPrefetcher is given a list of file names, and returns the
+   * files one at a time, in order, through next(). Each file returned by
+   * next() is an open std::ifstream whose contents have already been read
+   * into memory, so that a ConfigReader parses it without waiting on the
+   * disk. While the caller parses and analyzes one file, a reader thread
+   * reads up to nSlot - 1 following files.
+   *
+   * The reader thread is only used if the program is compiled with the
+   * TOOLS_ASYNC_IO preprocessor macro defined, which requires pthreads.
+   * Otherwise, each file is read when it is requested by next().
+   *
+   * \ingroup Tools_Storage_Module
+   */
+   class ConfigPrefetcher
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param nSlot maximum number of files held in memory (>= 1)
+      */
+      ConfigPrefetcher(int nSlot = 4);
+
+      /**
+      * Destructor.
+      *
+      * Stops the reader thread and closes all files.
+      */
+      ~ConfigPrefetcher();
+
+      /**
+      * Start reading a list of files.
+      *
+      * \param filenames names of files, in the order they will be used
+      * \param mode      open mode (e.g., std::ios::in|std::ios::binary)
+      */
+      void start(const std::vector<std::string>& filenames,
+                 std::ios::openmode mode = std::ios::in);
+
+      /**
+      * Return the next file, after releasing the previous one.
+      *
+      * Blocks until the file has been read. Throws an Exception if the
+      * file could not be opened. The returned stream remains valid until
+      * the next call to next() or stop().
+      */
+      std::ifstream& next();
+
+      /**
+      * Stop reading, and close all files.
+      */
+      void stop();
+
+   private:
+
+      /// Possible states of a slot.
+      enum State { Empty, Ready, Failed };
+
+      /// Storage for one file that has been read ahead.
+      struct Slot
+      {
+         std::ifstream file;
+         std::stringbuf buffer;
+         State state;
+      };
+
+      /// Ring buffer of slots, used in the order of filenames_.
+      DArray<Slot> slots_;
+
+      /// Names of files.
+      std::vector<std::string> filenames_;
+
+      /// Open mode for files.
+      std::ios::openmode mode_;
+
+      /// Index of the next file to be returned by next().
+      int nextId_;
+
+      /// Index of the next file to be read by the reader.
+      int readId_;
+
+      #ifdef TOOLS_ASYNC_IO
+      /// Reader thread.
+      pthread_t thread_;
+
+      /// Mutex protecting state of slots, readId_ and isDone_.
+      pthread_mutex_t mutex_;
+
+      /// Condition variable signalled when any slot changes state.
+      pthread_cond_t cond_;
+
+      /// Has the reader thread been started?
+      bool isRunning_;
+
+      /// Should the reader thread exit?
+      bool isDone_;
+
+      /// Reader thread main loop.
+      void run();
+
+      /// Entry point for pthread_create.
+      static void* runThread(void* ptr);
+      #endif
+
+      /// Open and read file fileId into its slot.
+      void load(int fileId);
+
+      /// Close the file of a slot, and mark it empty.
+      void release(Slot& slot);
+
+      // Copy constructor and assignment (not implemented).
+      ConfigPrefetcher(const ConfigPrefetcher& other);
+      ConfigPrefetcher& operator = (const ConfigPrefetcher& other);
+
+   };
+
+}
+#endif
@@ -9,7 +9,13 @@
 #include <tools/config/DdMdConfigReader.h>
 #include <tools/config/DdMdConfigWriter.h>
 #include <tools/trajectory/LammpsDumpReader.h>
+#include <tools/trajectory/AsyncReadBuf.h>
+#include <tools/trajectory/FrameIndex.h>
+#include <tools/processor/ConfigPrefetcher.h>
+#include <tools/storage/AtomRenumberer.h>
 #include <util/format/Str.h>
+#include <util/misc/ioUtil.h>
+#include <util/archives/Serializable_includes.h>
 
 // std headers
 #include <fstream>
@@ -28,7 +34,18 @@ namespace Tools
       configReaderFactory_(*this),
       configWriterFactory_(*this),
       trajectoryReaderFactory_(*this),
-      analyzerManager_(*this)
+      analyzerManager_(*this),
+      fileMaster_(),
+      threadPool_(),
+      trajectoryFile_(),
+      trajectoryBuf_(),
+      configReaderName_(),
+      checkpointFileName_(),
+      checkpointInterval_(0)
+      #ifdef UTIL_MPI
+      , communicatorPtr_(0),
+      logFile_()
+      #endif
    {  setClassName("Processor"); }
 
    /*
@@ -49,10 +66,10 @@ namespace Tools
    */
    void Processor::setOptions(int argc, char * const * argv)
    {
-
+      bool bFlag = false;
       int c;
       opterr = 0;
-      while ((c = getopt(argc, argv, "ep:c:")) != -1) {
+      while ((c = getopt(argc, argv, "ep:c:t:b")) != -1) {
          switch (c) {
          case 'e':
            ParamComponent::setEcho(true);
@@ -63,12 +80,36 @@ namespace Tools
          case 'c':
            fileMaster_.setCommandFileName(std::string(optarg));
            break;
+         case 't':
+           threadPool_.setNThread(atoi(optarg));
+           break;
+         case 'b':
+           bFlag = true;
+           break;
          case '?':
            Log::file() << "Unknown option -" << optopt << std::endl;
          }
       }
+      threadPool_.setPinned(bFlag);
+      threadPool_.initialize();
+
+   }
 
+   #ifdef UTIL_MPI
+   /*
+   * Set communicator for frame-parallel analysis.
+   */
+   void Processor::setCommunicator(MPI::Intracomm& communicator)
+   {
+      communicatorPtr_ = &communicator;
+      int rank = communicator.Get_rank();
+      if (rank > 0) {
+         std::string filename = "log." + toString(rank);
+         logFile_.open(filename.c_str());
+         Log::setFile(logFile_);
+      }
    }
+   #endif
 
    /*
    * Read default param file.
@@ -108,6 +149,11 @@ namespace Tools
    void Processor::readCommands()
    {
       if (fileMaster_.commandFileName().empty()) {
+         #ifdef UTIL_MPI
+         if (communicatorPtr_ && communicatorPtr_->Get_size() > 1) {
+            UTIL_THROW("A command file is required with > 1 processor");
+         }
+         #endif
          // Read from standard input if no command file name is set
          readCommands(std::cin);
       } else {
@@ -180,9 +226,16 @@ namespace Tools
             Log::file() << "\nWriting config file: ";
             in >> filename;
             Log::file() << filename << std::endl;
-            fileMaster_.openOutputFile(filename, outputFile);
-            configWriter().writeConfig(outputFile);
-            outputFile.close();
+            if (isIoProcessor()) {
+               fileMaster_.openOutputFile(filename, outputFile);
+               configWriter().writeConfig(outputFile);
+               outputFile.close();
+            }
+         } else
+         if (command == "RENUMBER_ATOMS") {
+            Log::file() << std::endl;
+            AtomRenumberer renumberer(*this);
+            renumberer.renumber();
          } else
          if (command == "SET_TRAJECTORY_READER") {
             std::string classname;
@@ -195,6 +248,24 @@ namespace Tools
             Log::file() << " " << filename << std::endl;
             analyzeTrajectory(filename);
          } else 
+         if (command == "ANALYZE_TRAJECTORY_FRAMES") {
+            int min, max, interval;
+            in >> min >> max >> interval >> filename;
+            Log::file() << " " << min << " " << max << " " << interval
+                        << " " << filename << std::endl;
+            analyzeTrajectory(filename, min, max, interval);
+         } else 
+         if (command == "CHECKPOINT") {
+            int interval;
+            in >> interval >> filename;
+            Log::file() << " " << interval << " " << filename << std::endl;
+            setCheckpoint(interval, filename);
+         } else
+         if (command == "RESTART_TRAJECTORY") {
+            in >> filename;
+            Log::file() << " " << filename << std::endl;
+            restartTrajectory(filename);
+         } else
          {
             Log::file() << "  Error: Unknown command  " << std::endl;
             readNext = false;
@@ -267,29 +338,31 @@ namespace Tools
       //Timer timer;
       std::string filename;
       std::stringstream indexString;
-      std::ifstream configFile;
-
-      // Main loop
-      Log::file() << "begin main loop" << std::endl;
-      //timer.start();
-      for (int iStep = min; iStep <= max; iStep += interval) {
-
+      std::vector<std::string> filenames;
+      int iStep;
+      for (iStep = min; iStep <= max; iStep += interval) {
          indexString << iStep;
          filename = baseFileName;
          filename += indexString.str();
-         configFile.open(filename.c_str());
-         if (!configFile.is_open()) {
-            std::string msg = "Configuration file is not open. Filename =";
-            msg += filename;
-            UTIL_THROW(msg.c_str());
-         }
+         filenames.push_back(filename);
 
          // Clear the stringstream
          indexString.str("");
+      }
+
+      // Files are read ahead by prefetcher, in a background thread if
+      // TOOLS_ASYNC_IO is defined, while the current file is analyzed.
+      ConfigPrefetcher prefetcher;
+      prefetcher.start(filenames);
 
+      // Main loop
+      Log::file() << "begin main loop" << std::endl;
+      //timer.start();
+      for (iStep = min; iStep <= max; iStep += interval) {
+
+         std::ifstream& configFile = prefetcher.next();
          clear();
          readConfig(configFile);
-         configFile.close();
 
          #if 0
          #ifndef SIMP_NOPAIR
@@ -313,6 +386,7 @@ namespace Tools
       }
       //timer.stop();
       Log::file() << "end main loop" << std::endl;
+      prefetcher.stop();
 
       // Output results of all analyzers to output files
       analyzerManager_.output();
@@ -398,42 +472,318 @@ namespace Tools
    */
    void Processor::analyzeTrajectory(const std::string& filename)
    {
+      // Dividing frames among processors or restarting from a
+      // checkpoint requires a frame index
+      if (nProcessor() > 1 || checkpointInterval_ > 0) {
+         analyzeTrajectory(filename, 0, -1, 1);
+         return;
+      }
 
-      // Open file
-      std::ifstream file;
+      openTrajectory(filename);
+
+      // Initialize analyzers (taking in molecular information).
+      analyzerManager_.setup();
+
+      // Main loop
+      Log::file() << "begin main loop" << std::endl;
+      int iStep = 0;
+      while (readFrame()) {
+         analyzerManager_.sample(iStep);
+         ++iStep;
+      }
+      Log::file() << "end main loop" << std::endl;
+
+      // Output any final results of analyzers to output files
+      analyzerManager_.output();
+
+      closeTrajectory();
+   }
+
+   /*
+   * Open a trajectory file, and read its header.
+   */
+   void Processor::openTrajectory(const std::string& filename)
+   {
+      // Input is read ahead in blocks by trajectoryBuf_, in a background
+      // thread if TOOLS_ASYNC_IO is defined, so that disk reads overlap
+      // parsing and analysis of the current frame.
       if (trajectoryReader().isBinary()) {
-         fileMaster_.openInputFile(filename, file,
-                                    std::ios::in | std::ios::binary);
+         trajectoryBuf_.open(fileMaster_, filename,
+                             std::ios::in | std::ios::binary);
       } else {
-         fileMaster_.openInputFile(filename, file);
+         trajectoryBuf_.open(fileMaster_, filename);
       }
-      if (!file.is_open()) {
+      trajectoryBuf_.attach(trajectoryFile_);
+      if (!trajectoryBuf_.isOpen()) {
          std::string msg = "Trajectory file is not open. Filename =";
          msg += filename;
          UTIL_THROW(msg.c_str());
       }
+      trajectoryReader().setFileName(filename);
+      trajectoryReader().readHeader(trajectoryFile_);
+   }
 
-      // Initialize analyzers (taking in molecular information).
-      analyzerManager_.setup();
+   /*
+   * Read the next frame of the open trajectory file.
+   */
+   bool Processor::readFrame()
+   {
+      if (!trajectoryBuf_.isOpen()) {
+         UTIL_THROW("No trajectory file is open");
+      }
+      bool notEnd = trajectoryReader().readFrame(trajectoryFile_);
+      if (!notEnd && trajectoryBuf_.hasError()) {
+         UTIL_THROW("Error reading trajectory file");
+      }
+      return notEnd;
+   }
 
-      // Main loop
+   /*
+   * Close the trajectory file.
+   */
+   void Processor::closeTrajectory()
+   {  trajectoryBuf_.close(); }
+
+   /*
+   * Open, read and analyze a range of frames of a trajectory file.
+   */
+   void Processor::analyzeTrajectory(const std::string& filename,
+                                     int min, int max, int interval)
+   {  analyzeFrames(filename, min, max, interval, 0); }
+
+   /*
+   * Enable or disable checkpoint files.
+   */
+   void Processor::setCheckpoint(int interval, const std::string& filename)
+   {
+      if (interval < 0) UTIL_THROW("interval < 0");
+      checkpointInterval_ = interval;
+      checkpointFileName_ = filename;
+   }
+
+   /*
+   * Resume analysis of a range of frames from a checkpoint file.
+   */
+   void Processor::restartTrajectory(const std::string& filename)
+   {
+      Serializable::IArchive ar;
+      std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary;
+      fileMaster_.openRestartIFile(checkpointFileName(filename),
+                                   ar.file(), mode);
+      std::string trajectoryName;
+      int min, max, interval;
+      ar >> trajectoryName;
+      ar >> min;
+      ar >> max;
+      ar >> interval;
+      Log::file() << "Resuming analysis of " << trajectoryName << std::endl;
+      analyzeFrames(trajectoryName, min, max, interval, &ar);
+      ar.file().close();
+   }
+
+   /*
+   * Open, read and analyze a range of frames (private).
+   */
+   void Processor::analyzeFrames(const std::string& filename,
+                                 int min, int max, int interval,
+                                 Serializable::IArchive* restartPtr)
+   {
+      // Preconditions
+      if (min < 0)  UTIL_THROW("min < 0");
+      if (max >= 0 && max < min)  UTIL_THROW("max < min");
+      if (interval <= 0)  UTIL_THROW("interval <= 0");
+
+      std::ios::openmode mode = std::ios::in;
+      if (trajectoryReader().isBinary()) {
+         mode |= std::ios::binary;
+      }
+      std::ifstream file;
+      AsyncReadBuf asyncBuf;
+      asyncBuf.open(fileMaster_, filename, mode);
+      asyncBuf.attach(file);
+      if (!asyncBuf.isOpen()) {
+         std::string msg = "Trajectory file is not open. Filename =";
+         msg += filename;
+         UTIL_THROW(msg.c_str());
+      }
+
+      analyzerManager_.setup();
+      trajectoryReader().setFileName(filename);
       trajectoryReader().readHeader(file);
+
+      // Get frame index from the reader, or from the index file
+      FrameIndex index;
+      int nFrame = trajectoryReader().nFrame();
+      if (nFrame < 0) {
+         std::ifstream sizeFile;
+         fileMaster_.openInputFile(filename, sizeFile, mode);
+         sizeFile.seekg(0, std::ios::end);
+         long fileSize = sizeFile.tellg();
+         sizeFile.close();
+
+         #ifdef UTIL_MPI
+         // Other processors wait for processor 0 to write a missing index
+         if (communicatorPtr_ && !isIoProcessor()) {
+            communicatorPtr_->Barrier();
+         }
+         #endif
+         const std::string& className = trajectoryReader().className();
+         std::string indexName = filename + ".idx";
+         std::ifstream indexIn(indexName.c_str());
+         bool hasIndex = false;
+         if (indexIn.is_open()) {
+            hasIndex = index.read(indexIn, className, fileSize);
+            indexIn.close();
+         }
+         if (!hasIndex) {
+            Log::file() << "building frame index " << indexName << std::endl;
+            index.build(trajectoryReader(), file);
+            file.clear();
+            if (isIoProcessor()) {
+               std::ofstream indexOut(indexName.c_str());
+               if (indexOut.is_open()) {
+                  index.write(indexOut, className, fileSize);
+                  indexOut.close();
+               }
+            }
+         }
+         #ifdef UTIL_MPI
+         if (communicatorPtr_ && isIoProcessor()) {
+            communicatorPtr_->Barrier();
+         }
+         #endif
+         nFrame = index.nFrame();
+      }
+      if (max < 0 || max >= nFrame) {
+         max = nFrame - 1;
+      }
+      if (min > max) {
+         UTIL_THROW("No frames in requested range");
+      }
+
+      // Select a contiguous block of frames for this processor
+      int nSelect = (max - min)/interval + 1;
+      int begin = 0;
+      int end = nSelect;
+      #ifdef UTIL_MPI
+      if (nProcessor() > 1) {
+         if (!analyzerManager_.isFrameParallel()) {
+            UTIL_THROW("Analyzer is not frame parallel");
+         }
+         int rank = communicatorPtr_->Get_rank();
+         int nProc = communicatorPtr_->Get_size();
+         begin = (nSelect*rank)/nProc;
+         end = (nSelect*(rank + 1))/nProc;
+      }
+      #endif
+
+      // Restore analyzer state, and skip frames analyzed before checkpoint
+      if (restartPtr) {
+         int nProc, next;
+         *restartPtr >> nProc;
+         *restartPtr >> next;
+         if (nProc != nProcessor()) {
+            UTIL_THROW("Inconsistent number of processors in checkpoint");
+         }
+         if (next < begin || next > end) {
+            UTIL_THROW("Invalid next frame in checkpoint");
+         }
+         begin = next;
+         analyzerManager_.loadState(*restartPtr);
+      }
+
+      // Main loop, seeking only when frames are not consecutive
       Log::file() << "begin main loop" << std::endl;
-      int iStep = 0;
-      bool notEnd = true;
-      while (notEnd) {
-         notEnd = trajectoryReader().readFrame(file);
-         if (notEnd) {
-            analyzerManager_.sample(iStep);
-            ++iStep;
+      int next = -1;
+      int iFrame;
+      for (int k = begin; k < end; ++k) {
+         iFrame = min + k*interval;
+         if (iFrame != next) {
+            file.clear();
+            if (index.nFrame() > 0) {
+               file.seekg(index.offset(iFrame));
+               if (file.fail()) {
+                  UTIL_THROW("Error seeking trajectory frame");
+               }
+            } else {
+               trajectoryReader().seekFrame(file, iFrame);
+            }
+         }
+         if (!trajectoryReader().readFrame(file)) {
+            UTIL_THROW("Error reading trajectory frame");
+         }
+         analyzerManager_.sample(iFrame);
+         next = iFrame + 1;
+         if (checkpointInterval_ > 0 && k + 1 < end) {
+            if ((k + 1) % checkpointInterval_ == 0) {
+               saveCheckpoint(filename, min, max, interval, k + 1);
+            }
          }
       }
       Log::file() << "end main loop" << std::endl;
+      if (asyncBuf.hasError()) {
+         UTIL_THROW("Error reading trajectory file");
+      }
 
-      // Output any final results of analyzers to output files
-      analyzerManager_.output();
+      #ifdef UTIL_MPI
+      if (communicatorPtr_) {
+         analyzerManager_.reduce(*communicatorPtr_);
+      }
+      #endif
+      if (isIoProcessor()) {
+         analyzerManager_.output();
+      }
 
-      file.close();
+      asyncBuf.close();
+   }
+
+   /*
+   * Write a checkpoint file (private).
+   */
+   void Processor::saveCheckpoint(const std::string& filename,
+                                  int min, int max, int interval, int next)
+   {
+      Serializable::OArchive ar;
+      std::ios_base::openmode mode = std::ios_base::out | std::ios_base::binary;
+      fileMaster_.openRestartOFile(checkpointFileName(checkpointFileName_),
+                                   ar.file(), mode);
+      std::string trajectoryName = filename;
+      int nProc = nProcessor();
+      ar << trajectoryName;
+      ar << min;
+      ar << max;
+      ar << interval;
+      ar << nProc;
+      ar << next;
+      analyzerManager_.saveState(ar);
+      ar.file().close();
+   }
+
+   /*
+   * Return name of the checkpoint file of this processor (private).
+   */
+   std::string
+   Processor::checkpointFileName(const std::string& filename) const
+   {
+      if (nProcessor() > 1) {
+         #ifdef UTIL_MPI
+         return filename + "." + toString(communicatorPtr_->Get_rank());
+         #endif
+      }
+      return filename;
+   }
+
+   /*
+   * Return number of processors (private).
+   */
+   int Processor::nProcessor() const
+   {
+      #ifdef UTIL_MPI
+      if (communicatorPtr_) {
+         return communicatorPtr_->Get_size();
+      }
+      #endif
+      return 1;
    }
 
    /*
@@ -442,4 +792,23 @@ namespace Tools
    FileMaster& Processor::fileMaster()
    {  return fileMaster_; }
 
+   /*
+   * Return ThreadPool.
+   */
+   Simp::ThreadPool& Processor::threadPool()
+   {  return threadPool_; }
+
+   /*
+   * Is this the processor that writes output files?
+   */
+   bool Processor::isIoProcessor() const
+   {
+      #ifdef UTIL_MPI
+      if (communicatorPtr_) {
+         return (communicatorPtr_->Get_rank() == 0);
+      }
+      #endif
+      return true;
+   }
+
 }
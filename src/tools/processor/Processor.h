@@ -13,8 +13,12 @@
 #include <tools/config/ConfigWriterFactory.h>           // member 
 #include <tools/trajectory/TrajectoryReaderFactory.h>   // member 
 #include <tools/processor/ProcessorAnalyzerManager.h>   // member 
+#include <tools/trajectory/AsyncReadBuf.h>              // member 
+#include <simp/threads/ThreadPool.h>                    // member
 #include <util/misc/FileMaster.h>                       // member 
 
+#include <fstream>
+
 namespace Tools 
 {
 
@@ -47,12 +51,43 @@ namespace Tools
       
       /**
       * Process command line options.
+      *
+      * Options:
+      *
+      *   -e  Enable echoing of the parameter file.
+      *
+      *   -p  filename. Set the parameter file name.
+      *
+      *   -c  filename. Set the command file name.
+      *
+      *   -t  nThread. Set the number of threads (if compiled with
+      *       TOOLS_OPENMP). By default, the OpenMP default is used.
+      *
+      *   -b  Bind (pin) each thread to one core.
       *  
       * \param argc number of arguments
       * \param argv array of argument C-strings
       */
       void setOptions(int argc, char * const * argv);
 
+      #ifdef UTIL_MPI
+      /**
+      * Enable frame-parallel analysis on the processors of a communicator.
+      *
+      * Every processor reads the parameter and command files, and
+      * executes every command. The ANALYZE_TRAJECTORY and
+      * ANALYZE_TRAJECTORY_FRAMES commands divide the selected frames
+      * among processors in contiguous blocks, and results are combined
+      * by Analyzer::reduce() before processor 0 calls output(). This
+      * requires that every analyzer be frame parallel. Only processor 0
+      * writes output and configuration files. Processors other than 0
+      * write log output to a file "log.n", where n is the rank.
+      *
+      * \param communicator communicator for all processors
+      */
+      void setCommunicator(MPI::Intracomm& communicator);
+      #endif
+
       using ParamComposite::readParam;
 
       /**
@@ -119,7 +154,8 @@ namespace Tools
       * that were generated by running a previous simulation. The function 
       * reads files with names of the form inputPrefix() + n for integer 
       * suffixes min <= n <= max with subsequent values differing by the
-      * specified interval.
+      * specified interval. Up to three files following the current one
+      * are read into memory ahead of time by a ConfigPrefetcher.
       *
       * \param baseFileName  root name for dump files (without int suffix)
       * \param min  integer suffix of first configuration file name
@@ -178,6 +214,79 @@ namespace Tools
       */
       void analyzeTrajectory(const std::string& filename);
 
+      /**
+      * Open a trajectory file and read its header.
+      *
+      * Frames may then be read one at a time by readFrame(), which 
+      * allows a trajectory to be processed by code that drives the 
+      * Processor frame by frame (e.g., from a scripting language),
+      * rather than by the analyzers of the AnalyzerManager.
+      *
+      * \param filename name of trajectory file.
+      */
+      void openTrajectory(const std::string& filename);
+
+      /**
+      * Read the next frame of the trajectory opened by openTrajectory().
+      *
+      * Atom positions are updated in place, so the addresses of atoms
+      * and groups do not change from frame to frame.
+      *
+      * \return true if a frame was read, false at the end of the file
+      */
+      bool readFrame();
+
+      /**
+      * Close the trajectory file opened by openTrajectory().
+      */
+      void closeTrajectory();
+
+      /**
+      * Analyze frames min, min + interval, ... <= max of a trajectory.
+      *
+      * In an MPI run with more than one processor, the selected frames
+      * are divided among processors (see setCommunicator()).
+      *
+      * Frames are accessed directly, using the frame index of formats
+      * that have one, or otherwise a FrameIndex that is stored in a file
+      * named filename + ".idx" and rebuilt whenever it does not match the
+      * trajectory. A negative value of max denotes the last frame.
+      *
+      * \param filename name of trajectory file.
+      * \param min      index of first frame
+      * \param max      index of last frame (or -1 for last frame)
+      * \param interval stride between analyzed frames
+      */
+      void analyzeTrajectory(const std::string& filename,
+                             int min, int max, int interval);
+
+      /**
+      * Enable or disable checkpoint files for trajectory analysis.
+      *
+      * If interval > 0, analyzeTrajectory() saves the state of all
+      * analyzers and the index of the next frame to file filename after
+      * every interval analyzed frames, so that an interrupted job may be
+      * resumed by restartTrajectory(). Each processor of an MPI run with
+      * more than one processor writes a file with suffix "." + rank.
+      * An interval of 0 disables checkpoints.
+      *
+      * \param interval number of analyzed frames between checkpoints
+      * \param filename name of checkpoint file
+      */
+      void setCheckpoint(int interval, const std::string& filename);
+
+      /**
+      * Resume a trajectory analysis from a checkpoint file.
+      *
+      * The parameter file, trajectory reader style and number of
+      * processors must be the same as in the job that wrote the file.
+      * Checkpoints are written as by analyzeTrajectory() if enabled by
+      * setCheckpoint().
+      *
+      * \param filename name of checkpoint file (without rank suffix)
+      */
+      void restartTrajectory(const std::string& filename);
+
       //@}
       /// \name Miscellaneous functions
       //@{
@@ -187,6 +296,18 @@ namespace Tools
       */
       FileMaster& fileMaster();
 
+      /**
+      * Return the ThreadPool shared by threaded analyzers.
+      */
+      Simp::ThreadPool& threadPool();
+
+      /**
+      * Is this the processor that writes output files?
+      *
+      * Returns true in a serial run, and on processor 0 of an MPI run.
+      */
+      bool isIoProcessor() const;
+
       //@}
 
    private:
@@ -215,9 +336,69 @@ namespace Tools
       /// FileMaster
       FileMaster fileMaster_;
 
+      /// Thread pool shared by all threaded code.
+      Simp::ThreadPool threadPool_;
+
+      /// Trajectory file used by openTrajectory() and readFrame().
+      std::ifstream trajectoryFile_;
+
+      /// Read-ahead buffer for trajectoryFile_.
+      AsyncReadBuf trajectoryBuf_;
+
       /// String identifier for ConfigReader class name
       std::string configReaderName_;
 
+      /// Name of checkpoint file (without rank suffix).
+      std::string checkpointFileName_;
+
+      /// Number of analyzed frames between checkpoints (0 if disabled).
+      int checkpointInterval_;
+
+      #ifdef UTIL_MPI
+      /// Communicator for frame-parallel analysis (null if serial).
+      MPI::Intracomm* communicatorPtr_;
+
+      /// Log file of a processor other than 0.
+      std::ofstream logFile_;
+      #endif
+
+      /**
+      * Analyze a range of frames, optionally resuming from a checkpoint.
+      *
+      * \param filename   name of trajectory file.
+      * \param min        index of first frame
+      * \param max        index of last frame (or -1 for last frame)
+      * \param interval   stride between analyzed frames
+      * \param restartPtr checkpoint archive, after the range (or null)
+      */
+      void analyzeFrames(const std::string& filename,
+                         int min, int max, int interval,
+                         Serializable::IArchive* restartPtr);
+
+      /**
+      * Write a checkpoint file.
+      *
+      * \param filename name of trajectory file.
+      * \param min      index of first frame
+      * \param max      index of last frame
+      * \param interval stride between analyzed frames
+      * \param next     index of the next selected frame to analyze
+      */
+      void saveCheckpoint(const std::string& filename,
+                          int min, int max, int interval, int next);
+
+      /**
+      * Return name of checkpoint file of this processor.
+      *
+      * \param filename name of checkpoint file (without rank suffix)
+      */
+      std::string checkpointFileName(const std::string& filename) const;
+
+      /**
+      * Return number of processors (1 if serial).
+      */
+      int nProcessor() const;
+
    };
 
 }
@@ -1,6 +1,7 @@
 
 tools_processor_= \
     tools/processor/Processor.cpp \
+    tools/processor/ConfigPrefetcher.cpp \
     tools/processor/ProcessorAnalyzerFactory.cpp \
     tools/processor/ProcessorAnalyzerManager.cpp 
 
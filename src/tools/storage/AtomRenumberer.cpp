@@ -0,0 +1,309 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AtomRenumberer.h"
+#include <tools/storage/Configuration.h>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   namespace
+   {
+
+      /*
+      * Sort key for an atom: molecule identifier, then rank within it.
+      */
+      struct AtomKey
+      {
+         int speciesId;
+         int moleculeId;
+         int atomId;
+         int id;
+      };
+
+      inline bool operator < (const AtomKey& a, const AtomKey& b)
+      {
+         if (a.speciesId != b.speciesId) return a.speciesId < b.speciesId;
+         if (a.moleculeId != b.moleculeId) return a.moleculeId < b.moleculeId;
+         if (a.atomId != b.atomId) return a.atomId < b.atomId;
+         return a.id < b.id;
+      }
+
+      /*
+      * Sort key for a molecule, which occupies a range [begin, end)
+      * of an array of AtomKey objects.
+      */
+      struct MoleculeKey
+      {
+         int speciesId;
+         unsigned int key;
+         int begin;
+         int end;
+      };
+
+      inline bool operator < (const MoleculeKey& a, const MoleculeKey& b)
+      {
+         if (a.speciesId != b.speciesId) return a.speciesId < b.speciesId;
+         if (a.key != b.key) return a.key < b.key;
+         return a.begin < b.begin;
+      }
+
+      /*
+      * Spread the lowest 10 bits of x so that there are two zero bits
+      * between each pair of consecutive bits (used for Morton keys).
+      */
+      inline unsigned int spreadBits(unsigned int x)
+      {
+         x &= 0x000003ff;
+         x = (x | (x << 16)) & 0x030000ff;
+         x = (x | (x <<  8)) & 0x0300f00f;
+         x = (x | (x <<  4)) & 0x030c30c3;
+         x = (x | (x <<  2)) & 0x09249249;
+         return x;
+      }
+
+      /*
+      * Find root of a union-find tree, with path halving.
+      */
+      inline int findRoot(std::vector<int>& parents, int i)
+      {
+         while (parents[i] != i) {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+         }
+         return i;
+      }
+
+      /*
+      * Rewrite atom ids of all groups, and sort groups by smallest atom id.
+      */
+      template <int N>
+      void renumberGroups(GroupStorage<N>& storage,
+                          const DArray<int>& newIds)
+      {
+         int n = storage.size();
+         if (n == 0) return;
+         std::vector< std::pair<int, int> > keys(n);
+         std::vector< Group<N> > groups(n);
+         int capacity = newIds.capacity();
+         int i, j, oldId, id, minId;
+         for (i = 0; i < n; ++i) {
+            Group<N>& group = storage[i];
+            minId = capacity;
+            for (j = 0; j < N; ++j) {
+               oldId = group.atomIds[j];
+               if (oldId < 0 || oldId >= capacity) {
+                  UTIL_THROW("Group atom id out of range");
+               }
+               id = newIds[oldId];
+               if (id < 0) {
+                  UTIL_THROW("Group contains a missing atom");
+               }
+               group.atomIds[j] = id;
+               if (id < minId) minId = id;
+            }
+            keys[i].first = minId;
+            keys[i].second = i;
+            groups[i] = group;
+         }
+         std::sort(keys.begin(), keys.end());
+         for (i = 0; i < n; ++i) {
+            storage[i] = groups[keys[i].second];
+            storage[i].id = i;
+         }
+      }
+
+   }
+
+   /*
+   * Constructor.
+   */
+   AtomRenumberer::AtomRenumberer(Configuration& configuration)
+    : newIds_(),
+      configurationPtr_(&configuration)
+   {}
+
+   /*
+   * Destructor.
+   */
+   AtomRenumberer::~AtomRenumberer()
+   {}
+
+   /*
+   * Renumber atoms and groups.
+   */
+   void AtomRenumberer::renumber()
+   {
+      Configuration& configuration = *configurationPtr_;
+      AtomStorage& storage = configuration.atoms();
+      if (storage.size() == 0) return;
+
+      bool useSpecies = computeNewIds();
+      storage.renumber(newIds_);
+
+      #ifdef SIMP_BOND
+      renumberGroups(configuration.bonds(), newIds_);
+      #endif
+      #ifdef SIMP_ANGLE
+      renumberGroups(configuration.angles(), newIds_);
+      #endif
+      #ifdef SIMP_DIHEDRAL
+      renumberGroups(configuration.dihedrals(), newIds_);
+      renumberGroups(configuration.impropers(), newIds_);
+      #endif
+
+      // Atoms have moved: add them to species again
+      int nSpecies = configuration.nSpecies();
+      if (useSpecies) {
+         int i;
+         for (i = 0; i < nSpecies; ++i) {
+            configuration.species(i).clear();
+         }
+         AtomStorage::Iterator iter;
+         for (storage.begin(iter); iter.notEnd(); ++iter) {
+            configuration.species(iter->speciesId).addAtom(*iter);
+         }
+         for (i = 0; i < nSpecies; ++i) {
+            configuration.species(i).isValid();
+         }
+      }
+   }
+
+   /*
+   * Choose new atom ids, ordered by molecule and Morton key.
+   */
+   bool AtomRenumberer::computeNewIds()
+   {
+      Configuration& configuration = *configurationPtr_;
+      AtomStorage& storage = configuration.atoms();
+      int capacity = storage.capacity();
+      int n = storage.size();
+      if (newIds_.capacity() != capacity) {
+         if (newIds_.isAllocated()) newIds_.deallocate();
+         newIds_.allocate(capacity);
+      }
+      int i;
+      for (i = 0; i < capacity; ++i) {
+         newIds_[i] = -1;
+      }
+
+      // Use species context data only if every atom belongs to a species
+      int nSpecies = configuration.nSpecies();
+      bool useSpecies = false;
+      if (nSpecies > 0) {
+         int nFill = 0;
+         for (i = 0; i < nSpecies; ++i) {
+            Species& species = configuration.species(i);
+            nFill += species.size()*species.nAtom();
+         }
+         useSpecies = (nFill == n);
+      }
+
+      // Otherwise, molecules are connected components of the bond graph
+      std::vector<int> parents;
+      if (!useSpecies) {
+         parents.resize(capacity);
+         for (i = 0; i < capacity; ++i) {
+            parents[i] = i;
+         }
+         #ifdef SIMP_BOND
+         GroupStorage<2>& bonds = configuration.bonds();
+         int root0, root1;
+         for (i = 0; i < bonds.size(); ++i) {
+            root0 = findRoot(parents, bonds[i].atomIds[0]);
+            root1 = findRoot(parents, bonds[i].atomIds[1]);
+            if (root0 < root1) {
+               parents[root1] = root0;
+            } else {
+               parents[root0] = root1;
+            }
+         }
+         #endif
+      }
+
+      // Sort atoms by molecule
+      std::vector<AtomKey> atomKeys(n);
+      for (i = 0; i < n; ++i) {
+         Atom& atom = storage.atom(i);
+         AtomKey& key = atomKeys[i];
+         key.id = atom.id;
+         if (useSpecies) {
+            key.speciesId = atom.speciesId;
+            key.moleculeId = atom.moleculeId;
+            key.atomId = atom.atomId;
+         } else {
+            key.speciesId = 0;
+            key.moleculeId = findRoot(parents, atom.id);
+            key.atomId = atom.id;
+         }
+      }
+      std::sort(atomKeys.begin(), atomKeys.end());
+
+      // Identify molecules, and compute Morton key of first atom of each
+      Boundary& boundary = configuration.boundary();
+      std::vector<MoleculeKey> moleculeKeys;
+      MoleculeKey moleculeKey;
+      Vector rg;
+      double s;
+      unsigned int bits;
+      int j, k;
+      i = 0;
+      while (i < n) {
+         j = i + 1;
+         while (j < n && atomKeys[j].speciesId == atomKeys[i].speciesId
+                && atomKeys[j].moleculeId == atomKeys[i].moleculeId) {
+            ++j;
+         }
+         boundary.transformCartToGen(storage.ptr(atomKeys[i].id)->position,
+                                     rg);
+         moleculeKey.key = 0;
+         for (k = 0; k < Dimension; ++k) {
+            s = rg[k] - floor(rg[k]);
+            bits = (unsigned int)(s*1024.0);
+            if (bits > 1023) bits = 1023;
+            moleculeKey.key |= spreadBits(bits) << k;
+         }
+         moleculeKey.speciesId = atomKeys[i].speciesId;
+         moleculeKey.begin = i;
+         moleculeKey.end = j;
+         moleculeKeys.push_back(moleculeKey);
+         i = j;
+      }
+      std::sort(moleculeKeys.begin(), moleculeKeys.end());
+
+      // Assign consecutive ids in order of molecules
+      Atom* atomPtr;
+      int nMolecule = moleculeKeys.size();
+      int speciesId = -1;
+      int moleculeId = 0;
+      int id = 0;
+      for (i = 0; i < nMolecule; ++i) {
+         if (moleculeKeys[i].speciesId != speciesId) {
+            speciesId = moleculeKeys[i].speciesId;
+            moleculeId = 0;
+         }
+         for (j = moleculeKeys[i].begin; j < moleculeKeys[i].end; ++j) {
+            newIds_[atomKeys[j].id] = id;
+            if (useSpecies) {
+               atomPtr = storage.ptr(atomKeys[j].id);
+               atomPtr->moleculeId = moleculeId;
+            }
+            ++id;
+         }
+         ++moleculeId;
+      }
+      return useSpecies;
+   }
+
+}
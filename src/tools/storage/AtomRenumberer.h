@@ -0,0 +1,97 @@
+#ifndef TOOLS_ATOM_RENUMBERER_H
+#define TOOLS_ATOM_RENUMBERER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/containers/DArray.h>          // member (template)
+
+namespace Tools
+{
+
+   class Configuration;
+
+   using namespace Util;
+
+   /**
+   * Renumbers atoms of a Configuration to improve memory locality.
+   *
+   * The renumber() function assigns new consecutive atom ids such that
+   * the atoms of each molecule are contiguous, and such that molecules
+   * that are close in space have close ids. Molecules are identified
+   * from species context data, if all atoms have been added to species,
+   * or otherwise as connected components of the bond graph. Molecules
+   * are ordered by species (if known), and then along a Morton (Z-order)
+   * space filling curve through the scaled position of the first atom
+   * of each molecule. Atoms within a molecule keep their relative
+   * order. Atoms are then stored in order of new id, all bonds, angles
+   * and dihedrals are rewritten to refer to the new ids and stored in
+   * order of their smallest atom id, and groups are given consecutive
+   * ids in this order.
+   *
+   * A configuration renumbered in this way and written to a ddSim
+   * configuration file yields an initial DdMd simulation in which atoms
+   * that interact are close in every array indexed by atom or group id.
+   * Molecule ids within each species are also reassigned in the new
+   * order, so that atom ids remain ordered by species, molecule and
+   * atom index, as required by mcSim and mdSim.
+   *
+   * \ingroup Tools_Storage_Module
+   */
+   class AtomRenumberer
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration
+      */
+      AtomRenumberer(Configuration& configuration);
+
+      /**
+      * Destructor.
+      */
+      ~AtomRenumberer();
+
+      /**
+      * Renumber all atoms and groups of the parent Configuration.
+      */
+      void renumber();
+
+      /**
+      * Get the new id of an atom, indexed by its id before renumber().
+      *
+      * \param oldId atom id before the last call to renumber()
+      */
+      int newId(int oldId) const;
+
+   private:
+
+      /// New atom ids, indexed by old ids.
+      DArray<int> newIds_;
+
+      /// Pointer to parent Configuration.
+      Configuration* configurationPtr_;
+
+      /**
+      * Choose new ids for all atoms, and store them in newIds_.
+      *
+      * \return true if molecules were identified from species data
+      */
+      bool computeNewIds();
+
+   };
+
+   // Inline function
+
+   inline int AtomRenumberer::newId(int oldId) const
+   {  return newIds_[oldId]; }
+
+}
+#endif
@@ -7,6 +7,10 @@
 
 #include "AtomStorage.h"
 
+#include <vector>
+#include <algorithm>
+#include <utility>
+
 namespace Tools 
 {
 
@@ -33,6 +37,22 @@ namespace Tools
       clear();
    }
 
+   /*
+   * Allocate velocities, if not already allocated.
+   */
+   void AtomStorage::allocateVelocities()
+   {
+      if (velocities_.isAllocated()) return;
+      int capacity = atomPtrs_.capacity();
+      if (capacity == 0) {
+         UTIL_THROW("Error: AtomStorage is not allocated");
+      }
+      velocities_.allocate(capacity);
+      for (int i = 0; i < capacity; ++i) {
+         velocities_[i].zero();
+      }
+   }
+
    /*
    * Return pointer to location for new atom.
    */
@@ -60,6 +80,63 @@ namespace Tools
       newPtr_ = 0;
    }
 
+   /*
+   * Change atom ids, and store atoms in order of new ids.
+   */
+   void AtomStorage::renumber(const DArray<int>& newIds)
+   {
+      if (newPtr_) {
+         UTIL_THROW("Error: an new atom is still active");
+      }
+      int capacity = atomPtrs_.capacity();
+      if (newIds.capacity() < capacity) {
+         UTIL_THROW("Array of new ids is too small");
+      }
+
+      // Sort (new id, old id) pairs, and copy atoms
+      int n = atoms_.size();
+      std::vector< std::pair<int, int> > keys(n);
+      std::vector<Atom> oldAtoms(n);
+      int i, newId;
+      for (i = 0; i < n; ++i) {
+         newId = newIds[atoms_[i].id];
+         if (newId < 0 || newId >= capacity) {
+            UTIL_THROW("New atom id out of range");
+         }
+         keys[i].first = newId;
+         keys[i].second = i;
+         oldAtoms[i] = atoms_[i];
+      }
+      std::sort(keys.begin(), keys.end());
+
+      // Permute velocities
+      if (velocities_.isAllocated()) {
+         std::vector<Vector> oldVelocities(capacity);
+         for (i = 0; i < capacity; ++i) {
+            oldVelocities[i] = velocities_[i];
+            velocities_[i].zero();
+         }
+         for (i = 0; i < n; ++i) {
+            velocities_[keys[i].first]
+                   = oldVelocities[oldAtoms[keys[i].second].id];
+         }
+      }
+
+      // Store atoms in order of new id
+      for (i = 0; i < capacity; ++i) {
+         atomPtrs_[i] = 0;
+      }
+      for (i = 0; i < n; ++i) {
+         newId = keys[i].first;
+         if (i > 0 && newId == keys[i-1].first) {
+            UTIL_THROW("Duplicate new atom id");
+         }
+         atoms_[i] = oldAtoms[keys[i].second];
+         atoms_[i].id = newId;
+         atomPtrs_[newId] = &atoms_[i];
+      }
+   }
+
    /*
    * Remove all atoms and bonds - set to empty state.
    */
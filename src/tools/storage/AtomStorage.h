@@ -24,6 +24,12 @@ namespace Tools
    /**
    * Container for a set of atoms.
    *
+   * Atom velocities are stored in a separate array, indexed by atom id,
+   * that is only allocated by allocateVelocities(). Analyses that only
+   * use positions thus never allocate or touch memory for velocities.
+   * Configuration readers for file formats that contain velocities call
+   * allocateVelocities() before reading them.
+   *
    * \ingroup Tools_Storage_Module
    */
    class AtomStorage
@@ -67,6 +73,18 @@ namespace Tools
       */
       void clear();
 
+      /**
+      * Change atom ids, and store atoms in order of increasing new id.
+      *
+      * Each atom with id i is given the new id newIds[i], and atoms are
+      * then stored so that atom(k) has the k-th smallest new id. If
+      * velocities are allocated, they are moved to the new ids. New ids
+      * must be distinct and less than capacity().
+      *
+      * \param newIds array of new ids, indexed by old ids
+      */
+      void renumber(const DArray<int>& newIds);
+
       /**
       * Get a pointer to an atom by global id.
       *
@@ -76,11 +94,43 @@ namespace Tools
       */
       Atom* ptr(int id);
 
+      /**
+      * Get an atom by its index in the order in which atoms were added.
+      *
+      * Atoms are stored contiguously, so &atom(0) may be used as the 
+      * base address of a strided view of all atoms, with a stride of
+      * sizeof(Atom). 
+      *
+      * \param i index of atom, 0 <= i < size()
+      */
+      Atom& atom(int i);
+
       /**
       * Initialize an iterator for atoms.
       */
       void begin(Iterator& iter);
 
+      /**
+      * Allocate the array of velocities, if not already allocated.
+      *
+      * Newly allocated velocities are set to zero. Must be called after
+      * allocate(capacity).
+      */
+      void allocateVelocities();
+
+      /**
+      * Have velocities been allocated?
+      */
+      bool hasVelocities() const;
+
+      /**
+      * Get the velocity of an atom by global id.
+      *
+      * \pre hasVelocities() == true
+      * \param id global index / tag of atom.
+      */
+      Vector& velocity(int id);
+
       /**
       * Get atom capacity (maximum id + 1).
       */
@@ -99,6 +149,9 @@ namespace Tools
       /// Pointers to atoms indexed by ids. Missing atoms are null pointers.
       DArray<Atom*> atomPtrs_;
 
+      /// Atom velocities indexed by ids, allocated only on request.
+      DArray<Vector> velocities_;
+
       /// Pointer to new atom.
       Atom* newPtr_;
 
@@ -125,6 +178,24 @@ namespace Tools
    inline Atom* AtomStorage::ptr(int id)
    {  return atomPtrs_[id]; }
 
+   /*
+   * Return an atom by index in order of addition.
+   */
+   inline Atom& AtomStorage::atom(int i)
+   {  return atoms_[i]; }
+
+   /*
+   * Have velocities been allocated?
+   */
+   inline bool AtomStorage::hasVelocities() const
+   {  return velocities_.isAllocated(); }
+
+   /*
+   * Return the velocity of an atom with a specific id.
+   */
+   inline Vector& AtomStorage::velocity(int id)
+   {  return velocities_[id]; }
+
    /*
    * Initialize an iterator for atoms.
    */
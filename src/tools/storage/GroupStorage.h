@@ -33,6 +33,7 @@ namespace Tools
       typedef DSArray< Group<N> > Base;
       using Base::allocate;
       using Base::begin;
+      using Base::operator[];
       using Base::clear;
       using Base::size;
       using Base::capacity;
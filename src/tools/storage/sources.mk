@@ -1,7 +1,8 @@
 
 tools_storage_= \
     tools/storage/AtomStorage.cpp \
-    tools/storage/Configuration.cpp 
+    tools/storage/Configuration.cpp \
+    tools/storage/AtomRenumberer.cpp
 
 # Create lists of source (*.cpp) and object (*.o) files
 tools_storage_SRCS=\
@@ -4,6 +4,7 @@
 #include <tools/neighbor/CellList.h>
 #include <tools/neighbor/Cell.h>
 #include <tools/chemistry/Atom.h>
+#include <util/boundary/Boundary.h>
 #include <util/containers/DPArray.h>
 #include <util/containers/DArray.h>
 #include <util/space/Vector.h>
@@ -438,6 +439,48 @@ public:
       TEST_ASSERT(np == nq);
    }
 
+   void testSetupBoundary()
+   {
+      printMethod(TEST_FUNC);
+
+      Vector lengths(4.0, 6.0, 8.0);
+      Vector lower(0.0, 0.0, 0.0);
+      double cutoff = 1.2;
+      Boundary boundary;
+      boundary.setOrthorhombic(lengths);
+      spCellList.allocate(10, lower, lengths, cutoff);
+      spCellList.setup(boundary, cutoff);
+
+      TEST_ASSERT(spCellList.grid().dimension(0) == 3);
+      TEST_ASSERT(spCellList.grid().dimension(1) == 5);
+      TEST_ASSERT(spCellList.grid().dimension(2) == 6);
+
+      // Atom outside the primary cell is placed by its image
+      DArray<Atom> spAtoms;
+      spAtoms.allocate(1);
+      spAtoms[0].id = 0;
+      spAtoms[0].position = Vector(-0.5, 7.0, 3.0);
+      spCellList.placeAtom(spAtoms[0], boundary);
+      spCellList.build();
+      TEST_ASSERT(spCellList.isValid());
+      TEST_ASSERT(spCellList.nAtom() == 1);
+      TEST_ASSERT(spCellList.nReject() == 0);
+
+      IntVector p(2, 0, 2);
+      const Cell& cell = spCellList.cell(spCellList.grid().rank(p));
+      TEST_ASSERT(cell.nAtom() == 1);
+      const Vector& r = cell.atomPtr(0)->position();
+      TEST_ASSERT(eq(r[0], 3.5));
+      TEST_ASSERT(eq(r[1], 1.0));
+      TEST_ASSERT(eq(r[2], 3.0));
+      TEST_ASSERT(eq(spAtoms[0].position[0], -0.5));
+
+      // Repeated setup with the same boundary clears cells
+      spCellList.setup(boundary, cutoff);
+      TEST_ASSERT(spCellList.nAtom() == 0);
+      TEST_ASSERT(spCellList.grid().size() == 3*5*6);
+   }
+
 };
 
 TEST_BEGIN(CellListTest)
@@ -447,6 +490,7 @@ TEST_ADD(CellListTest, testPlaceAtom)
 TEST_ADD(CellListTest, testPlaceAtoms)
 TEST_ADD(CellListTest, testAddRandomAtoms)
 TEST_ADD(CellListTest, testGetNeighbors)
+TEST_ADD(CellListTest, testSetupBoundary)
 TEST_END(CellListTest)
 
 #endif //ifndef TOOLS_CELL_LIST_TEST_H
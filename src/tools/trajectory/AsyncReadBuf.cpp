@@ -0,0 +1,316 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "AsyncReadBuf.h"
+#include <util/misc/FileMaster.h>
+
+#include <istream>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   AsyncReadBuf::AsyncReadBuf(int blockSize)
+    : std::streambuf(),
+      file_(),
+      active_(),
+      pending_(),
+      position_(0),
+      blockSize_(blockSize),
+      hasPending_(false),
+      isEnd_(true),
+      hasError_(false),
+      isFailed_(false)
+      #ifdef TOOLS_ASYNC_IO
+      , isRunning_(false)
+      , isDone_(false)
+      #endif
+   {
+      if (blockSize_ <= 0) {
+         UTIL_THROW("Nonpositive blockSize");
+      }
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_init(&mutex_, 0);
+      pthread_cond_init(&cond_, 0);
+      #endif
+   }
+
+   /*
+   * Destructor.
+   */
+   AsyncReadBuf::~AsyncReadBuf()
+   {
+      // Do not throw from a destructor
+      try {
+         close();
+      } catch (...) {}
+
+      #ifdef TOOLS_ASYNC_IO
+      if (isRunning_) {
+         pthread_mutex_lock(&mutex_);
+         isDone_ = true;
+         pthread_cond_broadcast(&cond_);
+         pthread_mutex_unlock(&mutex_);
+         pthread_join(thread_, 0);
+         isRunning_ = false;
+      }
+      pthread_cond_destroy(&cond_);
+      pthread_mutex_destroy(&mutex_);
+      #endif
+   }
+
+   /*
+   * Open a file, and start reading the first block.
+   */
+   void AsyncReadBuf::open(FileMaster& fileMaster,
+                           const std::string& filename,
+                           std::ios::openmode mode)
+   {
+      close();
+      fileMaster.openInputFile(filename, file_, mode);
+      isFailed_ = false;
+
+      #ifdef TOOLS_ASYNC_IO
+      if (!isRunning_) {
+         isDone_ = false;
+         if (pthread_create(&thread_, 0, &AsyncReadBuf::runThread, this)) {
+            UTIL_THROW("Failed to create reader thread");
+         }
+         isRunning_ = true;
+      }
+      pthread_mutex_lock(&mutex_);
+      hasError_ = false;
+      hasPending_ = false;
+      isEnd_ = false;
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #else
+      hasError_ = false;
+      hasPending_ = false;
+      isEnd_ = false;
+      #endif
+   }
+
+   /*
+   * Redirect input of a stream to this buffer.
+   */
+   void AsyncReadBuf::attach(std::istream& stream)
+   {
+      stream.rdbuf(this);
+      stream.clear();
+   }
+
+   /*
+   * Wait for any read in progress, and close file.
+   */
+   void AsyncReadBuf::close()
+   {
+      waitIdle();
+      if (file_.is_open()) {
+         file_.close();
+      }
+
+      // The reader thread is idle while isEnd_ is true.
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      #endif
+      isEnd_ = true;
+      hasPending_ = false;
+      pending_.clear();
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_unlock(&mutex_);
+      #endif
+      active_.clear();
+      setg(0, 0, 0);
+      position_ = 0;
+   }
+
+   /*
+   * Block until no read of the file is in progress.
+   */
+   void AsyncReadBuf::waitIdle()
+   {
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      while (!hasPending_ && !isEnd_) {
+         pthread_cond_wait(&cond_, &mutex_);
+      }
+      pthread_mutex_unlock(&mutex_);
+      #endif
+   }
+
+   /*
+   * Read next block of file into pending buffer.
+   */
+   void AsyncReadBuf::readPending()
+   {
+      pending_.resize(blockSize_);
+      file_.read(&pending_[0], blockSize_);
+      std::streamsize n = file_.gcount();
+      bool isEnd = (n < blockSize_);
+      bool hasError = file_.bad();
+      pending_.resize(n);
+
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      #endif
+      if (n > 0) hasPending_ = true;
+      if (isEnd) isEnd_ = true;
+      if (hasError) hasError_ = true;
+      #ifdef TOOLS_ASYNC_IO
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #endif
+   }
+
+   #ifdef TOOLS_ASYNC_IO
+   /*
+   * Reader thread main loop.
+   */
+   void AsyncReadBuf::run()
+   {
+      pthread_mutex_lock(&mutex_);
+      while (true) {
+         while ((hasPending_ || isEnd_) && !isDone_) {
+            pthread_cond_wait(&cond_, &mutex_);
+         }
+         if (isDone_) break;
+
+         // The main thread does not touch pending_ or file_ while
+         // hasPending_ and isEnd_ are both false, so the read is done
+         // without the lock.
+         pthread_mutex_unlock(&mutex_);
+         readPending();
+         pthread_mutex_lock(&mutex_);
+      }
+      pthread_mutex_unlock(&mutex_);
+   }
+
+   /*
+   * Static entry point for the reader thread.
+   */
+   void* AsyncReadBuf::runThread(void* ptr)
+   {
+      static_cast<AsyncReadBuf*>(ptr)->run();
+      return 0;
+   }
+   #endif
+
+   /*
+   * Swap in the next block read ahead by the reader, if any.
+   */
+   AsyncReadBuf::int_type AsyncReadBuf::underflow()
+   {
+      if (gptr() < egptr()) {
+         return traits_type::to_int_type(*gptr());
+      }
+      position_ += active_.size();
+      active_.clear();
+      setg(0, 0, 0);
+
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      while (!hasPending_ && !isEnd_) {
+         pthread_cond_wait(&cond_, &mutex_);
+      }
+      #else
+      if (!hasPending_ && !isEnd_) {
+         readPending();
+      }
+      #endif
+      if (hasPending_) {
+         active_.swap(pending_);
+         hasPending_ = false;
+      }
+      if (hasError_) {
+         isFailed_ = true;
+      }
+      #ifdef TOOLS_ASYNC_IO
+      // Wake the reader to start on the following block
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #endif
+
+      if (active_.empty()) {
+         return traits_type::eof();
+      }
+      char* begin = &active_[0];
+      setg(begin, begin, begin + active_.size());
+      return traits_type::to_int_type(*gptr());
+   }
+
+   /*
+   * Report the current input position, or seek relative to it.
+   */
+   AsyncReadBuf::pos_type
+   AsyncReadBuf::seekoff(off_type off, std::ios::seekdir dir,
+                         std::ios::openmode which)
+   {
+      if (!(which & std::ios::in)) {
+         return pos_type(off_type(-1));
+      }
+      off_type current = position_ + (gptr() - eback());
+      if (dir == std::ios::cur) {
+         if (off == 0) {
+            return pos_type(current);
+         }
+         return seekpos(pos_type(current + off), which);
+      }
+      if (dir == std::ios::beg) {
+         return seekpos(pos_type(off), which);
+      }
+      return pos_type(off_type(-1));
+   }
+
+   /*
+   * Seek to an absolute position.
+   */
+   AsyncReadBuf::pos_type
+   AsyncReadBuf::seekpos(pos_type pos, std::ios::openmode which)
+   {
+      off_type target = off_type(pos);
+      if (!(which & std::ios::in) || target < 0 || !file_.is_open()) {
+         return pos_type(off_type(-1));
+      }
+
+      // Within the active block, only move the get pointer
+      off_type size = active_.size();
+      if (target >= position_ && target < position_ + size) {
+         char* begin = &active_[0];
+         setg(begin, begin + (target - position_), begin + size);
+         return pos;
+      }
+
+      // Otherwise discard blocks read ahead, and restart reader at target
+      waitIdle();
+      #ifdef TOOLS_ASYNC_IO
+      pthread_mutex_lock(&mutex_);
+      #endif
+      pending_.clear();
+      hasPending_ = false;
+      file_.clear();
+      file_.seekg(pos);
+      bool isValid = !file_.fail();
+      isEnd_ = !isValid;
+      #ifdef TOOLS_ASYNC_IO
+      pthread_cond_broadcast(&cond_);
+      pthread_mutex_unlock(&mutex_);
+      #endif
+      active_.clear();
+      setg(0, 0, 0);
+      if (!isValid) {
+         return pos_type(off_type(-1));
+      }
+      position_ = target;
+      return pos;
+   }
+
+}
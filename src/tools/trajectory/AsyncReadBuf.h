@@ -0,0 +1,192 @@
+#ifndef TOOLS_ASYNC_READ_BUF_H
+#define TOOLS_ASYNC_READ_BUF_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+
+#ifdef TOOLS_ASYNC_IO
+#include <pthread.h>
+#endif
+
+namespace Util { class FileMaster; }
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /**
+   * Double-buffered stream buffer that reads a file ahead in the background.
+   *
+   * An AsyncReadBuf is attached to an input stream, so that everything
+   * read from the stream is taken from a block of memory. While the
+   * caller parses one block (e.g., while a TrajectoryReader parses a
+   * frame and the analyzers process it), a reader thread reads the next
+   * block of the file from disk. Reading from the stream only blocks
+   * when the caller has consumed all data that has been read ahead.
+   *
+   * The reader thread is only used if the program is compiled with the
+   * TOOLS_ASYNC_IO preprocessor macro defined, which requires pthreads.
+   * Otherwise, each block is read synchronously when it is needed.
+   *
+   * Because attach() replaces the stream buffer of a std::ifstream, the
+   * std::ifstream functions is_open() and close() refer to the unused
+   * internal buffer of that stream, and should not be called. Function
+   * tellg() returns the number of bytes read since open(). Function
+   * seekg() is supported for absolute positions and offsets from the
+   * current position. A seek within the block being parsed only moves
+   * the get pointer; any other seek discards the blocks read ahead and
+   * restarts reading at the new position.
+   */
+   class AsyncReadBuf : public std::streambuf
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param blockSize number of bytes read from the file at a time
+      */
+      AsyncReadBuf(int blockSize = 1048576);
+
+      /**
+      * Destructor.
+      *
+      * Closes file and stops the reader thread.
+      */
+      virtual ~AsyncReadBuf();
+
+      /**
+      * Open a file, after closing any file that was previously open.
+      *
+      * \param fileMaster FileMaster used to open the file
+      * \param filename   name of input file (without input prefix)
+      * \param mode       open mode (e.g., std::ios::in|std::ios::binary)
+      */
+      void open(FileMaster& fileMaster, const std::string& filename,
+                std::ios::openmode mode = std::ios::in);
+
+      /**
+      * Redirect all input from stream to this buffer.
+      *
+      * \param stream input stream (usually a std::ifstream)
+      */
+      void attach(std::istream& stream);
+
+      /**
+      * Wait for any read in progress to finish, and close file.
+      */
+      void close();
+
+      /**
+      * Is a file open?
+      */
+      bool isOpen() const;
+
+      /**
+      * Did a read from the file fail?
+      */
+      bool hasError() const;
+
+   protected:
+
+      /**
+      * Make the next block of data available, if any.
+      */
+      virtual int_type underflow();
+
+      /**
+      * Seek relative to the beginning or current position, or query.
+      */
+      virtual pos_type seekoff(off_type off, std::ios::seekdir dir,
+                               std::ios::openmode which = std::ios::in);
+
+      /**
+      * Seek to an absolute position in the file.
+      */
+      virtual pos_type seekpos(pos_type pos,
+                               std::ios::openmode which = std::ios::in);
+
+   private:
+
+      /// Input file.
+      std::ifstream file_;
+
+      /// Block being parsed by the main thread.
+      std::string active_;
+
+      /// Block being read by the reader thread.
+      std::string pending_;
+
+      /// Number of bytes in blocks consumed before active_.
+      long position_;
+
+      /// Number of bytes read from the file at a time.
+      int blockSize_;
+
+      /// Is the pending block full and ready to be parsed?
+      bool hasPending_;
+
+      /// Has the end of the file been reached by the reader?
+      bool isEnd_;
+
+      /// Did a read fail (shared with reader thread)?
+      bool hasError_;
+
+      /// Did a read fail (copy owned by main thread)?
+      bool isFailed_;
+
+      #ifdef TOOLS_ASYNC_IO
+      /// Reader thread.
+      pthread_t thread_;
+
+      /// Mutex protecting pending_, hasPending_, isEnd_, hasError_, isDone_.
+      pthread_mutex_t mutex_;
+
+      /// Condition variable signalled when hasPending_ or isEnd_ change.
+      pthread_cond_t cond_;
+
+      /// Has the reader thread been started?
+      bool isRunning_;
+
+      /// Should the reader thread exit?
+      bool isDone_;
+
+      /// Reader thread main loop.
+      void run();
+
+      /// Entry point for pthread_create.
+      static void* runThread(void* ptr);
+      #endif
+
+      /// Read the next block into pending_ (called by reader thread, if any).
+      void readPending();
+
+      /// Block until no read of file_ is in progress.
+      void waitIdle();
+
+      // Copy constructor and assignment (not implemented).
+      AsyncReadBuf(const AsyncReadBuf& other);
+      AsyncReadBuf& operator = (const AsyncReadBuf& other);
+
+   };
+
+   inline bool AsyncReadBuf::isOpen() const
+   {  return file_.is_open(); }
+
+   inline bool AsyncReadBuf::hasError() const
+   {  return isFailed_; }
+
+}
+#endif
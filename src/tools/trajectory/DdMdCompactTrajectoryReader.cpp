@@ -0,0 +1,88 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "DdMdCompactTrajectoryReader.h" 
+#include <tools/storage/Configuration.h>
+#include <util/space/Vector.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   DdMdCompactTrajectoryReader::DdMdCompactTrajectoryReader(Configuration& configuration)
+    : TrajectoryReader(configuration, true),
+      trajectory_(),
+      positions_()
+   {  setClassName("DdMdCompactTrajectoryReader"); }
+
+   /*
+   * Destructor.
+   */
+   DdMdCompactTrajectoryReader::~DdMdCompactTrajectoryReader()
+   {}
+
+   /*
+   * Read header and frame index, allocate memory.
+   */
+   void DdMdCompactTrajectoryReader::readHeader(std::ifstream &file)
+   {
+      trajectory_.readHeader(file);
+      trajectory_.readIndex(file);
+      int nAtom = trajectory_.nAtom();
+      if (positions_.isAllocated()) {
+         if (positions_.capacity() != nAtom) {
+            positions_.deallocate();
+         }
+      }
+      if (!positions_.isAllocated()) {
+         positions_.allocate(nAtom);
+      }
+   }
+
+   /*
+   * Read a frame.
+   */
+   bool DdMdCompactTrajectoryReader::readFrame(std::ifstream& file)
+   {
+      Boundary& boundary = configuration().boundary();
+      long iStep;
+      if (!trajectory_.readFrame(file, iStep, boundary, positions_)) {
+         return false;
+      }
+
+      // Assign atomic positions, converting to Cartesian coordinates
+      AtomStorage* storagePtr = &configuration().atoms();
+      Atom* atomPtr;
+      int nAtom = trajectory_.nAtom();
+      for (int i = 0; i < nAtom; ++i) {
+         atomPtr = storagePtr->ptr(i);
+         if (atomPtr == 0) {
+            UTIL_THROW("Unknown atom");
+         }
+         boundary.transformGenToCart(positions_[i], atomPtr->position);
+      }
+
+      return true;
+   }
+
+   /*
+   * Get number of frames in the index.
+   */
+   int DdMdCompactTrajectoryReader::nFrame() const
+   {  return trajectory_.nFrame(); }
+
+   /*
+   * Position file at the beginning of a frame.
+   */
+   void DdMdCompactTrajectoryReader::seekFrame(std::ifstream& file, int frameId)
+   {  trajectory_.seekFrame(file, frameId); }
+
+}
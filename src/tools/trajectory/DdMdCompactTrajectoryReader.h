@@ -0,0 +1,87 @@
+#ifndef TOOLS_DDMD_COMPACT_TRAJECTORY_READER_H
+#define TOOLS_DDMD_COMPACT_TRAJECTORY_READER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/trajectory/TrajectoryReader.h>  // base class
+#include <simp/trajectory/CompactTrajectory.h>  // member
+#include <util/containers/DArray.h>             // member
+#include <util/space/Vector.h>                  // member
+
+namespace Tools
+{
+
+   class Configuration;
+   using namespace Util;
+   using namespace Simp;
+
+   /**
+   * Reader for the compact trajectory format of DdMdCompactTrajectoryWriter.
+   *
+   * The frame index is read (or rebuilt) by readHeader, after which any
+   * frame can be accessed directly with seekFrame.
+   *
+   * \ingroup Tools_Trajectory_Module
+   */
+   class DdMdCompactTrajectoryReader  : public TrajectoryReader
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration object
+      */
+      DdMdCompactTrajectoryReader(Configuration& configuration);
+
+      /**
+      * Destructor.
+      */
+      virtual ~DdMdCompactTrajectoryReader();
+
+      /**
+      * Read the header and frame index.
+      *
+      * \param file input file 
+      */
+      virtual void readHeader(std::ifstream& file);
+
+      /**
+      * Read the next frame.
+      *
+      * \param file input file 
+      * \return true if a frame was found, false if end of trajectory
+      */
+      virtual bool readFrame(std::ifstream& file);
+
+      /**
+      * Get the number of frames in the file.
+      */
+      virtual int nFrame() const;
+
+      /**
+      * Position the file at the beginning of a frame.
+      *
+      * \param file input file 
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      virtual void seekFrame(std::ifstream& file, int frameId);
+
+   private:
+
+      /// File format decoder, and index of frame offsets.
+      CompactTrajectory trajectory_;
+
+      /// Scaled atomic positions, indexed by atom id.
+      DArray<Vector> positions_;
+
+   };
+
+}
+#endif
@@ -77,6 +77,9 @@ namespace Tools
          }
          boundary.transformGenToCart(r, atomPtr->position);
       }
+      if (file.fail()) {
+         UTIL_THROW("Incomplete trajectory frame");
+      }
 
       return true;
    }
@@ -0,0 +1,78 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "FrameIndex.h"
+#include "TrajectoryReader.h"
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   FrameIndex::FrameIndex()
+    : offsets_()
+   {}
+
+   /*
+   * Read all frames, recording the position of each.
+   */
+   void FrameIndex::build(TrajectoryReader& reader, std::ifstream& file)
+   {
+      offsets_.clear();
+      long position = file.tellg();
+      while (reader.readFrame(file)) {
+         if (position < 0) {
+            UTIL_THROW("Trajectory file position is unavailable");
+         }
+         offsets_.push_back(position);
+         position = file.tellg();
+      }
+   }
+
+   /*
+   * Read index file, and check that it matches the trajectory.
+   */
+   bool FrameIndex::read(std::istream& in, const std::string& className,
+                         long fileSize)
+   {
+      offsets_.clear();
+      std::string label, name;
+      long size;
+      int n;
+      in >> label >> name >> size;
+      if (in.fail() || label != "FRAME_INDEX") return false;
+      if (name != className || size != fileSize) return false;
+      in >> label >> n;
+      if (in.fail() || label != "nFrame" || n < 0) return false;
+      offsets_.resize(n);
+      for (int i = 0; i < n; ++i) {
+         in >> offsets_[i];
+      }
+      if (in.fail()) {
+         offsets_.clear();
+         return false;
+      }
+      return true;
+   }
+
+   /*
+   * Write index file.
+   */
+   void FrameIndex::write(std::ostream& out, const std::string& className,
+                          long fileSize) const
+   {
+      out << "FRAME_INDEX " << className << " " << fileSize << "\n";
+      out << "nFrame " << offsets_.size() << "\n";
+      for (size_t i = 0; i < offsets_.size(); ++i) {
+         out << offsets_[i] << "\n";
+      }
+   }
+
+}
@@ -0,0 +1,113 @@
+#ifndef TOOLS_FRAME_INDEX_H
+#define TOOLS_FRAME_INDEX_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <util/global.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Tools
+{
+
+   class TrajectoryReader;
+   using namespace Util;
+
+   /**
+   * Index of the file offsets of the frames of a sequential trajectory.
+   *
+   * A FrameIndex is built by reading every frame of a trajectory once
+   * with a TrajectoryReader, recording the file position before each
+   * frame. It may then be written to a small text "sidecar" file, and
+   * read back in later runs, so that frames of a trajectory file in a
+   * sequential format (e.g., DdMdTrajectoryReader or LammpsDumpReader)
+   * can be accessed in any order without parsing the preceding frames.
+   *
+   * An index file records the class name of the reader and the size
+   * of the trajectory file, and read() rejects an index if either does
+   * not match, so that a stale index is rebuilt.
+   *
+   * \ingroup Tools_Trajectory_Module
+   */
+   class FrameIndex
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      */
+      FrameIndex();
+
+      /**
+      * Build the index by reading all frames of a trajectory file.
+      *
+      * The file must be positioned after the header, i.e., after the
+      * reader's readHeader function. On return, the end of the file
+      * has been reached, and the state of the stream is not cleared.
+      *
+      * \param reader TrajectoryReader for the file format
+      * \param file   input file, after readHeader
+      */
+      void build(TrajectoryReader& reader, std::ifstream& file);
+
+      /**
+      * Read an index file, if it matches a trajectory.
+      *
+      * \param in        input index file
+      * \param className class name of trajectory reader
+      * \param fileSize  size of the trajectory file, in bytes
+      * \return true if a matching index was read, false otherwise
+      */
+      bool read(std::istream& in, const std::string& className,
+                long fileSize);
+
+      /**
+      * Write the index file.
+      *
+      * \param out       output index file
+      * \param className class name of trajectory reader
+      * \param fileSize  size of the trajectory file, in bytes
+      */
+      void write(std::ostream& out, const std::string& className,
+                 long fileSize) const;
+
+      /**
+      * Get the number of frames.
+      */
+      int nFrame() const;
+
+      /**
+      * Get the file offset of the beginning of a frame.
+      *
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      long offset(int frameId) const;
+
+   private:
+
+      /// File offsets of frames, indexed by frame id.
+      std::vector<long> offsets_;
+
+   };
+
+   // Inline functions
+
+   inline int FrameIndex::nFrame() const
+   {  return offsets_.size(); }
+
+   inline long FrameIndex::offset(int frameId) const
+   {
+      assert(frameId >= 0 && frameId < (int)offsets_.size());
+      return offsets_[frameId];
+   }
+
+}
+#endif
@@ -0,0 +1,185 @@
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include "Hdf5TrajectoryReader.h"
+#include <tools/storage/Configuration.h>
+#include <util/space/Vector.h>
+#include <util/global.h>
+
+namespace Tools
+{
+
+   using namespace Util;
+
+   /*
+   * Constructor.
+   */
+   Hdf5TrajectoryReader::Hdf5TrajectoryReader(Configuration& configuration)
+    : TrajectoryReader(configuration, true),
+      positions_(),
+      filename_(),
+      fileId_(-1),
+      positionsId_(-1),
+      lengthsId_(-1),
+      nAtom_(0),
+      nFrame_(0),
+      frameId_(0)
+   {  setClassName("Hdf5TrajectoryReader"); }
+
+   /*
+   * Destructor.
+   */
+   Hdf5TrajectoryReader::~Hdf5TrajectoryReader()
+   {  close(); }
+
+   /*
+   * Set name of the HDF5 file.
+   */
+   void Hdf5TrajectoryReader::setFileName(const std::string& filename)
+   {  filename_ = filename; }
+
+   /*
+   * Open file and datasets, allocate memory.
+   */
+   void Hdf5TrajectoryReader::readHeader(std::ifstream &file)
+   {
+      close();
+      fileId_ = H5Fopen(filename_.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+      if (fileId_ < 0) {
+         UTIL_THROW("Error opening HDF5 trajectory file");
+      }
+      positionsId_ = H5Dopen2(fileId_, "positions", H5P_DEFAULT);
+      lengthsId_ = H5Dopen2(fileId_, "lengths", H5P_DEFAULT);
+      if (positionsId_ < 0 || lengthsId_ < 0) {
+         UTIL_THROW("Missing dataset in HDF5 trajectory file");
+      }
+
+      hsize_t dims[3];
+      hid_t space = H5Dget_space(positionsId_);
+      if (H5Sget_simple_extent_ndims(space) != 3) {
+         UTIL_THROW("Invalid positions dataset");
+      }
+      H5Sget_simple_extent_dims(space, dims, NULL);
+      H5Sclose(space);
+      if (dims[2] != Dimension) {
+         UTIL_THROW("Invalid positions dataset");
+      }
+      nFrame_ = dims[0];
+      nAtom_ = dims[1];
+      frameId_ = 0;
+
+      if (positions_.isAllocated()) {
+         if (positions_.capacity() != Dimension*nAtom_) {
+            positions_.deallocate();
+         }
+      }
+      if (!positions_.isAllocated()) {
+         positions_.allocate(Dimension*nAtom_);
+      }
+   }
+
+   /*
+   * Read a frame.
+   */
+   bool Hdf5TrajectoryReader::readFrame(std::ifstream& file)
+   {
+      if (fileId_ < 0) {
+         UTIL_THROW("HDF5 trajectory file is not open");
+      }
+      if (frameId_ >= nFrame_) {
+         return false;
+      }
+
+      // Read and set orthorhombic box lengths
+      Boundary& boundary = configuration().boundary();
+      double lengthData[Dimension];
+      hsize_t count[3] = {1, Dimension, 0};
+      read(lengthsId_, 2, count, lengthData);
+      Vector lengths;
+      int i, j;
+      for (j = 0; j < Dimension; ++j) {
+         lengths[j] = lengthData[j];
+      }
+      boundary.setOrthorhombic(lengths);
+
+      // Read and assign atomic positions
+      count[1] = nAtom_;
+      count[2] = Dimension;
+      read(positionsId_, 3, count, &positions_[0]);
+      AtomStorage* storagePtr = &configuration().atoms();
+      Atom* atomPtr;
+      for (i = 0; i < nAtom_; ++i) {
+         atomPtr = storagePtr->ptr(i);
+         if (atomPtr == 0) {
+            UTIL_THROW("Unknown atom");
+         }
+         for (j = 0; j < Dimension; ++j) {
+            atomPtr->position[j] = positions_[Dimension*i + j];
+         }
+      }
+
+      ++frameId_;
+      return true;
+   }
+
+   /*
+   * Get number of frames.
+   */
+   int Hdf5TrajectoryReader::nFrame() const
+   {  return nFrame_; }
+
+   /*
+   * Set index of the next frame.
+   */
+   void Hdf5TrajectoryReader::seekFrame(std::ifstream& file, int frameId)
+   {
+      if (frameId < 0 || frameId >= nFrame_) {
+         UTIL_THROW("Frame index out of range");
+      }
+      frameId_ = frameId;
+   }
+
+   /*
+   * Close file and datasets.
+   */
+   void Hdf5TrajectoryReader::close()
+   {
+      if (fileId_ >= 0) {
+         if (positionsId_ >= 0) H5Dclose(positionsId_);
+         if (lengthsId_ >= 0) H5Dclose(lengthsId_);
+         H5Fclose(fileId_);
+         fileId_ = -1;
+         positionsId_ = -1;
+         lengthsId_ = -1;
+      }
+   }
+
+   /*
+   * Read a block of count doubles beginning at frame frameId_.
+   */
+   void Hdf5TrajectoryReader::read(hid_t dataset, int rank,
+                                   const hsize_t* count, double* data)
+   {
+      hsize_t offset[3] = {(hsize_t) frameId_, 0, 0};
+      hsize_t size = 1;
+      for (int i = 0; i < rank; ++i) {
+         size *= count[i];
+      }
+      hid_t fileSpace = H5Dget_space(dataset);
+      H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL,
+                          count, NULL);
+      hid_t memSpace = H5Screate_simple(1, &size, NULL);
+      herr_t error = H5Dread(dataset, H5T_NATIVE_DOUBLE, memSpace,
+                             fileSpace, H5P_DEFAULT, data);
+      H5Sclose(memSpace);
+      H5Sclose(fileSpace);
+      if (error < 0) {
+         UTIL_THROW("Error reading HDF5 trajectory file");
+      }
+   }
+
+}
@@ -0,0 +1,127 @@
+#ifndef TOOLS_HDF5_TRAJECTORY_READER_H
+#define TOOLS_HDF5_TRAJECTORY_READER_H
+
+/*
+* Simpatico - Simulation Package for Polymeric and Molecular Liquids
+*
+* Copyright 2010 - 2017, The Regents of the University of Minnesota
+* Distributed under the terms of the GNU General Public License.
+*/
+
+#include <tools/trajectory/TrajectoryReader.h>  // base class
+#include <util/containers/DArray.h>             // member
+#include <hdf5.h>
+
+#include <string>
+
+namespace Tools
+{
+
+   class Configuration;
+   using namespace Util;
+
+   /**
+   * Reader for HDF5 trajectory files written by DdMd::Hdf5TrajectoryWriter.
+   *
+   * The file is opened by the HDF5 library, using the name passed to
+   * setFileName, and the std::ifstream arguments of readHeader and
+   * readFrame are not used. Any frame can be accessed directly with
+   * seekFrame.
+   *
+   * This class is only available if compiled with SIMP_HDF5 defined.
+   *
+   * \ingroup Tools_Trajectory_Module
+   */
+   class Hdf5TrajectoryReader  : public TrajectoryReader
+   {
+
+   public:
+
+      /**
+      * Constructor.
+      *
+      * \param configuration parent Configuration object
+      */
+      Hdf5TrajectoryReader(Configuration& configuration);
+
+      /**
+      * Destructor (closes file, if open).
+      */
+      virtual ~Hdf5TrajectoryReader();
+
+      /**
+      * Set the name of the HDF5 file.
+      *
+      * \param filename name of trajectory file
+      */
+      virtual void setFileName(const std::string& filename);
+
+      /**
+      * Open the file and datasets, and allocate memory.
+      *
+      * \param file input file (unused)
+      */
+      virtual void readHeader(std::ifstream& file);
+
+      /**
+      * Read the next frame.
+      *
+      * \param file input file (unused)
+      * \return true if a frame was found, false if end of trajectory
+      */
+      virtual bool readFrame(std::ifstream& file);
+
+      /**
+      * Get the number of frames in the file.
+      */
+      virtual int nFrame() const;
+
+      /**
+      * Set the index of the next frame to be read.
+      *
+      * \param file input file (unused)
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      virtual void seekFrame(std::ifstream& file, int frameId);
+
+   private:
+
+      /// Positions for one frame (3 per atom, indexed by atom id).
+      DArray<double> positions_;
+
+      /// Name of the HDF5 file.
+      std::string filename_;
+
+      /// Identifier for the open file (negative if none).
+      hid_t fileId_;
+
+      /// Identifier for the positions dataset.
+      hid_t positionsId_;
+
+      /// Identifier for the box lengths dataset.
+      hid_t lengthsId_;
+
+      /// Number of atoms.
+      int nAtom_;
+
+      /// Number of frames in the file.
+      int nFrame_;
+
+      /// Index of the next frame.
+      int frameId_;
+
+      /**
+      * Close the file, if open.
+      */
+      void close();
+
+      /**
+      * Read a block of a dataset of doubles, starting at frame frameId_.
+      */
+      void read(hid_t dataset, int rank, const hsize_t* count,
+                double* data);
+
+   };
+
+}
+#endif
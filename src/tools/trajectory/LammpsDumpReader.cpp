@@ -7,19 +7,23 @@
 
 #include "LammpsDumpReader.h" 
 #include <tools/storage/Configuration.h>
+#include <simp/trajectory/LammpsDumpFormat.h>
 #include <util/space/Vector.h>
 #include <util/misc/ioUtil.h>
+#include <util/global.h>
 
 namespace Tools
 {
 
    using namespace Util;
+   using namespace Simp;
 
    /*
    * Constructor.
    */
    LammpsDumpReader::LammpsDumpReader(Configuration& configuration)
-    : TrajectoryReader(configuration, false)
+    : TrajectoryReader(configuration, false),
+      lines_()
    {  setClassName("LammpsDumpReader"); }
 
    /*
@@ -71,6 +75,7 @@ namespace Tools
          file >> min[i] >> max[i];
          lengths[i] = max[i] - min[i];
       }
+      configuration().boundary().setOrthorhombic(lengths);
 
       // Read ITEM: ATOMS 
       notEnd = getNextLine(file, line);
@@ -78,30 +83,47 @@ namespace Tools
       checkString(line, "ATOMS");
       // Ignore the rest of ITEM: ATOMS  line, for now
 
-      // Loop over atoms, read positions
-      AtomStorage* storagePtr = &configuration().atoms();
-      Atom* atomPtr;
-      Vector r;
-      IntVector shift;
-      int i, j, id, typeId, molId;
+      // Read all lines of ATOMS block
+      if (lines_.isAllocated()) {
+         if (lines_.capacity() < nAtom) {
+            lines_.deallocate();
+         }
+      }
+      if (!lines_.isAllocated()) {
+         lines_.allocate(nAtom);
+      }
+      int i;
       for (i = 0; i < nAtom; ++i) {
-
-         // Find atom address in AtomStorage by id
-         file >> id;
-         id = id - 1; // Convert from Lammps -> Simpatico integer convention
-         atomPtr = storagePtr->ptr(id);
-         if (atomPtr == 0) {
-            UTIL_THROW("Unknown atom");
+         if (!std::getline(file, lines_[i])) {
+            UTIL_THROW("EOF reading ITEM: ATOMS");
          }
-         file >> typeId;
-         file >> molId;
+      }
 
-         // Read position
-         for (j = 0; j < Util::Dimension; ++j) {
-            file >> atomPtr->position[j];
+      // Parse lines, and set positions of atoms identified by id
+      AtomStorage* storagePtr = &configuration().atoms();
+      int capacity = storagePtr->capacity();
+      int nError = 0;
+      #ifdef TOOLS_OPENMP
+      #pragma omp parallel for schedule(static) reduction(+:nError)
+      #endif
+      for (i = 0; i < nAtom; ++i) {
+         Vector r;
+         Atom* atomPtr;
+         int id, typeId, molId;
+         if (!LammpsDumpFormat::parseAtom(lines_[i].c_str(),
+                                          id, typeId, molId, r)) {
+            ++nError;
+            continue;
          }
-         file >> shift;
-
+         atomPtr = (id >= 0 && id < capacity) ? storagePtr->ptr(id) : 0;
+         if (atomPtr == 0) {
+            ++nError;
+            continue;
+         }
+         atomPtr->position = r;
+      }
+      if (nError) {
+         UTIL_THROW("Invalid line or unknown atom in ITEM: ATOMS block");
       }
       return true;
    }
@@ -9,6 +9,9 @@
 */
 
 #include <tools/trajectory/TrajectoryReader.h>  // base class
+#include <util/containers/DArray.h>             // member
+
+#include <string>
 
 namespace Tools
 {
@@ -19,6 +22,9 @@ namespace Tools
    /**
    * Reader for lammps dump trajectory file format.
    *
+   * All lines of the ATOMS block of a frame are first read into memory,
+   * and are then parsed by all threads (if compiled with TOOLS_OPENMP).
+   *
    * \ingroup Tools_Trajectory_Module
    */
    class LammpsDumpReader  : public TrajectoryReader
@@ -51,6 +57,11 @@ namespace Tools
       */
       virtual bool readFrame(std::ifstream& file);
 
+   private:
+
+      /// Lines of the ATOMS block of the current frame.
+      DArray<std::string> lines_;
+
    };
 
 }
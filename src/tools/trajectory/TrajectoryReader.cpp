@@ -6,6 +6,7 @@
 */
 
 #include "TrajectoryReader.h"
+#include <util/global.h>
 
 namespace Tools
 {
@@ -26,4 +27,10 @@ namespace Tools
    TrajectoryReader::~TrajectoryReader()
    {}
 
+   /*
+   * Random access (default implementation, not supported).
+   */
+   void TrajectoryReader::seekFrame(std::ifstream& file, int frameId)
+   {  UTIL_THROW("Random access is not supported by this trajectory format"); }
+
 }
@@ -10,6 +10,8 @@
 
 #include <util/param/ParamComposite.h>  // base class
 
+#include <string>
+
 namespace Tools
 {
 
@@ -47,6 +49,19 @@ namespace Tools
       */
       bool isBinary() const;
 
+      /**
+      * Set the name of the trajectory file, before readHeader().
+      *
+      * Formats that are read by an external library, rather than from
+      * the std::ifstream passed to readHeader and readFrame, open the
+      * file with this name in readHeader(). The name is not prefixed
+      * by the input prefix. Default implementation is empty.
+      *
+      * \param filename name of trajectory file
+      */
+      virtual void setFileName(const std::string& filename)
+      {}
+
       /**
       * Read a header (if any).
       *
@@ -62,6 +77,25 @@ namespace Tools
       */
       virtual bool readFrame(std::ifstream& file) = 0;
 
+      /**
+      * Get the number of frames, if known from a frame index.
+      *
+      * Default implementation returns -1 (unknown).
+      */
+      virtual int nFrame() const
+      {  return -1; }
+
+      /**
+      * Position the file so that the next readFrame() reads frame frameId.
+      *
+      * Only available for formats with a frame index, for which nFrame()
+      * returns a non-negative value. Default implementation throws.
+      *
+      * \param file input file, after readHeader()
+      * \param frameId index of frame, 0 <= frameId < nFrame()
+      */
+      virtual void seekFrame(std::ifstream& file, int frameId);
+
    protected:
 
       /**
@@ -1,9 +1,17 @@
 tools_trajectory_=\
    tools/trajectory/TrajectoryReader.cpp \
+   tools/trajectory/AsyncReadBuf.cpp \
+   tools/trajectory/FrameIndex.cpp \
    tools/trajectory/LammpsDumpReader.cpp \
    tools/trajectory/DdMdTrajectoryReader.cpp \
+   tools/trajectory/DdMdCompactTrajectoryReader.cpp \
    tools/trajectory/TrajectoryReaderFactory.cpp 
 
+ifdef SIMP_HDF5
+tools_trajectory_+=\
+   tools/trajectory/Hdf5TrajectoryReader.cpp
+endif
+
 tools_trajectory_SRCS=\
      $(addprefix $(SRC_DIR)/, $(tools_trajectory_))
 tools_trajectory_OBJS=\